@@ -21,6 +21,7 @@ endif ()
 ###### General features ######
 set(KATANA_ENABLE_PAPI OFF CACHE BOOL "Use PAPI counters for profiling")
 set(KATANA_ENABLE_VTUNE OFF CACHE BOOL "Use VTune for profiling")
+set(KATANA_ENABLE_MPI OFF CACHE BOOL "Build the MPI communication backend")
 set(KATANA_STRICT_CONFIG OFF CACHE BOOL "Instead of falling back gracefully, fail")
 set(KATANA_GRAPH_LOCATION "" CACHE PATH "Location of inputs for tests if downloaded/stored separately.")
 set(CXX_CLANG_TIDY "" CACHE STRING "Semi-colon separated list of clang-tidy command and arguments")
@@ -238,6 +239,10 @@ if (KATANA_ENABLE_PAPI)
   add_definitions(-DKATANA_ENABLE_PAPI)
 endif ()
 
+if (KATANA_ENABLE_MPI)
+  find_package(MPI REQUIRED COMPONENTS CXX)
+endif ()
+
 find_package(NUMA)
 
 find_package(Threads REQUIRED)
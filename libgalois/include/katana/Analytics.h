@@ -3,12 +3,28 @@
 
 #include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
 #include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
 #include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/graph_partition/graph_partition.h"
+#include "katana/analytics/hyper_anf/hyper_anf.h"
+#include "katana/analytics/hypergraph_partition/hypergraph_partition.h"
 #include "katana/analytics/jaccard/jaccard.h"
 #include "katana/analytics/k_core/k_core.h"
+#include "katana/analytics/k_shortest_simple_paths/k_shortest_simple_paths.h"
 #include "katana/analytics/k_truss/k_truss.h"
+#include "katana/analytics/label_propagation/label_propagation.h"
+#include "katana/analytics/matrix_completion/matrix_completion.h"
+#include "katana/analytics/max_flow/max_flow.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+#include "katana/analytics/motif_count/motif_count.h"
+#include "katana/analytics/nearest_neighbors/nearest_neighbors.h"
+#include "katana/analytics/neighbor_aggregation/neighbor_aggregation.h"
 #include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/points_to/points_to.h"
+#include "katana/analytics/reachability_index/reachability_index.h"
 #include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+#include "katana/analytics/subgraph_match/subgraph_match.h"
 #include "katana/analytics/triangle_count/triangle_count.h"
 
 #endif
@@ -1,17 +1,109 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <arrow/api.h>
 
 #include "katana/ErrorCode.h"
+#include "katana/Galois.h"
 #include "katana/LargeArray.h"
 #include "katana/Logging.h"
 #include "katana/Properties.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
 
 namespace katana {
 
 namespace {
 
+template <typename T>
+struct VectorHolder {
+  std::vector<T> vector;
+};
+
+/// An arrow::Buffer that owns the std::vector it wraps, so that a builder
+/// hands its storage to an array without copying it
+template <typename T>
+class VectorBuffer : private VectorHolder<T>, public arrow::Buffer {
+public:
+  explicit VectorBuffer(std::vector<T>&& vector)
+      : VectorHolder<T>{std::move(vector)},
+        arrow::Buffer(
+            reinterpret_cast<const uint8_t*>(this->vector.data()),
+            this->vector.size() * sizeof(T)) {}
+};
+
+/// Pack the n bytes of flags, each true if not 0, into an arrow bitmap. The
+/// threads pack whole 64-bit words, so no two write the same byte.
+///
+/// \returns the bitmap and the number of its bits set
+inline katana::Result<std::pair<std::shared_ptr<arrow::Buffer>, uint64_t>>
+PackBits(const uint8_t* flags, size_t n) {
+  size_t num_words = (n + 63) / 64;
+  auto res = arrow::AllocateBuffer(num_words * sizeof(uint64_t));
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating bitmap of {} bits: {}", n,
+        res.status());
+  }
+  std::shared_ptr<arrow::Buffer> bitmap = std::move(res.ValueOrDie());
+  // Arrow numbers the bits of a bitmap from the least significant bit of
+  // its first byte, which is the bit order of a little-endian word
+  auto* words = reinterpret_cast<uint64_t*>(bitmap->mutable_data());
+  katana::GAccumulator<uint64_t> num_set;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_words),
+      [&](size_t w) {
+        size_t begin = w * 64;
+        size_t end = std::min(begin + 64, n);
+        uint64_t word = 0;
+        for (size_t i = begin; i < end; ++i) {
+          word |= uint64_t{flags[i] != 0} << (i - begin);
+        }
+        words[w] = word;
+        num_set += __builtin_popcountll(word);
+      },
+      katana::no_stats());
+  return std::make_pair(std::move(bitmap), num_set.reduce());
+}
+
+/// Make an array of ArrowType, whose values are fixed width, of the
+/// values data and, if any value is null, the bitmap of its valid values
+template <typename ArrowType, typename StorageType>
+katana::Result<std::shared_ptr<arrow::Array>>
+MakeFixedWidthArray(std::vector<StorageType>&& data, const uint8_t* valid) {
+  int64_t length = data.size();
+  std::shared_ptr<arrow::Buffer> values;
+  if constexpr (std::is_same_v<ArrowType, arrow::BooleanType>) {
+    auto bits_res = PackBits(data.data(), data.size());
+    if (!bits_res) {
+      return bits_res.error();
+    }
+    values = std::move(bits_res.value().first);
+  } else {
+    values = std::make_shared<VectorBuffer<StorageType>>(std::move(data));
+  }
+
+  std::shared_ptr<arrow::Buffer> bitmap;
+  int64_t null_count = 0;
+  if (valid != nullptr) {
+    auto bits_res = PackBits(valid, length);
+    if (!bits_res) {
+      return bits_res.error();
+    }
+    null_count = length - bits_res.value().second;
+    if (null_count != 0) {
+      bitmap = std::move(bits_res.value().first);
+    }
+  }
+  return arrow::MakeArray(arrow::ArrayData::Make(
+      arrow::TypeTraits<ArrowType>::type_singleton(), length,
+      {std::move(bitmap), std::move(values)}, null_count));
+}
+
 /// NoNullBuilder uses std::vector for storage
-/// Finalize() makes a copy of the data
+/// Finalize() hands the storage of fixed width values to the array and
+/// leaves the builder empty
 /// Does not support null values
 template <typename ValueType, typename StorageType, typename ArrowType>
 class NoNullBuilder {
@@ -25,28 +117,36 @@ public:
 
   reference operator[](size_t index) {
     KATANA_LOG_DEBUG_ASSERT(index < size());
-    return static_cast<ValueType*>(data_.data())[index];
+    return reinterpret_cast<ValueType*>(data_.data())[index];
   }
 
   bool IsValid(size_t) { return true; }
 
   size_t size() const { return data_.size(); }
 
-  katana::Result<std::shared_ptr<arrow::Array>> Finalize() const {
-    using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
-    ArrowBuilder builder;
-    if (data_.size() > 0) {
-      if (auto r = builder.AppendValues(data_); !r.ok()) {
+  /// Start over with length values
+  void Reset(size_t length) { data_.assign(length, StorageType()); }
+
+  katana::Result<std::shared_ptr<arrow::Array>> Finalize() {
+    if constexpr (std::is_scalar_v<value_type>) {
+      return MakeFixedWidthArray<ArrowType>(std::move(data_), nullptr);
+    } else {
+      using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
+      ArrowBuilder builder;
+      if (data_.size() > 0) {
+        if (auto r = builder.AppendValues(data_); !r.ok()) {
+          KATANA_LOG_DEBUG("arrow error: {}", r);
+          return katana::ErrorCode::ArrowError;
+        }
+      }
+      std::shared_ptr<arrow::Array> array;
+      if (auto r = builder.Finish(&array); !r.ok()) {
         KATANA_LOG_DEBUG("arrow error: {}", r);
         return katana::ErrorCode::ArrowError;
       }
+      data_.clear();
+      return array;
     }
-    std::shared_ptr<arrow::Array> array;
-    if (auto r = builder.Finish(&array); !r.ok()) {
-      KATANA_LOG_DEBUG("arrow error: {}", r);
-      return katana::ErrorCode::ArrowError;
-    }
-    return array;
   }
 
 private:
@@ -54,7 +154,8 @@ private:
 };
 
 /// NullableBuilder uses std::vector for storage
-/// Finalize() makes a copy of the data
+/// Finalize() hands the storage of fixed width values to the array, builds
+/// the bitmap of valid values in parallel and leaves the builder empty
 /// Supports null values
 template <typename ValueType, typename StorageType, typename ArrowType>
 class NullableBuilder {
@@ -79,23 +180,25 @@ public:
 
   size_t size() const { return data_.size(); }
 
-  katana::Result<void> Finalize(std::shared_ptr<arrow::Array>* array) const {
-    using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
-    ArrowBuilder builder;
-    if (data_.size() > 0) {
-      if constexpr (std::is_scalar_v<value_type>) {
-        // TODO(danielmawhirter) find a better way to handle this
-        // arrow::NumericBuilder has:
-        // AppendValues(value_type*, int64_t, uint8_t*)
-        // AppendValues(value_type*, int64_t, vector<bool>)
-        // AppendValues(vector<value_type>, vector<bool>)
-        if (auto r =
-                builder.AppendValues(data_.data(), data_.size(), valid_.data());
-            !r.ok()) {
-          KATANA_LOG_DEBUG("arrow error: {}", r);
-          return katana::ErrorCode::ArrowError;
-        }
-      } else {
+  /// Start over with length null values, reusing the validity storage, e.g.,
+  /// to build the next of several properties of the same length
+  void Reset(size_t length) {
+    data_.assign(length, StorageType());
+    valid_.assign(length, false);
+  }
+
+  katana::Result<void> Finalize(std::shared_ptr<arrow::Array>* array) {
+    if constexpr (std::is_scalar_v<value_type>) {
+      auto res =
+          MakeFixedWidthArray<ArrowType>(std::move(data_), valid_.data());
+      if (!res) {
+        return res.error();
+      }
+      *array = std::move(res.value());
+    } else {
+      using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
+      ArrowBuilder builder;
+      if (data_.size() > 0) {
         // TODO(danielmawhirter) find a better way to handle this
         // arrow::BinaryBuilder has:
         // AppendValues(vector<string>, uint8_t*)
@@ -105,11 +208,13 @@ public:
           return katana::ErrorCode::ArrowError;
         }
       }
+      if (auto r = builder.Finish(array); !r.ok()) {
+        KATANA_LOG_DEBUG("arrow error: {}", r);
+        return katana::ErrorCode::ArrowError;
+      }
     }
-    if (auto r = builder.Finish(array); !r.ok()) {
-      KATANA_LOG_DEBUG("arrow error: {}", r);
-      return katana::ErrorCode::ArrowError;
-    }
+    data_.clear();
+    valid_.clear();
     return katana::ResultSuccess();
   }
 
@@ -181,6 +286,10 @@ public:
 
   size_t size() const { return builder_.size(); }
 
+  /// Start over with length null values. Finalize leaves the builder empty,
+  /// and a builder reset for the next property reuses its validity storage.
+  void Reset(size_t length) { builder_.Reset(length); }
+
 private:
   RandomBuilderType builder_;
 };
@@ -0,0 +1,50 @@
+#ifndef KATANA_LIBGALOIS_KATANA_BFLOAT16_H_
+#define KATANA_LIBGALOIS_KATANA_BFLOAT16_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace katana {
+
+/// A 16-bit float of the upper half of an IEEE float: the same 8 bits of
+/// exponent, so it has the range of float, and 8 bits of precision, i.e., a
+/// relative rounding error of at most 2^-8. For values that are read far
+/// more often than they are written, e.g., the contributions that pull
+/// PageRank reads per edge, it halves the bytes read for a float.
+///
+/// Conversions are shifts and adds of the bits, without branches for finite
+/// values, so loops converting arrays vectorize.
+class BFloat16 {
+  uint16_t bits_{};
+
+public:
+  BFloat16() = default;
+
+  /// Round value to the nearest BFloat16, ties to even
+  explicit BFloat16(float value) {
+    uint32_t u;
+    std::memcpy(&u, &value, sizeof(u));
+    if ((u & 0x7fffffffU) > 0x7f800000U) {
+      // NaN stays NaN, quiet
+      bits_ = static_cast<uint16_t>((u >> 16) | 0x40U);
+      return;
+    }
+    u += 0x7fffU + ((u >> 16) & 1U);
+    bits_ = static_cast<uint16_t>(u >> 16);
+  }
+
+  operator float() const {
+    uint32_t u = static_cast<uint32_t>(bits_) << 16;
+    float value;
+    std::memcpy(&value, &u, sizeof(value));
+    return value;
+  }
+
+  uint16_t bits() const { return bits_; }
+};
+
+static_assert(sizeof(BFloat16) == 2);
+
+}  // namespace katana
+
+#endif
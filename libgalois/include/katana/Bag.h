@@ -244,6 +244,19 @@ public:
     return local_iterator(&heads, katana::ThreadPool::getTID() + 1);
   }
 
+  //! The number of per-thread lists of items, which may exceed the active
+  //! threads
+  unsigned num_local_lists() const { return heads.size(); }
+
+  //! Call fn(begin, end) for each block of the items pushed by thread tid,
+  //! in order
+  template <typename F>
+  void ForEachLocalBlock(unsigned tid, const F& fn) const {
+    for (header* h = heads.getRemote(tid)->first; h; h = h->next) {
+      fn(const_pointer(h->dbegin), const_pointer(h->dend));
+    }
+  }
+
   bool empty() const {
     for (unsigned x = 0; x < heads.size(); ++x) {
       header* h = heads.getRemote(x)->first;
@@ -5,6 +5,7 @@
 
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <utility>
 #include <variant>
@@ -26,7 +27,7 @@ using NullMaps = std::pair<
     std::unordered_map<int, std::shared_ptr<arrow::Array>>,
     std::unordered_map<int, std::shared_ptr<arrow::Array>>>;
 
-enum SourceType { kGraphml, kKatana };
+enum SourceType { kGraphml, kKatana, kCsv, kParquet };
 enum SourceDatabase { kNone, kNeo4j, kMongodb, kMysql };
 enum ImportDataType {
   kString,
@@ -173,7 +174,11 @@ struct KATANA_EXPORT GraphComponents {
   Result<std::unique_ptr<katana::PropertyGraph>> ToPropertyGraph() const;
 };
 
+class ShardedPropertyGraphBuilder;
+
 class KATANA_EXPORT PropertyGraphBuilder {
+  friend class ShardedPropertyGraphBuilder;
+
   WriterProperties properties_;
   PropertiesState node_properties_;
   PropertiesState edge_properties_;
@@ -219,6 +224,12 @@ public:
 
   Result<GraphComponents> Finish(bool verbose = true);
 
+  /// Finish only the property and label tables of the nodes and edges added
+  /// so far, in order of addition, leaving the topology of the result null.
+  /// Edges need not have endpoints, so an importer can convert the values of
+  /// a batch of edges whose endpoints it resolves itself.
+  GraphComponents FinishTables();
+
   size_t GetNodeIndex();
   size_t GetNodes();
   size_t GetEdges();
@@ -228,6 +239,32 @@ private:
   GraphComponent BuildFinalEdges(bool verbose);
 };
 
+/// Build a graph with several PropertyGraphBuilders, the shards, each filled
+/// by at most one thread at a time, so that an importer can parse its input
+/// on many threads. Each shard has its own dictionary of node IDs; an edge
+/// may name a node of any shard by string ID, while numeric node indexes
+/// given to a shard are local to it. Checks that a node ID names an edge only
+/// see the edges of the same shard.
+///
+/// Finish merges the shards in parallel. The nodes of the graph are those of
+/// each shard in turn, in the order they were added, followed by a
+/// placeholder node for each ID that no shard defines. The edges of a node
+/// are in order of shard and then of addition. Properties and labels are
+/// matched by name across shards, and a property must have the same type in
+/// every shard that has it.
+class KATANA_EXPORT ShardedPropertyGraphBuilder {
+  WriterProperties properties_;
+  std::vector<std::unique_ptr<PropertyGraphBuilder>> shards_;
+
+public:
+  ShardedPropertyGraphBuilder(size_t chunk_size, size_t num_shards);
+
+  size_t num_shards() const { return shards_.size(); }
+  PropertyGraphBuilder* shard(size_t i) { return shards_[i].get(); }
+
+  Result<GraphComponents> Finish(bool verbose = true);
+};
+
 KATANA_EXPORT Result<void> WritePropertyGraph(
     const GraphComponents& graph_comps, const std::string& dir);
 KATANA_EXPORT Result<void> WritePropertyGraph(
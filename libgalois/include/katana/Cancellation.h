@@ -0,0 +1,104 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CANCELLATION_H_
+#define KATANA_LIBGALOIS_KATANA_CANCELLATION_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// A CancellationToken asks running parallel loops to stop early. It is
+/// cancelled explicitly with Cancel, which any thread may call at any time,
+/// or implicitly once its deadline passes.
+///
+/// Loops do not take a token as an argument. Instead, the thread that starts
+/// a computation installs one with a CancellationScope, and the do_all and
+/// for_each loops it starts check that token at every chunk boundary.
+/// A cancelled loop returns without running its remaining iterations, and
+/// the analytics routines return ErrorCode::Cancelled:
+///
+///     katana::CancellationToken token;
+///     token.SetTimeout(std::chrono::seconds(10));
+///     katana::CancellationScope scope(&token);
+///     auto res = katana::analytics::Bfs(pg, 0, "level", plan);
+///     // res.error() == katana::ErrorCode::Cancelled if it took too long
+class KATANA_EXPORT CancellationToken {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Request that loops observing this token stop
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+  /// Cancel this token once \param deadline passes
+  void SetDeadline(Clock::time_point deadline) {
+    deadline_.store(
+        deadline.time_since_epoch().count(), std::memory_order_relaxed);
+  }
+
+  /// Cancel this token once \param timeout from now passes
+  template <typename Rep, typename Period>
+  void SetTimeout(std::chrono::duration<Rep, Period> timeout) {
+    SetDeadline(
+        Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout));
+  }
+
+  /// \returns true if Cancel was called or the deadline has passed
+  bool IsCancelled() const {
+    if (cancelled_.load(std::memory_order_relaxed)) {
+      return true;
+    }
+    auto deadline = deadline_.load(std::memory_order_relaxed);
+    if (deadline == kNoDeadline ||
+        Clock::now().time_since_epoch().count() < deadline) {
+      return false;
+    }
+    // Remember that the deadline passed so later checks skip the clock
+    cancelled_.store(true, std::memory_order_relaxed);
+    return true;
+  }
+
+private:
+  static constexpr Clock::rep kNoDeadline =
+      std::numeric_limits<Clock::rep>::max();
+
+  mutable std::atomic<bool> cancelled_{false};
+  std::atomic<Clock::rep> deadline_{kNoDeadline};
+};
+
+/// CancellationScope makes \param token the token that parallel loops
+/// started from this thread observe until the scope ends. Scopes nest; a
+/// null token means loops cannot be cancelled.
+class KATANA_EXPORT CancellationScope {
+public:
+  explicit CancellationScope(const CancellationToken* token);
+  ~CancellationScope();
+
+  CancellationScope(const CancellationScope&) = delete;
+  CancellationScope& operator=(const CancellationScope&) = delete;
+
+private:
+  const CancellationToken* prev_;
+};
+
+namespace internal {
+
+/// \returns the token of the innermost CancellationScope of this thread, or
+///     nullptr if there is none
+KATANA_EXPORT const CancellationToken* CurrentCancellationToken();
+
+}  // namespace internal
+
+/// \returns true if the token of the innermost CancellationScope of this
+///     thread is cancelled
+inline bool
+IsCancelled() {
+  const CancellationToken* token = internal::CurrentCancellationToken();
+  return token && token->IsCancelled();
+}
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef KATANA_LIBGALOIS_KATANA_COMBININGSCATTER_H_
+#define KATANA_LIBGALOIS_KATANA_COMBININGSCATTER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+
+namespace katana {
+
+/// Adds values to the nodes of a graph, e.g., the residuals that push
+/// PageRank sends along edges, as atomicAdd does, but combines the values
+/// a thread adds to the same hot node, one with many in-edges, in a small
+/// direct-mapped buffer of its own and adds them to the node in one atomic
+/// add when they are evicted or flushed. Values for other nodes are added
+/// right away, as they rarely contend.
+///
+///     katana::CombiningScatter<float> scatter(topology, residuals);
+///     auto activate = [&](Node n, float old, float delta) { ... };
+///     katana::do_all(katana::iterate(work), [&](auto item) {
+///       scatter.Add(dest, delta, activate);
+///     });
+///     scatter.Flush(activate);
+///
+/// A value of a hot node reaches it only once it is flushed, so operators
+/// must not read the nodes they add to before Flush. on_flush(node, old,
+/// delta) is called once per atomic add, with the value of the node before
+/// the add, e.g., to activate the nodes whose value crosses a threshold.
+/// Values are combined with +, so the order of additions of floating point
+/// values can differ from that of atomicAdd.
+template <typename T>
+class CombiningScatter {
+public:
+  using Node = GraphTopology::Node;
+
+  /// The entries of each thread's buffer, if not given
+  constexpr static size_t kDefaultBufferEntries = 1024;
+  /// With automatic hot nodes, the in-degree from which a node is hot is the
+  /// larger of this and kHotDegreeFactor times the average degree
+  constexpr static uint64_t kMinHotDegree = 64;
+  constexpr static uint64_t kHotDegreeFactor = 8;
+
+  /// \param targets the values of the nodes of topology
+  /// \param buffer_entries the entries of each thread's buffer, rounded up
+  ///     to a power of two
+  /// \param min_hot_degree the in-degree from which a node is hot, or 0 to
+  ///     choose one from the average degree; in-degrees are estimated from
+  ///     a sample of the edges
+  CombiningScatter(
+      const GraphTopology& topology, std::atomic<T>* targets,
+      size_t buffer_entries = kDefaultBufferEntries,
+      uint64_t min_hot_degree = 0)
+      : targets_(targets) {
+    KATANA_LOG_ASSERT(buffer_entries > 0);
+    num_entries_ = 1;
+    while (num_entries_ < buffer_entries) {
+      num_entries_ *= 2;
+    }
+    FindHotNodes(topology, min_hot_degree);
+
+    katana::on_each(
+        [&](unsigned, unsigned) {
+          buffers_.getLocal()->assign(num_entries_, Entry{});
+        },
+        katana::no_stats());
+  }
+
+  /// \returns true if values added to node are combined
+  bool IsHot(Node node) const { return hot_.test(node); }
+
+  size_t num_hot_nodes() const { return num_hot_; }
+
+  /// Add value to node
+  template <typename F>
+  void Add(Node node, T value, const F& on_flush) {
+    if (!IsHot(node)) {
+      AddNow(node, value, on_flush);
+      return;
+    }
+    Entry& entry = (*buffers_.getLocal())[Slot(node)];
+    if (entry.node == node) {
+      entry.value += value;
+      return;
+    }
+    if (entry.node != kEmpty) {
+      AddNow(entry.node, entry.value, on_flush);
+    }
+    entry = Entry{node, value};
+  }
+
+  void Add(Node node, T value) {
+    Add(node, value, [](Node, T, T) {});
+  }
+
+  /// Add the values combined so far to their nodes. Call it outside of
+  /// parallel loops, after the loops that add values.
+  template <typename F>
+  void Flush(const F& on_flush) {
+    katana::on_each(
+        [&](unsigned, unsigned) {
+          for (Entry& entry : *buffers_.getLocal()) {
+            if (entry.node != kEmpty) {
+              AddNow(entry.node, entry.value, on_flush);
+              entry = Entry{};
+            }
+          }
+        },
+        katana::no_stats());
+  }
+
+  void Flush() {
+    Flush([](Node, T, T) {});
+  }
+
+private:
+  constexpr static Node kEmpty = std::numeric_limits<Node>::max();
+
+  struct Entry {
+    Node node{kEmpty};
+    T value{};
+  };
+
+  template <typename F>
+  void AddNow(Node node, T value, const F& on_flush) {
+    T old = katana::atomicAdd(targets_[node], value);
+    on_flush(node, old, value);
+  }
+
+  size_t Slot(Node node) const {
+    // Fibonacci hashing spreads hubs with nearby ids over the buffer
+    return ((node * UINT64_C(11400714819323198485)) >> 32) &
+           (num_entries_ - 1);
+  }
+
+  void FindHotNodes(const GraphTopology& topology, uint64_t min_hot_degree) {
+    uint64_t num_nodes = topology.num_nodes();
+    uint64_t num_edges = topology.num_edges();
+    hot_.resize(num_nodes);
+    num_hot_ = 0;
+    if (num_edges == 0) {
+      return;
+    }
+    if (min_hot_degree == 0) {
+      min_hot_degree =
+          std::max(kMinHotDegree, kHotDegreeFactor * num_edges / num_nodes);
+    }
+
+    // Every stride-th edge, so that a node of in-degree d is sampled about
+    // d / stride times
+    uint64_t num_samples = std::min<uint64_t>(num_edges, 64 * num_entries_);
+    uint64_t stride = num_edges / num_samples;
+    std::unordered_map<Node, uint64_t> samples;
+    const Node* dests = topology.edge_dests();
+    for (uint64_t e = 0; e < num_edges; e += stride) {
+      samples[dests[e]] += 1;
+    }
+    for (const auto& [node, count] : samples) {
+      if (count * stride >= min_hot_degree) {
+        hot_.set(node);
+        ++num_hot_;
+      }
+    }
+  }
+
+  std::atomic<T>* targets_;
+  size_t num_entries_;
+  DynamicBitset hot_;
+  size_t num_hot_;
+  PerThreadStorage<std::vector<Entry>> buffers_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef KATANA_LIBGALOIS_KATANA_COMPACTTOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_COMPACTTOPOLOGY_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+
+namespace katana {
+
+/// A read-only copy of the edge offsets of a GraphTopology in EdgeIndex,
+/// e.g., uint32_t for a graph of fewer than 2^32 edges, so that traversals
+/// read half the offset memory of GraphTopology. The destinations are shared
+/// with the topology and edges keep their ids, so edge properties are those
+/// of the graph.
+///
+/// It has the part of the interface of GraphTopology that traversals use:
+/// analytics templated on their topology run on either, and
+/// WithCompactTopology picks the most compact one for a graph.
+template <typename EdgeIndex>
+class CompactTopology {
+  static_assert(std::is_unsigned_v<EdgeIndex>);
+
+public:
+  using Node = GraphTopology::Node;
+  using Edge = EdgeIndex;
+  using node_iterator = boost::counting_iterator<Node>;
+  using edge_iterator = boost::counting_iterator<Edge>;
+  using nodes_range = StandardRange<node_iterator>;
+  using edges_range = StandardRange<edge_iterator>;
+  using iterator = node_iterator;
+
+  /// \returns true if the edges of topology fit EdgeIndex
+  static bool Fits(const GraphTopology& topology) {
+    return topology.num_edges() <= std::numeric_limits<EdgeIndex>::max();
+  }
+
+  /// Copy the offsets of topology, whose edges must fit EdgeIndex, in
+  /// parallel
+  explicit CompactTopology(const GraphTopology& topology)
+      : out_dests_(topology.out_dests), num_nodes_(topology.num_nodes()) {
+    KATANA_LOG_ASSERT(Fits(topology));
+    // A leading 0 saves the branch of GraphTopology::edge_range
+    out_indices_.allocateBlocked(num_nodes_ + 1);
+    out_indices_[0] = 0;
+    const uint64_t* indices =
+        num_nodes_ == 0 ? nullptr : topology.out_indices->raw_values();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) { out_indices_[n + 1] = indices[n]; },
+        katana::no_stats());
+  }
+
+  uint64_t num_nodes() const { return num_nodes_; }
+
+  uint64_t num_edges() const { return out_indices_[num_nodes_]; }
+
+  std::pair<Edge, Edge> edge_range(Node node) const {
+    return std::make_pair(out_indices_[node], out_indices_[node + 1]);
+  }
+
+  edges_range edges(Node node) const {
+    return MakeStandardRange<edge_iterator>(
+        out_indices_[node], out_indices_[node + 1]);
+  }
+
+  Node edge_dest(Edge edge) const {
+    KATANA_LOG_DEBUG_ASSERT(edge < num_edges());
+    return edge_dests()[edge];
+  }
+
+  /// The raw edge destination array, as GraphTopology::edge_dests
+  const Node* edge_dests() const {
+    return out_dests_ ? out_dests_->raw_values() : nullptr;
+  }
+
+  nodes_range nodes(Node begin, Node end) const {
+    return MakeStandardRange<node_iterator>(begin, end);
+  }
+
+  node_iterator begin() const { return node_iterator(0); }
+
+  node_iterator end() const { return node_iterator(num_nodes_); }
+
+  size_t size() const { return num_nodes_; }
+
+  bool empty() const { return num_nodes_ == 0; }
+
+private:
+  std::shared_ptr<arrow::UInt32Array> out_dests_;
+  uint64_t num_nodes_;
+  LargeArray<EdgeIndex> out_indices_;
+};
+
+/// Run fn on the most compact topology for topology: a
+/// CompactTopology<uint32_t> if its edges fit 32 bits and topology itself
+/// otherwise. Copying the offsets costs a pass over the nodes, which pays
+/// off for traversals that read them repeatedly.
+///
+/// \returns what fn returns, which must be the same for both topologies
+template <typename F>
+auto
+WithCompactTopology(const GraphTopology& topology, F fn) {
+  if (CompactTopology<uint32_t>::Fits(topology)) {
+    CompactTopology<uint32_t> compact(topology);
+    return fn(compact);
+  }
+  return fn(topology);
+}
+
+}  // namespace katana
+
+#endif
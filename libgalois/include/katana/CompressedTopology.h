@@ -0,0 +1,131 @@
+#ifndef KATANA_LIBGALOIS_KATANA_COMPRESSEDTOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_COMPRESSEDTOPOLOGY_H_
+
+#include <cstdint>
+#include <string>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/CSRTopology.h"
+#include "tsuba/RDGPrefix.h"
+
+namespace katana {
+
+/// The topology of an RDG stored in the compressed CSR format (see
+/// tsuba::kCompressedCSRTopologyVersion), kept compressed in memory. Loading
+/// a PropertyGraph decodes the whole topology into a GraphTopology, 4 bytes
+/// per edge. This keeps the per-node blocks as they are stored, mostly one or
+/// two bytes per edge, and decodes the block of a node each time its
+/// destinations are iterated.
+///
+/// Edges have no ids, since a block can only be read in order, so this suits
+/// analytics that read destinations but not edge properties, e.g.,
+/// traversals and degree counts. Only unpartitioned RDGs can be read.
+class KATANA_EXPORT CompressedTopology {
+public:
+  using Node = GraphTopology::Node;
+  using node_iterator = GraphTopology::node_iterator;
+  using nodes_range = GraphTopology::nodes_range;
+  using iterator = node_iterator;
+
+  /// Decodes the destinations of the block of a node as it advances
+  class dest_iterator
+      : public boost::iterator_facade<
+            dest_iterator, Node, boost::forward_traversal_tag, Node> {
+  public:
+    dest_iterator() = default;
+    dest_iterator(
+        Node src, const uint8_t* in, const uint8_t* end, uint64_t remaining)
+        : in_(in), end_(end), dest_(src), remaining_(remaining) {
+      if (remaining_ != 0) {
+        DecodeNext();
+      }
+    }
+
+  private:
+    friend class boost::iterator_core_access;
+
+    void DecodeNext() {
+      // Make checked every block
+      [[maybe_unused]] bool decoded =
+          tsuba::DecodeCompressedCSRDest(&in_, end_, &dest_);
+      KATANA_LOG_DEBUG_ASSERT(decoded);
+    }
+
+    Node dereference() const { return dest_; }
+    bool equal(const dest_iterator& other) const {
+      return remaining_ == other.remaining_;
+    }
+    void increment() {
+      if (--remaining_ != 0) {
+        DecodeNext();
+      }
+    }
+
+    const uint8_t* in_{nullptr};
+    const uint8_t* end_{nullptr};
+    Node dest_{0};
+    uint64_t remaining_{0};
+  };
+
+  using dests_range = StandardRange<dest_iterator>;
+
+  /// Read the compressed topology of the RDG rdg_name into memory and check
+  /// that every block decodes.
+  ///
+  /// \returns ErrorCode::NotImplemented if the topology is not compressed
+  static Result<CompressedTopology> Make(const std::string& rdg_name);
+
+  uint64_t num_nodes() const { return prefix_.num_nodes(); }
+  uint64_t num_edges() const { return prefix_.num_edges(); }
+
+  uint64_t degree(Node n) const { return edge_end(n) - edge_begin(n); }
+
+  /// The destinations of the edges of n, in the order they were stored
+  dests_range dests(Node n) const {
+    const uint8_t* block_end = dest_blocks_ + dest_offsets_[n];
+    const uint8_t* block_begin =
+        n == 0 ? dest_blocks_ : dest_blocks_ + dest_offsets_[n - 1];
+    return MakeStandardRange(
+        dest_iterator(n, block_begin, block_end, degree(n)), dest_iterator());
+  }
+
+  /// The bytes that hold the destinations of all edges
+  uint64_t dest_blocks_size() const {
+    return num_nodes() == 0 ? 0 : dest_offsets_[num_nodes() - 1];
+  }
+
+  nodes_range nodes(Node begin, Node end) const {
+    return MakeStandardRange<node_iterator>(begin, end);
+  }
+
+  node_iterator begin() const { return node_iterator(0); }
+
+  node_iterator end() const { return node_iterator(num_nodes()); }
+
+  size_t size() const { return num_nodes(); }
+
+  bool empty() const { return num_nodes() == 0; }
+
+private:
+  explicit CompressedTopology(tsuba::RDGPrefix&& prefix);
+
+  uint64_t edge_begin(Node n) const { return n == 0 ? 0 : prefix_[n - 1]; }
+  uint64_t edge_end(Node n) const { return prefix_[n]; }
+
+  /// \returns true if every block decodes to the degree of its node of
+  /// destinations of this topology
+  bool Validate() const;
+
+  tsuba::RDGPrefix prefix_;
+  const uint64_t* dest_offsets_;
+  const uint8_t* dest_blocks_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,346 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CONCURRENTHASHMAP_H_
+#define KATANA_LIBGALOIS_KATANA_CONCURRENTHASHMAP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace katana {
+
+namespace internal {
+
+/// The open addressing tables of the concurrent hash maps have a power of
+/// two slots, at least twice their capacity, and index them by the high bits
+/// of the hash times a Fibonacci constant, which spreads the nearby keys
+/// that std::hash maps to nearby hashes over the table.
+class HashTableSlots {
+public:
+  explicit HashTableSlots(size_t capacity) {
+    while ((size_t{1} << bits_) < 2 * capacity) {
+      ++bits_;
+    }
+  }
+
+  size_t size() const { return size_t{1} << bits_; }
+
+  size_t operator()(size_t hash) const {
+    return (static_cast<uint64_t>(hash) * UINT64_C(11400714819323198485)) >>
+           (64 - bits_);
+  }
+
+  size_t next(size_t slot) const { return (slot + 1) & (size() - 1); }
+
+private:
+  uint32_t bits_{4};
+};
+
+}  // namespace internal
+
+/// A hash map of a fixed capacity that many threads may insert into and
+/// look up in at the same time, e.g., to build a dictionary of string IDs or
+/// to aggregate values by key in a parallel loop.
+///
+///     katana::ConcurrentHashMap<std::string_view, uint64_t> ids(num_rows);
+///     katana::do_all(katana::iterate(size_t{0}, num_rows), [&](size_t i) {
+///       ids.Insert(names[i], i);
+///     });
+///
+/// It is an open addressing table with linear probing. A thread claims an
+/// empty slot with a compare-and-swap of its state, so no locks are taken,
+/// but a lookup that reaches a slot being filled waits for it. Entries are
+/// never removed. The slots are interleaved over the NUMA nodes, since
+/// threads probe them at random.
+///
+/// The capacity must bound the number of distinct keys; a table that fills
+/// up is fatal. Key and T must be default constructible. If all inserts
+/// come before all lookups, PhaseConcurrentHashMap is faster.
+template <
+    typename Key, typename T, typename Hash = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key>>
+class ConcurrentHashMap {
+public:
+  explicit ConcurrentHashMap(
+      size_t capacity, const Hash& hash = Hash(),
+      const KeyEqual& equal = KeyEqual())
+      : slot_of_(capacity), hash_(hash), equal_(equal) {
+    slots_.allocateInterleaved(slot_of_.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, slot_of_.size()),
+        [&](size_t i) { slots_.constructAt(i); }, katana::no_stats());
+  }
+
+  /// Insert key with the value constructed from args if key is not in the
+  /// map. The value is constructed before the entry is visible, so other
+  /// threads may update it once they find it, e.g., with atomics.
+  ///
+  /// \returns the value of key and whether it was inserted
+  template <typename... Args>
+  std::pair<T*, bool> Insert(const Key& key, Args&&... args) {
+    for (size_t i = slot_of_(hash_(key)), probes = 0; probes < slots_.size();
+         i = slot_of_.next(i), ++probes) {
+      Slot& slot = slots_[i];
+      uint8_t state = slot.state.load(std::memory_order_acquire);
+      if (state == kEmpty &&
+          slot.state.compare_exchange_strong(
+              state, kBusy, std::memory_order_acquire)) {
+        slot.key = key;
+        slot.value.~T();
+        new (&slot.value) T(std::forward<Args>(args)...);
+        slot.state.store(kFull, std::memory_order_release);
+        return {&slot.value, true};
+      }
+      if (Wait(slot, state) && equal_(slot.key, key)) {
+        return {&slot.value, false};
+      }
+    }
+    KATANA_LOG_FATAL("ConcurrentHashMap of {} slots is full", slots_.size());
+  }
+
+  /// \returns the value of key, or null if it is not in the map
+  T* Find(const Key& key) {
+    return const_cast<T*>(std::as_const(*this).Find(key));
+  }
+
+  const T* Find(const Key& key) const {
+    for (size_t i = slot_of_(hash_(key)), probes = 0; probes < slots_.size();
+         i = slot_of_.next(i), ++probes) {
+      const Slot& slot = slots_[i];
+      uint8_t state = slot.state.load(std::memory_order_acquire);
+      if (!Wait(slot, state)) {
+        return nullptr;
+      }
+      if (equal_(slot.key, key)) {
+        return &slot.value;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Insert the key and value pairs fn(i) for i in [begin, end) in parallel
+  template <typename I, typename F>
+  void InsertAll(I begin, I end, const F& fn) {
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](I i) {
+          auto [key, value] = fn(i);
+          Insert(key, std::move(value));
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  /// Call fn(key, value) for each entry in parallel. Entries inserted
+  /// during the call may be skipped.
+  template <typename F>
+  void ForEach(const F& fn) {
+    katana::do_all(
+        katana::iterate(size_t{0}, slots_.size()),
+        [&](size_t i) {
+          Slot& slot = slots_[i];
+          if (slot.state.load(std::memory_order_acquire) == kFull) {
+            fn(std::as_const(slot.key), slot.value);
+          }
+        },
+        katana::no_stats());
+  }
+
+  /// \returns the number of entries, counted in parallel
+  size_t size() {
+    katana::GAccumulator<size_t> size;
+    ForEach([&](const Key&, const T&) { size += 1; });
+    return size.reduce();
+  }
+
+  size_t num_slots() const { return slots_.size(); }
+
+private:
+  constexpr static uint8_t kEmpty = 0;
+  constexpr static uint8_t kBusy = 1;
+  constexpr static uint8_t kFull = 2;
+
+  struct Slot {
+    std::atomic<uint8_t> state{kEmpty};
+    Key key{};
+    T value{};
+  };
+
+  /// Wait for a slot in state to be filled if it is being filled
+  ///
+  /// \returns true if the slot is full and false if it is empty
+  static bool Wait(const Slot& slot, uint8_t state) {
+    while (state == kBusy) {
+      asmPause();
+      state = slot.state.load(std::memory_order_acquire);
+    }
+    return state == kFull;
+  }
+
+  internal::HashTableSlots slot_of_;
+  Hash hash_;
+  KeyEqual equal_;
+  LargeArray<Slot> slots_;
+};
+
+/// A hash map of integer keys like ConcurrentHashMap that is used in
+/// phases: many threads insert into it, e.g., in one parallel loop, and
+/// then many threads look up in it, e.g., in later loops, but the two are
+/// never at the same time. Without concurrent lookups, a key is claimed by
+/// a compare-and-swap of the key itself, and keys and values are in
+/// separate arrays, so inserts do not wait for each other and probes touch
+/// only the keys.
+///
+/// The largest Key marks empty slots and may not be inserted. Values are
+/// value-initialized when the map is made or cleared, so values of type
+/// std::atomic may be aggregated during the insert phase, e.g., the weight
+/// of the edges of a node to each community:
+///
+///     katana::PhaseConcurrentHashMap<uint64_t, std::atomic<double>> w(n);
+///     katana::do_all(katana::iterate(edges), [&](auto e) {
+///       katana::atomicAdd(*w.Insert(community[dest(e)]).first, weight[e]);
+///     });
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class PhaseConcurrentHashMap {
+  static_assert(std::is_integral_v<Key>);
+
+public:
+  constexpr static Key kEmptyKey = std::numeric_limits<Key>::max();
+
+  explicit PhaseConcurrentHashMap(size_t capacity, const Hash& hash = Hash())
+      : slot_of_(capacity), hash_(hash) {
+    keys_.allocateInterleaved(slot_of_.size());
+    values_.allocateInterleaved(slot_of_.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, slot_of_.size()),
+        [&](size_t i) {
+          keys_.constructAt(i, kEmptyKey);
+          values_.constructAt(i);
+        },
+        katana::no_stats());
+  }
+
+  /// Insert key with a value-initialized value if it is not in the map.
+  /// Call it only in the insert phase.
+  ///
+  /// \returns the value of key and whether it was inserted
+  std::pair<T*, bool> Insert(Key key) {
+    KATANA_LOG_DEBUG_ASSERT(key != kEmptyKey);
+    for (size_t i = slot_of_(hash_(key)), probes = 0; probes < keys_.size();
+         i = slot_of_.next(i), ++probes) {
+      // The phases are ordered by the end of the loops around them, so
+      // keys need no ordering with other memory
+      Key found = keys_[i].load(std::memory_order_relaxed);
+      if (found == kEmptyKey &&
+          keys_[i].compare_exchange_strong(
+              found, key, std::memory_order_relaxed)) {
+        return {&values_[i], true};
+      }
+      if (found == key) {
+        return {&values_[i], false};
+      }
+    }
+    KATANA_LOG_FATAL(
+        "PhaseConcurrentHashMap of {} slots is full", keys_.size());
+  }
+
+  /// Insert key with value if it is not in the map. The value is not
+  /// visible to other threads until the insert phase ends.
+  ///
+  /// \returns the value of key and whether it was inserted
+  std::pair<T*, bool> Insert(Key key, const T& value) {
+    auto res = Insert(key);
+    if (res.second) {
+      *res.first = value;
+    }
+    return res;
+  }
+
+  /// \returns the value of key, or null if it is not in the map. Call it
+  /// only in the lookup phase.
+  T* Find(Key key) {
+    return const_cast<T*>(std::as_const(*this).Find(key));
+  }
+
+  const T* Find(Key key) const {
+    for (size_t i = slot_of_(hash_(key)), probes = 0; probes < keys_.size();
+         i = slot_of_.next(i), ++probes) {
+      Key found = keys_[i].load(std::memory_order_relaxed);
+      if (found == key) {
+        return &values_[i];
+      }
+      if (found == kEmptyKey) {
+        return nullptr;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Insert the key and value pairs fn(i) for i in [begin, end) in parallel
+  template <typename I, typename F>
+  void InsertAll(I begin, I end, const F& fn) {
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](I i) {
+          auto [key, value] = fn(i);
+          Insert(key, value);
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  /// Call fn(key, value) for each entry in parallel. Call it only in the
+  /// lookup phase.
+  template <typename F>
+  void ForEach(const F& fn) {
+    katana::do_all(
+        katana::iterate(size_t{0}, keys_.size()),
+        [&](size_t i) {
+          Key key = keys_[i].load(std::memory_order_relaxed);
+          if (key != kEmptyKey) {
+            fn(key, values_[i]);
+          }
+        },
+        katana::no_stats());
+  }
+
+  /// Remove every entry in parallel, so the map can be reused, e.g., in the
+  /// next round of an algorithm
+  void Clear() {
+    katana::do_all(
+        katana::iterate(size_t{0}, keys_.size()),
+        [&](size_t i) {
+          if (keys_[i].load(std::memory_order_relaxed) != kEmptyKey) {
+            keys_[i].store(kEmptyKey, std::memory_order_relaxed);
+            values_[i].~T();
+            values_.constructAt(i);
+          }
+        },
+        katana::no_stats());
+  }
+
+  /// \returns the number of entries, counted in parallel
+  size_t size() {
+    katana::GAccumulator<size_t> size;
+    ForEach([&](Key, const T&) { size += 1; });
+    return size.reduce();
+  }
+
+  size_t num_slots() const { return keys_.size(); }
+
+private:
+  internal::HashTableSlots slot_of_;
+  Hash hash_;
+  LargeArray<std::atomic<Key>> keys_;
+  LargeArray<T> values_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CONFLICTTHROTTLE_H_
+#define KATANA_LIBGALOIS_KATANA_CONFLICTTHROTTLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// ConflictThrottle limits how many threads of a for_each with conflict
+/// detection run iterations at once, by the rate at which their iterations
+/// conflict (see katana::adaptive_conflicts). Threads take turns running
+/// batches of iterations; at most max_threads() of them hold a turn at a
+/// time, and a turn runs up to batch_size() iterations.
+///
+/// Every kWindow iterations, the throttle halves both if more than
+/// kHighConflictRate of the iterations conflicted, and lets one more thread
+/// run and doubles the batch if fewer than kLowConflictRate did, as the
+/// ParaMeter executor measures available parallelism offline. A loop starts
+/// from the limits the last loop of the same name ended with.
+class KATANA_EXPORT ConflictThrottle {
+public:
+  static constexpr uint64_t kWindow = 1024;
+  static constexpr double kHighConflictRate = 0.2;
+  static constexpr double kLowConflictRate = 0.05;
+  static constexpr uint32_t kMinBatch = 8;
+  static constexpr uint32_t kMaxBatch = 256;
+
+  ConflictThrottle(const char* loopname, uint32_t num_threads);
+  /// Remember the limits for the next loop of the same name
+  ~ConflictThrottle();
+
+  ConflictThrottle(const ConflictThrottle&) = delete;
+  ConflictThrottle& operator=(const ConflictThrottle&) = delete;
+
+  /// Wait for a turn to run a batch of iterations, or return false if
+  /// stop() returns true first
+  template <typename StopFn>
+  bool Acquire(const StopFn& stop) {
+    for (;;) {
+      uint32_t running = running_.load(std::memory_order_relaxed);
+      if (running < max_threads_.load(std::memory_order_relaxed) &&
+          running_.compare_exchange_weak(running, running + 1)) {
+        return true;
+      }
+      if (stop()) {
+        return false;
+      }
+      asmPause();
+    }
+  }
+
+  /// End a turn that ran iterations, of which conflicts conflicted
+  void Release(uint64_t iterations, uint64_t conflicts);
+
+  uint32_t max_threads() const {
+    return max_threads_.load(std::memory_order_relaxed);
+  }
+  uint32_t batch_size() const {
+    return batch_size_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void Adjust();
+
+  std::string loopname_;
+  uint32_t num_threads_;
+  std::atomic<uint32_t> max_threads_;
+  std::atomic<uint32_t> batch_size_;
+  std::atomic<uint32_t> running_{0};
+
+  std::atomic<uint64_t> window_iterations_{0};
+  std::atomic<uint64_t> window_conflicts_{0};
+  std::mutex adjusting_;
+};
+
+}  // namespace katana
+
+#endif
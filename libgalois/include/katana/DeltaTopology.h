@@ -0,0 +1,173 @@
+#ifndef KATANA_LIBGALOIS_KATANA_DELTATOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_DELTATOPOLOGY_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Edge insertions and deletions layered over an immutable GraphTopology.
+///
+/// Changes are appended to per-thread logs with InsertEdge and DeleteEdge,
+/// which may be called concurrently, e.g., from a parallel loop that ingests
+/// a batch. Apply merges the logged batch into a per-node overlay. Readers
+/// see the overlay through out_degree and ForEachOutEdge: the base edges
+/// of a node that were not deleted, in order, followed by its inserted
+/// edges. Compact folds the overlay into a new CSR topology, which becomes
+/// the new base; see also PropertyGraph::ApplyDeltaTopology.
+///
+/// The overlay is meant to stay small relative to the base. Lookups of
+/// changed nodes cost more than those of unchanged ones, so callers should
+/// compact once delta_fraction grows.
+///
+/// Apply, Compact and the readers must not run concurrently with each other
+/// or with the writers.
+class KATANA_EXPORT DeltaTopology {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+
+  /// The base edge id that ForEachOutEdge reports for inserted edges
+  static constexpr Edge kInsertedEdge = std::numeric_limits<Edge>::max();
+
+  explicit DeltaTopology(GraphTopology base);
+
+  DeltaTopology(const DeltaTopology&) = delete;
+  DeltaTopology& operator=(const DeltaTopology&) = delete;
+
+  /// Log the insertion of an edge from src to dst
+  void InsertEdge(Node src, Node dst) { Log(src, dst, true); }
+
+  /// Log the deletion of one edge from src to dst. Deleting an edge that does
+  /// not exist when the batch is applied does nothing.
+  void DeleteEdge(Node src, Node dst) { Log(src, dst, false); }
+
+  /// Merge the logged changes into the overlay. The deletions of a batch are
+  /// applied before its insertions, and a deletion removes an edge inserted
+  /// by an earlier batch before it removes a base edge.
+  ///
+  /// \returns an error, and discards the logged batch without applying any
+  ///     of it, if a logged edge is not between nodes of the topology
+  Result<void> Apply();
+
+  /// Build a new CSR topology with the overlay folded in, in parallel, and
+  /// make it the base of an empty overlay.
+  ///
+  /// \returns for each edge of the new topology, the id of the base edge it
+  ///     was or null if it was inserted
+  Result<std::shared_ptr<arrow::UInt64Array>> Compact();
+
+  const GraphTopology& base() const { return base_; }
+
+  uint64_t num_nodes() const { return base_.num_nodes(); }
+
+  /// \returns the number of edges including the overlay
+  uint64_t num_edges() const {
+    return base_.num_edges() + num_inserted_ - num_deleted_;
+  }
+
+  /// The number of edges of the overlay that have been inserted and of base
+  /// edges that have been deleted
+  uint64_t num_inserted() const { return num_inserted_; }
+  uint64_t num_deleted() const { return num_deleted_; }
+
+  /// \returns the size of the overlay relative to the base
+  double delta_fraction() const {
+    return base_.num_edges() == 0
+               ? (num_inserted_ > 0 ? 1.0 : 0.0)
+               : double(num_inserted_ + num_deleted_) / base_.num_edges();
+  }
+
+  uint64_t out_degree(Node n) const {
+    uint64_t degree = base_.edges(n).size();
+    if (const NodeDelta* d = delta(n)) {
+      degree += d->inserted.size() - d->deleted.size();
+    }
+    return degree;
+  }
+
+  /// Call fn(base_edge, dst) for each out-edge of n, base edges first.
+  /// base_edge is the id of the edge in the base topology, to look up its
+  /// properties, or kInsertedEdge.
+  template <typename F>
+  void ForEachOutEdge(Node n, const F& fn) const {
+    const NodeDelta* d = delta(n);
+    if (!d) {
+      for (auto e : base_.edges(n)) {
+        fn(e, base_.edge_dest(e));
+      }
+      return;
+    }
+    auto deleted = d->deleted.begin();
+    for (auto e : base_.edges(n)) {
+      if (deleted != d->deleted.end() && *deleted == e) {
+        ++deleted;
+        continue;
+      }
+      fn(e, base_.edge_dest(e));
+    }
+    for (Node dst : d->inserted) {
+      fn(kInsertedEdge, dst);
+    }
+  }
+
+  /// Call fn(dst) for each out-neighbor of n, base edges first
+  template <typename F>
+  void ForEachOutNeighbor(Node n, const F& fn) const {
+    ForEachOutEdge(n, [&](Edge, Node dst) { fn(dst); });
+  }
+
+private:
+  struct Change {
+    Node src;
+    Node dst;
+    bool insert;
+  };
+
+  /// The changes of one node
+  struct NodeDelta {
+    std::vector<Node> inserted;
+    /// Deleted base edges, sorted
+    std::vector<Edge> deleted;
+  };
+
+  static constexpr uint32_t kNoDelta = std::numeric_limits<uint32_t>::max();
+
+  void Log(Node src, Node dst, bool insert) {
+    logs_.getLocal()->emplace_back(Change{src, dst, insert});
+  }
+
+  const NodeDelta* delta(Node n) const {
+    if (delta_index_.empty() || delta_index_[n] == kNoDelta) {
+      return nullptr;
+    }
+    return &deltas_[delta_index_[n]];
+  }
+
+  /// Apply the changes of src, deletions first, and count the edges they
+  /// add to and remove from the overlay
+  void ApplyChanges(
+      Node src, NodeDelta* d, const Change* begin, const Change* end,
+      int64_t* inserted, int64_t* deleted) const;
+
+  GraphTopology base_;
+  katana::PerThreadStorage<std::vector<Change>> logs_;
+  /// The index in deltas_ of each node's changes, allocated on first use
+  std::vector<uint32_t> delta_index_;
+  std::vector<NodeDelta> deltas_;
+  uint64_t num_inserted_{0};
+  uint64_t num_deleted_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef KATANA_LIBGALOIS_KATANA_DETERMINISTICRESERVATIONS_H_
+#define KATANA_LIBGALOIS_KATANA_DETERMINISTICRESERVATIONS_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace katana {
+
+/// A cell of the neighborhood of the items of a deterministic_reservations
+/// loop. Items reserve the cells they will write with their priority, their
+/// position in the loop, and the earliest item wins.
+class ReservationCell {
+public:
+  static constexpr uint64_t kFree = std::numeric_limits<uint64_t>::max();
+
+  /// Reserve the cell for priority unless an earlier item reserved it
+  void Reserve(uint64_t priority) {
+    uint64_t owner = owner_.load(std::memory_order_relaxed);
+    while (priority < owner &&
+           !owner_.compare_exchange_weak(owner, priority)) {
+    }
+  }
+
+  bool ReservedBy(uint64_t priority) const {
+    return owner_.load(std::memory_order_relaxed) == priority;
+  }
+
+  /// Free the cell if priority holds it; return whether it did
+  bool Release(uint64_t priority) {
+    return owner_.compare_exchange_strong(priority, kFree);
+  }
+
+  void Reset() { owner_.store(kFree, std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint64_t> owner_{kFree};
+};
+
+struct DeterministicReservationsOptions {
+  /// The number of items of the first round, or 0 for about 1% of them
+  uint64_t window{0};
+  /// Keep the window as is rather than adapting it to the fraction of the
+  /// items of each round that fail to commit
+  bool fixed_window{false};
+};
+
+struct DeterministicReservationsStats {
+  uint64_t rounds{0};
+  /// Commits that failed and were retried in a later round
+  uint64_t retries{0};
+};
+
+/// Run items [0, num_items) by deterministic reservations (Blelloch et al.,
+/// Internally Deterministic Parallel Algorithms Can Be Fast, PPoPP 2012), an
+/// alternative to for_each with katana::det_id for loops whose iterations
+/// can name the cells they write up front.
+///
+/// Each round takes a window: the items that failed to commit in the last
+/// round, in order, then the next items. In parallel, step.Reserve(i)
+/// reserves the ReservationCells item i needs with priority i, returning
+/// false if i has nothing left to do. Then, in parallel, step.Commit(i)
+/// checks whether i holds all of its cells (ReservedBy), releases those it
+/// holds, and either writes and returns true or returns false to retry i in
+/// the next round. No item is allocated a context, and items and cells are
+/// flat arrays.
+///
+/// Rounds, and so results, depend only on the items and the window, not on
+/// the threads. Unless the window is fixed, it halves after a round in which
+/// more than a fifth of the items failed, and doubles after one in which
+/// fewer than a tenth did, which are deterministic too.
+template <typename Step>
+DeterministicReservationsStats
+deterministic_reservations(
+    uint64_t num_items, Step& step,
+    const DeterministicReservationsOptions& opts =
+        DeterministicReservationsOptions()) {
+  DeterministicReservationsStats stats;
+  uint64_t window =
+      opts.window > 0 ? opts.window : std::max<uint64_t>(num_items / 100, 1);
+  std::vector<uint64_t> items;
+  std::vector<uint64_t> held;
+  std::vector<uint8_t> keep;
+  std::vector<uint64_t> offsets;
+
+  uint64_t next = 0;
+  uint64_t num_held = 0;
+  while (next < num_items || num_held > 0) {
+    // A window smaller than the items held back runs the earliest of them
+    uint64_t size = std::min(window, num_held + (num_items - next));
+    items.resize(std::max<uint64_t>(size, num_held));
+    keep.resize(size);
+    offsets.resize(size);
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, size),
+        [&](uint64_t i) {
+          if (i >= num_held) {
+            items[i] = next + i - num_held;
+          }
+          keep[i] = step.Reserve(items[i]);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, size),
+        [&](uint64_t i) {
+          if (keep[i]) {
+            keep[i] = !step.Commit(items[i]);
+          }
+          offsets[i] = keep[i];
+        },
+        katana::no_stats());
+
+    // Pack the items that failed, in order, ahead of those held back but
+    // not in this round
+    katana::ParallelSTL::partial_sum(
+        offsets.begin(), offsets.end(), offsets.begin());
+    uint64_t num_failed = size == 0 ? 0 : offsets[size - 1];
+    uint64_t num_unrun = size < num_held ? num_held - size : 0;
+    held.resize(num_failed + num_unrun);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, size),
+        [&](uint64_t i) {
+          if (keep[i]) {
+            held[offsets[i] - 1] = items[i];
+          }
+        },
+        katana::no_stats());
+    std::copy(
+        items.begin() + size, items.begin() + size + num_unrun,
+        held.begin() + num_failed);
+
+    next += size > num_held ? size - num_held : 0;
+    num_held = num_failed + num_unrun;
+    std::swap(items, held);
+    stats.rounds += 1;
+    stats.retries += num_failed;
+
+    if (!opts.fixed_window && size > 0) {
+      if (num_failed * 5 > size) {
+        window = std::max<uint64_t>(window / 2, 1);
+      } else if (num_failed * 10 < size) {
+        window = std::min(window * 2, std::max<uint64_t>(num_items, 1));
+      }
+    }
+  }
+  return stats;
+}
+
+}  // namespace katana
+
+#endif
@@ -26,6 +26,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_DYNAMICBITSET_H_
 #define KATANA_LIBGALOIS_KATANA_DYNAMICBITSET_H_
 
+#include <algorithm>
 #include <cassert>
 #include <climits>
 #include <vector>
@@ -41,11 +42,34 @@
 namespace katana {
 /**
  * Concurrent dynamically allocated bitset
+ *
+ * Whole-set operations (reset, count, the bitwise operations, GetOffsets)
+ * run in parallel over blocks of plain words, which the compiler can
+ * vectorize; like the bitwise operations, they assume no bit is updated
+ * while they run. Threads first touch the words of a grown bitset in the
+ * blocks that these operations later give them, so that each block lives
+ * on the NUMA node of the thread that scans it.
  **/
 class KATANA_EXPORT DynamicBitset {
   katana::PODResizeableArray<katana::CopyableAtomic<uint64_t>> bitvec_{};
   size_t num_bits_{0};
 
+  static_assert(
+      sizeof(katana::CopyableAtomic<uint64_t>) == sizeof(uint64_t),
+      "bulk operations view the atomic words as plain words");
+
+  /// The words as plain integers, for bulk operations
+  uint64_t* words() { return reinterpret_cast<uint64_t*>(bitvec_.data()); }
+  const uint64_t* words() const {
+    return reinterpret_cast<const uint64_t*>(bitvec_.data());
+  }
+
+  /// Set words [begin, end) to value in parallel
+  void FillWords(size_t begin, size_t end, uint64_t value);
+
+  /// Clear the bits of the last word past num_bits_
+  void ClearTail();
+
 public:
   static constexpr uint32_t kNumBitsInUint64 = sizeof(uint64_t) * CHAR_BIT;
 
@@ -89,7 +113,10 @@ public:
     size_t old_size = bitvec_.size();
     bitvec_.resize((n + kNumBitsInUint64 - 1) / kNumBitsInUint64);
     if (bitvec_.size() > old_size) {
-      std::fill(bitvec_.begin() + old_size, bitvec_.end(), 0);
+      FillWords(old_size, bitvec_.size(), 0);
+    } else {
+      // Bits past the end may be set from a larger size
+      ClearTail();
     }
   }
 
@@ -109,8 +136,7 @@ public:
    */
   void clear() {
     num_bits_ = 0;
-    // TODO(roshan) parallelize this.
-    std::fill(bitvec_.begin(), bitvec_.end(), 0);
+    FillWords(0, bitvec_.size(), 0);
     bitvec_.clear();
   }
 
@@ -128,7 +154,7 @@ public:
   /**
    * Unset every bit in the bitset.
    */
-  void reset() { std::fill(bitvec_.begin(), bitvec_.end(), 0); }
+  void reset() { FillWords(0, bitvec_.size(), 0); }
 
   /**
    * Unset a range of bits given an inclusive range
@@ -262,6 +288,60 @@ public:
     return (old_val & bit_offset);
   }
 
+  /**
+   * Set a bit without an atomic read-modify-write. Only for phases in which
+   * one thread alone updates the 64-bit word holding the bit, e.g., when
+   * each thread owns a word-aligned range of the bits, and no thread reads
+   * the word meanwhile expecting the update.
+   *
+   * @param index Bit to set
+   * @returns the old value
+   */
+  bool set_owned(size_t index) {
+    size_t bit_index = index / kNumBitsInUint64;
+    uint64_t bit_offset = uint64_t{1} << (index % kNumBitsInUint64);
+    uint64_t old_val = bitvec_[bit_index].load(std::memory_order_relaxed);
+    bitvec_[bit_index].store(old_val | bit_offset, std::memory_order_relaxed);
+    return (old_val & bit_offset);
+  }
+
+  /**
+   * Reset a bit without an atomic read-modify-write; see set_owned.
+   *
+   * @param index Bit to reset
+   * @returns the old value
+   */
+  bool reset_owned(size_t index) {
+    size_t bit_index = index / kNumBitsInUint64;
+    uint64_t bit_offset = uint64_t{1} << (index % kNumBitsInUint64);
+    uint64_t old_val = bitvec_[bit_index].load(std::memory_order_relaxed);
+    bitvec_[bit_index].store(old_val & ~bit_offset, std::memory_order_relaxed);
+    return (old_val & bit_offset);
+  }
+
+  /**
+   * Find the first set bit at or after index.
+   *
+   * @param index Bit to start from
+   * @returns the index of the bit, or size() if no bit from index on is set
+   */
+  size_t FindNext(size_t index) const {
+    if (index >= num_bits_) {
+      return num_bits_;
+    }
+    size_t bit_index = index / kNumBitsInUint64;
+    uint64_t word = bitvec_[bit_index].load(std::memory_order_relaxed) &
+                    (~uint64_t{0} << (index % kNumBitsInUint64));
+    while (word == 0) {
+      if (++bit_index == bitvec_.size()) {
+        return num_bits_;
+      }
+      word = bitvec_[bit_index].load(std::memory_order_relaxed);
+    }
+    size_t found = bit_index * kNumBitsInUint64 + __builtin_ctzll(word);
+    return std::min(found, num_bits_);
+  }
+
   // assumes bit_vector is not updated (set) in parallel
   void bitwise_or(const DynamicBitset& other);
 
@@ -286,6 +366,14 @@ public:
    */
   void bitwise_and(const DynamicBitset& other1, const DynamicBitset& other2);
 
+  /**
+   * Does an IN-PLACE bitwise and of this bitset and the complement of
+   * another bitset, clearing the bits set in other
+   *
+   * @param other Other bitset whose bits to clear from this one
+   */
+  void bitwise_andnot(const DynamicBitset& other);
+
   /**
    * Does an IN-PLACE bitwise xor of this bitset and another bitset
    *
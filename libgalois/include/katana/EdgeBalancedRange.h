@@ -0,0 +1,206 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EDGEBALANCEDRANGE_H_
+#define KATANA_LIBGALOIS_KATANA_EDGEBALANCEDRANGE_H_
+
+#include <algorithm>
+#include <cstdint>
+
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Range.h"
+#include "katana/ThreadPool.h"
+
+namespace katana {
+
+namespace internal {
+
+/// \returns the first of size items such that the items before it weigh at
+/// least part / num_parts of all the items, where weight(i) is the weight of
+/// the items before the i-th one, which does not decrease with i
+template <typename WeightFn>
+uint64_t
+SplitByWeight(
+    uint64_t size, unsigned part, unsigned num_parts, const WeightFn& weight) {
+  if (part >= num_parts) {
+    return size;
+  }
+  uint64_t target = weight(size) * part / num_parts;
+  uint64_t lo = 0;
+  uint64_t hi = size;
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    if (weight(mid) < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+}  // namespace internal
+
+/// A range over the nodes of a GraphTopology whose local ranges have about
+/// the same number of edges, rather than of nodes, so that threads start
+/// with the same work in loops whose operators visit the edges of a node.
+/// A node weighs its edges plus node_weight, so that nodes without edges
+/// are work too.
+///
+/// Local ranges are found by binary search of the edge index of the
+/// topology, which must outlive the range.
+class EdgeBalancedRange {
+public:
+  using Node = GraphTopology::Node;
+  using iterator = GraphTopology::node_iterator;
+  using local_iterator = iterator;
+  using value_type = Node;
+
+  explicit EdgeBalancedRange(
+      const GraphTopology& topology, uint64_t node_weight = 1)
+      : indices_(topology.out_indices->raw_values()),
+        num_nodes_(topology.num_nodes()),
+        node_weight_(node_weight) {}
+
+  iterator begin() const { return iterator(0); }
+  iterator end() const { return iterator(num_nodes_); }
+
+  local_iterator local_begin() const {
+    return iterator(Split(ThreadPool::getTID()));
+  }
+  local_iterator local_end() const {
+    return iterator(Split(ThreadPool::getTID() + 1));
+  }
+
+private:
+  Node Split(unsigned part) const {
+    return internal::SplitByWeight(
+        num_nodes_, part, katana::activeThreads, [this](uint64_t node) {
+          return (node > 0 ? indices_[node - 1] : 0) + node * node_weight_;
+        });
+  }
+
+  const uint64_t* indices_;
+  uint64_t num_nodes_;
+  uint64_t node_weight_;
+};
+
+/// \returns a range over the nodes of graph, a GraphTopology or a graph with
+///     a topology(), whose local ranges have about the same number of edges
+template <typename GraphTy>
+EdgeBalancedRange
+iterate_edge_balanced(const GraphTy& graph, uint64_t node_weight = 1) {
+  return EdgeBalancedRange(graph.topology(), node_weight);
+}
+
+inline EdgeBalancedRange
+iterate_edge_balanced(const GraphTopology& topology, uint64_t node_weight = 1) {
+  return EdgeBalancedRange(topology, node_weight);
+}
+
+/// Some of the edges of a node: [begin, end) of edges(node)
+struct EdgeTile {
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+
+  Node node;
+  Edge begin;
+  Edge end;
+
+  GraphTopology::edges_range edges() const {
+    return MakeStandardRange<GraphTopology::edge_iterator>(begin, end);
+  }
+};
+
+/// The edges of all nodes of a GraphTopology in tiles of at most
+/// max_tile_edges edges, in order of node and edge. The edges of a node of
+/// more edges are split into several tiles, so that a node with many edges
+/// is run by many threads in loops over tiles. A node without edges has one
+/// empty tile.
+///
+///     katana::EdgeTiles tiles(graph.topology(), plan.edge_tile_size());
+///     katana::do_all(
+///         katana::iterate(tiles),
+///         [&](const katana::EdgeTile& tile) {
+///           for (auto e : tile.edges()) { ... }
+///         },
+///         katana::steal());
+///
+/// As with EdgeBalancedRange, the local ranges of iterate(tiles) have about
+/// the same number of edges.
+class EdgeTiles {
+public:
+  using iterator = const EdgeTile*;
+  using local_iterator = iterator;
+  using value_type = EdgeTile;
+
+  EdgeTiles(
+      const GraphTopology& topology, uint64_t max_tile_edges,
+      uint64_t tile_weight = 1)
+      : num_edges_(topology.num_edges()), tile_weight_(tile_weight) {
+    KATANA_LOG_ASSERT(max_tile_edges > 0);
+    uint64_t num_nodes = topology.num_nodes();
+
+    // The tiles of each node and those before it
+    LargeArray<uint64_t> ends;
+    ends.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node node) {
+          auto [begin, end] = topology.edge_range(node);
+          ends[node] = std::max<uint64_t>(
+              1, (end - begin + max_tile_edges - 1) / max_tile_edges);
+        },
+        katana::no_stats());
+    ParallelSTL::partial_sum(ends.begin(), ends.end(), ends.begin());
+
+    num_tiles_ = num_nodes > 0 ? ends[num_nodes - 1] : 0;
+    tiles_.allocateBlocked(num_tiles_);
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node node) {
+          auto [begin, end] = topology.edge_range(node);
+          uint64_t tile = node > 0 ? ends[node - 1] : 0;
+          do {
+            Edge tile_end = std::min(begin + max_tile_edges, end);
+            tiles_[tile++] = EdgeTile{node, begin, tile_end};
+            begin = tile_end;
+          } while (begin < end);
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  uint64_t size() const { return num_tiles_; }
+
+  iterator begin() const { return tiles_.data(); }
+  iterator end() const { return tiles_.data() + num_tiles_; }
+
+  local_iterator local_begin() const {
+    return begin() + Split(ThreadPool::getTID());
+  }
+  local_iterator local_end() const {
+    return begin() + Split(ThreadPool::getTID() + 1);
+  }
+
+private:
+  using Node = EdgeTile::Node;
+  using Edge = EdgeTile::Edge;
+
+  uint64_t Split(unsigned part) const {
+    return internal::SplitByWeight(
+        num_tiles_, part, katana::activeThreads, [this](uint64_t tile) {
+          Edge edges = tile < num_tiles_ ? tiles_[tile].begin : num_edges_;
+          return edges + tile * tile_weight_;
+        });
+  }
+
+  LargeArray<EdgeTile> tiles_;
+  uint64_t num_tiles_;
+  uint64_t num_edges_;
+  uint64_t tile_weight_;
+};
+
+}  // namespace katana
+
+#endif
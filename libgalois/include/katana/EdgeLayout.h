@@ -0,0 +1,230 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EDGELAYOUT_H_
+#define KATANA_LIBGALOIS_KATANA_EDGELAYOUT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "katana/LargeArray.h"
+
+namespace katana {
+
+/// How LC_CSR_Graph lays out the destinations and the data of its edges in
+/// memory. A layout changes no part of the graph API.
+enum class EdgeLayout {
+  /// Destinations and data in separate arrays (struct of arrays). Loops that
+  /// read only destinations touch the least memory.
+  kSoA,
+  /// The data of each edge next to its destination (array of structs), so
+  /// that one cache miss brings both, e.g., the weight of an edge relaxed by
+  /// SSSP.
+  kAoS,
+  /// Blocks of kEdgeLayoutBlockSize edges, each holding the destinations of
+  /// its edges and then their data: destination scans stay dense while the
+  /// data of an edge is a few cache lines from its destination.
+  kBlocked,
+};
+
+/// The number of edges in a block of EdgeLayout::kBlocked
+constexpr size_t kEdgeLayoutBlockSize = 16;
+
+namespace internal {
+
+/// The destinations and data of the edges of a graph laid out together,
+/// for the layouts other than EdgeLayout::kSoA
+template <typename EdgeTy, EdgeLayout Layout>
+class InterleavedEdges {
+  static_assert(Layout != EdgeLayout::kSoA);
+  static_assert(
+      std::is_trivially_destructible_v<EdgeTy>,
+      "interleaved edge data is never destroyed");
+
+  struct Entry {
+    uint32_t dst;
+    EdgeTy data;
+  };
+
+  struct Block {
+    uint32_t dsts[kEdgeLayoutBlockSize];
+    EdgeTy data[kEdgeLayoutBlockSize];
+  };
+
+  static constexpr bool kAoS = Layout == EdgeLayout::kAoS;
+  static constexpr size_t kEdgesPerUnit = kAoS ? 1 : kEdgeLayoutBlockSize;
+  using Unit = std::conditional_t<kAoS, Entry, Block>;
+
+  LargeArray<Unit> units_;
+  size_t num_edges_{0};
+  bool allocated_{false};
+
+  static size_t NumUnits(size_t num_edges) {
+    return (num_edges + kEdgesPerUnit - 1) / kEdgesPerUnit;
+  }
+
+public:
+  /// Allocate room for num_edges edges unless the storage is already
+  /// allocated, as both columns over it allocate it
+  void allocateBlocked(size_t num_edges) {
+    if (!allocated_) {
+      units_.allocateBlocked(NumUnits(num_edges));
+      num_edges_ = num_edges;
+      allocated_ = true;
+    }
+  }
+
+  void allocateInterleaved(size_t num_edges) {
+    if (!allocated_) {
+      units_.allocateInterleaved(NumUnits(num_edges));
+      num_edges_ = num_edges;
+      allocated_ = true;
+    }
+  }
+
+  void deallocate() {
+    units_.deallocate();
+    num_edges_ = 0;
+    allocated_ = false;
+  }
+
+  size_t size() const { return num_edges_; }
+
+  uint32_t& dst(size_t e) {
+    if constexpr (kAoS) {
+      return units_[e].dst;
+    } else {
+      return units_[e / kEdgesPerUnit].dsts[e % kEdgesPerUnit];
+    }
+  }
+
+  EdgeTy& data(size_t e) {
+    if constexpr (kAoS) {
+      return units_[e].data;
+    } else {
+      return units_[e / kEdgesPerUnit].data[e % kEdgesPerUnit];
+    }
+  }
+};
+
+/// One column, the destinations (IsDst) or the data, of InterleavedEdges,
+/// with the interface of the LargeArray that holds the column in
+/// EdgeLayout::kSoA. Columns made with ShareWith share their storage.
+template <typename EdgeTy, EdgeLayout Layout, bool IsDst>
+class EdgeColumn {
+  using Storage = InterleavedEdges<EdgeTy, Layout>;
+
+  template <typename, EdgeLayout, bool>
+  friend class EdgeColumn;
+
+  std::shared_ptr<Storage> storage_;
+
+  explicit EdgeColumn(std::shared_ptr<Storage> storage)
+      : storage_(std::move(storage)) {}
+
+public:
+  using raw_value_type = std::conditional_t<IsDst, uint32_t, EdgeTy>;
+  using value_type = raw_value_type;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  static const bool has_value = true;
+
+  struct size_of {
+    const static size_t value = sizeof(value_type);
+  };
+
+  class iterator : public boost::iterator_facade<
+                       iterator, value_type, boost::random_access_traversal_tag,
+                       value_type&> {
+  public:
+    iterator() = default;
+    iterator(Storage* storage, size_t at) : storage_(storage), at_(at) {}
+
+  private:
+    friend class boost::iterator_core_access;
+
+    value_type& dereference() const {
+      if constexpr (IsDst) {
+        return storage_->dst(at_);
+      } else {
+        return storage_->data(at_);
+      }
+    }
+    bool equal(const iterator& other) const { return at_ == other.at_; }
+    void increment() { ++at_; }
+    void decrement() { --at_; }
+    void advance(ptrdiff_t n) { at_ += n; }
+    ptrdiff_t distance_to(const iterator& other) const {
+      return ptrdiff_t(other.at_) - ptrdiff_t(at_);
+    }
+
+    Storage* storage_{nullptr};
+    size_t at_{0};
+  };
+
+  EdgeColumn() : storage_(std::make_shared<Storage>()) {}
+
+  EdgeColumn(const EdgeColumn&) = delete;
+  EdgeColumn& operator=(const EdgeColumn&) = delete;
+  EdgeColumn(EdgeColumn&&) = default;
+  EdgeColumn& operator=(EdgeColumn&&) = default;
+
+  /// \returns a column of this type over the storage of other
+  template <bool OtherIsDst>
+  static EdgeColumn ShareWith(
+      const EdgeColumn<EdgeTy, Layout, OtherIsDst>& other) {
+    return EdgeColumn(other.storage_);
+  }
+
+  reference operator[](size_t e) const { return at(e); }
+
+  reference at(size_t e) const {
+    if constexpr (IsDst) {
+      return storage_->dst(e);
+    } else {
+      return storage_->data(e);
+    }
+  }
+
+  void set(size_t e, const_reference v) { at(e) = v; }
+
+  iterator begin() const { return iterator(storage_.get(), 0); }
+  iterator end() const { return iterator(storage_.get(), size()); }
+
+  size_t size() const { return storage_->size(); }
+
+  void allocateBlocked(size_t n) { storage_->allocateBlocked(n); }
+  void allocateInterleaved(size_t n) { storage_->allocateInterleaved(n); }
+  void deallocate() { storage_->deallocate(); }
+  /// Edges are trivially destructible
+  void destroy() {}
+};
+
+/// The types of the destination and data columns of the edges of a graph
+/// with layout Layout. Edges without data keep their destinations in an
+/// array of their own whatever the layout.
+template <
+    typename EdgeTy, EdgeLayout Layout,
+    bool Interleaved = Layout != EdgeLayout::kSoA && !std::is_void_v<EdgeTy>>
+struct EdgeColumns {
+  using Dst = LargeArray<uint32_t>;
+  using Data = LargeArray<EdgeTy>;
+
+  static Data MakeData(const Dst&) { return Data(); }
+};
+
+template <typename EdgeTy, EdgeLayout Layout>
+struct EdgeColumns<EdgeTy, Layout, true> {
+  using Dst = EdgeColumn<EdgeTy, Layout, true>;
+  using Data = EdgeColumn<EdgeTy, Layout, false>;
+
+  static Data MakeData(const Dst& dst) { return Data::ShareWith(dst); }
+};
+
+}  // namespace internal
+}  // namespace katana
+
+#endif
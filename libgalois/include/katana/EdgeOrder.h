@@ -0,0 +1,150 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EDGEORDER_H_
+#define KATANA_LIBGALOIS_KATANA_EDGEORDER_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PropertyGraph.h"
+
+namespace katana {
+
+/// An order of the edges of a graph for edge-centric loops, which visit a
+/// list of edges rather than the edges of each node in turn. Orders other
+/// than CSR keep consecutive edges near in both endpoints, so that the node
+/// data an edge touches is likely in cache from the edges before it.
+enum class EdgeOrder {
+  /// The edges of each node in turn, as the topology stores them
+  kCSR,
+  /// By the block of kEdgeOrderBlockSize x kEdgeOrderBlockSize in the
+  /// adjacency matrix that holds each edge, row of blocks by row of blocks,
+  /// and in CSR order within a block
+  kBlocked,
+  /// Along a Hilbert curve through the adjacency matrix, which keeps nearby
+  /// edges near in both endpoints at every scale at once
+  kHilbert,
+};
+
+/// The number of node ids in a row or column of a block of
+/// EdgeOrder::kBlocked, whose source and destination data fit in L2 cache
+constexpr uint64_t kEdgeOrderBlockSize = uint64_t{1} << 14U;
+
+/// An edge of a list of edges in some EdgeOrder
+struct OrderedEdge {
+  GraphTopology::Node src;
+  GraphTopology::Node dst;
+  /// The id of the edge in its topology, e.g., to look up its properties
+  GraphTopology::Edge id;
+};
+
+namespace internal {
+
+/// \returns the distance along the Hilbert curve through the 2^order by
+/// 2^order square of the point (x, y)
+inline uint64_t
+HilbertIndex(uint32_t order, uint64_t x, uint64_t y) {
+  uint64_t n = uint64_t{1} << order;
+  uint64_t d = 0;
+  for (uint64_t s = n / 2; s > 0; s /= 2) {
+    uint64_t rx = (x & s) != 0;
+    uint64_t ry = (y & s) != 0;
+    d += s * s * ((3 * rx) ^ ry);
+    // Rotate the quadrant so that the curve within it starts where the
+    // curve enters it
+    if (ry == 0) {
+      if (rx == 1) {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+}  // namespace internal
+
+/// \returns the edges src -> dst of topology for which keep(src, dst) is
+/// true, in order. The list is built in parallel: a pass counts the edges
+/// of each node that are kept, a pass writes them with their keys in the
+/// order and a radix sort on the keys orders them.
+template <typename KeepFn>
+LargeArray<OrderedEdge>
+OrderEdges(const GraphTopology& topology, EdgeOrder order, KeepFn keep) {
+  using Node = GraphTopology::Node;
+  const uint64_t num_nodes = topology.num_nodes();
+  const Node* dests = topology.edge_dests();
+
+  LargeArray<uint64_t> offsets;
+  offsets.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        uint64_t count = 0;
+        for (auto e : topology.edges(n)) {
+          count += keep(n, dests[e]) ? 1 : 0;
+        }
+        offsets[n] = count;
+      },
+      katana::steal(), katana::no_stats());
+  ParallelSTL::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  uint64_t num_kept = num_nodes == 0 ? 0 : offsets[num_nodes - 1];
+
+  uint32_t order_bits = 0;
+  while ((uint64_t{1} << order_bits) < num_nodes) {
+    ++order_bits;
+  }
+  uint64_t num_block_columns =
+      (num_nodes + kEdgeOrderBlockSize - 1) / kEdgeOrderBlockSize;
+  auto key_of = [&](uint64_t src, uint64_t dst) -> uint64_t {
+    if (order == EdgeOrder::kHilbert) {
+      return internal::HilbertIndex(order_bits, src, dst);
+    }
+    return (src / kEdgeOrderBlockSize) * num_block_columns +
+           dst / kEdgeOrderBlockSize;
+  };
+
+  LargeArray<OrderedEdge> edges;
+  edges.allocateBlocked(num_kept);
+  LargeArray<uint64_t> keys;
+  if (order != EdgeOrder::kCSR) {
+    keys.allocateBlocked(num_kept);
+  }
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        uint64_t pos = n == 0 ? 0 : offsets[n - 1];
+        for (auto e : topology.edges(n)) {
+          Node dst = dests[e];
+          if (!keep(n, dst)) {
+            continue;
+          }
+          edges[pos] = OrderedEdge{n, dst, e};
+          if (order != EdgeOrder::kCSR) {
+            keys[pos] = key_of(n, dst);
+          }
+          ++pos;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (order != EdgeOrder::kCSR) {
+    // Stable, so edges of a block stay in CSR order
+    ParallelSTL::radix_sort_by_key(keys.begin(), keys.end(), edges.begin());
+  }
+  return edges;
+}
+
+/// \returns all the edges of topology, in order
+inline LargeArray<OrderedEdge>
+OrderEdges(const GraphTopology& topology, EdgeOrder order) {
+  return OrderEdges(
+      topology, order,
+      [](GraphTopology::Node, GraphTopology::Node) { return true; });
+}
+
+}  // namespace katana
+
+#endif
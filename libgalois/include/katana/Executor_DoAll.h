@@ -20,9 +20,16 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
 #include "katana/Barrier.h"
+#include "katana/Cancellation.h"
 #include "katana/CompilerSpecific.h"
 #include "katana/Executor_OnEach.h"
+#include "katana/LowLatency.h"
+#include "katana/MemoryAccounting.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/PaddedLock.h"
 #include "katana/PerThreadStorage.h"
@@ -37,6 +44,92 @@ namespace katana {
 
 namespace internal {
 
+template <typename P, typename = void>
+struct PrefetchStages : std::integral_constant<unsigned, 0> {};
+
+template <typename P>
+struct PrefetchStages<P, std::void_t<decltype(P::kStages)>>
+    : std::integral_constant<unsigned, P::kStages> {};
+
+//! Issues the prefetches of a prefetch_distance trait while a thread runs
+//! the items of its ranges in order
+template <
+    typename ArgsTuple, typename Iter,
+    bool Enable = has_trait<prefetch_tag, ArgsTuple>()>
+class RangePrefetcher {
+public:
+  explicit RangePrefetcher(const ArgsTuple&) {}
+
+  void Start(const Iter&, const Iter&, const Iter&) {}
+  void Ahead(const Iter&, const Iter&) {}
+};
+
+template <typename ArgsTuple, typename Iter>
+class RangePrefetcher<ArgsTuple, Iter, true> {
+  using Trait = trait_type_t<prefetch_tag, ArgsTuple>;
+  using Prefetcher = typename Trait::type;
+  using Diff = typename std::iterator_traits<Iter>::difference_type;
+
+  static_assert(
+      std::is_base_of_v<
+          std::random_access_iterator_tag,
+          typename std::iterator_traits<Iter>::iterator_category>,
+      "prefetch_distance needs random access iterators");
+
+  constexpr static unsigned kDistance = Trait::distance;
+  //! 0 if the prefetcher takes no stage
+  constexpr static unsigned kStages = PrefetchStages<Prefetcher>::value;
+  constexpr static unsigned kNumStages = kStages == 0 ? 1 : kStages;
+
+  Prefetcher prefetcher_;
+  bool started_{false};
+  //! The end of the items run last
+  Iter next_{};
+
+  constexpr static Diff Offset(unsigned stage) {
+    return std::max(kDistance >> stage, 1u);
+  }
+
+  void Prefetch(const Iter& item, unsigned stage) {
+    if constexpr (kStages == 0) {
+      prefetcher_(*item);
+    } else {
+      prefetcher_(*item, stage);
+    }
+  }
+
+public:
+  explicit RangePrefetcher(const ArgsTuple& args)
+      : prefetcher_(get_trait_value<prefetch_tag>(args).value) {}
+
+  //! Start to run the items [begin, end) of those up to bound. Unless they
+  //! continue the items run last, the prefetches that running the items
+  //! before them would have issued are issued now.
+  void Start(const Iter& begin, const Iter& end, const Iter& bound) {
+    if (!started_ || begin != next_) {
+      // Stages in order, so that later ones read what earlier ones fetched
+      for (unsigned stage = 0; stage < kNumStages; ++stage) {
+        Diff count = std::min(Offset(stage), bound - begin);
+        for (Diff i = 0; i < count; ++i) {
+          Prefetch(begin + i, stage);
+        }
+      }
+    }
+    started_ = true;
+    next_ = end;
+  }
+
+  //! Prefetch for the items ahead of item, which runs next
+  void Ahead(const Iter& item, const Iter& bound) {
+    Diff left = bound - item;
+    for (unsigned stage = 0; stage < kNumStages; ++stage) {
+      if (Offset(stage) < left) {
+        Prefetch(item + Offset(stage), stage);
+      }
+    }
+  }
+};
+
 template <typename R, typename F, typename ArgsTuple>
 class DoAllStealingExec {
   typedef typename R::local_iterator Iter;
@@ -80,16 +173,22 @@ class DoAllStealingExec {
           m_size(std::distance(beg, end)),
           num_iter(0) {}
 
-    bool doWork(F func, const unsigned chunk_size) {
+    bool doWork(
+        F func, const unsigned chunk_size, const CancellationToken* cancel,
+        RangePrefetcher<ArgsTuple, Iter>& prefetch) {
       Iter beg(shared_beg);
       Iter end(shared_end);
+      Iter bound(shared_end);
 
       bool didwork = false;
 
-      while (getWork(beg, end, chunk_size)) {
+      while (!(cancel && cancel->IsCancelled()) &&
+             getWork(beg, end, bound, chunk_size)) {
         didwork = true;
 
+        prefetch.Start(beg, end, bound);
         for (; beg != end; ++beg) {
+          prefetch.Ahead(beg, bound);
           if (NEED_STATS) {
             ++num_iter;
           }
@@ -118,8 +217,22 @@ class DoAllStealingExec {
       return ret;
     }
 
+    //! Drop the remaining work of a cancelled loop
+    void discardWork() {
+      work_mutex.lock();
+      {
+        shared_beg = shared_end;
+        m_size = 0;
+      }
+      work_mutex.unlock();
+    }
+
   private:
-    bool getWork(Iter& priv_beg, Iter& priv_end, const unsigned chunk_size) {
+    //! Take the next chunk as [priv_beg, priv_end); priv_bound is the end of
+    //! the work left, which the items ahead of the chunk may be prefetched to
+    bool getWork(
+        Iter& priv_beg, Iter& priv_end, Iter& priv_bound,
+        const unsigned chunk_size) {
       bool succ = false;
 
       work_mutex.lock();
@@ -140,6 +253,7 @@ class DoAllStealingExec {
 
           priv_beg = shared_beg;
           priv_end = nbeg;
+          priv_bound = shared_end;
           shared_beg = nbeg;
         }
       }
@@ -357,6 +471,8 @@ private:
   F func;
   const char* loopname;
   Diff_ty chunk_size;
+  const CancellationToken* cancel;
+  RangePrefetcher<ArgsTuple, Iter> prefetch;
   PerThreadStorage<ThreadContext> workers;
 
   TerminationDetection& term;
@@ -374,7 +490,10 @@ public:
         func(_func),
         loopname(katana::internal::getLoopName(argsTuple)),
         chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
-        term(GetTerminationDetection(activeThreads)),
+        cancel(CurrentCancellationToken()),
+        prefetch(argsTuple),
+        term(GetTerminationDetection(
+            activeThreads, katana::internal::getTerminationKind(argsTuple))),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
@@ -411,6 +530,7 @@ public:
 
   void operator()(void) {
     ThreadContext& ctx = *workers.getLocal();
+    RangePrefetcher<ArgsTuple, Iter> local_prefetch(prefetch);
     totalTime.start();
 
     while (true) {
@@ -418,12 +538,18 @@ public:
 
       execTime.start();
 
-      if (ctx.doWork(func, chunk_size)) {
+      if (ctx.doWork(func, chunk_size, cancel, local_prefetch)) {
         workHappened = true;
       }
 
       execTime.stop();
 
+      if (cancel && cancel->IsCancelled()) {
+        // Other threads drop their own work when they see the cancellation
+        ctx.discardWork();
+        break;
+      }
+
       KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
 
       stealTime.start();
@@ -480,6 +606,7 @@ template <>
 struct ChooseDoAllImpl<false> {
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F func, const ArgsT& argsTuple) {
+    const CancellationToken* cancel = CurrentCancellationToken();
     on_each_gen(
         [&](const unsigned int, const unsigned int) {
           static constexpr bool NEED_STATS =
@@ -498,6 +625,7 @@ struct ChooseDoAllImpl<false> {
 
           auto begin = range.local_begin();
           const auto end = range.local_end();
+          RangePrefetcher<ArgsT, decltype(begin)> prefetch(argsTuple);
 
           initTime.stop();
 
@@ -505,10 +633,26 @@ struct ChooseDoAllImpl<false> {
 
           size_t iter = 0;
 
-          while (begin != end) {
-            func(*begin++);
-            if (NEED_STATS) {
-              ++iter;
+          prefetch.Start(begin, end, end);
+          if (!cancel) {
+            while (begin != end) {
+              prefetch.Ahead(begin, end);
+              func(*begin++);
+              if (NEED_STATS) {
+                ++iter;
+              }
+            }
+          } else {
+            const unsigned chunk_size =
+                get_trait_value<chunk_size_tag>(argsTuple).value;
+            while (begin != end && !cancel->IsCancelled()) {
+              for (unsigned i = 0; i < chunk_size && begin != end; ++i) {
+                prefetch.Ahead(begin, end);
+                func(*begin++);
+                if (NEED_STATS) {
+                  ++iter;
+                }
+              }
             }
           }
           execTime.stop();
@@ -523,6 +667,21 @@ struct ChooseDoAllImpl<false> {
   }
 };
 
+//! \returns true if the low-latency mode runs a do_all over range on the
+//! calling thread; ranges without random access are only sized by a
+//! LowLatencyRegion
+template <typename R>
+bool
+RunDoAllSerially(const R& range) {
+  using Iterator = decltype(range.begin());
+  using Category = typename std::iterator_traits<Iterator>::iterator_category;
+  if constexpr (std::is_base_of_v<std::random_access_iterator_tag, Category>) {
+    return RunLoopSerially(std::distance(range.begin(), range.end()));
+  } else {
+    return RunLoopSerially();
+  }
+}
+
 }  // end namespace internal
 
 template <typename R, typename F, typename ArgsTuple>
@@ -539,16 +698,37 @@ do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
 
   using ArgsT = decltype(argsT);
 
+  OperatorReferenceType<decltype(std::forward<F>(func))> func_ref = func;
+  if (internal::RunDoAllSerially(range)) {
+    // Small enough that waking the pool and recording statistics would
+    // cost more than the loop
+    for (auto ii = range.begin(), ei = range.end(); ii != ei; ++ii) {
+      func_ref(*ii);
+    }
+    return;
+  }
+
   constexpr bool TIME_IT = has_trait<loopname_tag, ArgsT>();
   CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(argsT));
+  internal::CondLoopMemoryStats<TIME_IT> memory(
+      katana::internal::getLoopName(argsT));
 
   timer.start();
+  memory.start();
 
   constexpr bool STEAL = has_trait<steal_tag, ArgsT>();
 
-  OperatorReferenceType<decltype(std::forward<F>(func))> func_ref = func;
-  internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
+  if (ThreadPool::isInRun()) {
+    // Nested in a parallel region, whose threads are all busy: run on this
+    // thread
+    for (auto ii = range.begin(), ei = range.end(); ii != ei; ++ii) {
+      func_ref(*ii);
+    }
+  } else {
+    internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
+  }
 
+  memory.stop();
   timer.stop();
 }
 
@@ -21,15 +21,22 @@
 #define KATANA_LIBGALOIS_KATANA_EXECUTORFOREACH_H_
 
 #include <algorithm>
+#include <deque>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <utility>
 
 #include "katana/Barrier.h"
+#include "katana/Cancellation.h"
 #include "katana/Chunk.h"
+#include "katana/ConflictThrottle.h"
 #include "katana/Context.h"
+#include "katana/LoopSampler.h"
 #include "katana/LoopStatistics.h"
+#include "katana/LowLatency.h"
 #include "katana/Mem.h"
+#include "katana/MemoryAccounting.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/Range.h"
 #include "katana/Simple.h"
@@ -150,6 +157,8 @@ public:
       !has_trait<disable_conflict_detection_tag, ArgsTy>();
   static constexpr bool needsPia = has_trait<per_iter_alloc_tag, ArgsTy>();
   static constexpr bool needsBreak = has_trait<parallel_break_tag, ArgsTy>();
+  static constexpr bool adaptive =
+      needsAborts && has_trait<adaptive_conflicts_tag, ArgsTy>();
   static constexpr bool MORE_STATS =
       needStats && has_trait<more_stats_tag, ArgsTy>();
 
@@ -167,8 +176,14 @@ protected:
   using LoopStat = LoopStatistics<needStats>;
 
   struct ThreadLocalData : public ThreadLocalBasics, public LoopStat {
-    ThreadLocalData(FunctionTy fn, const char* ln)
-        : ThreadLocalBasics(fn), LoopStat(ln) {}
+    LoopSampleCounters* sample_counters;
+    /// Iterations and conflicts of the current turn, if adaptive
+    uint64_t turn_iterations{0};
+    uint64_t turn_conflicts{0};
+
+    ThreadLocalData(
+        FunctionTy fn, const char* ln, LoopSampleCounters* counters)
+        : ThreadLocalBasics(fn), LoopStat(ln), sample_counters(counters) {}
   };
 
   // RunQueueState factors out state within runQueue iterations to protect it
@@ -189,10 +204,13 @@ protected:
   WorkListTy wl;
   FunctionTy origFunction;
   const char* loopname;
+  const CancellationToken* cancel;
   bool broke;
 
   PerThreadTimer<MORE_STATS> initTime;
   PerThreadTimer<MORE_STATS> execTime;
+  LoopSampler<needStats> sampler;
+  std::unique_ptr<ConflictThrottle> throttle;
 
   inline void commitIteration(ThreadLocalData& tld) {
     if (needsPush) {
@@ -202,6 +220,9 @@ protected:
       auto n = pb.size();
       if (n) {
         tld.inc_pushes(n);
+        if (tld.sample_counters) {
+          LoopSampleCounters::Add(&tld.sample_counters->pushes, n);
+        }
         wl.push(pb.begin(), pb.end());
         pb.clear();
       }
@@ -219,6 +240,11 @@ protected:
     KATANA_LOG_DEBUG_ASSERT(needsAborts);
     tld.ctx.cancelIteration();
     tld.inc_conflicts();
+    if (adaptive)
+      ++tld.turn_conflicts;
+    if (tld.sample_counters) {
+      LoopSampleCounters::Add(&tld.sample_counters->pushes, 1);
+    }
     aborted.push(item);
     // clear push buffer
     if (needsPush)
@@ -233,25 +259,50 @@ protected:
       tld.ctx.startIteration();
 
     tld.inc_iterations();
+    if (adaptive)
+      ++tld.turn_iterations;
+    if (tld.sample_counters) {
+      LoopSampleCounters::Add(&tld.sample_counters->pops, 1);
+    }
     tld.function(val, tld.facing.data());
     commitIteration(tld);
   }
 
-  bool runQueueSimple(ThreadLocalData& tld) {
+  //! Check for cancellation every kCancelCheckPeriod iterations. A
+  //! cancelled loop stops like one that called breakLoop.
+  bool checkCancelled(unsigned int num) {
+    constexpr unsigned int kCancelCheckPeriod = 64;
+    if (!cancel || num % kCancelCheckPeriod != 0 || !cancel->IsCancelled()) {
+      return false;
+    }
+    broke = true;
+    return true;
+  }
+
+  bool stopped() const { return (needsBreak || cancel) && broke; }
+
+  bool runQueueSimple(ThreadLocalData& tld, bool polls) {
     std::optional<value_type> p;
     bool didWork = false;
-    while ((p = wl.pop())) {
+    unsigned int num = 0;
+    while (!checkCancelled(num) && (p = wl.pop())) {
+      ++num;
       didWork = true;
       doProcess(*p, tld);
+      if (polls) {
+        sampler.Poll();
+      }
     }
     return didWork;
   }
 
-  template <unsigned int limit, typename WL>
-  void runQueueDispatch(ThreadLocalData& tld, WL& lwl, RunQueueState<WL>& s) {
+  template <typename WL>
+  void runQueueDispatch(
+      ThreadLocalData& tld, WL& lwl, RunQueueState<WL>& s, unsigned int limit) {
 #ifdef KATANA_USE_LONGJMP_ABORT
     if (setjmp(execFrame) == 0) {
-      while ((!limit || s.num < limit) && (s.item = lwl.pop())) {
+      while ((!limit || s.num < limit) && !checkCancelled(s.num) &&
+             (s.item = lwl.pop())) {
         ++s.num;
         doProcess(aborted.value(*s.item), tld);
       }
@@ -261,7 +312,8 @@ protected:
     }
 #elif defined(KATANA_USE_EXCEPTION_ABORT)
     try {
-      while ((!limit || s.num < limit) && (s.item = lwl.pop())) {
+      while ((!limit || s.num < limit) && !checkCancelled(s.num) &&
+             (s.item = lwl.pop())) {
         ++s.num;
         doProcess(aborted.value(*s.item), tld);
       }
@@ -275,16 +327,36 @@ protected:
   template <unsigned int limit, typename WL>
   bool runQueue(ThreadLocalData& tld, WL& lwl) {
     RunQueueState<WL> s;
-    runQueueDispatch<limit>(tld, lwl, s);
+    runQueueDispatch(tld, lwl, s, limit);
     return s.num > 0;
   }
 
+  //! Run a turn of at most the batch size of the throttle, once it lets this
+  //! thread. A thread waiting for a turn does not signal termination, so
+  //! that it cannot be taken for idle while it holds local work.
+  bool runThrottledTurn(ThreadLocalData& tld) {
+    if (!throttle->Acquire([this]() { return stopped(); })) {
+      return false;
+    }
+    tld.turn_iterations = 0;
+    tld.turn_conflicts = 0;
+    RunQueueState<WorkListTy> s;
+    runQueueDispatch(tld, wl, s, throttle->batch_size());
+    bool didWork = s.num > 0;
+    didWork = handleAborts(tld) || didWork;
+    throttle->Release(tld.turn_iterations, tld.turn_conflicts);
+    return didWork;
+  }
+
   KATANA_ATTRIBUTE_NOINLINE
   bool handleAborts(ThreadLocalData& tld) {
     return runQueue<0>(tld, *aborted.getQueue());
   }
 
   void fastPushBack(typename UserContextAccess<value_type>::PushBufferTy& x) {
+    if (LoopSampleCounters* counters = sampler.local()) {
+      LoopSampleCounters::Add(&counters->pushes, x.size());
+    }
     wl.push(x.begin(), x.end());
     x.clear();
   }
@@ -302,7 +374,9 @@ protected:
     execTime.start();
 
     // Thread-local data goes on the local stack to be NUMA friendly
-    ThreadLocalData tld(origFunction, loopname);
+    ThreadLocalData tld(origFunction, loopname, sampler.local());
+    // The first thread samples progress, if sampling is enabled
+    bool polls = tld.sample_counters && ThreadPool::getTID() == 0;
     if (needsBreak)
       tld.facing.setBreakFlag(&broke);
     if (couldAbort)
@@ -316,7 +390,9 @@ protected:
         bool didWork = false;
 
         // Run some iterations
-        if (couldAbort || needsBreak) {
+        if (adaptive && couldAbort) {
+          didWork = runThrottledTurn(tld);
+        } else if (couldAbort || needsBreak) {
           constexpr int __NUM = (needsBreak || isLeader) ? 64 : 0;
           bool b = runQueue<__NUM>(tld, wl);
           didWork = b || didWork;
@@ -326,21 +402,30 @@ protected:
             didWork = b || didWork;
           }
         } else {  // No try/catch
-          bool b = runQueueSimple(tld);
+          bool b = runQueueSimple(tld, polls);
           didWork = b || didWork;
         }
 
+        if (tld.sample_counters) {
+          if (!didWork) {
+            LoopSampleCounters::Add(&tld.sample_counters->idle_spins, 1);
+          }
+          if (polls) {
+            sampler.Poll();
+          }
+        }
+
         // Update node color and prop token
         term.SignalWorked(didWork);
         asmPause();  // Let token propagate
-      } while (term.Working() && (!needsBreak || !broke));
+      } while (term.Working() && !stopped());
 
       if (checkEmpty(wl, tld, 0)) {
         execTime.stop();
         break;
       }
 
-      if (needsBreak && broke) {
+      if (stopped()) {
         execTime.stop();
         break;
       }
@@ -358,14 +443,21 @@ protected:
 
   template <typename... WArgsTy>
   ForEachExecutor(T2, FunctionTy f, const ArgsTy& args, WArgsTy... wargs)
-      : term(GetTerminationDetection(activeThreads)),
+      : term(GetTerminationDetection(
+            activeThreads, katana::internal::getTerminationKind(args))),
         barrier(GetBarrier(activeThreads)),
         wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f),
         loopname(katana::internal::getLoopName(args)),
+        cancel(internal::CurrentCancellationToken()),
         broke(false),
         initTime(loopname, "Init"),
-        execTime(loopname, "Execute") {}
+        execTime(loopname, "Execute"),
+        sampler(loopname) {
+    if (adaptive) {
+      throttle = std::make_unique<ConflictThrottle>(loopname, activeThreads);
+    }
+  }
 
   template <typename WArgsTy, size_t... Is>
   ForEachExecutor(
@@ -394,6 +486,11 @@ public:
     initTime.start();
 
     wl.push_initial(range);
+    if (LoopSampleCounters* counters = sampler.local()) {
+      LoopSampleCounters::Add(
+          &counters->pushes,
+          std::distance(range.local_begin(), range.local_end()));
+    }
     term.InitializeThread();
 
     initTime.stop();
@@ -437,6 +534,36 @@ struct reiterator<
   typedef typename WLTy::template with_iterator<IterTy>::type type;
 };
 
+//! Run a for_each on the calling thread, for loops nested in a parallel
+//! region. Pushed items are processed in FIFO order.
+template <
+    typename ValueTy, typename RangeTy, typename FunctionTy, typename ArgsTy>
+void
+for_each_nested(const RangeTy& range, FunctionTy& fn, const ArgsTy&) {
+  constexpr bool needsPia = has_trait<per_iter_alloc_tag, ArgsTy>();
+  constexpr bool needsBreak = has_trait<parallel_break_tag, ArgsTy>();
+
+  std::deque<ValueTy> items(range.begin(), range.end());
+  UserContextAccess<ValueTy> facing;
+  bool broke = false;
+  if (needsBreak) {
+    facing.setBreakFlag(&broke);
+  }
+
+  while (!items.empty() && !broke) {
+    ValueTy item = std::move(items.front());
+    items.pop_front();
+    fn(item, facing.data());
+
+    auto& pb = facing.getPushBuffer();
+    items.insert(items.end(), pb.begin(), pb.end());
+    pb.clear();
+    if (needsPia) {
+      facing.resetAlloc();
+    }
+  }
+}
+
 // TODO(ddn): Think about folding in range into args too
 template <typename RangeTy, typename FunctionTy, typename ArgsTy>
 void
@@ -451,8 +578,12 @@ for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
 
-  auto& barrier = GetBarrier(activeThreads);
   FuncRefType fn_ref = fn;
+  if (ThreadPool::isInRun()) {
+    return for_each_nested<value_type>(range, fn_ref, args);
+  }
+
+  auto& barrier = GetBarrier(activeThreads);
   WorkTy W(fn_ref, args);
   W.init(range);
   GetThreadPool().run(
@@ -478,13 +609,26 @@ for_each_gen(const RangeTy& r, FunctionTy&& fn, const TupleTy& tpl) {
       get_default_trait_values(
           tpl, std::make_tuple(wl_tag{}), std::make_tuple(wl<defaultWL>())));
 
+  if (internal::RunLoopSerially()) {
+    // In a small LowLatencyRegion: skip the pool, worklists and statistics
+    using value_type =
+        typename std::iterator_traits<typename RangeTy::iterator>::value_type;
+    OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))> fn_ref = fn;
+    for_each_nested<value_type>(r, fn_ref, xtpl);
+    return;
+  }
+
   constexpr bool TIME_IT = has_trait<loopname_tag, decltype(xtpl)>();
   CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(xtpl));
+  internal::CondLoopMemoryStats<TIME_IT> memory(
+      katana::internal::getLoopName(xtpl));
 
   timer.start();
+  memory.start();
 
   for_each_impl(r, std::forward<FunctionTy>(fn), xtpl);
 
+  memory.stop();
   timer.stop();
 }
 
@@ -0,0 +1,109 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EXECUTORFUSED_H_
+#define KATANA_LIBGALOIS_KATANA_EXECUTORFUSED_H_
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Barrier.h"
+#include "katana/Cancellation.h"
+#include "katana/Executor_OnEach.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * Separates the phases of a @ref do_all_fused loop that must not overlap:
+ * every item of the phases before it is done before any item of the phases
+ * after it starts. Without one, a thread runs a phase for its items right
+ * after it ran the phase before for them, while other threads may still run
+ * the phase before.
+ */
+struct phase_barrier {};
+
+/// The phases of a @ref do_all_fused loop; see @ref phases
+template <typename... Phases>
+struct FusedPhases {
+  std::tuple<Phases...> phases;
+};
+
+/**
+ * The phases of a @ref do_all_fused loop, in order: operators that conform
+ * to <code>fn(item)</code>, and the @ref phase_barrier between those that
+ * depend on items of other threads.
+ */
+template <typename... Phases>
+FusedPhases<std::decay_t<Phases>...>
+phases(Phases&&... ps) {
+  return FusedPhases<std::decay_t<Phases>...>{
+      std::make_tuple(std::forward<Phases>(ps)...)};
+}
+
+namespace internal {
+
+template <typename Iter, typename Phase>
+void
+RunFusedPhase(
+    const Iter& begin, const Iter& end, Phase& phase, Barrier& barrier,
+    const CancellationToken* cancel) {
+  if constexpr (std::is_same_v<Phase, phase_barrier>) {
+    // Threads of a cancelled loop still wait, so that none is left behind
+    barrier.Wait();
+  } else if (!cancel) {
+    for (Iter ii = begin; ii != end; ++ii) {
+      phase(*ii);
+    }
+  } else {
+    for (Iter ii = begin; ii != end && !cancel->IsCancelled(); ++ii) {
+      phase(*ii);
+    }
+  }
+}
+
+template <typename Range, typename Phase>
+void
+RunFusedPhaseSerially(const Range& range, Phase& phase) {
+  if constexpr (!std::is_same_v<Phase, phase_barrier>) {
+    for (auto ii = range.begin(), ei = range.end(); ii != ei; ++ii) {
+      phase(*ii);
+    }
+  }
+}
+
+template <typename Range, typename PhasesTuple, typename ArgsTuple>
+void
+do_all_fused_impl(
+    const Range& range, PhasesTuple& phases, const ArgsTuple& args) {
+  if (ThreadPool::isInRun()) {
+    // Nested in a parallel region: run on this thread, phase by phase
+    std::apply(
+        [&](auto&... phase) { (RunFusedPhaseSerially(range, phase), ...); },
+        phases);
+    return;
+  }
+
+  Barrier& barrier = GetBarrier(getActiveThreads());
+  const CancellationToken* cancel = CurrentCancellationToken();
+
+  on_each_gen(
+      [&](unsigned, unsigned) {
+        // The same items for every phase, so that a phase reads what this
+        // thread wrote in the phases before without a barrier
+        auto begin = range.local_begin();
+        auto end = range.local_end();
+        std::apply(
+            [&](auto&... phase) {
+              (RunFusedPhase(begin, end, phase, barrier, cancel), ...);
+            },
+            phases);
+      },
+      args);
+}
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
@@ -20,20 +20,42 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORORDERED_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORORDERED_H_
 
+#include <iterator>
+
+#include "katana/Executor_ForEach.h"
+#include "katana/MultiQueue.h"
+#include "katana/Range.h"
+#include "katana/Traits.h"
 #include "katana/config.h"
 
 namespace katana {
 
 // TODO(ddn): Pull in and integrate in executors from exp
 
+/// Run items in approximately cmp order. The items are scheduled by a
+/// MultiQueue, so that threads do not contend on one ordered set, and each
+/// runs as a for_each iteration with conflict detection: nhFunc(item)
+/// acquires the neighborhood of item and opFunc(item, ctx) runs only if no
+/// other iteration holds any of it. An iteration that conflicts goes back to
+/// the worklist. Items may commit out of order by up to the rank error of the
+/// MultiQueue, so operators must tolerate an earlier item arriving after a
+/// later one in their neighborhood, e.g., by discarding stale events.
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
 void
 for_each_ordered_impl(
-    [[maybe_unused]] Iter beg, [[maybe_unused]] Iter end,
-    [[maybe_unused]] const Cmp& cmp, [[maybe_unused]] const NhFunc& nhFunc,
-    [[maybe_unused]] const OpFunc& opFunc,
-    [[maybe_unused]] const char* loopname) {
-  KATANA_DIE("not yet implemented");
+    Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc,
+    const OpFunc& opFunc, const char* loopname) {
+  using T = typename std::iterator_traits<Iter>::value_type;
+
+  for_each_gen(
+      katana::iterate(beg, end),
+      [&](const T& item, UserContext<T>& ctx) {
+        nhFunc(item);
+        opFunc(item, ctx);
+      },
+      std::make_tuple(
+          katana::wl<MultiQueue<Cmp, T>>(cmp),
+          katana::loopname(loopname ? loopname : "for_each_ordered")));
 }
 
 template <
@@ -0,0 +1,115 @@
+#ifndef KATANA_LIBGALOIS_KATANA_FLATTEN_H_
+#define KATANA_LIBGALOIS_KATANA_FLATTEN_H_
+
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/LargeArray.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace katana {
+
+/// Copy the items of bag into a contiguous array, in the order in which the
+/// bag iterates them. Threads count the items of each per-thread list of the
+/// bag, a prefix sum places the blocks of the lists in the array, and then
+/// blocks are copied in parallel, so no thread walks more of the bag than
+/// its share and the array is allocated blocked across threads.
+template <typename T, unsigned BlockSize>
+LargeArray<T>
+Flatten(const InsertBag<T, BlockSize>& bag) {
+  struct Block {
+    const T* begin;
+    const T* end;
+    size_t offset;
+  };
+
+  unsigned num_lists = bag.num_local_lists();
+  std::vector<size_t> list_items(num_lists + 1, 0);
+  std::vector<size_t> list_blocks(num_lists + 1, 0);
+  katana::do_all(
+      katana::iterate(0U, num_lists),
+      [&](unsigned tid) {
+        bag.ForEachLocalBlock(tid, [&](const T* begin, const T* end) {
+          list_items[tid + 1] += end - begin;
+          list_blocks[tid + 1] += 1;
+        });
+      },
+      katana::no_stats());
+  std::partial_sum(list_items.begin(), list_items.end(), list_items.begin());
+  std::partial_sum(list_blocks.begin(), list_blocks.end(), list_blocks.begin());
+
+  LargeArray<T> items;
+  if (list_items.back() == 0) {
+    return items;
+  }
+
+  std::vector<Block> blocks(list_blocks.back());
+  katana::do_all(
+      katana::iterate(0U, num_lists),
+      [&](unsigned tid) {
+        size_t block = list_blocks[tid];
+        size_t offset = list_items[tid];
+        bag.ForEachLocalBlock(tid, [&](const T* begin, const T* end) {
+          blocks[block++] = Block{begin, end, offset};
+          offset += end - begin;
+        });
+      },
+      katana::no_stats());
+
+  items.allocateBlocked(list_items.back());
+  katana::do_all(
+      katana::iterate(blocks.begin(), blocks.end()),
+      [&](const Block& block) {
+        std::uninitialized_copy(
+            block.begin, block.end, items.data() + block.offset);
+      },
+      katana::steal(), katana::no_stats());
+  return items;
+}
+
+/// Like Flatten but sorted by comp and with one copy of each run of
+/// equivalent items, e.g., to turn a bag of nodes pushed more than once
+/// into a frontier of distinct nodes.
+template <typename T, unsigned BlockSize, typename Compare = std::less<T>>
+LargeArray<T>
+FlattenSortedUnique(
+    const InsertBag<T, BlockSize>& bag, const Compare& comp = Compare()) {
+  LargeArray<T> items = Flatten(bag);
+  size_t num_items = items.size();
+  if (num_items == 0) {
+    return items;
+  }
+  katana::ParallelSTL::sort(items.begin(), items.end(), comp);
+
+  // Number the first item of each run
+  LargeArray<size_t> positions;
+  positions.allocateBlocked(num_items);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_items),
+      [&](size_t i) {
+        positions[i] = i == 0 || comp(items[i - 1], items[i]);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      positions.begin(), positions.end(), positions.begin());
+
+  LargeArray<T> unique;
+  unique.allocateBlocked(positions[num_items - 1]);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_items),
+      [&](size_t i) {
+        if (i == 0 || positions[i] != positions[i - 1]) {
+          unique.constructAt(positions[i] - 1, items[i]);
+        }
+      },
+      katana::no_stats());
+  return unique;
+}
+
+}  // namespace katana
+
+#endif
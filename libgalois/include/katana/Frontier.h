@@ -0,0 +1,126 @@
+#ifndef KATANA_LIBGALOIS_KATANA_FRONTIER_H_
+#define KATANA_LIBGALOIS_KATANA_FRONTIER_H_
+
+#include <cstdint>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Reduction.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A set of active nodes for level-synchronous graph algorithms that is
+/// stored either sparsely, as a bag of node ids, or densely, as a bitmap
+/// over all nodes.
+///
+/// Small frontiers are cheapest as a bag since iterating them costs time
+/// proportional to their size. Large frontiers are cheapest as a bitmap,
+/// which deduplicates pushes and supports membership tests. Adapt()
+/// switches to whichever fits the current size.
+///
+/// push() is thread safe in either representation. A sparse frontier may
+/// hold the same node more than once if it is pushed more than once; a
+/// dense frontier never does.
+class KATANA_EXPORT Frontier {
+public:
+  using Node = uint32_t;
+
+  /// Default fraction of the nodes above which a frontier becomes dense
+  static constexpr double kDefaultDenseFraction = 0.05;
+
+  explicit Frontier(
+      size_t num_nodes, double dense_fraction = kDefaultDenseFraction);
+
+  Frontier(const Frontier&) = delete;
+  Frontier& operator=(const Frontier&) = delete;
+
+  bool is_dense() const { return dense_; }
+  size_t num_nodes() const { return num_nodes_; }
+
+  /// Number of pushes (sparse) or members (dense) held by the frontier
+  size_t size() { return size_.reduce(); }
+  bool empty() { return size() == 0; }
+
+  /// Add a node to the frontier. Thread safe.
+  void push(Node n) {
+    if (dense_) {
+      if (!bitmap_.set(n)) {
+        size_ += 1;
+      }
+    } else {
+      bag_.push(n);
+      size_ += 1;
+    }
+  }
+
+  /// Test whether a node is in the frontier. The frontier must be dense.
+  bool test(Node n) const {
+    KATANA_LOG_DEBUG_ASSERT(dense_);
+    return bitmap_.test(n);
+  }
+
+  /// Empty the frontier, keeping its representation.
+  void clear() { Reset(dense_); }
+
+  /// Empty the frontier and switch it to the given representation.
+  void Reset(bool dense);
+
+  /// Make every node a member; the frontier becomes dense.
+  void Fill();
+
+  /// Convert to a bitmap, dropping duplicate pushes. Parallel.
+  void ToDense();
+
+  /// Convert to a bag of node ids. Parallel.
+  void ToSparse();
+
+  /// Switch representation if the size calls for it. Frontiers become dense
+  /// above dense_fraction of the nodes and become sparse again only below
+  /// half that, so that a frontier near the threshold does not flip every
+  /// round.
+  void Adapt();
+
+  void swap(Frontier& other);
+
+  /// Call fn(Node) in parallel for every node in the frontier.
+  template <typename F>
+  void ForEach(const F& fn, const char* loopname = "FrontierForEach") {
+    if (!dense_) {
+      katana::do_all(
+          katana::iterate(bag_), [&](Node n) { fn(n); }, katana::steal(),
+          katana::chunk_size<kChunkSize>(), katana::loopname(loopname));
+      return;
+    }
+
+    auto& words = bitmap_.get_vec();
+    katana::do_all(
+        katana::iterate(size_t{0}, words.size()),
+        [&](size_t i) {
+          uint64_t word = words[i];
+          while (word) {
+            Node bit = __builtin_ctzll(word);
+            fn(static_cast<Node>(i * DynamicBitset::kNumBitsInUint64 + bit));
+            word &= word - 1;
+          }
+        },
+        katana::steal(), katana::loopname(loopname));
+  }
+
+private:
+  static constexpr unsigned kChunkSize = 64;
+
+  size_t num_nodes_;
+  double dense_fraction_;
+  bool dense_{false};
+  katana::InsertBag<Node> bag_;
+  katana::DynamicBitset bitmap_;
+  katana::GAccumulator<size_t> size_;
+
+  void ClearBitmap();
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef KATANA_LIBGALOIS_KATANA_GRAPHGENERATOR_H_
+#define KATANA_LIBGALOIS_KATANA_GRAPHGENERATOR_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The families of synthetic graphs that GenerateGraph can make
+enum class GeneratedGraph {
+  /// R-MAT, a stochastic Kronecker graph: each edge picks a quadrant of the
+  /// adjacency matrix with probabilities a, b, c and 1 - a - b - c and
+  /// recurses into it, which gives the skewed degrees and the communities
+  /// within communities of social and web graphs.
+  kRmat,
+  /// LFR-like community graphs: power law degrees and community sizes, and
+  /// a fraction mixing of the edges of each node leaves its community. The
+  /// communities are ranges of consecutive nodes.
+  kLfr,
+  /// Road-like random geometric graphs: the nodes are jittered points on a
+  /// square grid, in row major order, and each edge joins a node to a node
+  /// a few grid cells away. Degrees are nearly uniform, the diameter is
+  /// large and weights are edge lengths.
+  kGeometric,
+  /// Bipartite graphs: the edges go from the nodes [0, num_left_nodes) to
+  /// the others, with the destinations skewed by bipartite_skew, like the
+  /// ratings of users for items.
+  kBipartite,
+};
+
+/// The parameters of GenerateGraph. Fields specific to one family of graphs
+/// are prefixed with its name.
+struct GraphGeneratorOptions {
+  GeneratedGraph kind{GeneratedGraph::kRmat};
+  uint64_t num_nodes{0};
+  /// The number of edges drawn. Duplicates are removed if
+  /// remove_duplicates, and a symmetric graph has each edge in both
+  /// directions, so the graph may have somewhat fewer or up to twice as
+  /// many edges. Graphs of kLfr and kGeometric get this many on average.
+  uint64_t num_edges{0};
+  /// The graph, including its properties, is a function of the options
+  /// alone, whatever the number of threads
+  uint64_t seed{0};
+  /// Add the reverse of each edge
+  bool symmetric{false};
+  bool remove_duplicates{true};
+
+  double rmat_a{0.57};
+  double rmat_b{0.19};
+  double rmat_c{0.19};
+
+  /// The exponent of the power law of degrees; greater than 2
+  double lfr_degree_exponent{2.5};
+  /// The largest degree drawn, or 0 for the smaller of num_nodes - 1 and
+  /// 10 times the average degree. Nodes of degrees larger than their
+  /// communities have fewer distinct edges within them.
+  uint64_t lfr_max_degree{0};
+  /// The exponent of the power law of community sizes; greater than 1
+  double lfr_community_exponent{1.5};
+  uint64_t lfr_min_community_size{16};
+  /// The largest community size drawn, or 0 for the larger of
+  /// lfr_min_community_size and the largest degree
+  uint64_t lfr_max_community_size{0};
+  /// The fraction of the edges of a node drawn over all nodes rather than
+  /// within its community
+  double lfr_mixing{0.1};
+
+  /// The number of source nodes, or 0 for half of the nodes
+  uint64_t bipartite_num_left_nodes{0};
+  /// Destination i of the right nodes is drawn as floor(num_right * u^skew)
+  /// for a uniform u, so 1 is uniform and larger values favor the first
+  /// destinations
+  double bipartite_skew{1.0};
+
+  /// The uint32 edge property of edge weights in [1, max_weight], or empty
+  /// for none. The weights of geometric graphs grow with the length of the
+  /// edges; the reverse of an edge has the same weight.
+  std::string weight_property;
+  uint32_t max_weight{100};
+  /// The uint32 node property of node labels, or empty for none. The label
+  /// of a node is its community in kLfr, 0 for the left and 1 for the right
+  /// nodes in kBipartite, and in [0, num_labels) otherwise.
+  std::string label_property;
+  uint32_t num_labels{16};
+};
+
+/// Generate a synthetic graph in parallel, e.g., for benchmarking and load
+/// testing, without building an edge list first. Its random draws are
+/// counter based, i.e., a hash of the seed and of what is drawn, so any
+/// thread can make any draw and the graph does not depend on the number of
+/// threads. The out-edges of each node are sorted by destination and there
+/// are no self loops.
+///
+///     katana::GraphGeneratorOptions opts;
+///     opts.num_nodes = uint64_t{1} << 30;
+///     opts.num_edges = uint64_t{10} << 30;
+///     opts.weight_property = "weight";
+///     auto pg = katana::GenerateGraph(opts);
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> GenerateGraph(
+    const GraphGeneratorOptions& opts);
+
+}  // namespace katana
+
+#endif
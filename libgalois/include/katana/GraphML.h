@@ -19,6 +19,32 @@ KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertGraphML(
     const std::string& infilename, size_t chunk_size = 25000,
     bool verbose = false);
 
+/// ConvertGraphMLStreaming converts a GraphML file into katana form like
+/// ConvertGraphML, but without holding the whole input in memory. One thread
+/// reads the file and hands off batches of chunk_size nodes or edges to the
+/// others through a bounded queue; they convert each batch to Arrow and write
+/// its tables to Parquet files in staging_directory. Once the file is read,
+/// the topology is built from the edge endpoints alone and the staged tables
+/// are read back one column at a time, so that memory use peaks at about the
+/// size of the final graph.
+///
+/// The result is the same as that of ConvertGraphML, except that
+/// placeholder nodes, for IDs that no node defines, are in order of first
+/// use.
+///
+/// \param infilename Path to source graphml file
+/// \param staging_directory Local or remote directory for the staged tables,
+///     which are removed before returning
+/// \param chunk_size Number of nodes or edges per batch, and chunk size of
+///     the resulting tables
+/// \param verbose If true, print progress to the standard out while
+///     converting.
+/// \returns A collection of Arrow tables of node properties/labels, edge
+///     properties/types, and CSR topology
+KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertGraphMLStreaming(
+    const std::string& infilename, const std::string& staging_directory,
+    size_t chunk_size = 25000, bool verbose = false);
+
 }  // end namespace katana
 
 #endif
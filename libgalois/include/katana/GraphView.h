@@ -0,0 +1,196 @@
+#ifndef KATANA_LIBGALOIS_KATANA_GRAPHVIEW_H_
+#define KATANA_LIBGALOIS_KATANA_GRAPHVIEW_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <boost/iterator/filter_iterator.hpp>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A graph view is the subgraph of a PropertyGraph made of the nodes and
+/// edges that pass its filters, read through the topology of the graph.
+/// Nothing is copied: a filter costs a bit per node or per edge, and nodes
+/// and edges keep their ids, so their properties are those of the graph.
+///
+/// An edge is in the view if it passes the edge filters and both of its
+/// endpoints are in the view. Traversals iterate the nodes of the graph,
+/// skip those not in the view, and follow edges(n), which yields only the
+/// edges in the view:
+///
+///     katana::do_all(katana::iterate(view), [&](GraphView::Node n) {
+///       if (!view.contains(n)) {
+///         return;
+///       }
+///       for (auto e : view.edges(n)) {
+///         ... view.edge_dest(e) ...
+///       }
+///     });
+///
+/// Successive filters intersect. The view refers to the graph, which must
+/// outlive it and keep its topology.
+class KATANA_EXPORT GraphView {
+  /// True for the edges in the view
+  class EdgeInView {
+  public:
+    EdgeInView() = default;
+    EdgeInView(const GraphView* view) : view_(view) {}
+
+    bool operator()(GraphTopology::Edge e) const {
+      return view_->contains_edge(e);
+    }
+
+  private:
+    const GraphView* view_{nullptr};
+  };
+
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using node_iterator = GraphTopology::node_iterator;
+  using edge_iterator =
+      boost::filter_iterator<EdgeInView, GraphTopology::edge_iterator>;
+  using edges_range = StandardRange<edge_iterator>;
+  using iterator = node_iterator;
+
+  /// The distinct ids 0 .. num_nodes() - 1 of the nodes in the view, in the
+  /// order of their ids in the graph
+  struct CompactIds {
+    static constexpr Node kNotInView = std::numeric_limits<Node>::max();
+
+    /// The compact id of each node of the graph, or kNotInView
+    LargeArray<Node> compact_ids;
+    /// The node of the graph with each compact id
+    LargeArray<Node> graph_ids;
+  };
+
+  /// A view of all of pg
+  explicit GraphView(PropertyGraph* pg);
+
+  GraphView(GraphView&&) = default;
+  GraphView& operator=(GraphView&&) = default;
+
+  PropertyGraph* graph() const { return pg_; }
+
+  const GraphTopology& topology() const { return pg_->topology(); }
+
+  /// Keep the nodes of the node type named type_name
+  Result<void> FilterNodesByType(const std::string& type_name);
+
+  /// Keep the edges of the edge type named type_name
+  Result<void> FilterEdgesByType(const std::string& type_name);
+
+  /// Keep the nodes whose boolean or uint8 node property property_name is
+  /// true (non-zero) and not null
+  Result<void> FilterNodesByProperty(const std::string& property_name);
+
+  /// Keep the edges whose boolean or uint8 edge property property_name is
+  /// true (non-zero) and not null
+  Result<void> FilterEdgesByProperty(const std::string& property_name);
+
+  /// Keep the nodes whose bit is set in nodes, of a bit per node
+  Result<void> FilterNodes(const DynamicBitset& nodes);
+
+  /// Keep the edges whose bit is set in edges, of a bit per edge
+  Result<void> FilterEdges(const DynamicBitset& edges);
+
+  /// Keep the nodes n for which predicate(n), evaluated in parallel, holds
+  template <typename Predicate>
+  void FilterNodesIf(const Predicate& predicate) {
+    Restrict(&nodes_, &all_nodes_, Mask(topology().num_nodes(), predicate));
+  }
+
+  /// Keep the edges e for which predicate(e), evaluated in parallel, holds
+  template <typename Predicate>
+  void FilterEdgesIf(const Predicate& predicate) {
+    Restrict(&edges_, &all_edges_, Mask(topology().num_edges(), predicate));
+  }
+
+  /// \returns true if node n of the graph is in the view
+  bool contains(Node n) const { return all_nodes_ || nodes_.test(n); }
+
+  /// \returns true if edge e of the graph is in the view
+  bool contains_edge(Edge e) const {
+    return (all_edges_ || edges_.test(e)) && contains(topology().edge_dest(e));
+  }
+
+  /// \returns the edges of node n in the view; none if n is not in it
+  edges_range edges(Node n) const {
+    if (!contains(n)) {
+      return MakeEdgesRange(0, 0);
+    }
+    auto [begin, end] = topology().edge_range(n);
+    return MakeEdgesRange(begin, end);
+  }
+
+  Node edge_dest(Edge e) const { return topology().edge_dest(e); }
+
+  /// The number of nodes in the view
+  uint64_t num_nodes() const;
+
+  /// The number of edges in the view; takes a parallel pass over the edges
+  /// of the nodes in the view
+  uint64_t num_edges() const;
+
+  /// \returns the compact ids of the nodes in the view, which are computed
+  ///     on first use and kept until the next filter. Not safe to call
+  ///     concurrently with itself.
+  const CompactIds& compact_ids() const;
+
+  // Standard container concepts, over the nodes of the graph
+
+  node_iterator begin() const { return topology().begin(); }
+
+  node_iterator end() const { return topology().end(); }
+
+  size_t size() const { return topology().size(); }
+
+private:
+  edges_range MakeEdgesRange(Edge begin, Edge end) const {
+    return MakeStandardRange(
+        edge_iterator(EdgeInView(this), begin, end),
+        edge_iterator(EdgeInView(this), end, end));
+  }
+
+  template <typename Predicate>
+  static DynamicBitset Mask(uint64_t size, const Predicate& predicate) {
+    DynamicBitset mask;
+    mask.resize(size);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, size),
+        [&](uint64_t i) {
+          if (predicate(i)) {
+            mask.set(i);
+          }
+        },
+        katana::no_stats());
+    return mask;
+  }
+
+  /// Intersect the filter *filter, which passes everything if *all, with
+  /// mask
+  void Restrict(DynamicBitset* filter, bool* all, DynamicBitset&& mask);
+
+  PropertyGraph* pg_;
+  /// The node filter, unless all_nodes_
+  DynamicBitset nodes_;
+  /// The edge filter, unless all_edges_; it does not account for the
+  /// endpoints of the edges
+  DynamicBitset edges_;
+  bool all_nodes_{true};
+  bool all_edges_{true};
+  mutable std::unique_ptr<CompactIds> compact_ids_;
+};
+
+}  // namespace katana
+
+#endif
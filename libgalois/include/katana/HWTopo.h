@@ -35,6 +35,8 @@ struct KATANA_EXPORT ThreadTopoInfo {
   unsigned cumulativeMaxSocket;  // max socket id seen from [0, tid]
   unsigned osContext;            // OS ID to use for thread binding
   unsigned osNumaNode;           // OS ID for numa node
+  unsigned cacheDomain;          // threads sharing a last-level cache
+  unsigned cacheDomainLeader;    // first thread id in tid's cache domain
 };
 
 struct KATANA_EXPORT MachineTopoInfo {
@@ -42,6 +44,7 @@ struct KATANA_EXPORT MachineTopoInfo {
   unsigned maxCores;
   unsigned maxSockets;
   unsigned maxNumaNodes;
+  unsigned maxCacheDomains;
 };
 
 struct KATANA_EXPORT HWTopoInfo {
@@ -52,6 +55,22 @@ struct KATANA_EXPORT HWTopoInfo {
 /**
  * getHWTopo determines the machine topology from the process information
  * exposed in /proc and /dev filesystems.
+ *
+ * Only the cpus in the affinity mask of the process are included. Under a
+ * cgroup CPU bandwidth limit (v1 or v2), e.g., a container CPU limit, only
+ * as many threads as the limit rounds up to are included, unless
+ * KATANA_IGNORE_CPU_QUOTA is set.
+ *
+ * On Linux, two environment variables control the result:
+ *
+ * - KATANA_SOCKET_DOMAIN=cache makes each last-level cache domain (e.g., an
+ *   AMD CCX or an Intel sub-NUMA cluster) a socket, so that per-socket
+ *   worklists, stealing and barriers work within a cache domain rather
+ *   than across a whole package. The default, "socket", uses packages.
+ * - KATANA_THREAD_PLACEMENT orders threads over hardware contexts: "core"
+ *   (the default) fills one context of every core, socket by socket, before
+ *   any SMT sibling; "compact" fills whole cores, SMT siblings included,
+ *   socket by socket; "scatter" deals threads round robin over sockets.
  */
 KATANA_EXPORT HWTopoInfo getHWTopo();
 
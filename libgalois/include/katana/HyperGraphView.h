@@ -0,0 +1,85 @@
+#ifndef KATANA_LIBGALOIS_KATANA_HYPERGRAPHVIEW_H_
+#define KATANA_LIBGALOIS_KATANA_HYPERGRAPHVIEW_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A hypergraph view reads a PropertyGraph as the bipartite incidence graph
+/// of a hypergraph. The first num_hyperedges nodes of the graph are the
+/// hyperedges, in CSR form: each has an out-edge to each of its pins. The
+/// other nodes are the nodes of the hypergraph and have no out-edges.
+/// Properties of hyperedges and of nodes are node properties of the graph,
+/// and properties of pins are its edge properties, so a hypergraph is
+/// stored, loaded and queried like any other PropertyGraph, without a
+/// separate file format.
+///
+/// Hypergraph nodes are numbered from zero; node_id(n) is the id of node n
+/// in the graph. The nodes incident to hyperedge h are read through its
+/// pins:
+///
+///     for (auto e : view.pins(h)) {
+///       ... view.pin_node(e) ...
+///     }
+///
+/// and the hyperedges incident to a node through the in-edge index of the
+/// graph (see PropertyGraph::GetInEdgeIndex). The view refers to the graph,
+/// which must outlive it.
+class KATANA_EXPORT HyperGraphView {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using edges_range = GraphTopology::edges_range;
+
+  /// The view of pg whose first num_hyperedges nodes are hyperedges; fails
+  /// if a node of the hypergraph has out-edges or an edge reaches a
+  /// hyperedge
+  static Result<HyperGraphView> Make(
+      PropertyGraph* pg, uint64_t num_hyperedges);
+
+  /// A new graph holding a hypergraph of num_nodes nodes, where
+  /// hyperedges[h] lists the nodes, in [0, num_nodes), of hyperedge h. The
+  /// graph has no properties; read it with Make(pg, hyperedges.size()).
+  static Result<std::unique_ptr<PropertyGraph>> MakeGraph(
+      uint64_t num_nodes, const std::vector<std::vector<Node>>& hyperedges);
+
+  PropertyGraph* graph() const { return pg_; }
+
+  uint64_t num_hyperedges() const { return num_hyperedges_; }
+
+  /// The number of nodes of the hypergraph
+  uint64_t num_nodes() const {
+    return pg_->topology().num_nodes() - num_hyperedges_;
+  }
+
+  /// The number of pins, i.e., of pairs of a hyperedge and a node in it
+  uint64_t num_pins() const { return pg_->topology().num_edges(); }
+
+  /// \returns the id in the graph of node n of the hypergraph
+  Node node_id(Node n) const { return num_hyperedges_ + n; }
+
+  /// \returns the pins of hyperedge h, as edges of the graph
+  edges_range pins(Node h) const { return pg_->topology().edges(h); }
+
+  /// \returns the node of the hypergraph of pin e
+  Node pin_node(Edge e) const {
+    return pg_->topology().edge_dest(e) - num_hyperedges_;
+  }
+
+private:
+  HyperGraphView(PropertyGraph* pg, uint64_t num_hyperedges)
+      : pg_(pg), num_hyperedges_(num_hyperedges) {}
+
+  PropertyGraph* pg_;
+  uint64_t num_hyperedges_;
+};
+
+}  // namespace katana
+
+#endif
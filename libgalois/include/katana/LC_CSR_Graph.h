@@ -24,6 +24,7 @@
 #include <type_traits>
 
 #include "katana/Details.h"
+#include "katana/EdgeLayout.h"
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
 #include "katana/GraphHelpers.h"
@@ -48,12 +49,13 @@ namespace katana {
  *
  * @tparam NodeTy data on nodes
  * @tparam EdgeTy data on out edges
+ * @tparam Layout how edge destinations and data are laid out in memory
  */
 //! [doxygennuma]
 template <
     typename NodeTy, typename EdgeTy, bool HasNoLockable = false,
     bool UseNumaAlloc = false, bool HasOutOfLineLockable = false,
-    typename FileEdgeTy = EdgeTy>
+    typename FileEdgeTy = EdgeTy, EdgeLayout Layout = EdgeLayout::kSoA>
 class LC_CSR_Graph :
     //! [doxygennuma]
     private internal::LocalIteratorFeature<UseNumaAlloc>,
@@ -72,7 +74,7 @@ public:
   struct with_node_data {
     typedef LC_CSR_Graph<
         _node_data, EdgeTy, HasNoLockable, UseNumaAlloc, HasOutOfLineLockable,
-        FileEdgeTy>
+        FileEdgeTy, Layout>
         type;
   };
 
@@ -80,7 +82,7 @@ public:
   struct with_edge_data {
     typedef LC_CSR_Graph<
         NodeTy, _edge_data, HasNoLockable, UseNumaAlloc, HasOutOfLineLockable,
-        FileEdgeTy>
+        FileEdgeTy, Layout>
         type;
   };
 
@@ -88,7 +90,7 @@ public:
   struct with_file_edge_data {
     typedef LC_CSR_Graph<
         NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc, HasOutOfLineLockable,
-        _file_edge_data>
+        _file_edge_data, Layout>
         type;
   };
 
@@ -97,13 +99,13 @@ public:
   struct with_no_lockable {
     typedef LC_CSR_Graph<
         NodeTy, EdgeTy, _has_no_lockable, UseNumaAlloc, HasOutOfLineLockable,
-        FileEdgeTy>
+        FileEdgeTy, Layout>
         type;
   };
   template <bool _has_no_lockable>
   using _with_no_lockable = LC_CSR_Graph<
       NodeTy, EdgeTy, _has_no_lockable, UseNumaAlloc, HasOutOfLineLockable,
-      FileEdgeTy>;
+      FileEdgeTy, Layout>;
 
   //! If true, use NUMA-aware graph allocation; otherwise, use NUMA interleaved
   //! allocation.
@@ -111,28 +113,37 @@ public:
   struct with_numa_alloc {
     typedef LC_CSR_Graph<
         NodeTy, EdgeTy, HasNoLockable, _use_numa_alloc, HasOutOfLineLockable,
-        FileEdgeTy>
+        FileEdgeTy, Layout>
         type;
   };
   template <bool _use_numa_alloc>
   using _with_numa_alloc = LC_CSR_Graph<
       NodeTy, EdgeTy, HasNoLockable, _use_numa_alloc, HasOutOfLineLockable,
-      FileEdgeTy>;
+      FileEdgeTy, Layout>;
 
   //! If true, store abstract locks separate from nodes
   template <bool _has_out_of_line_lockable>
   struct with_out_of_line_lockable {
     typedef LC_CSR_Graph<
         NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc, _has_out_of_line_lockable,
-        FileEdgeTy>
+        FileEdgeTy, Layout>
+        type;
+  };
+
+  //! How to lay out edge destinations and data in memory; see EdgeLayout
+  template <EdgeLayout _layout>
+  struct with_edge_layout {
+    typedef LC_CSR_Graph<
+        NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc, HasOutOfLineLockable,
+        FileEdgeTy, _layout>
         type;
   };
 
   typedef read_default_graph_tag read_tag;
 
 protected:
-  typedef LargeArray<EdgeTy> EdgeData;
-  typedef LargeArray<uint32_t> EdgeDst;
+  typedef typename internal::EdgeColumns<EdgeTy, Layout>::Data EdgeData;
+  typedef typename internal::EdgeColumns<EdgeTy, Layout>::Dst EdgeDst;
   typedef internal::NodeInfoBaseTypes<
       NodeTy, !HasNoLockable && !HasOutOfLineLockable>
       NodeInfoTypes;
@@ -161,7 +172,7 @@ protected:
   NodeData nodeData;
   EdgeIndData edgeIndData;
   EdgeDst edgeDst;
-  EdgeData edgeData;
+  EdgeData edgeData = internal::EdgeColumns<EdgeTy, Layout>::MakeData(edgeDst);
 
   uint64_t numNodes;
   uint64_t numEdges;
@@ -899,54 +910,61 @@ public:
       KATANA_DIE("failed to read file");
     }
 
-    /**
-     * Load edgeDst array
-     **/
-    KATANA_LOG_DEBUG_ASSERT(edgeDst.data());
-    if (!edgeDst.data()) {
-      KATANA_DIE("out of memory");
-    }
+    if constexpr (std::is_same_v<EdgeDst, LargeArray<uint32_t>>) {
+      /**
+       * Load edgeDst array
+       **/
+      KATANA_LOG_DEBUG_ASSERT(edgeDst.data());
+      if (!edgeDst.data()) {
+        KATANA_DIE("out of memory");
+      }
 
-    readPosition = ((4 + numNodes) * sizeof(uint64_t));
-    graphFile.seekg(readPosition);
-    if (version == 1) {
-      graphFile.read(
-          reinterpret_cast<char*>(edgeDst.data()), sizeof(uint32_t) * numEdges);
-      if (!graphFile) {
-        KATANA_DIE("failed to read file");
+      readPosition = ((4 + numNodes) * sizeof(uint64_t));
+      graphFile.seekg(readPosition);
+      if (version == 1) {
+        graphFile.read(
+            reinterpret_cast<char*>(edgeDst.data()),
+            sizeof(uint32_t) * numEdges);
+        if (!graphFile) {
+          KATANA_DIE("failed to read file");
+        }
+        readPosition =
+            ((4 + numNodes) * sizeof(uint64_t) + numEdges * sizeof(uint32_t));
+        // version 1 padding TODO make version agnostic
+        if (numEdges % 2) {
+          readPosition += sizeof(uint32_t);
+        }
+      } else if (version == 2) {
+        graphFile.read(
+            reinterpret_cast<char*>(edgeDst.data()),
+            sizeof(uint64_t) * numEdges);
+        if (!graphFile) {
+          KATANA_DIE("failed to read file");
+        }
+        readPosition =
+            ((4 + numNodes) * sizeof(uint64_t) + numEdges * sizeof(uint64_t));
+        if (numEdges % 2) {
+          readPosition += sizeof(uint64_t);
+        }
+      } else {
+        KATANA_DIE("unknown file version: ", version);
       }
-      readPosition =
-          ((4 + numNodes) * sizeof(uint64_t) + numEdges * sizeof(uint32_t));
-      // version 1 padding TODO make version agnostic
-      if (numEdges % 2) {
-        readPosition += sizeof(uint32_t);
+      /**
+       * Load edge data array
+       **/
+      KATANA_LOG_DEBUG_ASSERT(edgeData.data());
+      if (!edgeData.data()) {
+        KATANA_DIE("out of memory");
       }
-    } else if (version == 2) {
+      graphFile.seekg(readPosition);
       graphFile.read(
-          reinterpret_cast<char*>(edgeDst.data()), sizeof(uint64_t) * numEdges);
+          reinterpret_cast<char*>(edgeData.data()), sizeof(EdgeTy) * numEdges);
       if (!graphFile) {
         KATANA_DIE("failed to read file");
       }
-      readPosition =
-          ((4 + numNodes) * sizeof(uint64_t) + numEdges * sizeof(uint64_t));
-      if (numEdges % 2) {
-        readPosition += sizeof(uint64_t);
-      }
     } else {
-      KATANA_DIE("unknown file version: ", version);
-    }
-    /**
-     * Load edge data array
-     **/
-    KATANA_LOG_DEBUG_ASSERT(edgeData.data());
-    if (!edgeData.data()) {
-      KATANA_DIE("out of memory");
-    }
-    graphFile.seekg(readPosition);
-    graphFile.read(
-        reinterpret_cast<char*>(edgeData.data()), sizeof(EdgeTy) * numEdges);
-    if (!graphFile) {
-      KATANA_DIE("failed to read file");
+      readInterleavedEdgesFromGRFile(
+          graphFile, version, (4 + numNodes) * sizeof(uint64_t));
     }
 
     initializeLocalRanges();
@@ -1022,6 +1040,53 @@ public:
     initializeLocalRanges();
   }
 
+  /**
+   * Reads the edge destinations and data of a GR file, starting at
+   * readPosition, into edge columns that are not plain arrays: each column
+   * is read into an array of its own and then copied to its place.
+   */
+  void readInterleavedEdgesFromGRFile(
+      std::ifstream& graphFile, uint64_t version, uint64_t readPosition) {
+    if (version != 1 && version != 2) {
+      KATANA_DIE("unknown file version: ", version);
+    }
+    uint64_t dstSize = version == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
+    LargeArray<char> dsts;
+    LargeArray<EdgeTy> data;
+    dsts.allocateInterleaved(dstSize * numEdges);
+    data.allocateInterleaved(numEdges);
+
+    graphFile.seekg(readPosition);
+    graphFile.read(dsts.data(), dstSize * numEdges);
+    if (!graphFile) {
+      KATANA_DIE("failed to read file");
+    }
+    readPosition += dstSize * numEdges;
+    // padding to 64 bits
+    if (numEdges % 2) {
+      readPosition += dstSize;
+    }
+    graphFile.seekg(readPosition);
+    graphFile.read(
+        reinterpret_cast<char*>(data.data()), sizeof(EdgeTy) * numEdges);
+    if (!graphFile) {
+      KATANA_DIE("failed to read file");
+    }
+
+    katana::do_all(
+        katana::iterate(UINT64_C(0), numEdges),
+        [&](uint64_t e) {
+          if (version == 1) {
+            edgeDst[e] = reinterpret_cast<const uint32_t*>(dsts.data())[e];
+          } else {
+            edgeDst[e] = static_cast<uint32_t>(
+                reinterpret_cast<const uint64_t*>(dsts.data())[e]);
+          }
+          edgeData[e] = data[e];
+        },
+        katana::no_stats(), katana::loopname("READ_INTERLEAVED_EDGES"));
+  }
+
   /**
    * Given a manually created graph, initialize the local ranges on this graph
    * so that threads can iterate over a balanced number of vertices.
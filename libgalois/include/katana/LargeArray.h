@@ -21,11 +21,14 @@
 #define KATANA_LIBGALOIS_KATANA_LARGEARRAY_H_
 
 #include <utility>
+#include <vector>
 
 #include "katana/Galois.h"
+#include "katana/MemoryAccounting.h"
 #include "katana/NumaMem.h"
 #include "katana/ParallelSTL.h"
 #include "katana/config.h"
+#include "katana/gstl.h"
 
 namespace katana {
 
@@ -42,14 +45,30 @@ class LargeArray {
   LAptr real_data_;
   T* data_{};
   size_t size_{};
+  MemoryCategory category_{};
+
+  void Account() {
+    category_ = CurrentMemoryCategory();
+    AccountMemory(category_, real_data_.get_deleter().bytes);
+  }
 
   void Allocate(size_t n, AllocType t) {
     KATANA_LOG_DEBUG_ASSERT(!data_);
     size_ = n;
     switch (t) {
-    case AllocType::Blocked:
-      real_data_ = largeMallocBlocked(n * sizeof(T), activeThreads);
+    case AllocType::Blocked: {
+      // Page in by the elements that a do_all over [0, n) gives each thread
+      // rather than by splitting the bytes, which are rounded up to whole
+      // pages, so that arrays of different element types line up
+      uint64_t num = n;
+      std::vector<uint64_t> ranges(activeThreads + 1, num);
+      for (unsigned t = 0; t < activeThreads; ++t) {
+        ranges[t] = block_range(uint64_t{0}, num, t, activeThreads).first;
+      }
+      real_data_ =
+          largeMallocSpecified(n * sizeof(T), activeThreads, ranges, sizeof(T));
       break;
+    }
     case AllocType::Interleaved:
       real_data_ = largeMallocInterleaved(n * sizeof(T), activeThreads);
       break;
@@ -64,6 +83,7 @@ class LargeArray {
     };
 
     data_ = reinterpret_cast<T*>(real_data_.get());
+    Account();
   }
 
 public:
@@ -92,7 +112,10 @@ public:
   LargeArray() = default;
 
   LargeArray(LargeArray&& o) noexcept
-      : real_data_(std::move(o.real_data_)), data_(o.data_), size_(o.size_) {
+      : real_data_(std::move(o.real_data_)),
+        data_(o.data_),
+        size_(o.size_),
+        category_(o.category_) {
     o.data_ = nullptr;
     o.size_ = 0;
   }
@@ -102,6 +125,7 @@ public:
     std::swap(real_data_, tmp.real_data_);
     std::swap(data_, tmp.data_);
     std::swap(size_, tmp.size_);
+    std::swap(category_, tmp.category_);
     return *this;
   }
 
@@ -129,7 +153,8 @@ public:
   void allocateInterleaved(size_type n) { Allocate(n, AllocType::Interleaved); }
 
   /**
-   * Allocates using blocked memory policy
+   * Allocates using blocked memory policy: the pages of the elements that a
+   * do_all over [0, n) without stealing gives a thread are on its NUMA node
    *
    * @param  n         number of elements to allocate
    */
@@ -168,6 +193,7 @@ public:
 
     size_ = num;
     data_ = reinterpret_cast<T*>(real_data_.get());
+    Account();
   }
   //! [allocatefunctions]
 
@@ -178,6 +204,22 @@ public:
     }
   }
 
+  /**
+   * Constructs every element from args in parallel. Each thread constructs
+   * the elements that a do_all over [0, size()) without stealing gives it,
+   * so after allocateBlocked it is the first to write to pages on its own
+   * NUMA node, and later loops over the same range read them locally.
+   */
+  template <typename... Args>
+  void constructParallel(const Args&... args) {
+    katana::on_each([&](unsigned tid, unsigned num_threads) {
+      auto [begin, end] = block_range(size_t{0}, size_, tid, num_threads);
+      for (size_t i = begin; i < end; ++i) {
+        new (&data_[i]) T(args...);
+      }
+    });
+  }
+
   template <typename... Args>
   void constructAt(size_type n, Args&&... args) {
     new (&data_[n]) T(std::forward<Args>(args)...);
@@ -190,7 +232,18 @@ public:
     construct(std::forward<Args>(args)...);
   }
 
+  //! Allocate blocked and construct in parallel with the same placement
+  template <typename... Args>
+  void createBlocked(size_type n, const Args&... args) {
+    allocateBlocked(n);
+    constructParallel(args...);
+  }
+
   void deallocate() {
+    if (real_data_) {
+      AccountMemory(
+          category_, -static_cast<int64_t>(real_data_.get_deleter().bytes));
+    }
     real_data_.reset();
     data_ = 0;
     size_ = 0;
@@ -261,6 +314,10 @@ public:
   void constructAt(size_type, Args&&...) {}
   template <typename... Args>
   void create(size_type, Args&&...) {}
+  template <typename... Args>
+  void constructParallel(const Args&...) {}
+  template <typename... Args>
+  void createBlocked(size_type, const Args&...) {}
 
   void deallocate() {}
   void destroy() {}
@@ -269,5 +326,25 @@ public:
   pointer data() { return nullptr; }
 };
 
+/**
+ * Allocates n elements in each of arrays with the blocked policy and
+ * value-initializes them in one parallel pass, e.g., for the per-node state
+ * of an algorithm. Element i of every array is then on the NUMA node of the
+ * thread that a do_all over [0, n) without stealing gives it.
+ *
+ *     katana::CreateBlocked(num_nodes, &distances, &parents, &visited);
+ */
+template <typename... Ts>
+void
+CreateBlocked(size_t n, LargeArray<Ts>*... arrays) {
+  (arrays->allocateBlocked(n), ...);
+  katana::on_each([&](unsigned tid, unsigned num_threads) {
+    auto [begin, end] = block_range(size_t{0}, n, tid, num_threads);
+    for (size_t i = begin; i < end; ++i) {
+      (arrays->constructAt(i), ...);
+    }
+  });
+}
+
 }  // namespace katana
 #endif
@@ -0,0 +1,139 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LOOPSAMPLER_H_
+#define KATANA_LIBGALOIS_KATANA_LOOPSAMPLER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "katana/PerThreadStorage.h"
+#include "katana/Threads.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Counters of one thread in a sampled loop. Only their thread writes them,
+/// so an update is a relaxed load and store rather than an atomic
+/// read-modify-write; the sampling thread reads them while the loop runs.
+struct LoopSampleCounters {
+  std::atomic<uint64_t> pushes{0};
+  std::atomic<uint64_t> pops{0};
+  std::atomic<uint64_t> idle_spins{0};
+
+  static void Add(std::atomic<uint64_t>* counter, uint64_t n) {
+    counter->store(
+        counter->load(std::memory_order_relaxed) + n,
+        std::memory_order_relaxed);
+  }
+};
+
+/// The totals of a loop at one point in time
+struct LoopSample {
+  /// Time in the clock of StatManager::TraceTime
+  uint64_t time_usec;
+  uint64_t pushes;
+  uint64_t pops;
+  /// Idle spins of each thread so far
+  std::vector<uint64_t> idle_spins;
+};
+
+namespace internal {
+
+/// \returns the interval in microseconds at which to sample loops, from the
+///     KATANA_LOOP_SAMPLE_USEC environment variable, or 0 to not sample
+KATANA_EXPORT uint64_t LoopSampleInterval();
+
+/// \returns the current time in the clock of LoopSample::time_usec
+KATANA_EXPORT uint64_t LoopSampleTime();
+
+/// Report the samples of a loop to the StatManager
+KATANA_EXPORT void ReportLoopSamples(
+    const char* loopname, const std::vector<LoopSample>& samples);
+
+}  // namespace internal
+
+/// LoopSampler samples the progress of a parallel loop at fixed intervals:
+/// how many items are pending, how many were pushed and popped, and how
+/// often each thread spun without finding work.
+///
+/// Sampling is enabled at runtime by setting KATANA_LOOP_SAMPLE_USEC to the
+/// interval in microseconds. When it is disabled, local returns nullptr and
+/// a loop pays only for checking that. Threads count events in their own
+/// counters; one thread polls and reads every thread's counters when an
+/// interval has passed.
+template <bool Enabled>
+class LoopSampler {
+  /// Number of polls between reads of the clock
+  static constexpr uint64_t kPollsPerCheck = 64;
+
+  const char* loopname_;
+  uint64_t interval_;
+  /// Allocated only when sampling
+  std::unique_ptr<PerThreadStorage<LoopSampleCounters>> counters_;
+  std::vector<LoopSample> samples_;
+  uint64_t polls_{0};
+  uint64_t next_usec_{0};
+
+  void Sample(uint64_t now) {
+    LoopSample sample{.time_usec = now, .pushes = 0, .pops = 0};
+    for (unsigned t = 0, n = getActiveThreads(); t < n; ++t) {
+      const LoopSampleCounters* c = counters_->getRemote(t);
+      sample.pushes += c->pushes.load(std::memory_order_relaxed);
+      sample.pops += c->pops.load(std::memory_order_relaxed);
+      sample.idle_spins.emplace_back(
+          c->idle_spins.load(std::memory_order_relaxed));
+    }
+    samples_.emplace_back(std::move(sample));
+  }
+
+public:
+  explicit LoopSampler(const char* loopname)
+      : loopname_(loopname), interval_(internal::LoopSampleInterval()) {
+    if (interval_) {
+      counters_ = std::make_unique<PerThreadStorage<LoopSampleCounters>>();
+    }
+  }
+
+  LoopSampler(const LoopSampler&) = delete;
+  LoopSampler& operator=(const LoopSampler&) = delete;
+
+  ~LoopSampler() {
+    if (interval_) {
+      Sample(internal::LoopSampleTime());
+      internal::ReportLoopSamples(loopname_, samples_);
+    }
+  }
+
+  /// \returns the counters of this thread or nullptr if not sampling
+  LoopSampleCounters* local() {
+    return interval_ ? counters_->getLocal() : nullptr;
+  }
+
+  /// Take a sample if an interval has passed. Only one thread may poll.
+  void Poll() {
+    if (++polls_ % kPollsPerCheck != 0) {
+      return;
+    }
+    uint64_t now = internal::LoopSampleTime();
+    if (now < next_usec_) {
+      return;
+    }
+    next_usec_ = now + interval_;
+    Sample(now);
+  }
+};
+
+template <>
+class LoopSampler<false> {
+public:
+  explicit LoopSampler(const char*) {}
+
+  LoopSampleCounters* local() const { return nullptr; }
+
+  void Poll() const {}
+};
+
+}  // namespace katana
+
+#endif
@@ -23,6 +23,7 @@
 #include "katana/Executor_Deterministic.h"
 #include "katana/Executor_DoAll.h"
 #include "katana/Executor_ForEach.h"
+#include "katana/Executor_Fused.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Executor_Ordered.h"
 #include "katana/Executor_ParaMeter.h"
@@ -42,6 +43,10 @@ namespace katana {
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item
  * is a value from the iteration range and T is the type of item.
  *
+ * Called from an operator of another loop, it runs serially on the calling
+ * thread, processing pushed items in FIFO order; there is no nested
+ * parallelism.
+ *
  * @param range an iterator range typically returned by @ref katana::iterate
  * @param fn operator
  * @param args optional arguments to loop, e.g., {@see loopname}, {@see wl}
@@ -60,6 +65,9 @@ for_each(const Range& range, FunctionTy&& fn, Args&&... args) {
  * Operator should conform to <code>fn(item)</code> where item is a value from
  * the iteration range.
  *
+ * Called from an operator of another loop, it runs serially on the calling
+ * thread; there is no nested parallelism.
+ *
  * @param range an iterator range typically returned by @ref katana::iterate
  * @param fn operator
  * @param args optional arguments to loop
@@ -71,6 +79,36 @@ do_all(const Range& range, FunctionTy&& fn, Args&&... args) {
   do_all_gen(range, std::forward<FunctionTy>(fn), tpl);
 }
 
+/**
+ * Several do-all loops over the same range in one parallel loop, e.g.,
+ *
+ *     katana::do_all_fused(
+ *         katana::iterate(graph),
+ *         katana::phases(
+ *             [&](Node n) { delta[n] = ...; }, katana::phase_barrier(),
+ *             [&](Node n) { ... delta[dest] ...; }),
+ *         katana::loopname("Fused"));
+ *
+ * Each thread runs every phase for the items of its local range, which are
+ * the same in every phase, so a phase may read what the phases before
+ * wrote for the same item. The threads wait for each other only at a
+ * phase_barrier and once at the end, rather than after every phase, which
+ * matters for loops with little work per phase. Items are not stolen, so
+ * ranges balanced for the work of the phases, such as
+ * katana::iterate_edge_balanced, suit them best.
+ *
+ * @param range an iterator range typically returned by @ref katana::iterate
+ * @param phases phases typically returned by @ref katana::phases
+ * @param args optional arguments to loop, e.g., {@see loopname}
+ */
+template <typename Range, typename... Phases, typename... Args>
+void
+do_all_fused(
+    const Range& range, FusedPhases<Phases...> phases, Args&&... args) {
+  auto tpl = std::make_tuple(std::forward<Args>(args)...);
+  internal::do_all_fused_impl(range, phases.phases, tpl);
+}
+
 /**
  * Low-level parallel loop. Operator is applied for each running thread.
  * Operator should confirm to <code>fn(tid, numThreads)</code> where tid is
@@ -89,7 +127,14 @@ on_each(FunctionTy&& fn, Args&&... args) {
 }
 
 /**
- * Galois ordered set iterator for stable source algorithms.
+ * Galois relaxed ordered set iterator.
+ *
+ * Items run in approximately cmp order, not strictly in order: they are
+ * scheduled by a katana::MultiQueue, so an item may commit after a later one
+ * by up to the rank error of the queue, O(number of threads). Operators must
+ * tolerate an earlier item arriving after a later one in their neighborhood,
+ * e.g., by discarding stale events. An iteration that conflicts with another
+ * over its neighborhood goes back to the worklist.
  *
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item
  * is a value from the iteration range and T is the type of item. Comparison
@@ -116,6 +161,9 @@ for_each_ordered(
 /**
  * Galois ordered set iterator for unstable source algorithms.
  *
+ * Not yet implemented: the relaxed order of the overload above gives no way
+ * to decide when a source is stable, so this dies.
+ *
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item
  * is a value from the iteration range and T is the type of item. Comparison
  * function should conform to <code>bool r = cmp(item1, item2)</code> where r is
@@ -0,0 +1,95 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LOWLATENCY_H_
+#define KATANA_LIBGALOIS_KATANA_LOWLATENCY_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Settings of the low-latency mode; see EnableLowLatency
+struct LowLatencyOptions {
+  static constexpr uint64_t kDefaultSerialThreshold = 1 << 14;
+  static constexpr uint64_t kDefaultSpinUsec = 1000;
+
+  /// Loops over at most this many items, and everything in a
+  /// LowLatencyRegion of at most this size, run on the calling thread
+  uint64_t serial_threshold{kDefaultSerialThreshold};
+  /// The spin budget of the thread pool while the mode is on, so that the
+  /// threads of back-to-back large loops do not go to sleep in between
+  uint64_t spin_usec{kDefaultSpinUsec};
+  /// Keep the threads of the pool busy waiting for work until
+  /// DisableLowLatency, trading a core per thread for the lowest wakeup
+  /// latency
+  bool burn_power{false};
+};
+
+/// Turn on the low-latency mode, for services that run many small analytics
+/// per request, where the fixed cost of a parallel loop (waking the pool,
+/// timers, statistics and per-thread reductions) dominates its work.
+///
+/// While the mode is on, do_all loops over random-access ranges of at most
+/// serial_threshold items run serially on the calling thread without
+/// timers or statistics, and so does every loop, including for_each, in a
+/// LowLatencyRegion that is small enough. Larger loops run as before, on a
+/// pool kept warm as set by options.
+KATANA_EXPORT void EnableLowLatency(const LowLatencyOptions& options = {});
+
+/// Turn off the low-latency mode and restore the thread pool
+KATANA_EXPORT void DisableLowLatency();
+
+KATANA_EXPORT bool IsLowLatency();
+
+/// Within its scope on this thread, run every parallel loop serially and
+/// report no statistics if the low-latency mode is on and size, e.g., the
+/// nodes plus edges of the graph of an analytics call, is at most its
+/// serial_threshold. Regions nest; an inner region cannot make loops
+/// parallel again.
+class KATANA_EXPORT LowLatencyRegion {
+public:
+  explicit LowLatencyRegion(uint64_t size);
+  ~LowLatencyRegion();
+
+  LowLatencyRegion(const LowLatencyRegion&) = delete;
+  LowLatencyRegion& operator=(const LowLatencyRegion&) = delete;
+
+  /// \returns true if loops in this region run serially
+  bool serial() const;
+
+private:
+  bool previous_;
+};
+
+namespace internal {
+
+/// The serial_threshold of the low-latency mode, or 0 if it is off
+KATANA_EXPORT extern std::atomic<uint64_t> low_latency_threshold;
+
+/// True on a thread in a LowLatencyRegion that runs loops serially
+KATANA_EXPORT extern thread_local bool low_latency_serial;
+
+/// \returns true if a loop over iterations items runs serially
+inline bool
+RunLoopSerially(uint64_t iterations) {
+  uint64_t threshold = low_latency_threshold.load(std::memory_order_relaxed);
+  return threshold != 0 && (low_latency_serial || iterations <= threshold);
+}
+
+/// \returns true if a loop of unknown size runs serially
+inline bool
+RunLoopSerially() {
+  return low_latency_serial;
+}
+
+/// \returns true if statistics are not recorded on this thread
+inline bool
+StatsDisabled() {
+  return low_latency_serial;
+}
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
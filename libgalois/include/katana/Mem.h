@@ -20,6 +20,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_MEM_H_
 #define KATANA_LIBGALOIS_KATANA_MEM_H_
 
+#include <vector>
+
 #include "katana/Allocators.h"
 #include "katana/config.h"
 
@@ -63,6 +65,12 @@ typedef katana::BumpWithMallocHeap<katana::FreeListHeap<katana::SystemHeap>>
 typedef katana::ExternalHeapAllocator<char, IterAllocBaseTy> PerIterAllocTy;
 //! [PerIterAllocTy example]
 
+//! Vector whose storage comes from the per-iteration or per-loop allocator
+//! of a UserContext, e.g.,
+//! <code>katana::ArenaVector<int> v(ctx.getPerLoopAlloc());</code>
+template <typename T>
+using ArenaVector = std::vector<T, typename PerIterAllocTy::rebind<T>::other>;
+
 //! Scalable variable-sized allocator for T that allocates blocks of sizes in
 //! powers of 2 Useful for small and medium sized allocations, e.g. small or
 //! medium vectors, strings, deques
@@ -0,0 +1,102 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MEMORYACCOUNTING_H_
+#define KATANA_LIBGALOIS_KATANA_MEMORYACCOUNTING_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// What memory is used for. Allocators account their memory to a category:
+///
+/// - The page pool, which backs FixedSizeHeap and the other heaps of
+///   Allocators.h, and so worklist chunks and bags, to kWorklist
+/// - LargeArray to the category of the \ref MemoryCategoryScope in which it
+///   is allocated, by default kAnalytics
+/// - NumaMemoryPool, the Arrow pool of property data, to kProperty
+enum class MemoryCategory : uint8_t {
+  kAnalytics = 0,
+  kWorklist,
+  kProperty,
+  kIO,
+};
+
+constexpr size_t kNumMemoryCategories = 4;
+
+/// The bytes currently allocated for a category and the most allocated at
+/// once since the start of the program or the last ResetMemoryPeaks()
+struct MemoryUsage {
+  int64_t current{};
+  int64_t peak{};
+};
+
+KATANA_EXPORT const char* MemoryCategoryName(MemoryCategory category);
+
+/// Record that \param bytes were allocated (or, if negative, freed) for
+/// \param category. Thread safe.
+KATANA_EXPORT void AccountMemory(MemoryCategory category, int64_t bytes);
+
+KATANA_EXPORT MemoryUsage GetMemoryUsage(MemoryCategory category);
+
+/// Lower the peak of every category to its current usage
+KATANA_EXPORT void ResetMemoryPeaks();
+
+/// The category of the LargeArrays allocated by this thread
+KATANA_EXPORT MemoryCategory CurrentMemoryCategory();
+
+/// Account the LargeArrays allocated by this thread to a category while the
+/// scope lasts, e.g., to tell the arrays read for a graph (kIO) from those
+/// made by an algorithm.
+class KATANA_EXPORT MemoryCategoryScope {
+  MemoryCategory prev_;
+
+public:
+  explicit MemoryCategoryScope(MemoryCategory category);
+  ~MemoryCategoryScope();
+
+  MemoryCategoryScope(const MemoryCategoryScope&) = delete;
+  MemoryCategoryScope& operator=(const MemoryCategoryScope&) = delete;
+};
+
+/// Reports the current and peak bytes of every category as stats of region
+KATANA_EXPORT void ReportMemoryUsage(const std::string& region);
+
+namespace internal {
+
+/// Tracks the peak memory of each category during a parallel loop and
+/// reports, as stats of the loop, how far each peak rose above the memory
+/// in use when the loop started. Loops nested in a running loop are not
+/// tracked on their own.
+class KATANA_EXPORT LoopMemoryStats {
+  const char* loopname_;
+  bool active_{false};
+  int64_t start_[kNumMemoryCategories]{};
+
+public:
+  explicit LoopMemoryStats(const char* loopname) : loopname_(loopname) {}
+
+  void start();
+  void stop();
+};
+
+template <bool Enable>
+class CondLoopMemoryStats : public LoopMemoryStats {
+public:
+  using LoopMemoryStats::LoopMemoryStats;
+};
+
+template <>
+class CondLoopMemoryStats<false> {
+public:
+  explicit CondLoopMemoryStats(const char*) {}
+
+  void start() const {}
+  void stop() const {}
+};
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
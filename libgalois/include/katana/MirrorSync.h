@@ -0,0 +1,197 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MIRRORSYNC_H_
+#define KATANA_LIBGALOIS_KATANA_MIRRORSYNC_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/CommBackend.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The masters and mirrors of a partition of a graph and the exchange of
+/// node values between them, for bulk synchronous distributed algorithms.
+///
+/// Each node of a partitioned RDG is a master on the host that owns it and
+/// may have mirrors on other hosts, which hold some of its edges. Hosts
+/// compute on masters and mirrors alike, with a value per local node.
+/// Between rounds, Reduce combines the values of mirrors into their masters
+/// and Broadcast copies the values of masters to their mirrors. Only nodes
+/// marked in a bitset of updated nodes are sent: each as its position in the
+/// list of the masters one host shares with another, which both hosts hold
+/// in the same order, and its value.
+///
+/// A graph that is not partitioned is a single partition of masters.
+class KATANA_EXPORT MirrorSync {
+public:
+  using Node = GraphTopology::Node;
+
+  /// Make the synchronization of pg, the partition of comm->ID of a graph
+  /// whose partitions are loaded by the comm->Num tasks of comm
+  static Result<MirrorSync> Make(const PropertyGraph& pg, CommBackend* comm);
+
+  uint32_t num_hosts() const { return comm_->Num; }
+  uint32_t host() const { return comm_->ID; }
+
+  /// The local nodes; [0, num_masters()) are masters and the rest mirrors
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_masters() const { return num_masters_; }
+  /// The nodes of the RDG
+  uint64_t num_global_nodes() const { return num_global_nodes_; }
+
+  /// \returns the id in the RDG of local node n
+  uint64_t global_id(Node n) const {
+    return global_ids_ ? global_ids_->Value(n) : n;
+  }
+
+  /// Combine the values of the mirrors marked in updated into their
+  /// masters. reduce(master, value), with value extract(mirror) of type T,
+  /// runs on the host of the master and returns true if it changed the
+  /// master, which is then marked in updated. The values of one host are
+  /// reduced in parallel, so reduce must be atomic; e.g., atomicMin.
+  template <typename T, typename ExtractFn, typename ReduceFn>
+  Result<void> Reduce(
+      DynamicBitset* updated, ExtractFn extract, ReduceFn reduce) {
+    return Exchange<T>(mirrors_, masters_, updated, extract, reduce);
+  }
+
+  /// Copy the values of the masters marked in updated to their mirrors:
+  /// set(mirror, value), with value extract(master) of type T, runs on the
+  /// host of each mirror, which is then marked in updated
+  template <typename T, typename ExtractFn, typename SetFn>
+  Result<void> Broadcast(DynamicBitset* updated, ExtractFn extract, SetFn set) {
+    return Exchange<T>(
+        masters_, mirrors_, updated, extract, [&](Node n, const T& value) {
+          set(n, value);
+          return true;
+        });
+  }
+
+  /// \returns combine applied to value of every host, in host order, on
+  ///     every host
+  template <typename T, typename CombineFn>
+  T AllReduce(const T& value, CombineFn combine) const {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::string message(reinterpret_cast<const char*>(&value), sizeof(T));
+    std::vector<std::string> recv =
+        comm_->AllToAll(std::vector<std::string>(num_hosts(), message));
+    T result{};
+    for (uint32_t h = 0; h < num_hosts(); ++h) {
+      T other{};
+      if (recv[h].size() == sizeof(T)) {
+        std::memcpy(&other, recv[h].data(), sizeof(T));
+      }
+      result = h == 0 ? other : combine(result, other);
+    }
+    return result;
+  }
+
+  /// \returns the sum of value over all hosts
+  uint64_t SumAll(uint64_t value) const {
+    return AllReduce(value, [](uint64_t a, uint64_t b) { return a + b; });
+  }
+
+private:
+  MirrorSync(CommBackend* comm, uint64_t num_nodes)
+      : comm_(comm),
+        num_nodes_(num_nodes),
+        masters_(comm->Num),
+        mirrors_(comm->Num) {}
+
+  /// Send the values of the nodes of senders[h] marked in updated to each
+  /// host h and apply the values received from h to the nodes of
+  /// receivers[h] at the same positions
+  template <typename T, typename ExtractFn, typename ApplyFn>
+  Result<void> Exchange(
+      const std::vector<std::vector<Node>>& senders,
+      const std::vector<std::vector<Node>>& receivers, DynamicBitset* updated,
+      ExtractFn extract, ApplyFn apply) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    constexpr size_t kRecordSize = sizeof(uint32_t) + sizeof(T);
+
+    std::vector<std::string> send(num_hosts());
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_hosts()),
+        [&](uint32_t h) {
+          const std::vector<Node>& nodes = senders[h];
+          char record[kRecordSize];
+          for (uint32_t i = 0; i < nodes.size(); ++i) {
+            if (!updated->test(nodes[i])) {
+              continue;
+            }
+            T value = extract(nodes[i]);
+            std::memcpy(record, &i, sizeof(i));
+            std::memcpy(record + sizeof(i), &value, sizeof(value));
+            send[h].append(record, kRecordSize);
+          }
+        },
+        katana::no_stats());
+
+    std::vector<std::string> recv = comm_->AllToAll(send);
+
+    for (uint32_t h = 0; h < num_hosts(); ++h) {
+      const std::string& message = recv[h];
+      const std::vector<Node>& nodes = receivers[h];
+      if (message.size() % kRecordSize != 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "message of {} bytes from host {} is not of records of {} bytes",
+            message.size(), h, kRecordSize);
+      }
+      // The records of a host are for distinct nodes, so they apply in
+      // parallel
+      katana::GAccumulator<uint64_t> out_of_range;
+      katana::do_all(
+          katana::iterate(uint64_t{0}, message.size() / kRecordSize),
+          [&](uint64_t r) {
+            const char* record = message.data() + r * kRecordSize;
+            uint32_t i = 0;
+            T value;
+            std::memcpy(&i, record, sizeof(i));
+            std::memcpy(&value, record + sizeof(i), sizeof(value));
+            if (i >= nodes.size()) {
+              out_of_range += 1;
+              return;
+            }
+            if (apply(nodes[i], value)) {
+              updated->set(nodes[i]);
+            }
+          },
+          katana::no_stats());
+      if (out_of_range.reduce() > 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "{} values from host {} are for nodes it does not share",
+            out_of_range.reduce(), h);
+      }
+    }
+    return ResultSuccess();
+  }
+
+  CommBackend* comm_;
+  uint64_t num_nodes_;
+  uint64_t num_masters_{0};
+  uint64_t num_global_nodes_{0};
+  /// Null if the graph is not partitioned and local ids are global ids
+  std::shared_ptr<arrow::UInt64Array> global_ids_;
+  /// masters_[h]: the masters of this host with a mirror on host h
+  std::vector<std::vector<Node>> masters_;
+  /// mirrors_[h]: the mirrors on this host of masters of host h
+  std::vector<std::vector<Node>> mirrors_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,575 @@
+/**
+ * @file Morph_Append_Graph.h
+ *
+ * Contains the Morph_Append_Graph class.
+ */
+
+#ifndef KATANA_LIBGALOIS_KATANA_MORPHAPPENDGRAPH_H_
+#define KATANA_LIBGALOIS_KATANA_MORPHAPPENDGRAPH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/noncopyable.hpp>
+
+#include "katana/Allocators.h"
+#include "katana/Bag.h"
+#include "katana/Details.h"
+#include "katana/FileGraph.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * Graph that allows concurrent addition of nodes and out edges without locks.
+ *
+ * The edges of a node live in a chain of blocks, each twice the size of the
+ * one before it. Adding an edge claims a slot at the tail of the chain with
+ * an atomic increment, so threads adding edges to the same high-degree node
+ * do not serialize on a lock; a thread that finds the tail full links the
+ * next block with a compare-and-swap.
+ *
+ * Removing an edge only marks it removed: later iterations skip it, but its
+ * slot stays until compactEdges(), which packs the remaining edges of each
+ * node into a single block. compactEdges() must not run concurrently with
+ * any other operation on the graph; all the other operations on edges may
+ * run concurrently with each other. Iterations concurrent with additions
+ * see some subset of the edges added concurrently.
+ *
+ * Node data is acquired as in the other graphs, unless HasNoLockable.
+ *
+ * @tparam NodeTy data on nodes
+ * @tparam EdgeTy data on out edges
+ */
+template <
+    typename NodeTy, typename EdgeTy, bool HasNoLockable = false,
+    typename FileEdgeTy = EdgeTy>
+class Morph_Append_Graph : private boost::noncopyable {
+public:
+  template <typename _node_data>
+  struct with_node_data {
+    using type =
+        Morph_Append_Graph<_node_data, EdgeTy, HasNoLockable, FileEdgeTy>;
+  };
+
+  template <typename _edge_data>
+  struct with_edge_data {
+    using type =
+        Morph_Append_Graph<NodeTy, _edge_data, HasNoLockable, FileEdgeTy>;
+  };
+
+  template <typename _file_edge_data>
+  struct with_file_edge_data {
+    using type =
+        Morph_Append_Graph<NodeTy, EdgeTy, HasNoLockable, _file_edge_data>;
+  };
+
+  //! If true, do not use abstract locks in graph
+  template <bool _has_no_lockable>
+  struct with_no_lockable {
+    using type =
+        Morph_Append_Graph<NodeTy, EdgeTy, _has_no_lockable, FileEdgeTy>;
+  };
+
+  //! type that tells graph reader how to read a file for this graph
+  using read_tag = read_with_aux_graph_tag;
+
+  //! The capacity of the first edge block of a node, at least
+  static constexpr uint32_t kMinEdgeBlockSize = 4;
+
+protected:
+  class NodeInfo;
+
+  //! EdgeInfo keeps destination of edges
+  using EdgeInfo = internal::EdgeInfoBase<NodeInfo*, EdgeTy>;
+  using NodeInfoTypes = internal::NodeInfoBaseTypes<NodeTy, !HasNoLockable>;
+
+  enum SlotState : uint8_t {
+    //! Claimed by an addition that has not finished
+    kEmpty,
+    kLive,
+    kRemoved,
+  };
+
+  struct Slot {
+    std::atomic<uint8_t> state{kEmpty};
+    EdgeInfo edge;
+  };
+
+  static_assert(
+      alignof(Slot) <= alignof(double),
+      "edge data is over-aligned for the block allocator");
+
+  //! Header of a block of edge slots, which follow it in memory
+  struct EdgeBlock {
+    uint32_t capacity;
+    //! Slots claimed so far; may exceed capacity once the block is full
+    std::atomic<uint32_t> reserved{0};
+    std::atomic<EdgeBlock*> next{nullptr};
+
+    explicit EdgeBlock(uint32_t c) : capacity(c) {}
+
+    //! Number of slots claimed
+    uint32_t size() const {
+      return std::min(reserved.load(std::memory_order_acquire), capacity);
+    }
+  };
+
+  static constexpr size_t kSlotsOffset =
+      (sizeof(EdgeBlock) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+
+  static Slot* slots(EdgeBlock* block) {
+    return reinterpret_cast<Slot*>(
+        reinterpret_cast<char*>(block) + kSlotsOffset);
+  }
+
+  static size_t blockBytes(uint32_t capacity) {
+    return kSlotsOffset + sizeof(Slot) * capacity;
+  }
+
+  static EdgeBlock* allocateBlock(uint32_t capacity) {
+    void* mem =
+        Pow2BlockHeap::getInstance()->allocateBlock(blockBytes(capacity));
+    EdgeBlock* block = new (mem) EdgeBlock(capacity);
+    Slot* s = slots(block);
+    for (uint32_t i = 0; i < capacity; ++i) {
+      new (&s[i]) Slot();
+    }
+    return block;
+  }
+
+  //! Frees block, whose edges must already be destroyed
+  static void deallocateBlock(EdgeBlock* block) {
+    size_t bytes = blockBytes(block->capacity);
+    block->~EdgeBlock();
+    Pow2BlockHeap::getInstance()->deallocateBlock(block, bytes);
+  }
+
+  /**
+   * Class that stores node info (e.g. where its edges begin and end, its data,
+   * etc.).
+   */
+  class NodeInfo : public internal::NodeInfoBase<NodeTy, !HasNoLockable> {
+    using Super = internal::NodeInfoBase<NodeTy, !HasNoLockable>;
+    friend class Morph_Append_Graph;
+
+    //! First block of edges; changes only in compactEdges()
+    EdgeBlock* head;
+    //! Block to which edges are added; it or a block after it has room
+    std::atomic<EdgeBlock*> tail;
+    //! Edges marked as removed since the last compaction
+    std::atomic<uint32_t> numRemoved{0};
+
+  public:
+    //! Calls NodeInfoBase constructor
+    template <typename... Args>
+    NodeInfo(Args&&... args) : Super(std::forward<Args>(args)...) {}
+  };  // end NodeInfo
+
+  //! Functor that returns pointers to NodeInfo objects given references
+  struct makeGraphNode {
+    //! Returns a pointer to the NodeInfo reference passed into this functor
+    NodeInfo* operator()(NodeInfo& data) const { return &data; }
+  };
+
+  /**
+   * Iterator over the edges of a node that are live, i.e., added and not
+   * removed.
+   */
+  class EdgeIterator
+      : public boost::iterator_facade<
+            EdgeIterator, EdgeInfo, boost::forward_traversal_tag> {
+    friend class boost::iterator_core_access;
+    friend class Morph_Append_Graph;
+
+    EdgeBlock* block_{nullptr};
+    uint32_t at_{0};
+
+    Slot& slot() const { return slots(block_)[at_]; }
+
+    //! Advance to the first live edge at or after the current position
+    void settle() {
+      while (block_) {
+        for (uint32_t size = block_->size(); at_ < size; ++at_) {
+          if (slot().state.load(std::memory_order_acquire) == kLive) {
+            return;
+          }
+        }
+        block_ = block_->next.load(std::memory_order_acquire);
+        at_ = 0;
+      }
+    }
+
+    EdgeInfo& dereference() const { return slot().edge; }
+    bool equal(const EdgeIterator& other) const {
+      return block_ == other.block_ && at_ == other.at_;
+    }
+    void increment() {
+      ++at_;
+      settle();
+    }
+
+  public:
+    EdgeIterator() = default;
+    explicit EdgeIterator(EdgeBlock* block) : block_(block) { settle(); }
+  };
+
+  /**
+   * Functor: contains an operator to compare the destination of an edge with
+   * a particular node.
+   */
+  struct dst_equals {
+    //! Destination to compare with
+    NodeInfo* dst;
+    //! Constructor: takes a node to compare edge destinations with
+    dst_equals(NodeInfo* d) : dst(d) {}
+    bool operator()(const EdgeInfo& edge) { return edge.dst == dst; }
+  };
+
+public:
+  //! A graph node is a NodeInfo object.
+  using GraphNode = NodeInfo*;
+  //! Type of edge data in file
+  using file_edge_data_type = FileEdgeTy;
+  //! Type of edge data
+  using edge_data_type = EdgeTy;
+  //! Type of node data
+  using node_data_type = NodeTy;
+  //! Reference type to node data
+  using node_data_reference = typename NodeInfoTypes::reference;
+  //! Reference type to edge data
+  using edge_data_reference = typename EdgeInfo::reference;
+  //! Iterator over the live edges of a node
+  using edge_iterator = EdgeIterator;
+  //! Edges as a range
+  using edges_iterator = StandardRange<NoDerefIterator<edge_iterator>>;
+
+protected:
+  //! Nodes are stored in an insert bag
+  using Nodes = katana::InsertBag<NodeInfo>;
+
+public:
+  //! Iterator over nodes
+  using iterator =
+      boost::transform_iterator<makeGraphNode, typename Nodes::iterator>;
+  //! Local iterator is just an iterator
+  using local_iterator = iterator;
+  using ReadGraphAuxData = LargeArray<GraphNode>;
+
+protected:
+  //! Nodes in this graph
+  Nodes nodes;
+
+  void acquireNode(GraphNode N, MethodFlag mflag) {
+    if constexpr (!HasNoLockable) {
+      katana::acquire(N, mflag);
+    }
+  }
+
+  /**
+   * Claim a slot at the tail of the edges of src, linking a block twice the
+   * size of the tail if it is full.
+   */
+  Slot* claimSlot(GraphNode src) {
+    EdgeBlock* block = src->tail.load(std::memory_order_acquire);
+    for (;;) {
+      uint32_t at = block->reserved.fetch_add(1, std::memory_order_relaxed);
+      if (at < block->capacity) {
+        return &slots(block)[at];
+      }
+
+      EdgeBlock* next = block->next.load(std::memory_order_acquire);
+      if (!next) {
+        EdgeBlock* grown = allocateBlock(2 * block->capacity);
+        if (block->next.compare_exchange_strong(
+                next, grown, std::memory_order_acq_rel)) {
+          next = grown;
+        } else {
+          deallocateBlock(grown);
+        }
+      }
+      // Help move the tail along; failing means another thread did
+      EdgeBlock* expected = block;
+      src->tail.compare_exchange_strong(
+          expected, next, std::memory_order_acq_rel);
+      block = next;
+    }
+  }
+
+  //! Destroys the edges of block that are not empty
+  static void destroyEdges(EdgeBlock* block) {
+    if constexpr (EdgeInfo::has_value) {
+      Slot* s = slots(block);
+      for (uint32_t i = 0, size = block->size(); i < size; ++i) {
+        if (s[i].state.load(std::memory_order_relaxed) != kEmpty) {
+          s[i].edge.destroy();
+        }
+      }
+    }
+  }
+
+  /**
+   * Pack the live edges of N into a single block and free its old blocks.
+   */
+  void compactNode(GraphNode N) {
+    EdgeBlock* head = N->head;
+    if (N->numRemoved.load(std::memory_order_relaxed) == 0 &&
+        !head->next.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    uint32_t live = 0;
+    for (edge_iterator ii(head), ei; ii != ei; ++ii) {
+      ++live;
+    }
+
+    EdgeBlock* packed = allocateBlock(std::max(live, kMinEdgeBlockSize));
+    Slot* to = slots(packed);
+    for (edge_iterator ii(head), ei; ii != ei; ++ii, ++to) {
+      to->edge.dst = ii->dst;
+      if constexpr (EdgeInfo::has_value) {
+        to->edge.construct(std::move(ii->get()));
+      }
+      to->state.store(kLive, std::memory_order_relaxed);
+    }
+    packed->reserved.store(live, std::memory_order_relaxed);
+
+    for (EdgeBlock* block = head; block;) {
+      EdgeBlock* next = block->next.load(std::memory_order_relaxed);
+      destroyEdges(block);
+      deallocateBlock(block);
+      block = next;
+    }
+
+    N->head = packed;
+    N->tail.store(packed, std::memory_order_relaxed);
+    N->numRemoved.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * Given a FileGraph and an edge in it, add it to the graph.
+   */
+  void constructEdgeValue(
+      FileGraph& graph, typename FileGraph::edge_iterator nn, GraphNode src,
+      GraphNode dst) {
+    if constexpr (EdgeInfo::has_value && LargeArray<FileEdgeTy>::has_value) {
+      using FEDV = typename LargeArray<FileEdgeTy>::value_type;
+      addMultiEdge(src, dst, graph.getEdgeData<FEDV>(nn));
+    } else {
+      addMultiEdge(src, dst);
+    }
+  }
+
+public:
+  //! Destroys all edges and frees their blocks
+  ~Morph_Append_Graph() {
+    for (NodeInfo& n : nodes) {
+      for (EdgeBlock* block = n.head; block;) {
+        EdgeBlock* next = block->next.load(std::memory_order_relaxed);
+        destroyEdges(block);
+        deallocateBlock(block);
+        block = next;
+      }
+    }
+  }
+
+  /**
+   * Get the data of a node N.
+   */
+  node_data_reference getData(
+      const GraphNode& N, MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(N, mflag);
+    return N->getData();
+  }
+
+  /**
+   * Get edge data of an edge given an iterator to the edge.
+   */
+  edge_data_reference getEdgeData(const edge_iterator& ni) {
+    return ni->get();
+  }
+
+  /**
+   * Get the destination of an edge given an iterator to the edge.
+   */
+  GraphNode getEdgeDst(const edge_iterator& ni) { return GraphNode(ni->dst); }
+
+  /**
+   * Returns an iterator to all the nodes in the graph. Not thread-safe.
+   */
+  iterator begin() {
+    return boost::make_transform_iterator(nodes.begin(), makeGraphNode());
+  }
+
+  //! Returns the end of the node iterator. Not thread-safe.
+  iterator end() {
+    return boost::make_transform_iterator(nodes.end(), makeGraphNode());
+  }
+
+  //! Return an iterator to the beginning of the local nodes of the graph.
+  local_iterator local_begin() {
+    return boost::make_transform_iterator(nodes.local_begin(), makeGraphNode());
+  }
+
+  //! Return an iterator to the end of the local nodes of the graph.
+  local_iterator local_end() {
+    return boost::make_transform_iterator(nodes.local_end(), makeGraphNode());
+  }
+
+  //! Return an iterator to the first live edge of a node.
+  edge_iterator edge_begin(GraphNode N) { return edge_iterator(N->head); }
+
+  //! Return an iterator to the end of the edges of a node.
+  edge_iterator edge_end(GraphNode) { return edge_iterator(); }
+
+  /**
+   * Return a range for edges of a node for use by C++ for_each loops.
+   */
+  edges_iterator edges(GraphNode N) {
+    return internal::make_no_deref_range(edge_begin(N), edge_end(N));
+  }
+
+  /**
+   * Returns an object with begin() and end() methods to iterate over the
+   * outgoing edges of N.
+   */
+  edges_iterator out_edges(GraphNode N) { return edges(N); }
+
+  /**
+   * Creates a new node. Thread-safe.
+   *
+   * @param nedges Number of edges expected for this node; more may be added
+   * @param args Arguments required to construct a new node
+   * @returns Newly created node
+   */
+  template <typename... Args>
+  GraphNode createNode(uint32_t nedges, Args&&... args) {
+    NodeInfo* N = &nodes.emplace(std::forward<Args>(args)...);
+    N->head = allocateBlock(std::max(nedges, kMinEdgeBlockSize));
+    N->tail.store(N->head, std::memory_order_release);
+    return GraphNode(N);
+  }
+
+  /**
+   * Add an edge, which may duplicate an existing one, without locks.
+   * Thread-safe, including with other additions to the same node.
+   *
+   * @param src Source node to add edge to
+   * @param dst Destination node of new edge
+   * @param args Arguments needed to construct the data of the edge
+   */
+  template <typename... Args>
+  void addMultiEdge(GraphNode src, GraphNode dst, Args&&... args) {
+    Slot* slot = claimSlot(src);
+    slot->edge.dst = dst;
+    slot->edge.construct(std::forward<Args>(args)...);
+    slot->state.store(kLive, std::memory_order_release);
+  }
+
+  /**
+   * Mark an edge as removed. Its slot is reclaimed by compactEdges().
+   * Thread-safe; does not invalidate iterators.
+   *
+   * @returns false if the edge was already removed
+   */
+  bool removeEdge(GraphNode src, const edge_iterator& edge) {
+    uint8_t live = kLive;
+    if (!edge.slot().state.compare_exchange_strong(
+            live, kRemoved, std::memory_order_acq_rel)) {
+      return false;
+    }
+    src->numRemoved.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * Finds a live edge between 2 nodes and returns the iterator to it if it
+   * exists.
+   */
+  edge_iterator findEdge(GraphNode src, GraphNode dst) {
+    return std::find_if(edge_begin(src), edge_end(src), dst_equals(dst));
+  }
+
+  /**
+   * Pack the live edges of every node with removed edges, or with more than
+   * one block of edges, into a single block. Frees the slots of removed edges
+   * and makes iterating edges a contiguous scan.
+   *
+   * Invalidates edge iterators. Not thread-safe: must not run concurrently
+   * with any other operation on the graph; parallel internally.
+   */
+  void compactEdges() {
+    katana::do_all(
+        katana::iterate(*this), [&](GraphNode n) { compactNode(n); },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("Morph_Append_Graph::compactEdges"));
+  }
+
+  /**
+   * Allocate memory for nodes given a file graph with a particular number of
+   * nodes.
+   *
+   * @param graph FileGraph with a number of nodes to allocate
+   * @param aux Data structure in which to allocate space for nodes.
+   */
+  void allocateFrom(FileGraph& graph, ReadGraphAuxData& aux) {
+    aux.allocateInterleaved(graph.size());
+  }
+
+  /**
+   * Constructs the nodes given a FileGraph to construct it from.
+   * Meant to be called by multiple threads.
+   *
+   * @param[in] graph FileGraph to construct a morph graph from
+   * @param[in] tid Thread id of thread calling this function
+   * @param[in] total Total number of threads in current execution
+   * @param[in,out] aux Allocated memory to store pointers to the created nodes
+   */
+  void constructNodesFrom(
+      FileGraph& graph, unsigned tid, unsigned total, ReadGraphAuxData& aux) {
+    auto r =
+        graph.divideByNode(sizeof(NodeInfo), sizeof(Slot), tid, total).first;
+
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      aux[*ii] =
+          createNode(std::distance(graph.edge_begin(*ii), graph.edge_end(*ii)));
+    }
+  }
+
+  /**
+   * Constructs the edges given a FileGraph to construct it from and pointers
+   * to already created nodes. Meant to be called by multiple threads.
+   *
+   * @param[in] graph FileGraph to construct a morph graph from
+   * @param[in] tid Thread id of thread calling this function
+   * @param[in] total Total number of threads in current execution
+   * @param[in] aux Contains pointers to already created nodes to
+   * create edges for.
+   */
+  void constructEdgesFrom(
+      FileGraph& graph, unsigned tid, unsigned total,
+      const ReadGraphAuxData& aux) {
+    auto r =
+        graph.divideByNode(sizeof(NodeInfo), sizeof(Slot), tid, total).first;
+
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      for (FileGraph::edge_iterator nn = graph.edge_begin(*ii),
+                                    en = graph.edge_end(*ii);
+           nn != en; ++nn) {
+        constructEdgeValue(graph, nn, aux[*ii], aux[graph.getEdgeDst(nn)]);
+      }
+    }
+  }
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+#define KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "katana/CacheLineStorage.h"
+#include "katana/PaddedLock.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/config.h"
+
+namespace katana {
+
+extern unsigned activeThreads;
+
+/**
+ * Relaxed priority scheduling by a multiqueue (Rihani et al., MultiQueues:
+ * Simpler, Faster, and Better Relaxed Concurrent Priority Queues, SPAA 2015).
+ * The worklist is QueuesPerThread locked binary heaps for each thread. A push
+ * goes to a random heap and a pop takes the earlier, by Compare, of the
+ * fronts of two random heaps, so that no lock is shared by all threads.
+ *
+ * Items come out in approximately Compare order: the expected rank of a
+ * popped item among all items in the worklist is O(QueuesPerThread *
+ * threads) rather than 0, as with \ref OrderedList. The worklist is exact
+ * when it is not concurrent.
+ *
+ * @tparam Compare  strict weak order of items, true if the first item should
+ *                  come out first
+ */
+template <
+    class Compare = std::less<int>, typename T = int,
+    unsigned QueuesPerThread = 2, bool Concurrent = true>
+class MultiQueue : private boost::noncopyable {
+  struct Queue : private PaddedLock<Concurrent> {
+    using PaddedLock<Concurrent>::lock;
+    using PaddedLock<Concurrent>::try_lock;
+    using PaddedLock<Concurrent>::unlock;
+
+    std::vector<T> heap;
+  };
+
+  Compare compare_;
+  std::unique_ptr<CacheLineStorage<Queue>[]> queues_;
+  unsigned num_queues_;
+  PerThreadStorage<uint64_t> seeds_;
+
+  /// The heap order puts the item that should come out first at the front
+  bool Later(const T& a, const T& b) const { return compare_(b, a); }
+
+  unsigned RandomQueue() {
+    uint64_t& x = *seeds_.getLocal();
+    if (x == 0) {
+      x = (ThreadPool::getTID() + 1) * UINT64_C(0x9E3779B97F4A7C15);
+    }
+    // xorshift64
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x % num_queues_;
+  }
+
+  Queue& queue(unsigned i) { return queues_[i].get(); }
+
+  void PushLocked(Queue& q, const T& val) {
+    q.heap.push_back(val);
+    std::push_heap(
+        q.heap.begin(), q.heap.end(),
+        [this](const T& a, const T& b) { return Later(a, b); });
+  }
+
+  T PopLocked(Queue& q) {
+    std::pop_heap(
+        q.heap.begin(), q.heap.end(),
+        [this](const T& a, const T& b) { return Later(a, b); });
+    T val = std::move(q.heap.back());
+    q.heap.pop_back();
+    return val;
+  }
+
+  /// Lock a random queue, retrying others while they are held
+  Queue& LockRandom() {
+    for (;;) {
+      Queue& q = queue(RandomQueue());
+      if (q.try_lock()) {
+        return q;
+      }
+    }
+  }
+
+public:
+  template <typename Tnew>
+  using retype = MultiQueue<Compare, Tnew, QueuesPerThread, Concurrent>;
+
+  template <bool b>
+  using rethread = MultiQueue<Compare, T, QueuesPerThread, b>;
+
+  typedef T value_type;
+
+  /// The most items of a range pushed to one heap by push(b, e)
+  static constexpr unsigned kPushBatch = 64;
+
+  explicit MultiQueue(const Compare& compare = Compare())
+      : compare_(compare),
+        num_queues_(
+            Concurrent ? std::max(activeThreads, 1U) * QueuesPerThread : 1) {
+    queues_ = std::make_unique<CacheLineStorage<Queue>[]>(num_queues_);
+  }
+
+  void push(const value_type& val) {
+    Queue& q = LockRandom();
+    PushLocked(q, val);
+    q.unlock();
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    // Spread a range over heaps, a batch at a time, rather than filling one
+    while (b != e) {
+      Queue& q = LockRandom();
+      for (unsigned i = 0; i < kPushBatch && b != e; ++i) {
+        PushLocked(q, *b++);
+      }
+      q.unlock();
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    if (num_queues_ > 1) {
+      // The front of two random heaps, skipping those held or empty
+      for (unsigned tries = 0; tries < 4; ++tries) {
+        Queue& a = queue(RandomQueue());
+        if (!a.try_lock()) {
+          continue;
+        }
+        Queue& b = queue(RandomQueue());
+        if (&b == &a || !b.try_lock()) {
+          if (!a.heap.empty()) {
+            T val = PopLocked(a);
+            a.unlock();
+            return val;
+          }
+          a.unlock();
+          continue;
+        }
+        Queue* best = &a;
+        if (a.heap.empty() ||
+            (!b.heap.empty() && Later(a.heap.front(), b.heap.front()))) {
+          best = &b;
+        }
+        std::optional<value_type> val;
+        if (!best->heap.empty()) {
+          val = PopLocked(*best);
+        }
+        b.unlock();
+        a.unlock();
+        if (val) {
+          return val;
+        }
+      }
+    }
+
+    // Few items left: look at every heap before reporting empty
+    unsigned start = num_queues_ > 1 ? RandomQueue() : 0;
+    for (unsigned i = 0; i < num_queues_; ++i) {
+      Queue& q = queue((start + i) % num_queues_);
+      q.lock();
+      if (!q.heap.empty()) {
+        T val = PopLocked(q);
+        q.unlock();
+        return val;
+      }
+      q.unlock();
+    }
+    return std::nullopt;
+  }
+
+  /// Whether every heap is empty. Called after pop fails, which may miss
+  /// items pushed meanwhile.
+  bool empty() {
+    for (unsigned i = 0; i < num_queues_; ++i) {
+      Queue& q = queue(i);
+      q.lock();
+      bool queue_empty = q.heap.empty();
+      q.unlock();
+      if (!queue_empty) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+KATANA_WLCOMPILECHECK(MultiQueue)
+
+}  // end namespace katana
+
+#endif
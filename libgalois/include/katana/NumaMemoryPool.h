@@ -0,0 +1,78 @@
+#ifndef KATANA_LIBGALOIS_KATANA_NUMAMEMORYPOOL_H_
+#define KATANA_LIBGALOIS_KATANA_NUMAMEMORYPOOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <arrow/memory_pool.h>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// An arrow::MemoryPool that places large buffers like LargeArray does: on
+/// the huge pages of PageAlloc, faulted in according to a NUMA policy.
+///
+/// Buffers smaller than a huge page come from another pool, by default
+/// arrow::default_memory_pool(). Pass the pool as
+/// tsuba::RDGLoadOptions::memory_pool to load graph data into it.
+///
+/// The Blocked and Interleaved policies fault pages in with the Galois
+/// threads. Allocations made inside a parallel loop fall back to the
+/// Floating policy, and allocations from other threads must not overlap a
+/// parallel loop. Loading a graph satisfies this.
+class KATANA_EXPORT NumaMemoryPool : public arrow::MemoryPool {
+public:
+  enum class Policy {
+    /// Each thread faults in a contiguous block of a buffer
+    kBlocked,
+    /// Threads fault in the pages of a buffer round robin
+    kInterleaved,
+    /// The allocating thread faults in a buffer
+    kLocal,
+    /// Pages are faulted in by whichever thread touches them first
+    kFloating,
+  };
+
+  /// \returns the process-wide pool with \param policy. Buffers may outlive
+  /// any particular graph, so pools are never destroyed.
+  static NumaMemoryPool* Get(Policy policy);
+
+  explicit NumaMemoryPool(
+      Policy policy,
+      arrow::MemoryPool* small_pool = arrow::default_memory_pool())
+      : policy_(policy), small_pool_(small_pool) {}
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override;
+
+  arrow::Status Reallocate(
+      int64_t old_size, int64_t new_size, uint8_t** ptr) override;
+
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  int64_t bytes_allocated() const override { return bytes_allocated_; }
+
+  int64_t max_memory() const override { return max_memory_; }
+
+  std::string backend_name() const override { return "katana-numa"; }
+
+  Policy policy() const { return policy_; }
+
+private:
+  bool IsLarge(int64_t size) const;
+
+  void AddBytes(int64_t size);
+
+  Policy policy_;
+  arrow::MemoryPool* small_pool_;
+  /// Serializes faulting pages in with the Galois threads
+  std::mutex page_in_mutex_;
+  std::atomic<int64_t> bytes_allocated_{0};
+  std::atomic<int64_t> max_memory_{0};
+};
+
+}  // namespace katana
+
+#endif
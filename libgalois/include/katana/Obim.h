@@ -23,6 +23,7 @@
 #include <deque>
 #include <limits>
 #include <type_traits>
+#include <vector>
 
 #include "katana/Barrier.h"
 #include "katana/Chunk.h"
@@ -139,6 +140,14 @@ struct OrderedByIntegerMetricComparator<Index, true> {
  * @tparam UseMonotonic   Assume that an activity at priority p will not
  * schedule work at priority p or any priority p1 where p1 < p.
  * @tparam UseDescending  Use descending order instead
+ *
+ * To bound the buckets resident at once, construct the worklist with a far
+ * distance: an item whose index is more than that many buckets after the
+ * current bucket of the thread that pushes it waits in a flat per-thread
+ * buffer instead of a bucket. A thread moves the earliest of its waiting
+ * items, and those within the far distance of them, into buckets when it
+ * finds no other work, so far-future buckets do not each hold partly full
+ * chunks on every socket. Only arithmetic indices support a far distance.
  */
 // TODO could move to general comparator but there are issues with atomic reads
 // and initial values for arbitrary types
@@ -239,6 +248,7 @@ private:
     CTy* current;
     unsigned int lastMasterVersion;
     unsigned int numPops;
+    std::vector<std::pair<Index, T>> far;
 
     ThreadData(Index initial)
         : curIndex(initial),
@@ -258,6 +268,49 @@ private:
 
   std::atomic<unsigned int> masterVersion;
   Indexer indexer;
+  Index farDistance;
+
+  /// Whether index is more than farDistance buckets after the current bucket
+  bool isFar(const ThreadData& p, Index index) const {
+    if constexpr (std::is_arithmetic<Index>::value) {
+      if (farDistance == Index() || !p.current ||
+          !this->compare(p.curIndex, index)) {
+        return false;
+      }
+      Index distance = UseDescending ? p.curIndex - index : index - p.curIndex;
+      return farDistance < distance;
+    } else {
+      return false;
+    }
+  }
+
+  /// Move the earliest far items, and those near them, into buckets
+  KATANA_ATTRIBUTE_NOINLINE
+  void refillFromFar(ThreadData& p) {
+    Index first = p.far.front().first;
+    for (const auto& entry : p.far) {
+      if (this->compare(entry.first, first))
+        first = entry.first;
+    }
+    p.current = updateLocalOrCreate(p, first);
+    p.curIndex = first;
+    if (BSP && this->compare(first, p.scanStart))
+      p.scanStart = first;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < p.far.size(); ++i) {
+      if (isFar(p, p.far[i].first)) {
+        if (kept != i)
+          p.far[kept] = std::move(p.far[i]);
+        ++kept;
+      } else {
+        updateLocalOrCreate(p, p.far[i].first)->push(p.far[i].second);
+      }
+    }
+    p.far.resize(kept);
+    if (p.far.empty())
+      p.far.shrink_to_fit();
+  }
 
   bool updateLocal(ThreadData& p) {
     if (p.lastMasterVersion != masterVersion.load(std::memory_order_relaxed)) {
@@ -275,6 +328,15 @@ private:
 
   KATANA_ATTRIBUTE_NOINLINE
   std::optional<T> slowPop(ThreadData& p) {
+    std::optional<T> item = scanPop(p);
+    while (!item && !p.far.empty()) {
+      refillFromFar(p);
+      item = scanPop(p);
+    }
+    return item;
+  }
+
+  std::optional<T> scanPop(ThreadData& p) {
     bool localLeader = ThreadPool::isLeader();
     Index msS = this->earliest;
 
@@ -344,8 +406,12 @@ private:
   }
 
 public:
-  OrderedByIntegerMetric(const Indexer& x = Indexer())
-      : data(this->earliest), masterVersion(0), indexer(x) {}
+  OrderedByIntegerMetric(
+      const Indexer& x = Indexer(), Index far_distance = Index())
+      : data(this->earliest),
+        masterVersion(0),
+        indexer(x),
+        farDistance(far_distance) {}
 
   ~OrderedByIntegerMetric() {
     // Deallocate in LIFO order to give opportunity for simple garbage
@@ -367,6 +433,11 @@ public:
       return;
     }
 
+    if (isFar(p, index)) {
+      p.far.emplace_back(index, val);
+      return;
+    }
+
     // Slow path
     CTy* C = updateLocalOrCreate(p, index);
     if (BSP && this->compare(index, p.scanStart))
@@ -35,6 +35,11 @@ KATANA_EXPORT void* allocPages(unsigned num, bool preFault);
 // free page range
 KATANA_EXPORT void freePages(void* ptr, unsigned num);
 
+// return the memory of a page range to the OS but keep it mapped; the pages
+// read as zero when next touched. Returns false if the OS refused, e.g., for
+// huge pages on kernels that cannot release them.
+KATANA_EXPORT bool releasePages(void* ptr, unsigned num);
+
 }  // namespace katana
 
 #endif
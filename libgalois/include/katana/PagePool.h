@@ -20,6 +20,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PAGEPOOL_H_
 #define KATANA_LIBGALOIS_KATANA_PAGEPOOL_H_
 
+#include <chrono>
 #include <cstddef>
 #include <deque>
 #include <mutex>
@@ -43,6 +44,19 @@ KATANA_EXPORT void pagePoolFree(void*);
 KATANA_EXPORT void pagePoolPreAlloc(unsigned);
 KATANA_EXPORT void pagePoolEnsurePreallocated(unsigned num);
 
+/**
+ * Return to the OS the memory of the pages that have been free in the pool
+ * for at least idle. The pages stay mapped and in the pool, so later
+ * allocations reuse them (zeroed) before mapping new ones, but they no
+ * longer count towards the resident memory of the process.
+ *
+ * Setting KATANA_PAGE_POOL_IDLE_MS to a positive number of milliseconds
+ * makes a background thread do this periodically for pages idle that long.
+ *
+ * @returns the number of pages released
+ */
+KATANA_EXPORT size_t pagePoolReleaseIdle(std::chrono::milliseconds idle);
+
 //! Returns total large pages allocated by Galois memory management subsystem
 KATANA_EXPORT int numPagePoolAllocTotal();
 //! Returns total large pages allocated for thread by Galois memory management
@@ -53,6 +67,7 @@ namespace internal {
 
 struct FreeNode {
   FreeNode* next;
+  std::chrono::steady_clock::time_point freed;
 };
 
 typedef katana::PtrLock<FreeNode> HeadPtr;
@@ -66,6 +81,50 @@ class PageAllocState {
   std::vector<HeadPtrStorage> pool;
   std::unordered_map<void*, int> ownerMap;
   katana::SimpleLock mapLock;
+  // Pages whose memory went back to the OS, by owner
+  std::vector<std::vector<void*>> released;
+  katana::SimpleLock releasedLock;
+
+  //! Pop a page from the free list of thread tid, if any
+  void* popFree(unsigned tid) {
+    HeadPtr& hp = pool[tid].data;
+    if (!hp.getValue()) {
+      return nullptr;
+    }
+    hp.lock();
+    FreeNode* h = hp.getValue();
+    if (h) {
+      hp.unlock_and_set(h->next);
+      freeCounts[tid] -= 1;
+      return h;
+    }
+    hp.unlock();
+    return nullptr;
+  }
+
+  //! Reuse a page of thread tid or another thread on its socket, taking from
+  //! free lists before released pages
+  void* reusePage(unsigned tid) {
+    auto& tp = katana::GetThreadPool();
+    unsigned socket = tp.getSocket(tid);
+    for (unsigned i = 0; i < pool.size(); ++i) {
+      if (i != tid && tp.getSocket(i) == socket) {
+        if (void* ptr = popFree(i)) {
+          return ptr;
+        }
+      }
+    }
+    std::lock_guard<katana::SimpleLock> lg(releasedLock);
+    for (unsigned i = 0; i < pool.size(); ++i) {
+      unsigned owner = (tid + i) % pool.size();
+      if (!released[owner].empty() && tp.getSocket(owner) == socket) {
+        void* ptr = released[owner].back();
+        released[owner].pop_back();
+        return ptr;
+      }
+    }
+    return nullptr;
+  }
 
   void* allocFromOS() {
     void* ptr = katana::allocPages(1, true);
@@ -83,6 +142,7 @@ public:
     counts.resize(num);
     freeCounts.resize(num);
     pool.resize(num);
+    released.resize(num);
   }
 
   int count(unsigned tid) const { return counts[tid]; }
@@ -102,16 +162,11 @@ public:
 
   void* pageAlloc() {
     auto tid = katana::ThreadPool::getTID();
-    HeadPtr& hp = pool[tid].data;
-    if (hp.getValue()) {
-      hp.lock();
-      FreeNode* h = hp.getValue();
-      if (h) {
-        hp.unlock_and_set(h->next);
-        freeCounts[tid] -= 1;
-        return h;
-      }
-      hp.unlock();
+    if (void* ptr = popFree(tid)) {
+      return ptr;
+    }
+    if (void* ptr = reusePage(tid)) {
+      return ptr;
     }
     return allocFromOS();
   }
@@ -127,10 +182,73 @@ public:
     hp.lock();
     FreeNode* nh = reinterpret_cast<FreeNode*>(ptr);
     nh->next = hp.getValue();
+    nh->freed = std::chrono::steady_clock::now();
     hp.unlock_and_set(nh);
   }
 
-  void pagePreAlloc() { pageFree(allocFromOS()); }
+  void pagePreAlloc() {
+    auto tid = katana::ThreadPool::getTID();
+    void* ptr = nullptr;
+    {
+      std::lock_guard<katana::SimpleLock> lg(releasedLock);
+      if (!released[tid].empty()) {
+        ptr = released[tid].back();
+        released[tid].pop_back();
+      }
+    }
+    if (ptr) {
+      // Fault the released page back in
+      for (size_t x = 0; x < katana::allocSize(); x += 4096) {
+        static_cast<volatile char*>(ptr)[x] = 0;
+      }
+    } else {
+      ptr = allocFromOS();
+    }
+    pageFree(ptr);
+  }
+
+  //! Release the memory of the pages free for at least idle; see
+  //! pagePoolReleaseIdle
+  size_t releaseIdle(std::chrono::steady_clock::duration idle) {
+    auto cutoff = std::chrono::steady_clock::now() - idle;
+    size_t num_released = 0;
+    for (unsigned tid = 0; tid < pool.size(); ++tid) {
+      // Unlink the idle pages, then release them without holding the list
+      std::vector<void*> idle_pages;
+      HeadPtr& hp = pool[tid].data;
+      hp.lock();
+      FreeNode* keep = nullptr;
+      FreeNode** tail = &keep;
+      for (FreeNode* h = hp.getValue(); h;) {
+        FreeNode* next = h->next;
+        if (h->freed <= cutoff) {
+          idle_pages.push_back(h);
+        } else {
+          *tail = h;
+          tail = &h->next;
+        }
+        h = next;
+      }
+      *tail = nullptr;
+      freeCounts[tid] -= static_cast<int>(idle_pages.size());
+      hp.unlock_and_set(keep);
+
+      std::vector<void*> kept_pages;
+      for (void* ptr : idle_pages) {
+        if (katana::releasePages(ptr, 1)) {
+          std::lock_guard<katana::SimpleLock> lg(releasedLock);
+          released[tid].push_back(ptr);
+          num_released += 1;
+        } else {
+          kept_pages.push_back(ptr);
+        }
+      }
+      for (void* ptr : kept_pages) {
+        pageFree(ptr);
+      }
+    }
+    return num_released;
+  }
 };
 
 //! Initialize PagePool, used by init();
@@ -20,13 +20,26 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PARALLELSTL_H_
 #define KATANA_LIBGALOIS_KATANA_PARALLELSTL_H_
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
 
 #include "katana/Chunk.h"
 #include "katana/LoopsDecl.h"
 #include "katana/NoDerefIterator.h"
 #include "katana/Range.h"
 #include "katana/Reduction.h"
+#include "katana/Result.h"
 #include "katana/Threads.h"
 #include "katana/Traits.h"
 #include "katana/UserContext.h"
@@ -465,13 +478,7 @@ copy_if(InputIt first, InputIt last, OutputIt d_first, UnaryPredicate pred) {
   std::vector<diff_type> prefix_sum(num_threads);
   on_each([&](unsigned tid, unsigned total) {
     auto [begin, end] = block_range(first, last, tid, total);
-    diff_type count = 0;
-    for (; first != last; ++first) {
-      if (pred(first)) {
-        count++;
-      }
-    }
-    prefix_sum[tid] = count;
+    prefix_sum[tid] = std::count_if(begin, end, pred);
   });
 
   // calculate prefix sums
@@ -484,12 +491,567 @@ copy_if(InputIt first, InputIt last, OutputIt d_first, UnaryPredicate pred) {
     diff_type offset = tid == 0 ? 0 : prefix_sum[tid - 1];
     OutputIt actual_end = std::copy_if(begin, end, d_first + offset, pred);
 
-    KATANA_LOG_DEBUG_ASSERT(actual_end == prefix_sum[tid]);
+    KATANA_LOG_DEBUG_ASSERT(actual_end == d_first + prefix_sum[tid]);
   });
 
   return d_first + prefix_sum.back();
 }
 
+namespace internal {
+
+/// The unsigned integer whose order matches the order of \p key
+template <typename Key>
+auto
+RadixKey(Key key) {
+  static_assert(std::is_integral_v<Key>, "radix sort keys must be integers");
+  using Unsigned = std::make_unsigned_t<Key>;
+  Unsigned bits = static_cast<Unsigned>(key);
+  if constexpr (std::is_signed_v<Key>) {
+    bits ^= Unsigned{1} << (sizeof(Key) * 8 - 1);
+  }
+  return bits;
+}
+
+/// One stable counting sort pass of an LSD radix sort: moves each element
+/// of [src, src + size) to dst by the digit of its key at \p shift
+template <typename SrcIt, typename DstIt, typename KeyFn>
+void
+RadixPass(SrcIt src, DstIt dst, size_t size, KeyFn key_fn, unsigned shift) {
+  constexpr size_t kNumBuckets = 256;
+  const unsigned num_threads = katana::getActiveThreads();
+  std::vector<std::array<size_t, kNumBuckets>> offsets(num_threads);
+
+  auto digit = [&](const auto& v) {
+    return (RadixKey(key_fn(v)) >> shift) & (kNumBuckets - 1);
+  };
+
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, size, tid, total);
+    std::array<size_t, kNumBuckets>& counts = offsets[tid];
+    counts.fill(0);
+    for (size_t i = begin; i != end; ++i) {
+      ++counts[digit(src[i])];
+    }
+  });
+
+  // Turn the counts into the first output position of each (bucket,
+  // thread), ordered by bucket and then by thread to keep the pass stable
+  size_t next = 0;
+  for (size_t b = 0; b < kNumBuckets; ++b) {
+    for (unsigned t = 0; t < num_threads; ++t) {
+      size_t count = offsets[t][b];
+      offsets[t][b] = next;
+      next += count;
+    }
+  }
+
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, size, tid, total);
+    std::array<size_t, kNumBuckets>& positions = offsets[tid];
+    for (size_t i = begin; i != end; ++i) {
+      dst[positions[digit(src[i])]++] = std::move(src[i]);
+    }
+  });
+}
+
+/// \returns the index i such that the first k elements of the stable merge
+/// of [a, a + a_size) and [b, b + b_size) are a[0, i) and b[0, k - i)
+template <typename It, typename Compare>
+size_t
+MergeSplit(It a, size_t a_size, It b, size_t b_size, size_t k, Compare comp) {
+  size_t lo = k > b_size ? k - b_size : 0;
+  size_t hi = std::min(k, a_size);
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    // Elements of a come first among equal elements
+    if (!comp(b[k - mid - 1], a[mid])) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/// Merges the sorted runs of \p run_size elements of [src, src + size) in
+/// pairs into dst. Each merge is cut into pieces of at most \p grain
+/// outputs, which are placed independently with MergeSplit.
+template <typename SrcIt, typename DstIt, typename Compare>
+void
+MergeRuns(
+    SrcIt src, DstIt dst, size_t size, size_t run_size, size_t grain,
+    Compare comp) {
+  const size_t num_pairs = (size + 2 * run_size - 1) / (2 * run_size);
+  const size_t pieces_per_pair = (2 * run_size + grain - 1) / grain;
+
+  do_all(
+      katana::iterate(size_t{0}, num_pairs * pieces_per_pair),
+      [&](size_t piece) {
+        size_t pair_begin = piece / pieces_per_pair * 2 * run_size;
+        size_t pair_end = std::min(pair_begin + 2 * run_size, size);
+        size_t out_begin = pair_begin + piece % pieces_per_pair * grain;
+        if (out_begin >= pair_end) {
+          return;
+        }
+        size_t out_end = std::min(out_begin + grain, pair_end);
+
+        SrcIt a = src + pair_begin;
+        size_t a_size = std::min(run_size, pair_end - pair_begin);
+        SrcIt b = a + a_size;
+        size_t b_size = pair_end - pair_begin - a_size;
+
+        size_t k_begin = out_begin - pair_begin;
+        size_t k_end = out_end - pair_begin;
+        size_t i_begin = MergeSplit(a, a_size, b, b_size, k_begin, comp);
+        size_t i_end = MergeSplit(a, a_size, b, b_size, k_end, comp);
+        std::merge(
+            a + i_begin, a + i_end, b + (k_begin - i_begin),
+            b + (k_end - i_end), dst + out_begin, comp);
+      },
+      katana::no_stats());
+}
+
+}  // namespace internal
+
+/**
+ * Sorts [first, last) stably by the integral key_fn(element), e.g., the
+ * source node of an edge.
+ *
+ * This is an LSD radix sort with 8-bit digits. Each pass counts digits per
+ * thread block and moves every element once, so the cost is linear in the
+ * number of elements times the number of digits in which the keys differ;
+ * digits that are the same for all keys are skipped. It needs a buffer as
+ * large as the input.
+ */
+template <typename RandomAccessIterator, typename KeyFn>
+void
+radix_sort(
+    RandomAccessIterator first, RandomAccessIterator last, KeyFn key_fn) {
+  using T = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  using Key = decltype(internal::RadixKey(key_fn(*first)));
+
+  const size_t size = std::distance(first, last);
+  if (size <= 1024) {
+    std::stable_sort(first, last, [&](const T& a, const T& b) {
+      return internal::RadixKey(key_fn(a)) < internal::RadixKey(key_fn(b));
+    });
+    return;
+  }
+
+  // The digits that vary are those where some key has a bit that another
+  // lacks
+  auto any_set = make_reducible(std::bit_or<Key>(), []() { return Key{0}; });
+  auto all_set = make_reducible(
+      std::bit_and<Key>(), []() { return static_cast<Key>(~Key{0}); });
+  do_all(
+      katana::iterate(first, last),
+      [&](const T& v) {
+        Key key = internal::RadixKey(key_fn(v));
+        any_set.update(key);
+        all_set.update(key);
+      },
+      katana::no_stats());
+  const Key varying = any_set.reduce() & ~all_set.reduce();
+
+  std::vector<T> buffer(size);
+  bool in_buffer = false;
+  for (unsigned shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+    if (((varying >> shift) & 0xff) == 0) {
+      continue;
+    }
+    if (in_buffer) {
+      internal::RadixPass(buffer.begin(), first, size, key_fn, shift);
+    } else {
+      internal::RadixPass(first, buffer.begin(), size, key_fn, shift);
+    }
+    in_buffer = !in_buffer;
+  }
+
+  if (in_buffer) {
+    ParallelSTL::copy(
+        std::make_move_iterator(buffer.begin()),
+        std::make_move_iterator(buffer.end()), first);
+  }
+}
+
+/**
+ * Sorts the integers in [first, last) with radix_sort.
+ */
+template <typename RandomAccessIterator>
+void
+radix_sort(RandomAccessIterator first, RandomAccessIterator last) {
+  radix_sort(first, last, [](const auto& v) { return v; });
+}
+
+/**
+ * Sorts the integers in [keys_first, keys_last) with radix_sort and applies
+ * the same permutation to the values starting at \p values_first, keeping
+ * values with equal keys in their original order.
+ */
+template <typename KeyIt, typename ValueIt>
+void
+radix_sort_by_key(KeyIt keys_first, KeyIt keys_last, ValueIt values_first) {
+  using Key = typename std::iterator_traits<KeyIt>::value_type;
+  using Value = typename std::iterator_traits<ValueIt>::value_type;
+
+  const size_t size = std::distance(keys_first, keys_last);
+  std::vector<std::pair<Key, Value>> pairs(size);
+  do_all(
+      katana::iterate(size_t{0}, size),
+      [&](size_t i) {
+        pairs[i] = std::make_pair(keys_first[i], std::move(values_first[i]));
+      },
+      katana::no_stats());
+
+  radix_sort(
+      pairs.begin(), pairs.end(), [](const auto& p) { return p.first; });
+
+  do_all(
+      katana::iterate(size_t{0}, size),
+      [&](size_t i) {
+        keys_first[i] = pairs[i].first;
+        values_first[i] = std::move(pairs[i].second);
+      },
+      katana::no_stats());
+}
+
+/**
+ * Sorts [first, last) with \p comp, keeping equal elements in their
+ * original order.
+ *
+ * Each thread sorts a block with std::stable_sort. Sorted runs are then
+ * merged in pairs until one run remains. Every merge is split into
+ * independent pieces by binary search, so all threads take part even in the
+ * last merge. It needs a buffer as large as the input.
+ */
+template <typename RandomAccessIterator, typename Compare>
+void
+stable_sort(
+    RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+  using T = typename std::iterator_traits<RandomAccessIterator>::value_type;
+
+  const size_t size = std::distance(first, last);
+  const size_t num_threads = katana::getActiveThreads();
+  if (size <= 1024 || num_threads == 1) {
+    std::stable_sort(first, last, comp);
+    return;
+  }
+
+  const size_t run_size = (size + num_threads - 1) / num_threads;
+  on_each([&](unsigned tid, unsigned) {
+    size_t begin = std::min(tid * run_size, size);
+    size_t end = std::min(begin + run_size, size);
+    std::stable_sort(first + begin, first + end, comp);
+  });
+
+  // Pieces small enough to balance load, large enough to amortize the
+  // binary searches
+  const size_t grain = std::max<size_t>(size / (num_threads * 4), 4096);
+
+  std::vector<T> buffer(size);
+  bool in_buffer = false;
+  for (size_t width = run_size; width < size; width *= 2) {
+    if (in_buffer) {
+      internal::MergeRuns(buffer.begin(), first, size, width, grain, comp);
+    } else {
+      internal::MergeRuns(first, buffer.begin(), size, width, grain, comp);
+    }
+    in_buffer = !in_buffer;
+  }
+
+  if (in_buffer) {
+    ParallelSTL::copy(
+        std::make_move_iterator(buffer.begin()),
+        std::make_move_iterator(buffer.end()), first);
+  }
+}
+
+template <typename RandomAccessIterator>
+void
+stable_sort(RandomAccessIterator first, RandomAccessIterator last) {
+  katana::ParallelSTL::stable_sort(
+      first, last,
+      std::less<
+          typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+
+namespace internal {
+
+/// \returns a new buffer with the values of \p array, which must not have
+/// nulls, for the sorts of arrow arrays to sort in place
+template <typename ArrowType>
+katana::Result<std::shared_ptr<arrow::Buffer>>
+CopyValuesToSort(const arrow::NumericArray<ArrowType>& array) {
+  using CType = typename ArrowType::c_type;
+  if (array.null_count() != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "cannot sort {} nulls",
+        array.null_count());
+  }
+  auto res = arrow::AllocateBuffer(array.length() * sizeof(CType));
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} values: {}",
+        array.length(), res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer(std::move(res.ValueOrDie()));
+  const CType* values = array.raw_values();
+  ParallelSTL::copy(
+      values, values + array.length(),
+      reinterpret_cast<CType*>(buffer->mutable_data()));
+  return buffer;
+}
+
+}  // namespace internal
+
+/**
+ * Sorts the integers of \p array, which must not have nulls, with
+ * radix_sort.
+ *
+ * \returns a new sorted array
+ */
+template <typename ArrowType>
+katana::Result<std::shared_ptr<arrow::NumericArray<ArrowType>>>
+radix_sort(const arrow::NumericArray<ArrowType>& array) {
+  using CType = typename ArrowType::c_type;
+  auto res = internal::CopyValuesToSort(array);
+  if (!res) {
+    return res.error();
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(res.value());
+  auto* values = reinterpret_cast<CType*>(buffer->mutable_data());
+  radix_sort(values, values + array.length());
+  return std::make_shared<arrow::NumericArray<ArrowType>>(
+      array.length(), std::move(buffer));
+}
+
+/**
+ * Sorts the integers of \p keys with radix_sort and applies the same
+ * permutation to \p values. Neither array may have nulls.
+ *
+ * \returns new sorted key and value arrays
+ */
+template <typename KeyType, typename ValueType>
+katana::Result<std::pair<
+    std::shared_ptr<arrow::NumericArray<KeyType>>,
+    std::shared_ptr<arrow::NumericArray<ValueType>>>>
+radix_sort_by_key(
+    const arrow::NumericArray<KeyType>& keys,
+    const arrow::NumericArray<ValueType>& values) {
+  if (keys.length() != values.length()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} keys but {} values",
+        keys.length(), values.length());
+  }
+  auto keys_res = internal::CopyValuesToSort(keys);
+  if (!keys_res) {
+    return keys_res.error();
+  }
+  auto values_res = internal::CopyValuesToSort(values);
+  if (!values_res) {
+    return values_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> keys_buf = std::move(keys_res.value());
+  std::shared_ptr<arrow::Buffer> values_buf = std::move(values_res.value());
+
+  auto* key_data =
+      reinterpret_cast<typename KeyType::c_type*>(keys_buf->mutable_data());
+  auto* value_data =
+      reinterpret_cast<typename ValueType::c_type*>(values_buf->mutable_data());
+  radix_sort_by_key(key_data, key_data + keys.length(), value_data);
+
+  return std::make_pair(
+      std::make_shared<arrow::NumericArray<KeyType>>(
+          keys.length(), std::move(keys_buf)),
+      std::make_shared<arrow::NumericArray<ValueType>>(
+          values.length(), std::move(values_buf)));
+}
+
+/**
+ * Sorts the values of \p array, which must not have nulls, with
+ * stable_sort.
+ *
+ * \returns a new sorted array
+ */
+template <typename ArrowType, typename Compare>
+katana::Result<std::shared_ptr<arrow::NumericArray<ArrowType>>>
+stable_sort(const arrow::NumericArray<ArrowType>& array, Compare comp) {
+  using CType = typename ArrowType::c_type;
+  auto res = internal::CopyValuesToSort(array);
+  if (!res) {
+    return res.error();
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(res.value());
+  auto* values = reinterpret_cast<CType*>(buffer->mutable_data());
+  stable_sort(values, values + array.length(), comp);
+  return std::make_shared<arrow::NumericArray<ArrowType>>(
+      array.length(), std::move(buffer));
+}
+
+template <typename ArrowType>
+katana::Result<std::shared_ptr<arrow::NumericArray<ArrowType>>>
+stable_sort(const arrow::NumericArray<ArrowType>& array) {
+  return stable_sort(array, std::less<typename ArrowType::c_type>());
+}
+
+//! The aggregate of one key computed by group_by
+template <typename Key, typename Value>
+struct GroupByEntry {
+  Key key;
+  uint64_t count;
+  Value sum;
+};
+
+namespace internal {
+
+/// An open addressing hash table from keys to their aggregates, which
+/// reserves a count of zero for empty slots
+template <typename Key, typename Value>
+class GroupByTable {
+public:
+  using Entry = GroupByEntry<Key, Value>;
+
+  static uint64_t Hash(Key key) {
+    return static_cast<uint64_t>(key) * UINT64_C(0x9E3779B97F4A7C15);
+  }
+
+  void Add(uint64_t hash, Key key, uint64_t count, const Value& sum) {
+    if (2 * (size_ + 1) > slots_.size()) {
+      Grow();
+    }
+    Entry& slot = Find(hash, key);
+    if (slot.count == 0) {
+      slot.key = key;
+      slot.sum = sum;
+      ++size_;
+    } else {
+      slot.sum += sum;
+    }
+    slot.count += count;
+  }
+
+  /// Add the aggregates of \p other to this table and clear \p other
+  void Merge(GroupByTable* other) {
+    for (const Entry& slot : other->slots_) {
+      if (slot.count != 0) {
+        Add(Hash(slot.key), slot.key, slot.count, slot.sum);
+      }
+    }
+    *other = GroupByTable();
+  }
+
+  /// Write the aggregates to \p out and \returns the end of the output
+  Entry* CopyTo(Entry* out) const {
+    for (const Entry& slot : slots_) {
+      if (slot.count != 0) {
+        *out++ = slot;
+      }
+    }
+    return out;
+  }
+
+  size_t size() const { return size_; }
+
+private:
+  Entry& Find(uint64_t hash, Key key) {
+    size_t mask = slots_.size() - 1;
+    // The high bits of hash pick the partition, so probe by the low bits
+    for (size_t i = (hash ^ (hash >> 32)) & mask;; i = (i + 1) & mask) {
+      Entry& slot = slots_[i];
+      if (slot.count == 0 || slot.key == key) {
+        return slot;
+      }
+    }
+  }
+
+  void Grow() {
+    std::vector<Entry> old(std::max<size_t>(16, 2 * slots_.size()));
+    old.swap(slots_);
+    size_ = 0;
+    for (const Entry& slot : old) {
+      if (slot.count != 0) {
+        Add(Hash(slot.key), slot.key, slot.count, slot.sum);
+      }
+    }
+  }
+
+  std::vector<Entry> slots_;
+  size_t size_{0};
+};
+
+}  // namespace internal
+
+/**
+ * Groups the elements of [first, last) by the integral key_fn(element) and
+ * computes the number of elements and the sum of value_fn(element) of each
+ * key, e.g., the sizes of the components named by a component property.
+ *
+ * Each thread aggregates a contiguous block of the input into private hash
+ * tables, one per partition of the key space by the high bits of the key
+ * hash. Each partition is then merged across threads in parallel, so there
+ * are no locks and no allocations per element, and memory grows with the
+ * number of distinct keys rather than with the key range.
+ *
+ * \returns one entry per distinct key, in no particular order
+ */
+template <typename InputIt, typename KeyFn, typename ValueFn>
+auto
+group_by(InputIt first, InputIt last, KeyFn key_fn, ValueFn value_fn) {
+  using Key = std::decay_t<decltype(key_fn(*first))>;
+  using Value = std::decay_t<decltype(value_fn(*first))>;
+  using Table = internal::GroupByTable<Key, Value>;
+  using Entry = GroupByEntry<Key, Value>;
+  static_assert(std::is_integral_v<Key>, "group_by keys must be integers");
+
+  constexpr unsigned kPartitionBits = 8;
+  constexpr size_t kNumPartitions = size_t{1} << kPartitionBits;
+
+  const unsigned num_threads = katana::getActiveThreads();
+  std::vector<std::vector<Table>> tables(num_threads);
+
+  on_each([&](unsigned tid, unsigned total) {
+    std::vector<Table>& local = tables[tid];
+    local.resize(kNumPartitions);
+    auto [begin, end] = block_range(first, last, tid, total);
+    for (; begin != end; ++begin) {
+      Key key = key_fn(*begin);
+      uint64_t hash = Table::Hash(key);
+      local[hash >> (64 - kPartitionBits)].Add(hash, key, 1, value_fn(*begin));
+    }
+  });
+
+  // Merge each partition into the tables of thread 0
+  std::vector<size_t> offsets(kNumPartitions + 1);
+  do_all(katana::iterate(size_t{0}, kNumPartitions), [&](size_t p) {
+    for (unsigned t = 1; t < num_threads; ++t) {
+      tables[0][p].Merge(&tables[t][p]);
+    }
+    offsets[p + 1] = tables[0][p].size();
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  std::vector<Entry> entries(offsets.back());
+  do_all(katana::iterate(size_t{0}, kNumPartitions), [&](size_t p) {
+    tables[0][p].CopyTo(entries.data() + offsets[p]);
+    tables[0][p] = Table();
+  });
+
+  return entries;
+}
+
+/**
+ * Groups the elements of [first, last) by the integral key_fn(element).
+ *
+ * \returns one entry per distinct key, whose count and sum are both the
+ *     number of elements with that key, in no particular order
+ */
+template <typename InputIt, typename KeyFn>
+auto
+group_by(InputIt first, InputIt last, KeyFn key_fn) {
+  return group_by(
+      first, last, key_fn, [](const auto&) { return uint64_t{1}; });
+}
+
 }  // end namespace ParallelSTL
 }  // end namespace katana
 #endif
@@ -0,0 +1,117 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PARTITIONLOADER_H_
+#define KATANA_LIBGALOIS_KATANA_PARTITIONLOADER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/PartitionMetadata.h"
+
+namespace katana {
+
+/// How PartitionLoader assigns the nodes and edges of an RDG to hosts
+struct PartitionLoadOptions {
+  enum Policy {
+    /// Blocks of block_nodes consecutive nodes go to hosts by a hash of
+    /// the block, and each host owns the out-edges of its nodes
+    kHashEdgeCut,
+    /// The Cartesian vertex cut of Boman et al. ("Scalable Matrix
+    /// Computations on Large Scale-Free Graphs Using 2D Graph
+    /// Partitioning", SC 2013), as in CuSP: the hosts form a grid, each
+    /// owns a contiguous range of nodes balanced by nodes plus edges, and
+    /// the edge (u, v) goes to the host in the row of the owner of u and
+    /// the column of the owner of v. A node has mirrors on at most a row
+    /// and a column of hosts.
+    kCartesianVertexCut,
+    /// The host of each node is the uint32 node property
+    /// partition_property of the RDG, e.g., the output of GraphPartition,
+    /// and each host owns the out-edges of its nodes
+    kPartitionProperty,
+  };
+
+  static constexpr uint64_t kDefaultBlockNodes = 1024;
+
+  Policy policy{kHashEdgeCut};
+  /// The nodes of a block of kHashEdgeCut, whose edges a host reads as one
+  /// range. With kPartitionProperty, a host also reads the edges of the
+  /// nodes of other hosts between two of its own when there are fewer than
+  /// this many, rather than start another range.
+  uint64_t block_nodes{kDefaultBlockNodes};
+  /// The node property of kPartitionProperty
+  std::string partition_property;
+};
+
+/// Load one host's partition of an unpartitioned RDG, so that a graph can
+/// run on any number of hosts without an offline repartitioning step.
+///
+/// Every host reads the out indices of the RDG, 8 bytes per node, and then
+/// only the ranges of edge destinations that hold its edges, all fetched
+/// concurrently through the FileView of the topology. The local nodes of a
+/// partition are its masters, in the order of their ids in the RDG,
+/// followed by its mirrors, the other endpoints of its edges, in the same
+/// order; local_to_global_id maps them to the nodes of the RDG. Hosts
+/// learn which of their masters are mirrored where by exchanging the
+/// lists of their mirrors, after which MirrorSync::Make works on the
+/// partition. No properties are loaded.
+///
+/// LoadPartition runs both steps with a CommBackend; Read and Finish run
+/// them separately, e.g., to load the partitions of several hosts in one
+/// process.
+class KATANA_EXPORT PartitionLoader {
+public:
+  /// Read the partition of host of the RDG rdg_name for num_hosts hosts
+  static Result<PartitionLoader> Read(
+      const std::string& rdg_name, uint32_t host, uint32_t num_hosts,
+      const PartitionLoadOptions& options = {});
+
+  uint32_t host() const { return host_; }
+  uint32_t num_hosts() const { return num_hosts_; }
+
+  /// The nodes of the RDG owned by this host, in increasing order
+  const std::vector<uint64_t>& masters() const { return masters_; }
+
+  /// mirrors()[h] holds the nodes of the RDG mirrored on this host whose
+  /// master is on host h, in increasing order, and is empty for this host
+  const std::vector<std::vector<uint64_t>>& mirrors() const {
+    return mirrors_;
+  }
+
+  /// Make the partition, given the mirrors() of each host h for this one
+  /// in mirrored[h]
+  Result<std::unique_ptr<PropertyGraph>> Finish(
+      const std::vector<std::vector<uint64_t>>& mirrored);
+
+private:
+  PartitionLoader(uint32_t host, uint32_t num_hosts)
+      : host_(host),
+        num_hosts_(num_hosts),
+        mirrors_(num_hosts),
+        mirror_nodes_(num_hosts) {}
+
+  uint32_t host_;
+  uint32_t num_hosts_;
+  tsuba::PartitionMetadata metadata_;
+  std::vector<uint64_t> masters_;
+  std::vector<std::vector<uint64_t>> mirrors_;
+  /// mirror_nodes_[h] holds the local ids of mirrors_[h]
+  std::vector<std::vector<uint32_t>> mirror_nodes_;
+  /// The node of the RDG of each local node
+  std::vector<uint64_t> local_to_global_;
+  /// The local CSR, over local node ids
+  GraphTopology topology_;
+};
+
+/// Load the partition of comm->ID of the RDG rdg_name for the comm->Num
+/// tasks of comm, each of which must call it; see PartitionLoader
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> LoadPartition(
+    const std::string& rdg_name, CommBackend* comm,
+    const PartitionLoadOptions& options = {});
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PEELINGBUCKETS_H_
+#define KATANA_LIBGALOIS_KATANA_PEELINGBUCKETS_H_
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/Reduction.h"
+
+namespace katana {
+
+/// Items by current degree, for peeling algorithms such as k-core and k-truss
+/// decomposition that repeatedly remove every item of the lowest degree.
+///
+/// Only kNumOpenBuckets consecutive degrees starting at a base have a bucket
+/// at a time; items of higher degree wait in an overflow bag until the window
+/// moves past them. Buckets are lazy: an item whose degree drops is added to
+/// the bucket of its new degree, and entries that are no longer current are
+/// dropped when their bucket is extracted. Degrees may only decrease, and not
+/// below the level being peeled.
+///
+/// \tparam DegreeFn uint32_t(Item), the current degree of an item
+/// \tparam IsPeeledFn bool(Item), whether an item was removed
+template <typename Item, typename DegreeFn, typename IsPeeledFn>
+class PeelingBuckets {
+public:
+  static constexpr uint32_t kNumOpenBuckets = 128;
+
+  PeelingBuckets(DegreeFn degree, IsPeeledFn is_peeled)
+      : degree_(std::move(degree)),
+        is_peeled_(std::move(is_peeled)),
+        buckets_(kNumOpenBuckets) {}
+
+  /// Add an item at its current degree. Thread safe. All items must be
+  /// inserted before the first NextLevel.
+  void Insert(const Item& item) {
+    uint32_t degree = degree_(item);
+    if (degree < kNumOpenBuckets) {
+      buckets_[degree].push(item);
+    } else {
+      overflow_.push(item);
+    }
+  }
+
+  /// Record that the degree of an item that is not peeled dropped to degree,
+  /// which must be above the level being peeled. Thread safe.
+  void Update(const Item& item, uint32_t degree) {
+    // Items beyond the window are still in the overflow bag
+    if (degree - base_ < kNumOpenBuckets) {
+      buckets_[degree - base_].push(item);
+    }
+  }
+
+  /// Find the lowest degree, at least *level, that items that are not peeled
+  /// have and call push(Item) in parallel for each of them.
+  ///
+  /// \returns false if every item is peeled
+  template <typename PushFn>
+  bool NextLevel(uint32_t* level, const PushFn& push) {
+    while (true) {
+      for (; *level - base_ < kNumOpenBuckets; ++*level) {
+        auto& bucket = buckets_[*level - base_];
+        if (bucket.empty()) {
+          continue;
+        }
+        GAccumulator<uint64_t> num_pushed;
+        do_all(
+            iterate(bucket),
+            [&](const Item& item) {
+              if (!is_peeled_(item) && degree_(item) == *level) {
+                push(item);
+                num_pushed += 1;
+              }
+            },
+            loopname("PeelingBucketsExtract"), no_stats());
+        bucket.clear();
+        if (num_pushed.reduce() != 0) {
+          return true;
+        }
+      }
+
+      // Every item of a degree in the window is peeled. Move the window to the
+      // lowest degree left.
+      GReduceMin<uint32_t> lowest;
+      do_all(
+          iterate(overflow_),
+          [&](const Item& item) {
+            if (!is_peeled_(item)) {
+              lowest.update(degree_(item));
+            }
+          },
+          loopname("PeelingBucketsLowest"), no_stats());
+      if (lowest.reduce() == std::numeric_limits<uint32_t>::max()) {
+        return false;
+      }
+      base_ = lowest.reduce();
+      *level = base_;
+
+      InsertBag<Item> remaining;
+      do_all(
+          iterate(overflow_),
+          [&](const Item& item) {
+            if (is_peeled_(item)) {
+              return;
+            }
+            uint32_t degree = degree_(item);
+            if (degree - base_ < kNumOpenBuckets) {
+              buckets_[degree - base_].push(item);
+            } else {
+              remaining.push(item);
+            }
+          },
+          loopname("PeelingBucketsRefill"), no_stats());
+      overflow_.swap(remaining);
+    }
+  }
+
+private:
+  DegreeFn degree_;
+  IsPeeledFn is_peeled_;
+  uint32_t base_{0};
+  std::vector<InsertBag<Item>> buckets_;
+  InsertBag<Item> overflow_;
+};
+
+/// Make PeelingBuckets, deducing the types of the functions
+template <typename Item, typename DegreeFn, typename IsPeeledFn>
+PeelingBuckets<Item, DegreeFn, IsPeeledFn>
+MakePeelingBuckets(DegreeFn degree, IsPeeledFn is_peeled) {
+  return PeelingBuckets<Item, DegreeFn, IsPeeledFn>(
+      std::move(degree), std::move(is_peeled));
+}
+
+}  // namespace katana
+
+#endif
@@ -85,6 +85,10 @@ KATANA_EXPORT PerBackend& getPPSBackend();
 
 KATANA_EXPORT void initPTS(unsigned maxT);
 
+//! Share the storage of thread tid with the calling thread, which was not
+//! made by the thread pool
+KATANA_EXPORT void adoptPTS(unsigned tid);
+
 template <typename T>
 class PerThreadStorage {
   PerBackend* b;
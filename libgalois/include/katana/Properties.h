@@ -2,10 +2,13 @@
 #define KATANA_LIBGALOIS_KATANA_PROPERTIES_H_
 
 #include <cassert>
+#include <cstring>
+#include <optional>
 #include <string_view>
 #include <utility>
 
 #include <arrow/array.h>
+#include <arrow/buffer.h>
 #include <arrow/stl.h>
 #include <arrow/type_fwd.h>
 #include <arrow/type_traits.h>
@@ -14,6 +17,7 @@
 #include "katana/Logging.h"
 #include "katana/PODResizeableArray.h"
 #include "katana/Result.h"
+#include "katana/Span.h"
 #include "katana/Traits.h"
 
 namespace katana {
@@ -361,22 +365,32 @@ public:
            arrow::BitUtil::GetBit(null_bitmap_, i + offset_);
   }
 
-  reference GetValue(size_t i) { return values_[i + offset_]; }
+  reference GetValue(size_t i) { return values_[i]; }
 
-  const_reference GetValue(size_t i) const { return values_[i + offset_]; }
+  const_reference GetValue(size_t i) const { return values_[i]; }
 
   reference operator[](size_t i) { return GetValue(i); }
 
   const_reference operator[](size_t i) const { return GetValue(i); }
 
+  /// The values of the view, which are contiguous because a view is over a
+  /// single arrow::Array. Indexing the pointer directly lets a kernel load
+  /// a property with one instruction rather than through the view.
+  T* data() { return values_; }
+
+  const T* data() const { return values_; }
+
+  size_t size() const { return length_; }
+
 private:
   PODPropertyView(
       T* values, const uint8_t* null_bitmap, size_t length, size_t offset)
-      : values_(values),
+      : values_(values + offset),
         null_bitmap_(null_bitmap),
         length_(length),
         offset_(offset) {}
 
+  /// The first value of the view, after the offset of the array
   T* values_;
   const uint8_t* null_bitmap_;
   size_t length_, offset_;
@@ -450,6 +464,200 @@ private:
   const ArrowArrayType& array_;
 };
 
+/// DictionaryStringPropertyReadOnlyView provides a read-only property view
+/// over an arrow::DictionaryArray of strings, as made by
+/// katana::DictionaryEncode. Each element is a code into a dictionary of the
+/// distinct strings, so filtering by a string is a compare of codes:
+///
+///   auto code = view.FindCode("Person");
+///   for (size_t i = 0; i < view.size(); ++i) {
+///     if (code && view.GetCode(i) == *code) ...
+///   }
+///
+/// and strings are only materialized by GetValue.
+template <typename IndexType = int32_t>
+class DictionaryStringPropertyReadOnlyView {
+public:
+  using value_type = std::string;
+  using code_type = IndexType;
+
+  static Result<DictionaryStringPropertyReadOnlyView> Make(
+      const arrow::DictionaryArray& array) {
+    using IndexArrowType = typename arrow::CTypeTraits<IndexType>::ArrowType;
+    if (array.indices()->type_id() != IndexArrowType::type_id) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError, "dictionary indices are {}, expected {}",
+          array.indices()->type()->ToString(),
+          arrow::TypeTraits<IndexArrowType>::type_singleton()->ToString());
+    }
+    auto dictionary =
+        std::dynamic_pointer_cast<arrow::StringArray>(array.dictionary());
+    if (!dictionary) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError, "dictionary values are {}, expected string",
+          array.dictionary()->type()->ToString());
+    }
+    return DictionaryStringPropertyReadOnlyView(
+        array, array.indices()->data()->template GetValues<IndexType>(1),
+        std::move(dictionary));
+  }
+
+  bool IsValid(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(i < size());
+    return array_.IsValid(i);
+  }
+
+  code_type GetCode(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(IsValid(i));
+    return codes_[i];
+  }
+
+  /// The codes of all elements, for loops that compare them in bulk; the
+  /// codes of null elements are unspecified
+  const code_type* codes() const { return codes_; }
+
+  size_t size() const { return array_.length(); }
+
+  /// The number of distinct strings, i.e., codes are in [0, num_codes())
+  size_t num_codes() const { return dictionary_->length(); }
+
+  /// 
+eturns the code of str, or nullopt if no element is str
+  std::optional<code_type> FindCode(std::string_view str) const {
+    for (int64_t c = 0, n = dictionary_->length(); c < n; ++c) {
+      if (dictionary_->IsValid(c) && dictionary_->GetView(c) == str) {
+        return static_cast<code_type>(c);
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::string_view GetCodeValue(code_type code) const {
+    return dictionary_->GetView(code);
+  }
+
+  value_type GetValue(size_t i) const {
+    return value_type{GetCodeValue(GetCode(i))};
+  }
+
+  value_type operator[](size_t i) const {
+    if (!IsValid(i)) {
+      return value_type{};
+    }
+    return GetValue(i);
+  }
+
+private:
+  DictionaryStringPropertyReadOnlyView(
+      const arrow::DictionaryArray& array, const code_type* codes,
+      std::shared_ptr<arrow::StringArray> dictionary)
+      : array_(array), codes_(codes), dictionary_(std::move(dictionary)) {}
+
+  const arrow::DictionaryArray& array_;
+  const code_type* codes_;
+  std::shared_ptr<arrow::StringArray> dictionary_;
+};
+
+/// FixedSizeListPropertyView provides a property view over
+/// arrow::FixedSizeListArrays of numbers, e.g., the embeddings of nodes, with
+/// the list of row i as a Span of its Dimension values. The lists of all rows
+/// are contiguous, one after another, so data() is a dense row-major matrix
+/// that a kernel can load with vector instructions. A Dimension known at
+/// compile time is checked against the array and makes the loops over a row
+/// constant length; with kDynamicExtent it is read from the array.
+///
+/// List values are 64-byte aligned when allocated by arrow, e.g., by
+/// FixedSizeListProperty::Allocate, so rows are aligned as well when
+/// Dimension * sizeof(T) is a multiple of 64.
+///
+/// \tparam T A plain old C datatype type like float or double
+/// \tparam Dimension The length of every list, or kDynamicExtent
+template <typename T, size_t Dimension = kDynamicExtent>
+class FixedSizeListPropertyView {
+public:
+  using value_type = Span<T, Dimension>;
+  using reference = Span<T, Dimension>;
+  using const_reference = Span<const T, Dimension>;
+
+  static Result<FixedSizeListPropertyView> Make(
+      const arrow::FixedSizeListArray& array) {
+    using ValueArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+    if (array.value_type()->id() != ValueArrowType::type_id) {
+      KATANA_LOG_DEBUG(
+          "arrow error: bad list value type: {}",
+          array.value_type()->ToString());
+      return ErrorCode::ArrowError;
+    }
+    size_t dimension = array.list_type()->list_size();
+    if (Dimension != kDynamicExtent && dimension != Dimension) {
+      KATANA_LOG_DEBUG(
+          "arrow error: bad list size: {} != {}", dimension, Dimension);
+      return ErrorCode::ArrowError;
+    }
+    if (array.offset() < 0) {
+      KATANA_LOG_DEBUG("arrow error: Offset not supported");
+      return ErrorCode::ArrowError;
+    }
+    const std::shared_ptr<arrow::ArrayData>& values = array.values()->data();
+    if (values->buffers.size() <= 1 || !values->buffers[1]->is_mutable()) {
+      KATANA_LOG_DEBUG("arrow error: immutable buffers not supported");
+      return ErrorCode::ArrowError;
+    }
+    return FixedSizeListPropertyView(
+        GetMutableValuesWorkAround<T>(values, 1, values->offset()),
+        array.data()->template GetValues<uint8_t>(0, 0), array.length(),
+        array.offset(), dimension);
+  }
+
+  bool IsValid(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(i < length_);
+    return null_bitmap_ == nullptr ||
+           arrow::BitUtil::GetBit(null_bitmap_, i + offset_);
+  }
+
+  reference GetValue(size_t i) {
+    return reference(&values_[i * dimension()], dimension());
+  }
+
+  const_reference GetValue(size_t i) const {
+    return const_reference(&values_[i * dimension()], dimension());
+  }
+
+  reference operator[](size_t i) { return GetValue(i); }
+
+  const_reference operator[](size_t i) const { return GetValue(i); }
+
+  /// The values of all lists of the view, row i starting at
+  /// data()[i * dimension()]
+  T* data() { return values_; }
+
+  const T* data() const { return values_; }
+
+  size_t size() const { return length_; }
+
+  /// The length of every list, a constant unless Dimension is
+  /// kDynamicExtent
+  size_t dimension() const {
+    return Dimension != kDynamicExtent ? Dimension : dimension_;
+  }
+
+private:
+  FixedSizeListPropertyView(
+      T* values, const uint8_t* null_bitmap, size_t length, size_t offset,
+      size_t dimension)
+      : values_(values + offset * dimension),
+        null_bitmap_(null_bitmap),
+        length_(length),
+        offset_(offset),
+        dimension_(dimension) {}
+
+  /// The first value of the first list of the view, after the offset of the
+  /// array
+  T* values_;
+  const uint8_t* null_bitmap_;
+  size_t length_, offset_, dimension_;
+};
+
 template <typename T>
 struct PODProperty {
   using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
@@ -479,6 +687,11 @@ struct LargeStringReadOnlyProperty {
   using ViewType = StringPropertyReadOnlyView<arrow::LargeStringArray>;
 };
 
+struct DictionaryStringReadOnlyProperty {
+  using ArrowType = arrow::DictionaryType;
+  using ViewType = DictionaryStringPropertyReadOnlyView<>;
+};
+
 template <typename T>
 struct StructProperty {
   using ArrowType = arrow::FixedSizeBinaryType;
@@ -514,5 +727,41 @@ struct StructProperty {
   }
 };
 
+/// A property of Dimension values of T per row, e.g., a float embedding,
+/// stored as an arrow::FixedSizeListArray
+template <typename T, size_t Dimension = kDynamicExtent>
+struct FixedSizeListProperty {
+  using ArrowType = arrow::FixedSizeListType;
+  using ViewType = FixedSizeListPropertyView<T, Dimension>;
+
+  /// A table of one column of num_rows lists of zeros in a single buffer
+  static katana::Result<std::shared_ptr<arrow::Table>> Allocate(
+      size_t num_rows, const std::string& name) {
+    static_assert(
+        Dimension != kDynamicExtent, "allocating lists needs their size");
+    using ValueArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+    using ValueArrayType =
+        typename arrow::TypeTraits<ValueArrowType>::ArrayType;
+
+    size_t num_values = num_rows * Dimension;
+    auto res = arrow::AllocateBuffer(num_values * sizeof(T));
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "failed to allocate values: {}",
+          res.status());
+    }
+    std::shared_ptr<arrow::Buffer> buffer = std::move(res.ValueOrDie());
+    std::memset(buffer->mutable_data(), 0, num_values * sizeof(T));
+
+    auto values = std::make_shared<ValueArrayType>(num_values, buffer);
+    auto type = arrow::fixed_size_list(
+        arrow::TypeTraits<ValueArrowType>::type_singleton(), Dimension);
+    auto array =
+        std::make_shared<arrow::FixedSizeListArray>(type, num_rows, values);
+    return arrow::Table::Make(
+        arrow::schema({arrow::field(name, type)}), {array});
+  }
+};
+
 }  // namespace katana
 #endif
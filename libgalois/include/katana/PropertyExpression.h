@@ -0,0 +1,139 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PROPERTYEXPRESSION_H_
+#define KATANA_LIBGALOIS_KATANA_PROPERTYEXPRESSION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// An elementwise arithmetic expression over the numeric properties of the
+/// nodes or edges of a PropertyGraph, e.g.,
+///
+///     0.3 * pagerank + log(degree())
+///
+/// Expressions are evaluated by EvaluateNodeExpression and
+/// EvaluateEdgeExpression into a double per node or edge. Properties of any
+/// integer, floating point or boolean type may appear in an expression; a
+/// value is null if a property it uses is null.
+class KATANA_EXPORT PropertyExpression {
+public:
+  enum class Op {
+    kProperty,
+    kConstant,
+    /// The number of out-edges of a node
+    kOutDegree,
+    kAdd,
+    kSubtract,
+    kMultiply,
+    kDivide,
+    kNegate,
+    /// The natural logarithm
+    kLog,
+    kExp,
+    kSqrt,
+    kAbs,
+    kPow,
+    kMin,
+    kMax,
+  };
+
+  /// The value of the property \p name
+  static PropertyExpression Property(std::string name);
+
+  static PropertyExpression Constant(double value);
+
+  /// The out-degree of each node; only valid in node expressions
+  static PropertyExpression OutDegree();
+
+  /// Apply the function \p op, e.g., Op::kLog or Op::kPow, to \p args
+  static Result<PropertyExpression> Call(
+      Op op, std::vector<PropertyExpression> args);
+
+  /// Parse an expression of numbers, property names, the operators + - * /
+  /// with the usual precedence, parentheses, and the functions log, exp,
+  /// sqrt, abs, pow, min, max and degree(). Property names are identifiers;
+  /// names with other characters are quoted in backticks, as in
+  /// `page-rank`.
+  static Result<PropertyExpression> Parse(const std::string& text);
+
+  Op op() const;
+
+  /// The name of a property or the value of a constant
+  const std::string& name() const;
+  double value() const;
+
+  const std::vector<PropertyExpression>& args() const;
+
+  /// \returns the expression in the syntax read by Parse
+  std::string ToString() const;
+
+  friend KATANA_EXPORT PropertyExpression
+  operator+(const PropertyExpression& a, const PropertyExpression& b);
+  friend KATANA_EXPORT PropertyExpression
+  operator-(const PropertyExpression& a, const PropertyExpression& b);
+  friend KATANA_EXPORT PropertyExpression
+  operator*(const PropertyExpression& a, const PropertyExpression& b);
+  friend KATANA_EXPORT PropertyExpression
+  operator/(const PropertyExpression& a, const PropertyExpression& b);
+  friend KATANA_EXPORT PropertyExpression
+  operator-(const PropertyExpression& a);
+
+private:
+  struct Term;
+
+  explicit PropertyExpression(std::shared_ptr<const Term> term)
+      : term_(std::move(term)) {}
+
+  static PropertyExpression Make(
+      Op op, std::vector<PropertyExpression> args, std::string name = "",
+      double value = 0);
+
+  std::shared_ptr<const Term> term_;
+};
+
+/// Evaluate \p expression for every node of \p pg. The expression is
+/// compiled once into a sequence of elementwise kernels, which run over
+/// blocks of nodes in parallel on the Katana thread pool, so that the
+/// intermediate values of a block stay in cache and only the result is
+/// materialized. Properties with several chunks are read in place.
+KATANA_EXPORT Result<std::shared_ptr<arrow::DoubleArray>>
+EvaluateNodeExpression(
+    const PropertyGraph& pg, const PropertyExpression& expression);
+
+/// Evaluate \p expression, over edge properties, for every edge of \p pg
+KATANA_EXPORT Result<std::shared_ptr<arrow::DoubleArray>>
+EvaluateEdgeExpression(
+    const PropertyGraph& pg, const PropertyExpression& expression);
+
+/// Add the node property \p name, which may not exist yet, holding the
+/// value of \p expression for every node. The result is added as one
+/// chunk, without a copy.
+KATANA_EXPORT Result<void> AddNodePropertyFromExpression(
+    PropertyGraph* pg, const std::string& name,
+    const PropertyExpression& expression);
+
+/// Add the node property \p name from the expression \p text; see
+/// PropertyExpression::Parse
+KATANA_EXPORT Result<void> AddNodePropertyFromExpression(
+    PropertyGraph* pg, const std::string& name, const std::string& text);
+
+/// Add the edge property \p name, which may not exist yet, holding the
+/// value of \p expression for every edge
+KATANA_EXPORT Result<void> AddEdgePropertyFromExpression(
+    PropertyGraph* pg, const std::string& name,
+    const PropertyExpression& expression);
+
+/// Add the edge property \p name from the expression \p text
+KATANA_EXPORT Result<void> AddEdgePropertyFromExpression(
+    PropertyGraph* pg, const std::string& name, const std::string& text);
+
+}  // namespace katana
+
+#endif
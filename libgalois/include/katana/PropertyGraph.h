@@ -1,8 +1,10 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 
-#include <bitset>
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -13,13 +15,19 @@
 #include "katana/Details.h"
 #include "katana/ErrorCode.h"
 #include "katana/LargeArray.h"
+#include "katana/SparseBitmap.h"
+#include "katana/Uri.h"
 #include "katana/config.h"
 #include "tsuba/RDG.h"
 
 namespace katana {
 
+class DeltaTopology;
+class NodePermutation;
+
 /// A graph topology represents the adjacency information for a graph in CSR
-/// format.
+/// format. Its arrays are uncompressed even if the graph was loaded from a
+/// compressed topology (see CompressedTopology).
 struct KATANA_EXPORT GraphTopology {
   using Node = uint32_t;
   using Edge = uint64_t;
@@ -70,6 +78,10 @@ struct KATANA_EXPORT GraphTopology {
     return out_dests->Value(eid);
   }
 
+  /// The raw edge destination array: the destinations of the out-edges of
+  /// node n are edge_dests()[e] for e in edges(n), contiguously.
+  const Node* edge_dests() const { return out_dests->raw_values(); }
+
   nodes_range nodes(Node begin, Node end) const {
     return MakeStandardRange<node_iterator>(begin, end);
   }
@@ -85,6 +97,220 @@ struct KATANA_EXPORT GraphTopology {
   bool empty() const { return num_nodes() == 0; }
 };
 
+/// An in-edge index is the transpose of a GraphTopology (i.e., the CSC form of
+/// the original CSR topology). The in-edges of each node are ordered by source
+/// node.
+struct KATANA_EXPORT InEdgeIndex {
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using edges_range = GraphTopology::edges_range;
+
+  /// topology.edges(n) are the in-edges of n and topology.edge_dest(e) is the
+  /// source of in-edge e
+  GraphTopology topology;
+  /// The id of each in-edge in the original topology. Use it to look up the
+  /// edge properties of an in-edge.
+  std::shared_ptr<arrow::UInt64Array> out_edge_ids;
+
+  uint64_t num_nodes() const { return topology.num_nodes(); }
+
+  uint64_t num_edges() const { return topology.num_edges(); }
+
+  /// \returns iterable in-edge range for node
+  edges_range in_edges(Node node) const { return topology.edges(node); }
+
+  /// \returns the source of an in-edge
+  Node in_edge_src(Edge in_edge) const { return topology.edge_dest(in_edge); }
+
+  /// \returns the id of an in-edge in the original topology
+  Edge out_edge_id(Edge in_edge) const { return out_edge_ids->Value(in_edge); }
+};
+
+/// An edge type index is a copy of a GraphTopology whose out-edges of each
+/// node are grouped by edge TypeSetID (see PropertyGraph::GetEdgeTypeSetID),
+/// in ascending order, so that the out-edges of a node with one TypeSetID
+/// are found by a search among the groups of the node alone. Within a
+/// group, edges keep the order they have in the original topology.
+struct KATANA_EXPORT EdgeTypeIndex {
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using edges_range = GraphTopology::edges_range;
+  using TypeSetID = uint16_t;
+
+  /// topology.edges(n) are the out-edges of n grouped by TypeSetID and
+  /// topology.edge_dest(e) is the destination of edge e
+  GraphTopology topology;
+  /// The id of each edge in the original topology. Use it to look up the
+  /// edge properties of an edge.
+  std::shared_ptr<arrow::UInt64Array> out_edge_ids;
+  /// The number of edge TypeSetIDs
+  uint64_t num_type_set_ids{0};
+  /// The groups of node n are those from group_indices[n - 1] (or 0) up to
+  /// group_indices[n]
+  std::shared_ptr<arrow::UInt64Array> group_indices;
+  /// The TypeSetID of each group, ascending within each node
+  std::shared_ptr<arrow::UInt16Array> group_types;
+  /// The first edge of each group and, last, num_edges(); a group ends
+  /// where the next begins
+  std::shared_ptr<arrow::UInt64Array> group_begins;
+
+  uint64_t num_nodes() const { return topology.num_nodes(); }
+
+  uint64_t num_edges() const { return topology.num_edges(); }
+
+  /// \returns iterable range of all out-edges of node
+  edges_range edges(Node node) const { return topology.edges(node); }
+
+  /// \returns iterable range of the out-edges of node with TypeSetID type
+  edges_range edges(Node node, TypeSetID type) const {
+    const TypeSetID* types = group_types->raw_values();
+    const TypeSetID* begin =
+        types + (node > 0 ? group_indices->Value(node - 1) : 0);
+    const TypeSetID* end = types + group_indices->Value(node);
+    const TypeSetID* it = std::lower_bound(begin, end, type);
+    if (it == end || *it != type) {
+      return MakeStandardRange<GraphTopology::edge_iterator>(0, 0);
+    }
+    uint64_t group = it - types;
+    return MakeStandardRange<GraphTopology::edge_iterator>(
+        group_begins->Value(group), group_begins->Value(group + 1));
+  }
+
+  /// \returns the destination of an edge
+  Node edge_dest(Edge edge) const { return topology.edge_dest(edge); }
+
+  /// \returns the id of an edge in the original topology
+  Edge out_edge_id(Edge edge) const { return out_edge_ids->Value(edge); }
+};
+
+/// An edge existence index finds the edge from a node to another in
+/// constant time for nodes of high out-degree, whose out-edges a binary
+/// search would take many cache misses to search. Each node of at least
+/// min_degree out-edges has an open addressing hash table of its own, of
+/// a power of two slots at least twice its degree, from the destinations of
+/// its out-edges to the first out-edge to each. The out-edges of other nodes
+/// are searched directly: by binary search if they are sorted by
+/// destination and by a scan if not. The index shares the arrays of the
+/// topology, so one of a topology mapped from storage is only valid while
+/// its graph is.
+struct KATANA_EXPORT EdgeExistenceIndex {
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+
+  /// The out-degree from which a node has a table, if not given
+  static constexpr uint64_t kDefaultMinDegree = 64;
+  /// An empty slot of a table
+  static constexpr uint64_t kEmptySlot = std::numeric_limits<uint64_t>::max();
+
+  /// The indexed topology
+  GraphTopology topology;
+  uint64_t min_degree{kDefaultMinDegree};
+  /// Whether the out-edges of every node are sorted by destination
+  bool sorted_by_dest{false};
+  /// The table of node n is the slots from table_begins[n] up to
+  /// table_begins[n + 1]; nodes of lower degree have empty tables
+  LargeArray<uint64_t> table_begins;
+  /// A full slot holds the destination of an edge in its high 32 bits and
+  /// the offset of the edge among the out-edges of its node in the low ones
+  LargeArray<uint64_t> slots;
+
+  uint64_t num_nodes() const { return topology.num_nodes(); }
+
+  /// \returns the first edge from src to dst, or the end of the out-edges of
+  /// src if there is none
+  Edge FindEdge(Node src, Node dst) const {
+    auto [begin, end] = topology.edge_range(src);
+    uint64_t table_begin = table_begins[src];
+    uint64_t table_size = table_begins[src + 1] - table_begin;
+    if (table_size > 0) {
+      const uint64_t* table = &slots[table_begin];
+      for (uint64_t i = FirstSlot(dst, table_size);;
+           i = (i + 1) & (table_size - 1)) {
+        if (table[i] == kEmptySlot) {
+          return end;
+        }
+        if ((table[i] >> 32) == dst) {
+          return begin + (table[i] & std::numeric_limits<uint32_t>::max());
+        }
+      }
+    }
+    const Node* dests = topology.edge_dests();
+    if (sorted_by_dest) {
+      const Node* it = std::lower_bound(dests + begin, dests + end, dst);
+      return it != dests + end && *it == dst ? it - dests : end;
+    }
+    return std::find(dests + begin, dests + end, dst) - dests;
+  }
+
+  /// \returns true if there is an edge from src to dst
+  bool HasEdge(Node src, Node dst) const {
+    return FindEdge(src, dst) != topology.edge_range(src).second;
+  }
+
+  /// \returns the slot of a table of table_size slots to probe first for dst
+  static uint64_t FirstSlot(Node dst, uint64_t table_size) {
+    // Fibonacci hashing: the high bits of the product are the best mixed
+    return (dst * UINT64_C(11400714819323198485)) >>
+           (64 - __builtin_ctzll(table_size));
+  }
+};
+
+/// A temporal edge index is a copy of a GraphTopology whose out-edges of each
+/// node are sorted by a timestamp edge property, and then by edge id, so that
+/// the out-edges of a node within a window of time are found by a binary
+/// search among the edges of the node alone (see TemporalWindow). Edges with
+/// a null timestamp come last, at kNullTime, and are in no window.
+struct KATANA_EXPORT TemporalEdgeIndex {
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using edges_range = GraphTopology::edges_range;
+
+  /// The timestamp of edges whose timestamp is null, after every window
+  static constexpr int64_t kNullTime = std::numeric_limits<int64_t>::max();
+
+  /// topology.edges(n) are the out-edges of n sorted by timestamp and
+  /// topology.edge_dest(e) is the destination of edge e
+  GraphTopology topology;
+  /// The id of each edge in the original topology. Use it to look up the
+  /// edge properties of an edge.
+  std::shared_ptr<arrow::UInt64Array> out_edge_ids;
+  /// The timestamp of each edge of topology, in the units of the property
+  LargeArray<int64_t> timestamps;
+  /// The edge property that the index sorts by
+  std::string timestamp_property_name;
+  /// The column of the property when the index was built; the index is
+  /// stale once the graph holds another
+  std::weak_ptr<arrow::ChunkedArray> source;
+
+  uint64_t num_nodes() const { return topology.num_nodes(); }
+
+  uint64_t num_edges() const { return topology.num_edges(); }
+
+  /// \returns iterable range of all out-edges of node
+  edges_range edges(Node node) const { return topology.edges(node); }
+
+  /// \returns iterable range of the out-edges of node whose timestamps are
+  /// in [begin_time, end_time)
+  edges_range edges(Node node, int64_t begin_time, int64_t end_time) const {
+    auto [begin, end] = topology.edge_range(node);
+    const int64_t* times = timestamps.data();
+    const int64_t* first =
+        std::lower_bound(times + begin, times + end, begin_time);
+    const int64_t* last = std::lower_bound(first, times + end, end_time);
+    return MakeStandardRange<GraphTopology::edge_iterator>(
+        first - times, last - times);
+  }
+
+  /// \returns the destination of an edge
+  Node edge_dest(Edge edge) const { return topology.edge_dest(edge); }
+
+  /// \returns the timestamp of an edge
+  int64_t timestamp(Edge edge) const { return timestamps[edge]; }
+
+  /// \returns the id of an edge in the original topology
+  Edge out_edge_id(Edge edge) const { return out_edge_ids->Value(edge); }
+};
+
 /// A property graph is a graph that has properties associated with its nodes
 /// and edges. A property has a name and value. Its value may be a primitive
 /// type, a list of values or a composition of properties.
@@ -100,15 +326,16 @@ struct KATANA_EXPORT GraphTopology {
 class KATANA_EXPORT PropertyGraph {
 public:
   /// TypeSetID uniquely identifies/contains a combination/set of types
-  /// TypeSetID is represented using 8 bits
+  /// TypeSetID is represented using 16 bits
   /// TypeSetID for nodes is distinct from TypeSetID for edges
-  using TypeSetID = uint8_t;
+  using TypeSetID = uint16_t;
   static constexpr TypeSetID kUnknownType = TypeSetID{0};
   static constexpr TypeSetID kInvalidType =
       std::numeric_limits<TypeSetID>::max();
-  /// A set of TypeSetIDs
-  using SetOfTypeSetIDs =
-      std::bitset<std::numeric_limits<TypeSetID>::max() + 1>;
+  /// A set of TypeSetIDs. Few of the TypeSetIDs contain a given type, so the
+  /// set is sparse; TypeSetIDs below SparseBitmap::kBlockBits, which
+  /// graphs with few combinations of types use, fit in a single block.
+  using SetOfTypeSetIDs = SparseBitmap;
   /// A set of type names
   using SetOfTypeNames = std::unordered_set<std::string>;
   /// A map from TypeSetID to the set of the type names it contains
@@ -136,6 +363,15 @@ private:
   Result<void> WriteGraph(
       const std::string& uri, const std::string& command_line);
 
+  /// Record a use of the node or edge properties \param names and evict the
+  /// least recently used properties if the loaded ones exceed the memory
+  /// budget
+  void UseProperties(bool nodes, const std::vector<std::string>& names) const;
+  Result<void> EnforcePropertyMemoryBudget() const;
+  std::shared_ptr<arrow::ChunkedArray> PinProperty(
+      bool nodes, const std::string& name,
+      std::shared_ptr<arrow::ChunkedArray> property) const;
+
   tsuba::RDG rdg_;
   std::unique_ptr<tsuba::RDGFile> file_;
 
@@ -143,6 +379,29 @@ private:
   // caller of SetTopology.
   GraphTopology topology_;
 
+  /// The in-edge index is built lazily and shared by all of its users until
+  /// the topology changes. If it was loaded from storage, it is backed by rdg_.
+  std::shared_ptr<const InEdgeIndex> in_edge_index_;
+  /// Whether to store the in-edge index alongside the topology
+  bool persist_in_edge_index_{false};
+  /// The edge type index is built lazily like the in-edge index and dropped
+  /// when the topology or the edge TypeSetIDs change
+  std::shared_ptr<const EdgeTypeIndex> edge_type_index_;
+  /// The edge existence index is built lazily like the in-edge index, for
+  /// the min_degree of the last GetEdgeExistenceIndex, and dropped when the
+  /// topology changes
+  std::shared_ptr<const EdgeExistenceIndex> edge_existence_index_;
+  /// The temporal edge index is built lazily like the in-edge index, for the
+  /// timestamp property of the last GetTemporalEdgeIndex, and dropped when
+  /// the topology changes
+  std::shared_ptr<const TemporalEdgeIndex> temporal_edge_index_;
+
+  /// Whether the topology is written in the compressed CSR format
+  bool compress_topology_{false};
+  /// Whether the topology file that the last Write stored, if rdg_ still
+  /// references it, is in the compressed CSR format
+  bool stored_topology_compressed_{false};
+
   /// A map from the node TypeSetID to
   /// the set of the node type names it contains
   TypeSetIDToSetOfTypeNamesMap node_type_set_id_to_type_names_;
@@ -162,9 +421,31 @@ private:
   /// The edge TypeSetID for each edge in the graph
   katana::LargeArray<TypeSetID> edge_type_set_id_;
 
+  /// The bytes the loaded properties may use, or 0 for no limit
+  uint64_t property_memory_budget_{0};
+  /// Where properties changed since they were stored are spilled to
+  katana::Uri spill_dir_;
+  /// The last use of each property, by a clock that ticks at every use.
+  /// Getting a property is a use, hence mutable.
+  mutable uint64_t property_clock_{0};
+  mutable std::unordered_map<std::string, uint64_t> node_property_uses_;
+  mutable std::unordered_map<std::string, uint64_t> edge_property_uses_;
+  /// The number of live pins of each property, which the memory budget does
+  /// not evict. Pins reference the counts weakly, so they may outlive the
+  /// graph.
+  struct PropertyPins {
+    std::unordered_map<std::string, uint32_t> nodes;
+    std::unordered_map<std::string, uint32_t> edges;
+  };
+  std::shared_ptr<PropertyPins> property_pins_{
+      std::make_shared<PropertyPins>()};
+
   // Keep partition_metadata, master_nodes, mirror_nodes out of the public interface,
-  // while allowing Distribution to read/write it for RDG
+  // while allowing Distribution to read/write it for RDG, PartitionLoader to
+  // write it and MirrorSync to read it
   friend class Distribution;
+  friend class MirrorSync;
+  friend class PartitionLoader;
   const tsuba::PartitionMetadata& partition_metadata() const {
     return rdg_.part_metadata();
   }
@@ -251,23 +532,52 @@ public:
   PropertyGraph();
 
   /// Make a property graph from a constructed RDG. Take ownership of the RDG
-  /// and its underlying resources.
+  /// and its underlying resources. If \param memory_pool is not null, the
+  /// topology is copied into memory from it instead of being used in place
+  /// (see tsuba::RDGLoadOptions::memory_pool). Each thread copies the
+  /// topology of the nodes that a do_all over the nodes gives it, so with a
+  /// NumaMemoryPool of the kBlocked or kFloating policy the topology of a
+  /// node is on the NUMA node of the thread that iterates over it.
   static Result<std::unique_ptr<PropertyGraph>> Make(
-      std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg);
+      std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg,
+      arrow::MemoryPool* memory_pool = nullptr);
 
   /// Make a property graph from an RDG name.
   static Result<std::unique_ptr<PropertyGraph>> Make(
       const std::string& rdg_name,
       const tsuba::RDGLoadOptions& opts = tsuba::RDGLoadOptions());
 
-  /// \return A copy of this with the same set of properties. The copy shares no
-  ///       state with this.
+  /// Make one property graph of all the partitions of a partitioned RDG,
+  /// which load in parallel, for a single host with many sockets. The nodes
+  /// are the masters of the partitions in partition order, with all of
+  /// their edges, mirrors included, and their properties;
+  /// local_to_global_id maps them back to the nodes of the RDG. The topology
+  /// of each partition is placed on the NUMA nodes of the threads that load
+  /// it. opts.partition_id_to_load is ignored; an RDG of one partition loads
+  /// as with Make.
+  static Result<std::unique_ptr<PropertyGraph>> MakeFromAllPartitions(
+      const std::string& rdg_name,
+      const tsuba::RDGLoadOptions& opts = tsuba::RDGLoadOptions());
+
+  /// \return A copy of this with the same set of properties, made like the
+  ///       copy of a subset below
   Result<std::unique_ptr<PropertyGraph>> Copy() const;
 
+  /// Copy this graph in memory, without reading it from storage again except
+  /// for the selected properties not loaded yet. The copy shares the
+  /// topology and the buffers of the selected properties with this graph
+  /// instead of copying them. Arrow arrays are immutable, so adding,
+  /// upserting or removing properties of either graph leaves the other
+  /// unchanged, and the first graph to modify a shared topology in place
+  /// copies it (see EnsureTopologyUnshared). Writing into a shared property
+  /// in place, e.g., through a property view, is seen by both graphs;
+  /// upsert a new column instead. A topology mapped from storage is copied,
+  /// since the mapping lives only as long as this graph. The copy is not
+  /// backed by storage and has no TypeSetIDs until ConstructTypeSetIDs.
+  ///
   /// \param node_properties The node properties to copy.
   /// \param edge_properties The edge properties to copy.
-  /// \return A copy of this with a subset of the properties. The copy shares no
-  ///        state with this.
+  /// \return A copy of this with a subset of the properties.
   Result<std::unique_ptr<PropertyGraph>> Copy(
       const std::vector<std::string>& node_properties,
       const std::vector<std::string>& edge_properties) const;
@@ -333,6 +643,12 @@ public:
   /// Like \ref Write(const std::string&, const std::string&) but can only update
   /// parts of the original read location of the graph.
   Result<void> Commit(const std::string& command_line);
+
+  /// Like \ref Commit(const std::string&) but writes the property files with
+  /// \param opts, e.g., to choose the codecs and encodings of some columns
+  Result<void> Commit(
+      const std::string& command_line,
+      const tsuba::ParquetWriter::WriteOpts& opts);
   /// Tell the RDG where it's data is coming from
   Result<void> InformPath(const std::string& input_path);
 
@@ -341,14 +657,21 @@ public:
   /// Report the differences between two graphs
   std::string ReportDiff(const PropertyGraph* other) const;
 
+  /// The schema of every node property, including those of a graph loaded
+  /// with tsuba::RDGLoadOptions::lazy_properties that are not loaded yet
   std::shared_ptr<arrow::Schema> node_schema() const {
-    return node_properties()->schema();
+    return rdg_.full_node_schema();
   }
 
   std::shared_ptr<arrow::Schema> edge_schema() const {
-    return edge_properties()->schema();
+    return rdg_.full_edge_schema();
   }
 
+  /// \returns the latest version of the node and edge properties, which
+  /// readers may keep using while this graph adds or removes properties;
+  /// see tsuba::RDGSnapshot. Lazy properties are loaded first.
+  std::shared_ptr<const tsuba::RDGSnapshot> PropertySnapshot() const;
+
   /// \returns the number of node types
   size_t GetNodeTypesNum() const {
     return node_type_name_to_type_set_ids_.size();
@@ -426,57 +749,53 @@ public:
   }
 
   // Return type dictated by arrow
-  int32_t GetNodePropertyNum() const {
-    return node_properties()->num_columns();
-  }
-  int32_t GetEdgePropertyNum() const {
-    return edge_properties()->num_columns();
-  }
+  int32_t GetNodePropertyNum() const { return node_schema()->num_fields(); }
+  int32_t GetEdgePropertyNum() const { return edge_schema()->num_fields(); }
 
   // num_rows() == num_nodes() (all local nodes)
   std::shared_ptr<arrow::ChunkedArray> GetNodeProperty(int i) const {
-    if (i >= rdg_.node_properties()->num_columns()) {
+    if (i >= GetNodePropertyNum()) {
       return nullptr;
     }
-    return node_properties()->column(i);
+    return GetNodeProperty(node_schema()->field(i)->name());
   }
 
   // num_rows() == num_edges() (all local edges)
   std::shared_ptr<arrow::ChunkedArray> GetEdgeProperty(int i) const {
-    if (i >= edge_properties()->num_columns()) {
+    if (i >= GetEdgePropertyNum()) {
       return nullptr;
     }
-    return edge_properties()->column(i);
+    return GetEdgeProperty(edge_schema()->field(i)->name());
   }
 
   /// \returns true if a node property/type with @param name exists
   bool HasNodeProperty(const std::string& name) const {
-    return node_properties()->schema()->GetFieldIndex(name) != -1;
+    return node_schema()->GetFieldIndex(name) != -1;
   }
 
   /// \returns true if an edge property/type with @param name exists
   bool HasEdgeProperty(const std::string& name) const {
-    return edge_properties()->schema()->GetFieldIndex(name) != -1;
+    return edge_schema()->GetFieldIndex(name) != -1;
   }
 
-  /// Get a node property by name.
+  /// Get a node property by name. A lazy property (see
+  /// tsuba::RDGLoadOptions::lazy_properties) is loaded the first time it is
+  /// gotten, which, like changing properties, must not happen concurrently
+  /// with other uses of the properties.
   ///
   /// \param name The name of the property to get.
-  /// \return The property data or NULL if the property is not found.
+  /// \return The property data or NULL if the property is not found or
+  /// cannot be loaded.
   std::shared_ptr<arrow::ChunkedArray> GetNodeProperty(
-      const std::string& name) const {
-    return node_properties()->GetColumnByName(name);
-  }
+      const std::string& name) const;
   std::vector<std::string> GetNodePropertyNames() const {
-    return node_properties()->ColumnNames();
+    return node_schema()->field_names();
   }
 
   std::shared_ptr<arrow::ChunkedArray> GetEdgeProperty(
-      const std::string& name) const {
-    return edge_properties()->GetColumnByName(name);
-  }
+      const std::string& name) const;
   std::vector<std::string> GetEdgePropertyNames() const {
-    return edge_properties()->ColumnNames();
+    return edge_schema()->field_names();
   }
 
   /// Get a node property by name and cast it to a type.
@@ -542,9 +861,125 @@ public:
     return rdg_.MarkEdgePropertiesPersistent(persist_edge_props);
   }
 
+  /// Record how node property \param name was computed and mark it
+  /// persistent; see tsuba::RDG::SetNodePropertyDerivation and
+  /// katana::analytics::MemoizeNodeProperty
+  Result<void> SetNodePropertyDerivation(
+      const std::string& name, const std::string& derivation) {
+    return rdg_.SetNodePropertyDerivation(name, derivation);
+  }
+
+  /// \returns how node property \param name was computed, or empty if
+  /// unknown
+  std::string GetNodePropertyDerivation(const std::string& name) const {
+    return rdg_.GetNodePropertyDerivation(name);
+  }
+
+  /// \returns a name of the stored contents of the topology and of the node
+  /// and edge properties given, or empty if any of them is not stored as
+  /// it is; see tsuba::RDG::StoredVersion
+  std::string StoredVersion(
+      const std::vector<std::string>& node_props,
+      const std::vector<std::string>& edge_props) const {
+    return rdg_.StoredVersion(node_props, edge_props);
+  }
+
   const GraphTopology& topology() const { return topology_; }
 
-  /// Add Node properties that do not exist in the current graph
+  /// Get the in-edge index of this graph. The index is built on first use (or
+  /// mapped from storage if the graph was stored with one) and is shared by
+  /// subsequent callers until the topology changes. An index mapped from
+  /// storage is only valid while this graph is.
+  ///
+  /// This function is not thread-safe; call it outside of parallel loops.
+  Result<std::shared_ptr<const InEdgeIndex>> GetInEdgeIndex();
+
+  /// \returns true if the in-edge index is already built or loaded
+  bool HasInEdgeIndex() const { return in_edge_index_ != nullptr; }
+
+  /// Get the edge type index of this graph, for traversals that follow only
+  /// edges of some types. The index is built on first use and shared by
+  /// subsequent callers until the topology changes. Requires
+  /// ConstructTypeSetIDs.
+  ///
+  /// This function is not thread-safe; call it outside of parallel loops.
+  Result<std::shared_ptr<const EdgeTypeIndex>> GetEdgeTypeIndex();
+
+  /// Get the edge existence index of this graph, for finding edges between
+  /// given nodes, e.g., by FindEdgeSortedByDest, which uses it once it is
+  /// built. The index is built on first use, or again if min_degree
+  /// differs, and shared by subsequent callers until the topology changes.
+  ///
+  /// This function is not thread-safe; call it outside of parallel loops.
+  Result<std::shared_ptr<const EdgeExistenceIndex>> GetEdgeExistenceIndex(
+      uint64_t min_degree = EdgeExistenceIndex::kDefaultMinDegree);
+
+  /// \returns the edge existence index if it is built, or null
+  const EdgeExistenceIndex* edge_existence_index() const {
+    return edge_existence_index_.get();
+  }
+
+  /// Get the temporal edge index of this graph for the timestamp edge
+  /// property named timestamp_property_name, for traversals of the edges
+  /// within windows of time (see TemporalWindow). The property may be of any
+  /// timestamp type, date64 or int64. The index is built on first use, or
+  /// again if the property differs or was replaced since, and shared by
+  /// subsequent callers until the topology changes.
+  ///
+  /// This function is not thread-safe; call it outside of parallel loops.
+  Result<std::shared_ptr<const TemporalEdgeIndex>> GetTemporalEdgeIndex(
+      const std::string& timestamp_property_name);
+
+  /// Forget the in-edge index. Anything that modifies the topology in place
+  /// must call this.
+  Result<void> DropInEdgeIndex();
+
+  /// Whether the in-edge index is persisted as a sidecar of the topology when
+  /// this graph is written. It is persisted by default if it was loaded from
+  /// storage.
+  void set_persist_in_edge_index(bool persist) {
+    persist_in_edge_index_ = persist;
+  }
+
+  /// Whether the topology is written in the compressed CSR format (see
+  /// tsuba::kCompressedCSRTopologyVersion) the next time this graph is
+  /// written. Compressed topologies are smaller in storage but are decoded
+  /// into memory when loaded instead of being mapped, so the loaded graph uses
+  /// as much memory as an uncompressed one; CompressedTopology reads them
+  /// without decoding. They cannot be read by tsuba::RDGSlice. It is on by
+  /// default if the graph was loaded from a compressed topology.
+  void set_compress_topology(bool compress) { compress_topology_ = compress; }
+
+  /// \returns true if the out-edges of every node are known to be sorted by
+  /// destination. The property is persisted with the graph, so a graph sorted
+  /// once (e.g., by SortAllEdgesByDest) stays sorted across loads.
+  bool edges_sorted_by_dest() const { return rdg_.topology_sorted_by_dest(); }
+
+  /// Inform this graph that its topology was modified in place. Derived
+  /// state like the in-edge index is dropped and the topology is written
+  /// again on the next Write.
+  ///
+  /// \param sorted_by_dest whether the out-edges of every node are sorted by
+  /// destination after the modification
+  Result<void> MarkTopologyModified(bool sorted_by_dest);
+
+  /// Copy the topology into memory of this graph alone if it is shared with
+  /// another graph, e.g., a copy of this one (see Copy), so that it may be
+  /// modified in place. Call it before modifying the topology in place and
+  /// MarkTopologyModified after.
+  Result<void> EnsureTopologyUnshared();
+
+  /// The field metadata key of a property that should keep the chunks it was
+  /// added with; see AddNodeProperties
+  static constexpr const char* kKeepChunksKey = "katana.keep_chunks";
+
+  /// Add Node properties that do not exist in the current graph.
+  ///
+  /// The chunks of each property are combined into one array, in parallel
+  /// across properties, so that property views see contiguous buffers.
+  /// Properties that already have one chunk are added without a copy, as
+  /// are those whose field metadata sets kKeepChunksKey to "true". The same
+  /// holds for the other Add and Upsert methods.
   Result<void> AddNodeProperties(const std::shared_ptr<arrow::Table>& props);
   /// Add Edge properties that do not exist in the current graph
   Result<void> AddEdgeProperties(const std::shared_ptr<arrow::Table>& props);
@@ -559,6 +994,34 @@ public:
   Result<void> RemoveEdgeProperty(int i);
   Result<void> RemoveEdgeProperty(const std::string& prop_name);
 
+  /// Keep the loaded node and edge properties within \param max_bytes, as
+  /// counted by the buffers of their arrays, by evicting those least
+  /// recently gotten, added or upserted (see tsuba::RDG::EvictNodeProperty).
+  /// Evicted properties load again when they are gotten; those changed since
+  /// they were stored are first spilled to files in \param spill_dir. The
+  /// most recently used property and pinned properties (see PinNodeProperty)
+  /// are never evicted, even if they alone exceed the budget, and a budget of
+  /// 0 evicts nothing.
+  ///
+  /// While there is a budget, getting a property may evict others, so
+  /// properties must not be gotten concurrently; readers on other threads
+  /// should use PropertySnapshot.
+  Result<void> SetPropertyMemoryBudget(
+      uint64_t max_bytes, const std::string& spill_dir);
+
+  /// The bytes of the buffers of the loaded node and edge properties
+  uint64_t loaded_property_bytes() const;
+
+  /// Get a node property like GetNodeProperty and keep it loaded, whatever
+  /// the memory budget, until the returned array and all of its copies are
+  /// destroyed. Views that point into the buffers of a property, like those
+  /// of TypedPropertyGraph, pin it.
+  std::shared_ptr<arrow::ChunkedArray> PinNodeProperty(
+      const std::string& name) const;
+  /// \see PinNodeProperty
+  std::shared_ptr<arrow::ChunkedArray> PinEdgeProperty(
+      const std::string& name) const;
+
   /// Remove all node properties
   void DropNodeProperties() { rdg_.DropNodeProperties(); }
   /// Remove all edge properties
@@ -592,7 +1055,22 @@ public:
 
   Result<void> SetTopology(const GraphTopology& topology);
 
-  /// Return the node property table for local nodes
+  /// Fold the edge changes applied to delta into the topology of this graph.
+  /// delta must have been made from the topology of this graph; it is
+  /// compacted and its new base becomes the topology of this graph.
+  ///
+  /// Edges kept from the old topology keep their properties and types.
+  /// Inserted edges have null properties and the unknown type.
+  Result<void> ApplyDeltaTopology(DeltaTopology* delta);
+
+  /// Relabel the nodes of this graph in place: node n becomes
+  /// perm.NewId(n). Node and edge properties and types move with their
+  /// nodes and edges, and the out-edges of each node keep their order. See
+  /// also RelabelNodes, which relabels a copy.
+  Result<void> ApplyNodePermutation(const NodePermutation& perm);
+
+  /// Return the node property table for local nodes, loading the lazy
+  /// properties not loaded yet
   const std::shared_ptr<arrow::Table>& node_properties() const {
     return rdg_.node_properties();
   }
@@ -636,16 +1114,53 @@ public:
   }
 };
 
+/// MakeInEdgeIndex builds the in-edge index of a topology in parallel.
+///
+/// Prefer PropertyGraph::GetInEdgeIndex, which caches the result.
+KATANA_EXPORT Result<std::shared_ptr<InEdgeIndex>> MakeInEdgeIndex(
+    const GraphTopology& topology);
+
+/// MakeEdgeTypeIndex builds the edge type index of a graph in parallel.
+///
+/// Prefer PropertyGraph::GetEdgeTypeIndex, which caches the result.
+KATANA_EXPORT Result<std::shared_ptr<EdgeTypeIndex>> MakeEdgeTypeIndex(
+    const PropertyGraph& pg);
+
+/// MakeEdgeExistenceIndex builds the edge existence index of a graph in
+/// parallel, with tables for the nodes of at least min_degree out-edges.
+///
+/// Prefer PropertyGraph::GetEdgeExistenceIndex, which caches the result.
+KATANA_EXPORT Result<std::shared_ptr<EdgeExistenceIndex>>
+MakeEdgeExistenceIndex(
+    const PropertyGraph& pg,
+    uint64_t min_degree = EdgeExistenceIndex::kDefaultMinDegree);
+
+/// MakeTemporalEdgeIndex builds the temporal edge index of a graph for the
+/// timestamp edge property named timestamp_property_name in parallel.
+///
+/// Prefer PropertyGraph::GetTemporalEdgeIndex, which caches the result.
+KATANA_EXPORT Result<std::shared_ptr<TemporalEdgeIndex>> MakeTemporalEdgeIndex(
+    const PropertyGraph& pg, const std::string& timestamp_property_name);
+
 /// SortAllEdgesByDest sorts edges for each node by destination
 /// IDs (ascending order).
 ///
 /// Returns the permutation vector (mapping from old
-/// indices to the new indices) which results due to the sorting.
+/// indices to the new indices) which results due to the sorting. If the edges
+/// are already sorted (see PropertyGraph::edges_sorted_by_dest), nothing is
+/// sorted and the identity permutation is returned. A topology shared with
+/// another graph is copied before it is sorted.
 KATANA_EXPORT Result<std::shared_ptr<arrow::UInt64Array>> SortAllEdgesByDest(
     PropertyGraph* pg);
 
+/// EnsureAllEdgesSortedByDest is SortAllEdgesByDest for callers that do not
+/// need the permutation. It does nothing if the edges are already sorted.
+KATANA_EXPORT Result<void> EnsureAllEdgesSortedByDest(PropertyGraph* pg);
+
 /// FindEdgeSortedByDest finds the "node_to_find" id in the
-/// sorted edgelist of the "node" using binary search.
+/// sorted edgelist of the "node" using binary search, or using the edge
+/// existence index of the graph if it is built (see
+/// PropertyGraph::GetEdgeExistenceIndex).
 ///
 /// This returns the matched edge index if 'node_to_find' is present
 /// in the edgelist of 'node' else edge end if 'node_to_find' is not found.
@@ -654,7 +1169,7 @@ KATANA_EXPORT GraphTopology::Edge FindEdgeSortedByDest(
     GraphTopology::Node node_to_find);
 
 /// Relabel all nodes in the graph by sorting in the descending
-/// order by node degree.
+/// order by node degree (see NodeOrder::kDegree).
 KATANA_EXPORT Result<void> SortNodesByDegree(PropertyGraph* pg);
 
 /// Creates in-memory symmetric (or undirected) graph.
@@ -11,6 +11,25 @@ namespace katana::internal {
 KATANA_EXPORT Result<std::vector<arrow::Array*>> ExtractArrays(
     const arrow::Table* table, const std::vector<std::string>& properties);
 
+/// ExtractArrays returns the array for each column. It returns an error if
+/// a column is null or there is more than one array for any column.
+KATANA_EXPORT Result<std::vector<arrow::Array*>> ExtractArrays(
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& columns);
+
+template <typename PropTuple>
+Result<katana::PropertyViewTuple<PropTuple>>
+MakePropertyViews(const std::vector<arrow::Array*>& arrays) {
+  if (arrays.size() < std::tuple_size_v<PropTuple>) {
+    return std::errc::invalid_argument;
+  }
+
+  auto views_result = ConstructPropertyViews<PropTuple>(arrays);
+  if (!views_result) {
+    return views_result.error();
+  }
+  return views_result.value();
+}
+
 template <typename PropTuple>
 Result<katana::PropertyViewTuple<PropTuple>>
 MakePropertyViews(
@@ -19,17 +38,37 @@ MakePropertyViews(
   if (!arrays_result) {
     return arrays_result.error();
   }
+  return MakePropertyViews<PropTuple>(arrays_result.value());
+}
 
-  auto arrays = std::move(arrays_result.value());
-
-  if (arrays.size() < std::tuple_size_v<PropTuple>) {
+/// MakePinnedPropertyViews makes views of the first properties, one per
+/// element of the view, which pin_fn gets and pins. The pins are appended to
+/// \param pins, which must outlive the views.
+template <typename PropTuple, typename PinFn>
+Result<katana::PropertyViewTuple<PropTuple>>
+MakePinnedPropertyViews(
+    const std::vector<std::string>& properties, PinFn pin_fn,
+    std::vector<std::shared_ptr<arrow::ChunkedArray>>* pins) {
+  if (properties.size() < std::tuple_size_v<PropTuple>) {
     return std::errc::invalid_argument;
   }
 
-  auto views_result = ConstructPropertyViews<PropTuple>(arrays);
+  // Pin each property as it is gotten, so that getting the next one does
+  // not evict it
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (size_t i = 0; i < std::tuple_size_v<PropTuple>; ++i) {
+    columns.emplace_back(pin_fn(properties[i]));
+  }
+  auto arrays_result = ExtractArrays(columns);
+  if (!arrays_result) {
+    return arrays_result.error();
+  }
+
+  auto views_result = MakePropertyViews<PropTuple>(arrays_result.value());
   if (!views_result) {
     return views_result.error();
   }
+  pins->insert(pins->end(), columns.begin(), columns.end());
   return views_result.value();
 }
 
@@ -37,14 +76,22 @@ MakePropertyViews(
 /// This version selects a specific set of properties to include in the typed
 /// view.
 ///
+/// Only the properties of the view are loaded, and they stay loaded, whatever
+/// the memory budget of the graph, while \param pins holds them (see
+/// PropertyGraph::PinNodeProperty).
+///
 /// It returns an error if there are fewer properties than elements of the
 /// view or if the underlying arrow::ChunkedArray has more than one
 /// arrow::Array.
 template <typename PropTuple>
 static Result<katana::PropertyViewTuple<PropTuple>>
 MakeNodePropertyViews(
-    const PropertyGraph* pg, const std::vector<std::string>& properties) {
-  return MakePropertyViews<PropTuple>(pg->node_properties().get(), properties);
+    const PropertyGraph* pg, const std::vector<std::string>& properties,
+    std::vector<std::shared_ptr<arrow::ChunkedArray>>* pins) {
+  return MakePinnedPropertyViews<PropTuple>(
+      properties,
+      [pg](const std::string& name) { return pg->PinNodeProperty(name); },
+      pins);
 }
 
 /// MakeNodePropertyViews asserts a typed view on top of runtime properties.
@@ -54,8 +101,11 @@ MakeNodePropertyViews(
 /// arrow::Array.
 template <typename PropTuple>
 static Result<katana::PropertyViewTuple<PropTuple>>
-MakeNodePropertyViews(const PropertyGraph* pg) {
-  return MakeNodePropertyViews<PropTuple>(pg, pg->node_schema()->field_names());
+MakeNodePropertyViews(
+    const PropertyGraph* pg,
+    std::vector<std::shared_ptr<arrow::ChunkedArray>>* pins) {
+  return MakeNodePropertyViews<PropTuple>(
+      pg, pg->node_schema()->field_names(), pins);
 }
 
 /// MakeEdgePropertyViews asserts a typed view on top of runtime properties.
@@ -66,8 +116,12 @@ MakeNodePropertyViews(const PropertyGraph* pg) {
 template <typename PropTuple>
 static Result<katana::PropertyViewTuple<PropTuple>>
 MakeEdgePropertyViews(
-    const PropertyGraph* pg, const std::vector<std::string>& properties) {
-  return MakePropertyViews<PropTuple>(pg->edge_properties().get(), properties);
+    const PropertyGraph* pg, const std::vector<std::string>& properties,
+    std::vector<std::shared_ptr<arrow::ChunkedArray>>* pins) {
+  return MakePinnedPropertyViews<PropTuple>(
+      properties,
+      [pg](const std::string& name) { return pg->PinEdgeProperty(name); },
+      pins);
 }
 
 /// MakeEdgePropertyViews asserts a typed view on top of runtime properties.
@@ -75,8 +129,11 @@ MakeEdgePropertyViews(
 /// \see MakeNodePropertyViews
 template <typename PropTuple>
 static Result<katana::PropertyViewTuple<PropTuple>>
-MakeEdgePropertyViews(const PropertyGraph* pg) {
-  return MakeEdgePropertyViews<PropTuple>(pg, pg->edge_schema()->field_names());
+MakeEdgePropertyViews(
+    const PropertyGraph* pg,
+    std::vector<std::shared_ptr<arrow::ChunkedArray>>* pins) {
+  return MakeEdgePropertyViews<PropTuple>(
+      pg, pg->edge_schema()->field_names(), pins);
 }
 
 }  // namespace katana::internal
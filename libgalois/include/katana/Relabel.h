@@ -0,0 +1,122 @@
+#ifndef KATANA_LIBGALOIS_KATANA_RELABEL_H_
+#define KATANA_LIBGALOIS_KATANA_RELABEL_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The orders in which ComputeNodeOrder can place the nodes of a graph
+enum class NodeOrder {
+  /// Descending out-degree; nodes of equal degree keep their order. Hubs
+  /// come first, which is what triangle counting wants.
+  kDegree,
+  /// Reverse Cuthill-McKee: breadth first from a node of least degree,
+  /// visiting neighbors by ascending degree, then reversed. Places
+  /// neighbors close together and keeps the bandwidth of the adjacency
+  /// matrix small.
+  kReverseCuthillMcKee,
+  /// A greedy approximation of Gorder: each next node is the one with the
+  /// most edges, in either direction, to the last kLocalityWindow placed
+  /// nodes. Nodes visited together by edge traversals end up close in
+  /// memory.
+  kLocality,
+};
+
+/// The number of recently placed nodes that NodeOrder::kLocality scores
+/// candidates against
+constexpr uint32_t kLocalityWindow = 5;
+
+/// The node property in which RelabelNodes records the id each node had in
+/// the original graph. It is stored with the relabeled graph when it is
+/// written, so the permutation survives reloading; see
+/// NodePermutation::FromOriginalIds.
+constexpr const char* kOriginalNodeIdProperty = "katana_original_node_id";
+
+/// A relabeling of the nodes of a graph, with its inverse
+class KATANA_EXPORT NodePermutation {
+public:
+  using Node = GraphTopology::Node;
+
+  /// \param old_ids the original id of each node of the relabeled graph;
+  ///     it must be a permutation of [0, old_ids->length())
+  static Result<NodePermutation> Make(
+      std::shared_ptr<arrow::UInt32Array> old_ids);
+
+  /// \returns the permutation that relabeled \p relabeled, from its
+  ///     kOriginalNodeIdProperty
+  static Result<NodePermutation> FromOriginalIds(
+      const PropertyGraph& relabeled);
+
+  uint64_t size() const { return old_ids_->length(); }
+
+  /// \returns the id in the relabeled graph of original node \p old_id
+  Node NewId(Node old_id) const { return new_ids_->Value(old_id); }
+
+  /// \returns the original id of node \p new_id of the relabeled graph
+  Node OldId(Node new_id) const { return old_ids_->Value(new_id); }
+
+  const std::shared_ptr<arrow::UInt32Array>& new_ids() const {
+    return new_ids_;
+  }
+
+  const std::shared_ptr<arrow::UInt32Array>& old_ids() const {
+    return old_ids_;
+  }
+
+  /// Map per-node values computed on the relabeled graph, e.g., a result
+  /// property, back to the original node order.
+  Result<std::shared_ptr<arrow::Array>> ToOriginalOrder(
+      const std::shared_ptr<arrow::Array>& values) const;
+
+  /// Map per-node values of the original graph to the relabeled order
+  Result<std::shared_ptr<arrow::Array>> ToNewOrder(
+      const std::shared_ptr<arrow::Array>& values) const;
+
+private:
+  NodePermutation(
+      std::shared_ptr<arrow::UInt32Array> new_ids,
+      std::shared_ptr<arrow::UInt32Array> old_ids)
+      : new_ids_(std::move(new_ids)), old_ids_(std::move(old_ids)) {}
+
+  std::shared_ptr<arrow::UInt32Array> new_ids_;
+  std::shared_ptr<arrow::UInt32Array> old_ids_;
+};
+
+/// Compute a relabeling of the nodes of \p pg that places them in \p order
+KATANA_EXPORT Result<NodePermutation> ComputeNodeOrder(
+    const PropertyGraph& pg, NodeOrder order);
+
+/// Compute a relabeling of the nodes of \p pg that groups them by the
+/// ascending values of the integer node property \p property, e.g., the
+/// partition of each node computed by graph partitioning. Nodes with equal
+/// values keep their order.
+KATANA_EXPORT Result<NodePermutation> ComputeNodeOrderByProperty(
+    const PropertyGraph& pg, const std::string& property);
+
+/// Make a copy of \p pg with its nodes relabeled by \p perm. Node and edge
+/// properties and types move with their nodes and edges, and the original
+/// id of each node is stored as by RelabelNodes(const PropertyGraph&,
+/// NodeOrder).
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> RelabelNodes(
+    const PropertyGraph& pg, const NodePermutation& perm);
+
+/// Make a copy of \p pg with its nodes relabeled into \p order. Node and
+/// edge properties and types move with their nodes and edges. The original
+/// id of each node is stored in the node property kOriginalNodeIdProperty,
+/// so that results computed on the copy can be mapped back with
+/// NodePermutation::FromOriginalIds, also after the copy is written and
+/// loaded again.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> RelabelNodes(
+    const PropertyGraph& pg, NodeOrder order);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SEGMENTEDTOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_SEGMENTEDTOPOLOGY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/RDGPrefix.h"
+
+namespace katana {
+
+/// The topology of an RDG in storage, read a segment of nodes at a time so
+/// that graphs with more edges than fit in memory can be processed, like
+/// OCFileGraph does for FileGraphs. The out indices, 8 bytes per node, stay
+/// in memory. The destinations of the edges of a segment are only resident
+/// between Load (or Prefetch) and Evict of the segment.
+///
+/// Only uncompressed topologies of unpartitioned RDGs can be segmented.
+class KATANA_EXPORT SegmentedTopology {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using edges_range = GraphTopology::edges_range;
+
+  /// The nodes [begin, end) and their edges [edge_begin, edge_end)
+  struct Segment {
+    Node begin;
+    Node end;
+    Edge edge_begin;
+    Edge edge_end;
+  };
+
+  static constexpr uint64_t kDefaultSegmentBytes = UINT64_C(1) << 30;
+
+  /// Open the topology of the RDG rdg_name, reading only its out indices.
+  ///
+  /// \param segment_bytes the most bytes of edge destinations in a segment;
+  ///     a node with more edges than that is a segment of its own
+  static Result<SegmentedTopology> Make(
+      const std::string& rdg_name,
+      uint64_t segment_bytes = kDefaultSegmentBytes);
+
+  uint64_t num_nodes() const { return prefix_.num_nodes(); }
+  uint64_t num_edges() const { return prefix_.num_edges(); }
+
+  const std::vector<Segment>& segments() const { return segments_; }
+
+  /// The index of the segment of node n
+  size_t segment_of(Node n) const;
+
+  edges_range edges(Node n) const {
+    Edge begin = n == 0 ? 0 : prefix_[n - 1];
+    return MakeStandardRange<GraphTopology::edge_iterator>(begin, prefix_[n]);
+  }
+
+  uint64_t degree(Node n) const { return edges(n).size(); }
+
+  /// The destination of edge e, which must be an edge of a loaded segment
+  Node edge_dest(Edge e) const { return out_dests_[e]; }
+
+  /// Read the edges of segment i into memory and wait for them
+  Result<void> Load(size_t i);
+
+  /// Start reading the edges of segment i in the background; Load waits
+  /// for them
+  Result<void> Prefetch(size_t i);
+
+  /// Release the memory of the edges of segment i
+  Result<void> Evict(size_t i);
+
+private:
+  SegmentedTopology(tsuba::RDGPrefix&& prefix, uint64_t segment_bytes);
+
+  tsuba::RDGPrefix prefix_;
+  const uint32_t* out_dests_;
+  std::vector<Segment> segments_;
+};
+
+/// Call fn(segment) for each segment of topology in order, with the edges of
+/// the segment loaded. The edges of the next segment are read in the
+/// background while fn runs, and those of each segment are evicted when fn
+/// returns, so at most two segments are in memory at once. fn may run
+/// parallel loops over the nodes of its segment.
+///
+/// \param wanted if not null, only the segments i for which wanted(i) is
+///     true are read, e.g., those with nodes in the frontier of a traversal.
+///     It is called for a segment before fn returns for the segments before
+///     it.
+template <typename F, typename W = std::nullptr_t>
+Result<void>
+ForEachSegment(SegmentedTopology* topology, F fn, W wanted = nullptr) {
+  size_t num_segments = topology->segments().size();
+  auto next_wanted = [&](size_t i) {
+    while (i < num_segments) {
+      if constexpr (std::is_same_v<W, std::nullptr_t>) {
+        return i;
+      } else if (wanted(i)) {
+        return i;
+      }
+      ++i;
+    }
+    return i;
+  };
+
+  size_t i = next_wanted(0);
+  if (i < num_segments) {
+    if (auto res = topology->Load(i); !res) {
+      return res.error();
+    }
+  }
+  while (i < num_segments) {
+    size_t next = next_wanted(i + 1);
+    if (next < num_segments) {
+      if (auto res = topology->Prefetch(next); !res) {
+        return res.error();
+      }
+    }
+    fn(topology->segments()[i]);
+    if (auto res = topology->Evict(i); !res) {
+      return res.error();
+    }
+    if (next < num_segments) {
+      if (auto res = topology->Load(next); !res) {
+        return res.error();
+      }
+    }
+    i = next;
+  }
+  return ResultSuccess();
+}
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,366 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SEMIRING_H_
+#define KATANA_LIBGALOIS_KATANA_SEMIRING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/EdgeBalancedRange.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "katana/TiledExecutor.h"
+
+namespace katana {
+
+/// A semiring over which SpMV and SpMM multiply: Add is associative and
+/// commutative with identity Zero(), which Multiply(a, x) maps to Zero() for
+/// either argument, and AtomicAdd(y, v) adds v to y in place atomically.
+///
+/// Semirings are types, so the products are specialized for them at compile
+/// time.
+template <typename T>
+struct PlusTimesSemiring {
+  using value_type = T;
+  static constexpr T Zero() { return T{0}; }
+  static T Add(T a, T b) { return a + b; }
+  static T Multiply(T a, T x) { return a * x; }
+  static void AtomicAdd(std::atomic<T>& y, T v) { atomicAdd(y, v); }
+};
+
+/// Tropical semiring, e.g., one relaxation of all edges for shortest paths
+template <typename T>
+struct MinPlusSemiring {
+  using value_type = T;
+  static constexpr T Zero() { return std::numeric_limits<T>::max(); }
+  static T Add(T a, T b) { return a < b ? a : b; }
+  static T Multiply(T a, T x) {
+    return a == Zero() || x == Zero() ? Zero() : a + x;
+  }
+  static void AtomicAdd(std::atomic<T>& y, T v) { atomicMin(y, v); }
+};
+
+/// E.g., the widest or most reliable paths, for values of at least 0
+template <typename T>
+struct MaxTimesSemiring {
+  using value_type = T;
+  static constexpr T Zero() { return T{0}; }
+  static T Add(T a, T b) { return a < b ? b : a; }
+  static T Multiply(T a, T x) { return a * x; }
+  static void AtomicAdd(std::atomic<T>& y, T v) { atomicMax(y, v); }
+};
+
+/// Boolean semiring, e.g., one step of a traversal for reachability
+struct OrAndSemiring {
+  using value_type = uint8_t;
+  static constexpr uint8_t Zero() { return 0; }
+  static uint8_t Add(uint8_t a, uint8_t b) { return a | b; }
+  static uint8_t Multiply(uint8_t a, uint8_t x) { return a & x; }
+  static void AtomicAdd(std::atomic<uint8_t>& y, uint8_t v) {
+    y.fetch_or(v, std::memory_order_relaxed);
+  }
+};
+
+/// The weights of an adjacency matrix: every edge is an entry of one
+template <typename T>
+struct UnitWeights {
+  T operator()(GraphTopology::Edge) const { return T{1}; }
+};
+
+/// How SpMV and SpMM visit the entries of the matrix
+enum class SpMVDirection {
+  /// Push if the matrix has columns and the nonzeros of x have few entries
+  /// in them, otherwise pull
+  kAuto,
+  /// Each row of y sums its entries, reading x at their columns: no atomics
+  /// and every entry is visited. Needs the rows of the matrix.
+  kPull,
+  /// Each nonzero of x adds to the rows of the entries of its column
+  /// atomically, so the work is that of the nonzeros of x alone. Needs the
+  /// columns of the matrix.
+  kPush,
+  /// Pull in tiles of rows and columns with Fixed2DGraphTiledExecutor, so
+  /// the part of x that a tile reads stays in cache, and no two threads
+  /// share the rows of y they write. Needs the rows of the matrix, with the
+  /// entries of each row sorted by column.
+  kTiled,
+};
+
+/// The most rows and columns of a tile of SpMVDirection::kTiled, if not given
+constexpr size_t kDefaultSpMVTileSize = 16384;
+
+/// The mask of an unmasked product: every row of y is computed
+struct NoMask {
+  bool operator()(GraphTopology::Node) const { return true; }
+};
+
+/// A square sparse matrix with an entry A(i, j) = weights(e) for each edge
+/// e from i to j of a topology, i.e., the weighted adjacency matrix of the
+/// graph. weights is called with the ids of edges of topology.
+///
+/// The rows of A are topology. Its columns, needed to push or to pull the
+/// transpose, are an in-edge index of topology, if given. Both must outlive
+/// the matrix.
+template <typename Weights>
+class SparseMatrix {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+
+  /// One orientation of the matrix: the entries of the i-th row (or column)
+  /// are topology->edges(i), and topology->edge_dest(e) the column (or row)
+  /// of entry e. edge_ids, if not null, map entries to edges of the matrix's
+  /// topology, for their weights.
+  struct Adjacency {
+    const GraphTopology* topology{};
+    const arrow::UInt64Array* edge_ids{};
+
+    Edge edge_id(Edge e) const { return edge_ids ? edge_ids->Value(e) : e; }
+  };
+
+  SparseMatrix(
+      const GraphTopology& topology, const InEdgeIndex* in_edges,
+      Weights weights = Weights())
+      : num_nodes_(topology.num_nodes()), weights_(std::move(weights)) {
+    rows_.topology = &topology;
+    if (in_edges) {
+      columns_.topology = &in_edges->topology;
+      columns_.edge_ids = in_edges->out_edge_ids.get();
+    }
+  }
+
+  /// \returns the transpose of this matrix, which shares its topologies
+  SparseMatrix Transpose() const {
+    SparseMatrix transposed = *this;
+    std::swap(transposed.rows_, transposed.columns_);
+    return transposed;
+  }
+
+  uint64_t size() const { return num_nodes_; }
+
+  bool has_rows() const { return rows_.topology != nullptr; }
+  bool has_columns() const { return columns_.topology != nullptr; }
+
+  const Adjacency& rows() const { return rows_; }
+  const Adjacency& columns() const { return columns_; }
+
+  /// \returns the value of entry e of adjacency, a rows() or columns()
+  auto value(const Adjacency& adjacency, Edge e) const {
+    return weights_(adjacency.edge_id(e));
+  }
+
+private:
+  uint64_t num_nodes_;
+  Weights weights_;
+  Adjacency rows_;
+  Adjacency columns_;
+};
+
+namespace internal {
+
+/// Push when the entries of the nonzeros of x are at most this fraction of
+/// all entries, as an atomic add costs several reads
+constexpr uint64_t kSpMVPushFactor = 8;
+
+template <typename T>
+std::atomic<T>&
+AsAtomic(T& value) {
+  static_assert(
+      sizeof(std::atomic<T>) == sizeof(T) &&
+      std::atomic<T>::is_always_lock_free);
+  return *reinterpret_cast<std::atomic<T>*>(&value);
+}
+
+/// Y = A X over semiring S for n x width row-major X and Y. A width K other
+/// than 0 is known at compile time, so the loops over a row of X unroll.
+template <typename S, uint32_t K, typename Weights, typename Mask>
+void
+SpMMImpl(
+    const SparseMatrix<Weights>& a, const typename S::value_type* x,
+    typename S::value_type* y, uint32_t width, const Mask& mask,
+    SpMVDirection direction, size_t tile_size) {
+  using T = typename S::value_type;
+  using Node = GraphTopology::Node;
+  const uint64_t k = K ? K : width;
+  const auto& rows = a.rows();
+  const auto& columns = a.columns();
+
+  auto is_zero = [&](Node j) {
+    for (uint32_t c = 0; c < k; ++c) {
+      if (x[j * k + c] != S::Zero()) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  if (direction == SpMVDirection::kAuto) {
+    direction = a.has_rows() ? SpMVDirection::kPull : SpMVDirection::kPush;
+    if (a.has_rows() && a.has_columns()) {
+      GAccumulator<uint64_t> push_entries;
+      do_all(
+          iterate(*columns.topology),
+          [&](Node j) {
+            if (!is_zero(j)) {
+              push_entries += columns.topology->edges(j).size();
+            }
+          },
+          no_stats(), loopname("SpMVPushEntries"));
+      if (push_entries.reduce() * kSpMVPushFactor <=
+          columns.topology->num_edges()) {
+        direction = SpMVDirection::kPush;
+      }
+    }
+  }
+
+  KATANA_LOG_VASSERT(
+      direction == SpMVDirection::kPush ? a.has_columns() : a.has_rows(),
+      "the matrix has no {} for this direction",
+      direction == SpMVDirection::kPush ? "columns" : "rows");
+
+  if (direction == SpMVDirection::kPull) {
+    do_all(
+        iterate_edge_balanced(*rows.topology),
+        [&](Node i) {
+          if (!mask(i)) {
+            return;
+          }
+          T sum[K ? K : 1];
+          T* out = K ? sum : &y[i * k];
+          for (uint32_t c = 0; c < k; ++c) {
+            out[c] = S::Zero();
+          }
+          for (auto e : rows.topology->edges(i)) {
+            auto value = a.value(rows, e);
+            const T* in = &x[rows.topology->edge_dest(e) * k];
+            for (uint32_t c = 0; c < k; ++c) {
+              out[c] = S::Add(out[c], S::Multiply(value, in[c]));
+            }
+          }
+          if (K) {
+            for (uint32_t c = 0; c < k; ++c) {
+              y[i * k + c] = out[c];
+            }
+          }
+        },
+        steal(), no_stats(), loopname("SpMVPull"));
+    return;
+  }
+
+  do_all(
+      iterate(uint64_t{0}, a.size()),
+      [&](Node i) {
+        if (mask(i)) {
+          for (uint32_t c = 0; c < k; ++c) {
+            y[i * k + c] = S::Zero();
+          }
+        }
+      },
+      no_stats(), loopname("SpMVZero"));
+
+  if (direction == SpMVDirection::kPush) {
+    do_all(
+        iterate_edge_balanced(*columns.topology),
+        [&](Node j) {
+          if (is_zero(j)) {
+            return;
+          }
+          for (auto e : columns.topology->edges(j)) {
+            Node i = columns.topology->edge_dest(e);
+            if (!mask(i)) {
+              continue;
+            }
+            auto value = a.value(columns, e);
+            for (uint32_t c = 0; c < k; ++c) {
+              T product = S::Multiply(value, x[j * k + c]);
+              if (product != S::Zero()) {
+                S::AtomicAdd(AsAtomic(y[i * k + c]), product);
+              }
+            }
+          }
+        },
+        steal(), no_stats(), loopname("SpMVPush"));
+    return;
+  }
+
+  if (a.size() == 0) {
+    return;
+  }
+  // The executor locks the rows and the columns of a tile, so the rows of y
+  // are written by one thread at a time
+  TiledGraphTopology tiled{*rows.topology};
+  Fixed2DGraphTiledExecutor<TiledGraphTopology> executor(tiled);
+  executor.execute(
+      tiled.begin(), tiled.end(), tiled.begin(), tiled.end(), tile_size,
+      tile_size,
+      [&](Node i, Node j, TiledGraphTopology::edge_iterator e) {
+        if (!mask(i)) {
+          return;
+        }
+        auto value = a.value(rows, *e);
+        for (uint32_t c = 0; c < k; ++c) {
+          y[i * k + c] =
+              S::Add(y[i * k + c], S::Multiply(value, x[j * k + c]));
+        }
+      },
+      true);
+}
+
+}  // namespace internal
+
+/// y = A x over semiring S: y[i] is the S::Add of S::Multiply(A(i, j), x[j])
+/// over the entries of row i. For the transpose, e.g., to sum the values of
+/// the in-neighbors of each node, multiply by a.Transpose().
+///
+///     katana::SparseMatrix a(
+///         topology, in_edges.get(), katana::UnitWeights<float>());
+///     katana::SpMV<katana::PlusTimesSemiring<float>>(a.Transpose(), x, y);
+///
+/// x and y must not overlap.
+///
+/// \param mask a callable mask(i) of the rows of y to compute; the other
+///     rows are left as they are
+/// \param tile_size the rows and columns of a tile of SpMVDirection::kTiled
+template <typename S, typename Weights, typename Mask = NoMask>
+void
+SpMV(
+    const SparseMatrix<Weights>& a, const typename S::value_type* x,
+    typename S::value_type* y, SpMVDirection direction = SpMVDirection::kAuto,
+    const Mask& mask = Mask(), size_t tile_size = kDefaultSpMVTileSize) {
+  internal::SpMMImpl<S, 1>(a, x, y, 1, mask, direction, tile_size);
+}
+
+/// Y = A X over semiring S, for X and Y of width columns stored row-major:
+/// the values of row i are X[i * width] to X[i * width + width - 1]. One
+/// pass over the entries of A computes all the columns, as several SpMV
+/// would not. See SpMV for the other arguments; in SpMVDirection::kPush, a
+/// row of X is a nonzero if any of its values is.
+template <typename S, typename Weights, typename Mask = NoMask>
+void
+SpMM(
+    const SparseMatrix<Weights>& a, const typename S::value_type* x,
+    typename S::value_type* y, uint32_t width,
+    SpMVDirection direction = SpMVDirection::kAuto, const Mask& mask = Mask(),
+    size_t tile_size = kDefaultSpMVTileSize) {
+  switch (width) {
+  case 1:
+    return internal::SpMMImpl<S, 1>(a, x, y, 1, mask, direction, tile_size);
+  case 2:
+    return internal::SpMMImpl<S, 2>(a, x, y, 2, mask, direction, tile_size);
+  case 4:
+    return internal::SpMMImpl<S, 4>(a, x, y, 4, mask, direction, tile_size);
+  case 8:
+    return internal::SpMMImpl<S, 8>(a, x, y, 8, mask, direction, tile_size);
+  default:
+    return internal::SpMMImpl<S, 0>(
+        a, x, y, width, mask, direction, tile_size);
+  }
+}
+
+}  // namespace katana
+
+#endif
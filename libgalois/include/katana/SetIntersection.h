@@ -0,0 +1,127 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SETINTERSECTION_H_
+#define KATANA_LIBGALOIS_KATANA_SETINTERSECTION_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Kernels for intersecting sorted lists of node ids. Callers should use
+/// CountSortedIntersection, which picks one per call; the kernels are
+/// exposed individually for testing and benchmarking.
+enum class IntersectionKernel {
+  /// Branchy merge of both lists
+  kScalar,
+  /// Exponential search of each element of the shorter list in the longer
+  kGalloping,
+  /// All-pairs comparison of blocks of 8 elements (AVX2)
+  kAVX2,
+  /// All-pairs comparison of blocks of 16 elements (AVX-512F)
+  kAVX512,
+};
+
+/// Return true if the kernel can run on this machine.
+KATANA_EXPORT bool IsIntersectionKernelSupported(IntersectionKernel kernel);
+
+/// Return the number of values in both [a, a + a_size) and [b, b + b_size).
+/// Both lists must be strictly increasing.
+///
+/// Lists of very different lengths use galloping search; otherwise the
+/// widest block kernel supported by the CPU is used, chosen once at run time.
+KATANA_EXPORT size_t CountSortedIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size);
+
+/// CountSortedIntersection with a specific kernel. The kernel must be
+/// supported.
+KATANA_EXPORT size_t CountSortedIntersection(
+    IntersectionKernel kernel, const uint32_t* a, size_t a_size,
+    const uint32_t* b, size_t b_size);
+
+namespace internal {
+
+/// Length ratio above which galloping beats a linear merge
+constexpr size_t kIntersectionGallopRatio = 32;
+
+template <typename F>
+void
+ForEachGallopingIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    F fn) {
+  bool a_is_small = a_size < b_size;
+  const uint32_t* small = a_is_small ? a : b;
+  const uint32_t* large = a_is_small ? b : a;
+  size_t small_size = a_is_small ? a_size : b_size;
+  size_t large_size = a_is_small ? b_size : a_size;
+
+  size_t pos = 0;
+  for (size_t i = 0; i < small_size && pos < large_size; ++i) {
+    uint32_t v = small[i];
+    // Exponential search for the first element >= v
+    size_t step = 1;
+    size_t hi = pos;
+    while (hi < large_size && large[hi] < v) {
+      pos = hi + 1;
+      hi += step;
+      step *= 2;
+    }
+    if (hi > large_size) {
+      hi = large_size;
+    }
+    while (pos < hi) {
+      size_t mid = pos + (hi - pos) / 2;
+      if (large[mid] < v) {
+        pos = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    if (pos < large_size && large[pos] == v) {
+      bool more = a_is_small ? fn(i, pos) : fn(pos, i);
+      if (!more) {
+        return;
+      }
+      ++pos;
+    }
+  }
+}
+
+}  // namespace internal
+
+/// Call fn(i, j) for every pair of positions with a[i] == b[j], in
+/// increasing order, until fn returns false. Both lists must be strictly
+/// increasing. Lists of very different lengths use galloping search. Use
+/// this rather than CountSortedIntersection when matches need further
+/// filtering.
+template <typename F>
+void
+ForEachSortedIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    F fn) {
+  constexpr size_t kRatio = internal::kIntersectionGallopRatio;
+  if (a_size * kRatio < b_size || b_size * kRatio < a_size) {
+    internal::ForEachGallopingIntersection(a, a_size, b, b_size, fn);
+    return;
+  }
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a_size && j < b_size) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      if (!fn(i, j)) {
+        return;
+      }
+      ++i;
+      ++j;
+    }
+  }
+}
+
+}  // namespace katana
+
+#endif
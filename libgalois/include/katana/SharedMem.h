@@ -26,10 +26,24 @@
 
 namespace katana {
 
+namespace internal {
+
+/// Make the thread pool and the state that depends on it of the current
+/// SharedMem, unless it is made already. The getters of that state call this
+/// when it is missing.
+KATANA_EXPORT void StartSharedMem();
+
+}  // namespace internal
+
 /// A SharedMem represents global initialization required for the shared
 /// memory subsystem, i.e., thread pools and barriers. As a side-effect of
 /// construction, this class sets global internal state.
 ///
+/// The thread pool and barriers are made on first use, e.g., by the first
+/// parallel loop or per-thread data structure, so that programs that never
+/// run in parallel do not wait for threads to start and the machine topology
+/// to be probed. The thread that makes them becomes thread 0 of the pool.
+///
 /// Data structures that require per-thread allocation typically ask for the
 /// thread pool. If their construction is not guaranteed to happen after the
 /// construction of a SharedMem, initialization races can occur.
@@ -37,6 +51,9 @@ class KATANA_EXPORT SharedMem {
   struct Impl;
   std::unique_ptr<Impl> impl_;
 
+  void Start();
+  friend void internal::StartSharedMem();
+
 public:
   SharedMem();
   ~SharedMem();
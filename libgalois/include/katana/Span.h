@@ -0,0 +1,73 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SPAN_H_
+#define KATANA_LIBGALOIS_KATANA_SPAN_H_
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace katana {
+
+/// The extent of a Span whose size is only known at runtime
+inline constexpr size_t kDynamicExtent = std::numeric_limits<size_t>::max();
+
+namespace internal {
+
+template <size_t Extent>
+class SpanExtent {
+public:
+  constexpr explicit SpanExtent(size_t) {}
+  constexpr size_t size() const { return Extent; }
+};
+
+template <>
+class SpanExtent<kDynamicExtent> {
+public:
+  constexpr explicit SpanExtent(size_t size) : size_(size) {}
+  constexpr size_t size() const { return size_; }
+
+private:
+  size_t size_;
+};
+
+}  // namespace internal
+
+/// A Span is a pointer to size() contiguous values of T that it does not own,
+/// like std::span of C++20. With an Extent known at compile time, a Span is
+/// just the pointer and loops over it have a constant trip count, which the
+/// compiler can unroll and vectorize without a remainder loop.
+template <typename T, size_t Extent = kDynamicExtent>
+class Span : private internal::SpanExtent<Extent> {
+  using Base = internal::SpanExtent<Extent>;
+
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using iterator = T*;
+
+  static constexpr size_t extent = Extent;
+
+  constexpr Span(T* data, size_t size) : Base(size), data_(data) {}
+
+  /// A Span of non-const values converts to a Span of const values
+  template <
+      typename U,
+      typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+  constexpr Span(const Span<U, Extent>& other)
+      : Base(other.size()), data_(other.data()) {}
+
+  constexpr T* data() const { return data_; }
+  constexpr size_t size() const { return Base::size(); }
+  constexpr bool empty() const { return size() == 0; }
+
+  constexpr T& operator[](size_t i) const { return data_[i]; }
+
+  constexpr iterator begin() const { return data_; }
+  constexpr iterator end() const { return data_ + size(); }
+
+private:
+  T* data_;
+};
+
+}  // namespace katana
+
+#endif
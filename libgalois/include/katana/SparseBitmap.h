@@ -0,0 +1,126 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SPARSEBITMAP_H_
+#define KATANA_LIBGALOIS_KATANA_SPARSEBITMAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Kernels for the block operations of SparseBitmap. Callers should use the
+/// SparseBitmap methods without a kernel argument, which use the widest
+/// kernel supported by the CPU, chosen once at run time; the kernels are
+/// exposed individually for testing and benchmarking.
+enum class SparseBitmapKernel {
+  /// One 64-bit word at a time
+  kScalar,
+  /// Half a block at a time (AVX2)
+  kAVX2,
+  /// A whole block at a time (AVX-512F)
+  kAVX512,
+};
+
+/// Return true if the kernel can run on this machine.
+KATANA_EXPORT bool IsSparseBitmapKernelSupported(SparseBitmapKernel kernel);
+
+/// A set of uint32_t values, stored as a sorted array of 512-bit blocks that
+/// each cover an aligned range of values. Blocks with no values are not
+/// stored, so sparse sets stay small, while each block is one cache line that
+/// unions and differences combine with a few SIMD instructions. Unlike a
+/// linked list of elements, the blocks of a set are contiguous in memory.
+///
+/// SparseBitmap is not thread-safe.
+class KATANA_EXPORT SparseBitmap {
+public:
+  static constexpr uint32_t kBlockBits = 512;
+  static constexpr uint32_t kBlockWords = kBlockBits / 64;
+
+  struct alignas(64) Block {
+    uint64_t words[kBlockWords];
+  };
+
+  bool empty() const { return keys_.empty(); }
+
+  /// The number of values in the set
+  size_t size() const;
+
+  size_t num_blocks() const { return keys_.size(); }
+
+  bool test(uint32_t value) const {
+    uint32_t key = value / kBlockBits;
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    if (it == keys_.end() || *it != key) {
+      return false;
+    }
+    uint32_t bit = value % kBlockBits;
+    return (blocks_[it - keys_.begin()].words[bit / 64] >> (bit % 64)) & 1;
+  }
+
+  /// Add value to the set. Return true if it was not already there.
+  bool set(uint32_t value);
+
+  void clear() {
+    keys_.clear();
+    blocks_.clear();
+  }
+
+  void swap(SparseBitmap& other) {
+    keys_.swap(other.keys_);
+    blocks_.swap(other.blocks_);
+  }
+
+  /// Add the values of other to this set. Return true if any were new. If
+  /// added is not null, it is set to the new values, that is, to other minus
+  /// this set before the call. added may not be this set or other.
+  bool UnionWith(const SparseBitmap& other, SparseBitmap* added = nullptr);
+
+  /// UnionWith with a specific kernel. The kernel must be supported.
+  bool UnionWith(
+      SparseBitmapKernel kernel, const SparseBitmap& other,
+      SparseBitmap* added = nullptr);
+
+  /// Set this set to the values of a that are not in b. Neither may be this
+  /// set.
+  void AssignDifference(const SparseBitmap& a, const SparseBitmap& b);
+
+  /// AssignDifference with a specific kernel. The kernel must be supported.
+  void AssignDifference(
+      SparseBitmapKernel kernel, const SparseBitmap& a, const SparseBitmap& b);
+
+  /// Return true if every value of this set is in other.
+  bool IsSubsetOf(const SparseBitmap& other) const;
+
+  bool operator==(const SparseBitmap& other) const;
+  bool operator!=(const SparseBitmap& other) const { return !(*this == other); }
+
+  /// Call fn(value) for every value of the set in increasing order
+  template <typename F>
+  void ForEach(F fn) const {
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      uint32_t base = keys_[i] * kBlockBits;
+      for (uint32_t w = 0; w < kBlockWords; ++w) {
+        for (uint64_t word = blocks_[i].words[w]; word; word &= word - 1) {
+          fn(base + w * 64 + __builtin_ctzll(word));
+        }
+      }
+    }
+  }
+
+  /// The values of the set in increasing order
+  std::vector<uint32_t> ToVector() const;
+
+private:
+  struct Kernels;
+
+  /// Block index of each stored block, strictly increasing
+  std::vector<uint32_t> keys_;
+  /// Bits of each stored block; none are all zero
+  std::vector<Block> blocks_;
+};
+
+}  // namespace katana
+
+#endif
@@ -20,6 +20,16 @@
 #ifndef KATANA_LIBGALOIS_KATANA_SPATIALTREE_H_
 #define KATANA_LIBGALOIS_KATANA_SPATIALTREE_H_
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -187,6 +197,383 @@ public:
   }
 };
 
+//! Static index of points in 2 or 3 dimensions, bulk loaded in parallel and
+//! queried in parallel batches, e.g., to find the k nearest neighbors of
+//! every point of a point cloud and build a k-NN graph from them.
+//!
+//! bulkLoad sorts the points by their Morton code, which keeps points that
+//! are close in space close in the order, cuts the order into leaves of
+//! kLeafSize points, and builds a complete binary tree of bounding boxes
+//! over the leaves. Points are identified by their position in the input of
+//! bulkLoad. Queries are exact and may run concurrently with each other.
+template <size_t Dim>
+class SpatialTree {
+  static_assert(Dim == 2 || Dim == 3, "SpatialTree is 2 or 3 dimensional");
+
+public:
+  using Point = std::array<double, Dim>;
+
+  //! Axis-aligned box, closed on all sides
+  struct Box {
+    Point lo;
+    Point hi;
+
+    //! The box that contains no point
+    static Box emptyBox() {
+      Box b;
+      b.lo.fill(std::numeric_limits<double>::infinity());
+      b.hi.fill(-std::numeric_limits<double>::infinity());
+      return b;
+    }
+
+    bool isEmpty() const { return lo[0] > hi[0]; }
+
+    void extend(const Point& p) {
+      for (size_t d = 0; d < Dim; ++d) {
+        lo[d] = std::min(lo[d], p[d]);
+        hi[d] = std::max(hi[d], p[d]);
+      }
+    }
+
+    void extend(const Box& b) {
+      for (size_t d = 0; d < Dim; ++d) {
+        lo[d] = std::min(lo[d], b.lo[d]);
+        hi[d] = std::max(hi[d], b.hi[d]);
+      }
+    }
+
+    bool contains(const Point& p) const {
+      for (size_t d = 0; d < Dim; ++d) {
+        if (p[d] < lo[d] || p[d] > hi[d]) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool overlaps(const Box& b) const {
+      for (size_t d = 0; d < Dim; ++d) {
+        if (b.hi[d] < lo[d] || b.lo[d] > hi[d]) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    //! Squared distance from p to the nearest point of the box; infinite
+    //! for the empty box
+    double distance2(const Point& p) const {
+      double sum = 0;
+      for (size_t d = 0; d < Dim; ++d) {
+        double gap = std::max({lo[d] - p[d], 0.0, p[d] - hi[d]});
+        sum += gap * gap;
+      }
+      return sum;
+    }
+  };
+
+  //! Pads the results of nearest neighbor queries with fewer than k points
+  static constexpr uint64_t kNoPoint = std::numeric_limits<uint64_t>::max();
+  //! Points per leaf of the tree
+  static constexpr size_t kLeafSize = 16;
+
+  static double distance2(const Point& a, const Point& b) {
+    double sum = 0;
+    for (size_t d = 0; d < Dim; ++d) {
+      sum += (a[d] - b[d]) * (a[d] - b[d]);
+    }
+    return sum;
+  }
+
+  //! Index points, replacing any points indexed before. Parallel.
+  void bulkLoad(const std::vector<Point>& points) {
+    size_t size = points.size();
+
+    std::vector<Box> threadBounds(katana::getActiveThreads(), Box::emptyBox());
+    katana::on_each([&](unsigned tid, unsigned total) {
+      auto [begin, end] = katana::block_range(size_t{0}, size, tid, total);
+      for (size_t i = begin; i != end; ++i) {
+        threadBounds[tid].extend(points[i]);
+      }
+    });
+    bounds_ = Box::emptyBox();
+    for (const Box& b : threadBounds) {
+      bounds_.extend(b);
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> order(size);
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) { order[i] = {mortonCode(points[i]), i}; },
+        katana::no_stats());
+    katana::ParallelSTL::radix_sort(
+        order.begin(), order.end(), [](const auto& p) { return p.first; });
+
+    points_.resize(size);
+    ids_.resize(size);
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) {
+          ids_[i] = order[i].second;
+          points_[i] = points[ids_[i]];
+        },
+        katana::no_stats());
+
+    // Leaf l is node numLeafSlots_ + l; the children of node i are 2i and
+    // 2i + 1, and the root is node 1
+    size_t numLeaves = (size + kLeafSize - 1) / kLeafSize;
+    numLeafSlots_ = 1;
+    while (numLeafSlots_ < numLeaves) {
+      numLeafSlots_ *= 2;
+    }
+    boxes_.assign(2 * numLeafSlots_, Box::emptyBox());
+    katana::do_all(
+        katana::iterate(size_t{0}, numLeaves),
+        [&](size_t leaf) {
+          Box& b = boxes_[numLeafSlots_ + leaf];
+          for (size_t i = leaf * kLeafSize, e = leafEnd(leaf); i != e; ++i) {
+            b.extend(points_[i]);
+          }
+        },
+        katana::no_stats());
+    for (size_t level = numLeafSlots_ / 2; level >= 1; level /= 2) {
+      katana::do_all(
+          katana::iterate(level, 2 * level),
+          [&](size_t node) {
+            boxes_[node] = boxes_[2 * node];
+            boxes_[node].extend(boxes_[2 * node + 1]);
+          },
+          katana::no_stats());
+    }
+  }
+
+  //! Number of points indexed
+  size_t size() const { return points_.size(); }
+
+  //! Bounding box of the points indexed
+  const Box& bounds() const { return bounds_; }
+
+  //! \returns the ids of the k points nearest to q, nearest first and ties
+  //! broken by smaller id; fewer if there are fewer points
+  std::vector<uint64_t> nearest(const Point& q, size_t k) const {
+    std::vector<Candidate> best;
+    searchNearest(q, k, kNoPoint, &best);
+    std::vector<uint64_t> ids;
+    for (const Candidate& c : best) {
+      ids.emplace_back(c.second);
+    }
+    return ids;
+  }
+
+  //! Finds the k nearest points to each query in parallel.
+  //!
+  //! \returns the ids of the neighbors of query i, as by nearest(), at
+  //!     k * i .. k * i + k - 1, padded with kNoPoint
+  std::vector<uint64_t> batchNearest(
+      const std::vector<Point>& queries, size_t k) const {
+    std::vector<uint64_t> neighbors(queries.size() * k, kNoPoint);
+    katana::PerThreadStorage<std::vector<Candidate>> scratch;
+    katana::do_all(
+        katana::iterate(size_t{0}, queries.size()),
+        [&](size_t i) {
+          std::vector<Candidate>& best = *scratch.getLocal();
+          searchNearest(queries[i], k, kNoPoint, &best);
+          for (size_t j = 0; j < best.size(); ++j) {
+            neighbors[k * i + j] = best[j].second;
+          }
+        },
+        katana::steal(), katana::no_stats());
+    return neighbors;
+  }
+
+  //! Finds, in parallel, the k nearest other points to every point
+  //! indexed, i.e., the edges of the k-NN graph of the points.
+  //!
+  //! \returns the ids of the neighbors of point i at k * i .. k * i + k - 1,
+  //!     nearest first, padded with kNoPoint
+  std::vector<uint64_t> allNearest(size_t k) const {
+    std::vector<uint64_t> neighbors(size() * k, kNoPoint);
+    katana::PerThreadStorage<std::vector<Candidate>> scratch;
+    // In index order, so that consecutive queries visit the same leaves
+    katana::do_all(
+        katana::iterate(size_t{0}, size()),
+        [&](size_t i) {
+          std::vector<Candidate>& best = *scratch.getLocal();
+          uint64_t id = ids_[i];
+          searchNearest(points_[i], k, id, &best);
+          for (size_t j = 0; j < best.size(); ++j) {
+            neighbors[k * id + j] = best[j].second;
+          }
+        },
+        katana::steal(), katana::no_stats());
+    return neighbors;
+  }
+
+  //! \returns the ids of the points in box, in no particular order
+  std::vector<uint64_t> inRange(const Box& box) const {
+    std::vector<uint64_t> ids;
+    searchRange(
+        [&](const Box& b) { return b.overlaps(box); },
+        [&](const Point& p) { return box.contains(p); }, &ids);
+    return ids;
+  }
+
+  //! \returns the ids of the points at distance at most radius from
+  //!     center, in no particular order
+  std::vector<uint64_t> inRadius(const Point& center, double radius) const {
+    std::vector<uint64_t> ids;
+    double radius2 = radius * radius;
+    searchRange(
+        [&](const Box& b) { return b.distance2(center) <= radius2; },
+        [&](const Point& p) { return distance2(center, p) <= radius2; },
+        &ids);
+    return ids;
+  }
+
+  //! inRange for each box, in parallel
+  std::vector<std::vector<uint64_t>> batchInRange(
+      const std::vector<Box>& boxes) const {
+    std::vector<std::vector<uint64_t>> ids(boxes.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, boxes.size()),
+        [&](size_t i) { ids[i] = inRange(boxes[i]); }, katana::steal(),
+        katana::no_stats());
+    return ids;
+  }
+
+  //! inRadius for each center, in parallel
+  std::vector<std::vector<uint64_t>> batchInRadius(
+      const std::vector<Point>& centers, double radius) const {
+    std::vector<std::vector<uint64_t>> ids(centers.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, centers.size()),
+        [&](size_t i) { ids[i] = inRadius(centers[i], radius); },
+        katana::steal(), katana::no_stats());
+    return ids;
+  }
+
+private:
+  //! (squared distance, id), ordered so that the worst candidate is largest
+  using Candidate = std::pair<double, uint64_t>;
+
+  //! Enough for the depth-first traversal of a tree of 2^64 leaves
+  static constexpr size_t kMaxStack = 2 * 64;
+
+  size_t leafEnd(size_t leaf) const {
+    return std::min((leaf + 1) * kLeafSize, points_.size());
+  }
+
+  //! Interleaves the bits of the coordinates of p, relative to bounds_,
+  //! quantized to 64 / Dim bits each
+  uint64_t mortonCode(const Point& p) const {
+    constexpr unsigned kBits = 64 / Dim;
+    constexpr double kMaxCell = double((uint64_t{1} << kBits) - 1);
+    uint64_t code = 0;
+    for (size_t d = 0; d < Dim; ++d) {
+      double extent = bounds_.hi[d] - bounds_.lo[d];
+      double fraction = extent > 0 ? (p[d] - bounds_.lo[d]) / extent : 0;
+      auto cell = static_cast<uint64_t>(fraction * kMaxCell);
+      for (unsigned b = 0; b < kBits; ++b) {
+        code |= ((cell >> b) & 1) << (b * Dim + d);
+      }
+    }
+    return code;
+  }
+
+  //! Fills *best with the k nearest points to q other than exclude, sorted
+  void searchNearest(
+      const Point& q, size_t k, uint64_t exclude,
+      std::vector<Candidate>* best) const {
+    best->clear();
+    if (k == 0 || points_.empty()) {
+      return;
+    }
+    auto bound = [&]() {
+      return best->size() < k ? std::numeric_limits<double>::infinity()
+                              : best->front().first;
+    };
+
+    // Depth first, nearer child first; *best is a max-heap
+    std::array<size_t, kMaxStack> stack;
+    size_t top = 0;
+    stack[top++] = 1;
+    while (top > 0) {
+      size_t node = stack[--top];
+      // Keep boxes at the bound, which may hold ties with smaller ids
+      const Box& box = boxes_[node];
+      if (box.isEmpty() || box.distance2(q) > bound()) {
+        continue;
+      }
+      if (node < numLeafSlots_) {
+        size_t nearChild = 2 * node;
+        size_t farChild = 2 * node + 1;
+        if (boxes_[farChild].distance2(q) < boxes_[nearChild].distance2(q)) {
+          std::swap(nearChild, farChild);
+        }
+        stack[top++] = farChild;
+        stack[top++] = nearChild;
+        continue;
+      }
+      size_t leaf = node - numLeafSlots_;
+      for (size_t i = leaf * kLeafSize, e = leafEnd(leaf); i < e; ++i) {
+        if (ids_[i] == exclude) {
+          continue;
+        }
+        Candidate c{distance2(q, points_[i]), ids_[i]};
+        if (best->size() < k) {
+          best->emplace_back(c);
+          std::push_heap(best->begin(), best->end());
+        } else if (c < best->front()) {
+          std::pop_heap(best->begin(), best->end());
+          best->back() = c;
+          std::push_heap(best->begin(), best->end());
+        }
+      }
+    }
+    std::sort_heap(best->begin(), best->end());
+  }
+
+  //! Appends to *ids the ids of the points p for which inPoint(p), visiting
+  //! the nodes whose boxes b pass visit(b)
+  template <typename VisitFn, typename InPointFn>
+  void searchRange(
+      const VisitFn& visit, const InPointFn& inPoint,
+      std::vector<uint64_t>* ids) const {
+    if (points_.empty()) {
+      return;
+    }
+    std::array<size_t, kMaxStack> stack;
+    size_t top = 0;
+    stack[top++] = 1;
+    while (top > 0) {
+      size_t node = stack[--top];
+      if (!visit(boxes_[node])) {
+        continue;
+      }
+      if (node < numLeafSlots_) {
+        stack[top++] = 2 * node;
+        stack[top++] = 2 * node + 1;
+        continue;
+      }
+      size_t leaf = node - numLeafSlots_;
+      for (size_t i = leaf * kLeafSize, e = leafEnd(leaf); i < e; ++i) {
+        if (inPoint(points_[i])) {
+          ids->emplace_back(ids_[i]);
+        }
+      }
+    }
+  }
+
+  //! The points sorted by Morton code
+  std::vector<Point> points_;
+  //! The id of each point of points_
+  std::vector<uint64_t> ids_;
+  //! The bounding boxes of the nodes of the tree; node 0 is unused
+  std::vector<Box> boxes_;
+  size_t numLeafSlots_{0};
+  Box bounds_{Box::emptyBox()};
+};
+
 }  // namespace katana
 
 #endif
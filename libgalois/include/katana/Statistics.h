@@ -23,7 +23,10 @@
 #include <limits>
 #include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "katana/LowLatency.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
 #include "katana/gstl.h"
@@ -313,6 +316,15 @@ protected:
   /// ReadParam and ReadFP and print their own results here.
   virtual void PrintStats(std::ostream& out);
 
+  /// PrintJSON prints statistics and the intervals timed by StatTimers to a
+  /// stream as a JSON object in the Chrome trace event format, which
+  /// chrome://tracing and Perfetto load. Statistics are under the "stats"
+  /// key as region -> category -> {kind, total_type, total, thread_values}.
+  ///
+  /// Print calls this instead of PrintStats when the KATANA_STAT_FORMAT
+  /// environment variable is "json".
+  void PrintJSON(std::ostream& out);
+
   void MergeStats();
 
   bool IsPrintingThreadVals() const;
@@ -359,6 +371,23 @@ public:
   void AddParam(
       const std::string& region, const std::string& category, const Str& val);
 
+  /// Record that timer \param category of \param region stopped after
+  /// running for \param usec microseconds. Only recorded when IsTracing.
+  void AddTraceEvent(const Str& region, const Str& category, uint64_t usec);
+
+  /// Record the values of the counter \param name at \param time_usec as
+  /// series name -> value. Only recorded when IsTracing.
+  void AddCounterEvent(
+      const std::string& name, uint64_t time_usec,
+      const std::vector<std::pair<std::string, int64_t>>& values);
+
+  /// \returns true if timed intervals are recorded for a trace
+  bool IsTracing() const;
+
+  /// \returns the microseconds since this was constructed, the clock of
+  /// trace events
+  uint64_t TraceTime() const;
+
   void Print();
 };
 
@@ -382,6 +411,9 @@ ReportStat(
     const std::string& region, const std::string& category, const T& value,
     const StatTotal::Type& type,
     std::enable_if_t<std::is_integral_v<T>>* = nullptr) {
+  if (internal::StatsDisabled()) {
+    return;
+  }
   internal::sysStatManager()->AddInt(region, category, int64_t(value), type);
 }
 
@@ -391,6 +423,9 @@ ReportStat(
     const std::string& region, const std::string& category, const T& value,
     const StatTotal::Type& type,
     std::enable_if_t<std::is_floating_point_v<T>>* = nullptr) {
+  if (internal::StatsDisabled()) {
+    return;
+  }
   internal::sysStatManager()->AddFP(region, category, double(value), type);
 }
 
@@ -437,6 +472,12 @@ KATANA_EXPORT void reportRUsage(const std::string& id);
 //! Reports Galois system memory stats for all threads
 KATANA_EXPORT void reportPageAlloc(const char* category);
 
+/// Reports, for each kind of tsuba I/O done so far, its count, errors,
+/// bytes, total, maximum and percentile latencies and throughput as stats of
+/// region, e.g., "GetP99Usec". The I/O of the whole program is reported as
+/// region "tsuba" when statistics are printed.
+KATANA_EXPORT void ReportIOStats(const std::string& region);
+
 /// Prints statistics out to standard out or to the file indicated by
 /// SetStatFile
 KATANA_EXPORT void PrintStats();
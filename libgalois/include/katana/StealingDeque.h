@@ -0,0 +1,263 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef KATANA_LIBGALOIS_KATANA_STEALINGDEQUE_H_
+#define KATANA_LIBGALOIS_KATANA_STEALINGDEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/PerThreadChunk.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * Lock-free work-stealing deque of pointers (Chase and Lev, "Dynamic
+ * Circular Work-Stealing Deque", SPAA 2005, using the C11 memory orderings
+ * from Le et al., PPoPP 2013).
+ *
+ * Only the owning thread may call push() and pop(), which operate on the
+ * bottom of the deque. Any thread may call steal(), which takes from the top.
+ * Storage grows on demand; retired buffers are kept until the deque is
+ * destroyed because a concurrent thief may still be reading them.
+ */
+template <typename T>
+class ChaseLevDeque : private boost::noncopyable {
+  static_assert(std::is_pointer<T>::value, "ChaseLevDeque holds pointers");
+
+  struct Buffer {
+    int64_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+
+    explicit Buffer(int64_t size)
+        : mask(size - 1), slots(new std::atomic<T>[size]) {}
+
+    int64_t size() const { return mask + 1; }
+    T get(int64_t i) const {
+      return slots[i & mask].load(std::memory_order_relaxed);
+    }
+    void put(int64_t i, T v) {
+      slots[i & mask].store(v, std::memory_order_relaxed);
+    }
+  };
+
+  static constexpr int64_t kInitialSize = 64;
+
+  alignas(64) std::atomic<int64_t> top_{0};
+  alignas(64) std::atomic<int64_t> bottom_{0};
+  std::atomic<Buffer*> buffer_;
+  //! Owner-only list of every buffer ever allocated
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+
+  KATANA_ATTRIBUTE_NOINLINE
+  Buffer* Grow(Buffer* old, int64_t top, int64_t bottom) {
+    buffers_.emplace_back(std::make_unique<Buffer>(old->size() * 2));
+    Buffer* next = buffers_.back().get();
+    for (int64_t i = top; i < bottom; ++i) {
+      next->put(i, old->get(i));
+    }
+    buffer_.store(next, std::memory_order_release);
+    return next;
+  }
+
+public:
+  ChaseLevDeque() {
+    buffers_.emplace_back(std::make_unique<Buffer>(kInitialSize));
+    buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+  }
+
+  //! Approximate emptiness check; safe to call from any thread
+  bool empty() const {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    return b <= t;
+  }
+
+  //! Owner only
+  void push(T v) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Buffer* a = buffer_.load(std::memory_order_relaxed);
+    if (b - t > a->size() - 1) {
+      a = Grow(a, t, b);
+    }
+    a->put(b, v);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  //! Owner only; returns nullptr when empty
+  T pop() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Buffer* a = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    T v = a->get(b);
+    if (t == b) {
+      // Last element: race against thieves for it
+      if (!top_.compare_exchange_strong(
+              t, t + 1, std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        v = nullptr;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return v;
+  }
+
+  //! Any thread; returns nullptr when empty or when losing a race
+  T steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+
+    Buffer* a = buffer_.load(std::memory_order_acquire);
+    T v = a->get(t);
+    if (!top_.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return v;
+  }
+};
+
+/**
+ * Per-thread chunk container for PerThreadChunkMaster built on
+ * ChaseLevDeque. Pushes and owner pops never take a lock. An idle thread
+ * steals single chunks from its victims in topology order: first the other
+ * threads in its own socket, then the threads of the remaining sockets in
+ * ring order starting at the next socket id, so that work crosses the socket
+ * interconnect only when the local socket has none.
+ *
+ * @tparam OwnerFIFO if true, the owner takes its oldest chunk (from the
+ * steal end of its own deque) rather than its newest
+ */
+template <bool OwnerFIFO>
+class TopoStealingDeque : private boost::noncopyable {
+  struct Local {
+    ChaseLevDeque<ChunkHeader*> deque;
+    //! Victims of this thread in steal order, valid for num_victims_for
+    std::vector<unsigned> victims;
+    unsigned num_victims_for = 0;
+  };
+
+  PerThreadStorage<Local> local_;
+
+  static void ComputeVictims(unsigned id, unsigned num, Local* me) {
+    auto& tp = GetThreadPool();
+    unsigned my_socket = tp.getSocket(id);
+    unsigned num_sockets = tp.getMaxSockets();
+
+    me->victims.clear();
+    for (unsigned offset = 0; offset < num_sockets; ++offset) {
+      unsigned socket = (my_socket + offset) % num_sockets;
+      for (unsigned i = 1; i <= num; ++i) {
+        unsigned eid = (id + i) % num;
+        if (eid != id && tp.getSocket(eid) == socket) {
+          me->victims.push_back(eid);
+        }
+      }
+    }
+    me->num_victims_for = num;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  ChunkHeader* doSteal(Local* me) {
+    unsigned id = ThreadPool::getTID();
+    unsigned num = katana::getActiveThreads();
+    if (me->num_victims_for != num) {
+      ComputeVictims(id, num, me);
+    }
+
+    for (unsigned eid : me->victims) {
+      if (ChunkHeader* c = local_.getRemote(eid)->deque.steal()) {
+        return c;
+      }
+    }
+    return nullptr;
+  }
+
+public:
+  void push(ChunkHeader* c) { local_.getLocal()->deque.push(c); }
+
+  ChunkHeader* pop() {
+    Local* me = local_.getLocal();
+    ChunkHeader* c = OwnerFIFO ? me->deque.steal() : me->deque.pop();
+    if (c) {
+      return c;
+    }
+    if (OwnerFIFO && !me->deque.empty()) {
+      // Lost a race with a thief for our own work; try again before roaming
+      if ((c = me->deque.steal())) {
+        return c;
+      }
+    }
+    return doSteal(me);
+  }
+};
+
+/**
+ * Per-thread chunked LIFO with lock-free, topology-ordered work stealing.
+ * Unlike \ref PerSocketChunkLIFO, threads never contend on a shared
+ * per-socket queue; unlike \ref PerThreadChunkLIFO, pushes and local pops
+ * take no lock and stealing is not limited to socket leaders.
+ *
+ * @tparam ChunkSize chunk size
+ */
+template <int ChunkSize = 64, typename T = int>
+using StealingChunkLIFO =
+    PerThreadChunkMaster<true, ChunkSize, TopoStealingDeque<false>, T>;
+KATANA_WLCOMPILECHECK(StealingChunkLIFO)
+
+/**
+ * Per-thread chunked FIFO with lock-free, topology-ordered work stealing.
+ * A scalable replacement for \ref PerSocketChunkFIFO when many threads
+ * share a socket.
+ *
+ * @tparam ChunkSize chunk size
+ */
+template <int ChunkSize = 64, typename T = int>
+using StealingChunkFIFO =
+    PerThreadChunkMaster<false, ChunkSize, TopoStealingDeque<true>, T>;
+KATANA_WLCOMPILECHECK(StealingChunkFIFO)
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef KATANA_LIBGALOIS_KATANA_TEMPORALWINDOW_H_
+#define KATANA_LIBGALOIS_KATANA_TEMPORALWINDOW_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A temporal window is the subgraph of a PropertyGraph made of all of its
+/// nodes and of the edges whose timestamps are in [begin_time, end_time),
+/// read through the temporal edge index of the graph (see
+/// PropertyGraph::GetTemporalEdgeIndex). Nothing is copied: the edges of a
+/// node in the window are found by a binary search among its edges, in
+/// O(log d) for a node of d edges, and they come in order of timestamp.
+///
+/// Edges are those of the index; out_edge_id(e) is the id of edge e in the
+/// graph, e.g., to read its properties. Nodes keep their ids.
+///
+///     auto window = katana::TemporalWindow::Make(pg, "time", t0, t1);
+///     katana::do_all(katana::iterate(*window), [&](TemporalWindow::Node n) {
+///       for (auto e : window->edges(n)) {
+///         ... window->edge_dest(e) ...
+///       }
+///     });
+///
+/// Windows of a graph share its index, so sliding a window over time,
+/// e.g., by SetBounds, sorts the edges once. The window refers to the
+/// graph, which must outlive it.
+class KATANA_EXPORT TemporalWindow {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using node_iterator = GraphTopology::node_iterator;
+  using edges_range = GraphTopology::edges_range;
+  using iterator = node_iterator;
+
+  /// The window [begin_time, end_time) of pg over the edge property named
+  /// timestamp_property_name, in the units of the property; see
+  /// PropertyGraph::GetTemporalEdgeIndex for its types
+  static Result<TemporalWindow> Make(
+      PropertyGraph* pg, const std::string& timestamp_property_name,
+      int64_t begin_time, int64_t end_time);
+
+  TemporalWindow(
+      PropertyGraph* pg, std::shared_ptr<const TemporalEdgeIndex> index,
+      int64_t begin_time, int64_t end_time)
+      : pg_(pg),
+        index_(std::move(index)),
+        begin_time_(begin_time),
+        end_time_(end_time) {}
+
+  PropertyGraph* graph() const { return pg_; }
+
+  const TemporalEdgeIndex& index() const { return *index_; }
+
+  int64_t begin_time() const { return begin_time_; }
+
+  int64_t end_time() const { return end_time_; }
+
+  /// Move the window to [begin_time, end_time)
+  void SetBounds(int64_t begin_time, int64_t end_time) {
+    begin_time_ = begin_time;
+    end_time_ = end_time;
+  }
+
+  /// \returns the edges of node n in the window
+  edges_range edges(Node n) const {
+    return index_->edges(n, begin_time_, end_time_);
+  }
+
+  Node edge_dest(Edge e) const { return index_->edge_dest(e); }
+
+  int64_t timestamp(Edge e) const { return index_->timestamp(e); }
+
+  /// \returns the id of edge e in the graph
+  Edge out_edge_id(Edge e) const { return index_->out_edge_id(e); }
+
+  uint64_t num_nodes() const { return index_->num_nodes(); }
+
+  /// The number of edges in the window; takes a parallel pass over the nodes
+  uint64_t num_edges() const;
+
+  // Standard container concepts, over the nodes of the graph
+
+  node_iterator begin() const { return index_->topology.begin(); }
+
+  node_iterator end() const { return index_->topology.end(); }
+
+  size_t size() const { return index_->topology.size(); }
+
+private:
+  PropertyGraph* pg_;
+  std::shared_ptr<const TemporalEdgeIndex> index_;
+  int64_t begin_time_;
+  int64_t end_time_;
+};
+
+}  // namespace katana
+
+#endif
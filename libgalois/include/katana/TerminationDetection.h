@@ -30,12 +30,32 @@ namespace katana {
 
 class TerminationDetection;
 
+/// The algorithms of termination detection
+enum class TerminationKind {
+  /// The one chosen by KATANA_TERMINATION (ring, tree or counter), by
+  /// default kRing
+  kDefault,
+  /// A token passed around a ring of threads (Dijkstra). Idle threads only
+  /// touch their own and the next thread's state, but detection takes two
+  /// trips of the token around all threads after the last work.
+  kRing,
+  /// A token passed up and down a binary tree of threads, so detection
+  /// takes time logarithmic in the number of threads
+  kTree,
+  /// Idle threads count themselves into a shared counter that is reset
+  /// whenever a thread works; the last thread to go idle detects
+  /// termination at once. Idle threads back off exponentially between
+  /// polls. Good for short loops at high thread counts, where the latency
+  /// of the ring dominates.
+  kCounter,
+};
+
 /*
- * Returns the termination detection instance. The instance will be reused, but
- * reinitialized to activeThreads.
+ * Returns the termination detection instance of a kind. The instance will be
+ * reused, but reinitialized to activeThreads.
  */
 KATANA_EXPORT TerminationDetection& GetTerminationDetection(
-    unsigned active_threads);
+    unsigned active_threads, TerminationKind kind = TerminationKind::kDefault);
 
 /// Termination detection is the process of determining whether multiple
 /// threads can safely stop executing because no worker has done any
@@ -69,7 +89,8 @@ KATANA_EXPORT TerminationDetection& GetTerminationDetection(
 ///
 class KATANA_EXPORT TerminationDetection {
   // So that GetTerminationDetection can call init.
-  friend TerminationDetection& GetTerminationDetection(unsigned);
+  friend TerminationDetection& GetTerminationDetection(
+      unsigned, TerminationKind);
 
   CacheLineStorage<std::atomic<int>> global_term_;
 
@@ -109,7 +130,7 @@ public:
 };
 
 namespace internal {
-void SetTerminationDetection(TerminationDetection* term);
+void SetTerminationDetection(TerminationKind kind, TerminationDetection* term);
 }  // end namespace internal
 
 }  // end namespace katana
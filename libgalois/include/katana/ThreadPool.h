@@ -25,6 +25,7 @@
 #include <condition_variable>
 #include <cstdlib>
 #include <functional>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -70,6 +71,10 @@ protected:
     unsigned wbegin, wend;
     std::atomic<int> done;
     std::atomic<int> fastRelease;
+    //! set while the thread blocks on cv rather than spins
+    std::atomic<bool> parked{false};
+    //! moving average of the time between runs, for adaptive spinning
+    uint64_t avgIdleUsec{0};
     ThreadTopoInfo topo;
 
     void wakeup(bool fastmode) {
@@ -77,34 +82,35 @@ protected:
         done = 0;
         fastRelease = 1;
       } else {
-        std::lock_guard<std::mutex> lg(m);
+        // A spinning thread sees done, so only a parked one needs the
+        // notification. Both are sequentially consistent, so either the
+        // thread sees done or we see parked.
         done = 0;
-        cv.notify_one();
-        // start.release();
-      }
-    }
-
-    void wait(bool fastmode) {
-      if (fastmode) {
-        while (!fastRelease.load(std::memory_order_relaxed)) {
-          asmPause();
+        if (parked) {
+          std::lock_guard<std::mutex> lg(m);
+          cv.notify_one();
         }
-        fastRelease = 0;
-      } else {
-        std::unique_lock<std::mutex> lg(m);
-        cv.wait(lg, [=] { return !done; });
-        // start.acquire();
       }
     }
+
+    //! wait for wakeup, spinning for up to spinUsec before blocking
+    void wait(bool fastmode, uint64_t spinUsec);
   };
 
   thread_local static per_signal my_box;
+  //! set for the threads of the pool and for a thread running work on them
+  thread_local static bool inRun;
 
   MachineTopoInfo mi;
   std::vector<per_signal*> signals;
+  //! the mailbox of the thread that made the pool
+  per_signal* masterBox;
+  //! held while a thread runs work on the pool
+  std::mutex runMutex;
   std::vector<std::thread> threads;
   unsigned reserved;
   unsigned masterFastmode;
+  std::atomic<uint64_t> spinUsec;
   bool running;
   std::function<void(void)> work;
 
@@ -123,7 +129,7 @@ protected:
   //! spin down after run
   void decascade();
 
-  //! execute work on num threads
+  //! execute work on num threads, holding runMutex
   void runInternal(unsigned num);
 
   ThreadPool();
@@ -139,6 +145,11 @@ public:
 
   //! execute work on all threads
   //! a simple wrapper for run
+  //!
+  //! Runs are exclusive: the pool is not split between concurrent regions,
+  //! so a run from another thread waits for the current one to finish. A
+  //! thread of the pool may not start a run; loops called from an operator
+  //! check isInRun and run on the calling thread instead.
   template <typename... Args>
   void run(unsigned num, Args&&... args) {
     struct ExecuteTuple {
@@ -155,6 +166,9 @@ public:
     // paying for an indirection in work allows small-object optimization in
     // std::function to kick in and avoid a heap allocation
     ExecuteTuple lwork(std::forward<Args>(args)...);
+    KATANA_LOG_VASSERT(!inRun, "Recursive thread pool execution not supported");
+    attachThread();
+    std::lock_guard<std::mutex> lock(runMutex);
     work = std::ref(lwork);
     // work =
     // std::function<void(void)>(ExecuteTuple(std::forward<Args>(args)...));
@@ -165,13 +179,33 @@ public:
   //! run function in a dedicated thread until the threadpool exits
   void runDedicated(std::function<void(void)>& f);
 
+  //! Let the calling thread, which was not made by the pool, use per-thread
+  //! storage as thread 0 and run work on the pool. Threads other than the
+  //! one that made the pool take turns running work; each run waits for the
+  //! runs of other threads to finish. run calls this, so it is only needed
+  //! by threads that use per-thread storage before their first run.
+  void attachThread();
+
   // experimental: busy wait for work
   void burnPower(unsigned num);
   // experimental: leave busy wait
   void beKind();
 
+  //! Outside of fastmode, let idle threads spin for up to usec microseconds
+  //! after a run, with exponential backoff, before they block. Threads
+  //! whose runs arrive further apart than that on average block right away.
+  //! 0, the default unless KATANA_THREAD_SPIN_USEC is set, always blocks.
+  void setSpinBudget(uint64_t usec) { spinUsec = usec; }
+  uint64_t getSpinBudget() const { return spinUsec; }
+
+  //! true while some thread runs work on the pool
   bool isRunning() const { return running; }
 
+  //! true on a thread that runs work of the pool, where a loop cannot start
+  //! a run of its own and must run on the calling thread instead. Other
+  //! threads may start runs while the pool is running; they wait their turn.
+  static bool isInRun() { return inRun; }
+
   //! return the number of non-reserved threads in the pool
   unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
   //! return the number of threads supported by the thread pool on the current
@@ -180,6 +214,7 @@ public:
   unsigned getMaxCores() const { return mi.maxCores; }
   unsigned getMaxSockets() const { return mi.maxSockets; }
   unsigned getMaxNumaNodes() const { return mi.maxNumaNodes; }
+  unsigned getMaxCacheDomains() const { return mi.maxCacheDomains; }
 
   unsigned getLeaderForSocket(unsigned pid) const {
     for (unsigned i = 0; i < getMaxThreads(); ++i)
@@ -201,6 +236,9 @@ public:
   unsigned getNumaNode(unsigned tid) const {
     return signals[tid]->topo.numaNode;
   }
+  unsigned getCacheDomain(unsigned tid) const {
+    return signals[tid]->topo.cacheDomain;
+  }
 
   static unsigned getTID() { return my_box.topo.tid; }
   static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
@@ -210,10 +248,11 @@ public:
     return my_box.topo.cumulativeMaxSocket;
   }
   static unsigned getNumaNode() { return my_box.topo.numaNode; }
+  static unsigned getCacheDomain() { return my_box.topo.cacheDomain; }
 };
 
 /**
- * return a reference to system thread pool
+ * return a reference to system thread pool, which is made on the first call
  */
 KATANA_EXPORT ThreadPool& GetThreadPool();
 
@@ -223,6 +262,9 @@ namespace katana::internal {
 
 KATANA_EXPORT void SetThreadPool(ThreadPool* tp);
 
+/// \returns the system thread pool, or nullptr if it is not made yet
+KATANA_EXPORT ThreadPool* PeekThreadPool();
+
 }  // namespace katana::internal
 
 #endif
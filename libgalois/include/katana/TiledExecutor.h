@@ -23,10 +23,34 @@
 #include "katana/Galois.h"
 #include "katana/LargeArray.h"
 #include "katana/NoDerefIterator.h"
+#include "katana/PropertyGraph.h"
 #include "katana/config.h"
 
 namespace katana {
 
+/// The graph interface that Fixed2DGraphTiledExecutor uses, over a
+/// GraphTopology. The executor finds the edges of a tile by binary search,
+/// so the edges of each node must be sorted by destination.
+struct TiledGraphTopology {
+  using GraphNode = GraphTopology::Node;
+  using iterator = GraphTopology::node_iterator;
+  using edge_iterator = GraphTopology::edge_iterator;
+
+  const GraphTopology& topology;
+
+  iterator begin() const { return topology.begin(); }
+  iterator end() const { return topology.end(); }
+  edge_iterator edge_begin(GraphNode n, MethodFlag) const {
+    return topology.edges(n).begin();
+  }
+  edge_iterator edge_end(GraphNode n, MethodFlag) const {
+    return topology.edges(n).end();
+  }
+  GraphNode getEdgeDst(edge_iterator e) const {
+    return topology.edge_dest(*e);
+  }
+};
+
 template <typename Graph, bool UseExp = false>
 class Fixed2DGraphTiledExecutor {
   static constexpr int numDims = 2;  // code is specialized to 2
@@ -23,6 +23,7 @@
 #include <tuple>
 #include <type_traits>
 
+#include "katana/TerminationDetection.h"
 #include "katana/WorkList.h"
 #include "katana/config.h"
 
@@ -261,6 +262,16 @@ struct per_iter_alloc : public trait_has_type<bool>, per_iter_alloc_tag {};
 struct no_stats_tag {};
 struct no_stats : public trait_has_type<bool>, no_stats_tag {};
 
+/**
+ * Chooses the termination detection of a for_each or a stealing do_all, e.g.,
+ * <code>katana::termination(katana::TerminationKind::kCounter)</code>
+ */
+struct termination_tag {};
+struct termination : public trait_has_value<TerminationKind>, termination_tag {
+  termination(TerminationKind kind = TerminationKind::kDefault)
+      : trait_has_value<TerminationKind>(kind) {}
+};
+
 /**
  * Indicates the operator needs detailed stats
  * Must provide loopname to enable this flag
@@ -275,6 +286,14 @@ struct disable_conflict_detection_tag {};
 struct disable_conflict_detection : public trait_has_type<bool>,
                                     disable_conflict_detection_tag {};
 
+/**
+ * Indicates the loop should run fewer threads at once while its iterations
+ * conflict often, and more as conflicts drop; see katana::ConflictThrottle
+ */
+struct adaptive_conflicts_tag {};
+struct adaptive_conflicts : public trait_has_type<bool>,
+                            adaptive_conflicts_tag {};
+
 /**
  * Indicates that the neighborhood set does not change through out i.e. is not
  * dependent on computed values. Examples of such fixed neighborhood is e.g.
@@ -347,6 +366,34 @@ struct local_state_tag {};
 template <typename T>
 struct local_state : public trait_has_type<T>, local_state_tag {};
 
+/**
+ * Indicates a do_all should prefetch what its operator reads for the item
+ * Distance items ahead of the one it runs, e.g.,
+ * <code>katana::prefetch_distance<8>(katana::AdjacencyPrefetcher(topology,
+ * ranks))</code>.
+ *
+ * The prefetcher is called as prefetcher(item) or, if it has a static
+ * member kStages, as prefetcher(item, stage) for each stage in
+ * [0, kStages), stage s at (Distance >> s) items ahead. A stage can thus
+ * read what the earlier stages prefetched for the same item, e.g., the
+ * edge index of a node before the edges. Items must come from random access
+ * iterators.
+ */
+struct prefetch_tag {};
+template <unsigned Distance, typename P>
+struct s_prefetch_distance : public trait_has_value<P>, prefetch_tag {
+  static_assert(Distance > 0, "prefetch distance must be positive");
+  constexpr static unsigned distance = Distance;
+
+  s_prefetch_distance(P p) : trait_has_value<P>(std::move(p)) {}
+};
+
+template <unsigned Distance, typename P>
+s_prefetch_distance<Distance, P>
+prefetch_distance(P prefetcher) {
+  return s_prefetch_distance<Distance, P>(std::move(prefetcher));
+}
+
 // TODO: separate to libdist
 /** For distributed Galois **/
 struct op_tag {};
@@ -404,6 +451,16 @@ std::enable_if_t<!has_trait<loopname_tag, Tup>(), const char*>
 getLoopName(const Tup&) {
   return "ANON_LOOP";
 }
+
+template <typename Tup>
+TerminationKind
+getTerminationKind(const Tup& t) {
+  if constexpr (has_trait<termination_tag, Tup>()) {
+    return get_trait_value<termination_tag>(t).value;
+  } else {
+    return TerminationKind::kDefault;
+  }
+}
 }  // namespace internal
 
 }  // namespace katana
@@ -1,7 +1,9 @@
 #ifndef KATANA_LIBGALOIS_KATANA_TYPEDPROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_TYPEDPROPERTYGRAPH_H_
 
+#include <memory>
 #include <tuple>
+#include <vector>
 
 #include <arrow/type_fwd.h>
 #include <boost/iterator/counting_iterator.hpp>
@@ -38,11 +40,17 @@ class TypedPropertyGraph {
 
   NodeView node_view_;
   EdgeView edge_view_;
+  /// The properties that the views point into, which stay loaded while this
+  /// graph is alive (see PropertyGraph::PinNodeProperty)
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> pins_;
 
-  TypedPropertyGraph(PropertyGraph* pg, NodeView node_view, EdgeView edge_view)
+  TypedPropertyGraph(
+      PropertyGraph* pg, NodeView node_view, EdgeView edge_view,
+      std::vector<std::shared_ptr<arrow::ChunkedArray>> pins)
       : pfg_(pg),
         node_view_(std::move(node_view)),
-        edge_view_(std::move(edge_view)) {}
+        edge_view_(std::move(edge_view)),
+        pins_(std::move(pins)) {}
 
 public:
   using node_properties = NodeProps;
@@ -124,6 +132,42 @@ public:
     return std::get<prop_index>(edge_view_).GetValue(*edge);
   }
 
+  /**
+   * Gets the values of a node property as a raw array indexed by node, for
+   * properties whose views are contiguous (POD and struct properties, and
+   * fixed size lists, whose values are row-major by node). The
+   * pointer is valid as long as the graph; fetch it once outside a kernel
+   * so that each access is a plain indexed load.
+   *
+   * @returns pointer to the value of node 0
+   */
+  template <typename NodeIndex>
+  auto* GetNodePropertyData() {
+    constexpr size_t prop_index = find_trait<NodeIndex, NodeProps>();
+    return std::get<prop_index>(node_view_).data();
+  }
+  template <typename NodeIndex>
+  const auto* GetNodePropertyData() const {
+    constexpr size_t prop_index = find_trait<NodeIndex, NodeProps>();
+    return std::get<prop_index>(node_view_).data();
+  }
+
+  /**
+   * Gets the values of an edge property as a raw array indexed by edge.
+   *
+   * @see GetNodePropertyData
+   */
+  template <typename EdgeIndex>
+  auto* GetEdgePropertyData() {
+    constexpr size_t prop_index = find_trait<EdgeIndex, EdgeProps>();
+    return std::get<prop_index>(edge_view_).data();
+  }
+  template <typename EdgeIndex>
+  const auto* GetEdgePropertyData() const {
+    constexpr size_t prop_index = find_trait<EdgeIndex, EdgeProps>();
+    return std::get<prop_index>(edge_view_).data();
+  }
+
   /**
    * Gets the destination for an edge.
    *
@@ -137,6 +181,8 @@ public:
   uint64_t num_nodes() const { return pfg_->num_nodes(); }
   uint64_t num_edges() const { return pfg_->num_edges(); }
 
+  const GraphTopology& topology() const { return pfg_->topology(); }
+
   /**
    * Gets the edge range of some node.
    *
@@ -213,21 +259,22 @@ Result<TypedPropertyGraph<NodeProps, EdgeProps>>
 TypedPropertyGraph<NodeProps, EdgeProps>::Make(
     PropertyGraph* pg, const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> pins;
   auto node_view_result =
-      internal::MakeNodePropertyViews<NodeProps>(pg, node_properties);
+      internal::MakeNodePropertyViews<NodeProps>(pg, node_properties, &pins);
   if (!node_view_result) {
     return node_view_result.error();
   }
 
   auto edge_view_result =
-      internal::MakeEdgePropertyViews<EdgeProps>(pg, edge_properties);
+      internal::MakeEdgePropertyViews<EdgeProps>(pg, edge_properties, &pins);
   if (!edge_view_result) {
     return edge_view_result.error();
   }
 
   return TypedPropertyGraph(
       pg, std::move(node_view_result.value()),
-      std::move(edge_view_result.value()));
+      std::move(edge_view_result.value()), std::move(pins));
 }
 
 template <typename NodeProps, typename EdgeProps>
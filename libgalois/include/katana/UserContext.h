@@ -45,6 +45,8 @@ protected:
   //! Allocator stuff
   IterAllocBaseTy IterationAllocatorBase;
   PerIterAllocTy PerIterationAllocator;
+  IterAllocBaseTy LoopAllocatorBase;
+  PerIterAllocTy PerLoopAllocator;
 
   //! used by all
   bool* didBreak = nullptr;
@@ -72,6 +74,8 @@ public:
   UserContext()
       : IterationAllocatorBase(),
         PerIterationAllocator(&IterationAllocatorBase),
+        LoopAllocatorBase(),
+        PerLoopAllocator(&LoopAllocatorBase),
         didBreak(0) {}
 
   //! Signal break in parallel loop, current iteration continues
@@ -81,6 +85,14 @@ public:
   //! Acquire a per-iteration allocator
   PerIterAllocTy& getPerIterAlloc() { return PerIterationAllocator; }
 
+  //! Acquire a per-loop allocator: a bump allocator of this thread whose
+  //! memory stays valid, for every thread, until the loop ends, when it is
+  //! reclaimed all at once. Items pushed by an iteration may point to it,
+  //! e.g., to hand variable-sized payloads to later iterations without
+  //! malloc. Deallocation is a no-op, so memory needed only within an
+  //! iteration is better taken from the per-iteration allocator.
+  PerIterAllocTy& getPerLoopAlloc() { return PerLoopAllocator; }
+
   //! Push new work
   template <typename... Args>
   void push(Args&&... args) {
@@ -102,6 +114,17 @@ public:
     this->push(std::forward<Args>(args)...);
   }
 
+  //! Push the new work in [begin, end) at once, e.g., from an array filled
+  //! by an operator compiled outside of C++
+  template <typename Iter>
+  void pushRange(Iter begin, Iter end) {
+    for (; begin != end; ++begin) {
+      pushBuffer.emplace_back(*begin);
+    }
+    if (fastPushBack && pushBuffer.size() > fastPushBackLimit)
+      fastPushBack(pushBuffer);
+  }
+
   //! Force the abort of this iteration
   void abort() { katana::signalConflict(); }
 
@@ -0,0 +1,218 @@
+#ifndef KATANA_LIBGALOIS_KATANA_VERTEXPROGRAM_H_
+#define KATANA_LIBGALOIS_KATANA_VERTEXPROGRAM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Cancellation.h"
+#include "katana/DynamicBitset.h"
+#include "katana/EdgeBalancedRange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Frontier.h"
+#include "katana/Galois.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// How RunVertexProgram sends the messages of a superstep
+enum class VertexProgramDirection {
+  /// Pull when the frontier is dense and push otherwise
+  kAuto,
+  /// Active nodes combine their messages into those of their destinations
+  kPush,
+  /// Every node combines the messages of its active in-neighbors
+  kPull,
+};
+
+struct VertexProgramOptions {
+  VertexProgramDirection direction{VertexProgramDirection::kAuto};
+  /// The fraction of the nodes above which the frontier becomes dense, and
+  /// kAuto pulls (see Frontier::Adapt)
+  double dense_fraction{Frontier::kDefaultDenseFraction};
+  /// RunVertexProgram stops after this many supersteps
+  uint32_t max_supersteps{std::numeric_limits<uint32_t>::max()};
+};
+
+/// Run a vertex program on the nodes of pg in bulk-synchronous supersteps,
+/// in the manner of Pregel, without writing the loops by hand.
+///
+/// A program holds a value per node and sends messages along out-edges.
+/// Messages to the same node are merged by a combiner, which must be
+/// associative and commutative, so each node receives one:
+///
+///     struct Program {
+///       using Value = ...;
+///       using Message = ...;  // trivially copyable
+///       /// The identity of Combine
+///       Message Identity() const;
+///       Message Combine(Message a, Message b) const;
+///       /// Initializes the value of n; true if n is active in superstep 0
+///       bool Init(Node n, Value* value) const;
+///       /// The message an active src sends along its out-edge e to dst
+///       Message Scatter(Node src, const Value& value, Edge e, Node dst) const;
+///       /// The combined messages to n, received in a superstep; true if n
+///       /// is active in the next one
+///       bool Apply(Node n, Value* value, const Message& message) const;
+///     };
+///
+/// In each superstep, every active node sends a message along each of its
+/// out-edges, from its value at the start of the superstep, and then every
+/// node that received a message applies their combination. Nodes that
+/// receive none keep their values and are inactive. The program ends once
+/// no node is active.
+///
+/// Sparse frontiers are pushed: the messages of each active node are
+/// combined into a slot per destination by compare and swap. Dense ones
+/// are pulled over the in-edge index of pg (see PropertyGraph::
+/// GetInEdgeIndex), so that every node combines the messages from its
+/// active in-neighbors alone, without atomics. Either way e is the id of
+/// the out-edge in pg, e.g., to read its properties.
+///
+/// \returns the number of supersteps
+template <typename Program>
+Result<uint32_t> RunVertexProgram(
+    PropertyGraph* pg, const Program& program,
+    std::vector<typename Program::Value>* values,
+    const VertexProgramOptions& options = {});
+
+namespace internal {
+
+/// Combine message into slot atomically
+template <typename Program>
+void
+CombineAtomic(
+    const Program& program, std::atomic<typename Program::Message>* slot,
+    const typename Program::Message& message) {
+  auto old = slot->load(std::memory_order_relaxed);
+  while (!slot->compare_exchange_weak(
+      old, program.Combine(old, message), std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace internal
+
+template <typename Program>
+Result<uint32_t>
+RunVertexProgram(
+    PropertyGraph* pg, const Program& program,
+    std::vector<typename Program::Value>* values,
+    const VertexProgramOptions& options) {
+  using Message = typename Program::Message;
+  using Node = GraphTopology::Node;
+  static_assert(
+      std::is_trivially_copyable_v<Message>,
+      "messages are combined by compare and swap");
+
+  const GraphTopology& topology = pg->topology();
+  const size_t num_nodes = topology.num_nodes();
+  values->resize(num_nodes);
+
+  std::vector<std::atomic<Message>> messages(num_nodes);
+  // Push marks the nodes with messages so that receivers holds each once
+  DynamicBitset received;
+  received.resize(num_nodes);
+  std::shared_ptr<const InEdgeIndex> in_edges;
+
+  Frontier frontier(num_nodes, options.dense_fraction);
+  Frontier next(num_nodes, options.dense_fraction);
+  Frontier receivers(num_nodes, options.dense_fraction);
+
+  do_all(
+      iterate(size_t{0}, num_nodes),
+      [&](Node n) {
+        messages[n].store(program.Identity(), std::memory_order_relaxed);
+        if (program.Init(n, &(*values)[n])) {
+          frontier.push(n);
+        }
+      },
+      no_stats(), loopname("VertexProgramInit"));
+  frontier.Adapt();
+
+  uint32_t superstep = 0;
+  for (; !frontier.empty() && superstep < options.max_supersteps;
+       ++superstep) {
+    if (IsCancelled()) {
+      return ErrorCode::Cancelled;
+    }
+
+    bool pull = options.direction == VertexProgramDirection::kPull ||
+                (options.direction == VertexProgramDirection::kAuto &&
+                 frontier.is_dense());
+    if (pull && !in_edges) {
+      auto in_edges_result = pg->GetInEdgeIndex();
+      if (!in_edges_result) {
+        return in_edges_result.error();
+      }
+      in_edges = std::move(in_edges_result.value());
+    }
+
+    if (pull) {
+      frontier.ToDense();
+      receivers.Reset(true);
+      const InEdgeIndex& index = *in_edges;
+      do_all(
+          iterate_edge_balanced(index.topology),
+          [&](Node dst) {
+            Message combined = program.Identity();
+            bool any = false;
+            for (auto e : index.in_edges(dst)) {
+              Node src = index.in_edge_src(e);
+              if (frontier.test(src)) {
+                combined = program.Combine(
+                    combined, program.Scatter(
+                                  src, (*values)[src], index.out_edge_id(e),
+                                  dst));
+                any = true;
+              }
+            }
+            if (any) {
+              messages[dst].store(combined, std::memory_order_relaxed);
+              receivers.push(dst);
+            }
+          },
+          steal(), no_stats(), loopname("VertexProgramPull"));
+    } else {
+      receivers.Reset(false);
+      frontier.ForEach(
+          [&](Node src) {
+            const auto& value = (*values)[src];
+            for (auto e : topology.edges(src)) {
+              Node dst = topology.edge_dest(e);
+              internal::CombineAtomic(
+                  program, &messages[dst],
+                  program.Scatter(src, value, e, dst));
+              if (!received.set(dst)) {
+                receivers.push(dst);
+              }
+            }
+          },
+          "VertexProgramPush");
+    }
+
+    receivers.ForEach(
+        [&](Node n) {
+          Message message = messages[n].load(std::memory_order_relaxed);
+          messages[n].store(program.Identity(), std::memory_order_relaxed);
+          received.reset(n);
+          if (program.Apply(n, &(*values)[n], message)) {
+            next.push(n);
+          }
+        },
+        "VertexProgramApply");
+
+    frontier.swap(next);
+    next.clear();
+    frontier.Adapt();
+  }
+
+  return superstep;
+}
+
+}  // namespace katana
+
+#endif
@@ -25,11 +25,13 @@
 #include "katana/BulkSynchronous.h"
 #include "katana/Chunk.h"
 #include "katana/LocalQueue.h"
+#include "katana/MultiQueue.h"
 #include "katana/Obim.h"
 #include "katana/OrderedList.h"
 #include "katana/OwnerComputes.h"
 #include "katana/PerThreadChunk.h"
 #include "katana/Simple.h"
+#include "katana/StealingDeque.h"
 #include "katana/StableIterator.h"
 #include "katana/config.h"
 
@@ -38,7 +40,8 @@ namespace katana {
  * Scheduling policies for Galois iterators. Unless you have very specific
  * scheduling requirement, \ref PerSocketChunkLIFO or \ref PerSocketChunkFIFO is
  * a reasonable scheduling policy. If you need approximate priority scheduling,
- * use \ref OrderedByIntegerMetric. For debugging, you may be interested in
+ * use \ref OrderedByIntegerMetric, or \ref MultiQueue to order items by a
+ * comparison rather than an integer. For debugging, you may be interested in
  * \ref FIFO or \ref LIFO, which try to follow serial order exactly.
  *
  * The way to use a worklist is to pass it as a template parameter to
@@ -48,6 +51,15 @@ namespace katana {
  * katana::for_each(katana::iterate(beg,end), fn,
  * katana::wl<katana::PerSocketChunkFIFO<32>>());
  * \endcode
+ *
+ * Worklists that take arguments get them from \ref wl(). For example, to
+ * schedule by a real-valued priority,
+ *
+ * \code
+ * auto earlier = [&](Node a, Node b) { return dist[a] < dist[b]; };
+ * katana::for_each(katana::iterate(beg,end), fn,
+ * katana::wl<katana::MultiQueue<decltype(earlier)>>(earlier));
+ * \endcode
  */
 
 namespace {  // don't pollute the symbol table with the example
@@ -0,0 +1,204 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_AUTOTUNE_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_AUTOTUNE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/analytics/Sparsify.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// A plan to try, with a name that identifies it in the autotune cache
+template <typename PlanType>
+struct PlanCandidate {
+  std::string name;
+  PlanType plan;
+};
+
+struct AutotuneOptions {
+  /// The number of nodes of the sampled subgraph the trials run on
+  uint64_t sample_nodes{1U << 16U};
+  /// Trials of each candidate; the fastest of them counts
+  uint32_t trials{2};
+  /// The node and edge properties the analytic reads, copied to the sample
+  std::vector<std::string> node_properties;
+  std::vector<std::string> edge_properties;
+  /// Look up and record choices in AutotuneCache::Global()
+  bool use_cache{true};
+  /// If set, trials run on this sparsification of the graph, which keeps
+  /// every node and the degree distribution in proportion, instead of on
+  /// the subgraph of sample_nodes found by SampleSubgraph
+  std::optional<SparsifyPlan> sparsify_plan;
+};
+
+/// Choices of the autotuner by analytic and graph fingerprint. The cache
+/// lives for the process; ToJson and FromJson save it with the graphs it
+/// describes, e.g., next to their RDGs, to reuse it across runs.
+class KATANA_EXPORT AutotuneCache {
+public:
+  static AutotuneCache& Global();
+
+  /// \returns the name of the candidate chosen for analytic on the graph
+  ///     with the fingerprint, if any
+  std::optional<std::string> Lookup(
+      const std::string& analytic, uint64_t fingerprint) const;
+
+  void Insert(
+      const std::string& analytic, uint64_t fingerprint,
+      const std::string& candidate);
+
+  void Clear();
+
+  std::string ToJson() const;
+
+  /// Add the choices of json, as written by ToJson
+  Result<void> FromJson(const std::string& json);
+
+private:
+  static std::string Key(const std::string& analytic, uint64_t fingerprint);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::string> choices_;
+};
+
+/// \returns a hash of the size and of a sample of the topology of pg that
+///     tells graphs apart for the autotuner without reading all of it
+KATANA_EXPORT uint64_t GraphFingerprint(const PropertyGraph& pg);
+
+/// \returns the subgraph of pg induced by up to num_nodes nodes found by
+///     breadth first search from random nodes, which keeps the degrees and
+///     neighborhoods of the nodes it reaches, with copies of the properties
+///     given
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> SampleSubgraph(
+    PropertyGraph* pg, uint64_t num_nodes,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties);
+
+/// Choose the fastest of candidates for an analytic on pg. Each candidate
+/// runs options.trials times through run(sample, plan), which returns a
+/// Result<void>, on a subgraph sampled from pg; properties a trial adds to
+/// the sample are removed after it. Candidates that fail are skipped. With
+/// options.use_cache, a choice recorded for analytic on a graph with the
+/// fingerprint of pg is taken without trials.
+///
+/// \returns the plan of the fastest candidate
+template <typename PlanType, typename RunFn>
+Result<PlanType>
+Autotune(
+    PropertyGraph* pg, const std::string& analytic,
+    const std::vector<PlanCandidate<PlanType>>& candidates, RunFn run,
+    const AutotuneOptions& options = {}) {
+  if (candidates.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no candidate plans for {}", analytic);
+  }
+
+  uint64_t fingerprint = GraphFingerprint(*pg);
+  if (options.use_cache) {
+    if (auto name = AutotuneCache::Global().Lookup(analytic, fingerprint)) {
+      for (const auto& candidate : candidates) {
+        if (candidate.name == *name) {
+          return candidate.plan;
+        }
+      }
+    }
+  }
+
+  std::unique_ptr<PropertyGraph> sample;
+  if (options.sparsify_plan) {
+    auto sample_res = Sparsify(
+        pg, *options.sparsify_plan, options.node_properties,
+        options.edge_properties);
+    if (!sample_res) {
+      return sample_res.error();
+    }
+    sample = std::move(sample_res.value().graph);
+  } else {
+    auto sample_res = SampleSubgraph(
+        pg, options.sample_nodes, options.node_properties,
+        options.edge_properties);
+    if (!sample_res) {
+      return sample_res.error();
+    }
+    sample = std::move(sample_res.value());
+  }
+  // Trials remove the properties they add so that the next may add them
+  auto node_properties = sample->node_schema()->field_names();
+  auto edge_properties = sample->edge_schema()->field_names();
+  auto remove_added = [&]() -> Result<void> {
+    for (const auto& name : sample->node_schema()->field_names()) {
+      if (std::find(node_properties.begin(), node_properties.end(), name) ==
+          node_properties.end()) {
+        if (auto r = sample->RemoveNodeProperty(name); !r) {
+          return r.error();
+        }
+      }
+    }
+    for (const auto& name : sample->edge_schema()->field_names()) {
+      if (std::find(edge_properties.begin(), edge_properties.end(), name) ==
+          edge_properties.end()) {
+        if (auto r = sample->RemoveEdgeProperty(name); !r) {
+          return r.error();
+        }
+      }
+    }
+    return ResultSuccess();
+  };
+
+  const PlanCandidate<PlanType>* best = nullptr;
+  double best_seconds = std::numeric_limits<double>::infinity();
+  for (const auto& candidate : candidates) {
+    double seconds = std::numeric_limits<double>::infinity();
+    for (uint32_t trial = 0; trial < std::max(options.trials, 1U); ++trial) {
+      auto start = std::chrono::steady_clock::now();
+      Result<void> res = run(sample.get(), candidate.plan);
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      if (auto r = remove_added(); !r) {
+        return r.error();
+      }
+      if (!res) {
+        KATANA_LOG_DEBUG(
+            "autotune {}: candidate {} failed: {}", analytic, candidate.name,
+            res.error());
+        seconds = std::numeric_limits<double>::infinity();
+        break;
+      }
+      seconds = std::min(seconds, elapsed.count());
+    }
+    KATANA_LOG_DEBUG(
+        "autotune {}: candidate {} took {}s", analytic, candidate.name,
+        seconds);
+    if (seconds < best_seconds) {
+      best = &candidate;
+      best_seconds = seconds;
+    }
+  }
+
+  if (best == nullptr) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "every candidate plan for {} failed",
+        analytic);
+  }
+  if (options.use_cache) {
+    AutotuneCache::Global().Insert(analytic, fingerprint, best->name);
+  }
+  return best->plan;
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -24,6 +24,8 @@
 #include <cstdlib>
 #include <iostream>
 
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -44,6 +46,15 @@ struct BfsSsspImplementationBase {
   using GNode = typename Graph::Node;
   using EI = typename Graph::edge_iterator;
 
+  /// True when the active threads span more than one socket. Shared
+  /// per-socket chunk queues contend heavily in that case, so the
+  /// asynchronous algorithms switch to the lock-free stealing worklists.
+  static bool UseStealingWorklist() {
+    unsigned num = katana::getActiveThreads();
+    return num > 1 &&
+           katana::GetThreadPool().getCumulativeMaxSocket(num - 1) > 0;
+  }
+
   struct UpdateRequest {
     GNode src;
     Dist dist;
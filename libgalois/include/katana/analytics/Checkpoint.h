@@ -0,0 +1,180 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CHECKPOINT_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_CHECKPOINT_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Result.h"
+#include "katana/Uri.h"
+#include "katana/config.h"
+#include "tsuba/WriteGroup.h"
+
+namespace katana::analytics {
+
+/// A Checkpointer saves the state of an analytic that runs in iterations,
+/// e.g., the ranks and residuals of PageRank, so that a run stopped by the
+/// preemption of its machine resumes from its last checkpoint instead of
+/// from the start.
+///
+/// As with cancellation, analytics do not take a checkpointer as an
+/// argument. The thread that runs one installs it with a CheckpointScope;
+/// analytics that support checkpoints resume from its checkpoint when they
+/// start, if it is one of theirs, and save their state at every
+/// interval-th iteration boundary:
+///
+///     auto ckpt_res = katana::analytics::Checkpointer::Make(dir, 10);
+///     katana::analytics::CheckpointScope scope(ckpt_res.value().get());
+///     auto res = katana::analytics::Pagerank(pg, "rank", plan);
+///     // a run of the same code after a preemption picks up where it was
+///
+/// Save writes the state through a tsuba::WriteGroup while the analytic
+/// continues. The checkpoint replaces the previous one only once its
+/// files are complete and a small manifest naming it is stored, so a run
+/// stopped at any time finds a complete checkpoint. The checkpoints of
+/// each task of a job have a manifest of their own.
+///
+/// Analytics log failed checkpoints and continue; a checkpointer is not
+/// cleared when they finish, so call Clear once the result is stored.
+class KATANA_EXPORT Checkpointer {
+public:
+  /// The state after an iteration of an analytic
+  struct Checkpoint {
+    /// Names the analytic and its input, e.g., the algorithm and the size
+    /// of the graph, so that state is only restored into the same run
+    std::string analytic;
+    uint64_t iteration{0};
+    std::shared_ptr<arrow::Table> state;
+  };
+
+  /// Save checkpoints under the directory dir at every interval-th
+  /// iteration; an interval of 0 only restores
+  static Result<std::unique_ptr<Checkpointer>> Make(
+      const std::string& dir, uint32_t interval);
+
+  Checkpointer(const Checkpointer&) = delete;
+  Checkpointer& operator=(const Checkpointer&) = delete;
+  /// Waits for the checkpoint being saved, if any
+  ~Checkpointer();
+
+  uint32_t interval() const { return interval_; }
+
+  /// \returns true if the state after iteration (counting from 1) should be
+  ///     saved
+  bool IsDue(uint64_t iteration) const {
+    return interval_ > 0 && iteration % interval_ == 0;
+  }
+
+  /// Start to save state as the checkpoint of analytic after iteration.
+  /// The checkpoint being saved, if any, is finished first. When running
+  /// with multiple hosts, Save should be called by all hosts.
+  Result<void> Save(
+      const std::string& analytic, uint64_t iteration,
+      std::shared_ptr<arrow::Table> state);
+
+  /// Wait for the checkpoint being saved, if any, to be complete
+  Result<void> Finish();
+
+  /// \returns the last complete checkpoint of analytic, or nothing if the
+  ///     last one is of another analytic or there is none
+  Result<std::optional<Checkpoint>> Restore(const std::string& analytic);
+
+  /// Delete the checkpoints
+  Result<void> Clear();
+
+private:
+  Checkpointer(katana::Uri dir, uint32_t interval)
+      : dir_(std::move(dir)), interval_(interval) {}
+
+  katana::Uri ManifestUri() const;
+
+  katana::Uri dir_;
+  uint32_t interval_;
+
+  /// The checkpoint being saved and its writes
+  std::unique_ptr<tsuba::WriteGroup> writes_;
+  std::string pending_analytic_;
+  uint64_t pending_iteration_{0};
+  std::string pending_file_;
+  /// The file of the last complete checkpoint
+  std::string committed_file_;
+};
+
+/// CheckpointScope makes \param checkpointer the one that analytics run by
+/// this thread use until the scope ends. Scopes nest; a null checkpointer
+/// means no checkpoints.
+class KATANA_EXPORT CheckpointScope {
+public:
+  explicit CheckpointScope(Checkpointer* checkpointer);
+  ~CheckpointScope();
+
+  CheckpointScope(const CheckpointScope&) = delete;
+  CheckpointScope& operator=(const CheckpointScope&) = delete;
+
+private:
+  Checkpointer* prev_;
+};
+
+/// \returns the checkpointer of the innermost CheckpointScope of this
+///     thread, or nullptr if there is none
+KATANA_EXPORT Checkpointer* CurrentCheckpointer();
+
+/// \returns an array of f(i) for i in [0, size), computed in parallel,
+///     e.g., a column of a value per node for the state of a checkpoint
+template <typename T, typename F>
+Result<std::shared_ptr<arrow::Array>>
+MakeCheckpointColumn(uint64_t size, F f) {
+  using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+  auto buffer_res = arrow::AllocateBuffer(size * sizeof(T));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        ArrowToKatana(buffer_res.status()), "allocating a column: {}",
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  T* data = reinterpret_cast<T*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, size), [&](uint64_t i) { data[i] = f(i); },
+      katana::no_stats());
+  return std::make_shared<arrow::NumericArray<ArrowType>>(size, buffer);
+}
+
+/// Call set(i, value) for the value at each row i of the column name of
+/// state, which must be of T and have size rows
+template <typename T, typename F>
+Result<void>
+RestoreCheckpointColumn(
+    const arrow::Table& state, const std::string& name, uint64_t size,
+    F set) {
+  using ArrayType =
+      arrow::NumericArray<typename arrow::CTypeTraits<T>::ArrowType>;
+  std::shared_ptr<arrow::ChunkedArray> column = state.GetColumnByName(name);
+  if (!column ||
+      !column->type()->Equals(arrow::CTypeTraits<T>::type_singleton()) ||
+      static_cast<uint64_t>(column->length()) != size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "checkpoint has no column {} of {} values of the expected type", name,
+        size);
+  }
+  uint64_t offset = 0;
+  for (const auto& chunk : column->chunks()) {
+    auto array = std::static_pointer_cast<ArrayType>(chunk);
+    katana::do_all(
+        katana::iterate(int64_t{0}, array->length()),
+        [&](int64_t i) { set(offset + i, array->Value(i)); },
+        katana::no_stats());
+    offset += array->length();
+  }
+  return ResultSuccess();
+}
+
+}  // namespace katana::analytics
+
+#endif
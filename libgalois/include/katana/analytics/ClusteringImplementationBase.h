@@ -20,13 +20,18 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <numeric>
 #include <random>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/Galois.h"
 #include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -48,6 +53,77 @@ using DegreeWeight = katana::PODProperty<EdgeWeightType>;
 template <typename EdgeWeightType>
 using EdgeWeight = katana::PODProperty<EdgeWeightType>;
 
+/// The edges that one thread merged for the clusters it coarsened, with
+/// the hash table it merges them with
+template <typename EdgeTy>
+struct CoarseningBuffer {
+  std::vector<uint32_t> dests;
+  std::vector<EdgeTy> weights;
+  /// Open addressing table from a destination cluster to its position in
+  /// the edges of the current cluster. A slot holds the stamp of the
+  /// cluster that filled it in the upper 32 bits, so that the table never
+  /// needs to be cleared.
+  std::vector<uint64_t> slots;
+  uint32_t stamp{0};
+  uint32_t shift{64};
+
+  /// Prepare for a cluster with at most \p max_edges distinct edges
+  void StartCluster(uint64_t max_edges) {
+    uint32_t bits = 4;
+    while ((uint64_t{1} << bits) < 2 * max_edges) {
+      ++bits;
+    }
+    if (slots.size() < (uint64_t{1} << bits)) {
+      slots.assign(uint64_t{1} << bits, 0);
+      stamp = 0;
+    }
+    if (++stamp == 0) {
+      std::fill(slots.begin(), slots.end(), 0);
+      stamp = 1;
+    }
+    shift = 64 - bits;
+  }
+
+  /// Add an edge to \p dst, merging it into an earlier edge of the cluster
+  /// whose edges start at \p begin
+  void Add(uint64_t begin, uint32_t dst, EdgeTy weight) {
+    uint64_t mask = (uint64_t{1} << (64 - shift)) - 1;
+    for (uint64_t slot = (dst * 0x9e3779b97f4a7c15ULL) >> shift;;
+         slot = (slot + 1) & mask) {
+      uint64_t entry = slots[slot];
+      if (entry >> 32 != stamp) {
+        slots[slot] = uint64_t{stamp} << 32 | (dests.size() - begin);
+        dests.emplace_back(dst);
+        weights.emplace_back(weight);
+        return;
+      }
+      uint64_t pos = begin + (entry & 0xffffffff);
+      if (dests[pos] == dst) {
+        weights[pos] += weight;
+        return;
+      }
+    }
+  }
+};
+
+/// The buffers of GraphCoarsening. They are kept across the levels of a
+/// clustering, so that once they fit the first, largest level coarsening
+/// allocates nothing but the properties of the next graph.
+template <typename EdgeTy>
+struct CoarseningArena {
+  /// The nodes sorted by cluster; those of cluster c are at
+  /// [node_offsets[c], node_offsets[c + 1])
+  std::vector<uint32_t> cluster_nodes;
+  std::vector<uint64_t> node_offsets;
+  /// The merged edges of cluster c are in the buffer of thread
+  /// edge_thread[c], from edge_begin[c], and go to [edge_offsets[c],
+  /// edge_offsets[c + 1]) of the next graph
+  std::vector<uint32_t> edge_thread;
+  std::vector<uint64_t> edge_begin;
+  std::vector<uint64_t> edge_offsets;
+  katana::PerThreadStorage<CoarseningBuffer<EdgeTy>> per_thread;
+};
+
 template <typename _Graph, typename _EdgeType, typename _CommunityType>
 struct ClusteringImplementationBase {
   using Graph = _Graph;
@@ -60,6 +136,9 @@ struct ClusteringImplementationBase {
 
   using CommunityArray = katana::LargeArray<CommunityType>;
 
+  /// Buffers of GraphCoarsening, reused by every level
+  CoarseningArena<EdgeTy> coarsening_arena_;
+
   /**
    * Algorithm to find the best cluster for the node
    * to move to among its neighbors in the graph and moves.
@@ -296,8 +375,8 @@ struct ClusteringImplementationBase {
           ((double)(c_info[n].degree_wt) * (double)constant_for_second_term);
     });
 
-    e_xx = acc_e_xx.reduce();
-    a2_x = acc_a2_x.reduce();
+    e_xx = acc_e_xx.reduceHierarchical();
+    a2_x = acc_a2_x.reduceHierarchical();
 
     mod = e_xx * (double)constant_for_second_term -
           a2_x * (double)constant_for_second_term;
@@ -388,8 +467,8 @@ struct ClusteringImplementationBase {
           ((double)(c_info[n].degree_wt) * (double)constant_for_second_term);
     });
 
-    e_xx = acc_e_xx.reduce();
-    a2_x = acc_a2_x.reduce();
+    e_xx = acc_e_xx.reduceHierarchical();
+    a2_x = acc_a2_x.reduceHierarchical();
 
     mod = e_xx * (double)constant_for_second_term -
           a2_x * (double)constant_for_second_term;
@@ -540,68 +619,87 @@ struct ClusteringImplementationBase {
     uint64_t num_nodes_next = num_unique_clusters;
     uint64_t num_edges_next = 0;  // Unknown right now
 
-    std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-    // Comment: Serial separation is better than do_all due to contention
-    for (GNode n = 0; n < graph.num_nodes(); ++n) {
-      auto n_data_curr_comm_id = graph.template GetData<CurrentCommunityId>(n);
-      if (n_data_curr_comm_id != UNASSIGNED)
-        cluster_bags[n_data_curr_comm_id].push_back(n);
+    CoarseningArena<EdgeTy>& arena = coarsening_arena_;
+    for (unsigned i = 0; i < katana::getActiveThreads(); ++i) {
+      arena.per_thread.getRemote(i)->dests.clear();
+      arena.per_thread.getRemote(i)->weights.clear();
     }
 
-    std::vector<std::vector<uint32_t>> edges_id(num_unique_clusters);
-    std::vector<std::vector<EdgeTy>> edges_data(num_unique_clusters);
-
-    /* First pass to find the number of edges */
+    // Group the nodes by cluster, keeping node order within a cluster so
+    // that edge weights are summed in the same order on every run.
+    // Unassigned nodes sort last, as cluster num_unique_clusters.
+    auto cluster_of = [&](GNode n) -> uint64_t {
+      uint64_t c = graph.template GetData<CurrentCommunityId>(n);
+      return c == UNASSIGNED ? num_unique_clusters : c;
+    };
+    arena.cluster_nodes.resize(graph.num_nodes());
+    std::iota(arena.cluster_nodes.begin(), arena.cluster_nodes.end(), GNode{0});
+    katana::ParallelSTL::radix_sort(
+        arena.cluster_nodes.begin(), arena.cluster_nodes.end(), cluster_of);
+
+    // Renumbered clusters are not empty, so each starts where the sorted
+    // cluster ids change
+    arena.node_offsets.resize(num_unique_clusters + 1);
+    arena.node_offsets[num_unique_clusters] = graph.num_nodes();
+    katana::do_all(
+        katana::iterate((uint64_t)0, graph.num_nodes()),
+        [&](uint64_t i) {
+          uint64_t c = cluster_of(arena.cluster_nodes[i]);
+          if (i == 0 || cluster_of(arena.cluster_nodes[i - 1]) != c) {
+            arena.node_offsets[c] = i;
+          }
+        },
+        katana::no_stats());
+
+    // Merge the edges of each cluster into the buffer of the thread that
+    // handles it, combining edges to the same cluster with a hash table
+    arena.edge_thread.resize(num_unique_clusters);
+    arena.edge_begin.resize(num_unique_clusters);
+    arena.edge_offsets.resize(num_unique_clusters + 1);
+    arena.edge_offsets[0] = 0;
     katana::do_all(
         katana::iterate((uint64_t)0, num_unique_clusters),
         [&](uint64_t c) {
-          std::map<uint64_t, uint64_t> cluster_local_map;
-          uint64_t num_unique_clusters = 0;
-          for (auto cb_ii = cluster_bags[c].begin();
-               cb_ii != cluster_bags[c].end(); ++cb_ii) {
+          CoarseningBuffer<EdgeTy>& buffer = *arena.per_thread.getLocal();
+          const GNode* nodes_begin =
+              arena.cluster_nodes.data() + arena.node_offsets[c];
+          const GNode* nodes_end =
+              arena.cluster_nodes.data() + arena.node_offsets[c + 1];
+
+          uint64_t num_cluster_edges = 0;
+          for (const GNode* n = nodes_begin; n != nodes_end; ++n) {
+            num_cluster_edges += graph.edges(*n).size();
+          }
+          uint64_t begin = buffer.dests.size();
+          buffer.StartCluster(num_cluster_edges);
+
+          for (const GNode* n = nodes_begin; n != nodes_end; ++n) {
             KATANA_LOG_DEBUG_ASSERT(
-                graph.template GetData<CurrentCommunityId>(*cb_ii) ==
+                graph.template GetData<CurrentCommunityId>(*n) ==
                 c);  // All nodes in this bag must have same cluster id
-
-            for (auto ii = graph.edge_begin(*cb_ii);
-                 ii != graph.edge_end(*cb_ii); ++ii) {
+            for (auto ii = graph.edge_begin(*n); ii != graph.edge_end(*n);
+                 ++ii) {
               auto dst = graph.GetEdgeDest(ii);
               auto dst_data_curr_comm_id =
                   graph.template GetData<CurrentCommunityId>(dst);
               KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
-              auto stored_already = cluster_local_map.find(
-                  dst_data_curr_comm_id);  // Check if it already exists
-              if (stored_already != cluster_local_map.end()) {
-                edges_data[c][stored_already->second] +=
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
-              } else {
-                cluster_local_map[dst_data_curr_comm_id] = num_unique_clusters;
-                edges_id[c].push_back(dst_data_curr_comm_id);
-                edges_data[c].push_back(
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii));
-                num_unique_clusters++;
-              }
+              buffer.Add(
+                  begin, dst_data_curr_comm_id,
+                  graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii));
             }  // End edge loop
           }
+
+          arena.edge_thread[c] = katana::ThreadPool::getTID();
+          arena.edge_begin[c] = begin;
+          arena.edge_offsets[c + 1] = buffer.dests.size() - begin;
         },
         katana::steal(), katana::loopname("BuildGraph: Find edges"));
 
-    /* Serial loop to reduce all the edge counts */
-    std::vector<uint64_t> prefix_edges_count(num_unique_clusters);
-    katana::GAccumulator<uint64_t> num_edges_acc;
-    katana::do_all(
-        katana::iterate((uint64_t)0, num_nodes_next), [&](uint64_t c) {
-          prefix_edges_count[c] = edges_id[c].size();
-          num_edges_acc += prefix_edges_count[c];
-        });
+    katana::ParallelSTL::partial_sum(
+        arena.edge_offsets.begin(), arena.edge_offsets.end(),
+        arena.edge_offsets.begin());
+    num_edges_next = arena.edge_offsets[num_nodes_next];
 
-    num_edges_next = num_edges_acc.reduce();
-    for (uint64_t c = 1; c < num_nodes_next; ++c) {
-      prefix_edges_count[c] += prefix_edges_count[c - 1];
-    }
-
-    KATANA_LOG_DEBUG_ASSERT(
-        prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
     katana::StatTimer TimerConstructFrom("Timer_Construct_From");
     TimerConstructFrom.start();
 
@@ -676,19 +774,23 @@ struct ClusteringImplementationBase {
       return graph_result.error();
     }
     Graph graph_curr = graph_result.value();
+    // Stream the merged edges into the CSR of the next level
     katana::do_all(
-        katana::iterate((uint64_t)0, num_nodes_next), [&](uint64_t n) {
-          out_indices_view[n] = prefix_edges_count[n];
-          uint64_t number_of_edges =
-              (n == 0) ? prefix_edges_count[0]
-                       : (prefix_edges_count[n] - prefix_edges_count[n - 1]);
-          uint64_t start_index = (n == 0) ? 0 : prefix_edges_count[n - 1];
-          for (uint32_t k = 0; k < number_of_edges; ++k) {
-            out_dests_view[start_index + k] = edges_id[n][k];
+        katana::iterate((uint64_t)0, num_nodes_next),
+        [&](uint64_t n) {
+          out_indices_view[n] = arena.edge_offsets[n + 1];
+          const CoarseningBuffer<EdgeTy>& buffer =
+              *arena.per_thread.getRemote(arena.edge_thread[n]);
+          uint64_t start_index = arena.edge_offsets[n];
+          uint64_t number_of_edges = arena.edge_offsets[n + 1] - start_index;
+          for (uint64_t k = 0; k < number_of_edges; ++k) {
+            out_dests_view[start_index + k] =
+                buffer.dests[arena.edge_begin[n] + k];
             graph_curr.template GetEdgeData<EdgeWeight<EdgeWeightType>>(
-                start_index + k) = edges_data[n][k];
+                start_index + k) = buffer.weights[arena.edge_begin[n] + k];
           }
-        });
+        },
+        katana::steal(), katana::no_stats());
 
     TimerConstructFrom.stop();
 
@@ -0,0 +1,84 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_DISTRIBUTEDPROPAGATION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_DISTRIBUTEDPROPAGATION_H_
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/MirrorSync.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+
+namespace katana::analytics {
+
+/// Propagate minimums along the out-edges of a partition in bulk synchronous
+/// rounds, the core of distributed BFS, SSSP and label propagation
+/// connected components. In each round, every node n marked in active lowers
+/// values[dst] to values[n] + weight(e) for its edges e to dst; then mirrors
+/// reduce their values into their masters by minimum and the masters that
+/// changed broadcast theirs to their mirrors. The nodes whose values changed
+/// are active in the next round, until no host has an active node.
+///
+/// values and active are by local node. Masters and mirrors must hold the
+/// same values initially, except for active masters, whose values are
+/// broadcast first.
+///
+/// \returns the number of rounds
+template <typename T, typename WeightFn>
+Result<uint64_t>
+DistributedMinPropagation(
+    const GraphTopology& topology, MirrorSync* sync,
+    LargeArray<std::atomic<T>>* values, DynamicBitset* active,
+    WeightFn weight) {
+  using Node = GraphTopology::Node;
+  auto extract = [&](Node n) { return (*values)[n].load(); };
+  auto reduce = [&](Node n, const T& value) {
+    return katana::atomicMin((*values)[n], value) > value;
+  };
+  auto set = [&](Node n, const T& value) { (*values)[n].store(value); };
+
+  if (auto r = sync->Broadcast<T>(active, extract, set); !r) {
+    return r.error();
+  }
+
+  DynamicBitset next;
+  next.resize(topology.num_nodes());
+  uint64_t rounds = 0;
+  while (sync->SumAll(active->count()) > 0) {
+    ++rounds;
+    next.reset();
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node n) {
+          if (!active->test(n)) {
+            return;
+          }
+          T value = (*values)[n].load();
+          for (auto e : topology.edges(n)) {
+            Node dst = topology.edge_dest(e);
+            T candidate = value + weight(e);
+            if (katana::atomicMin((*values)[dst], candidate) > candidate) {
+              next.set(dst);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    if (auto r = sync->Reduce<T>(&next, extract, reduce); !r) {
+      return r.error();
+    }
+    if (auto r = sync->Broadcast<T>(&next, extract, set); !r) {
+      return r.error();
+    }
+    std::swap(*active, next);
+  }
+  return rounds;
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MULTISOURCEBFS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MULTISOURCEBFS_H_
+
+#include <cstdint>
+
+#include "katana/Bag.h"
+#include "katana/LargeArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/gstl.h"
+
+namespace katana::analytics {
+
+/// Breadth-first search from up to 64 sources at once (Then et al., "The More
+/// the Merrier: Efficient Multi-Source Graph Traversal", VLDB 2015).
+///
+/// Each source owns one bit of a 64-bit mask. A node that is reached at the
+/// same distance from several sources is expanded once for all of them, so a
+/// search reads each adjacency list once per distinct distance at which its
+/// node is reached rather than once per source.
+///
+/// The result is a list of levels: level(d) holds one entry for every node
+/// that is at distance d from at least one source, together with the mask of
+/// those sources. Every (node, source) pair reachable from the source appears
+/// in exactly one level.
+///
+/// The instance can be reused for further searches on the same topology;
+/// each Run() only touches the nodes reached by the previous search.
+class KATANA_EXPORT MultiSourceBfs {
+public:
+  using Node = GraphTopology::Node;
+  using Mask = uint64_t;
+
+  static constexpr size_t kMaxSources = 64;
+
+  struct Visit {
+    Node node;
+    /// Bit i is set if node is at this distance from source i
+    Mask sources;
+  };
+  using Level = katana::InsertBag<Visit>;
+
+  explicit MultiSourceBfs(const GraphTopology& topology);
+
+  /// Search from num_sources <= kMaxSources sources; sources[i] gets bit i.
+  /// Sources may repeat.
+  void Run(const Node* sources, size_t num_sources);
+
+  /// Number of levels found by the last search, including level 0 (the
+  /// sources)
+  size_t num_levels() const { return levels_.size(); }
+
+  Level& level(size_t d) { return levels_[d]; }
+
+  /// Make marked(n) return the mask of level d for each node n in it and 0
+  /// for every other node. Only the previously marked level is cleared, so
+  /// this is proportional to the size of the two levels.
+  ///
+  /// Algorithms that carry per-source values between adjacent levels, like
+  /// Brandes' dependency accumulation, mark one level while iterating over
+  /// its neighbor.
+  void MarkLevel(size_t d);
+
+  Mask marked(Node n) const { return marks_[n]; }
+
+private:
+  const GraphTopology& topology_;
+  katana::LargeArray<Mask> seen_;
+  katana::LargeArray<Mask> next_;
+  katana::LargeArray<Mask> marks_;
+  katana::gstl::Vector<Level> levels_;
+  katana::InsertBag<Node> discovered_;
+  /// Level currently in marks_, if has_marks_
+  size_t marked_level_{0};
+  bool has_marks_{false};
+
+  void ClearMarks();
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_OUTOFCORE_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_OUTOFCORE_H_
+
+#include <cstdint>
+#include <limits>
+
+#include "katana/LargeArray.h"
+#include "katana/Result.h"
+#include "katana/SegmentedTopology.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Analytics over a SegmentedTopology, for graphs whose edges do not fit in
+/// memory. Each keeps a few bytes per node in memory and makes passes over
+/// the segments of the topology in order (see ForEachSegment), so the edges
+/// are read sequentially and at most two segments are resident at once.
+
+constexpr uint32_t kOutOfCoreUnreached = std::numeric_limits<uint32_t>::max();
+
+/// The number of hops from source to each node along out-edges, or
+/// kOutOfCoreUnreached. Each level reads only the segments with nodes in
+/// its frontier.
+KATANA_EXPORT Result<LargeArray<uint32_t>> OutOfCoreBfs(
+    SegmentedTopology* topology, uint32_t source);
+
+/// The weakly connected component of each node, named by its least node.
+/// Labels are propagated along the edges in both directions, one pass over
+/// the segments at a time, with pointer jumping between passes, until no
+/// label changes.
+KATANA_EXPORT Result<LargeArray<uint32_t>> OutOfCoreConnectedComponents(
+    SegmentedTopology* topology);
+
+struct OutOfCorePagerankPlan {
+  float alpha{0.85};
+  float tolerance{1.0e-6};
+  uint32_t max_iterations{100};
+};
+
+/// PageRank by pushing the rank of each node along its out-edges, one pass
+/// over the segments per iteration. The rank of nodes without out-edges is
+/// spread over all nodes. The ranks sum to 1; iterations stop when the sum
+/// of the changes of all ranks is below plan.tolerance.
+KATANA_EXPORT Result<LargeArray<float>> OutOfCorePagerank(
+    SegmentedTopology* topology,
+    const OutOfCorePagerankPlan& plan = OutOfCorePagerankPlan());
+
+}  // namespace katana::analytics
+
+#endif
@@ -3,6 +3,11 @@
 
 namespace katana::analytics {
 
+/// The architecture a plan runs an analytic on. Every analytic implements
+/// kCPU and some also kDistributedCPU; none implements kGPU or
+/// kDistributedGPU yet. An analytic fails with ErrorCode::FeatureNotEnabled
+/// for a plan of an architecture it has no implementation for (see
+/// CheckArchitecture).
 enum Architecture {
   /// Local execution using CPUs only
   kCPU,
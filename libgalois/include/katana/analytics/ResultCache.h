@@ -0,0 +1,58 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_RESULTCACHE_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_RESULTCACHE_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// What the result of an analytic depends on, besides the topology of the
+/// graph
+struct AnalyticSignature {
+  /// Names the analytic and all of its parameters, including its plan,
+  /// e.g., "ConnectedComponents/Afforest/edge_tile_size:512"
+  std::string analytic;
+  /// The node and edge properties the analytic reads
+  std::vector<std::string> node_properties;
+  std::vector<std::string> edge_properties;
+};
+
+/// Compute the node property output_property_name of pg with compute,
+/// unless pg already stores it as computed by an analytic of the same
+/// signature from the same stored topology and input properties.
+///
+/// On success, the output is recorded as derived from the signature and
+/// the stored version of the inputs (see PropertyGraph::StoredVersion) and
+/// is committed to the RDG of pg with command_line, so that later calls,
+/// e.g., by other jobs that load a later version of the RDG, return it
+/// without recomputing it:
+///
+///     katana::analytics::AnalyticSignature signature{
+///         .analytic = fmt::format(
+///             "ConnectedComponents/{}/{}", plan.algorithm(),
+///             plan.edge_tile_size())};
+///     auto res = katana::analytics::MemoizeNodeProperty(
+///         pg, signature, "component", command_line, [&]() {
+///           return katana::analytics::ConnectedComponents(
+///               pg, "component", plan);
+///         });
+///
+/// An output derived from another signature or from other inputs is
+/// removed before computing it again. If the topology or an input is not
+/// stored as it is, e.g., because pg was not loaded from storage, the
+/// result cannot be identified later and is only computed.
+///
+/// \returns true if the stored output was reused
+KATANA_EXPORT Result<bool> MemoizeNodeProperty(
+    PropertyGraph* pg, const AnalyticSignature& signature,
+    const std::string& output_property_name, const std::string& command_line,
+    const std::function<Result<void>()>& compute);
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SHAREDSCAN_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_SHAREDSCAN_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "katana/EdgeBalancedRange.h"
+#include "katana/Galois.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Run several pull-style analytics in one pass over the edges per
+/// iteration, so that they share the read of the topology instead of each
+/// streaming it from memory.
+///
+/// Each kernel is the per-edge part of an analytic. In every iteration, each
+/// node starts a NodeState for each kernel, visits its out-edges once,
+/// passing each edge to every kernel, and finishes each state:
+///
+///     struct Kernel {
+///       using NodeState = ...;  // e.g., a sum; default constructible
+///       /// Serially, before iteration (counting from 0); false once done
+///       bool BeginIteration(uint32_t iteration);
+///       NodeState Start(Node n) const;
+///       /// Concurrently for the edges of distinct nodes
+///       void Visit(NodeState* state, Edge e, Node dst) const;
+///       /// Concurrently for distinct nodes; may write to n only
+///       void Finish(Node n, const NodeState& state);
+///       /// Serially, after an iteration that the kernel took part in
+///       void EndIteration();
+///     };
+///
+/// Kernels that are done no longer visit edges, and the scan stops once all
+/// of them are done. Kernels only read what they wrote in earlier
+/// iterations, so their results are those of running them one by one.
+///
+///     katana::analytics::DegreeKernel degrees(topology);
+///     katana::analytics::LabelPropagationKernel components(topology);
+///     katana::analytics::RunSharedScan(topology, degrees, components);
+///
+/// \returns the number of iterations
+template <typename... Kernels>
+uint32_t RunSharedScan(const GraphTopology& topology, Kernels&... kernels);
+
+/// The degree of each node and the largest degree, in one iteration
+class KATANA_EXPORT DegreeKernel {
+public:
+  using NodeState = uint64_t;
+
+  explicit DegreeKernel(const GraphTopology& topology);
+
+  bool BeginIteration(uint32_t iteration) { return iteration == 0; }
+  NodeState Start(GraphTopology::Node) const { return 0; }
+  void Visit(NodeState* degree, GraphTopology::Edge, GraphTopology::Node)
+      const {
+    *degree += 1;
+  }
+  void Finish(GraphTopology::Node n, const NodeState& degree) {
+    degrees_[n] = degree;
+    max_degree_.update(degree);
+  }
+  void EndIteration() {}
+
+  const std::vector<uint64_t>& degrees() const { return degrees_; }
+  uint64_t max_degree() { return max_degree_.reduce(); }
+
+private:
+  std::vector<uint64_t> degrees_;
+  GReduceMax<uint64_t> max_degree_;
+};
+
+/// PageRank like PagerankPlan::PullTopological: the graph is the transpose
+/// of the graph to rank, so each node pulls the rank of the destinations of
+/// its edges, divided by their number of in-edges in the transpose
+class KATANA_EXPORT PagerankKernel {
+public:
+  using NodeState = float;
+
+  PagerankKernel(
+      const GraphTopology& topology,
+      PagerankPlan plan = PagerankPlan::PullTopological());
+
+  bool BeginIteration(uint32_t iteration);
+  NodeState Start(GraphTopology::Node) const { return 0; }
+  void Visit(NodeState* sum, GraphTopology::Edge, GraphTopology::Node dst)
+      const {
+    *sum += contributions_[dst];
+  }
+  void Finish(GraphTopology::Node n, const NodeState& sum) {
+    float rank = sum * plan_.alpha() + base_score_;
+    delta_ += std::fabs(rank - ranks_[n]);
+    ranks_[n] = rank;
+  }
+  void EndIteration();
+
+  const std::vector<float>& ranks() const { return ranks_; }
+
+private:
+  PagerankPlan plan_;
+  float base_score_;
+  std::vector<float> ranks_;
+  std::vector<uint32_t> out_degrees_;
+  std::vector<float> contributions_;
+  GAccumulator<float> delta_;
+  bool converged_{false};
+};
+
+/// Connected components of a symmetric graph by label propagation: each
+/// node takes the smallest label among its own and those of its neighbors
+/// until no label changes. A component is labeled by its smallest node.
+class KATANA_EXPORT LabelPropagationKernel {
+public:
+  using NodeState = uint64_t;
+
+  explicit LabelPropagationKernel(const GraphTopology& topology);
+
+  bool BeginIteration(uint32_t) { return changed_; }
+  NodeState Start(GraphTopology::Node n) const { return labels_[n]; }
+  void Visit(NodeState* label, GraphTopology::Edge, GraphTopology::Node dst)
+      const {
+    *label = std::min(*label, labels_[dst]);
+  }
+  void Finish(GraphTopology::Node n, const NodeState& label) {
+    if (label < labels_[n]) {
+      num_changed_ += 1;
+    }
+    next_labels_[n] = label;
+  }
+  void EndIteration();
+
+  const std::vector<uint64_t>& labels() const { return labels_; }
+
+private:
+  /// Labels are double buffered so that an iteration only reads the labels
+  /// of the previous one
+  std::vector<uint64_t> labels_;
+  std::vector<uint64_t> next_labels_;
+  GAccumulator<uint64_t> num_changed_;
+  bool changed_{true};
+};
+
+/// The mean of a value per node over the destinations of the edges of each
+/// node, like NeighborAggregationPlan::Mean of out-neighbors for a single
+/// feature, in one iteration. Nodes without edges get 0.
+class KATANA_EXPORT NeighborMeanKernel {
+public:
+  struct NodeState {
+    double sum{0};
+    uint64_t count{0};
+  };
+
+  explicit NeighborMeanKernel(std::vector<double> values);
+
+  bool BeginIteration(uint32_t iteration) { return iteration == 0; }
+  NodeState Start(GraphTopology::Node) const { return NodeState{}; }
+  void Visit(NodeState* state, GraphTopology::Edge, GraphTopology::Node dst)
+      const {
+    state->sum += values_[dst];
+    state->count += 1;
+  }
+  void Finish(GraphTopology::Node n, const NodeState& state) {
+    means_[n] = state.count > 0 ? state.sum / state.count : 0;
+  }
+  void EndIteration() {}
+
+  const std::vector<double>& means() const { return means_; }
+
+private:
+  std::vector<double> values_;
+  std::vector<double> means_;
+};
+
+namespace internal {
+
+template <typename... Kernels, size_t... I>
+void
+SharedScanNode(
+    const GraphTopology& topology, GraphTopology::Node n,
+    const std::array<bool, sizeof...(Kernels)>& active,
+    std::index_sequence<I...>, Kernels&... kernels) {
+  std::tuple<typename Kernels::NodeState...> states;
+  ((active[I] ? void(std::get<I>(states) = kernels.Start(n)) : void()), ...);
+  for (auto e : topology.edges(n)) {
+    auto dst = topology.edge_dest(e);
+    ((active[I] ? kernels.Visit(&std::get<I>(states), e, dst) : void()),
+     ...);
+  }
+  ((active[I] ? kernels.Finish(n, std::get<I>(states)) : void()), ...);
+}
+
+}  // namespace internal
+
+template <typename... Kernels>
+uint32_t
+RunSharedScan(const GraphTopology& topology, Kernels&... kernels) {
+  constexpr size_t kNumKernels = sizeof...(Kernels);
+  for (uint32_t iteration = 0;; ++iteration) {
+    // Braced initialization calls BeginIteration in order
+    std::array<bool, kNumKernels> active{kernels.BeginIteration(iteration)...};
+    if (std::none_of(active.begin(), active.end(), [](bool a) { return a; })) {
+      return iteration;
+    }
+
+    do_all(
+        iterate_edge_balanced(topology),
+        [&](GraphTopology::Node n) {
+          internal::SharedScanNode(
+              topology, n, active, std::index_sequence_for<Kernels...>(),
+              kernels...);
+        },
+        steal(), no_stats(), loopname("SharedScan"));
+
+    size_t k = 0;
+    ((active[k++] ? kernels.EndIteration() : void()), ...);
+  }
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SPARSIFY_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_SPARSIFY_H_
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/analytics/Plan.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// A plan for sparsifying a graph: sampling a fraction of its edges into a
+/// smaller graph on which analytics run at a fraction of the cost, for
+/// approximate answers (see, e.g., ApproximatePagerank).
+///
+/// A sparsified graph keeps every node of the original, with the same ids,
+/// so the node properties computed on it describe the original nodes. Edge
+/// sampling decides each edge by a hash of its unordered endpoints, so the
+/// sample of a symmetric graph is symmetric.
+class SparsifyPlan : public Plan {
+public:
+  enum Algorithm {
+    kUniformEdge,
+    kDegreeBiasedEdge,
+    kForestFire,
+    kSpectral,
+  };
+
+  static constexpr double kDefaultEdgeFraction = 0.1;
+  static constexpr double kDefaultBurnProbability = 0.7;
+  static constexpr uint64_t kDefaultSeed = 0;
+
+private:
+  Algorithm algorithm_;
+  double edge_fraction_;
+  double burn_probability_;
+  uint64_t seed_;
+
+  SparsifyPlan(
+      Architecture architecture, Algorithm algorithm, double edge_fraction,
+      double burn_probability, uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        edge_fraction_(edge_fraction),
+        burn_probability_(burn_probability),
+        seed_(seed) {}
+
+public:
+  SparsifyPlan() : SparsifyPlan{UniformEdge()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The fraction of the edges to keep, in (0, 1]
+  double edge_fraction() const { return edge_fraction_; }
+  /// The probability with which a forest fire keeps spreading from a node
+  double burn_probability() const { return burn_probability_; }
+  uint64_t seed() const { return seed_; }
+
+  /// Keep each edge with probability edge_fraction.
+  static SparsifyPlan UniformEdge(
+      double edge_fraction = kDefaultEdgeFraction,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU, kUniformEdge, edge_fraction, 0, seed};
+  }
+
+  /// Keep the edge (u, v) with probability proportional to deg(u) +
+  /// deg(v), capped at 1, which keeps the edges around hubs and so the
+  /// paths that carry most of the rank in Page Rank.
+  static SparsifyPlan DegreeBiasedEdge(
+      double edge_fraction = kDefaultEdgeFraction,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU, kDegreeBiasedEdge, edge_fraction, 0, seed};
+  }
+
+  /// Keep the subgraph induced by the nodes burned by forest fires
+  /// (Leskovec and Faloutsos, "Sampling from Large Graphs", KDD 2006). A
+  /// fire starts at a random node and spreads from each node it burns to a
+  /// geometrically distributed number of its unburned neighbors, with mean
+  /// burn_probability / (1 - burn_probability). Fires run in parallel, in
+  /// rounds, until their induced subgraph has about edge_fraction of the
+  /// edges. The sample keeps dense local neighborhoods, and so triangles
+  /// and clustering.
+  static SparsifyPlan ForestFire(
+      double edge_fraction = kDefaultEdgeFraction,
+      double burn_probability = kDefaultBurnProbability,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU, kForestFire, edge_fraction, burn_probability, seed};
+  }
+
+  /// Keep the edge (u, v) with probability proportional to 1 / deg(u) + 1
+  /// / deg(v), capped at 1. This bounds the effective resistance of the
+  /// edge, by which spectral sparsifiers sample (Spielman and Srivastava,
+  /// "Graph Sparsification by Effective Resistances", STOC 2008), without
+  /// solving for it: bridges and the edges of low degree nodes, which hold
+  /// the graph together, are kept, and the edges among hubs thinned.
+  static SparsifyPlan Spectral(
+      double edge_fraction = kDefaultEdgeFraction,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU, kSpectral, edge_fraction, 0, seed};
+  }
+};
+
+/// A graph sparsified by Sparsify
+struct KATANA_EXPORT SparsifiedGraph {
+  /// The name of the edge property of graph holding the inverse of the
+  /// probability with which each edge was kept, as a double, by which sums
+  /// over the sampled edges scale to unbiased (Horvitz-Thompson) estimates
+  /// of sums over the original edges
+  static constexpr const char* kWeightProperty = "katana.sample_weight";
+
+  std::unique_ptr<PropertyGraph> graph;
+  /// The number of edges of graph over the number of the original
+  double edge_fraction;
+
+  /// The factor by which an edge count of graph scales to an estimate of
+  /// the count of the original
+  double edge_scale() const {
+    return edge_fraction > 0 ? 1 / edge_fraction : 0;
+  }
+};
+
+/// Sample the edges of pg into a new in-memory graph on the same nodes. The
+/// node properties of node_properties are shared with the new graph,
+/// without a copy, and the edge properties of edge_properties copied for
+/// the edges kept.
+KATANA_EXPORT Result<SparsifiedGraph> Sparsify(
+    PropertyGraph* pg, SparsifyPlan plan = {},
+    const std::vector<std::string>& node_properties = {},
+    const std::vector<std::string>& edge_properties = {});
+
+/// The accuracy of an analytic computed on a sparsified graph
+struct KATANA_EXPORT ApproximationStatistics {
+  /// The number of edges the analytic ran on
+  uint64_t sample_edges;
+  /// The fraction of the edges of the graph the analytic ran on
+  double edge_fraction;
+  /// An estimate of the error of the result; what it measures is given by
+  /// each approximate analytic
+  double estimated_error;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+}  // namespace katana::analytics
+
+#endif
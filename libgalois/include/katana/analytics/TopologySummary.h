@@ -0,0 +1,65 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_TOPOLOGYSUMMARY_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_TOPOLOGYSUMMARY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace tsuba {
+class RDGPrefix;
+}  // namespace tsuba
+
+namespace katana::analytics {
+
+/// The degree distribution and size of a graph, computed from the out
+/// indices of its topology alone (see tsuba::RDGPrefix), so that a job can
+/// be sized and planned before loading the edges or properties of the
+/// graph. Plans that tune themselves to a graph can also be made from a
+/// summary, e.g., SsspPlan and TriangleCountPlan.
+struct KATANA_EXPORT TopologySummary {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  uint64_t max_degree{0};
+  uint64_t num_isolated_nodes{0};
+  double average_degree{0};
+  /// The median degree of a random sample of the nodes with edges
+  uint64_t sample_median_degree{0};
+  /// degree_histogram[0] is the number of nodes without edges, and
+  /// degree_histogram[i] for i > 0 the number with a degree in [2^(i - 1),
+  /// 2^i)
+  std::vector<uint64_t> degree_histogram;
+  /// As IsApproximateDegreeDistributionPowerLaw
+  bool power_law{false};
+
+  /// The bytes of the topology once loaded: 64-bit indices and 32-bit
+  /// destinations
+  uint64_t topology_bytes() const {
+    return num_nodes * sizeof(uint64_t) + num_edges * sizeof(uint32_t);
+  }
+
+  /// The bytes of the graph once loaded with properties of the given bytes
+  /// per node and per edge
+  uint64_t EstimatedBytes(
+      uint64_t node_property_bytes = 0,
+      uint64_t edge_property_bytes = 0) const {
+    return topology_bytes() + num_nodes * node_property_bytes +
+           num_edges * edge_property_bytes;
+  }
+
+  /// Summarize the topology of the RDG rdg_name, of one partition, reading
+  /// only the header and out indices of its topology
+  static Result<TopologySummary> Make(const std::string& rdg_name);
+
+  static Result<TopologySummary> Make(const tsuba::RDGPrefix& prefix);
+
+  /// Summarize out_indices, the end of the edges of each node in turn
+  static TopologySummary Make(
+      const uint64_t* out_indices, uint64_t num_nodes, uint64_t num_edges);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,6 +2,7 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_UTILS_H_
 
 #include <algorithm>
+#include <initializer_list>
 #include <random>
 #include <utility>
 
@@ -9,6 +10,7 @@
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
 #include "katana/Result.h"
+#include "katana/analytics/Plan.h"
 
 namespace katana::analytics {
 
@@ -34,6 +36,29 @@ public:
 KATANA_EXPORT bool IsApproximateDegreeDistributionPowerLaw(
     const PropertyGraph& graph);
 
+/// Read the numeric edge property edge_weight_property_name as doubles,
+/// indexed by edge. Fails unless every weight is finite and not negative.
+KATANA_EXPORT Result<std::vector<double>> NonNegativeEdgeWeights(
+    PropertyGraph* pg, const std::string& edge_weight_property_name);
+
+/// \returns an error unless the architecture of plan is one of implemented,
+///     those the analytic has an implementation for. Analytics check their
+///     plans with it so that, e.g., a distributed plan for an analytic that
+///     only runs locally fails rather than runs on one host.
+inline Result<void>
+CheckArchitecture(
+    const Plan& plan,
+    std::initializer_list<Architecture> implemented = {kCPU}) {
+  if (std::find(implemented.begin(), implemented.end(), plan.architecture()) ==
+      implemented.end()) {
+    return KATANA_ERROR(
+        ErrorCode::FeatureNotEnabled,
+        "no implementation for architecture {}",
+        static_cast<int>(plan.architecture()));
+  }
+  return ResultSuccess();
+}
+
 template <typename Props>
 std::vector<std::string>
 DefaultPropertyNames() {
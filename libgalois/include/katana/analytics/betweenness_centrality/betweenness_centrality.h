@@ -18,23 +18,31 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
-    // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
-    // kAsynchronous,
+    kMultiSource,
+    kAsynchronous,
+    // TODO(gill): Reinstate auto now that async is back.
     // kAutomatic,
   };
 
+  static const uint32_t kDefaultSourcesPerBatch = 64;
+
 private:
   Algorithm algorithm_;
+  uint32_t sources_per_batch_;
 
-  BetweennessCentralityPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+  BetweennessCentralityPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t sources_per_batch = kDefaultSourcesPerBatch)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        sources_per_batch_(sources_per_batch) {}
 
 public:
   BetweennessCentralityPlan() : BetweennessCentralityPlan{kCPU, kLevel} {}
 
   BetweennessCentralityPlan(const katana::PropertyGraph* pg [[maybe_unused]])
       : BetweennessCentralityPlan() {
-    // TODO(gill): Reinstate automation once we reinstate async
+    // TODO(gill): Reinstate automation
     // if (algo == AutoAlgo) {
     //   katana::FileGraph degreeGraph;
     //   degreeGraph.fromFile(inputFile);
@@ -50,11 +58,34 @@ public:
   }
 
   Algorithm algorithm() const { return algorithm_; }
+  /// Number of sources searched together by kMultiSource; at most 64
+  uint32_t sources_per_batch() const { return sources_per_batch_; }
 
   static BetweennessCentralityPlan Level() { return {kCPU, kLevel}; }
 
+  /// Search from one source per thread at a time. The state of a search
+  /// covers the nodes it visited alone, indexed by a hash table until it
+  /// reaches an eighth of the graph, so a thread uses at most about 16 bytes
+  /// per node, and much less if its searches reach few nodes.
   static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
 
+  /// Process sources in batches with one bit-parallel BFS per batch (see
+  /// MultiSourceBfs), reading the graph once per batch instead of once per
+  /// source. Uses 8 * sources_per_batch bytes per node for path counts and
+  /// dependencies, and the in-edge index of the graph.
+  static BetweennessCentralityPlan MultiSource(
+      uint32_t sources_per_batch = kDefaultSourcesPerBatch) {
+    return {kCPU, kMultiSource, sources_per_batch};
+  }
+
+  /// Build the shortest path DAG of each source asynchronously with an
+  /// ordered worklist and propagate dependencies as soon as they are ready,
+  /// without per-level barriers. Best on high-diameter graphs. Uses the
+  /// in-edge index of the graph.
+  static BetweennessCentralityPlan Asynchronous() {
+    return {kCPU, kAsynchronous};
+  }
+
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
     return BetweennessCentralityPlan(kCPU, algo);
   }
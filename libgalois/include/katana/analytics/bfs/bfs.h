@@ -1,8 +1,13 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_BFS_BFS_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_BFS_BFS_H_
 
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
 
+#include "katana/TemporalWindow.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -65,9 +70,17 @@ public:
 
   static BfsPlan Synchronous() { return {kCPU, kSynchronous, 0}; }
 
+  /// Direction-optimizing BFS over the in-edge index of the graph (see
+  /// PropertyGraph::GetInEdgeIndex). alpha and beta are where the search
+  /// starts; it adapts alpha to the edges its bottom-up steps examine.
   static BfsPlan SynchronousDirectOpt(uint32_t alpha, uint32_t beta) {
     return {kCPU, kSynchronousDirectOpt, 0, alpha, beta};
   }
+
+  /// Synchronous BFS on a partition of a graph partitioned across the hosts
+  /// of the job (see MirrorSync), with the start node given by its id in
+  /// the RDG. Every host calls Bfs on its partition.
+  static BfsPlan Distributed() { return {kDistributedCPU, kSynchronous, 0}; }
 };
 
 /// Compute BFS level of nodes in the graph pg starting from start_node. The
@@ -79,6 +92,34 @@ KATANA_EXPORT Result<void> Bfs(
     PropertyGraph* pg, size_t start_node,
     const std::string& output_property_name, BfsPlan algo = {});
 
+/// Compute the BFS level of the nodes of the graph of window from start_node
+/// over the edges of window alone, without copying the graph, by a
+/// level-synchronous search. Nodes that are not reached get the same level
+/// as in Bfs. The property named output_property_name is created on
+/// window.graph() by this function and may not exist before the call.
+KATANA_EXPORT Result<void> Bfs(
+    const TemporalWindow& window, size_t start_node,
+    const std::string& output_property_name);
+
+/// The level BfsMultiSource gives nodes that a source does not reach; the
+/// same as that of Bfs.
+constexpr uint32_t kBfsMultiSourceInfinity =
+    std::numeric_limits<uint32_t>::max() / 4;
+
+/// Compute the BFS level of every node from each of sources at once. The
+/// result is stored in a property named by output_property_name: a fixed-size
+/// list of sources.size() uint32_t per node, whose element i is the level
+/// from sources[i] or kBfsMultiSourceInfinity.
+///
+/// The search is bit-parallel (see MultiSourceBfs): each adjacency list is
+/// read once per batch of 64 sources and distinct level at which the node is
+/// reached, rather than once per source, and the output is allocated once.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> BfsMultiSource(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& output_property_name);
+
 /// Do a quick validation of the results of a BFS computation where the results
 /// are stored in property_name. This function does not do an exhaustive check.
 /// The results are approximate and may have false-negatives.
@@ -0,0 +1,97 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for bipartite matching, specifying the algorithm and
+/// any parameters associated with it.
+class BipartiteMatchingPlan : public Plan {
+public:
+  enum Algorithm {
+    kPothenFan,
+    kAuction,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  BipartiteMatchingPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  BipartiteMatchingPlan() : BipartiteMatchingPlan{PothenFan()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Parallel depth-first search for augmenting paths with lookahead and
+  /// fairness, as in Azad et al. In each phase every unmatched left node
+  /// searches in parallel for an augmenting path, and the searches claim the
+  /// right nodes they visit so their paths are disjoint. Visited marks are
+  /// stamped with the phase number, so they are never cleared. Phases end
+  /// when one finds no path. Maximum cardinality only.
+  static BipartiteMatchingPlan PothenFan() { return {kCPU, kPothenFan}; }
+
+  /// The auction algorithm of Bertsekas with epsilon scaling. In each round
+  /// all unassigned nodes bid in parallel for their best offer, and each
+  /// offer goes to its highest bidder. Weights are scaled so that the final
+  /// round, with an increment of one, gives an exact maximum weight
+  /// matching.
+  static BipartiteMatchingPlan Auction() { return {kCPU, kAuction}; }
+};
+
+/// Compute a maximum cardinality matching of the bipartite graph pg, whose
+/// edges all go from a node on the left to a node on the right; a node may
+/// not have both in- and out-edges. The edges in the matching are marked
+/// true in the boolean edge property named output_property_name.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> BipartiteMatching(
+    PropertyGraph* pg, const std::string& output_property_name,
+    BipartiteMatchingPlan plan = {});
+
+/// Compute a maximum weight matching of the bipartite graph pg, as
+/// BipartiteMatching does for cardinality. The weight of each edge is taken
+/// from the edge property named edge_weight_property_name, which may be a 32-
+/// or 64-bit signed or unsigned int. Edges of negative weight are never
+/// matched. Only the auction algorithm supports weights.
+KATANA_EXPORT Result<void> WeightedBipartiteMatching(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    BipartiteMatchingPlan plan = BipartiteMatchingPlan::Auction());
+
+/// Check that output_property_name is a matching with no augmenting path.
+KATANA_EXPORT Result<void> BipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+/// Check that output_property_name is a matching with the weight of one found
+/// serially by successive shortest paths.
+KATANA_EXPORT Result<void> WeightedBipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT BipartiteMatchingStatistics {
+  /// The number of edges in the matching.
+  uint64_t n_matched_edges;
+  /// The number of nodes with out-edges.
+  uint64_t n_left_nodes;
+  /// The number of nodes with in-edges.
+  uint64_t n_right_nodes;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<BipartiteMatchingStatistics> Compute(
+      PropertyGraph* pg, const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,8 +2,13 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_CONNECTEDCOMPONENTS_CONNECTEDCOMPONENTS_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/GraphView.h"
+#include "katana/TemporalWindow.h"
+#include "katana/analytics/Autotune.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -26,7 +31,8 @@ public:
     kBlockedAsynchronous,
     kAfforest,
     kEdgeAfforest,
-    kEdgeTiledAfforest
+    kEdgeTiledAfforest,
+    kAfforestCompact
   };
 
   static const ptrdiff_t kDefaultEdgeTileSize = 512;
@@ -76,6 +82,14 @@ public:
     return {kCPU, kLabelProp, 0, 0, 0};
   }
 
+  /// Label propagation on a partition of a graph partitioned across the
+  /// hosts of the job (see MirrorSync). Components are labeled by the least
+  /// id in the RDG of their nodes. Every host calls ConnectedComponents on
+  /// its partition.
+  static ConnectedComponentsPlan Distributed() {
+    return {kDistributedCPU, kLabelProp, 0, 0, 0};
+  }
+
   /// Synchronous connected components algorithm.  Initially all nodes are in
   /// their own component. Then, we merge endpoints of edges to form the spanning
   /// tree. Merging is done in two phases to simplify concurrent updates: (1)
@@ -148,6 +162,19 @@ public:
         kCPU, kEdgeAfforest, edge_tile_size, neighbor_sample_size,
         component_sample_frequency};
   }
+
+  /// Afforest sampling on a flat array of 32-bit parent node ids instead of a
+  /// union-find node per graph node. Roots are hooked with compare-and-swap
+  /// toward the lesser node id. It takes half the memory of Afforest and has
+  /// one indirection less per find. Components are labeled by the least node
+  /// id in them.
+  static ConnectedComponentsPlan AfforestCompact(
+      uint32_t neighbor_sample_size = kDefaultNeighborSampleSize,
+      uint32_t component_sample_frequency = kDefaultComponentSampleFrequency) {
+    return {
+        kCPU, kAfforestCompact, 0, neighbor_sample_size,
+        component_sample_frequency};
+  }
 };
 
 /// Compute the Connected-components for pg. The pg is expected to be
@@ -161,6 +188,61 @@ KATANA_EXPORT Result<void> ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
     ConnectedComponentsPlan plan = ConnectedComponentsPlan());
 
+/// The plans of the parallel ConnectedComponents algorithms with their
+/// default parameters and, for the tiled ones, a range of tile sizes
+KATANA_EXPORT std::vector<PlanCandidate<ConnectedComponentsPlan>>
+ConnectedComponentsCandidates();
+
+/// \returns the fastest of ConnectedComponentsCandidates() for pg, by
+///     Autotune on a sample of pg
+KATANA_EXPORT Result<ConnectedComponentsPlan> AutotuneConnectedComponents(
+    PropertyGraph* pg, const AutotuneOptions& options = {});
+
+/// Approximate the connected components of pg, which must be symmetric, by
+/// computing them with plan on the sparsification of pg by sparsify_plan,
+/// which keeps all the nodes. The sample of a symmetric graph is
+/// symmetric, and each of its components lies within a component of pg, so
+/// components may be split but are never merged. The component of each node
+/// is stored in the new node property output_property_name of pg.
+///
+/// The estimated_error of the returned statistics is the fraction of the
+/// edges of pg whose endpoints are in different components, counted in one
+/// pass over the edges; it is 0 if and only if the components are exact.
+KATANA_EXPORT Result<ApproximationStatistics> ApproximateConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    SparsifyPlan sparsify_plan = {},
+    ConnectedComponentsPlan plan = ConnectedComponentsPlan());
+
+/// Compute the connected components of the nodes of view over the edges of
+/// view alone, which are expected to be symmetric, without copying the
+/// graph. Each node in the view is labeled with the least node of its
+/// component and each node not in it with itself. The property named
+/// output_property_name is created on view.graph() by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> ConnectedComponents(
+    const GraphView& view, const std::string& output_property_name);
+
+/// Compute the connected components of the graph of window over the edges
+/// of window alone, treating them as undirected, like the GraphView
+/// overload; e.g., the components of the edges of the last week.
+KATANA_EXPORT Result<void> ConnectedComponents(
+    const TemporalWindow& window, const std::string& output_property_name);
+
+/// Update the components computed by ConnectedComponents after edges were
+/// inserted into the graph, without recomputing them from scratch.
+///
+/// property_name holds the components of the graph before the insertions
+/// and is updated in place; inserted_edges are the (source, destination)
+/// pairs of the inserted edges. The nodes of the graph must not have
+/// changed. The components joined by the batch are merged with a union-find
+/// over only the labels of the endpoints of the batch, and each merged
+/// component takes the least of its labels. Relabeling then takes one
+/// parallel pass over the nodes, which is skipped when the batch joins no
+/// components.
+KATANA_EXPORT Result<void> ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges);
+
 KATANA_EXPORT Result<void> ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
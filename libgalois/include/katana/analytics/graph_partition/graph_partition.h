@@ -0,0 +1,167 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHPARTITION_GRAPHPARTITION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHPARTITION_GRAPHPARTITION_H_
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+#include "tsuba/PartitionMetadata.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for graph partitioning, specifying the algorithm and
+/// any parameters associated with it.
+class GraphPartitionPlan : public Plan {
+public:
+  enum Algorithm {
+    kMultilevel,
+  };
+
+  static constexpr double kDefaultImbalance = 0.03;
+  static const uint32_t kDefaultRefinementPasses = 4;
+  static const uint32_t kDefaultCoarsestNodesPerPartition = 20;
+
+private:
+  Algorithm algorithm_;
+  double imbalance_;
+  uint32_t refinement_passes_;
+  uint32_t coarsest_nodes_per_partition_;
+
+  GraphPartitionPlan(
+      Architecture architecture, Algorithm algorithm, double imbalance,
+      uint32_t refinement_passes, uint32_t coarsest_nodes_per_partition)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        imbalance_(imbalance),
+        refinement_passes_(refinement_passes),
+        coarsest_nodes_per_partition_(coarsest_nodes_per_partition) {}
+
+public:
+  GraphPartitionPlan() : GraphPartitionPlan{Multilevel()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The fraction by which a partition may exceed the average partition
+  /// size.
+  double imbalance() const { return imbalance_; }
+  /// The number of refinement passes run at each level of the hierarchy.
+  uint32_t refinement_passes() const { return refinement_passes_; }
+  /// Stop coarsening once the graph has at most this many nodes per
+  /// partition.
+  uint32_t coarsest_nodes_per_partition() const {
+    return coarsest_nodes_per_partition_;
+  }
+
+  /// Multilevel k-way partitioning in the style of METIS, over the
+  /// undirected graph of pg with parallel edges merged into weighted ones.
+  /// The graph is coarsened by heavy edge matching, where every node
+  /// proposes to its heaviest unmatched neighbor and mutual proposals are
+  /// matched, until it is small; the coarsest graph is partitioned by greedy
+  /// graph growing, and the partition is projected back one level at a time
+  /// and refined at each by moving boundary nodes to the partition they are
+  /// most connected to. Moves alternate between going to higher and lower
+  /// numbered partitions, so neighbors never swap partitions in the same
+  /// step, and never make a partition heavier than the imbalance allows.
+  static GraphPartitionPlan Multilevel(
+      double imbalance = kDefaultImbalance,
+      uint32_t refinement_passes = kDefaultRefinementPasses,
+      uint32_t coarsest_nodes_per_partition =
+          kDefaultCoarsestNodesPerPartition) {
+    return {
+        kCPU, kMultilevel, imbalance, refinement_passes,
+        coarsest_nodes_per_partition};
+  }
+};
+
+/// Partition the nodes of pg into num_partitions parts of about the same
+/// size with few edges between them, treating every edge as undirected. The
+/// partition of each node is stored as a uint32 in the node property named
+/// output_property_name, which is created by this function and may not exist
+/// before the call.
+KATANA_EXPORT Result<void> GraphPartition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, GraphPartitionPlan plan = {});
+
+/// Check that every node is in one of the num_partitions partitions.
+KATANA_EXPORT Result<void> GraphPartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT GraphPartitionStatistics {
+  /// The number of partitions, one more than the largest partition id.
+  uint64_t n_partitions;
+  /// The number of edges between nodes of different partitions.
+  uint64_t edge_cut;
+  /// The number of nodes in the largest partition.
+  uint64_t max_partition_size;
+  /// The number of nodes in the smallest partition.
+  uint64_t min_partition_size;
+  /// The ratio of the largest partition size to the average one, minus one.
+  double imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<GraphPartitionStatistics> Compute(
+      PropertyGraph* pg, const std::string& output_property_name);
+};
+
+/// How the edges of a partitioned graph are assigned to hosts. The values
+/// are the policy_id of tsuba::PartitionMetadata, for which zero means the
+/// graph is not partitioned.
+enum class PartitionLayoutPolicy : uint32_t {
+  /// Each host owns the out-edges of its nodes.
+  kOutgoingEdgeCut = 1,
+  /// Each host owns the in-edges of its nodes.
+  kIncomingEdgeCut = 2,
+  /// The edges into a node of in-degree at most the threshold are owned by
+  /// the host of the node, and other edges by the host of their source, as
+  /// in the hybrid cut of PowerLyra, so the edges of hubs are spread over
+  /// the hosts of their neighbors.
+  kHybridVertexCut = 3,
+  /// The edges go to a grid of hosts, by the row of the host of their
+  /// source and the column of the host of their destination; made by
+  /// katana::PartitionLoader, not ComputePartitionLayout.
+  kCartesianVertexCut = 4,
+};
+
+/// The partition of one host, in the form tsuba::RDG stores it. The local
+/// nodes of the host are its masters, the nodes of its partition in the
+/// order of their ids, followed by its mirrors, the other endpoints of its
+/// edges. Global node ids number the nodes of partition 0 first, then those
+/// of partition 1, and so on; global edge ids likewise number the edges of
+/// host 0 first.
+struct KATANA_EXPORT PartitionLayout {
+  tsuba::PartitionMetadata metadata;
+  /// master_nodes[h] holds the uint32 local ids of the masters that have a
+  /// mirror on host h, and is empty for this host.
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> master_nodes;
+  /// mirror_nodes[h] holds the uint32 local ids of the mirrors whose master
+  /// is on host h, and is empty for this host.
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> mirror_nodes;
+  /// For each host, the first and one past the last global node id it owns.
+  std::shared_ptr<arrow::ChunkedArray> host_to_owned_global_node_ids;
+  /// For each host, the first and one past the last global edge id it owns.
+  std::shared_ptr<arrow::ChunkedArray> host_to_owned_global_edge_ids;
+  /// The node id in pg of each local node.
+  std::shared_ptr<arrow::ChunkedArray> local_to_user_id;
+  /// The global node id of each local node.
+  std::shared_ptr<arrow::ChunkedArray> local_to_global_id;
+};
+
+/// Compute the layout of host of the partition of pg stored in the uint32
+/// node property partition_property_name, for example by GraphPartition,
+/// where host i owns the nodes of partition i.
+KATANA_EXPORT Result<PartitionLayout> ComputePartitionLayout(
+    PropertyGraph* pg, const std::string& partition_property_name,
+    uint32_t num_hosts, uint32_t host,
+    PartitionLayoutPolicy policy = PartitionLayoutPolicy::kOutgoingEdgeCut,
+    uint32_t vertex_cut_degree_threshold = 100);
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_HYPERANF_HYPERANF_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_HYPERANF_HYPERANF_H_
+
+#include <iostream>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for HyperANF, specifying the algorithm and any
+/// parameters associated with it.
+class HyperAnfPlan : public Plan {
+public:
+  enum Algorithm {
+    kSynchronous,
+  };
+
+  static constexpr uint32_t kDefaultLog2Registers = 6;
+  static constexpr uint32_t kMinLog2Registers = 4;
+  static constexpr uint32_t kMaxLog2Registers = 16;
+  static constexpr uint32_t kDefaultMaxIterations = 1000;
+
+private:
+  Algorithm algorithm_;
+  uint32_t log2_registers_;
+  uint32_t max_iterations_;
+
+  HyperAnfPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t log2_registers,
+      uint32_t max_iterations)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        log2_registers_(log2_registers),
+        max_iterations_(max_iterations) {}
+
+public:
+  HyperAnfPlan() : HyperAnfPlan{Synchronous()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint32_t log2_registers() const { return log2_registers_; }
+  uint32_t max_iterations() const { return max_iterations_; }
+
+  /// Every node keeps a HyperLogLog counter of 2^log2_registers one-byte
+  /// registers for the set of nodes it reaches. In iteration t, each node
+  /// unions the counters of the destinations of its edges into its own by
+  /// a register-wise maximum, so that its counter holds the nodes within
+  /// distance t. The relative standard error of each count is about
+  /// 1.04 / sqrt(2^log2_registers). Each iteration reads every edge once and
+  /// the counters take 2^(log2_registers + 1) bytes per node. The
+  /// iterations stop once no counter changes, or after max_iterations.
+  static HyperAnfPlan Synchronous(
+      uint32_t log2_registers = kDefaultLog2Registers,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kSynchronous, log2_registers, max_iterations};
+  }
+};
+
+/// The statistics of the distances of a graph, as estimated by HyperAnf
+struct KATANA_EXPORT HyperAnfStatistics {
+  /// The estimated number of pairs of nodes (x, y) such that y is reachable
+  /// from x in at most t steps, counting (x, x), for each t from 0 to the
+  /// last iteration.
+  std::vector<double> neighborhood_function;
+  /// The estimated 90th percentile of the distances between the pairs of
+  /// nodes at finite distance, interpolated between iterations.
+  double effective_diameter;
+  /// The estimated mean of the distances between the pairs of distinct
+  /// nodes at finite distance.
+  double average_distance;
+  /// The number of iterations until no counter changed, which is at most
+  /// the largest finite distance.
+  uint32_t num_iterations;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/// Estimate the neighborhood function of pg with HyperANF (Boldi, Rosa and
+/// Vigna), i.e., the number of pairs of nodes within each distance, along
+/// the out-edges of pg. The estimated harmonic centrality of each node x,
+/// the sum of 1 / d(x, y) over the nodes y != x reachable from it, is
+/// stored in the float node property named output_property_name. This is
+/// the usual harmonic centrality, over the distances to x, if pg is the
+/// transpose of the graph of interest, or if pg is symmetric.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<HyperAnfStatistics> HyperAnf(
+    PropertyGraph* pg, const std::string& output_property_name,
+    HyperAnfPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_HYPERGRAPHPARTITION_HYPERGRAPHPARTITION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_HYPERGRAPHPARTITION_HYPERGRAPHPARTITION_H_
+
+#include <iostream>
+#include <limits>
+
+#include "katana/HyperGraphView.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// The partition of a hyperedge whose nodes are in different partitions
+constexpr uint32_t kHyperGraphPartitionCut =
+    std::numeric_limits<uint32_t>::max();
+
+/// A computational plan for hypergraph partitioning, specifying the
+/// algorithm and any parameters associated with it.
+class HyperGraphPartitionPlan : public Plan {
+public:
+  enum Algorithm {
+    kMultilevel,
+  };
+
+  /// The hyperedges whose nodes are merged first when coarsening
+  enum MatchingPolicy {
+    /// Hyperedges with more nodes first
+    kHigherDegree,
+    /// Hyperedges with fewer nodes first
+    kLowerDegree,
+    /// Hyperedges with heavier nodes first
+    kHigherWeight,
+    /// Hyperedges with lighter nodes first
+    kLowerWeight,
+    /// Hyperedges in a pseudo-random order, fixed by their ids
+    kRandom,
+  };
+
+  static constexpr double kDefaultImbalance = 0.05;
+  static const MatchingPolicy kDefaultMatchingPolicy = kHigherDegree;
+  static const uint32_t kDefaultRefinementPasses = 2;
+  static const uint32_t kDefaultMaxCoarseGraphSize = 25;
+
+private:
+  Algorithm algorithm_;
+  MatchingPolicy matching_policy_;
+  double imbalance_;
+  uint32_t refinement_passes_;
+  uint32_t max_coarse_graph_size_;
+
+  HyperGraphPartitionPlan(
+      Architecture architecture, Algorithm algorithm,
+      MatchingPolicy matching_policy, double imbalance,
+      uint32_t refinement_passes, uint32_t max_coarse_graph_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        matching_policy_(matching_policy),
+        imbalance_(imbalance),
+        refinement_passes_(refinement_passes),
+        max_coarse_graph_size_(max_coarse_graph_size) {}
+
+public:
+  HyperGraphPartitionPlan() : HyperGraphPartitionPlan{Multilevel()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  MatchingPolicy matching_policy() const { return matching_policy_; }
+  /// The fraction by which a side of each bisection may exceed its share of
+  /// the node weight.
+  double imbalance() const { return imbalance_; }
+  /// The number of refinement passes run at each level of the hierarchy.
+  uint32_t refinement_passes() const { return refinement_passes_; }
+  /// Stop coarsening once the hypergraph has at most this many nodes.
+  uint32_t max_coarse_graph_size() const { return max_coarse_graph_size_; }
+
+  /// Multilevel recursive bisection in the style of BiPart (Maleki et al.),
+  /// which gives the same partition for any number of threads. The
+  /// hypergraph is coarsened by letting every node pick the first of its
+  /// hyperedges in the order of matching_policy, ties broken by id, and
+  /// merging the nodes that picked the same hyperedge, until it is small;
+  /// the coarsest hypergraph is bisected by moving the nodes of highest gain
+  /// from one side to the other in rounds, and the bisection is projected
+  /// back one level at a time and refined at each by swapping the nodes of
+  /// highest positive gain between the sides in pairs, then moving nodes
+  /// out of a side heavier than the imbalance allows. Each side is then
+  /// bisected again, without the hyperedges already cut, until there are
+  /// num_partitions partitions.
+  static HyperGraphPartitionPlan Multilevel(
+      MatchingPolicy matching_policy = kDefaultMatchingPolicy,
+      double imbalance = kDefaultImbalance,
+      uint32_t refinement_passes = kDefaultRefinementPasses,
+      uint32_t max_coarse_graph_size = kDefaultMaxCoarseGraphSize) {
+    return {
+        kCPU, kMultilevel, matching_policy, imbalance, refinement_passes,
+        max_coarse_graph_size};
+  }
+};
+
+/// Partition the nodes of the hypergraph stored in pg, whose first
+/// num_hyperedges nodes are hyperedges (see HyperGraphView), into
+/// num_partitions parts of about the same size, cutting few hyperedges. The
+/// partition of each node, and of each hyperedge whose nodes are all in the
+/// same partition, is stored as a uint32 in the node property named
+/// output_property_name; the other hyperedges are kHyperGraphPartitionCut.
+/// The property is created by this function and may not exist before the
+/// call.
+KATANA_EXPORT Result<void> HyperGraphPartition(
+    PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions,
+    const std::string& output_property_name,
+    HyperGraphPartitionPlan plan = {});
+
+/// Check that every node is in one of the num_partitions partitions and that
+/// every hyperedge is in the partition of its nodes or is cut.
+KATANA_EXPORT Result<void> HyperGraphPartitionAssertValid(
+    PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT HyperGraphPartitionStatistics {
+  /// The number of partitions, one more than the largest partition id.
+  uint64_t n_partitions;
+  /// The number of hyperedges with nodes in more than one partition.
+  uint64_t hyperedge_cut;
+  /// The number of nodes in the largest partition.
+  uint64_t max_partition_size;
+  /// The number of nodes in the smallest partition.
+  uint64_t min_partition_size;
+  /// The ratio of the largest partition size to the average one, minus one.
+  double imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<HyperGraphPartitionStatistics> Compute(
+      PropertyGraph* pg, uint64_t num_hyperedges,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
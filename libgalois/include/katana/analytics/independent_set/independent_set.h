@@ -20,7 +20,8 @@ public:
     // kNondeterministic,
     // kDeterministicBase,
     kPriority,
-    kEdgeTiledPriority
+    kEdgeTiledPriority,
+    kBitsetPriority,
   };
 
 private:
@@ -46,6 +47,10 @@ public:
     return {kCPU, kEdgeTiledPriority};
   }
 
+  /// Luby's algorithm with fixed priorities over node states packed in
+  /// bitsets. Each round only revisits the nodes left undecided.
+  static IndependentSetPlan BitsetPriority() { return {kCPU, kBitsetPriority}; }
+
   static IndependentSetPlan FromAlgorithm(Algorithm algorithm) {
     return {kCPU, algorithm};
   }
@@ -63,6 +68,21 @@ KATANA_EXPORT Result<void> IndependentSet(
 KATANA_EXPORT Result<void> IndependentSetAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
+/// Color the nodes of pg so that no edge joins two nodes of the same color,
+/// greedily: in rounds like those of IndependentSetPlan::BitsetPriority,
+/// each node, once its neighbors of higher degree are colored, takes the
+/// least color none of them has. A node of degree d gets a color of at most
+/// d. The nodes of one color are an independent set, e.g., updates of their
+/// edges do not conflict.
+/// The graph must be symmetric.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint32_t.
+KATANA_EXPORT Result<void> GraphColoring(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+KATANA_EXPORT Result<void> GraphColoringAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
 struct KATANA_EXPORT IndependentSetStatistics {
   /// The number of nodes in the independent set.
   uint32_t cardinality;
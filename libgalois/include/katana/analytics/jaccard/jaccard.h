@@ -1,7 +1,10 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_JACCARD_JACCARD_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_JACCARD_JACCARD_H_
 
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <string>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -64,6 +67,99 @@ KATANA_EXPORT Result<void> Jaccard(
 KATANA_EXPORT Result<void> JaccardAssertValid(
     PropertyGraph* pg, uint32_t compare_node, const std::string& property_name);
 
+/// A computational plan for SimilarityTopK, specifying the similarity measure
+/// and how candidate pairs are found and scored.
+class SimilarityTopKPlan : public Plan {
+public:
+  enum Measure {
+    /// |N(u) & N(v)| / |N(u) | N(v)|
+    kJaccard,
+    /// |N(u) & N(v)| / sqrt(|N(u)| |N(v)|)
+    kCosine,
+    /// The sum over the common neighbors w of 1 / log(in-degree of w)
+    kAdamicAdar,
+  };
+
+  /// Pass as max_intermediate_degree to follow every common neighbor
+  static const uint32_t kUnboundedDegree = 0;
+
+private:
+  Measure measure_;
+  uint32_t max_intermediate_degree_;
+  uint32_t num_hashes_;
+
+  SimilarityTopKPlan(
+      Architecture architecture, Measure measure,
+      uint32_t max_intermediate_degree, uint32_t num_hashes)
+      : Plan(architecture),
+        measure_(measure),
+        max_intermediate_degree_(max_intermediate_degree),
+        num_hashes_(num_hashes) {}
+
+public:
+  SimilarityTopKPlan() : SimilarityTopKPlan(kCPU, kJaccard, 0, 0) {}
+
+  Measure measure() const { return measure_; }
+  /// Common neighbors with a higher in-degree are not followed to find
+  /// candidates, or 0 (kUnboundedDegree)
+  uint32_t max_intermediate_degree() const { return max_intermediate_degree_; }
+  /// The size of the MinHash signatures, or 0 for exact similarities
+  uint32_t num_hashes() const { return num_hashes_; }
+
+  /// Exact similarities. A common neighbor with an in-degree above
+  /// max_intermediate_degree is not counted: hubs make the number of 2-hop
+  /// pairs quadratic in their degree while saying little about similarity.
+  static SimilarityTopKPlan Jaccard(
+      uint32_t max_intermediate_degree = kUnboundedDegree) {
+    return {kCPU, kJaccard, max_intermediate_degree, 0};
+  }
+
+  static SimilarityTopKPlan Cosine(
+      uint32_t max_intermediate_degree = kUnboundedDegree) {
+    return {kCPU, kCosine, max_intermediate_degree, 0};
+  }
+
+  static SimilarityTopKPlan AdamicAdar(
+      uint32_t max_intermediate_degree = kUnboundedDegree) {
+    return {kCPU, kAdamicAdar, max_intermediate_degree, 0};
+  }
+
+  /// Jaccard similarities estimated from MinHash signatures of num_hashes
+  /// hashes per node, with an error of about 1 / sqrt(num_hashes). The
+  /// estimate covers all neighbors, so unlike the exact measures it does
+  /// not lose the common neighbors skipped by max_intermediate_degree; only
+  /// the candidates reached through them are lost.
+  static SimilarityTopKPlan MinHashJaccard(
+      uint32_t num_hashes,
+      uint32_t max_intermediate_degree = kUnboundedDegree) {
+    return {kCPU, kJaccard, max_intermediate_degree, num_hashes};
+  }
+};
+
+/// The node SimilarityTopK gives the entries after the last candidate of a
+/// node with fewer than k candidates.
+constexpr uint32_t kSimilarityTopKNoNode = std::numeric_limits<uint32_t>::max();
+
+/// Find, for every node u, the k nodes most similar to u among those that
+/// share an out-neighbor with u (its 2-hop neighborhood, excluding u). The
+/// neighbors are stored in a property named output_nodes_property_name, a
+/// fixed-size list of k uint32_t per node, by decreasing similarity (ties by
+/// increasing node), and their similarities in a property named
+/// output_scores_property_name, a fixed-size list of k doubles. Entries past
+/// the candidates of u are kSimilarityTopKNoNode with similarity 0.
+///
+/// All nodes are processed in parallel, each counting the common neighbors
+/// of all of its candidates at once in a per-thread sparse accumulator, so
+/// the work is the number of 2-hop paths rather than quadratic in the
+/// number of nodes. This uses the in-edge index of pg.
+/// The properties are created by this function and may not exist before
+/// the call.
+KATANA_EXPORT Result<void> SimilarityTopK(
+    PropertyGraph* pg, uint32_t k,
+    const std::string& output_nodes_property_name,
+    const std::string& output_scores_property_name,
+    SimilarityTopKPlan plan = {});
+
 struct KATANA_EXPORT JaccardStatistics {
   /// The maximum similarity excluding the comparison node.
   double max_similarity;
@@ -2,6 +2,8 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_KCORE_KCORE_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include <katana/analytics/Plan.h>
 
@@ -17,7 +19,7 @@ namespace katana::analytics {
 class KCorePlan : public Plan {
 public:
   /// Algorithm selectors for KCore
-  enum Algorithm { kSynchronous, kAsynchronous };
+  enum Algorithm { kSynchronous, kAsynchronous, kDecomposition };
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -40,6 +42,11 @@ public:
 
   /// Asynchronous k-core algorithm.
   static KCorePlan Asynchronous() { return {kCPU, kAsynchronous}; }
+
+  /// Bucket-based core decomposition, which peels nodes in order of degree
+  /// and finds the coreness of every node in one run. KCore then keeps the
+  /// nodes of coreness at least k.
+  static KCorePlan Decomposition() { return {kCPU, kDecomposition}; }
 };
 
 /// Compute the k-core for pg. The pg must be symmetric.
@@ -55,9 +62,46 @@ KATANA_EXPORT Result<void> KCoreAssertValid(
     PropertyGraph* pg, uint32_t k_core_number,
     const std::string& property_name);
 
+/// Compute the coreness of every node of pg, i.e., the largest k such that
+/// the node is in the k-core. The pg must be symmetric. The k-core for any k
+/// consists of the nodes of coreness at least k.
+/// The uint32 property named output_property_name is created by this
+/// function and may not exist before the call.
+KATANA_EXPORT Result<void> KCoreDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+/// Update the coreness computed by KCoreDecomposition after edges were
+/// inserted into and deleted from the graph, without recomputing it from
+/// scratch.
+///
+/// pg is the symmetric graph after the changes and property_name holds the
+/// coreness of the graph before them; it is updated in place. The nodes of
+/// the graph must not have changed. inserted_edges and deleted_edges are
+/// the (source, destination) pairs of the changed edges, each standing for
+/// the edge in both directions; an inserted edge must be in pg.
+///
+/// Coreness is maintained by its local h-index characterization: values are
+/// only lowered from the endpoints of deleted edges, and raised in a few
+/// rounds from the endpoints of inserted edges, so the work is proportional
+/// to the part of the graph whose coreness could change. Both are parallel
+/// over the whole batch.
+KATANA_EXPORT Result<void> KCoreDecompositionIncremental(
+    PropertyGraph* pg, const std::string& property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges);
+
+/// Check that every node of coreness c has at least c neighbors of coreness
+/// at least c, and not c + 1 neighbors of coreness at least c + 1. This is
+/// not an exhaustive check.
+KATANA_EXPORT Result<void> KCoreDecompositionAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
 struct KATANA_EXPORT KCoreStatistics {
   /// Total number of node left in the core.
   uint64_t number_of_nodes_in_kcore;
+  /// The number of nodes of each coreness, from 0 to the largest coreness.
+  /// Only filled in by ComputeDecomposition.
+  std::vector<uint64_t> coreness_histogram;
 
   /// Print the statistics in a human readable form.
   void Print(std::ostream& os = std::cout) const;
@@ -65,6 +109,12 @@ struct KATANA_EXPORT KCoreStatistics {
   static katana::Result<KCoreStatistics> Compute(
       katana::PropertyGraph* pg, uint32_t k_core_number,
       const std::string& property_name);
+
+  /// Compute the statistics of the output of KCoreDecomposition, including
+  /// the histogram of coreness
+  static katana::Result<KCoreStatistics> ComputeDecomposition(
+      katana::PropertyGraph* pg, uint32_t k_core_number,
+      const std::string& property_name);
 };
 
 }  // namespace katana::analytics
@@ -0,0 +1,81 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_KSHORTESTSIMPLEPATHS_KSHORTESTSIMPLEPATHS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_KSHORTESTSIMPLEPATHS_KSHORTESTSIMPLEPATHS_H_
+
+#include <iostream>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for the k shortest simple paths between two nodes,
+/// specifying the algorithm and any parameters associated with it.
+class KShortestSimplePathsPlan : public Plan {
+public:
+  enum Algorithm {
+    kYen,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  KShortestSimplePathsPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  KShortestSimplePathsPlan() : KShortestSimplePathsPlan{kCPU, kYen} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /**
+   * The algorithm of
+   *   Jin Y. Yen. Finding the K Shortest Loopless Paths in a Network.
+   *   Management Science. 1971.
+   *
+   * Each iteration deviates from the last path found at each of its nodes.
+   * These spur searches run concurrently, one per thread, as Dijkstra
+   * searches that stop at the target. They mask the nodes of the root path
+   * and the edges taken by earlier paths instead of copying the graph, and
+   * each thread reuses its distance arrays across searches.
+   */
+  static KShortestSimplePathsPlan Yen() { return {kCPU, kYen}; }
+};
+
+/// The paths found by KShortestSimplePaths, by nondecreasing weight.
+struct KATANA_EXPORT KShortestSimplePathsResult {
+  /// The nodes of each path, from the source to the target.
+  std::vector<std::vector<uint32_t>> paths;
+  /// The total edge weight of each path.
+  std::vector<double> weights;
+
+  /// Print the paths in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/// Find the k shortest simple paths from source to target in pg. The edge
+/// weights are taken from the property named edge_weight_property_name
+/// (which may be a 32- or 64-bit sign or unsigned int or a floating point
+/// number) and may not be negative. Between two nodes, only the lightest of
+/// any parallel edges is used. Fewer than k paths are returned if fewer
+/// exist; paths of equal weight are ordered by their nodes, so the result
+/// does not depend on the schedule.
+KATANA_EXPORT Result<KShortestSimplePathsResult> KShortestSimplePaths(
+    PropertyGraph* pg, size_t source, size_t target, size_t k,
+    const std::string& edge_weight_property_name,
+    KShortestSimplePathsPlan plan = {});
+
+/// Check that the paths of result are distinct simple paths from source to
+/// target, that their weights are those of their edges and that they are
+/// ordered by weight.
+KATANA_EXPORT Result<void> KShortestSimplePathsAssertValid(
+    PropertyGraph* pg, size_t source, size_t target,
+    const std::string& edge_weight_property_name,
+    const KShortestSimplePathsResult& result);
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,6 +2,8 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_KTRUSS_KTRUSS_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include <katana/analytics/Plan.h>
 
@@ -16,7 +18,7 @@ namespace katana::analytics {
 class KTrussPlan : public Plan {
 public:
   /// Algorithm selectors for KCore
-  enum Algorithm { kBsp, kBspJacobi, kBspCoreThenTruss };
+  enum Algorithm { kBsp, kBspJacobi, kBspCoreThenTruss, kDecomposition };
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -39,6 +41,12 @@ public:
 
   /// Compute k-1 core and then k-truss algorithm.
   static KTrussPlan BspCoreThenTruss() { return {kCPU, kBspCoreThenTruss}; }
+
+  /// Truss decomposition, which peels edges in order of support and finds
+  /// the trussness of every edge in one run. Supports are kept per edge and
+  /// the reverse of each edge is found once, so removing an edge needs no
+  /// searches. KTruss then keeps the edges of trussness at least k.
+  static KTrussPlan Decomposition() { return {kCPU, kDecomposition}; }
 };
 
 /// Compute the k-truss for pg. The pg is expected to be
@@ -57,9 +65,50 @@ KATANA_EXPORT Result<void> KTrussAssertValid(
     PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& property_name);
 
+/// Compute the trussness of every edge of pg, i.e., the largest k such that
+/// the edge is in the k-truss. Edges on no triangle have trussness 2. The pg
+/// must be symmetric without parallel edges; both directions of an edge get
+/// the same trussness.
+/// The uint32 edge property named output_property_name is created by this
+/// function and may not exist before the call.
+///
+/// @warning This algorithm will reorder nodes and edges in the graph.
+KATANA_EXPORT Result<void> KTrussDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+/// Update the trussness computed by KTrussDecomposition after edges were
+/// inserted into and deleted from the graph, without recomputing it from
+/// scratch.
+///
+/// pg is the symmetric graph after the changes, without parallel edges and
+/// with its edges sorted by destination, and property_name holds, for each
+/// edge that was also in the graph before the changes, its trussness then;
+/// it is updated in place, and the values of inserted edges are ignored.
+/// The nodes of the graph must not have changed. inserted_edges and
+/// deleted_edges are the (source, destination) pairs of the changed edges,
+/// each standing for the edge in both directions.
+///
+/// Trussness is maintained by its local h-index characterization, as
+/// KCoreDecompositionIncremental maintains coreness, starting from the
+/// edges on triangles with changed edges, so the work is proportional to
+/// the part of the graph whose trussness could change.
+KATANA_EXPORT Result<void> KTrussDecompositionIncremental(
+    PropertyGraph* pg, const std::string& property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges);
+
+/// Check that every edge of trussness t is on at least t - 2 triangles of
+/// edges of trussness at least t, and not on t - 1 triangles of edges of
+/// trussness above t. This is not an exhaustive check.
+KATANA_EXPORT Result<void> KTrussDecompositionAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
 struct KATANA_EXPORT KTrussStatistics {
   /// Total number of edges left in the truss.
   uint64_t number_of_edges_left;
+  /// The number of undirected edges of each trussness, from 0 to the largest
+  /// trussness. Only filled in by ComputeDecomposition.
+  std::vector<uint64_t> trussness_histogram;
 
   /// Print the statistics in a human readable form.
   void Print(std::ostream& os = std::cout) const;
@@ -67,6 +116,12 @@ struct KATANA_EXPORT KTrussStatistics {
   static katana::Result<KTrussStatistics> Compute(
       katana::PropertyGraph* pg, uint32_t k_truss_number,
       const std::string& property_name);
+
+  /// Compute the statistics of the output of KTrussDecomposition, including
+  /// the histogram of trussness
+  static katana::Result<KTrussStatistics> ComputeDecomposition(
+      katana::PropertyGraph* pg, uint32_t k_truss_number,
+      const std::string& property_name);
 };
 
 }  // namespace katana::analytics
@@ -0,0 +1,97 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_LABELPROPAGATION_LABELPROPAGATION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_LABELPROPAGATION_LABELPROPAGATION_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for community detection by label propagation,
+/// specifying the algorithm and any parameters associated with it.
+class LabelPropagationPlan : public Plan {
+public:
+  enum Algorithm {
+    kSynchronous,
+    kAsynchronous,
+  };
+
+  static const uint32_t kDefaultMaxIterations = 10;
+
+private:
+  Algorithm algorithm_;
+  uint32_t max_iterations_;
+
+  LabelPropagationPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t max_iterations)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        max_iterations_(max_iterations) {}
+
+public:
+  LabelPropagationPlan()
+      : LabelPropagationPlan{kCPU, kAsynchronous, kDefaultMaxIterations} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Maximum number of rounds to execute.
+  uint32_t max_iterations() const { return max_iterations_; }
+
+  /// Every node starts with its own id as label. In each round, the nodes
+  /// take the label most frequent among their neighbors in the previous
+  /// round, the smallest one on ties. Only nodes with a neighbor that
+  /// changed label are evaluated again. The result is deterministic and
+  /// matches the CDLP kernel of the LDBC Graphalytics benchmark.
+  static LabelPropagationPlan Synchronous(
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kSynchronous, max_iterations};
+  }
+
+  /// Like Synchronous, but labels are updated in place, so nodes see the
+  /// labels their neighbors took earlier in the same round. Converges in
+  /// fewer rounds and avoids the oscillation of synchronous updates on
+  /// bipartite structures, but the result depends on the schedule.
+  static LabelPropagationPlan Asynchronous(
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kAsynchronous, max_iterations};
+  }
+};
+
+/// Detect communities in pg by label propagation and store the label of
+/// each node, which is a node id, in the uint64 property
+/// output_property_name. The graph must be symmetric. The labels can seed
+/// LouvainClusteringFromSeed.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> LabelPropagation(
+    PropertyGraph* pg, const std::string& output_property_name,
+    LabelPropagationPlan plan = {});
+
+/// Check that every label is a node id and that isolated nodes kept their
+/// own ids.
+KATANA_EXPORT Result<void> LabelPropagationAssertValid(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+struct KATANA_EXPORT LabelPropagationStatistics {
+  /// Total number of unique communities in the graph.
+  uint64_t n_communities;
+  /// Total number of communities with more than 1 node.
+  uint64_t n_non_trivial_communities;
+  /// The number of nodes present in the largest community.
+  uint64_t largest_community_size;
+  /// The proportion of nodes present in the largest community.
+  double largest_community_ratio;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<LabelPropagationStatistics> Compute(
+      PropertyGraph* pg, const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -4,6 +4,7 @@
 #include "katana/PropertyGraph.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/Sparsify.h"
 #include "katana/analytics/Utils.h"
 
 // API
@@ -14,7 +15,11 @@ namespace katana::analytics {
 /// Clustering Coefficient of the nodes in the graph.
 class LocalClusteringCoefficientPlan : public Plan {
 public:
-  enum Algorithm { kOrderedCountAtomics, kOrderedCountPerThread };
+  enum Algorithm {
+    kOrderedCountAtomics,
+    kOrderedCountPerThread,
+    kOrderedCountOwnerComputes
+  };
 
   enum Relabeling {
     kRelabel,
@@ -69,6 +74,24 @@ public:
       Relabeling relabeling = kDefaultRelabeling) {
     return {kCPU, kOrderedCountPerThread, edges_sorted, relabeling};
   }
+
+  /**
+   * The ordered count algorithm, with neither atomics nor per-thread
+   * arrays of counts. Each triangle is found once, at its largest node,
+   * which counts it for itself and for its two edges to the other nodes;
+   * those counts are kept with the edges of the node that finds them, so
+   * only one thread writes each. Each node then collects the counts of
+   * the edges to it from its larger neighbors. This takes one count per
+   * edge instead of one per node for each thread.
+   *
+   * @param edges_sorted Are the edges of the graph already sorted.
+   * @param relabeling Should the algorithm relabel the nodes.
+   */
+  static LocalClusteringCoefficientPlan OrderedCountOwnerComputes(
+      bool edges_sorted = kDefaultEdgesSorted,
+      Relabeling relabeling = kDefaultRelabeling) {
+    return {kCPU, kOrderedCountOwnerComputes, edges_sorted, relabeling};
+  }
 };
 
 /**
@@ -85,6 +108,30 @@ KATANA_EXPORT Result<void> LocalClusteringCoefficient(
     PropertyGraph* pg, const std::string& output_property_name,
     LocalClusteringCoefficientPlan plan = {});
 
+/**
+ * Approximate the local clustering coefficient of each node of pg, which
+ * must be symmetric, by counting triangles with plan on the sparsification
+ * of pg by sparsify_plan. Unlike LocalClusteringCoefficient, this leaves
+ * the topology of pg as it is.
+ *
+ * A triangle survives edge sampling with the probability p^3 where p is
+ * the fraction of edges kept, so the coefficient of a node is estimated as
+ * its sampled triangles over p^3, over the wedges of its degree in pg. A
+ * forest fire keeps whole neighborhoods instead, so the coefficient of a
+ * node it burned is taken as is from the sample, and other nodes get 0.
+ * The coefficients are stored in the new node property
+ * output_property_name of pg.
+ *
+ * The estimated_error of the returned statistics is the relative standard
+ * error of the number of triangles the coefficients are scaled from, by
+ * the variance of a sum of independent survivals; it is 1 if the sample
+ * has no triangles.
+ */
+KATANA_EXPORT Result<ApproximationStatistics>
+ApproximateLocalClusteringCoefficient(
+    PropertyGraph* pg, const std::string& output_property_name,
+    SparsifyPlan sparsify_plan = {}, LocalClusteringCoefficientPlan plan = {});
+
 }  // namespace katana::analytics
 
 #endif
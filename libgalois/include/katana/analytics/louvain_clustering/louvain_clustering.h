@@ -123,6 +123,16 @@ KATANA_EXPORT Result<void> LouvainClustering(
     PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, LouvainClusteringPlan plan = {});
 
+/// Compute the Louvain Clustering for pg starting from the clusters in the
+/// uint64 node property seed_property_name, e.g., the labels computed by
+/// LabelPropagation. Each seed cluster must be a node id. The graph is
+/// first coarsened by the seed clusters, which Louvain then merges but
+/// never splits. Vertex following is not applied.
+KATANA_EXPORT Result<void> LouvainClusteringFromSeed(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& seed_property_name,
+    const std::string& output_property_name, LouvainClusteringPlan plan = {});
+
 KATANA_EXPORT Result<void> LouvainClusteringAssertValid(
     PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name);
@@ -0,0 +1,157 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MATRIXCOMPLETION_MATRIXCOMPLETION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MATRIXCOMPLETION_MATRIXCOMPLETION_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for matrix completion, specifying the algorithm and
+/// any parameters associated with it.
+class MatrixCompletionPlan : public Plan {
+public:
+  enum Algorithm {
+    kStochasticGradientDescent,
+    kAlternatingLeastSquares,
+  };
+
+  static const uint32_t kDefaultLatentVectorSize = 20;
+  static constexpr double kDefaultLearningRate = 0.012;
+  static constexpr double kDefaultLambda = 0.05;
+  static constexpr double kDefaultTolerance = 0.01;
+  static const uint32_t kDefaultMaxIterations = 100;
+  static const uint32_t kDefaultItemsPerBlock = 350;
+  static const uint32_t kDefaultUsersPerBlock = 2048;
+
+private:
+  Algorithm algorithm_;
+  uint32_t latent_vector_size_;
+  double learning_rate_;
+  double lambda_;
+  double tolerance_;
+  uint32_t max_iterations_;
+  uint32_t items_per_block_;
+  uint32_t users_per_block_;
+
+  MatrixCompletionPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t latent_vector_size, double learning_rate, double lambda,
+      double tolerance, uint32_t max_iterations, uint32_t items_per_block,
+      uint32_t users_per_block)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        latent_vector_size_(latent_vector_size),
+        learning_rate_(learning_rate),
+        lambda_(lambda),
+        tolerance_(tolerance),
+        max_iterations_(max_iterations),
+        items_per_block_(items_per_block),
+        users_per_block_(users_per_block) {}
+
+public:
+  MatrixCompletionPlan() : MatrixCompletionPlan{StochasticGradientDescent()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of latent factors of each node.
+  uint32_t latent_vector_size() const { return latent_vector_size_; }
+  /// The initial step size of gradient descent.
+  double learning_rate() const { return learning_rate_; }
+  /// The weight of the squared norm of the latent vectors in the objective.
+  double lambda() const { return lambda_; }
+  /// Stop when the squared error changes by less than this ratio in a round.
+  double tolerance() const { return tolerance_; }
+  /// Maximum number of rounds to execute.
+  uint32_t max_iterations() const { return max_iterations_; }
+  /// The number of items in a tile of kStochasticGradientDescent.
+  uint32_t items_per_block() const { return items_per_block_; }
+  /// The number of users in a tile of kStochasticGradientDescent.
+  uint32_t users_per_block() const { return users_per_block_; }
+
+  /// Each round updates the latent vectors of both ends of every edge by a
+  /// gradient step. The rating matrix is cut into tiles of items_per_block
+  /// items by users_per_block users, and a Fixed2DGraphTiledExecutor hands
+  /// threads tiles that share no row or column, so updates never conflict
+  /// and need no atomics. The step size follows the bold driver: it grows
+  /// by 5% after a round that reduced the error and halves otherwise.
+  static MatrixCompletionPlan StochasticGradientDescent(
+      uint32_t latent_vector_size = kDefaultLatentVectorSize,
+      double learning_rate = kDefaultLearningRate,
+      double lambda = kDefaultLambda, double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      uint32_t items_per_block = kDefaultItemsPerBlock,
+      uint32_t users_per_block = kDefaultUsersPerBlock) {
+    return {
+        kCPU,
+        kStochasticGradientDescent,
+        latent_vector_size,
+        learning_rate,
+        lambda,
+        tolerance,
+        max_iterations,
+        items_per_block,
+        users_per_block};
+  }
+
+  /// Each round first fixes the user vectors and solves the regularized
+  /// least squares problem of every item exactly, then does the same for the
+  /// users. Every node solves its own small system by Cholesky
+  /// factorization, so the nodes of a side are solved in parallel.
+  static MatrixCompletionPlan AlternatingLeastSquares(
+      uint32_t latent_vector_size = kDefaultLatentVectorSize,
+      double lambda = kDefaultLambda, double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {
+        kCPU,
+        kAlternatingLeastSquares,
+        latent_vector_size,
+        0,
+        lambda,
+        tolerance,
+        max_iterations,
+        0,
+        0};
+  }
+};
+
+/// Factor the rating matrix of the bipartite graph pg into latent vectors,
+/// so that the rating of an edge is approximated by the dot product of the
+/// vectors of its endpoints. The items are the nodes with out-edges and must
+/// precede all users, which have no out-edges; every edge goes from an item
+/// to a user. The ratings are taken from the edge property named
+/// edge_rating_property_name (which may be a 32- or 64-bit sign or unsigned
+/// int or a floating point number).
+/// The latent vectors are stored as fixed size lists of floats in the node
+/// property named output_property_name, which is created by this function
+/// and may not exist before the call.
+KATANA_EXPORT Result<void> MatrixCompletion(
+    PropertyGraph* pg, const std::string& edge_rating_property_name,
+    const std::string& output_property_name, MatrixCompletionPlan plan = {});
+
+/// Check that every node has a latent vector of finite values.
+KATANA_EXPORT Result<void> MatrixCompletionAssertValid(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+struct KATANA_EXPORT MatrixCompletionStatistics {
+  /// The number of items, which are the nodes with out-edges.
+  uint64_t n_items;
+  /// The number of users.
+  uint64_t n_users;
+  /// The root mean squared error of the predicted ratings of the edges.
+  double rmse;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MatrixCompletionStatistics> Compute(
+      PropertyGraph* pg, const std::string& edge_rating_property_name,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for maximum flow, specifying the algorithm and any
+/// parameters associated with it.
+class MaxFlowPlan : public Plan {
+public:
+  enum Algorithm {
+    kPushRelabel,
+  };
+
+  /// Use the default global relabeling interval, alpha * num_nodes +
+  /// num_edges arcs scanned, with alpha = 6 as in Goldberg's implementation.
+  static const uint64_t kDefaultGlobalRelabelInterval = 0;
+
+private:
+  Algorithm algorithm_;
+  uint64_t global_relabel_interval_;
+
+  MaxFlowPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint64_t global_relabel_interval)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        global_relabel_interval_(global_relabel_interval) {}
+
+public:
+  MaxFlowPlan() : MaxFlowPlan{PushRelabel()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of arcs discharges scan between global relabelings, or
+  /// kDefaultGlobalRelabelInterval to derive it from the size of the graph.
+  uint64_t global_relabel_interval() const { return global_relabel_interval_; }
+
+  /// Parallel push-relabel on the residual graph, whose arcs are the edges
+  /// of pg and their reverses. In each round all active nodes discharge in
+  /// parallel, pushing to any lower residual neighbor and relabeling to one
+  /// above the lowest one, as in the lock-free algorithm of Hong, so
+  /// neighbors need no locks. Nodes that cannot reach the sink rise above
+  /// the number of nodes and return their excess to the source, so the
+  /// result is a flow rather than a preflow.
+  ///
+  /// Between rounds, once enough work is done, a global relabeling sets every
+  /// height to the exact residual distance to the sink (or to the source, for
+  /// nodes that cannot reach the sink) by parallel breadth-first searches
+  /// over the reverse arcs, and the gap heuristic lifts the nodes above an
+  /// empty height out of reach of the sink at once.
+  static MaxFlowPlan PushRelabel(
+      uint64_t global_relabel_interval = kDefaultGlobalRelabelInterval) {
+    return {kCPU, kPushRelabel, global_relabel_interval};
+  }
+};
+
+/// Compute a maximum flow from source_id to sink_id in pg. The capacity of
+/// each edge is taken from the edge property named
+/// edge_capacity_property_name (which may be a 32- or 64-bit sign or unsigned
+/// int whose values fit in an int64_t), and the flow on each edge is stored
+/// in the edge property named output_property_name, of the same type. Edges
+/// between the same nodes are independent, and flows on opposite edges are
+/// not cancelled.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> MaxFlow(
+    PropertyGraph* pg, uint32_t source_id, uint32_t sink_id,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name, MaxFlowPlan plan = {});
+
+/// Check that output_property_name is a flow within the capacities, that is
+/// conserved at every node but source_id and sink_id, and that is maximum
+/// because no residual path leads from source_id to sink_id.
+KATANA_EXPORT Result<void> MaxFlowAssertValid(
+    PropertyGraph* pg, uint32_t source_id, uint32_t sink_id,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT MaxFlowStatistics {
+  /// The net flow out of the source.
+  int64_t flow_value;
+  /// The number of edges whose flow equals their capacity.
+  uint64_t n_saturated_edges;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MaxFlowStatistics> Compute(
+      PropertyGraph* pg, uint32_t source_id,
+      const std::string& edge_capacity_property_name,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
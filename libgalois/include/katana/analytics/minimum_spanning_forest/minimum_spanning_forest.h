@@ -0,0 +1,82 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for the minimum spanning forest, specifying the
+/// algorithm and any parameters associated with it.
+class MinimumSpanningForestPlan : public Plan {
+public:
+  enum Algorithm {
+    kBoruvka,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  MinimumSpanningForestPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  MinimumSpanningForestPlan() : MinimumSpanningForestPlan{kCPU, kBoruvka} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// In each round, every component picks its lightest edge to another
+  /// component with an atomic minimum, the picked edges join the components
+  /// and pointer jumping relabels them. The first round reads the edges of
+  /// the topology in place; after it, the edges between distinct
+  /// components are copied into a flat list that is compacted every round,
+  /// so the work per round shrinks with the number of edges left.
+  static MinimumSpanningForestPlan Boruvka() { return {kCPU, kBoruvka}; }
+};
+
+/// Compute a minimum spanning forest of pg, treating every edge as
+/// undirected, and store in the boolean edge property output_property_name
+/// whether each edge is in the forest. The edge weights are taken from the
+/// property named edge_weight_property_name (which may be a 32- or 64-bit
+/// sign or unsigned int or a floating point number). Ties between edges of
+/// equal weight are broken by edge id, so the forest does not depend on the
+/// schedule, and of the two directions of an edge of a symmetric graph at
+/// most one is in the forest.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    MinimumSpanningForestPlan plan = {});
+
+/// Check that the edges marked in output_property_name are the minimum
+/// spanning forest, which is unique under the order by weight and then edge
+/// id, by comparing them with the forest of a serial Kruskal's algorithm.
+KATANA_EXPORT Result<void> MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT MinimumSpanningForestStatistics {
+  /// The number of edges in the forest.
+  uint64_t n_forest_edges;
+  /// The number of trees in the forest, including isolated nodes.
+  uint64_t n_trees;
+  /// The total weight of the forest edges.
+  double total_weight;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MinimumSpanningForestStatistics> Compute(
+      PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MOTIFCOUNT_MOTIFCOUNT_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MOTIFCOUNT_MOTIFCOUNT_H_
+
+#include <array>
+#include <iostream>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for counting the triangles, 4-cycles and 4-cliques of
+/// each node.
+class MotifCountPlan : public Plan {
+public:
+  enum Algorithm {
+    kOrderedCount,
+  };
+
+  enum Relabeling {
+    kRelabel,
+    kNoRelabel,
+    kAutoRelabel,
+  };
+
+  static const Relabeling kDefaultRelabeling = kAutoRelabel;
+  static const bool kDefaultEdgeSorted = false;
+
+private:
+  Algorithm algorithm_;
+  Relabeling relabeling_;
+  bool edges_sorted_;
+
+  MotifCountPlan(
+      Architecture architecture, Algorithm algorithm, bool edges_sorted,
+      Relabeling relabeling)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        relabeling_(relabeling),
+        edges_sorted_(edges_sorted) {}
+
+public:
+  MotifCountPlan()
+      : MotifCountPlan{
+            kCPU, kOrderedCount, kDefaultEdgeSorted, kDefaultRelabeling} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  Relabeling relabeling() const { return relabeling_; }
+  bool edges_sorted() const { return edges_sorted_; }
+
+  /**
+   * The ordered count of TriangleCount, extended to larger motifs. Nodes are
+   * relabeled by descending degree and each motif is found once:
+   * triangles and 4-cliques by intersecting the sorted lists of neighbors of
+   * higher degree, 4-cycles by counting the wedges between pairs of nodes
+   * as in
+   *   Norishige Chiba and Takao Nishizeki. Arboricity and Subgraph Listing
+   *   Algorithms. SIAM Journal on Computing. 1985.
+   *
+   * The 4-cycle count keeps one counter per node for each thread.
+   *
+   * @param edges_sorted Are the edges of the graph already sorted.
+   * @param relabeling Should the algorithm relabel the nodes.
+   */
+  static MotifCountPlan OrderedCount(
+      bool edges_sorted = kDefaultEdgeSorted,
+      Relabeling relabeling = kDefaultRelabeling) {
+    return {kCPU, kOrderedCount, edges_sorted, relabeling};
+  }
+};
+
+/**
+ * Count, for each node, the triangles, 4-cycles and 4-cliques it is part of
+ * and store the counts in uint64 node properties. A 4-cycle is any cycle
+ * through four nodes, whether or not it has chords. A motif whose property
+ * name is empty is not counted; at least one name must be given. The graph
+ * must be symmetric and have no self loops or multi-edges.
+ *
+ * This algorithm copies the graph internally.
+ *
+ * @param pg The graph to process.
+ * @param triangles_property name of the per-node triangle count property
+ * @param four_cycles_property name of the per-node 4-cycle count property
+ * @param four_cliques_property name of the per-node 4-clique count property
+ * @param plan
+ */
+KATANA_EXPORT Result<void> MotifCount(
+    PropertyGraph* pg, const std::string& triangles_property,
+    const std::string& four_cycles_property,
+    const std::string& four_cliques_property, MotifCountPlan plan = {});
+
+/// Check the output of MotifCount: every motif counted at a node is
+/// counted at all of its nodes, and no node is in more motifs than its
+/// degree allows. Empty property names are skipped.
+KATANA_EXPORT Result<void> MotifCountAssertValid(
+    PropertyGraph* pg, const std::string& triangles_property,
+    const std::string& four_cycles_property,
+    const std::string& four_cliques_property);
+
+struct KATANA_EXPORT MotifCountStatistics {
+  /// The number of triangles in the graph
+  uint64_t total_triangles;
+  /// The number of 4-cycles in the graph
+  uint64_t total_four_cycles;
+  /// The number of 4-cliques in the graph
+  uint64_t total_four_cliques;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  /// Compute the statistics of the output of MotifCount. Motifs whose
+  /// property name is empty have a total of 0.
+  static katana::Result<MotifCountStatistics> Compute(
+      PropertyGraph* pg, const std::string& triangles_property,
+      const std::string& four_cycles_property,
+      const std::string& four_cliques_property);
+};
+
+/// The number of connected and unconnected triples of nodes of a directed
+/// graph of each of the 16 isomorphism classes of directed triads. Types
+/// are named by their numbers of mutual, asymmetric and null dyads and, to
+/// tell apart types with the same numbers, the orientation (Down, Up,
+/// Cyclic or Transitive) of their asymmetric edges.
+struct KATANA_EXPORT TriadCensus {
+  enum TriadType {
+    k003,
+    k012,
+    k102,
+    k021D,
+    k021U,
+    k021C,
+    k111D,
+    k111U,
+    k030T,
+    k030C,
+    k201,
+    k120D,
+    k120U,
+    k120C,
+    k210,
+    k300,
+  };
+
+  static constexpr size_t kNumTriadTypes = 16;
+
+  /// The number of triads of each TriadType. The number of empty triads,
+  /// (n choose 3) minus the others, saturates at the largest uint64_t.
+  std::array<uint64_t, kNumTriadTypes> counts{};
+
+  /// \returns the name of \p type, e.g., "021D"
+  static const char* TypeName(TriadType type);
+
+  /// Print the census in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/**
+ * Compute the triad census of a directed graph with the algorithm of
+ *   Vladimir Batagelj and Andrej Mrvar. A subquadratic triad census
+ *   algorithm for large sparse networks with small maximum degree. Social
+ *   Networks. 2001.
+ *
+ * Self loops are ignored and parallel edges are counted once. This
+ * algorithm copies the graph internally.
+ *
+ * @param pg The graph to process.
+ */
+KATANA_EXPORT katana::Result<TriadCensus> DirectedTriadCensus(
+    PropertyGraph* pg);
+
+}  // namespace katana::analytics
+
+#endif
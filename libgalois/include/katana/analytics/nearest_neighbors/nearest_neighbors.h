@@ -0,0 +1,107 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_NEARESTNEIGHBORS_NEARESTNEIGHBORS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_NEARESTNEIGHBORS_NEARESTNEIGHBORS_H_
+
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for approximate nearest neighbors, specifying the
+/// distance between embeddings and the parameters of the hierarchical
+/// navigable small world (HNSW) graph that indexes them.
+///
+/// Every node is on layer 0 of the index and on each layer above with
+/// probability 1 / max_degree, and links to up to max_degree nearby nodes
+/// on each of its layers (2 * max_degree on layer 0). A query descends
+/// greedily from the single node of the top layer and then searches layer 0
+/// with a beam of the nearest nodes seen so far; wider beams find more of
+/// the true nearest neighbors at the cost of more distances.
+///
+/// The index is built in rounds of doubling size; the nodes of a round are
+/// inserted in parallel, so each sees an index of at least half its final
+/// size. Queries of a batch are answered in parallel.
+class NearestNeighborsPlan : public Plan {
+public:
+  enum Metric {
+    /// The Euclidean distance between embeddings
+    kEuclidean,
+    /// The negated inner product of embeddings, so that larger products are
+    /// nearer
+    kInnerProduct,
+    /// One minus the cosine of the angle between embeddings
+    kCosine,
+  };
+
+  static const uint32_t kDefaultMaxDegree = 16;
+  static const uint32_t kDefaultBuildBeamWidth = 100;
+  static const uint32_t kDefaultQueryBeamWidth = 64;
+
+private:
+  Metric metric_;
+  uint32_t max_degree_;
+  uint32_t build_beam_width_;
+  uint32_t query_beam_width_;
+
+  NearestNeighborsPlan(
+      Architecture architecture, Metric metric, uint32_t max_degree,
+      uint32_t build_beam_width, uint32_t query_beam_width)
+      : Plan(architecture),
+        metric_(metric),
+        max_degree_(max_degree),
+        build_beam_width_(build_beam_width),
+        query_beam_width_(query_beam_width) {}
+
+public:
+  NearestNeighborsPlan() : NearestNeighborsPlan{Hnsw()} {}
+
+  Metric metric() const { return metric_; }
+  /// The number of neighbors of a node on the layers above layer 0
+  uint32_t max_degree() const { return max_degree_; }
+  /// The number of nearest nodes searched when inserting a node
+  uint32_t build_beam_width() const { return build_beam_width_; }
+  /// The number of nearest nodes searched for a query, or k if larger
+  uint32_t query_beam_width() const { return query_beam_width_; }
+
+  /// Index the embeddings with an HNSW graph. An index must be queried
+  /// with the metric and max_degree it was built with.
+  static NearestNeighborsPlan Hnsw(
+      Metric metric = kEuclidean, uint32_t max_degree = kDefaultMaxDegree,
+      uint32_t build_beam_width = kDefaultBuildBeamWidth,
+      uint32_t query_beam_width = kDefaultQueryBeamWidth) {
+    return {kCPU, metric, max_degree, build_beam_width, query_beam_width};
+  }
+};
+
+/// Build an approximate nearest neighbor index over the embeddings of the
+/// nodes of pg, taken from the node property embedding_property_name, a
+/// fixed size list of floats. The index is stored in the node property
+/// index_property_name, which is created by this function and may not exist
+/// before the call, so it is saved and loaded with the other properties of
+/// the graph. The index of a node is a list of the ids of its neighbors on
+/// each layer it is on.
+KATANA_EXPORT Result<void> NearestNeighborsBuildIndex(
+    PropertyGraph* pg, const std::string& embedding_property_name,
+    const std::string& index_property_name, NearestNeighborsPlan plan = {});
+
+/// Find (approximately) the k nodes of pg whose embeddings are nearest to
+/// each of num_queries query embeddings, using the index built over
+/// embedding_property_name in index_property_name by
+/// NearestNeighborsBuildIndex. queries is row-major with the dimension of
+/// the embeddings. The neighbors of query q, nearest first, and their
+/// distances are stored in neighbors and distances at [q * k, (q + 1) * k);
+/// if pg has fewer than k nodes, the rest are the largest node id and
+/// infinity.
+KATANA_EXPORT Result<void> NearestNeighborsQuery(
+    PropertyGraph* pg, const std::string& embedding_property_name,
+    const std::string& index_property_name, const float* queries,
+    uint64_t num_queries, uint32_t k, GraphTopology::Node* neighbors,
+    float* distances, NearestNeighborsPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
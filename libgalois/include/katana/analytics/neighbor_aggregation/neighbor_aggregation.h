@@ -0,0 +1,107 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORAGGREGATION_NEIGHBORAGGREGATION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORAGGREGATION_NEIGHBORAGGREGATION_H_
+
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for neighbor aggregation, specifying how the
+/// features of the neighbors of a node are combined and the parameters of
+/// the pass over them.
+///
+/// Every node reads the features of its neighbors and writes its own
+/// aggregate, so no atomics are needed, with threads balanced by edges.
+/// Wide features are aggregated feature_block_size features at a time: each
+/// pass reads only that slice of the features of every node, so the slices
+/// of nodes with many neighbors stay in cache from one reader to the next.
+/// The loops over the features of a slice are contiguous and vectorize.
+class NeighborAggregationPlan : public Plan {
+public:
+  enum Aggregation {
+    /// The sum of the (weighted) features of the neighbors
+    kSum,
+    /// The sum divided by the number of neighbors or, with weights, by the
+    /// sum of the weights
+    kMean,
+    /// The largest (weighted) value of each feature among the neighbors
+    kMax,
+  };
+
+  enum Neighbors {
+    /// The destinations of the out-edges of a node
+    kOutNeighbors,
+    /// The sources of the in-edges of a node, e.g., the senders of the
+    /// messages to it
+    kInNeighbors,
+  };
+
+  static const uint32_t kDefaultFeatureBlockSize = 64;
+
+private:
+  Aggregation aggregation_;
+  Neighbors neighbors_;
+  uint32_t feature_block_size_;
+
+  NeighborAggregationPlan(
+      Architecture architecture, Aggregation aggregation, Neighbors neighbors,
+      uint32_t feature_block_size)
+      : Plan(architecture),
+        aggregation_(aggregation),
+        neighbors_(neighbors),
+        feature_block_size_(feature_block_size) {}
+
+public:
+  NeighborAggregationPlan() : NeighborAggregationPlan{Mean()} {}
+
+  Aggregation aggregation() const { return aggregation_; }
+  Neighbors neighbors() const { return neighbors_; }
+  /// The number of features aggregated in one pass over the edges, or 0 for
+  /// all of them.
+  uint32_t feature_block_size() const { return feature_block_size_; }
+
+  static NeighborAggregationPlan Sum(
+      Neighbors neighbors = kInNeighbors,
+      uint32_t feature_block_size = kDefaultFeatureBlockSize) {
+    return {kCPU, kSum, neighbors, feature_block_size};
+  }
+
+  static NeighborAggregationPlan Mean(
+      Neighbors neighbors = kInNeighbors,
+      uint32_t feature_block_size = kDefaultFeatureBlockSize) {
+    return {kCPU, kMean, neighbors, feature_block_size};
+  }
+
+  static NeighborAggregationPlan Max(
+      Neighbors neighbors = kInNeighbors,
+      uint32_t feature_block_size = kDefaultFeatureBlockSize) {
+    return {kCPU, kMax, neighbors, feature_block_size};
+  }
+};
+
+/// Aggregate the features of the neighbors of every node of pg, e.g., for
+/// the layers of a graph neural network. The features are read from the
+/// node property input_property_name, a fixed size list of floats or
+/// doubles, and the aggregates are stored as fixed size lists of floats of
+/// the same size in the node property named output_property_name, which is
+/// created by this function and may not exist before the call. A node
+/// without neighbors aggregates to zeros.
+///
+/// If edge_weight_property_name is not empty, the features of a neighbor are
+/// multiplied by the weight of the edge to it, taken from that edge property
+/// (which may be a 32- or 64-bit sign or unsigned int or a floating point
+/// number).
+KATANA_EXPORT Result<void> NeighborAggregation(
+    PropertyGraph* pg, const std::string& input_property_name,
+    const std::string& output_property_name,
+    const std::string& edge_weight_property_name = "",
+    NeighborAggregationPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORSAMPLING_NEIGHBORSAMPLING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_NEIGHBORSAMPLING_NEIGHBORSAMPLING_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/LargeArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Random.h"
+#include "katana/Result.h"
+
+namespace katana::analytics {
+
+/// A mini-batch of a graph sampled around some seed nodes, relabeled so that
+/// node i of the batch is nodes[i] of the graph.
+///
+/// The seeds come first, in the order given, followed by the nodes first
+/// reached at hop 1, then at hop 2, and so on: the nodes first reached at
+/// hop h are [hop_offsets[h], hop_offsets[h + 1]), with hop 0 the seeds.
+/// The nodes reached before the last hop are expanded, and the sampled
+/// out-edges of node i of them are [out_indices[i - 1], out_indices[i])
+/// (from 0 for node 0), to the batch nodes out_dests[e], along the edges
+/// edges[e] of the graph. So the edges sampled at hop h are those of the
+/// nodes reached at hop h - 1, a contiguous range.
+///
+/// The buffers keep their memory from one batch to the next.
+struct KATANA_EXPORT NeighborSample {
+  std::vector<uint32_t> nodes;
+  std::vector<uint64_t> hop_offsets;
+  std::vector<uint64_t> out_indices;
+  std::vector<uint32_t> out_dests;
+  std::vector<uint64_t> edges;
+
+  /// The node features of each node of the batch in turn, feature_width
+  /// values each, if the sampler gathers features
+  std::vector<float> features;
+  uint32_t feature_width{};
+
+  uint64_t num_nodes() const { return nodes.size(); }
+  uint64_t num_edges() const { return out_dests.size(); }
+  uint32_t num_hops() const { return hop_offsets.size() - 2; }
+
+  /// The sampled out-edges of batch node i
+  std::pair<uint64_t, uint64_t> edge_range(uint64_t i) const {
+    return {i == 0 ? 0 : out_indices[i - 1], out_indices[i]};
+  }
+
+  const float* node_features(uint64_t i) const {
+    return &features[i * feature_width];
+  }
+};
+
+/// Draws neighborhood samples of a graph, as for training a graph neural
+/// network on mini-batches.
+///
+/// At hop h, each node reached at hop h - 1 keeps fanouts[h - 1] of its
+/// out-edges, drawn by a random number generator local to each thread,
+/// uniformly or, if the sampler has weights, with probability proportional to
+/// the weight of each edge. Without replacement, a node keeps all of its
+/// edges if it does not have more than the fanout (edges of weight 0 are
+/// never drawn); with it, a node keeps exactly fanout edges if it has any.
+///
+/// A sampler keeps the scratch space of a batch from one batch to the next.
+/// It must not draw more than one batch at a time, and the graph must not
+/// change during its lifetime.
+class KATANA_EXPORT NeighborSampler {
+public:
+  /// Make a sampler that draws edges uniformly, gathering the node features
+  /// in the node properties feature_property_names. A feature property is
+  /// numeric, or a fixed size list of numbers, converted to float.
+  static Result<std::unique_ptr<NeighborSampler>> Make(
+      const PropertyGraph* pg,
+      const std::vector<std::string>& feature_property_names = {},
+      bool with_replacement = false);
+
+  /// Make a sampler that draws the edges of each node with probability
+  /// proportional to their weight, read from the edge property
+  /// edge_weight_property_name, whose values must not be negative
+  static Result<std::unique_ptr<NeighborSampler>> MakeWeighted(
+      PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::vector<std::string>& feature_property_names = {},
+      bool with_replacement = false);
+
+  /// Draw the hops of fanouts around seeds, which must be distinct, into
+  /// batch
+  Result<void> Sample(
+      const std::vector<uint32_t>& seeds, const std::vector<uint32_t>& fanouts,
+      NeighborSample* batch);
+
+  /// Set the seed of the random number generator of each thread, so that a
+  /// sequence of batches is the same if the threads draw the same edges
+  void Seed(uint64_t seed);
+
+  /// Use Make or MakeWeighted
+  NeighborSampler(
+      const PropertyGraph* pg, std::vector<double>&& weights,
+      bool with_replacement);
+
+private:
+  struct FeatureColumn {
+    std::shared_ptr<arrow::Array> values;
+    uint32_t width;
+    /// The property if it is lists, of which values are the elements
+    std::shared_ptr<arrow::FixedSizeListArray> lists;
+  };
+
+  struct ThreadState {
+    RandGenerator generator;
+    std::vector<uint32_t> positions;
+    std::vector<std::pair<double, uint64_t>> keys;
+  };
+
+  Result<void> AddFeature(const std::string& name);
+  uint64_t Fanout(uint32_t node, uint32_t fanout) const;
+  void SampleEdges(
+      uint32_t node, uint32_t fanout, ThreadState* state, uint64_t* out);
+  void GatherFeatures(NeighborSample* batch) const;
+
+  const PropertyGraph* pg_;
+  bool with_replacement_;
+  /// The weight of each edge, empty if uniform
+  std::vector<double> weights_;
+  /// The number of edges of each node with a weight above 0, if weighted
+  std::vector<uint32_t> positive_degrees_;
+  /// The prefix sums of the weights of the edges of each node, if weighted
+  /// with replacement
+  std::vector<double> cumulative_weights_;
+
+  std::vector<FeatureColumn> features_;
+  uint32_t feature_width_{};
+
+  PerThreadStorage<ThreadState> threads_;
+  /// The batch node of each node of the graph, or none; only the nodes of
+  /// the batch being drawn have one
+  LargeArray<std::atomic<uint32_t>> batch_ids_;
+  /// The first of the edges sampled at a hop to each node not yet in the
+  /// batch, or none
+  LargeArray<std::atomic<uint64_t>> first_edges_;
+  std::vector<uint64_t> new_ranks_;
+};
+
+/// Samples a sequence of batches on a background thread, up to depth batches
+/// ahead of the one in use, so that sampling overlaps consuming them.
+class KATANA_EXPORT NeighborSampleLoader {
+public:
+  /// The sampler and the vectors of seeds must outlive the loader
+  NeighborSampleLoader(
+      NeighborSampler* sampler,
+      const std::vector<std::vector<uint32_t>>* seed_batches,
+      std::vector<uint32_t> fanouts, size_t depth = 2);
+  ~NeighborSampleLoader();
+
+  NeighborSampleLoader(const NeighborSampleLoader&) = delete;
+  NeighborSampleLoader& operator=(const NeighborSampleLoader&) = delete;
+
+  /// The next batch, in the order of seed_batches, or nullptr after the
+  /// last. The batch stays valid until the next call.
+  Result<const NeighborSample*> Next();
+
+private:
+  struct Slot {
+    NeighborSample batch;
+    /// Errors cannot pass between threads as ErrorInfo
+    std::optional<CopyableErrorInfo> error;
+  };
+
+  void Produce();
+
+  NeighborSampler* sampler_;
+  const std::vector<std::vector<uint32_t>>* seed_batches_;
+  std::vector<uint32_t> fanouts_;
+  std::vector<Slot> slots_;
+
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  /// Batches sampled so far
+  size_t produced_{0};
+  /// Batches returned by Next so far
+  size_t consumed_{0};
+  std::atomic<bool> stopping_{false};
+  std::thread producer_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,10 +2,14 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_PAGERANK_PAGERANK_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
+#include "katana/TemporalWindow.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/Sparsify.h"
 
 namespace katana::analytics {
 
@@ -18,27 +22,46 @@ public:
     kPullResidual,
     kPushSynchronous,
     kPushAsynchronous,
+    kPullBlocked,
+  };
+
+  /// The format of the per-node values that pull algorithms read per edge
+  enum Precision {
+    kFloat,
+    /// katana::BFloat16, half the bytes of float. Ranks are still
+    /// accumulated in float, and once the ranks stop changing by more than
+    /// the rounding of bfloat16 allows, the iterations go on in float until
+    /// the tolerance is met. Used by kPullTopological and kPullBlocked.
+    kBFloat16,
   };
 
   static constexpr double kDefaultTolerance = 1.0e-3;
   static const int kDefaultMaxIterations = 1000;
   static constexpr double kDefaultAlpha = 0.85;
+  /// 2^18 nodes, whose float contributions take 1 MiB
+  static constexpr uint32_t kDefaultSegmentSize = 1U << 18U;
 
 private:
   Algorithm algorithm_;
   float tolerance_;
   unsigned int max_iterations_;
   float alpha_;
+  uint32_t segment_size_;
+  Precision precision_;
 
 public:
   PagerankPlan(
       Architecture architecture, Algorithm algorithm, float tolerance,
-      unsigned int max_iterations, float alpha)
+      unsigned int max_iterations, float alpha,
+      uint32_t segment_size = kDefaultSegmentSize,
+      Precision precision = kFloat)
       : Plan(architecture),
         algorithm_(algorithm),
         tolerance_(tolerance),
         max_iterations_(max_iterations),
-        alpha_(alpha) {}
+        alpha_(alpha),
+        segment_size_(segment_size),
+        precision_(precision) {}
 
   constexpr static const unsigned kChunkSize = 16U;
 
@@ -55,6 +78,10 @@ public:
   unsigned int max_iterations() const { return max_iterations_; }
   float alpha() const { return alpha_; }
   float initial_residual() const { return 1 - alpha_; }
+  /// The number of source nodes whose ranks are read together by
+  /// kPullBlocked
+  uint32_t segment_size() const { return segment_size_; }
+  Precision precision() const { return precision_; }
 
   /// Topological pull algorithm
   ///
@@ -62,8 +89,10 @@ public:
   static PagerankPlan PullTopological(
       float tolerance = kDefaultTolerance,
       unsigned int max_iterations = kDefaultMaxIterations,
-      float alpha = kDefaultAlpha) {
-    return {kCPU, kPullTopological, tolerance, max_iterations, alpha};
+      float alpha = kDefaultAlpha, Precision precision = kFloat) {
+    return PagerankPlan{
+        kCPU, kPullTopological, tolerance, max_iterations, alpha,
+        kDefaultSegmentSize, precision};
   }
 
   /// Delta-residual pull algorithm
@@ -76,6 +105,27 @@ public:
     return {kCPU, kPullResidual, tolerance, max_iterations, alpha};
   }
 
+  /// Segmented topological pull algorithm
+  ///
+  /// Like PullTopological, but the in-edges are split into segments by their
+  /// source and each iteration pulls one segment at a time, so the ranks it
+  /// reads stay in cache on graphs much larger than the last level cache.
+  /// segment_size should be chosen so that segment_size floats fit in a
+  /// core's share of the cache. Each iteration only uses the ranks of the
+  /// previous one.
+  ///
+  /// The graph must be transposed to use this algorithm.
+  static PagerankPlan PullBlocked(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha,
+      uint32_t segment_size = kDefaultSegmentSize,
+      Precision precision = kFloat) {
+    return PagerankPlan{
+        kCPU, kPullBlocked, tolerance, max_iterations, alpha, segment_size,
+        precision};
+  }
+
   /// Asynchronous push algorithm
   ///
   /// This implementation is based on the Push-based PageRank computation
@@ -103,15 +153,96 @@ public:
       float alpha = kDefaultAlpha) {
     return {kCPU, kPushSynchronous, tolerance, max_iterations, alpha};
   }
+
+  /// Synchronous topological push algorithm on a partition of a graph
+  /// partitioned across the hosts of the job (see MirrorSync). Every host
+  /// calls Pagerank on its partition.
+  static PagerankPlan Distributed(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha) {
+    return {
+        kDistributedCPU, kPushSynchronous, tolerance, max_iterations, alpha};
+  }
 };
 
 /// Compute the Page Rank of each node in the graph.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
+///
+/// The pull algorithms resume from the checkpoint of the Checkpointer of the
+/// calling thread, if any, and save their state to it (see Checkpoint.h).
 KATANA_EXPORT Result<void> Pagerank(
     PropertyGraph* pg, const std::string& output_property_name,
     PagerankPlan plan = {});
 
+/// Compute the Page Rank of each node over the edges of window alone,
+/// without copying the graph, by pushing residuals in rounds as
+/// PagerankPlan::PushSynchronous does. Only the tolerance, alpha and maximum
+/// number of iterations of plan are used. The property named
+/// output_property_name is created on window.graph() by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> Pagerank(
+    const TemporalWindow& window, const std::string& output_property_name,
+    PagerankPlan plan = {});
+
+/// Edges inserted into and deleted from a graph, as (source, destination)
+/// pairs. Each entry inserts or deletes one edge, so a change to a multi-edge
+/// appears once per copy.
+struct KATANA_EXPORT PagerankEdgeChanges {
+  std::vector<std::pair<uint32_t, uint32_t>> inserted;
+  std::vector<std::pair<uint32_t, uint32_t>> deleted;
+};
+
+/// Update a Page Rank computed by Pagerank after the edges of the graph
+/// changed, without recomputing it from scratch.
+///
+/// pg is the graph after the changes and rank_property_name holds the ranks
+/// of the graph before them; the ranks are updated in place. The nodes of the
+/// graph must not have changed. Residuals are seeded only at the neighbors
+/// of the sources of changed edges and then pushed asynchronously, as in
+/// PagerankPlan::PushAsynchronous, until they are all below the tolerance of
+/// the plan. The plan's alpha must be the one the ranks were computed with.
+///
+/// The work is proportional to the part of the graph whose rank changes by
+/// more than the tolerance, which is usually far smaller than the graph when
+/// few edges change.
+KATANA_EXPORT Result<void> PagerankIncremental(
+    PropertyGraph* pg, const std::string& rank_property_name,
+    const PagerankEdgeChanges& changes, PagerankPlan plan = {});
+
+/// Compute the personalized Page Rank of each node for many seed sets.
+///
+/// The ranks for seed_sets[i] are stored in a new property named
+/// output_property_names[i]. A personalized Page Rank is the Page Rank of a
+/// walk that restarts at a seed of the set instead of at any node, so the
+/// ranks of each set add up to at most initial_residual; the tolerance of the
+/// plan should be chosen accordingly. Only the tolerance and alpha of the
+/// plan are used.
+///
+/// Seed sets are computed in batches by the push-residual algorithm with one
+/// lane per seed set, which traverses the graph once for a whole batch.
+KATANA_EXPORT Result<void> PagerankPersonalized(
+    PropertyGraph* pg, const std::vector<std::vector<uint32_t>>& seed_sets,
+    const std::vector<std::string>& output_property_names,
+    PagerankPlan plan = {});
+
+/// Approximate the Page Rank of each node of pg by computing it with plan on
+/// the sparsification of pg by sparsify_plan, which keeps all the nodes.
+/// Each sampled node keeps its share of its out-edges in expectation, so
+/// the walk the ranks describe changes little. The ranks are stored in the
+/// new node property output_property_name of pg.
+///
+/// The estimated_error of the returned statistics bounds the L1 distance of
+/// the ranks from the exact ranks, relative to their sum: it is the change
+/// of the ranks by one pull iteration on pg, over (1 - alpha) times their
+/// sum. The bound takes one pass over the in-edges of pg, with the
+/// teleport term fitted to the ranks so that any normalization of the
+/// ranks is measured alike.
+KATANA_EXPORT Result<ApproximationStatistics> ApproximatePagerank(
+    PropertyGraph* pg, const std::string& output_property_name,
+    SparsifyPlan sparsify_plan = {}, PagerankPlan plan = {});
+
 KATANA_EXPORT Result<void> PagerankAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
@@ -0,0 +1,110 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_POINTSTO_POINTSTO_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_POINTSTO_POINTSTO_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// The kinds of constraint, as values of the constraint kind edge property.
+/// An edge from src to dst stands for the statement given for its kind.
+enum class PointsToConstraint : uint8_t {
+  /// dst = &src
+  kAddressOf = 0,
+  /// dst = src
+  kCopy = 1,
+  /// dst = *src
+  kLoad = 2,
+  /// *dst = src
+  kStore = 3,
+  /// dst = src + offset; the analysis is field-insensitive, so this is a copy
+  kGetElementPtr = 4,
+};
+
+/// A computational plan for points-to analysis, specifying the algorithm and
+/// any parameters associated with it.
+class PointsToPlan : public Plan {
+public:
+  enum Algorithm {
+    kDifferencePropagation,
+  };
+
+  static const bool kDefaultDetectCycles = true;
+
+private:
+  Algorithm algorithm_;
+  bool detect_cycles_;
+
+  PointsToPlan(
+      Architecture architecture, Algorithm algorithm, bool detect_cycles)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        detect_cycles_(detect_cycles) {}
+
+public:
+  PointsToPlan() : PointsToPlan{DifferencePropagation()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  bool detect_cycles() const { return detect_cycles_; }
+
+  /// Andersen's analysis by rounds of parallel difference propagation: each
+  /// round, every variable whose points-to set grew sends only the new
+  /// pointees along its copy edges and resolves its loads and stores for
+  /// them. Sets are SparseBitmaps, so unions and differences work a cache
+  /// line at a time.
+  ///
+  /// If detect_cycles is true, variables on cycles of copy edges, which must
+  /// end up with equal sets, are collapsed into one. Cycles are found by
+  /// hybrid cycle detection (Hardekopf and Lin): an offline pass over the
+  /// constraints collapses cycles of copies and records which pointees of a
+  /// pointer will close a cycle through a load or store; lazy cycle detection
+  /// searches for the rest from copy edges that stop changing their target.
+  static PointsToPlan DifferencePropagation(
+      bool detect_cycles = kDefaultDetectCycles) {
+    return {kCPU, kDifferencePropagation, detect_cycles};
+  }
+};
+
+/// Compute the points-to sets of Andersen's inclusion-based, flow- and
+/// context-insensitive pointer analysis. The nodes of pg are the variables
+/// and abstract objects of a program and its edges are the constraints
+/// between them, with their kinds in the edge property named
+/// constraint_kind_property_name; see PointsToConstraint. The kinds may be
+/// any 8-, 32- or 64-bit int. Each node's set, as a list of node ids in
+/// increasing order, is stored in the node property named
+/// output_property_name, of type large_list<uint32>.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> PointsTo(
+    PropertyGraph* pg, const std::string& constraint_kind_property_name,
+    const std::string& output_property_name, PointsToPlan plan = {});
+
+/// Check that output_property_name is the least solution of the constraints,
+/// as found by a naive serial solver.
+KATANA_EXPORT Result<void> PointsToAssertValid(
+    PropertyGraph* pg, const std::string& constraint_kind_property_name,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT PointsToStatistics {
+  /// The total size of the points-to sets.
+  uint64_t n_points_to_facts;
+  /// The number of nodes that point to something.
+  uint64_t n_pointers;
+  /// The size of the largest points-to set.
+  uint64_t max_points_to_size;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<PointsToStatistics> Compute(
+      PropertyGraph* pg, const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -6,6 +6,7 @@
 #include <katana/analytics/Plan.h>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/LargeArray.h"
 #include "katana/analytics/Utils.h"
 
 // API
@@ -95,7 +96,11 @@ public:
 
   uint32_t number_of_edge_types() const { return number_of_edge_types_; }
 
-  /// Node2Vec algorithm to generate random walks on the graph
+  /// Node2Vec algorithm to generate random walks on the graph. Each step
+  /// draws a neighbor of the current node, from an alias table if the edges
+  /// are weighted, and accepts it by rejection sampling on its distance from
+  /// the previous node; the neighbors of high-degree nodes are cached in
+  /// bitmaps for that test.
   static RandomWalksPlan Node2Vec(
       uint32_t walk_length = kDefaultWalkLength,
       uint32_t number_of_walks = kDefaultNumberOfWalks,
@@ -140,6 +145,36 @@ public:
 KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
     PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
 
+/// Random walks in one contiguous buffer, number_of_walks for each node in
+/// turn: walk i starts at node i % num_nodes and is the lengths[i] nodes
+/// starting at nodes[i * stride]. A walk is walk_length + 1 nodes long unless
+/// it reaches a node it cannot leave, and it is empty if it starts at one.
+/// The rest of each stride is unspecified.
+struct KATANA_EXPORT RandomWalksBuffer {
+  katana::LargeArray<uint32_t> nodes;
+  katana::LargeArray<uint32_t> lengths;
+  uint32_t stride{};
+
+  size_t num_walks() const { return lengths.size(); }
+  const uint32_t* walk(size_t i) const { return &nodes[i * stride]; }
+};
+
+/// Compute the random walks of pg like RandomWalks, but write them into a
+/// buffer allocated up front instead of one vector per walk. Only Node2Vec is
+/// supported.
+KATANA_EXPORT Result<RandomWalksBuffer> RandomWalksToBuffer(
+    PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
+
+/// Compute the random walks of pg into a buffer, stepping from a node to a
+/// neighbor with probability proportional to the weight of the edge between
+/// them, read from the property edge_weight_property_name, before the
+/// Node2Vec bias towards or away from the previous node is applied. Weights
+/// must not be negative; a node whose edges all have weight 0 ends a walk.
+/// The weights are read before the edges of pg are sorted by destination.
+KATANA_EXPORT Result<RandomWalksBuffer> RandomWalksToBuffer(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    RandomWalksPlan plan = RandomWalksPlan());
+
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
 }  // namespace katana::analytics
@@ -0,0 +1,129 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_REACHABILITYINDEX_REACHABILITYINDEX_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_REACHABILITYINDEX_REACHABILITYINDEX_H_
+
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// The distance ReachabilityIndexQuery reports between nodes when the
+/// target is not reachable from the source
+constexpr uint32_t kReachabilityIndexUnreachable =
+    std::numeric_limits<uint32_t>::max();
+
+/// A computational plan for the reachability index, a 2-hop labeling that
+/// answers hop distance and reachability queries between pairs of nodes.
+///
+/// Every node is a hub, ranked by descending degree (NodeOrder::kDegree).
+/// The label of a node lists hubs with their distance from the node (its
+/// out-label) and to the node (its in-label), so that the distance from s
+/// to t is the least sum over the hubs common to the out-label of s and
+/// the in-label of t. Hubs are searched from in rank order, and the search
+/// from a hub is pruned at every node whose distance the labels of the
+/// higher ranked hubs already give (Akiba, Iwata and Yoshida, "Fast Exact
+/// Shortest-Path Distance Queries on Large Networks by Pruned Landmark
+/// Labeling", SIGMOD 2013). No search continues into a node ranked above
+/// its hub, so a few high degree hubs cover most pairs and the labels stay
+/// small on social and other small-world graphs.
+class ReachabilityIndexPlan : public Plan {
+public:
+  enum Algorithm {
+    kPrunedLandmarkLabeling,
+  };
+
+  static constexpr uint32_t kDefaultNumBitParallelHubs = 64;
+  static constexpr uint32_t kMaxBitParallelHubs = 64;
+
+private:
+  Algorithm algorithm_;
+  uint32_t num_bit_parallel_hubs_;
+  bool symmetric_;
+
+  ReachabilityIndexPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t num_bit_parallel_hubs, bool symmetric)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        num_bit_parallel_hubs_(num_bit_parallel_hubs),
+        symmetric_(symmetric) {}
+
+public:
+  ReachabilityIndexPlan() : ReachabilityIndexPlan{PrunedLandmarkLabeling()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of highest ranked hubs searched from at once
+  uint32_t num_bit_parallel_hubs() const { return num_bit_parallel_hubs_; }
+  /// Whether the graph is symmetric, so that in- and out-labels are equal
+  bool symmetric() const { return symmetric_; }
+
+  /// Pruned landmark labeling. The searches from the
+  /// num_bit_parallel_hubs highest ranked hubs, which reach most of the
+  /// graph, run as one bit-parallel breadth-first search (MultiSourceBfs)
+  /// and are pruned afterwards. The other hubs are searched from in
+  /// parallel batches of doubling size; the searches of a batch are pruned
+  /// by the labels of the hubs before it, which leaves a few redundant
+  /// entries but no wrong answers. If symmetric, the graph must be
+  /// symmetric (e.g., made by CreateSymmetricGraph) and only one label per
+  /// node is built and stored.
+  static ReachabilityIndexPlan PrunedLandmarkLabeling(
+      uint32_t num_bit_parallel_hubs = kDefaultNumBitParallelHubs,
+      bool symmetric = false) {
+    return {kCPU, kPrunedLandmarkLabeling, num_bit_parallel_hubs, symmetric};
+  }
+};
+
+/// Build the reachability index of pg along its out-edges. The in-label of
+/// each node is stored in the node property index_property_prefix +
+/// "-from" and its out-label, unless plan.symmetric(), in
+/// index_property_prefix + "-to". Each label is a list of (hub, distance)
+/// structs of uint32, ordered by hub, where hub is the rank of the hub
+/// node. The properties are created by this function and may not exist
+/// before the call; they are persisted with the rest of the graph, so the
+/// index is built once for a static topology.
+KATANA_EXPORT Result<void> ReachabilityIndex(
+    PropertyGraph* pg, const std::string& index_property_prefix,
+    ReachabilityIndexPlan plan = {});
+
+/// Answer num_queries hop distance queries with the index of pg stored with
+/// index_property_prefix by ReachabilityIndex. The distance from
+/// sources[q] to targets[q] is stored in distances[q], or
+/// kReachabilityIndexUnreachable if there is no path. Queries are answered
+/// in parallel, each by one intersection of two labels.
+KATANA_EXPORT Result<void> ReachabilityIndexQuery(
+    PropertyGraph* pg, const std::string& index_property_prefix,
+    const GraphTopology::Node* sources, const GraphTopology::Node* targets,
+    uint64_t num_queries, uint32_t* distances);
+
+/// Like ReachabilityIndexQuery, but only store whether targets[q] is
+/// reachable from sources[q] in reachable[q], which stops each
+/// intersection at the first common hub.
+KATANA_EXPORT Result<void> ReachabilityIndexReachable(
+    PropertyGraph* pg, const std::string& index_property_prefix,
+    const GraphTopology::Node* sources, const GraphTopology::Node* targets,
+    uint64_t num_queries, bool* reachable);
+
+struct KATANA_EXPORT ReachabilityIndexStatistics {
+  /// The number of (hub, distance) entries of all labels.
+  uint64_t total_label_size;
+  /// The number of entries of the largest label.
+  uint64_t max_label_size;
+  /// The average number of entries of a label.
+  double average_label_size;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<ReachabilityIndexStatistics> Compute(
+      PropertyGraph* pg, const std::string& index_property_prefix);
+};
+
+}  // namespace katana::analytics
+
+#endif
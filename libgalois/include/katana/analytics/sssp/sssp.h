@@ -2,9 +2,14 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_SSSP_SSSP_H_
 
 #include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/TopologySummary.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -29,6 +34,10 @@ public:
   };
 
   static const int kDefaultDelta = 13;
+  /// Pass as the delta of a delta-stepping plan to choose the delta from a
+  /// sample of the edge weights and degrees, and to keep tuning the bucket
+  /// width from bucket occupancy while the algorithm runs.
+  static const unsigned kAdaptiveDelta = std::numeric_limits<unsigned>::max();
   static const int kDefaultEdgeTileSize = 512;
 
   // Don't allow people to directly construct these, so as to have only one
@@ -57,9 +66,19 @@ public:
   SsspPlan(const katana::PropertyGraph* pg) : Plan(kCPU) {
     bool isPowerLaw = IsApproximateDegreeDistributionPowerLaw(*pg);
     if (isPowerLaw) {
-      *this = DeltaStep();
+      *this = DeltaStep(kAdaptiveDelta);
     } else {
-      *this = DeltaStepBarrier();
+      *this = DeltaStepBarrier(kAdaptiveDelta);
+    }
+  }
+
+  /// The plan SsspPlan(pg) chooses for a graph summarized by summary, before
+  /// loading it
+  SsspPlan(const TopologySummary& summary) : Plan(kCPU) {
+    if (summary.power_law) {
+      *this = DeltaStep(kAdaptiveDelta);
+    } else {
+      *this = DeltaStepBarrier(kAdaptiveDelta);
     }
   }
 
@@ -67,6 +86,8 @@ public:
 
   /// The exponent of the delta step size (2 based). A delta of 4 will produce a real delta step size of 16.
   unsigned delta() const { return delta_; }
+  /// True if the algorithm chooses and tunes the delta; see kAdaptiveDelta.
+  bool adaptive_delta() const { return delta_ == kAdaptiveDelta; }
   ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
 
   static SsspPlan DeltaTile(
@@ -102,6 +123,13 @@ public:
 
   static SsspPlan Topological() { return {kCPU, kTopological, 0, 0}; }
 
+  /// Synchronous Bellman-Ford on a partition of a graph partitioned across
+  /// the hosts of the job (see MirrorSync), with the start node given by
+  /// its id in the RDG. Every host calls Sssp on its partition.
+  static SsspPlan Distributed() {
+    return {kDistributedCPU, kTopological, 0, 0};
+  }
+
   static SsspPlan TopologicalTile(
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
     return {kCPU, kTopologicalTile, 0, edge_tile_size};
@@ -121,6 +149,26 @@ KATANA_EXPORT Result<void> Sssp(
     const std::string& edge_weight_property_name,
     const std::string& output_property_name, SsspPlan plan = {});
 
+/// Compute the shortest path lengths from each of sources at once. The edge
+/// weights are taken from the property named edge_weight_property_name
+/// (which may be a 32- or 64-bit signed or unsigned int, float or double, and
+/// must not be negative). The result is stored in a property named by
+/// output_property_name: a fixed-size list of sources.size() values per node,
+/// of the type of the weights, whose element i is the length of the shortest
+/// path from sources[i], or std::numeric_limits<Weight>::max() / 4 (as for
+/// Sssp) if there is none.
+///
+/// Sources are relaxed together in batches: every node holds a row of
+/// distances, one per source of the batch, and an edge relaxes the whole row
+/// at once, so each edge is read once per round of a batch rather than once
+/// per source and the relaxations vectorize.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> SsspMultiSource(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name);
+
 KATANA_EXPORT Result<void> SsspAssertValid(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
@@ -141,6 +189,109 @@ struct KATANA_EXPORT SsspStatistics {
       PropertyGraph* pg, const std::string& output_property_name);
 };
 
+/// A computational plan for shortest path queries between pairs of nodes.
+class ShortestPathPlan : public Plan {
+public:
+  enum Algorithm {
+    kBidirectionalDijkstra,
+    kDijkstra,
+    kLandmarks,
+  };
+
+  static const uint32_t kDefaultNumLandmarks = 16;
+
+private:
+  Algorithm algorithm_;
+  std::string landmarks_property_prefix_;
+
+  ShortestPathPlan(
+      Architecture architecture, Algorithm algorithm,
+      std::string landmarks_property_prefix = "")
+      : Plan(architecture),
+        algorithm_(algorithm),
+        landmarks_property_prefix_(std::move(landmarks_property_prefix)) {}
+
+public:
+  ShortestPathPlan() : ShortestPathPlan{kCPU, kBidirectionalDijkstra} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The prefix of the properties that hold the landmark distances.
+  const std::string& landmarks_property_prefix() const {
+    return landmarks_property_prefix_;
+  }
+
+  /// Search forward from the source and backward from the target along the
+  /// in-edge index of the graph, expanding the smaller of the two
+  /// frontiers, and stop once no path through the unsettled nodes can be
+  /// shorter than the best path through a node reached by both searches.
+  /// Builds the in-edge index if it is not cached yet.
+  static ShortestPathPlan BidirectionalDijkstra() {
+    return {kCPU, kBidirectionalDijkstra};
+  }
+
+  /// Search forward from the source only and stop once the target is
+  /// settled. Needs no in-edge index.
+  static ShortestPathPlan Dijkstra() { return {kCPU, kDijkstra}; }
+
+  /// A* search guided by the landmark distances that
+  /// ShortestPathLandmarks stored in the properties with the given prefix,
+  /// as in
+  ///   Andrew V. Goldberg and Chris Harrelson. Computing the Shortest Path:
+  ///   A* Search Meets Graph Theory. SODA 2005.
+  /// By the triangle inequality, the distances between each landmark and
+  /// the target bound the distance from a node to the target from below,
+  /// which steers the search toward the target and stops it once the target
+  /// is settled.
+  static ShortestPathPlan Landmarks(
+      const std::string& landmarks_property_prefix) {
+    return {kCPU, kLandmarks, landmarks_property_prefix};
+  }
+};
+
+/// A shortest path between two nodes.
+struct KATANA_EXPORT ShortestPathResult {
+  /// The nodes of the path from the source to the target; empty if the
+  /// target is not reachable.
+  std::vector<uint32_t> path;
+  /// The total edge weight of the path; infinity if there is none.
+  double distance{std::numeric_limits<double>::infinity()};
+
+  bool reachable() const { return !path.empty(); }
+};
+
+/// Build the landmark index used by ShortestPathPlan::Landmarks for the
+/// edge weights in the property named edge_weight_property_name. The first
+/// landmark is the node with the most out-edges and each next one is the
+/// node farthest from the landmarks chosen so far. The distances from
+/// landmark i to every node are stored in the node property
+/// landmarks_property_prefix + "-from-" + i and the distances from every
+/// node to it in landmarks_property_prefix + "-to-" + i, using the
+/// parallel Sssp; the distances to the landmarks are computed on the in-edge
+/// index. The properties are persisted with the rest of the graph, so the
+/// index is built once for a static topology and weights. Fewer landmarks
+/// are chosen if fewer nodes are reachable.
+KATANA_EXPORT Result<void> ShortestPathLandmarks(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& landmarks_property_prefix,
+    uint32_t num_landmarks = ShortestPathPlan::kDefaultNumLandmarks);
+
+/// Find a shortest path from source to target in pg without computing the
+/// distances to other nodes. The edge weights are taken from the property
+/// named edge_weight_property_name (which may be a 32- or 64-bit sign or
+/// unsigned int or a floating point number) and may not be negative.
+/// Each query runs on the calling thread.
+KATANA_EXPORT Result<ShortestPathResult> ShortestPath(
+    PropertyGraph* pg, size_t source, size_t target,
+    const std::string& edge_weight_property_name, ShortestPathPlan plan = {});
+
+/// Answer a batch of shortest path queries, each a (source, target) pair.
+/// Queries run in parallel, one per thread at a time, and each thread reuses
+/// its search buffers across the queries it answers.
+KATANA_EXPORT Result<std::vector<ShortestPathResult>> ShortestPaths(
+    PropertyGraph* pg,
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+    const std::string& edge_weight_property_name, ShortestPathPlan plan = {});
+
 }  // namespace katana::analytics
 
 #endif
@@ -0,0 +1,87 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+
+#include <iostream>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan to for StronglyConnectedComponents, specifying the
+/// algorithm and any parameters associated with it.
+class StronglyConnectedComponentsPlan : public Plan {
+public:
+  /// Algorithm selectors for strongly connected components
+  enum Algorithm { kForwardBackward, kColoring };
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+
+  StronglyConnectedComponentsPlan(
+      Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  StronglyConnectedComponentsPlan()
+      : StronglyConnectedComponentsPlan{kCPU, kForwardBackward} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Trim nodes without in- or out-edges, then find the component of a
+  /// high degree pivot as the intersection of its forward and backward
+  /// reachable sets. Real world graphs usually have one giant component,
+  /// which this finds with two breadth first searches. The remaining
+  /// nodes are trimmed again and split up by coloring.
+  static StronglyConnectedComponentsPlan ForwardBackward() {
+    return {kCPU, kForwardBackward};
+  }
+
+  /// Trim nodes without in- or out-edges, then repeatedly propagate the
+  /// minimum node id forward as a color. A node that keeps its own color
+  /// is the root of a component, which consists of the nodes of that
+  /// color that reach the root backward. Needs no pivot but many rounds on
+  /// graphs of large diameter.
+  static StronglyConnectedComponentsPlan Coloring() {
+    return {kCPU, kColoring};
+  }
+};
+
+/// Compute the strongly connected components of pg. The graph is treated
+/// as directed; its in-edge index is built if it does not exist yet. Each
+/// node is labeled with the smallest node id in its component.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> StronglyConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    StronglyConnectedComponentsPlan plan = {});
+
+/// Check that each component in property_name is strongly connected and that
+/// no two components are on a common cycle, i.e., the components are
+/// maximal.
+KATANA_EXPORT Result<void> StronglyConnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT StronglyConnectedComponentsStatistics {
+  /// Total number of unique components in the graph.
+  uint64_t total_components;
+  /// Total number of components with more than 1 node.
+  uint64_t total_non_trivial_components;
+  /// The number of nodes present in the largest component.
+  uint64_t largest_component_size;
+  /// The ratio of nodes present in the largest component.
+  double largest_component_ratio;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<StronglyConnectedComponentsStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+#endif
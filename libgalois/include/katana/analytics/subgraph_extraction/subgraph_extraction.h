@@ -1,6 +1,10 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
 
@@ -13,6 +17,7 @@ class SubGraphExtractionPlan : public Plan {
 public:
   enum Algorithm {
     kNodeSet,
+    kNodeSetScan,
   };
 
 private:
@@ -22,7 +27,7 @@ private:
       : Plan(architecture), algorithm_(algorithm) {}
 
 public:
-  SubGraphExtractionPlan() : SubGraphExtractionPlan{kCPU, kNodeSet} {}
+  SubGraphExtractionPlan() : SubGraphExtractionPlan{kCPU, kNodeSetScan} {}
 
   Algorithm algorithm() const { return algorithm_; }
 
@@ -38,14 +43,32 @@ public:
    * The node-set algorithm:
    *    Given a set of node ids, this algorithm constructs a new sub-graph
    *    connecting all the nodes in the set along with the properties requested.
+   *    It sorts the edges of the graph by destination and searches the edges
+   *    of each node of the set for every other node of the set.
    */
   static SubGraphExtractionPlan NodeSet() { return {kCPU, kNodeSet}; }
+
+  /**
+   * The node-set scan algorithm:
+   *    Marks the nodes of the set in a bitmap and scans the edges of each of
+   *    them once, in parallel, keeping those to marked nodes; the edges of
+   *    the sub-graph are placed by a prefix sum of their counts. The work is
+   *    linear in the degrees of the nodes of the set, and the graph is left
+   *    unsorted. This is the default.
+   */
+  static SubGraphExtractionPlan NodeSetScan() { return {kCPU, kNodeSetScan}; }
+
+  static SubGraphExtractionPlan FromAlgorithm(Algorithm algorithm) {
+    return {kCPU, algorithm};
+  }
 };
 
 /**
  * Construct a new sub-graph from the original graph.
  *
- * By default only topology of the sub-graph is constructed.
+ * Node i of the sub-graph is the i-th distinct node of node_vec, and its
+ * edges are the edges of that node to nodes of node_vec. Only the topology
+ * of the sub-graph is constructed.
  * The new sub-graph is independent of the original graph.
  *
  * @param pg The graph to process.
@@ -57,7 +80,25 @@ SubGraphExtraction(
     katana::PropertyGraph* pg,
     const std::vector<katana::PropertyGraph::Node>& node_vec,
     SubGraphExtractionPlan plan = {});
-// const std::vector<std::string>& node_properties_to_copy, const std::vector<std::string>& edge_properties_to_copy);
+
+/**
+ * Construct a new sub-graph from the original graph, as above, with copies
+ * of the node properties node_properties_to_copy of its nodes and of the edge
+ * properties edge_properties_to_copy of its edges, gathered by arrow Take.
+ *
+ * @param pg The graph to process.
+ * @param node_vec Set of node IDs
+ * @param node_properties_to_copy Names of node properties of pg
+ * @param edge_properties_to_copy Names of edge properties of pg
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtraction(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& node_vec,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    SubGraphExtractionPlan plan = {});
 
 }  // namespace katana::analytics
 
@@ -0,0 +1,120 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHMATCH_SUBGRAPHMATCH_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHMATCH_SUBGRAPHMATCH_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A small directed graph to find in a PropertyGraph. Its nodes are numbered
+/// from 0 in the order they are added, and each node and edge may require a
+/// type of the nodes and edges matching it.
+class SubgraphPattern {
+public:
+  static const uint32_t kMaxNodes = 8;
+
+  struct Edge {
+    uint32_t src;
+    uint32_t dst;
+    /// The type of the matching edges, or empty for any edge
+    std::string type;
+  };
+
+  /// Add a node matching the nodes with type or, if it is empty, any node
+  /// \returns the id of the node
+  uint32_t AddNode(const std::string& type = "") {
+    node_types_.emplace_back(type);
+    return node_types_.size() - 1;
+  }
+
+  /// Add an edge from src to dst matching the edges with type or, if it is
+  /// empty, any edge
+  void AddEdge(uint32_t src, uint32_t dst, const std::string& type = "") {
+    edges_.emplace_back(Edge{src, dst, type});
+  }
+
+  uint32_t num_nodes() const { return node_types_.size(); }
+  const std::vector<std::string>& node_types() const { return node_types_; }
+  const std::vector<Edge>& edges() const { return edges_; }
+
+private:
+  std::vector<std::string> node_types_;
+  std::vector<Edge> edges_;
+};
+
+/// A computational plan for subgraph matching, specifying the algorithm and
+/// the parameters associated with it.
+class SubgraphMatchPlan : public Plan {
+public:
+  enum Algorithm {
+    kGenericJoin,
+  };
+
+  static const uint32_t kDefaultSplitDepth = 2;
+
+private:
+  Algorithm algorithm_;
+  uint32_t split_depth_;
+
+  SubgraphMatchPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t split_depth)
+      : Plan(architecture), algorithm_(algorithm), split_depth_(split_depth) {}
+
+public:
+  SubgraphMatchPlan() : SubgraphMatchPlan{GenericJoin()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The partial matches of fewer pattern nodes are work items that idle
+  /// threads may steal
+  uint32_t split_depth() const { return split_depth_; }
+
+  /// A worst-case optimal generic join: the pattern nodes are matched one at
+  /// a time, each connected to the nodes before it, and the candidates for a
+  /// node are the intersection of the sorted neighbor lists of the nodes
+  /// matched to its pattern neighbors, smallest list first, as in
+  ///   Hung Q. Ngo, Christopher Ré and Atri Rudra. Skew Strikes Back: New
+  ///   Developments in the Theory of Join Algorithms. SIGMOD Record. 2013.
+  ///
+  /// Neighbor lists are built once for each direction and edge type of the
+  /// pattern. Partial matches of fewer than split_depth nodes are pushed to
+  /// a work-stealing worklist and deeper ones are extended depth first by
+  /// the thread that found them, so matches around high degree nodes are
+  /// spread over all threads.
+  static SubgraphMatchPlan GenericJoin(
+      uint32_t split_depth = kDefaultSplitDepth) {
+    return {kCPU, kGenericJoin, split_depth};
+  }
+};
+
+/// Called with the node of pg matched to each node of the pattern, indexed by
+/// pattern node; the array is valid only during the call. It is called
+/// concurrently by many threads.
+using SubgraphMatchCallback = std::function<void(const GraphTopology::Node*)>;
+
+/// Find the matches of pattern in pg: the maps of the nodes of pattern to
+/// distinct nodes of pg of their types such that each edge of pattern maps to
+/// an edge of pg of its type, in the same direction. The pattern must be
+/// connected. Every match is passed to callback, and symmetric patterns are
+/// matched once for each of their automorphisms.
+///
+/// \returns the number of matches
+KATANA_EXPORT Result<uint64_t> SubgraphMatch(
+    PropertyGraph* pg, const SubgraphPattern& pattern,
+    const SubgraphMatchCallback& callback, SubgraphMatchPlan plan = {});
+
+/// \returns the number of matches of pattern in pg without visiting them
+/// \see SubgraphMatch
+KATANA_EXPORT Result<uint64_t> SubgraphMatchCount(
+    PropertyGraph* pg, const SubgraphPattern& pattern,
+    SubgraphMatchPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNT_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNT_H_
 
+#include <iostream>
+
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/TopologySummary.h"
 
 // API
 
@@ -15,6 +18,7 @@ public:
     kNodeIteration,
     kEdgeIteration,
     kOrderedCount,
+    kSampling,
   };
 
   enum Relabeling {
@@ -25,28 +29,45 @@ public:
 
   static const Relabeling kDefaultRelabeling = kAutoRelabel;
   static const bool kDefaultEdgeSorted = false;
+  static constexpr double kDefaultRelativeError = 0.05;
+  static constexpr double kDefaultConfidence = 0.9;
 
 private:
   Algorithm algorithm_;
   Relabeling relabeling_;
   bool edges_sorted_;
+  double relative_error_;
+  double confidence_;
 
   TriangleCountPlan(
       Architecture architecture, Algorithm algorithm, bool edges_sorted,
-      Relabeling relabeling)
+      Relabeling relabeling, double relative_error = kDefaultRelativeError,
+      double confidence = kDefaultConfidence)
       : Plan(architecture),
         algorithm_(algorithm),
         relabeling_(relabeling),
-        edges_sorted_(edges_sorted) {}
+        edges_sorted_(edges_sorted),
+        relative_error_(relative_error),
+        confidence_(confidence) {}
 
 public:
   TriangleCountPlan()
       : TriangleCountPlan{
             kCPU, kOrderedCount, kDefaultEdgeSorted, kDefaultRelabeling} {}
 
+  /// Decide relabeling from a summary of the graph, as kAutoRelabel would
+  /// once it is loaded
+  TriangleCountPlan(
+      const TopologySummary& summary, bool edges_sorted = kDefaultEdgeSorted)
+      : TriangleCountPlan{
+            kCPU, kOrderedCount, edges_sorted,
+            summary.power_law ? kRelabel : kNoRelabel} {}
+
   Algorithm algorithm() const { return algorithm_; }
   Relabeling relabeling() const { return relabeling_; }
   bool edges_sorted() const { return edges_sorted_; }
+  double relative_error() const { return relative_error_; }
+  double confidence() const { return confidence_; }
 
   /**
    * The node-iterator algorithm from the following:
@@ -90,6 +111,29 @@ public:
       Relabeling relabeling = kDefaultRelabeling) {
     return {kCPU, kOrderedCount, edges_sorted, relabeling};
   }
+
+  /**
+   * Estimate the count by colorful sparsification:
+   *   Rasmus Pagh and Charalampos E. Tsourakakis. Colorful triangle counting
+   *   and a MapReduce implementation. Information Processing Letters. 2012.
+   *
+   * The nodes get one of c colors at random and the triangles among edges
+   * whose endpoints have the same color are counted exactly; each color
+   * class yields an independent-looking estimate c^3 times its count. The
+   * number of colors starts high and is halved, down to an exact count with
+   * one color, until a Chebyshev bound on the mean of the color estimates
+   * meets the error bound. The graph is neither copied nor sorted; only
+   * the sampled edges are stored.
+   *
+   * @param relative_error The bound on the error relative to the estimate.
+   * @param confidence The probability with which the bound should hold.
+   */
+  static TriangleCountPlan Sampling(
+      double relative_error = kDefaultRelativeError,
+      double confidence = kDefaultConfidence) {
+    return {kCPU, kSampling, kDefaultEdgeSorted, kNoRelabel, relative_error,
+            confidence};
+  }
 };
 
 /**
@@ -104,6 +148,31 @@ public:
 KATANA_EXPORT katana::Result<uint64_t> TriangleCount(
     PropertyGraph* pg, TriangleCountPlan plan = {});
 
+struct KATANA_EXPORT TriangleCountEstimate {
+  /// The estimated number of triangles
+  double estimate;
+  /// The estimated variance of estimate; 0 if it is exact
+  double variance;
+  /// The number of colors of the sample the estimate came from; 1 if it
+  /// is exact
+  uint32_t colors;
+
+  /// Print the estimate in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/**
+ * Estimate the number of triangles in the graph with
+ * TriangleCountPlan::kSampling and report the variance of the estimate.
+ * Other plans count exactly, with zero variance. The graph must be
+ * symmetric!
+ *
+ * @param pg The graph to process.
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<TriangleCountEstimate> EstimateTriangleCount(
+    PropertyGraph* pg, TriangleCountPlan plan = TriangleCountPlan::Sampling());
+
 }  // namespace katana::analytics
 
 #endif
@@ -1,6 +1,7 @@
 #include "katana/BuildGraph.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <deque>
@@ -11,6 +12,7 @@
 #include <optional>
 #include <random>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -25,6 +27,8 @@
 #include <parquet/arrow/writer.h>
 
 #include "katana/ArrowInterchange.h"
+#include "katana/AtomicHelpers.h"
+#include "katana/ConcurrentHashMap.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/Logging.h"
@@ -1148,6 +1152,149 @@ BuildImportVec(
   return array;
 }
 
+/*************************************************/
+/* Functions for merging the shards of a builder */
+/*************************************************/
+
+// Build the arrow arrays of a CSR topology
+katana::Result<std::shared_ptr<katana::GraphTopology>>
+BuildTopology(
+    const std::vector<uint64_t>& out_indices,
+    const std::vector<uint32_t>& out_dests) {
+  auto topology = std::make_shared<katana::GraphTopology>();
+  arrow::Status st;
+  std::shared_ptr<arrow::UInt64Builder> topology_indices_builder =
+      std::make_shared<arrow::UInt64Builder>();
+  st = topology_indices_builder->AppendValues(out_indices);
+  if (!st.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(st.code()), "Error building topology: {}", st);
+  }
+  std::shared_ptr<arrow::UInt32Builder> topology_dests_builder =
+      std::make_shared<arrow::UInt32Builder>();
+  st = topology_dests_builder->AppendValues(out_dests);
+  if (!st.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(st.code()), "Error building topology: {}", st);
+  }
+
+  st = topology_indices_builder->Finish(&topology->out_indices);
+  if (!st.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(st.code()), "Error building topology: {}", st);
+  }
+  st = topology_dests_builder->Finish(&topology->out_dests);
+  if (!st.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(st.code()), "Error building topology: {}", st);
+  }
+  return topology;
+}
+
+// The null array of chunk_size elements for columns of type
+std::shared_ptr<arrow::Array>
+FindNullArrayOfType(
+    const std::shared_ptr<arrow::DataType>& type,
+    WriterProperties* properties) {
+  if (type->id() != arrow::Type::LIST) {
+    return properties->null_arrays.first.find(type->id())->second;
+  }
+  auto list_type = std::static_pointer_cast<arrow::ListType>(type);
+  return properties->null_arrays.second.find(list_type->value_type()->id())
+      ->second;
+}
+
+// Append elts elements of constant, which is a null or false array of
+// chunk_size elements, in chunks of at most chunk_size
+void
+AddConstantChunks(
+    ArrowArrays* chunks, const std::shared_ptr<arrow::Array>& constant,
+    size_t elts) {
+  size_t chunk_size = constant->length();
+  for (; elts >= chunk_size; elts -= chunk_size) {
+    chunks->emplace_back(constant);
+  }
+  if (elts > 0) {
+    chunks->emplace_back(constant->Slice(0, elts));
+  }
+}
+
+// A column of the merged graph and its chunks in the shards that have it
+struct MergedColumn {
+  std::shared_ptr<arrow::Field> field;
+  std::vector<const ArrowArrays*> shard_chunks;
+};
+
+// Match up the columns of the shards by name, in order of first appearance
+template <typename State>
+katana::Result<std::vector<MergedColumn>>
+MergeColumns(const std::vector<const State*>& shards) {
+  std::vector<MergedColumn> columns;
+  std::unordered_map<std::string, size_t> column_indexes;
+  for (size_t s = 0; s < shards.size(); s++) {
+    for (size_t c = 0; c < shards[s]->schema.size(); c++) {
+      const auto& field = shards[s]->schema[c];
+      auto [entry, inserted] =
+          column_indexes.emplace(field->name(), columns.size());
+      if (inserted) {
+        columns.emplace_back(MergedColumn{
+            field, std::vector<const ArrowArrays*>(shards.size(), nullptr)});
+      }
+      MergedColumn& column = columns[entry->second];
+      if (!column.field->type()->Equals(*field->type())) {
+        return KATANA_ERROR(
+            katana::ErrorCode::TypeError,
+            "column {} has type {} in one shard and {} in shard {}",
+            field->name(), column.field->type()->ToString(),
+            field->type()->ToString(), s);
+      }
+      column.shard_chunks[s] = &shards[s]->chunks[c];
+    }
+  }
+  return columns;
+}
+
+// Concatenate the chunks of each column across shards, filling in constant
+// for shards without the column, then placeholder_elts more
+std::vector<ArrowArrays>
+ConcatenateShardChunks(
+    const std::vector<MergedColumn>& columns,
+    const std::vector<uint64_t>& shard_elts, size_t placeholder_elts,
+    const std::function<std::shared_ptr<arrow::Array>(const MergedColumn&)>&
+        constant_of) {
+  std::vector<ArrowArrays> chunks(columns.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, columns.size()),
+      [&](size_t c) {
+        auto constant = constant_of(columns[c]);
+        for (size_t s = 0; s < shard_elts.size(); s++) {
+          if (const ArrowArrays* shard_chunks = columns[c].shard_chunks[s]) {
+            chunks[c].insert(
+                chunks[c].end(), shard_chunks->begin(), shard_chunks->end());
+          } else {
+            AddConstantChunks(&chunks[c], constant, shard_elts[s]);
+          }
+        }
+        AddConstantChunks(&chunks[c], constant, placeholder_elts);
+      },
+      katana::no_stats());
+  return chunks;
+}
+
+std::shared_ptr<arrow::Table>
+BuildMergedTable(
+    const std::vector<ArrowArrays>& chunks,
+    const std::vector<MergedColumn>& columns) {
+  ArrowFields fields;
+  ChunkedArrays arrays;
+  for (size_t c = 0; c < columns.size(); c++) {
+    fields.emplace_back(columns[c].field);
+    arrays.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        chunks[c], columns[c].field->type()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), arrays);
+}
+
 }  // end of unnamed namespace
 
 katana::PropertyGraphBuilder::PropertyGraphBuilder(size_t chunk_size)
@@ -1749,47 +1896,351 @@ katana::PropertyGraphBuilder::Finish(bool verbose) {
   }
 
   // build topology
-  auto topology = std::make_shared<katana::GraphTopology>();
-  arrow::Status st;
-  std::shared_ptr<arrow::UInt64Builder> topology_indices_builder =
-      std::make_shared<arrow::UInt64Builder>();
-  st = topology_indices_builder->AppendValues(topology_builder_.out_indices);
-  if (!st.ok()) {
-    return KATANA_ERROR(
-        ArrowToKatana(st.code()), "Error building topology: {}", st);
+  auto topology_result = BuildTopology(
+      topology_builder_.out_indices, topology_builder_.out_dests);
+  if (!topology_result) {
+    return topology_result.error();
   }
-  std::shared_ptr<arrow::UInt32Builder> topology_dests_builder =
-      std::make_shared<arrow::UInt32Builder>();
-  st = topology_dests_builder->AppendValues(topology_builder_.out_dests);
-  if (!st.ok()) {
-    return KATANA_ERROR(
-        ArrowToKatana(st.code()), "Error building topology: {}", st);
+  auto topology = topology_result.value();
+
+  if (verbose) {
+    std::cout << "Finished mongodb conversion to arrow\n";
+    std::cout << "Nodes: " << topology->out_indices->length() << "\n";
+    std::cout << "Node Properties: " << nodes_tables.properties->num_columns()
+              << "\n";
+    std::cout << "Node Labels: " << nodes_tables.labels->num_columns() << "\n";
+    std::cout << "Edges: " << topology->out_dests->length() << "\n";
+    std::cout << "Edge Properties: " << edges_tables.properties->num_columns()
+              << "\n";
+    std::cout << "Edge Types: " << edges_tables.labels->num_columns() << "\n";
   }
 
-  st = topology_indices_builder->Finish(&topology->out_indices);
-  if (!st.ok()) {
+  return katana::GraphComponents{nodes_tables, edges_tables, topology};
+}
+
+katana::GraphComponents
+katana::PropertyGraphBuilder::FinishTables() {
+  EvenOutChunkBuilders(
+      &node_properties_.builders, &node_properties_.chunks, &properties_,
+      nodes_);
+  EvenOutChunkBuilders(
+      &node_labels_.builders, &node_labels_.chunks, &properties_, nodes_);
+  EvenOutChunkBuilders(
+      &edge_properties_.builders, &edge_properties_.chunks, &properties_,
+      edges_);
+  EvenOutChunkBuilders(
+      &edge_types_.builders, &edge_types_.chunks, &properties_, edges_);
+
+  GraphComponent nodes_tables{
+      BuildTable(&node_properties_.chunks, &node_properties_.schema),
+      BuildTable(&node_labels_.chunks, &node_labels_.schema)};
+  GraphComponent edges_tables{
+      BuildTable(&edge_properties_.chunks, &edge_properties_.schema),
+      BuildTable(&edge_types_.chunks, &edge_types_.schema)};
+  return katana::GraphComponents{nodes_tables, edges_tables, nullptr};
+}
+
+katana::ShardedPropertyGraphBuilder::ShardedPropertyGraphBuilder(
+    size_t chunk_size, size_t num_shards)
+    : properties_(GetWriterProperties(chunk_size)) {
+  for (size_t i = 0; i < num_shards; i++) {
+    shards_.emplace_back(std::make_unique<PropertyGraphBuilder>(chunk_size));
+  }
+}
+
+katana::Result<GraphComponents>
+katana::ShardedPropertyGraphBuilder::Finish(bool verbose) {
+  constexpr uint32_t kUnresolved = std::numeric_limits<uint32_t>::max();
+  size_t num_shards = shards_.size();
+  size_t chunk_size = properties_.chunk_size;
+
+  // Nodes are numbered shard by shard. Edges start at a chunk boundary in
+  // each shard, so that the shards' edge chunks line up when concatenated;
+  // the padding is never referenced.
+  std::vector<uint64_t> node_base(num_shards + 1, 0);
+  std::vector<uint64_t> edge_base(num_shards + 1, 0);
+  std::vector<uint64_t> padded_edge_base(num_shards + 1, 0);
+  std::vector<uint64_t> shard_nodes(num_shards);
+  std::vector<uint64_t> shard_edges(num_shards);
+  for (size_t s = 0; s < num_shards; s++) {
+    PropertyGraphBuilder* shard = shards_[s].get();
+    if (shard->building_node_ || shard->building_edge_) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "shard {} has an unfinished node or edge",
+          s);
+    }
+    const TopologyState& topology = shard->topology_builder_;
+    if (topology.sources.size() != shard->edges_ ||
+        topology.destinations.size() != shard->edges_) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "shard {} has an edge without a source or destination", s);
+    }
+    shard_nodes[s] = shard->nodes_;
+    shard_edges[s] = shard->edges_;
+    node_base[s + 1] = node_base[s] + shard->nodes_;
+    edge_base[s + 1] = edge_base[s] + shard->edges_;
+    padded_edge_base[s + 1] =
+        padded_edge_base[s] +
+        (shard->edges_ + chunk_size - 1) / chunk_size * chunk_size;
+
+    EvenOutChunkBuilders(
+        &shard->node_properties_.builders, &shard->node_properties_.chunks,
+        &shard->properties_, shard->nodes_);
+    EvenOutChunkBuilders(
+        &shard->node_labels_.builders, &shard->node_labels_.chunks,
+        &shard->properties_, shard->nodes_);
+    EvenOutChunkBuilders(
+        &shard->edge_properties_.builders, &shard->edge_properties_.chunks,
+        &shard->properties_, shard->edges_);
+    EvenOutChunkBuilders(
+        &shard->edge_types_.builders, &shard->edge_types_.chunks,
+        &shard->properties_, shard->edges_);
+  }
+  if (node_base[num_shards] >= kUnresolved) {
     return KATANA_ERROR(
-        ArrowToKatana(st.code()), "Error building topology: {}", st);
+        ErrorCode::InvalidArgument, "{} nodes do not fit 32-bit node IDs",
+        node_base[num_shards]);
   }
-  st = topology_dests_builder->Finish(&topology->out_dests);
-  if (!st.ok()) {
+  uint64_t num_edges = edge_base[num_shards];
+
+  // Merge the node ID dictionaries into one concurrent map. Where shards
+  // define the same ID, the first shard wins, as its nodes have the
+  // smallest indexes.
+  size_t num_ids = 0;
+  for (size_t s = 0; s < num_shards; s++) {
+    num_ids += shards_[s]->topology_builder_.node_indexes.size();
+  }
+  katana::ConcurrentHashMap<std::string_view, std::atomic<uint64_t>>
+      node_indexes(num_ids);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_shards),
+      [&](size_t s) {
+        for (const auto& [id, index] :
+             shards_[s]->topology_builder_.node_indexes) {
+          uint64_t node = node_base[s] + index;
+          auto [entry, inserted] = node_indexes.Insert(id, node);
+          if (!inserted) {
+            katana::atomicMin(*entry, node);
+          }
+        }
+      },
+      katana::no_stats());
+
+  // Undefined IDs are split into partitions by hash, each numbered by one
+  // thread
+  size_t num_partitions = katana::getActiveThreads();
+  auto partition_of = [&](std::string_view id) {
+    return std::hash<std::string_view>{}(id) % num_partitions;
+  };
+
+  // Resolve the sources and destinations of edges, which are indexed from
+  // padded_edge_base, collecting the IDs that no shard defines
+  struct Unresolved {
+    std::string_view id;
+    std::vector<uint32_t>* endpoints;
+    uint64_t edge;
+  };
+  std::vector<uint32_t> sources(padded_edge_base[num_shards]);
+  std::vector<uint32_t> destinations(padded_edge_base[num_shards]);
+  std::vector<std::vector<std::vector<Unresolved>>> unresolved(
+      num_shards, std::vector<std::vector<Unresolved>>(num_partitions));
+  katana::do_all(
+      katana::iterate(size_t{0}, num_shards),
+      [&](size_t s) {
+        const TopologyState& topology = shards_[s]->topology_builder_;
+        uint64_t base = padded_edge_base[s];
+        for (size_t e = 0; e < shard_edges[s]; e++) {
+          uint32_t src = topology.sources[e];
+          uint32_t dest = topology.destinations[e];
+          sources[base + e] = src == kUnresolved ? src : node_base[s] + src;
+          destinations[base + e] =
+              dest == kUnresolved ? dest : node_base[s] + dest;
+        }
+        auto resolve = [&](const std::unordered_map<size_t, std::string>& ids,
+                           std::vector<uint32_t>* endpoints) {
+          for (const auto& [e, id] : ids) {
+            if (const auto* entry = node_indexes.Find(id)) {
+              (*endpoints)[base + e] = entry->load(std::memory_order_relaxed);
+            } else {
+              unresolved[s][partition_of(id)].emplace_back(
+                  Unresolved{id, endpoints, base + e});
+            }
+          }
+        };
+        resolve(topology.sources_intermediate, &sources);
+        resolve(topology.destinations_intermediate, &destinations);
+      },
+      katana::steal(), katana::no_stats());
+
+  // Create a placeholder node for each undefined ID, numbered partition by
+  // partition after the nodes of the shards
+  std::vector<std::unordered_map<std::string_view, uint64_t>> placeholders(
+      num_partitions);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_partitions),
+      [&](size_t p) {
+        for (size_t s = 0; s < num_shards; s++) {
+          for (const Unresolved& u : unresolved[s][p]) {
+            placeholders[p].emplace(u.id, placeholders[p].size());
+          }
+        }
+      },
+      katana::no_stats());
+  std::vector<uint64_t> placeholder_base(num_partitions + 1, 0);
+  placeholder_base[0] = node_base[num_shards];
+  for (size_t p = 0; p < num_partitions; p++) {
+    placeholder_base[p + 1] = placeholder_base[p] + placeholders[p].size();
+  }
+  uint64_t num_nodes = placeholder_base[num_partitions];
+  if (num_nodes >= kUnresolved) {
     return KATANA_ERROR(
-        ArrowToKatana(st.code()), "Error building topology: {}", st);
+        ErrorCode::InvalidArgument, "{} nodes do not fit 32-bit node IDs",
+        num_nodes);
+  }
+  katana::do_all(
+      katana::iterate(size_t{0}, num_partitions),
+      [&](size_t p) {
+        for (size_t s = 0; s < num_shards; s++) {
+          for (const Unresolved& u : unresolved[s][p]) {
+            (*u.endpoints)[u.edge] =
+                placeholder_base[p] + placeholders[p].find(u.id)->second;
+          }
+        }
+      },
+      katana::no_stats());
+  uint64_t num_placeholders = num_nodes - node_base[num_shards];
+
+  // Build the CSR by a stable sort of the edges by source, which keeps the
+  // edges of a node in order of shard and then of addition. mapping is from
+  // the final edge index to the padded index.
+  std::vector<uint32_t> keys(num_edges);
+  std::vector<size_t> mapping(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_shards),
+      [&](size_t s) {
+        for (size_t e = 0; e < shard_edges[s]; e++) {
+          keys[edge_base[s] + e] = sources[padded_edge_base[s] + e];
+          mapping[edge_base[s] + e] = padded_edge_base[s] + e;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  sources = std::vector<uint32_t>();
+  katana::ParallelSTL::radix_sort_by_key(
+      keys.begin(), keys.end(), mapping.begin());
+
+  std::vector<uint64_t> out_indices(num_nodes, 0);
+  std::vector<uint32_t> out_dests(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t i) {
+        out_dests[i] = destinations[mapping[i]];
+        // The last edge of a node ends it and any edgeless nodes up to the
+        // next source
+        uint64_t next = i + 1 < num_edges ? keys[i + 1] : num_nodes;
+        for (uint64_t n = keys[i]; n < next; n++) {
+          out_indices[n] = i + 1;
+        }
+      },
+      katana::no_stats());
+  destinations = std::vector<uint32_t>();
+  keys = std::vector<uint32_t>();
+
+  // Build the tables
+  std::vector<const PropertiesState*> node_properties;
+  std::vector<const LabelsState*> node_labels;
+  std::vector<const PropertiesState*> edge_properties;
+  std::vector<const LabelsState*> edge_types;
+  for (const auto& shard : shards_) {
+    node_properties.emplace_back(&shard->node_properties_);
+    node_labels.emplace_back(&shard->node_labels_);
+    edge_properties.emplace_back(&shard->edge_properties_);
+    edge_types.emplace_back(&shard->edge_types_);
+  }
+  auto node_property_columns = MergeColumns(node_properties);
+  if (!node_property_columns) {
+    return node_property_columns.error();
+  }
+  auto node_label_columns = MergeColumns(node_labels);
+  if (!node_label_columns) {
+    return node_label_columns.error();
+  }
+  auto edge_property_columns = MergeColumns(edge_properties);
+  if (!edge_property_columns) {
+    return edge_property_columns.error();
+  }
+  auto edge_type_columns = MergeColumns(edge_types);
+  if (!edge_type_columns) {
+    return edge_type_columns.error();
+  }
+
+  auto null_of = [&](const MergedColumn& column) {
+    return FindNullArrayOfType(column.field->type(), &properties_);
+  };
+  auto false_of = [&](const MergedColumn&) { return properties_.false_array; };
+
+  GraphComponent nodes_tables{
+      BuildMergedTable(
+          ConcatenateShardChunks(
+              node_property_columns.value(), shard_nodes, num_placeholders,
+              null_of),
+          node_property_columns.value()),
+      BuildMergedTable(
+          ConcatenateShardChunks(
+              node_label_columns.value(), shard_nodes, num_placeholders,
+              false_of),
+          node_label_columns.value())};
+
+  // The edge columns are padded to whole chunks in every shard, as
+  // RearrangeTable expects
+  std::vector<uint64_t> padded_shard_edges(num_shards);
+  for (size_t s = 0; s < num_shards; s++) {
+    padded_shard_edges[s] = padded_edge_base[s + 1] - padded_edge_base[s];
+  }
+  auto to_chunked = [](const std::vector<ArrowArrays>& chunks,
+                       const std::vector<MergedColumn>& columns) {
+    ChunkedArrays chunked_arrays;
+    for (size_t c = 0; c < columns.size(); c++) {
+      chunked_arrays.emplace_back(std::make_shared<arrow::ChunkedArray>(
+          chunks[c], columns[c].field->type()));
+    }
+    return chunked_arrays;
+  };
+  auto initial_edges = to_chunked(
+      ConcatenateShardChunks(
+          edge_property_columns.value(), padded_shard_edges, 0, null_of),
+      edge_property_columns.value());
+  auto initial_types = to_chunked(
+      ConcatenateShardChunks(
+          edge_type_columns.value(), padded_shard_edges, 0, false_of),
+      edge_type_columns.value());
+  GraphComponent edges_tables{
+      BuildMergedTable(
+          RearrangeTable(initial_edges, mapping, &properties_),
+          edge_property_columns.value()),
+      BuildMergedTable(
+          RearrangeTypeTable(initial_types, mapping, &properties_),
+          edge_type_columns.value())};
+
+  auto topology = BuildTopology(out_indices, out_dests);
+  if (!topology) {
+    return topology.error();
   }
 
   if (verbose) {
-    std::cout << "Finished mongodb conversion to arrow\n";
-    std::cout << "Nodes: " << topology->out_indices->length() << "\n";
+    std::cout << "Finished merging " << num_shards << " shards\n";
+    std::cout << "Nodes: " << num_nodes << " (" << num_placeholders
+              << " placeholders)\n";
     std::cout << "Node Properties: " << nodes_tables.properties->num_columns()
               << "\n";
     std::cout << "Node Labels: " << nodes_tables.labels->num_columns() << "\n";
-    std::cout << "Edges: " << topology->out_dests->length() << "\n";
+    std::cout << "Edges: " << num_edges << "\n";
     std::cout << "Edge Properties: " << edges_tables.properties->num_columns()
               << "\n";
     std::cout << "Edge Types: " << edges_tables.labels->num_columns() << "\n";
   }
 
-  return katana::GraphComponents{nodes_tables, edges_tables, topology};
+  return katana::GraphComponents{nodes_tables, edges_tables, topology.value()};
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -0,0 +1,19 @@
+#include "katana/Cancellation.h"
+
+namespace {
+
+thread_local const katana::CancellationToken* current_token = nullptr;
+
+}  // namespace
+
+katana::CancellationScope::CancellationScope(const CancellationToken* token)
+    : prev_(current_token) {
+  current_token = token;
+}
+
+katana::CancellationScope::~CancellationScope() { current_token = prev_; }
+
+const katana::CancellationToken*
+katana::internal::CurrentCancellationToken() {
+  return current_token;
+}
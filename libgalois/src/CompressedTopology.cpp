@@ -0,0 +1,118 @@
+#include "katana/CompressedTopology.h"
+
+#include <atomic>
+#include <utility>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "tsuba/tsuba.h"
+
+katana::CompressedTopology::CompressedTopology(tsuba::RDGPrefix&& prefix)
+    : prefix_(std::move(prefix)),
+      dest_offsets_(reinterpret_cast<const uint64_t*>(prefix_.data())),
+      dest_blocks_(prefix_.data() + prefix_.num_nodes() * sizeof(uint64_t)) {}
+
+katana::Result<katana::CompressedTopology>
+katana::CompressedTopology::Make(const std::string& rdg_name) {
+  auto handle_res = tsuba::Open(rdg_name, tsuba::kReadOnly);
+  if (!handle_res) {
+    return handle_res.error();
+  }
+  // Closes the handle
+  tsuba::RDGFile file(handle_res.value());
+
+  auto prefix_res = tsuba::RDGPrefix::Make(file);
+  if (!prefix_res) {
+    return prefix_res.error().WithContext("reading topology of {}", rdg_name);
+  }
+  tsuba::RDGPrefix prefix = std::move(prefix_res.value());
+  if (!prefix.has_topology()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} has no topology", rdg_name);
+  }
+  if (prefix.version() != tsuba::kCompressedCSRTopologyVersion) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "topology version {} of {} is not compressed", prefix.version(),
+        rdg_name);
+  }
+
+  uint64_t num_nodes = prefix.num_nodes();
+  tsuba::CSRTopologyHeader header{
+      .version = prefix.version(),
+      .edge_type_size = 0,
+      .num_nodes = num_nodes,
+      .num_edges = prefix.num_edges(),
+  };
+  uint64_t offsets_size = num_nodes * sizeof(uint64_t);
+  uint64_t prefix_size = tsuba::CompressedCSRTopologyFileSize(header, 0);
+  if (prefix.file_size() < prefix_size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology size: {} expected {}",
+        prefix.file_size(), prefix_size);
+  }
+  if (auto res = prefix.FillData(0, offsets_size, true); !res) {
+    return res.error().WithContext("reading block offsets of {}", rdg_name);
+  }
+  const auto* dest_offsets = reinterpret_cast<const uint64_t*>(prefix.data());
+  uint64_t dest_blocks_size = num_nodes ? dest_offsets[num_nodes - 1] : 0;
+  uint64_t expected_size =
+      tsuba::CompressedCSRTopologyFileSize(header, dest_blocks_size);
+  if (prefix.file_size() < expected_size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology size: {} expected {}",
+        prefix.file_size(), expected_size);
+  }
+  if (num_nodes && prefix[num_nodes - 1] != prefix.num_edges()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "out_indices end at {} expected {}",
+        prefix[num_nodes - 1], prefix.num_edges());
+  }
+  if (auto res = prefix.FillData(
+          offsets_size, offsets_size + dest_blocks_size, true);
+      !res) {
+    return res.error().WithContext("reading blocks of {}", rdg_name);
+  }
+
+  CompressedTopology topology(std::move(prefix));
+  if (!topology.Validate()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "malformed compressed topology of {}",
+        rdg_name);
+  }
+  return topology;
+}
+
+bool
+katana::CompressedTopology::Validate() const {
+  uint64_t blocks_size = dest_blocks_size();
+  std::atomic<bool> malformed{false};
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes()),
+      [&](uint64_t n) {
+        uint64_t edges_begin = edge_begin(n);
+        uint64_t edges_end = edge_end(n);
+        uint64_t block_begin = n == 0 ? 0 : dest_offsets_[n - 1];
+        uint64_t block_end = dest_offsets_[n];
+        if (edges_begin > edges_end || edges_end > num_edges() ||
+            block_begin > block_end || block_end > blocks_size) {
+          malformed = true;
+          return;
+        }
+        const uint8_t* in = dest_blocks_ + block_begin;
+        const uint8_t* end = dest_blocks_ + block_end;
+        auto dest = static_cast<Node>(n);
+        for (uint64_t i = edges_begin; i < edges_end; ++i) {
+          if (!tsuba::DecodeCompressedCSRDest(&in, end, &dest) ||
+              dest >= num_nodes()) {
+            malformed = true;
+            return;
+          }
+        }
+        if (in != end) {
+          malformed = true;
+        }
+      },
+      katana::no_stats());
+  return !malformed;
+}
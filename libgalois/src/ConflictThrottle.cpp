@@ -0,0 +1,82 @@
+#include "katana/ConflictThrottle.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+/// The max threads and batch size each named loop ended with
+struct History {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::pair<uint32_t, uint32_t>> limits;
+};
+
+History&
+GetHistory() {
+  static History history;
+  return history;
+}
+
+}  // namespace
+
+katana::ConflictThrottle::ConflictThrottle(
+    const char* loopname, uint32_t num_threads)
+    : loopname_(loopname ? loopname : ""),
+      num_threads_(std::max<uint32_t>(num_threads, 1)),
+      max_threads_(num_threads_),
+      batch_size_(kMaxBatch) {
+  History& history = GetHistory();
+  std::lock_guard<std::mutex> lock(history.mutex);
+  auto it = history.limits.find(loopname_);
+  if (it != history.limits.end()) {
+    max_threads_ = std::min(it->second.first, num_threads_);
+    batch_size_ = it->second.second;
+  }
+}
+
+katana::ConflictThrottle::~ConflictThrottle() {
+  History& history = GetHistory();
+  std::lock_guard<std::mutex> lock(history.mutex);
+  history.limits[loopname_] = {max_threads(), batch_size()};
+}
+
+void
+katana::ConflictThrottle::Release(uint64_t iterations, uint64_t conflicts) {
+  running_.fetch_sub(1);
+  if (iterations == 0) {
+    return;
+  }
+  window_conflicts_.fetch_add(conflicts, std::memory_order_relaxed);
+  uint64_t total =
+      window_iterations_.fetch_add(iterations, std::memory_order_relaxed) +
+      iterations;
+  if (total >= kWindow && adjusting_.try_lock()) {
+    std::lock_guard<std::mutex> lock(adjusting_, std::adopt_lock);
+    Adjust();
+  }
+}
+
+void
+katana::ConflictThrottle::Adjust() {
+  uint64_t iterations = window_iterations_.exchange(0);
+  uint64_t conflicts = window_conflicts_.exchange(0);
+  if (iterations < kWindow) {
+    // Another thread adjusted for this window
+    window_iterations_.fetch_add(iterations);
+    window_conflicts_.fetch_add(conflicts);
+    return;
+  }
+  double rate = static_cast<double>(conflicts) / iterations;
+  uint32_t threads = max_threads();
+  uint32_t batch = batch_size();
+  if (rate > kHighConflictRate) {
+    threads = std::max<uint32_t>(threads / 2, 1);
+    batch = std::max(batch / 2, kMinBatch);
+  } else if (rate < kLowConflictRate) {
+    threads = std::min(threads + 1, num_threads_);
+    batch = std::min(batch * 2, kMaxBatch);
+  }
+  max_threads_ = threads;
+  batch_size_ = batch;
+}
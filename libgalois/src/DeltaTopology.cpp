@@ -0,0 +1,207 @@
+#include "katana/DeltaTopology.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateBuffer(uint64_t size) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} bytes: {}", size,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+}  // namespace
+
+katana::DeltaTopology::DeltaTopology(GraphTopology base)
+    : base_(std::move(base)) {}
+
+void
+katana::DeltaTopology::ApplyChanges(
+    Node src, NodeDelta* d, const Change* begin, const Change* end,
+    int64_t* inserted, int64_t* deleted) const {
+  for (const Change* c = begin; c != end; ++c) {
+    if (c->insert) {
+      d->inserted.emplace_back(c->dst);
+      ++*inserted;
+      continue;
+    }
+
+    auto it = std::find(d->inserted.begin(), d->inserted.end(), c->dst);
+    if (it != d->inserted.end()) {
+      d->inserted.erase(it);
+      --*inserted;
+      continue;
+    }
+    for (auto e : base_.edges(src)) {
+      if (base_.edge_dest(e) != c->dst) {
+        continue;
+      }
+      auto pos = std::lower_bound(d->deleted.begin(), d->deleted.end(), e);
+      if (pos == d->deleted.end() || *pos != e) {
+        d->deleted.insert(pos, e);
+        ++*deleted;
+        break;
+      }
+    }
+  }
+}
+
+katana::Result<void>
+katana::DeltaTopology::Apply() {
+  std::vector<Change> changes;
+  for (unsigned t = 0; t < logs_.size(); ++t) {
+    std::vector<Change>* log = logs_.getRemote(t);
+    changes.insert(changes.end(), log->begin(), log->end());
+    log->clear();
+  }
+  if (changes.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  uint64_t num_nodes = base_.num_nodes();
+  for (const auto& c : changes) {
+    if (c.src >= num_nodes || c.dst >= num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "edge ({}, {}) is not between nodes of the topology", c.src, c.dst);
+    }
+  }
+
+  // Group the changes by source, deletions first
+  katana::ParallelSTL::sort(
+      changes.begin(), changes.end(), [](const Change& a, const Change& b) {
+        return std::tie(a.src, a.insert, a.dst) <
+               std::tie(b.src, b.insert, b.dst);
+      });
+
+  std::vector<size_t> group_begin;
+  for (size_t i = 0; i < changes.size(); ++i) {
+    if (i == 0 || changes[i].src != changes[i - 1].src) {
+      group_begin.emplace_back(i);
+    }
+  }
+  group_begin.emplace_back(changes.size());
+
+  if (delta_index_.empty()) {
+    delta_index_.resize(num_nodes, kNoDelta);
+  }
+  for (size_t g = 0; g + 1 < group_begin.size(); ++g) {
+    Node src = changes[group_begin[g]].src;
+    if (delta_index_[src] == kNoDelta) {
+      delta_index_[src] = deltas_.size();
+      deltas_.emplace_back();
+    }
+  }
+
+  katana::GAccumulator<int64_t> inserted;
+  katana::GAccumulator<int64_t> deleted;
+  katana::do_all(
+      katana::iterate(size_t{0}, group_begin.size() - 1),
+      [&](size_t g) {
+        const Change* begin = &changes[group_begin[g]];
+        const Change* end = changes.data() + group_begin[g + 1];
+        int64_t local_inserted = 0;
+        int64_t local_deleted = 0;
+        ApplyChanges(
+            begin->src, &deltas_[delta_index_[begin->src]], begin, end,
+            &local_inserted, &local_deleted);
+        inserted += local_inserted;
+        deleted += local_deleted;
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("ApplyDelta"));
+
+  num_inserted_ += inserted.reduce();
+  num_deleted_ += deleted.reduce();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+katana::DeltaTopology::Compact() {
+  uint64_t num_nodes = base_.num_nodes();
+  uint64_t num_edges = this->num_edges();
+
+  auto indices_res = AllocateBuffer(num_nodes * sizeof(uint64_t));
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res = AllocateBuffer(num_edges * sizeof(uint32_t));
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto ids_res = AllocateBuffer(num_edges * sizeof(uint64_t));
+  if (!ids_res) {
+    return ids_res.error();
+  }
+  auto valid_res = AllocateBuffer((num_edges + 7) / 8);
+  if (!valid_res) {
+    return valid_res.error();
+  }
+
+  std::shared_ptr<arrow::Buffer> indices_buf = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> dests_buf = std::move(dests_res.value());
+  std::shared_ptr<arrow::Buffer> ids_buf = std::move(ids_res.value());
+  std::shared_ptr<arrow::Buffer> valid_buf = std::move(valid_res.value());
+
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buf->mutable_data());
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buf->mutable_data());
+  auto* ids = reinterpret_cast<uint64_t*>(ids_buf->mutable_data());
+  uint8_t* valid = valid_buf->mutable_data();
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { indices[n] = out_degree(n); }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+  KATANA_LOG_ASSERT(num_nodes == 0 || indices[num_nodes - 1] == num_edges);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t pos = n == 0 ? 0 : indices[n - 1];
+        ForEachOutEdge(n, [&](Edge base_edge, Node dst) {
+          dests[pos] = dst;
+          ids[pos] = base_edge;
+          ++pos;
+        });
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("CompactDelta"));
+
+  // Validity bits are set a byte at a time so that threads never share one
+  katana::do_all(
+      katana::iterate(uint64_t{0}, (num_edges + 7) / 8),
+      [&](uint64_t byte) {
+        uint8_t bits = 0;
+        for (uint64_t e = byte * 8; e < std::min(num_edges, byte * 8 + 8);
+             ++e) {
+          if (ids[e] != kInsertedEdge) {
+            bits |= uint8_t{1} << (e % 8);
+          } else {
+            ids[e] = 0;
+          }
+        }
+        valid[byte] = bits;
+      },
+      katana::no_stats());
+
+  base_ = GraphTopology{
+      .out_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buf),
+      .out_dests = std::make_shared<arrow::UInt32Array>(num_edges, dests_buf),
+  };
+  delta_index_.clear();
+  deltas_.clear();
+  num_inserted_ = 0;
+  num_deleted_ = 0;
+
+  return std::make_shared<arrow::UInt64Array>(num_edges, ids_buf, valid_buf);
+}
@@ -27,29 +27,75 @@
 
 KATANA_EXPORT katana::DynamicBitset katana::EmptyBitset;
 
+namespace {
+
+/// Call fn(begin, end) on each thread for its block of words [0, num_words),
+/// or once for all of them from within a parallel loop
+template <typename F>
+void
+ForEachBlock(size_t num_words, const F& fn) {
+  if (katana::ThreadPool::isInRun()) {
+    fn(size_t{0}, num_words);
+    return;
+  }
+  katana::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [begin, end] =
+        katana::block_range(size_t{0}, num_words, tid, nthreads);
+    fn(begin, end);
+  });
+}
+
+}  // namespace
+
+void
+katana::DynamicBitset::FillWords(size_t begin, size_t end, uint64_t value) {
+  uint64_t* w = words();
+  ForEachBlock(end - begin, [&](size_t b, size_t e) {
+    std::fill(w + begin + b, w + begin + e, value);
+  });
+}
+
+void
+katana::DynamicBitset::ClearTail() {
+  size_t tail = num_bits_ % kNumBitsInUint64;
+  if (tail != 0) {
+    words()[bitvec_.size() - 1] &= (uint64_t{1} << tail) - 1;
+  }
+}
+
 void
 katana::DynamicBitset::bitwise_or(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] |= other_bitvec[i]; }, katana::no_stats());
+  uint64_t* w = words();
+  const uint64_t* o = other.words();
+  ForEachBlock(bitvec_.size(), [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      w[i] |= o[i];
+    }
+  });
 }
 
 void
 katana::DynamicBitset::bitwise_not() {
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = ~bitvec_[i]; }, katana::no_stats());
+  uint64_t* w = words();
+  ForEachBlock(bitvec_.size(), [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      w[i] = ~w[i];
+    }
+  });
+  ClearTail();
 }
 
 void
 katana::DynamicBitset::bitwise_and(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] &= other_bitvec[i]; }, katana::no_stats());
+  uint64_t* w = words();
+  const uint64_t* o = other.words();
+  ForEachBlock(bitvec_.size(), [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      w[i] &= o[i];
+    }
+  });
 }
 
 void
@@ -57,22 +103,38 @@ katana::DynamicBitset::bitwise_and(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
   KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
+  uint64_t* w = words();
+  const uint64_t* o1 = other1.words();
+  const uint64_t* o2 = other2.words();
+  ForEachBlock(bitvec_.size(), [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      w[i] = o1[i] & o2[i];
+    }
+  });
+}
 
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] & other_bitvec2[i]; },
-      katana::no_stats());
+void
+katana::DynamicBitset::bitwise_andnot(const DynamicBitset& other) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
+  uint64_t* w = words();
+  const uint64_t* o = other.words();
+  ForEachBlock(bitvec_.size(), [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      w[i] &= ~o[i];
+    }
+  });
 }
 
 void
 katana::DynamicBitset::bitwise_xor(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] ^= other_bitvec[i]; }, katana::no_stats());
+  uint64_t* w = words();
+  const uint64_t* o = other.words();
+  ForEachBlock(bitvec_.size(), [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      w[i] ^= o[i];
+    }
+  });
 }
 
 void
@@ -80,31 +142,27 @@ katana::DynamicBitset::bitwise_xor(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
   KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
-
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] ^ other_bitvec2[i]; },
-      katana::no_stats());
+  uint64_t* w = words();
+  const uint64_t* o1 = other1.words();
+  const uint64_t* o2 = other2.words();
+  ForEachBlock(bitvec_.size(), [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      w[i] = o1[i] ^ o2[i];
+    }
+  });
 }
 
 size_t
 katana::DynamicBitset::count() const {
   katana::GAccumulator<size_t> ret;
-  katana::do_all(
-      katana::iterate(bitvec_.begin(), bitvec_.end()),
-      [&](uint64_t n) {
-#ifdef __GNUC__
-        ret += __builtin_popcountll(n);
-#else
-        n = n - ((n >> 1) & 0x5555555555555555UL);
-        n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-        ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-               56;
-#endif
-      },
-      katana::no_stats());
+  const uint64_t* w = words();
+  ForEachBlock(bitvec_.size(), [&](size_t b, size_t e) {
+    size_t local = 0;
+    for (size_t i = b; i < e; ++i) {
+      local += __builtin_popcountll(w[i]);
+    }
+    ret += local;
+  });
   return ret.reduce();
 }
 
@@ -117,16 +175,25 @@ ComputeOffsets(
   uint32_t activeThreads = katana::getActiveThreads();
   std::vector<Integer> tPrefixBitCounts(activeThreads);
 
+  // Words hold whole bits, but bits past the end of the bitset do not count
+  const auto& words = bitset.get_vec();
+  size_t tail = bitset.size() % katana::DynamicBitset::kNumBitsInUint64;
+  auto word_at = [&](size_t i) {
+    uint64_t word = words[i].load(std::memory_order_relaxed);
+    if (tail != 0 && i == words.size() - 1) {
+      word &= (uint64_t{1} << tail) - 1;
+    }
+    return word;
+  };
+
   // count how many bits are set on each thread
   katana::on_each([&](unsigned tid, unsigned nthreads) {
     auto [start, end] =
-        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+        katana::block_range(size_t{0}, words.size(), tid, nthreads);
 
     Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
+    for (size_t i = start; i < end; ++i) {
+      count += __builtin_popcountll(word_at(i));
     }
 
     tPrefixBitCounts[tid] = count;
@@ -145,18 +212,21 @@ ComputeOffsets(
   if (bitsetCount > 0) {
     size_t cur_size = offsets->size();
     offsets->resize(cur_size + bitsetCount);
+    Integer* out = offsets->data();
     katana::on_each([&](unsigned tid, unsigned nthreads) {
       auto [start, end] =
-          katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+          katana::block_range(size_t{0}, words.size(), tid, nthreads);
       Integer index = cur_size;
       if (tid != 0) {
         index += tPrefixBitCounts[tid - 1];
       }
 
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets->at(index) = i;
-          ++index;
+      for (size_t i = start; i < end; ++i) {
+        uint64_t word = word_at(i);
+        while (word) {
+          out[index++] = i * katana::DynamicBitset::kNumBitsInUint64 +
+                         __builtin_ctzll(word);
+          word &= word - 1;
         }
       }
     });
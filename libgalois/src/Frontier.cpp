@@ -0,0 +1,99 @@
+#include "katana/Frontier.h"
+
+#include <algorithm>
+#include <utility>
+
+katana::Frontier::Frontier(size_t num_nodes, double dense_fraction)
+    : num_nodes_(num_nodes), dense_fraction_(dense_fraction) {
+  bitmap_.resize(num_nodes_);
+}
+
+void
+katana::Frontier::ClearBitmap() {
+  auto& words = bitmap_.get_vec();
+  katana::do_all(
+      katana::iterate(size_t{0}, words.size()), [&](size_t i) { words[i] = 0; },
+      katana::no_stats());
+}
+
+void
+katana::Frontier::Reset(bool dense) {
+  if (dense_) {
+    ClearBitmap();
+  } else {
+    bag_.clear();
+  }
+  size_.reset();
+  dense_ = dense;
+}
+
+void
+katana::Frontier::Fill() {
+  if (!dense_) {
+    bag_.clear();
+  }
+  auto& words = bitmap_.get_vec();
+  size_t num_words = words.size();
+  katana::do_all(
+      katana::iterate(size_t{0}, num_words),
+      [&](size_t i) { words[i] = ~uint64_t{0}; }, katana::no_stats());
+  // Bits past the last node must stay clear for ForEach
+  size_t tail = num_nodes_ % DynamicBitset::kNumBitsInUint64;
+  if (tail != 0) {
+    words[num_words - 1] = (uint64_t{1} << tail) - 1;
+  }
+  size_.reset();
+  size_ += num_nodes_;
+  dense_ = true;
+}
+
+void
+katana::Frontier::ToDense() {
+  if (dense_) {
+    return;
+  }
+  katana::do_all(
+      katana::iterate(bag_), [&](Node n) { bitmap_.set(n); },
+      katana::chunk_size<kChunkSize>(), katana::loopname("FrontierToDense"));
+  bag_.clear();
+  size_.reset();
+  size_ += bitmap_.count();
+  dense_ = true;
+}
+
+void
+katana::Frontier::ToSparse() {
+  if (!dense_) {
+    return;
+  }
+  ForEach([&](Node n) { bag_.push(n); }, "FrontierToSparse");
+  ClearBitmap();
+  dense_ = false;
+}
+
+void
+katana::Frontier::Adapt() {
+  double threshold = dense_fraction_ * num_nodes_;
+  size_t current = size();
+  if (!dense_ && current > threshold) {
+    ToDense();
+  } else if (dense_ && current < threshold / 2) {
+    ToSparse();
+  }
+}
+
+void
+katana::Frontier::swap(Frontier& other) {
+  std::swap(num_nodes_, other.num_nodes_);
+  std::swap(dense_fraction_, other.dense_fraction_);
+  std::swap(dense_, other.dense_);
+  bag_.swap(other.bag_);
+  std::swap(bitmap_, other.bitmap_);
+
+  size_t mine = size();
+  size_t theirs = other.size();
+  size_.reset();
+  size_ += theirs;
+  other.size_.reset();
+  other.size_ += mine;
+}
@@ -0,0 +1,604 @@
+#include "katana/GraphGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Draws that are made again, e.g., self loops, give up after this many
+/// tries, so that a graph without valid edges, like one of a single node,
+/// still ends
+constexpr uint64_t kMaxAttempts = 64;
+
+/// What a random draw is for, so that draws for the same index but
+/// different purposes differ
+enum class Draw : uint64_t {
+  kEdge = 1,
+  kCommunity,
+  kPosition,
+  kWeight,
+  kLabel,
+};
+
+uint64_t
+Mix(uint64_t x) {
+  // splitmix64
+  x += UINT64_C(0x9e3779b97f4a7c15);
+  x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+/// A counter-based random stream: draw i is a hash of the seed, of what the
+/// stream is for, e.g., the edges of a node, and of i, so that any thread
+/// can make any draw without state shared with the others
+class RandomStream {
+public:
+  RandomStream(uint64_t seed, Draw draw, uint64_t index)
+      : key_(Mix(Mix(seed + static_cast<uint64_t>(draw)) + index)) {}
+
+  uint64_t operator()(uint64_t i) const {
+    return Mix(key_ + i * UINT64_C(0x9e3779b97f4a7c15));
+  }
+
+  /// \returns draw i uniform in [0, 1)
+  double Uniform(uint64_t i) const { return ((*this)(i) >> 11) * 0x1.0p-53; }
+
+  /// \returns draw i uniform in [0, bound)
+  uint64_t Below(uint64_t bound, uint64_t i) const {
+    unsigned __int128 product =
+        static_cast<unsigned __int128>((*this)(i)) * bound;
+    return static_cast<uint64_t>(product >> 64);
+  }
+
+private:
+  uint64_t key_;
+};
+
+/// \returns the inverse of the distribution function at u of the power law
+/// of exponent on [low, high]
+double
+PowerLaw(double u, double low, double high, double exponent) {
+  double e = 1 - exponent;
+  double a = std::pow(low, e);
+  double b = std::pow(high, e);
+  return std::pow(a + u * (b - a), 1 / e);
+}
+
+/// \returns the mean of the power law of exponent on [low, high]
+double
+PowerLawMean(double low, double high, double exponent) {
+  if (low >= high) {
+    return low;
+  }
+  return (1 - exponent) / (2 - exponent) *
+         (std::pow(high, 2 - exponent) - std::pow(low, 2 - exponent)) /
+         (std::pow(high, 1 - exponent) - std::pow(low, 1 - exponent));
+}
+
+/// \returns x rounded to one of the integers next to it, up with the
+/// probability of its fraction, so that the mean is unchanged
+uint64_t
+RoundRandomly(double x, double u) {
+  return static_cast<uint64_t>(x + u);
+}
+
+/// The weights and labels shared by the families of graphs. A generator
+/// also has ForEachEdge(fn), which calls fn(src, dst) for each drawn edge
+/// from a parallel loop and draws the same edges each time it is called.
+class Generator {
+public:
+  explicit Generator(const katana::GraphGeneratorOptions& opts)
+      : opts_(opts) {}
+
+  uint32_t Weight(Node a, Node b) const {
+    uint64_t pair = (uint64_t{std::min(a, b)} << 32) | std::max(a, b);
+    RandomStream random(opts_.seed, Draw::kWeight, pair);
+    return 1 + random.Below(opts_.max_weight, 0);
+  }
+
+  uint32_t Label(Node n) const {
+    return RandomStream(opts_.seed, Draw::kLabel, n).Below(opts_.num_labels, 0);
+  }
+
+protected:
+  const katana::GraphGeneratorOptions& opts_;
+};
+
+class RmatGenerator : public Generator {
+public:
+  explicit RmatGenerator(const katana::GraphGeneratorOptions& opts)
+      : Generator(opts) {
+    while ((uint64_t{1} << scale_) < opts.num_nodes) {
+      ++scale_;
+    }
+  }
+
+  template <typename F>
+  void ForEachEdge(const F& fn) const {
+    double a = opts_.rmat_a;
+    double ab = a + opts_.rmat_b;
+    double abc = ab + opts_.rmat_c;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, opts_.num_edges),
+        [&](uint64_t i) {
+          RandomStream random(opts_.seed, Draw::kEdge, i);
+          // Nodes past num_nodes, which is rounded up to a power of two,
+          // and self loops are drawn again
+          for (uint64_t attempt = 0, draw = 0; attempt < kMaxAttempts;
+               ++attempt) {
+            uint64_t src = 0;
+            uint64_t dst = 0;
+            for (uint32_t level = 0; level < scale_; ++level) {
+              double u = random.Uniform(draw++);
+              src = 2 * src + (u >= ab);
+              dst = 2 * dst + ((u >= a && u < ab) || u >= abc);
+            }
+            if (src < opts_.num_nodes && dst < opts_.num_nodes && src != dst) {
+              fn(src, dst);
+              return;
+            }
+          }
+        },
+        katana::no_stats());
+  }
+
+private:
+  uint32_t scale_{0};
+};
+
+class LfrGenerator : public Generator {
+public:
+  explicit LfrGenerator(const katana::GraphGeneratorOptions& opts)
+      : Generator(opts) {
+    uint64_t num_nodes = opts.num_nodes;
+    double average = static_cast<double>(opts.num_edges) / num_nodes;
+    max_degree_ = opts.lfr_max_degree;
+    if (max_degree_ == 0) {
+      max_degree_ = std::max<uint64_t>(
+          std::min<uint64_t>(num_nodes - 1, std::ceil(10 * average)), 1);
+    }
+
+    // Find the least degree whose power law has the average degree; its
+    // mean grows with the least degree
+    double low = 1;
+    double high = max_degree_;
+    for (int i = 0; i < 64; ++i) {
+      double mid = (low + high) / 2;
+      if (PowerLawMean(mid, max_degree_, opts.lfr_degree_exponent) < average) {
+        low = mid;
+      } else {
+        high = mid;
+      }
+    }
+    min_degree_ = low;
+
+    // The communities are few compared to the nodes, so draw them in order
+    double min_size = opts.lfr_min_community_size;
+    double max_size = std::max<double>(
+        opts.lfr_max_community_size ? opts.lfr_max_community_size
+                                    : max_degree_,
+        min_size);
+    RandomStream random(opts.seed, Draw::kCommunity, 0);
+    community_begins_.emplace_back(0);
+    for (uint64_t i = 0; community_begins_.back() < num_nodes; i += 2) {
+      double size = PowerLaw(
+          random.Uniform(i), min_size, max_size, opts.lfr_community_exponent);
+      community_begins_.emplace_back(std::min(
+          community_begins_.back() +
+              std::max<uint64_t>(RoundRandomly(size, random.Uniform(i + 1)), 1),
+          num_nodes));
+    }
+    // Merge a last community cut short into the one before it
+    size_t num_communities = community_begins_.size() - 1;
+    if (num_communities > 1 &&
+        num_nodes - community_begins_[num_communities - 1] < min_size) {
+      community_begins_.erase(community_begins_.end() - 2);
+    }
+  }
+
+  template <typename F>
+  void ForEachEdge(const F& fn) const {
+    uint64_t num_nodes = opts_.num_nodes;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          RandomStream random(opts_.seed, Draw::kEdge, n);
+          double degree = PowerLaw(
+              random.Uniform(0), min_degree_, max_degree_,
+              opts_.lfr_degree_exponent);
+          uint64_t num_edges = RoundRandomly(degree, random.Uniform(1));
+
+          uint32_t community = Community(n);
+          uint64_t begin = community_begins_[community];
+          uint64_t end = community_begins_[community + 1];
+          for (uint64_t j = 0, draw = 2; j < num_edges; ++j, draw += 2) {
+            bool outside = random.Uniform(draw) < opts_.lfr_mixing;
+            uint64_t first = outside || end - begin < 2 ? 0 : begin;
+            uint64_t last = outside || end - begin < 2 ? num_nodes : end;
+            if (last - first < 2) {
+              continue;
+            }
+            // Draw from the others of [first, last)
+            uint64_t dst = first + random.Below(last - first - 1, draw + 1);
+            fn(n, dst + (dst >= n));
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  uint32_t Label(Node n) const { return Community(n); }
+
+private:
+  uint32_t Community(Node n) const {
+    return std::upper_bound(
+               community_begins_.begin(), community_begins_.end(),
+               uint64_t{n}) -
+           community_begins_.begin() - 1;
+  }
+
+  uint64_t max_degree_{0};
+  double min_degree_{1};
+  std::vector<uint64_t> community_begins_;
+};
+
+class GeometricGenerator : public Generator {
+public:
+  explicit GeometricGenerator(const katana::GraphGeneratorOptions& opts)
+      : Generator(opts) {
+    width_ = std::sqrt(static_cast<double>(opts.num_nodes));
+    while (width_ * width_ < opts.num_nodes) {
+      ++width_;
+    }
+    average_degree_ = static_cast<double>(opts.num_edges) / opts.num_nodes;
+    // The (2 radius + 1)^2 - 1 cells around a node hold most of its edges
+    // without many duplicates
+    radius_ = std::max<int64_t>(
+        std::ceil(std::sqrt(average_degree_ + 1) / 2), 1);
+  }
+
+  template <typename F>
+  void ForEachEdge(const F& fn) const {
+    int64_t side = 2 * radius_ + 1;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, opts_.num_nodes),
+        [&](uint64_t n) {
+          RandomStream random(opts_.seed, Draw::kEdge, n);
+          uint64_t num_edges =
+              RoundRandomly(average_degree_, random.Uniform(0));
+          int64_t x = n % width_;
+          int64_t y = n / width_;
+          for (uint64_t j = 0, draw = 1; j < num_edges; ++j) {
+            // Cells off the grid and the cell of n are drawn again
+            for (uint64_t attempt = 0; attempt < kMaxAttempts; ++attempt) {
+              int64_t dx =
+                  static_cast<int64_t>(random.Below(side, draw++)) - radius_;
+              int64_t dy =
+                  static_cast<int64_t>(random.Below(side, draw++)) - radius_;
+              int64_t dst_x = x + dx;
+              int64_t dst_y = y + dy;
+              if ((dx == 0 && dy == 0) || dst_x < 0 || dst_y < 0 ||
+                  dst_x >= static_cast<int64_t>(width_)) {
+                continue;
+              }
+              uint64_t dst = dst_y * width_ + dst_x;
+              if (dst < opts_.num_nodes) {
+                fn(n, dst);
+                break;
+              }
+            }
+          }
+        },
+        katana::no_stats());
+  }
+
+  /// The length of an edge scaled to [1, max_weight]
+  uint32_t Weight(Node a, Node b) const {
+    auto [ax, ay] = Position(a);
+    auto [bx, by] = Position(b);
+    double length = std::hypot(ax - bx, ay - by);
+    double max_length = (radius_ + 1) * std::sqrt(2.0);
+    uint32_t weight = 1 + length / max_length * (opts_.max_weight - 1);
+    return std::min(weight, opts_.max_weight);
+  }
+
+private:
+  /// The grid cell of n with a random offset within it
+  std::pair<double, double> Position(Node n) const {
+    RandomStream random(opts_.seed, Draw::kPosition, n);
+    return {
+        n % width_ + random.Uniform(0),
+        static_cast<double>(n / width_) + random.Uniform(1)};
+  }
+
+  uint64_t width_{0};
+  double average_degree_{0};
+  int64_t radius_{1};
+};
+
+class BipartiteGenerator : public Generator {
+public:
+  explicit BipartiteGenerator(const katana::GraphGeneratorOptions& opts)
+      : Generator(opts),
+        num_left_(
+            opts.bipartite_num_left_nodes ? opts.bipartite_num_left_nodes
+                                          : opts.num_nodes / 2),
+        num_right_(opts.num_nodes - num_left_) {}
+
+  template <typename F>
+  void ForEachEdge(const F& fn) const {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, opts_.num_edges),
+        [&](uint64_t i) {
+          RandomStream random(opts_.seed, Draw::kEdge, i);
+          uint64_t src = random.Below(num_left_, 0);
+          double u = std::pow(random.Uniform(1), opts_.bipartite_skew);
+          uint64_t dst = std::min<uint64_t>(u * num_right_, num_right_ - 1);
+          fn(src, num_left_ + dst);
+        },
+        katana::no_stats());
+  }
+
+  uint32_t Label(Node n) const { return n >= num_left_; }
+
+private:
+  uint64_t num_left_;
+  uint64_t num_right_;
+};
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateBuffer(uint64_t size) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} bytes: {}", size,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+/// \returns the index of the first edge of each node, from the end of the
+/// edges of each node in indices
+uint64_t
+FirstEdge(const uint64_t* indices, uint64_t n) {
+  return n > 0 ? indices[n - 1] : 0;
+}
+
+template <typename G>
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+Generate(const G& generator, const katana::GraphGeneratorOptions& opts) {
+  uint64_t num_nodes = opts.num_nodes;
+  bool symmetric = opts.symmetric;
+
+  // Count the edges of each node, then draw them all again into their
+  // places, so that no edge list is stored
+  katana::LargeArray<uint64_t> cursors;
+  cursors.createBlocked(num_nodes);
+  generator.ForEachEdge([&](Node src, Node dst) {
+    __sync_fetch_and_add(&cursors[src], 1);
+    if (symmetric) {
+      __sync_fetch_and_add(&cursors[dst], 1);
+    }
+  });
+
+  auto indices_res = AllocateBuffer(num_nodes * sizeof(uint64_t));
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buf = std::move(indices_res.value());
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buf->mutable_data());
+  katana::ParallelSTL::partial_sum(cursors.begin(), cursors.end(), indices);
+  uint64_t num_edges = FirstEdge(indices, num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cursors[n] = FirstEdge(indices, n); },
+      katana::no_stats());
+
+  auto dests_res = AllocateBuffer(num_edges * sizeof(uint32_t));
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buf = std::move(dests_res.value());
+  auto* dests = reinterpret_cast<Node*>(dests_buf->mutable_data());
+  generator.ForEachEdge([&](Node src, Node dst) {
+    dests[__sync_fetch_and_add(&cursors[src], 1)] = dst;
+    if (symmetric) {
+      dests[__sync_fetch_and_add(&cursors[dst], 1)] = src;
+    }
+  });
+
+  // Edges were placed in the order threads drew them; sorting each node
+  // makes the graph the same whatever the number of threads
+  katana::GAccumulator<uint64_t> num_duplicates;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Node* begin = dests + FirstEdge(indices, n);
+        Node* end = dests + indices[n];
+        std::sort(begin, end);
+        if (opts.remove_duplicates) {
+          Node* unique_end = std::unique(begin, end);
+          num_duplicates += end - unique_end;
+          end = unique_end;
+        }
+        cursors[n] = end - begin;
+      },
+      katana::steal(), katana::no_stats());
+
+  if (num_duplicates.reduce() > 0) {
+    auto unique_indices_res = AllocateBuffer(num_nodes * sizeof(uint64_t));
+    if (!unique_indices_res) {
+      return unique_indices_res.error();
+    }
+    auto unique_dests_res = AllocateBuffer(
+        (num_edges - num_duplicates.reduce()) * sizeof(uint32_t));
+    if (!unique_dests_res) {
+      return unique_dests_res.error();
+    }
+    auto* unique_indices =
+        reinterpret_cast<uint64_t*>(unique_indices_res.value()->mutable_data());
+    auto* unique_dests =
+        reinterpret_cast<Node*>(unique_dests_res.value()->mutable_data());
+    katana::ParallelSTL::partial_sum(
+        cursors.begin(), cursors.end(), unique_indices);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          std::copy_n(
+              dests + FirstEdge(indices, n), cursors[n],
+              unique_dests + FirstEdge(unique_indices, n));
+        },
+        katana::steal(), katana::no_stats());
+    indices_buf = std::move(unique_indices_res.value());
+    dests_buf = std::move(unique_dests_res.value());
+    indices = unique_indices;
+    dests = unique_dests;
+    num_edges -= num_duplicates.reduce();
+  }
+
+  auto pg = std::make_unique<katana::PropertyGraph>();
+  if (auto res = pg->SetTopology(katana::GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_nodes, indices_buf),
+          .out_dests =
+              std::make_shared<arrow::UInt32Array>(num_edges, dests_buf),
+      });
+      !res) {
+    return res.error();
+  }
+  if (auto res = pg->MarkTopologyModified(true); !res) {
+    return res.error();
+  }
+
+  if (!opts.weight_property.empty()) {
+    auto weights_res = AllocateBuffer(num_edges * sizeof(uint32_t));
+    if (!weights_res) {
+      return weights_res.error();
+    }
+    auto* weights =
+        reinterpret_cast<uint32_t*>(weights_res.value()->mutable_data());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          for (uint64_t e = FirstEdge(indices, n); e < indices[n]; ++e) {
+            weights[e] = generator.Weight(n, dests[e]);
+          }
+        },
+        katana::steal(), katana::no_stats());
+    auto table = arrow::Table::Make(
+        arrow::schema({arrow::field(opts.weight_property, arrow::uint32())}),
+        {std::make_shared<arrow::UInt32Array>(
+            num_edges, std::move(weights_res.value()))});
+    if (auto res = pg->AddEdgeProperties(table); !res) {
+      return res.error();
+    }
+  }
+
+  if (!opts.label_property.empty()) {
+    auto labels_res = AllocateBuffer(num_nodes * sizeof(uint32_t));
+    if (!labels_res) {
+      return labels_res.error();
+    }
+    auto* labels =
+        reinterpret_cast<uint32_t*>(labels_res.value()->mutable_data());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { labels[n] = generator.Label(n); },
+        katana::no_stats());
+    auto table = arrow::Table::Make(
+        arrow::schema({arrow::field(opts.label_property, arrow::uint32())}),
+        {std::make_shared<arrow::UInt32Array>(
+            num_nodes, std::move(labels_res.value()))});
+    if (auto res = pg->AddNodeProperties(table); !res) {
+      return res.error();
+    }
+  }
+
+  return std::unique_ptr<katana::PropertyGraph>(std::move(pg));
+}
+
+katana::Result<void>
+CheckOptions(const katana::GraphGeneratorOptions& opts) {
+  if (opts.num_nodes == 0 ||
+      opts.num_nodes > std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "number of nodes must be in [1, {}]: {}",
+        std::numeric_limits<Node>::max(), opts.num_nodes);
+  }
+  if (opts.max_weight == 0 || opts.num_labels == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "max weight and number of labels must be positive");
+  }
+
+  switch (opts.kind) {
+  case katana::GeneratedGraph::kRmat:
+    if (opts.rmat_a < 0 || opts.rmat_b < 0 || opts.rmat_c < 0 ||
+        opts.rmat_a + opts.rmat_b + opts.rmat_c > 1) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "R-MAT probabilities must be nonnegative with a sum of at most 1");
+    }
+    break;
+  case katana::GeneratedGraph::kLfr:
+    if (opts.lfr_degree_exponent <= 2 || opts.lfr_community_exponent <= 1) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "LFR degree exponent must exceed 2 and community exponent 1");
+    }
+    if (opts.lfr_mixing < 0 || opts.lfr_mixing > 1 ||
+        opts.lfr_min_community_size == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "LFR mixing must be in [0, 1] and communities not empty");
+    }
+    break;
+  case katana::GeneratedGraph::kGeometric:
+    break;
+  case katana::GeneratedGraph::kBipartite:
+    if (opts.num_nodes < 2 ||
+        opts.bipartite_num_left_nodes >= opts.num_nodes ||
+        opts.bipartite_skew <= 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "bipartite graphs need nodes on both sides and a positive skew");
+    }
+    break;
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::GenerateGraph(const GraphGeneratorOptions& opts) {
+  if (auto res = CheckOptions(opts); !res) {
+    return res.error();
+  }
+
+  switch (opts.kind) {
+  case GeneratedGraph::kRmat:
+    return Generate(RmatGenerator(opts), opts);
+  case GeneratedGraph::kLfr:
+    return Generate(LfrGenerator(opts), opts);
+  case GeneratedGraph::kGeometric:
+    return Generate(GeometricGenerator(opts), opts);
+  case GeneratedGraph::kBipartite:
+    return Generate(BipartiteGenerator(opts), opts);
+  }
+  return KATANA_ERROR(ErrorCode::InvalidArgument, "unknown kind of graph");
+}
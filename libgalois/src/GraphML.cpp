@@ -1,6 +1,7 @@
 #include "katana/GraphML.h"
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdlib>
 #include <deque>
@@ -8,6 +9,7 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <random>
 #include <sstream>
@@ -15,9 +17,11 @@
 #include <unordered_set>
 #include <vector>
 
+#include <arrow/compute/api.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "katana/ArrowInterchange.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphMLSchema.h"
@@ -25,6 +29,10 @@
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
 #include "katana/Threads.h"
+#include "katana/Uri.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/file.h"
 
 using katana::ImportData;
 using katana::ImportDataType;
@@ -329,19 +337,32 @@ ProcessData(xmlTextReaderPtr reader) {
   return make_pair(key, propertyData);
 }
 
+/// A node or edge as read from a GraphML file, before its values are
+/// converted
+struct RawElement {
+  // id of a node
+  std::string id;
+  // endpoints of an edge
+  std::string source;
+  std::string target;
+  std::vector<std::string> labels;
+  // key and raw value of each data element
+  std::vector<std::pair<std::string, std::string>> data;
+};
+
 /*
  * reader should be pointing at the node element before calling
  *
  * parses the node from a GraphML file into readable form
  */
-void
-ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+RawElement
+ProcessNode(xmlTextReaderPtr reader) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
   xmlChar *name, *value;
 
-  std::string id;
+  RawElement node;
   std::vector<std::string> labels;
 
   bool extractedLabels = false;  // neo4j includes these twice so only parse 1
@@ -353,7 +374,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
 
     if (name != NULL) {
       if (xmlStrEqual(name, BAD_CAST "id")) {
-        id = std::string((const char*)value);
+        node.id = std::string((const char*)value);
       } else if (
           xmlStrEqual(name, BAD_CAST "labels") ||
           xmlStrEqual(name, BAD_CAST "label")) {
@@ -376,11 +397,6 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderMoveToNextAttribute(reader);
   }
 
-  bool validNode = !id.empty();
-  if (validNode) {
-    builder->StartNode(id);
-  }
-
   // parse "data" xml nodes for properties
   ret = xmlTextReaderRead(reader);
   // will terminate when </node> reached or an improper read
@@ -408,18 +424,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
               extractedLabels = true;
             }
           } else if (property.first != std::string("IGNORE")) {
-            if (validNode) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
-            }
+            node.data.emplace_back(std::move(property));
           }
         }
       } else {
@@ -433,15 +438,8 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderRead(reader);
   }
 
-  // add labels if they exists
-  if (validNode) {
-    if (!labels.empty()) {
-      for (std::string label : labels) {
-        builder->AddLabel(label);
-      }
-    }
-    builder->FinishNode();
-  }
+  node.labels = std::move(labels);
+  return node;
 }
 
 /*
@@ -449,15 +447,14 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
  *
  * parses the edge from a GraphML file into readable form
  */
-void
-ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+RawElement
+ProcessEdge(xmlTextReaderPtr reader) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
   xmlChar *name, *value;
 
-  std::string source;
-  std::string target;
+  RawElement edge;
   std::string type;
   bool extracted_type = false;  // neo4j includes these twice so only parse 1
 
@@ -469,9 +466,9 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     if (name != NULL) {
       if (xmlStrEqual(name, BAD_CAST "id")) {
       } else if (xmlStrEqual(name, BAD_CAST "source")) {
-        source = std::string((const char*)value);
+        edge.source = std::string((const char*)value);
       } else if (xmlStrEqual(name, BAD_CAST "target")) {
-        target = std::string((const char*)value);
+        edge.target = std::string((const char*)value);
       } else if (
           xmlStrEqual(name, BAD_CAST "labels") ||
           xmlStrEqual(name, BAD_CAST "label")) {
@@ -489,11 +486,6 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderMoveToNextAttribute(reader);
   }
 
-  bool valid_edge = !source.empty() && !target.empty();
-  if (valid_edge) {
-    valid_edge = builder->StartEdge(source, target);
-  }
-
   // parse "data" xml edges for properties
   ret = xmlTextReaderRead(reader);
   // will terminate when </edge> reached or an improper read
@@ -516,18 +508,7 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
               extracted_type = true;
             }
           } else if (property.first != std::string("IGNORE")) {
-            if (valid_edge) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
-            }
+            edge.data.emplace_back(std::move(property));
           }
         }
       } else {
@@ -541,23 +522,22 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
   }
 
   // add type if it exists
-  if (valid_edge) {
-    if (type.length() > 0) {
-      builder->AddLabel(type);
-    }
-    builder->FinishEdge();
+  if (type.length() > 0) {
+    edge.labels.emplace_back(std::move(type));
   }
+  return edge;
 }
 
 /*
  * reader should be pointing at the graph element before calling
  *
- * parses the graph structure from a GraphML file into Galois format
+ * parses the graph structure from a GraphML file, handing each node and edge
+ * to on_node or on_edge in order
  */
+template <typename NodeFn, typename EdgeFn>
 void
 ProcessGraph(
-    xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder,
-    bool verbose) {
+    xmlTextReaderPtr reader, NodeFn on_node, EdgeFn on_edge, bool verbose) {
   auto minimum_depth = xmlTextReaderDepth(reader);
   int ret = xmlTextReaderRead(reader);
 
@@ -574,7 +554,7 @@ ProcessGraph(
     if (xmlTextReaderNodeType(reader) == 1) {
       // if elt is a "node" xml node read it in
       if (xmlStrEqual(name, BAD_CAST "node")) {
-        ProcessNode(reader, builder);
+        on_node(ProcessNode(reader));
       } else if (xmlStrEqual(name, BAD_CAST "edge")) {
         if (!finished_nodes) {
           finished_nodes = true;
@@ -583,7 +563,7 @@ ProcessGraph(
           }
         }
         // if elt is an "egde" xml node read it in
-        ProcessEdge(reader, builder);
+        on_edge(ProcessEdge(reader));
       } else {
         KATANA_LOG_ERROR(
             "Found element: {}, which was ignored",
@@ -599,72 +579,821 @@ ProcessGraph(
   }
 }
 
-}  // end of unnamed namespace
-
-katana::Result<katana::GraphComponents>
-katana::ConvertGraphML(
-    const std::string& infilename, size_t chunk_size, bool verbose) {
+/*
+ * reads a GraphML file, handing the keys of its properties to on_key and then
+ * each node and edge of its first graph to on_node or on_edge in order
+ */
+template <typename KeyFn, typename NodeFn, typename EdgeFn>
+katana::Result<void>
+ProcessGraphML(
+    const std::string& infilename, KeyFn on_key, NodeFn on_node,
+    EdgeFn on_edge, bool verbose) {
   xmlTextReaderPtr reader;
   int ret = 0;
 
-  katana::PropertyGraphBuilder builder{chunk_size};
-
   bool finishedGraph = false;
   if (verbose) {
     std::cout << "Start converting GraphML file: " << infilename << "\n";
   }
 
   reader = xmlNewTextReaderFilename(infilename.c_str());
-  if (reader != NULL) {
-    ret = xmlTextReaderRead(reader);
+  if (reader == NULL) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Unable to open {}", infilename);
+  }
+  ret = xmlTextReaderRead(reader);
 
-    // procedure:
-    // read in "key" xml nodes and add them to nodeKeys and edgeKeys
-    // once we reach the first "graph" xml node we parse it using the above keys
-    // once we have parsed the first "graph" xml node we exit
-    while (ret == 1 && !finishedGraph) {
-      xmlChar* name;
-      name = xmlTextReaderName(reader);
-      if (name == NULL) {
-        name = xmlStrdup(BAD_CAST "--");
-      }
-      // if elt is an xml node
-      if (xmlTextReaderNodeType(reader) == 1) {
-        // if elt is a "key" xml node read it in
-        if (xmlStrEqual(name, BAD_CAST "key")) {
-          PropertyKey key = katana::graphml::ProcessKey(reader);
-          if (!key.id.empty() && key.id != std::string("label") &&
-              key.id != std::string("IGNORE")) {
-            if (key.for_node) {
-              builder.AddBuilder(std::move(key));
-            } else if (key.for_edge) {
-              builder.AddBuilder(std::move(key));
-            }
-          }
-        } else if (xmlStrEqual(name, BAD_CAST "graph")) {
-          if (verbose) {
-            std::cout << "Finished processing property headers\n";
+  // procedure:
+  // read in "key" xml nodes and add them to nodeKeys and edgeKeys
+  // once we reach the first "graph" xml node we parse it using the above keys
+  // once we have parsed the first "graph" xml node we exit
+  while (ret == 1 && !finishedGraph) {
+    xmlChar* name;
+    name = xmlTextReaderName(reader);
+    if (name == NULL) {
+      name = xmlStrdup(BAD_CAST "--");
+    }
+    // if elt is an xml node
+    if (xmlTextReaderNodeType(reader) == 1) {
+      // if elt is a "key" xml node read it in
+      if (xmlStrEqual(name, BAD_CAST "key")) {
+        PropertyKey key = katana::graphml::ProcessKey(reader);
+        if (!key.id.empty() && key.id != std::string("label") &&
+            key.id != std::string("IGNORE")) {
+          if (key.for_node || key.for_edge) {
+            on_key(std::move(key));
           }
-          ProcessGraph(reader, &builder, false);
-          finishedGraph = true;
         }
+      } else if (xmlStrEqual(name, BAD_CAST "graph")) {
+        if (verbose) {
+          std::cout << "Finished processing property headers\n";
+        }
+        ProcessGraph(reader, on_node, on_edge, false);
+        finishedGraph = true;
       }
+    }
+
+    xmlFree(name);
+    ret = xmlTextReaderRead(reader);
+  }
+  xmlFreeTextReader(reader);
+  if (ret < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "Failed to parse {}, incorrect xml format\n"
+        "Please verify there are no illegal characters in the GraphML file\n"
+        "To remove invalid characters use: \"sed -i $'s/[^[:print:]\t]//g' "
+        "{}\", warning this will alter the original file",
+        infilename, infilename);
+  }
+  return katana::ResultSuccess();
+}
 
-      xmlFree(name);
-      ret = xmlTextReaderRead(reader);
+/// Add the values and labels of element to the node or edge that builder is
+/// building
+void
+AddValuesAndLabels(
+    const RawElement& element, katana::PropertyGraphBuilder* builder) {
+  for (const auto& property : element.data) {
+    const std::string& value = property.second;
+    builder->AddValue(
+        property.first,
+        [&]() {
+          return PropertyKey{property.first, ImportDataType::kString, false};
+        },
+        [&value](ImportDataType type, bool is_list) {
+          return ResolveValue(value, type, is_list);
+        });
+  }
+  for (const std::string& label : element.labels) {
+    builder->AddLabel(label);
+  }
+}
+
+void
+AddNode(const RawElement& node, katana::PropertyGraphBuilder* builder) {
+  if (node.id.empty()) {
+    return;
+  }
+  builder->StartNode(node.id);
+  AddValuesAndLabels(node, builder);
+  builder->FinishNode();
+}
+
+void
+AddEdge(const RawElement& edge, katana::PropertyGraphBuilder* builder) {
+  if (edge.source.empty() || edge.target.empty() ||
+      !builder->StartEdge(edge.source, edge.target)) {
+    return;
+  }
+  AddValuesAndLabels(edge, builder);
+  builder->FinishEdge();
+}
+
+/*****************************************/
+/* Functions for streaming GraphML files */
+/*****************************************/
+
+/// Consecutive nodes, or consecutive edges, of a GraphML file
+struct ElementBatch {
+  bool edges{false};
+  // position of the batch in the file
+  size_t index{0};
+  // for nodes, the index of the first node of the batch
+  uint64_t first_node{0};
+  // for edges, the number of node batches before this one
+  size_t node_batches_before{0};
+  std::vector<RawElement> elements;
+};
+
+/// A FIFO of batches with bounded capacity, from the thread reading the file
+/// to the threads converting batches
+class BatchQueue {
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::deque<ElementBatch> batches_;
+  size_t capacity_;
+  bool closed_{false};
+
+public:
+  BatchQueue(size_t capacity) : capacity_(capacity) {}
+
+  /// Move batch to the back of the queue unless it is full
+  bool TryPush(ElementBatch* batch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (batches_.size() >= capacity_) {
+      return false;
     }
-    xmlFreeTextReader(reader);
-    if (ret < 0) {
-      return KATANA_ERROR(
-          ErrorCode::InvalidArgument,
-          "Failed to parse {}, incorrect xml format\n"
-          "Please verify there are no illegal characters in the GraphML file\n"
-          "To remove invalid characters use: \"sed -i $'s/[^[:print:]\t]//g' "
-          "{}\", warning this will alter the original file",
-          infilename, infilename);
+    batches_.emplace_back(std::move(*batch));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /// Remove the oldest batch, if there is one
+  std::optional<ElementBatch> TryPop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return PopLocked();
+  }
+
+  /// Remove the oldest batch, waiting for one while the queue is open.
+  /// Returns nullopt once the queue is closed and empty.
+  std::optional<ElementBatch> Pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this]() { return !batches_.empty() || closed_; });
+    return PopLocked();
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+private:
+  std::optional<ElementBatch> PopLocked() {
+    if (batches_.empty()) {
+      return std::nullopt;
+    }
+    ElementBatch batch = std::move(batches_.front());
+    batches_.pop_front();
+    return batch;
+  }
+};
+
+/// The number of node batches converted so far
+class BatchCounter {
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  size_t count_{0};
+
+public:
+  void Increment() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    count_++;
+    changed_.notify_all();
+  }
+
+  void WaitFor(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this, count]() { return count_ >= count; });
+  }
+};
+
+/// The index of each node ID seen so far, in partitions by hash so that
+/// threads converting batches rarely wait for each other
+class NodeDictionary {
+  struct Partition {
+    std::mutex mutex;
+    std::unordered_map<std::string, uint64_t> indexes;
+  };
+  std::vector<Partition> partitions_;
+
+  Partition& PartitionOf(const std::string& id) {
+    return partitions_[std::hash<std::string>{}(id) % partitions_.size()];
+  }
+
+public:
+  NodeDictionary(size_t num_partitions) : partitions_(num_partitions) {}
+
+  /// Add id with index; like PropertyGraphBuilder, the first definition of
+  /// an ID in the file wins
+  void Insert(const std::string& id, uint64_t index) {
+    Partition& partition = PartitionOf(id);
+    std::lock_guard<std::mutex> lock(partition.mutex);
+    auto [it, inserted] = partition.indexes.emplace(id, index);
+    if (!inserted && index < it->second) {
+      it->second = index;
+    }
+  }
+
+  std::optional<uint64_t> Find(const std::string& id) {
+    Partition& partition = PartitionOf(id);
+    std::lock_guard<std::mutex> lock(partition.mutex);
+    auto it = partition.indexes.find(id);
+    if (it == partition.indexes.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+};
+
+/// What stays in memory of a converted batch: the schemas of its tables,
+/// which are staged in Parquet files, and the endpoints of its edges
+struct StagedBatch {
+  bool edges{false};
+  size_t index{0};
+  uint64_t rows{0};
+  std::shared_ptr<arrow::Schema> properties_schema;
+  std::shared_ptr<arrow::Schema> labels_schema;
+  katana::Uri properties_uri;
+  katana::Uri labels_uri;
+  std::vector<uint64_t> sources;
+  std::vector<uint64_t> destinations;
+  // endpoints whose node was not yet converted, as 2 * edge for sources or
+  // 2 * edge + 1 for destinations, and the ID of the node
+  std::vector<std::pair<uint64_t, std::string>> unresolved;
+};
+
+/// Write table to a new file in staging_dir, if it has any columns
+katana::Result<katana::Uri>
+StageTable(
+    const std::shared_ptr<arrow::Table>& table, const katana::Uri& staging_dir,
+    const std::string& prefix) {
+  if (table->num_columns() == 0) {
+    return katana::Uri{};
+  }
+  auto writer_res = tsuba::ParquetWriter::Make(table);
+  if (!writer_res) {
+    return writer_res.error().WithContext("making staging writer");
+  }
+  katana::Uri uri = staging_dir.RandFile(prefix);
+  if (auto res = writer_res.value()->WriteToUri(uri); !res) {
+    return res.error().WithContext("staging {}", uri);
+  }
+  return uri;
+}
+
+/// Convert the values and labels of batch to Arrow and stage them, and
+/// resolve the endpoints of its edges with the nodes converted so far
+katana::Result<StagedBatch>
+StageBatch(
+    const ElementBatch& batch, const std::vector<PropertyKey>& keys,
+    NodeDictionary* dictionary, const katana::Uri& staging_dir) {
+  katana::PropertyGraphBuilder builder{batch.elements.size()};
+  for (const PropertyKey& key : keys) {
+    builder.AddBuilder(key);
+  }
+
+  StagedBatch staged;
+  staged.edges = batch.edges;
+  staged.index = batch.index;
+  staged.rows = batch.elements.size();
+  if (!batch.edges) {
+    for (size_t i = 0; i < batch.elements.size(); ++i) {
+      AddNode(batch.elements[i], &builder);
+      dictionary->Insert(batch.elements[i].id, batch.first_node + i);
     }
   } else {
-    return KATANA_ERROR(ErrorCode::NotFound, "Unable to open {}", infilename);
+    staged.sources.resize(batch.elements.size());
+    staged.destinations.resize(batch.elements.size());
+    for (size_t i = 0; i < batch.elements.size(); ++i) {
+      const RawElement& edge = batch.elements[i];
+      builder.StartEdge();
+      AddValuesAndLabels(edge, &builder);
+      builder.FinishEdge();
+
+      if (auto src = dictionary->Find(edge.source); src) {
+        staged.sources[i] = src.value();
+      } else {
+        staged.unresolved.emplace_back(2 * i, edge.source);
+      }
+      if (auto dest = dictionary->Find(edge.target); dest) {
+        staged.destinations[i] = dest.value();
+      } else {
+        staged.unresolved.emplace_back(2 * i + 1, edge.target);
+      }
+    }
+  }
+
+  katana::GraphComponents tables = builder.FinishTables();
+  const katana::GraphComponent& component =
+      batch.edges ? tables.edges : tables.nodes;
+  std::string prefix = fmt::format(
+      "graphml-{}-{}", batch.edges ? "edges" : "nodes", batch.index);
+
+  staged.properties_schema = component.properties->schema();
+  auto properties_res =
+      StageTable(component.properties, staging_dir, prefix + "-properties");
+  if (!properties_res) {
+    return properties_res.error();
+  }
+  staged.properties_uri = std::move(properties_res.value());
+
+  staged.labels_schema = component.labels->schema();
+  auto labels_res =
+      StageTable(component.labels, staging_dir, prefix + "-labels");
+  if (!labels_res) {
+    return labels_res.error();
+  }
+  staged.labels_uri = std::move(labels_res.value());
+
+  return staged;
+}
+
+/// The union of the fields of schemas, in order of first appearance. A field
+/// must have the same type in every schema that has it.
+katana::Result<std::vector<std::shared_ptr<arrow::Field>>>
+MergeSchemas(const std::vector<const arrow::Schema*>& schemas) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::unordered_map<std::string, size_t> field_indexes;
+  for (const arrow::Schema* schema : schemas) {
+    for (const auto& field : schema->fields()) {
+      auto [it, inserted] = field_indexes.emplace(field->name(), fields.size());
+      if (inserted) {
+        fields.emplace_back(field);
+      } else if (!fields[it->second]->type()->Equals(field->type())) {
+        return KATANA_ERROR(
+            katana::ErrorCode::TypeError,
+            "property {} is of types {} and {} in the same file",
+            field->name(), fields[it->second]->type()->ToString(),
+            field->type()->ToString());
+      }
+    }
+  }
+  return fields;
+}
+
+/// Split the concatenation of arrays into chunks of chunk_size elements,
+/// like the chunks of PropertyGraphBuilder, without copying them if they
+/// already are
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+Rechunk(
+    const std::shared_ptr<arrow::DataType>& type,
+    const std::vector<std::shared_ptr<arrow::Array>>& arrays,
+    size_t chunk_size) {
+  bool chunked = true;
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    size_t length = arrays[i]->length();
+    if (length > chunk_size || (length < chunk_size && i + 1 < arrays.size())) {
+      chunked = false;
+    }
+  }
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  if (chunked) {
+    chunks = arrays;
+  } else {
+    auto concat_res = arrow::Concatenate(arrays);
+    if (!concat_res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(concat_res.status()),
+          "concatenating column: {}", concat_res.status());
+    }
+    std::shared_ptr<arrow::Array> column = concat_res.ValueOrDie();
+    for (int64_t i = 0; i < column->length(); i += chunk_size) {
+      chunks.emplace_back(column->Slice(i, chunk_size));
+    }
+  }
+  auto chunked_res = arrow::ChunkedArray::Make(chunks, type);
+  if (!chunked_res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(chunked_res.status()),
+        "building column: {}", chunked_res.status());
+  }
+  return chunked_res.ValueOrDie();
+}
+
+/// Read the column field of the staged tables of batches in order, followed
+/// by extra_rows more. Batches without the column, and the extra rows, are
+/// null, or false for labels.
+katana::Result<std::vector<std::shared_ptr<arrow::Array>>>
+ReadStagedColumn(
+    const std::vector<const StagedBatch*>& batches, bool labels,
+    const std::shared_ptr<arrow::Field>& field, uint64_t extra_rows,
+    tsuba::ParquetReader* reader) {
+  auto filler = [&](uint64_t rows) {
+    return labels
+               ? arrow::MakeArrayFromScalar(arrow::BooleanScalar(false), rows)
+               : arrow::MakeArrayOfNull(field->type(), rows);
+  };
+
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  for (const StagedBatch* batch : batches) {
+    const auto& schema = labels ? batch->labels_schema
+                                : batch->properties_schema;
+    int index = schema->GetFieldIndex(field->name());
+    if (index >= 0) {
+      const katana::Uri& uri =
+          labels ? batch->labels_uri : batch->properties_uri;
+      auto column_res = reader->ReadColumn(uri, index);
+      if (!column_res) {
+        return column_res.error().WithContext("reading staged {}", uri);
+      }
+      const auto& chunks = column_res.value()->column(0)->chunks();
+      arrays.insert(arrays.end(), chunks.begin(), chunks.end());
+      continue;
+    }
+    auto filler_res = filler(batch->rows);
+    if (!filler_res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(filler_res.status()),
+          "filling column {}: {}", field->name(), filler_res.status());
+    }
+    arrays.emplace_back(filler_res.ValueOrDie());
+  }
+  if (extra_rows > 0) {
+    auto filler_res = filler(extra_rows);
+    if (!filler_res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(filler_res.status()),
+          "filling column {}: {}", field->name(), filler_res.status());
+    }
+    arrays.emplace_back(filler_res.ValueOrDie());
+  }
+  return arrays;
+}
+
+/// Build a table of the merged columns of the staged tables of batches, one
+/// column at a time. If order is not null, row i of the table is row
+/// order[i] of the concatenated batches.
+katana::Result<std::shared_ptr<arrow::Table>>
+BuildStagedTable(
+    const std::vector<const StagedBatch*>& batches, bool labels,
+    uint64_t extra_rows, const std::shared_ptr<arrow::UInt64Array>& order,
+    size_t chunk_size, tsuba::ParquetReader* reader) {
+  std::vector<const arrow::Schema*> schemas;
+  for (const StagedBatch* batch : batches) {
+    schemas.emplace_back(
+        labels ? batch->labels_schema.get() : batch->properties_schema.get());
+  }
+  auto fields_res = MergeSchemas(schemas);
+  if (!fields_res) {
+    return fields_res.error();
+  }
+  const auto& fields = fields_res.value();
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& field : fields) {
+    auto arrays_res =
+        ReadStagedColumn(batches, labels, field, extra_rows, reader);
+    if (!arrays_res) {
+      return arrays_res.error();
+    }
+    std::vector<std::shared_ptr<arrow::Array>> arrays =
+        std::move(arrays_res.value());
+
+    if (order) {
+      auto column = std::make_shared<arrow::ChunkedArray>(
+          std::move(arrays), field->type());
+      auto take_res = arrow::compute::Take(
+          arrow::Datum(column), arrow::Datum(order));
+      if (!take_res.ok()) {
+        return KATANA_ERROR(
+            katana::ArrowToKatana(take_res.status()),
+            "ordering column {}: {}", field->name(), take_res.status());
+      }
+      arrays = take_res.ValueOrDie().chunked_array()->chunks();
+    }
+
+    auto column_res = Rechunk(field->type(), arrays, chunk_size);
+    if (!column_res) {
+      return column_res.error();
+    }
+    columns.emplace_back(std::move(column_res.value()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+/// Build the graph from the staged batches, which are in file order
+katana::Result<katana::GraphComponents>
+BuildStagedGraph(
+    std::vector<StagedBatch>* staged, NodeDictionary* dictionary,
+    size_t chunk_size, bool verbose) {
+  std::vector<const StagedBatch*> node_batches;
+  std::vector<StagedBatch*> edge_batches;
+  uint64_t num_defined_nodes = 0;
+  uint64_t num_edges = 0;
+  for (StagedBatch& batch : *staged) {
+    if (batch.edges) {
+      edge_batches.emplace_back(&batch);
+      num_edges += batch.rows;
+    } else {
+      node_batches.emplace_back(&batch);
+      num_defined_nodes += batch.rows;
+    }
+  }
+
+  // nodes defined after an edge to them, or never, are resolved now; the
+  // latter become placeholder nodes after all defined nodes
+  std::unordered_map<std::string, uint64_t> placeholders;
+  for (StagedBatch* batch : edge_batches) {
+    for (const auto& [endpoint, id] : batch->unresolved) {
+      uint64_t node = 0;
+      if (auto index = dictionary->Find(id); index) {
+        node = index.value();
+      } else {
+        uint64_t next = num_defined_nodes + placeholders.size();
+        auto [it, inserted] = placeholders.emplace(id, next);
+        if (inserted && verbose) {
+          std::cout << "Adding placeholder node: " << id << std::endl;
+        }
+        node = it->second;
+      }
+      if (endpoint % 2 == 0) {
+        batch->sources[endpoint / 2] = node;
+      } else {
+        batch->destinations[endpoint / 2] = node;
+      }
+    }
+    batch->unresolved.clear();
+  }
+  uint64_t num_nodes = num_defined_nodes + placeholders.size();
+  if (num_nodes >= std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} nodes do not fit in 32-bit node ids", num_nodes);
+  }
+
+  // build the CSR, keeping the edges of each node in file order
+  std::vector<uint64_t> out_indices(num_nodes, 0);
+  for (const StagedBatch* batch : edge_batches) {
+    for (uint64_t src : batch->sources) {
+      out_indices[src]++;
+    }
+  }
+  // offsets are where the edges of each node start, out_indices where they
+  // end
+  std::vector<uint64_t> offsets(num_nodes, 0);
+  uint64_t begin = 0;
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    offsets[n] = begin;
+    begin += out_indices[n];
+    out_indices[n] = begin;
+  }
+
+  std::vector<uint64_t> order(num_edges);
+  std::vector<uint32_t> out_dests(num_edges);
+  uint64_t edge = 0;
+  for (StagedBatch* batch : edge_batches) {
+    for (uint64_t i = 0; i < batch->rows; ++i, ++edge) {
+      uint64_t position = offsets[batch->sources[i]]++;
+      order[position] = edge;
+      out_dests[position] = static_cast<uint32_t>(batch->destinations[i]);
+    }
+    batch->sources = std::vector<uint64_t>();
+    batch->destinations = std::vector<uint64_t>();
+  }
+  offsets = std::vector<uint64_t>();
+
+  auto topology = std::make_shared<katana::GraphTopology>();
+  topology->out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+      katana::BuildArray(out_indices));
+  out_indices = std::vector<uint64_t>();
+  topology->out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+      katana::BuildArray(out_dests));
+  out_dests = std::vector<uint32_t>();
+  auto order_array =
+      std::static_pointer_cast<arrow::UInt64Array>(katana::BuildArray(order));
+  order = std::vector<uint64_t>();
+
+  if (verbose) {
+    std::cout << "Finished topology and ordering edges\n";
+  }
+
+  // read the staged tables back one column at a time
+  tsuba::ParquetReader::ReadOpts opts;
+  opts.make_cannonical = false;
+  auto reader_res = tsuba::ParquetReader::Make(opts);
+  if (!reader_res) {
+    return reader_res.error();
+  }
+  tsuba::ParquetReader* reader = reader_res.value().get();
+
+  uint64_t num_placeholders = placeholders.size();
+  auto node_properties = BuildStagedTable(
+      node_batches, false, num_placeholders, nullptr, chunk_size, reader);
+  if (!node_properties) {
+    return node_properties.error();
+  }
+  auto node_labels = BuildStagedTable(
+      node_batches, true, num_placeholders, nullptr, chunk_size, reader);
+  if (!node_labels) {
+    return node_labels.error();
+  }
+
+  std::vector<const StagedBatch*> const_edge_batches(
+      edge_batches.begin(), edge_batches.end());
+  auto edge_properties = BuildStagedTable(
+      const_edge_batches, false, 0, order_array, chunk_size, reader);
+  if (!edge_properties) {
+    return edge_properties.error();
+  }
+  auto edge_types = BuildStagedTable(
+      const_edge_batches, true, 0, order_array, chunk_size, reader);
+  if (!edge_types) {
+    return edge_types.error();
+  }
+
+  if (verbose) {
+    std::cout << "Nodes: " << num_nodes << " (" << num_placeholders
+              << " placeholders)\n";
+    std::cout << "Node Properties: " << node_properties.value()->num_columns()
+              << "\n";
+    std::cout << "Node Labels: " << node_labels.value()->num_columns() << "\n";
+    std::cout << "Edges: " << num_edges << "\n";
+    std::cout << "Edge Properties: " << edge_properties.value()->num_columns()
+              << "\n";
+    std::cout << "Edge Types: " << edge_types.value()->num_columns() << "\n";
+  }
+
+  return katana::GraphComponents{
+      katana::GraphComponent{node_properties.value(), node_labels.value()},
+      katana::GraphComponent{edge_properties.value(), edge_types.value()},
+      topology};
+}
+
+void
+RemoveStagedFiles(
+    const katana::Uri& staging_dir, const std::vector<StagedBatch>& staged) {
+  std::unordered_set<std::string> files;
+  for (const StagedBatch& batch : staged) {
+    for (const katana::Uri* uri : {&batch.properties_uri, &batch.labels_uri}) {
+      if (!uri->empty()) {
+        files.emplace(uri->BaseName());
+      }
+    }
+  }
+  if (files.empty()) {
+    return;
+  }
+  if (auto res = tsuba::FileDelete(staging_dir.string(), files); !res) {
+    KATANA_LOG_WARN("could not remove staged files: {}", res.error());
+  }
+}
+
+}  // end of unnamed namespace
+
+katana::Result<katana::GraphComponents>
+katana::ConvertGraphML(
+    const std::string& infilename, size_t chunk_size, bool verbose) {
+  katana::PropertyGraphBuilder builder{chunk_size};
+
+  auto res = ProcessGraphML(
+      infilename, [&](PropertyKey&& key) { builder.AddBuilder(key); },
+      [&](RawElement&& node) { AddNode(node, &builder); },
+      [&](RawElement&& edge) { AddEdge(edge, &builder); }, verbose);
+  if (!res) {
+    return res.error();
   }
   return builder.Finish(verbose);
 }
+
+katana::Result<katana::GraphComponents>
+katana::ConvertGraphMLStreaming(
+    const std::string& infilename, const std::string& staging_directory,
+    size_t chunk_size, bool verbose) {
+  if (chunk_size == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "chunk size must be positive");
+  }
+  auto staging_res = katana::Uri::Make(staging_directory);
+  if (!staging_res) {
+    return staging_res.error();
+  }
+  katana::Uri staging_dir = std::move(staging_res.value());
+
+  unsigned num_threads = katana::getActiveThreads();
+  BatchQueue queue(2 * num_threads);
+  BatchCounter converted_node_batches;
+  NodeDictionary dictionary(4 * num_threads);
+  std::vector<PropertyKey> keys;
+
+  std::mutex staged_mutex;
+  std::vector<StagedBatch> staged;
+  katana::Result<void> staged_res = katana::ResultSuccess();
+
+  auto convert = [&](ElementBatch&& batch) {
+    // wait for the nodes before these edges so that most endpoints resolve
+    // right away
+    if (batch.edges) {
+      converted_node_batches.WaitFor(batch.node_batches_before);
+    }
+    auto res = StageBatch(batch, keys, &dictionary, staging_dir);
+    {
+      std::lock_guard<std::mutex> lock(staged_mutex);
+      if (!res) {
+        if (staged_res) {
+          staged_res = res.error();
+        }
+      } else {
+        staged.emplace_back(std::move(res.value()));
+      }
+    }
+    if (!batch.edges) {
+      converted_node_batches.Increment();
+    }
+  };
+
+  katana::Result<void> read_res = katana::ResultSuccess();
+  katana::on_each([&](unsigned tid, unsigned) {
+    if (tid == 0) {
+      ElementBatch current;
+      size_t num_batches = 0;
+      size_t num_node_batches = 0;
+      uint64_t num_nodes = 0;
+
+      auto flush = [&]() {
+        if (current.elements.empty()) {
+          return;
+        }
+        current.index = num_batches++;
+        if (current.edges) {
+          current.node_batches_before = num_node_batches;
+        } else {
+          current.first_node = num_nodes - current.elements.size();
+          num_node_batches++;
+        }
+        // rather than wait for room, convert the oldest batch here, which
+        // also keeps a single thread from waiting forever
+        while (!queue.TryPush(&current)) {
+          if (auto oldest = queue.TryPop(); oldest) {
+            convert(std::move(oldest.value()));
+          }
+        }
+        current = ElementBatch{};
+      };
+      auto add = [&](RawElement&& element, bool edges) {
+        if (current.edges != edges) {
+          flush();
+          current.edges = edges;
+        }
+        current.elements.emplace_back(std::move(element));
+        if (current.elements.size() == chunk_size) {
+          flush();
+          current.edges = edges;
+        }
+      };
+
+      read_res = ProcessGraphML(
+          infilename,
+          [&](PropertyKey&& key) { keys.emplace_back(std::move(key)); },
+          [&](RawElement&& node) {
+            if (!node.id.empty()) {
+              num_nodes++;
+              add(std::move(node), false);
+            }
+          },
+          [&](RawElement&& edge) {
+            if (!edge.source.empty() && !edge.target.empty()) {
+              add(std::move(edge), true);
+            }
+          },
+          verbose);
+      flush();
+      queue.Close();
+    }
+    while (auto batch = queue.Pop()) {
+      convert(std::move(batch.value()));
+    }
+  });
+
+  if (!read_res) {
+    RemoveStagedFiles(staging_dir, staged);
+    return read_res.error();
+  }
+  if (!staged_res) {
+    RemoveStagedFiles(staging_dir, staged);
+    return staged_res.error();
+  }
+  if (verbose) {
+    std::cout << "Finished staging " << staged.size() << " batches\n";
+  }
+
+  std::sort(
+      staged.begin(), staged.end(),
+      [](const StagedBatch& a, const StagedBatch& b) {
+        return a.index < b.index;
+      });
+  auto components = BuildStagedGraph(&staged, &dictionary, chunk_size, verbose);
+  RemoveStagedFiles(staging_dir, staged);
+  return components;
+}
@@ -0,0 +1,205 @@
+#include "katana/GraphView.h"
+
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+/// The rows of property whose value is true (non-zero) and not null
+katana::Result<katana::DynamicBitset>
+PropertyMask(
+    const std::shared_ptr<arrow::ChunkedArray>& property,
+    const std::string& property_name) {
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property {}", property_name);
+  }
+  auto type_id = property->type()->id();
+  if (type_id != arrow::Type::BOOL && type_id != arrow::Type::UINT8) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "property {} of type {} is not boolean or uint8", property_name,
+        property->type()->ToString());
+  }
+
+  katana::DynamicBitset mask;
+  mask.resize(property->length());
+  uint64_t offset = 0;
+  for (const auto& chunk : property->chunks()) {
+    std::shared_ptr<arrow::BooleanArray> bools;
+    std::shared_ptr<arrow::UInt8Array> bytes;
+    if (type_id == arrow::Type::BOOL) {
+      bools = std::static_pointer_cast<arrow::BooleanArray>(chunk);
+    } else {
+      bytes = std::static_pointer_cast<arrow::UInt8Array>(chunk);
+    }
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t(chunk->length())),
+        [&](uint64_t i) {
+          if (!chunk->IsNull(i) &&
+              (bools ? bools->Value(i) : bytes->Value(i) != 0)) {
+            mask.set(offset + i);
+          }
+        },
+        katana::no_stats());
+    offset += chunk->length();
+  }
+  return mask;
+}
+
+katana::Result<katana::DynamicBitset>
+CopyMask(const katana::DynamicBitset& bits, uint64_t size, const char* what) {
+  if (bits.size() != size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "a filter of {} bits does not match the {} {} of the graph",
+        bits.size(), size, what);
+  }
+  katana::DynamicBitset mask;
+  mask.resize(size);
+  mask.bitwise_or(bits);
+  return mask;
+}
+
+}  // namespace
+
+katana::GraphView::GraphView(PropertyGraph* pg) : pg_(pg) {}
+
+void
+katana::GraphView::Restrict(
+    DynamicBitset* filter, bool* all, DynamicBitset&& mask) {
+  if (*all) {
+    *filter = std::move(mask);
+    *all = false;
+  } else {
+    filter->bitwise_and(mask);
+  }
+  compact_ids_.reset();
+}
+
+katana::Result<void>
+katana::GraphView::FilterNodesByType(const std::string& type_name) {
+  if (!pg_->HasNodeType(type_name)) {
+    return KATANA_ERROR(ErrorCode::NotFound, "no node type {}", type_name);
+  }
+  const PropertyGraph::SetOfTypeSetIDs& type_set_ids =
+      pg_->NodeTypeNameToTypeSetIDs(type_name);
+  FilterNodesIf([&](uint64_t n) {
+    return type_set_ids.test(pg_->GetNodeTypeSetID(n));
+  });
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::GraphView::FilterEdgesByType(const std::string& type_name) {
+  if (!pg_->HasEdgeType(type_name)) {
+    return KATANA_ERROR(ErrorCode::NotFound, "no edge type {}", type_name);
+  }
+  const PropertyGraph::SetOfTypeSetIDs& type_set_ids =
+      pg_->EdgeTypeNameToTypeSetIDs(type_name);
+  FilterEdgesIf([&](uint64_t e) {
+    return type_set_ids.test(pg_->GetEdgeTypeSetID(e));
+  });
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::GraphView::FilterNodesByProperty(const std::string& property_name) {
+  auto mask_res =
+      PropertyMask(pg_->GetNodeProperty(property_name), property_name);
+  if (!mask_res) {
+    return mask_res.error().WithContext("filtering nodes");
+  }
+  Restrict(&nodes_, &all_nodes_, std::move(mask_res.value()));
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::GraphView::FilterEdgesByProperty(const std::string& property_name) {
+  auto mask_res =
+      PropertyMask(pg_->GetEdgeProperty(property_name), property_name);
+  if (!mask_res) {
+    return mask_res.error().WithContext("filtering edges");
+  }
+  Restrict(&edges_, &all_edges_, std::move(mask_res.value()));
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::GraphView::FilterNodes(const DynamicBitset& nodes) {
+  auto mask_res = CopyMask(nodes, topology().num_nodes(), "nodes");
+  if (!mask_res) {
+    return mask_res.error();
+  }
+  Restrict(&nodes_, &all_nodes_, std::move(mask_res.value()));
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::GraphView::FilterEdges(const DynamicBitset& edges) {
+  auto mask_res = CopyMask(edges, topology().num_edges(), "edges");
+  if (!mask_res) {
+    return mask_res.error();
+  }
+  Restrict(&edges_, &all_edges_, std::move(mask_res.value()));
+  return ResultSuccess();
+}
+
+uint64_t
+katana::GraphView::num_nodes() const {
+  return all_nodes_ ? topology().num_nodes() : nodes_.count();
+}
+
+uint64_t
+katana::GraphView::num_edges() const {
+  if (all_nodes_ && all_edges_) {
+    return topology().num_edges();
+  }
+  katana::GAccumulator<uint64_t> num_edges;
+  katana::do_all(
+      katana::iterate(*this),
+      [&](Node n) { num_edges += edges(n).size(); },
+      katana::steal(), katana::no_stats());
+  return num_edges.reduce();
+}
+
+const katana::GraphView::CompactIds&
+katana::GraphView::compact_ids() const {
+  if (compact_ids_) {
+    return *compact_ids_;
+  }
+
+  // The compact id of a node is the number of nodes in the view before it
+  uint64_t size = topology().num_nodes();
+  auto ids = std::make_unique<CompactIds>();
+  ids->compact_ids.allocateBlocked(size);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, size),
+      [&](uint64_t n) { ids->compact_ids[n] = contains(n) ? 1 : 0; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      ids->compact_ids.begin(), ids->compact_ids.end(),
+      ids->compact_ids.begin());
+
+  ids->graph_ids.allocateBlocked(num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, size),
+      [&](uint64_t n) {
+        if (contains(n)) {
+          Node compact_id = ids->compact_ids[n] - 1;
+          ids->compact_ids[n] = compact_id;
+          ids->graph_ids[compact_id] = n;
+        } else {
+          ids->compact_ids[n] = CompactIds::kNotInView;
+        }
+      },
+      katana::no_stats());
+
+  compact_ids_ = std::move(ids);
+  return *compact_ids_;
+}
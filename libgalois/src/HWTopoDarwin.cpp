@@ -56,6 +56,7 @@ makeHWTopo() {
   mti.maxThreads = getIntValue("hw.logicalcpu_max");
   mti.maxCores = getIntValue("hw.physicalcpu_max");
   mti.maxNumaNodes = mti.maxSockets;
+  mti.maxCacheDomains = mti.maxSockets;
 
   std::vector<ThreadTopoInfo> tti;
   tti.reserve(mti.maxThreads);
@@ -84,6 +85,8 @@ makeHWTopo() {
         .numaNode = socket,
         .osContext = i,
         .osNumaNode = socket,
+        .cacheDomain = socket,
+        .cacheDomainLeader = leader,
     });
   }
 
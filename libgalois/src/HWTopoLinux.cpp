@@ -23,13 +23,20 @@
 #include <array>
 #include <cassert>
 #include <cerrno>
+#include <cmath>
 #include <cstring>
 #include <fstream>
 #include <functional>
+#include <limits>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
+#include <tuple>
+#include <utility>
 
+#include "katana/Env.h"
 #include "katana/HWTopo.h"
 #include "katana/SimpleLock.h"
 #include "katana/gIO.h"
@@ -52,6 +59,9 @@ struct cpuinfo {
   unsigned coreid;
   unsigned cpucores;
   unsigned numaNode;  // from libnuma
+  unsigned llc;       // lowest cpu sharing the last-level cache, from sysfs
+  unsigned domain;    // computed: cache domain, renumbered
+  unsigned group;     // computed: physid or domain, whichever are sockets
   bool valid;         // from cpuset
   bool smt;           // computed
 };
@@ -61,8 +71,8 @@ operator<(const cpuinfo& lhs, const cpuinfo& rhs) {
   if (lhs.smt != rhs.smt) {
     return lhs.smt < rhs.smt;
   }
-  if (lhs.physid != rhs.physid) {
-    return lhs.physid < rhs.physid;
+  if (lhs.group != rhs.group) {
+    return lhs.group < rhs.group;
   }
   if (lhs.coreid != rhs.coreid) {
     return lhs.coreid < rhs.coreid;
@@ -163,15 +173,113 @@ parseCPUInfo() {
   return vals;
 }
 
+//! The lowest cpu sharing the last-level cache of proc, or the maximum
+//! unsigned if sysfs does not say
+unsigned
+findLLC(unsigned proc) {
+  unsigned llc = std::numeric_limits<unsigned>::max();
+  int max_level = 0;
+  std::string cache_dir =
+      "/sys/devices/system/cpu/cpu" + std::to_string(proc) + "/cache/index";
+  for (int index = 0;; ++index) {
+    std::string dir = cache_dir + std::to_string(index);
+    std::ifstream level_file(dir + "/level");
+    int level = 0;
+    if (!(level_file >> level)) {
+      break;
+    }
+    std::ifstream type_file(dir + "/type");
+    std::string type;
+    type_file >> type;
+    std::ifstream shared_file(dir + "/shared_cpu_list");
+    std::string shared;
+    std::getline(shared_file, shared);
+    std::vector<int> cpus = katana::parseCPUList(shared);
+    if (type == "Instruction" || cpus.empty() || level <= max_level) {
+      continue;
+    }
+    max_level = level;
+    llc = *std::min_element(cpus.begin(), cpus.end());
+  }
+  return llc;
+}
+
+//! Number the cache domains and choose what is a socket
+void
+markDomains(std::vector<cpuinfo>& info) {
+  std::string socket_domain = "socket";
+  katana::GetEnv("KATANA_SOCKET_DOMAIN", &socket_domain);
+  if (socket_domain != "socket" && socket_domain != "cache") {
+    KATANA_LOG_WARN(
+        "unknown KATANA_SOCKET_DOMAIN {}; using sockets", socket_domain);
+  }
+
+  std::map<std::pair<unsigned, unsigned>, unsigned> domains;
+  for (auto& c : info) {
+    c.llc = findLLC(c.proc);
+    domains.emplace(std::make_pair(c.physid, c.llc), 0);
+  }
+  unsigned next = 0;
+  for (auto& [key, id] : domains) {
+    id = next++;
+  }
+  for (auto& c : info) {
+    c.domain = domains[std::make_pair(c.physid, c.llc)];
+    c.group = socket_domain == "cache" ? c.domain : c.physid;
+  }
+}
+
+//! Reorder threads, which are sorted one context per core first, according
+//! to KATANA_THREAD_PLACEMENT
+void
+applyPlacement(std::vector<cpuinfo>& info) {
+  std::string placement = "core";
+  katana::GetEnv("KATANA_THREAD_PLACEMENT", &placement);
+  if (placement == "compact") {
+    std::stable_sort(
+        info.begin(), info.end(), [](const cpuinfo& a, const cpuinfo& b) {
+          return std::make_tuple(a.group, a.physid, a.coreid) <
+                 std::make_tuple(b.group, b.physid, b.coreid);
+        });
+  } else if (placement == "scatter") {
+    // The i-th thread of every group comes before the (i+1)-th of any
+    std::map<unsigned, unsigned> seen;
+    std::vector<std::pair<unsigned, cpuinfo>> ranked;
+    for (auto& c : info) {
+      ranked.emplace_back(seen[c.group]++, c);
+    }
+    std::stable_sort(
+        ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+          return std::make_pair(a.first, a.second.group) <
+                 std::make_pair(b.first, b.second.group);
+        });
+    for (size_t i = 0; i < info.size(); ++i) {
+      info[i] = ranked[i].second;
+    }
+  } else if (placement != "core") {
+    KATANA_LOG_WARN(
+        "unknown KATANA_THREAD_PLACEMENT {}; using core", placement);
+  }
+}
+
 unsigned
 countSockets(const std::vector<cpuinfo>& info) {
   std::set<unsigned> pkgs;
   for (auto& c : info) {
-    pkgs.insert(c.physid);
+    pkgs.insert(c.group);
   }
   return pkgs.size();
 }
 
+unsigned
+countCacheDomains(const std::vector<cpuinfo>& info) {
+  std::set<unsigned> domains;
+  for (auto& c : info) {
+    domains.insert(c.domain);
+  }
+  return domains.size();
+}
+
 unsigned
 countCores(const std::vector<cpuinfo>& info) {
   std::set<std::pair<int, int>> cores;
@@ -202,10 +310,28 @@ markSMT(std::vector<cpuinfo>& info) {
   }
 }
 
+//! The cpus this process may run on, e.g., the cpuset of its container
 std::vector<int>
 parseCPUSet() {
   std::vector<int> vals;
 
+#ifdef KATANA_USE_SCHED_SETAFFINITY
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  // Fails on machines with more than CPU_SETSIZE cpus; fall back to
+  // /proc then
+  if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+    for (int i = 0; i < CPU_SETSIZE; ++i) {
+      if (CPU_ISSET(i, &mask)) {
+        vals.push_back(i);
+      }
+    }
+    if (!vals.empty()) {
+      return vals;
+    }
+  }
+#endif
+
   std::ifstream data("/proc/self/status");
 
   if (!data) {
@@ -236,6 +362,87 @@ parseCPUSet() {
   return katana::parseCPUList(line);
 }
 
+//! The cpus worth of time a cgroup v2 directory and its ancestors allow
+//! per period, or 0 for no limit
+double
+readCgroupV2Limit(std::string dir) {
+  double limit = 0;
+  for (;;) {
+    std::ifstream cpu_max("/sys/fs/cgroup" + dir + "/cpu.max");
+    std::string quota;
+    double period = 0;
+    if (cpu_max >> quota >> period && quota != "max" && period > 0) {
+      double l = std::stod(quota) / period;
+      limit = limit == 0 ? l : std::min(limit, l);
+    }
+    if (dir.empty() || dir == "/") {
+      return limit;
+    }
+    dir = dir.substr(0, dir.find_last_of('/'));
+  }
+}
+
+//! The cpus worth of time a cgroup v1 cpu controller directory allows per
+//! period, or 0 for no limit
+double
+readCgroupV1Limit(const std::string& dir) {
+  for (const char* root :
+       {"/sys/fs/cgroup/cpu,cpuacct", "/sys/fs/cgroup/cpu"}) {
+    for (const std::string& d : {dir, std::string()}) {
+      std::ifstream quota_file(root + d + "/cpu.cfs_quota_us");
+      std::ifstream period_file(root + d + "/cpu.cfs_period_us");
+      double quota = 0;
+      double period = 0;
+      if (quota_file >> quota && period_file >> period) {
+        return quota > 0 && period > 0 ? quota / period : 0;
+      }
+    }
+  }
+  return 0;
+}
+
+//! The number of cpus the CPU bandwidth limit (e.g., a Kubernetes CPU limit)
+//! of the cgroup of this process lets run at once without being
+//! throttled, rounded up, or 0 if there is no limit
+unsigned
+cgroupCPULimit() {
+  std::ifstream cgroup("/proc/self/cgroup");
+  std::string line;
+  double limit = 0;
+  // Lines are hierarchy-ID:controller-list:cgroup-path
+  while (std::getline(cgroup, line)) {
+    size_t first = line.find(':');
+    size_t second = line.find(':', first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+      continue;
+    }
+    std::string controllers = line.substr(first + 1, second - first - 1);
+    std::string path = line.substr(second + 1);
+    double l = 0;
+    if (line.compare(0, first, "0") == 0 && controllers.empty()) {
+      l = readCgroupV2Limit(path);
+    } else if (("," + controllers + ",").find(",cpu,") != std::string::npos) {
+      l = readCgroupV1Limit(path);
+    }
+    if (l > 0) {
+      limit = limit == 0 ? l : std::min(limit, l);
+    }
+  }
+  return std::ceil(limit);
+}
+
+//! Keep only as many threads as the cgroup CPU limit can run; spinning
+//! more would use up the quota and get all of them throttled
+void
+limitToCPUQuota(std::vector<cpuinfo>& info) {
+  bool ignore = false;
+  katana::GetEnv("KATANA_IGNORE_CPU_QUOTA", &ignore);
+  unsigned limit = ignore ? 0 : cgroupCPULimit();
+  if (limit > 0 && limit < info.size()) {
+    info.resize(limit);
+  }
+}
+
 void
 markValid(std::vector<cpuinfo>& info) {
   auto v = parseCPUSet();
@@ -256,6 +463,7 @@ makeHWTopo() {
   katana::MachineTopoInfo retMTI;
 
   auto info = parseCPUInfo();
+  markDomains(info);
   std::sort(info.begin(), info.end());
   markSMT(info);
   markValid(info);
@@ -267,36 +475,48 @@ makeHWTopo() {
 
   std::sort(info.begin(), info.end());
   markSMT(info);
+  applyPlacement(info);
+  limitToCPUQuota(info);
   retMTI.maxSockets = countSockets(info);
   retMTI.maxThreads = info.size();
   retMTI.maxCores = countCores(info);
   retMTI.maxNumaNodes = countNumaNodes(info);
+  retMTI.maxCacheDomains = countCacheDomains(info);
 
   std::vector<katana::ThreadTopoInfo> retTTI;
   retTTI.reserve(retMTI.maxThreads);
   // compute renumberings
   std::set<unsigned> sockets;
   std::set<unsigned> numaNodes;
+  std::set<unsigned> domains;
   for (auto& i : info) {
-    sockets.insert(i.physid);
+    sockets.insert(i.group);
     numaNodes.insert(i.numaNode);
+    domains.insert(i.domain);
   }
   unsigned mid = 0;  // max socket id
   for (unsigned i = 0; i < info.size(); ++i) {
-    unsigned pid = info[i].physid;
-    unsigned repid =
-        std::distance(sockets.begin(), sockets.find(info[i].physid));
+    unsigned pid = info[i].group;
+    unsigned did = info[i].domain;
+    unsigned repid = std::distance(sockets.begin(), sockets.find(pid));
     mid = std::max(mid, repid);
     unsigned leader = std::distance(
         info.begin(),
         std::find_if(info.begin(), info.end(), [pid](const cpuinfo& c) {
-          return c.physid == pid;
+          return c.group == pid;
+        }));
+    unsigned domain_leader = std::distance(
+        info.begin(),
+        std::find_if(info.begin(), info.end(), [did](const cpuinfo& c) {
+          return c.domain == did;
         }));
     retTTI.push_back(katana::ThreadTopoInfo{
         i, leader, repid,
         (unsigned)std::distance(
             numaNodes.begin(), numaNodes.find(info[i].numaNode)),
-        mid, info[i].proc, info[i].numaNode});
+        mid, info[i].proc, info[i].numaNode,
+        (unsigned)std::distance(domains.begin(), domains.find(did)),
+        domain_leader});
   }
 
   return {
@@ -0,0 +1,82 @@
+#include "katana/HyperGraphView.h"
+
+#include <limits>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Galois.h"
+#include "katana/Reduction.h"
+
+katana::Result<katana::HyperGraphView>
+katana::HyperGraphView::Make(PropertyGraph* pg, uint64_t num_hyperedges) {
+  const GraphTopology& topology = pg->topology();
+  if (num_hyperedges > topology.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} hyperedges in a graph of {} nodes", num_hyperedges,
+        topology.num_nodes());
+  }
+
+  katana::GReduceLogicalOr bad_edges;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        if (n >= num_hyperedges) {
+          if (!topology.edges(n).empty()) {
+            bad_edges.update(true);
+          }
+          return;
+        }
+        for (auto e : topology.edges(n)) {
+          if (topology.edge_dest(e) < num_hyperedges) {
+            bad_edges.update(true);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (bad_edges.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edges must go from the first {} nodes to the others", num_hyperedges);
+  }
+  return HyperGraphView(pg, num_hyperedges);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::HyperGraphView::MakeGraph(
+    uint64_t num_nodes, const std::vector<std::vector<Node>>& hyperedges) {
+  uint64_t num_hyperedges = hyperedges.size();
+  if (num_nodes + num_hyperedges > std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} nodes and {} hyperedges do not fit in {} graph nodes", num_nodes,
+        num_hyperedges, std::numeric_limits<Node>::max());
+  }
+
+  std::vector<uint64_t> indices;
+  std::vector<Node> dests;
+  indices.reserve(num_nodes + num_hyperedges);
+  for (const std::vector<Node>& pins : hyperedges) {
+    for (Node n : pins) {
+      if (n >= num_nodes) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "hyperedge {} has node {} of {}", indices.size(), n, num_nodes);
+      }
+      dests.emplace_back(num_hyperedges + n);
+    }
+    indices.emplace_back(dests.size());
+  }
+  indices.resize(num_nodes + num_hyperedges, dests.size());
+
+  auto pg = std::make_unique<katana::PropertyGraph>();
+  if (auto res = pg->SetTopology(katana::GraphTopology{
+          .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+              katana::BuildArray(indices)),
+          .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+              katana::BuildArray(dests)),
+      });
+      !res) {
+    return res.error();
+  }
+  return std::unique_ptr<katana::PropertyGraph>(std::move(pg));
+}
@@ -0,0 +1,68 @@
+#include "katana/LoopSampler.h"
+
+#include <algorithm>
+#include <string>
+
+#include "katana/EnvCheck.h"
+#include "katana/Statistics.h"
+
+uint64_t
+katana::internal::LoopSampleInterval() {
+  static uint64_t interval = []() {
+    int usec = 0;
+    EnvCheck("KATANA_LOOP_SAMPLE_USEC", usec);
+    return static_cast<uint64_t>(std::max(usec, 0));
+  }();
+  return interval;
+}
+
+uint64_t
+katana::internal::LoopSampleTime() {
+  return sysStatManager()->TraceTime();
+}
+
+void
+katana::internal::ReportLoopSamples(
+    const char* loopname, const std::vector<LoopSample>& samples) {
+  if (samples.empty()) {
+    return;
+  }
+
+  StatManager* sm = sysStatManager();
+  std::string name(loopname);
+  int64_t max_pending = 0;
+  const LoopSample* prev = nullptr;
+  for (const auto& sample : samples) {
+    int64_t pending = static_cast<int64_t>(sample.pushes - sample.pops);
+    max_pending = std::max(max_pending, pending);
+
+    if (sm->IsTracing()) {
+      uint64_t pushes = sample.pushes - (prev ? prev->pushes : 0);
+      uint64_t pops = sample.pops - (prev ? prev->pops : 0);
+      sm->AddCounterEvent(
+          name + " pending", sample.time_usec, {{"items", pending}});
+      sm->AddCounterEvent(
+          name + " rate", sample.time_usec,
+          {{"pushes", static_cast<int64_t>(pushes)},
+           {"pops", static_cast<int64_t>(pops)}});
+
+      std::vector<std::pair<std::string, int64_t>> idle;
+      for (size_t t = 0; t < sample.idle_spins.size(); ++t) {
+        uint64_t spins =
+            sample.idle_spins[t] - (prev ? prev->idle_spins[t] : 0);
+        idle.emplace_back(
+            "thread " + std::to_string(t), static_cast<int64_t>(spins));
+      }
+      sm->AddCounterEvent(name + " idle spins", sample.time_usec, idle);
+    }
+    prev = &sample;
+  }
+
+  uint64_t idle_spins = 0;
+  for (auto spins : prev->idle_spins) {
+    idle_spins += spins;
+  }
+  ReportStatMax(name, "MaxPending", max_pending);
+  ReportStatSum(name, "IdleSpins", idle_spins);
+  ReportStatSum(name, "Samples", samples.size());
+}
@@ -0,0 +1,75 @@
+#include "katana/LowLatency.h"
+
+#include <mutex>
+
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+std::atomic<uint64_t> katana::internal::low_latency_threshold{0};
+
+thread_local bool katana::internal::low_latency_serial = false;
+
+namespace {
+
+std::mutex low_latency_mutex;
+/// The spin budget of the pool before EnableLowLatency
+uint64_t saved_spin_usec = 0;
+bool burning = false;
+
+}  // namespace
+
+void
+katana::EnableLowLatency(const LowLatencyOptions& options) {
+  std::lock_guard<std::mutex> lock(low_latency_mutex);
+  ThreadPool& pool = GetThreadPool();
+  if (internal::low_latency_threshold.load() == 0) {
+    saved_spin_usec = pool.getSpinBudget();
+  }
+  pool.setSpinBudget(options.spin_usec);
+  if (options.burn_power) {
+    pool.burnPower(getActiveThreads());
+  } else if (burning) {
+    pool.beKind();
+  }
+  burning = options.burn_power;
+  // A threshold of 0 would turn the mode off
+  internal::low_latency_threshold.store(
+      options.serial_threshold ? options.serial_threshold : 1);
+}
+
+void
+katana::DisableLowLatency() {
+  std::lock_guard<std::mutex> lock(low_latency_mutex);
+  if (internal::low_latency_threshold.load() == 0) {
+    return;
+  }
+  internal::low_latency_threshold.store(0);
+  ThreadPool& pool = GetThreadPool();
+  if (burning) {
+    pool.beKind();
+    burning = false;
+  }
+  pool.setSpinBudget(saved_spin_usec);
+}
+
+bool
+katana::IsLowLatency() {
+  return internal::low_latency_threshold.load() != 0;
+}
+
+katana::LowLatencyRegion::LowLatencyRegion(uint64_t size)
+    : previous_(internal::low_latency_serial) {
+  uint64_t threshold = internal::low_latency_threshold.load();
+  if (threshold != 0 && size <= threshold) {
+    internal::low_latency_serial = true;
+  }
+}
+
+katana::LowLatencyRegion::~LowLatencyRegion() {
+  internal::low_latency_serial = previous_;
+}
+
+bool
+katana::LowLatencyRegion::serial() const {
+  return internal::low_latency_serial;
+}
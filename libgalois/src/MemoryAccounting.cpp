@@ -0,0 +1,128 @@
+#include "katana/MemoryAccounting.h"
+
+#include <array>
+#include <atomic>
+
+#include "katana/Statistics.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+struct Counter {
+  std::atomic<int64_t> current{0};
+  std::atomic<int64_t> peak{0};
+  /// The peak since the start of the running loop
+  std::atomic<int64_t> loop_peak{0};
+};
+
+std::array<Counter, katana::kNumMemoryCategories> counters;
+
+thread_local katana::MemoryCategory current_category =
+    katana::MemoryCategory::kAnalytics;
+
+void
+RaiseTo(std::atomic<int64_t>* max, int64_t val) {
+  int64_t prev = max->load(std::memory_order_relaxed);
+  while (val > prev &&
+         !max->compare_exchange_weak(prev, val, std::memory_order_relaxed))
+    ;
+}
+
+Counter&
+GetCounter(katana::MemoryCategory category) {
+  return counters[static_cast<size_t>(category)];
+}
+
+}  // namespace
+
+const char*
+katana::MemoryCategoryName(MemoryCategory category) {
+  static constexpr const char* kNames[] = {
+      "Analytics", "Worklist", "Property", "IO"};
+  static_assert(std::size(kNames) == kNumMemoryCategories);
+  return kNames[static_cast<size_t>(category)];
+}
+
+void
+katana::AccountMemory(MemoryCategory category, int64_t bytes) {
+  Counter& counter = GetCounter(category);
+  int64_t current =
+      counter.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  if (bytes > 0) {
+    RaiseTo(&counter.peak, current);
+    RaiseTo(&counter.loop_peak, current);
+  }
+}
+
+katana::MemoryUsage
+katana::GetMemoryUsage(MemoryCategory category) {
+  const Counter& counter = GetCounter(category);
+  return MemoryUsage{
+      counter.current.load(std::memory_order_relaxed),
+      counter.peak.load(std::memory_order_relaxed)};
+}
+
+void
+katana::ResetMemoryPeaks() {
+  for (Counter& counter : counters) {
+    counter.peak.store(
+        counter.current.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  }
+}
+
+katana::MemoryCategory
+katana::CurrentMemoryCategory() {
+  return current_category;
+}
+
+katana::MemoryCategoryScope::MemoryCategoryScope(MemoryCategory category)
+    : prev_(current_category) {
+  current_category = category;
+}
+
+katana::MemoryCategoryScope::~MemoryCategoryScope() {
+  current_category = prev_;
+}
+
+void
+katana::ReportMemoryUsage(const std::string& region) {
+  for (size_t i = 0; i < kNumMemoryCategories; ++i) {
+    auto category = static_cast<MemoryCategory>(i);
+    MemoryUsage usage = GetMemoryUsage(category);
+    std::string name = MemoryCategoryName(category);
+    ReportStatSingle(region, name + "Bytes", usage.current);
+    ReportStatSingle(region, name + "PeakBytes", usage.peak);
+  }
+}
+
+void
+katana::internal::LoopMemoryStats::start() {
+  active_ = !ThreadPool::isInRun();
+  if (!active_) {
+    return;
+  }
+  for (size_t i = 0; i < kNumMemoryCategories; ++i) {
+    start_[i] = counters[i].current.load(std::memory_order_relaxed);
+    counters[i].loop_peak.store(start_[i], std::memory_order_relaxed);
+  }
+}
+
+void
+katana::internal::LoopMemoryStats::stop() {
+  if (!active_) {
+    return;
+  }
+  for (size_t i = 0; i < kNumMemoryCategories; ++i) {
+    int64_t rise =
+        counters[i].loop_peak.load(std::memory_order_relaxed) - start_[i];
+    if (rise > 0) {
+      ReportStatMax(
+          loopname_,
+          std::string(MemoryCategoryName(static_cast<MemoryCategory>(i))) +
+              "PeakBytes",
+          rise);
+    }
+  }
+  active_ = false;
+}
@@ -0,0 +1,111 @@
+#include "katana/MirrorSync.h"
+
+#include <arrow/array/concatenate.h>
+
+#include "katana/ArrowInterchange.h"
+
+namespace {
+
+/// The nodes of a list of local nodes of a partition, which must be in
+/// [begin, end)
+katana::Result<std::vector<katana::GraphTopology::Node>>
+ToNodes(
+    const std::shared_ptr<arrow::ChunkedArray>& list, uint64_t begin,
+    uint64_t end) {
+  std::vector<katana::GraphTopology::Node> nodes;
+  if (!list) {
+    return nodes;
+  }
+  if (list->type()->id() != arrow::Type::UINT32) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "expected a list of uint32 nodes: {}",
+        list->type()->ToString());
+  }
+  nodes.reserve(list->length());
+  for (const auto& chunk : list->chunks()) {
+    auto array = std::static_pointer_cast<arrow::UInt32Array>(chunk);
+    for (int64_t i = 0; i < array->length(); ++i) {
+      uint32_t n = array->Value(i);
+      if (n < begin || n >= end) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "node {} of the list is not in [{}, {})", n, begin, end);
+      }
+      nodes.emplace_back(n);
+    }
+  }
+  return nodes;
+}
+
+}  // namespace
+
+katana::Result<katana::MirrorSync>
+katana::MirrorSync::Make(const PropertyGraph& pg, CommBackend* comm) {
+  MirrorSync sync(comm, pg.num_nodes());
+
+  if (pg.master_nodes().empty() && pg.mirror_nodes().empty()) {
+    if (comm->Num != 1) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "the graph is not partitioned but there are {} hosts", comm->Num);
+    }
+    sync.num_masters_ = pg.num_nodes();
+    sync.num_global_nodes_ = pg.num_nodes();
+    return sync;
+  }
+
+  if (pg.master_nodes().size() != comm->Num ||
+      pg.mirror_nodes().size() != comm->Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "partition {} is of a graph of {} partitions, not {}",
+        pg.partition_id(), pg.master_nodes().size(), comm->Num);
+  }
+  const tsuba::PartitionMetadata& metadata = pg.partition_metadata();
+  sync.num_masters_ = metadata.num_owned_;
+  sync.num_global_nodes_ = metadata.num_global_nodes_;
+  if (sync.num_masters_ > sync.num_nodes_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "partition {} owns {} of its {} nodes",
+        pg.partition_id(), sync.num_masters_, sync.num_nodes_);
+  }
+
+  const std::shared_ptr<arrow::ChunkedArray>& ids = pg.local_to_global_id();
+  if (!ids || ids->type()->id() != arrow::Type::UINT64 ||
+      static_cast<uint64_t>(ids->length()) != pg.num_nodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "partition {} has no global IDs for its {} nodes", pg.partition_id(),
+        pg.num_nodes());
+  }
+  std::shared_ptr<arrow::Array> array;
+  if (ids->num_chunks() == 1) {
+    array = ids->chunk(0);
+  } else {
+    auto concat_res = ids->num_chunks() == 0
+                          ? arrow::MakeArrayOfNull(arrow::uint64(), 0)
+                          : arrow::Concatenate(ids->chunks());
+    if (!concat_res.ok()) {
+      return KATANA_ERROR(
+          ArrowToKatana(concat_res.status()), "combining global IDs: {}",
+          concat_res.status());
+    }
+    array = std::move(concat_res.ValueOrDie());
+  }
+  sync.global_ids_ = std::static_pointer_cast<arrow::UInt64Array>(array);
+
+  for (uint32_t h = 0; h < comm->Num; ++h) {
+    auto masters_res = ToNodes(pg.master_nodes()[h], 0, sync.num_masters_);
+    if (!masters_res) {
+      return masters_res.error().WithContext("masters mirrored on {}", h);
+    }
+    sync.masters_[h] = std::move(masters_res.value());
+    auto mirrors_res =
+        ToNodes(pg.mirror_nodes()[h], sync.num_masters_, sync.num_nodes_);
+    if (!mirrors_res) {
+      return mirrors_res.error().WithContext("mirrors of host {}", h);
+    }
+    sync.mirrors_[h] = std::move(mirrors_res.value());
+  }
+  return sync;
+}
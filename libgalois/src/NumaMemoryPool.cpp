@@ -0,0 +1,122 @@
+#include "katana/NumaMemoryPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "katana/MemoryAccounting.h"
+#include "katana/NumaMem.h"
+#include "katana/PageAlloc.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+uint64_t
+RoundUpToPage(uint64_t size) {
+  uint64_t page = katana::allocSize();
+  return (size + page - 1) / page * page;
+}
+
+}  // namespace
+
+katana::NumaMemoryPool*
+katana::NumaMemoryPool::Get(Policy policy) {
+  static std::array<NumaMemoryPool*, 4> pools = {
+      new NumaMemoryPool(Policy::kBlocked),
+      new NumaMemoryPool(Policy::kInterleaved),
+      new NumaMemoryPool(Policy::kLocal),
+      new NumaMemoryPool(Policy::kFloating),
+  };
+  return pools[static_cast<size_t>(policy)];
+}
+
+bool
+katana::NumaMemoryPool::IsLarge(int64_t size) const {
+  return static_cast<uint64_t>(size) >= katana::allocSize();
+}
+
+void
+katana::NumaMemoryPool::AddBytes(int64_t size) {
+  AccountMemory(MemoryCategory::kProperty, size);
+  int64_t allocated = bytes_allocated_ += size;
+  int64_t max = max_memory_;
+  while (allocated > max && !max_memory_.compare_exchange_weak(max, allocated))
+    ;
+}
+
+arrow::Status
+katana::NumaMemoryPool::Allocate(int64_t size, uint8_t** out) {
+  if (size < 0) {
+    return arrow::Status::Invalid("negative allocation size");
+  }
+  if (!IsLarge(size)) {
+    ARROW_RETURN_NOT_OK(small_pool_->Allocate(size, out));
+    AddBytes(size);
+    return arrow::Status::OK();
+  }
+
+  LAptr mem;
+  bool in_loop = ThreadPool::isInRun();
+  switch (policy_) {
+  case Policy::kBlocked:
+  case Policy::kInterleaved:
+    if (!in_loop) {
+      std::lock_guard<std::mutex> lock(page_in_mutex_);
+      mem = policy_ == Policy::kBlocked
+                ? largeMallocBlocked(size, getActiveThreads())
+                : largeMallocInterleaved(size, getActiveThreads());
+    } else {
+      mem = largeMallocFloating(size);
+    }
+    break;
+  case Policy::kLocal:
+    mem = largeMallocLocal(size);
+    break;
+  case Policy::kFloating:
+    mem = largeMallocFloating(size);
+    break;
+  }
+  if (!mem) {
+    return arrow::Status::OutOfMemory("allocating ", size, " bytes");
+  }
+
+  *out = static_cast<uint8_t*>(mem.release());
+  AddBytes(size);
+  return arrow::Status::OK();
+}
+
+arrow::Status
+katana::NumaMemoryPool::Reallocate(
+    int64_t old_size, int64_t new_size, uint8_t** ptr) {
+  if (!IsLarge(old_size) && !IsLarge(new_size)) {
+    ARROW_RETURN_NOT_OK(small_pool_->Reallocate(old_size, new_size, ptr));
+    AddBytes(new_size - old_size);
+    return arrow::Status::OK();
+  }
+  if (IsLarge(old_size) && IsLarge(new_size) &&
+      RoundUpToPage(old_size) == RoundUpToPage(new_size)) {
+    // Still fits in the pages it has
+    AddBytes(new_size - old_size);
+    return arrow::Status::OK();
+  }
+
+  uint8_t* next = nullptr;
+  ARROW_RETURN_NOT_OK(Allocate(new_size, &next));
+  std::memcpy(next, *ptr, std::min(old_size, new_size));
+  Free(*ptr, old_size);
+  *ptr = next;
+  return arrow::Status::OK();
+}
+
+void
+katana::NumaMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  if (!IsLarge(size)) {
+    small_pool_->Free(buffer, size);
+  } else {
+    // The freer of largeMalloc* frees the whole pages it allocated
+    LAptr mem{buffer, internal::largeFreer{RoundUpToPage(size)}};
+  }
+  AccountMemory(MemoryCategory::kProperty, -size);
+  bytes_allocated_ -= size;
+}
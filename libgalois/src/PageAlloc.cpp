@@ -101,6 +101,15 @@ katana::allocPages(unsigned num, bool preFault) {
   return ptr;
 }
 
+bool
+katana::releasePages(void* ptr, unsigned num) {
+  if (madvise(ptr, num * hugePageSize, MADV_DONTNEED) != 0) {
+    KATANA_WARN_ONCE("releasing pages failed: {}", errno);
+    return false;
+  }
+  return true;
+}
+
 void
 katana::freePages(void* ptr, unsigned num) {
   std::lock_guard<SimpleLock> lg(allocLock);
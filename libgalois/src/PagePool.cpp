@@ -19,47 +19,123 @@
 
 #include "katana/PagePool.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "katana/Env.h"
 #include "katana/Logging.h"
+#include "katana/MemoryAccounting.h"
+#include "katana/SharedMem.h"
 
 static katana::internal::PageAllocState<>* PA;
 
+namespace {
+
+/// Periodically releases the pages of a pool that have been idle for a
+/// while; see pagePoolReleaseIdle
+class IdleReleaser {
+public:
+  IdleReleaser(
+      katana::internal::PageAllocState<>* pa, std::chrono::milliseconds idle)
+      : thread_([this, pa, idle]() { Run(pa, idle); }) {}
+
+  ~IdleReleaser() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  IdleReleaser(const IdleReleaser&) = delete;
+  IdleReleaser& operator=(const IdleReleaser&) = delete;
+
+private:
+  void Run(
+      katana::internal::PageAllocState<>* pa, std::chrono::milliseconds idle) {
+    // Check twice per idle period so no page waits much more than that
+    auto period = std::max(idle / 2, std::chrono::milliseconds(1));
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, period, [this]() { return stop_; })) {
+      pa->releaseIdle(idle);
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+std::unique_ptr<IdleReleaser> releaser;
+
+/// The page pool, which is made with the thread pool on first use
+katana::internal::PageAllocState<>*
+PagePool() {
+  if (!PA) {
+    katana::internal::StartSharedMem();
+  }
+  return PA;
+}
+
+}  // namespace
+
 void
 katana::internal::setPagePoolState(PageAllocState<>* pa) {
   KATANA_LOG_VASSERT(!(PA && pa), "double Initialization of PageAllocState");
+  releaser.reset();
   PA = pa;
+
+  int idle_ms = 0;
+  if (pa && katana::GetEnv("KATANA_PAGE_POOL_IDLE_MS", &idle_ms) &&
+      idle_ms > 0) {
+    releaser = std::make_unique<IdleReleaser>(
+        pa, std::chrono::milliseconds(idle_ms));
+  }
+}
+
+size_t
+katana::pagePoolReleaseIdle(std::chrono::milliseconds idle) {
+  return PagePool()->releaseIdle(idle);
 }
 
 int
 katana::numPagePoolAllocTotal() {
-  return PA->countAll();
+  return PagePool()->countAll();
 }
 
 int
 katana::numPagePoolAllocForThread(unsigned tid) {
-  return PA->count(tid);
+  return PagePool()->count(tid);
 }
 
 void*
 katana::pagePoolAlloc() {
-  return PA->pageAlloc();
+  AccountMemory(MemoryCategory::kWorklist, allocSize());
+  return PagePool()->pageAlloc();
 }
 
 void
 katana::pagePoolPreAlloc(unsigned num) {
   while (num--) {
-    PA->pagePreAlloc();
+    PagePool()->pagePreAlloc();
   }
 }
 
 void
 katana::pagePoolEnsurePreallocated(unsigned num) {
   auto tid = katana::ThreadPool::getTID();
-  while (PA->freeCount(tid) < num) {
-    PA->pagePreAlloc();
+  while (PagePool()->freeCount(tid) < num) {
+    PagePool()->pagePreAlloc();
   }
 }
 
 void
 katana::pagePoolFree(void* ptr) {
-  PA->pageFree(ptr);
+  AccountMemory(MemoryCategory::kWorklist, -static_cast<int64_t>(allocSize()));
+  PagePool()->pageFree(ptr);
 }
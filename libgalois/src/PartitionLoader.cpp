@@ -0,0 +1,526 @@
+#include "katana/PartitionLoader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "tsuba/CSRTopology.h"
+#include "tsuba/RDGPrefix.h"
+#include "tsuba/RDGSlice.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using NodeRange = std::pair<uint64_t, uint64_t>;
+
+/// The policy_id of tsuba::PartitionMetadata of each kind of partition; see
+/// katana::analytics::PartitionLayoutPolicy
+constexpr uint32_t kOutgoingEdgeCutPolicyId = 1;
+constexpr uint32_t kCartesianVertexCutPolicyId = 4;
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateBuffer(uint64_t size) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} bytes: {}", size,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+/// A hash of block b of nodes (the finalizer of SplitMix64)
+uint64_t
+HashBlock(uint64_t b) {
+  b = (b ^ (b >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  b = (b ^ (b >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return b ^ (b >> 31);
+}
+
+/// The rows of the grid of num_hosts hosts of a Cartesian vertex cut: the
+/// largest divisor of num_hosts that is at most its square root, so that the
+/// grid is as square as it can be
+uint32_t
+GridRows(uint32_t num_hosts) {
+  uint32_t rows = 1;
+  for (uint32_t r = 2; uint64_t{r} * r <= num_hosts; ++r) {
+    if (num_hosts % r == 0) {
+      rows = r;
+    }
+  }
+  return rows;
+}
+
+/// The first node of each of num_hosts contiguous ranges of the nodes of
+/// prefix with about the same number of nodes plus edges, followed by the
+/// number of nodes
+std::vector<uint64_t>
+BalancedRanges(const tsuba::RDGPrefix& prefix, uint32_t num_hosts) {
+  uint64_t num_nodes = prefix.num_nodes();
+  uint64_t total = num_nodes + prefix.num_edges();
+  // The nodes plus edges before node n
+  auto cost = [&](uint64_t n) { return n == 0 ? 0 : n + prefix[n - 1]; };
+  std::vector<uint64_t> begins(num_hosts + 1, num_nodes);
+  begins[0] = 0;
+  for (uint32_t h = 1; h < num_hosts; ++h) {
+    // total * h / num_hosts without overflow
+    uint64_t target = total / num_hosts * h + total % num_hosts * h / num_hosts;
+    uint64_t lo = begins[h - 1];
+    uint64_t hi = num_nodes;
+    while (lo < hi) {
+      uint64_t mid = lo + (hi - lo) / 2;
+      if (cost(mid) < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    begins[h] = lo;
+  }
+  return begins;
+}
+
+/// Append the nodes [begin, end) to ranges, extending the last range instead
+/// if begin is less than gap past its end
+void
+AddRange(
+    std::vector<NodeRange>* ranges, uint64_t begin, uint64_t end,
+    uint64_t gap) {
+  if (!ranges->empty() && begin - ranges->back().second < gap) {
+    ranges->back().second = end;
+    return;
+  }
+  ranges->emplace_back(begin, end);
+}
+
+/// The host of each node, read from the uint32 node property name of the
+/// RDG of handle without its topology
+katana::Result<std::vector<uint32_t>>
+ReadOwners(
+    tsuba::RDGHandle handle, const std::string& name, uint64_t num_nodes,
+    uint32_t num_hosts) {
+  std::vector<std::string> node_props{name};
+  std::vector<std::string> edge_props;
+  auto slice_res = tsuba::RDGSlice::Make(
+      handle,
+      tsuba::RDGSlice::SliceArg{
+          .node_range = {0, num_nodes},
+          .edge_range = {0, 0},
+          .topo_off = 0,
+          .topo_size = sizeof(tsuba::CSRTopologyHeader),
+      },
+      &node_props, &edge_props);
+  if (!slice_res) {
+    return slice_res.error().WithContext("reading partition property {}", name);
+  }
+  std::shared_ptr<arrow::ChunkedArray> column =
+      slice_res.value().node_properties()->GetColumnByName(name);
+  if (!column || column->type()->id() != arrow::Type::UINT32) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "partition property {} is not a uint32 node property", name);
+  }
+  if (static_cast<uint64_t>(column->length()) != num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "partition property {} has {} values for {} nodes", name,
+        column->length(), num_nodes);
+  }
+
+  std::vector<uint32_t> owners;
+  owners.reserve(num_nodes);
+  for (const auto& chunk : column->chunks()) {
+    auto array = std::static_pointer_cast<arrow::UInt32Array>(chunk);
+    for (int64_t i = 0; i < array->length(); ++i) {
+      if (array->IsNull(i) || array->Value(i) >= num_hosts) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "node {} is not in one of the {} partitions", owners.size(),
+            num_hosts);
+      }
+      owners.emplace_back(array->Value(i));
+    }
+  }
+  return owners;
+}
+
+}  // namespace
+
+katana::Result<katana::PartitionLoader>
+katana::PartitionLoader::Read(
+    const std::string& rdg_name, uint32_t host, uint32_t num_hosts,
+    const PartitionLoadOptions& options) {
+  if (host >= num_hosts) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "host {} is not one of the {} hosts", host,
+        num_hosts);
+  }
+  if (options.block_nodes == 0) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "blocks must have nodes");
+  }
+
+  auto handle_res = tsuba::Open(rdg_name, tsuba::kReadOnly);
+  if (!handle_res) {
+    return handle_res.error();
+  }
+  // Closes the handle
+  tsuba::RDGFile file(handle_res.value());
+
+  auto prefix_res = tsuba::RDGPrefix::Make(file);
+  if (!prefix_res) {
+    return prefix_res.error().WithContext("reading topology of {}", rdg_name);
+  }
+  tsuba::RDGPrefix prefix = std::move(prefix_res.value());
+  if (!prefix.has_topology()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} has no topology", rdg_name);
+  }
+  if (prefix.version() != 1) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "cannot partition topology version {} of {}", prefix.version(),
+        rdg_name);
+  }
+  uint64_t num_nodes = prefix.num_nodes();
+  auto edge_begin = [&](uint64_t n) { return n == 0 ? 0 : prefix[n - 1]; };
+
+  const PartitionLoadOptions::Policy policy = options.policy;
+  uint64_t block_nodes = options.block_nodes;
+  // The host of each node, for kPartitionProperty
+  std::vector<uint32_t> owners;
+  // The first node of each host, for kCartesianVertexCut
+  std::vector<uint64_t> begins;
+  uint32_t grid_rows = 1;
+  uint32_t grid_cols = num_hosts;
+  switch (policy) {
+  case PartitionLoadOptions::kHashEdgeCut:
+    break;
+  case PartitionLoadOptions::kCartesianVertexCut:
+    begins = BalancedRanges(prefix, num_hosts);
+    grid_rows = GridRows(num_hosts);
+    grid_cols = num_hosts / grid_rows;
+    break;
+  case PartitionLoadOptions::kPartitionProperty: {
+    auto owners_res =
+        ReadOwners(file, options.partition_property, num_nodes, num_hosts);
+    if (!owners_res) {
+      return owners_res.error();
+    }
+    owners = std::move(owners_res.value());
+    break;
+  }
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unknown partition policy {}",
+        static_cast<int>(policy));
+  }
+
+  auto owner = [&](uint64_t n) -> uint32_t {
+    switch (policy) {
+    case PartitionLoadOptions::kHashEdgeCut:
+      return HashBlock(n / block_nodes) % num_hosts;
+    case PartitionLoadOptions::kCartesianVertexCut:
+      return std::upper_bound(begins.begin(), begins.end(), n) -
+             begins.begin() - 1;
+    default:
+      return owners[n];
+    }
+  };
+  // The host of an edge to dst from a node of host src_owner
+  auto edge_host = [&](uint32_t src_owner, uint64_t dst) -> uint32_t {
+    if (policy != PartitionLoadOptions::kCartesianVertexCut) {
+      return src_owner;
+    }
+    return src_owner / grid_cols * grid_cols + owner(dst) % grid_cols;
+  };
+
+  // The nodes whose edges this host reads: its own for the edge cuts,
+  // those of its row of the grid for the vertex cut
+  std::vector<NodeRange> ranges;
+  switch (policy) {
+  case PartitionLoadOptions::kHashEdgeCut:
+    for (uint64_t b = 0; b * block_nodes < num_nodes; ++b) {
+      if (HashBlock(b) % num_hosts == host) {
+        AddRange(
+            &ranges, b * block_nodes,
+            std::min(num_nodes, (b + 1) * block_nodes), 1);
+      }
+    }
+    break;
+  case PartitionLoadOptions::kCartesianVertexCut: {
+    uint32_t row_begin = host / grid_cols * grid_cols;
+    if (begins[row_begin] < begins[row_begin + grid_cols]) {
+      ranges.emplace_back(begins[row_begin], begins[row_begin + grid_cols]);
+    }
+    break;
+  }
+  default:
+    for (uint64_t n = 0; n < num_nodes; ++n) {
+      if (owners[n] == host) {
+        AddRange(&ranges, n, n + 1, block_nodes);
+      }
+    }
+  }
+
+  // Fetch the destinations of all ranges at once and then wait for them
+  for (bool resolve : {false, true}) {
+    for (const auto& [begin, end] : ranges) {
+      if (auto res =
+              prefix.FillDests(edge_begin(begin), prefix[end - 1], resolve);
+          !res) {
+        return res.error().WithContext("reading edges of {}", rdg_name);
+      }
+    }
+  }
+  const uint32_t* dests = prefix.out_dests();
+
+  PartitionLoader loader(host, num_hosts);
+  std::vector<Node> sources;
+  for (const auto& [begin, end] : ranges) {
+    for (uint64_t n = begin; n < end; ++n) {
+      sources.emplace_back(n);
+      if (owner(n) == host) {
+        loader.masters_.emplace_back(n);
+      }
+    }
+  }
+
+  // Count the local edges of each source and mark the mirrors
+  std::vector<uint64_t> degrees(sources.size());
+  katana::DynamicBitset is_mirror;
+  is_mirror.resize(num_nodes);
+  std::atomic<bool> bad_dests{false};
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{sources.size()}),
+      [&](uint64_t i) {
+        Node src = sources[i];
+        uint32_t src_owner = owner(src);
+        uint64_t kept = 0;
+        for (uint64_t e = edge_begin(src); e < prefix[src]; ++e) {
+          Node dst = dests[e];
+          if (dst >= num_nodes) {
+            bad_dests = true;
+            return;
+          }
+          if (edge_host(src_owner, dst) != host) {
+            continue;
+          }
+          ++kept;
+          if (owner(dst) != host) {
+            is_mirror.set(dst);
+          }
+        }
+        if (kept > 0 && src_owner != host) {
+          is_mirror.set(src);
+        }
+        degrees[i] = kept;
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("PartitionLoader::CountEdges"));
+  if (bad_dests) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "edges of {} reach past its {} nodes",
+        rdg_name, num_nodes);
+  }
+
+  std::vector<uint64_t> mirrors = is_mirror.GetOffsets<uint64_t>();
+  uint64_t num_masters = loader.masters_.size();
+  uint64_t num_local = num_masters + mirrors.size();
+  if (num_local >= std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "{} local nodes do not fit 32-bit node IDs",
+        num_local);
+  }
+  // Local mirror ids follow the order of their nodes, which interleaves the
+  // mirrors of different hosts
+  loader.local_to_global_ = loader.masters_;
+  for (uint64_t m : mirrors) {
+    uint32_t h = owner(m);
+    loader.mirrors_[h].emplace_back(m);
+    loader.mirror_nodes_[h].emplace_back(loader.local_to_global_.size());
+    loader.local_to_global_.emplace_back(m);
+  }
+  auto local_of = [&](uint64_t n) -> Node {
+    const std::vector<uint64_t>& masters = loader.masters_;
+    if (owner(n) == host) {
+      return std::lower_bound(masters.begin(), masters.end(), n) -
+             masters.begin();
+    }
+    return num_masters +
+           (std::lower_bound(mirrors.begin(), mirrors.end(), n) -
+            mirrors.begin());
+  };
+
+  // The local CSR, whose sources are masters and, in the vertex cut, also
+  // mirrors
+  auto indices_res = AllocateBuffer(num_local * sizeof(uint64_t));
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buf = std::move(indices_res.value());
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buf->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_local),
+      [&](uint64_t n) { indices[n] = 0; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{sources.size()}),
+      [&](uint64_t i) {
+        if (degrees[i] > 0) {
+          indices[local_of(sources[i])] = degrees[i];
+        }
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(indices, indices + num_local, indices);
+  uint64_t num_local_edges = num_local == 0 ? 0 : indices[num_local - 1];
+
+  auto dests_res = AllocateBuffer(num_local_edges * sizeof(uint32_t));
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buf = std::move(dests_res.value());
+  auto* local_dests = reinterpret_cast<uint32_t*>(dests_buf->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{sources.size()}),
+      [&](uint64_t i) {
+        if (degrees[i] == 0) {
+          return;
+        }
+        Node src = sources[i];
+        uint32_t src_owner = owner(src);
+        Node local = local_of(src);
+        uint64_t out = local == 0 ? 0 : indices[local - 1];
+        for (uint64_t e = edge_begin(src); e < prefix[src]; ++e) {
+          if (edge_host(src_owner, dests[e]) == host) {
+            local_dests[out++] = local_of(dests[e]);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("PartitionLoader::CopyEdges"));
+  loader.topology_ = GraphTopology{
+      .out_indices =
+          std::make_shared<arrow::UInt64Array>(num_local, indices_buf),
+      .out_dests =
+          std::make_shared<arrow::UInt32Array>(num_local_edges, dests_buf),
+  };
+
+  tsuba::PartitionMetadata& metadata = loader.metadata_;
+  if (policy == PartitionLoadOptions::kCartesianVertexCut) {
+    metadata.policy_id_ = kCartesianVertexCutPolicyId;
+    metadata.cartesian_grid_ = {grid_rows, grid_cols};
+  } else {
+    metadata.policy_id_ = kOutgoingEdgeCutPolicyId;
+    metadata.is_outgoing_edge_cut_ = true;
+  }
+  metadata.num_global_nodes_ = num_nodes;
+  metadata.max_global_node_id_ = num_nodes > 0 ? num_nodes - 1 : 0;
+  metadata.num_global_edges_ = prefix.num_edges();
+  metadata.num_edges_ = num_local_edges;
+  metadata.num_nodes_ = num_local;
+  metadata.num_owned_ = num_masters;
+  return loader;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PartitionLoader::Finish(
+    const std::vector<std::vector<uint64_t>>& mirrored) {
+  if (!topology_.out_indices) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "partition {} is finished already", host_);
+  }
+  if (mirrored.size() != num_hosts_ || !mirrored[host_].empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "expected the mirrors of each of {} other hosts, found {} lists",
+        num_hosts_ - 1, mirrored.size());
+  }
+
+  // The masters mirrored by each host, in the order of its mirrors
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> master_nodes;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> mirror_nodes;
+  for (uint32_t h = 0; h < num_hosts_; ++h) {
+    std::vector<uint32_t> masters;
+    for (uint64_t n : mirrored[h]) {
+      auto it = std::lower_bound(masters_.begin(), masters_.end(), n);
+      if (it == masters_.end() || *it != n) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "host {} mirrors node {}, which is not a master of host {}", h, n,
+            host_);
+      }
+      masters.emplace_back(it - masters_.begin());
+    }
+    master_nodes.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        arrow::ArrayVector{katana::BuildArray(masters)}));
+    mirror_nodes.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        arrow::ArrayVector{katana::BuildArray(mirror_nodes_[h])}));
+  }
+
+  auto pg = std::make_unique<PropertyGraph>();
+  if (auto res = pg->SetTopology(topology_); !res) {
+    return res.error();
+  }
+  topology_ = GraphTopology{};
+  pg->set_local_to_global_id(std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{katana::BuildArray(local_to_global_)}));
+  pg->set_partition_metadata(metadata_);
+  pg->set_master_nodes(std::move(master_nodes));
+  pg->set_mirror_nodes(std::move(mirror_nodes));
+  return std::unique_ptr<PropertyGraph>(std::move(pg));
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::LoadPartition(
+    const std::string& rdg_name, CommBackend* comm,
+    const PartitionLoadOptions& options) {
+  auto loader_res =
+      PartitionLoader::Read(rdg_name, comm->ID, comm->Num, options);
+
+  // Every host must reach the exchange below, or none
+  auto failed_res = comm->AllReduce(
+      static_cast<uint32_t>(loader_res ? 0 : 1), CommReduceOp::kSum);
+  if (!failed_res) {
+    return failed_res.error();
+  }
+  if (!loader_res) {
+    return loader_res.error();
+  }
+  if (failed_res.value() > 0) {
+    return KATANA_ERROR(
+        ErrorCode::CommError, "{} hosts failed to read their partitions",
+        failed_res.value());
+  }
+  PartitionLoader loader = std::move(loader_res.value());
+
+  std::vector<std::shared_ptr<arrow::Buffer>> send;
+  for (const std::vector<uint64_t>& mirrors : loader.mirrors()) {
+    send.emplace_back(arrow::Buffer::Wrap(mirrors));
+  }
+  auto recv_res = comm->AllToAllV(send);
+  if (!recv_res) {
+    return recv_res.error().WithContext("exchanging mirrors");
+  }
+  std::vector<std::vector<uint64_t>> mirrored(comm->Num);
+  for (uint32_t h = 0; h < comm->Num; ++h) {
+    const std::shared_ptr<arrow::Buffer>& buf = recv_res.value()[h];
+    if (!buf || buf->size() % sizeof(uint64_t) != 0) {
+      return KATANA_ERROR(
+          ErrorCode::CommError, "malformed list of mirrors from host {}", h);
+    }
+    mirrored[h].resize(buf->size() / sizeof(uint64_t));
+    if (!mirrored[h].empty()) {
+      std::memcpy(mirrored[h].data(), buf->data(), buf->size());
+    }
+  }
+  return loader.Finish(mirrored);
+}
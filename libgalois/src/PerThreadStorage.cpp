@@ -203,3 +203,9 @@ katana::initPTS(unsigned maxT) {
     pssBase = getPPSBackend().initPerSocket(maxT);
   }
 }
+
+void
+katana::adoptPTS(unsigned tid) {
+  ptsBase = static_cast<char*>(getPTSBackend().getRemote(tid, 0));
+  pssBase = static_cast<char*>(getPPSBackend().getRemote(tid, 0));
+}
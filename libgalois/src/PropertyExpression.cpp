@@ -0,0 +1,922 @@
+#include "katana/PropertyExpression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+
+using Op = katana::PropertyExpression::Op;
+using Node = katana::GraphTopology::Node;
+
+struct katana::PropertyExpression::Term {
+  Op op;
+  std::string name;
+  double value;
+  std::vector<PropertyExpression> args;
+};
+
+namespace {
+
+/// The number of rows evaluated at once by a thread. The values of a block
+/// at every step of the program fit in cache, and since it is a multiple of
+/// 8 each block writes whole bytes of the validity bitmap.
+constexpr uint64_t kBlockSize = 1024;
+
+struct FunctionInfo {
+  const char* name;
+  Op op;
+  size_t arity;
+};
+
+constexpr FunctionInfo kFunctions[] = {
+    {"log", Op::kLog, 1},   {"exp", Op::kExp, 1}, {"sqrt", Op::kSqrt, 1},
+    {"abs", Op::kAbs, 1},   {"pow", Op::kPow, 2}, {"min", Op::kMin, 2},
+    {"max", Op::kMax, 2},   {"degree", Op::kOutDegree, 0},
+};
+
+const FunctionInfo*
+FindFunction(Op op) {
+  for (const FunctionInfo& f : kFunctions) {
+    if (f.op == op) {
+      return &f;
+    }
+  }
+  return nullptr;
+}
+
+const FunctionInfo*
+FindFunction(const std::string& name) {
+  for (const FunctionInfo& f : kFunctions) {
+    if (name == f.name) {
+      return &f;
+    }
+  }
+  return nullptr;
+}
+
+size_t
+Arity(Op op) {
+  switch (op) {
+  case Op::kProperty:
+  case Op::kConstant:
+  case Op::kOutDegree:
+    return 0;
+  case Op::kNegate:
+    return 1;
+  case Op::kAdd:
+  case Op::kSubtract:
+  case Op::kMultiply:
+  case Op::kDivide:
+    return 2;
+  default:
+    return FindFunction(op)->arity;
+  }
+}
+
+template <Op op>
+inline double
+Apply(double a, double b) {
+  if constexpr (op == Op::kAdd) {
+    return a + b;
+  } else if constexpr (op == Op::kSubtract) {
+    return a - b;
+  } else if constexpr (op == Op::kMultiply) {
+    return a * b;
+  } else if constexpr (op == Op::kDivide) {
+    return a / b;
+  } else if constexpr (op == Op::kNegate) {
+    return -a;
+  } else if constexpr (op == Op::kLog) {
+    return std::log(a);
+  } else if constexpr (op == Op::kExp) {
+    return std::exp(a);
+  } else if constexpr (op == Op::kSqrt) {
+    return std::sqrt(a);
+  } else if constexpr (op == Op::kAbs) {
+    return std::fabs(a);
+  } else if constexpr (op == Op::kPow) {
+    return std::pow(a, b);
+  } else if constexpr (op == Op::kMin) {
+    return std::fmin(a, b);
+  } else {
+    static_assert(op == Op::kMax);
+    return std::fmax(a, b);
+  }
+}
+
+/// Apply the binary op to the values of a and b and store the result in a
+template <Op op>
+void
+Kernel(double* a, const double* b, uint64_t count) {
+  for (uint64_t i = 0; i < count; ++i) {
+    a[i] = Apply<op>(a[i], b[i]);
+  }
+}
+
+/// Apply the unary op to the values of a in place
+template <Op op>
+void
+Kernel(double* a, uint64_t count) {
+  for (uint64_t i = 0; i < count; ++i) {
+    a[i] = Apply<op>(a[i], 0);
+  }
+}
+
+template <typename Fn>
+auto
+Dispatch(Op op, Fn fn) {
+  switch (op) {
+  case Op::kAdd:
+    return fn(std::integral_constant<Op, Op::kAdd>{});
+  case Op::kSubtract:
+    return fn(std::integral_constant<Op, Op::kSubtract>{});
+  case Op::kMultiply:
+    return fn(std::integral_constant<Op, Op::kMultiply>{});
+  case Op::kDivide:
+    return fn(std::integral_constant<Op, Op::kDivide>{});
+  case Op::kNegate:
+    return fn(std::integral_constant<Op, Op::kNegate>{});
+  case Op::kLog:
+    return fn(std::integral_constant<Op, Op::kLog>{});
+  case Op::kExp:
+    return fn(std::integral_constant<Op, Op::kExp>{});
+  case Op::kSqrt:
+    return fn(std::integral_constant<Op, Op::kSqrt>{});
+  case Op::kAbs:
+    return fn(std::integral_constant<Op, Op::kAbs>{});
+  case Op::kPow:
+    return fn(std::integral_constant<Op, Op::kPow>{});
+  case Op::kMin:
+    return fn(std::integral_constant<Op, Op::kMin>{});
+  case Op::kMax:
+    return fn(std::integral_constant<Op, Op::kMax>{});
+  default:
+    KATANA_LOG_FATAL("not an elementwise op: {}", static_cast<int>(op));
+  }
+}
+
+class Parser {
+public:
+  explicit Parser(const std::string& text) : text_(text) {}
+
+  katana::Result<katana::PropertyExpression> Parse() {
+    auto res = ParseSum();
+    if (!res) {
+      return res.error();
+    }
+    SkipSpace();
+    if (pos_ != text_.size()) {
+      return Error("unexpected character");
+    }
+    return res;
+  }
+
+private:
+  katana::Result<katana::PropertyExpression> ParseSum() {
+    auto res = ParseProduct();
+    while (res) {
+      SkipSpace();
+      if (!Accept('+') && !Accept('-')) {
+        break;
+      }
+      char c = text_[pos_ - 1];
+      auto rhs = ParseProduct();
+      if (!rhs) {
+        return rhs.error();
+      }
+      res = c == '+' ? res.value() + rhs.value() : res.value() - rhs.value();
+    }
+    return res;
+  }
+
+  katana::Result<katana::PropertyExpression> ParseProduct() {
+    auto res = ParseUnary();
+    while (res) {
+      SkipSpace();
+      if (!Accept('*') && !Accept('/')) {
+        break;
+      }
+      char c = text_[pos_ - 1];
+      auto rhs = ParseUnary();
+      if (!rhs) {
+        return rhs.error();
+      }
+      res = c == '*' ? res.value() * rhs.value() : res.value() / rhs.value();
+    }
+    return res;
+  }
+
+  katana::Result<katana::PropertyExpression> ParseUnary() {
+    SkipSpace();
+    if (Accept('-')) {
+      auto res = ParseUnary();
+      if (!res) {
+        return res.error();
+      }
+      return -res.value();
+    }
+    return ParsePrimary();
+  }
+
+  katana::Result<katana::PropertyExpression> ParsePrimary() {
+    SkipSpace();
+    if (pos_ == text_.size()) {
+      return Error("unexpected end of expression");
+    }
+    char c = text_[pos_];
+    if (Accept('(')) {
+      auto res = ParseSum();
+      if (!res) {
+        return res.error();
+      }
+      SkipSpace();
+      if (!Accept(')')) {
+        return Error("expected )");
+      }
+      return res;
+    }
+    if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+      const char* begin = text_.c_str() + pos_;
+      char* end = nullptr;
+      double value = std::strtod(begin, &end);
+      if (end == begin) {
+        return Error("malformed number");
+      }
+      pos_ += end - begin;
+      return katana::PropertyExpression::Constant(value);
+    }
+    if (Accept('`')) {
+      size_t close = text_.find('`', pos_);
+      if (close == std::string::npos) {
+        return Error("unterminated quoted property name");
+      }
+      std::string name = text_.substr(pos_, close - pos_);
+      pos_ = close + 1;
+      return katana::PropertyExpression::Property(std::move(name));
+    }
+    if (!IsIdentifierStart(c)) {
+      return Error("unexpected character");
+    }
+    size_t begin = pos_;
+    while (pos_ < text_.size() && IsIdentifierPart(text_[pos_])) {
+      ++pos_;
+    }
+    std::string name = text_.substr(begin, pos_ - begin);
+    SkipSpace();
+    if (!Accept('(')) {
+      return katana::PropertyExpression::Property(std::move(name));
+    }
+
+    const FunctionInfo* function = FindFunction(name);
+    if (!function) {
+      pos_ = begin;
+      return Error("unknown function");
+    }
+    std::vector<katana::PropertyExpression> args;
+    SkipSpace();
+    if (!Accept(')')) {
+      do {
+        auto res = ParseSum();
+        if (!res) {
+          return res.error();
+        }
+        args.emplace_back(std::move(res.value()));
+        SkipSpace();
+      } while (Accept(','));
+      if (!Accept(')')) {
+        return Error("expected , or )");
+      }
+    }
+    return katana::PropertyExpression::Call(function->op, std::move(args));
+  }
+
+  static bool IsIdentifierStart(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+  }
+
+  static bool IsIdentifierPart(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' ||
+           c == '.';
+  }
+
+  void SkipSpace() {
+    while (pos_ < text_.size() &&
+           std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+      ++pos_;
+    }
+  }
+
+  bool Accept(char c) {
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  katana::ErrorInfo Error(const char* what) const {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} at offset {} of {}", what,
+        pos_, text_);
+  }
+
+  const std::string& text_;
+  size_t pos_{0};
+};
+
+/// The binding strength of an expression when printed; operands that bind
+/// less strongly than their operator are parenthesized
+int
+Precedence(const katana::PropertyExpression& e) {
+  switch (e.op()) {
+  case Op::kAdd:
+  case Op::kSubtract:
+    return 1;
+  case Op::kMultiply:
+  case Op::kDivide:
+    return 2;
+  case Op::kNegate:
+    return 3;
+  case Op::kConstant:
+    return e.value() < 0 ? 3 : 4;
+  default:
+    return 4;
+  }
+}
+
+/// An input of a compiled program: a property, read across its chunks
+struct Input {
+  std::shared_ptr<arrow::ChunkedArray> property;
+  /// The first row of each chunk and, last, the number of rows
+  std::vector<int64_t> chunk_starts;
+};
+
+struct Instruction {
+  Op op;
+  /// The constant of Op::kConstant
+  double value;
+  /// The index of the input of Op::kProperty
+  size_t input;
+};
+
+/// An expression compiled into a postfix sequence of instructions, each of
+/// which pushes its result after popping its operands
+struct Program {
+  std::vector<Instruction> instructions;
+  std::vector<Input> inputs;
+  /// The number of values on the stack at its deepest
+  size_t depth{0};
+  /// Whether any input has nulls
+  bool nullable{false};
+};
+
+bool
+IsNumeric(const arrow::DataType& type) {
+  return arrow::is_integer(type.id()) || arrow::is_floating(type.id()) ||
+         type.id() == arrow::Type::BOOL;
+}
+
+/// \returns e with every op whose operands are constants replaced by its
+/// value
+katana::PropertyExpression
+Fold(const katana::PropertyExpression& e) {
+  if (e.args().empty()) {
+    return e;
+  }
+  std::vector<katana::PropertyExpression> args;
+  bool constant = true;
+  for (const auto& arg : e.args()) {
+    args.emplace_back(Fold(arg));
+    constant &= args.back().op() == Op::kConstant;
+  }
+  if (constant) {
+    double a = args[0].value();
+    double b = args.size() > 1 ? args[1].value() : 0;
+    return katana::PropertyExpression::Constant(
+        Dispatch(e.op(), [&](auto op) { return Apply<op.value>(a, b); }));
+  }
+  switch (e.op()) {
+  case Op::kAdd:
+    return args[0] + args[1];
+  case Op::kSubtract:
+    return args[0] - args[1];
+  case Op::kMultiply:
+    return args[0] * args[1];
+  case Op::kDivide:
+    return args[0] / args[1];
+  case Op::kNegate:
+    return -args[0];
+  default:
+    return katana::PropertyExpression::Call(e.op(), std::move(args)).value();
+  }
+}
+
+katana::Result<void>
+CompileTerm(
+    const katana::PropertyExpression& e, bool nodes,
+    const katana::PropertyGraph& pg,
+    std::unordered_map<std::string, size_t>* input_indexes, Program* program,
+    size_t* stack_size) {
+  for (const auto& arg : e.args()) {
+    if (auto res = CompileTerm(
+            arg, nodes, pg, input_indexes, program, stack_size);
+        !res) {
+      return res.error();
+    }
+  }
+
+  Instruction instruction{e.op(), 0, 0};
+  switch (e.op()) {
+  case Op::kConstant:
+    instruction.value = e.value();
+    break;
+  case Op::kOutDegree:
+    if (!nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "degree() is not defined for edges");
+    }
+    break;
+  case Op::kProperty: {
+    auto [it, inserted] =
+        input_indexes->emplace(e.name(), program->inputs.size());
+    instruction.input = it->second;
+    if (!inserted) {
+      break;
+    }
+    auto property =
+        nodes ? pg.GetNodeProperty(e.name()) : pg.GetEdgeProperty(e.name());
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no {} property {}",
+          nodes ? "node" : "edge", e.name());
+    }
+    if (!IsNumeric(*property->type())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "property {} is {}, not numeric",
+          e.name(), property->type()->ToString());
+    }
+    Input input{property, {0}};
+    for (const auto& chunk : property->chunks()) {
+      input.chunk_starts.emplace_back(
+          input.chunk_starts.back() + chunk->length());
+    }
+    program->nullable |= property->null_count() > 0;
+    program->inputs.emplace_back(std::move(input));
+    break;
+  }
+  default:
+    break;
+  }
+  program->instructions.emplace_back(instruction);
+  *stack_size = *stack_size - e.args().size() + 1;
+  program->depth = std::max(program->depth, *stack_size);
+  return katana::ResultSuccess();
+}
+
+katana::Result<Program>
+Compile(
+    const katana::PropertyExpression& expression, bool nodes,
+    const katana::PropertyGraph& pg) {
+  Program program;
+  std::unordered_map<std::string, size_t> input_indexes;
+  size_t stack_size = 0;
+  if (auto res = CompileTerm(
+          Fold(expression), nodes, pg, &input_indexes, &program, &stack_size);
+      !res) {
+    return res.error();
+  }
+  KATANA_LOG_DEBUG_ASSERT(stack_size == 1);
+  return program;
+}
+
+template <typename ArrayType>
+void
+ConvertValues(
+    const arrow::Array& chunk, int64_t offset, uint64_t count, double* out) {
+  const auto& array = static_cast<const ArrayType&>(chunk);
+  for (uint64_t i = 0; i < count; ++i) {
+    out[i] = static_cast<double>(array.Value(offset + i));
+  }
+}
+
+/// Store count values of chunk, starting at offset, as doubles in out
+void
+LoadValues(
+    const arrow::Array& chunk, int64_t offset, uint64_t count, double* out) {
+  switch (chunk.type_id()) {
+  case arrow::Type::BOOL:
+    return ConvertValues<arrow::BooleanArray>(chunk, offset, count, out);
+  case arrow::Type::INT8:
+    return ConvertValues<arrow::Int8Array>(chunk, offset, count, out);
+  case arrow::Type::UINT8:
+    return ConvertValues<arrow::UInt8Array>(chunk, offset, count, out);
+  case arrow::Type::INT16:
+    return ConvertValues<arrow::Int16Array>(chunk, offset, count, out);
+  case arrow::Type::UINT16:
+    return ConvertValues<arrow::UInt16Array>(chunk, offset, count, out);
+  case arrow::Type::INT32:
+    return ConvertValues<arrow::Int32Array>(chunk, offset, count, out);
+  case arrow::Type::UINT32:
+    return ConvertValues<arrow::UInt32Array>(chunk, offset, count, out);
+  case arrow::Type::INT64:
+    return ConvertValues<arrow::Int64Array>(chunk, offset, count, out);
+  case arrow::Type::UINT64:
+    return ConvertValues<arrow::UInt64Array>(chunk, offset, count, out);
+  case arrow::Type::HALF_FLOAT: {
+    // Half floats are stored as their bits; convert them by hand
+    const auto& array = static_cast<const arrow::HalfFloatArray&>(chunk);
+    for (uint64_t i = 0; i < count; ++i) {
+      uint16_t bits = array.Value(offset + i);
+      int exponent = (bits >> 10) & 0x1f;
+      double mantissa = bits & 0x3ff;
+      double magnitude =
+          exponent == 0
+              ? std::ldexp(mantissa, -24)
+              : exponent == 0x1f
+                    ? (mantissa == 0 ? HUGE_VAL : NAN)
+                    : std::ldexp(mantissa + 1024, exponent - 25);
+      out[i] = bits & 0x8000 ? -magnitude : magnitude;
+    }
+    return;
+  }
+  case arrow::Type::FLOAT:
+    return ConvertValues<arrow::FloatArray>(chunk, offset, count, out);
+  case arrow::Type::DOUBLE:
+    std::memcpy(
+        out,
+        static_cast<const arrow::DoubleArray&>(chunk).raw_values() + offset,
+        count * sizeof(double));
+    return;
+  default:
+    KATANA_LOG_FATAL("unexpected type {}", chunk.type()->ToString());
+  }
+}
+
+/// Call fn(chunk, offset, count, first) for the runs of rows [begin, end)
+/// of input that lie in one chunk, where first is the index of the first
+/// row of the run relative to begin
+template <typename Fn>
+void
+ForEachRun(const Input& input, int64_t begin, int64_t end, Fn fn) {
+  auto it = std::upper_bound(
+      input.chunk_starts.begin(), input.chunk_starts.end(), begin);
+  size_t c = it - input.chunk_starts.begin() - 1;
+  for (int64_t row = begin; row < end; ++c) {
+    int64_t chunk_end = std::min(end, input.chunk_starts[c + 1]);
+    if (chunk_end == row) {
+      // Empty chunk
+      continue;
+    }
+    fn(*input.property->chunk(c), row - input.chunk_starts[c],
+       chunk_end - row, row - begin);
+    row = chunk_end;
+  }
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateBuffer(uint64_t size) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} bytes: {}", size,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+katana::Result<std::shared_ptr<arrow::DoubleArray>>
+Evaluate(
+    const katana::PropertyGraph& pg,
+    const katana::PropertyExpression& expression, bool nodes) {
+  auto program_res = Compile(expression, nodes, pg);
+  if (!program_res) {
+    return program_res.error();
+  }
+  const Program& program = program_res.value();
+  const katana::GraphTopology& topology = pg.topology();
+  uint64_t num_rows = nodes ? pg.num_nodes() : pg.num_edges();
+
+  auto values_res = AllocateBuffer(num_rows * sizeof(double));
+  if (!values_res) {
+    return values_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> values = std::move(values_res.value());
+  std::shared_ptr<arrow::Buffer> validity;
+  if (program.nullable) {
+    auto validity_res = AllocateBuffer((num_rows + 7) / 8);
+    if (!validity_res) {
+      return validity_res.error();
+    }
+    validity = std::move(validity_res.value());
+  }
+  auto* out = reinterpret_cast<double*>(values->mutable_data());
+
+  // The bottom of the stack of a block is its part of the output, which
+  // holds the result once the program is done; the rest of the stack is
+  // scratch space of the thread
+  katana::PerThreadStorage<std::vector<double>> scratch;
+  katana::GAccumulator<int64_t> null_count;
+  uint64_t num_blocks = (num_rows + kBlockSize - 1) / kBlockSize;
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        int64_t begin = block * kBlockSize;
+        int64_t end = std::min(num_rows, begin + kBlockSize);
+        uint64_t count = end - begin;
+
+        std::vector<double>& stack_space = *scratch.getLocal();
+        stack_space.resize((program.depth - 1) * kBlockSize);
+        auto slot = [&](size_t s) {
+          return s == 0 ? out + begin
+                        : stack_space.data() + (s - 1) * kBlockSize;
+        };
+
+        size_t top = 0;
+        for (const Instruction& instruction : program.instructions) {
+          switch (instruction.op) {
+          case Op::kConstant:
+            std::fill_n(slot(top++), count, instruction.value);
+            break;
+          case Op::kOutDegree: {
+            double* dst = slot(top++);
+            for (uint64_t i = 0; i < count; ++i) {
+              dst[i] = topology.edges(Node(begin + i)).size();
+            }
+            break;
+          }
+          case Op::kProperty: {
+            double* dst = slot(top++);
+            ForEachRun(
+                program.inputs[instruction.input], begin, end,
+                [&](const arrow::Array& chunk, int64_t offset, uint64_t n,
+                    uint64_t first) {
+                  LoadValues(chunk, offset, n, dst + first);
+                });
+            break;
+          }
+          default:
+            if (Arity(instruction.op) == 2) {
+              --top;
+              Dispatch(instruction.op, [&](auto op) {
+                Kernel<op.value>(slot(top - 1), slot(top), count);
+              });
+            } else {
+              Dispatch(instruction.op, [&](auto op) {
+                Kernel<op.value>(slot(top - 1), count);
+              });
+            }
+          }
+        }
+
+        if (!validity) {
+          return;
+        }
+        uint8_t* bits = validity->mutable_data() + begin / 8;
+        std::fill_n(bits, (count + 7) / 8, 0xff);
+        for (const Input& input : program.inputs) {
+          if (input.property->null_count() == 0) {
+            continue;
+          }
+          ForEachRun(
+              input, begin, end,
+              [&](const arrow::Array& chunk, int64_t offset, uint64_t n,
+                  uint64_t first) {
+                if (chunk.null_count() == 0) {
+                  return;
+                }
+                for (uint64_t i = 0; i < n; ++i) {
+                  if (chunk.IsNull(offset + i)) {
+                    bits[(first + i) / 8] &= ~(1 << ((first + i) % 8));
+                  }
+                }
+              });
+        }
+        int64_t valid = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+          valid += (bits[i / 8] >> (i % 8)) & 1;
+        }
+        null_count += count - valid;
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("EvaluatePropertyExpression"));
+
+  return std::make_shared<arrow::DoubleArray>(
+      num_rows, values, validity, validity ? null_count.reduce() : 0);
+}
+
+}  // namespace
+
+katana::PropertyExpression
+katana::PropertyExpression::Make(
+    Op op, std::vector<PropertyExpression> args, std::string name,
+    double value) {
+  return PropertyExpression{std::make_shared<const Term>(
+      Term{op, std::move(name), value, std::move(args)})};
+}
+
+katana::PropertyExpression
+katana::PropertyExpression::Property(std::string name) {
+  return Make(Op::kProperty, {}, std::move(name));
+}
+
+katana::PropertyExpression
+katana::PropertyExpression::Constant(double value) {
+  return Make(Op::kConstant, {}, "", value);
+}
+
+katana::PropertyExpression
+katana::PropertyExpression::OutDegree() {
+  return Make(Op::kOutDegree, {});
+}
+
+katana::Result<katana::PropertyExpression>
+katana::PropertyExpression::Call(Op op, std::vector<PropertyExpression> args) {
+  if (op == Op::kProperty || op == Op::kConstant) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "properties and constants are not functions");
+  }
+  size_t arity = Arity(op);
+  if (args.size() != arity) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} takes {} arguments, not {}",
+        static_cast<int>(op), arity, args.size());
+  }
+  return Make(op, std::move(args));
+}
+
+katana::Result<katana::PropertyExpression>
+katana::PropertyExpression::Parse(const std::string& text) {
+  return Parser(text).Parse();
+}
+
+Op
+katana::PropertyExpression::op() const {
+  return term_->op;
+}
+
+const std::string&
+katana::PropertyExpression::name() const {
+  return term_->name;
+}
+
+double
+katana::PropertyExpression::value() const {
+  return term_->value;
+}
+
+const std::vector<katana::PropertyExpression>&
+katana::PropertyExpression::args() const {
+  return term_->args;
+}
+
+std::string
+katana::PropertyExpression::ToString() const {
+  switch (op()) {
+  case Op::kProperty: {
+    bool identifier =
+        !name().empty() &&
+        (std::isalpha(static_cast<unsigned char>(name()[0])) ||
+         name()[0] == '_') &&
+        std::all_of(name().begin(), name().end(), [](char c) {
+          return std::isalnum(static_cast<unsigned char>(c)) || c == '_' ||
+                 c == '.';
+        });
+    return identifier ? name() : fmt::format("`{}`", name());
+  }
+  case Op::kConstant:
+    // Integers print without a fraction with any version of fmt
+    if (value() == std::trunc(value()) && std::fabs(value()) < 1e15) {
+      return fmt::format("{}", static_cast<int64_t>(value()));
+    }
+    return fmt::format("{}", value());
+  case Op::kNegate: {
+    const PropertyExpression& arg = args()[0];
+    std::string s = arg.ToString();
+    return Precedence(arg) < 3 ? fmt::format("-({})", s) : "-" + s;
+  }
+  case Op::kAdd:
+  case Op::kSubtract:
+  case Op::kMultiply:
+  case Op::kDivide: {
+    int precedence = Precedence(*this);
+    const PropertyExpression& lhs = args()[0];
+    const PropertyExpression& rhs = args()[1];
+    std::string l = lhs.ToString();
+    std::string r = rhs.ToString();
+    if (Precedence(lhs) < precedence) {
+      l = fmt::format("({})", l);
+    }
+    // Operators associate to the left, so a right operand of the same
+    // precedence is parenthesized, as in a - (b - c)
+    if (Precedence(rhs) <= precedence) {
+      r = fmt::format("({})", r);
+    }
+    const char* symbol = op() == Op::kAdd        ? "+"
+                         : op() == Op::kSubtract ? "-"
+                         : op() == Op::kMultiply ? "*"
+                                                 : "/";
+    return fmt::format("{} {} {}", l, symbol, r);
+  }
+  default: {
+    std::string s = FindFunction(op())->name;
+    s += "(";
+    for (size_t i = 0; i < args().size(); ++i) {
+      s += (i ? ", " : "") + args()[i].ToString();
+    }
+    return s + ")";
+  }
+  }
+}
+
+katana::PropertyExpression
+katana::operator+(const PropertyExpression& a, const PropertyExpression& b) {
+  return PropertyExpression::Make(Op::kAdd, {a, b});
+}
+
+katana::PropertyExpression
+katana::operator-(const PropertyExpression& a, const PropertyExpression& b) {
+  return PropertyExpression::Make(Op::kSubtract, {a, b});
+}
+
+katana::PropertyExpression
+katana::operator*(const PropertyExpression& a, const PropertyExpression& b) {
+  return PropertyExpression::Make(Op::kMultiply, {a, b});
+}
+
+katana::PropertyExpression
+katana::operator/(const PropertyExpression& a, const PropertyExpression& b) {
+  return PropertyExpression::Make(Op::kDivide, {a, b});
+}
+
+katana::PropertyExpression
+katana::operator-(const PropertyExpression& a) {
+  return PropertyExpression::Make(Op::kNegate, {a});
+}
+
+katana::Result<std::shared_ptr<arrow::DoubleArray>>
+katana::EvaluateNodeExpression(
+    const PropertyGraph& pg, const PropertyExpression& expression) {
+  return Evaluate(pg, expression, true);
+}
+
+katana::Result<std::shared_ptr<arrow::DoubleArray>>
+katana::EvaluateEdgeExpression(
+    const PropertyGraph& pg, const PropertyExpression& expression) {
+  return Evaluate(pg, expression, false);
+}
+
+katana::Result<void>
+katana::AddNodePropertyFromExpression(
+    PropertyGraph* pg, const std::string& name,
+    const PropertyExpression& expression) {
+  auto res = EvaluateNodeExpression(*pg, expression);
+  if (!res) {
+    return res.error();
+  }
+  return pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::float64())}),
+      {std::static_pointer_cast<arrow::Array>(res.value())}));
+}
+
+katana::Result<void>
+katana::AddEdgePropertyFromExpression(
+    PropertyGraph* pg, const std::string& name,
+    const PropertyExpression& expression) {
+  auto res = EvaluateEdgeExpression(*pg, expression);
+  if (!res) {
+    return res.error();
+  }
+  return pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::float64())}),
+      {std::static_pointer_cast<arrow::Array>(res.value())}));
+}
+
+katana::Result<void>
+katana::AddNodePropertyFromExpression(
+    PropertyGraph* pg, const std::string& name, const std::string& text) {
+  auto res = PropertyExpression::Parse(text);
+  if (!res) {
+    return res.error();
+  }
+  return AddNodePropertyFromExpression(pg, name, res.value());
+}
+
+katana::Result<void>
+katana::AddEdgePropertyFromExpression(
+    PropertyGraph* pg, const std::string& name, const std::string& text) {
+  auto res = PropertyExpression::Parse(text);
+  if (!res) {
+    return res.error();
+  }
+  return AddEdgePropertyFromExpression(pg, name, res.value());
+}
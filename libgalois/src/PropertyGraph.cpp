@@ -2,13 +2,28 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+
+#include <arrow/compute/api.h>
+
 #include "katana/ArrowInterchange.h"
+#include "katana/BitMath.h"
+#include "katana/DeltaTopology.h"
 #include "katana/Logging.h"
 #include "katana/Loops.h"
+#include "katana/NumaMemoryPool.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/Platform.h"
 #include "katana/Properties.h"
+#include "katana/Relabel.h"
 #include "katana/Result.h"
+#include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/RDG.h"
@@ -16,6 +31,117 @@
 
 namespace {
 
+bool
+KeepsChunks(const arrow::Field& field) {
+  const auto& metadata = field.metadata();
+  if (!metadata) {
+    return false;
+  }
+  auto res = metadata->Get(katana::PropertyGraph::kKeepChunksKey);
+  return res.ok() && res.ValueOrDie() == "true";
+}
+
+/// Combine the chunks of each property of props into one array, in
+/// parallel across properties. Returns props itself if no property needs
+/// combining.
+katana::Result<std::shared_ptr<arrow::Table>>
+CombinePropertyChunks(
+    const std::shared_ptr<arrow::Table>& props, arrow::MemoryPool* pool) {
+  std::vector<int> chunked;
+  for (int i = 0, n = props->num_columns(); i < n; ++i) {
+    if (props->column(i)->num_chunks() > 1 && !KeepsChunks(*props->field(i))) {
+      chunked.emplace_back(i);
+    }
+  }
+  if (chunked.empty()) {
+    return props;
+  }
+  if (!pool) {
+    pool = arrow::default_memory_pool();
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns = props->columns();
+  std::vector<arrow::Status> statuses(chunked.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, chunked.size()),
+      [&](size_t k) {
+        std::shared_ptr<arrow::ChunkedArray>& column = columns[chunked[k]];
+        auto res = arrow::Concatenate(column->chunks(), pool);
+        if (!res.ok()) {
+          statuses[k] = res.status();
+          return;
+        }
+        column = std::make_shared<arrow::ChunkedArray>(res.ValueOrDie());
+      },
+      katana::steal(), katana::no_stats());
+
+  for (size_t k = 0; k < chunked.size(); ++k) {
+    const arrow::Status& status = statuses[k];
+    if (status.ok()) {
+      continue;
+    }
+    // Binary and string arrays have int32_t offsets, so they may be too
+    // large to combine (c.f. ParquetReader); leave those chunked
+    auto type = props->field(chunked[k])->type()->id();
+    if (status.IsCapacityError() || status.IsInvalid()) {
+      if (type == arrow::Type::BINARY || type == arrow::Type::STRING) {
+        KATANA_LOG_DEBUG(
+            "keeping chunks of {}: {}", props->field(chunked[k])->name(),
+            status);
+        continue;
+      }
+    }
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "combining chunks of {}: {}",
+        props->field(chunked[k])->name(), status);
+  }
+  return arrow::Table::Make(props->schema(), columns, props->num_rows());
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateTopologyBuffer(
+    uint64_t size, arrow::MemoryPool* pool = arrow::default_memory_pool()) {
+  auto res = arrow::AllocateBuffer(size, pool);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} bytes: {}", size,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+/// The pool to allocate a copy of a topology from, for the pool of a load.
+/// A NumaMemoryPool that blocks buffers across threads would split the
+/// destinations evenly by bytes, not by the nodes that each thread later
+/// iterates over, so use the floating pool instead and let PlaceTopology
+/// fault the pages in.
+arrow::MemoryPool*
+TopologyPool(arrow::MemoryPool* pool) {
+  auto* numa_pool = dynamic_cast<katana::NumaMemoryPool*>(pool);
+  if (numa_pool &&
+      numa_pool->policy() == katana::NumaMemoryPool::Policy::kBlocked) {
+    return katana::NumaMemoryPool::Get(
+        katana::NumaMemoryPool::Policy::kFloating);
+  }
+  return pool;
+}
+
+/// Call fn(begin, end) on each thread for the nodes [begin, end) that a
+/// do_all over all nodes without stealing gives it. Filling the topology of
+/// those nodes from fn makes each thread the first to touch the pages that
+/// it later reads, which places them on its NUMA node.
+template <typename F>
+void
+PlaceTopology(uint64_t num_nodes, const F& fn) {
+  katana::on_each([&](unsigned tid, unsigned num_threads) {
+    auto [begin, end] =
+        katana::block_range(uint64_t{0}, num_nodes, tid, num_threads);
+    if (begin < end) {
+      fn(begin, end);
+    }
+  });
+}
+
 constexpr uint64_t
 GetGraphSize(uint64_t num_nodes, uint64_t num_edges) {
   /// version, sizeof_edge_data, num_nodes, num_edges
@@ -41,13 +167,109 @@ GetGraphSize(uint64_t num_nodes, uint64_t num_edges) {
 ///
 /// Since property graphs store their edge data separately, we will
 /// ignore the size_of_edge_data (data[1]).
+bool
+IsCompressedTopology(const tsuba::FileView& file_view) {
+  return file_view.Valid() && file_view.size() >= sizeof(uint64_t) &&
+         file_view.ptr<uint64_t>()[0] == tsuba::kCompressedCSRTopologyVersion;
+}
+
+/// DecodeTopology decodes a compressed topology file (see
+/// tsuba::kCompressedCSRTopologyVersion) into arrays allocated from pool and
+/// placed by PlaceTopology.
+katana::Result<katana::GraphTopology>
+DecodeTopology(const tsuba::FileView& file_view, arrow::MemoryPool* pool) {
+  const auto* header = file_view.ptr<tsuba::CSRTopologyHeader>();
+  uint64_t num_nodes = header->num_nodes;
+  uint64_t num_edges = header->num_edges;
+
+  uint64_t prefix_size =
+      tsuba::CompressedCSRTopologyFileSize(*header, /*dest_blocks_size=*/0);
+  if (file_view.size() < prefix_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "file_view size: {} expected {}",
+        file_view.size(), prefix_size);
+  }
+
+  const auto* in_indices = reinterpret_cast<const uint64_t*>(
+      file_view.ptr<uint8_t>() + sizeof(*header));
+  const auto* dest_offsets = in_indices + num_nodes;
+  const auto* dest_blocks =
+      reinterpret_cast<const uint8_t*>(dest_offsets + num_nodes);
+
+  uint64_t dest_blocks_size = num_nodes ? dest_offsets[num_nodes - 1] : 0;
+  uint64_t expected_size =
+      tsuba::CompressedCSRTopologyFileSize(*header, dest_blocks_size);
+  if (file_view.size() < expected_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "file_view size: {} expected {}",
+        file_view.size(), expected_size);
+  }
+  if (num_nodes && in_indices[num_nodes - 1] != num_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "out_indices end at {} expected {}", in_indices[num_nodes - 1],
+        num_edges);
+  }
+
+  arrow::MemoryPool* topology_pool = TopologyPool(pool);
+  auto indices_res =
+      AllocateTopologyBuffer(num_nodes * sizeof(uint64_t), topology_pool);
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res =
+      AllocateTopologyBuffer(num_edges * sizeof(uint32_t), topology_pool);
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buf = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> dests_buf = std::move(dests_res.value());
+
+  auto* out_indices = reinterpret_cast<uint64_t*>(indices_buf->mutable_data());
+  auto* out_dests = reinterpret_cast<uint32_t*>(dests_buf->mutable_data());
+
+  std::atomic<bool> malformed{false};
+  PlaceTopology(num_nodes, [&](uint64_t begin, uint64_t end) {
+    std::copy(in_indices + begin, in_indices + end, out_indices + begin);
+    for (uint64_t n = begin; n < end; ++n) {
+      uint64_t edge_begin = n == 0 ? 0 : in_indices[n - 1];
+      uint64_t edge_end = in_indices[n];
+      uint64_t block_begin = n == 0 ? 0 : dest_offsets[n - 1];
+      uint64_t block_end = dest_offsets[n];
+      if (edge_begin > edge_end || edge_end > num_edges ||
+          block_begin > block_end || block_end > dest_blocks_size ||
+          !tsuba::DecodeCompressedCSRDests(
+              n, dest_blocks + block_begin, dest_blocks + block_end,
+              edge_end - edge_begin, out_dests + edge_begin)) {
+        malformed = true;
+        return;
+      }
+    }
+  });
+
+  if (malformed) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "malformed compressed topology");
+  }
+
+  return katana::GraphTopology{
+      .out_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buf),
+      .out_dests = std::make_shared<arrow::UInt32Array>(num_edges, dests_buf),
+  };
+}
+
 katana::Result<katana::GraphTopology>
-MapTopology(const tsuba::FileView& file_view) {
+MapTopology(const tsuba::FileView& file_view, arrow::MemoryPool* pool) {
   const auto* data = file_view.ptr<uint64_t>();
   if (file_view.size() < 4) {
     return katana::ErrorCode::InvalidArgument;
   }
 
+  if (data[0] == tsuba::kCompressedCSRTopologyVersion) {
+    return DecodeTopology(file_view, pool);
+  }
+
   if (data[0] != 1) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -81,11 +303,52 @@ MapTopology(const tsuba::FileView& file_view) {
   };
 }
 
+/// CopyTopology copies a topology into arrays allocated from pool, in
+/// parallel and placed by PlaceTopology.
+katana::Result<katana::GraphTopology>
+CopyTopology(const katana::GraphTopology& topology, arrow::MemoryPool* pool) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  arrow::MemoryPool* topology_pool = TopologyPool(pool);
+  auto indices_res =
+      AllocateTopologyBuffer(num_nodes * sizeof(uint64_t), topology_pool);
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res =
+      AllocateTopologyBuffer(num_edges * sizeof(uint32_t), topology_pool);
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buf = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> dests_buf = std::move(dests_res.value());
+
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buf->mutable_data());
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buf->mutable_data());
+  const uint64_t* in_indices =
+      num_nodes ? topology.out_indices->raw_values() : nullptr;
+  const uint32_t* in_dests =
+      num_edges ? topology.out_dests->raw_values() : nullptr;
+  PlaceTopology(num_nodes, [&](uint64_t begin, uint64_t end) {
+    std::copy(in_indices + begin, in_indices + end, indices + begin);
+    uint64_t edge_begin = begin == 0 ? 0 : in_indices[begin - 1];
+    std::copy(
+        in_dests + edge_begin, in_dests + in_indices[end - 1],
+        dests + edge_begin);
+  });
+
+  return katana::GraphTopology{
+      .out_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buf),
+      .out_dests = std::make_shared<arrow::UInt32Array>(num_edges, dests_buf),
+  };
+}
+
 katana::Result<void>
 LoadTopology(
     katana::GraphTopology* topology,
-    const tsuba::FileView& topology_file_storage) {
-  auto map_result = MapTopology(topology_file_storage);
+    const tsuba::FileView& topology_file_storage, arrow::MemoryPool* pool) {
+  auto map_result = MapTopology(topology_file_storage, pool);
   if (!map_result) {
     return map_result.error();
   }
@@ -94,6 +357,81 @@ LoadTopology(
   return katana::ResultSuccess();
 }
 
+/// WriteCompressedTopology writes a topology in the compressed CSR format (see
+/// tsuba::kCompressedCSRTopologyVersion).
+katana::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteCompressedTopology(const katana::GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  const uint64_t* indices =
+      num_nodes ? topology.out_indices->raw_values() : nullptr;
+  const uint32_t* dests =
+      num_edges ? topology.out_dests->raw_values() : nullptr;
+
+  katana::LargeArray<uint64_t> dest_offsets;
+  dest_offsets.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t edge_begin = n == 0 ? 0 : indices[n - 1];
+        dest_offsets[n] = tsuba::CompressedCSRDestsSize(
+            n, dests + edge_begin, dests + indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      dest_offsets.begin(), dest_offsets.end(), dest_offsets.begin());
+
+  uint64_t dest_blocks_size = num_nodes ? dest_offsets[num_nodes - 1] : 0;
+  katana::LargeArray<uint8_t> dest_blocks;
+  dest_blocks.allocateBlocked(dest_blocks_size);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t edge_begin = n == 0 ? 0 : indices[n - 1];
+        uint64_t block_begin = n == 0 ? 0 : dest_offsets[n - 1];
+        tsuba::EncodeCompressedCSRDests(
+            n, dests + edge_begin, dests + indices[n],
+            dest_blocks.data() + block_begin);
+      },
+      katana::steal(), katana::no_stats());
+
+  tsuba::CSRTopologyHeader header{
+      .version = tsuba::kCompressedCSRTopologyVersion,
+      .edge_type_size = 0,
+      .num_nodes = num_nodes,
+      .num_edges = num_edges,
+  };
+
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  if (auto res = ff->Init(
+          tsuba::CompressedCSRTopologyFileSize(header, dest_blocks_size));
+      !res) {
+    return res.error();
+  }
+
+  arrow::Status aro_sts = ff->Write(&header, sizeof(header));
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+  if (num_nodes) {
+    aro_sts = ff->Write(indices, num_nodes * sizeof(uint64_t));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+    aro_sts = ff->Write(dest_offsets.data(), num_nodes * sizeof(uint64_t));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+  if (dest_blocks_size) {
+    aro_sts = ff->Write(dest_blocks.data(), dest_blocks_size);
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
 katana::Result<std::unique_ptr<tsuba::FileFrame>>
 WriteTopology(const katana::GraphTopology& topology) {
   auto ff = std::make_unique<tsuba::FileFrame>();
@@ -133,6 +471,119 @@ WriteTopology(const katana::GraphTopology& topology) {
   return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
 }
 
+constexpr uint64_t
+GetInEdgeIndexSize(uint64_t num_nodes, uint64_t num_edges) {
+  /// version, sizeof_edge_data, num_nodes, num_edges
+  constexpr int mandatory_fields = 4;
+
+  return (mandatory_fields + num_nodes) * sizeof(uint64_t) +
+         katana::AlignUp<uint64_t>(num_edges * sizeof(uint32_t)) +
+         (num_edges * sizeof(uint64_t));
+}
+
+/// MapInEdgeIndex takes a file buffer of an in-edge topology file and extracts
+/// the in-edge index.
+///
+/// An in-edge topology file has the same format as a topology file. Its
+/// out_indices and out_dests are those of the transposed topology, and its
+/// edge data (sizeof_edge_data = 8) is the id of each in-edge in the original
+/// topology.
+katana::Result<katana::InEdgeIndex>
+MapInEdgeIndex(const tsuba::FileView& file_view) {
+  const auto* data = file_view.ptr<uint64_t>();
+  if (file_view.size() < 4 * sizeof(uint64_t)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "in-edge topology too small");
+  }
+
+  if (data[0] != 1 || data[1] != sizeof(uint64_t)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "unexpected in-edge topology version {} or edge data size {}", data[0],
+        data[1]);
+  }
+
+  uint64_t num_nodes = data[2];
+  uint64_t num_edges = data[3];
+
+  uint64_t expected_size = GetInEdgeIndexSize(num_nodes, num_edges);
+
+  if (file_view.size() < expected_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "file_view size: {} expected {}",
+        file_view.size(), expected_size);
+  }
+
+  const auto* raw = file_view.ptr<uint8_t>();
+  uint64_t dests_offset = (4 + num_nodes) * sizeof(uint64_t);
+  uint64_t edge_ids_offset =
+      dests_offset + katana::AlignUp<uint64_t>(num_edges * sizeof(uint32_t));
+
+  auto indices_buffer = std::make_shared<arrow::Buffer>(
+      raw + 4 * sizeof(uint64_t), num_nodes * sizeof(uint64_t));
+  auto dests_buffer = std::make_shared<arrow::Buffer>(
+      raw + dests_offset, num_edges * sizeof(uint32_t));
+  auto edge_ids_buffer = std::make_shared<arrow::Buffer>(
+      raw + edge_ids_offset, num_edges * sizeof(uint64_t));
+
+  return katana::InEdgeIndex{
+      .topology =
+          katana::GraphTopology{
+              .out_indices = std::make_shared<arrow::UInt64Array>(
+                  num_nodes, indices_buffer),
+              .out_dests =
+                  std::make_shared<arrow::UInt32Array>(num_edges, dests_buffer),
+          },
+      .out_edge_ids =
+          std::make_shared<arrow::UInt64Array>(num_edges, edge_ids_buffer),
+  };
+}
+
+katana::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteInEdgeIndex(const katana::InEdgeIndex& index) {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  uint64_t num_nodes = index.num_nodes();
+  uint64_t num_edges = index.num_edges();
+  if (auto res = ff->Init(GetInEdgeIndexSize(num_nodes, num_edges)); !res) {
+    return res.error();
+  }
+
+  uint64_t data[4] = {1, sizeof(uint64_t), num_nodes, num_edges};
+  arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+
+  if (num_nodes) {
+    aro_sts = ff->Write(
+        index.topology.out_indices->raw_values(), num_nodes * sizeof(uint64_t));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+
+  if (num_edges) {
+    uint64_t dests_size = num_edges * sizeof(uint32_t);
+    aro_sts = ff->Write(index.topology.out_dests->raw_values(), dests_size);
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+    // pad so that the edge data is aligned
+    uint64_t padding = 0;
+    aro_sts = ff->Write(
+        &padding, katana::AlignUp<uint64_t>(dests_size) - dests_size);
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+    aro_sts = ff->Write(
+        index.out_edge_ids->raw_values(), num_edges * sizeof(uint64_t));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 MakePropertyGraph(
     std::unique_ptr<tsuba::RDGFile> rdg_file,
@@ -143,7 +594,7 @@ MakePropertyGraph(
   }
 
   return katana::PropertyGraph::Make(
-      std::move(rdg_file), std::move(rdg_result.value()));
+      std::move(rdg_file), std::move(rdg_result.value()), opts.memory_pool);
 }
 
 /// Assumes all boolean or uint8 properties are types
@@ -182,7 +633,8 @@ GetTypeSetIDsFromProperties(
 
   // assign a new ID to each type
   // NB: cannot use unordered_map without defining a hash function for vectors;
-  // performance is not affected here because the map is very small (<=256)
+  // performance is not affected here because the map is small compared to
+  // the rows
   std::map<katana::gstl::Vector<int>, katana::PropertyGraph::TypeSetID>
       type_field_indices_to_id;
   for (int i : type_field_indices) {
@@ -207,7 +659,8 @@ GetTypeSetIDsFromProperties(
 
   // collect the list of unique combination of types
   // NB: cannot use unordered_set without defining a hash function for vectors;
-  // performance is not affected here because the set is very small (<=256)
+  // performance is not affected here because the set is small compared to
+  // the rows
   katana::gstl::Set<katana::gstl::Vector<int>> type_combinations;
   katana::PerThreadStorage<katana::gstl::Set<katana::gstl::Vector<int>>>
       type_combinations_pts;
@@ -266,7 +719,7 @@ GetTypeSetIDsFromProperties(
   }
 
   // assert that all type IDs and 2 special type IDs (unknown and invalid)
-  // can be stored in 8 bits
+  // can be stored in a TypeSetID
   if (type_set_id_to_type_names->size() >
       (std::numeric_limits<katana::PropertyGraph::TypeSetID>::max() -
        size_t{2})) {
@@ -317,6 +770,61 @@ GetTypeSetIDsFromProperties(
       std::move(type_set_ids));
 }
 
+/// Take the rows rows[i] of props. Columns of fixed width, one chunk and no
+/// nulls, which are most properties, are gathered by a parallel loop in
+/// which each thread writes, and so first touches, its own block of the
+/// result; the other columns are taken by arrow::compute::Take.
+template <typename IndexArray>
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::Table>& props,
+    const std::shared_ptr<IndexArray>& rows) {
+  uint64_t num_rows = rows->length();
+  const auto* row_ids = rows->raw_values();
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0, n = props->num_columns(); i < n; ++i) {
+    const std::shared_ptr<arrow::ChunkedArray>& column = props->column(i);
+    const std::shared_ptr<arrow::DataType>& type = column->type();
+    const auto* fixed = dynamic_cast<const arrow::FixedWidthType*>(type.get());
+    bool gather = fixed && fixed->bit_width() % 8 == 0 &&
+                  type->id() != arrow::Type::DICTIONARY &&
+                  type->id() != arrow::Type::EXTENSION &&
+                  column->num_chunks() == 1 && column->null_count() == 0;
+    if (!gather) {
+      auto take_res =
+          arrow::compute::Take(arrow::Datum(column), arrow::Datum(rows));
+      if (!take_res.ok()) {
+        return KATANA_ERROR(
+            katana::ArrowToKatana(take_res.status()), "taking {}: {}",
+            props->field(i)->name(), take_res.status());
+      }
+      columns.emplace_back(take_res.ValueOrDie().chunked_array());
+      continue;
+    }
+
+    size_t width = fixed->bit_width() / 8;
+    const arrow::ArrayData& data = *column->chunk(0)->data();
+    const uint8_t* in = data.buffers[1]->data() + data.offset * width;
+    auto buf_res = AllocateTopologyBuffer(num_rows * width);
+    if (!buf_res) {
+      return buf_res.error();
+    }
+    std::shared_ptr<arrow::Buffer> buf = std::move(buf_res.value());
+    uint8_t* out = buf->mutable_data();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_rows),
+        [&](uint64_t r) {
+          std::memcpy(out + r * width, in + row_ids[r] * width, width);
+        },
+        katana::no_stats());
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        arrow::MakeArray(arrow::ArrayData::Make(
+            type, num_rows, {nullptr, std::move(buf)}, 0))));
+  }
+  return arrow::Table::Make(props->schema(), columns, num_rows);
+}
+
 katana::LargeArray<katana::PropertyGraph::TypeSetID>
 GetUnknownTypeSetIDs(uint64_t num_rows) {
   katana::LargeArray<katana::PropertyGraph::TypeSetID> type_set_ids;
@@ -327,91 +835,515 @@ GetUnknownTypeSetIDs(uint64_t num_rows) {
   return type_set_ids;
 }
 
-}  // namespace
-
-katana::PropertyGraph::PropertyGraph() = default;
-
-katana::PropertyGraph::PropertyGraph(
-    std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg)
-    : rdg_(std::move(rdg)), file_(std::move(rdg_file)) {}
-
-katana::Result<void>
-katana::PropertyGraph::Validate() {
-  // TODO (thunt) check that arrow table sizes match topology
-  // if (topology_.out_dests &&
-  //    topology_.out_dests->length() != table->num_rows()) {
-  //  return ErrorCode::InvalidArgument;
-  //}
-  // if (topology_.out_indices &&
-  //    topology_.out_indices->length() != table->num_rows()) {
-  //  return ErrorCode::InvalidArgument;
-  //}
+/// The bytes of the buffers of data and its children; buffers shared
+/// between arrays are counted for each of them
+uint64_t
+ArrayDataBytes(const arrow::ArrayData& data) {
+  uint64_t bytes = 0;
+  for (const std::shared_ptr<arrow::Buffer>& buffer : data.buffers) {
+    if (buffer) {
+      bytes += buffer->size();
+    }
+  }
+  for (const std::shared_ptr<arrow::ArrayData>& child : data.child_data) {
+    bytes += ArrayDataBytes(*child);
+  }
+  if (data.dictionary) {
+    bytes += ArrayDataBytes(*data.dictionary);
+  }
+  return bytes;
+}
 
-  uint64_t num_node_rows = static_cast<uint64_t>(node_properties()->num_rows());
-  if (num_node_rows == 0) {
-    if ((node_properties()->num_columns() != 0) && (num_nodes() != 0)) {
+/// The global IDs of the local nodes of pg as one array
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+GlobalIDsOf(const katana::PropertyGraph& pg) {
+  const std::shared_ptr<arrow::ChunkedArray>& ids = pg.local_to_global_id();
+  if (!ids || ids->type()->id() != arrow::Type::UINT64 ||
+      static_cast<uint64_t>(ids->length()) != pg.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "partition {} has no global IDs for its {} nodes", pg.partition_id(),
+        pg.num_nodes());
+  }
+  std::shared_ptr<arrow::Array> array;
+  if (ids->num_chunks() == 1) {
+    array = ids->chunk(0);
+  } else {
+    auto concat_res = ids->num_chunks() == 0
+                          ? arrow::MakeArrayOfNull(arrow::uint64(), 0)
+                          : arrow::Concatenate(ids->chunks());
+    if (!concat_res.ok()) {
       return KATANA_ERROR(
-          ErrorCode::AssertionFailed,
-          "number of rows in node properties is 0 but "
-          "the number of node properties is {} and the number of nodes is {}",
-          node_properties()->num_columns(), num_nodes());
+          katana::ArrowToKatana(concat_res.status()),
+          "combining global IDs: {}", concat_res.status());
     }
-  } else if (num_node_rows != num_nodes()) {
-    return KATANA_ERROR(
-        ErrorCode::AssertionFailed,
-        "number of rows in node properties {} differs "
-        "from the number of nodes {}",
-        node_properties()->num_rows(), num_nodes());
+    array = std::move(concat_res.ValueOrDie());
   }
+  return std::static_pointer_cast<arrow::UInt64Array>(array);
+}
 
-  uint64_t num_edge_rows = static_cast<uint64_t>(edge_properties()->num_rows());
-  if (num_edge_rows == 0) {
-    if ((edge_properties()->num_columns() != 0) && (num_edges() != 0)) {
+/// Combine the loaded partitions of a partitioned graph into one graph
+/// whose nodes are the masters of the partitions, in partition order; see
+/// PropertyGraph::MakeFromAllPartitions
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+CombinePartitions(
+    const std::vector<std::unique_ptr<katana::PropertyGraph>>& parts,
+    const std::vector<uint64_t>& num_owned, arrow::MemoryPool* pool) {
+  constexpr uint32_t kNoNode = std::numeric_limits<uint32_t>::max();
+  uint32_t num_parts = parts.size();
+  if (!pool) {
+    pool = arrow::default_memory_pool();
+  }
+
+  // The combined nodes of partition p are [begins[p], begins[p + 1]) and its
+  // edges start at edge_begins[p] among the edges of all partitions
+  std::vector<uint64_t> begins(num_parts + 1, 0);
+  std::vector<uint64_t> edge_begins(num_parts + 1, 0);
+  std::vector<std::shared_ptr<arrow::UInt64Array>> global_ids(num_parts);
+  for (uint32_t p = 0; p < num_parts; ++p) {
+    if (num_owned[p] > parts[p]->num_nodes()) {
       return KATANA_ERROR(
-          ErrorCode::AssertionFailed,
-          "number of rows in edge properties is 0 but "
-          "the number of edge properties is {} and the number of edges is {}",
-          edge_properties()->num_columns(), num_edges());
+          katana::ErrorCode::InvalidArgument,
+          "partition {} owns {} of its {} nodes", p, num_owned[p],
+          parts[p]->num_nodes());
     }
-  } else if (num_edge_rows != num_edges()) {
+    begins[p + 1] = begins[p] + num_owned[p];
+    edge_begins[p + 1] = edge_begins[p] + parts[p]->num_edges();
+    auto ids_res = GlobalIDsOf(*parts[p]);
+    if (!ids_res) {
+      return ids_res.error();
+    }
+    global_ids[p] = std::move(ids_res.value());
+  }
+  uint64_t num_nodes = begins[num_parts];
+  uint64_t num_edges = edge_begins[num_parts];
+  if (num_nodes >= kNoNode) {
     return KATANA_ERROR(
-        ErrorCode::AssertionFailed,
-        "number of rows in edge properties {} differs "
-        "from the number of edges {}",
-        edge_properties()->num_rows(), num_edges());
+        katana::ErrorCode::NotImplemented,
+        "{} nodes do not fit 32-bit node IDs", num_nodes);
   }
 
-  return katana::ResultSuccess();
-}
+  // The combined node of each global node, which is its master
+  std::atomic<bool> bad_ids{false};
+  katana::LargeArray<uint32_t> to_combined;
+  to_combined.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t c) { to_combined[c] = kNoNode; }, katana::no_stats());
+  for (uint32_t p = 0; p < num_parts; ++p) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_owned[p]),
+        [&](uint64_t n) {
+          uint64_t id = global_ids[p]->Value(n);
+          if (id >= num_nodes || to_combined[id] != kNoNode) {
+            bad_ids = true;
+            return;
+          }
+          to_combined[id] = begins[p] + n;
+        },
+        katana::no_stats());
+  }
+  auto combined_of = [&](uint32_t p, uint64_t n) {
+    uint64_t id = global_ids[p]->Value(n);
+    if (id >= num_nodes || to_combined[id] == kNoNode) {
+      bad_ids = true;
+      return uint32_t{0};
+    }
+    return to_combined[id];
+  };
 
-katana::Result<void>
-katana::PropertyGraph::DoWrite(
-    tsuba::RDGHandle handle, const std::string& command_line) {
-  if (!rdg_.topology_file_storage().Valid()) {
-    auto result = WriteTopology(topology_);
-    if (!result) {
-      return result.error();
+  // Thread t handles the combined nodes [node_ranges[t], node_ranges[t +
+  // 1]), so that the nodes of partition p go to threads [p * T / P,
+  // (p + 1) * T / P) (or whole partitions to a thread if there are fewer
+  // threads), and touches the pages of their topology first, which places
+  // them on its NUMA node
+  uint64_t num_threads = katana::getActiveThreads();
+  std::vector<uint64_t> node_ranges(num_threads + 1, num_nodes);
+  if (num_threads < num_parts) {
+    for (uint64_t t = 0; t < num_threads; ++t) {
+      node_ranges[t] = begins[t * num_parts / num_threads];
+    }
+  } else {
+    for (uint64_t p = 0; p < num_parts; ++p) {
+      uint64_t first = p * num_threads / num_parts;
+      uint64_t last = (p + 1) * num_threads / num_parts;
+      for (uint64_t k = 0; k < last - first; ++k) {
+        node_ranges[first + k] = begins[p] + num_owned[p] * k / (last - first);
+      }
     }
-    return rdg_.Store(handle, command_line, std::move(result.value()));
   }
 
-  return rdg_.Store(handle, command_line);
-}
-
-katana::Result<std::unique_ptr<katana::PropertyGraph>>
-katana::PropertyGraph::Make(
-    std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg) {
-  auto g = std::unique_ptr<PropertyGraph>(
-      new PropertyGraph(std::move(rdg_file), std::move(rdg)));
-
-  auto load_result =
-      LoadTopology(&g->topology_, g->rdg_.topology_file_storage());
-  if (!load_result) {
-    return load_result.error();
-  }
+  arrow::MemoryPool* topology_pool =
+      katana::NumaMemoryPool::Get(katana::NumaMemoryPool::Policy::kFloating);
+  auto indices_res =
+      AllocateTopologyBuffer(num_nodes * sizeof(uint64_t), topology_pool);
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res =
+      AllocateTopologyBuffer(num_edges * sizeof(uint32_t), topology_pool);
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto ids_res = AllocateTopologyBuffer(num_nodes * sizeof(uint64_t), pool);
+  if (!ids_res) {
+    return ids_res.error();
+  }
+  auto origins_res = AllocateTopologyBuffer(num_edges * sizeof(uint64_t));
+  if (!origins_res) {
+    return origins_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buf = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> dests_buf = std::move(dests_res.value());
+  std::shared_ptr<arrow::Buffer> ids_buf = std::move(ids_res.value());
+  std::shared_ptr<arrow::Buffer> origins_buf = std::move(origins_res.value());
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buf->mutable_data());
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buf->mutable_data());
+  auto* ids = reinterpret_cast<uint64_t*>(ids_buf->mutable_data());
+  // origins[e] is the edge of all partitions that combined edge e is
+  auto* origins = reinterpret_cast<uint64_t*>(origins_buf->mutable_data());
+
+  // The partition of each combined node in [begin, end) in turn
+  auto for_partitions = [&](uint64_t begin, uint64_t end, auto fn) {
+    uint32_t p = std::upper_bound(begins.begin(), begins.end(), begin) -
+                 begins.begin() - 1;
+    for (uint64_t c = begin; c < end; ++c) {
+      while (c >= begins[p + 1]) {
+        ++p;
+      }
+      fn(p, c);
+    }
+  };
 
-  if (auto good = g->Validate(); !good) {
-    return good.error();
+  // A master has its edges in its partition, and in a vertex cut the
+  // mirrors of a node have more of them in the others
+  katana::on_each([&](unsigned tid, unsigned) {
+    auto touch = [&](uint32_t p, uint64_t c) {
+      uint64_t n = c - begins[p];
+      indices[c] = parts[p]->topology().edges(n).size();
+      ids[c] = global_ids[p]->Value(n);
+    };
+    for_partitions(node_ranges[tid], node_ranges[tid + 1], touch);
+  });
+  for (uint32_t p = 0; p < num_parts; ++p) {
+    katana::do_all(
+        katana::iterate(num_owned[p], parts[p]->num_nodes()),
+        [&](uint64_t n) {
+          uint64_t degree = parts[p]->topology().edges(n).size();
+          if (degree > 0) {
+            indices[combined_of(p, n)] += degree;
+          }
+        },
+        katana::no_stats());
+  }
+  if (bad_ids) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "global IDs do not match one master per node");
+  }
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+
+  // Mirror edges of a node follow its master edges, in partition order
+  katana::LargeArray<uint64_t> cursors;
+  cursors.allocateInterleaved(num_nodes);
+  auto copy_edges = [&](uint32_t p, uint64_t n, uint64_t out) {
+    const katana::GraphTopology& topology = parts[p]->topology();
+    for (auto e : topology.edges(n)) {
+      dests[out] = combined_of(p, topology.edge_dest(e));
+      origins[out] = edge_begins[p] + e;
+      ++out;
+    }
+    return out;
+  };
+  katana::on_each([&](unsigned tid, unsigned) {
+    auto copy_master = [&](uint32_t p, uint64_t c) {
+      cursors[c] = copy_edges(p, c - begins[p], c == 0 ? 0 : indices[c - 1]);
+    };
+    for_partitions(node_ranges[tid], node_ranges[tid + 1], copy_master);
+  });
+  for (uint32_t p = 0; p < num_parts; ++p) {
+    katana::do_all(
+        katana::iterate(num_owned[p], parts[p]->num_nodes()),
+        [&](uint64_t n) {
+          if (!parts[p]->topology().edges(n).empty()) {
+            uint32_t c = combined_of(p, n);
+            cursors[c] = copy_edges(p, n, cursors[c]);
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+  if (bad_ids) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edges reach nodes without a master");
+  }
+
+  auto pg = std::make_unique<katana::PropertyGraph>();
+  if (auto res = pg->SetTopology(katana::GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_nodes, indices_buf),
+          .out_dests =
+              std::make_shared<arrow::UInt32Array>(num_edges, dests_buf),
+      });
+      !res) {
+    return res.error();
+  }
+  pg->set_local_to_global_id(std::make_shared<arrow::ChunkedArray>(
+      std::make_shared<arrow::UInt64Array>(num_nodes, ids_buf)));
+
+  // The node properties of the masters are those of the combined nodes, and
+  // edge properties follow their edges
+  std::vector<std::shared_ptr<arrow::Table>> node_tables;
+  std::vector<std::shared_ptr<arrow::Table>> edge_tables;
+  for (uint32_t p = 0; p < num_parts; ++p) {
+    node_tables.emplace_back(
+        parts[p]->node_properties()->Slice(0, num_owned[p]));
+    edge_tables.emplace_back(parts[p]->edge_properties());
+  }
+  auto nodes_res = arrow::ConcatenateTables(node_tables);
+  if (!nodes_res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(nodes_res.status()),
+        "combining node properties: {}", nodes_res.status());
+  }
+  std::shared_ptr<arrow::Table> node_props = nodes_res.ValueOrDie();
+  if (node_props->num_columns() > 0) {
+    auto combine_res = node_props->CombineChunks(pool);
+    if (!combine_res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(combine_res.status()),
+          "combining node properties: {}", combine_res.status());
+    }
+    if (auto res = pg->AddNodeProperties(combine_res.ValueOrDie()); !res) {
+      return res.error();
+    }
+  }
+
+  auto edges_res = arrow::ConcatenateTables(edge_tables);
+  if (!edges_res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(edges_res.status()),
+        "combining edge properties: {}", edges_res.status());
+  }
+  std::shared_ptr<arrow::Table> edge_props = edges_res.ValueOrDie();
+  if (edge_props->num_columns() > 0) {
+    arrow::compute::ExecContext ctx(pool);
+    auto take_res = arrow::compute::Take(
+        arrow::Datum(edge_props),
+        arrow::Datum(
+            std::make_shared<arrow::UInt64Array>(num_edges, origins_buf)),
+        arrow::compute::TakeOptions::Defaults(), &ctx);
+    if (!take_res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(take_res.status()),
+          "taking edge properties: {}", take_res.status());
+    }
+    auto combine_res = take_res.ValueOrDie().table()->CombineChunks(pool);
+    if (!combine_res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(combine_res.status()),
+          "combining edge properties: {}", combine_res.status());
+    }
+    if (auto res = pg->AddEdgeProperties(combine_res.ValueOrDie()); !res) {
+      return res.error();
+    }
+  }
+  return std::unique_ptr<katana::PropertyGraph>(std::move(pg));
+}
+
+/// SelectProperties loads the node or edge properties \param names of rdg that
+/// are not loaded yet and returns a table of their columns, which shares
+/// their buffers
+katana::Result<std::shared_ptr<arrow::Table>>
+SelectProperties(
+    const tsuba::RDG& rdg, bool nodes, const std::vector<std::string>& names) {
+  std::shared_ptr<arrow::Schema> schema =
+      nodes ? rdg.full_node_schema() : rdg.full_edge_schema();
+  for (const std::string& name : names) {
+    if (schema->GetFieldIndex(name) < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no {} property {}",
+          nodes ? "node" : "edge", name);
+    }
+    auto res = nodes ? rdg.EnsureNodePropertyLoaded(name)
+                     : rdg.EnsureEdgePropertyLoaded(name);
+    if (!res) {
+      return res.error();
+    }
+  }
+
+  const std::shared_ptr<arrow::Table>& loaded =
+      nodes ? rdg.loaded_node_properties() : rdg.loaded_edge_properties();
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const std::string& name : names) {
+    int i = loaded->schema()->GetFieldIndex(name);
+    fields.emplace_back(loaded->field(i));
+    columns.emplace_back(loaded->column(i));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, loaded->num_rows());
+}
+
+uint64_t
+ChunkedArrayBytes(const arrow::ChunkedArray& array) {
+  uint64_t bytes = 0;
+  for (const std::shared_ptr<arrow::Array>& chunk : array.chunks()) {
+    bytes += ArrayDataBytes(*chunk->data());
+  }
+  return bytes;
+}
+
+}  // namespace
+
+katana::PropertyGraph::PropertyGraph() = default;
+
+katana::PropertyGraph::PropertyGraph(
+    std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg)
+    : rdg_(std::move(rdg)), file_(std::move(rdg_file)) {}
+
+katana::Result<void>
+katana::PropertyGraph::Validate() {
+  // TODO (thunt) check that arrow table sizes match topology
+  // if (topology_.out_dests &&
+  //    topology_.out_dests->length() != table->num_rows()) {
+  //  return ErrorCode::InvalidArgument;
+  //}
+  // if (topology_.out_indices &&
+  //    topology_.out_indices->length() != table->num_rows()) {
+  //  return ErrorCode::InvalidArgument;
+  //}
+
+  // Lazy properties not loaded yet are checked against these as they load
+  const auto& node_props = rdg_.loaded_node_properties();
+  uint64_t num_node_rows = static_cast<uint64_t>(node_props->num_rows());
+  if (num_node_rows == 0) {
+    if ((node_props->num_columns() != 0) && (num_nodes() != 0)) {
+      return KATANA_ERROR(
+          ErrorCode::AssertionFailed,
+          "number of rows in node properties is 0 but "
+          "the number of node properties is {} and the number of nodes is {}",
+          node_props->num_columns(), num_nodes());
+    }
+  } else if (num_node_rows != num_nodes()) {
+    return KATANA_ERROR(
+        ErrorCode::AssertionFailed,
+        "number of rows in node properties {} differs "
+        "from the number of nodes {}",
+        node_props->num_rows(), num_nodes());
+  }
+
+  const auto& edge_props = rdg_.loaded_edge_properties();
+  uint64_t num_edge_rows = static_cast<uint64_t>(edge_props->num_rows());
+  if (num_edge_rows == 0) {
+    if ((edge_props->num_columns() != 0) && (num_edges() != 0)) {
+      return KATANA_ERROR(
+          ErrorCode::AssertionFailed,
+          "number of rows in edge properties is 0 but "
+          "the number of edge properties is {} and the number of edges is {}",
+          edge_props->num_columns(), num_edges());
+    }
+  } else if (num_edge_rows != num_edges()) {
+    return KATANA_ERROR(
+        ErrorCode::AssertionFailed,
+        "number of rows in edge properties {} differs "
+        "from the number of edges {}",
+        edge_props->num_rows(), num_edges());
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::DoWrite(
+    tsuba::RDGHandle handle, const std::string& command_line) {
+  std::unique_ptr<tsuba::FileFrame> in_ff;
+  if (persist_in_edge_index_ && in_edge_index_ &&
+      !rdg_.in_topology_file_storage().Valid() &&
+      !rdg_.HasStoredInTopology(handle)) {
+    auto result = WriteInEdgeIndex(*in_edge_index_);
+    if (!result) {
+      return result.error().WithContext("writing in-edge index");
+    }
+    in_ff = std::move(result.value());
+  }
+
+  // Rewrite the topology if it is not in storage or if it is stored in a
+  // different format than requested. A topology that an earlier Write stored
+  // is not bound, but the RDG still references its file.
+  const tsuba::FileView& storage = rdg_.topology_file_storage();
+  bool stored = storage.Valid() || rdg_.HasStoredTopology(handle);
+  bool stored_compressed = storage.Valid() ? IsCompressedTopology(storage)
+                                           : stored_topology_compressed_;
+  if (!stored || stored_compressed != compress_topology_) {
+    auto result = compress_topology_ ? WriteCompressedTopology(topology_)
+                                     : WriteTopology(topology_);
+    if (!result) {
+      return result.error();
+    }
+    if (auto res = rdg_.Store(
+            handle, command_line, std::move(result.value()),
+            std::move(in_ff));
+        !res) {
+      return res.error();
+    }
+    stored_topology_compressed_ = compress_topology_;
+    return katana::ResultSuccess();
+  }
+
+  return rdg_.Store(handle, command_line, nullptr, std::move(in_ff));
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::Make(
+    std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg,
+    arrow::MemoryPool* memory_pool) {
+  auto g = std::unique_ptr<PropertyGraph>(
+      new PropertyGraph(std::move(rdg_file), std::move(rdg)));
+
+  arrow::MemoryPool* pool =
+      memory_pool ? memory_pool : arrow::default_memory_pool();
+  auto load_result =
+      LoadTopology(&g->topology_, g->rdg_.topology_file_storage(), pool);
+  if (!load_result) {
+    return load_result.error();
+  }
+  g->compress_topology_ = IsCompressedTopology(g->rdg_.topology_file_storage());
+  g->stored_topology_compressed_ = g->compress_topology_;
+
+  if (memory_pool && !g->compress_topology_) {
+    // The topology is backed by storage; move it into memory from the pool
+    auto copy_res = CopyTopology(g->topology_, memory_pool);
+    if (!copy_res) {
+      return copy_res.error();
+    }
+    g->topology_ = std::move(copy_res.value());
+    if (auto res = g->rdg_.ReleaseTopologyFileStorage(); !res) {
+      return res.error();
+    }
+  }
+
+  if (g->rdg_.in_topology_file_storage().Valid()) {
+    auto in_res = MapInEdgeIndex(g->rdg_.in_topology_file_storage());
+    if (!in_res) {
+      return in_res.error().WithContext("loading in-edge index");
+    }
+    katana::InEdgeIndex& index = in_res.value();
+    if (index.num_nodes() != g->num_nodes() ||
+        index.num_edges() != g->num_edges()) {
+      KATANA_LOG_WARN(
+          "ignoring stale in-edge index with {} nodes and {} edges",
+          index.num_nodes(), index.num_edges());
+      if (auto res = g->rdg_.UnbindInTopologyFileStorage(); !res) {
+        return res.error();
+      }
+    } else {
+      g->in_edge_index_ = std::make_shared<InEdgeIndex>(std::move(index));
+      g->persist_in_edge_index_ = true;
+    }
+  }
+
+  if (auto good = g->Validate(); !good) {
+    return good.error();
   }
   return std::unique_ptr<PropertyGraph>(std::move(g));
 }
@@ -428,6 +1360,71 @@ katana::PropertyGraph::Make(
       std::make_unique<tsuba::RDGFile>(handle.value()), opts);
 }
 
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::MakeFromAllPartitions(
+    const std::string& rdg_name, const tsuba::RDGLoadOptions& opts) {
+  auto stat_res = tsuba::Stat(rdg_name);
+  if (!stat_res) {
+    return stat_res.error();
+  }
+  uint32_t num_parts = stat_res.value().num_partitions;
+  if (num_parts <= 1) {
+    tsuba::RDGLoadOptions part_opts = opts;
+    part_opts.partition_id_to_load = 0;
+    return Make(rdg_name, part_opts);
+  }
+
+  std::vector<tsuba::RDGHandle> handles;
+  for (uint32_t p = 0; p < num_parts; ++p) {
+    auto handle = tsuba::Open(rdg_name, tsuba::kReadWrite);
+    if (!handle) {
+      return handle.error();
+    }
+    handles.emplace_back(handle.value());
+  }
+
+  // Partitions load in parallel, each on its own thread so that the NUMA
+  // node of the thread holds what it touches first
+  std::vector<std::unique_ptr<PropertyGraph>> parts(num_parts);
+  std::vector<std::optional<CopyableErrorInfo>> errors(num_parts);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_parts),
+      [&](uint32_t p) {
+        tsuba::RDGLoadOptions part_opts = opts;
+        part_opts.partition_id_to_load = p;
+        auto res = MakePropertyGraph(
+            std::make_unique<tsuba::RDGFile>(handles[p]), part_opts);
+        if (!res) {
+          errors[p].emplace(res.error());
+          return;
+        }
+        parts[p] = std::move(res.value());
+      },
+      katana::chunk_size<1>(), katana::no_stats(),
+      katana::loopname("MakeFromAllPartitions"));
+  for (uint32_t p = 0; p < num_parts; ++p) {
+    if (errors[p]) {
+      return KATANA_ERROR(
+          errors[p]->error_code(), "loading partition {}: {}", p, *errors[p]);
+    }
+  }
+
+  std::vector<uint64_t> num_owned(num_parts);
+  uint64_t total_owned = 0;
+  for (uint32_t p = 0; p < num_parts; ++p) {
+    num_owned[p] = parts[p]->partition_metadata().num_owned_;
+    total_owned += num_owned[p];
+  }
+  uint64_t num_global_nodes = parts[0]->partition_metadata().num_global_nodes_;
+  if (total_owned != num_global_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "partitions own {} nodes of the {} of the graph", total_owned,
+        num_global_nodes);
+  }
+  return CombinePartitions(parts, num_owned, opts.memory_pool);
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Copy() const {
   return Copy(node_schema()->field_names(), edge_schema()->field_names());
@@ -437,13 +1434,65 @@ katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Copy(
     const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties) const {
-  // TODO(gill): This should copy the RDG in memory without reloading from storage.
-  tsuba::RDGLoadOptions opts;
-  opts.partition_id_to_load = partition_id();
-  opts.node_properties = &node_properties;
-  opts.edge_properties = &edge_properties;
+  auto node_props = SelectProperties(rdg_, true, node_properties);
+  if (!node_props) {
+    return node_props.error().WithContext("copying node properties");
+  }
+  auto edge_props = SelectProperties(rdg_, false, edge_properties);
+  if (!edge_props) {
+    return edge_props.error().WithContext("copying edge properties");
+  }
+
+  auto g = std::make_unique<PropertyGraph>();
+  const tsuba::FileView& storage = rdg_.topology_file_storage();
+  if (storage.Valid() && !IsCompressedTopology(storage)) {
+    // The topology is backed by the storage of rdg_, which may be released
+    // before the copy is
+    auto copy_res = CopyTopology(topology_, arrow::default_memory_pool());
+    if (!copy_res) {
+      return copy_res.error();
+    }
+    if (auto res = g->SetTopology(copy_res.value()); !res) {
+      return res.error();
+    }
+  } else {
+    if (auto res = g->SetTopology(topology_); !res) {
+      return res.error();
+    }
+    if (!rdg_.in_topology_file_storage().Valid()) {
+      g->in_edge_index_ = in_edge_index_;
+    }
+    g->edge_existence_index_ = edge_existence_index_;
+  }
+  g->rdg_.set_topology_sorted_by_dest(edges_sorted_by_dest());
+  g->persist_in_edge_index_ = persist_in_edge_index_;
+  g->compress_topology_ = compress_topology_;
+
+  if (auto res = g->AddNodeProperties(node_props.value()); !res) {
+    return res.error();
+  }
+  if (auto res = g->AddEdgeProperties(edge_props.value()); !res) {
+    return res.error();
+  }
 
-  return Make(rdg_dir(), opts);
+  // The partition arrays are immutable like the properties
+  g->rdg_.set_partition_id(partition_id());
+  g->rdg_.set_part_metadata(rdg_.part_metadata());
+  g->rdg_.set_write_opts(rdg_.write_opts());
+  auto master_nodes = rdg_.master_nodes();
+  g->rdg_.set_master_nodes(std::move(master_nodes));
+  auto mirror_nodes = rdg_.mirror_nodes();
+  g->rdg_.set_mirror_nodes(std::move(mirror_nodes));
+  auto host_to_owned_nodes = rdg_.host_to_owned_global_node_ids();
+  g->rdg_.set_host_to_owned_global_node_ids(std::move(host_to_owned_nodes));
+  auto host_to_owned_edges = rdg_.host_to_owned_global_edge_ids();
+  g->rdg_.set_host_to_owned_global_edge_ids(std::move(host_to_owned_edges));
+  auto local_to_user_id = rdg_.local_to_user_id();
+  g->rdg_.set_local_to_user_id(std::move(local_to_user_id));
+  auto local_to_global_id = rdg_.local_to_global_id();
+  g->rdg_.set_local_to_global_id(std::move(local_to_global_id));
+
+  return std::unique_ptr<PropertyGraph>(std::move(g));
 }
 
 katana::Result<void>
@@ -457,15 +1506,36 @@ katana::PropertyGraph::ConstructTypeSetIDs() {
         "ConstructTypeSetIDs() should not called more than once");
   }
 
+  // Types are the bool and uint8 properties, so load those that are lazy
+  auto is_type = [](const std::shared_ptr<arrow::Field>& field) {
+    return field->type()->id() == arrow::Type::BOOL ||
+           field->type()->id() == arrow::Type::UINT8;
+  };
+  for (const auto& field : node_schema()->fields()) {
+    if (is_type(field)) {
+      if (auto res = rdg_.EnsureNodePropertyLoaded(field->name()); !res) {
+        return res.error().WithContext("loading node type");
+      }
+    }
+  }
+  for (const auto& field : edge_schema()->fields()) {
+    if (is_type(field)) {
+      if (auto res = rdg_.EnsureEdgePropertyLoaded(field->name()); !res) {
+        return res.error().WithContext("loading edge type");
+      }
+    }
+  }
+
   static_assert(kUnknownType == 0);
   node_type_set_id_to_type_names_.push_back(
       {});  // for kUnknownType: assumes it is 0
-  uint64_t num_node_rows = static_cast<uint64_t>(node_properties()->num_rows());
+  const auto& node_props = rdg_.loaded_node_properties();
+  uint64_t num_node_rows = static_cast<uint64_t>(node_props->num_rows());
   if (num_node_rows == 0) {
     node_type_set_id_ = GetUnknownTypeSetIDs(num_nodes());
   } else {
     auto node_types_res = GetTypeSetIDsFromProperties(
-        node_properties(), &node_type_name_to_type_set_ids_,
+        node_props, &node_type_name_to_type_set_ids_,
         &node_type_set_id_to_type_names_);
     if (!node_types_res) {
       return node_types_res.error().WithContext("node properties");
@@ -476,12 +1546,13 @@ katana::PropertyGraph::ConstructTypeSetIDs() {
   static_assert(kUnknownType == 0);
   edge_type_set_id_to_type_names_.push_back(
       {});  // for kUnknownType: assumes it is 0
-  uint64_t num_edge_rows = static_cast<uint64_t>(edge_properties()->num_rows());
+  const auto& edge_props = rdg_.loaded_edge_properties();
+  uint64_t num_edge_rows = static_cast<uint64_t>(edge_props->num_rows());
   if (num_edge_rows == 0) {
     edge_type_set_id_ = GetUnknownTypeSetIDs(num_edges());
   } else {
     auto edge_types_res = GetTypeSetIDsFromProperties(
-        edge_properties(), &edge_type_name_to_type_set_ids_,
+        edge_props, &edge_type_name_to_type_set_ids_,
         &edge_type_set_id_to_type_names_);
     if (!edge_types_res) {
       return edge_types_res.error().WithContext("edge properties");
@@ -522,6 +1593,191 @@ katana::PropertyGraph::Commit(const std::string& command_line) {
   return DoWrite(*file_, command_line);
 }
 
+katana::Result<void>
+katana::PropertyGraph::Commit(
+    const std::string& command_line,
+    const tsuba::ParquetWriter::WriteOpts& opts) {
+  tsuba::ParquetWriter::WriteOpts old_opts = rdg_.write_opts();
+  rdg_.set_write_opts(opts);
+  auto res = Commit(command_line);
+  rdg_.set_write_opts(old_opts);
+  return res;
+}
+
+std::shared_ptr<const tsuba::RDGSnapshot>
+katana::PropertyGraph::PropertySnapshot() const {
+  if (auto res = rdg_.EnsurePropertiesLoaded(); !res) {
+    KATANA_LOG_ERROR("loading lazy properties: {}", res.error());
+  }
+  return rdg_.Snapshot();
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+katana::PropertyGraph::GetNodeProperty(const std::string& name) const {
+  if (auto res = rdg_.EnsureNodePropertyLoaded(name); !res) {
+    KATANA_LOG_ERROR("loading node property {}: {}", name, res.error());
+    return nullptr;
+  }
+  std::shared_ptr<arrow::ChunkedArray> property =
+      rdg_.loaded_node_properties()->GetColumnByName(name);
+  if (property) {
+    UseProperties(true, {name});
+  }
+  return property;
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+katana::PropertyGraph::GetEdgeProperty(const std::string& name) const {
+  if (auto res = rdg_.EnsureEdgePropertyLoaded(name); !res) {
+    KATANA_LOG_ERROR("loading edge property {}: {}", name, res.error());
+    return nullptr;
+  }
+  std::shared_ptr<arrow::ChunkedArray> property =
+      rdg_.loaded_edge_properties()->GetColumnByName(name);
+  if (property) {
+    UseProperties(false, {name});
+  }
+  return property;
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+katana::PropertyGraph::PinNodeProperty(const std::string& name) const {
+  return PinProperty(true, name, GetNodeProperty(name));
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+katana::PropertyGraph::PinEdgeProperty(const std::string& name) const {
+  return PinProperty(false, name, GetEdgeProperty(name));
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+katana::PropertyGraph::PinProperty(
+    bool nodes, const std::string& name,
+    std::shared_ptr<arrow::ChunkedArray> property) const {
+  if (!property) {
+    return nullptr;
+  }
+  auto& pins = nodes ? property_pins_->nodes : property_pins_->edges;
+  pins[name] += 1;
+
+  // The pin shares ownership of the property, and when its last copy is
+  // destroyed it drops the count, unless the graph is gone
+  arrow::ChunkedArray* array = property.get();
+  std::weak_ptr<PropertyPins> weak_pins = property_pins_;
+  return std::shared_ptr<arrow::ChunkedArray>(
+      array, [weak_pins, nodes, name,
+              property = std::move(property)](arrow::ChunkedArray*) mutable {
+        property.reset();
+        std::shared_ptr<PropertyPins> all_pins = weak_pins.lock();
+        if (!all_pins) {
+          return;
+        }
+        auto& pins = nodes ? all_pins->nodes : all_pins->edges;
+        if (auto it = pins.find(name); it != pins.end() && --it->second == 0) {
+          pins.erase(it);
+        }
+      });
+}
+
+katana::Result<void>
+katana::PropertyGraph::SetPropertyMemoryBudget(
+    uint64_t max_bytes, const std::string& spill_dir) {
+  auto uri_res = katana::Uri::Make(spill_dir);
+  if (!uri_res) {
+    return uri_res.error();
+  }
+  property_memory_budget_ = max_bytes;
+  spill_dir_ = std::move(uri_res.value());
+  return EnforcePropertyMemoryBudget();
+}
+
+uint64_t
+katana::PropertyGraph::loaded_property_bytes() const {
+  uint64_t bytes = 0;
+  for (const auto& table :
+       {rdg_.loaded_node_properties(), rdg_.loaded_edge_properties()}) {
+    for (const auto& column : table->columns()) {
+      bytes += ChunkedArrayBytes(*column);
+    }
+  }
+  return bytes;
+}
+
+void
+katana::PropertyGraph::UseProperties(
+    bool nodes, const std::vector<std::string>& names) const {
+  if (property_memory_budget_ == 0) {
+    return;
+  }
+  auto& uses = nodes ? node_property_uses_ : edge_property_uses_;
+  for (const std::string& name : names) {
+    uses[name] = ++property_clock_;
+  }
+  if (auto res = EnforcePropertyMemoryBudget(); !res) {
+    KATANA_LOG_WARN("evicting properties over budget: {}", res.error());
+  }
+}
+
+katana::Result<void>
+katana::PropertyGraph::EnforcePropertyMemoryBudget() const {
+  if (property_memory_budget_ == 0) {
+    return katana::ResultSuccess();
+  }
+  struct Loaded {
+    uint64_t last_use;
+    bool node;
+    std::string name;
+    uint64_t bytes;
+    bool pinned;
+  };
+  std::vector<Loaded> loaded;
+  uint64_t total = 0;
+  for (bool nodes : {true, false}) {
+    const auto& table = nodes ? rdg_.loaded_node_properties()
+                              : rdg_.loaded_edge_properties();
+    const auto& uses = nodes ? node_property_uses_ : edge_property_uses_;
+    const auto& pins = nodes ? property_pins_->nodes : property_pins_->edges;
+    for (int i = 0, n = table->num_columns(); i < n; ++i) {
+      const std::string& name = table->field(i)->name();
+      auto use = uses.find(name);
+      uint64_t bytes = ChunkedArrayBytes(*table->column(i));
+      total += bytes;
+      loaded.emplace_back(Loaded{
+          .last_use = use == uses.end() ? 0 : use->second,
+          .node = nodes,
+          .name = name,
+          .bytes = bytes,
+          .pinned = pins.count(name) > 0,
+      });
+    }
+  }
+  if (total <= property_memory_budget_) {
+    return katana::ResultSuccess();
+  }
+
+  std::sort(loaded.begin(), loaded.end(), [](const auto& a, const auto& b) {
+    return a.last_use < b.last_use;
+  });
+  // The most recently used property stays loaded
+  loaded.pop_back();
+  for (const Loaded& property : loaded) {
+    if (total <= property_memory_budget_) {
+      break;
+    }
+    if (property.pinned) {
+      continue;
+    }
+    auto res = property.node
+                   ? rdg_.EvictNodeProperty(property.name, spill_dir_)
+                   : rdg_.EvictEdgeProperty(property.name, spill_dir_);
+    if (!res) {
+      return res.error().WithContext("evicting {}", property.name);
+    }
+    total -= property.bytes;
+  }
+  return katana::ResultSuccess();
+}
+
 bool
 katana::PropertyGraph::Equals(const PropertyGraph* other) const {
   if (!topology().Equals(other->topology())) {
@@ -645,7 +1901,15 @@ katana::PropertyGraph::AddNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology_.out_indices->length(), props->num_rows());
   }
-  return rdg_.AddNodeProperties(props);
+  auto combined = CombinePropertyChunks(props, rdg_.memory_pool());
+  if (!combined) {
+    return combined.error();
+  }
+  if (auto res = rdg_.AddNodeProperties(combined.value()); !res) {
+    return res.error();
+  }
+  UseProperties(true, props->ColumnNames());
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -661,7 +1925,15 @@ katana::PropertyGraph::UpsertNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology_.out_indices->length(), props->num_rows());
   }
-  return rdg_.UpsertNodeProperties(props);
+  auto combined = CombinePropertyChunks(props, rdg_.memory_pool());
+  if (!combined) {
+    return combined.error();
+  }
+  if (auto res = rdg_.UpsertNodeProperties(combined.value()); !res) {
+    return res.error();
+  }
+  UseProperties(true, props->ColumnNames());
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -671,10 +1943,9 @@ katana::PropertyGraph::RemoveNodeProperty(int i) {
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(const std::string& prop_name) {
-  auto col_names = node_properties()->ColumnNames();
-  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
-  if (pos != col_names.cend()) {
-    return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
+  int i = node_schema()->GetFieldIndex(prop_name);
+  if (i >= 0) {
+    return rdg_.RemoveNodeProperty(i);
   }
   return katana::ErrorCode::PropertyNotFound;
 }
@@ -692,7 +1963,15 @@ katana::PropertyGraph::AddEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology_.out_dests->length(), props->num_rows());
   }
-  return rdg_.AddEdgeProperties(props);
+  auto combined = CombinePropertyChunks(props, rdg_.memory_pool());
+  if (!combined) {
+    return combined.error();
+  }
+  if (auto res = rdg_.AddEdgeProperties(combined.value()); !res) {
+    return res.error();
+  }
+  UseProperties(false, props->ColumnNames());
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -708,7 +1987,15 @@ katana::PropertyGraph::UpsertEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology_.out_dests->length(), props->num_rows());
   }
-  return rdg_.UpsertEdgeProperties(props);
+  auto combined = CombinePropertyChunks(props, rdg_.memory_pool());
+  if (!combined) {
+    return combined.error();
+  }
+  if (auto res = rdg_.UpsertEdgeProperties(combined.value()); !res) {
+    return res.error();
+  }
+  UseProperties(false, props->ColumnNames());
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -718,10 +2005,9 @@ katana::PropertyGraph::RemoveEdgeProperty(int i) {
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
-  auto col_names = edge_properties()->ColumnNames();
-  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
-  if (pos != col_names.cend()) {
-    return rdg_.RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
+  int i = edge_schema()->GetFieldIndex(prop_name);
+  if (i >= 0) {
+    return rdg_.RemoveEdgeProperty(i);
   }
   return katana::ErrorCode::PropertyNotFound;
 }
@@ -732,7 +2018,282 @@ katana::PropertyGraph::SetTopology(const katana::GraphTopology& topology) {
     return res.error();
   }
   topology_ = topology;
+  in_edge_index_.reset();
+  edge_type_index_.reset();
+  edge_existence_index_.reset();
+  temporal_edge_index_.reset();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::ApplyDeltaTopology(katana::DeltaTopology* delta) {
+  if (delta->base().out_indices != topology_.out_indices ||
+      delta->base().out_dests != topology_.out_dests) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "delta was not made from the topology of this graph");
+  }
 
+  auto ids_res = delta->Compact();
+  if (!ids_res) {
+    return ids_res.error();
+  }
+  std::shared_ptr<arrow::UInt64Array> ids = std::move(ids_res.value());
+
+  std::shared_ptr<arrow::Table> props;
+  if (edge_properties()->num_columns() > 0) {
+    auto take_res = arrow::compute::Take(
+        arrow::Datum(edge_properties()), arrow::Datum(ids));
+    if (!take_res.ok()) {
+      return KATANA_ERROR(
+          ArrowToKatana(take_res.status()), "taking edge properties: {}",
+          take_res.status());
+    }
+    props = take_res.ValueOrDie().table();
+  }
+
+  if (edge_type_set_id_.size() == num_edges()) {
+    katana::LargeArray<TypeSetID> types;
+    types.allocateBlocked(ids->length());
+    katana::do_all(
+        katana::iterate(int64_t{0}, ids->length()),
+        [&](int64_t e) {
+          types[e] = ids->IsValid(e) ? edge_type_set_id_[ids->Value(e)]
+                                     : kUnknownType;
+        },
+        katana::no_stats());
+    edge_type_set_id_ = std::move(types);
+  }
+
+  if (auto res = SetTopology(delta->base()); !res) {
+    return res.error();
+  }
+  rdg_.set_topology_sorted_by_dest(false);
+
+  if (props) {
+    if (auto res = UpsertEdgeProperties(props); !res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::ApplyNodePermutation(const NodePermutation& perm) {
+  uint64_t num_nodes = topology_.num_nodes();
+  uint64_t num_edges = topology_.num_edges();
+  if (perm.size() != num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "permutation of {} nodes for a graph of {} nodes", perm.size(),
+        num_nodes);
+  }
+
+  auto indices_res = AllocateTopologyBuffer(num_nodes * sizeof(uint64_t));
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res = AllocateTopologyBuffer(num_edges * sizeof(uint32_t));
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto ids_res = AllocateTopologyBuffer(num_edges * sizeof(uint64_t));
+  if (!ids_res) {
+    return ids_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buf = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> dests_buf = std::move(dests_res.value());
+  std::shared_ptr<arrow::Buffer> ids_buf = std::move(ids_res.value());
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buf->mutable_data());
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buf->mutable_data());
+  auto* ids = reinterpret_cast<uint64_t*>(ids_buf->mutable_data());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { indices[n] = topology_.edges(perm.OldId(n)).size(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+
+  // ids[e] is the id in the old topology of new edge e
+  const uint32_t* old_dests = topology_.edge_dests();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t out = n == 0 ? 0 : indices[n - 1];
+        for (auto e : topology_.edges(perm.OldId(n))) {
+          dests[out] = perm.NewId(old_dests[e]);
+          ids[out] = e;
+          ++out;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  auto edge_ids = std::make_shared<arrow::UInt64Array>(num_edges, ids_buf);
+
+  std::shared_ptr<arrow::Table> node_props;
+  if (node_properties()->num_columns() > 0) {
+    auto take_res = TakeRows(node_properties(), perm.old_ids());
+    if (!take_res) {
+      return take_res.error().WithContext("taking node properties");
+    }
+    node_props = std::move(take_res.value());
+  }
+  std::shared_ptr<arrow::Table> edge_props;
+  if (edge_properties()->num_columns() > 0) {
+    auto take_res = TakeRows(edge_properties(), edge_ids);
+    if (!take_res) {
+      return take_res.error().WithContext("taking edge properties");
+    }
+    edge_props = std::move(take_res.value());
+  }
+
+  if (node_type_set_id_.size() == num_nodes) {
+    katana::LargeArray<TypeSetID> types;
+    types.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { types[n] = node_type_set_id_[perm.OldId(n)]; },
+        katana::no_stats());
+    node_type_set_id_ = std::move(types);
+  }
+  if (edge_type_set_id_.size() == num_edges) {
+    katana::LargeArray<TypeSetID> types;
+    types.allocateBlocked(num_edges);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_edges),
+        [&](uint64_t e) { types[e] = edge_type_set_id_[ids[e]]; },
+        katana::no_stats());
+    edge_type_set_id_ = std::move(types);
+  }
+
+  if (auto res = SetTopology(katana::GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_nodes, indices_buf),
+          .out_dests =
+              std::make_shared<arrow::UInt32Array>(num_edges, dests_buf),
+      });
+      !res) {
+    return res.error();
+  }
+  rdg_.set_topology_sorted_by_dest(false);
+
+  if (node_props) {
+    if (auto res = UpsertNodeProperties(node_props); !res) {
+      return res.error();
+    }
+  }
+  if (edge_props) {
+    if (auto res = UpsertEdgeProperties(edge_props); !res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<const katana::InEdgeIndex>>
+katana::PropertyGraph::GetInEdgeIndex() {
+  if (!in_edge_index_) {
+    auto res = MakeInEdgeIndex(topology_);
+    if (!res) {
+      return res.error();
+    }
+    in_edge_index_ = std::move(res.value());
+  }
+  return in_edge_index_;
+}
+
+katana::Result<std::shared_ptr<const katana::EdgeTypeIndex>>
+katana::PropertyGraph::GetEdgeTypeIndex() {
+  if (!edge_type_index_) {
+    auto res = MakeEdgeTypeIndex(*this);
+    if (!res) {
+      return res.error();
+    }
+    edge_type_index_ = std::move(res.value());
+  }
+  return edge_type_index_;
+}
+
+katana::Result<std::shared_ptr<const katana::EdgeExistenceIndex>>
+katana::PropertyGraph::GetEdgeExistenceIndex(uint64_t min_degree) {
+  if (!edge_existence_index_ ||
+      edge_existence_index_->min_degree != min_degree) {
+    auto res = MakeEdgeExistenceIndex(*this, min_degree);
+    if (!res) {
+      return res.error();
+    }
+    edge_existence_index_ = std::move(res.value());
+  }
+  return edge_existence_index_;
+}
+
+katana::Result<std::shared_ptr<const katana::TemporalEdgeIndex>>
+katana::PropertyGraph::GetTemporalEdgeIndex(
+    const std::string& timestamp_property_name) {
+  auto column = GetEdgeProperty(timestamp_property_name);
+  if (!column) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no edge property {}",
+        timestamp_property_name);
+  }
+  if (!temporal_edge_index_ ||
+      temporal_edge_index_->timestamp_property_name !=
+          timestamp_property_name ||
+      temporal_edge_index_->source.lock() != column) {
+    auto res = MakeTemporalEdgeIndex(*this, timestamp_property_name);
+    if (!res) {
+      return res.error();
+    }
+    temporal_edge_index_ = std::move(res.value());
+  }
+  return temporal_edge_index_;
+}
+
+katana::Result<void>
+katana::PropertyGraph::DropInEdgeIndex() {
+  in_edge_index_.reset();
+  return rdg_.UnbindInTopologyFileStorage();
+}
+
+katana::Result<void>
+katana::PropertyGraph::MarkTopologyModified(bool sorted_by_dest) {
+  in_edge_index_.reset();
+  edge_type_index_.reset();
+  edge_existence_index_.reset();
+  temporal_edge_index_.reset();
+  if (IsCompressedTopology(rdg_.topology_file_storage())) {
+    // topology_ was decoded into memory of its own, so storage can be
+    // released; the next Write encodes topology_ again
+    if (auto res = rdg_.UnbindTopologyFileStorage(); !res) {
+      return res.error();
+    }
+  } else if (auto res = rdg_.MarkTopologyModified(); !res) {
+    return res.error();
+  }
+  rdg_.set_topology_sorted_by_dest(sorted_by_dest);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::EnsureTopologyUnshared() {
+  // The edge existence index holds the topology, and modifying the topology
+  // drops it anyway
+  edge_existence_index_.reset();
+  // Other graphs share the topology by holding the same arrays
+  if (num_nodes() == 0 || (topology_.out_indices.use_count() <= 1 &&
+                           topology_.out_dests.use_count() <= 1)) {
+    return katana::ResultSuccess();
+  }
+  auto copy_res = CopyTopology(topology_, arrow::default_memory_pool());
+  if (!copy_res) {
+    return copy_res.error();
+  }
+  bool sorted_by_dest = edges_sorted_by_dest();
+  if (auto res = SetTopology(copy_res.value()); !res) {
+    return res.error();
+  }
+  rdg_.set_topology_sorted_by_dest(sorted_by_dest);
   return katana::ResultSuccess();
 }
 
@@ -752,6 +2313,13 @@ katana::PropertyGraph::InformPath(const std::string& input_path) {
 
 katana::Result<std::shared_ptr<arrow::UInt64Array>>
 katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
+  if (!pg->edges_sorted_by_dest()) {
+    // The destinations are sorted in place
+    if (auto r = pg->EnsureTopologyUnshared(); !r) {
+      return r.error();
+    }
+  }
+
   auto view_result_dests =
       katana::ConstructPropertyView<katana::UInt32Property>(
           pg->topology().out_dests.get());
@@ -774,22 +2342,29 @@ katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
   std::iota(
       permutation_vec_data,
       permutation_vec_data + permutation_vec_builder.capacity(), uint64_t{0});
-  auto comparator = [&](uint64_t a, uint64_t b) {
-    return out_dests_view[a] < out_dests_view[b];
-  };
 
-  katana::do_all(
-      katana::iterate(uint64_t{0}, pg->topology().num_nodes()),
-      [&](uint64_t n) {
-        auto edge_range = pg->topology().edge_range(n);
-        std::sort(
-            permutation_vec_data + edge_range.first,
-            permutation_vec_data + edge_range.second, comparator);
-        std::sort(
-            &out_dests_view[0] + edge_range.first,
-            &out_dests_view[0] + edge_range.second);
-      },
-      katana::steal());
+  if (!pg->edges_sorted_by_dest()) {
+    auto comparator = [&](uint64_t a, uint64_t b) {
+      return out_dests_view[a] < out_dests_view[b];
+    };
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, pg->topology().num_nodes()),
+        [&](uint64_t n) {
+          auto edge_range = pg->topology().edge_range(n);
+          std::sort(
+              permutation_vec_data + edge_range.first,
+              permutation_vec_data + edge_range.second, comparator);
+          std::sort(
+              &out_dests_view[0] + edge_range.first,
+              &out_dests_view[0] + edge_range.second);
+        },
+        katana::steal());
+
+    if (auto r = pg->MarkTopologyModified(true); !r) {
+      return r.error();
+    }
+  }
 
   if (auto r = permutation_vec_builder.Advance(pg->topology().num_edges());
       !r.ok()) {
@@ -804,120 +2379,40 @@ katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
   }
 }
 
+katana::Result<void>
+katana::EnsureAllEdgesSortedByDest(katana::PropertyGraph* pg) {
+  if (pg->edges_sorted_by_dest()) {
+    return katana::ResultSuccess();
+  }
+  if (auto r = SortAllEdgesByDest(pg); !r) {
+    return r.error();
+  }
+  return katana::ResultSuccess();
+}
+
 katana::GraphTopology::Edge
 katana::FindEdgeSortedByDest(
     const PropertyGraph* graph, GraphTopology::Node node,
     GraphTopology::Node node_to_find) {
-  auto view_result_dests =
-      katana::ConstructPropertyView<katana::UInt32Property>(
-          graph->topology().out_dests.get());
-  if (!view_result_dests) {
-    KATANA_LOG_FATAL(
-        "Unable to construct property view on topology destinations : {}",
-        view_result_dests.error());
+  if (const EdgeExistenceIndex* index = graph->edge_existence_index()) {
+    return index->FindEdge(node, node_to_find);
   }
 
-  auto out_dests_view = std::move(view_result_dests.value());
-
-  auto edge_range = graph->topology().edge_range(node);
-  using edge_iterator = boost::counting_iterator<uint64_t>;
-  auto edge_matched = std::lower_bound(
-      edge_iterator(edge_range.first), edge_iterator(edge_range.second),
-      node_to_find,
-      [=](edge_iterator e, uint32_t n) { return out_dests_view[*e] < n; });
-
-  return (
-      out_dests_view[*edge_matched] == node_to_find ? *edge_matched
-                                                    : edge_range.second);
+  auto [begin, end] = graph->topology().edge_range(node);
+  const GraphTopology::Node* dests = graph->topology().edge_dests();
+  const GraphTopology::Node* matched =
+      std::lower_bound(dests + begin, dests + end, node_to_find);
+  return matched != dests + end && *matched == node_to_find ? matched - dests
+                                                             : end;
 }
 
 katana::Result<void>
 katana::SortNodesByDegree(katana::PropertyGraph* pg) {
-  uint64_t num_nodes = pg->topology().num_nodes();
-  uint64_t num_edges = pg->topology().num_edges();
-
-  using DegreeNodePair = std::pair<uint64_t, uint32_t>;
-  std::vector<DegreeNodePair> dn_pairs(num_nodes);
-  katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](size_t node) {
-    size_t node_degree = pg->edges(node).size();
-    dn_pairs[node] = DegreeNodePair(node_degree, node);
-  });
-
-  // sort by degree (first item)
-  katana::ParallelSTL::sort(
-      dn_pairs.begin(), dn_pairs.end(), std::greater<DegreeNodePair>());
-
-  // create mapping, get degrees out to another vector to get prefix sum
-  std::vector<uint32_t> old_to_new_mapping(num_nodes);
-  katana::LargeArray<uint64_t> new_prefix_sum;
-  new_prefix_sum.allocateBlocked(num_nodes);
-  katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](uint64_t index) {
-    // save degree, which is pair.first
-    new_prefix_sum[index] = dn_pairs[index].first;
-    // save mapping; original index is in .second, map it to current index
-    old_to_new_mapping[dn_pairs[index].second] = index;
-  });
-
-  katana::ParallelSTL::partial_sum(
-      new_prefix_sum.begin(), new_prefix_sum.end(), new_prefix_sum.begin());
-
-  katana::LargeArray<uint32_t> new_out_dest;
-  new_out_dest.allocateBlocked(num_edges);
-
-  auto view_result_indices =
-      ConstructPropertyView<UInt64Property>(pg->topology().out_indices.get());
-  if (!view_result_indices) {
-    return view_result_indices.error();
+  auto perm_res = ComputeNodeOrder(*pg, NodeOrder::kDegree);
+  if (!perm_res) {
+    return perm_res.error();
   }
-
-  auto out_indices_view = std::move(view_result_indices.value());
-
-  auto view_result_dests =
-      ConstructPropertyView<UInt32Property>(pg->topology().out_dests.get());
-  if (!view_result_dests) {
-    return view_result_dests.error();
-  }
-
-  auto out_dests_view = std::move(view_result_dests.value());
-
-  katana::do_all(
-      katana::iterate(uint64_t{0}, num_nodes),
-      [&](uint32_t old_node_id) {
-        uint32_t new_node_id = old_to_new_mapping[old_node_id];
-
-        // get the start location of this reindex'd nodes edges
-        uint64_t new_out_index =
-            (new_node_id == 0) ? 0 : new_prefix_sum[new_node_id - 1];
-
-        // construct the graph, reindexing as it goes along
-        auto node_edge_range = pg->topology().edge_range(old_node_id);
-        for (auto e = node_edge_range.first; e != node_edge_range.second; ++e) {
-          // get destination, reindex
-          uint32_t old_edge_dest = out_dests_view[e];
-          uint32_t new_edge_dest = old_to_new_mapping[old_edge_dest];
-
-          new_out_dest[new_out_index] = new_edge_dest;
-
-          new_out_index++;
-        }
-        // this assert makes sure reindex was correct + makes sure all edges
-        // are accounted for
-        KATANA_LOG_DEBUG_ASSERT(new_out_index == new_prefix_sum[new_node_id]);
-      },
-      katana::steal());
-
-  //Update the underlying PropertyGraph topology
-  katana::do_all(
-      katana::iterate(uint64_t{0}, num_nodes), [&](uint32_t node_id) {
-        out_indices_view[node_id] = new_prefix_sum[node_id];
-      });
-
-  katana::do_all(
-      katana::iterate(uint64_t{0}, num_edges), [&](uint32_t edge_id) {
-        out_dests_view[edge_id] = new_out_dest[edge_id];
-      });
-
-  return katana::ResultSuccess();
+  return pg->ApplyNodePermutation(perm_res.value());
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -1112,3 +2607,374 @@ katana::CreateTransposeGraphTopology(
 
   return std::unique_ptr<PropertyGraph>(std::move(transpose));
 }
+
+katana::Result<std::shared_ptr<katana::InEdgeIndex>>
+katana::MakeInEdgeIndex(const GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  auto indices_res = AllocateTopologyBuffer(num_nodes * sizeof(uint64_t));
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto srcs_res = AllocateTopologyBuffer(num_edges * sizeof(uint32_t));
+  if (!srcs_res) {
+    return srcs_res.error();
+  }
+  auto edge_ids_res = AllocateTopologyBuffer(num_edges * sizeof(uint64_t));
+  if (!edge_ids_res) {
+    return edge_ids_res.error();
+  }
+
+  std::shared_ptr<arrow::Buffer> indices_buf = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> srcs_buf = std::move(srcs_res.value());
+  std::shared_ptr<arrow::Buffer> edge_ids_buf = std::move(edge_ids_res.value());
+
+  auto* in_indices = reinterpret_cast<uint64_t*>(indices_buf->mutable_data());
+  auto* in_srcs = reinterpret_cast<uint32_t*>(srcs_buf->mutable_data());
+  auto* edge_ids = reinterpret_cast<uint64_t*>(edge_ids_buf->mutable_data());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_indices[n] = 0; }, katana::no_stats());
+
+  // Count incoming edges of each node
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        __sync_add_and_fetch(&in_indices[topology.edge_dest(e)], 1);
+      },
+      katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      in_indices, in_indices + num_nodes, in_indices);
+
+  katana::LargeArray<uint64_t> cursor;
+  cursor.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cursor[n] = n == 0 ? 0 : in_indices[n - 1]; },
+      katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t src) {
+        for (auto e : topology.edges(src)) {
+          auto dest = topology.edge_dest(e);
+          auto pos = __sync_fetch_and_add(&cursor[dest], 1);
+          in_srcs[pos] = src;
+          edge_ids[pos] = e;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // Slots were claimed in arbitrary order. Edge ids are ordered by source in
+  // the original topology, so sorting the sources and the edge ids of each
+  // node independently keeps them paired and makes the index deterministic.
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n == 0 ? 0 : in_indices[n - 1];
+        uint64_t end = in_indices[n];
+        std::sort(in_srcs + begin, in_srcs + end);
+        std::sort(edge_ids + begin, edge_ids + end);
+      },
+      katana::steal(), katana::no_stats());
+
+  return std::make_shared<InEdgeIndex>(InEdgeIndex{
+      .topology =
+          GraphTopology{
+              .out_indices =
+                  std::make_shared<arrow::UInt64Array>(num_nodes, indices_buf),
+              .out_dests =
+                  std::make_shared<arrow::UInt32Array>(num_edges, srcs_buf),
+          },
+      .out_edge_ids =
+          std::make_shared<arrow::UInt64Array>(num_edges, edge_ids_buf),
+  });
+}
+
+katana::Result<std::shared_ptr<katana::EdgeTypeIndex>>
+katana::MakeEdgeTypeIndex(const PropertyGraph& pg) {
+  static_assert(std::is_same_v<
+                EdgeTypeIndex::TypeSetID, PropertyGraph::TypeSetID>);
+  const GraphTopology& topology = pg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  uint64_t num_types = pg.GetEdgeTypeSetIDsNum();
+  if (num_types == 0 && num_edges > 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edge TypeSetIDs are not constructed; call ConstructTypeSetIDs");
+  }
+
+  auto indices_res = AllocateTopologyBuffer(num_nodes * sizeof(uint64_t));
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res = AllocateTopologyBuffer(num_edges * sizeof(uint32_t));
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto edge_ids_res = AllocateTopologyBuffer(num_edges * sizeof(uint64_t));
+  if (!edge_ids_res) {
+    return edge_ids_res.error();
+  }
+  auto group_indices_res =
+      AllocateTopologyBuffer(num_nodes * sizeof(uint64_t));
+  if (!group_indices_res) {
+    return group_indices_res.error();
+  }
+
+  std::shared_ptr<arrow::Buffer> indices_buf = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> dests_buf = std::move(dests_res.value());
+  std::shared_ptr<arrow::Buffer> edge_ids_buf = std::move(edge_ids_res.value());
+  std::shared_ptr<arrow::Buffer> group_indices_buf =
+      std::move(group_indices_res.value());
+
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buf->mutable_data());
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buf->mutable_data());
+  auto* edge_ids = reinterpret_cast<uint64_t*>(edge_ids_buf->mutable_data());
+  auto* group_indices =
+      reinterpret_cast<uint64_t*>(group_indices_buf->mutable_data());
+
+  // Edges stay within the range of their node, so each node is grouped on
+  // its own by a stable sort of its edges by type; count its groups
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        indices[n] = end;
+        std::iota(edge_ids + begin, edge_ids + end, begin);
+        std::stable_sort(
+            edge_ids + begin, edge_ids + end, [&](uint64_t a, uint64_t b) {
+              return pg.GetEdgeTypeSetID(a) < pg.GetEdgeTypeSetID(b);
+            });
+        uint64_t num_groups = 0;
+        for (uint64_t pos = begin; pos < end; ++pos) {
+          dests[pos] = topology.edge_dest(edge_ids[pos]);
+          if (pos == begin || pg.GetEdgeTypeSetID(edge_ids[pos]) !=
+                                  pg.GetEdgeTypeSetID(edge_ids[pos - 1])) {
+            ++num_groups;
+          }
+        }
+        group_indices[n] = num_groups;
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      group_indices, group_indices + num_nodes, group_indices);
+  uint64_t num_groups = num_nodes > 0 ? group_indices[num_nodes - 1] : 0;
+
+  auto types_res =
+      AllocateTopologyBuffer(num_groups * sizeof(PropertyGraph::TypeSetID));
+  if (!types_res) {
+    return types_res.error();
+  }
+  auto begins_res = AllocateTopologyBuffer((num_groups + 1) * sizeof(uint64_t));
+  if (!begins_res) {
+    return begins_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> types_buf = std::move(types_res.value());
+  std::shared_ptr<arrow::Buffer> begins_buf = std::move(begins_res.value());
+  auto* group_types =
+      reinterpret_cast<PropertyGraph::TypeSetID*>(types_buf->mutable_data());
+  auto* group_begins = reinterpret_cast<uint64_t*>(begins_buf->mutable_data());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        uint64_t group = n > 0 ? group_indices[n - 1] : 0;
+        for (uint64_t pos = begin; pos < end; ++pos) {
+          PropertyGraph::TypeSetID type = pg.GetEdgeTypeSetID(edge_ids[pos]);
+          if (pos == begin || type != group_types[group - 1]) {
+            group_types[group] = type;
+            group_begins[group] = pos;
+            ++group;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  group_begins[num_groups] = num_edges;
+
+  return std::make_shared<EdgeTypeIndex>(EdgeTypeIndex{
+      .topology =
+          GraphTopology{
+              .out_indices =
+                  std::make_shared<arrow::UInt64Array>(num_nodes, indices_buf),
+              .out_dests =
+                  std::make_shared<arrow::UInt32Array>(num_edges, dests_buf),
+          },
+      .out_edge_ids =
+          std::make_shared<arrow::UInt64Array>(num_edges, edge_ids_buf),
+      .num_type_set_ids = num_types,
+      .group_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, group_indices_buf),
+      .group_types =
+          std::make_shared<arrow::UInt16Array>(num_groups, types_buf),
+      .group_begins =
+          std::make_shared<arrow::UInt64Array>(num_groups + 1, begins_buf),
+  });
+}
+
+katana::Result<std::shared_ptr<katana::TemporalEdgeIndex>>
+katana::MakeTemporalEdgeIndex(
+    const PropertyGraph& pg, const std::string& timestamp_property_name) {
+  const GraphTopology& topology = pg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  auto column = pg.GetEdgeProperty(timestamp_property_name);
+  if (!column) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no edge property {}",
+        timestamp_property_name);
+  }
+  switch (column->type()->id()) {
+  case arrow::Type::TIMESTAMP:
+  case arrow::Type::DATE64:
+  case arrow::Type::INT64:
+    break;
+  default:
+    return KATANA_ERROR(
+        ErrorCode::TypeError,
+        "edge property {} is a {}, not a timestamp, date64 or int64",
+        timestamp_property_name, column->type()->ToString());
+  }
+
+  // The timestamp of each edge; all three types are stored as int64
+  LargeArray<int64_t> edge_times;
+  edge_times.allocateBlocked(num_edges);
+  uint64_t offset = 0;
+  for (const auto& chunk : column->chunks()) {
+    const int64_t* values = chunk->data()->GetValues<int64_t>(1);
+    katana::do_all(
+        katana::iterate(int64_t{0}, chunk->length()),
+        [&](int64_t i) {
+          edge_times[offset + i] =
+              chunk->IsNull(i) ? TemporalEdgeIndex::kNullTime : values[i];
+        },
+        katana::no_stats());
+    offset += chunk->length();
+  }
+
+  auto indices_res = AllocateTopologyBuffer(num_nodes * sizeof(uint64_t));
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto dests_res = AllocateTopologyBuffer(num_edges * sizeof(uint32_t));
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto edge_ids_res = AllocateTopologyBuffer(num_edges * sizeof(uint64_t));
+  if (!edge_ids_res) {
+    return edge_ids_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buf = std::move(indices_res.value());
+  std::shared_ptr<arrow::Buffer> dests_buf = std::move(dests_res.value());
+  std::shared_ptr<arrow::Buffer> edge_ids_buf = std::move(edge_ids_res.value());
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buf->mutable_data());
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buf->mutable_data());
+  auto* edge_ids = reinterpret_cast<uint64_t*>(edge_ids_buf->mutable_data());
+
+  auto index = std::make_shared<TemporalEdgeIndex>();
+  index->timestamps.allocateBlocked(num_edges);
+  int64_t* times = index->timestamps.data();
+
+  // Edges stay within the range of their node, so each node is sorted on its
+  // own; ties keep the order of edge ids
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        indices[n] = end;
+        std::iota(edge_ids + begin, edge_ids + end, begin);
+        std::stable_sort(
+            edge_ids + begin, edge_ids + end, [&](uint64_t a, uint64_t b) {
+              return edge_times[a] < edge_times[b];
+            });
+        for (uint64_t pos = begin; pos < end; ++pos) {
+          dests[pos] = topology.edge_dest(edge_ids[pos]);
+          times[pos] = edge_times[edge_ids[pos]];
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  index->topology = GraphTopology{
+      .out_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buf),
+      .out_dests = std::make_shared<arrow::UInt32Array>(num_edges, dests_buf),
+  };
+  index->out_edge_ids =
+      std::make_shared<arrow::UInt64Array>(num_edges, edge_ids_buf);
+  index->timestamp_property_name = timestamp_property_name;
+  index->source = column;
+  return index;
+}
+
+katana::Result<std::shared_ptr<katana::EdgeExistenceIndex>>
+katana::MakeEdgeExistenceIndex(const PropertyGraph& pg, uint64_t min_degree) {
+  using Node = GraphTopology::Node;
+  const GraphTopology& topology = pg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  auto index = std::make_shared<EdgeExistenceIndex>();
+  index->topology = topology;
+  index->min_degree = min_degree;
+  index->sorted_by_dest = pg.edges_sorted_by_dest();
+
+  // Offsets of edges in slots are 32 bits, so nodes of more edges have no
+  // table
+  index->table_begins.allocateBlocked(num_nodes + 1);
+  uint64_t* begins = index->table_begins.data();
+  begins[0] = 0;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        uint64_t degree = end - begin;
+        uint64_t size = 0;
+        if (degree >= std::max<uint64_t>(min_degree, 1) &&
+            degree <= std::numeric_limits<uint32_t>::max()) {
+          size = 2;
+          while (size < 2 * degree) {
+            size *= 2;
+          }
+        }
+        begins[n + 1] = size;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      begins + 1, begins + num_nodes + 1, begins + 1);
+
+  index->slots.allocateBlocked(begins[num_nodes]);
+  uint64_t* slots = index->slots.data();
+  const Node* dests = topology.edge_dests();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t size = begins[n + 1] - begins[n];
+        if (size == 0) {
+          return;
+        }
+        uint64_t* table = slots + begins[n];
+        std::fill(table, table + size, EdgeExistenceIndex::kEmptySlot);
+        auto [begin, end] = topology.edge_range(n);
+        for (uint64_t e = begin; e < end; ++e) {
+          Node dst = dests[e];
+          // The first edge to a destination keeps its slot
+          uint64_t i = EdgeExistenceIndex::FirstSlot(dst, size);
+          while (table[i] != EdgeExistenceIndex::kEmptySlot &&
+                 (table[i] >> 32) != dst) {
+            i = (i + 1) & (size - 1);
+          }
+          if (table[i] == EdgeExistenceIndex::kEmptySlot) {
+            table[i] = (uint64_t{dst} << 32) | (e - begin);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return index;
+}
@@ -3,9 +3,23 @@
 katana::Result<std::vector<arrow::Array*>>
 katana::internal::ExtractArrays(
     const arrow::Table* table, const std::vector<std::string>& properties) {
-  std::vector<arrow::Array*> ret;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
   for (auto& property : properties) {
     auto column = table->GetColumnByName(property);
+    if (!column) {
+      return ErrorCode::PropertyNotFound;
+    }
+    columns.emplace_back(std::move(column));
+  }
+
+  return ExtractArrays(columns);
+}
+
+katana::Result<std::vector<arrow::Array*>>
+katana::internal::ExtractArrays(
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& columns) {
+  std::vector<arrow::Array*> ret;
+  for (auto& column : columns) {
     if (!column) {
       return ErrorCode::PropertyNotFound;
     }
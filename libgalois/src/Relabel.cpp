@@ -0,0 +1,348 @@
+#include "katana/Relabel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <arrow/array/concatenate.h>
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// \returns the nodes of \p topology by descending out-degree; nodes of
+/// equal degree keep their order
+std::vector<Node>
+NodesByDescendingDegree(const katana::GraphTopology& topology) {
+  std::vector<Node> nodes(topology.num_nodes());
+  std::iota(nodes.begin(), nodes.end(), Node{0});
+  katana::ParallelSTL::radix_sort(nodes.begin(), nodes.end(), [&](Node n) {
+    return ~static_cast<uint64_t>(topology.edges(n).size());
+  });
+  return nodes;
+}
+
+std::vector<Node>
+ReverseCuthillMcKeeOrder(const katana::GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  const Node* dests = topology.edge_dests();
+  auto degree = [&](Node n) {
+    return static_cast<uint64_t>(topology.edges(n).size());
+  };
+
+  // Start each breadth first search from an unvisited node of least degree
+  std::vector<Node> starts(num_nodes);
+  std::iota(starts.begin(), starts.end(), Node{0});
+  katana::ParallelSTL::radix_sort(starts.begin(), starts.end(), degree);
+
+  std::vector<Node> order;
+  order.reserve(num_nodes);
+  std::vector<bool> visited(num_nodes);
+  std::vector<Node> neighbors;
+  for (Node start : starts) {
+    if (visited[start]) {
+      continue;
+    }
+    visited[start] = true;
+    order.emplace_back(start);
+    for (size_t head = order.size() - 1; head < order.size(); ++head) {
+      neighbors.clear();
+      for (auto e : topology.edges(order[head])) {
+        Node dst = dests[e];
+        if (!visited[dst]) {
+          visited[dst] = true;
+          neighbors.emplace_back(dst);
+        }
+      }
+      std::stable_sort(
+          neighbors.begin(), neighbors.end(),
+          [&](Node a, Node b) { return degree(a) < degree(b); });
+      order.insert(order.end(), neighbors.begin(), neighbors.end());
+    }
+  }
+
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+std::vector<Node>
+LocalityOrder(
+    const katana::GraphTopology& topology,
+    const katana::InEdgeIndex& in_edge_index) {
+  uint64_t num_nodes = topology.num_nodes();
+  const Node* dests = topology.edge_dests();
+  const Node* srcs = in_edge_index.topology.edge_dests();
+
+  auto for_each_neighbor = [&](Node n, auto fn) {
+    for (auto e : topology.edges(n)) {
+      fn(dests[e]);
+    }
+    for (auto e : in_edge_index.in_edges(n)) {
+      fn(srcs[e]);
+    }
+  };
+
+  // score[n] is the number of edges between unplaced node n and the nodes
+  // in the window. Candidates holds (score, node) entries with positive
+  // scores; entries whose score is no longer current are skipped.
+  std::vector<uint32_t> score(num_nodes);
+  std::vector<bool> placed(num_nodes);
+  std::priority_queue<std::pair<uint32_t, Node>> candidates;
+
+  // Without candidates, continue from the unplaced node of highest degree
+  std::vector<Node> hubs = NodesByDescendingDegree(topology);
+  size_t next_hub = 0;
+
+  std::vector<Node> order;
+  order.reserve(num_nodes);
+  while (order.size() < num_nodes) {
+    bool found = false;
+    Node next = 0;
+    while (!candidates.empty() && !found) {
+      auto [s, n] = candidates.top();
+      candidates.pop();
+      found = !placed[n] && score[n] == s;
+      next = n;
+    }
+    if (!found) {
+      while (placed[hubs[next_hub]]) {
+        ++next_hub;
+      }
+      next = hubs[next_hub];
+    }
+
+    placed[next] = true;
+    order.emplace_back(next);
+    for_each_neighbor(next, [&](Node n) {
+      if (!placed[n]) {
+        candidates.emplace(++score[n], n);
+      }
+    });
+    if (order.size() > katana::kLocalityWindow) {
+      Node leaving = order[order.size() - katana::kLocalityWindow - 1];
+      for_each_neighbor(leaving, [&](Node n) {
+        if (!placed[n] && --score[n] > 0) {
+          candidates.emplace(score[n], n);
+        }
+      });
+    }
+  }
+
+  return order;
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+TakeNodes(
+    const std::shared_ptr<arrow::Array>& values,
+    const std::shared_ptr<arrow::UInt32Array>& indices) {
+  if (values->length() != indices->length()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} values for a permutation of {} nodes", values->length(),
+        indices->length());
+  }
+  auto take_res = arrow::compute::Take(*values, *indices);
+  if (!take_res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(take_res.status()), "permuting values: {}",
+        take_res.status());
+  }
+  return take_res.ValueOrDie();
+}
+
+}  // namespace
+
+katana::Result<katana::NodePermutation>
+katana::NodePermutation::Make(std::shared_ptr<arrow::UInt32Array> old_ids) {
+  constexpr Node kUnset = std::numeric_limits<Node>::max();
+  uint64_t size = old_ids->length();
+  if (old_ids->null_count() != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "permutation has {} nulls",
+        old_ids->null_count());
+  }
+
+  std::vector<Node> new_ids(size, kUnset);
+  std::atomic<bool> valid{true};
+  katana::do_all(
+      katana::iterate(uint64_t{0}, size),
+      [&](uint64_t n) {
+        Node old_id = old_ids->Value(n);
+        if (old_id >= size ||
+            !__sync_bool_compare_and_swap(&new_ids[old_id], kUnset, n)) {
+          valid = false;
+        }
+      },
+      katana::no_stats());
+  if (!valid) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "ids are not a permutation of [0, {})",
+        size);
+  }
+
+  return NodePermutation(
+      std::static_pointer_cast<arrow::UInt32Array>(BuildArray(new_ids)),
+      std::move(old_ids));
+}
+
+katana::Result<katana::NodePermutation>
+katana::NodePermutation::FromOriginalIds(const PropertyGraph& relabeled) {
+  auto prop = relabeled.GetNodeProperty(kOriginalNodeIdProperty);
+  if (!prop) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "graph has no {} property",
+        kOriginalNodeIdProperty);
+  }
+  if (!prop->type()->Equals(arrow::uint32())) {
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "{} has type {}", kOriginalNodeIdProperty,
+        prop->type()->ToString());
+  }
+
+  std::shared_ptr<arrow::Array> ids;
+  if (prop->num_chunks() == 1) {
+    ids = prop->chunk(0);
+  } else {
+    auto concat_res = arrow::Concatenate(prop->chunks());
+    if (!concat_res.ok()) {
+      return KATANA_ERROR(
+          ArrowToKatana(concat_res.status()), "concatenating {}: {}",
+          kOriginalNodeIdProperty, concat_res.status());
+    }
+    ids = std::move(concat_res.ValueOrDie());
+  }
+  return Make(std::static_pointer_cast<arrow::UInt32Array>(ids));
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::NodePermutation::ToOriginalOrder(
+    const std::shared_ptr<arrow::Array>& values) const {
+  return TakeNodes(values, new_ids_);
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::NodePermutation::ToNewOrder(
+    const std::shared_ptr<arrow::Array>& values) const {
+  return TakeNodes(values, old_ids_);
+}
+
+katana::Result<katana::NodePermutation>
+katana::ComputeNodeOrder(const PropertyGraph& pg, NodeOrder order) {
+  const GraphTopology& topology = pg.topology();
+
+  std::vector<Node> old_ids;
+  switch (order) {
+  case NodeOrder::kDegree:
+    old_ids = NodesByDescendingDegree(topology);
+    break;
+  case NodeOrder::kReverseCuthillMcKee:
+    old_ids = ReverseCuthillMcKeeOrder(topology);
+    break;
+  case NodeOrder::kLocality: {
+    auto index_res = MakeInEdgeIndex(topology);
+    if (!index_res) {
+      return index_res.error();
+    }
+    old_ids = LocalityOrder(topology, *index_res.value());
+    break;
+  }
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unknown node order {}",
+        static_cast<int>(order));
+  }
+
+  return NodePermutation::Make(
+      std::static_pointer_cast<arrow::UInt32Array>(BuildArray(old_ids)));
+}
+
+katana::Result<katana::NodePermutation>
+katana::ComputeNodeOrderByProperty(
+    const PropertyGraph& pg, const std::string& property) {
+  std::shared_ptr<arrow::ChunkedArray> column = pg.GetNodeProperty(property);
+  if (!column) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no node property {}", property);
+  }
+  if (!arrow::is_integer(column->type()->id())) {
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "node property {} is {}, expected integers",
+        property, column->type()->ToString());
+  }
+  if (column->null_count() != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "node property {} has {} nulls", property,
+        column->null_count());
+  }
+  auto cast_res = arrow::compute::Cast(arrow::Datum(column), arrow::int64());
+  if (!cast_res.ok()) {
+    return KATANA_ERROR(
+        ArrowToKatana(cast_res.status()), "casting {}: {}", property,
+        cast_res.status());
+  }
+  auto concat_res =
+      arrow::Concatenate(cast_res.ValueOrDie().chunked_array()->chunks());
+  if (!concat_res.ok()) {
+    return KATANA_ERROR(
+        ArrowToKatana(concat_res.status()), "combining {}: {}", property,
+        concat_res.status());
+  }
+  auto values =
+      std::static_pointer_cast<arrow::Int64Array>(concat_res.ValueOrDie());
+
+  // The sort key flips the sign bit so that negative values come first
+  std::vector<Node> old_ids(pg.topology().num_nodes());
+  std::iota(old_ids.begin(), old_ids.end(), Node{0});
+  katana::ParallelSTL::radix_sort(
+      old_ids.begin(), old_ids.end(), [&](Node n) {
+        return static_cast<uint64_t>(values->Value(n)) ^ (uint64_t{1} << 63);
+      });
+
+  return NodePermutation::Make(
+      std::static_pointer_cast<arrow::UInt32Array>(BuildArray(old_ids)));
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::RelabelNodes(const PropertyGraph& pg, NodeOrder order) {
+  auto perm_res = ComputeNodeOrder(pg, order);
+  if (!perm_res) {
+    return perm_res.error();
+  }
+  return RelabelNodes(pg, perm_res.value());
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::RelabelNodes(const PropertyGraph& pg, const NodePermutation& perm) {
+  auto copy_res = pg.Copy();
+  if (!copy_res) {
+    return copy_res.error();
+  }
+  std::unique_ptr<PropertyGraph> relabeled = std::move(copy_res.value());
+  if (auto res = relabeled->ApplyNodePermutation(perm); !res) {
+    return res.error();
+  }
+
+  // A graph that was already relabeled keeps its original ids, which
+  // ApplyNodePermutation moved along with the other properties
+  if (!relabeled->HasNodeProperty(kOriginalNodeIdProperty)) {
+    auto field = arrow::field(kOriginalNodeIdProperty, arrow::uint32());
+    auto table =
+        arrow::Table::Make(arrow::schema({field}), {perm.old_ids()});
+    if (auto res = relabeled->AddNodeProperties(table); !res) {
+      return res.error();
+    }
+  }
+
+  return std::unique_ptr<PropertyGraph>(std::move(relabeled));
+}
@@ -0,0 +1,82 @@
+#include "katana/SegmentedTopology.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "katana/ErrorCode.h"
+#include "tsuba/tsuba.h"
+
+katana::SegmentedTopology::SegmentedTopology(
+    tsuba::RDGPrefix&& prefix, uint64_t segment_bytes)
+    : prefix_(std::move(prefix)), out_dests_(prefix_.out_dests()) {
+  uint64_t max_edges = std::max<uint64_t>(segment_bytes / sizeof(uint32_t), 1);
+  uint64_t num_nodes = prefix_.num_nodes();
+  Node begin = 0;
+  while (begin < num_nodes) {
+    Edge edge_begin = begin == 0 ? 0 : prefix_[begin - 1];
+    // The last node whose edges end within max_edges of edge_begin, but at
+    // least one node
+    const uint64_t* indices = prefix_.out_indexes();
+    Node end = std::upper_bound(
+                   indices + begin, indices + num_nodes,
+                   edge_begin + max_edges) -
+               indices;
+    end = std::max<Node>(end, begin + 1);
+    segments_.emplace_back(Segment{begin, end, edge_begin, prefix_[end - 1]});
+    begin = end;
+  }
+}
+
+katana::Result<katana::SegmentedTopology>
+katana::SegmentedTopology::Make(
+    const std::string& rdg_name, uint64_t segment_bytes) {
+  auto handle_res = tsuba::Open(rdg_name, tsuba::kReadOnly);
+  if (!handle_res) {
+    return handle_res.error();
+  }
+  // Closes the handle
+  tsuba::RDGFile file(handle_res.value());
+
+  auto prefix_res = tsuba::RDGPrefix::Make(file);
+  if (!prefix_res) {
+    return prefix_res.error().WithContext("reading topology of {}", rdg_name);
+  }
+  tsuba::RDGPrefix prefix = std::move(prefix_res.value());
+  if (!prefix.has_topology()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} has no topology", rdg_name);
+  }
+  if (prefix.version() != 1) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "cannot segment topology version {} of {}", prefix.version(),
+        rdg_name);
+  }
+  return SegmentedTopology(std::move(prefix), segment_bytes);
+}
+
+size_t
+katana::SegmentedTopology::segment_of(Node n) const {
+  auto it = std::upper_bound(
+      segments_.begin(), segments_.end(), n,
+      [](Node node, const Segment& segment) { return node < segment.end; });
+  return it - segments_.begin();
+}
+
+katana::Result<void>
+katana::SegmentedTopology::Load(size_t i) {
+  const Segment& segment = segments_[i];
+  return prefix_.FillDests(segment.edge_begin, segment.edge_end, true);
+}
+
+katana::Result<void>
+katana::SegmentedTopology::Prefetch(size_t i) {
+  const Segment& segment = segments_[i];
+  return prefix_.FillDests(segment.edge_begin, segment.edge_end, false);
+}
+
+katana::Result<void>
+katana::SegmentedTopology::Evict(size_t i) {
+  const Segment& segment = segments_[i];
+  return prefix_.EvictDests(segment.edge_begin, segment.edge_end);
+}
@@ -19,9 +19,13 @@
 
 #include "katana/SharedMem.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include "katana/Barrier.h"
+#include "katana/CompilerSpecific.h"
 #include "katana/PagePool.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
@@ -202,36 +206,164 @@ public:
   }
 };
 
+// Counter termination detection. The shared state is an epoch, which a
+// thread that worked advances, and the number of threads idle in the
+// epoch. A thread counts itself idle in an epoch only after a whole look
+// for work that began in the epoch found nothing. Work only reaches an idle
+// thread from a thread that is working and so not counted, and which
+// advances the epoch once done, so all threads being counted idle in an
+// epoch means no work is left.
+class CounterTerminationDetection : public katana::TerminationDetection {
+  static constexpr unsigned kMaxBackoff = 1024;
+
+  struct ThreadState {
+    uint32_t seen_epoch;
+    bool counted;
+    unsigned backoff;
+  };
+
+  // epoch in the high half, idle threads in the low half
+  katana::CacheLineStorage<std::atomic<uint64_t>> state_;
+  katana::PerThreadStorage<ThreadState> data_;
+
+  unsigned active_threads_;
+
+  static uint32_t Epoch(uint64_t state) { return state >> 32; }
+
+  static uint32_t Idle(uint64_t state) { return state & 0xFFFFFFFF; }
+
+  //! Begin a new epoch with no thread idle in it
+  uint32_t Advance() {
+    uint64_t state = state_.data.load();
+    uint64_t next;
+    do {
+      next = uint64_t{Epoch(state) + 1U} << 32;
+    } while (!state_.data.compare_exchange_weak(state, next));
+    return Epoch(next);
+  }
+
+  void Watch(ThreadState& th, uint32_t epoch) {
+    th.seen_epoch = epoch;
+    th.counted = false;
+    th.backoff = 1;
+  }
+
+protected:
+  void Init(unsigned active_threads) override {
+    active_threads_ = active_threads;
+  }
+
+public:
+  void InitializeThread() override {
+    ResetTerminated();
+    // Advancing forgets threads counted in an earlier round
+    Watch(*data_.getLocal(), Advance());
+  }
+
+  void SignalWorked(bool work_happened) override {
+    KATANA_LOG_DEBUG_ASSERT(!(work_happened && !Working()));
+    ThreadState& th = *data_.getLocal();
+    if (work_happened) {
+      Watch(th, Advance());
+      return;
+    }
+
+    uint64_t state = state_.data.load();
+    if (Epoch(state) != th.seen_epoch) {
+      // The caller looked for work before the epoch began; look again
+      Watch(th, Epoch(state));
+      return;
+    }
+
+    if (!th.counted) {
+      while (!state_.data.compare_exchange_weak(state, state + 1)) {
+        if (Epoch(state) != th.seen_epoch) {
+          Watch(th, Epoch(state));
+          return;
+        }
+      }
+      th.counted = true;
+      if (Idle(state) + 1 == active_threads_) {
+        SetTerminated();
+      }
+      return;
+    }
+
+    // Still idle: wait longer each time before the caller polls its work
+    for (unsigned i = 0; i < th.backoff && Working(); ++i) {
+      katana::asmPause();
+    }
+    th.backoff = std::min(th.backoff * 2, kMaxBackoff);
+  }
+};
+
+/// Guards the current SharedMem and the start of its state
+std::mutex start_mutex;
+katana::SharedMem* current_shared_mem = nullptr;
+
 }  // namespace
 
 struct katana::SharedMem::Impl {
   struct Dependents {
     LocalTerminationDetection term;
+    TreeTerminationDetection tree_term;
+    CounterTerminationDetection counter_term;
     std::unique_ptr<Barrier> barrier;
     internal::PageAllocState<> page_pool;
   };
 
-  ThreadPool thread_pool;
+  std::unique_ptr<ThreadPool> thread_pool;
   std::unique_ptr<Dependents> deps;
 };
 
 katana::SharedMem::SharedMem() : impl_(std::make_unique<Impl>()) {
-  internal::SetThreadPool(&impl_->thread_pool);
+  std::lock_guard<std::mutex> lock(start_mutex);
+  KATANA_LOG_VASSERT(
+      current_shared_mem == nullptr, "Double initialization of SharedMem");
+  current_shared_mem = this;
+}
+
+void
+katana::internal::StartSharedMem() {
+  std::lock_guard<std::mutex> lock(start_mutex);
+  if (current_shared_mem == nullptr || current_shared_mem->impl_->deps) {
+    return;
+  }
+  current_shared_mem->Start();
+}
+
+void
+katana::SharedMem::Start() {
+  impl_->thread_pool = std::make_unique<ThreadPool>();
+  internal::SetThreadPool(impl_->thread_pool.get());
 
   // The thread pool must be initialized first because other substrate classes
   // may call GetThreadPool() in their constructors
   impl_->deps = std::make_unique<Impl::Dependents>();
   impl_->deps->barrier =
-      katana::CreateTopoBarrier(impl_->thread_pool.getMaxUsableThreads());
+      katana::CreateTopoBarrier(impl_->thread_pool->getMaxUsableThreads());
 
   internal::SetBarrier(impl_->deps->barrier.get());
-  internal::SetTerminationDetection(&impl_->deps->term);
+  internal::SetTerminationDetection(
+      TerminationKind::kRing, &impl_->deps->term);
+  internal::SetTerminationDetection(
+      TerminationKind::kTree, &impl_->deps->tree_term);
+  internal::SetTerminationDetection(
+      TerminationKind::kCounter, &impl_->deps->counter_term);
   internal::setPagePoolState(&impl_->deps->page_pool);
 }
 
 katana::SharedMem::~SharedMem() {
+  std::lock_guard<std::mutex> lock(start_mutex);
+  current_shared_mem = nullptr;
+  if (!impl_->deps) {
+    return;
+  }
+
   internal::setPagePoolState(nullptr);
-  internal::SetTerminationDetection(nullptr);
+  internal::SetTerminationDetection(TerminationKind::kCounter, nullptr);
+  internal::SetTerminationDetection(TerminationKind::kTree, nullptr);
+  internal::SetTerminationDetection(TerminationKind::kRing, nullptr);
   internal::SetBarrier(nullptr);
 
   // Other substrate classes destructors may call GetThreadPool() so destroy
@@ -239,4 +371,5 @@ katana::SharedMem::~SharedMem() {
   impl_->deps.reset();
 
   internal::SetThreadPool(nullptr);
+  impl_->thread_pool.reset();
 }
@@ -0,0 +1,392 @@
+#include "katana/SparseBitmap.h"
+
+#include <cstring>
+
+#include "katana/Logging.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KATANA_HAS_X86_SPARSE_BITMAP 1
+#include <immintrin.h>
+#endif
+
+using Block = katana::SparseBitmap::Block;
+
+namespace {
+
+constexpr uint32_t kBlockWords = katana::SparseBitmap::kBlockWords;
+
+// Block kernels: set *dst to the union (OrBlock) or difference (AndNotBlock)
+// of two blocks, and return whether a block of interest is non-zero. OrBlock
+// also writes the bits of src that were not in dst to *added.
+
+bool
+OrBlockScalar(Block* dst, const Block& src, Block* added) {
+  uint64_t any = 0;
+  for (uint32_t w = 0; w < kBlockWords; ++w) {
+    uint64_t fresh = src.words[w] & ~dst->words[w];
+    dst->words[w] |= src.words[w];
+    added->words[w] = fresh;
+    any |= fresh;
+  }
+  return any != 0;
+}
+
+bool
+AndNotBlockScalar(Block* dst, const Block& a, const Block& b) {
+  uint64_t any = 0;
+  for (uint32_t w = 0; w < kBlockWords; ++w) {
+    dst->words[w] = a.words[w] & ~b.words[w];
+    any |= dst->words[w];
+  }
+  return any != 0;
+}
+
+#ifdef KATANA_HAS_X86_SPARSE_BITMAP
+
+__attribute__((target("avx2"))) inline bool
+OrBlockAVX2(Block* dst, const Block& src, Block* added) {
+  auto* d = reinterpret_cast<__m256i*>(dst->words);
+  const auto* s = reinterpret_cast<const __m256i*>(src.words);
+  auto* n = reinterpret_cast<__m256i*>(added->words);
+
+  __m256i any = _mm256_setzero_si256();
+  for (int h = 0; h < 2; ++h) {
+    __m256i vd = _mm256_load_si256(d + h);
+    __m256i vs = _mm256_load_si256(s + h);
+    __m256i fresh = _mm256_andnot_si256(vd, vs);
+    _mm256_store_si256(d + h, _mm256_or_si256(vd, vs));
+    _mm256_store_si256(n + h, fresh);
+    any = _mm256_or_si256(any, fresh);
+  }
+  return !_mm256_testz_si256(any, any);
+}
+
+__attribute__((target("avx2"))) inline bool
+AndNotBlockAVX2(Block* dst, const Block& a, const Block& b) {
+  auto* d = reinterpret_cast<__m256i*>(dst->words);
+  const auto* va = reinterpret_cast<const __m256i*>(a.words);
+  const auto* vb = reinterpret_cast<const __m256i*>(b.words);
+
+  __m256i any = _mm256_setzero_si256();
+  for (int h = 0; h < 2; ++h) {
+    __m256i diff = _mm256_andnot_si256(
+        _mm256_load_si256(vb + h), _mm256_load_si256(va + h));
+    _mm256_store_si256(d + h, diff);
+    any = _mm256_or_si256(any, diff);
+  }
+  return !_mm256_testz_si256(any, any);
+}
+
+// GCC's own avx512fintrin.h trips -Wmaybe-uninitialized when inlined
+KATANA_IGNORE_MAYBE_UNINITIALIZED
+__attribute__((target("avx512f"))) inline bool
+OrBlockAVX512(Block* dst, const Block& src, Block* added) {
+  __m512i vd = _mm512_load_si512(dst->words);
+  __m512i vs = _mm512_load_si512(src.words);
+  __m512i fresh = _mm512_andnot_si512(vd, vs);
+  _mm512_store_si512(dst->words, _mm512_or_si512(vd, vs));
+  _mm512_store_si512(added->words, fresh);
+  return _mm512_test_epi64_mask(fresh, fresh) != 0;
+}
+
+__attribute__((target("avx512f"))) inline bool
+AndNotBlockAVX512(Block* dst, const Block& a, const Block& b) {
+  __m512i diff = _mm512_andnot_si512(
+      _mm512_load_si512(b.words), _mm512_load_si512(a.words));
+  _mm512_store_si512(dst->words, diff);
+  return _mm512_test_epi64_mask(diff, diff) != 0;
+}
+KATANA_END_IGNORE_MAYBE_UNINITIALIZED
+
+#endif
+
+}  // namespace
+
+/// The merges of sorted block lists, parameterized by block kernel. Each
+/// public kernel instantiates a merge inside a function compiled for its
+/// instruction set, so that the block kernel is inlined into the loop.
+struct katana::SparseBitmap::Kernels {
+  using OrFn = bool (*)(Block*, const Block&, Block*);
+  using AndNotFn = bool (*)(Block*, const Block&, const Block&);
+
+  template <OrFn Or>
+  __attribute__((always_inline)) static inline bool Union(
+      SparseBitmap* dst, const SparseBitmap& src, SparseBitmap* added) {
+    if (added) {
+      added->clear();
+    }
+    const auto& src_keys = src.keys_;
+    auto& keys = dst->keys_;
+    auto& blocks = dst->blocks_;
+
+    // Blocks of src that dst does not have yet
+    size_t missing = 0;
+    size_t i = 0;
+    for (size_t j = 0; j < src_keys.size(); ++j) {
+      while (i < keys.size() && keys[i] < src_keys[j]) {
+        ++i;
+      }
+      missing += i == keys.size() || keys[i] != src_keys[j];
+    }
+
+    Block fresh;
+    bool changed = missing != 0;
+    if (!changed) {
+      // Every block of src is already in dst, which is the common case
+      // once a set has converged, so combine them in place
+      i = 0;
+      for (size_t j = 0; j < src_keys.size(); ++j) {
+        while (keys[i] != src_keys[j]) {
+          ++i;
+        }
+        if (Or(&blocks[i], src.blocks_[j], &fresh)) {
+          changed = true;
+          if (added) {
+            added->keys_.emplace_back(keys[i]);
+            added->blocks_.emplace_back(fresh);
+          }
+        }
+      }
+      return changed;
+    }
+
+    // Otherwise merge from the back so that blocks move at most once
+    size_t old_size = keys.size();
+    keys.resize(old_size + missing);
+    blocks.resize(old_size + missing);
+    size_t k = keys.size();
+    i = old_size;
+    size_t j = src_keys.size();
+    while (j > 0) {
+      --k;
+      if (i > 0 && keys[i - 1] > src_keys[j - 1]) {
+        --i;
+        keys[k] = keys[i];
+        blocks[k] = blocks[i];
+      } else if (i > 0 && keys[i - 1] == src_keys[j - 1]) {
+        --i;
+        --j;
+        keys[k] = keys[i];
+        blocks[k] = blocks[i];
+        if (Or(&blocks[k], src.blocks_[j], &fresh) && added) {
+          added->keys_.emplace_back(keys[k]);
+          added->blocks_.emplace_back(fresh);
+        }
+      } else {
+        --j;
+        keys[k] = src_keys[j];
+        blocks[k] = src.blocks_[j];
+        if (added) {
+          added->keys_.emplace_back(keys[k]);
+          added->blocks_.emplace_back(blocks[k]);
+        }
+      }
+    }
+    if (added) {
+      std::reverse(added->keys_.begin(), added->keys_.end());
+      std::reverse(added->blocks_.begin(), added->blocks_.end());
+    }
+    return true;
+  }
+
+  template <AndNotFn AndNot>
+  __attribute__((always_inline)) static inline void Difference(
+      SparseBitmap* dst, const SparseBitmap& a, const SparseBitmap& b) {
+    dst->clear();
+    Block diff;
+    size_t j = 0;
+    for (size_t i = 0; i < a.keys_.size(); ++i) {
+      while (j < b.keys_.size() && b.keys_[j] < a.keys_[i]) {
+        ++j;
+      }
+      if (j == b.keys_.size() || b.keys_[j] != a.keys_[i]) {
+        dst->keys_.emplace_back(a.keys_[i]);
+        dst->blocks_.emplace_back(a.blocks_[i]);
+      } else if (AndNot(&diff, a.blocks_[i], b.blocks_[j])) {
+        dst->keys_.emplace_back(a.keys_[i]);
+        dst->blocks_.emplace_back(diff);
+      }
+    }
+  }
+
+  static bool UnionScalar(
+      SparseBitmap* dst, const SparseBitmap& src, SparseBitmap* added) {
+    return Union<OrBlockScalar>(dst, src, added);
+  }
+
+  static void DifferenceScalar(
+      SparseBitmap* dst, const SparseBitmap& a, const SparseBitmap& b) {
+    Difference<AndNotBlockScalar>(dst, a, b);
+  }
+
+#ifdef KATANA_HAS_X86_SPARSE_BITMAP
+  __attribute__((target("avx2"))) static bool UnionAVX2(
+      SparseBitmap* dst, const SparseBitmap& src, SparseBitmap* added) {
+    return Union<OrBlockAVX2>(dst, src, added);
+  }
+
+  __attribute__((target("avx2"))) static void DifferenceAVX2(
+      SparseBitmap* dst, const SparseBitmap& a, const SparseBitmap& b) {
+    Difference<AndNotBlockAVX2>(dst, a, b);
+  }
+
+  KATANA_IGNORE_MAYBE_UNINITIALIZED
+  __attribute__((target("avx512f"))) static bool UnionAVX512(
+      SparseBitmap* dst, const SparseBitmap& src, SparseBitmap* added) {
+    return Union<OrBlockAVX512>(dst, src, added);
+  }
+
+  __attribute__((target("avx512f"))) static void DifferenceAVX512(
+      SparseBitmap* dst, const SparseBitmap& a, const SparseBitmap& b) {
+    Difference<AndNotBlockAVX512>(dst, a, b);
+  }
+  KATANA_END_IGNORE_MAYBE_UNINITIALIZED
+#endif
+
+  using UnionFn = bool (*)(SparseBitmap*, const SparseBitmap&, SparseBitmap*);
+  using DifferenceFn =
+      void (*)(SparseBitmap*, const SparseBitmap&, const SparseBitmap&);
+
+  struct Table {
+    UnionFn union_fn;
+    DifferenceFn difference_fn;
+  };
+
+  static Table KernelTable(SparseBitmapKernel kernel) {
+    switch (kernel) {
+    case SparseBitmapKernel::kScalar:
+      return {UnionScalar, DifferenceScalar};
+#ifdef KATANA_HAS_X86_SPARSE_BITMAP
+    case SparseBitmapKernel::kAVX2:
+      return {UnionAVX2, DifferenceAVX2};
+    case SparseBitmapKernel::kAVX512:
+      return {UnionAVX512, DifferenceAVX512};
+#endif
+    default:
+      return {nullptr, nullptr};
+    }
+  }
+
+  static const Table& Best() {
+    static const Table best = [] {
+      for (auto kernel :
+           {SparseBitmapKernel::kAVX512, SparseBitmapKernel::kAVX2}) {
+        if (IsSparseBitmapKernelSupported(kernel)) {
+          return KernelTable(kernel);
+        }
+      }
+      return KernelTable(SparseBitmapKernel::kScalar);
+    }();
+    return best;
+  }
+};
+
+bool
+katana::IsSparseBitmapKernelSupported(SparseBitmapKernel kernel) {
+  switch (kernel) {
+  case SparseBitmapKernel::kScalar:
+    return true;
+#ifdef KATANA_HAS_X86_SPARSE_BITMAP
+  case SparseBitmapKernel::kAVX2:
+    return __builtin_cpu_supports("avx2");
+  case SparseBitmapKernel::kAVX512:
+    return __builtin_cpu_supports("avx512f");
+#endif
+  default:
+    return false;
+  }
+}
+
+size_t
+katana::SparseBitmap::size() const {
+  size_t count = 0;
+  for (const auto& block : blocks_) {
+    for (uint32_t w = 0; w < kBlockWords; ++w) {
+      count += __builtin_popcountll(block.words[w]);
+    }
+  }
+  return count;
+}
+
+bool
+katana::SparseBitmap::set(uint32_t value) {
+  uint32_t key = value / kBlockBits;
+  auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+  size_t pos = it - keys_.begin();
+  if (it == keys_.end() || *it != key) {
+    keys_.insert(it, key);
+    blocks_.insert(blocks_.begin() + pos, Block{});
+  }
+  uint32_t bit = value % kBlockBits;
+  uint64_t mask = uint64_t{1} << (bit % 64);
+  uint64_t& word = blocks_[pos].words[bit / 64];
+  bool fresh = !(word & mask);
+  word |= mask;
+  return fresh;
+}
+
+bool
+katana::SparseBitmap::UnionWith(
+    const SparseBitmap& other, SparseBitmap* added) {
+  KATANA_LOG_DEBUG_ASSERT(added != this && added != &other);
+  return Kernels::Best().union_fn(this, other, added);
+}
+
+bool
+katana::SparseBitmap::UnionWith(
+    SparseBitmapKernel kernel, const SparseBitmap& other, SparseBitmap* added) {
+  KATANA_LOG_ASSERT(IsSparseBitmapKernelSupported(kernel));
+  KATANA_LOG_DEBUG_ASSERT(added != this && added != &other);
+  return Kernels::KernelTable(kernel).union_fn(this, other, added);
+}
+
+void
+katana::SparseBitmap::AssignDifference(
+    const SparseBitmap& a, const SparseBitmap& b) {
+  KATANA_LOG_DEBUG_ASSERT(&a != this && &b != this);
+  Kernels::Best().difference_fn(this, a, b);
+}
+
+void
+katana::SparseBitmap::AssignDifference(
+    SparseBitmapKernel kernel, const SparseBitmap& a, const SparseBitmap& b) {
+  KATANA_LOG_ASSERT(IsSparseBitmapKernelSupported(kernel));
+  KATANA_LOG_DEBUG_ASSERT(&a != this && &b != this);
+  Kernels::KernelTable(kernel).difference_fn(this, a, b);
+}
+
+bool
+katana::SparseBitmap::IsSubsetOf(const SparseBitmap& other) const {
+  size_t j = 0;
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    while (j < other.keys_.size() && other.keys_[j] < keys_[i]) {
+      ++j;
+    }
+    if (j == other.keys_.size() || other.keys_[j] != keys_[i]) {
+      return false;
+    }
+    for (uint32_t w = 0; w < kBlockWords; ++w) {
+      if (blocks_[i].words[w] & ~other.blocks_[j].words[w]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool
+katana::SparseBitmap::operator==(const SparseBitmap& other) const {
+  return keys_ == other.keys_ &&
+         (blocks_.empty() ||
+          std::memcmp(
+             blocks_.data(), other.blocks_.data(),
+              blocks_.size() * sizeof(Block)) == 0);
+}
+
+std::vector<uint32_t>
+katana::SparseBitmap::ToVector() const {
+  std::vector<uint32_t> values;
+  values.reserve(size());
+  ForEach([&](uint32_t v) { values.emplace_back(v); });
+  return values;
+}
@@ -21,15 +21,23 @@
 
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <unistd.h>
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <vector>
 
 #include "katana/Env.h"
 #include "katana/Executor_OnEach.h"
+#include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "tsuba/IOStats.h"
 #include "tsuba/file.h"
 
 namespace {
@@ -39,6 +47,70 @@ CheckPrintingThreadVals() {
   return katana::GetEnv("PRINT_PER_THREAD_STATS");
 }
 
+bool
+CheckPrintingJSON() {
+  std::string format;
+  return katana::GetEnv("KATANA_STAT_FORMAT", &format) && format == "json";
+}
+
+std::string
+ToString(const katana::gstl::Str& s) {
+  return std::string(s.begin(), s.end());
+}
+
+template <typename T>
+nlohmann::json
+ToJSON(const T& val) {
+  return val;
+}
+
+template <>
+nlohmann::json
+ToJSON(const katana::gstl::Str& val) {
+  return ToString(val);
+}
+
+/// A completed interval of a StatTimer in the Chrome trace event format
+struct TraceEvent {
+  std::string name;
+  std::string category;
+  uint64_t start_usec;
+  uint64_t duration_usec;
+  unsigned tid;
+};
+
+/// A sample of a counter in the Chrome trace event format
+struct CounterEvent {
+  std::string name;
+  uint64_t time_usec;
+  std::vector<std::pair<std::string, int64_t>> values;
+};
+
+/// Add the I/O recorded by tsuba to sm as stats of region
+void
+AddIOStats(katana::StatManager* sm, const std::string& region) {
+  using katana::StatTotal;
+  for (size_t i = 0; i < tsuba::kNumIOOps; ++i) {
+    auto op = static_cast<tsuba::IOOp>(i);
+    tsuba::IOOpStats stats = tsuba::GetIOStats(op);
+    if (stats.count == 0) {
+      continue;
+    }
+    std::string name = tsuba::IOOpName(op);
+    std::pair<const char*, uint64_t> values[] = {
+        {"Count", stats.count},        {"Errors", stats.errors},
+        {"Bytes", stats.bytes},        {"Usec", stats.total_usec},
+        {"MaxUsec", stats.max_usec},   {"P50Usec", stats.p50_usec},
+        {"P90Usec", stats.p90_usec},   {"P99Usec", stats.p99_usec},
+    };
+    for (const auto& [suffix, value] : values) {
+      sm->AddInt(region, name + suffix, value, StatTotal::SINGLE);
+    }
+    sm->AddFP(
+        region, name + "BytesPerSec", stats.bytes_per_sec(), StatTotal::SINGLE);
+  }
+}
+
 void
 PrintHeader(std::ostream& out, const char* sep) {
   out << "STAT_TYPE" << sep << "REGION" << sep << "CATEGORY" << sep;
@@ -56,24 +128,36 @@ struct StatImpl {
     return std::is_same<T, katana::gstl::Str>::value ? "PARAM" : "STAT";
   }
 
-  katana::PerThreadStorage<katana::internal::ScalarStatManager<T>>
-      perThreadManagers_;
+  using PerThreadManagers =
+      katana::PerThreadStorage<katana::internal::ScalarStatManager<T>>;
+
+  /// Made by the first Add, so that a StatManager does not start the thread
+  /// pool before any statistic is reported
+  std::unique_ptr<PerThreadManagers> perThreadManagers_;
+  std::once_flag perThreadManagersMade_;
   MergedStats result_;
   bool merged_{};
 
   void Add(
       const katana::gstl::Str& region, const katana::gstl::Str& category,
       const T& val, const katana::StatTotal::Type& type) {
-    perThreadManagers_.getLocal()->addToStat(region, category, val, type);
+    std::call_once(perThreadManagersMade_, [this]() {
+      perThreadManagers_ = std::make_unique<PerThreadManagers>();
+    });
+    perThreadManagers_->getLocal()->addToStat(region, category, val, type);
   }
 
   void Merge() {
     if (merged_) {
       return;
     }
+    if (!perThreadManagers_) {
+      merged_ = true;
+      return;
+    }
 
-    for (unsigned t = 0; t < perThreadManagers_.size(); ++t) {
-      const auto* manager = perThreadManagers_.getRemote(t);
+    for (unsigned t = 0; t < perThreadManagers_->size(); ++t) {
+      const auto* manager = perThreadManagers_->getRemote(t);
 
       for (auto i = manager->cbegin(), end_i = manager->cend(); i != end_i;
            ++i) {
@@ -125,6 +209,25 @@ struct StatImpl {
       }
     }
   }
+
+  /// Add statistics to \param regions as region -> category -> stat
+  void AddToJSON(nlohmann::json* regions) const {
+    for (auto i = result_.cbegin(), end_i = result_.cend(); i != end_i; ++i) {
+      const auto& s = result_.stat(i);
+      nlohmann::json values = nlohmann::json::array();
+      for (const auto& v : s.values()) {
+        values.push_back(ToJSON(v));
+      }
+
+      (*regions)[ToString(result_.region(i))][ToString(result_.category(i))] =
+          {
+              {"kind", StatKind()},
+              {"total_type", katana::StatTotal::str(s.totalTy())},
+              {"total", ToJSON(s.total())},
+              {"thread_values", std::move(values)},
+          };
+    }
+  }
 };
 
 }  // end unnamed namespace
@@ -135,6 +238,14 @@ public:
   StatImpl<double> fp_stats_;
   StatImpl<Str> str_stats_;
   std::string outfile_;
+
+  bool print_json_{CheckPrintingJSON()};
+  std::chrono::steady_clock::time_point start_{
+      std::chrono::steady_clock::now()};
+  std::mutex trace_mutex_;
+  std::vector<TraceEvent> trace_;
+  std::vector<CounterEvent> counters_;
+  bool io_stats_added_{false};
 };
 
 katana::StatManager::StatManager() { impl_ = std::make_unique<Impl>(); }
@@ -151,6 +262,106 @@ katana::StatManager::IsPrintingThreadVals() const {
   return CheckPrintingThreadVals();
 }
 
+bool
+katana::StatManager::IsTracing() const {
+  return impl_->print_json_;
+}
+
+uint64_t
+katana::StatManager::TraceTime() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - impl_->start_)
+      .count();
+}
+
+void
+katana::StatManager::AddCounterEvent(
+    const std::string& name, uint64_t time_usec,
+    const std::vector<std::pair<std::string, int64_t>>& values) {
+  if (!impl_->print_json_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(impl_->trace_mutex_);
+  impl_->counters_.emplace_back(CounterEvent{
+      .name = name,
+      .time_usec = time_usec,
+      .values = values,
+  });
+}
+
+void
+katana::StatManager::AddTraceEvent(
+    const Str& region, const Str& category, uint64_t usec) {
+  if (!impl_->print_json_) {
+    return;
+  }
+  uint64_t end = TraceTime();
+
+  TraceEvent event{
+      .name = ToString(region),
+      .category = ToString(category),
+      .start_usec = end > usec ? end - usec : 0,
+      .duration_usec = usec,
+      .tid = ThreadPool::getTID(),
+  };
+
+  std::lock_guard<std::mutex> lock(impl_->trace_mutex_);
+  impl_->trace_.emplace_back(std::move(event));
+}
+
+void
+katana::StatManager::PrintJSON(std::ostream& out) {
+  MergeStats();
+
+  nlohmann::json regions = nlohmann::json::object();
+  impl_->int_stats_.AddToJSON(&regions);
+  impl_->fp_stats_.AddToJSON(&regions);
+  impl_->str_stats_.AddToJSON(&regions);
+
+  nlohmann::json events = nlohmann::json::array();
+  {
+    std::lock_guard<std::mutex> lock(impl_->trace_mutex_);
+    for (const auto& event : impl_->trace_) {
+      events.push_back({
+          {"name", event.name},
+          {"cat", event.category},
+          {"ph", "X"},
+          {"ts", event.start_usec},
+          {"dur", event.duration_usec},
+          {"pid", getpid()},
+          {"tid", event.tid},
+      });
+    }
+    for (const auto& event : impl_->counters_) {
+      nlohmann::json args = nlohmann::json::object();
+      for (const auto& [series, value] : event.values) {
+        args[series] = value;
+      }
+      events.push_back({
+          {"name", event.name},
+          {"ph", "C"},
+          {"ts", event.time_usec},
+          {"pid", getpid()},
+          {"args", std::move(args)},
+      });
+    }
+  }
+
+  // Trace viewers read traceEvents and ignore the other fields
+  nlohmann::json doc = {
+      {"traceEvents", std::move(events)},
+      {"displayTimeUnit", "ms"},
+      {"stats", std::move(regions)},
+  };
+
+  auto res = katana::JsonDump(doc);
+  if (!res) {
+    KATANA_LOG_ERROR("printing stats as JSON: {}", res.error());
+    return;
+  }
+  out << res.value() << "\n";
+}
+
 void
 katana::StatManager::PrintStats(std::ostream& out) {
   MergeStats();
@@ -249,12 +460,25 @@ katana::StatManager::AddParam(
 
 void
 katana::StatManager::Print() {
+  if (!impl_->io_stats_added_) {
+    AddIOStats(this, "tsuba");
+    impl_->io_stats_added_ = true;
+  }
+
+  auto print = [this](std::ostream& out) {
+    if (impl_->print_json_) {
+      PrintJSON(out);
+    } else {
+      PrintStats(out);
+    }
+  };
+
   if (impl_->outfile_.empty()) {
-    return PrintStats(std::cout);
+    return print(std::cout);
   }
   // n.b. Assumes that stats fit in memory
   std::ostringstream out;
-  PrintStats(out);
+  print(out);
 
   std::string stats = out.str();
   if (stats.empty()) {
@@ -290,6 +514,11 @@ katana::PrintStats() {
   internal::sysStatManager()->Print();
 }
 
+void
+katana::ReportIOStats(const std::string& region) {
+  AddIOStats(internal::sysStatManager(), region);
+}
+
 void
 katana::reportPageAlloc(const char* category) {
   katana::on_each_gen(
@@ -0,0 +1,24 @@
+#include "katana/TemporalWindow.h"
+
+#include "katana/Galois.h"
+#include "katana/Reduction.h"
+
+katana::Result<katana::TemporalWindow>
+katana::TemporalWindow::Make(
+    PropertyGraph* pg, const std::string& timestamp_property_name,
+    int64_t begin_time, int64_t end_time) {
+  auto index_res = pg->GetTemporalEdgeIndex(timestamp_property_name);
+  if (!index_res) {
+    return index_res.error();
+  }
+  return TemporalWindow(pg, std::move(index_res.value()), begin_time, end_time);
+}
+
+uint64_t
+katana::TemporalWindow::num_edges() const {
+  katana::GAccumulator<uint64_t> count;
+  katana::do_all(
+      katana::iterate(*this), [&](Node n) { count += edges(n).size(); },
+      katana::no_stats());
+  return count.reduce();
+}
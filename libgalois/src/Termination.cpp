@@ -17,24 +17,60 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <array>
+#include <string>
+
+#include "katana/Env.h"
 #include "katana/Logging.h"
+#include "katana/SharedMem.h"
 #include "katana/TerminationDetection.h"
 
 // vtable anchoring
 katana::TerminationDetection::~TerminationDetection() = default;
 
-static katana::TerminationDetection* kTerminationDetection = nullptr;
+static std::array<katana::TerminationDetection*, 4> kTerminationDetections;
+
+static katana::TerminationKind
+DefaultKind() {
+  static katana::TerminationKind kind = [] {
+    std::string name = "ring";
+    katana::GetEnv("KATANA_TERMINATION", &name);
+    if (name == "tree") {
+      return katana::TerminationKind::kTree;
+    }
+    if (name == "counter") {
+      return katana::TerminationKind::kCounter;
+    }
+    if (name != "ring") {
+      KATANA_LOG_WARN("unknown KATANA_TERMINATION {}; using ring", name);
+    }
+    return katana::TerminationKind::kRing;
+  }();
+  return kind;
+}
 
 void
-katana::internal::SetTerminationDetection(katana::TerminationDetection* t) {
+katana::internal::SetTerminationDetection(
+    TerminationKind kind, katana::TerminationDetection* t) {
+  auto*& slot = kTerminationDetections[static_cast<size_t>(kind)];
   KATANA_LOG_VASSERT(
-      !(kTerminationDetection && t),
-      "Double initialization of TerminationDetection");
-  kTerminationDetection = t;
+      !(slot && t), "Double initialization of TerminationDetection");
+  slot = t;
 }
 
 katana::TerminationDetection&
-katana::GetTerminationDetection(unsigned active_threads) {
-  kTerminationDetection->Init(active_threads);
-  return *kTerminationDetection;
+katana::GetTerminationDetection(
+    unsigned active_threads, TerminationKind kind) {
+  if (kind == TerminationKind::kDefault) {
+    kind = DefaultKind();
+  }
+  TerminationDetection* term =
+      kTerminationDetections[static_cast<size_t>(kind)];
+  if (!term) {
+    internal::StartSharedMem();
+    term = kTerminationDetections[static_cast<size_t>(kind)];
+  }
+  KATANA_LOG_VASSERT(term, "TerminationDetection not initialized");
+  term->Init(active_threads);
+  return *term;
 }
@@ -20,31 +20,84 @@
 #include "katana/ThreadPool.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 
 #include "katana/Env.h"
 #include "katana/HWTopo.h"
 #include "katana/Logging.h"
+#include "katana/SharedMem.h"
 
 // Forward declare this to avoid including PerThreadStorage.
 // We avoid this to stress that the thread Pool MUST NOT depend on PTS.
 namespace katana {
 
 extern void initPTS(unsigned);
+extern void adoptPTS(unsigned);
 
 }
 
 using katana::ThreadPool;
 
 thread_local ThreadPool::per_signal ThreadPool::my_box;
+thread_local bool ThreadPool::inRun;
+
+void
+ThreadPool::per_signal::wait(bool fastmode, uint64_t spinUsec) {
+  if (fastmode) {
+    while (!fastRelease.load(std::memory_order_relaxed)) {
+      asmPause();
+    }
+    fastRelease = 0;
+    return;
+  }
+
+  using Clock = std::chrono::steady_clock;
+  constexpr unsigned kMaxPauses = 64;
+
+  auto start = Clock::now();
+  // Spin only if runs have been arriving within the budget
+  bool spin = spinUsec && avgIdleUsec <= spinUsec;
+  if (spin) {
+    auto deadline = start + std::chrono::microseconds(spinUsec);
+    unsigned pauses = 1;
+    while (done && Clock::now() < deadline) {
+      for (unsigned i = 0; i < pauses; ++i) {
+        asmPause();
+      }
+      pauses = std::min(2 * pauses, kMaxPauses);
+    }
+  }
+
+  if (done) {
+    parked = true;
+    std::unique_lock<std::mutex> lg(m);
+    cv.wait(lg, [=] { return !done; });
+    parked = false;
+  }
+
+  if (spinUsec) {
+    uint64_t idle = std::chrono::duration_cast<std::chrono::microseconds>(
+                        Clock::now() - start)
+                        .count();
+    avgIdleUsec = (7 * avgIdleUsec + idle) / 8;
+  }
+}
 
 ThreadPool::ThreadPool()
     : mi(getHWTopo().machineTopoInfo),
+      masterBox(nullptr),
       reserved(0),
       masterFastmode(false),
+      spinUsec(0),
       running(false) {
+  if (int usec = 0; GetEnv("KATANA_THREAD_SPIN_USEC", &usec) && usec > 0) {
+    spinUsec = usec;
+  }
   signals.resize(mi.maxThreads);
   initThread(0);
+  masterBox = &my_box;
 
   for (unsigned i = 1; i < mi.maxThreads; ++i) {
     std::thread t(&ThreadPool::threadLoop, this, i);
@@ -152,13 +205,26 @@ ThreadPool::initThread(unsigned tid) {
   my_box.done = 1;
 }
 
+void
+ThreadPool::attachThread() {
+  // done is only clear for threads the pool has not seen, or for threads of
+  // the pool while they run work, which may not start a run anyway
+  if (my_box.done) {
+    return;
+  }
+  my_box.topo = masterBox->topo;
+  my_box.done = 1;
+  adoptPTS(my_box.topo.tid);
+}
+
 void
 ThreadPool::threadLoop(unsigned tid) {
   initThread(tid);
+  inRun = true;
   bool fastmode = false;
   auto& me = my_box;
   do {
-    me.wait(fastmode);
+    me.wait(fastmode, spinUsec.load(std::memory_order_relaxed));
     cascade(fastmode);
     try {
       work();
@@ -168,6 +234,7 @@ ThreadPool::threadLoop(unsigned tid) {
       fastmode = fm.mode;
     } catch (const dedicated_ty dt) {
       me.done = 1;
+      inRun = false;
       dt.fn();
       return;
     } catch (const std::exception& exc) {
@@ -230,8 +297,10 @@ void
 ThreadPool::runInternal(unsigned num) {
   // sanitize num
   // seq write to starting should make work safe
-  KATANA_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
   running = true;
+  inRun = true;
+  // The children look up topology of thread 0 through signals
+  signals[0] = &my_box;
   num = std::min(std::max(1U, num), getMaxUsableThreads());
   // my_box is tid 0
   auto& me = my_box;
@@ -245,6 +314,7 @@ ThreadPool::runInternal(unsigned num) {
   try {
     work();
   } catch (const shutdown_ty&) {
+    inRun = false;
     return;
   } catch (const fastmode_ty& fm) {
   }
@@ -253,6 +323,8 @@ ThreadPool::runInternal(unsigned num) {
   // Clean up
   work = nullptr;
   running = false;
+  inRun = false;
+  signals[0] = masterBox;
 }
 
 void
@@ -277,16 +349,27 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   work = nullptr;
 }
 
-static katana::ThreadPool* TPOOL = nullptr;
+static std::atomic<katana::ThreadPool*> TPOOL{nullptr};
 
 void
 katana::internal::SetThreadPool(ThreadPool* tp) {
-  KATANA_LOG_VASSERT(!(TPOOL && tp), "Double initialization of ThreadPool");
-  TPOOL = tp;
+  KATANA_LOG_VASSERT(
+      !(TPOOL.load() && tp), "Double initialization of ThreadPool");
+  TPOOL.store(tp, std::memory_order_release);
+}
+
+katana::ThreadPool*
+katana::internal::PeekThreadPool() {
+  return TPOOL.load(std::memory_order_acquire);
 }
 
 katana::ThreadPool&
 katana::GetThreadPool() {
-  KATANA_LOG_VASSERT(TPOOL, "ThreadPool not initialized");
-  return *TPOOL;
+  ThreadPool* tp = TPOOL.load(std::memory_order_acquire);
+  if (!tp) {
+    internal::StartSharedMem();
+    tp = TPOOL.load(std::memory_order_acquire);
+  }
+  KATANA_LOG_VASSERT(tp, "ThreadPool not initialized");
+  return *tp;
 }
@@ -21,6 +21,7 @@
 
 #include <algorithm>
 
+#include "katana/HWTopo.h"
 #include "katana/ThreadPool.h"
 namespace katana {
 KATANA_EXPORT unsigned int activeThreads = 1;
@@ -28,7 +29,12 @@ KATANA_EXPORT unsigned int activeThreads = 1;
 
 unsigned int
 katana::setActiveThreads(unsigned int num) noexcept {
-  num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
+  // Setting the threads does not start the pool; no thread of a pool that is
+  // not started is reserved
+  katana::ThreadPool* pool = katana::internal::PeekThreadPool();
+  num = std::min(
+      num, pool ? pool->getMaxUsableThreads()
+                : katana::getHWTopo().machineTopoInfo.maxThreads);
   num = std::max(num, 1U);
   katana::activeThreads = num;
   return num;
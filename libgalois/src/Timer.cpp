@@ -110,7 +110,13 @@ StatTimer::start() {
 void
 StatTimer::stop() {
   valid_ = false;
+  uint64_t before = TimeAccumulator::get_usec();
   TimeAccumulator::stop();
+
+  StatManager* sm = internal::sysStatManager();
+  if (sm && sm->IsTracing()) {
+    sm->AddTraceEvent(region_, name_, TimeAccumulator::get_usec() - before);
+  }
 }
 
 uint64_t
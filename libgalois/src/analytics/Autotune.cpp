@@ -0,0 +1,151 @@
+#include "katana/analytics/Autotune.h"
+
+#include <algorithm>
+#include <deque>
+#include <random>
+
+#include "katana/ErrorCode.h"
+#include "katana/JSON.h"
+#include "katana/Random.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+
+namespace {
+
+/// The entries of out_indices and destinations hashed into a fingerprint
+constexpr uint64_t kFingerprintSamples = 1024;
+
+uint64_t
+Mix(uint64_t hash, uint64_t value) {
+  uint64_t z = hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 6U));
+  z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31U);
+}
+
+}  // namespace
+
+katana::analytics::AutotuneCache&
+katana::analytics::AutotuneCache::Global() {
+  static AutotuneCache cache;
+  return cache;
+}
+
+std::string
+katana::analytics::AutotuneCache::Key(
+    const std::string& analytic, uint64_t fingerprint) {
+  return fmt::format("{}/{:016x}", analytic, fingerprint);
+}
+
+std::optional<std::string>
+katana::analytics::AutotuneCache::Lookup(
+    const std::string& analytic, uint64_t fingerprint) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = choices_.find(Key(analytic, fingerprint));
+  if (it == choices_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void
+katana::analytics::AutotuneCache::Insert(
+    const std::string& analytic, uint64_t fingerprint,
+    const std::string& candidate) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  choices_[Key(analytic, fingerprint)] = candidate;
+}
+
+void
+katana::analytics::AutotuneCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  choices_.clear();
+}
+
+std::string
+katana::analytics::AutotuneCache::ToJson() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return nlohmann::json(choices_).dump();
+}
+
+katana::Result<void>
+katana::analytics::AutotuneCache::FromJson(const std::string& json) {
+  std::unordered_map<std::string, std::string> choices;
+  if (auto r = katana::JsonParse(json, &choices); !r) {
+    return r.error();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& [key, candidate] : choices) {
+    choices_[key] = std::move(candidate);
+  }
+  return katana::ResultSuccess();
+}
+
+uint64_t
+katana::analytics::GraphFingerprint(const PropertyGraph& pg) {
+  const GraphTopology& topology = pg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  uint64_t hash = Mix(Mix(0, num_nodes), num_edges);
+  if (num_nodes > 0) {
+    const uint64_t* indices = topology.out_indices->raw_values();
+    for (uint64_t i = 0; i < kFingerprintSamples; ++i) {
+      hash = Mix(hash, indices[i * num_nodes / kFingerprintSamples]);
+    }
+  }
+  if (num_edges > 0) {
+    const GraphTopology::Node* dests = topology.edge_dests();
+    for (uint64_t i = 0; i < kFingerprintSamples; ++i) {
+      hash = Mix(hash, dests[i * num_edges / kFingerprintSamples]);
+    }
+  }
+  return hash;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SampleSubgraph(
+    PropertyGraph* pg, uint64_t num_nodes,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) {
+  const GraphTopology& topology = pg->topology();
+  num_nodes = std::min(num_nodes, topology.num_nodes());
+
+  std::vector<GraphTopology::Node> nodes;
+  nodes.reserve(num_nodes);
+  std::vector<uint8_t> visited(topology.num_nodes());
+  std::deque<GraphTopology::Node> queue;
+  auto visit = [&](GraphTopology::Node n) {
+    if (!visited[n] && nodes.size() < num_nodes) {
+      visited[n] = true;
+      nodes.emplace_back(n);
+      queue.emplace_back(n);
+    }
+  };
+
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<GraphTopology::Node> pick(
+      0, std::max<uint64_t>(topology.num_nodes(), 1) - 1);
+  // Start searches from random nodes until the sample is full, falling back
+  // to a scan as random picks hit visited nodes
+  GraphTopology::Node next_unvisited = 0;
+  while (nodes.size() < num_nodes) {
+    GraphTopology::Node start = pick(gen);
+    if (visited[start]) {
+      while (visited[next_unvisited]) {
+        ++next_unvisited;
+      }
+      start = next_unvisited;
+    }
+    visit(start);
+    while (!queue.empty() && nodes.size() < num_nodes) {
+      GraphTopology::Node n = queue.front();
+      queue.pop_front();
+      for (auto e : topology.edges(n)) {
+        visit(topology.edge_dest(e));
+      }
+    }
+    queue.clear();
+  }
+  std::sort(nodes.begin(), nodes.end());
+
+  return SubGraphExtraction(pg, nodes, node_properties, edge_properties);
+}
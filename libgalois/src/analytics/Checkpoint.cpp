@@ -0,0 +1,241 @@
+#include "katana/analytics/Checkpoint.h"
+
+#include <unordered_set>
+#include <vector>
+
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+thread_local katana::analytics::Checkpointer* current_checkpointer = nullptr;
+
+/// The manifest names the file of the last complete checkpoint
+struct Manifest {
+  std::string analytic;
+  uint64_t iteration{0};
+  std::string file;
+};
+
+void
+to_json(nlohmann::json& j, const Manifest& manifest) {
+  j = nlohmann::json{
+      {"analytic", manifest.analytic},
+      {"iteration", manifest.iteration},
+      {"file", manifest.file},
+  };
+}
+
+void
+from_json(const nlohmann::json& j, Manifest& manifest) {
+  j.at("analytic").get_to(manifest.analytic);
+  j.at("iteration").get_to(manifest.iteration);
+  j.at("file").get_to(manifest.file);
+}
+
+/// Delete file of dir, if any, logging failures; a checkpoint that is not
+/// deleted only takes space
+void
+DeleteFile(const katana::Uri& dir, const std::string& file) {
+  if (file.empty()) {
+    return;
+  }
+  if (auto r = tsuba::FileDelete(dir.string(), {file}); !r) {
+    KATANA_LOG_WARN("deleting checkpoint {}: {}", dir.Join(file), r.error());
+  }
+}
+
+/// \returns the manifest at uri, or nothing if there is none
+katana::Result<std::optional<Manifest>>
+ReadManifest(const katana::Uri& uri) {
+  tsuba::StatBuf stat_buf;
+  if (auto r = tsuba::FileStat(uri.string(), &stat_buf); !r) {
+    if (r.error().error_code() == std::errc::no_such_file_or_directory) {
+      return std::optional<Manifest>();
+    }
+    return r.error().WithContext("checking for {}", uri);
+  }
+  std::string json(stat_buf.size, '\0');
+  if (auto r = tsuba::FileGet(uri.string(), json.data(), 0, json.size()); !r) {
+    return r.error().WithContext("reading {}", uri);
+  }
+  Manifest manifest;
+  if (auto r = katana::JsonParse(json, &manifest); !r) {
+    return r.error().WithContext("parsing {}", uri);
+  }
+  return std::optional<Manifest>(std::move(manifest));
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::analytics::Checkpointer>>
+katana::analytics::Checkpointer::Make(
+    const std::string& dir, uint32_t interval) {
+  auto uri_res = katana::Uri::Make(dir);
+  if (!uri_res) {
+    return uri_res.error();
+  }
+  return std::unique_ptr<Checkpointer>(
+      new Checkpointer(std::move(uri_res.value()), interval));
+}
+
+katana::analytics::Checkpointer::~Checkpointer() {
+  if (auto r = Finish(); !r) {
+    KATANA_LOG_WARN("checkpoint not saved: {}", r.error());
+  }
+}
+
+katana::Uri
+katana::analytics::Checkpointer::ManifestUri() const {
+  return dir_.Join(fmt::format("checkpoint.{}.json", tsuba::Comm()->ID));
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Save(
+    const std::string& analytic, uint64_t iteration,
+    std::shared_ptr<arrow::Table> state) {
+  if (auto r = Finish(); !r) {
+    return r.error().WithContext("finishing the previous checkpoint");
+  }
+
+  auto group_res = tsuba::WriteGroup::Make();
+  if (!group_res) {
+    return group_res.error();
+  }
+  std::unique_ptr<tsuba::WriteGroup> group = std::move(group_res.value());
+
+  auto writer_res = tsuba::ParquetWriter::Make(std::move(state));
+  if (!writer_res) {
+    return writer_res.error();
+  }
+  katana::Uri file = dir_.RandFile("checkpoint");
+  if (auto r = writer_res.value()->WriteToUri(file, group.get()); !r) {
+    // Writes already started still hold the file
+    if (auto finish_res = group->Finish(); !finish_res) {
+      KATANA_LOG_DEBUG("abandoned checkpoint: {}", finish_res.error());
+    }
+    DeleteFile(dir_, file.BaseName());
+    return r.error().WithContext("saving checkpoint {}", file);
+  }
+
+  writes_ = std::move(group);
+  pending_analytic_ = analytic;
+  pending_iteration_ = iteration;
+  pending_file_ = file.BaseName();
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Finish() {
+  if (!writes_) {
+    return ResultSuccess();
+  }
+  std::unique_ptr<tsuba::WriteGroup> writes = std::move(writes_);
+  std::string file = std::move(pending_file_);
+  pending_file_.clear();
+
+  if (auto r = writes->Finish(); !r) {
+    DeleteFile(dir_, file);
+    return r.error().WithContext("saving checkpoint {}", dir_.Join(file));
+  }
+
+  // The checkpoint is complete once the manifest names it
+  Manifest manifest{pending_analytic_, pending_iteration_, file};
+  auto json_res = katana::JsonDump(manifest);
+  if (!json_res) {
+    DeleteFile(dir_, file);
+    return json_res.error();
+  }
+  const std::string& json = json_res.value();
+  katana::Uri manifest_uri = ManifestUri();
+  if (auto r =
+          tsuba::FileStore(manifest_uri.string(), json.data(), json.size());
+      !r) {
+    DeleteFile(dir_, file);
+    return r.error().WithContext("storing {}", manifest_uri);
+  }
+
+  DeleteFile(dir_, committed_file_);
+  committed_file_ = std::move(file);
+  return ResultSuccess();
+}
+
+katana::Result<std::optional<katana::analytics::Checkpointer::Checkpoint>>
+katana::analytics::Checkpointer::Restore(const std::string& analytic) {
+  if (auto r = Finish(); !r) {
+    KATANA_LOG_WARN("checkpoint not saved: {}", r.error());
+  }
+
+  auto manifest_res = ReadManifest(ManifestUri());
+  if (!manifest_res) {
+    return manifest_res.error();
+  }
+  if (!manifest_res.value()) {
+    return std::optional<Checkpoint>();
+  }
+  Manifest& manifest = *manifest_res.value();
+  committed_file_ = manifest.file;
+  if (manifest.analytic != analytic) {
+    return std::optional<Checkpoint>();
+  }
+
+  auto reader_res = tsuba::ParquetReader::Make();
+  if (!reader_res) {
+    return reader_res.error();
+  }
+  katana::Uri file = dir_.Join(manifest.file);
+  auto state_res = reader_res.value()->ReadTable(file);
+  if (!state_res) {
+    return state_res.error().WithContext("reading checkpoint {}", file);
+  }
+  return std::optional<Checkpoint>(Checkpoint{
+      std::move(manifest.analytic), manifest.iteration,
+      std::move(state_res.value())});
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Clear() {
+  if (auto r = Finish(); !r) {
+    KATANA_LOG_DEBUG("checkpoint not saved: {}", r.error());
+  }
+
+  katana::Uri manifest_uri = ManifestUri();
+  auto manifest_res = ReadManifest(manifest_uri);
+  if (!manifest_res) {
+    return manifest_res.error();
+  }
+  if (!manifest_res.value()) {
+    return ResultSuccess();
+  }
+  // A checkpointer made after a preemption knows the file only from the
+  // manifest
+  committed_file_ = manifest_res.value()->file;
+
+  // Delete the manifest first so that a checkpoint is never named without
+  // its file
+  std::unordered_set<std::string> manifest_file{manifest_uri.BaseName()};
+  if (auto r = tsuba::FileDelete(dir_.string(), manifest_file); !r) {
+    return r.error().WithContext("deleting {}", manifest_uri);
+  }
+  DeleteFile(dir_, committed_file_);
+  committed_file_.clear();
+  return ResultSuccess();
+}
+
+katana::analytics::CheckpointScope::CheckpointScope(Checkpointer* checkpointer)
+    : prev_(current_checkpointer) {
+  current_checkpointer = checkpointer;
+}
+
+katana::analytics::CheckpointScope::~CheckpointScope() {
+  current_checkpointer = prev_;
+}
+
+katana::analytics::Checkpointer*
+katana::analytics::CurrentCheckpointer() {
+  return current_checkpointer;
+}
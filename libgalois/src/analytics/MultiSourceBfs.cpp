@@ -0,0 +1,109 @@
+#include "katana/analytics/MultiSourceBfs.h"
+
+#include "katana/Galois.h"
+
+namespace {
+
+constexpr unsigned kChunkSize = 64;
+
+}  // namespace
+
+katana::analytics::MultiSourceBfs::MultiSourceBfs(
+    const GraphTopology& topology)
+    : topology_(topology) {
+  katana::CreateBlocked(topology_.num_nodes(), &seen_, &next_, &marks_);
+}
+
+void
+katana::analytics::MultiSourceBfs::ClearMarks() {
+  if (!has_marks_) {
+    return;
+  }
+  katana::do_all(
+      katana::iterate(levels_[marked_level_]),
+      [&](const Visit& v) { marks_[v.node] = 0; }, katana::no_stats(),
+      katana::loopname("MultiSourceBfsClearMarks"));
+  has_marks_ = false;
+}
+
+void
+katana::analytics::MultiSourceBfs::MarkLevel(size_t d) {
+  KATANA_LOG_DEBUG_ASSERT(d < num_levels());
+  if (has_marks_ && marked_level_ == d) {
+    return;
+  }
+  ClearMarks();
+  katana::do_all(
+      katana::iterate(levels_[d]),
+      [&](const Visit& v) { marks_[v.node] = v.sources; }, katana::no_stats(),
+      katana::loopname("MultiSourceBfsMarkLevel"));
+  marked_level_ = d;
+  has_marks_ = true;
+}
+
+void
+katana::analytics::MultiSourceBfs::Run(
+    const Node* sources, size_t num_sources) {
+  KATANA_LOG_ASSERT(num_sources <= kMaxSources);
+
+  // Undo the previous search
+  ClearMarks();
+  for (auto& level : levels_) {
+    katana::do_all(
+        katana::iterate(level), [&](const Visit& v) { seen_[v.node] = 0; },
+        katana::no_stats(), katana::loopname("MultiSourceBfsReset"));
+  }
+  levels_.clear();
+
+  levels_.emplace_back();
+  for (size_t i = 0; i < num_sources; ++i) {
+    Node s = sources[i];
+    if (!seen_[s]) {
+      discovered_.push(s);
+    }
+    seen_[s] |= Mask{1} << i;
+  }
+  for (Node s : discovered_) {
+    levels_[0].push(Visit{s, seen_[s]});
+  }
+  discovered_.clear();
+
+  while (true) {
+    Level& current = levels_.back();
+
+    // Expand every node of the level once for all of its sources. seen_ is
+    // only updated between levels, so the bits a neighbor receives are
+    // exactly the sources for which it is one step further away.
+    katana::do_all(
+        katana::iterate(current),
+        [&](const Visit& v) {
+          for (auto e : topology_.edges(v.node)) {
+            Node dst = topology_.edge_dest(e);
+            Mask bits = v.sources & ~seen_[dst];
+            if (bits && (next_[dst] & bits) != bits) {
+              if (__sync_fetch_and_or(&next_[dst], bits) == 0) {
+                discovered_.push(dst);
+              }
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(), katana::no_stats(),
+        katana::loopname("MultiSourceBfsExpand"));
+
+    if (discovered_.empty()) {
+      break;
+    }
+
+    Level& next = levels_.emplace_back();
+    katana::do_all(
+        katana::iterate(discovered_),
+        [&](Node n) {
+          Mask bits = next_[n];
+          next_[n] = 0;
+          seen_[n] |= bits;
+          next.push(Visit{n, bits});
+        },
+        katana::no_stats(), katana::loopname("MultiSourceBfsAdvance"));
+    discovered_.clear();
+  }
+}
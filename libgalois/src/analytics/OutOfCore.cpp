@@ -0,0 +1,228 @@
+#include "katana/analytics/OutOfCore.h"
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+using Node = katana::SegmentedTopology::Node;
+using Segment = katana::SegmentedTopology::Segment;
+
+template <typename T>
+katana::LargeArray<std::atomic<T>>
+MakeAtomicArray(uint64_t size) {
+  katana::LargeArray<std::atomic<T>> array;
+  array.allocateBlocked(size);
+  return array;
+}
+
+template <typename T>
+katana::LargeArray<T>
+CopyOut(const katana::LargeArray<std::atomic<T>>& array) {
+  katana::LargeArray<T> out;
+  out.allocateBlocked(array.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, array.size()),
+      [&](size_t n) { out[n] = array[n].load(std::memory_order_relaxed); },
+      katana::no_stats());
+  return out;
+}
+
+}  // namespace
+
+katana::Result<katana::LargeArray<uint32_t>>
+katana::analytics::OutOfCoreBfs(SegmentedTopology* topology, uint32_t source) {
+  uint64_t num_nodes = topology->num_nodes();
+  if (source >= num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "source {} is not a node", source);
+  }
+
+  auto levels = MakeAtomicArray<uint32_t>(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        levels[n].store(kOutOfCoreUnreached, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  levels[source] = 0;
+
+  // Whether each segment has nodes in the current and next frontier
+  size_t num_segments = topology->segments().size();
+  std::vector<std::atomic<bool>> in_frontier(num_segments);
+  std::vector<std::atomic<bool>> in_next(num_segments);
+  in_frontier[topology->segment_of(source)] = true;
+
+  for (uint32_t level = 0;; ++level) {
+    katana::GReduceLogicalOr discovered;
+    auto res = ForEachSegment(
+        topology,
+        [&](const Segment& segment) {
+          katana::do_all(
+              katana::iterate(segment.begin, segment.end),
+              [&](Node n) {
+                if (levels[n].load(std::memory_order_relaxed) != level) {
+                  return;
+                }
+                for (auto e : topology->edges(n)) {
+                  Node dst = topology->edge_dest(e);
+                  uint32_t unreached = kOutOfCoreUnreached;
+                  if (levels[dst].compare_exchange_strong(
+                          unreached, level + 1, std::memory_order_relaxed)) {
+                    in_next[topology->segment_of(dst)].store(
+                        true, std::memory_order_relaxed);
+                    discovered.update(true);
+                  }
+                }
+              },
+              katana::steal(), katana::no_stats(),
+              katana::loopname("OutOfCoreBfs"));
+        },
+        [&](size_t i) { return in_frontier[i].load(); });
+    if (!res) {
+      return res.error();
+    }
+    if (!discovered.reduce()) {
+      break;
+    }
+    for (size_t i = 0; i < num_segments; ++i) {
+      in_frontier[i] = in_next[i].load();
+      in_next[i] = false;
+    }
+  }
+
+  return CopyOut(levels);
+}
+
+katana::Result<katana::LargeArray<uint32_t>>
+katana::analytics::OutOfCoreConnectedComponents(SegmentedTopology* topology) {
+  uint64_t num_nodes = topology->num_nodes();
+  auto components = MakeAtomicArray<uint32_t>(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { components[n].store(n, std::memory_order_relaxed); },
+      katana::no_stats());
+
+  // Every label is a node of the component with an id no larger than that of
+  // the labeled node, so labels only decrease and jumping to the label of a
+  // label stays in the component
+  for (bool changed = true; changed;) {
+    katana::GReduceLogicalOr lowered;
+    auto res = ForEachSegment(topology, [&](const Segment& segment) {
+      katana::do_all(
+          katana::iterate(segment.begin, segment.end),
+          [&](Node n) {
+            for (auto e : topology->edges(n)) {
+              Node dst = topology->edge_dest(e);
+              uint32_t src_label =
+                  components[n].load(std::memory_order_relaxed);
+              uint32_t dst_label =
+                  components[dst].load(std::memory_order_relaxed);
+              if (src_label < dst_label) {
+                if (katana::atomicMin(components[dst], src_label) > src_label) {
+                  lowered.update(true);
+                }
+              } else if (dst_label < src_label) {
+                if (katana::atomicMin(components[n], dst_label) > dst_label) {
+                  lowered.update(true);
+                }
+              }
+            }
+          },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("OutOfCoreConnectedComponents"));
+    });
+    if (!res) {
+      return res.error();
+    }
+    changed = lowered.reduce();
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint32_t label = components[n].load(std::memory_order_relaxed);
+          uint32_t next = components[label].load(std::memory_order_relaxed);
+          while (next != label) {
+            label = next;
+            next = components[label].load(std::memory_order_relaxed);
+          }
+          katana::atomicMin(components[n], label);
+        },
+        katana::no_stats());
+  }
+
+  return CopyOut(components);
+}
+
+katana::Result<katana::LargeArray<float>>
+katana::analytics::OutOfCorePagerank(
+    SegmentedTopology* topology, const OutOfCorePagerankPlan& plan) {
+  uint64_t num_nodes = topology->num_nodes();
+  LargeArray<float> ranks;
+  ranks.allocateBlocked(num_nodes);
+  if (num_nodes == 0) {
+    return ranks;
+  }
+  float initial = 1.0f / num_nodes;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { ranks[n] = initial; }, katana::no_stats());
+
+  auto sums = MakeAtomicArray<float>(num_nodes);
+  for (uint32_t iter = 0; iter < plan.max_iterations; ++iter) {
+    katana::GAccumulator<double> dangling;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          sums[n].store(0, std::memory_order_relaxed);
+          if (topology->degree(n) == 0) {
+            dangling += ranks[n];
+          }
+        },
+        katana::no_stats());
+
+    auto res = ForEachSegment(topology, [&](const Segment& segment) {
+      katana::do_all(
+          katana::iterate(segment.begin, segment.end),
+          [&](Node n) {
+            auto edges = topology->edges(n);
+            if (edges.empty()) {
+              return;
+            }
+            float contribution = ranks[n] / edges.size();
+            for (auto e : edges) {
+              katana::atomicAdd(sums[topology->edge_dest(e)], contribution);
+            }
+          },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("OutOfCorePagerank"));
+    });
+    if (!res) {
+      return res.error();
+    }
+
+    float base = (1.0f - plan.alpha) / num_nodes +
+                 plan.alpha * static_cast<float>(dangling.reduce()) / num_nodes;
+    katana::GAccumulator<double> change;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          float rank =
+              base + plan.alpha * sums[n].load(std::memory_order_relaxed);
+          change += std::fabs(rank - ranks[n]);
+          ranks[n] = rank;
+        },
+        katana::no_stats());
+    if (change.reduce() < plan.tolerance) {
+      break;
+    }
+  }
+
+  return ranks;
+}
@@ -0,0 +1,73 @@
+#include "katana/analytics/ResultCache.h"
+
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// The derivation recorded on outputs, or empty if the inputs are not
+/// stored as they are
+katana::Result<std::string>
+Derivation(
+    const katana::PropertyGraph& pg,
+    const katana::analytics::AnalyticSignature& signature) {
+  std::string version =
+      pg.StoredVersion(signature.node_properties, signature.edge_properties);
+  if (version.empty()) {
+    return std::string();
+  }
+  return katana::JsonDump(nlohmann::json{
+      {"analytic", signature.analytic},
+      {"input_version", version},
+  });
+}
+
+}  // namespace
+
+katana::Result<bool>
+katana::analytics::MemoizeNodeProperty(
+    PropertyGraph* pg, const AnalyticSignature& signature,
+    const std::string& output_property_name, const std::string& command_line,
+    const std::function<Result<void>()>& compute) {
+  auto derivation_res = Derivation(*pg, signature);
+  if (!derivation_res) {
+    return derivation_res.error();
+  }
+  const std::string& derivation = derivation_res.value();
+
+  if (pg->node_schema()->GetFieldIndex(output_property_name) >= 0) {
+    std::string stored = pg->GetNodePropertyDerivation(output_property_name);
+    if (!derivation.empty() && stored == derivation) {
+      KATANA_LOG_DEBUG(
+          "reusing {} computed by {}", output_property_name,
+          signature.analytic);
+      return true;
+    }
+    // Only outputs of memoized analytics are stale; others are the
+    // caller's and computing fails as usual
+    if (!stored.empty()) {
+      if (auto res = pg->RemoveNodeProperty(output_property_name); !res) {
+        return res.error().WithContext(
+            "removing stale {}", output_property_name);
+      }
+    }
+  }
+
+  if (auto res = compute(); !res) {
+    return res.error();
+  }
+  if (derivation.empty()) {
+    return false;
+  }
+
+  if (auto res =
+          pg->SetNodePropertyDerivation(output_property_name, derivation);
+      !res) {
+    return res.error().WithContext(
+        "{} did not write {}", signature.analytic, output_property_name);
+  }
+  if (auto res = pg->Commit(command_line); !res) {
+    return res.error().WithContext("storing {}", output_property_name);
+  }
+  return false;
+}
@@ -0,0 +1,62 @@
+#include "katana/analytics/SharedScan.h"
+
+katana::analytics::DegreeKernel::DegreeKernel(const GraphTopology& topology)
+    : degrees_(topology.num_nodes()) {}
+
+katana::analytics::PagerankKernel::PagerankKernel(
+    const GraphTopology& topology, PagerankPlan plan)
+    : plan_(plan),
+      base_score_((1.0f - plan.alpha()) / topology.num_nodes()),
+      ranks_(topology.num_nodes(), 1.0f / topology.num_nodes()),
+      out_degrees_(topology.num_nodes()),
+      contributions_(topology.num_nodes()) {
+  // In-edges of the transpose are the out-edges of the graph to rank
+  do_all(
+      iterate(topology),
+      [&](GraphTopology::Node n) {
+        for (auto e : topology.edges(n)) {
+          __sync_fetch_and_add(&out_degrees_[topology.edge_dest(e)], 1);
+        }
+      },
+      steal(), no_stats(), loopname("PagerankKernelDegrees"));
+}
+
+bool
+katana::analytics::PagerankKernel::BeginIteration(uint32_t iteration) {
+  if (converged_ || iteration >= plan_.max_iterations()) {
+    return false;
+  }
+  do_all(
+      iterate(size_t{0}, ranks_.size()),
+      [&](size_t n) {
+        contributions_[n] =
+            out_degrees_[n] > 0 ? ranks_[n] / out_degrees_[n] : 0;
+      },
+      no_stats(), loopname("PagerankKernelContributions"));
+  delta_.reset();
+  return true;
+}
+
+void
+katana::analytics::PagerankKernel::EndIteration() {
+  converged_ = delta_.reduce() <= plan_.tolerance();
+}
+
+katana::analytics::LabelPropagationKernel::LabelPropagationKernel(
+    const GraphTopology& topology)
+    : labels_(topology.num_nodes()), next_labels_(topology.num_nodes()) {
+  do_all(
+      iterate(size_t{0}, labels_.size()), [&](size_t n) { labels_[n] = n; },
+      no_stats(), loopname("LabelPropagationKernelInit"));
+}
+
+void
+katana::analytics::LabelPropagationKernel::EndIteration() {
+  labels_.swap(next_labels_);
+  changed_ = num_changed_.reduce() > 0;
+  num_changed_.reset();
+}
+
+katana::analytics::NeighborMeanKernel::NeighborMeanKernel(
+    std::vector<double> values)
+    : values_(std::move(values)), means_(values_.size()) {}
@@ -0,0 +1,465 @@
+#include "katana/analytics/Sparsify.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <numeric>
+
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using katana::analytics::SparsifyPlan;
+
+/// The number of edges whose sampling weights decide the scale of the
+/// sampling probabilities of the degree biased and spectral plans
+constexpr uint64_t kScaleSampleEdges = 1U << 16U;
+
+uint64_t
+Mix(uint64_t x) {
+  // splitmix64
+  x += UINT64_C(0x9e3779b97f4a7c15);
+  x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+/// \returns a uniform double in [0, 1) from the bits of x
+double
+ToUnit(uint64_t x) {
+  return static_cast<double>(x >> 11U) * 0x1.0p-53;
+}
+
+/// \returns a uniform double in [0, 1) that depends only on seed and the
+/// unordered pair of nodes
+double
+EdgeUniform(uint64_t seed, Node a, Node b) {
+  uint64_t lo = std::min(a, b);
+  uint64_t hi = std::max(a, b);
+  return ToUnit(Mix(seed ^ Mix(hi << 32U | lo)));
+}
+
+/// The unscaled weight by which plan samples an edge between nodes of the
+/// given degrees
+double
+EdgeWeight(SparsifyPlan::Algorithm algorithm, uint64_t a, uint64_t b) {
+  if (algorithm == SparsifyPlan::kDegreeBiasedEdge) {
+    return static_cast<double>(a + b);
+  }
+  KATANA_LOG_DEBUG_ASSERT(algorithm == SparsifyPlan::kSpectral);
+  return 1.0 / std::max<uint64_t>(a, 1) + 1.0 / std::max<uint64_t>(b, 1);
+}
+
+/// \returns the scale c for which keeping each edge with probability
+/// min(1, c * weight) keeps about fraction of the edges, solved on an
+/// evenly spaced sample of the edges
+double
+WeightScale(
+    const katana::GraphTopology& topology, SparsifyPlan::Algorithm algorithm,
+    double fraction) {
+  uint64_t num_edges = topology.num_edges();
+  uint64_t num_samples = std::min(num_edges, kScaleSampleEdges);
+  std::vector<double> weights(num_samples);
+  const uint64_t* indices = topology.out_indices->raw_values();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_samples),
+      [&](uint64_t s) {
+        uint64_t e = s * num_edges / num_samples;
+        Node src =
+            std::upper_bound(indices, indices + topology.num_nodes(), e) -
+            indices;
+        Node dst = topology.edge_dest(e);
+        weights[s] = EdgeWeight(
+            algorithm, topology.edges(src).size(), topology.edges(dst).size());
+      },
+      katana::no_stats());
+
+  double target = fraction * num_samples;
+  auto kept = [&](double c) {
+    double sum = 0;
+    for (double w : weights) {
+      sum += std::min(1.0, c * w);
+    }
+    return sum;
+  };
+  double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+  double lo = total > 0 ? target / total : 0;
+  double hi = lo;
+  while (hi > 0 && kept(hi) < target) {
+    hi *= 2;
+  }
+  // Bisect in the ratio of the bounds; 0.1% is within the noise of the
+  // sampling
+  while (hi > lo * 1.001) {
+    double mid = std::sqrt(lo * hi);
+    (kept(mid) < target ? lo : hi) = mid;
+  }
+  return hi;
+}
+
+/// Decide the edges kept by an edge sampling plan and the inverse of the
+/// probability of each
+void
+SampleEdges(
+    const katana::GraphTopology& topology, const SparsifyPlan& plan,
+    std::vector<uint8_t>* keep, std::vector<double>* inverse_probability) {
+  double scale = plan.algorithm() == SparsifyPlan::kUniformEdge
+                     ? 0
+                     : WeightScale(
+                           topology, plan.algorithm(), plan.edge_fraction());
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node src) {
+        uint64_t src_degree = topology.edges(src).size();
+        for (auto e : topology.edges(src)) {
+          Node dst = topology.edge_dest(e);
+          double p = plan.edge_fraction();
+          if (plan.algorithm() != SparsifyPlan::kUniformEdge) {
+            p = std::min(
+                1.0, scale * EdgeWeight(
+                                 plan.algorithm(), src_degree,
+                                 topology.edges(dst).size()));
+          }
+          bool kept = EdgeUniform(plan.seed(), src, dst) < p;
+          (*keep)[e] = kept;
+          (*inverse_probability)[e] = kept ? 1 / p : 0;
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("SparsifySampleEdges"));
+}
+
+/// A small random number generator for one forest fire
+class FireRandom {
+public:
+  explicit FireRandom(uint64_t seed) : state_(Mix(seed)) {}
+
+  uint64_t Next() { return Mix(state_++); }
+
+  double Uniform() { return ToUnit(Next()); }
+
+private:
+  uint64_t state_;
+};
+
+/// Burn nodes by forest fires started at nodes of order, from *next_seed
+/// on, until target nodes are burned
+void
+BurnForestFires(
+    const katana::GraphTopology& topology, const SparsifyPlan& plan,
+    const std::vector<Node>& order, uint64_t target,
+    std::vector<std::atomic<uint8_t>>* burned,
+    std::atomic<uint64_t>* num_burned, uint64_t* next_seed) {
+  // Negative, or -inf for a burn probability of 0
+  double log_burn = std::log(plan.burn_probability());
+  uint64_t wave_size = 4 * katana::getActiveThreads();
+
+  while (num_burned->load() < target && *next_seed < order.size()) {
+    uint64_t wave_begin = *next_seed;
+    uint64_t wave_end =
+        std::min<uint64_t>(order.size(), wave_begin + wave_size);
+    *next_seed = wave_end;
+
+    katana::do_all(
+        katana::iterate(wave_begin, wave_end),
+        [&](uint64_t fire) {
+          Node start = order[fire];
+          if ((*burned)[start].exchange(1)) {
+            return;
+          }
+          ++*num_burned;
+          FireRandom random(plan.seed() ^ Mix(fire));
+          std::deque<Node> queue{start};
+          while (!queue.empty() && num_burned->load() < target) {
+            Node n = queue.front();
+            queue.pop_front();
+            auto edges = topology.edges(n);
+            uint64_t degree = edges.size();
+            if (degree == 0) {
+              continue;
+            }
+            // A geometric number of neighbors, with mean p / (1 - p)
+            auto spread = static_cast<uint64_t>(
+                std::floor(std::log(1 - random.Uniform()) / log_burn));
+            uint64_t first_edge = *edges.begin();
+            uint64_t offset = random.Next() % degree;
+            for (uint64_t i = 0; i < degree && spread > 0; ++i) {
+              Node dst =
+                  topology.edge_dest(first_edge + (offset + i) % degree);
+              if ((*burned)[dst].exchange(1) == 0) {
+                ++*num_burned;
+                queue.emplace_back(dst);
+                --spread;
+              }
+            }
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("SparsifyForestFire"));
+  }
+}
+
+/// Decide the edges kept by a forest fire plan: those among burned nodes
+void
+SampleForestFire(
+    const katana::GraphTopology& topology, const SparsifyPlan& plan,
+    std::vector<uint8_t>* keep) {
+  uint64_t num_nodes = topology.num_nodes();
+  std::vector<Node> order(num_nodes);
+  std::iota(order.begin(), order.end(), Node{0});
+  katana::ParallelSTL::radix_sort(order.begin(), order.end(), [&](Node n) {
+    return Mix(plan.seed() ^ n);
+  });
+
+  std::vector<std::atomic<uint8_t>> burned(num_nodes);
+  std::atomic<uint64_t> num_burned{0};
+  uint64_t next_seed = 0;
+  double target_edges = plan.edge_fraction() * topology.num_edges();
+  // A uniform node sample of fraction q induces about q^2 of the edges;
+  // fires burn denser neighborhoods, so start there and grow the target
+  // by the edges still missing
+  auto target_nodes = static_cast<uint64_t>(
+      std::ceil(std::sqrt(plan.edge_fraction()) * num_nodes));
+
+  while (true) {
+    BurnForestFires(
+        topology, plan, order, target_nodes, &burned, &num_burned, &next_seed);
+
+    katana::GAccumulator<uint64_t> induced;
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node src) {
+          bool src_burned = burned[src].load(std::memory_order_relaxed);
+          uint64_t kept = 0;
+          for (auto e : topology.edges(src)) {
+            bool k = src_burned &&
+                     burned[topology.edge_dest(e)].load(
+                         std::memory_order_relaxed);
+            (*keep)[e] = k;
+            kept += k;
+          }
+          induced += kept;
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("SparsifyForestFireEdges"));
+
+    uint64_t burned_now = num_burned.load();
+    if (induced.reduce() >= target_edges || burned_now >= num_nodes ||
+        next_seed >= num_nodes) {
+      return;
+    }
+    double missing =
+        std::sqrt(target_edges / std::max<uint64_t>(induced.reduce(), 1));
+    target_nodes = std::min<uint64_t>(
+        num_nodes,
+        std::max<uint64_t>(burned_now + 1, std::ceil(burned_now * missing)));
+  }
+}
+
+template <typename ArrowArray>
+katana::Result<std::shared_ptr<ArrowArray>>
+AllocateArray(uint64_t length) {
+  using CType = typename ArrowArray::TypeClass::c_type;
+  auto buffer_res = arrow::AllocateBuffer(length * sizeof(CType));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} values: {}", length,
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  return std::make_shared<ArrowArray>(length, buffer);
+}
+
+template <typename ArrowArray>
+auto*
+MutableValues(const std::shared_ptr<ArrowArray>& array) {
+  using CType = typename ArrowArray::TypeClass::c_type;
+  return reinterpret_cast<CType*>(array->values()->mutable_data());
+}
+
+/// The edge properties names of pg at the kept edge ids, and the sample
+/// weight of each kept edge
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeEdgeProperties(
+    katana::PropertyGraph* pg, const std::vector<std::string>& names,
+    const std::shared_ptr<arrow::UInt64Array>& edge_ids,
+    const std::shared_ptr<arrow::DoubleArray>& weights) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const std::string& name : names) {
+    auto property = pg->GetEdgeProperty(name);
+    if (!property) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no edge property {}", name);
+    }
+    auto take_res = arrow::compute::Take(
+        arrow::Datum(property), arrow::Datum(edge_ids));
+    if (!take_res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(take_res.status()), "taking {}: {}", name,
+          take_res.status());
+    }
+    fields.emplace_back(arrow::field(name, property->type()));
+    columns.emplace_back(take_res.ValueOrDie().chunked_array());
+  }
+  fields.emplace_back(arrow::field(
+      katana::analytics::SparsifiedGraph::kWeightProperty, arrow::float64()));
+  columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{weights}));
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+}  // namespace
+
+katana::Result<katana::analytics::SparsifiedGraph>
+katana::analytics::Sparsify(
+    PropertyGraph* pg, SparsifyPlan plan,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) {
+  if (!(plan.edge_fraction() > 0 && plan.edge_fraction() <= 1)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "edge fraction {} is not in (0, 1]",
+        plan.edge_fraction());
+  }
+  if (plan.algorithm() == SparsifyPlan::kForestFire &&
+      !(plan.burn_probability() >= 0 && plan.burn_probability() < 1)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "burn probability {} is not in [0, 1)",
+        plan.burn_probability());
+  }
+
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  std::vector<uint8_t> keep(num_edges);
+  std::vector<double> inverse_probability(num_edges);
+
+  switch (plan.algorithm()) {
+  case SparsifyPlan::kUniformEdge:
+  case SparsifyPlan::kDegreeBiasedEdge:
+  case SparsifyPlan::kSpectral:
+    SampleEdges(topology, plan, &keep, &inverse_probability);
+    break;
+  case SparsifyPlan::kForestFire:
+    SampleForestFire(topology, plan, &keep);
+    break;
+  default:
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  auto indices_res = AllocateArray<arrow::UInt64Array>(num_nodes);
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  std::shared_ptr<arrow::UInt64Array> out_indices = indices_res.value();
+  uint64_t* indices = MutableValues(out_indices);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        uint64_t kept = 0;
+        for (auto e : topology.edges(n)) {
+          kept += keep[e];
+        }
+        indices[n] = kept;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+  uint64_t num_kept = num_nodes == 0 ? 0 : indices[num_nodes - 1];
+
+  auto dests_res = AllocateArray<arrow::UInt32Array>(num_kept);
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto edge_ids_res = AllocateArray<arrow::UInt64Array>(num_kept);
+  if (!edge_ids_res) {
+    return edge_ids_res.error();
+  }
+  auto weights_res = AllocateArray<arrow::DoubleArray>(num_kept);
+  if (!weights_res) {
+    return weights_res.error();
+  }
+  uint32_t* dests = MutableValues(dests_res.value());
+  uint64_t* edge_ids = MutableValues(edge_ids_res.value());
+  double* weights = MutableValues(weights_res.value());
+  double edge_fraction =
+      num_edges == 0 ? 1 : static_cast<double>(num_kept) / num_edges;
+
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        uint64_t out = n == 0 ? 0 : indices[n - 1];
+        for (auto e : topology.edges(n)) {
+          if (!keep[e]) {
+            continue;
+          }
+          dests[out] = topology.edge_dest(e);
+          edge_ids[out] = e;
+          // The inclusion probability of an edge of a forest fire is not
+          // known; each stands for the same share of the original
+          weights[out] = plan.algorithm() == SparsifyPlan::kForestFire
+                             ? 1 / edge_fraction
+                             : inverse_probability[e];
+          ++out;
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("SparsifyFill"));
+
+  auto sample = std::make_unique<PropertyGraph>();
+  if (auto r = sample->SetTopology(GraphTopology{
+          .out_indices = out_indices,
+          .out_dests = dests_res.value(),
+      });
+      !r) {
+    return r.error();
+  }
+
+  if (!node_properties.empty()) {
+    // The nodes are the same, so the properties are shared as they are
+    auto keep_chunks =
+        arrow::key_value_metadata({PropertyGraph::kKeepChunksKey}, {"true"});
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (const std::string& name : node_properties) {
+      auto property = pg->GetNodeProperty(name);
+      if (!property) {
+        return KATANA_ERROR(
+            ErrorCode::PropertyNotFound, "no node property {}", name);
+      }
+      fields.emplace_back(
+          arrow::field(name, property->type())->WithMetadata(keep_chunks));
+      columns.emplace_back(property);
+    }
+    if (auto r = sample->AddNodeProperties(
+            arrow::Table::Make(arrow::schema(fields), columns));
+        !r) {
+      return r.error();
+    }
+  }
+
+  auto edge_props_res = MakeEdgeProperties(
+      pg, edge_properties, edge_ids_res.value(), weights_res.value());
+  if (!edge_props_res) {
+    return edge_props_res.error().WithContext("copying edge properties");
+  }
+  if (auto r = sample->AddEdgeProperties(edge_props_res.value()); !r) {
+    return r.error();
+  }
+
+  return SparsifiedGraph{std::move(sample), edge_fraction};
+}
+
+void
+katana::analytics::ApproximationStatistics::Print(std::ostream& os) const {
+  os << "Sample edges = " << sample_edges << std::endl;
+  os << "Edge fraction = " << edge_fraction << std::endl;
+  os << "Estimated error = " << estimated_error << std::endl;
+}
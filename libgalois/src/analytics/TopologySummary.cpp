@@ -0,0 +1,123 @@
+#include "katana/analytics/TopologySummary.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "tsuba/RDGPrefix.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+/// Degrees of up to 64 bits, by bit width
+using Histogram = std::array<uint64_t, 65>;
+
+uint64_t
+DegreeOf(const uint64_t* out_indices, uint64_t n) {
+  return out_indices[n] - (n == 0 ? 0 : out_indices[n - 1]);
+}
+
+uint32_t
+BucketOf(uint64_t degree) {
+  uint32_t bucket = 0;
+  while (degree > 0) {
+    degree >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+}  // namespace
+
+katana::analytics::TopologySummary
+katana::analytics::TopologySummary::Make(
+    const uint64_t* out_indices, uint64_t num_nodes, uint64_t num_edges) {
+  TopologySummary summary;
+  summary.num_nodes = num_nodes;
+  summary.num_edges = num_edges;
+  if (num_nodes == 0) {
+    return summary;
+  }
+  summary.average_degree = static_cast<double>(num_edges) / num_nodes;
+
+  katana::PerThreadStorage<Histogram> histograms;
+  katana::GReduceMax<uint64_t> max_degree;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t degree = DegreeOf(out_indices, n);
+        (*histograms.getLocal())[BucketOf(degree)] += 1;
+        max_degree.update(degree);
+      },
+      katana::no_stats());
+  Histogram histogram{};
+  for (unsigned t = 0; t < katana::getActiveThreads(); ++t) {
+    const Histogram& local = *histograms.getRemote(t);
+    for (size_t i = 0; i < histogram.size(); ++i) {
+      histogram[i] += local[i];
+    }
+  }
+  size_t num_buckets = histogram.size();
+  while (num_buckets > 1 && histogram[num_buckets - 1] == 0) {
+    --num_buckets;
+  }
+  summary.degree_histogram.assign(
+      histogram.begin(), histogram.begin() + num_buckets);
+  summary.num_isolated_nodes = histogram[0];
+  summary.max_degree = max_degree.reduce();
+  if (summary.num_isolated_nodes == num_nodes) {
+    return summary;
+  }
+
+  // Sample nodes with edges as IsApproximateDegreeDistributionPowerLaw does
+  // on a loaded graph, so that both choose the same plans
+  uint64_t num_samples = std::min<uint64_t>(1000, num_nodes);
+  std::vector<uint64_t> samples(num_samples);
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<uint64_t> dist(0, num_nodes - 1);
+  for (uint64_t& sample : samples) {
+    do {
+      sample = DegreeOf(out_indices, dist(gen));
+    } while (sample == 0);
+  }
+  std::sort(samples.begin(), samples.end());
+  summary.sample_median_degree = samples[num_samples / 2];
+  double sample_average = 0;
+  for (uint64_t sample : samples) {
+    sample_average += sample;
+  }
+  sample_average /= num_samples;
+  summary.power_law = num_nodes >= 10 && num_edges / num_nodes >= 10 &&
+                      sample_average / 1.3 > summary.sample_median_degree;
+  return summary;
+}
+
+katana::Result<katana::analytics::TopologySummary>
+katana::analytics::TopologySummary::Make(const tsuba::RDGPrefix& prefix) {
+  if (!prefix.has_topology()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "graph has no stored topology");
+  }
+  return Make(prefix.out_indexes(), prefix.num_nodes(), prefix.num_edges());
+}
+
+katana::Result<katana::analytics::TopologySummary>
+katana::analytics::TopologySummary::Make(const std::string& rdg_name) {
+  auto handle_res = tsuba::Open(rdg_name, tsuba::kReadOnly);
+  if (!handle_res) {
+    return handle_res.error();
+  }
+  // Closes the handle
+  tsuba::RDGFile file(handle_res.value());
+
+  auto prefix_res = tsuba::RDGPrefix::Make(file);
+  if (!prefix_res) {
+    return prefix_res.error().WithContext("reading topology of {}", rdg_name);
+  }
+  return Make(prefix_res.value());
+}
@@ -19,7 +19,12 @@
 
 #include "katana/analytics/Utils.h"
 
+#include <cmath>
+#include <limits>
+
+#include "katana/Galois.h"
 #include "katana/Random.h"
+#include "katana/Reduction.h"
 
 uint32_t
 katana::analytics::SourcePicker::PickNext() {
@@ -64,5 +69,70 @@ katana::analytics::IsApproximateDegreeDistributionPowerLaw(
   return sample_average / 1.3 > sample_median;
 }
 
+namespace {
+
+using Edge = katana::GraphTopology::Edge;
+
+template <typename T>
+katana::Result<std::vector<double>>
+EdgeWeightsWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  auto weights_result = pg->GetEdgePropertyTyped<T>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto weights = weights_result.value();
+
+  std::vector<double> result(pg->topology().num_edges());
+  katana::GReduceMin<Edge> invalid;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{result.size()}),
+      [&](Edge e) {
+        result[e] = weights->Value(e);
+        // Also catches NaN
+        if (!(result[e] >= 0) || std::isinf(result[e])) {
+          invalid.update(e);
+        }
+      },
+      katana::no_stats());
+  if (Edge e = invalid.reduce(); e != std::numeric_limits<Edge>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge {} has weight {}, which is not a finite non-negative number", e,
+        result[e]);
+  }
+  return result;
+}
+
+}  // namespace
+
+katana::Result<std::vector<double>>
+katana::analytics::NonNegativeEdgeWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return EdgeWeightsWithWrap<uint32_t>(pg, edge_weight_property_name);
+  case arrow::Int32Type::type_id:
+    return EdgeWeightsWithWrap<int32_t>(pg, edge_weight_property_name);
+  case arrow::UInt64Type::type_id:
+    return EdgeWeightsWithWrap<uint64_t>(pg, edge_weight_property_name);
+  case arrow::Int64Type::type_id:
+    return EdgeWeightsWithWrap<int64_t>(pg, edge_weight_property_name);
+  case arrow::FloatType::type_id:
+    return EdgeWeightsWithWrap<float>(pg, edge_weight_property_name);
+  case arrow::DoubleType::type_id:
+    return EdgeWeightsWithWrap<double>(pg, edge_weight_property_name);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
 thread_local int
     katana::analytics::TemporaryPropertyGuard::temporary_property_counter = 0;
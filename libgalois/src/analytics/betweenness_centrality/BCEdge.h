@@ -23,26 +23,13 @@
 #include "BCNode.h"
 #include "control.h"
 
+/// Edge state of the asynchronous algorithm, indexed by out-edge id so that
+/// out-edges and in-edges (through InEdgeIndex::out_edge_id) share it
 struct BCEdge {
-  using NodeType = BCNode<BC_USE_MARKING, BC_CONCURRENT>;
-  NodeType* src;
-  NodeType* dst;
   ShortPathType val;
   unsigned level;
 
-  BCEdge(NodeType* _src, NodeType* _dst)
-      : src(_src), dst(_dst), val(0), level(kInfinity) {}
-  BCEdge() : src(0), dst(0), val(0), level(kInfinity) {}
-
-  BCEdge& operator=(BCEdge const& from) {
-    if (this != &from) {
-      src = from.src;
-      dst = from.dst;
-      val = from.val;
-      level = from.level;
-    }
-    return *this;
-  }
+  BCEdge() : val(0), level(kInfinity) {}
 
   inline void reset() {
     if (level != kInfinity) {
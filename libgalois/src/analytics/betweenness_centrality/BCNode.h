@@ -27,7 +27,9 @@
 #include <vector>
 
 #include "control.h"
+#include "katana/Logging.h"
 #include "katana/SimpleLock.h"
+#include "katana/gIO.h"
 #include "katana/gstl.h"
 
 template <bool UseMarking = false, bool Concurrent = true>
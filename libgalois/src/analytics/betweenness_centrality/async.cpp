@@ -1,24 +1,30 @@
-#include <iomanip>
-#include <iostream>
+#include <algorithm>
+#include <numeric>
 
 #include "BCEdge.h"
 #include "BCNode.h"
+#include "betweenness_centrality_impl.h"
 #include "katana/Bag.h"
-#include "katana/BufferedGraph.h"
-#include "katana/LC_CSR_CSC_Graph.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
 
 // WARNING: optimal chunk size may differ depending on input graph
-constexpr static const unsigned ASYNC_CHUNK_SIZE = 64U;
+constexpr static const unsigned kAsyncChunkSize = 64U;
 using NodeType = BCNode<BC_USE_MARKING, BC_CONCURRENT>;
-using AsynchronousGraph =
-    katana::LC_CSR_CSC_Graph<NodeType, BCEdge, false, true>;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+struct NodeBC : public katana::PODProperty<float> {};
 
 // Work items for the forward phase
 struct ForwardPhaseWorkItem {
-  uint32_t nodeID;
+  uint32_t node_id;
   uint32_t distance;
-  ForwardPhaseWorkItem() : nodeID(kInfinity), distance(kInfinity){};
-  ForwardPhaseWorkItem(uint32_t _n, uint32_t _d) : nodeID(_n), distance(_d){};
+  ForwardPhaseWorkItem() : node_id(kInfinity), distance(kInfinity){};
+  ForwardPhaseWorkItem(uint32_t n, uint32_t d) : node_id(n), distance(d){};
 };
 
 // grabs distance from a forward phase work item
@@ -29,7 +35,7 @@ struct FPWorkItemIndexer {
 };
 
 // obim worklist type declaration
-using PSchunk = katana::PerSocketChunkFIFO<ASYNC_CHUNK_SIZE>;
+using PSchunk = katana::PerSocketChunkFIFO<kAsyncChunkSize>;
 using OBIM = katana::OrderedByIntegerMetric<FPWorkItemIndexer, PSchunk>;
 
 template <typename T, bool enable>
@@ -38,7 +44,9 @@ struct Counter : public T {
 
   Counter(std::string s) : name(std::move(s)) {}
 
-  ~Counter() { katana::ReportStatSingle("(NULL)", name, this->reduce()); }
+  ~Counter() {
+    katana::ReportStatSingle("BetweennessCentrality", name, this->reduce());
+  }
 };
 
 template <typename T>
@@ -49,493 +57,404 @@ struct Counter<T, false> {
   void update(Args...) {}
 };
 
-struct BetweenessCentralityAsynchronous {
-  AsynchronousGraph& graph;
-
-  BetweenessCentralityAsynchronous(AsynchronousGraph& _graph) : graph(_graph) {}
+/// Asynchronous Brandes betweenness centrality (Prountzos and Pingali,
+/// "Betweenness Centrality: Algorithms and Implementations", PPoPP 2013).
+///
+/// The forward phase builds the shortest path DAG of a source with an
+/// ordered-by-distance worklist and corrects it in place when a shorter path
+/// to a node is found, instead of proceeding level by level. The backward
+/// phase propagates dependencies from the leaves of the DAG, releasing a
+/// predecessor as soon as all of its successors are done. Neither phase has
+/// global barriers, which helps on high-diameter graphs where levels are
+/// small.
+///
+/// Correcting a node requires its in-edges, so this runs over the graph's
+/// in-edge index. Edge state is indexed by out-edge id and shared by both
+/// directions.
+class BCAsynchronous {
+  const katana::GraphTopology& topology_;
+  const katana::InEdgeIndex& in_index_;
+  std::vector<NodeType> node_data_;
+  std::vector<BCEdge> edge_data_;
 
   using SumCounter =
       Counter<katana::GAccumulator<unsigned long>, BC_COUNT_ACTIONS>;
-  SumCounter spfuCount{"SP&FU"};
-  SumCounter updateSigmaP1Count{"UpdateSigmaBefore"};
-  SumCounter updateSigmaP2Count{"RealUS"};
-  SumCounter firstUpdateCount{"First Update"};
-  SumCounter correctNodeP1Count{"CorrectNodeBefore"};
-  SumCounter correctNodeP2Count{"Real CN"};
-  SumCounter noActionCount{"NoAction"};
+  SumCounter spfu_count_{"SP&FU"};
+  SumCounter update_sigma_p1_count_{"UpdateSigmaBefore"};
+  SumCounter update_sigma_p2_count_{"RealUS"};
+  SumCounter first_update_count_{"First Update"};
+  SumCounter correct_node_p1_count_{"CorrectNodeBefore"};
+  SumCounter correct_node_p2_count_{"Real CN"};
+  SumCounter no_action_count_{"NoAction"};
 
   using MaxCounter =
       Counter<katana::GReduceMax<unsigned long>, BC_COUNT_ACTIONS>;
-  MaxCounter largestNodeDist{"Largest node distance"};
+  MaxCounter largest_node_dist_{"Largest node distance"};
 
   using LeafCounter =
       Counter<katana::GAccumulator<unsigned long>, BC_COUNT_LEAVES>;
 
-  void CorrectNode(uint32_t dstID, BCEdge&) {
-    NodeType& dstData = graph.getData(dstID);
+  katana::InsertBag<ForwardPhaseWorkItem> forward_phase_wl_;
+  katana::InsertBag<uint32_t> backward_phase_wl_;
+
+  NodeType& data(Node n) { return node_data_[n]; }
+  BCEdge& edge_data(Edge e) { return edge_data_[e]; }
+
+  void CorrectNode(uint32_t dst_id) {
+    NodeType& dst_data = data(dst_id);
 
     // loop through in edges
-    for (auto e : graph.in_edges(dstID)) {
-      BCEdge& inEdgeData = graph.getInEdgeData(e);
+    for (auto e : in_index_.in_edges(dst_id)) {
+      BCEdge& in_edge_data = edge_data(in_index_.out_edge_id(e));
 
-      uint32_t srcID = graph.getInEdgeDst(e);
-      if (srcID == dstID)
+      uint32_t src_id = in_index_.in_edge_src(e);
+      if (src_id == dst_id) {
         continue;
+      }
 
-      NodeType& srcData = graph.getData(srcID);
+      NodeType& src_data = data(src_id);
 
       // lock in right order
-      if (srcID < dstID) {
-        srcData.lock();
-        dstData.lock();
+      if (src_id < dst_id) {
+        src_data.lock();
+        dst_data.lock();
       } else {
-        dstData.lock();
-        srcData.lock();
+        dst_data.lock();
+        src_data.lock();
       }
 
-      const unsigned edgeLevel = inEdgeData.level;
+      const unsigned edge_level = in_edge_data.level;
 
       // Correct Node
-      if (srcData.distance >= dstData.distance) {
-        correctNodeP1Count.update(1);
-        dstData.unlock();
-
-        if (edgeLevel != kInfinity) {
-          inEdgeData.level = kInfinity;
-          if (edgeLevel == srcData.distance) {
-            correctNodeP2Count.update(1);
-            srcData.nsuccs--;
+      if (src_data.distance >= dst_data.distance) {
+        correct_node_p1_count_.update(1);
+        dst_data.unlock();
+
+        if (edge_level != kInfinity) {
+          in_edge_data.level = kInfinity;
+          if (edge_level == src_data.distance) {
+            correct_node_p2_count_.update(1);
+            src_data.nsuccs--;
           }
         }
-        srcData.unlock();
+        src_data.unlock();
       } else {
-        srcData.unlock();
-        dstData.unlock();
+        src_data.unlock();
+        dst_data.unlock();
       }
     }
   }
 
   template <typename CTXType>
-  void SpAndFU(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
-    spfuCount.update(1);
+  void SpAndFU(uint32_t src_id, uint32_t dst_id, BCEdge& ed, CTXType& ctx) {
+    spfu_count_.update(1);
 
-    NodeType& srcData = graph.getData(srcID);
-    NodeType& dstData = graph.getData(dstID);
+    NodeType& src_data = data(src_id);
+    NodeType& dst_data = data(dst_id);
 
     // make dst a successor of src, src predecessor of dst
-    srcData.nsuccs++;
-    const ShortPathType srcSigma = srcData.sigma;
-    KATANA_LOG_DEBUG_ASSERT(srcSigma > 0);
-    NodeType::predTY& dstPreds = dstData.preds;
-    bool dstPredsNotEmpty = !dstPreds.empty();
-    dstPreds.clear();
-    dstPreds.push_back(srcID);
-    dstData.distance = srcData.distance + 1;
-
-    largestNodeDist.update(dstData.distance);
-
-    dstData.nsuccs = 0;        // SP
-    dstData.sigma = srcSigma;  // FU
-    ed.val = srcSigma;
-    ed.level = srcData.distance;
-    srcData.unlock();
-    if (!dstData.isAlreadyIn())
-      ctx.push(ForwardPhaseWorkItem(dstID, dstData.distance));
-    dstData.unlock();
-    if (dstPredsNotEmpty) {
-      correctNode(dstID, ed);
+    src_data.nsuccs++;
+    const ShortPathType src_sigma = src_data.sigma;
+    KATANA_LOG_DEBUG_ASSERT(src_sigma > 0);
+    NodeType::predTY& dst_preds = dst_data.preds;
+    bool dst_preds_not_empty = !dst_preds.empty();
+    dst_preds.clear();
+    dst_preds.push_back(src_id);
+    dst_data.distance = src_data.distance + 1;
+
+    largest_node_dist_.update(dst_data.distance);
+
+    dst_data.nsuccs = 0;         // SP
+    dst_data.sigma = src_sigma;  // FU
+    ed.val = src_sigma;
+    ed.level = src_data.distance;
+    src_data.unlock();
+    if (!dst_data.isAlreadyIn()) {
+      ctx.push(ForwardPhaseWorkItem(dst_id, dst_data.distance));
+    }
+    dst_data.unlock();
+    if (dst_preds_not_empty) {
+      CorrectNode(dst_id);
     }
   }
 
   template <typename CTXType>
-  void UpdateSigma(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
-    updateSigmaP1Count.update(1);
+  void UpdateSigma(uint32_t src_id, uint32_t dst_id, BCEdge& ed, CTXType& ctx) {
+    update_sigma_p1_count_.update(1);
 
-    NodeType& srcData = graph.getData(srcID);
-    NodeType& dstData = graph.getData(dstID);
+    NodeType& src_data = data(src_id);
+    NodeType& dst_data = data(dst_id);
 
-    const ShortPathType srcSigma = srcData.sigma;
+    const ShortPathType src_sigma = src_data.sigma;
     const ShortPathType eval = ed.val;
-    const ShortPathType diff = srcSigma - eval;
+    const ShortPathType diff = src_sigma - eval;
 
-    srcData.unlock();
+    src_data.unlock();
     // greater than 0.0001 instead of 0 due to floating point imprecision
     if (diff > 0.0001) {
-      updateSigmaP2Count.update(1);
-      ed.val = srcSigma;
+      update_sigma_p2_count_.update(1);
+      ed.val = src_sigma;
+      dst_data.sigma += diff;
 
-      // ShortPathType old = dstData.sigma;
-      dstData.sigma += diff;
-
-      // if (old >= dstData.sigma) {
-      //  katana::gDebug("Overflow detected; capping at max uint64_t");
-      //  dstData.sigma = std::numeric_limits<uint64_t>::max();
-      //}
-
-      int nbsuccs = dstData.nsuccs;
-
-      if (nbsuccs > 0) {
-        if (!dstData.isAlreadyIn())
-          ctx.push(ForwardPhaseWorkItem(dstID, dstData.distance));
+      if (dst_data.nsuccs > 0) {
+        if (!dst_data.isAlreadyIn()) {
+          ctx.push(ForwardPhaseWorkItem(dst_id, dst_data.distance));
+        }
       }
-      dstData.unlock();
-    } else {
-      dstData.unlock();
     }
+    dst_data.unlock();
   }
 
   template <typename CTXType>
-  void FirstUpdate(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
-    firstUpdateCount.update(1);
-
-    NodeType& srcData = graph.getData(srcID);
-    srcData.nsuccs++;
-    const ShortPathType srcSigma = srcData.sigma;
-
-    NodeType& dstData = graph.getData(dstID);
-    dstData.preds.push_back(srcID);
-
-    const ShortPathType dstSigma = dstData.sigma;
-
-    // ShortPathType old = dstData.sigma;
-    dstData.sigma = dstSigma + srcSigma;
-    // if (old >= dstData.sigma) {
-    //  katana::gDebug("Overflow detected; capping at max uint64_t");
-    //  dstData.sigma = std::numeric_limits<uint64_t>::max();
-    //}
-
-    ed.val = srcSigma;
-    ed.level = srcData.distance;
-    srcData.unlock();
-    int nbsuccs = dstData.nsuccs;
-    if (nbsuccs > 0) {
-      if (!dstData.isAlreadyIn())
-        ctx.push(ForwardPhaseWorkItem(dstID, dstData.distance));
+  void FirstUpdate(uint32_t src_id, uint32_t dst_id, BCEdge& ed, CTXType& ctx) {
+    first_update_count_.update(1);
+
+    NodeType& src_data = data(src_id);
+    src_data.nsuccs++;
+    const ShortPathType src_sigma = src_data.sigma;
+
+    NodeType& dst_data = data(dst_id);
+    dst_data.preds.push_back(src_id);
+    dst_data.sigma += src_sigma;
+
+    ed.val = src_sigma;
+    ed.level = src_data.distance;
+    src_data.unlock();
+    if (dst_data.nsuccs > 0) {
+      if (!dst_data.isAlreadyIn()) {
+        ctx.push(ForwardPhaseWorkItem(dst_id, dst_data.distance));
+      }
     }
-    dstData.unlock();
+    dst_data.unlock();
   }
 
-  void DagConstruction(katana::InsertBag<ForwardPhaseWorkItem>& wl) {
+  void DagConstruction() {
     katana::for_each(
-        katana::iterate(wl),
+        katana::iterate(forward_phase_wl_),
         [&](ForwardPhaseWorkItem& wi, auto& ctx) {
-          uint32_t srcID = wi.nodeID;
-          NodeType& srcData = graph.getData(srcID);
-          srcData.markOut();
+          uint32_t src_id = wi.node_id;
+          NodeType& src_data = data(src_id);
+          src_data.markOut();
 
           // loop through all edges
-          for (auto e : graph.edges(srcID)) {
-            BCEdge& edgeData = graph.getEdgeData(e);
-            uint32_t dstID = graph.getEdgeDst(e);
-            NodeType& dstData = graph.getData(dstID);
+          for (auto e : topology_.edges(src_id)) {
+            BCEdge& ed = edge_data(e);
+            uint32_t dst_id = topology_.edge_dest(e);
+            NodeType& dst_data = data(dst_id);
 
-            if (srcID == dstID)
+            if (src_id == dst_id) {
               continue;  // ignore self loops
+            }
 
-            // lock in set order to prevent deadlock (lower id
-            // first)
-            // TODO run even in serial version; find way to not
-            // need to run
-            if (srcID < dstID) {
-              srcData.lock();
-              dstData.lock();
+            // lock in set order to prevent deadlock (lower id first)
+            if (src_id < dst_id) {
+              src_data.lock();
+              dst_data.lock();
             } else {
-              dstData.lock();
-              srcData.lock();
+              dst_data.lock();
+              src_data.lock();
             }
 
-            const int elevel = edgeData.level;
-            const int ADist = srcData.distance;
-            const int BDist = dstData.distance;
+            const int elevel = ed.level;
+            const int a_dist = src_data.distance;
+            const int b_dist = dst_data.distance;
 
-            if (BDist - ADist > 1) {
+            if (b_dist - a_dist > 1) {
               // Shortest Path + First Update (and Correct Node)
-              this->spAndFU(srcID, dstID, edgeData, ctx);
-            } else if (elevel == ADist && BDist == ADist + 1) {
+              SpAndFU(src_id, dst_id, ed, ctx);
+            } else if (elevel == a_dist && b_dist == a_dist + 1) {
               // Update Sigma
-              this->updateSigma(srcID, dstID, edgeData, ctx);
-            } else if (BDist == ADist + 1 && elevel != ADist) {
+              UpdateSigma(src_id, dst_id, ed, ctx);
+            } else if (b_dist == a_dist + 1 && elevel != a_dist) {
               // First Update not combined with Shortest Path
-              this->firstUpdate(srcID, dstID, edgeData, ctx);
+              FirstUpdate(src_id, dst_id, ed, ctx);
             } else {  // No Action
-              noActionCount.update(1);
-              srcData.unlock();
-              dstData.unlock();
+              no_action_count_.update(1);
+              src_data.unlock();
+              dst_data.unlock();
             }
           }
         },
         katana::wl<OBIM>(FPWorkItemIndexer()),
-        katana::disable_conflict_detection(), katana::loopname("ForwardPhase"));
+        katana::disable_conflict_detection(), katana::no_stats(),
+        katana::loopname("ForwardPhase"));
   }
 
-  void DependencyBackProp(katana::InsertBag<uint32_t>& wl) {
+  void DependencyBackProp() {
     katana::for_each(
-        katana::iterate(wl),
-        [&](uint32_t srcID, auto& ctx) {
-          NodeType& srcData = graph.getData(srcID);
-          srcData.lock();
+        katana::iterate(backward_phase_wl_),
+        [&](uint32_t src_id, auto& ctx) {
+          NodeType& src_data = data(src_id);
+          src_data.lock();
 
-          if (srcData.nsuccs == 0) {
-            const double srcDelta = srcData.delta;
-            srcData.bc += srcDelta;
+          if (src_data.nsuccs == 0) {
+            const double src_delta = src_data.delta;
+            src_data.bc += src_delta;
 
-            srcData.unlock();
+            src_data.unlock();
 
-            NodeType::predTY& srcPreds = srcData.preds;
+            NodeType::predTY& src_preds = src_data.preds;
 
             // loop through src's predecessors
-            for (unsigned i = 0; i < srcPreds.size(); i++) {
-              uint32_t predID = srcPreds[i];
-              NodeType& predData = graph.getData(predID);
+            for (unsigned i = 0; i < src_preds.size(); i++) {
+              uint32_t pred_id = src_preds[i];
+              NodeType& pred_data = data(pred_id);
 
-              KATANA_LOG_DEBUG_ASSERT(srcData.sigma >= 1);
+              KATANA_LOG_DEBUG_ASSERT(src_data.sigma >= 1);
               const double term =
-                  (double)predData.sigma * (1.0 + srcDelta) / srcData.sigma;
-              // if (std::isnan(term)) {
-              //  katana::gPrint(predData.sigma, " ", srcDelta, "
-              //  ", srcData.sigma, "\n");
-              //}
-              predData.lock();
-              predData.delta += term;
-              const unsigned prevPdNsuccs = predData.nsuccs;
-              predData.nsuccs--;
-
-              if (prevPdNsuccs == 1) {
-                predData.unlock();
-                ctx.push(predID);
+                  pred_data.sigma * (1.0 + src_delta) / src_data.sigma;
+              pred_data.lock();
+              pred_data.delta += term;
+              const unsigned prev_pd_nsuccs = pred_data.nsuccs;
+              pred_data.nsuccs--;
+
+              if (prev_pd_nsuccs == 1) {
+                pred_data.unlock();
+                ctx.push(pred_id);
               } else {
-                predData.unlock();
+                pred_data.unlock();
               }
             }
 
             // reset data in preparation for next source
-            srcData.reset();
-            for (auto e : graph.edges(srcID)) {
-              graph.getEdgeData(e).reset();
+            src_data.reset();
+            for (auto e : topology_.edges(src_id)) {
+              edge_data(e).reset();
             }
           } else {
-            srcData.unlock();
+            src_data.unlock();
           }
         },
-        katana::disable_conflict_detection(),
+        katana::disable_conflict_detection(), katana::no_stats(),
         katana::loopname("BackwardPhase"));
   }
 
-  void FindLeaves(katana::InsertBag<uint32_t>& fringeWL, unsigned nnodes) {
-    LeafCounter leafCount{"leaf nodes in DAG"};
+  void FindLeaves() {
+    LeafCounter leaf_count{"leaf nodes in DAG"};
     katana::do_all(
-        katana::iterate(0u, nnodes),
-        [&](auto i) {
-          NodeType& n = graph.getData(i);
+        katana::iterate(topology_),
+        [&](Node n) {
+          NodeType& node_data = data(n);
 
-          if (n.nsuccs == 0 && n.distance < kInfinity) {
-            leafCount.update(1);
-            fringeWL.push(i);
+          if (node_data.nsuccs == 0 && node_data.distance < kInfinity) {
+            leaf_count.update(1);
+            backward_phase_wl_.push(n);
           }
         },
-        katana::loopname("LeafFind"));
+        katana::no_stats(), katana::loopname("LeafFind"));
   }
-};
 
-void
-AsynchronousSanity(AsynchronousGraph& graph) {
-  katana::GReduceMax<float> accum_max;
-  katana::GReduceMin<float> accum_min;
-  katana::GAccumulator<float> accum_sum;
-  accum_max.reset();
-  accum_min.reset();
-  accum_sum.reset();
+public:
+  BCAsynchronous(
+      const katana::GraphTopology& topology,
+      const katana::InEdgeIndex& in_index)
+      : topology_(topology),
+        in_index_(in_index),
+        node_data_(topology.num_nodes()),
+        edge_data_(topology.num_edges()) {}
+
+  /// Add the dependencies of every node on source to its BC
+  void RunSource(Node source) {
+    // nodes without neighbors have no dependencies
+    if (topology_.edges(source).empty()) {
+      return;
+    }
 
-  // get max, min, sum of BC values using accumulators and reducers
-  katana::do_all(
-      katana::iterate(graph),
-      [&](unsigned n) {
-        auto& nodeData = graph.getData(n);
-        accum_max.update(nodeData.bc);
-        accum_min.update(nodeData.bc);
-        accum_sum += nodeData.bc;
-      },
-      katana::no_stats(), katana::loopname("AsynchronousSanity"));
-
-  katana::gPrint("Max BC is ", accum_max.reduce(), "\n");
-  katana::gPrint("Min BC is ", accum_min.reduce(), "\n");
-  katana::gPrint("BC sum is ", accum_sum.reduce(), "\n");
-}
-////////////////////////////////////////////////////////////////////////////////
+    NodeType& active = data(source);
+    active.initAsSource();
+    forward_phase_wl_.push_back(ForwardPhaseWorkItem(source, 0));
+    DagConstruction();
+    forward_phase_wl_.clear();
 
-//! runs asynchronous BC
-void
-BetweennessCentralityAsynchronous() {
-  if (BC_CONCURRENT) {
-    katana::gInfo("Running in concurrent mode with ", numThreads, " threads");
-  } else {
-    katana::gInfo("Running in serial mode");
-  }
+    FindLeaves();
 
-  katana::gInfo("Constructing async BC graph");
-  // create bidirectional graph
-  AsynchronousGraph bcGraph;
+    // the BC of the source itself does not change
+    double backup_src_bc = active.bc;
+    DependencyBackProp();
+    active.bc = backup_src_bc;
 
-  katana::StatTimer graph_construct_timer("GRAPH_CONSTRUCT");
-  graph_construct_timer.start();
+    backward_phase_wl_.clear();
+  }
 
-  katana::FileGraph fileReader;
-  fileReader.fromFile(inputFile);
-  bcGraph.allocateFrom(fileReader.size(), fileReader.sizeEdges());
-  bcGraph.constructNodes();
+  float bc(Node n) const { return node_data_[n].bc; }
+};
 
-  katana::do_all(katana::iterate(fileReader), [&](uint32_t i) {
-    auto b = fileReader.edge_begin(i);
-    auto e = fileReader.edge_end(i);
+}  // namespace
 
-    bcGraph.fixEndEdge(i, *e);
+katana::Result<void>
+BetweennessCentralityAsynchronous(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan [[maybe_unused]]) {
+  katana::ReportStatSingle(
+      "BetweennessCentrality", "ChunkSize", kAsyncChunkSize);
 
-    while (b < e) {
-      bcGraph.constructEdge(*b, fileReader.getEdgeDst(*b));
-      b++;
+  std::vector<uint32_t> source_vector;
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    source_vector = std::get<std::vector<uint32_t>>(sources);
+  } else {
+    uint64_t num_sources = pg->num_nodes();
+    if (sources != kBetweennessCentralityAllNodes) {
+      num_sources =
+          std::min<uint64_t>(std::get<uint32_t>(sources), num_sources);
     }
-  });
-  bcGraph.constructIncomingEdges();
-
-  graph_construct_timer.stop();
-
-  BetweenessCentralityAsynchronous bcExecutor(bcGraph);
+    source_vector.resize(num_sources);
+    std::iota(source_vector.begin(), source_vector.end(), 0);
+  }
+  for (auto s : source_vector) {
+    if (s >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node", s);
+    }
+  }
 
-  unsigned nnodes = bcGraph.size();
-  uint64_t nedges = bcGraph.sizeEdges();
-  katana::gInfo("Num nodes is ", nnodes, ", num edges is ", nedges);
-  katana::gInfo("Using OBIM chunk size: ", ASYNC_CHUNK_SIZE);
-  katana::gInfo(
-      "Note that optimal chunk size may differ depending on input "
-      "graph");
-  katana::ReportStatSingle(
-      "BetweennessCentralityAsynchronous", "ChunkSize", ASYNC_CHUNK_SIZE);
+  auto in_index_res = pg->GetInEdgeIndex();
+  if (!in_index_res) {
+    return in_index_res.error();
+  }
+  std::shared_ptr<const katana::InEdgeIndex> in_index =
+      std::move(in_index_res.value());
 
   katana::reportPageAlloc("MemAllocPre");
-  katana::gInfo("Going to pre-allocate pages");
+  size_t nnodes = pg->num_nodes();
+  uint64_t nedges = pg->num_edges();
   katana::EnsurePreallocated(
       std::min(
           static_cast<uint64_t>(
               std::min(katana::getActiveThreads(), 100U) *
-              std::max((nnodes / 4500000), unsigned{5}) *
+              std::max((nnodes / 4500000), size_t{5}) *
               std::max((nedges / 30000000), uint64_t{5}) * 2.5),
           uint64_t{1500}) +
       5);
-  katana::gInfo("Pre-allocation complete");
+  BCAsynchronous bc_async(pg->topology(), *in_index);
   katana::reportPageAlloc("MemAllocMid");
 
-  // reset everything in preparation for run
-  katana::do_all(
-      katana::iterate(0u, nnodes), [&](auto i) { bcGraph.getData(i).reset(); });
-  katana::do_all(katana::iterate(UINT64_C(0), nedges), [&](auto i) {
-    bcGraph.getEdgeData(i).reset();
-  });
-
-  // reading in list of sources to operate on if provided
-  std::ifstream sourceFile;
-  std::vector<uint64_t> sourceVector;
-  if (sourcesToUse != "") {
-    sourceFile.open(sourcesToUse);
-    std::vector<uint64_t> t(
-        std::istream_iterator<uint64_t>{sourceFile},
-        std::istream_iterator<uint64_t>{});
-    sourceVector = t;
-    sourceFile.close();
-  }
-
-  if (numOfSources == 0) {
-    numOfSources = nnodes;
-  }
-
-  // if user does specifes a certain number of out sources (i.e. only sources
-  // with outgoing edges), we need to loop over the entire node set to look for
-  // good sources to use
-  uint32_t goodSource = 0;
-  if (iterLimit != 0) {
-    numOfSources = nnodes;
-  }
-
-  // only use at most the number of sources in the passed in source file (if
-  // such a file was actually pass in)
-  if (sourceVector.size() != 0) {
-    if (numOfSources > sourceVector.size()) {
-      numOfSources = sourceVector.size();
-    }
-  }
-
-  katana::InsertBag<ForwardPhaseWorkItem> forwardPhaseWL;
-  katana::InsertBag<uint32_t> backwardPhaseWL;
-
-  katana::gInfo("Beginning execution");
-
-  katana::StatTimer exec_time("BetweennessCentralityAsynchronous");
+  katana::StatTimer exec_time("Asynchronous", "BetweennessCentrality");
   exec_time.start();
-  for (uint32_t i = 0; i < numOfSources; ++i) {
-    uint32_t sourceToUse = i;
-    if (sourceVector.size() != 0) {
-      sourceToUse = sourceVector[i];
-    }
-
-    // ignore nodes with no neighbors
-    if (!std::distance(
-            bcGraph.edge_begin(sourceToUse), bcGraph.edge_end(sourceToUse))) {
-      katana::gDebug(sourceToUse, " has no outgoing edges");
-      continue;
-    }
-
-    forwardPhaseWL.push_back(ForwardPhaseWorkItem(sourceToUse, 0));
-    NodeType& active = bcGraph.getData(sourceToUse);
-    active.initAsSource();
-    katana::gDebug("Source is ", sourceToUse);
-
-    bcExecutor.dagConstruction(forwardPhaseWL);
-    forwardPhaseWL.clear();
-
-    bcExecutor.findLeaves(backwardPhaseWL, nnodes);
-
-    double backupSrcBC = active.bc;
-    bcExecutor.dependencyBackProp(backwardPhaseWL);
-
-    active.bc = backupSrcBC;  // current source BC should not get updated
-
-    backwardPhaseWL.clear();
-
-    // break out once number of sources user specified to do (if any) has been
-    // reached
-    goodSource++;
-    if (iterLimit != 0 && goodSource >= iterLimit)
-      break;
+  for (auto source : source_vector) {
+    bc_async.RunSource(source);
   }
   exec_time.stop();
-
-  katana::gInfo("Number of sources with outgoing edges was ", goodSource);
-
   katana::reportPageAlloc("MemAllocPost");
 
-  // sanity
-  AsynchronousSanity(bcGraph);
-
-  // prints out first 10 node BC values
-  if (!skipVerify) {
-    int count = 0;
-    for (unsigned i = 0; i < nnodes && count < 10; ++i, ++count) {
-      katana::gPrint(
-          count, ": ", std::setiosflags(std::ios::fixed), std::setprecision(6),
-          bcGraph.getData(i).bc, "\n");
-    }
+  if (auto result =
+          katana::analytics::ConstructNodeProperties<std::tuple<NodeBC>>(
+              pg, {output_property_name});
+      !result) {
+    return result.error();
   }
-
-  if (output) {
-    std::cerr << "Writting out bc values...\n";
-    std::stringstream outfname;
-    outfname << "certificate"
-             << "_" << numThreads << ".txt";
-    std::string fname = outfname.str();
-    std::ofstream outfile(fname.c_str());
-    for (unsigned i = 0; i < nnodes; ++i) {
-      outfile << i << " " << std::setiosflags(std::ios::fixed)
-              << std::setprecision(9) << bcGraph.getData(i).bc << "\n";
-    }
-    outfile.close();
+  auto graph_result =
+      katana::TypedPropertyGraph<std::tuple<NodeBC>, std::tuple<>>::Make(
+          pg, {output_property_name}, {});
+  if (!graph_result) {
+    return graph_result.error();
   }
+  auto graph = graph_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) { graph.GetData<NodeBC>(n) = bc_async.bc(n); },
+      katana::no_stats(), katana::loopname("ExtractBC"));
+  return katana::ResultSuccess();
 }
@@ -19,6 +19,8 @@
 
 #include "betweenness_centrality_impl.h"
 
+#include "katana/Cancellation.h"
+
 using namespace katana::analytics;
 
 const BetweennessCentralitySources
@@ -30,20 +32,30 @@ katana::analytics::BetweennessCentrality(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     const BetweennessCentralitySources& sources,
     BetweennessCentralityPlan plan) {
+  katana::Result<void> r = katana::ResultSuccess();
   switch (plan.algorithm()) {
-    //TODO (gill) Needs bidirectional graph (CSR_CSC)
-    //   case Asynchronous:
-    //     // see AsyncStructs.h
-    //     katana::gInfo("Running async BC");
-    //     doAsyncBC();
-    //     break;
+  case BetweennessCentralityPlan::kAsynchronous:
+    r = BetweennessCentralityAsynchronous(
+        pg, sources, output_property_name, plan);
+    break;
   case BetweennessCentralityPlan::kLevel:
-    return BetweennessCentralityLevel(pg, sources, output_property_name, plan);
+    r = BetweennessCentralityLevel(pg, sources, output_property_name, plan);
+    break;
   case BetweennessCentralityPlan::kOuter:
-    return BetweennessCentralityOuter(pg, sources, output_property_name, plan);
+    r = BetweennessCentralityOuter(pg, sources, output_property_name, plan);
+    break;
+  case BetweennessCentralityPlan::kMultiSource:
+    r = BetweennessCentralityMultiSource(
+        pg, sources, output_property_name, plan);
+    break;
   default:
     return katana::ErrorCode::InvalidArgument;
   }
+
+  if (r && katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return r;
 }
 
 void
@@ -0,0 +1,24 @@
+#ifndef KATANA_LIBGALOIS_ANALYTICS_BETWEENNESSCENTRALITY_CONTROL_H_
+#define KATANA_LIBGALOIS_ANALYTICS_BETWEENNESSCENTRALITY_CONTROL_H_
+
+#include <cstdint>
+#include <limits>
+
+// Compile-time switches for the asynchronous algorithm
+
+//! Avoid pushing a node that is already on the worklist
+constexpr static const bool BC_USE_MARKING = true;
+//! Lock nodes; required unless running with a single thread
+constexpr static const bool BC_CONCURRENT = true;
+//! Report how often each kind of DAG update happens
+constexpr static const bool BC_COUNT_ACTIONS = false;
+//! Report the number of leaves of each DAG
+constexpr static const bool BC_COUNT_LEAVES = false;
+
+using ShortPathType = double;
+
+// Small enough that the difference of two distances fits in an int
+constexpr static const uint32_t kInfinity =
+    std::numeric_limits<uint32_t>::max() / 4;
+
+#endif
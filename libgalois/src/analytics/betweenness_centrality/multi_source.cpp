@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <numeric>
+
+#include "betweenness_centrality_impl.h"
+#include "katana/LargeArray.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/MultiSourceBfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = MultiSourceBfs::Node;
+using Mask = MultiSourceBfs::Mask;
+using Visit = MultiSourceBfs::Visit;
+
+struct NodeBC : public katana::PODProperty<float> {};
+
+constexpr static const unsigned kMultiSourceChunkSize = 64u;
+
+/// Brandes' algorithm for a batch of sources on top of MultiSourceBfs.
+///
+/// Path counts and dependencies are kept per (node, source) pair in
+/// node-major arrays with one slot per source of a batch, so the values of
+/// one node for all sources share cache lines.
+class BCMultiSource {
+  const katana::GraphTopology& topology_;
+  const katana::InEdgeIndex& in_index_;
+  size_t width_;
+  MultiSourceBfs bfs_;
+  katana::LargeArray<float> sigma_;
+  katana::LargeArray<float> delta_;
+  katana::LargeArray<float> bc_;
+
+  float* sigma(Node n) { return &sigma_[size_t{n} * width_]; }
+  float* delta(Node n) { return &delta_[size_t{n} * width_]; }
+
+  template <typename F>
+  static void ForEachBit(Mask m, const F& fn) {
+    while (m) {
+      fn(__builtin_ctzll(m));
+      m &= m - 1;
+    }
+  }
+
+  /// Count shortest paths level by level, pulling from the predecessors in
+  /// the previous level along in-edges so that each node is written by one
+  /// thread only.
+  void CountPaths() {
+    katana::do_all(
+        katana::iterate(bfs_.level(0)),
+        [&](const Visit& v) {
+          float* s = sigma(v.node);
+          ForEachBit(v.sources, [&](unsigned k) { s[k] = 1; });
+        },
+        katana::no_stats(), katana::loopname("MultiSourceInitPaths"));
+
+    for (size_t d = 1; d < bfs_.num_levels(); ++d) {
+      bfs_.MarkLevel(d - 1);
+      katana::do_all(
+          katana::iterate(bfs_.level(d)),
+          [&](const Visit& v) {
+            float* s = sigma(v.node);
+            for (auto e : in_index_.in_edges(v.node)) {
+              Node pred = in_index_.in_edge_src(e);
+              Mask common = v.sources & bfs_.marked(pred);
+              if (common) {
+                const float* pred_s = sigma(pred);
+                ForEachBit(common, [&](unsigned k) { s[k] += pred_s[k]; });
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<kMultiSourceChunkSize>(),
+          katana::no_stats(), katana::loopname("MultiSourceCountPaths"));
+    }
+  }
+
+  /// Back-propagate dependencies from the deepest level towards the sources
+  /// and accumulate them into bc_. Sources themselves are skipped.
+  void AccumulateDependencies() {
+    for (size_t d = bfs_.num_levels() - 1; d-- > 1;) {
+      bfs_.MarkLevel(d + 1);
+      katana::do_all(
+          katana::iterate(bfs_.level(d)),
+          [&](const Visit& v) {
+            float* del = delta(v.node);
+            for (auto e : topology_.edges(v.node)) {
+              Node succ = topology_.edge_dest(e);
+              Mask common = v.sources & bfs_.marked(succ);
+              if (common) {
+                const float* succ_s = sigma(succ);
+                const float* succ_d = delta(succ);
+                ForEachBit(common, [&](unsigned k) {
+                  del[k] += (1 + succ_d[k]) / succ_s[k];
+                });
+              }
+            }
+
+            const float* s = sigma(v.node);
+            float sum = 0;
+            ForEachBit(v.sources, [&](unsigned k) {
+              del[k] *= s[k];
+              sum += del[k];
+            });
+            bc_[v.node] += sum;
+          },
+          katana::steal(), katana::chunk_size<kMultiSourceChunkSize>(),
+          katana::no_stats(), katana::loopname("MultiSourceBrandes"));
+    }
+  }
+
+  void ResetBatch() {
+    for (size_t d = 0; d < bfs_.num_levels(); ++d) {
+      katana::do_all(
+          katana::iterate(bfs_.level(d)),
+          [&](const Visit& v) {
+            float* s = sigma(v.node);
+            float* del = delta(v.node);
+            ForEachBit(v.sources, [&](unsigned k) {
+              s[k] = 0;
+              del[k] = 0;
+            });
+          },
+          katana::no_stats(), katana::loopname("MultiSourceReset"));
+    }
+  }
+
+public:
+  BCMultiSource(
+      const katana::GraphTopology& topology,
+      const katana::InEdgeIndex& in_index, size_t width)
+      : topology_(topology),
+        in_index_(in_index),
+        width_(width),
+        bfs_(topology) {
+    size_t num_nodes = topology_.num_nodes();
+    sigma_.allocateBlocked(num_nodes * width_);
+    delta_.allocateBlocked(num_nodes * width_);
+    bc_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          std::fill(sigma(n), sigma(n) + width_, 0.0f);
+          std::fill(delta(n), delta(n) + width_, 0.0f);
+          bc_[n] = 0;
+        },
+        katana::no_stats(), katana::loopname("MultiSourceInit"));
+  }
+
+  /// Process up to width sources at once
+  void RunBatch(const Node* sources, size_t num_sources) {
+    KATANA_LOG_DEBUG_ASSERT(num_sources <= width_);
+    bfs_.Run(sources, num_sources);
+    CountPaths();
+    AccumulateDependencies();
+    ResetBatch();
+  }
+
+  float bc(Node n) const { return bc_[n]; }
+};
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityMultiSource(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan) {
+  size_t width = plan.sources_per_batch();
+  if (width == 0 || width > MultiSourceBfs::kMaxSources) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "sources per batch must be between 1 and {}",
+        MultiSourceBfs::kMaxSources);
+  }
+
+  std::vector<uint32_t> source_vector;
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    source_vector = std::get<std::vector<uint32_t>>(sources);
+  } else {
+    uint64_t num_sources = pg->num_nodes();
+    if (sources != kBetweennessCentralityAllNodes) {
+      num_sources =
+          std::min<uint64_t>(std::get<uint32_t>(sources), num_sources);
+    }
+    source_vector.resize(num_sources);
+    std::iota(source_vector.begin(), source_vector.end(), 0);
+  }
+  for (auto s : source_vector) {
+    if (s >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node", s);
+    }
+  }
+
+  auto in_index_res = pg->GetInEdgeIndex();
+  if (!in_index_res) {
+    return in_index_res.error();
+  }
+  std::shared_ptr<const katana::InEdgeIndex> in_index =
+      std::move(in_index_res.value());
+
+  katana::reportPageAlloc("MemAllocPre");
+  BCMultiSource bc_multi_source(pg->topology(), *in_index, width);
+  katana::reportPageAlloc("MemAllocMid");
+
+  katana::StatTimer exec_time("MultiSource", "BetweennessCentrality");
+  exec_time.start();
+  for (size_t i = 0; i < source_vector.size(); i += width) {
+    size_t n = std::min(width, source_vector.size() - i);
+    bc_multi_source.RunBatch(source_vector.data() + i, n);
+  }
+  exec_time.stop();
+  katana::reportPageAlloc("MemAllocPost");
+
+  if (auto result =
+          katana::analytics::ConstructNodeProperties<std::tuple<NodeBC>>(
+              pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+  auto graph_result =
+      katana::TypedPropertyGraph<std::tuple<NodeBC>, std::tuple<>>::Make(
+          pg, {output_property_name}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  auto graph = graph_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) { graph.GetData<NodeBC>(n) = bc_multi_source.bc(n); },
+      katana::no_stats(), katana::loopname("ExtractBC"));
+  return katana::ResultSuccess();
+}
@@ -1,6 +1,13 @@
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
 #include <boost/iterator/filter_iterator.hpp>
 
 #include "betweenness_centrality_impl.h"
+#include "katana/AtomicHelpers.h"
+#include "katana/LargeArray.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -15,96 +22,201 @@ typedef typename OuterGraph::Node OuterGNode;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class BCOuter {
-  const OuterGraph& graph_;
-  int num_nodes_;
-
-  // TODO(amp): centrality_measure_ is basically a manual implementation of
-  //  vector GAccumulator. This should use the Reducible framework to hide the
-  //  details.
-  katana::PerThreadStorage<float*> centrality_measure_;  // Output value
-  katana::PerThreadStorage<float*> per_thread_sigma_;
-  katana::PerThreadStorage<int*> per_thread_distance_;
-  katana::PerThreadStorage<float*> per_thread_delta_;
-  katana::PerThreadStorage<katana::gdeque<OuterGNode>*> per_thread_successor_;
-
+constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+
+/// A search indexes the nodes it visited with a hash table until it visits
+/// more than this fraction of the graph, then with a dense array
+constexpr uint32_t kDenseFraction = 8;
+
+/// The state of a search from one source, for the nodes it visited alone.
+///
+/// The nodes are kept in visit order, which is BFS order, with their path
+/// counts and dependencies, and the positions where each level starts, so
+/// that a node is in the next level of another if its position is in that
+/// range; no distances are stored. The position of a node is found with an
+/// open addressing hash table, which is replaced by an array of a position
+/// per node once a search visits a large part of the graph. Resetting for
+/// the next source only touches the nodes visited, so a thread uses memory
+/// in proportion to the largest set of nodes it reached, not to the graph.
+class SourceState {
 public:
-  /**
-   * Constructor initializes thread local storage.
-   */
-  BCOuter(const OuterGraph& g) : graph_(g), num_nodes_(g.num_nodes()) {
-    InitializeLocal();
+  explicit SourceState(uint32_t num_nodes) : num_nodes_(num_nodes) {}
+
+  std::vector<OuterGNode> visited;
+  std::vector<float> sigma;
+  std::vector<float> delta;
+  /// level_starts[d] is the position of the first node at distance d
+  std::vector<uint32_t> level_starts;
+
+  /// \returns the position of n in visit order, or kUnvisited
+  uint32_t position(OuterGNode n) const {
+    if (!dense_.empty()) {
+      return dense_[n];
+    }
+    for (uint64_t slot = Hash(n);; slot = (slot + 1) & mask_) {
+      if (table_[slot].node == n) {
+        return table_[slot].position;
+      }
+      if (table_[slot].node == kUnvisited) {
+        return kUnvisited;
+      }
+    }
   }
 
-  /**
-   * Constructor destroys thread local storage.
-   */
-  ~BCOuter(void) { DeleteLocal(); }
+  /// Visit n, with no paths to it yet, and return its position
+  uint32_t Visit(OuterGNode n) {
+    auto p = static_cast<uint32_t>(visited.size());
+    visited.emplace_back(n);
+    sigma.emplace_back(0);
+    delta.emplace_back(0);
+    if (!dense_.empty()) {
+      dense_[n] = p;
+    } else if (visited.size() > num_nodes_ / kDenseFraction) {
+      MakeDense();
+    } else {
+      if (2 * visited.size() > table_.size()) {
+        Grow();
+      }
+      Insert(n, p);
+    }
+    return p;
+  }
 
-  //! Function that does BC for a single source; called by a thread
-  void ComputeBC(const OuterGNode current_source) {
-    katana::gdeque<OuterGNode> source_queue;
+  /// Forget the nodes visited, for the search from the next source
+  void Reset() {
+    for (OuterGNode n : visited) {
+      if (!dense_.empty()) {
+        dense_[n] = kUnvisited;
+        continue;
+      }
+      // Every entry is removed, so no probe sequence needs to stay intact
+      uint64_t slot = Hash(n);
+      while (table_[slot].node != n) {
+        slot = (slot + 1) & mask_;
+      }
+      table_[slot].node = kUnvisited;
+    }
+    visited.clear();
+    sigma.clear();
+    delta.clear();
+    level_starts.clear();
+  }
 
-    float* sigma = *per_thread_sigma_.getLocal();
-    int* distance = *per_thread_distance_.getLocal();
-    float* delta = *per_thread_delta_.getLocal();
-    katana::gdeque<OuterGNode>* successor = *per_thread_successor_.getLocal();
+private:
+  struct Entry {
+    OuterGNode node;
+    uint32_t position;
+  };
+
+  uint64_t Hash(OuterGNode n) const {
+    // Fibonacci hashing, taking the high bits of the product
+    return (n * UINT64_C(0x9E3779B97F4A7C15)) >> shift_;
+  }
 
-    sigma[current_source] = 1;
-    distance[current_source] = 1;
+  void Insert(OuterGNode n, uint32_t p) {
+    uint64_t slot = Hash(n);
+    while (table_[slot].node != kUnvisited) {
+      slot = (slot + 1) & mask_;
+    }
+    table_[slot] = Entry{n, p};
+  }
+
+  void Grow() {
+    uint64_t capacity = std::max<uint64_t>(64, 2 * table_.size());
+    table_.assign(capacity, Entry{kUnvisited, kUnvisited});
+    mask_ = capacity - 1;
+    shift_ = 64 - __builtin_ctzll(capacity);
+    for (uint32_t p = 0; p + 1 < visited.size(); ++p) {
+      Insert(visited[p], p);
+    }
+  }
 
-    source_queue.push_back(current_source);
+  /// Switch to the dense index for this and every later search, which is
+  /// smaller than the table by then
+  void MakeDense() {
+    dense_.assign(num_nodes_, kUnvisited);
+    for (uint32_t p = 0; p < visited.size(); ++p) {
+      dense_[visited[p]] = p;
+    }
+    table_ = std::vector<Entry>();
+  }
 
-    // Do bfs while computing number of shortest paths (saved into sigma)
-    // and successors of nodes;
-    // Note this bfs makes it so source has distance of 1 instead of 0
-    for (auto qq = source_queue.begin(), eq = source_queue.end(); qq != eq;
-         ++qq) {
-      int src = *qq;
+  uint32_t num_nodes_;
+  std::vector<Entry> table_;
+  uint64_t mask_{0};
+  uint32_t shift_{64};
+  std::vector<uint32_t> dense_;
+};
 
-      for (auto edge : graph_.edges(src)) {
-        auto dest = graph_.GetEdgeDest(edge);
+class BCOuter {
+  const OuterGraph& graph_;
+  katana::LargeArray<std::atomic<float>> centrality_measure_;  // Output value
+  katana::PerThreadStorage<std::unique_ptr<SourceState>> per_thread_state_;
 
-        if (!distance[*dest]) {
-          source_queue.push_back(*dest);
-          distance[*dest] = distance[src] + 1;
-        }
+public:
+  BCOuter(const OuterGraph& g) : graph_(g) {
+    centrality_measure_.allocateBlocked(graph_.num_nodes());
+    centrality_measure_.constructParallel(0.0f);
+  }
 
-        if (distance[*dest] == distance[src] + 1) {
-          sigma[*dest] = sigma[*dest] + sigma[src];
-          successor[src].push_back(*dest);
+  //! Function that does BC for a single source; called by a thread
+  void ComputeBC(const OuterGNode current_source) {
+    std::unique_ptr<SourceState>& local = *per_thread_state_.getLocal();
+    if (!local) {
+      local = std::make_unique<SourceState>(graph_.num_nodes());
+    }
+    SourceState& state = *local;
+
+    state.Visit(current_source);
+    state.sigma[0] = 1;
+    state.level_starts = {0, 1};
+
+    // Do bfs level by level while computing number of shortest paths (saved
+    // into sigma); a node discovered at this level is in the next one
+    for (size_t level = 0;
+         state.level_starts[level] < state.level_starts[level + 1]; ++level) {
+      uint32_t next_start = state.level_starts[level + 1];
+      for (uint32_t p = state.level_starts[level]; p < next_start; ++p) {
+        for (auto edge : graph_.edges(state.visited[p])) {
+          auto dest = *graph_.GetEdgeDest(edge);
+          uint32_t q = state.position(dest);
+          if (q == kUnvisited) {
+            q = state.Visit(dest);
+          }
+          if (q >= next_start) {
+            state.sigma[q] += state.sigma[p];
+          }
         }
       }
+      state.level_starts.emplace_back(state.visited.size());
     }
 
-    // Back-propogate the dependency values (delta) along the BFS DAG
-    // ignore the source (hence source_queue.size > 1 and not source_queue.empty)
-    while (source_queue.size() > 1) {
-      int leaf = source_queue.back();
-      source_queue.pop_back();
-
-      float sigma_leaf = sigma[leaf];  // has finalized short path value
-      float delta_leaf = delta[leaf];
-      auto& succ_list = successor[leaf];
-
-      for (auto current_succ = succ_list.begin(), succ_end = succ_list.end();
-           current_succ != succ_end; ++current_succ) {
-        delta_leaf +=
-            (sigma_leaf / sigma[*current_succ]) * (1.0 + delta[*current_succ]);
+    // Back-propogate the dependency values (delta) along the BFS DAG, whose
+    // successors of a node are its neighbors in the next level; ignore the
+    // source at level 0. The search stopped at an empty level, so the
+    // deepest level with nodes is third from the end of level_starts.
+    for (size_t level = state.level_starts.size() - 3; level > 0; --level) {
+      uint32_t succ_begin = state.level_starts[level + 1];
+      uint32_t succ_end = state.level_starts[level + 2];
+      for (uint32_t p = state.level_starts[level]; p < succ_begin; ++p) {
+        float sigma_leaf = state.sigma[p];  // has finalized short path value
+        float delta_leaf = 0;
+        for (auto edge : graph_.edges(state.visited[p])) {
+          uint32_t q = state.position(*graph_.GetEdgeDest(edge));
+          if (q >= succ_begin && q < succ_end) {
+            delta_leaf +=
+                (sigma_leaf / state.sigma[q]) * (1.0 + state.delta[q]);
+          }
+        }
+        state.delta[p] = delta_leaf;
+        if (delta_leaf != 0) {
+          katana::atomicAdd(
+              centrality_measure_[state.visited[p]], delta_leaf);
+        }
       }
-      delta[leaf] = delta_leaf;
     }
 
-    // save result of this source's BC, reset all local values for next
-    // source
-    float* Vec = *centrality_measure_.getLocal();
-    for (int i = 0; i < num_nodes_; ++i) {
-      Vec[i] += delta[i];
-      delta[i] = 0;
-      sigma[i] = 0;
-      distance[i] = 0;
-      successor[i].clear();
-    }
+    state.Reset();
   }
 
   /**
@@ -125,35 +237,6 @@ public:
         katana::steal(), katana::loopname("Main"));
   }
 
-  /**
-   * Verification for reference torus graph inputs.
-   * All nodes should have the same betweenness value up to
-   * some tolerance.
-   */
-  void Verify() {
-    float sample_bc = 0.0;
-    bool first_time = true;
-    for (int i = 0; i < num_nodes_; ++i) {
-      float bc = (*centrality_measure_.getRemote(0))[i];
-
-      for (unsigned j = 1; j < katana::getActiveThreads(); ++j)
-        bc += (*centrality_measure_.getRemote(j))[i];
-
-      if (first_time) {
-        sample_bc = bc;
-        katana::gInfo("BC: ", sample_bc);
-        first_time = false;
-      } else {
-        // check if over some tolerance value
-        if ((bc - sample_bc) > 0.0001) {
-          katana::gInfo(
-              "If torus graph, verification failed ", (bc - sample_bc));
-          return;
-        }
-      }
-    }
-  }
-
   katana::Result<std::shared_ptr<arrow::FloatArray>> ExtractBCValues(
       size_t begin, size_t end) {
     arrow::FloatBuilder builder;
@@ -161,13 +244,8 @@ public:
       return katana::ErrorCode::ArrowError;
     }
     for (; begin != end; ++begin) {
-      float bc = (*centrality_measure_.getRemote(0))[begin];
-
-      for (unsigned j = 1; j < katana::getActiveThreads(); ++j) {
-        bc += (*centrality_measure_.getRemote(j))[begin];
-      }
-
-      if (auto r = builder.Append(bc); !r.ok()) {
+      if (auto r = builder.Append(centrality_measure_[begin].load());
+          !r.ok()) {
         return katana::ErrorCode::ArrowError;
       }
     }
@@ -177,53 +255,6 @@ public:
     }
     return ret;
   }
-
-private:
-  /**
-   * Initialize an array at some provided address.
-   *
-   * @param addr Address to initialize array at
-   */
-  template <typename T>
-  void InitArray(T** addr) {
-    *addr = new T[num_nodes_]();
-  }
-
-  /**
-   * Destroy an array at some provided address.
-   *
-   * @param addr Address to destroy array at
-   */
-  template <typename T>
-  void DeleteArray(T** addr) {
-    delete[] * addr;
-  }
-
-  /**
-   * Initialize local thread storage.
-   */
-  void InitializeLocal(void) {
-    katana::on_each([this](unsigned, unsigned) {
-      this->InitArray(centrality_measure_.getLocal());
-      this->InitArray(per_thread_sigma_.getLocal());
-      this->InitArray(per_thread_distance_.getLocal());
-      this->InitArray(per_thread_delta_.getLocal());
-      this->InitArray(per_thread_successor_.getLocal());
-    });
-  }
-
-  /**
-   * Destroy local thread storage.
-   */
-  void DeleteLocal(void) {
-    katana::on_each([this](unsigned, unsigned) {
-      this->DeleteArray(centrality_measure_.getLocal());
-      this->DeleteArray(per_thread_sigma_.getLocal());
-      this->DeleteArray(per_thread_distance_.getLocal());
-      this->DeleteArray(per_thread_delta_.getLocal());
-      this->DeleteArray(per_thread_successor_.getLocal());
-    });
-  }
 };
 
 /**
@@ -256,11 +287,7 @@ BetweennessCentralityOuter(
 
   BCOuter bc_outer(graph);
 
-  // preallocate pages for use in algorithm
   katana::reportPageAlloc("MeminfoPre");
-  katana::EnsurePreallocated(
-      katana::getActiveThreads() * graph.num_nodes() / 1650);
-  katana::reportPageAlloc("MeminfoMid");
 
   // vector of sources to process; initialized if doing outSources
   std::vector<uint32_t> source_vector;
@@ -19,12 +19,18 @@
 
 #include "katana/analytics/bfs/bfs.h"
 
+#include <algorithm>
 #include <deque>
+#include <limits>
 #include <type_traits>
 
-#include "katana/DynamicBitset.h"
+#include "katana/Cancellation.h"
+#include "katana/Frontier.h"
+#include "katana/LowLatency.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/DistributedPropagation.h"
+#include "tsuba/tsuba.h"
 
 using namespace katana::analytics;
 
@@ -116,37 +122,17 @@ struct OneTilePushWrap {
   }
 };
 
-template <typename WL>
-void
-WlToBitset(WL& wl, katana::DynamicBitset& bitset) {
-  katana::do_all(
-      katana::iterate(wl), [&](const Graph::Node& src) { bitset.set(src); },
-      katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
-}
+namespace gwl = katana;
+// typedef PerSocketChunkFIFO<kChunkSize> dFIFO;
+using FIFO = gwl::PerSocketChunkFIFO<kChunkSize>;
+using StealingFIFO = gwl::StealingChunkFIFO<kChunkSize>;
+using BSWL = gwl::BulkSynchronous<gwl::PerSocketChunkLIFO<kChunkSize>>;
 
-template <typename WL>
-void
-BitsetToWl(const Graph& graph, const katana::DynamicBitset& bitset, WL& wl) {
-  wl.clear();
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const Graph::Node& src) {
-        if (bitset.test(src)) {
-          wl.push(src);
-        }
-      },
-      katana::chunk_size<kChunkSize>(), katana::loopname("BitsetToWl"));
-}
-
-template <bool CONCURRENT, typename T, typename P, typename R>
+template <
+    bool CONCURRENT, typename T, typename WL = FIFO, typename P, typename R>
 void
 AsynchronousAlgo(
     Graph* graph, Graph::Node source, const P& pushWrap, const R& edgeRange) {
-  namespace gwl = katana;
-  // typedef PerSocketChunkFIFO<kChunkSize> dFIFO;
-  using FIFO = gwl::PerSocketChunkFIFO<kChunkSize>;
-  using BSWL = gwl::BulkSynchronous<gwl::PerSocketChunkLIFO<kChunkSize>>;
-  using WL = FIFO;
 
   using Loop = typename std::conditional<
       CONCURRENT, katana::ForEach, katana::WhileQ<katana::SerFIFO<T>>>::type;
@@ -269,139 +255,150 @@ SynchronousAlgo(
   }
 }
 
-template <bool CONCURRENT, typename P>
+/// Direction-optimizing BFS (Beamer et al., "Direction-Optimizing
+/// Breadth-First Search", SC 2012). Levels are expanded top-down, pushing
+/// along the out-edges of a sparse frontier, until the frontier has more
+/// out-edges than the unreached nodes have divided by alpha. Then they are
+/// expanded bottom-up: every unreached node looks for a neighbor in the
+/// frontier, now a dense bitmap, among its in-edges from the in-edge index.
+///
+/// The alpha and beta of the plan are only starting points. Each bottom-up
+/// step counts the in-edges it examines; the out-edges of the unreached
+/// nodes over that count is the alpha at which the switch pays off, and
+/// alpha moves halfway to it. Once the frontier shrinks, the search returns
+/// to top-down as soon as pushing from the frontier would examine fewer
+/// edges than the last bottom-up step did or the frontier holds fewer than
+/// num_nodes / beta nodes.
+template <bool CONCURRENT>
 void
 SynchronousDirectOpt(
-    Graph* graph, katana::PropertyGraph* transpose_graph, Graph::Node source,
-    const P& pushWrap, const uint32_t alpha, const uint32_t beta) {
-  using Cont = typename std::conditional<
-      CONCURRENT, katana::InsertBag<Graph::Node>,
-      katana::SerStack<Graph::Node>>::type;
+    Graph* graph, const katana::InEdgeIndex* in_index, Graph::Node source,
+    const uint32_t alpha, const uint32_t beta) {
   using Loop = typename std::conditional<
       CONCURRENT, katana::DoAll, katana::StdForEach>::type;
 
-  katana::GAccumulator<uint32_t> work_items;
-  katana::StatTimer bitset_to_wl_timer("Bitset_To_WL_Timer");
-  katana::StatTimer wl_to_bitset_timer("WL_To_Bitset_Timer");
-
   Loop loop;
 
-  katana::DynamicBitset front_bitset, next_bitset;
-  front_bitset.resize(graph->size());
-  next_bitset.resize(graph->size());
+  katana::Frontier frontier(graph->size());
+  katana::Frontier next_frontier(graph->size());
 
-  front_bitset.reset();
-  next_bitset.reset();
-
-  Cont* frontier = new Cont();
-  Cont* next_frontier = new Cont();
-
-  Dist next_level{0};
   graph->GetData<BfsNodeDistance>(source) = 0U;
+  frontier.push(source);
+
+  uint64_t num_nodes = graph->num_nodes();
+  uint64_t frontier_size = 1;
+  uint64_t last_frontier_size = 0;
+  // The out-edges of the frontier and of the nodes not reached yet
+  uint64_t frontier_edges = graph->edges(source).size();
+  uint64_t unreached_edges = graph->num_edges() - frontier_edges;
+  // The in-edges examined by the last bottom-up step
+  uint64_t pull_edges = std::numeric_limits<uint64_t>::max();
+  double adaptive_alpha = std::max(alpha, 1U);
+  uint64_t min_push_size = num_nodes / std::max(beta, 1U);
+  bool bottom_up = false;
+  uint64_t num_pull_steps = 0;
+
+  for (Dist level = 1; frontier_size > 0; ++level) {
+    if (!bottom_up) {
+      bottom_up = frontier_edges > unreached_edges / adaptive_alpha;
+    } else if (frontier_size < last_frontier_size) {
+      bottom_up =
+          frontier_edges >= pull_edges && frontier_size >= min_push_size;
+    }
 
-  if (CONCURRENT) {
-    pushWrap(*next_frontier, source, "parallel");
-  } else {
-    pushWrap(*next_frontier, source);
-  }
+    katana::GAccumulator<uint64_t> next_edges;
+    if (bottom_up) {
+      if (!frontier.is_dense()) {
+        frontier.ToDense();
+      }
+      next_frontier.Reset(true);
+      katana::GAccumulator<uint64_t> examined;
 
-  work_items += 1;
-
-  int64_t edges_to_check = graph->num_edges();
-  int64_t scout_count = graph->edges(source).size();
-  uint32_t num_nodes = graph->num_nodes();
-  uint64_t old_num_work_items{0};
-
-  katana::GAccumulator<uint64_t> writes_pull, writes_push;
-  writes_pull.reset();
-  writes_push.reset();
-
-  while (!next_frontier->empty()) {
-    std::swap(frontier, next_frontier);
-    next_frontier->clear();
-    if (scout_count > edges_to_check / alpha) {
-      wl_to_bitset_timer.start();
-      WlToBitset(*frontier, front_bitset);
-      wl_to_bitset_timer.stop();
-      do {
-        ++next_level;
-        old_num_work_items = work_items.reduce();
-        work_items.reset();
-
-        loop(
-            katana::iterate(*transpose_graph),
-            [&](const typename Graph::Node& dst) {
-              auto& ddata = graph->GetData<BfsNodeDistance>(dst);
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                for (auto e : transpose_graph->edges(dst)) {
-                  auto src = transpose_graph->GetEdgeDest(e);
-
-                  if (front_bitset.test(*src)) {
-                    // assign parents on the bfs path.
-                    ddata = *src;
-                    next_bitset.set(dst);
-                    work_items += 1;
-                    break;
-                  }
-                }
+      loop(
+          katana::iterate(in_index->topology),
+          [&](const typename Graph::Node& dst) {
+            auto& ddata = graph->GetData<BfsNodeDistance>(dst);
+            if (ddata != BfsImplementation::kDistanceInfinity) {
+              return;
+            }
+            uint64_t checked = 0;
+            for (auto e : in_index->in_edges(dst)) {
+              ++checked;
+              if (frontier.test(in_index->in_edge_src(e))) {
+                ddata = level;
+                next_frontier.push(dst);
+                next_edges += graph->edges(dst).size();
+                break;
               }
-            },
-            katana::steal(), katana::chunk_size<kChunkSize>(),
-            katana::loopname(std::string("SyncDO-pull").c_str()));
-        std::swap(front_bitset, next_bitset);
-        next_bitset.reset();
-      } while (work_items.reduce() >= old_num_work_items ||
-               (work_items.reduce() > num_nodes / beta));
-
-      bitset_to_wl_timer.start();
-      BitsetToWl(*graph, front_bitset, *next_frontier);
-      bitset_to_wl_timer.stop();
-      scout_count = 1;
+            }
+            examined += checked;
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::loopname("SyncDO-pull"));
+
+      pull_edges = examined.reduce();
+      if (pull_edges > 0) {
+        adaptive_alpha = std::max(
+            1.0, (adaptive_alpha + double(unreached_edges) / pull_edges) / 2);
+      }
+      ++num_pull_steps;
     } else {
-      ++next_level;
-      edges_to_check -= scout_count;
-      work_items.reset();
+      if (frontier.is_dense()) {
+        frontier.ToSparse();
+      }
+      next_frontier.Reset(false);
 
-      loop(
-          katana::iterate(*frontier),
+      frontier.ForEach(
           [&](const typename Graph::Node& src) {
             for (auto e : graph->edges(src)) {
               auto dst = graph->GetEdgeDest(e);
               Dist& ddata = graph->GetData<BfsNodeDistance>(*dst);
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                Dist old_dist = ddata;
-                if (__sync_bool_compare_and_swap(&ddata, old_dist, src)) {
-                  next_frontier->push(*dst);
-                  work_items += std::distance(
-                      graph->edge_begin(*dst), graph->edge_end(*dst));
-                }
+              if (ddata == BfsImplementation::kDistanceInfinity &&
+                  __sync_bool_compare_and_swap(
+                      &ddata, BfsImplementation::kDistanceInfinity, level)) {
+                next_frontier.push(*dst);
+                next_edges += graph->edges(*dst).size();
               }
             }
           },
-          katana::steal(), katana::chunk_size<kChunkSize>(),
-          katana::loopname(std::string("SyncDO-push").c_str()));
-      scout_count = work_items.reduce();
+          "SyncDO-push");
     }
+
+    frontier.swap(next_frontier);
+    last_frontier_size = frontier_size;
+    frontier_size = frontier.size();
+    frontier_edges = next_edges.reduce();
+    unreached_edges -= frontier_edges;
   }
 
-  delete frontier;
-  delete next_frontier;
+  katana::ReportStatSingle("BFS", "PullSteps", num_pull_steps);
+  katana::ReportStatSingle("BFS", "FinalAlpha", adaptive_alpha);
 }
 
 template <bool CONCURRENT>
 void
 RunAlgo(
-    BfsPlan algo, Graph* graph, katana::PropertyGraph* transpose_graph,
+    BfsPlan algo, Graph* graph, const katana::InEdgeIndex* in_index,
     const Graph::Node& source) {
   BfsImplementation impl{algo.edge_tile_size()};
   switch (algo.algorithm()) {
   case BfsPlan::kAsynchronousTile:
-    AsynchronousAlgo<CONCURRENT, SrcEdgeTile>(
-        graph, source, SrcEdgeTilePushWrap{graph, impl}, TileRangeFn());
+    if (BfsImplementation::UseStealingWorklist()) {
+      AsynchronousAlgo<CONCURRENT, SrcEdgeTile, StealingFIFO>(
+          graph, source, SrcEdgeTilePushWrap{graph, impl}, TileRangeFn());
+    } else {
+      AsynchronousAlgo<CONCURRENT, SrcEdgeTile>(
+          graph, source, SrcEdgeTilePushWrap{graph, impl}, TileRangeFn());
+    }
     break;
   case BfsPlan::kAsynchronous:
-    AsynchronousAlgo<CONCURRENT, UpdateRequest>(
-        graph, source, ReqPushWrap(), OutEdgeRangeFn{graph});
+    if (BfsImplementation::UseStealingWorklist()) {
+      AsynchronousAlgo<CONCURRENT, UpdateRequest, StealingFIFO>(
+          graph, source, ReqPushWrap(), OutEdgeRangeFn{graph});
+    } else {
+      AsynchronousAlgo<CONCURRENT, UpdateRequest>(
+          graph, source, ReqPushWrap(), OutEdgeRangeFn{graph});
+    }
     break;
   case BfsPlan::kSynchronousTile:
     SynchronousAlgo<CONCURRENT, EdgeTile>(
@@ -413,8 +410,7 @@ RunAlgo(
     break;
   case BfsPlan::kSynchronousDirectOpt:
     SynchronousDirectOpt<CONCURRENT>(
-        graph, transpose_graph, source, NodePushWrap(), algo.alpha(),
-        algo.beta());
+        graph, in_index, source, algo.alpha(), algo.beta());
     break;
   default:
     std::cerr << "ERROR: unkown algo type\n";
@@ -441,41 +437,86 @@ BfsImpl(
     graph.GetData<BfsNodeDistance>(n) = BfsImplementation::kDistanceInfinity;
   });
 
-  // TODO(lhc): due to lack of in-edge iteration, manually creates a transposed graph
-  const katana::GraphTopology& topology = pg->topology();
-  katana::LargeArray<uint64_t> out_indices;
-  katana::LargeArray<uint32_t> out_dests;
-
-  out_indices.allocateInterleaved(topology.num_nodes());
-  out_dests.allocateInterleaved(topology.num_edges());
-  auto transpose_graph =
-      katana::CreateTransposeGraphTopology(topology, &out_indices, &out_dests);
+  std::shared_ptr<const katana::InEdgeIndex> in_index;
+  if (algo.algorithm() == BfsPlan::kSynchronousDirectOpt) {
+    auto in_index_res = pg->GetInEdgeIndex();
+    if (!in_index_res) {
+      return in_index_res.error();
+    }
+    in_index = std::move(in_index_res.value());
+  }
 
   katana::StatTimer execTime("BFS");
   execTime.start();
 
-  RunAlgo<true>(algo, &graph, transpose_graph.value().get(), source);
+  RunAlgo<true>(algo, &graph, in_index.get(), source);
 
   execTime.stop();
 
-  // TODO(lhc) this is temporary verification code for direct-optimization.
-  // it is different from other algos b/c it stores parent ids, instead of distance.
-  if (algo.algorithm() == BfsPlan::kSynchronousDirectOpt) {
-    for (Graph::Node n = 0; n < 10; n++) {
-      std::cout << "parent[" << n << "] : " << graph.GetData<BfsNodeDistance>(n)
-                << "\n";
-    }
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
   }
 
   return katana::ResultSuccess();
 }
 
+/// BFS on the partition pg of a graph partitioned across the hosts of
+/// tsuba::Comm(), from start_node, a node of the RDG
+katana::Result<void>
+DistributedBfs(Graph* graph, katana::PropertyGraph* pg, size_t start_node) {
+  auto sync_res = katana::MirrorSync::Make(*pg, tsuba::Comm());
+  if (!sync_res) {
+    return sync_res.error();
+  }
+  katana::MirrorSync& sync = sync_res.value();
+  if (start_node >= sync.num_global_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "start node {} is not a node of the graph of {} nodes", start_node,
+        sync.num_global_nodes());
+  }
+
+  const katana::GraphTopology& topology = pg->topology();
+  katana::LargeArray<std::atomic<Dist>> levels;
+  levels.allocateBlocked(topology.num_nodes());
+  katana::DynamicBitset active;
+  active.resize(topology.num_nodes());
+  katana::do_all(
+      katana::iterate(topology),
+      [&](uint32_t n) {
+        bool is_start =
+            n < sync.num_masters() && sync.global_id(n) == start_node;
+        levels.constructAt(
+            n, is_start ? Dist{0} : BfsImplementation::kDistanceInfinity);
+        if (is_start) {
+          active.set(n);
+        }
+      },
+      katana::no_stats());
+
+  auto rounds_res = DistributedMinPropagation<Dist>(
+      topology, &sync, &levels, &active, [](auto) { return Dist{1}; });
+  if (!rounds_res) {
+    return rounds_res.error();
+  }
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](uint32_t n) { graph->GetData<BfsNodeDistance>(n) = levels[n]; },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<void>
 katana::analytics::Bfs(
     katana::PropertyGraph* pg, size_t start_node,
     const std::string& output_property_name, BfsPlan algo) {
+  if (auto r = CheckArchitecture(algo, {kCPU, kDistributedCPU}); !r) {
+    return r.error();
+  }
+  katana::LowLatencyRegion region(pg->num_nodes() + pg->num_edges());
   if (auto result = ConstructNodeProperties<std::tuple<BfsNodeDistance>>(
           pg, {output_property_name});
       !result) {
@@ -487,9 +528,76 @@ katana::analytics::Bfs(
     return pg_result.error();
   }
 
+  if (algo.architecture() == kDistributedCPU) {
+    return DistributedBfs(&pg_result.value(), pg, start_node);
+  }
   return BfsImpl(pg_result.value(), pg, start_node, algo);
 }
 
+katana::Result<void>
+katana::analytics::Bfs(
+    const katana::TemporalWindow& window, size_t start_node,
+    const std::string& output_property_name) {
+  if (start_node >= window.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "start node {} is not a node of the graph of {} nodes", start_node,
+        window.num_nodes());
+  }
+  katana::PropertyGraph* pg = window.graph();
+  if (auto result = ConstructNodeProperties<std::tuple<BfsNodeDistance>>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph& graph = pg_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) {
+        graph.GetData<BfsNodeDistance>(n) =
+            n == start_node ? 0 : BfsImplementation::kDistanceInfinity;
+      },
+      katana::no_stats());
+
+  katana::StatTimer execTime("TemporalBFS");
+  execTime.start();
+
+  // The first edge to reach a node claims it for the next level
+  katana::Frontier frontier(window.num_nodes());
+  katana::Frontier next(window.num_nodes());
+  frontier.push(start_node);
+  for (Dist level = 1; !frontier.empty(); ++level) {
+    if (katana::IsCancelled()) {
+      return katana::ErrorCode::Cancelled;
+    }
+    frontier.ForEach(
+        [&](uint32_t n) {
+          for (auto e : window.edges(n)) {
+            auto dst = window.edge_dest(e);
+            Dist* dist = &graph.GetData<BfsNodeDistance>(dst);
+            if (__atomic_load_n(dist, __ATOMIC_RELAXED) ==
+                    BfsImplementation::kDistanceInfinity &&
+                __sync_bool_compare_and_swap(
+                    dist, BfsImplementation::kDistanceInfinity, level)) {
+              next.push(dst);
+            }
+          }
+        },
+        "TemporalBFS");
+    frontier.swap(next);
+    next.clear();
+    frontier.Adapt();
+  }
+
+  execTime.stop();
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::analytics::BfsAssertValid(
     PropertyGraph* pg, const std::string& property_name) {
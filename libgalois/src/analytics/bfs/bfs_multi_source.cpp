@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <limits>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/analytics/MultiSourceBfs.h"
+#include "katana/analytics/bfs/bfs.h"
+
+katana::Result<void>
+katana::analytics::BfsMultiSource(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& output_property_name) {
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  if (sources.empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "no sources");
+  }
+  for (uint32_t source : sources) {
+    if (source >= num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "source {} is not a node", source);
+    }
+  }
+
+  // Row n holds the levels of node n, as in the output list of n
+  size_t width = sources.size();
+  uint64_t num_values = num_nodes * width;
+  auto buffer_res = arrow::AllocateBuffer(num_values * sizeof(uint32_t));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "allocating levels: {}", buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  auto* levels = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        std::fill_n(levels + n * width, width, kBfsMultiSourceInfinity);
+      },
+      katana::no_stats(), katana::loopname("BfsMultiSourceInit"));
+
+  // Each search covers kMaxSources sources and sets their columns level by
+  // level; the searches share the buffers of one MultiSourceBfs
+  MultiSourceBfs search(topology);
+  for (size_t first = 0; first < width; first += MultiSourceBfs::kMaxSources) {
+    size_t count = std::min(width - first, MultiSourceBfs::kMaxSources);
+    search.Run(sources.data() + first, count);
+    for (size_t d = 0; d < search.num_levels(); ++d) {
+      katana::do_all(
+          katana::iterate(search.level(d)),
+          [&](const MultiSourceBfs::Visit& v) {
+            uint32_t* row = levels + v.node * width + first;
+            for (MultiSourceBfs::Mask bits = v.sources; bits;
+                 bits &= bits - 1) {
+              row[__builtin_ctzll(bits)] = d;
+            }
+          },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("BfsMultiSourceLevels"));
+    }
+  }
+
+  auto values = std::make_shared<arrow::UInt32Array>(num_values, buffer);
+  auto type = arrow::fixed_size_list(arrow::uint32(), width);
+  auto list =
+      std::make_shared<arrow::FixedSizeListArray>(type, num_nodes, values);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, type)}), {list});
+  return pg->AddNodeProperties(table);
+}
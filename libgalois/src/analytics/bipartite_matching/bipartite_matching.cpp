@@ -0,0 +1,922 @@
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Cancellation.h"
+#include "katana/Frontier.h"
+#include "katana/LargeArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr Node kNone = std::numeric_limits<Node>::max();
+constexpr Edge kNoEdge = std::numeric_limits<Edge>::max();
+/// The largest scaled weight the auction accepts, leaving room for prices
+/// to grow above the weights
+constexpr int64_t kMaxScaledWeight = int64_t{1} << 59;
+/// The factor by which the auction shrinks its bid increment between
+/// scaling phases
+constexpr int64_t kEpsilonScaling = 4;
+
+/// Mark the nodes with in-edges as being on the right side, checking that
+/// none of them also has out-edges
+katana::Result<std::vector<uint8_t>>
+RightSide(
+    const katana::GraphTopology& topology,
+    const katana::InEdgeIndex& in_edges) {
+  std::vector<uint8_t> is_right(topology.num_nodes());
+  katana::GReduceMin<Node> both_sides;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        is_right[n] = !in_edges.in_edges(n).empty();
+        if (is_right[n] && !topology.edges(n).empty()) {
+          both_sides.update(n);
+        }
+      },
+      katana::no_stats());
+  if (Node n = both_sides.reduce(); n != kNone) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "node {} has both in- and out-edges, so edges do not all go from "
+        "the left side to the right side",
+        n);
+  }
+  return is_right;
+}
+
+/// Pack flags into an arrow boolean array
+katana::Result<std::shared_ptr<arrow::Array>>
+BuildBooleanArray(const std::vector<uint8_t>& flags) {
+  uint64_t num_bytes = (flags.size() + 7) / 8;
+  auto buffer_res = arrow::AllocateBuffer(num_bytes);
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} bytes: {}", num_bytes,
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> bitmap = std::move(buffer_res.ValueOrDie());
+  uint8_t* bits = bitmap->mutable_data();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_bytes),
+      [&](uint64_t b) {
+        uint8_t byte = 0;
+        for (uint64_t i = 0; i < 8 && 8 * b + i < flags.size(); ++i) {
+          byte |= flags[8 * b + i] << i;
+        }
+        bits[b] = byte;
+      },
+      katana::no_stats());
+  return std::make_shared<arrow::BooleanArray>(flags.size(), bitmap);
+}
+
+katana::Result<void>
+AddMatchingProperty(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    const std::vector<uint8_t>& in_matching) {
+  auto array_res = BuildBooleanArray(in_matching);
+  if (!array_res) {
+    return array_res.error();
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::boolean())}),
+      {array_res.value()});
+  return pg->AddEdgeProperties(table);
+}
+
+/// Pothen-Fan: phases of parallel, vertex disjoint depth-first searches for
+/// augmenting paths from the unmatched left nodes
+class PothenFan {
+  /// One left node on the path of a search
+  struct Frame {
+    Node node;
+    /// The number of edges of node the search has tried
+    uint64_t tried;
+    /// The edge to the right node the search went through last
+    Edge edge;
+  };
+
+  const katana::GraphTopology& topology_;
+  const std::vector<uint8_t>& is_right_;
+
+  /// The left node matched to each right node
+  katana::LargeArray<std::atomic<Node>> right_mate_;
+  /// The matched edge of each right node
+  std::vector<Edge> right_edge_;
+  std::vector<uint8_t> left_matched_;
+  /// The next edge each left node looks ahead to for an unmatched neighbor.
+  /// Matched nodes never become unmatched, so this never moves back.
+  std::vector<Edge> lookahead_;
+  /// The last phase each right node was visited in
+  katana::LargeArray<std::atomic<uint32_t>> visited_;
+  katana::PerThreadStorage<std::vector<Frame>> stacks_;
+
+  bool is_left(Node n) const {
+    return !is_right_[n] && !topology_.edges(n).empty();
+  }
+
+  bool Visit(Node n, uint32_t phase) {
+    return visited_[n].exchange(phase) != phase;
+  }
+
+  void Augment(const std::vector<Frame>& path) {
+    for (const Frame& frame : path) {
+      Node right = topology_.edge_dest(frame.edge);
+      right_mate_[right].store(frame.node);
+      right_edge_[right] = frame.edge;
+      left_matched_[frame.node] = true;
+    }
+  }
+
+  /// Search for an augmenting path from root, going through edges in order
+  /// or, in alternate phases, in reverse order
+  bool Search(
+      Node root, uint32_t phase, bool forward, std::vector<Frame>* stack) {
+    stack->clear();
+    stack->emplace_back(Frame{root, 0, kNoEdge});
+    while (!stack->empty()) {
+      Frame& frame = stack->back();
+      auto [begin, end] = topology_.edge_range(frame.node);
+
+      for (Edge& e = lookahead_[frame.node]; e < end;) {
+        Node right = topology_.edge_dest(e++);
+        if (right_mate_[right].load(std::memory_order_relaxed) == kNone &&
+            Visit(right, phase)) {
+          frame.edge = e - 1;
+          Augment(*stack);
+          return true;
+        }
+      }
+
+      Node next = kNone;
+      while (frame.tried < end - begin && next == kNone) {
+        uint64_t i = frame.tried++;
+        Edge e = forward ? begin + i : end - 1 - i;
+        Node right = topology_.edge_dest(e);
+        if (!Visit(right, phase)) {
+          continue;
+        }
+        frame.edge = e;
+        next = right_mate_[right].load();
+        if (next == kNone) {
+          Augment(*stack);
+          return true;
+        }
+      }
+      if (next == kNone) {
+        stack->pop_back();
+      } else {
+        stack->emplace_back(Frame{next, 0, kNoEdge});
+      }
+    }
+    return false;
+  }
+
+public:
+  PothenFan(
+      const katana::GraphTopology& topology,
+      const std::vector<uint8_t>& is_right)
+      : topology_(topology),
+        is_right_(is_right),
+        right_edge_(topology.num_nodes(), kNoEdge),
+        left_matched_(topology.num_nodes()),
+        lookahead_(topology.num_nodes()) {
+    right_mate_.allocateBlocked(topology.num_nodes());
+    visited_.allocateBlocked(topology.num_nodes());
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node n) {
+          right_mate_.constructAt(n, kNone);
+          visited_.constructAt(n, 0);
+          lookahead_[n] = topology.edge_range(n).first;
+        },
+        katana::no_stats());
+  }
+
+  katana::Result<void> Run() {
+    // Start from a greedy matching
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          if (!is_left(n)) {
+            return;
+          }
+          for (Edge e : topology_.edges(n)) {
+            Node right = topology_.edge_dest(e);
+            Node expected = kNone;
+            if (right_mate_[right].compare_exchange_strong(expected, n)) {
+              right_edge_[right] = e;
+              left_matched_[n] = true;
+              return;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    for (uint32_t phase = 1;; ++phase) {
+      if (katana::IsCancelled()) {
+        return katana::ErrorCode::Cancelled;
+      }
+      katana::InsertBag<Node> unmatched;
+      katana::do_all(
+          katana::iterate(topology_),
+          [&](Node n) {
+            if (is_left(n) && !left_matched_[n]) {
+              unmatched.push(n);
+            }
+          },
+          katana::no_stats());
+
+      katana::GAccumulator<uint64_t> augmented;
+      bool forward = phase % 2 == 1;
+      katana::do_all(
+          katana::iterate(unmatched),
+          [&](Node n) {
+            if (Search(n, phase, forward, stacks_.getLocal())) {
+              augmented += 1;
+            }
+          },
+          katana::steal(), katana::loopname("BipartiteMatching-PothenFan"));
+      if (augmented.reduce() == 0) {
+        return katana::ResultSuccess();
+      }
+    }
+  }
+
+  std::vector<uint8_t> InMatching() const {
+    std::vector<uint8_t> in_matching(topology_.num_edges());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          if (right_edge_[n] != kNoEdge) {
+            in_matching[right_edge_[n]] = true;
+          }
+        },
+        katana::no_stats());
+    return in_matching;
+  }
+};
+
+/// The auction algorithm for the square assignment problem whose bidders are
+/// the left nodes and stand-ins for the right nodes, and whose objects are
+/// the right nodes and stand-ins for the left ones. Left node n bids for its
+/// neighbors or for object n, its own stand-in, which means staying
+/// unmatched. The stand-in of right node n bids for object n, leaving right
+/// node n unmatched, or for the stand-ins of the neighbors of n, which frees
+/// them for n. Matchings of pg are the assignments of this problem of the
+/// same weight, and one always exists.
+class Auction {
+  const katana::GraphTopology& topology_;
+  const katana::InEdgeIndex& in_edges_;
+  const std::vector<uint8_t>& is_right_;
+  /// Edge weights, scaled by one more than the number of bidders
+  const std::vector<int64_t>& weights_;
+  int64_t max_weight_;
+
+  std::vector<int64_t> prices_;
+  /// The bidder holding each object
+  std::vector<Node> owners_;
+  /// The edge of the last winning bid of each bidder, or kNoEdge if the
+  /// object was a stand-in
+  std::vector<Edge> assigned_edges_;
+  std::vector<Node> bid_objects_;
+  std::vector<Edge> bid_edges_;
+  std::vector<int64_t> bids_;
+  katana::LargeArray<std::atomic<int64_t>> high_bids_;
+  katana::LargeArray<std::atomic<Node>> winners_;
+
+  katana::Frontier current_;
+  katana::Frontier next_;
+
+  bool is_bidder(Node n) const {
+    return is_right_[n] || !topology_.edges(n).empty();
+  }
+
+  /// Call fn(object, weight, edge) for every object bidder n may bid for
+  template <typename F>
+  void ForEachOffer(Node n, const F& fn) const {
+    fn(n, 0, kNoEdge);
+    if (!is_right_[n]) {
+      for (Edge e : topology_.edges(n)) {
+        fn(topology_.edge_dest(e), weights_[e], e);
+      }
+    } else {
+      for (Edge e : in_edges_.in_edges(n)) {
+        fn(in_edges_.in_edge_src(e), 0, kNoEdge);
+      }
+    }
+  }
+
+  /// Bid for the object of highest value to n, raising its price by the
+  /// margin over the next best one plus epsilon
+  void Bid(Node n, int64_t epsilon) {
+    Node best = kNone;
+    Edge best_edge = kNoEdge;
+    int64_t first = std::numeric_limits<int64_t>::min();
+    int64_t second = std::numeric_limits<int64_t>::min();
+    ForEachOffer(n, [&](Node object, int64_t weight, Edge e) {
+      int64_t value = weight - prices_[object];
+      if (best == kNone || value > first) {
+        second = first;
+        first = value;
+        best = object;
+        best_edge = e;
+      } else if (value > second) {
+        second = value;
+      }
+    });
+    // Every bidder has at least two offers: its own object and a neighbor
+    int64_t bid = prices_[best] + (first - second) + epsilon;
+    bid_objects_[n] = best;
+    bid_edges_[n] = best_edge;
+    bids_[n] = bid;
+    int64_t high = high_bids_[best].load();
+    while (bid > high && !high_bids_[best].compare_exchange_weak(high, bid)) {
+    }
+  }
+
+  void Round(int64_t epsilon) {
+    current_.ForEach(
+        [&](Node n) { Bid(n, epsilon); }, "BipartiteMatching-AuctionBid");
+
+    // The first highest bidder of each object wins it; the others bid again
+    current_.ForEach(
+        [&](Node n) {
+          Node object = bid_objects_[n];
+          Node expected = kNone;
+          if (bids_[n] != high_bids_[object].load() ||
+              !winners_[object].compare_exchange_strong(expected, n)) {
+            next_.push(n);
+          }
+        },
+        "BipartiteMatching-AuctionResolve");
+
+    current_.ForEach(
+        [&](Node n) {
+          Node object = bid_objects_[n];
+          if (winners_[object].load() != n) {
+            return;
+          }
+          if (owners_[object] != kNone) {
+            next_.push(owners_[object]);
+          }
+          owners_[object] = n;
+          assigned_edges_[n] = bid_edges_[n];
+          prices_[object] = bids_[n];
+          high_bids_[object] = std::numeric_limits<int64_t>::min();
+          winners_[object] = kNone;
+        },
+        "BipartiteMatching-AuctionAssign");
+    next_.Adapt();
+  }
+
+public:
+  Auction(
+      const katana::GraphTopology& topology,
+      const katana::InEdgeIndex& in_edges,
+      const std::vector<uint8_t>& is_right,
+      const std::vector<int64_t>& scaled_weights, int64_t max_weight)
+      : topology_(topology),
+        in_edges_(in_edges),
+        is_right_(is_right),
+        weights_(scaled_weights),
+        max_weight_(max_weight),
+        prices_(topology.num_nodes()),
+        owners_(topology.num_nodes()),
+        assigned_edges_(topology.num_nodes(), kNoEdge),
+        bid_objects_(topology.num_nodes()),
+        bid_edges_(topology.num_nodes()),
+        bids_(topology.num_nodes()),
+        current_(topology.num_nodes()),
+        next_(topology.num_nodes()) {
+    high_bids_.allocateBlocked(topology.num_nodes());
+    winners_.allocateBlocked(topology.num_nodes());
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node n) {
+          high_bids_.constructAt(n, std::numeric_limits<int64_t>::min());
+          winners_.constructAt(n, kNone);
+        },
+        katana::no_stats());
+  }
+
+  /// Run scaling phases, each a complete auction with a smaller increment
+  /// on the prices of the last, down to an increment of one
+  katana::Result<void> Run() {
+    int64_t epsilon = std::max<int64_t>(1, max_weight_ / (2 * kEpsilonScaling));
+    while (true) {
+      next_.clear();
+      katana::do_all(
+          katana::iterate(topology_),
+          [&](Node n) {
+            owners_[n] = kNone;
+            if (is_bidder(n)) {
+              next_.push(n);
+            }
+          },
+          katana::no_stats());
+      next_.Adapt();
+
+      while (!next_.empty()) {
+        if (katana::IsCancelled()) {
+          return katana::ErrorCode::Cancelled;
+        }
+        current_.swap(next_);
+        next_.Reset(current_.is_dense());
+        Round(epsilon);
+      }
+
+      if (epsilon == 1) {
+        return katana::ResultSuccess();
+      }
+      epsilon = std::max<int64_t>(1, epsilon / kEpsilonScaling);
+    }
+  }
+
+  std::vector<uint8_t> InMatching() const {
+    std::vector<uint8_t> in_matching(topology_.num_edges());
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          if (!is_right_[n] && assigned_edges_[n] != kNoEdge &&
+              is_bidder(n)) {
+            in_matching[assigned_edges_[n]] = true;
+          }
+        },
+        katana::no_stats());
+    return in_matching;
+  }
+};
+
+/// Scale weights so that an auction ending with an increment of one is
+/// exact, and run it
+katana::Result<std::vector<uint8_t>>
+RunAuction(
+    const katana::GraphTopology& topology,
+    const katana::InEdgeIndex& in_edges, const std::vector<uint8_t>& is_right,
+    std::vector<int64_t>* weights) {
+  katana::GAccumulator<uint64_t> num_bidders;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        if (is_right[n] || !topology.edges(n).empty()) {
+          num_bidders += 1;
+        }
+      },
+      katana::no_stats());
+  int64_t scale = num_bidders.reduce() + 1;
+
+  katana::GReduceMax<int64_t> max_weight;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{weights->size()}),
+      [&](Edge e) {
+        int64_t w = (*weights)[e];
+        max_weight.update(w < 0 ? -w : w);
+      },
+      katana::no_stats());
+  if (max_weight.reduce() > kMaxScaledWeight / scale) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "weights up to {} are too large for {} nodes", max_weight.reduce(),
+        scale - 1);
+  }
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{weights->size()}),
+      [&](Edge e) { (*weights)[e] *= scale; }, katana::no_stats());
+
+  Auction algo(
+      topology, in_edges, is_right, *weights, max_weight.reduce() * scale);
+  if (auto r = algo.Run(); !r) {
+    return r.error();
+  }
+  return algo.InMatching();
+}
+
+template <typename Weight>
+katana::Result<std::vector<int64_t>>
+EdgeWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  auto weights_result =
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto weights = weights_result.value();
+
+  std::vector<int64_t> result(pg->topology().num_edges());
+  katana::GReduceLogicalOr too_large;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{result.size()}),
+      [&](Edge e) {
+        Weight w = weights->Value(e);
+        if constexpr (!std::is_signed_v<Weight>) {
+          if (static_cast<uint64_t>(w) >
+              static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            too_large.update(true);
+          }
+        }
+        result[e] = w;
+      },
+      katana::no_stats());
+  if (too_large.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge property {} has values too large for an int64_t",
+        edge_weight_property_name);
+  }
+  return result;
+}
+
+katana::Result<std::vector<int64_t>>
+EdgeWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return EdgeWeights<uint32_t>(pg, edge_weight_property_name);
+  case arrow::Int32Type::type_id:
+    return EdgeWeights<int32_t>(pg, edge_weight_property_name);
+  case arrow::UInt64Type::type_id:
+    return EdgeWeights<uint64_t>(pg, edge_weight_property_name);
+  case arrow::Int64Type::type_id:
+    return EdgeWeights<int64_t>(pg, edge_weight_property_name);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+/// A matching read back from its output property, with the matched edge
+/// and mate of every node
+struct Matching {
+  std::vector<uint8_t> in_matching;
+  std::vector<Edge> node_edges;
+  std::vector<Node> mates;
+};
+
+katana::Result<Matching>
+ReadMatching(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto output_result = pg->GetEdgePropertyTyped<bool>(output_property_name);
+  if (!output_result) {
+    return output_result.error();
+  }
+  auto output = output_result.value();
+
+  const katana::GraphTopology& topology = pg->topology();
+  Matching matching{
+      std::vector<uint8_t>(topology.num_edges()),
+      std::vector<Edge>(topology.num_nodes(), kNoEdge),
+      std::vector<Node>(topology.num_nodes(), kNone)};
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    for (Edge e : topology.edges(n)) {
+      if (!output->Value(e)) {
+        continue;
+      }
+      Node dest = topology.edge_dest(e);
+      for (Node end : {n, dest}) {
+        if (matching.node_edges[end] != kNoEdge) {
+          return KATANA_ERROR(
+              katana::ErrorCode::AssertionFailed,
+              "node {} is in matched edges {} and {}", end,
+              matching.node_edges[end], e);
+        }
+        matching.node_edges[end] = e;
+      }
+      matching.mates[n] = dest;
+      matching.mates[dest] = n;
+      matching.in_matching[e] = true;
+    }
+  }
+  return matching;
+}
+
+/// The weight of a maximum weight matching, found serially by successive
+/// shortest paths. Costs are negated weights, made non-negative by node
+/// potentials, and augmentation stops once the cheapest path costs
+/// nothing.
+int64_t
+MaximumMatchingWeight(
+    const katana::GraphTopology& topology, const std::vector<uint8_t>& is_right,
+    const std::vector<int64_t>& weights) {
+  constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max() / 4;
+  Node num_nodes = topology.num_nodes();
+  auto is_left = [&](Node n) {
+    return !is_right[n] && !topology.edges(n).empty();
+  };
+
+  std::vector<int64_t> potentials(num_nodes);
+  for (Node n = 0; n < num_nodes; ++n) {
+    for (Edge e : topology.edges(n)) {
+      Node dest = topology.edge_dest(e);
+      potentials[dest] = std::min(potentials[dest], -weights[e]);
+    }
+  }
+  int64_t sink_potential = 0;
+  for (Node n = 0; n < num_nodes; ++n) {
+    sink_potential = std::min(sink_potential, potentials[n]);
+  }
+
+  std::vector<Edge> matched(num_nodes, kNoEdge);
+  std::vector<Node> mates(num_nodes, kNone);
+  std::vector<int64_t> dist(num_nodes);
+  std::vector<Edge> prev_edges(num_nodes);
+  std::vector<Node> prev_nodes(num_nodes);
+  using Item = std::pair<int64_t, Node>;
+  while (true) {
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    for (Node n = 0; n < num_nodes; ++n) {
+      dist[n] = kInfinity;
+      if (is_left(n) && matched[n] == kNoEdge) {
+        dist[n] = 0;
+        queue.emplace(0, n);
+      }
+    }
+    int64_t sink_dist = kInfinity;
+    Node last = kNone;
+    auto relax = [&](Node from, Node to, Edge e, int64_t d) {
+      if (d < dist[to]) {
+        dist[to] = d;
+        prev_edges[to] = e;
+        prev_nodes[to] = from;
+        queue.emplace(d, to);
+      }
+    };
+    while (!queue.empty()) {
+      auto [d, n] = queue.top();
+      queue.pop();
+      if (d > dist[n]) {
+        continue;
+      }
+      if (is_left(n)) {
+        for (Edge e : topology.edges(n)) {
+          Node dest = topology.edge_dest(e);
+          if (e != matched[n]) {
+            relax(
+                n, dest, e,
+                d - weights[e] + potentials[n] - potentials[dest]);
+          }
+        }
+      } else if (matched[n] == kNoEdge) {
+        if (d + potentials[n] - sink_potential < sink_dist) {
+          sink_dist = d + potentials[n] - sink_potential;
+          last = n;
+        }
+      } else {
+        Node mate = mates[n];
+        relax(
+            n, mate, matched[n],
+            d + weights[matched[n]] + potentials[n] - potentials[mate]);
+      }
+    }
+    if (last == kNone || sink_dist + sink_potential >= 0) {
+      break;
+    }
+
+    for (Node n = 0; n < num_nodes; ++n) {
+      potentials[n] += std::min(dist[n], sink_dist);
+    }
+    sink_potential += sink_dist;
+    for (Node right = last;;) {
+      Edge e = prev_edges[right];
+      Node left = prev_nodes[right];
+      Edge old = matched[left];
+      matched[left] = matched[right] = e;
+      mates[left] = right;
+      mates[right] = left;
+      if (old == kNoEdge) {
+        break;
+      }
+      right = topology.edge_dest(old);
+    }
+  }
+
+  int64_t total = 0;
+  for (Node n = 0; n < num_nodes; ++n) {
+    if (is_left(n) && matched[n] != kNoEdge) {
+      total += weights[matched[n]];
+    }
+  }
+  return total;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::BipartiteMatching(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    BipartiteMatchingPlan plan) {
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+  const katana::InEdgeIndex& in_edges = *in_edges_result.value();
+  auto is_right_result = RightSide(pg->topology(), in_edges);
+  if (!is_right_result) {
+    return is_right_result.error();
+  }
+  const std::vector<uint8_t>& is_right = is_right_result.value();
+
+  switch (plan.algorithm()) {
+  case BipartiteMatchingPlan::kPothenFan: {
+    PothenFan algo(pg->topology(), is_right);
+    if (auto r = algo.Run(); !r) {
+      return r.error();
+    }
+    return AddMatchingProperty(pg, output_property_name, algo.InMatching());
+  }
+  case BipartiteMatchingPlan::kAuction: {
+    std::vector<int64_t> weights(pg->topology().num_edges(), 1);
+    auto in_matching_result =
+        RunAuction(pg->topology(), in_edges, is_right, &weights);
+    if (!in_matching_result) {
+      return in_matching_result.error();
+    }
+    return AddMatchingProperty(
+        pg, output_property_name, in_matching_result.value());
+  }
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        static_cast<int>(plan.algorithm()));
+  }
+}
+
+katana::Result<void>
+katana::analytics::WeightedBipartiteMatching(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, BipartiteMatchingPlan plan) {
+  if (plan.algorithm() != BipartiteMatchingPlan::kAuction) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "algorithm {} does not support weights",
+        static_cast<int>(plan.algorithm()));
+  }
+  auto weights_result = EdgeWeights(pg, edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+  const katana::InEdgeIndex& in_edges = *in_edges_result.value();
+  auto is_right_result = RightSide(pg->topology(), in_edges);
+  if (!is_right_result) {
+    return is_right_result.error();
+  }
+
+  auto in_matching_result = RunAuction(
+      pg->topology(), in_edges, is_right_result.value(),
+      &weights_result.value());
+  if (!in_matching_result) {
+    return in_matching_result.error();
+  }
+  return AddMatchingProperty(
+      pg, output_property_name, in_matching_result.value());
+}
+
+katana::Result<void>
+katana::analytics::BipartiteMatchingAssertValid(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto matching_result = ReadMatching(pg, output_property_name);
+  if (!matching_result) {
+    return matching_result.error();
+  }
+  const Matching& matching = matching_result.value();
+
+  // The matching is maximum if and only if no alternating path from an
+  // unmatched left node ends at an unmatched right node
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<uint8_t> visited(topology.num_nodes());
+  std::deque<Node> queue;
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    if (!topology.edges(n).empty() && matching.node_edges[n] == kNoEdge) {
+      queue.emplace_back(n);
+    }
+  }
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop_front();
+    for (Edge e : topology.edges(n)) {
+      Node right = topology.edge_dest(e);
+      if (matching.in_matching[e] || visited[right]) {
+        continue;
+      }
+      visited[right] = true;
+      if (matching.mates[right] == kNone) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "the matching is not maximum: node {} has an augmenting path",
+            right);
+      }
+      queue.emplace_back(matching.mates[right]);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::WeightedBipartiteMatchingAssertValid(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  auto weights_result = EdgeWeights(pg, edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  const std::vector<int64_t>& weights = weights_result.value();
+  auto matching_result = ReadMatching(pg, output_property_name);
+  if (!matching_result) {
+    return matching_result.error();
+  }
+  const Matching& matching = matching_result.value();
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+  auto is_right_result =
+      RightSide(pg->topology(), *in_edges_result.value());
+  if (!is_right_result) {
+    return is_right_result.error();
+  }
+
+  int64_t weight = 0;
+  for (Edge e = 0; e < weights.size(); ++e) {
+    if (matching.in_matching[e]) {
+      weight += weights[e];
+    }
+  }
+  int64_t expected =
+      MaximumMatchingWeight(pg->topology(), is_right_result.value(), weights);
+  if (weight != expected) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the matching has weight {} but the maximum is {}", weight, expected);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<BipartiteMatchingStatistics>
+katana::analytics::BipartiteMatchingStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto output_result = pg->GetEdgePropertyTyped<bool>(output_property_name);
+  if (!output_result) {
+    return output_result.error();
+  }
+  auto output = output_result.value();
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+  const katana::InEdgeIndex& in_edges = *in_edges_result.value();
+
+  const katana::GraphTopology& topology = pg->topology();
+  katana::GAccumulator<uint64_t> n_matched_edges;
+  katana::GAccumulator<uint64_t> n_left_nodes;
+  katana::GAccumulator<uint64_t> n_right_nodes;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        if (!topology.edges(n).empty()) {
+          n_left_nodes += 1;
+        }
+        if (!in_edges.in_edges(n).empty()) {
+          n_right_nodes += 1;
+        }
+        for (Edge e : topology.edges(n)) {
+          if (output->Value(e)) {
+            n_matched_edges += 1;
+          }
+        }
+      },
+      katana::no_stats());
+  return BipartiteMatchingStatistics{
+      n_matched_edges.reduce(), n_left_nodes.reduce(), n_right_nodes.reduce()};
+}
+
+void
+katana::analytics::BipartiteMatchingStatistics::Print(std::ostream& os) const {
+  os << "Matched edges = " << n_matched_edges << std::endl;
+  os << "Left nodes = " << n_left_nodes << std::endl;
+  os << "Right nodes = " << n_right_nodes << std::endl;
+}
@@ -20,7 +20,14 @@
 #include "katana/analytics/connected_components/connected_components.h"
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Cancellation.h"
+#include "katana/EdgeBalancedRange.h"
+#include "katana/EdgeOrder.h"
+#include "katana/Frontier.h"
+#include "katana/ParallelSTL.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/DistributedPropagation.h"
+#include "tsuba/tsuba.h"
 
 using namespace katana::analytics;
 
@@ -124,30 +131,36 @@ struct ConnectedComponentsLabelPropAlgo {
   void Deallocate(Graph*) {}
 
   void operator()(Graph* graph) {
-    katana::GReduceLogicalOr changed;
-    do {
-      changed.reset();
-      katana::do_all(
-          katana::iterate(*graph),
+    // Only nodes whose label dropped in the last round can lower a
+    // neighbor's label, so every round after the first visits just those
+    katana::Frontier current(graph->size());
+    katana::Frontier next(graph->size());
+    current.Fill();
+
+    while (!current.empty()) {
+      next.Reset(current.is_dense());
+      current.ForEach(
           [&](const GNode& src) {
             auto& sdata_current_comp = graph->GetData<NodeComponent>(src);
             auto& sdata_old_comp = old_component_[src];
             if (sdata_old_comp > sdata_current_comp) {
               sdata_old_comp = sdata_current_comp;
 
-              changed.update(true);
-
               for (auto e : graph->edges(src)) {
                 auto dest = graph->GetEdgeDest(e);
                 auto& ddata_current_comp = graph->GetData<NodeComponent>(dest);
                 ComponentType label_new = sdata_current_comp;
-                katana::atomicMin(ddata_current_comp, label_new);
+                if (katana::atomicMin(ddata_current_comp, label_new) >
+                    label_new) {
+                  next.push(*dest);
+                }
               }
             }
           },
-          katana::disable_conflict_detection(), katana::steal(),
-          katana::loopname("ConnectedComponentsLabelPropAlgo"));
-    } while (changed.reduce());
+          "ConnectedComponentsLabelPropAlgo");
+      next.Adapt();
+      current.swap(next);
+    }
   }
 };
 
@@ -342,7 +355,6 @@ struct ConnectedComponentsEdgeAsynchronousAlgo {
   using EdgeData = std::tuple<>;
   typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
   typedef typename Graph::Node GNode;
-  using Edge = std::pair<GNode, typename Graph::edge_iterator>;
 
   ConnectedComponentsPlan& plan_;
   ConnectedComponentsEdgeAsynchronousAlgo(ConnectedComponentsPlan& plan)
@@ -366,30 +378,17 @@ struct ConnectedComponentsEdgeAsynchronousAlgo {
   void operator()(Graph* graph) {
     katana::GAccumulator<size_t> empty_merges;
 
-    katana::InsertBag<Edge> works;
+    // Along a Hilbert curve, consecutive merges touch nearby components
+    katana::LargeArray<katana::OrderedEdge> works = katana::OrderEdges(
+        graph->GetPropertyGraph().topology(), katana::EdgeOrder::kHilbert,
+        [](GNode src, GNode dst) { return src < dst; });
 
     katana::do_all(
-        katana::iterate(*graph),
-        [&](const GNode& src) {
-          for (const auto& ii : graph->edges(src)) {
-            if (src < *(graph->GetEdgeDest(ii))) {
-              works.push_back(std::make_pair(src, ii));
-            }
-          }
-        },
-        katana::loopname("CC-EdgeAsynchronousInit"), katana::steal());
-
-    katana::do_all(
-        katana::iterate(works),
-        [&](Edge& e) {
-          auto& sdata = graph->GetData<NodeComponent>(e.first);
-          auto dest = graph->GetEdgeDest(e.second);
-          auto& ddata = graph->GetData<NodeComponent>(dest);
-
-          if (e.first > *dest)
-            // continue;
-            ;
-          else if (!sdata->merge(ddata)) {
+        katana::iterate(works.begin(), works.end()),
+        [&](const katana::OrderedEdge& e) {
+          auto& sdata = graph->GetData<NodeComponent>(e.src);
+          auto& ddata = graph->GetData<NodeComponent>(e.dst);
+          if (!sdata->merge(ddata)) {
             empty_merges += 1;
           }
         },
@@ -538,52 +537,18 @@ struct ConnectedComponentsEdgeTiledAsynchronousAlgo {
     });
   }
 
-  struct EdgeTile {
-    // ConnectedComponentsNode* sData;
-    GNode src;
-    Graph::edge_iterator beg;
-    Graph::edge_iterator end;
-  };
-
-  /*struct EdgeTileMaker {
-      EdgeTile operator() (ConnectedComponentsNode* sdata, Graph::edge_iterator beg,
-  Graph::edge_iterator end) const{ return EdgeTile{sdata, beg, end};
-      }
-  };*/
-
   void operator()(Graph* graph) {
     katana::GAccumulator<size_t> empty_merges;
 
-    katana::InsertBag<EdgeTile> works;
-    katana::do_all(
-        katana::iterate(*graph),
-        [&](const GNode& src) {
-          auto beg = graph->edge_begin(src);
-          const auto& end = graph->edge_end(src);
-
-          KATANA_LOG_DEBUG_ASSERT(beg <= end);
-          if ((end - beg) > plan_.edge_tile_size()) {
-            for (; beg + plan_.edge_tile_size() < end;) {
-              const auto& ne = beg + plan_.edge_tile_size();
-              KATANA_LOG_DEBUG_ASSERT(ne < end);
-              works.push_back(EdgeTile{src, beg, ne});
-              beg = ne;
-            }
-          }
-
-          if ((end - beg) > 0) {
-            works.push_back(EdgeTile{src, beg, end});
-          }
-        },
-        katana::loopname("CC-EdgeTiledAsynchronousInit"), katana::steal());
+    katana::EdgeTiles works(graph->topology(), plan_.edge_tile_size());
 
     katana::do_all(
         katana::iterate(works),
-        [&](const EdgeTile& tile) {
-          const auto& src = tile.src;
+        [&](const katana::EdgeTile& tile) {
+          const auto& src = tile.node;
           auto& sdata = graph->GetData<NodeComponent>(src);
 
-          for (auto ii = tile.beg; ii != tile.end; ++ii) {
+          for (auto ii : tile.edges()) {
             auto dest = graph->GetEdgeDest(ii);
             if (src >= *dest)
               continue;
@@ -1122,6 +1087,142 @@ struct ConnectedComponentsEdgeTiledAfforestAlgo {
   }
 };
 
+struct ConnectedComponentsAfforestCompactAlgo {
+  using ComponentType = uint64_t;
+  struct NodeComponent {
+    using ArrowType = arrow::CTypeTraits<ComponentType>::ArrowType;
+    using ViewType = katana::PODPropertyView<ComponentType>;
+  };
+
+  using NodeData = std::tuple<NodeComponent>;
+  using EdgeData = std::tuple<>;
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+  typedef typename Graph::Node GNode;
+
+  ConnectedComponentsPlan& plan_;
+  /// The parent of each node in the union-find forest; roots are their own
+  /// parents and have the least node id of their tree
+  katana::LargeArray<std::atomic<GNode>> parent_;
+
+  ConnectedComponentsAfforestCompactAlgo(ConnectedComponentsPlan& plan)
+      : plan_(plan) {}
+
+  void Initialize(Graph* graph) {
+    parent_.allocateBlocked(graph->size());
+    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
+      new (&parent_[node]) std::atomic<GNode>(node);
+    });
+  }
+
+  void Deallocate(Graph* graph) {
+    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
+      graph->GetData<NodeComponent>(node) =
+          parent_[node].load(std::memory_order_relaxed);
+    });
+  }
+
+  GNode Parent(GNode node) const {
+    return parent_[node].load(std::memory_order_relaxed);
+  }
+
+  /// Join the trees of u and v by hooking the greater of two roots onto the
+  /// lesser one
+  void Link(GNode u, GNode v) {
+    GNode p1 = Parent(u);
+    GNode p2 = Parent(v);
+    while (p1 != p2) {
+      GNode high = std::max(p1, p2);
+      GNode low = std::min(p1, p2);
+      GNode p_high = Parent(high);
+      if (p_high == low ||
+          (p_high == high &&
+           parent_[high].compare_exchange_strong(p_high, low))) {
+        break;
+      }
+      p1 = Parent(Parent(high));
+      p2 = Parent(low);
+    }
+  }
+
+  /// Point node directly at its root
+  void Compress(GNode node) {
+    GNode parent = Parent(node);
+    while (parent != Parent(parent)) {
+      parent = Parent(parent);
+    }
+    parent_[node].store(parent, std::memory_order_relaxed);
+  }
+
+  /// \returns the most frequent root of sampled nodes
+  GNode ApproxLargestComponent(Graph* graph) {
+    using map_type = katana::gstl::UnorderedMap<GNode, int>;
+    using pair_type = std::pair<GNode, int>;
+
+    map_type comp_freq(plan_.component_sample_frequency());
+    std::random_device rd;
+    std::mt19937 rng(rd());
+    std::uniform_int_distribution<uint32_t> dist(0, graph->size() - 1);
+    for (uint32_t i = 0; i < plan_.component_sample_frequency(); i++) {
+      comp_freq[Parent(dist(rng))]++;
+    }
+
+    KATANA_LOG_DEBUG_ASSERT(!comp_freq.empty());
+    auto most_frequent = std::max_element(
+        comp_freq.cbegin(), comp_freq.cend(),
+        [](const pair_type& a, const pair_type& b) {
+          return a.second < b.second;
+        });
+    return most_frequent->first;
+  }
+
+  void operator()(Graph* graph) {
+    if (graph->size() == 0) {
+      return;
+    }
+
+    for (uint32_t r = 0; r < plan_.neighbor_sample_size(); ++r) {
+      katana::do_all(
+          katana::iterate(*graph),
+          [&](const GNode& src) {
+            Graph::edge_iterator ii = graph->edge_begin(src);
+            Graph::edge_iterator ei = graph->edge_end(src);
+            std::advance(ii, r);
+            if (ii < ei) {
+              Link(src, *graph->GetEdgeDest(ii));
+            }
+          },
+          katana::steal(), katana::loopname("AfforestCompact-VNS-Link"));
+
+      katana::do_all(
+          katana::iterate(*graph), [&](const GNode& src) { Compress(src); },
+          katana::steal(), katana::loopname("AfforestCompact-VNS-Compress"));
+    }
+
+    katana::StatTimer StatTimer_Sampling("AfforestCompact-LCS-Sampling");
+    StatTimer_Sampling.start();
+    const GNode c = ApproxLargestComponent(graph);
+    StatTimer_Sampling.stop();
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& src) {
+          if (Parent(src) == c) {
+            return;
+          }
+          Graph::edge_iterator ii = graph->edge_begin(src);
+          Graph::edge_iterator ei = graph->edge_end(src);
+          for (std::advance(ii, plan_.neighbor_sample_size()); ii < ei; ++ii) {
+            Link(src, *graph->GetEdgeDest(ii));
+          }
+        },
+        katana::steal(), katana::loopname("AfforestCompact-LCS-Link"));
+
+    katana::do_all(
+        katana::iterate(*graph), [&](const GNode& src) { Compress(src); },
+        katana::steal(), katana::loopname("AfforestCompact-LCS-Compress"));
+  }
+};
+
 }  //namespace
 
 template <typename Algorithm>
@@ -1153,13 +1254,157 @@ ConnectedComponentsWithWrap(
   execTime.stop();
 
   algo.Deallocate(&graph);
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return katana::ResultSuccess();
+}
+
+/// Label propagation on the partition pg of a graph partitioned across the
+/// hosts of tsuba::Comm(): components are labeled by the least id in the RDG
+/// of their nodes
+static katana::Result<void>
+DistributedConnectedComponents(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  using Algo = ConnectedComponentsLabelPropAlgo;
+  using ComponentType = Algo::ComponentType;
+  auto sync_res = katana::MirrorSync::Make(*pg, tsuba::Comm());
+  if (!sync_res) {
+    return sync_res.error();
+  }
+  katana::MirrorSync& sync = sync_res.value();
+
+  const katana::GraphTopology& topology = pg->topology();
+  katana::LargeArray<std::atomic<ComponentType>> labels;
+  labels.allocateBlocked(topology.num_nodes());
+  katana::DynamicBitset active;
+  active.resize(topology.num_nodes());
+  active.bitwise_not();
+  katana::do_all(
+      katana::iterate(topology),
+      [&](uint32_t n) { labels.constructAt(n, sync.global_id(n)); },
+      katana::no_stats());
+
+  auto rounds_res = DistributedMinPropagation<ComponentType>(
+      topology, &sync, &labels, &active, [](auto) { return ComponentType{0}; });
+  if (!rounds_res) {
+    return rounds_res.error();
+  }
+
+  if (auto r = ConstructNodeProperties<std::tuple<Algo::NodeComponent>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto graph_res = Algo::Graph::Make(pg, {output_property_name}, {});
+  if (!graph_res) {
+    return graph_res.error();
+  }
+  Algo::Graph graph = graph_res.value();
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) {
+        graph.GetData<Algo::NodeComponent>(n) = labels[n].load();
+      },
+      katana::no_stats());
   return katana::ResultSuccess();
 }
 
+std::vector<PlanCandidate<ConnectedComponentsPlan>>
+katana::analytics::ConnectedComponentsCandidates() {
+  using Plan = ConnectedComponentsPlan;
+  // Serial is left out: it may win on a small sample but not on the graph
+  std::vector<PlanCandidate<Plan>> candidates{
+      {"LabelProp", Plan::LabelProp()},
+      {"Synchronous", Plan::Synchronous()},
+      {"Asynchronous", Plan::Asynchronous()},
+      {"EdgeAsynchronous", Plan::EdgeAsynchronous()},
+      {"BlockedAsynchronous", Plan::BlockedAsynchronous()},
+      {"Afforest", Plan::Afforest()},
+      {"EdgeAfforest", Plan::EdgeAfforest()},
+      {"AfforestCompact", Plan::AfforestCompact()},
+  };
+  for (ptrdiff_t tile_size : {128, 512, 2048}) {
+    candidates.push_back(
+        {fmt::format("EdgeTiledAsynchronous/{}", tile_size),
+         Plan::EdgeTiledAsynchronous(tile_size)});
+    candidates.push_back(
+        {fmt::format("EdgeTiledAfforest/{}", tile_size),
+         Plan::EdgeTiledAfforest(tile_size)});
+  }
+  return candidates;
+}
+
+katana::Result<ConnectedComponentsPlan>
+katana::analytics::AutotuneConnectedComponents(
+    PropertyGraph* pg, const AutotuneOptions& options) {
+  return Autotune(
+      pg, "ConnectedComponents", ConnectedComponentsCandidates(),
+      [](PropertyGraph* sample, const ConnectedComponentsPlan& plan) {
+        return ConnectedComponents(sample, "autotune-component", plan);
+      },
+      options);
+}
+
+katana::Result<katana::analytics::ApproximationStatistics>
+katana::analytics::ApproximateConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    SparsifyPlan sparsify_plan, ConnectedComponentsPlan plan) {
+  auto sample_res = Sparsify(pg, sparsify_plan);
+  if (!sample_res) {
+    return sample_res.error();
+  }
+  PropertyGraph* sample = sample_res.value().graph.get();
+  if (auto r = ConnectedComponents(sample, output_property_name, plan); !r) {
+    return r.error();
+  }
+  // The nodes are the same, so the components carry over as they are
+  auto components = sample->GetNodeProperty(output_property_name);
+  if (auto r = pg->AddNodeProperties(arrow::Table::Make(
+          arrow::schema(
+              {arrow::field(output_property_name, components->type())}),
+          {components}));
+      !r) {
+    return r.error();
+  }
+
+  auto component_res =
+      pg->GetNodePropertyTyped<uint64_t>(output_property_name);
+  if (!component_res) {
+    return component_res.error();
+  }
+  const uint64_t* component = component_res.value()->raw_values();
+  const GraphTopology& topology = pg->topology();
+  katana::GAccumulator<uint64_t> crossing;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](GraphTopology::Node n) {
+        uint64_t count = 0;
+        for (auto e : topology.edges(n)) {
+          count += component[topology.edge_dest(e)] != component[n];
+        }
+        crossing += count;
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("ConnectedComponentsCrossingEdges"));
+
+  return ApproximationStatistics{
+      sample->num_edges(), sample_res.value().edge_fraction,
+      topology.num_edges() == 0
+          ? 0
+          : static_cast<double>(crossing.reduce()) / topology.num_edges()};
+}
+
 katana::Result<void>
 katana::analytics::ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
     ConnectedComponentsPlan plan) {
+  if (auto r = CheckArchitecture(plan, {kCPU, kDistributedCPU}); !r) {
+    return r.error();
+  }
+  if (plan.architecture() == kDistributedCPU) {
+    return DistributedConnectedComponents(pg, output_property_name);
+  }
   switch (plan.algorithm()) {
   case ConnectedComponentsPlan::kSerial:
     return ConnectedComponentsWithWrap<ConnectedComponentsSerialAlgo>(
@@ -1194,11 +1439,183 @@ katana::analytics::ConnectedComponents(
     return ConnectedComponentsWithWrap<
         ConnectedComponentsEdgeTiledAfforestAlgo>(
         pg, output_property_name, plan);
+  case ConnectedComponentsPlan::kAfforestCompact:
+    return ConnectedComponentsWithWrap<ConnectedComponentsAfforestCompactAlgo>(
+        pg, output_property_name, plan);
   default:
     return ErrorCode::InvalidArgument;
   }
 }
 
+namespace {
+
+/// The component of a node of a graph view
+struct ViewComponentNode : public katana::UnionFindNode<ViewComponentNode> {
+  ViewComponentNode() : katana::UnionFindNode<ViewComponentNode>(this) {}
+};
+
+/// Connected components over the edges of a GraphView or TemporalWindow
+template <typename View>
+katana::Result<void>
+ViewConnectedComponents(
+    const View& view, const std::string& output_property_name) {
+  using ComponentType = uint64_t;
+  struct NodeComponent : public katana::PODProperty<ComponentType> {};
+
+  using NodeData = std::tuple<NodeComponent>;
+  using EdgeData = std::tuple<>;
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+
+  katana::PropertyGraph* pg = view.graph();
+  if (auto r = katana::analytics::ConstructNodeProperties<NodeData>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  katana::StatTimer execTime("ConnectedComponent");
+  execTime.start();
+
+  // Union-find links toward lower addresses, so each component is rooted at
+  // its least node
+  std::vector<ViewComponentNode> components(view.size());
+  katana::do_all(
+      katana::iterate(view),
+      [&](typename View::Node n) {
+        for (auto e : view.edges(n)) {
+          components[n].merge(&components[view.edge_dest(e)]);
+        }
+      },
+      katana::steal(), katana::loopname("ViewCC-Link"));
+
+  katana::do_all(
+      katana::iterate(view),
+      [&](typename View::Node n) {
+        components[n].compress();
+        graph.GetData<NodeComponent>(n) =
+            components[n].get() - components.data();
+      },
+      katana::loopname("ViewCC-Label"));
+
+  execTime.stop();
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::ConnectedComponents(
+    const GraphView& view, const std::string& output_property_name) {
+  return ViewConnectedComponents(view, output_property_name);
+}
+
+katana::Result<void>
+katana::analytics::ConnectedComponents(
+    const TemporalWindow& window, const std::string& output_property_name) {
+  return ViewConnectedComponents(window, output_property_name);
+}
+
+namespace {
+
+/// A set of component labels joined by inserted edges
+struct LabelSetNode : public katana::UnionFindNode<LabelSetNode> {
+  LabelSetNode() : katana::UnionFindNode<LabelSetNode>(this) {}
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges) {
+  using ComponentType = uint64_t;
+  struct NodeComponent : public katana::PODProperty<ComponentType> {};
+
+  using NodeData = std::tuple<NodeComponent>;
+  using EdgeData = std::tuple<>;
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+  typedef typename Graph::Node GNode;
+
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+
+  auto graph = pg_result.value();
+
+  for (const auto& [src, dst] : inserted_edges) {
+    if (src >= graph.size() || dst >= graph.size()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "inserted edge ({}, {}) is not between nodes of the graph", src,
+          dst);
+    }
+  }
+
+  // The distinct labels of the endpoints, sorted, so that the union-find,
+  // which links toward lower addresses, roots each set at its least label
+  std::vector<ComponentType> labels(2 * inserted_edges.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, inserted_edges.size()),
+      [&](size_t i) {
+        const auto& [src, dst] = inserted_edges[i];
+        labels[2 * i] = graph.GetData<NodeComponent>(src);
+        labels[2 * i + 1] = graph.GetData<NodeComponent>(dst);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::radix_sort(labels.begin(), labels.end());
+  labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+
+  auto find_label = [&](ComponentType label) {
+    return std::lower_bound(labels.begin(), labels.end(), label);
+  };
+
+  std::vector<LabelSetNode> sets(labels.size());
+  katana::GAccumulator<uint64_t> merges;
+  katana::do_all(
+      katana::iterate(inserted_edges),
+      [&](const std::pair<uint32_t, uint32_t>& edge) {
+        auto src = find_label(graph.GetData<NodeComponent>(edge.first));
+        auto dst = find_label(graph.GetData<NodeComponent>(edge.second));
+        if (sets[src - labels.begin()].merge(&sets[dst - labels.begin()])) {
+          merges += 1;
+        }
+      },
+      katana::steal(), katana::loopname("IncrementalCC-Link"));
+
+  if (merges.reduce() == 0) {
+    return katana::ResultSuccess();
+  }
+
+  katana::do_all(
+      katana::iterate(size_t{0}, sets.size()),
+      [&](size_t i) { sets[i].compress(); },
+      katana::loopname("IncrementalCC-Compress"));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        ComponentType& label = graph.GetData<NodeComponent>(node);
+        auto it = find_label(label);
+        if (it == labels.end() || *it != label) {
+          return;
+        }
+        const LabelSetNode* rep = sets[it - labels.begin()].get();
+        label = labels[rep - sets.data()];
+      },
+      katana::loopname("IncrementalCC-Relabel"));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::analytics::ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name) {
@@ -1259,37 +1676,11 @@ katana::analytics::ConnectedComponentsStatistics::Compute(
 
   auto graph = pg_result.value();
 
-  using Map = katana::gstl::Map<ComponentType, int>;
-
-  auto reduce = [](Map& lhs, Map&& rhs) -> Map& {
-    Map v{std::move(rhs)};
-
-    for (auto& kv : v) {
-      if (lhs.count(kv.first) == 0) {
-        lhs[kv.first] = 0;
-      }
-      lhs[kv.first] += kv.second;
-    }
-
-    return lhs;
-  };
-
-  auto mapIdentity = []() { return Map(); };
-
-  auto accumMap = katana::make_reducible(reduce, mapIdentity);
-
-  katana::GAccumulator<size_t> accumReps;
-
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& x) {
-        auto& n = graph.template GetData<NodeComponent>(x);
-        accumMap.update(Map{std::make_pair(n, 1)});
-      },
-      katana::loopname("CountLargest"));
-
-  Map& map = accumMap.reduce();
-  size_t reps = map.size();
+  auto components = katana::ParallelSTL::group_by(
+      graph.begin(), graph.end(), [&](const GNode& x) {
+        return graph.template GetData<NodeComponent>(x);
+      });
+  size_t reps = components.size();
 
   using ComponentSizePair = std::pair<ComponentType, int>;
 
@@ -1305,9 +1696,9 @@ katana::analytics::ConnectedComponentsStatistics::Compute(
   auto maxComp = katana::make_reducible(sizeMax, identity);
 
   katana::GAccumulator<uint64_t> non_trivial_components;
-  katana::do_all(katana::iterate(map), [&](const ComponentSizePair& x) {
-    maxComp.update(x);
-    if (x.second > 1) {
+  katana::do_all(katana::iterate(components), [&](const auto& x) {
+    maxComp.update(ComponentSizePair(x.key, x.count));
+    if (x.count > 1) {
       non_trivial_components += 1;
     }
   });
@@ -0,0 +1,831 @@
+#include "katana/analytics/graph_partition/graph_partition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Cancellation.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using Partition = uint32_t;
+
+constexpr Node kUnmatched = std::numeric_limits<Node>::max();
+constexpr Partition kUnassigned = std::numeric_limits<Partition>::max();
+/// The number of proposal rounds of each matching
+constexpr uint32_t kMatchingRounds = 4;
+/// Stop coarsening when a level keeps more than this fraction of the nodes
+/// of the level before it
+constexpr double kMinCoarseningRatio = 0.95;
+
+/// One level of the multilevel hierarchy: an undirected graph with weighted
+/// nodes and edges in CSR form, which holds both directions of every edge
+struct Level {
+  std::vector<uint64_t> offsets;
+  std::vector<Node> dests;
+  std::vector<uint64_t> edge_weights;
+  std::vector<uint64_t> node_weights;
+  /// The node of the next coarser level each node is merged into
+  std::vector<Node> coarse;
+
+  Node num_nodes() const { return node_weights.size(); }
+  uint64_t edge_begin(Node n) const { return offsets[n]; }
+  uint64_t edge_end(Node n) const { return offsets[n + 1]; }
+};
+
+using Neighbors = std::vector<std::pair<Node, uint64_t>>;
+
+/// Sort neighbors by node and merge duplicates, summing their weights
+void
+MergeNeighbors(Neighbors* neighbors) {
+  std::sort(neighbors->begin(), neighbors->end());
+  size_t size = 0;
+  for (const auto& neighbor : *neighbors) {
+    if (size > 0 && (*neighbors)[size - 1].first == neighbor.first) {
+      (*neighbors)[size - 1].second += neighbor.second;
+    } else {
+      (*neighbors)[size++] = neighbor;
+    }
+  }
+  neighbors->resize(size);
+}
+
+/// Fill in the edges of level, where gather(n, &neighbors) appends the
+/// neighbors of node n, possibly more than once each. The neighbors are
+/// gathered twice, once to count them and once to place them, so no lists
+/// are kept between the passes.
+template <typename Gather>
+void
+BuildEdges(Level* level, const Gather& gather) {
+  Node num_nodes = level->num_nodes();
+  katana::PerThreadStorage<Neighbors> scratch;
+  auto neighbors_of = [&](Node n) -> const Neighbors& {
+    Neighbors& neighbors = *scratch.getLocal();
+    neighbors.clear();
+    gather(n, &neighbors);
+    MergeNeighbors(&neighbors);
+    return neighbors;
+  };
+
+  level->offsets.assign(num_nodes + 1, 0);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) { level->offsets[n + 1] = neighbors_of(n).size(); },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      level->offsets.begin(), level->offsets.end(), level->offsets.begin());
+
+  level->dests.resize(level->offsets[num_nodes]);
+  level->edge_weights.resize(level->offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        uint64_t e = level->offsets[n];
+        for (const auto& [dst, weight] : neighbors_of(n)) {
+          level->dests[e] = dst;
+          level->edge_weights[e] = weight;
+          ++e;
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// The undirected graph of topology, where every node weighs one and every
+/// edge weighs the number of edges between its endpoints in either
+/// direction. Self loops are dropped.
+Level
+BaseLevel(
+    const katana::GraphTopology& topology, const katana::InEdgeIndex& in) {
+  Level level;
+  level.node_weights.assign(topology.num_nodes(), 1);
+  BuildEdges(&level, [&](Node n, Neighbors* neighbors) {
+    for (Edge e : topology.edges(n)) {
+      if (Node dst = topology.edge_dest(e); dst != n) {
+        neighbors->emplace_back(dst, 1);
+      }
+    }
+    for (Edge e : in.in_edges(n)) {
+      if (Node src = in.in_edge_src(e); src != n) {
+        neighbors->emplace_back(src, 1);
+      }
+    }
+  });
+  return level;
+}
+
+/// A pseudo-random priority of the edge between a and b, the same in both
+/// directions, that breaks ties between edges of equal weight. Ties broken
+/// by id would make most nodes propose to their smallest neighbor, which
+/// would rarely propose back.
+uint64_t
+TieBreak(Node a, Node b) {
+  // The finalizer of SplitMix64
+  uint64_t x = (uint64_t{std::min(a, b)} << 32) | std::max(a, b);
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// Match the nodes of fine along heavy edges, recording in fine->coarse the
+/// node of the coarser level each is merged into, and return that level.
+/// In each round every unmatched node proposes to its heaviest unmatched
+/// neighbor, and two nodes that propose to each other are matched, so the
+/// matching does not depend on the schedule. Pairs heavier than
+/// max_node_weight are not matched.
+Level
+Coarsen(Level* fine, uint64_t max_node_weight) {
+  Node num_nodes = fine->num_nodes();
+  std::vector<Node> match(num_nodes, kUnmatched);
+  std::vector<Node> proposal(num_nodes);
+  for (uint32_t round = 0; round < kMatchingRounds; ++round) {
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes),
+        [&](Node n) {
+          proposal[n] = n;
+          if (match[n] != kUnmatched) {
+            return;
+          }
+          uint64_t best_weight = 0;
+          uint64_t best_tie = 0;
+          for (uint64_t e = fine->edge_begin(n); e < fine->edge_end(n); ++e) {
+            Node dst = fine->dests[e];
+            if (match[dst] != kUnmatched ||
+                fine->node_weights[n] + fine->node_weights[dst] >
+                    max_node_weight) {
+              continue;
+            }
+            uint64_t weight = fine->edge_weights[e];
+            uint64_t tie = TieBreak(n, dst);
+            if (proposal[n] == n || weight > best_weight ||
+                (weight == best_weight && tie > best_tie)) {
+              proposal[n] = dst;
+              best_weight = weight;
+              best_tie = tie;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    katana::GAccumulator<uint64_t> matched;
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes),
+        [&](Node n) {
+          Node other = proposal[n];
+          if (other != n && proposal[other] == n) {
+            match[n] = other;
+            matched += 1;
+          }
+        },
+        katana::no_stats());
+    if (matched.reduce() == 0) {
+      break;
+    }
+  }
+
+  // Each coarse node is represented by its smaller fine node
+  std::vector<Node> rank(num_nodes);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) { rank[n] = match[n] == kUnmatched || n < match[n]; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+  Node num_coarse = num_nodes > 0 ? rank.back() : 0;
+
+  std::vector<Node> representatives(num_coarse);
+  fine->coarse.resize(num_nodes);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        Node representative =
+            match[n] == kUnmatched ? n : std::min(n, match[n]);
+        fine->coarse[n] = rank[representative] - 1;
+        if (representative == n) {
+          representatives[rank[n] - 1] = n;
+        }
+      },
+      katana::no_stats());
+
+  Level coarse;
+  coarse.node_weights.resize(num_coarse);
+  katana::do_all(
+      katana::iterate(Node{0}, num_coarse),
+      [&](Node c) {
+        Node representative = representatives[c];
+        coarse.node_weights[c] = fine->node_weights[representative];
+        if (Node other = match[representative]; other != kUnmatched) {
+          coarse.node_weights[c] += fine->node_weights[other];
+        }
+      },
+      katana::no_stats());
+  BuildEdges(&coarse, [&](Node c, Neighbors* neighbors) {
+    auto gather = [&](Node member) {
+      for (uint64_t e = fine->edge_begin(member); e < fine->edge_end(member);
+           ++e) {
+        if (Node dst = fine->coarse[fine->dests[e]]; dst != c) {
+          neighbors->emplace_back(dst, fine->edge_weights[e]);
+        }
+      }
+    };
+    Node representative = representatives[c];
+    gather(representative);
+    if (Node other = match[representative]; other != kUnmatched) {
+      gather(other);
+    }
+  });
+  return coarse;
+}
+
+/// The total node weight of each of the num_partitions partitions
+std::vector<uint64_t>
+PartitionWeights(
+    const Level& level, const std::vector<Partition>& part,
+    Partition num_partitions) {
+  katana::PerThreadStorage<std::vector<uint64_t>> local_weights;
+  katana::do_all(
+      katana::iterate(Node{0}, level.num_nodes()),
+      [&](Node n) {
+        std::vector<uint64_t>& weights = *local_weights.getLocal();
+        if (weights.empty()) {
+          weights.resize(num_partitions);
+        }
+        weights[part[n]] += level.node_weights[n];
+      },
+      katana::no_stats());
+
+  std::vector<uint64_t> weights(num_partitions);
+  for (unsigned i = 0; i < local_weights.size(); ++i) {
+    const std::vector<uint64_t>& local = *local_weights.getRemote(i);
+    for (size_t p = 0; p < local.size(); ++p) {
+      weights[p] += local[p];
+    }
+  }
+  return weights;
+}
+
+/// Partition the coarsest level by greedy graph growing. Each partition in
+/// turn grows from an unassigned node by taking the unassigned node most
+/// connected to it, until it holds its share of the remaining weight; the
+/// last partition takes whatever is left.
+std::vector<Partition>
+GrowPartitions(const Level& level, Partition num_partitions) {
+  Node num_nodes = level.num_nodes();
+  std::vector<Partition> part(num_nodes, kUnassigned);
+  std::vector<uint64_t> connection(num_nodes);
+  uint64_t remaining = 0;
+  for (uint64_t weight : level.node_weights) {
+    remaining += weight;
+  }
+
+  Node next_seed = 0;
+  for (Partition p = 0; p < num_partitions; ++p) {
+    uint64_t target = remaining / (num_partitions - p);
+    uint64_t weight = 0;
+    std::priority_queue<std::pair<uint64_t, Node>> frontier;
+    std::vector<Node> touched;
+    while (weight < target || p + 1 == num_partitions) {
+      if (frontier.empty()) {
+        while (next_seed < num_nodes && part[next_seed] != kUnassigned) {
+          ++next_seed;
+        }
+        if (next_seed == num_nodes) {
+          break;
+        }
+        frontier.emplace(0, next_seed);
+      }
+      auto [node_connection, n] = frontier.top();
+      frontier.pop();
+      // Skip nodes already taken and entries superseded by a later push
+      if (part[n] != kUnassigned || node_connection != connection[n]) {
+        continue;
+      }
+      part[n] = p;
+      weight += level.node_weights[n];
+      for (uint64_t e = level.edge_begin(n); e < level.edge_end(n); ++e) {
+        Node dst = level.dests[e];
+        if (part[dst] == kUnassigned) {
+          connection[dst] += level.edge_weights[e];
+          frontier.emplace(connection[dst], dst);
+          touched.emplace_back(dst);
+        }
+      }
+    }
+    for (Node n : touched) {
+      connection[n] = 0;
+    }
+    remaining -= weight;
+  }
+  return part;
+}
+
+/// The weight of the edges from a node to each partition
+struct Connectivity {
+  std::vector<uint64_t> weights;
+  /// The partitions with nonzero weights
+  std::vector<Partition> partitions;
+};
+
+/// Improve part by moving nodes of level to the partition they have the
+/// most edge weight to. Every step reads the partitions of the step before,
+/// and steps alternate between moves to higher and to lower numbered
+/// partitions, so two neighbors never trade places and undo each other's
+/// gain. A node may also move without gain to even out the partition
+/// weights, and must move out of a partition heavier than
+/// max_partition_weight if it can. No move makes a partition heavier than
+/// max_partition_weight.
+void
+Refine(
+    const Level& level, Partition num_partitions,
+    uint64_t max_partition_weight, uint32_t passes,
+    std::vector<Partition>* part) {
+  Node num_nodes = level.num_nodes();
+  std::vector<uint64_t> initial_weights =
+      PartitionWeights(level, *part, num_partitions);
+  std::vector<std::atomic<uint64_t>> part_weights(num_partitions);
+  for (Partition p = 0; p < num_partitions; ++p) {
+    part_weights[p] = initial_weights[p];
+  }
+
+  std::vector<Partition> next(num_nodes);
+  katana::PerThreadStorage<Connectivity> scratch;
+  for (uint32_t step = 0; step < 2 * passes; ++step) {
+    bool upward = step % 2 == 0;
+    const std::vector<Partition>& current = *part;
+    katana::GAccumulator<uint64_t> moves;
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes),
+        [&](Node n) {
+          Partition from = current[n];
+          next[n] = from;
+
+          Connectivity& connectivity = *scratch.getLocal();
+          if (connectivity.weights.empty()) {
+            connectivity.weights.resize(num_partitions);
+          }
+          // Edge weights are positive, so a zero weight means the partition
+          // has not been seen yet
+          for (uint64_t e = level.edge_begin(n); e < level.edge_end(n); ++e) {
+            Partition p = current[level.dests[e]];
+            if (connectivity.weights[p] == 0) {
+              connectivity.partitions.emplace_back(p);
+            }
+            connectivity.weights[p] += level.edge_weights[e];
+          }
+
+          uint64_t node_weight = level.node_weights[n];
+          int64_t internal = connectivity.weights[from];
+          bool overweight = part_weights[from] > max_partition_weight;
+          Partition best = from;
+          int64_t best_gain = 0;
+          for (Partition p : connectivity.partitions) {
+            if (p == from || (upward ? p < from : p > from) ||
+                part_weights[p] + node_weight > max_partition_weight) {
+              continue;
+            }
+            int64_t gain = int64_t(connectivity.weights[p]) - internal;
+            bool better =
+                best == from
+                    ? gain > 0 || overweight ||
+                          (gain == 0 && part_weights[p] + node_weight <
+                                            part_weights[from])
+                    : gain > best_gain ||
+                          (gain == best_gain &&
+                           part_weights[p] < part_weights[best]);
+            if (better) {
+              best = p;
+              best_gain = gain;
+            }
+          }
+          for (Partition p : connectivity.partitions) {
+            connectivity.weights[p] = 0;
+          }
+          connectivity.partitions.clear();
+          if (best == from) {
+            return;
+          }
+
+          // Other threads may have filled the partition since it was read
+          uint64_t before = part_weights[best].fetch_add(node_weight);
+          if (before + node_weight > max_partition_weight) {
+            part_weights[best].fetch_sub(node_weight);
+            return;
+          }
+          part_weights[from].fetch_sub(node_weight);
+          next[n] = best;
+          moves += 1;
+        },
+        katana::steal(), katana::no_stats());
+    part->swap(next);
+    if (moves.reduce() == 0 && !upward) {
+      break;
+    }
+  }
+}
+
+katana::Result<std::vector<Partition>>
+MultilevelPartition(
+    const katana::GraphTopology& topology, const katana::InEdgeIndex& in,
+    Partition num_partitions, const GraphPartitionPlan& plan) {
+  std::vector<Level> levels;
+  levels.emplace_back(BaseLevel(topology, in));
+
+  uint64_t total_weight = topology.num_nodes();
+  uint64_t coarsest_nodes =
+      uint64_t{num_partitions} * plan.coarsest_nodes_per_partition();
+  // Bound the weight of coarse nodes, as METIS does, so that the coarsest
+  // graph can still be cut into balanced partitions
+  uint64_t max_node_weight = std::max<uint64_t>(
+      2, 3 * total_weight / std::max<uint64_t>(2 * coarsest_nodes, 1));
+  while (levels.back().num_nodes() > coarsest_nodes) {
+    if (katana::IsCancelled()) {
+      return katana::ErrorCode::Cancelled;
+    }
+    Level coarse = Coarsen(&levels.back(), max_node_weight);
+    if (coarse.num_nodes() >
+        kMinCoarseningRatio * levels.back().num_nodes()) {
+      break;
+    }
+    levels.emplace_back(std::move(coarse));
+  }
+
+  auto max_partition_weight = static_cast<uint64_t>(
+      std::ceil((1.0 + plan.imbalance()) * total_weight / num_partitions));
+  std::vector<Partition> part = GrowPartitions(levels.back(), num_partitions);
+  Refine(
+      levels.back(), num_partitions, max_partition_weight,
+      plan.refinement_passes(), &part);
+  while (levels.size() > 1) {
+    if (katana::IsCancelled()) {
+      return katana::ErrorCode::Cancelled;
+    }
+    levels.pop_back();
+    const Level& fine = levels.back();
+    std::vector<Partition> fine_part(fine.num_nodes());
+    katana::do_all(
+        katana::iterate(Node{0}, fine.num_nodes()),
+        [&](Node n) { fine_part[n] = part[fine.coarse[n]]; },
+        katana::no_stats());
+    part = std::move(fine_part);
+    Refine(
+        fine, num_partitions, max_partition_weight, plan.refinement_passes(),
+        &part);
+  }
+  return part;
+}
+
+/// The number of nodes in each of the num_partitions partitions
+std::vector<uint64_t>
+PartitionSizes(
+    const katana::GraphTopology& topology, const Partition* part,
+    Partition num_partitions) {
+  katana::PerThreadStorage<std::vector<uint64_t>> local_sizes;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        std::vector<uint64_t>& sizes = *local_sizes.getLocal();
+        if (sizes.empty()) {
+          sizes.resize(num_partitions);
+        }
+        sizes[part[n]] += 1;
+      },
+      katana::no_stats());
+
+  std::vector<uint64_t> sizes(num_partitions);
+  for (unsigned i = 0; i < local_sizes.size(); ++i) {
+    const std::vector<uint64_t>& local = *local_sizes.getRemote(i);
+    for (size_t p = 0; p < local.size(); ++p) {
+      sizes[p] += local[p];
+    }
+  }
+  return sizes;
+}
+
+template <typename T>
+std::shared_ptr<arrow::ChunkedArray>
+BuildChunkedArray(std::vector<T>& values) {
+  return std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{katana::BuildArray(values)});
+}
+
+/// The first and one past the last id of each range of sizes, laid end to
+/// end
+std::vector<uint64_t>
+Ranges(const std::vector<uint64_t>& sizes) {
+  std::vector<uint64_t> ranges;
+  uint64_t begin = 0;
+  for (uint64_t size : sizes) {
+    ranges.emplace_back(begin);
+    ranges.emplace_back(begin + size);
+    begin += size;
+  }
+  return ranges;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::GraphPartition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, GraphPartitionPlan plan) {
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the number of partitions must be positive");
+  }
+  if (!(plan.imbalance() >= 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the imbalance must not be negative");
+  }
+  if (plan.coarsest_nodes_per_partition() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the coarsest graph must have some nodes per partition");
+  }
+
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+
+  auto part_result = MultilevelPartition(
+      pg->topology(), *in_edges_result.value(), num_partitions, plan);
+  if (!part_result) {
+    return part_result.error();
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::uint32())}),
+      {katana::BuildArray(part_result.value())});
+  return pg->AddNodeProperties(table);
+}
+
+katana::Result<void>
+katana::analytics::GraphPartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name) {
+  auto part_result =
+      pg->GetNodePropertyTyped<Partition>(output_property_name);
+  if (!part_result) {
+    return part_result.error();
+  }
+  const Partition* part = part_result.value()->raw_values();
+
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(pg->topology()),
+      [&](Node n) {
+        if (part[n] >= num_partitions) {
+          out_of_range.update(true);
+        }
+      },
+      katana::no_stats());
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "a node is not in one of the {} partitions", num_partitions);
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::GraphPartitionStatistics::Print(std::ostream& os) const {
+  os << "Number of partitions = " << n_partitions << std::endl;
+  os << "Edge cut = " << edge_cut << std::endl;
+  os << "Largest partition size = " << max_partition_size << std::endl;
+  os << "Smallest partition size = " << min_partition_size << std::endl;
+  os << "Imbalance = " << imbalance << std::endl;
+}
+
+katana::Result<GraphPartitionStatistics>
+katana::analytics::GraphPartitionStatistics::Compute(
+    PropertyGraph* pg, const std::string& output_property_name) {
+  auto part_result =
+      pg->GetNodePropertyTyped<Partition>(output_property_name);
+  if (!part_result) {
+    return part_result.error();
+  }
+  const Partition* part = part_result.value()->raw_values();
+  const katana::GraphTopology& topology = pg->topology();
+
+  katana::GReduceMax<Partition> max_part;
+  katana::GAccumulator<uint64_t> edge_cut;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        max_part.update(part[n]);
+        for (Edge e : topology.edges(n)) {
+          if (part[topology.edge_dest(e)] != part[n]) {
+            edge_cut += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (topology.num_nodes() == 0) {
+    return GraphPartitionStatistics{0, 0, 0, 0, 0};
+  }
+  uint64_t n_partitions = uint64_t{max_part.reduce()} + 1;
+  std::vector<uint64_t> sizes =
+      PartitionSizes(topology, part, n_partitions);
+  uint64_t max_size = *std::max_element(sizes.begin(), sizes.end());
+  uint64_t min_size = *std::min_element(sizes.begin(), sizes.end());
+  double average = double(topology.num_nodes()) / n_partitions;
+  return GraphPartitionStatistics{
+      n_partitions, edge_cut.reduce(), max_size, min_size,
+      max_size / average - 1};
+}
+
+katana::Result<PartitionLayout>
+katana::analytics::ComputePartitionLayout(
+    PropertyGraph* pg, const std::string& partition_property_name,
+    uint32_t num_hosts, uint32_t host, PartitionLayoutPolicy policy,
+    uint32_t vertex_cut_degree_threshold) {
+  switch (policy) {
+  case PartitionLayoutPolicy::kOutgoingEdgeCut:
+  case PartitionLayoutPolicy::kIncomingEdgeCut:
+  case PartitionLayoutPolicy::kHybridVertexCut:
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown layout policy {}",
+        static_cast<uint32_t>(policy));
+  }
+  if (host >= num_hosts) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "host {} is not one of the {} hosts", host, num_hosts);
+  }
+  if (auto r = GraphPartitionAssertValid(
+          pg, num_hosts, partition_property_name);
+      !r) {
+    return r.error().WithContext("partitions must name hosts");
+  }
+  const Partition* part =
+      pg->GetNodePropertyTyped<Partition>(partition_property_name)
+          .value()
+          ->raw_values();
+  const katana::GraphTopology& topology = pg->topology();
+  Node num_nodes = topology.num_nodes();
+
+  katana::LargeArray<std::atomic<uint32_t>> in_degree;
+  if (policy == PartitionLayoutPolicy::kHybridVertexCut) {
+    in_degree.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node n) { in_degree.constructAt(n, 0); }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node n) {
+          for (Edge e : topology.edges(n)) {
+            in_degree[topology.edge_dest(e)].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+  auto edge_host = [&](Node src, Node dst) -> Partition {
+    switch (policy) {
+    case PartitionLayoutPolicy::kOutgoingEdgeCut:
+      return part[src];
+    case PartitionLayoutPolicy::kIncomingEdgeCut:
+      return part[dst];
+    default:
+      return in_degree[dst] <= vertex_cut_degree_threshold ? part[dst]
+                                                           : part[src];
+    }
+  };
+
+  // Global node ids order the nodes by partition and then by id
+  std::vector<Node> order(num_nodes);
+  katana::do_all(
+      katana::iterate(topology), [&](Node n) { order[n] = n; },
+      katana::no_stats());
+  katana::ParallelSTL::sort(order.begin(), order.end(), [&](Node a, Node b) {
+    return std::make_pair(part[a], a) < std::make_pair(part[b], b);
+  });
+  std::vector<uint64_t> global_id(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{num_nodes}),
+      [&](uint64_t i) { global_id[order[i]] = i; }, katana::no_stats());
+  std::vector<uint64_t> node_ranges =
+      Ranges(PartitionSizes(topology, part, num_hosts));
+  uint64_t first_owned = node_ranges[2 * host];
+  uint64_t num_owned = node_ranges[2 * host + 1] - first_owned;
+
+  // Mark the mirrors of this host and, for each other host, the masters of
+  // this host mirrored there
+  katana::LargeArray<std::atomic<uint8_t>> is_mirror;
+  katana::LargeArray<std::atomic<uint8_t>> mirrored_on;
+  is_mirror.allocateBlocked(num_nodes);
+  mirrored_on.allocateBlocked(num_hosts * num_owned);
+  katana::do_all(
+      katana::iterate(topology), [&](Node n) { is_mirror.constructAt(n, 0); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_hosts * num_owned),
+      [&](uint64_t i) { mirrored_on.constructAt(i, 0); }, katana::no_stats());
+  katana::PerThreadStorage<std::vector<uint64_t>> local_edge_counts;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node src) {
+        std::vector<uint64_t>& edge_counts = *local_edge_counts.getLocal();
+        if (edge_counts.empty()) {
+          edge_counts.resize(num_hosts);
+        }
+        for (Edge e : topology.edges(src)) {
+          Node dst = topology.edge_dest(e);
+          Partition owner = edge_host(src, dst);
+          edge_counts[owner] += 1;
+          for (Node n : {src, dst}) {
+            if (part[n] == owner) {
+              continue;
+            }
+            if (owner == host) {
+              is_mirror[n].store(1, std::memory_order_relaxed);
+            } else if (part[n] == host) {
+              mirrored_on[owner * num_owned + global_id[n] - first_owned]
+                  .store(1, std::memory_order_relaxed);
+            }
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  std::vector<uint64_t> edge_counts(num_hosts);
+  for (unsigned i = 0; i < local_edge_counts.size(); ++i) {
+    const std::vector<uint64_t>& local = *local_edge_counts.getRemote(i);
+    for (size_t h = 0; h < local.size(); ++h) {
+      edge_counts[h] += local[h];
+    }
+  }
+
+  auto mirror = [&](Node n) { return is_mirror[n].load() != 0; };
+  std::vector<Node> mirrors(
+      katana::ParallelSTL::count_if(order.begin(), order.end(), mirror));
+  katana::ParallelSTL::copy_if(
+      order.begin(), order.end(), mirrors.begin(), mirror);
+
+  PartitionLayout layout;
+  std::vector<uint64_t> local_to_user(num_owned + mirrors.size());
+  std::vector<uint64_t> local_to_global(num_owned + mirrors.size());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{local_to_user.size()}),
+      [&](uint64_t i) {
+        Node n = i < num_owned ? order[first_owned + i]
+                               : mirrors[i - num_owned];
+        local_to_user[i] = n;
+        local_to_global[i] = global_id[n];
+      },
+      katana::no_stats());
+  layout.local_to_user_id = BuildChunkedArray(local_to_user);
+  layout.local_to_global_id = BuildChunkedArray(local_to_global);
+
+  std::vector<std::vector<uint32_t>> master_nodes(num_hosts);
+  std::vector<std::vector<uint32_t>> mirror_nodes(num_hosts);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_hosts),
+      [&](uint32_t h) {
+        for (uint64_t i = 0; h != host && i < num_owned; ++i) {
+          if (mirrored_on[h * num_owned + i].load()) {
+            master_nodes[h].emplace_back(i);
+          }
+        }
+      },
+      katana::no_stats());
+  for (uint64_t i = 0; i < mirrors.size(); ++i) {
+    mirror_nodes[part[mirrors[i]]].emplace_back(num_owned + i);
+  }
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    layout.master_nodes.emplace_back(BuildChunkedArray(master_nodes[h]));
+    layout.mirror_nodes.emplace_back(BuildChunkedArray(mirror_nodes[h]));
+  }
+
+  std::vector<uint64_t> edge_ranges = Ranges(edge_counts);
+  layout.host_to_owned_global_node_ids = BuildChunkedArray(node_ranges);
+  layout.host_to_owned_global_edge_ids = BuildChunkedArray(edge_ranges);
+
+  tsuba::PartitionMetadata& metadata = layout.metadata;
+  metadata.policy_id_ = static_cast<uint32_t>(policy);
+  metadata.is_outgoing_edge_cut_ =
+      policy == PartitionLayoutPolicy::kOutgoingEdgeCut;
+  metadata.is_incoming_edge_cut_ =
+      policy == PartitionLayoutPolicy::kIncomingEdgeCut;
+  metadata.num_global_nodes_ = num_nodes;
+  metadata.max_global_node_id_ = num_nodes > 0 ? num_nodes - 1 : 0;
+  metadata.num_global_edges_ = topology.num_edges();
+  metadata.num_edges_ = edge_counts[host];
+  metadata.num_nodes_ = local_to_user.size();
+  metadata.num_owned_ = num_owned;
+  return layout;
+}
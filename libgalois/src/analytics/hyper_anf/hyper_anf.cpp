@@ -0,0 +1,367 @@
+#include "katana/analytics/hyper_anf/hyper_anf.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Cancellation.h"
+#include "katana/EdgeBalancedRange.h"
+#include "katana/LargeArray.h"
+#include "katana/Reduction.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KATANA_HAS_X86_HYPER_ANF 1
+#include <immintrin.h>
+#endif
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+// Register kernels: set the registers of dst to the register-wise maximum of
+// dst and src and return whether any register of dst grew
+
+bool
+MaxRegistersScalar(uint8_t* dst, const uint8_t* src, uint32_t num_registers) {
+  uint8_t grew = 0;
+  for (uint32_t i = 0; i < num_registers; ++i) {
+    grew |= src[i] > dst[i];
+    dst[i] = std::max(dst[i], src[i]);
+  }
+  return grew != 0;
+}
+
+#ifdef KATANA_HAS_X86_HYPER_ANF
+
+// SSE2 is part of x86-64, so this kernel needs no dispatch
+inline bool
+MaxRegistersSSE2(uint8_t* dst, const uint8_t* src, uint32_t num_registers) {
+  int same = 0xFFFF;
+  for (uint32_t i = 0; i < num_registers; i += 16) {
+    auto* d = reinterpret_cast<__m128i*>(dst + i);
+    __m128i vd = _mm_loadu_si128(d);
+    __m128i max = _mm_max_epu8(
+        vd, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm_storeu_si128(d, max);
+    same &= _mm_movemask_epi8(_mm_cmpeq_epi8(max, vd));
+  }
+  return same != 0xFFFF;
+}
+
+__attribute__((target("avx2"))) inline bool
+MaxRegistersAVX2(uint8_t* dst, const uint8_t* src, uint32_t num_registers) {
+  uint32_t same = 0xFFFFFFFF;
+  for (uint32_t i = 0; i < num_registers; i += 32) {
+    auto* d = reinterpret_cast<__m256i*>(dst + i);
+    __m256i vd = _mm256_loadu_si256(d);
+    __m256i max = _mm256_max_epu8(
+        vd, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+    _mm256_storeu_si256(d, max);
+    same &= _mm256_movemask_epi8(_mm256_cmpeq_epi8(max, vd));
+  }
+  return same != 0xFFFFFFFF;
+}
+
+#endif
+
+using MaxRegistersFn = bool (*)(uint8_t*, const uint8_t*, uint32_t);
+
+/// Write to next the union of the counter of n and the counters of the
+/// destinations of its edges that changed in the last iteration; the others
+/// are already in the counter of n. Each instruction set instantiates this
+/// in a function compiled for it, so that the register kernel is inlined
+/// into the edge loop.
+template <MaxRegistersFn Max>
+__attribute__((always_inline)) inline bool
+GatherCounter(
+    const katana::GraphTopology& topology, const uint8_t* counters,
+    const uint8_t* changed, uint8_t* next, uint32_t num_registers, Node n) {
+  uint8_t* dst = next + uint64_t{n} * num_registers;
+  std::memcpy(dst, counters + uint64_t{n} * num_registers, num_registers);
+  bool grew = false;
+  for (auto e : topology.edges(n)) {
+    Node neighbor = topology.edge_dest(e);
+    if (changed[neighbor]) {
+      grew |= Max(
+          dst, counters + uint64_t{neighbor} * num_registers, num_registers);
+    }
+  }
+  return grew;
+}
+
+using GatherFn = bool (*)(
+    const katana::GraphTopology&, const uint8_t*, const uint8_t*, uint8_t*,
+    uint32_t, Node);
+
+bool
+GatherScalar(
+    const katana::GraphTopology& topology, const uint8_t* counters,
+    const uint8_t* changed, uint8_t* next, uint32_t num_registers, Node n) {
+  return GatherCounter<MaxRegistersScalar>(
+      topology, counters, changed, next, num_registers, n);
+}
+
+#ifdef KATANA_HAS_X86_HYPER_ANF
+
+bool
+GatherSSE2(
+    const katana::GraphTopology& topology, const uint8_t* counters,
+    const uint8_t* changed, uint8_t* next, uint32_t num_registers, Node n) {
+  return GatherCounter<MaxRegistersSSE2>(
+      topology, counters, changed, next, num_registers, n);
+}
+
+__attribute__((target("avx2"))) bool
+GatherAVX2(
+    const katana::GraphTopology& topology, const uint8_t* counters,
+    const uint8_t* changed, uint8_t* next, uint32_t num_registers, Node n) {
+  return GatherCounter<MaxRegistersAVX2>(
+      topology, counters, changed, next, num_registers, n);
+}
+
+#endif
+
+GatherFn
+BestGather(uint32_t num_registers) {
+#ifdef KATANA_HAS_X86_HYPER_ANF
+  if (num_registers % 32 == 0 && __builtin_cpu_supports("avx2")) {
+    return GatherAVX2;
+  }
+  if (num_registers % 16 == 0) {
+    return GatherSSE2;
+  }
+#endif
+  return GatherScalar;
+}
+
+/// A hash of node ids into 64 bits (the finalizer of SplitMix64)
+uint64_t
+HashNode(Node n) {
+  uint64_t z = n + 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31U);
+}
+
+/// The synchronous HyperANF iteration over one counter per node, with the
+/// counters of an iteration double buffered so that every node reads those
+/// of the last one
+class HyperAnfAlgo {
+  const katana::GraphTopology& topology_;
+  uint32_t log2_registers_;
+  uint32_t num_registers_;
+  GatherFn gather_;
+  double alpha_;
+  /// 2^-r for every register value r
+  std::array<double, 64> inverse_powers_;
+
+  katana::LargeArray<uint8_t> counters_;
+  katana::LargeArray<uint8_t> next_counters_;
+  katana::LargeArray<uint8_t> changed_;
+  katana::LargeArray<uint8_t> next_changed_;
+  /// The estimated size of the counter of each node
+  katana::LargeArray<float> sizes_;
+
+public:
+  katana::LargeArray<float> harmonic;
+
+  HyperAnfAlgo(const katana::GraphTopology& topology, uint32_t log2_registers)
+      : topology_(topology),
+        log2_registers_(log2_registers),
+        num_registers_(1U << log2_registers),
+        gather_(BestGather(num_registers_)) {
+    switch (num_registers_) {
+    case 16:
+      alpha_ = 0.673;
+      break;
+    case 32:
+      alpha_ = 0.697;
+      break;
+    case 64:
+      alpha_ = 0.709;
+      break;
+    default:
+      alpha_ = 0.7213 / (1.0 + 1.079 / num_registers_);
+    }
+    for (size_t r = 0; r < inverse_powers_.size(); ++r) {
+      inverse_powers_[r] = std::ldexp(1.0, -static_cast<int>(r));
+    }
+
+    uint64_t num_nodes = topology.num_nodes();
+    counters_.allocateBlocked(num_nodes * num_registers_);
+    next_counters_.allocateBlocked(num_nodes * num_registers_);
+    changed_.allocateBlocked(num_nodes);
+    next_changed_.allocateBlocked(num_nodes);
+    sizes_.allocateBlocked(num_nodes);
+    harmonic.allocateBlocked(num_nodes);
+  }
+
+  /// The HyperLogLog estimate of the size of a counter, with the linear
+  /// counting correction for small sets
+  double Estimate(const uint8_t* registers) const {
+    double sum = 0;
+    uint32_t zeros = 0;
+    for (uint32_t i = 0; i < num_registers_; ++i) {
+      sum += inverse_powers_[registers[i]];
+      zeros += registers[i] == 0;
+    }
+    double m = num_registers_;
+    double estimate = alpha_ * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+      estimate = m * std::log(m / zeros);
+    }
+    return estimate;
+  }
+
+  /// A counter of n alone
+  void Init(Node n) {
+    uint8_t* registers = &counters_[uint64_t{n} * num_registers_];
+    std::memset(registers, 0, num_registers_);
+    uint64_t hash = HashNode(n);
+    uint64_t rest = hash << log2_registers_;
+    uint32_t rank =
+        rest == 0 ? 64 - log2_registers_ + 1 : __builtin_clzll(rest) + 1;
+    registers[hash >> (64 - log2_registers_)] = rank;
+
+    changed_[n] = 1;
+    sizes_[n] = Estimate(registers);
+    harmonic[n] = 0;
+  }
+
+  katana::Result<HyperAnfStatistics> Run(uint32_t max_iterations) {
+    HyperAnfStatistics stats{};
+    katana::GAccumulator<double> total;
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          Init(n);
+          total += sizes_[n];
+        },
+        katana::no_stats(), katana::loopname("HyperAnfInit"));
+    stats.neighborhood_function.emplace_back(total.reduce());
+
+    for (uint32_t t = 1; t <= max_iterations; ++t) {
+      if (katana::IsCancelled()) {
+        return katana::ErrorCode::Cancelled;
+      }
+
+      total.reset();
+      katana::GAccumulator<uint64_t> num_changed;
+      katana::do_all(
+          katana::iterate_edge_balanced(topology_),
+          [&](Node n) {
+            bool grew = gather_(
+                topology_, counters_.data(), changed_.data(),
+                next_counters_.data(), num_registers_, n);
+            next_changed_[n] = grew;
+            if (grew) {
+              num_changed += 1;
+              // Estimates are not quite monotone in the registers
+              float size = std::max<float>(
+                  Estimate(&next_counters_[uint64_t{n} * num_registers_]),
+                  sizes_[n]);
+              harmonic[n] += (size - sizes_[n]) / t;
+              sizes_[n] = size;
+            }
+            total += sizes_[n];
+          },
+          katana::steal(), katana::no_stats(), katana::loopname("HyperAnf"));
+      if (num_changed.reduce() == 0) {
+        break;
+      }
+
+      std::swap(counters_, next_counters_);
+      std::swap(changed_, next_changed_);
+      stats.neighborhood_function.emplace_back(total.reduce());
+      stats.num_iterations = t;
+    }
+    return stats;
+  }
+};
+
+/// Fill in the statistics that follow from the neighborhood function
+void
+SummarizeNeighborhoodFunction(HyperAnfStatistics* stats) {
+  const std::vector<double>& nf = stats->neighborhood_function;
+  double reachable = nf.back();
+  double threshold = 0.9 * reachable;
+
+  stats->effective_diameter = 0;
+  for (size_t t = 1; t < nf.size(); ++t) {
+    if (nf[t - 1] < threshold && nf[t] >= threshold) {
+      stats->effective_diameter =
+          (t - 1) + (threshold - nf[t - 1]) / (nf[t] - nf[t - 1]);
+      break;
+    }
+  }
+
+  double distances = 0;
+  for (size_t t = 1; t < nf.size(); ++t) {
+    distances += t * (nf[t] - nf[t - 1]);
+  }
+  double pairs = reachable - nf.front();
+  stats->average_distance = pairs > 0 ? distances / pairs : 0;
+}
+
+}  // namespace
+
+katana::Result<HyperAnfStatistics>
+katana::analytics::HyperAnf(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    HyperAnfPlan plan) {
+  if (auto column = pg->GetNodeProperty(output_property_name); column) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AlreadyExists, "node property {} already exists",
+        output_property_name);
+  }
+  if (plan.log2_registers() < HyperAnfPlan::kMinLog2Registers ||
+      plan.log2_registers() > HyperAnfPlan::kMaxLog2Registers) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "log2_registers must be between {} and {}, not {}",
+        HyperAnfPlan::kMinLog2Registers, HyperAnfPlan::kMaxLog2Registers,
+        plan.log2_registers());
+  }
+
+  switch (plan.algorithm()) {
+  case HyperAnfPlan::kSynchronous: {
+    HyperAnfAlgo algo(pg->topology(), plan.log2_registers());
+    auto stats_result = algo.Run(plan.max_iterations());
+    if (!stats_result) {
+      return stats_result.error();
+    }
+    HyperAnfStatistics stats = std::move(stats_result.value());
+    SummarizeNeighborhoodFunction(&stats);
+
+    std::vector<float> harmonic(algo.harmonic.begin(), algo.harmonic.end());
+    auto table = arrow::Table::Make(
+        arrow::schema({arrow::field(output_property_name, arrow::float32())}),
+        {katana::BuildArray(harmonic)});
+    if (auto r = pg->AddNodeProperties(table); !r) {
+      return r.error();
+    }
+    return stats;
+  }
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        plan.algorithm());
+  }
+}
+
+void
+katana::analytics::HyperAnfStatistics::Print(std::ostream& os) const {
+  os << "Iterations = " << num_iterations << std::endl;
+  os << "Effective diameter = " << effective_diameter << std::endl;
+  os << "Average distance = " << average_distance << std::endl;
+  for (size_t t = 0; t < neighborhood_function.size(); ++t) {
+    os << "Pairs within distance " << t << " = " << neighborhood_function[t]
+       << std::endl;
+  }
+}
@@ -0,0 +1,829 @@
+#include "katana/analytics/hypergraph_partition/hypergraph_partition.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Cancellation.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Partition = uint32_t;
+using MatchingPolicy = HyperGraphPartitionPlan::MatchingPolicy;
+
+constexpr Node kNone = std::numeric_limits<Node>::max();
+/// Stop coarsening when a level keeps more than this fraction of the nodes
+/// of the level before it
+constexpr double kMinCoarseningRatio = 0.95;
+
+/// One level of the multilevel hierarchy: a hypergraph with weighted nodes,
+/// holding the pins of every hyperedge and the hyperedges of every node in
+/// CSR form
+struct Level {
+  std::vector<uint64_t> pin_offsets{0};
+  std::vector<Node> pins;
+  std::vector<uint64_t> incidence_offsets;
+  std::vector<Node> incidence;
+  std::vector<uint64_t> node_weights;
+  /// The node of the next coarser level each node is merged into
+  std::vector<Node> coarse;
+
+  Node num_nodes() const { return node_weights.size(); }
+  Node num_hyperedges() const { return pin_offsets.size() - 1; }
+  uint64_t pin_begin(Node h) const { return pin_offsets[h]; }
+  uint64_t pin_end(Node h) const { return pin_offsets[h + 1]; }
+  uint64_t incidence_begin(Node n) const { return incidence_offsets[n]; }
+  uint64_t incidence_end(Node n) const { return incidence_offsets[n + 1]; }
+};
+
+/// Fill in the pins of level from those of num_candidates hyperedges, where
+/// gather(h, &pins) appends the pins of candidate h, possibly more than once
+/// each. Candidates with fewer than two distinct pins can never be cut and
+/// are dropped; the others keep their order. As in BuildEdges of graph
+/// partitioning, the pins are gathered once to count them and once to place
+/// them.
+template <typename Gather>
+void
+BuildPins(Level* level, Node num_candidates, const Gather& gather) {
+  katana::PerThreadStorage<std::vector<Node>> scratch;
+  auto pins_of = [&](Node h) -> const std::vector<Node>& {
+    std::vector<Node>& pins = *scratch.getLocal();
+    pins.clear();
+    gather(h, &pins);
+    std::sort(pins.begin(), pins.end());
+    pins.erase(std::unique(pins.begin(), pins.end()), pins.end());
+    if (pins.size() < 2) {
+      pins.clear();
+    }
+    return pins;
+  };
+
+  std::vector<uint64_t> ends(num_candidates + 1);
+  std::vector<Node> ranks(num_candidates + 1);
+  katana::do_all(
+      katana::iterate(Node{0}, num_candidates),
+      [&](Node h) {
+        ends[h + 1] = pins_of(h).size();
+        ranks[h + 1] = ends[h + 1] > 0;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(ends.begin(), ends.end(), ends.begin());
+  katana::ParallelSTL::partial_sum(ranks.begin(), ranks.end(), ranks.begin());
+
+  level->pin_offsets.assign(ranks.back() + 1, 0);
+  level->pins.resize(ends.back());
+  katana::do_all(
+      katana::iterate(Node{0}, num_candidates),
+      [&](Node h) {
+        if (ends[h + 1] == ends[h]) {
+          return;
+        }
+        const std::vector<Node>& pins = pins_of(h);
+        std::copy(pins.begin(), pins.end(), level->pins.begin() + ends[h]);
+        level->pin_offsets[ranks[h + 1]] = ends[h + 1];
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// Fill in the hyperedges of every node of level from its pins, in order of
+/// hyperedge id
+void
+BuildIncidence(Level* level) {
+  Node num_nodes = level->num_nodes();
+  Node num_hyperedges = level->num_hyperedges();
+  std::vector<std::atomic<uint64_t>> cursors(num_nodes);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) { cursors[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(Node{0}, num_hyperedges),
+      [&](Node h) {
+        for (uint64_t e = level->pin_begin(h); e < level->pin_end(h); ++e) {
+          cursors[level->pins[e]].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  level->incidence_offsets.assign(num_nodes + 1, 0);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        level->incidence_offsets[n + 1] = cursors[n].load();
+        cursors[n].store(0, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      level->incidence_offsets.begin(), level->incidence_offsets.end(),
+      level->incidence_offsets.begin());
+
+  level->incidence.resize(level->incidence_offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(Node{0}, num_hyperedges),
+      [&](Node h) {
+        for (uint64_t e = level->pin_begin(h); e < level->pin_end(h); ++e) {
+          Node n = level->pins[e];
+          uint64_t i = cursors[n].fetch_add(1, std::memory_order_relaxed);
+          level->incidence[level->incidence_offsets[n] + i] = h;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        std::sort(
+            level->incidence.begin() + level->incidence_begin(n),
+            level->incidence.begin() + level->incidence_end(n));
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// The hypergraph of view, where every node weighs one
+Level
+BaseLevel(const katana::HyperGraphView& view) {
+  Level level;
+  level.node_weights.assign(view.num_nodes(), 1);
+  BuildPins(
+      &level, view.num_hyperedges(), [&](Node h, std::vector<Node>* pins) {
+        for (auto e : view.pins(h)) {
+          pins->emplace_back(view.pin_node(e));
+        }
+      });
+  BuildIncidence(&level);
+  return level;
+}
+
+uint64_t
+TotalWeight(const Level& level) {
+  katana::GAccumulator<uint64_t> total;
+  katana::do_all(
+      katana::iterate(Node{0}, level.num_nodes()),
+      [&](Node n) { total += level.node_weights[n]; }, katana::no_stats());
+  return total.reduce();
+}
+
+/// A pseudo-random key of hyperedge h; the finalizer of SplitMix64
+uint64_t
+Scramble(Node h) {
+  uint64_t x = h;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// The key of hyperedge h under policy; nodes pick their hyperedge of least
+/// key, ties broken by id
+uint64_t
+MatchingKey(const Level& level, Node h, MatchingPolicy policy) {
+  uint64_t size = level.pin_end(h) - level.pin_begin(h);
+  auto weight = [&]() {
+    uint64_t total = 0;
+    for (uint64_t e = level.pin_begin(h); e < level.pin_end(h); ++e) {
+      total += level.node_weights[level.pins[e]];
+    }
+    return total;
+  };
+  switch (policy) {
+  case HyperGraphPartitionPlan::kHigherDegree:
+    return ~size;
+  case HyperGraphPartitionPlan::kLowerDegree:
+    return size;
+  case HyperGraphPartitionPlan::kHigherWeight:
+    return ~weight();
+  case HyperGraphPartitionPlan::kLowerWeight:
+    return weight();
+  case HyperGraphPartitionPlan::kRandom:
+    return Scramble(h);
+  }
+  return 0;
+}
+
+/// Merge the nodes of fine, recording in fine->coarse the node of the
+/// coarser level each is merged into, and return that level. Every node
+/// lighter than max_node_weight picks one of its hyperedges by
+/// MatchingKey, and the nodes that picked the same hyperedge merge, in the
+/// order of its pins, into groups no heavier than max_node_weight. A node
+/// picks from its own hyperedges alone and each group is formed by the one
+/// hyperedge its nodes picked, so the result does not depend on the
+/// schedule. Hyperedges left inside one coarse node are dropped.
+Level
+Coarsen(Level* fine, MatchingPolicy policy, uint64_t max_node_weight) {
+  Node num_nodes = fine->num_nodes();
+  Node num_hyperedges = fine->num_hyperedges();
+  std::vector<uint64_t> keys(num_hyperedges);
+  katana::do_all(
+      katana::iterate(Node{0}, num_hyperedges),
+      [&](Node h) { keys[h] = MatchingKey(*fine, h, policy); },
+      katana::steal(), katana::no_stats());
+
+  std::vector<Node> choice(num_nodes, kNone);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        if (fine->node_weights[n] >= max_node_weight) {
+          return;
+        }
+        for (uint64_t i = fine->incidence_begin(n); i < fine->incidence_end(n);
+             ++i) {
+          Node h = fine->incidence[i];
+          // Incident hyperedges come in order of id, so the first of least
+          // key wins ties
+          if (choice[n] == kNone || keys[h] < keys[choice[n]]) {
+            choice[n] = h;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // Each group is led by its first node, which holds the weight of the group
+  std::vector<Node> leader(num_nodes);
+  std::vector<uint64_t> group_weights(num_nodes);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        leader[n] = n;
+        group_weights[n] = fine->node_weights[n];
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(Node{0}, num_hyperedges),
+      [&](Node h) {
+        Node current = kNone;
+        for (uint64_t e = fine->pin_begin(h); e < fine->pin_end(h); ++e) {
+          Node n = fine->pins[e];
+          if (choice[n] != h) {
+            continue;
+          }
+          if (current == kNone ||
+              group_weights[current] + fine->node_weights[n] >
+                  max_node_weight) {
+            current = n;
+            continue;
+          }
+          leader[n] = current;
+          group_weights[current] += fine->node_weights[n];
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<Node> rank(num_nodes);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) { rank[n] = leader[n] == n; }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+  Node num_coarse = num_nodes > 0 ? rank.back() : 0;
+
+  Level coarse;
+  coarse.node_weights.resize(num_coarse);
+  fine->coarse.resize(num_nodes);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        fine->coarse[n] = rank[leader[n]] - 1;
+        if (leader[n] == n) {
+          coarse.node_weights[rank[n] - 1] = group_weights[n];
+        }
+      },
+      katana::no_stats());
+  BuildPins(&coarse, num_hyperedges, [&](Node h, std::vector<Node>* pins) {
+    for (uint64_t e = fine->pin_begin(h); e < fine->pin_end(h); ++e) {
+      pins->emplace_back(fine->coarse[fine->pins[e]]);
+    }
+  });
+  BuildIncidence(&coarse);
+  return coarse;
+}
+
+/// The number of pins of each hyperedge on each side of a bisection
+using SideCounts = std::vector<std::array<uint32_t, 2>>;
+
+SideCounts
+CountSides(const Level& level, const std::vector<Partition>& side) {
+  SideCounts counts(level.num_hyperedges());
+  katana::do_all(
+      katana::iterate(Node{0}, level.num_hyperedges()),
+      [&](Node h) {
+        counts[h] = {0, 0};
+        for (uint64_t e = level.pin_begin(h); e < level.pin_end(h); ++e) {
+          counts[h][side[level.pins[e]]] += 1;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return counts;
+}
+
+/// The decrease of the number of cut hyperedges if node n alone moved to the
+/// other side
+int64_t
+Gain(
+    const Level& level, const SideCounts& counts,
+    const std::vector<Partition>& side, Node n) {
+  Partition from = side[n];
+  int64_t gain = 0;
+  for (uint64_t i = level.incidence_begin(n); i < level.incidence_end(n);
+       ++i) {
+    const auto& count = counts[level.incidence[i]];
+    if (count[from] == 1) {
+      gain += 1;
+    } else if (count[1 - from] == 0) {
+      gain -= 1;
+    }
+  }
+  return gain;
+}
+
+/// A node that may move to the other side. Moves are ordered by decreasing
+/// gain and then by node, so that their order does not depend on the
+/// schedule.
+struct Move {
+  int64_t gain;
+  Node node;
+
+  bool operator<(const Move& other) const {
+    return gain != other.gain ? gain > other.gain : node < other.node;
+  }
+};
+
+/// The moves of the nodes on side from whose gain passes accept, best first
+template <typename Accept>
+std::vector<Move>
+Candidates(
+    const Level& level, const SideCounts& counts,
+    const std::vector<Partition>& side, Partition from, const Accept& accept) {
+  katana::PerThreadStorage<std::vector<Move>> local_moves;
+  katana::do_all(
+      katana::iterate(Node{0}, level.num_nodes()),
+      [&](Node n) {
+        if (side[n] != from) {
+          return;
+        }
+        int64_t gain = Gain(level, counts, side, n);
+        if (accept(gain)) {
+          local_moves.getLocal()->emplace_back(Move{gain, n});
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<Move> moves;
+  for (unsigned i = 0; i < local_moves.size(); ++i) {
+    const std::vector<Move>& local = *local_moves.getRemote(i);
+    moves.insert(moves.end(), local.begin(), local.end());
+  }
+  katana::ParallelSTL::sort(moves.begin(), moves.end());
+  return moves;
+}
+
+std::array<uint64_t, 2>
+SideWeights(const Level& level, const std::vector<Partition>& side) {
+  katana::GAccumulator<uint64_t> weight0;
+  katana::GAccumulator<uint64_t> weight1;
+  katana::do_all(
+      katana::iterate(Node{0}, level.num_nodes()),
+      [&](Node n) {
+        if (side[n] == 0) {
+          weight0 += level.node_weights[n];
+        } else {
+          weight1 += level.node_weights[n];
+        }
+      },
+      katana::no_stats());
+  return {weight0.reduce(), weight1.reduce()};
+}
+
+/// Bisect the coarsest level. All nodes start on side 1, and in each round
+/// the sqrt(n) nodes of highest gain there move to side 0, as in BiPart,
+/// until side 0 holds target_weight.
+std::vector<Partition>
+InitialBisection(
+    const Level& level, const std::array<uint64_t, 2>& max_weights,
+    uint64_t target_weight) {
+  std::vector<Partition> side(level.num_nodes(), 1);
+  auto batch =
+      std::max<size_t>(1, static_cast<size_t>(std::sqrt(level.num_nodes())));
+  uint64_t weight = 0;
+  while (weight < target_weight) {
+    SideCounts counts = CountSides(level, side);
+    std::vector<Move> moves =
+        Candidates(level, counts, side, 1, [](int64_t) { return true; });
+    size_t moved = 0;
+    for (const Move& move : moves) {
+      if (moved == batch || weight >= target_weight) {
+        break;
+      }
+      uint64_t node_weight = level.node_weights[move.node];
+      if (weight + node_weight > max_weights[0]) {
+        continue;
+      }
+      side[move.node] = 0;
+      weight += node_weight;
+      ++moved;
+    }
+    if (moved == 0) {
+      break;
+    }
+  }
+  return side;
+}
+
+/// Move the nodes of highest gain out of a side heavier than its max weight,
+/// as long as the other side stays within its own
+void
+Rebalance(
+    const Level& level, const std::array<uint64_t, 2>& max_weights,
+    std::vector<Partition>* side) {
+  std::array<uint64_t, 2> weights = SideWeights(level, *side);
+  for (Partition heavy : {0, 1}) {
+    Partition light = 1 - heavy;
+    if (weights[heavy] <= max_weights[heavy]) {
+      continue;
+    }
+    SideCounts counts = CountSides(level, *side);
+    std::vector<Move> moves =
+        Candidates(level, counts, *side, heavy, [](int64_t) { return true; });
+    for (const Move& move : moves) {
+      if (weights[heavy] <= max_weights[heavy]) {
+        break;
+      }
+      uint64_t node_weight = level.node_weights[move.node];
+      if (weights[light] + node_weight > max_weights[light]) {
+        continue;
+      }
+      (*side)[move.node] = light;
+      weights[heavy] -= node_weight;
+      weights[light] += node_weight;
+    }
+  }
+}
+
+/// Improve the bisection of level as BiPart does: in each pass the nodes of
+/// positive gain on either side are ranked, and the best of one side swap
+/// with the best of the other, one for one, so that the sides keep their
+/// sizes. Every pass reads the gains of the pass before.
+void
+Refine(
+    const Level& level, const std::array<uint64_t, 2>& max_weights,
+    uint32_t passes, std::vector<Partition>* side) {
+  auto positive = [](int64_t gain) { return gain > 0; };
+  for (uint32_t pass = 0; pass < passes; ++pass) {
+    SideCounts counts = CountSides(level, *side);
+    std::vector<Move> from0 = Candidates(level, counts, *side, 0, positive);
+    std::vector<Move> from1 = Candidates(level, counts, *side, 1, positive);
+    size_t num_swaps = std::min(from0.size(), from1.size());
+    if (num_swaps == 0) {
+      break;
+    }
+    katana::do_all(
+        katana::iterate(size_t{0}, num_swaps),
+        [&](size_t i) {
+          (*side)[from0[i].node] = 1;
+          (*side)[from1[i].node] = 0;
+        },
+        katana::no_stats());
+  }
+  Rebalance(level, max_weights, side);
+}
+
+/// Bisect base so that side 0 holds about fraction of its weight
+katana::Result<std::vector<Partition>>
+Bisect(Level* base, double fraction, const HyperGraphPartitionPlan& plan) {
+  uint64_t total_weight = TotalWeight(*base);
+  double slack = 1.0 + plan.imbalance();
+  std::array<uint64_t, 2> max_weights{
+      static_cast<uint64_t>(std::ceil(slack * total_weight * fraction)),
+      static_cast<uint64_t>(std::ceil(slack * total_weight * (1 - fraction)))};
+  auto target_weight =
+      static_cast<uint64_t>(std::llround(total_weight * fraction));
+  // Bound the weight of coarse nodes, as graph partitioning does, so that
+  // the coarsest hypergraph can still be bisected evenly
+  uint64_t max_node_weight = std::max<uint64_t>(
+      2, 3 * total_weight / (2 * uint64_t{plan.max_coarse_graph_size()}));
+
+  // Coarser levels; level i of the hierarchy is base for i = 0 and
+  // coarser[i - 1] otherwise
+  std::vector<Level> coarser;
+  auto level_at = [&](size_t i) -> Level* {
+    return i == 0 ? base : &coarser[i - 1];
+  };
+  while (level_at(coarser.size())->num_nodes() >
+         plan.max_coarse_graph_size()) {
+    if (katana::IsCancelled()) {
+      return katana::ErrorCode::Cancelled;
+    }
+    Level* fine = level_at(coarser.size());
+    Level coarse = Coarsen(fine, plan.matching_policy(), max_node_weight);
+    if (coarse.num_nodes() > kMinCoarseningRatio * fine->num_nodes()) {
+      break;
+    }
+    coarser.emplace_back(std::move(coarse));
+  }
+
+  const Level& coarsest = *level_at(coarser.size());
+  std::vector<Partition> side =
+      InitialBisection(coarsest, max_weights, target_weight);
+  Refine(coarsest, max_weights, plan.refinement_passes(), &side);
+  for (size_t i = coarser.size(); i > 0; --i) {
+    if (katana::IsCancelled()) {
+      return katana::ErrorCode::Cancelled;
+    }
+    const Level& fine = *level_at(i - 1);
+    std::vector<Partition> fine_side(fine.num_nodes());
+    katana::do_all(
+        katana::iterate(Node{0}, fine.num_nodes()),
+        [&](Node n) { fine_side[n] = side[fine.coarse[n]]; },
+        katana::no_stats());
+    side = std::move(fine_side);
+    coarser.pop_back();
+    Refine(fine, max_weights, plan.refinement_passes(), &side);
+  }
+  return side;
+}
+
+/// The nodes of level on side s, with the hyperedges that have all of their
+/// pins there. ids holds the id in the input of every node of level, and
+/// sub_ids receives those of the nodes kept.
+Level
+Induce(
+    const Level& level, const std::vector<Partition>& side, Partition s,
+    const std::vector<Node>& ids, std::vector<Node>* sub_ids) {
+  Node num_nodes = level.num_nodes();
+  std::vector<Node> rank(num_nodes);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) { rank[n] = side[n] == s; }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+  Node num_kept = num_nodes > 0 ? rank.back() : 0;
+
+  Level sub;
+  sub.node_weights.resize(num_kept);
+  sub_ids->resize(num_kept);
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node n) {
+        if (side[n] == s) {
+          sub.node_weights[rank[n] - 1] = level.node_weights[n];
+          (*sub_ids)[rank[n] - 1] = ids[n];
+        }
+      },
+      katana::no_stats());
+  // Hyperedges across the sides are cut already, whatever happens next
+  BuildPins(
+      &sub, level.num_hyperedges(), [&](Node h, std::vector<Node>* pins) {
+        for (uint64_t e = level.pin_begin(h); e < level.pin_end(h); ++e) {
+          if (side[level.pins[e]] != s) {
+            return;
+          }
+        }
+        for (uint64_t e = level.pin_begin(h); e < level.pin_end(h); ++e) {
+          pins->emplace_back(rank[level.pins[e]] - 1);
+        }
+      });
+  BuildIncidence(&sub);
+  return sub;
+}
+
+/// Partition level into num_partitions partitions numbered from first by
+/// recursive bisection, writing the partition of each of its nodes n to
+/// (*part)[ids[n]]
+katana::Result<void>
+PartitionRecursive(
+    Level* level, const std::vector<Node>& ids, Partition first,
+    Partition num_partitions, const HyperGraphPartitionPlan& plan,
+    std::vector<Partition>* part) {
+  if (num_partitions == 1 || level->num_nodes() == 0) {
+    katana::do_all(
+        katana::iterate(Node{0}, level->num_nodes()),
+        [&](Node n) { (*part)[ids[n]] = first; }, katana::no_stats());
+    return katana::ResultSuccess();
+  }
+
+  Partition num_left = num_partitions / 2;
+  auto side_res = Bisect(level, double(num_left) / num_partitions, plan);
+  if (!side_res) {
+    return side_res.error();
+  }
+  for (Partition s : {0, 1}) {
+    std::vector<Node> sub_ids;
+    Level sub = Induce(*level, side_res.value(), s, ids, &sub_ids);
+    auto res = s == 0 ? PartitionRecursive(
+                            &sub, sub_ids, first, num_left, plan, part)
+                      : PartitionRecursive(
+                            &sub, sub_ids, first + num_left,
+                            num_partitions - num_left, plan, part);
+    if (!res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// The partition of the nodes of hyperedge h if they are all in the same
+/// one, where partition_of(n) is the partition of node n of the hypergraph,
+/// and kHyperGraphPartitionCut otherwise, or if h has no nodes
+template <typename PartitionOf>
+Partition
+HyperedgePartition(
+    const katana::HyperGraphView& view, Node h,
+    const PartitionOf& partition_of) {
+  Partition common = kHyperGraphPartitionCut;
+  for (auto e : view.pins(h)) {
+    Partition p = partition_of(view.pin_node(e));
+    if (common == kHyperGraphPartitionCut) {
+      common = p;
+    } else if (p != common) {
+      return kHyperGraphPartitionCut;
+    }
+  }
+  return common;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::HyperGraphPartition(
+    PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions,
+    const std::string& output_property_name, HyperGraphPartitionPlan plan) {
+  if (num_partitions == 0 || num_partitions == kHyperGraphPartitionCut) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the number of partitions must be in [1, {})",
+        kHyperGraphPartitionCut);
+  }
+  if (!(plan.imbalance() >= 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the imbalance must not be negative");
+  }
+  if (plan.max_coarse_graph_size() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the coarsest hypergraph must have some nodes");
+  }
+  auto view_res = katana::HyperGraphView::Make(pg, num_hyperedges);
+  if (!view_res) {
+    return view_res.error();
+  }
+  const katana::HyperGraphView& view = view_res.value();
+
+  Level base = BaseLevel(view);
+  std::vector<Node> ids(base.num_nodes());
+  katana::do_all(
+      katana::iterate(Node{0}, base.num_nodes()), [&](Node n) { ids[n] = n; },
+      katana::no_stats());
+  std::vector<Partition> part(base.num_nodes());
+  if (auto res = PartitionRecursive(&base, ids, 0, num_partitions, plan, &part);
+      !res) {
+    return res.error();
+  }
+
+  std::vector<Partition> output(pg->topology().num_nodes());
+  katana::do_all(
+      katana::iterate(Node{0}, Node(view.num_hyperedges())),
+      [&](Node h) {
+        output[h] =
+            HyperedgePartition(view, h, [&](Node n) { return part[n]; });
+      },
+      katana::steal(), katana::no_stats());
+  katana::do_all(
+      katana::iterate(Node{0}, Node(view.num_nodes())),
+      [&](Node n) { output[view.node_id(n)] = part[n]; }, katana::no_stats());
+
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::uint32())}),
+      {katana::BuildArray(output)});
+  return pg->AddNodeProperties(table);
+}
+
+katana::Result<void>
+katana::analytics::HyperGraphPartitionAssertValid(
+    PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions,
+    const std::string& output_property_name) {
+  auto view_res = katana::HyperGraphView::Make(pg, num_hyperedges);
+  if (!view_res) {
+    return view_res.error();
+  }
+  const katana::HyperGraphView& view = view_res.value();
+  auto part_result =
+      pg->GetNodePropertyTyped<Partition>(output_property_name);
+  if (!part_result) {
+    return part_result.error();
+  }
+  const Partition* part = part_result.value()->raw_values();
+  auto partition_of = [&](Node n) { return part[view.node_id(n)]; };
+
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(Node{0}, Node(view.num_nodes())),
+      [&](Node n) {
+        if (partition_of(n) >= num_partitions) {
+          out_of_range.update(true);
+        }
+      },
+      katana::no_stats());
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "a node is not in one of the {} partitions", num_partitions);
+  }
+
+  katana::GReduceLogicalOr wrong_hyperedge;
+  katana::do_all(
+      katana::iterate(Node{0}, Node(view.num_hyperedges())),
+      [&](Node h) {
+        if (part[h] != HyperedgePartition(view, h, partition_of)) {
+          wrong_hyperedge.update(true);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (wrong_hyperedge.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "a hyperedge is not in the partition of its nodes");
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::HyperGraphPartitionStatistics::Print(
+    std::ostream& os) const {
+  os << "Number of partitions = " << n_partitions << std::endl;
+  os << "Hyperedge cut = " << hyperedge_cut << std::endl;
+  os << "Largest partition size = " << max_partition_size << std::endl;
+  os << "Smallest partition size = " << min_partition_size << std::endl;
+  os << "Imbalance = " << imbalance << std::endl;
+}
+
+katana::Result<HyperGraphPartitionStatistics>
+katana::analytics::HyperGraphPartitionStatistics::Compute(
+    PropertyGraph* pg, uint64_t num_hyperedges,
+    const std::string& output_property_name) {
+  auto view_res = katana::HyperGraphView::Make(pg, num_hyperedges);
+  if (!view_res) {
+    return view_res.error();
+  }
+  const katana::HyperGraphView& view = view_res.value();
+  auto part_result =
+      pg->GetNodePropertyTyped<Partition>(output_property_name);
+  if (!part_result) {
+    return part_result.error();
+  }
+  const Partition* part = part_result.value()->raw_values();
+  auto partition_of = [&](Node n) { return part[view.node_id(n)]; };
+  if (view.num_nodes() == 0) {
+    return HyperGraphPartitionStatistics{0, 0, 0, 0, 0};
+  }
+
+  katana::GReduceMax<Partition> max_part;
+  katana::do_all(
+      katana::iterate(Node{0}, Node(view.num_nodes())),
+      [&](Node n) { max_part.update(partition_of(n)); }, katana::no_stats());
+  uint64_t n_partitions = uint64_t{max_part.reduce()} + 1;
+
+  katana::GAccumulator<uint64_t> hyperedge_cut;
+  katana::do_all(
+      katana::iterate(Node{0}, Node(view.num_hyperedges())),
+      [&](Node h) {
+        if (!view.pins(h).empty() &&
+            HyperedgePartition(view, h, partition_of) ==
+                kHyperGraphPartitionCut) {
+          hyperedge_cut += 1;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::PerThreadStorage<std::vector<uint64_t>> local_sizes;
+  katana::do_all(
+      katana::iterate(Node{0}, Node(view.num_nodes())),
+      [&](Node n) {
+        std::vector<uint64_t>& sizes = *local_sizes.getLocal();
+        if (sizes.empty()) {
+          sizes.resize(n_partitions);
+        }
+        sizes[partition_of(n)] += 1;
+      },
+      katana::no_stats());
+  std::vector<uint64_t> sizes(n_partitions);
+  for (unsigned i = 0; i < local_sizes.size(); ++i) {
+    const std::vector<uint64_t>& local = *local_sizes.getRemote(i);
+    for (size_t p = 0; p < local.size(); ++p) {
+      sizes[p] += local[p];
+    }
+  }
+
+  uint64_t max_size = *std::max_element(sizes.begin(), sizes.end());
+  uint64_t min_size = *std::min_element(sizes.begin(), sizes.end());
+  double average = double(view.num_nodes()) / n_partitions;
+  return HyperGraphPartitionStatistics{
+      n_partitions, hyperedge_cut.reduce(), max_size, min_size,
+      max_size / average - 1};
+}
@@ -25,7 +25,10 @@
 #include <vector>
 
 #include "katana/Bag.h"
+#include "katana/Cancellation.h"
+#include "katana/DynamicBitset.h"
 #include "katana/Galois.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/ParallelSTL.h"
 #include "katana/Properties.h"
 #include "katana/Reduction.h"
@@ -576,6 +579,143 @@ struct EdgeTiledPrioAlgo {
   }
 };
 
+/// Rounds that decide nodes in priority order, keeping the states of the
+/// nodes in bitsets. A round decides every undecided node none of whose
+/// undecided neighbors precedes it, and only the nodes left undecided are
+/// visited in the next one. Nodes are ordered by degree, then by a hash.
+///
+/// A maximal independent set takes the decided nodes and decides their
+/// neighbors to be out of the set (Luby's algorithm with fixed random
+/// priorities); a coloring gives each decided node the least color of none
+/// of its neighbors (Jones and Plassmann, "A Parallel Graph Coloring
+/// Heuristic", SIAM J. Sci. Comput. 1993).
+class PriorityRounds {
+public:
+  using Node = katana::GraphTopology::Node;
+
+  PriorityRounds(const katana::GraphTopology& topology, bool largest_first)
+      : topology_(topology), largest_first_(largest_first) {
+    decided_.resize(topology.num_nodes());
+  }
+
+  uint64_t Key(Node n) const {
+    uint64_t degree = topology_.edges(n).size();
+    if (largest_first_) {
+      degree = ~degree;
+    }
+    return (degree << 32) | hash(n);
+  }
+
+  bool Precedes(Node a, Node b) const {
+    uint64_t a_key = Key(a);
+    uint64_t b_key = Key(b);
+    return a_key < b_key || (a_key == b_key && a < b);
+  }
+
+  bool decided(Node n) const { return decided_.test(n); }
+
+  /// Mark n decided; safe while other nodes are
+  void Decide(Node n) { decided_.set(n); }
+
+  /// Run rounds until every node is decided, calling decide(n) for the nodes
+  /// a round decides and then commit(n) for each of them once they are all
+  /// marked decided. decide may read the state of the neighbors of n that
+  /// precede it, all decided in earlier rounds. Returns the number of rounds.
+  template <typename D, typename C>
+  size_t Run(D decide, C commit) {
+    auto round = [&](const auto& range) {
+      katana::do_all(
+          range,
+          [&](Node n) {
+            if (decided_.test(n)) {
+              return;
+            }
+            for (auto e : topology_.edges(n)) {
+              Node dst = topology_.edge_dest(e);
+              if (dst != n && !decided_.test(dst) && Precedes(dst, n)) {
+                next_.push(n);
+                return;
+              }
+            }
+            decide(n);
+            chosen_.push(n);
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::loopname("IndependentSet-bitset-round"));
+      katana::do_all(
+          katana::iterate(chosen_),
+          [&](Node n) {
+            decided_.set(n);
+            commit(n);
+          },
+          katana::loopname("IndependentSet-bitset-commit"));
+      chosen_.clear();
+      frontier_.swap(next_);
+      next_.clear();
+    };
+
+    size_t rounds = 1;
+    round(katana::iterate(topology_));
+    while (!frontier_.empty()) {
+      round(katana::iterate(frontier_));
+      ++rounds;
+    }
+    return rounds;
+  }
+
+private:
+  const katana::GraphTopology& topology_;
+  bool largest_first_;
+  katana::DynamicBitset decided_;
+  katana::InsertBag<Node> frontier_;
+  katana::InsertBag<Node> next_;
+  katana::InsertBag<Node> chosen_;
+};
+
+struct BitsetPrioAlgo {
+  struct NodeFlag {
+    using ArrowType = arrow::CTypeTraits<uint8_t>::ArrowType;
+    using ViewType = katana::PODPropertyView<MatchFlag>;
+  };
+  using NodeData = std::tuple<NodeFlag>;
+  using EdgeData = std::tuple<>;
+
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+  typedef typename Graph::Node GNode;
+
+  void Initialize(Graph*) {}
+
+  void operator()(Graph* graph) {
+    const katana::GraphTopology& topology =
+        graph->GetPropertyGraph().topology();
+    // Low degree nodes first leaves more nodes for the set
+    PriorityRounds rounds(topology, false);
+    // A decided node is in the set if it is in in, and out otherwise
+    katana::DynamicBitset in;
+    in.resize(topology.num_nodes());
+
+    size_t num_rounds = rounds.Run(
+        [](GNode) {},
+        [&](GNode n) {
+          in.set(n);
+          for (auto e : topology.edges(n)) {
+            rounds.Decide(topology.edge_dest(e));
+          }
+        });
+
+    katana::do_all(
+        katana::iterate(topology),
+        [&](GNode n) {
+          graph->GetData<NodeFlag>(n) =
+              in.test(n) ? MatchFlag::kMatched : MatchFlag::KOtherMatched;
+        },
+        katana::loopname("IndependentSet-bitset-output"));
+
+    katana::ReportStatSingle(
+        "IndependentSet-bitsetPrioAlgo", "rounds", num_rounds);
+  }
+};
+
 struct IsBad {
   struct NodeFlag {
     using ArrowType = arrow::CTypeTraits<uint8_t>::ArrowType;
@@ -648,6 +788,10 @@ Run(katana::PropertyGraph* pg, const std::string& output_property_name) {
   impl(&graph);
   exec_time.stop();
 
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+
   katana::reportPageAlloc("MeminfoPost");
 
   if (std::is_same<Algo, PrioAlgo>::value ||
@@ -691,6 +835,8 @@ katana::analytics::IndependentSet(
     return Run<PrioAlgo>(pg, output_property_name);
   case IndependentSetPlan::kEdgeTiledPriority:
     return Run<EdgeTiledPrioAlgo>(pg, output_property_name);
+  case IndependentSetPlan::kBitsetPriority:
+    return Run<BitsetPrioAlgo>(pg, output_property_name);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
@@ -716,6 +862,108 @@ katana::analytics::IndependentSetAssertValid(
   return katana::ResultSuccess();
 }
 
+namespace {
+
+using NodeColor = katana::PODProperty<uint32_t>;
+using ColorGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeColor>, std::tuple<>>;
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::GraphColoring(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  if (auto result = ConstructNodeProperties<std::tuple<NodeColor>>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+  auto pg_result = ColorGraph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  ColorGraph graph = pg_result.value();
+  const katana::GraphTopology& topology = pg->topology();
+  using Node = PriorityRounds::Node;
+
+  katana::StatTimer exec_time("GraphColoring");
+  exec_time.start();
+
+  // High degree nodes first needs fewer colors
+  PriorityRounds rounds(topology, true);
+  katana::PerThreadStorage<std::vector<uint8_t>> scratch;
+  katana::GReduceMax<uint32_t> max_color;
+  size_t num_rounds = rounds.Run(
+      [&](Node n) {
+        // A node of degree d has a free color among the first d + 1
+        std::vector<uint8_t>& taken = *scratch.getLocal();
+        size_t degree = topology.edges(n).size();
+        if (taken.size() < degree + 1) {
+          taken.resize(degree + 1, 0);
+        }
+        auto mark = [&](uint8_t value) {
+          for (auto e : topology.edges(n)) {
+            Node dst = topology.edge_dest(e);
+            if (dst != n && rounds.decided(dst)) {
+              uint32_t c = graph.GetData<NodeColor>(dst);
+              if (c <= degree) {
+                taken[c] = value;
+              }
+            }
+          }
+        };
+        mark(1);
+        uint32_t color = 0;
+        while (taken[color]) {
+          ++color;
+        }
+        mark(0);
+        graph.GetData<NodeColor>(n) = color;
+        max_color.update(color);
+      },
+      [](Node) {});
+
+  exec_time.stop();
+
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+
+  katana::ReportStatSingle("GraphColoring", "rounds", num_rounds);
+  katana::ReportStatSingle(
+      "GraphColoring", "colors",
+      topology.num_nodes() == 0 ? 0 : max_color.reduce() + 1);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::GraphColoringAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = ColorGraph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  ColorGraph graph = pg_result.value();
+
+  katana::GReduceLogicalOr conflict;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const ColorGraph::Node& n) {
+        uint32_t color = graph.GetData<NodeColor>(n);
+        for (auto e : graph.edges(n)) {
+          auto dst = graph.GetEdgeDest(e);
+          if (*dst != n && graph.GetData<NodeColor>(dst) == color) {
+            conflict.update(true);
+          }
+        }
+      },
+      katana::loopname("GraphColoring-verify"), katana::no_stats());
+  if (conflict.reduce()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+  return katana::ResultSuccess();
+}
+
 void
 katana::analytics::IndependentSetStatistics::Print(std::ostream& os) const {
   os << "Cardinality = " << cardinality << std::endl;
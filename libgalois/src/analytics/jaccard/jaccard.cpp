@@ -19,6 +19,8 @@
 
 #include "katana/analytics/jaccard/jaccard.h"
 
+#include "katana/Cancellation.h"
+#include "katana/SetIntersection.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
 
@@ -36,33 +38,21 @@ struct IntersectWithSortedEdgeList {
 private:
   const GNode base_;
   const Graph& graph_;
+  const GNode* dests_;
 
 public:
   IntersectWithSortedEdgeList(const Graph& graph, GNode base)
-      : base_(base), graph_(graph) {}
+      : base_(base),
+        graph_(graph),
+        dests_(graph.GetPropertyGraph().topology().edge_dests()) {}
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    // Iterate over the edges of both n2 and base in sync, based on the
-    // assumption that edges lists are sorted.
-    auto edges_n2_iter = graph_.edge_begin(n2);
-    auto edges_n2_end = graph_.edge_end(n2);
-    auto edges_base_iter = graph_.edge_begin(base_);
-    auto edges_base_end = graph_.edge_end(base_);
-    while (edges_n2_iter != edges_n2_end && edges_base_iter != edges_base_end) {
-      auto edge_n2_dst = graph_.GetEdgeDest(*edges_n2_iter);
-      auto edge_base_dst = graph_.GetEdgeDest(*edges_base_iter);
-      if (edge_n2_dst == edge_base_dst) {
-        intersection_size++;
-        edges_n2_iter++;
-        edges_base_iter++;
-      } else if (edge_n2_dst > edge_base_dst) {
-        edges_base_iter++;
-      } else if (edge_n2_dst < edge_base_dst) {
-        edges_n2_iter++;
-      }
-    }
-    return intersection_size;
+    // Edge lists are sorted, so their destinations are sorted sets
+    auto edges_n2 = graph_.edges(n2);
+    auto edges_base = graph_.edges(base_);
+    return katana::CountSortedIntersection(
+        dests_ + *edges_n2.begin(), edges_n2.size(),
+        dests_ + *edges_base.begin(), edges_base.size());
   }
 };
 
@@ -163,6 +153,9 @@ katana::analytics::Jaccard(
     break;
   }
 
+  if (r && katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
   return r;
 }
 
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Cancellation.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/analytics/jaccard/jaccard.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// A dense accumulator of the weight of the 2-hop paths from a node to each
+/// candidate; only the touched entries are reset between nodes
+struct Scratch {
+  std::vector<double> paths;
+  std::vector<Node> touched;
+  std::vector<std::pair<double, Node>> candidates;
+};
+
+uint64_t
+Mix(uint64_t x) {
+  // splitmix64
+  x += UINT64_C(0x9e3779b97f4a7c15);
+  x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+/// The MinHash signature of the out-neighbors of every node: entry h of the
+/// row of n is the least hash h of a neighbor of n
+katana::LargeArray<uint64_t>
+MakeSignatures(const katana::GraphTopology& topology, uint32_t num_hashes) {
+  katana::LargeArray<uint64_t> signatures;
+  signatures.allocateBlocked(topology.num_nodes() * num_hashes);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        uint64_t* row = &signatures[uint64_t{n} * num_hashes];
+        std::fill_n(row, num_hashes, UINT64_MAX);
+        for (auto e : topology.edges(n)) {
+          uint64_t dst_hash = Mix(topology.edge_dest(e));
+          for (uint32_t h = 0; h < num_hashes; ++h) {
+            row[h] = std::min(row[h], Mix(dst_hash + h));
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("SimilarityTopKSignatures"));
+  return signatures;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::SimilarityTopK(
+    PropertyGraph* pg, uint32_t k,
+    const std::string& output_nodes_property_name,
+    const std::string& output_scores_property_name, SimilarityTopKPlan plan) {
+  if (k == 0) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "k must be positive");
+  }
+  if (plan.num_hashes() > 0 &&
+      plan.measure() != SimilarityTopKPlan::kJaccard) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "MinHash only estimates Jaccard");
+  }
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+  auto in_edges = in_edges_result.value();
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint32_t max_degree = plan.max_intermediate_degree();
+  uint32_t num_hashes = plan.num_hashes();
+
+  katana::LargeArray<uint64_t> signatures;
+  if (num_hashes > 0) {
+    signatures = MakeSignatures(topology, num_hashes);
+  }
+
+  uint64_t num_values = num_nodes * k;
+  auto nodes_res = arrow::AllocateBuffer(num_values * sizeof(uint32_t));
+  auto scores_res = arrow::AllocateBuffer(num_values * sizeof(double));
+  if (!nodes_res.ok() || !scores_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "allocating top {} lists: {}", k,
+        nodes_res.ok() ? scores_res.status() : nodes_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> nodes_buffer =
+      std::move(nodes_res.ValueOrDie());
+  std::shared_ptr<arrow::Buffer> scores_buffer =
+      std::move(scores_res.ValueOrDie());
+  auto* top_nodes = reinterpret_cast<uint32_t*>(nodes_buffer->mutable_data());
+  auto* top_scores = reinterpret_cast<double*>(scores_buffer->mutable_data());
+
+  auto score = [&](Node u, Node v, double paths) {
+    if (num_hashes > 0) {
+      const uint64_t* u_row = &signatures[uint64_t{u} * num_hashes];
+      const uint64_t* v_row = &signatures[uint64_t{v} * num_hashes];
+      uint32_t matches = 0;
+      for (uint32_t h = 0; h < num_hashes; ++h) {
+        matches += u_row[h] == v_row[h];
+      }
+      return double(matches) / num_hashes;
+    }
+    double u_degree = topology.edges(u).size();
+    double v_degree = topology.edges(v).size();
+    switch (plan.measure()) {
+    case SimilarityTopKPlan::kJaccard:
+      return paths / (u_degree + v_degree - paths);
+    case SimilarityTopKPlan::kCosine:
+      return paths / std::sqrt(u_degree * v_degree);
+    case SimilarityTopKPlan::kAdamicAdar:
+      return paths;
+    }
+    return 0.0;
+  };
+
+  katana::PerThreadStorage<Scratch> scratch;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node u) {
+        Scratch& local = *scratch.getLocal();
+        if (local.paths.empty()) {
+          local.paths.resize(num_nodes, 0);
+        }
+
+        // Accumulate, for each candidate v, its paths u -> w <- v
+        for (auto e : topology.edges(u)) {
+          Node w = topology.edge_dest(e);
+          auto sources = in_edges->in_edges(w);
+          if (max_degree != SimilarityTopKPlan::kUnboundedDegree &&
+              sources.size() > max_degree) {
+            continue;
+          }
+          double weight = plan.measure() == SimilarityTopKPlan::kAdamicAdar
+                              ? 1.0 / std::log(double(sources.size()))
+                              : 1.0;
+          for (auto in_e : sources) {
+            Node v = in_edges->in_edge_src(in_e);
+            if (v == u) {
+              continue;
+            }
+            if (local.paths[v] == 0) {
+              local.touched.emplace_back(v);
+            }
+            local.paths[v] += weight;
+          }
+        }
+
+        local.candidates.clear();
+        for (Node v : local.touched) {
+          local.candidates.emplace_back(-score(u, v, local.paths[v]), v);
+          local.paths[v] = 0;
+        }
+        local.touched.clear();
+
+        // Highest score first, then least node
+        size_t found = std::min<size_t>(k, local.candidates.size());
+        std::partial_sort(
+            local.candidates.begin(), local.candidates.begin() + found,
+            local.candidates.end());
+        uint32_t* nodes_row = top_nodes + uint64_t{u} * k;
+        double* scores_row = top_scores + uint64_t{u} * k;
+        for (size_t i = 0; i < found; ++i) {
+          nodes_row[i] = local.candidates[i].second;
+          scores_row[i] = -local.candidates[i].first;
+        }
+        std::fill(nodes_row + found, nodes_row + k, kSimilarityTopKNoNode);
+        std::fill(scores_row + found, scores_row + k, 0.0);
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("SimilarityTopK"));
+
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+
+  auto nodes_type = arrow::fixed_size_list(arrow::uint32(), k);
+  auto scores_type = arrow::fixed_size_list(arrow::float64(), k);
+  auto nodes_list = std::make_shared<arrow::FixedSizeListArray>(
+      nodes_type, num_nodes,
+      std::make_shared<arrow::UInt32Array>(num_values, nodes_buffer));
+  auto scores_list = std::make_shared<arrow::FixedSizeListArray>(
+      scores_type, num_nodes,
+      std::make_shared<arrow::DoubleArray>(num_values, scores_buffer));
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field(output_nodes_property_name, nodes_type),
+           arrow::field(output_scores_property_name, scores_type)}),
+      {nodes_list, scores_list});
+  return pg->AddNodeProperties(table);
+}
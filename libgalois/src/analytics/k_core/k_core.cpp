@@ -19,7 +19,16 @@
 
 #include "katana/analytics/k_core/k_core.h"
 
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Cancellation.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Frontier.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PeelingBuckets.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -38,6 +47,8 @@ struct KCoreNodeCurrentDegree {
 
 struct KCoreNodeAlive : public katana::PODProperty<uint32_t> {};
 
+struct KCoreNodeCoreness : public katana::PODProperty<uint32_t> {};
+
 using NodeData = std::tuple<KCoreNodeCurrentDegree>;
 using EdgeData = std::tuple<>;
 typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
@@ -69,10 +80,10 @@ DegreeCounting(Graph* graph) {
  * @param initial_worklist Empty worklist to be filled with dead nodes.
  * @param k_core_number Each node in the core is expected to have degree <= k_core_number.
  */
+template <typename WL>
 void
 SetupInitialWorklist(
-    const Graph& graph, katana::InsertBag<GNode>& initial_worklist,
-    uint32_t k_core_number) {
+    const Graph& graph, WL& initial_worklist, uint32_t k_core_number) {
   katana::do_all(
       katana::iterate(graph),
       [&](const GNode& node) {
@@ -80,7 +91,7 @@ SetupInitialWorklist(
             graph.GetData<KCoreNodeCurrentDegree>(node);
         if (node_current_degree < k_core_number) {
           //! Dead node, add to initial_worklist for processing later.
-          initial_worklist.emplace(node);
+          initial_worklist.push(node);
         }
       },
       katana::loopname("InitialWorklistSetup"), katana::no_stats());
@@ -96,19 +107,19 @@ SetupInitialWorklist(
  */
 void
 SyncCascadeKCore(Graph* graph, uint32_t k_core_number) {
-  auto current = std::make_unique<katana::InsertBag<GNode>>();
-  auto next = std::make_unique<katana::InsertBag<GNode>>();
+  katana::Frontier current(graph->size());
+  katana::Frontier next(graph->size());
 
   //! Setup worklist.
-  SetupInitialWorklist(*graph, *next, k_core_number);
+  SetupInitialWorklist(*graph, next, k_core_number);
+  next.Adapt();
 
-  while (!next->empty()) {
+  while (!next.empty()) {
     //! Make "next" into current.
-    std::swap(current, next);
-    next->clear();
+    current.swap(next);
+    next.Reset(current.is_dense());
 
-    katana::do_all(
-        katana::iterate(*current),
+    current.ForEach(
         [&](const GNode& dead_node) {
           //! Decrement degree of all neighbors.
           for (auto e : graph->edges(dead_node)) {
@@ -120,12 +131,12 @@ SyncCascadeKCore(Graph* graph, uint32_t k_core_number) {
             if (old_degree == k_core_number) {
               //! This thread was responsible for putting degree of destination
               //! below threshold; add to worklist.
-              next->emplace(*dest);
+              next.push(*dest);
             }
           }
         },
-        katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
-        katana::loopname("KCore Synchronous"));
+        "KCore Synchronous");
+    next.Adapt();
   }
 }
 
@@ -165,6 +176,68 @@ AsyncCascadeKCore(Graph* graph, uint32_t k_core_number) {
       katana::loopname("KCore Asynchronous"));
 }
 
+/**
+ * Peel nodes in rounds of increasing level: each round removes every node
+ * whose degree among the remaining nodes is at most the level. Degrees of
+ * remaining nodes never drop below the level, so when a node is peeled its
+ * degree is its coreness, and it stays that way.
+ *
+ * @param graph Graph to operate on; degrees must be initialized
+ */
+void
+BucketCoreDecomposition(Graph* graph) {
+  katana::DynamicBitset peeled;
+  peeled.resize(graph->size());
+  auto buckets = katana::MakePeelingBuckets<GNode>(
+      [graph](GNode node) {
+        return graph->GetData<KCoreNodeCurrentDegree>(node).load(
+            std::memory_order_relaxed);
+      },
+      [&peeled](GNode node) { return peeled.test(node); });
+  katana::do_all(
+      katana::iterate(*graph), [&](const GNode& node) { buckets.Insert(node); },
+      katana::no_stats());
+
+  katana::Frontier current(graph->size());
+  katana::Frontier next(graph->size());
+
+  uint32_t level = 0;
+  while (!katana::IsCancelled() &&
+         buckets.NextLevel(&level, [&](GNode node) { next.push(node); })) {
+    next.Adapt();
+    while (!next.empty()) {
+      current.swap(next);
+      next.Reset(current.is_dense());
+
+      current.ForEach(
+          [&](const GNode& node) {
+            peeled.set(node);
+            for (auto e : graph->edges(node)) {
+              auto dest = graph->GetEdgeDest(e);
+              if (peeled.test(*dest)) {
+                continue;
+              }
+              auto& dest_current_degree =
+                  graph->GetData<KCoreNodeCurrentDegree>(dest);
+              uint32_t old_degree = dest_current_degree.load();
+              while (old_degree > level &&
+                     !dest_current_degree.compare_exchange_weak(
+                         old_degree, old_degree - 1))
+                ;
+              if (old_degree == level + 1) {
+                //! Dropped to the level: peel it in this level.
+                next.push(*dest);
+              } else if (old_degree > level + 1) {
+                buckets.Update(*dest, old_degree - 1);
+              }
+            }
+          },
+          "KCore Peel");
+      next.Adapt();
+    }
+  }
+}
+
 /**
  * After computation is finished, the nodes left in the core
  * are marked as alive.
@@ -216,11 +289,19 @@ KCoreImpl(
   case KCorePlan::kAsynchronous:
     AsyncCascadeKCore(graph, k_core_number);
     break;
+  case KCorePlan::kDecomposition:
+    //! Every node ends with its coreness as its degree.
+    BucketCoreDecomposition(graph);
+    break;
   default:
     return katana::ErrorCode::AssertionFailed;
   }
   exec_time.stop();
 
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+
   return katana::ResultSuccess();
 }
 
@@ -262,6 +343,304 @@ katana::analytics::KCore(
   return KCoreMarkAliveNodes(&graph_final, k_core_number);
 }
 
+katana::Result<void>
+katana::analytics::KCoreDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  //! The degrees become the coreness, so peel the output property directly.
+  if (auto result = ConstructNodeProperties<std::tuple<KCoreNodeCurrentDegree>>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  return KCoreImpl(&graph, KCorePlan::Decomposition(), 0);
+}
+
+/*******************************************************************************
+ * Incremental core decomposition
+ ******************************************************************************/
+using NodePair = std::pair<uint32_t, uint32_t>;
+
+/// Maintains coreness across a batch of edge updates by the local h-index
+/// characterization of coreness (Sariyuce et al., "Local Algorithms for
+/// Hierarchical Dense Subgraph Discovery", VLDB 2018): coreness is the
+/// largest assignment of values to nodes in which each node of value c has
+/// at least c neighbors of value at least c, and lowering each value to the
+/// h-index of the values of its neighbors, until none changes, reaches it
+/// from any upper bound of it.
+///
+/// Deletions only lower coreness, so the old coreness is an upper bound on
+/// the graph without the inserted edges, and it is lowered starting from
+/// the endpoints of the deleted edges. Insertions only raise coreness. Each
+/// round of insertion raises by one the nodes that could rise, which are
+/// reached from the endpoints of the inserted edges, and from the nodes
+/// that rose in earlier rounds and their neighbors, through nodes of equal
+/// value, and then lowers them again. What is left is still a lower bound,
+/// and the first round in which no node stays raised is the last.
+class CoreMaintenance {
+public:
+  using Edge = katana::GraphTopology::Edge;
+
+  CoreMaintenance(const katana::GraphTopology& topology, Graph* graph)
+      : topology_(topology), graph_(graph) {}
+
+  /// Find the inserted edges in the graph, in both directions
+  katana::Result<void> MarkInserted(const std::vector<NodePair>& inserted);
+
+  /// Lower the values after deleting edges, ignoring the inserted edges
+  void Delete(const std::vector<NodePair>& deleted);
+
+  /// Raise the values after inserting edges
+  void Insert(const std::vector<NodePair>& inserted);
+
+private:
+  std::atomic<uint32_t>& Value(GNode n) {
+    return graph_->GetData<KCoreNodeCurrentDegree>(n);
+  }
+
+  /// Whether e was an edge of the graph before the insertions
+  bool IsOld(Edge e) const {
+    return inserted_.size() == 0 || !inserted_.test(e);
+  }
+
+  /// The h-index of the values of the neighbors of n, at most the value of n
+  uint32_t HIndex(GNode n, bool with_inserted);
+
+  /// Whether the value of n could rise, i.e., whether more than its value of
+  /// its neighbors have a value of at least its value
+  bool CanRise(GNode n);
+
+  /// Lower the values of seeds, and transitively of their neighbors, to the
+  /// h-index of the values of their neighbors
+  void Lower(katana::InsertBag<GNode>* seeds, bool with_inserted);
+
+  const katana::GraphTopology& topology_;
+  Graph* graph_;
+  katana::DynamicBitset inserted_;
+  katana::PerThreadStorage<std::vector<uint32_t>> counts_;
+};
+
+katana::Result<void>
+CoreMaintenance::MarkInserted(const std::vector<NodePair>& inserted) {
+  inserted_.resize(topology_.num_edges());
+  std::atomic<bool> found{true};
+  katana::do_all(
+      katana::iterate(inserted),
+      [&](const NodePair& edge) {
+        //! A multi-edge is marked once per insertion of it.
+        auto mark = [&](GNode src, GNode dst) {
+          for (auto e : topology_.edges(src)) {
+            if (topology_.edge_dest(e) == dst && !inserted_.set(e)) {
+              return;
+            }
+          }
+          found = false;
+        };
+        mark(edge.first, edge.second);
+        if (edge.first != edge.second) {
+          mark(edge.second, edge.first);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (!found) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "inserted edges must be edges of the graph in both directions");
+  }
+  return katana::ResultSuccess();
+}
+
+uint32_t
+CoreMaintenance::HIndex(GNode n, bool with_inserted) {
+  auto edges = topology_.edges(n);
+  uint32_t value = std::min<uint64_t>(Value(n), edges.size());
+  std::vector<uint32_t>& counts = *counts_.getLocal();
+  counts.assign(value + 1, 0);
+  for (auto e : edges) {
+    if (with_inserted || IsOld(e)) {
+      counts[std::min(Value(topology_.edge_dest(e)).load(), value)] += 1;
+    }
+  }
+  uint32_t at_least = 0;
+  for (uint32_t h = value; h > 0; --h) {
+    at_least += counts[h];
+    if (at_least >= h) {
+      return h;
+    }
+  }
+  return 0;
+}
+
+bool
+CoreMaintenance::CanRise(GNode n) {
+  uint32_t value = Value(n);
+  uint32_t at_least = 0;
+  for (auto e : topology_.edges(n)) {
+    at_least += Value(topology_.edge_dest(e)) >= value;
+  }
+  return at_least > value;
+}
+
+void
+CoreMaintenance::Lower(katana::InsertBag<GNode>* seeds, bool with_inserted) {
+  katana::for_each(
+      katana::iterate(*seeds),
+      [&](GNode n, auto& ctx) {
+        uint32_t h = HIndex(n, with_inserted);
+        if (katana::atomicMin(Value(n), h) <= h) {
+          return;
+        }
+        //! Only the neighbors of value above h may have counted n.
+        for (auto e : topology_.edges(n)) {
+          GNode dest = topology_.edge_dest(e);
+          if ((with_inserted || IsOld(e)) && Value(dest) > h) {
+            ctx.push(dest);
+          }
+        }
+      },
+      katana::disable_conflict_detection(),
+      katana::chunk_size<KCorePlan::kChunkSize>(),
+      katana::loopname("KCore Incremental Lower"));
+}
+
+void
+CoreMaintenance::Delete(const std::vector<NodePair>& deleted) {
+  katana::InsertBag<GNode> seeds;
+  katana::do_all(
+      katana::iterate(deleted),
+      [&](const NodePair& edge) {
+        seeds.push(edge.first);
+        seeds.push(edge.second);
+      },
+      katana::no_stats());
+  Lower(&seeds, false);
+}
+
+void
+CoreMaintenance::Insert(const std::vector<NodePair>& inserted) {
+  katana::DynamicBitset visited;
+  visited.resize(topology_.num_nodes());
+  katana::DynamicBitset risen;
+  risen.resize(topology_.num_nodes());
+  katana::InsertBag<GNode> risen_nodes;
+
+  while (!katana::IsCancelled()) {
+    katana::InsertBag<GNode> seeds;
+    katana::do_all(
+        katana::iterate(inserted),
+        [&](const NodePair& edge) {
+          seeds.push(edge.first);
+          seeds.push(edge.second);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(risen_nodes),
+        [&](GNode n) {
+          seeds.push(n);
+          for (auto e : topology_.edges(n)) {
+            seeds.push(topology_.edge_dest(e));
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    //! Values do not change until every candidate is found.
+    katana::InsertBag<GNode> candidates;
+    katana::InsertBag<NodePair> old_values;
+    katana::for_each(
+        katana::iterate(seeds),
+        [&](GNode n, auto& ctx) {
+          if (visited.test(n) || !CanRise(n) || visited.set(n)) {
+            return;
+          }
+          uint32_t value = Value(n);
+          candidates.push(n);
+          old_values.push(NodePair{n, value});
+          for (auto e : topology_.edges(n)) {
+            GNode dest = topology_.edge_dest(e);
+            if (!visited.test(dest) && Value(dest) == value) {
+              ctx.push(dest);
+            }
+          }
+        },
+        katana::disable_conflict_detection(),
+        katana::chunk_size<KCorePlan::kChunkSize>(),
+        katana::loopname("KCore Incremental Candidates"));
+
+    katana::do_all(
+        katana::iterate(candidates), [&](GNode n) { Value(n) += 1; },
+        katana::no_stats());
+    Lower(&candidates, true);
+
+    katana::GAccumulator<uint64_t> rose;
+    katana::do_all(
+        katana::iterate(old_values),
+        [&](const NodePair& old_value) {
+          auto [n, value] = old_value;
+          visited.reset(n);
+          if (Value(n) > value) {
+            rose += 1;
+            if (!risen.set(n)) {
+              risen_nodes.push(n);
+            }
+          }
+        },
+        katana::no_stats());
+    if (rose.reduce() == 0) {
+      break;
+    }
+  }
+}
+
+katana::Result<void>
+katana::analytics::KCoreDecompositionIncremental(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges) {
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  for (const auto* edges : {&inserted_edges, &deleted_edges}) {
+    for (const auto& [src, dst] : *edges) {
+      if (src >= graph.size() || dst >= graph.size()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "edge ({}, {}) is not between nodes of the graph", src, dst);
+      }
+    }
+  }
+
+  katana::StatTimer exec_time("KCoreDecompositionIncremental");
+  exec_time.start();
+
+  CoreMaintenance maintenance(pg->topology(), &graph);
+  if (!inserted_edges.empty()) {
+    if (auto r = maintenance.MarkInserted(inserted_edges); !r) {
+      return r.error();
+    }
+  }
+  if (!deleted_edges.empty()) {
+    maintenance.Delete(deleted_edges);
+  }
+  if (!inserted_edges.empty()) {
+    maintenance.Insert(inserted_edges);
+  }
+  exec_time.stop();
+
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return katana::ResultSuccess();
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -299,7 +678,82 @@ katana::analytics::KCoreStatistics::Compute(
       },
       katana::loopname("KCore sanity check"), katana::no_stats());
 
-  return KCoreStatistics{alive_nodes.reduce()};
+  return KCoreStatistics{alive_nodes.reduce(), {}};
+}
+
+katana::Result<void>
+katana::analytics::KCoreDecompositionAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  using CorenessGraph =
+      katana::TypedPropertyGraph<std::tuple<KCoreNodeCoreness>, std::tuple<>>;
+  auto pg_result = CorenessGraph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  auto is_bad = [&graph](const GNode& node) {
+    uint32_t coreness = graph.GetData<KCoreNodeCoreness>(node);
+    uint32_t at_least = 0;
+    uint32_t above = 0;
+    for (auto e : graph.edges(node)) {
+      uint32_t dest_coreness =
+          graph.GetData<KCoreNodeCoreness>(graph.GetEdgeDest(e));
+      at_least += dest_coreness >= coreness;
+      above += dest_coreness > coreness;
+    }
+    if (at_least < coreness || above > coreness) {
+      KATANA_LOG_DEBUG(
+          "{} has coreness {} but {} neighbors of at least that and {} "
+          "above",
+          node, coreness, at_least, above);
+      return true;
+    }
+    return false;
+  };
+
+  if (katana::ParallelSTL::find_if(graph.begin(), graph.end(), is_bad) !=
+      graph.end()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<KCoreStatistics>
+katana::analytics::KCoreStatistics::ComputeDecomposition(
+    katana::PropertyGraph* pg, uint32_t k_core_number,
+    const std::string& property_name) {
+  using CorenessGraph =
+      katana::TypedPropertyGraph<std::tuple<KCoreNodeCoreness>, std::tuple<>>;
+  auto pg_result = CorenessGraph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  auto counts = katana::ParallelSTL::group_by(
+      graph.begin(), graph.end(),
+      [&](const GNode& node) {
+        return graph.GetData<KCoreNodeCoreness>(node);
+      });
+
+  katana::GReduceMax<uint32_t> max_coreness;
+  katana::do_all(
+      katana::iterate(counts),
+      [&](const auto& x) { max_coreness.update(x.key); }, katana::no_stats());
+
+  KCoreStatistics stats{0, {}};
+  if (!counts.empty()) {
+    stats.coreness_histogram.resize(uint64_t{max_coreness.reduce()} + 1);
+  }
+  for (const auto& x : counts) {
+    stats.coreness_histogram[x.key] = x.count;
+    if (x.key >= k_core_number) {
+      stats.number_of_nodes_in_kcore += x.count;
+    }
+  }
+  return stats;
 }
 /// \endcond DO_NOT_DOCUMENT
 
@@ -307,4 +761,13 @@ void
 katana::analytics::KCoreStatistics::Print(std::ostream& os) const {
   os << "Number of nodes in the core = " << number_of_nodes_in_kcore
      << std::endl;
+  if (!coreness_histogram.empty()) {
+    os << "Largest coreness = " << coreness_histogram.size() - 1 << std::endl;
+    os << "Number of nodes by coreness:" << std::endl;
+    for (size_t k = 0; k < coreness_histogram.size(); ++k) {
+      if (coreness_histogram[k] != 0) {
+        os << "  " << k << " = " << coreness_histogram[k] << std::endl;
+      }
+    }
+  }
 }
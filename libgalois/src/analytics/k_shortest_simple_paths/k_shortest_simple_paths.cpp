@@ -0,0 +1,417 @@
+#include "katana/analytics/k_shortest_simple_paths/k_shortest_simple_paths.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kNotOnPath = std::numeric_limits<uint32_t>::max();
+
+/// A path with the distance from the source to each of its nodes
+template <typename Weight>
+struct WeightedPath {
+  std::vector<Node> nodes;
+  std::vector<Weight> distances;
+
+  Weight weight() const { return distances.back(); }
+
+  bool operator<(const WeightedPath& other) const {
+    if (weight() != other.weight()) {
+      return weight() < other.weight();
+    }
+    return nodes < other.nodes;
+  }
+};
+
+/// A thread's state for Dijkstra searches. The distance and parent of a node
+/// are valid only if its stamp is the one of the current search, so that
+/// the arrays are allocated once and never cleared.
+template <typename Weight>
+struct SpurSearch {
+  std::vector<Weight> distance;
+  std::vector<Node> parent;
+  std::vector<uint32_t> seen;
+  uint32_t stamp{0};
+  std::vector<std::pair<Weight, Node>> heap;
+
+  /// Extend \p path, which ends at the spur node, by a shortest path to
+  /// \p target that avoids the nodes n with masked(n) and the edges from the
+  /// spur node to the nodes in \p banned. \returns false if there is none.
+  template <typename WeightFn, typename MaskFn>
+  bool Extend(
+      const katana::GraphTopology& topology, WeightFn weight_of, Node target,
+      MaskFn masked, const std::vector<Node>& banned,
+      WeightedPath<Weight>* path) {
+    size_t num_nodes = topology.num_nodes();
+    if (seen.size() < num_nodes) {
+      distance.resize(num_nodes);
+      parent.resize(num_nodes);
+      seen.assign(num_nodes, 0);
+      stamp = 0;
+    }
+    if (++stamp == 0) {
+      std::fill(seen.begin(), seen.end(), 0);
+      stamp = 1;
+    }
+
+    const Node* dests = topology.edge_dests();
+    auto later = std::greater<std::pair<Weight, Node>>();
+    Node spur = path->nodes.back();
+    seen[spur] = stamp;
+    distance[spur] = 0;
+    heap.clear();
+    heap.emplace_back(0, spur);
+
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end(), later);
+      auto [dist, n] = heap.back();
+      heap.pop_back();
+      // Nodes are only pushed again with smaller distances
+      if (dist != distance[n]) {
+        continue;
+      }
+      if (n == target) {
+        break;
+      }
+      for (auto e : topology.edges(n)) {
+        Node dst = dests[e];
+        if (masked(dst)) {
+          continue;
+        }
+        if (n == spur &&
+            std::find(banned.begin(), banned.end(), dst) != banned.end()) {
+          continue;
+        }
+        Weight new_dist = dist + weight_of(e);
+        if (seen[dst] != stamp || new_dist < distance[dst]) {
+          seen[dst] = stamp;
+          distance[dst] = new_dist;
+          parent[dst] = n;
+          heap.emplace_back(new_dist, dst);
+          std::push_heap(heap.begin(), heap.end(), later);
+        }
+      }
+    }
+    if (target == spur) {
+      return true;
+    }
+    if (seen[target] != stamp) {
+      return false;
+    }
+
+    size_t root_size = path->nodes.size();
+    Weight base = path->weight();
+    for (Node n = target; n != spur; n = parent[n]) {
+      path->nodes.emplace_back(n);
+      path->distances.emplace_back(base + distance[n]);
+    }
+    std::reverse(path->nodes.begin() + root_size, path->nodes.end());
+    std::reverse(path->distances.begin() + root_size, path->distances.end());
+    return true;
+  }
+};
+
+template <typename Weight, typename WeightFn>
+KShortestSimplePathsResult
+Yen(const katana::GraphTopology& topology, WeightFn weight_of, Node source,
+    Node target, size_t k) {
+  katana::PerThreadStorage<SpurSearch<Weight>> searches;
+  std::vector<WeightedPath<Weight>> accepted;
+  std::set<WeightedPath<Weight>> candidates;
+  // The index of each node in the last accepted path
+  std::vector<uint32_t> position(topology.num_nodes(), kNotOnPath);
+
+  WeightedPath<Weight> shortest{{source}, {Weight{0}}};
+  if (k > 0 && searches.getLocal()->Extend(
+                   topology, weight_of, target, [](Node) { return false; },
+                   {}, &shortest)) {
+    accepted.emplace_back(std::move(shortest));
+  }
+
+  while (!accepted.empty() && accepted.size() < k) {
+    const WeightedPath<Weight>& last = accepted.back();
+    size_t len = last.nodes.size();
+    for (size_t i = 0; i < len; ++i) {
+      position[last.nodes[i]] = i;
+    }
+    // The number of leading nodes each accepted path shares with the last
+    std::vector<size_t> shared(accepted.size());
+    for (size_t j = 0; j < accepted.size(); ++j) {
+      const auto& nodes = accepted[j].nodes;
+      while (shared[j] < std::min(len, nodes.size()) &&
+             nodes[shared[j]] == last.nodes[shared[j]]) {
+        ++shared[j];
+      }
+    }
+
+    // Deviate from the last path at each node but the target. The spur
+    // search from node i may not visit the nodes before it, and may not
+    // leave it along the edges of accepted paths with the same root path.
+    std::vector<std::optional<WeightedPath<Weight>>> spur_paths(len - 1);
+    katana::do_all(
+        katana::iterate(size_t{0}, len - 1),
+        [&](size_t i) {
+          std::vector<Node> banned;
+          for (size_t j = 0; j < accepted.size(); ++j) {
+            if (shared[j] > i) {
+              banned.emplace_back(accepted[j].nodes[i + 1]);
+            }
+          }
+          WeightedPath<Weight> path{
+              {last.nodes.begin(), last.nodes.begin() + i + 1},
+              {last.distances.begin(), last.distances.begin() + i + 1}};
+          if (searches.getLocal()->Extend(
+                  topology, weight_of, target,
+                  [&](Node n) { return position[n] < i; }, banned, &path)) {
+            spur_paths[i] = std::move(path);
+          }
+        },
+        katana::chunk_size<1>(), katana::steal(), katana::no_stats(),
+        katana::loopname("KShortestSimplePaths-Spur"));
+
+    for (Node n : last.nodes) {
+      position[n] = kNotOnPath;
+    }
+    for (auto& path : spur_paths) {
+      if (path) {
+        candidates.emplace(std::move(*path));
+      }
+    }
+    // Only the lightest remaining candidates can still be accepted
+    while (candidates.size() > k - accepted.size()) {
+      candidates.erase(std::prev(candidates.end()));
+    }
+    if (candidates.empty()) {
+      break;
+    }
+    accepted.emplace_back(
+        std::move(candidates.extract(candidates.begin()).value()));
+  }
+
+  KShortestSimplePathsResult result;
+  for (auto& path : accepted) {
+    result.weights.emplace_back(static_cast<double>(path.weight()));
+    result.paths.emplace_back(std::move(path.nodes));
+  }
+  return result;
+}
+
+template <typename Weight>
+katana::Result<KShortestSimplePathsResult>
+KShortestSimplePathsWithWrap(
+    katana::PropertyGraph* pg, Node source, Node target, size_t k,
+    const std::string& edge_weight_property_name) {
+  auto weights_result =
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto weights = weights_result.value();
+
+  if constexpr (std::is_signed_v<Weight>) {
+    katana::GReduceLogicalOr negative;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, pg->topology().num_edges()),
+        [&](uint64_t e) {
+          if (weights->Value(e) < 0) {
+            negative.update(true);
+          }
+        },
+        katana::no_stats());
+    if (negative.reduce()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "edge weights are negative");
+    }
+  }
+
+  katana::StatTimer exec_time("KShortestSimplePaths");
+  exec_time.start();
+  auto result = Yen<Weight>(
+      pg->topology(), [&](uint64_t e) { return weights->Value(e); }, source,
+      target, k);
+  exec_time.stop();
+  return result;
+}
+
+template <typename Weight>
+katana::Result<void>
+KShortestSimplePathsAssertValidImpl(
+    katana::PropertyGraph* pg, size_t source, size_t target,
+    const std::string& edge_weight_property_name,
+    const KShortestSimplePathsResult& result) {
+  auto weights_result =
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto weights = weights_result.value();
+  const katana::GraphTopology& topology = pg->topology();
+
+  if (result.paths.size() != result.weights.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "{} paths but {} weights",
+        result.paths.size(), result.weights.size());
+  }
+
+  std::set<std::vector<uint32_t>> distinct;
+  for (size_t i = 0; i < result.paths.size(); ++i) {
+    const auto& path = result.paths[i];
+    if (path.empty() || path.front() != source || path.back() != target) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "path {} does not lead from {} to {}", i, source, target);
+    }
+    std::vector<uint32_t> sorted(path);
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed, "path {} is not simple", i);
+    }
+    if (!distinct.emplace(path).second) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed, "path {} is found twice", i);
+    }
+
+    Weight weight{0};
+    for (size_t j = 0; j + 1 < path.size(); ++j) {
+      std::optional<Weight> lightest;
+      for (auto e : topology.edges(path[j])) {
+        if (topology.edge_dest(e) == path[j + 1] &&
+            (!lightest || weights->Value(e) < *lightest)) {
+          lightest = weights->Value(e);
+        }
+      }
+      if (!lightest) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed, "path {} has no edge {} -> {}",
+            i, path[j], path[j + 1]);
+      }
+      weight += *lightest;
+    }
+    double expected = static_cast<double>(weight);
+    if (std::abs(result.weights[i] - expected) >
+        1e-6 * std::max(1.0, std::abs(expected))) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "path {} has weight {} but its edges weigh {}", i, result.weights[i],
+          expected);
+    }
+    if (i > 0 && result.weights[i] < result.weights[i - 1]) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "path {} is lighter than the one before it", i);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<KShortestSimplePathsResult>
+katana::analytics::KShortestSimplePaths(
+    katana::PropertyGraph* pg, size_t source, size_t target, size_t k,
+    const std::string& edge_weight_property_name,
+    KShortestSimplePathsPlan plan) {
+  if (source >= pg->topology().num_nodes() ||
+      target >= pg->topology().num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} or target {} is not a node", source, target);
+  }
+  if (plan.algorithm() != KShortestSimplePathsPlan::kYen) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        static_cast<int>(plan.algorithm()));
+  }
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return KShortestSimplePathsWithWrap<uint32_t>(
+        pg, source, target, k, edge_weight_property_name);
+  case arrow::Int32Type::type_id:
+    return KShortestSimplePathsWithWrap<int32_t>(
+        pg, source, target, k, edge_weight_property_name);
+  case arrow::UInt64Type::type_id:
+    return KShortestSimplePathsWithWrap<uint64_t>(
+        pg, source, target, k, edge_weight_property_name);
+  case arrow::Int64Type::type_id:
+    return KShortestSimplePathsWithWrap<int64_t>(
+        pg, source, target, k, edge_weight_property_name);
+  case arrow::FloatType::type_id:
+    return KShortestSimplePathsWithWrap<float>(
+        pg, source, target, k, edge_weight_property_name);
+  case arrow::DoubleType::type_id:
+    return KShortestSimplePathsWithWrap<double>(
+        pg, source, target, k, edge_weight_property_name);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+katana::Result<void>
+katana::analytics::KShortestSimplePathsAssertValid(
+    katana::PropertyGraph* pg, size_t source, size_t target,
+    const std::string& edge_weight_property_name,
+    const KShortestSimplePathsResult& result) {
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return KShortestSimplePathsAssertValidImpl<uint32_t>(
+        pg, source, target, edge_weight_property_name, result);
+  case arrow::Int32Type::type_id:
+    return KShortestSimplePathsAssertValidImpl<int32_t>(
+        pg, source, target, edge_weight_property_name, result);
+  case arrow::UInt64Type::type_id:
+    return KShortestSimplePathsAssertValidImpl<uint64_t>(
+        pg, source, target, edge_weight_property_name, result);
+  case arrow::Int64Type::type_id:
+    return KShortestSimplePathsAssertValidImpl<int64_t>(
+        pg, source, target, edge_weight_property_name, result);
+  case arrow::FloatType::type_id:
+    return KShortestSimplePathsAssertValidImpl<float>(
+        pg, source, target, edge_weight_property_name, result);
+  case arrow::DoubleType::type_id:
+    return KShortestSimplePathsAssertValidImpl<double>(
+        pg, source, target, edge_weight_property_name, result);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+void
+katana::analytics::KShortestSimplePathsResult::Print(std::ostream& os) const {
+  os << "k paths:" << std::endl;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    for (uint32_t n : paths[i]) {
+      os << " " << n;
+    }
+    os << " weight: " << weights[i] << std::endl;
+  }
+}
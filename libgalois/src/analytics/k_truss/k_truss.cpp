@@ -19,7 +19,19 @@
 
 #include "katana/analytics/k_truss/k_truss.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Cancellation.h"
+#include "katana/DynamicBitset.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PeelingBuckets.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/SetIntersection.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -32,6 +44,17 @@ using EdgeData = std::tuple<EdgeFlag>;
 typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
 typedef typename Graph::Node GNode;
 
+struct EdgeTrussness : public katana::PODProperty<uint32_t> {};
+typedef katana::TypedPropertyGraph<NodeData, std::tuple<EdgeTrussness>>
+    TrussnessGraph;
+
+struct EdgeAtomicTrussness {
+  using ArrowType = arrow::CTypeTraits<uint32_t>::ArrowType;
+  using ViewType = katana::PODPropertyView<std::atomic<uint32_t>>;
+};
+typedef katana::TypedPropertyGraph<NodeData, std::tuple<EdgeAtomicTrussness>>
+    AtomicTrussnessGraph;
+
 using Edge = std::pair<GNode, GNode>;
 using EdgeVec = katana::InsertBag<Edge>;
 using NodeVec = katana::InsertBag<GNode>;
@@ -92,38 +115,26 @@ IsValidDegreeNoLessThanJ(const Graph& g, GNode n, unsigned int j) {
  */
 bool
 IsSupportNoLessThanJ(const Graph& g, GNode src, GNode dest, unsigned int j) {
-  size_t numValidEqual = 0;
-  auto srcI = g.edge_begin(src), srcE = g.edge_end(src),
-       dstI = g.edge_begin(dest), dstE = g.edge_end(dest);
+  const GNode* dests = g.GetPropertyGraph().topology().edge_dests();
+  auto src_edges = g.edges(src);
+  auto dst_edges = g.edges(dest);
+  auto src_first = *src_edges.begin();
+  auto dst_first = *dst_edges.begin();
 
-  while (true) {
-    //! Find the first valid edge.
-    while (srcI != srcE && (g.GetEdgeData<EdgeFlag>(srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.GetEdgeData<EdgeFlag>(dstI) & removed)) {
-      ++dstI;
-    }
+  auto is_valid = [&](auto edge) {
+    return !(g.GetEdgeData<EdgeFlag>(Graph::edge_iterator(edge)) & removed);
+  };
 
-    if (srcI == srcE || dstI == dstE) {
-      return numValidEqual >= j;
-    }
-
-    //! Check for intersection.
-    auto sN = *g.GetEdgeDest(srcI), dN = *g.GetEdgeDest(dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      numValidEqual += 1;
-      if (numValidEqual >= j) {
-        return true;
-      }
-      ++srcI;
-      ++dstI;
-    }
-  }
+  size_t numValidEqual = 0;
+  katana::ForEachSortedIntersection(
+      dests + src_first, src_edges.size(), dests + dst_first, dst_edges.size(),
+      [&](size_t src_pos, size_t dst_pos) {
+        //! Only intersections of two valid edges count.
+        if (is_valid(src_first + src_pos) && is_valid(dst_first + dst_pos)) {
+          numValidEqual += 1;
+        }
+        return numValidEqual < j;
+      });
 
   return numValidEqual >= j;
 }
@@ -336,6 +347,239 @@ BSPCoreThenTrussAlgo(Graph* g, uint32_t k) {
   return katana::ResultSuccess();
 }
 
+/// Per-edge state of the truss decomposition, indexed by edge id. Each
+/// undirected edge is represented by its direction from the smaller to the
+/// larger node, its canonical edge.
+class TrussDecomposition {
+public:
+  using Edge = katana::GraphTopology::Edge;
+
+  explicit TrussDecomposition(const katana::PropertyGraph* pg)
+      : pg_(pg), topology_(pg->topology()) {}
+
+  /// Compute the trussness of every edge. Edges must be sorted by
+  /// destination and the graph must be symmetric.
+  katana::Result<void> Run();
+
+  uint32_t trussness(Edge e) const { return trussness_[Canonical(e)]; }
+
+private:
+  static constexpr uint32_t kAlive = std::numeric_limits<uint32_t>::max();
+
+  /// \returns the canonical edge of e; self loops are their own
+  Edge Canonical(Edge e) const {
+    return src_[e] <= topology_.edge_dest(e) ? e : reverse_[e];
+  }
+
+  bool IsCanonical(Edge e) const { return src_[e] < topology_.edge_dest(e); }
+
+  /// Call fn(e1, e2) with the canonical edges e1 and e2 that close a
+  /// triangle with canonical edge e
+  template <typename F>
+  void ForEachTriangle(Edge e, const F& fn) const;
+
+  katana::Result<void> Initialize();
+  void Peel();
+
+  const katana::PropertyGraph* pg_;
+  const katana::GraphTopology& topology_;
+  /// Source of each edge
+  katana::LargeArray<GNode> src_;
+  /// The edge in the opposite direction of each edge
+  katana::LargeArray<Edge> reverse_;
+  /// Triangles of each canonical edge among the edges that are not peeled
+  katana::LargeArray<std::atomic<uint32_t>> support_;
+  /// Round in which each canonical edge is peeled, or kAlive
+  katana::LargeArray<std::atomic<uint32_t>> peel_round_;
+  /// Trussness of each canonical edge
+  katana::LargeArray<uint32_t> trussness_;
+};
+
+template <typename F>
+void
+TrussDecomposition::ForEachTriangle(Edge e, const F& fn) const {
+  GNode u = src_[e];
+  GNode v = topology_.edge_dest(e);
+  const GNode* dests = topology_.edge_dests();
+  auto u_edges = topology_.edges(u);
+  auto v_edges = topology_.edges(v);
+  Edge u_first = *u_edges.begin();
+  Edge v_first = *v_edges.begin();
+  katana::ForEachSortedIntersection(
+      dests + u_first, u_edges.size(), dests + v_first, v_edges.size(),
+      [&](size_t u_pos, size_t v_pos) {
+        GNode w = dests[u_first + u_pos];
+        if (w != u && w != v) {
+          fn(Canonical(u_first + u_pos), Canonical(v_first + v_pos));
+        }
+        return true;
+      });
+}
+
+katana::Result<void>
+TrussDecomposition::Initialize() {
+  uint64_t num_edges = topology_.num_edges();
+  src_.allocateBlocked(num_edges);
+  reverse_.allocateBlocked(num_edges);
+  support_.allocateBlocked(num_edges);
+  peel_round_.allocateBlocked(num_edges);
+  trussness_.allocateBlocked(num_edges);
+
+  katana::do_all(
+      katana::iterate(topology_),
+      [&](GNode n) {
+        for (auto e : topology_.edges(n)) {
+          src_[e] = n;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  //! The only searches: one per edge, for the edge in the other direction.
+  std::atomic<bool> symmetric{true};
+  katana::do_all(
+      katana::iterate(topology_),
+      [&](GNode n) {
+        for (auto e : topology_.edges(n)) {
+          GNode dest = topology_.edge_dest(e);
+          Edge r = katana::FindEdgeSortedByDest(pg_, dest, n);
+          if (r == *topology_.edges(dest).end()) {
+            symmetric = false;
+          }
+          reverse_[e] = r;
+        }
+      },
+      katana::steal(), katana::loopname("KTruss Reverse Edges"),
+      katana::no_stats());
+  if (!symmetric) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "truss decomposition requires a symmetric graph");
+  }
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](Edge e) {
+        uint32_t support = 0;
+        if (IsCanonical(e)) {
+          ForEachTriangle(e, [&](Edge, Edge) { ++support; });
+        }
+        new (&support_[e]) std::atomic<uint32_t>(support);
+        new (&peel_round_[e]) std::atomic<uint32_t>(kAlive);
+        //! Edges on no triangle, and self loops, are in the 2-truss only.
+        trussness_[e] = 2;
+      },
+      katana::steal(), katana::loopname("KTruss Support"), katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+/// Peel edges in rounds of increasing support level. Each round removes the
+/// edges of support at most the level, which have trussness level + 2, and
+/// decrements the support of the other two edges of each of their triangles.
+/// A triangle with more than one edge in the round is handled by its
+/// smallest such edge, and a triangle that lost an edge in an earlier round
+/// no longer counts.
+void
+TrussDecomposition::Peel() {
+  auto buckets = katana::MakePeelingBuckets<Edge>(
+      [this](Edge e) { return support_[e].load(std::memory_order_relaxed); },
+      [this](Edge e) {
+        return peel_round_[e].load(std::memory_order_relaxed) != kAlive;
+      });
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topology_.num_edges()),
+      [&](Edge e) {
+        if (IsCanonical(e)) {
+          buckets.Insert(e);
+        }
+      },
+      katana::no_stats());
+
+  katana::InsertBag<Edge> current;
+  katana::InsertBag<Edge> next;
+  uint32_t level = 0;
+  uint32_t round = 0;
+
+  auto push = [&](Edge e) {
+    peel_round_[e] = round;
+    current.push(e);
+  };
+  while (!katana::IsCancelled() && buckets.NextLevel(&level, push)) {
+    while (!current.empty()) {
+      katana::do_all(
+          katana::iterate(current),
+          [&](Edge e) {
+            trussness_[e] = level + 2;
+            ForEachTriangle(e, [&](Edge e1, Edge e2) {
+              uint32_t round1 = peel_round_[e1];
+              uint32_t round2 = peel_round_[e2];
+              if (round1 < round || round2 < round ||
+                  (round1 == round && e1 < e) || (round2 == round && e2 < e)) {
+                return;
+              }
+              for (Edge other : {e1, e2}) {
+                if (peel_round_[other] == round) {
+                  continue;
+                }
+                auto& support = support_[other];
+                uint32_t old_support = support.load();
+                while (old_support > level &&
+                       !support.compare_exchange_weak(
+                           old_support, old_support - 1))
+                  ;
+                if (old_support == level + 1) {
+                  //! Dropped to the level: peel it in the next round.
+                  peel_round_[other] = round + 1;
+                  next.push(other);
+                } else if (old_support > level + 1) {
+                  buckets.Update(other, old_support - 1);
+                }
+              }
+            });
+          },
+          katana::steal(), katana::loopname("KTruss Peel"));
+      current.clear();
+      current.swap(next);
+      ++round;
+    }
+  }
+}
+
+katana::Result<void>
+TrussDecomposition::Run() {
+  if (auto r = Initialize(); !r) {
+    return r.error();
+  }
+  Peel();
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+KTrussDecompositionAlgo(katana::PropertyGraph* pg, Graph* g, uint32_t k) {
+  if (k <= 2) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  TrussDecomposition decomposition(pg);
+  if (auto r = decomposition.Run(); !r) {
+    return r.error();
+  }
+
+  katana::do_all(
+      katana::iterate(*g),
+      [&](GNode n) {
+        for (auto e : g->edges(n)) {
+          g->template GetEdgeData<EdgeFlag>(e) =
+              decomposition.trussness(e) < k ? removed : valid;
+        }
+      },
+      katana::steal());
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::analytics::KTruss(
     katana::PropertyGraph* pg, uint32_t k_truss_number,
@@ -347,8 +591,11 @@ katana::analytics::KTruss(
   }
 
   // TODO(amp): Don't mutate the users topology!
-  auto result = katana::SortAllEdgesByDest(pg);
-  if (!result) {
+  if (auto result = katana::EnsureAllEdgesSortedByDest(pg); !result) {
+    return result.error();
+  }
+  // Removing an edge finds its reverse by FindEdgeSortedByDest
+  if (auto result = pg->GetEdgeExistenceIndex(); !result) {
     return result.error();
   }
 
@@ -363,16 +610,430 @@ katana::analytics::KTruss(
   katana::StatTimer exec_time("KTruss");
   exec_time.start();
 
+  katana::Result<void> r = katana::ResultSuccess();
   switch (plan.algorithm()) {
   case KTrussPlan::kBsp:
-    return BSPTrussAlgo(&graph, k_truss_number);
+    r = BSPTrussAlgo(&graph, k_truss_number);
+    break;
   case KTrussPlan::kBspJacobi:
-    return BSPTrussJacobiAlgo(&graph, k_truss_number);
+    r = BSPTrussJacobiAlgo(&graph, k_truss_number);
+    break;
   case KTrussPlan::kBspCoreThenTruss:
-    return BSPCoreThenTrussAlgo(&graph, k_truss_number);
+    r = BSPCoreThenTrussAlgo(&graph, k_truss_number);
+    break;
+  case KTrussPlan::kDecomposition:
+    r = KTrussDecompositionAlgo(pg, &graph, k_truss_number);
+    break;
   default:
     return katana::ErrorCode::InvalidArgument;
   }
+
+  if (r && katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return r;
+}
+
+katana::Result<void>
+katana::analytics::KTrussDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  if (auto result = ConstructEdgeProperties<std::tuple<EdgeTrussness>>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  // TODO(amp): Don't mutate the users topology!
+  if (auto result = katana::EnsureAllEdgesSortedByDest(pg); !result) {
+    return result.error();
+  }
+  // Removing an edge finds its reverse by FindEdgeSortedByDest
+  if (auto result = pg->GetEdgeExistenceIndex(); !result) {
+    return result.error();
+  }
+
+  auto pg_result = TrussnessGraph::Make(pg, {}, {output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  katana::StatTimer exec_time("KTrussDecomposition");
+  exec_time.start();
+
+  TrussDecomposition decomposition(pg);
+  if (auto r = decomposition.Run(); !r) {
+    return r.error();
+  }
+
+  exec_time.stop();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.edges(n)) {
+          graph.GetEdgeData<EdgeTrussness>(e) = decomposition.trussness(e);
+        }
+      },
+      katana::steal());
+  return katana::ResultSuccess();
+}
+
+/// Maintains trussness across a batch of edge updates, as CoreMaintenance
+/// in k_core.cpp maintains coreness, by the local h-index characterization
+/// of trussness: trussness is the largest assignment of values to edges in
+/// which each edge of value t is on at least t - 2 triangles whose other
+/// edges have values of at least t.
+///
+/// Deletions lower values on the graph without the inserted edges, starting
+/// from the edges that were on triangles with a deleted edge. Insertions
+/// raise values in rounds, starting from the inserted edges, the edges on
+/// triangles with them, and the edges that rose in earlier rounds and the
+/// edges on triangles with those. Each undirected edge is represented by its
+/// canonical edge, from the smaller to the larger node, as in
+/// TrussDecomposition; the others are set to match at the end.
+class TrussMaintenance {
+public:
+  using Edge = katana::GraphTopology::Edge;
+
+  TrussMaintenance(const katana::PropertyGraph* pg, AtomicTrussnessGraph* graph)
+      : pg_(pg), topology_(pg->topology()), graph_(graph) {}
+
+  /// Find the inserted edges in the graph, in both directions, and set
+  /// their values to 2
+  katana::Result<void> MarkInserted(
+      const std::vector<std::pair<GNode, GNode>>& inserted);
+
+  /// Lower the values after deleting edges, ignoring the inserted edges
+  void Delete(const std::vector<std::pair<GNode, GNode>>& deleted);
+
+  /// Raise the values after inserting the edges marked inserted
+  void Insert();
+
+  /// Set the values of the edges in the other direction of changed
+  /// canonical edges
+  void Finish();
+
+private:
+  std::atomic<uint32_t>& Value(Edge e) {
+    return graph_->GetEdgeData<EdgeAtomicTrussness>(
+        AtomicTrussnessGraph::edge_iterator(e));
+  }
+
+  GNode Source(Edge e) const {
+    const uint64_t* indices = topology_.out_indices->raw_values();
+    return std::upper_bound(indices, indices + topology_.num_nodes(), e) -
+           indices;
+  }
+
+  Edge Canonical(Edge e, GNode src) const {
+    GNode dest = topology_.edge_dest(e);
+    return src <= dest ? e : katana::FindEdgeSortedByDest(pg_, dest, src);
+  }
+
+  /// Whether e was an edge of the graph before the insertions
+  bool IsOld(Edge e) const {
+    return inserted_.size() == 0 || !inserted_.test(e);
+  }
+
+  /// Call fn(e1, e2) with the canonical edges e1 and e2 from u and from v
+  /// to each common neighbor of u and v
+  template <typename F>
+  void ForEachCommonNeighbor(
+      GNode u, GNode v, bool with_inserted, const F& fn) const;
+
+  /// Call fn(e1, e2) with the canonical edges e1 and e2 that close a
+  /// triangle with canonical edge e
+  template <typename F>
+  void ForEachTriangle(Edge e, bool with_inserted, const F& fn) const {
+    ForEachCommonNeighbor(Source(e), topology_.edge_dest(e), with_inserted, fn);
+  }
+
+  /// Two plus the h-index of the least values of the other edges of the
+  /// triangles of e, at most the value of e
+  uint32_t HIndex(Edge e, bool with_inserted);
+
+  /// Whether the value of e could rise, i.e., whether e is on more than its
+  /// value minus 2 triangles whose other edges have at least its value
+  bool CanRise(Edge e);
+
+  /// Lower the values of seeds, and transitively of the edges on triangles
+  /// with them, to their h-indices
+  void Lower(katana::InsertBag<Edge>* seeds, bool with_inserted);
+
+  const katana::PropertyGraph* pg_;
+  const katana::GraphTopology& topology_;
+  AtomicTrussnessGraph* graph_;
+  katana::DynamicBitset inserted_;
+  /// The canonical inserted edges that are not self loops
+  katana::InsertBag<Edge> inserted_edges_;
+  /// Canonical edges whose value changed
+  katana::InsertBag<Edge> changed_;
+  katana::PerThreadStorage<std::vector<uint32_t>> counts_;
+};
+
+template <typename F>
+void
+TrussMaintenance::ForEachCommonNeighbor(
+    GNode u, GNode v, bool with_inserted, const F& fn) const {
+  const GNode* dests = topology_.edge_dests();
+  auto u_edges = topology_.edges(u);
+  auto v_edges = topology_.edges(v);
+  Edge u_first = *u_edges.begin();
+  Edge v_first = *v_edges.begin();
+  katana::ForEachSortedIntersection(
+      dests + u_first, u_edges.size(), dests + v_first, v_edges.size(),
+      [&](size_t u_pos, size_t v_pos) {
+        GNode w = dests[u_first + u_pos];
+        Edge uw = u_first + u_pos;
+        Edge vw = v_first + v_pos;
+        if (w != u && w != v && (with_inserted || (IsOld(uw) && IsOld(vw)))) {
+          fn(Canonical(uw, u), Canonical(vw, v));
+        }
+        return true;
+      });
+}
+
+katana::Result<void>
+TrussMaintenance::MarkInserted(
+    const std::vector<std::pair<GNode, GNode>>& inserted) {
+  inserted_.resize(topology_.num_edges());
+  std::atomic<bool> found{true};
+  katana::do_all(
+      katana::iterate(inserted),
+      [&](const std::pair<GNode, GNode>& edge) {
+        auto [src, dst] = edge;
+        Edge e = katana::FindEdgeSortedByDest(pg_, src, dst);
+        Edge r = katana::FindEdgeSortedByDest(pg_, dst, src);
+        if (e == *topology_.edges(src).end() ||
+            r == *topology_.edges(dst).end()) {
+          found = false;
+          return;
+        }
+        inserted_.set(e);
+        inserted_.set(r);
+        Value(e) = 2;
+        Value(r) = 2;
+        if (src != dst) {
+          inserted_edges_.push(src < dst ? e : r);
+        }
+      },
+      katana::no_stats());
+  if (!found) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "inserted edges must be edges of the graph in both directions");
+  }
+  return katana::ResultSuccess();
+}
+
+uint32_t
+TrussMaintenance::HIndex(Edge e, bool with_inserted) {
+  //! An edge is on fewer triangles than its destination has edges.
+  uint32_t value = std::min<uint64_t>(
+      Value(e), topology_.edges(topology_.edge_dest(e)).size() + 2);
+  std::vector<uint32_t>& counts = *counts_.getLocal();
+  counts.assign(value + 1, 0);
+  ForEachTriangle(e, with_inserted, [&](Edge e1, Edge e2) {
+    counts[std::min({Value(e1).load(), Value(e2).load(), value})] += 1;
+  });
+  uint32_t at_least = 0;
+  for (uint32_t t = value; t > 2; --t) {
+    at_least += counts[t];
+    if (at_least + 2 >= t) {
+      return t;
+    }
+  }
+  return 2;
+}
+
+bool
+TrussMaintenance::CanRise(Edge e) {
+  uint32_t value = Value(e);
+  uint32_t at_least = 0;
+  ForEachTriangle(e, true, [&](Edge e1, Edge e2) {
+    at_least += std::min(Value(e1).load(), Value(e2).load()) >= value;
+  });
+  return at_least + 2 > value;
+}
+
+void
+TrussMaintenance::Lower(katana::InsertBag<Edge>* seeds, bool with_inserted) {
+  katana::for_each(
+      katana::iterate(*seeds),
+      [&](Edge e, auto& ctx) {
+        uint32_t h = HIndex(e, with_inserted);
+        if (katana::atomicMin(Value(e), h) <= h) {
+          return;
+        }
+        changed_.push(e);
+        //! Only the edges of value above h may have counted e.
+        ForEachTriangle(e, with_inserted, [&](Edge e1, Edge e2) {
+          for (Edge other : {e1, e2}) {
+            if (Value(other) > h) {
+              ctx.push(other);
+            }
+          }
+        });
+      },
+      katana::disable_conflict_detection(),
+      katana::loopname("KTruss Incremental Lower"));
+}
+
+void
+TrussMaintenance::Delete(const std::vector<std::pair<GNode, GNode>>& deleted) {
+  katana::InsertBag<Edge> seeds;
+  katana::do_all(
+      katana::iterate(deleted),
+      [&](const std::pair<GNode, GNode>& edge) {
+        if (edge.first == edge.second) {
+          return;
+        }
+        //! The edges left of the triangles of the deleted edge
+        ForEachCommonNeighbor(
+            edge.first, edge.second, false, [&](Edge e1, Edge e2) {
+              seeds.push(e1);
+              seeds.push(e2);
+            });
+      },
+      katana::steal(), katana::no_stats());
+  Lower(&seeds, false);
+}
+
+void
+TrussMaintenance::Insert() {
+  katana::DynamicBitset visited;
+  visited.resize(topology_.num_edges());
+  katana::DynamicBitset risen;
+  risen.resize(topology_.num_edges());
+  katana::InsertBag<Edge> risen_edges;
+
+  while (!katana::IsCancelled()) {
+    katana::InsertBag<Edge> seeds;
+    auto push_with_triangles = [&](Edge e) {
+      seeds.push(e);
+      ForEachTriangle(e, true, [&](Edge e1, Edge e2) {
+        seeds.push(e1);
+        seeds.push(e2);
+      });
+    };
+    katana::do_all(
+        katana::iterate(inserted_edges_), push_with_triangles, katana::steal(),
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(risen_edges), push_with_triangles, katana::steal(),
+        katana::no_stats());
+
+    //! Values do not change until every candidate is found.
+    katana::InsertBag<Edge> candidates;
+    katana::InsertBag<std::pair<Edge, uint32_t>> old_values;
+    katana::for_each(
+        katana::iterate(seeds),
+        [&](Edge e, auto& ctx) {
+          if (visited.test(e) || !CanRise(e) || visited.set(e)) {
+            return;
+          }
+          uint32_t value = Value(e);
+          candidates.push(e);
+          old_values.push(std::make_pair(e, value));
+          ForEachTriangle(e, true, [&](Edge e1, Edge e2) {
+            for (Edge other : {e1, e2}) {
+              if (!visited.test(other) && Value(other) == value) {
+                ctx.push(other);
+              }
+            }
+          });
+        },
+        katana::disable_conflict_detection(),
+        katana::loopname("KTruss Incremental Candidates"));
+
+    katana::do_all(
+        katana::iterate(candidates), [&](Edge e) { Value(e) += 1; },
+        katana::no_stats());
+    Lower(&candidates, true);
+
+    katana::GAccumulator<uint64_t> rose;
+    katana::do_all(
+        katana::iterate(old_values),
+        [&](const std::pair<Edge, uint32_t>& old_value) {
+          auto [e, value] = old_value;
+          visited.reset(e);
+          if (Value(e) > value) {
+            rose += 1;
+            changed_.push(e);
+            if (!risen.set(e)) {
+              risen_edges.push(e);
+            }
+          }
+        },
+        katana::no_stats());
+    if (rose.reduce() == 0) {
+      break;
+    }
+  }
+}
+
+void
+TrussMaintenance::Finish() {
+  katana::do_all(
+      katana::iterate(changed_),
+      [&](Edge e) {
+        GNode src = Source(e);
+        Value(katana::FindEdgeSortedByDest(pg_, topology_.edge_dest(e), src)) =
+            Value(e).load();
+      },
+      katana::no_stats());
+}
+
+katana::Result<void>
+katana::analytics::KTrussDecompositionIncremental(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges) {
+  if (!pg->edges_sorted_by_dest()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edges must be sorted by destination, e.g., by SortAllEdgesByDest");
+  }
+
+  auto pg_result = AtomicTrussnessGraph::Make(pg, {}, {property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  for (const auto* edges : {&inserted_edges, &deleted_edges}) {
+    for (const auto& [src, dst] : *edges) {
+      if (src >= graph.size() || dst >= graph.size()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "edge ({}, {}) is not between nodes of the graph", src, dst);
+      }
+    }
+  }
+
+  katana::StatTimer exec_time("KTrussDecompositionIncremental");
+  exec_time.start();
+
+  TrussMaintenance maintenance(pg, &graph);
+  if (!inserted_edges.empty()) {
+    if (auto r = maintenance.MarkInserted(inserted_edges); !r) {
+      return r.error();
+    }
+  }
+  if (!deleted_edges.empty()) {
+    maintenance.Delete(deleted_edges);
+  }
+  if (!inserted_edges.empty()) {
+    maintenance.Insert();
+  }
+  maintenance.Finish();
+  exec_time.stop();
+
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return katana::ResultSuccess();
 }
 
 // Doxygen doesn't correctly handle implementation annotations that do not
@@ -414,11 +1075,128 @@ katana::analytics::KTrussStatistics::Compute(
       },
       katana::loopname("KTruss sanity check"), katana::no_stats());
 
-  return KTrussStatistics{alive_edges.reduce()};
+  return KTrussStatistics{alive_edges.reduce(), {}};
+}
+
+katana::Result<void>
+katana::analytics::KTrussDecompositionAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = TrussnessGraph::Make(pg, {}, {property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  const GNode* dests = pg->topology().edge_dests();
+
+  auto is_bad = [&](const GNode& src) {
+    for (auto e : graph.edges(src)) {
+      GNode dest = *graph.GetEdgeDest(e);
+      if (dest <= src) {
+        continue;
+      }
+      uint32_t trussness = graph.GetEdgeData<EdgeTrussness>(e);
+      auto src_edges = graph.edges(src);
+      auto dst_edges = graph.edges(dest);
+      auto src_first = *src_edges.begin();
+      auto dst_first = *dst_edges.begin();
+      uint32_t at_least = 0;
+      uint32_t above = 0;
+      katana::ForEachSortedIntersection(
+          dests + src_first, src_edges.size(), dests + dst_first,
+          dst_edges.size(), [&](size_t src_pos, size_t dst_pos) {
+            GNode w = dests[src_first + src_pos];
+            if (w != src && w != dest) {
+              uint32_t t = std::min(
+                  graph.GetEdgeData<EdgeTrussness>(
+                      Graph::edge_iterator(src_first + src_pos)),
+                  graph.GetEdgeData<EdgeTrussness>(
+                      Graph::edge_iterator(dst_first + dst_pos)));
+              at_least += t >= trussness;
+              above += t > trussness;
+            }
+            return true;
+          });
+      if (at_least + 2 < trussness || above + 1 > trussness) {
+        KATANA_LOG_DEBUG(
+            "edge {} -> {} has trussness {} but {} triangles of at least "
+            "that and {} above",
+            src, dest, trussness, at_least, above);
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if (katana::ParallelSTL::find_if(graph.begin(), graph.end(), is_bad) !=
+      graph.end()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<KTrussStatistics>
+katana::analytics::KTrussStatistics::ComputeDecomposition(
+    katana::PropertyGraph* pg, uint32_t k_truss_number,
+    const std::string& property_name) {
+  auto pg_result = TrussnessGraph::Make(pg, {}, {property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  //! Count each undirected edge once.
+  constexpr uint32_t kReverse = std::numeric_limits<uint32_t>::max();
+  const GNode* dests = pg->topology().edge_dests();
+  std::vector<uint32_t> keys(pg->topology().num_edges());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.edges(n)) {
+          keys[e] = n < dests[e] ? graph.GetEdgeData<EdgeTrussness>(e)
+                                   : kReverse;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  auto counts = katana::ParallelSTL::group_by(
+      keys.begin(), keys.end(), [](uint32_t key) { return key; });
+
+  uint32_t max_trussness = 0;
+  for (const auto& x : counts) {
+    if (x.key != kReverse) {
+      max_trussness = std::max(max_trussness, x.key);
+    }
+  }
+
+  KTrussStatistics stats{0, {}};
+  for (const auto& x : counts) {
+    if (x.key == kReverse) {
+      continue;
+    }
+    if (stats.trussness_histogram.empty()) {
+      stats.trussness_histogram.resize(uint64_t{max_trussness} + 1);
+    }
+    stats.trussness_histogram[x.key] = x.count;
+    if (x.key >= k_truss_number) {
+      stats.number_of_edges_left += x.count;
+    }
+  }
+  return stats;
 }
 /// \endcond DO_NOT_DOCUMENT
 
 void
 katana::analytics::KTrussStatistics::Print(std::ostream& os) const {
   os << "Number of nodes in the core = " << number_of_edges_left << std::endl;
+  if (!trussness_histogram.empty()) {
+    os << "Largest trussness = " << trussness_histogram.size() - 1
+       << std::endl;
+    os << "Number of edges by trussness:" << std::endl;
+    for (size_t k = 0; k < trussness_histogram.size(); ++k) {
+      if (trussness_histogram[k] != 0) {
+        os << "  " << k << " = " << trussness_histogram[k] << std::endl;
+      }
+    }
+  }
 }
@@ -0,0 +1,339 @@
+#include "katana/analytics/label_propagation/label_propagation.h"
+
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+#include "katana/CompactTopology.h"
+#include "katana/Frontier.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+struct NodeLabel : public katana::PODProperty<uint64_t> {};
+
+/// A thread's table from label to the number of neighbors with it. A slot
+/// holds the stamp of the node that filled it in its upper 32 bits and the
+/// count in the lower ones, so that the table never needs to be cleared.
+struct LabelCounts {
+  std::vector<Node> labels;
+  std::vector<uint64_t> slots;
+  uint32_t stamp{0};
+  uint32_t shift{64};
+
+  /// Prepare for a node with at most \p max_labels distinct labels
+  void Start(uint64_t max_labels) {
+    uint32_t bits = 4;
+    while ((uint64_t{1} << bits) < 2 * max_labels) {
+      ++bits;
+    }
+    if (slots.size() < (uint64_t{1} << bits)) {
+      labels.resize(uint64_t{1} << bits);
+      slots.assign(uint64_t{1} << bits, 0);
+      stamp = 0;
+    }
+    if (++stamp == 0) {
+      std::fill(slots.begin(), slots.end(), 0);
+      stamp = 1;
+    }
+    shift = 64 - bits;
+  }
+
+  /// Count one more neighbor with \p label; \returns its count so far
+  uint32_t Add(Node label) {
+    uint64_t mask = (uint64_t{1} << (64 - shift)) - 1;
+    for (uint64_t slot = (label * 0x9e3779b97f4a7c15ULL) >> shift;;
+         slot = (slot + 1) & mask) {
+      uint64_t entry = slots[slot];
+      if (entry >> 32 != stamp) {
+        labels[slot] = label;
+        slots[slot] = uint64_t{stamp} << 32 | 1;
+        return 1;
+      }
+      if (labels[slot] == label) {
+        slots[slot] = entry + 1;
+        return (entry & 0xffffffff) + 1;
+      }
+    }
+  }
+};
+
+/// \returns the label most frequent among the neighbors of \p n, the
+/// smallest one on ties, or \p current if \p n has no neighbors other than
+/// itself
+template <typename Topology, typename LabelFn>
+Node
+MostFrequentLabel(
+    const Topology& topology, Node n, Node current,
+    LabelFn label_of, LabelCounts* counts) {
+  const Node* dests = topology.edge_dests();
+  auto edges = topology.edges(n);
+  counts->Start(edges.size());
+
+  Node best = current;
+  uint32_t best_count = 0;
+  for (auto e : edges) {
+    Node dst = dests[e];
+    if (dst == n) {
+      continue;
+    }
+    Node label = label_of(dst);
+    uint32_t count = counts->Add(label);
+    if (count > best_count || (count == best_count && label < best)) {
+      best = label;
+      best_count = count;
+    }
+  }
+  return best;
+}
+
+/// Frontier-restricted rounds of label propagation. In each round, \p update
+/// evaluates every node of the frontier, then \p commit returns whether its
+/// label changed. The neighbors of changed nodes, each pushed once, form
+/// the next frontier, which is dense or sparse as its size calls for.
+template <typename Topology, typename UpdateFn, typename CommitFn>
+void
+PropagateLabels(
+    const Topology& topology, uint32_t max_iterations,
+    UpdateFn update, CommitFn commit) {
+  const Node* dests = topology.edge_dests();
+  katana::Frontier frontier(topology.num_nodes());
+  katana::Frontier next_frontier(topology.num_nodes());
+  // The last round that pushed each node, so sparse frontiers hold no
+  // duplicates
+  std::vector<std::atomic<uint32_t>> pushed(topology.num_nodes());
+
+  frontier.Fill();
+  for (uint32_t round = 1; round <= max_iterations && !frontier.empty();
+       ++round) {
+    frontier.ForEach(update, "LabelPropagation");
+    frontier.ForEach(
+        [&](Node n) {
+          if (!commit(n)) {
+            return;
+          }
+          for (auto e : topology.edges(n)) {
+            Node dst = dests[e];
+            if (pushed[dst].load(std::memory_order_relaxed) != round &&
+                pushed[dst].exchange(round) != round) {
+              next_frontier.push(dst);
+            }
+          }
+        },
+        "LabelPropagation-Push");
+
+    frontier.swap(next_frontier);
+    frontier.Adapt();
+    next_frontier.clear();
+  }
+}
+
+template <typename Topology>
+void
+SynchronousLabelPropagation(
+    const Topology& topology, uint32_t max_iterations,
+    std::vector<Node>* labels) {
+  std::vector<Node> next_labels(*labels);
+  katana::PerThreadStorage<LabelCounts> counts;
+  PropagateLabels(
+      topology, max_iterations,
+      [&](Node n) {
+        next_labels[n] = MostFrequentLabel(
+            topology, n, (*labels)[n], [&](Node m) { return (*labels)[m]; },
+            counts.getLocal());
+      },
+      // No node reads the labels of others until the next round
+      [&](Node n) {
+        if (next_labels[n] == (*labels)[n]) {
+          return false;
+        }
+        (*labels)[n] = next_labels[n];
+        return true;
+      });
+}
+
+template <typename Topology>
+void
+AsynchronousLabelPropagation(
+    const Topology& topology, uint32_t max_iterations,
+    std::vector<Node>* labels) {
+  std::vector<std::atomic<Node>> current(labels->size());
+  katana::do_all(
+      katana::iterate(topology), [&](Node n) { current[n] = (*labels)[n]; },
+      katana::no_stats());
+
+  // Whether the label of each node changed in this round
+  std::vector<uint8_t> changed(labels->size());
+  katana::PerThreadStorage<LabelCounts> counts;
+  PropagateLabels(
+      topology, max_iterations,
+      [&](Node n) {
+        Node old_label = current[n].load(std::memory_order_relaxed);
+        Node label = MostFrequentLabel(
+            topology, n, old_label,
+            [&](Node m) { return current[m].load(std::memory_order_relaxed); },
+            counts.getLocal());
+        changed[n] = label != old_label;
+        current[n].store(label, std::memory_order_relaxed);
+      },
+      [&](Node n) { return changed[n] != 0; });
+
+  katana::do_all(
+      katana::iterate(topology), [&](Node n) { (*labels)[n] = current[n]; },
+      katana::no_stats());
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::LabelPropagation(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    LabelPropagationPlan plan) {
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<Node> labels(topology.num_nodes());
+  std::iota(labels.begin(), labels.end(), Node{0});
+
+  if (plan.algorithm() != LabelPropagationPlan::kSynchronous &&
+      plan.algorithm() != LabelPropagationPlan::kAsynchronous) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        static_cast<int>(plan.algorithm()));
+  }
+
+  katana::StatTimer exec_time("LabelPropagation");
+  exec_time.start();
+  // Every round reads the edge offsets of the frontier
+  katana::WithCompactTopology(topology, [&](const auto& compact) {
+    if (plan.algorithm() == LabelPropagationPlan::kSynchronous) {
+      SynchronousLabelPropagation(compact, plan.max_iterations(), &labels);
+    } else {
+      AsynchronousLabelPropagation(compact, plan.max_iterations(), &labels);
+    }
+  });
+  exec_time.stop();
+
+  if (auto r = ConstructNodeProperties<std::tuple<NodeLabel>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto graph_result =
+      katana::TypedPropertyGraph<std::tuple<NodeLabel>, std::tuple<>>::Make(
+          pg, {output_property_name}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  auto graph = graph_result.value();
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) { graph.GetData<NodeLabel>(n) = labels[n]; },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::LabelPropagationAssertValid(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto labels_result = pg->GetNodePropertyTyped<uint64_t>(output_property_name);
+  if (!labels_result) {
+    return labels_result.error();
+  }
+  auto labels = labels_result.value();
+  const katana::GraphTopology& topology = pg->topology();
+  const Node* dests = topology.edge_dests();
+
+  auto is_bad = [&](Node n) {
+    uint64_t label = labels->Value(n);
+    if (label >= topology.num_nodes()) {
+      KATANA_LOG_DEBUG("{} has label {}, which is not a node", n, label);
+      return true;
+    }
+    for (auto e : topology.edges(n)) {
+      if (dests[e] != n) {
+        return false;
+      }
+    }
+    if (label != n) {
+      KATANA_LOG_DEBUG("isolated node {} has label {}", n, label);
+      return true;
+    }
+    return false;
+  };
+
+  std::vector<Node> nodes(topology.num_nodes());
+  std::iota(nodes.begin(), nodes.end(), Node{0});
+  if (katana::ParallelSTL::find_if(nodes.begin(), nodes.end(), is_bad) !=
+      nodes.end()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<LabelPropagationStatistics>
+katana::analytics::LabelPropagationStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto graph_result =
+      katana::TypedPropertyGraph<std::tuple<NodeLabel>, std::tuple<>>::Make(
+          pg, {output_property_name}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  auto graph = graph_result.value();
+
+  auto communities = katana::ParallelSTL::group_by(
+      graph.begin(), graph.end(),
+      [&](const Node& x) { return graph.GetData<NodeLabel>(x); });
+  size_t reps = communities.size();
+
+  using CommunitySizePair = std::pair<uint64_t, int>;
+
+  auto sizeMax = [](const CommunitySizePair& a, const CommunitySizePair& b) {
+    if (a.second > b.second) {
+      return a;
+    }
+    return b;
+  };
+
+  auto identity = []() { return CommunitySizePair{}; };
+
+  auto maxComp = katana::make_reducible(sizeMax, identity);
+
+  katana::GAccumulator<uint64_t> non_trivial_communities;
+  katana::do_all(katana::iterate(communities), [&](const auto& x) {
+    maxComp.update(CommunitySizePair(x.key, x.count));
+    if (x.count > 1) {
+      non_trivial_communities += 1;
+    }
+  });
+
+  CommunitySizePair largest = maxComp.reduce();
+
+  // Compensate for dropping representative node of communities
+  size_t largest_community_size = largest.second + 1;
+  double largest_community_ratio = 0;
+  if (!graph.empty()) {
+    largest_community_ratio = double(largest_community_size) / graph.size();
+  }
+
+  return LabelPropagationStatistics{
+      reps, non_trivial_communities.reduce(), largest_community_size,
+      largest_community_ratio};
+}
+
+void
+katana::analytics::LabelPropagationStatistics::Print(std::ostream& os) const {
+  os << "Total number of communities = " << n_communities << std::endl;
+  os << "Total number of non trivial communities = "
+     << n_non_trivial_communities << std::endl;
+  os << "Number of nodes in the largest community = " << largest_community_size
+     << std::endl;
+  os << "Ratio of nodes in the largest community = " << largest_community_ratio
+     << std::endl;
+}
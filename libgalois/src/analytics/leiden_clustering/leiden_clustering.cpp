@@ -0,0 +1,777 @@
+#include "katana/analytics/leiden_clustering/leiden_clustering.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Cancellation.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/ClusteringImplementationBase.h"
+#include "katana/analytics/louvain_clustering/louvain_clustering.h"
+
+using namespace katana::analytics;
+namespace {
+
+/// Label each node with the smallest node of its cluster that it reaches
+/// through edges inside the cluster. Nodes whose cluster is UNASSIGNED
+/// keep their own ids. The graph must be symmetric.
+template <typename ClusterFn>
+void
+LabelClusterComponents(
+    const katana::GraphTopology& topology, ClusterFn cluster_of,
+    katana::LargeArray<std::atomic<uint64_t>>* labels) {
+  constexpr uint64_t kUnassigned = std::numeric_limits<uint64_t>::max();
+  const uint32_t* dests = topology.edge_dests();
+
+  katana::do_all(
+      katana::iterate(topology),
+      [&](uint32_t n) { (*labels)[n] = n; }, katana::no_stats());
+
+  bool changed = true;
+  while (changed) {
+    katana::GReduceLogicalOr any_changed;
+    katana::do_all(
+        katana::iterate(topology),
+        [&](uint32_t n) {
+          uint64_t cluster = cluster_of(n);
+          if (cluster == kUnassigned) {
+            return;
+          }
+          uint64_t label = (*labels)[n];
+          for (auto e : topology.edges(n)) {
+            uint32_t dst = dests[e];
+            if (cluster_of(dst) == cluster) {
+              label = std::min(label, (*labels)[dst].load());
+            }
+          }
+          if (label < (*labels)[n]) {
+            katana::atomicMin((*labels)[n], label);
+            any_changed.update(true);
+          }
+        },
+        katana::steal(), katana::loopname("Leiden: Label components"));
+    changed = any_changed.reduce();
+  }
+}
+
+/// A refined subcommunity. Its id is the node that founded it, which never
+/// leaves it.
+template <typename EdgeWeightType>
+struct SubCommunityType {
+  enum State : uint8_t {
+    /// The founder is alone and may still join another subcommunity
+    kSingleton,
+    /// Another node joined the founder, which stays
+    kJoined,
+    /// The founder joined another subcommunity; this one is empty
+    kMoved,
+  };
+
+  std::atomic<EdgeWeightType> degree_wt;
+  /// Weight of the edges between the subcommunity and the rest of its
+  /// community
+  std::atomic<EdgeWeightType> external_wt;
+  std::atomic<uint8_t> state;
+};
+
+template <typename EdgeWeightType>
+struct LeidenClusteringImplementation
+    : public katana::analytics::ClusteringImplementationBase<
+          katana::TypedPropertyGraph<
+              std::tuple<
+                  PreviousCommunityId, CurrentCommunityId,
+                  DegreeWeight<EdgeWeightType>>,
+              std::tuple<EdgeWeight<EdgeWeightType>>>,
+          EdgeWeightType, CommunityType<EdgeWeightType>> {
+  using NodeData = std::tuple<
+      PreviousCommunityId, CurrentCommunityId, DegreeWeight<EdgeWeightType>>;
+  using EdgeData = std::tuple<EdgeWeight<EdgeWeightType>>;
+  using CommTy = CommunityType<EdgeWeightType>;
+  using CommunityArray = katana::LargeArray<CommTy>;
+  using SubCommTy = SubCommunityType<EdgeWeightType>;
+
+  using Graph = katana::TypedPropertyGraph<NodeData, EdgeData>;
+  using GNode = typename Graph::Node;
+
+  using Base = katana::analytics::ClusteringImplementationBase<
+      Graph, EdgeWeightType, CommTy>;
+
+  /**
+   * Sums up the degree weight and size of the communities given by
+   * CommunityIdProperty, which need not be singletons.
+   */
+  template <typename CommunityIdProperty>
+  static void SumCommunityDegreeWeight(
+      const Graph& graph, CommunityArray* c_info) {
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      (*c_info)[n].degree_wt = 0;
+      (*c_info)[n].size = 0;
+    });
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      uint64_t c = graph.template GetData<CommunityIdProperty>(n);
+      if (c != Base::UNASSIGNED) {
+        katana::atomicAdd(
+            (*c_info)[c].degree_wt,
+            graph.template GetData<DegreeWeight<EdgeWeightType>>(n));
+        katana::atomicAdd((*c_info)[c].size, (uint64_t)1);
+      }
+    });
+  }
+
+  /**
+   * The local moving phase: the DoAll Louvain rounds, started from the
+   * communities already in CurrentCommunityId rather than from singletons.
+   */
+  katana::Result<double> LeidenMoveNodesDoAll(
+      katana::PropertyGraph* pfg, double lower,
+      double modularity_threshold_per_round, uint32_t& iter) {
+    katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
+    katana::TimerGuard TimerClusteringGuard(TimerClusteringTotal);
+
+    auto graph_result = Graph::Make(pfg);
+    if (!graph_result) {
+      return graph_result.error();
+    }
+    Graph graph = graph_result.value();
+
+    CommunityArray c_info;  // Community info
+
+    /* Variables needed for Modularity calculation */
+    double constant_for_second_term;
+    double prev_mod = lower;
+    double curr_mod = -1;
+    uint32_t num_iter = iter;
+
+    /*** Initialization ***/
+    c_info.allocateBlocked(graph.num_nodes());
+
+    /* Calculate the weighted degree sum for each vertex and community */
+    Base::template SumVertexDegreeWeight<EdgeWeightType>(&graph, c_info);
+    SumCommunityDegreeWeight<CurrentCommunityId>(graph, &c_info);
+
+    /* Compute the total weight (2m) and 1/2m terms */
+    constant_for_second_term =
+        Base::template CalConstantForSecondTerm<EdgeWeightType>(graph);
+
+    katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
+    TimerClusteringWhile.start();
+    while (true) {
+      num_iter++;
+
+      katana::do_all(
+          katana::iterate(graph),
+          [&](GNode n) {
+            auto& n_data_curr_comm_id =
+                graph.template GetData<CurrentCommunityId>(n);
+            auto& n_data_degree_wt =
+                graph.template GetData<DegreeWeight<EdgeWeightType>>(n);
+
+            uint64_t degree =
+                std::distance(graph.edge_begin(n), graph.edge_end(n));
+            if (degree == 0) {
+              return;
+            }
+
+            // Map each neighbor's cluster to local number:
+            // Community --> Index
+            std::map<uint64_t, uint64_t> cluster_local_map;
+            std::vector<EdgeWeightType>
+                counter;  // Number of edges to each unique cluster
+            EdgeWeightType self_loop_wt = 0;
+
+            Base::template FindNeighboringClusters<EdgeWeightType>(
+                graph, n, cluster_local_map, counter, self_loop_wt);
+            // Find the max gain in modularity
+            uint64_t local_target = Base::MaxModularityWithoutSwaps(
+                cluster_local_map, counter, self_loop_wt, c_info,
+                n_data_degree_wt, n_data_curr_comm_id,
+                constant_for_second_term);
+
+            /* Update cluster info */
+            if (local_target != n_data_curr_comm_id &&
+                local_target != Base::UNASSIGNED) {
+              katana::atomicAdd(
+                  c_info[local_target].degree_wt, n_data_degree_wt);
+              katana::atomicAdd(c_info[local_target].size, (uint64_t)1);
+              katana::atomicSub(
+                  c_info[n_data_curr_comm_id].degree_wt, n_data_degree_wt);
+              katana::atomicSub(c_info[n_data_curr_comm_id].size, (uint64_t)1);
+
+              /* Set the new cluster id */
+              n_data_curr_comm_id = local_target;
+            }
+          },
+          katana::loopname("leiden algo: Move nodes"));
+
+      /* Calculate the overall modularity */
+      double e_xx = 0;
+      double a2_x = 0;
+
+      curr_mod = Base::template CalModularity<EdgeWeightType>(
+          graph, c_info, e_xx, a2_x, constant_for_second_term);
+
+      if ((curr_mod - prev_mod) < modularity_threshold_per_round) {
+        prev_mod = curr_mod;
+        break;
+      }
+
+      prev_mod = curr_mod;
+
+    }  // End while
+    TimerClusteringWhile.stop();
+
+    iter = num_iter;
+    return prev_mod;
+  }
+
+  /**
+   * Try to move singleton \p n into the subcommunity founded by \p target.
+   * A node only moves while it is a singleton and only into a subcommunity
+   * whose founder has not moved, so nodes never leave a subcommunity that
+   * others joined and every subcommunity stays connected.
+   */
+  static bool JoinSubCommunity(
+      katana::LargeArray<SubCommTy>* sub_info, GNode n, uint64_t target) {
+    uint8_t expected = SubCommTy::kSingleton;
+    if (!(*sub_info)[n].state.compare_exchange_strong(
+            expected, SubCommTy::kMoved)) {
+      return false;
+    }
+    auto& target_state = (*sub_info)[target].state;
+    uint8_t state = target_state.load();
+    while (state != SubCommTy::kJoined) {
+      if (state == SubCommTy::kMoved) {
+        // Nobody joins a node that is moving, so n is still alone
+        (*sub_info)[n].state = SubCommTy::kSingleton;
+        return false;
+      }
+      if (target_state.compare_exchange_weak(state, SubCommTy::kJoined)) {
+        break;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * The refinement phase. Each node starts in its own subcommunity, stored
+   * in CurrentCommunityId, inside its community, stored in
+   * PreviousCommunityId. In parallel, a singleton that is well connected
+   * to the rest of its community joins the well connected subcommunity of
+   * the same community with the largest modularity gain, if positive. A
+   * set S of a community C of total degree weight K_C is well connected if
+   * the weight of the edges between S and C - S is at least
+   * K_S (K_C - K_S) / 2m.
+   */
+  void RefineCommunities(Graph* graph, double constant_for_second_term) {
+    CommunityArray c_info;
+    c_info.allocateBlocked(graph->num_nodes());
+    SumCommunityDegreeWeight<PreviousCommunityId>(*graph, &c_info);
+
+    katana::LargeArray<SubCommTy> sub_info;
+    sub_info.allocateBlocked(graph->num_nodes());
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      uint64_t comm = graph->template GetData<PreviousCommunityId>(n);
+      EdgeWeightType external_wt = 0;
+      for (auto ii = graph->edge_begin(n); ii != graph->edge_end(n); ++ii) {
+        auto dst = graph->GetEdgeDest(ii);
+        if (*dst != n &&
+            graph->template GetData<PreviousCommunityId>(dst) == comm) {
+          external_wt +=
+              graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
+        }
+      }
+      graph->template GetData<CurrentCommunityId>(n) = n;
+      sub_info[n].degree_wt =
+          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+      sub_info[n].external_wt = external_wt;
+      sub_info[n].state = SubCommTy::kSingleton;
+    });
+
+    auto well_connected = [&](double wt, double degree_wt, double comm_wt) {
+      return wt >= degree_wt * (comm_wt - degree_wt) * constant_for_second_term;
+    };
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](GNode n) {
+          if (sub_info[n].state != SubCommTy::kSingleton) {
+            return;
+          }
+          uint64_t comm = graph->template GetData<PreviousCommunityId>(n);
+          EdgeWeightType n_degree_wt =
+              graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+          double comm_degree_wt = c_info[comm].degree_wt;
+
+          // Weight of the edges to each subcommunity of the community
+          std::map<uint64_t, EdgeWeightType> sub_wt;
+          EdgeWeightType comm_wt = 0;
+          for (auto ii = graph->edge_begin(n); ii != graph->edge_end(n);
+               ++ii) {
+            auto dst = graph->GetEdgeDest(ii);
+            if (*dst == n ||
+                graph->template GetData<PreviousCommunityId>(dst) != comm) {
+              continue;
+            }
+            auto edge_wt =
+                graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
+            sub_wt[graph->template GetData<CurrentCommunityId>(dst)] +=
+                edge_wt;
+            comm_wt += edge_wt;
+          }
+          if (!well_connected(comm_wt, n_degree_wt, comm_degree_wt)) {
+            return;
+          }
+
+          // Ties go to the smallest subcommunity id
+          uint64_t target = n;
+          EdgeWeightType target_wt = 0;
+          double max_gain = 0;
+          for (const auto& [sub, wt] : sub_wt) {
+            double sub_degree_wt = sub_info[sub].degree_wt;
+            if (!well_connected(
+                    sub_info[sub].external_wt, sub_degree_wt,
+                    comm_degree_wt)) {
+              continue;
+            }
+            double gain =
+                wt - n_degree_wt * sub_degree_wt * constant_for_second_term;
+            if (gain > max_gain) {
+              max_gain = gain;
+              target = sub;
+              target_wt = wt;
+            }
+          }
+          if (target == n || !JoinSubCommunity(&sub_info, n, target)) {
+            return;
+          }
+
+          graph->template GetData<CurrentCommunityId>(n) = target;
+          katana::atomicAdd(sub_info[target].degree_wt, n_degree_wt);
+          // The edges between n and the target are now internal
+          katana::atomicAdd(sub_info[target].external_wt, comm_wt);
+          katana::atomicSub(
+              sub_info[target].external_wt,
+              static_cast<EdgeWeightType>(2 * target_wt));
+        },
+        katana::steal(), katana::loopname("leiden algo: Refinement"));
+  }
+
+  /**
+   * Splits every community in CurrentCommunityId into its connected parts
+   * and renumbers the communities contiguously. Splitting a community
+   * without edges between its parts never lowers modularity.
+   */
+  uint64_t SplitDisconnectedCommunities(
+      const katana::GraphTopology& topology, Graph* graph) {
+    katana::LargeArray<std::atomic<uint64_t>> labels;
+    labels.allocateBlocked(graph->num_nodes());
+    LabelClusterComponents(
+        topology,
+        [&](uint32_t n) {
+          return graph->template GetData<CurrentCommunityId>(n);
+        },
+        &labels);
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      auto& n_data_curr_comm_id =
+          graph->template GetData<CurrentCommunityId>(n);
+      if (n_data_curr_comm_id != Base::UNASSIGNED) {
+        n_data_curr_comm_id = labels[n];
+      }
+    });
+    return Base::RenumberClustersContiguously(graph);
+  }
+
+public:
+  katana::Result<void> LeidenClustering(
+      katana::PropertyGraph* pfg, const std::string& edge_weight_property_name,
+      const std::vector<std::string>& temp_node_property_names,
+      katana::LargeArray<uint64_t>& clusters_orig, LeidenClusteringPlan plan) {
+    /*
+     * Construct temp property graph. This graph gets coarsened as the
+     * computation proceeds.
+     */
+    auto pfg_mutable = std::make_unique<katana::PropertyGraph>();
+    katana::LargeArray<uint64_t> out_indices_next;
+    katana::LargeArray<uint32_t> out_dests_next;
+
+    out_indices_next.allocateInterleaved(pfg->topology().num_nodes());
+    out_dests_next.allocateInterleaved(pfg->topology().num_edges());
+
+    auto numeric_array_out_indices =
+        std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
+            static_cast<int64_t>(pfg->topology().num_nodes()),
+            arrow::MutableBuffer::Wrap(
+                out_indices_next.data(), pfg->topology().num_nodes()));
+    auto numeric_array_out_dests =
+        std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
+            static_cast<int64_t>(pfg->topology().num_edges()),
+            arrow::MutableBuffer::Wrap(
+                out_dests_next.data(), pfg->topology().num_edges()));
+
+    if (auto r = pfg_mutable->SetTopology(katana::GraphTopology{
+            .out_indices = std::move(numeric_array_out_indices),
+            .out_dests = std::move(numeric_array_out_dests),
+        });
+        !r) {
+      return r.error();
+    }
+    if (auto result = ConstructNodeProperties<NodeData>(
+            pfg_mutable.get(), temp_node_property_names);
+        !result) {
+      return result.error();
+    }
+    std::vector<std::string> temp_edge_property_names = {
+        "_katana_temporary_property_" + edge_weight_property_name};
+    if (auto result = ConstructEdgeProperties<EdgeData>(
+            pfg_mutable.get(), temp_edge_property_names);
+        !result) {
+      return result.error();
+    }
+
+    auto graph_result = Graph::Make(pfg);
+    if (!graph_result) {
+      return graph_result.error();
+    }
+    Graph graph_curr = graph_result.value();
+
+    /*
+    * Vertex following optimization
+    */
+    if (plan.enable_vf()) {
+      Base::VertexFollowing(&graph_curr);  // Find nodes that follow other nodes
+
+      uint64_t num_unique_clusters =
+          Base::RenumberClustersContiguously(&graph_curr);
+
+      /*
+       * Initialize node cluster id.
+       */
+      katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+        clusters_orig[n] = graph_curr.template GetData<CurrentCommunityId>(n);
+      });
+
+      // Build new graph to remove the isolated nodes
+      auto coarsened_graph_result =
+          Base::template GraphCoarsening<NodeData, EdgeData, EdgeWeightType>(
+              graph_curr, pfg_mutable.get(), num_unique_clusters,
+              temp_node_property_names, temp_edge_property_names);
+      if (!coarsened_graph_result) {
+        return coarsened_graph_result.error();
+      }
+
+      auto pfg_next = std::move(coarsened_graph_result.value());
+      pfg_mutable = std::move(pfg_next);
+
+    } else {
+      /*
+       * Initialize node cluster id.
+       */
+      katana::do_all(
+          katana::iterate(graph_curr), [&](GNode n) { clusters_orig[n] = n; });
+
+      if (auto r = Base::CreateDuplicateGraph(
+              pfg, pfg_mutable.get(), edge_weight_property_name,
+              temp_edge_property_names[0]);
+          !r) {
+        return r.error();
+      }
+
+      if (auto result = ConstructNodeProperties<NodeData>(pfg_mutable.get());
+          !result) {
+        return result.error();
+      }
+    }
+
+    double prev_mod = -1;  // Previous modularity
+    double curr_mod = -1;  // Current modularity
+
+    std::unique_ptr<katana::PropertyGraph> pfg_curr = std::move(pfg_mutable);
+    {
+      auto graph_first_result = Graph::Make(pfg_curr.get());
+      if (!graph_first_result) {
+        return graph_first_result.error();
+      }
+      Graph graph_first = graph_first_result.value();
+      katana::do_all(katana::iterate(graph_first), [&](GNode n) {
+        graph_first.template GetData<CurrentCommunityId>(n) = n;
+      });
+    }
+
+    /*
+     * clusters_orig maps each original node to its node in the current
+     * level, whose community is in CurrentCommunityId.
+     */
+    uint32_t iter = 0;
+    uint64_t num_nodes_orig = clusters_orig.size();
+    while (true) {
+      iter++;
+
+      auto graph_result = Graph::Make(pfg_curr.get());
+      if (!graph_result) {
+        return graph_result.error();
+      }
+      Graph graph_curr = graph_result.value();
+      if (graph_curr.num_nodes() <= plan.min_graph_size()) {
+        break;
+      }
+      switch (plan.algorithm()) {
+      case LeidenClusteringPlan::kDoAll: {
+        auto curr_mod_result = LeidenMoveNodesDoAll(
+            pfg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
+            iter);
+        if (!curr_mod_result) {
+          return curr_mod_result.error();
+        }
+        curr_mod = curr_mod_result.value();
+        break;
+      }
+      default:
+        return katana::ErrorCode::InvalidArgument;
+      }
+
+      Base::RenumberClustersContiguously(&graph_curr);
+
+      if (iter >= plan.max_iterations() ||
+          (curr_mod - prev_mod) <= plan.modularity_threshold_total()) {
+        break;
+      }
+
+      // Keep the communities aside while CurrentCommunityId holds the
+      // refined subcommunities that become the nodes of the next level
+      katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+        graph_curr.template GetData<PreviousCommunityId>(n) =
+            graph_curr.template GetData<CurrentCommunityId>(n);
+      });
+      RefineCommunities(
+          &graph_curr,
+          Base::template CalConstantForSecondTerm<EdgeWeightType>(graph_curr));
+      uint64_t num_sub_communities =
+          Base::RenumberClustersContiguously(&graph_curr);
+
+      katana::LargeArray<uint64_t> sub_community_comm;
+      sub_community_comm.allocateBlocked(num_sub_communities);
+      katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+        sub_community_comm[graph_curr.template GetData<CurrentCommunityId>(
+            n)] = graph_curr.template GetData<PreviousCommunityId>(n);
+      });
+
+      katana::do_all(
+          katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
+            if (clusters_orig[n] != Base::UNASSIGNED) {
+              KATANA_LOG_DEBUG_ASSERT(
+                  clusters_orig[n] < graph_curr.num_nodes());
+              clusters_orig[n] =
+                  graph_curr.template GetData<CurrentCommunityId>(
+                      clusters_orig[n]);
+            }
+          });
+
+      auto coarsened_graph_result =
+          Base::template GraphCoarsening<NodeData, EdgeData, EdgeWeightType>(
+              graph_curr, pfg_curr.get(), num_sub_communities,
+              temp_node_property_names, temp_edge_property_names);
+      if (!coarsened_graph_result) {
+        return coarsened_graph_result.error();
+      }
+      pfg_curr = std::move(coarsened_graph_result.value());
+
+      // The next level starts from the unrefined communities
+      auto graph_next_result = Graph::Make(pfg_curr.get());
+      if (!graph_next_result) {
+        return graph_next_result.error();
+      }
+      Graph graph_next = graph_next_result.value();
+      katana::do_all(katana::iterate(graph_next), [&](GNode n) {
+        graph_next.template GetData<CurrentCommunityId>(n) =
+            sub_community_comm[n];
+      });
+
+      prev_mod = curr_mod;
+    }
+
+    auto graph_last_result = Graph::Make(pfg_curr.get());
+    if (!graph_last_result) {
+      return graph_last_result.error();
+    }
+    Graph graph_last = graph_last_result.value();
+    SplitDisconnectedCommunities(pfg_curr->topology(), &graph_last);
+
+    katana::do_all(
+        katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
+          if (clusters_orig[n] != Base::UNASSIGNED) {
+            clusters_orig[n] = graph_last.template GetData<CurrentCommunityId>(
+                clusters_orig[n]);
+          }
+        });
+    return katana::ResultSuccess();
+  }
+};
+
+template <typename EdgeWeightType>
+katana::Result<void>
+LeidenClusteringWithWrap(
+    katana::PropertyGraph* pfg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, LeidenClusteringPlan plan) {
+  static_assert(
+      std::is_integral_v<EdgeWeightType> ||
+      std::is_floating_point_v<EdgeWeightType>);
+
+  std::vector<TemporaryPropertyGuard> temp_node_properties(3);
+  std::generate_n(
+      temp_node_properties.begin(), temp_node_properties.size(),
+      [&]() { return TemporaryPropertyGuard{pfg}; });
+  std::vector<std::string> temp_node_property_names(
+      temp_node_properties.size());
+  std::transform(
+      temp_node_properties.begin(), temp_node_properties.end(),
+      temp_node_property_names.begin(),
+      [](const TemporaryPropertyGuard& p) { return p.name(); });
+
+  using Impl = LeidenClusteringImplementation<EdgeWeightType>;
+  if (auto result = ConstructNodeProperties<typename Impl::NodeData>(
+          pfg, temp_node_property_names);
+      !result) {
+    return result.error();
+  }
+
+  /*
+   * To keep track of communities for nodes in the original graph.
+   * Community will be set to -1 for isolated nodes
+   */
+  katana::LargeArray<uint64_t> clusters_orig;
+  clusters_orig.allocateBlocked(pfg->num_nodes());
+
+  Impl impl{};
+  if (auto r = impl.LeidenClustering(
+          pfg, edge_weight_property_name, temp_node_property_names,
+          clusters_orig, plan);
+      !r) {
+    return r.error();
+  }
+
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+
+  if (auto r = ConstructNodeProperties<std::tuple<CurrentCommunityId>>(
+          pfg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+
+  auto graph_result =
+      katana::TypedPropertyGraph<std::tuple<CurrentCommunityId>, std::tuple<>>::
+          Make(pfg, {output_property_name}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  auto graph = graph_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t i) {
+        graph.GetData<CurrentCommunityId>(i) = clusters_orig[i];
+      },
+      katana::loopname("Add clusterIds"), katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+}  // anonymous namespace
+
+katana::Result<void>
+katana::analytics::LeidenClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, LeidenClusteringPlan plan) {
+  switch (pg->GetEdgeProperty(edge_weight_property_name)->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return LeidenClusteringWithWrap<uint32_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return LeidenClusteringWithWrap<int32_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return LeidenClusteringWithWrap<uint64_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return LeidenClusteringWithWrap<int64_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::FloatType::type_id:
+    return LeidenClusteringWithWrap<float>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return LeidenClusteringWithWrap<double>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+katana::Result<void>
+katana::analytics::LeidenClusteringAssertValid(
+    katana::PropertyGraph* pg,
+    [[maybe_unused]] const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto clusters_result = pg->GetNodePropertyTyped<uint64_t>(property_name);
+  if (!clusters_result) {
+    return clusters_result.error();
+  }
+  auto clusters = clusters_result.value();
+
+  const katana::GraphTopology& topology = pg->topology();
+  katana::LargeArray<std::atomic<uint64_t>> labels;
+  labels.allocateBlocked(topology.num_nodes());
+  LabelClusterComponents(
+      topology, [&](uint32_t n) { return clusters->Value(n); }, &labels);
+
+  // Each connected part of a cluster has one node labeled with itself
+  std::vector<uint64_t> root_clusters;
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    uint64_t cluster = clusters->Value(n);
+    if (labels[n] == n && cluster != std::numeric_limits<uint64_t>::max()) {
+      root_clusters.emplace_back(cluster);
+    }
+  }
+  std::sort(root_clusters.begin(), root_clusters.end());
+  auto it = std::adjacent_find(root_clusters.begin(), root_clusters.end());
+  if (it != root_clusters.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "cluster {} is not connected",
+        *it);
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::LeidenClusteringStatistics::Print(std::ostream& os) const {
+  os << "Total number of clusters = " << n_clusters << std::endl;
+  os << "Total number of non trivial clusters = " << n_non_trivial_clusters
+     << std::endl;
+  os << "Number of nodes in the largest cluster = " << largest_cluster_size
+     << std::endl;
+  os << "Ratio of nodes in the largest cluster = " << largest_cluster_proportion
+     << std::endl;
+  os << "Leiden modularity = " << modularity << std::endl;
+}
+
+katana::Result<katana::analytics::LeidenClusteringStatistics>
+katana::analytics::LeidenClusteringStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  // The statistics only depend on the clusters, which Louvain stores alike
+  auto stats_result = LouvainClusteringStatistics::Compute(
+      pg, edge_weight_property_name, property_name);
+  if (!stats_result) {
+    return stats_result.error();
+  }
+  const LouvainClusteringStatistics& stats = stats_result.value();
+  return LeidenClusteringStatistics{
+      stats.n_clusters, stats.n_non_trivial_clusters,
+      stats.largest_cluster_size, stats.largest_cluster_proportion,
+      stats.modularity};
+}
@@ -19,12 +19,17 @@
 
 #include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 
+#include <cmath>
+
+#include "katana/AdjacencyPrefetcher.h"
 #include "katana/AtomicHelpers.h"
+#include "katana/Cancellation.h"
 
 using namespace katana::analytics;
 
 namespace {
 constexpr static const unsigned kChunkSize = 64U;
+constexpr static const unsigned kPrefetchDistance = 16U;
 
 struct LocalClusteringCoefficientAtomics {
   struct NodeTriangleCount {
@@ -88,6 +93,8 @@ struct LocalClusteringCoefficientAtomics {
         katana::iterate(*graph),
         [&](const Node& n) { OrderedCountFunc(graph, n); },
         katana::chunk_size<kChunkSize>(), katana::steal(), katana::no_stats(),
+        katana::prefetch_distance<kPrefetchDistance>(
+            katana::AdjacencyPrefetcher(graph->topology())),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
   }
 
@@ -207,6 +214,8 @@ struct LocalClusteringCoefficientPerThread {
               graph, n, &(*per_thread_node_triangle_count.getLocal()));
         },
         katana::chunk_size<kChunkSize>(), katana::steal(),
+        katana::prefetch_distance<kPrefetchDistance>(
+            katana::AdjacencyPrefetcher(graph->topology())),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
 
     katana::do_all(
@@ -273,6 +282,131 @@ struct LocalClusteringCoefficientPerThread {
     return katana::ResultSuccess();
   }
 };
+
+struct LocalClusteringCoefficientOwnerComputes {
+  struct NodeClusteringCoefficient : public katana::PODProperty<double> {};
+
+  using NodeData = typename std::tuple<NodeClusteringCoefficient>;
+  using EdgeData = typename std::tuple<>;
+
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+
+  typedef typename Graph::Node Node;
+
+  /// Triangles counted for each edge by its source, which is the largest
+  /// node of the triangles
+  katana::LargeArray<uint32_t> edge_triangle_count_;
+
+  /**
+ * Counts the triangles of which n is the largest node, and adds one to the
+ * counts of the edges of n to the other two nodes of each. Only this call
+ * writes those counts. It assumes that edgelist of each node is sorted.
+ */
+  uint64_t OrderedCountFunc(Graph* graph, Node n) {
+    uint64_t triangles = 0;
+    for (auto it_v : graph->edges(n)) {
+      auto v = *graph->GetEdgeDest(it_v);
+      if (v >= n) {
+        break;
+      }
+      Graph::edge_iterator it_n = graph->edges(n).begin();
+
+      for (auto it_vv : graph->edges(v)) {
+        auto vv = *graph->GetEdgeDest(it_vv);
+        if (vv >= v) {
+          break;
+        }
+        while (*graph->GetEdgeDest(it_n) < vv) {
+          it_n++;
+        }
+        if (vv == *graph->GetEdgeDest(it_n)) {
+          triangles += 1;
+          edge_triangle_count_[it_v] += 1;
+          edge_triangle_count_[*it_n] += 1;
+        }
+      }
+    }
+    return triangles;
+  }
+
+  /*
+ * Owner-computes counting: a pass that finds each triangle once, at its
+ * largest node, and a pass in which each node sums its own count and the
+ * counts of the edges to it, found in the sorted edges of its larger
+ * neighbors.
+ */
+  void OrderedCountAlgo(katana::PropertyGraph* pg, Graph* graph) {
+    //! The output holds the triangles of each node until the end.
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const Node& n) {
+          for (auto e : graph->edges(n)) {
+            edge_triangle_count_[e] = 0;
+          }
+          graph->GetData<NodeClusteringCoefficient>(n) =
+              OrderedCountFunc(graph, n);
+        },
+        katana::chunk_size<kChunkSize>(), katana::steal(),
+        katana::prefetch_distance<kPrefetchDistance>(
+            katana::AdjacencyPrefetcher(graph->topology())),
+        katana::loopname("TriangleCount_OrderedCountAlgo"));
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const Node& n) {
+          auto& data = graph->GetData<NodeClusteringCoefficient>(n);
+          uint64_t triangles = data;
+          for (auto e : graph->edges(n)) {
+            auto dest = *graph->GetEdgeDest(e);
+            if (dest > n) {
+              triangles += edge_triangle_count_[katana::FindEdgeSortedByDest(
+                  pg, dest, n)];
+            }
+          }
+          auto degree =
+              std::distance(graph->edges(n).begin(), graph->edges(n).end());
+          if (degree > 1) {
+            data = ((double)(2 * triangles)) / (degree * (degree - 1));
+          } else {
+            data = 0.0;
+          }
+        },
+        katana::chunk_size<kChunkSize>(), katana::steal(),
+        katana::loopname("TriangleCount_Collect"));
+  }
+
+  katana::Result<void> operator()(
+      katana::PropertyGraph* pg, const std::string& output_property_name) {
+    if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
+            pg, {output_property_name});
+        !result) {
+      return result.error();
+    }
+
+    auto graph_result = Graph::Make(pg, {output_property_name}, {});
+    if (!graph_result) {
+      return graph_result.error();
+    }
+
+    Graph graph = graph_result.value();
+
+    katana::StatTimer execTime(
+        "LocalClusteringCoefficient", "LocalClusteringCoefficient");
+    execTime.start();
+
+    edge_triangle_count_.allocateBlocked(graph.num_edges());
+
+    // Calculate the number of triangles on each node and compute the
+    // clustering coefficient of each node from them
+    OrderedCountAlgo(pg, &graph);
+
+    edge_triangle_count_.destroy();
+    edge_triangle_count_.deallocate();
+
+    execTime.stop();
+    return katana::ResultSuccess();
+  }
+};
 }  // namespace
 
 template <typename Algorithm>
@@ -281,7 +415,13 @@ LocalClusteringCoefficientWithWrap(
     katana::PropertyGraph* pg, const std::string& output_property_name) {
   Algorithm algo;
 
-  return algo(pg, output_property_name);
+  if (auto r = algo(pg, output_property_name); !r) {
+    return r.error();
+  }
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -336,7 +476,7 @@ katana::analytics::LocalClusteringCoefficient(
 
   // If we relabel we must also sort. Relabeling will break the sorting.
   if (relabel || !plan.edges_sorted()) {
-    if (auto r = katana::SortAllEdgesByDest(pg); !r) {
+    if (auto r = katana::EnsureAllEdgesSortedByDest(pg); !r) {
       return r.error();
     }
   }
@@ -354,7 +494,104 @@ katana::analytics::LocalClusteringCoefficient(
     LocalClusteringCoefficientPerThread algo_per_thread;
     return algo_per_thread(pg, output_property_name);
   }
+  case LocalClusteringCoefficientPlan::kOrderedCountOwnerComputes: {
+    LocalClusteringCoefficientOwnerComputes algo_owner_computes;
+    return algo_owner_computes(pg, output_property_name);
+  }
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
+
+katana::Result<katana::analytics::ApproximationStatistics>
+katana::analytics::ApproximateLocalClusteringCoefficient(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    SparsifyPlan sparsify_plan, LocalClusteringCoefficientPlan plan) {
+  auto sample_res = Sparsify(pg, sparsify_plan);
+  if (!sample_res) {
+    return sample_res.error();
+  }
+  katana::PropertyGraph* sample = sample_res.value().graph.get();
+  double edge_fraction = sample_res.value().edge_fraction;
+
+  // Relabeling would reorder the nodes of the sample away from those of pg
+  LocalClusteringCoefficientPlan sample_plan;
+  switch (plan.algorithm()) {
+  case LocalClusteringCoefficientPlan::kOrderedCountAtomics:
+    sample_plan = LocalClusteringCoefficientPlan::OrderedCountAtomics(
+        plan.edges_sorted(), LocalClusteringCoefficientPlan::kNoRelabel);
+    break;
+  case LocalClusteringCoefficientPlan::kOrderedCountOwnerComputes:
+    sample_plan = LocalClusteringCoefficientPlan::OrderedCountOwnerComputes(
+        plan.edges_sorted(), LocalClusteringCoefficientPlan::kNoRelabel);
+    break;
+  default:
+    sample_plan = LocalClusteringCoefficientPlan::OrderedCountPerThread(
+        plan.edges_sorted(), LocalClusteringCoefficientPlan::kNoRelabel);
+  }
+  if (auto r =
+          LocalClusteringCoefficient(sample, output_property_name, sample_plan);
+      !r) {
+    return r.error();
+  }
+  auto sampled_res =
+      sample->GetNodePropertyTyped<double>(output_property_name);
+  if (!sampled_res) {
+    return sampled_res.error();
+  }
+  const double* sampled = sampled_res.value()->raw_values();
+
+  uint64_t num_nodes = pg->num_nodes();
+  auto buffer_res = arrow::AllocateBuffer(num_nodes * sizeof(double));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} values: {}", num_nodes,
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  auto* coefficient = reinterpret_cast<double*>(buffer->mutable_data());
+
+  bool forest_fire = sparsify_plan.algorithm() == SparsifyPlan::kForestFire;
+  // The probability that a triangle survives; the nodes of a forest fire
+  // are kept with about the square root of the fraction of edges
+  double survival = forest_fire ? std::pow(edge_fraction, 1.5)
+                                : std::pow(edge_fraction, 3);
+  const katana::GraphTopology& topology = pg->topology();
+  const katana::GraphTopology& sample_topology = sample->topology();
+  katana::GAccumulator<double> sampled_triangles;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](katana::GraphTopology::Node n) {
+        double sample_degree = sample_topology.edges(n).size();
+        double triangles =
+            sampled[n] * sample_degree * (sample_degree - 1) / 2;
+        sampled_triangles += triangles;
+        if (forest_fire) {
+          coefficient[n] = sampled[n];
+          return;
+        }
+        double degree = topology.edges(n).size();
+        coefficient[n] =
+            degree < 2 ? 0
+                       : std::min(
+                             1.0, triangles / survival /
+                                      (degree * (degree - 1) / 2));
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("ApproximateLocalClusteringCoefficient"));
+
+  auto coefficients =
+      std::make_shared<arrow::DoubleArray>(num_nodes, std::move(buffer));
+  if (auto r = pg->AddNodeProperties(arrow::Table::Make(
+          arrow::schema({arrow::field(output_property_name, arrow::float64())}),
+          {std::static_pointer_cast<arrow::Array>(coefficients)}));
+      !r) {
+    return r.error();
+  }
+
+  // Each triangle is counted at its three nodes
+  double triangles = sampled_triangles.reduce() / 3;
+  return ApproximationStatistics{
+      sample->num_edges(), edge_fraction,
+      triangles < 1 ? 1 : std::sqrt((1 - survival) / triangles)};
+}
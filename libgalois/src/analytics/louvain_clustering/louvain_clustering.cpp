@@ -22,6 +22,8 @@
 #include <deque>
 #include <type_traits>
 
+#include "katana/Cancellation.h"
+#include "katana/ParallelSTL.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/ClusteringImplementationBase.h"
 
@@ -356,6 +358,7 @@ struct LouvainClusteringImplementation
 public:
   katana::Result<void> LouvainClustering(
       katana::PropertyGraph* pfg, const std::string& edge_weight_property_name,
+      const std::string& seed_property_name,
       const std::vector<std::string>& temp_node_property_names,
       katana::LargeArray<uint64_t>& clusters_orig, LouvainClusteringPlan plan) {
     /*
@@ -407,10 +410,41 @@ public:
     Graph graph_curr = graph_result.value();
 
     /*
-    * Vertex following optimization
-    */
-    if (plan.enable_vf()) {
-      Base::VertexFollowing(&graph_curr);  // Find nodes that follow other nodes
+     * Start from the seed clusters or the vertex following optimization by
+     * coarsening the input graph
+     */
+    bool coarsen_input = !seed_property_name.empty() || plan.enable_vf();
+    if (coarsen_input) {
+      if (!seed_property_name.empty()) {
+        auto seed_result =
+            pfg->GetNodePropertyTyped<uint64_t>(seed_property_name);
+        if (!seed_result) {
+          return seed_result.error();
+        }
+        auto seed = seed_result.value();
+        if (seed->null_count() != 0) {
+          return KATANA_ERROR(
+              katana::ErrorCode::InvalidArgument, "seed {} has {} nulls",
+              seed_property_name, seed->null_count());
+        }
+        katana::GAccumulator<uint64_t> invalid_seeds;
+        katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+          uint64_t cluster = seed->Value(n);
+          if (cluster >= graph_curr.num_nodes()) {
+            invalid_seeds += 1;
+          }
+          graph_curr.template GetData<CurrentCommunityId>(n) = cluster;
+        });
+        if (invalid_seeds.reduce() != 0) {
+          return KATANA_ERROR(
+              katana::ErrorCode::InvalidArgument,
+              "seed {} has {} clusters that are not node ids",
+              seed_property_name, invalid_seeds.reduce());
+        }
+      } else {
+        // Find nodes that follow other nodes
+        Base::VertexFollowing(&graph_curr);
+      }
 
       uint64_t num_unique_clusters =
           Base::RenumberClustersContiguously(&graph_curr);
@@ -506,7 +540,7 @@ public:
 
       if (iter < plan.max_iterations() &&
           (curr_mod - prev_mod) > plan.modularity_threshold_total()) {
-        if (!plan.enable_vf() && phase == 1) {
+        if (!coarsen_input && phase == 1) {
           KATANA_LOG_DEBUG_ASSERT(num_nodes_orig == graph_curr.num_nodes());
           katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
             clusters_orig[n] =
@@ -548,6 +582,7 @@ template <typename EdgeWeightType>
 static katana::Result<void>
 LouvainClusteringWithWrap(
     katana::PropertyGraph* pfg, const std::string& edge_weight_property_name,
+    const std::string& seed_property_name,
     const std::string& output_property_name, LouvainClusteringPlan plan) {
   static_assert(
       std::is_integral_v<EdgeWeightType> ||
@@ -580,12 +615,16 @@ LouvainClusteringWithWrap(
 
   LouvainClusteringImplementation<EdgeWeightType> impl{};
   if (auto r = impl.LouvainClustering(
-          pfg, edge_weight_property_name, temp_node_property_names,
-          clusters_orig, plan);
+          pfg, edge_weight_property_name, seed_property_name,
+          temp_node_property_names, clusters_orig, plan);
       !r) {
     return r.error();
   }
 
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+
   if (auto r = ConstructNodeProperties<std::tuple<CurrentCommunityId>>(
           pfg, {output_property_name});
       !r) {
@@ -610,36 +649,65 @@ LouvainClusteringWithWrap(
   return katana::ResultSuccess();
 }
 
-}  // anonymous namespace
-
 katana::Result<void>
-katana::analytics::LouvainClustering(
+LouvainClusteringWithSeed(
     katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& seed_property_name,
     const std::string& output_property_name, LouvainClusteringPlan plan) {
   switch (pg->GetEdgeProperty(edge_weight_property_name)->type()->id()) {
   case arrow::UInt32Type::type_id:
     return LouvainClusteringWithWrap<uint32_t>(
-        pg, edge_weight_property_name, output_property_name, plan);
+        pg, edge_weight_property_name, seed_property_name,
+        output_property_name, plan);
   case arrow::Int32Type::type_id:
     return LouvainClusteringWithWrap<int32_t>(
-        pg, edge_weight_property_name, output_property_name, plan);
+        pg, edge_weight_property_name, seed_property_name,
+        output_property_name, plan);
   case arrow::UInt64Type::type_id:
     return LouvainClusteringWithWrap<uint64_t>(
-        pg, edge_weight_property_name, output_property_name, plan);
+        pg, edge_weight_property_name, seed_property_name,
+        output_property_name, plan);
   case arrow::Int64Type::type_id:
     return LouvainClusteringWithWrap<int64_t>(
-        pg, edge_weight_property_name, output_property_name, plan);
+        pg, edge_weight_property_name, seed_property_name,
+        output_property_name, plan);
   case arrow::FloatType::type_id:
     return LouvainClusteringWithWrap<float>(
-        pg, edge_weight_property_name, output_property_name, plan);
+        pg, edge_weight_property_name, seed_property_name,
+        output_property_name, plan);
   case arrow::DoubleType::type_id:
     return LouvainClusteringWithWrap<double>(
-        pg, edge_weight_property_name, output_property_name, plan);
+        pg, edge_weight_property_name, seed_property_name,
+        output_property_name, plan);
   default:
     return katana::ErrorCode::TypeError;
   }
 }
 
+}  // anonymous namespace
+
+katana::Result<void>
+katana::analytics::LouvainClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, LouvainClusteringPlan plan) {
+  return LouvainClusteringWithSeed(
+      pg, edge_weight_property_name, "", output_property_name, plan);
+}
+
+katana::Result<void>
+katana::analytics::LouvainClusteringFromSeed(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& seed_property_name,
+    const std::string& output_property_name, LouvainClusteringPlan plan) {
+  if (seed_property_name.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "seed property name is empty");
+  }
+  return LouvainClusteringWithSeed(
+      pg, edge_weight_property_name, seed_property_name, output_property_name,
+      plan);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::LouvainClusteringAssertValid(
@@ -696,37 +764,11 @@ katana::analytics::LouvainClusteringStatistics::Compute(
   }
   auto graph = graph_result.value();
 
-  using Map = katana::gstl::Map<uint64_t, uint64_t>;
-
-  auto reduce = [](Map& lhs, Map&& rhs) -> Map& {
-    Map v{std::move(rhs)};
-
-    for (auto& kv : v) {
-      if (lhs.count(kv.first) == 0) {
-        lhs[kv.first] = 0;
-      }
-      lhs[kv.first] += kv.second;
-    }
-
-    return lhs;
-  };
-
-  auto mapIdentity = []() { return Map(); };
-
-  auto accumMap = katana::make_reducible(reduce, mapIdentity);
-
-  katana::GAccumulator<size_t> accumReps;
-
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const uint32_t& x) {
-        auto& n = graph.template GetData<PreviousCommunityId>(x);
-        accumMap.update(Map{std::make_pair(n, uint64_t{1})});
-      },
-      katana::loopname("CountLargest"));
-
-  Map& map = accumMap.reduce();
-  size_t reps = map.size();
+  auto clusters = katana::ParallelSTL::group_by(
+      graph.begin(), graph.end(), [&](const uint32_t& x) {
+        return graph.template GetData<PreviousCommunityId>(x);
+      });
+  size_t reps = clusters.size();
 
   using ClusterSizePair = std::pair<uint32_t, uint32_t>;
 
@@ -742,9 +784,9 @@ katana::analytics::LouvainClusteringStatistics::Compute(
   auto maxComp = katana::make_reducible(sizeMax, identity);
 
   katana::GAccumulator<uint64_t> non_trivial_clusters;
-  katana::do_all(katana::iterate(map), [&](const ClusterSizePair& x) {
-    maxComp.update(x);
-    if (x.second > 1) {
+  katana::do_all(katana::iterate(clusters), [&](const auto& x) {
+    maxComp.update(ClusterSizePair(x.key, x.count));
+    if (x.count > 1) {
       non_trivial_clusters += 1;
     }
   });
@@ -0,0 +1,597 @@
+#include "katana/analytics/matrix_completion/matrix_completion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Cancellation.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/TiledExecutor.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using LatentValue = float;
+
+/// The number of partial sums of DotProduct
+constexpr uint32_t kLanes = 8;
+
+/// The dot product of two latent vectors. Keeping kLanes independent
+/// partial sums lets the compiler vectorize the loop without reassociating
+/// floating point additions.
+LatentValue
+DotProduct(
+    const LatentValue* __restrict__ a, const LatentValue* __restrict__ b,
+    uint32_t size) {
+  LatentValue partial[kLanes] = {};
+  uint32_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    for (uint32_t j = 0; j < kLanes; ++j) {
+      partial[j] += a[i + j] * b[i + j];
+    }
+  }
+  LatentValue sum = 0;
+  for (; i < size; ++i) {
+    sum += a[i] * b[i];
+  }
+  for (uint32_t j = 0; j < kLanes; ++j) {
+    sum += partial[j];
+  }
+  return sum;
+}
+
+/// Take a gradient step on the squared error of one rating with
+/// regularization \p lambda
+void
+GradientUpdate(
+    LatentValue* __restrict__ item, LatentValue* __restrict__ user,
+    uint32_t size, LatentValue lambda, LatentValue rating, LatentValue step) {
+  LatentValue error = DotProduct(item, user, size) - rating;
+  for (uint32_t i = 0; i < size; ++i) {
+    LatentValue prev_item = item[i];
+    LatentValue prev_user = user[i];
+    item[i] -= step * (error * prev_user + lambda * prev_item);
+    user[i] -= step * (error * prev_item + lambda * prev_user);
+  }
+}
+
+/// A pseudorandom value in [0, 1) determined by \p key (SplitMix64), so
+/// that initialization is parallel and deterministic
+double
+UnitHash(uint64_t key) {
+  uint64_t z = key + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+  z ^= z >> 31U;
+  return (z >> 11U) * 0x1.0p-53;
+}
+
+/// \returns the number of items, which are the nodes up to the last node
+/// with out-edges
+Node
+NumItems(const katana::GraphTopology& topology) {
+  Node num_items = topology.num_nodes();
+  while (num_items > 0 && topology.edges(num_items - 1).empty()) {
+    --num_items;
+  }
+  return num_items;
+}
+
+/// Solve a x = b for the symmetric positive definite size x size matrix a,
+/// of which only the lower triangle is read, by Cholesky factorization. The
+/// factor overwrites a and x overwrites b.
+void
+CholeskySolve(double* a, double* b, uint32_t size) {
+  for (uint32_t j = 0; j < size; ++j) {
+    double diagonal = a[j * size + j];
+    for (uint32_t p = 0; p < j; ++p) {
+      diagonal -= a[j * size + p] * a[j * size + p];
+    }
+    diagonal = std::sqrt(diagonal);
+    a[j * size + j] = diagonal;
+    for (uint32_t i = j + 1; i < size; ++i) {
+      double sum = a[i * size + j];
+      for (uint32_t p = 0; p < j; ++p) {
+        sum -= a[i * size + p] * a[j * size + p];
+      }
+      a[i * size + j] = sum / diagonal;
+    }
+  }
+  for (uint32_t i = 0; i < size; ++i) {
+    double sum = b[i];
+    for (uint32_t p = 0; p < i; ++p) {
+      sum -= a[i * size + p] * b[p];
+    }
+    b[i] = sum / a[i * size + i];
+  }
+  for (uint32_t i = size; i-- > 0;) {
+    double sum = b[i];
+    for (uint32_t p = i + 1; p < size; ++p) {
+      sum -= a[p * size + i] * b[p];
+    }
+    b[i] = sum / a[i * size + i];
+  }
+}
+
+/// A thread's normal equations for one node in AlternatingLeastSquares
+struct NormalEquations {
+  std::vector<double> matrix;
+  std::vector<double> rhs;
+
+  /// Start the equations of a node with regularization \p lambda
+  void Start(uint32_t size, double lambda) {
+    matrix.assign(size * size, 0);
+    rhs.assign(size, 0);
+    for (uint32_t i = 0; i < size; ++i) {
+      matrix[i * size + i] = lambda;
+    }
+  }
+
+  /// Add a rating of the node by or of a neighbor with latent vector \p y
+  void Add(const LatentValue* y, double rating, uint32_t size) {
+    for (uint32_t r = 0; r < size; ++r) {
+      double* row = &matrix[r * size];
+      for (uint32_t c = 0; c <= r; ++c) {
+        row[c] += double(y[r]) * y[c];
+      }
+      rhs[r] += rating * y[r];
+    }
+  }
+
+  /// Solve the equations into \p x
+  void Solve(LatentValue* x, uint32_t size) {
+    CholeskySolve(matrix.data(), rhs.data(), size);
+    for (uint32_t i = 0; i < size; ++i) {
+      x[i] = rhs[i];
+    }
+  }
+};
+
+/// \returns the latent vectors of the nodes of a fixed size list property
+/// as a flat array, and the length of each vector
+katana::Result<std::pair<const LatentValue*, uint32_t>>
+GetLatentVectors(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto property = pg->GetNodeProperty(output_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no node property {}",
+        output_property_name);
+  }
+  auto view_result = katana::ConstructPropertyView<
+      katana::FixedSizeListProperty<LatentValue>>(property->chunk(0).get());
+  if (!view_result) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "{} is not a fixed size list of floats",
+        output_property_name);
+  }
+  const auto& view = view_result.value();
+  return std::make_pair(view.data(), static_cast<uint32_t>(view.dimension()));
+}
+
+/// \returns whether the out-edges of every node of pg are sorted by
+/// destination
+bool
+EdgesSortedByDest(katana::PropertyGraph* pg) {
+  if (pg->edges_sorted_by_dest()) {
+    return true;
+  }
+  const katana::GraphTopology& topology = pg->topology();
+  katana::GReduceLogicalOr unsorted;
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(topology.num_nodes())),
+      [&](Node n) {
+        auto [begin, end] = topology.edge_range(n);
+        if (!std::is_sorted(
+                topology.edge_dests() + begin, topology.edge_dests() + end)) {
+          unsorted.update(true);
+        }
+      },
+      katana::no_stats());
+  return !unsorted.reduce();
+}
+
+/// Copy \p topology with the out-edges of every node sorted by destination
+/// into \p sorted, and \p ratings in the same order into \p sorted_ratings
+template <typename Rating>
+void
+SortByDest(
+    const katana::GraphTopology& topology, const Rating* ratings,
+    katana::GraphTopology* sorted, std::vector<Rating>* sorted_ratings) {
+  std::vector<Edge> order(topology.num_edges());
+  std::vector<Node> dests(topology.num_edges());
+  sorted_ratings->resize(topology.num_edges());
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(topology.num_nodes())),
+      [&](Node n) {
+        auto [begin, end] = topology.edge_range(n);
+        std::iota(order.data() + begin, order.data() + end, begin);
+        std::sort(
+            order.data() + begin, order.data() + end, [&](Edge a, Edge b) {
+              return topology.edge_dest(a) < topology.edge_dest(b) ||
+                     (topology.edge_dest(a) == topology.edge_dest(b) && a < b);
+            });
+        for (Edge e = begin; e < end; ++e) {
+          dests[e] = topology.edge_dest(order[e]);
+          (*sorted_ratings)[e] = ratings[order[e]];
+        }
+      },
+      katana::steal(), katana::loopname("MatrixCompletion-SortByDest"));
+  sorted->out_indices = topology.out_indices;
+  sorted->out_dests =
+      std::static_pointer_cast<arrow::UInt32Array>(katana::BuildArray(dests));
+}
+
+template <typename Rating>
+class MatrixCompletionImpl {
+  const katana::GraphTopology& topology_;
+  const Rating* ratings_;
+  Node num_items_;
+  uint32_t size_;
+  LatentValue* latent_;
+
+  LatentValue* Vector(Node n) { return &latent_[uint64_t{n} * size_]; }
+
+public:
+  MatrixCompletionImpl(
+      const katana::GraphTopology& topology, const Rating* ratings,
+      Node num_items, uint32_t size, LatentValue* latent)
+      : topology_(topology),
+        ratings_(ratings),
+        num_items_(num_items),
+        size_(size),
+        latent_(latent) {}
+
+  /// Fill the vectors with values in [0, 1 / sqrt(size))
+  void Initialize() {
+    double top = 1.0 / std::sqrt(size_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, topology_.num_nodes() * size_),
+        [&](uint64_t i) { latent_[i] = top * UnitHash(i); },
+        katana::no_stats());
+  }
+
+  /// \returns the sum of the squared errors of the predicted ratings
+  double SquaredError() {
+    katana::GAccumulator<double> error;
+    katana::do_all(
+        katana::iterate(Node{0}, num_items_),
+        [&](Node item) {
+          for (Edge e : topology_.edges(item)) {
+            double diff =
+                DotProduct(
+                    Vector(item), Vector(topology_.edge_dest(e)), size_) -
+                double(ratings_[e]);
+            error += diff * diff;
+          }
+        },
+        katana::steal(), katana::no_stats());
+    return error.reduce();
+  }
+
+  void SgdRound(const MatrixCompletionPlan& plan, LatentValue step) {
+    katana::TiledGraphTopology tiled{topology_};
+    LatentValue lambda = plan.lambda();
+    // The executor counts the updates of its tiles, so each round needs a
+    // fresh one
+    katana::Fixed2DGraphTiledExecutor<katana::TiledGraphTopology> executor(
+        tiled);
+    executor.execute(
+        tiled.begin(), tiled.begin() + num_items_, tiled.begin() + num_items_,
+        tiled.end(), plan.items_per_block(), plan.users_per_block(),
+        [&](Node item, Node user, katana::TiledGraphTopology::edge_iterator e) {
+          GradientUpdate(
+              Vector(item), Vector(user), size_, lambda, ratings_[*e], step);
+        },
+        true);
+  }
+
+  void AlsRound(
+      const MatrixCompletionPlan& plan, const katana::InEdgeIndex& in) {
+    katana::PerThreadStorage<NormalEquations> equations;
+    katana::do_all(
+        katana::iterate(Node{0}, num_items_),
+        [&](Node item) {
+          NormalEquations& local = *equations.getLocal();
+          local.Start(size_, plan.lambda());
+          for (Edge e : topology_.edges(item)) {
+            local.Add(Vector(topology_.edge_dest(e)), ratings_[e], size_);
+          }
+          local.Solve(Vector(item), size_);
+        },
+        katana::steal(), katana::loopname("MatrixCompletion-SolveItems"));
+    katana::do_all(
+        katana::iterate(num_items_, static_cast<Node>(topology_.num_nodes())),
+        [&](Node user) {
+          NormalEquations& local = *equations.getLocal();
+          local.Start(size_, plan.lambda());
+          for (Edge e : in.in_edges(user)) {
+            local.Add(
+                Vector(in.in_edge_src(e)), ratings_[in.out_edge_id(e)], size_);
+          }
+          local.Solve(Vector(user), size_);
+        },
+        katana::steal(), katana::loopname("MatrixCompletion-SolveUsers"));
+  }
+
+  katana::Result<void> Run(
+      const MatrixCompletionPlan& plan, const katana::InEdgeIndex* in) {
+    Initialize();
+    if (topology_.num_edges() == 0) {
+      return katana::ResultSuccess();
+    }
+
+    double last = SquaredError();
+    LatentValue step = plan.learning_rate();
+    for (uint32_t round = 0; round < plan.max_iterations(); ++round) {
+      if (katana::IsCancelled()) {
+        return katana::ErrorCode::Cancelled;
+      }
+      if (plan.algorithm() == MatrixCompletionPlan::kAlternatingLeastSquares) {
+        AlsRound(plan, *in);
+      } else {
+        SgdRound(plan, step);
+      }
+
+      double error = SquaredError();
+      if (!std::isfinite(error)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "diverged in round {}; try a smaller learning rate", round);
+      }
+      // Bold driver
+      step *= error < last ? 1.05 : 0.5;
+      if (last == 0 || std::abs(last - error) / last < plan.tolerance()) {
+        break;
+      }
+      last = error;
+    }
+    return katana::ResultSuccess();
+  }
+};
+
+template <typename Rating>
+katana::Result<void>
+MatrixCompletionWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_rating_property_name,
+    const std::string& output_property_name, MatrixCompletionPlan plan) {
+  auto ratings_result =
+      pg->GetEdgePropertyTyped<Rating>(edge_rating_property_name);
+  if (!ratings_result) {
+    return ratings_result.error();
+  }
+  const katana::GraphTopology& topology = pg->topology();
+  const Rating* ratings = ratings_result.value()->raw_values();
+
+  Node num_items = NumItems(topology);
+  katana::GReduceLogicalOr not_bipartite;
+  katana::do_all(
+      katana::iterate(Node{0}, num_items),
+      [&](Node item) {
+        for (Edge e : topology.edges(item)) {
+          if (topology.edge_dest(e) < num_items) {
+            not_bipartite.update(true);
+          }
+        }
+      },
+      katana::no_stats());
+  if (not_bipartite.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "an edge ends at an item; the items must be the first {} nodes and "
+        "every edge must go from an item to a user",
+        num_items);
+  }
+
+  std::shared_ptr<const katana::InEdgeIndex> in_edges;
+  if (plan.algorithm() == MatrixCompletionPlan::kAlternatingLeastSquares) {
+    auto in_edges_result = pg->GetInEdgeIndex();
+    if (!in_edges_result) {
+      return in_edges_result.error();
+    }
+    in_edges = in_edges_result.value();
+  }
+
+  // The tiled executor finds the edges of a tile by binary search, so
+  // unless the edges are sorted by destination it runs on a sorted copy of
+  // the topology and the ratings, which leaves pg untouched
+  katana::GraphTopology sorted;
+  std::vector<Rating> sorted_ratings;
+  const katana::GraphTopology* tiled = &topology;
+  if (plan.algorithm() == MatrixCompletionPlan::kStochasticGradientDescent &&
+      !EdgesSortedByDest(pg)) {
+    SortByDest(topology, ratings, &sorted, &sorted_ratings);
+    tiled = &sorted;
+    ratings = sorted_ratings.data();
+  }
+
+  uint32_t size = plan.latent_vector_size();
+  uint64_t num_values = topology.num_nodes() * size;
+  auto buffer_res = arrow::AllocateBuffer(num_values * sizeof(LatentValue));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating latent vectors: {}",
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+
+  MatrixCompletionImpl<Rating> impl(
+      *tiled, ratings, num_items, size,
+      reinterpret_cast<LatentValue*>(buffer->mutable_data()));
+  if (auto r = impl.Run(plan, in_edges.get()); !r) {
+    return r.error();
+  }
+
+  auto values = std::make_shared<arrow::FloatArray>(num_values, buffer);
+  auto type = arrow::fixed_size_list(arrow::float32(), size);
+  auto list = std::make_shared<arrow::FixedSizeListArray>(
+      type, topology.num_nodes(), values);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, type)}), {list});
+  return pg->AddNodeProperties(table);
+}
+
+template <typename Rating>
+katana::Result<double>
+RootMeanSquaredError(
+    katana::PropertyGraph* pg, const std::string& edge_rating_property_name,
+    const LatentValue* latent, uint32_t size) {
+  auto ratings_result =
+      pg->GetEdgePropertyTyped<Rating>(edge_rating_property_name);
+  if (!ratings_result) {
+    return ratings_result.error();
+  }
+  const katana::GraphTopology& topology = pg->topology();
+  if (topology.num_edges() == 0) {
+    return 0.0;
+  }
+  MatrixCompletionImpl<Rating> impl(
+      topology, ratings_result.value()->raw_values(), NumItems(topology), size,
+      const_cast<LatentValue*>(latent));
+  return std::sqrt(impl.SquaredError() / topology.num_edges());
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MatrixCompletion(
+    katana::PropertyGraph* pg, const std::string& edge_rating_property_name,
+    const std::string& output_property_name, MatrixCompletionPlan plan) {
+  if (plan.latent_vector_size() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "latent vectors must not be empty");
+  }
+  if (plan.algorithm() == MatrixCompletionPlan::kAlternatingLeastSquares &&
+      !(plan.lambda() > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "alternating least squares needs a positive lambda");
+  }
+  if (plan.algorithm() == MatrixCompletionPlan::kStochasticGradientDescent &&
+      (plan.items_per_block() == 0 || plan.users_per_block() == 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "tiles must not be empty");
+  }
+  auto ratings = pg->GetEdgeProperty(edge_rating_property_name);
+  if (!ratings) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_rating_property_name);
+  }
+
+  switch (ratings->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return MatrixCompletionWithWrap<uint32_t>(
+        pg, edge_rating_property_name, output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return MatrixCompletionWithWrap<int32_t>(
+        pg, edge_rating_property_name, output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return MatrixCompletionWithWrap<uint64_t>(
+        pg, edge_rating_property_name, output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return MatrixCompletionWithWrap<int64_t>(
+        pg, edge_rating_property_name, output_property_name, plan);
+  case arrow::FloatType::type_id:
+    return MatrixCompletionWithWrap<float>(
+        pg, edge_rating_property_name, output_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return MatrixCompletionWithWrap<double>(
+        pg, edge_rating_property_name, output_property_name, plan);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+katana::Result<void>
+katana::analytics::MatrixCompletionAssertValid(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto latent_result = GetLatentVectors(pg, output_property_name);
+  if (!latent_result) {
+    return latent_result.error();
+  }
+  auto [latent, size] = latent_result.value();
+
+  katana::GReduceLogicalOr not_finite;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->topology().num_nodes() * size),
+      [&](uint64_t i) {
+        if (!std::isfinite(latent[i])) {
+          not_finite.update(true);
+        }
+      },
+      katana::no_stats());
+  if (not_finite.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "latent values are not finite");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<MatrixCompletionStatistics>
+katana::analytics::MatrixCompletionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& edge_rating_property_name,
+    const std::string& output_property_name) {
+  auto latent_result = GetLatentVectors(pg, output_property_name);
+  if (!latent_result) {
+    return latent_result.error();
+  }
+  auto [latent, size] = latent_result.value();
+
+  auto ratings = pg->GetEdgeProperty(edge_rating_property_name);
+  if (!ratings) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_rating_property_name);
+  }
+
+  katana::Result<double> rmse = katana::ErrorCode::TypeError;
+  switch (ratings->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    rmse = RootMeanSquaredError<uint32_t>(
+        pg, edge_rating_property_name, latent, size);
+    break;
+  case arrow::Int32Type::type_id:
+    rmse = RootMeanSquaredError<int32_t>(
+        pg, edge_rating_property_name, latent, size);
+    break;
+  case arrow::UInt64Type::type_id:
+    rmse = RootMeanSquaredError<uint64_t>(
+        pg, edge_rating_property_name, latent, size);
+    break;
+  case arrow::Int64Type::type_id:
+    rmse = RootMeanSquaredError<int64_t>(
+        pg, edge_rating_property_name, latent, size);
+    break;
+  case arrow::FloatType::type_id:
+    rmse = RootMeanSquaredError<float>(
+        pg, edge_rating_property_name, latent, size);
+    break;
+  case arrow::DoubleType::type_id:
+    rmse = RootMeanSquaredError<double>(
+        pg, edge_rating_property_name, latent, size);
+    break;
+  default:
+    break;
+  }
+  if (!rmse) {
+    return rmse.error();
+  }
+
+  uint64_t n_items = NumItems(pg->topology());
+  return MatrixCompletionStatistics{
+      n_items, pg->topology().num_nodes() - n_items, rmse.value()};
+}
+
+void
+katana::analytics::MatrixCompletionStatistics::Print(std::ostream& os) const {
+  os << "Number of items = " << n_items << std::endl;
+  os << "Number of users = " << n_users << std::endl;
+  os << "RMSE = " << rmse << std::endl;
+}
@@ -0,0 +1,648 @@
+#include "katana/analytics/max_flow/max_flow.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Cancellation.h"
+#include "katana/Frontier.h"
+#include "katana/LargeArray.h"
+#include "katana/Reduction.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using Height = uint64_t;
+
+/// Goldberg's factor of the number of nodes in the default global relabeling
+/// interval
+constexpr uint64_t kGlobalRelabelAlpha = 6;
+
+/// The residual graph in CSR form. The arcs of each node are its out-edges,
+/// with their capacities, followed by the reverses of its in-edges, with no
+/// capacity of their own.
+struct ResidualGraph {
+  std::vector<uint64_t> offsets;
+  std::vector<Node> heads;
+  /// The reverse of each arc
+  std::vector<uint64_t> mates;
+  /// The forward arc of each edge
+  std::vector<uint64_t> edge_arcs;
+
+  ResidualGraph(
+      const katana::GraphTopology& topology,
+      const katana::InEdgeIndex& in_edges)
+      : offsets(topology.num_nodes() + 1),
+        heads(2 * topology.num_edges()),
+        mates(2 * topology.num_edges()),
+        edge_arcs(topology.num_edges()) {
+    std::vector<uint64_t> reverse_arcs(topology.num_edges());
+    offsets[topology.num_nodes()] = heads.size();
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node n) {
+          uint64_t arc = topology.edge_range(n).first +
+                         in_edges.topology.edge_range(n).first;
+          offsets[n] = arc;
+          for (Edge e : topology.edges(n)) {
+            heads[arc] = topology.edge_dest(e);
+            edge_arcs[e] = arc++;
+          }
+          for (Edge e : in_edges.in_edges(n)) {
+            heads[arc] = in_edges.in_edge_src(e);
+            reverse_arcs[in_edges.out_edge_id(e)] = arc++;
+          }
+        },
+        katana::steal(), katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, topology.num_edges()),
+        [&](Edge e) {
+          mates[edge_arcs[e]] = reverse_arcs[e];
+          mates[reverse_arcs[e]] = edge_arcs[e];
+        },
+        katana::no_stats());
+  }
+
+  uint64_t arc_begin(Node n) const { return offsets[n]; }
+  uint64_t arc_end(Node n) const { return offsets[n + 1]; }
+};
+
+/// Parallel push-relabel in rounds. Each active node is discharged by one
+/// thread per round, which is the only one to change its height, while its
+/// residual capacities and excess are updated atomically by its neighbors.
+class PushRelabel {
+  const ResidualGraph& graph_;
+  Node num_nodes_;
+  Node source_;
+  Node sink_;
+  /// The height nodes get when a global relabeling cannot reach them
+  Height unreached_;
+
+  katana::LargeArray<std::atomic<int64_t>> residual_;
+  katana::LargeArray<std::atomic<int64_t>> excess_;
+  katana::LargeArray<std::atomic<Height>> height_;
+  /// The number of nodes at each height below num_nodes_
+  katana::LargeArray<std::atomic<uint64_t>> height_count_;
+  /// The last round each node was activated for, so a sparse frontier holds
+  /// it once
+  katana::LargeArray<std::atomic<uint32_t>> stamp_;
+  uint32_t round_{0};
+
+  katana::Frontier current_;
+  katana::Frontier next_;
+
+  void Activate(Node n) {
+    if (n != source_ && n != sink_ && stamp_[n].exchange(round_) != round_) {
+      next_.push(n);
+    }
+  }
+
+  /// Push the excess of n to lower neighbors and relabel it until none is
+  /// left. Returns the number of arcs scanned.
+  uint64_t Discharge(Node n, katana::GReduceMin<Height>* gap) {
+    uint64_t work = 0;
+    Height height = height_[n].load(std::memory_order_relaxed);
+    int64_t excess;
+    while ((excess = excess_[n].load()) > 0) {
+      Height lowest = std::numeric_limits<Height>::max();
+      for (uint64_t arc = graph_.arc_begin(n);
+           arc < graph_.arc_end(n) && excess > 0; ++arc) {
+        int64_t capacity = residual_[arc].load();
+        if (capacity <= 0) {
+          continue;
+        }
+        Node dest = graph_.heads[arc];
+        Height dest_height = height_[dest].load();
+        if (dest_height >= height) {
+          lowest = std::min(lowest, dest_height);
+          continue;
+        }
+        int64_t amount = std::min(excess, capacity);
+        residual_[arc].fetch_sub(amount);
+        residual_[graph_.mates[arc]].fetch_add(amount);
+        excess_[n].fetch_sub(amount);
+        excess -= amount;
+        if (excess_[dest].fetch_add(amount) == 0) {
+          Activate(dest);
+        }
+      }
+      work += graph_.arc_end(n) - graph_.arc_begin(n);
+      if (excess <= 0) {
+        continue;
+      }
+      // Every lower neighbor is saturated; a node with excess has a residual
+      // path back to the source, so some arc is left
+      if (lowest == std::numeric_limits<Height>::max()) {
+        break;
+      }
+      Height new_height = lowest + 1;
+      if (height < num_nodes_ && height_count_[height].fetch_sub(1) == 1 &&
+          height > 0) {
+        gap->update(height);
+      }
+      if (new_height < num_nodes_) {
+        height_count_[new_height].fetch_add(1);
+      }
+      height_[n].store(new_height);
+      height = new_height;
+    }
+    return work;
+  }
+
+  /// Breadth-first search over the reverses of residual arcs from root,
+  /// giving each unreached node its distance plus root_height
+  void Search(Node root, Height root_height, bool count) {
+    katana::Frontier current(num_nodes_);
+    katana::Frontier next(num_nodes_);
+    next.push(root);
+    for (Height height = root_height; !next.empty(); ++height) {
+      if (count && height < num_nodes_) {
+        height_count_[height] = next.size();
+      }
+      current.swap(next);
+      next.Reset(current.is_dense());
+      current.ForEach(
+          [&](Node n) {
+            for (uint64_t arc = graph_.arc_begin(n); arc < graph_.arc_end(n);
+                 ++arc) {
+              if (residual_[graph_.mates[arc]].load() <= 0) {
+                continue;
+              }
+              Node src = graph_.heads[arc];
+              Height expected = unreached_;
+              if (height_[src].compare_exchange_strong(expected, height + 1)) {
+                next.push(src);
+              }
+            }
+          },
+          "MaxFlow-GlobalRelabel");
+      next.Adapt();
+    }
+  }
+
+  /// Set every height to the residual distance to the sink, or for nodes
+  /// that cannot reach it, to num_nodes_ plus the distance to the source,
+  /// and activate every node with excess
+  void GlobalRelabel() {
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes_),
+        [&](Node n) {
+          height_[n] = unreached_;
+          height_count_[n] = 0;
+        },
+        katana::no_stats());
+    height_[source_] = num_nodes_;
+    height_[sink_] = 0;
+    Search(sink_, 0, true);
+    Search(source_, num_nodes_, false);
+
+    next_.clear();
+    ++round_;
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes_),
+        [&](Node n) {
+          if (excess_[n].load() > 0) {
+            Activate(n);
+          }
+        },
+        katana::no_stats());
+    next_.Adapt();
+  }
+
+  /// No node above the empty height gap can reach the sink, so lift those
+  /// below num_nodes_ to it
+  void Gap(Height gap) {
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes_),
+        [&](Node n) {
+          Height height = height_[n].load();
+          if (height > gap && height < num_nodes_) {
+            height_[n] = num_nodes_;
+          }
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(Height{gap + 1}, Height{num_nodes_}),
+        [&](Height height) { height_count_[height] = 0; }, katana::no_stats());
+  }
+
+public:
+  PushRelabel(
+      const ResidualGraph& graph, const std::vector<int64_t>& capacities,
+      Node source, Node sink)
+      : graph_(graph),
+        num_nodes_(graph.offsets.size() - 1),
+        source_(source),
+        sink_(sink),
+        unreached_(2 * static_cast<Height>(num_nodes_)),
+        current_(num_nodes_),
+        next_(num_nodes_) {
+    residual_.allocateBlocked(graph.heads.size());
+    excess_.allocateBlocked(num_nodes_);
+    height_.allocateBlocked(num_nodes_);
+    height_count_.allocateBlocked(num_nodes_);
+    stamp_.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{graph.heads.size()}),
+        [&](uint64_t arc) { residual_.constructAt(arc, 0); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{capacities.size()}),
+        [&](Edge e) { residual_[graph.edge_arcs[e]] = capacities[e]; },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes_),
+        [&](Node n) {
+          excess_.constructAt(n, 0);
+          height_.constructAt(n, 0);
+          height_count_.constructAt(n, 0);
+          stamp_.constructAt(n, 0);
+        },
+        katana::no_stats());
+  }
+
+  /// Run to completion, leaving the flow in the residual capacities of the
+  /// reverse arcs
+  katana::Result<void> Run(uint64_t global_relabel_interval) {
+    if (global_relabel_interval == MaxFlowPlan::kDefaultGlobalRelabelInterval) {
+      global_relabel_interval =
+          kGlobalRelabelAlpha * num_nodes_ + graph_.heads.size() / 2;
+    }
+
+    // Saturate the edges out of the source
+    katana::do_all(
+        katana::iterate(graph_.arc_begin(source_), graph_.arc_end(source_)),
+        [&](uint64_t arc) {
+          Node dest = graph_.heads[arc];
+          int64_t capacity = residual_[arc].load();
+          if (dest == source_ || capacity <= 0) {
+            return;
+          }
+          residual_[arc] = 0;
+          residual_[graph_.mates[arc]].fetch_add(capacity);
+          excess_[dest].fetch_add(capacity);
+        },
+        katana::no_stats());
+    GlobalRelabel();
+
+    uint64_t work_since_relabel = 0;
+    uint64_t work_since_gap = 0;
+    while (!next_.empty()) {
+      if (katana::IsCancelled()) {
+        return katana::ErrorCode::Cancelled;
+      }
+      current_.swap(next_);
+      next_.Reset(current_.is_dense());
+      ++round_;
+
+      katana::GAccumulator<uint64_t> work;
+      katana::GReduceMin<Height> gap;
+      current_.ForEach(
+          [&](Node n) { work += Discharge(n, &gap); }, "MaxFlow-Discharge");
+      next_.Adapt();
+
+      work_since_relabel += work.reduce();
+      work_since_gap += work.reduce();
+      if (work_since_relabel >= global_relabel_interval) {
+        GlobalRelabel();
+        work_since_relabel = 0;
+        continue;
+      }
+      Height lowest_gap = gap.reduce();
+      if (lowest_gap != std::numeric_limits<Height>::max() &&
+          height_count_[lowest_gap].load() == 0 &&
+          work_since_gap >= num_nodes_) {
+        Gap(lowest_gap);
+        work_since_gap = 0;
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+  /// The flow on edge e
+  int64_t flow(Edge e) const {
+    return residual_[graph_.mates[graph_.edge_arcs[e]]].load();
+  }
+};
+
+template <typename Capacity>
+katana::Result<std::vector<int64_t>>
+EdgeValues(katana::PropertyGraph* pg, const std::string& property_name) {
+  auto values_result = pg->GetEdgePropertyTyped<Capacity>(property_name);
+  if (!values_result) {
+    return values_result.error();
+  }
+  auto values = values_result.value();
+
+  std::vector<int64_t> result(pg->topology().num_edges());
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{result.size()}),
+      [&](Edge e) {
+        Capacity value = values->Value(e);
+        if constexpr (std::is_signed_v<Capacity>) {
+          if (value < 0) {
+            out_of_range.update(true);
+          }
+        } else if (
+            static_cast<uint64_t>(value) >
+            static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+          out_of_range.update(true);
+        }
+        result[e] = value;
+      },
+      katana::no_stats());
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge property {} has values that are negative or too large",
+        property_name);
+  }
+  return result;
+}
+
+template <typename Capacity>
+katana::Result<void>
+MaxFlowWithWrap(
+    katana::PropertyGraph* pg, Node source, Node sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name, MaxFlowPlan plan) {
+  auto capacities_result =
+      EdgeValues<Capacity>(pg, edge_capacity_property_name);
+  if (!capacities_result) {
+    return capacities_result.error();
+  }
+
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+  ResidualGraph graph(pg->topology(), *in_edges_result.value());
+
+  PushRelabel algo(graph, capacities_result.value(), source, sink);
+  if (auto r = algo.Run(plan.global_relabel_interval()); !r) {
+    return r.error();
+  }
+
+  std::vector<Capacity> flows(pg->topology().num_edges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{flows.size()}),
+      [&](Edge e) { flows[e] = algo.flow(e); }, katana::no_stats());
+
+  using ArrowType = typename arrow::CTypeTraits<Capacity>::ArrowType;
+  auto type = arrow::TypeTraits<ArrowType>::type_singleton();
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, type)}),
+      {std::make_shared<arrow::ChunkedArray>(
+          arrow::ArrayVector{katana::BuildArray(flows)})});
+  if (auto r = pg->AddEdgeProperties(table); !r) {
+    return r.error();
+  }
+  return katana::ResultSuccess();
+}
+
+/// The capacities and flows of a flow computed by MaxFlow
+struct FlowValues {
+  std::vector<int64_t> capacities;
+  std::vector<int64_t> flows;
+};
+
+template <typename Capacity>
+katana::Result<FlowValues>
+ReadFlowWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_capacity_property_name,
+    const std::string& output_property_name) {
+  auto capacities_result =
+      EdgeValues<Capacity>(pg, edge_capacity_property_name);
+  if (!capacities_result) {
+    return capacities_result.error();
+  }
+  auto flows_result = EdgeValues<Capacity>(pg, output_property_name);
+  if (!flows_result) {
+    return flows_result.error();
+  }
+  return FlowValues{
+      std::move(capacities_result.value()), std::move(flows_result.value())};
+}
+
+katana::Result<FlowValues>
+ReadFlow(
+    katana::PropertyGraph* pg, const std::string& edge_capacity_property_name,
+    const std::string& output_property_name) {
+  auto capacities = pg->GetEdgeProperty(edge_capacity_property_name);
+  if (!capacities) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_capacity_property_name);
+  }
+
+  switch (capacities->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return ReadFlowWithWrap<uint32_t>(
+        pg, edge_capacity_property_name, output_property_name);
+  case arrow::Int32Type::type_id:
+    return ReadFlowWithWrap<int32_t>(
+        pg, edge_capacity_property_name, output_property_name);
+  case arrow::UInt64Type::type_id:
+    return ReadFlowWithWrap<uint64_t>(
+        pg, edge_capacity_property_name, output_property_name);
+  case arrow::Int64Type::type_id:
+    return ReadFlowWithWrap<int64_t>(
+        pg, edge_capacity_property_name, output_property_name);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MaxFlow(
+    katana::PropertyGraph* pg, uint32_t source_id, uint32_t sink_id,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name, MaxFlowPlan plan) {
+  if (plan.algorithm() != MaxFlowPlan::kPushRelabel) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        static_cast<int>(plan.algorithm()));
+  }
+  if (source_id >= pg->topology().num_nodes() ||
+      sink_id >= pg->topology().num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no node {}",
+        std::max(source_id, sink_id));
+  }
+  if (source_id == sink_id) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source and sink are both node {}", source_id);
+  }
+  auto capacities = pg->GetEdgeProperty(edge_capacity_property_name);
+  if (!capacities) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_capacity_property_name);
+  }
+
+  switch (capacities->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return MaxFlowWithWrap<uint32_t>(
+        pg, source_id, sink_id, edge_capacity_property_name,
+        output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return MaxFlowWithWrap<int32_t>(
+        pg, source_id, sink_id, edge_capacity_property_name,
+        output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return MaxFlowWithWrap<uint64_t>(
+        pg, source_id, sink_id, edge_capacity_property_name,
+        output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return MaxFlowWithWrap<int64_t>(
+        pg, source_id, sink_id, edge_capacity_property_name,
+        output_property_name, plan);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+katana::Result<void>
+katana::analytics::MaxFlowAssertValid(
+    katana::PropertyGraph* pg, uint32_t source_id, uint32_t sink_id,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name) {
+  const katana::GraphTopology& topology = pg->topology();
+  if (source_id >= topology.num_nodes() || sink_id >= topology.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no node {}",
+        std::max(source_id, sink_id));
+  }
+  auto values_result =
+      ReadFlow(pg, edge_capacity_property_name, output_property_name);
+  if (!values_result) {
+    return values_result.error();
+  }
+  const FlowValues& values = values_result.value();
+
+  for (Edge e = 0; e < topology.num_edges(); ++e) {
+    if (values.flows[e] > values.capacities[e]) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "edge {} has flow {} above its capacity {}", e, values.flows[e],
+          values.capacities[e]);
+    }
+  }
+
+  katana::LargeArray<std::atomic<int64_t>> net_flow;
+  net_flow.allocateBlocked(topology.num_nodes());
+  katana::do_all(
+      katana::iterate(topology), [&](Node n) { net_flow.constructAt(n, 0); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        for (Edge e : topology.edges(n)) {
+          net_flow[n].fetch_sub(values.flows[e]);
+          net_flow[topology.edge_dest(e)].fetch_add(values.flows[e]);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    if (n != source_id && n != sink_id && net_flow[n].load() != 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "flow is not conserved at node {}, which gains {}", n,
+          net_flow[n].load());
+    }
+  }
+
+  // The flow is maximum if and only if the sink is not reachable from the
+  // source in the residual graph
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+  const katana::InEdgeIndex& in_edges = *in_edges_result.value();
+  std::vector<uint8_t> visited(topology.num_nodes());
+  std::deque<Node> queue{source_id};
+  visited[source_id] = true;
+  auto visit = [&](Node n) {
+    if (!visited[n]) {
+      visited[n] = true;
+      queue.emplace_back(n);
+    }
+  };
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop_front();
+    if (n == sink_id) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "the flow is not maximum: the sink is reachable in the residual "
+          "graph");
+    }
+    for (Edge e : topology.edges(n)) {
+      if (values.flows[e] < values.capacities[e]) {
+        visit(topology.edge_dest(e));
+      }
+    }
+    for (Edge e : in_edges.in_edges(n)) {
+      if (values.flows[in_edges.out_edge_id(e)] > 0) {
+        visit(in_edges.in_edge_src(e));
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<MaxFlowStatistics>
+katana::analytics::MaxFlowStatistics::Compute(
+    katana::PropertyGraph* pg, uint32_t source_id,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name) {
+  const katana::GraphTopology& topology = pg->topology();
+  if (source_id >= topology.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no node {}", source_id);
+  }
+  auto values_result =
+      ReadFlow(pg, edge_capacity_property_name, output_property_name);
+  if (!values_result) {
+    return values_result.error();
+  }
+  const FlowValues& values = values_result.value();
+
+  katana::GAccumulator<int64_t> flow_value;
+  katana::GAccumulator<uint64_t> n_saturated_edges;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        for (Edge e : topology.edges(n)) {
+          if (n == source_id) {
+            flow_value += values.flows[e];
+          }
+          if (topology.edge_dest(e) == source_id) {
+            flow_value -= values.flows[e];
+          }
+          if (values.capacities[e] > 0 &&
+              values.flows[e] == values.capacities[e]) {
+            n_saturated_edges += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return MaxFlowStatistics{flow_value.reduce(), n_saturated_edges.reduce()};
+}
+
+void
+katana::analytics::MaxFlowStatistics::Print(std::ostream& os) const {
+  os << "Flow value = " << flow_value << std::endl;
+  os << "Saturated edges = " << n_saturated_edges << std::endl;
+}
@@ -0,0 +1,590 @@
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "katana/Cancellation.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// The lightest edge of a component that has no edge to another component
+constexpr uint64_t kNoEdge = std::numeric_limits<uint64_t>::max();
+
+/// An edge between two components, named by their roots
+template <typename Weight>
+struct CrossingEdge {
+  Node src;
+  Node dst;
+  Weight weight;
+  Edge id;
+};
+
+/// Boruvka's algorithm over flat arrays. Components are named by a root
+/// node; parent_ maps each root of the current round to the root it joins.
+/// Edges are ordered by weight and then by id, so the lightest edge of each
+/// component is unique and the forest is the same for every schedule.
+template <typename Weight>
+class Boruvka {
+  const katana::GraphTopology& topology_;
+  const Weight* weights_;
+
+  std::vector<std::atomic<Node>> parent_;
+  /// The lightest edge of each root in this round, as an edge id in the
+  /// first round and as a position in edges_ after it
+  std::vector<std::atomic<uint64_t>> lightest_;
+  std::vector<Node> roots_;
+  std::vector<Node> next_roots_;
+  std::vector<CrossingEdge<Weight>> edges_;
+  std::vector<CrossingEdge<Weight>> next_edges_;
+
+public:
+  /// Whether each edge is in the forest
+  std::vector<uint8_t> in_forest;
+
+  Boruvka(const katana::GraphTopology& topology, const Weight* weights)
+      : topology_(topology),
+        weights_(weights),
+        parent_(topology.num_nodes()),
+        lightest_(topology.num_nodes()),
+        roots_(topology.num_nodes()),
+        in_forest(topology.num_edges(), 0) {
+    katana::do_all(
+        katana::iterate(Node{0}, static_cast<Node>(topology.num_nodes())),
+        [&](Node n) {
+          parent_[n].store(n, std::memory_order_relaxed);
+          lightest_[n].store(kNoEdge, std::memory_order_relaxed);
+          roots_[n] = n;
+        },
+        katana::no_stats());
+  }
+
+  katana::Result<void> Run() {
+    if (!FirstRound()) {
+      return katana::ResultSuccess();
+    }
+    BuildCrossingEdges();
+    while (!edges_.empty()) {
+      if (katana::IsCancelled()) {
+        return katana::ErrorCode::Cancelled;
+      }
+      if (!Round()) {
+        break;
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  /// Make \p candidate the lightest edge of \p root unless it has a
+  /// lighter one
+  template <typename Lighter>
+  void Offer(Node root, uint64_t candidate, const Lighter& lighter) {
+    std::atomic<uint64_t>& slot = lightest_[root];
+    uint64_t current = slot.load(std::memory_order_relaxed);
+    while (current == kNoEdge || lighter(candidate, current)) {
+      if (slot.compare_exchange_weak(
+              current, candidate, std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+  /// \returns the node whose out-edge \p e is
+  Node EdgeSource(Edge e) const {
+    const uint64_t* indices = topology_.out_indices->raw_values();
+    return std::upper_bound(indices, indices + topology_.num_nodes(), e) -
+           indices;
+  }
+
+  /// Join every root to the other end of its lightest edge, add that edge
+  /// to the forest and pointer jump until parent_ maps every root of this
+  /// round to the root of its new component. \p other_end(root, candidate)
+  /// is the other endpoint of a candidate edge and \p edge_id(candidate)
+  /// its edge id. \returns false if no root has a lightest edge.
+  template <typename OtherEnd, typename EdgeId>
+  bool Hook(const OtherEnd& other_end, const EdgeId& edge_id) {
+    katana::GReduceLogicalOr hooked;
+    katana::do_all(
+        katana::iterate(roots_),
+        [&](Node root) {
+          uint64_t candidate = lightest_[root].load(std::memory_order_relaxed);
+          if (candidate == kNoEdge) {
+            return;
+          }
+          hooked.update(true);
+          Node other = other_end(root, candidate);
+          // Two components joined by the same lightest edge would point at
+          // each other; the lesser one stays a root and adds the edge.
+          bool mutual =
+              lightest_[other].load(std::memory_order_relaxed) == candidate;
+          if (!mutual || root < other) {
+            in_forest[edge_id(candidate)] = 1;
+          }
+          if (!mutual || root > other) {
+            parent_[root].store(other, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::loopname("MinimumSpanningForest-Hook"));
+    if (!hooked.reduce()) {
+      return false;
+    }
+
+    // The picked edges form trees, so jumping converges in a logarithmic
+    // number of passes. Concurrent jumps only ever read ancestors.
+    bool jumped = true;
+    while (jumped) {
+      katana::GReduceLogicalOr changed;
+      katana::do_all(
+          katana::iterate(roots_),
+          [&](Node root) {
+            Node parent = parent_[root].load(std::memory_order_relaxed);
+            Node grandparent = parent_[parent].load(std::memory_order_relaxed);
+            if (parent != grandparent) {
+              parent_[root].store(grandparent, std::memory_order_relaxed);
+              changed.update(true);
+            }
+          },
+          katana::loopname("MinimumSpanningForest-Jump"));
+      jumped = changed.reduce();
+    }
+
+    katana::do_all(
+        katana::iterate(roots_),
+        [&](Node root) {
+          lightest_[root].store(kNoEdge, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    next_roots_.resize(roots_.size());
+    auto end = katana::ParallelSTL::copy_if(
+        roots_.begin(), roots_.end(), next_roots_.begin(), [&](Node root) {
+          return parent_[root].load(std::memory_order_relaxed) == root;
+        });
+    next_roots_.resize(end - next_roots_.begin());
+    std::swap(roots_, next_roots_);
+    return true;
+  }
+
+  /// The first round reads the edges of the topology in place, since every
+  /// node is its own component.
+  bool FirstRound() {
+    auto lighter = [&](Edge a, Edge b) {
+      return weights_[a] < weights_[b] ||
+             (weights_[a] == weights_[b] && a < b);
+    };
+    katana::do_all(
+        katana::iterate(Node{0}, static_cast<Node>(topology_.num_nodes())),
+        [&](Node src) {
+          for (Edge e : topology_.edges(src)) {
+            Node dst = topology_.edge_dest(e);
+            if (dst != src) {
+              Offer(src, e, lighter);
+              Offer(dst, e, lighter);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<64>(),
+        katana::loopname("MinimumSpanningForest-FirstLightest"));
+
+    return Hook(
+        [&](Node root, uint64_t e) {
+          Node dst = topology_.edge_dest(e);
+          return dst != root ? dst : EdgeSource(e);
+        },
+        [](uint64_t e) { return e; });
+  }
+
+  /// Copy the edges between distinct components after the first round
+  /// into edges_, with their endpoints replaced by their roots
+  void BuildCrossingEdges() {
+    uint64_t num_nodes = topology_.num_nodes();
+    auto root_of = [&](Node n) {
+      return parent_[n].load(std::memory_order_relaxed);
+    };
+    auto crossing = [&](Node src, Edge e) {
+      return root_of(src) != root_of(topology_.edge_dest(e));
+    };
+
+    std::vector<uint64_t> offsets(num_nodes + 1, 0);
+    katana::do_all(
+        katana::iterate(Node{0}, static_cast<Node>(num_nodes)),
+        [&](Node src) {
+          uint64_t count = 0;
+          for (Edge e : topology_.edges(src)) {
+            count += crossing(src, e);
+          }
+          offsets[src + 1] = count;
+        },
+        katana::steal(), katana::chunk_size<64>(),
+        katana::loopname("MinimumSpanningForest-CountCrossing"));
+    katana::ParallelSTL::partial_sum(
+        offsets.begin(), offsets.end(), offsets.begin());
+
+    edges_.resize(offsets.back());
+    katana::do_all(
+        katana::iterate(Node{0}, static_cast<Node>(num_nodes)),
+        [&](Node src) {
+          uint64_t pos = offsets[src];
+          for (Edge e : topology_.edges(src)) {
+            if (crossing(src, e)) {
+              edges_[pos++] = CrossingEdge<Weight>{
+                  root_of(src), root_of(topology_.edge_dest(e)), weights_[e],
+                  e};
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<64>(),
+        katana::loopname("MinimumSpanningForest-CopyCrossing"));
+  }
+
+  /// A round over the crossing edges, which relabels their endpoints and
+  /// drops the edges that became internal to a component
+  bool Round() {
+    auto lighter = [&](uint64_t a, uint64_t b) {
+      const CrossingEdge<Weight>& x = edges_[a];
+      const CrossingEdge<Weight>& y = edges_[b];
+      return x.weight < y.weight || (x.weight == y.weight && x.id < y.id);
+    };
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{edges_.size()}),
+        [&](uint64_t i) {
+          Offer(edges_[i].src, i, lighter);
+          Offer(edges_[i].dst, i, lighter);
+        },
+        katana::loopname("MinimumSpanningForest-Lightest"));
+
+    bool hooked = Hook(
+        [&](Node root, uint64_t i) {
+          return edges_[i].src != root ? edges_[i].src : edges_[i].dst;
+        },
+        [&](uint64_t i) { return edges_[i].id; });
+    if (!hooked) {
+      return false;
+    }
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{edges_.size()}),
+        [&](uint64_t i) {
+          CrossingEdge<Weight>& edge = edges_[i];
+          edge.src = parent_[edge.src].load(std::memory_order_relaxed);
+          edge.dst = parent_[edge.dst].load(std::memory_order_relaxed);
+        },
+        katana::loopname("MinimumSpanningForest-Relabel"));
+    next_edges_.resize(edges_.size());
+    auto end = katana::ParallelSTL::copy_if(
+        edges_.begin(), edges_.end(), next_edges_.begin(),
+        [](const CrossingEdge<Weight>& e) { return e.src != e.dst; });
+    next_edges_.resize(end - next_edges_.begin());
+    std::swap(edges_, next_edges_);
+    return true;
+  }
+};
+
+/// Pack flags into an arrow boolean array
+katana::Result<std::shared_ptr<arrow::Array>>
+BuildBooleanArray(const std::vector<uint8_t>& flags) {
+  uint64_t num_bytes = (flags.size() + 7) / 8;
+  auto buffer_res = arrow::AllocateBuffer(num_bytes);
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} bytes: {}", num_bytes,
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> bitmap = std::move(buffer_res.ValueOrDie());
+  uint8_t* bits = bitmap->mutable_data();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_bytes),
+      [&](uint64_t b) {
+        uint8_t byte = 0;
+        for (uint64_t i = 0; i < 8 && 8 * b + i < flags.size(); ++i) {
+          byte |= flags[8 * b + i] << i;
+        }
+        bits[b] = byte;
+      },
+      katana::no_stats());
+  return std::make_shared<arrow::BooleanArray>(flags.size(), bitmap);
+}
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  auto weights_result =
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+
+  Boruvka<Weight> algo(pg->topology(), weights_result.value()->raw_values());
+  if (auto r = algo.Run(); !r) {
+    return r.error();
+  }
+
+  auto array_res = BuildBooleanArray(algo.in_forest);
+  if (!array_res) {
+    return array_res.error();
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::boolean())}),
+      {array_res.value()});
+  return pg->AddEdgeProperties(table);
+}
+
+/// The minimum spanning forest found serially by Kruskal's algorithm, with
+/// ties broken by edge id as in Boruvka
+template <typename Weight>
+katana::Result<std::vector<uint8_t>>
+KruskalForest(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  auto weights_result =
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto weights = weights_result.value();
+  const katana::GraphTopology& topology = pg->topology();
+
+  std::vector<Node> sources(topology.num_edges());
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    for (Edge e : topology.edges(n)) {
+      sources[e] = n;
+    }
+  }
+  std::vector<Edge> order(topology.num_edges());
+  std::iota(order.begin(), order.end(), Edge{0});
+  katana::ParallelSTL::sort(order.begin(), order.end(), [&](Edge a, Edge b) {
+    return weights->Value(a) < weights->Value(b) ||
+           (weights->Value(a) == weights->Value(b) && a < b);
+  });
+
+  std::vector<Node> parent(topology.num_nodes());
+  std::iota(parent.begin(), parent.end(), Node{0});
+  auto find = [&](Node n) {
+    while (parent[n] != n) {
+      parent[n] = parent[parent[n]];
+      n = parent[n];
+    }
+    return n;
+  };
+
+  std::vector<uint8_t> in_forest(topology.num_edges(), 0);
+  for (Edge e : order) {
+    Node src = find(sources[e]);
+    Node dst = find(topology.edge_dest(e));
+    if (src != dst) {
+      parent[std::max(src, dst)] = std::min(src, dst);
+      in_forest[e] = 1;
+    }
+  }
+  return in_forest;
+}
+
+/// \returns the total weight of the edges marked in \p in_forest
+template <typename Weight>
+katana::Result<double>
+ForestWeight(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const arrow::BooleanArray* in_forest) {
+  auto weights_result =
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto weights = weights_result.value();
+
+  katana::GAccumulator<double> total;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->topology().num_edges()),
+      [&](uint64_t e) {
+        if (in_forest->Value(e)) {
+          total += weights->Value(e);
+        }
+      },
+      katana::no_stats());
+  return total.reduce();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForest(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MinimumSpanningForestPlan plan) {
+  if (plan.algorithm() != MinimumSpanningForestPlan::kBoruvka) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        static_cast<int>(plan.algorithm()));
+  }
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return MinimumSpanningForestWithWrap<uint32_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int32Type::type_id:
+    return MinimumSpanningForestWithWrap<int32_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::UInt64Type::type_id:
+    return MinimumSpanningForestWithWrap<uint64_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int64Type::type_id:
+    return MinimumSpanningForestWithWrap<int64_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::FloatType::type_id:
+    return MinimumSpanningForestWithWrap<float>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::DoubleType::type_id:
+    return MinimumSpanningForestWithWrap<double>(
+        pg, edge_weight_property_name, output_property_name);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForestAssertValid(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  auto output_result = pg->GetEdgePropertyTyped<bool>(output_property_name);
+  if (!output_result) {
+    return output_result.error();
+  }
+  auto output = output_result.value();
+
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  katana::Result<std::vector<uint8_t>> expected_result =
+      katana::ErrorCode::TypeError;
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    expected_result = KruskalForest<uint32_t>(pg, edge_weight_property_name);
+    break;
+  case arrow::Int32Type::type_id:
+    expected_result = KruskalForest<int32_t>(pg, edge_weight_property_name);
+    break;
+  case arrow::UInt64Type::type_id:
+    expected_result = KruskalForest<uint64_t>(pg, edge_weight_property_name);
+    break;
+  case arrow::Int64Type::type_id:
+    expected_result = KruskalForest<int64_t>(pg, edge_weight_property_name);
+    break;
+  case arrow::FloatType::type_id:
+    expected_result = KruskalForest<float>(pg, edge_weight_property_name);
+    break;
+  case arrow::DoubleType::type_id:
+    expected_result = KruskalForest<double>(pg, edge_weight_property_name);
+    break;
+  default:
+    break;
+  }
+  if (!expected_result) {
+    return expected_result.error();
+  }
+  const std::vector<uint8_t>& expected = expected_result.value();
+
+  // Under the order by weight and then id the forest is unique, so it must
+  // be exactly the one Kruskal's algorithm finds
+  for (Edge e = 0; e < expected.size(); ++e) {
+    if (output->Value(e) != static_cast<bool>(expected[e])) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "edge {} is {}in the forest but should {}be", e,
+          output->Value(e) ? "" : "not ", expected[e] ? "" : "not ");
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<MinimumSpanningForestStatistics>
+katana::analytics::MinimumSpanningForestStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  auto output_result = pg->GetEdgePropertyTyped<bool>(output_property_name);
+  if (!output_result) {
+    return output_result.error();
+  }
+  auto output = output_result.value();
+
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  katana::Result<double> total_weight = katana::ErrorCode::TypeError;
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    total_weight =
+        ForestWeight<uint32_t>(pg, edge_weight_property_name, output.get());
+    break;
+  case arrow::Int32Type::type_id:
+    total_weight =
+        ForestWeight<int32_t>(pg, edge_weight_property_name, output.get());
+    break;
+  case arrow::UInt64Type::type_id:
+    total_weight =
+        ForestWeight<uint64_t>(pg, edge_weight_property_name, output.get());
+    break;
+  case arrow::Int64Type::type_id:
+    total_weight =
+        ForestWeight<int64_t>(pg, edge_weight_property_name, output.get());
+    break;
+  case arrow::FloatType::type_id:
+    total_weight =
+        ForestWeight<float>(pg, edge_weight_property_name, output.get());
+    break;
+  case arrow::DoubleType::type_id:
+    total_weight =
+        ForestWeight<double>(pg, edge_weight_property_name, output.get());
+    break;
+  default:
+    break;
+  }
+  if (!total_weight) {
+    return total_weight.error();
+  }
+
+  katana::GAccumulator<uint64_t> n_forest_edges;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->topology().num_edges()),
+      [&](uint64_t e) {
+        if (output->Value(e)) {
+          n_forest_edges += 1;
+        }
+      },
+      katana::no_stats());
+
+  // Every forest edge joins two trees that were separate
+  uint64_t n_trees = pg->topology().num_nodes() - n_forest_edges.reduce();
+  return MinimumSpanningForestStatistics{
+      n_forest_edges.reduce(), n_trees, total_weight.value()};
+}
+
+void
+katana::analytics::MinimumSpanningForestStatistics::Print(
+    std::ostream& os) const {
+  os << "Number of forest edges = " << n_forest_edges << std::endl;
+  os << "Number of trees = " << n_trees << std::endl;
+  os << "Total weight = " << total_weight << std::endl;
+}
@@ -0,0 +1,705 @@
+#include "katana/analytics/motif_count/motif_count.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "katana/Cancellation.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Relabel.h"
+#include "katana/SetIntersection.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr static const unsigned kChunkSize = 64U;
+
+struct NodeCount : public katana::PODProperty<uint64_t> {};
+
+using CountGraph =
+    katana::TypedPropertyGraph<std::tuple<NodeCount>, std::tuple<>>;
+
+/// A sorted list of neighbors
+struct Neighbors {
+  const Node* nodes;
+  size_t size;
+};
+
+/// \returns the neighbors of \p n with smaller ids. After relabeling by
+/// degree, these are the neighbors of higher degree.
+Neighbors
+LowerNeighbors(const katana::GraphTopology& topology, Node n) {
+  auto edges = topology.edges(n);
+  const Node* first = topology.edge_dests() + *edges.begin();
+  const Node* last = topology.edge_dests() + *edges.end();
+  return {first, static_cast<size_t>(std::lower_bound(first, last, n) - first)};
+}
+
+/// \returns the neighbors of \p n with ids larger than \p bound
+Neighbors
+UpperNeighbors(const katana::GraphTopology& topology, Node n, Node bound) {
+  auto edges = topology.edges(n);
+  const Node* first = topology.edge_dests() + *edges.begin();
+  const Node* last = topology.edge_dests() + *edges.end();
+  const Node* mid = std::upper_bound(first, last, bound);
+  return {mid, static_cast<size_t>(last - mid)};
+}
+
+void
+AddCount(std::vector<uint64_t>* counts, Node n, uint64_t count) {
+  __sync_fetch_and_add(&(*counts)[n], count);
+}
+
+/// Count the triangles of each node. Each triangle is found once, from its
+/// node with the largest id, by intersecting the lower neighbors of its two
+/// largest nodes.
+void
+CountTriangles(
+    const katana::GraphTopology& topology, std::vector<uint64_t>* triangles) {
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node u) {
+        Neighbors lower_u = LowerNeighbors(topology, u);
+        uint64_t at_u = 0;
+        for (size_t i = 0; i < lower_u.size; ++i) {
+          Node v = lower_u.nodes[i];
+          Neighbors lower_v = LowerNeighbors(topology, v);
+          uint64_t at_v = 0;
+          katana::ForEachSortedIntersection(
+              lower_u.nodes, i, lower_v.nodes, lower_v.size,
+              [&](size_t w, size_t) {
+                AddCount(triangles, lower_u.nodes[w], 1);
+                ++at_v;
+                return true;
+              });
+          if (at_v != 0) {
+            AddCount(triangles, v, at_v);
+            at_u += at_v;
+          }
+        }
+        if (at_u != 0) {
+          AddCount(triangles, u, at_u);
+        }
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(), katana::no_stats(),
+      katana::loopname("MotifCount_Triangles"));
+}
+
+/// Count the 4-cliques of each node. Like CountTriangles, each 4-clique is
+/// found from its node with the largest id: the lower neighbors common to
+/// its two largest nodes are the candidates for the two others.
+void
+CountFourCliques(
+    const katana::GraphTopology& topology, std::vector<uint64_t>* cliques) {
+  katana::PerThreadStorage<std::vector<Node>> per_thread_common;
+
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node u) {
+        std::vector<Node>& common = *per_thread_common.getLocal();
+        Neighbors lower_u = LowerNeighbors(topology, u);
+        uint64_t at_u = 0;
+        for (size_t i = 0; i < lower_u.size; ++i) {
+          Node v = lower_u.nodes[i];
+          Neighbors lower_v = LowerNeighbors(topology, v);
+          common.clear();
+          katana::ForEachSortedIntersection(
+              lower_u.nodes, i, lower_v.nodes, lower_v.size,
+              [&](size_t w, size_t) {
+                common.emplace_back(lower_u.nodes[w]);
+                return true;
+              });
+
+          uint64_t at_v = 0;
+          for (size_t j = 0; j < common.size(); ++j) {
+            Node w = common[j];
+            Neighbors lower_w = LowerNeighbors(topology, w);
+            uint64_t at_w = 0;
+            katana::ForEachSortedIntersection(
+                common.data(), j, lower_w.nodes, lower_w.size,
+                [&](size_t x, size_t) {
+                  AddCount(cliques, common[x], 1);
+                  ++at_w;
+                  return true;
+                });
+            if (at_w != 0) {
+              AddCount(cliques, w, at_w);
+              at_v += at_w;
+            }
+          }
+          if (at_v != 0) {
+            AddCount(cliques, v, at_v);
+            at_u += at_v;
+          }
+        }
+        if (at_u != 0) {
+          AddCount(cliques, u, at_u);
+        }
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(), katana::no_stats(),
+      katana::loopname("MotifCount_FourCliques"));
+}
+
+/// Count the 4-cycles of each node. Each 4-cycle is found once, from its
+/// node u with the smallest id: two of the wedges u - a - w with a and w
+/// larger than u close it. With c wedges between u and w, u and w are
+/// opposite in (c choose 2) 4-cycles and each middle node a is in c - 1 of
+/// them. After relabeling by degree, u is the node of highest degree and
+/// only the neighbor lists of nodes of lower degree are scanned.
+void
+CountFourCycles(
+    const katana::GraphTopology& topology, std::vector<uint64_t>* cycles) {
+  uint64_t num_nodes = topology.num_nodes();
+  katana::PerThreadStorage<std::vector<uint32_t>> per_thread_wedges;
+  katana::PerThreadStorage<std::vector<Node>> per_thread_ends;
+
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node u) {
+        std::vector<uint32_t>& wedges = *per_thread_wedges.getLocal();
+        std::vector<Node>& ends = *per_thread_ends.getLocal();
+        if (wedges.empty()) {
+          wedges.resize(num_nodes);
+        }
+
+        Neighbors upper_u = UpperNeighbors(topology, u, u);
+        for (size_t i = 0; i < upper_u.size; ++i) {
+          Neighbors upper_a = UpperNeighbors(topology, upper_u.nodes[i], u);
+          for (size_t j = 0; j < upper_a.size; ++j) {
+            Node w = upper_a.nodes[j];
+            if (wedges[w]++ == 0) {
+              ends.emplace_back(w);
+            }
+          }
+        }
+
+        uint64_t at_u = 0;
+        for (Node w : ends) {
+          uint64_t c = wedges[w];
+          uint64_t at_w = c * (c - 1) / 2;
+          if (at_w != 0) {
+            AddCount(cycles, w, at_w);
+            at_u += at_w;
+          }
+        }
+
+        if (at_u != 0) {
+          AddCount(cycles, u, at_u);
+          for (size_t i = 0; i < upper_u.size; ++i) {
+            Node a = upper_u.nodes[i];
+            Neighbors upper_a = UpperNeighbors(topology, a, u);
+            uint64_t at_a = 0;
+            for (size_t j = 0; j < upper_a.size; ++j) {
+              at_a += wedges[upper_a.nodes[j]] - 1;
+            }
+            if (at_a != 0) {
+              AddCount(cycles, a, at_a);
+            }
+          }
+        }
+
+        for (Node w : ends) {
+          wedges[w] = 0;
+        }
+        ends.clear();
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(), katana::no_stats(),
+      katana::loopname("MotifCount_FourCycles"));
+}
+
+/// Store \p counts, computed on a graph relabeled by \p perm, as node
+/// property \p name of \p pg
+katana::Result<void>
+WriteCounts(
+    katana::PropertyGraph* pg, const std::string& name,
+    const std::vector<uint64_t>& counts,
+    const std::optional<katana::NodePermutation>& perm) {
+  if (auto r = ConstructNodeProperties<std::tuple<NodeCount>>(pg, {name});
+      !r) {
+    return r.error();
+  }
+  auto graph_res = CountGraph::Make(pg, {name}, {});
+  if (!graph_res) {
+    return graph_res.error();
+  }
+  CountGraph graph = graph_res.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) {
+        graph.GetData<NodeCount>(n) = counts[perm ? perm->NewId(n) : n];
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+GetCounts(katana::PropertyGraph* pg, const std::string& name) {
+  auto counts_res = pg->GetNodePropertyTyped<uint64_t>(name);
+  if (!counts_res) {
+    return KATANA_ERROR(
+        counts_res.error(), "reading motif counts {}: {}", name,
+        counts_res.error());
+  }
+  return counts_res.value();
+}
+
+/// \returns n choose k for small k
+uint64_t
+Choose(uint64_t n, uint64_t k) {
+  if (n < k) {
+    return 0;
+  }
+  uint64_t result = 1;
+  for (uint64_t i = 0; i < k; ++i) {
+    result = result * (n - i) / (i + 1);
+  }
+  return result;
+}
+
+/// Check that the sum of motif counts \p name is a multiple of the motif
+/// size \p size and that no node of degree d has more than
+/// max_count(d) motifs
+template <typename MaxCountFn>
+katana::Result<void>
+AssertValidCounts(
+    katana::PropertyGraph* pg, const std::string& name, uint64_t size,
+    MaxCountFn max_count) {
+  if (name.empty()) {
+    return katana::ResultSuccess();
+  }
+  auto counts_res = GetCounts(pg, name);
+  if (!counts_res) {
+    return counts_res.error();
+  }
+  auto counts = counts_res.value();
+  const katana::GraphTopology& topology = pg->topology();
+
+  katana::GAccumulator<uint64_t> total;
+  katana::GAccumulator<uint64_t> too_many;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        total += counts->Value(n);
+        if (counts->Value(n) > max_count(topology.edges(n).size())) {
+          too_many += 1;
+        }
+      },
+      katana::no_stats());
+
+  if (too_many.reduce() != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} nodes have more motifs in {} than their degree allows",
+        too_many.reduce(), name);
+  }
+  if (total.reduce() % size != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "motifs in {} are counted {} times, not a multiple of {}", name,
+        total.reduce(), size);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<uint64_t>
+TotalMotifs(katana::PropertyGraph* pg, const std::string& name, uint64_t size) {
+  if (name.empty()) {
+    return 0;
+  }
+  auto counts_res = GetCounts(pg, name);
+  if (!counts_res) {
+    return counts_res.error();
+  }
+  auto counts = counts_res.value();
+
+  katana::GAccumulator<uint64_t> total;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_nodes()),
+      [&](uint64_t n) { total += counts->Value(n); }, katana::no_stats());
+  return total.reduce() / size;
+}
+
+constexpr uint8_t kOutArc = 1;
+constexpr uint8_t kInArc = 2;
+
+/// The TriadType of each triad code of Batagelj and Mrvar
+constexpr TriadCensus::TriadType kTriadTypes[64] = {
+    TriadCensus::k003,  TriadCensus::k012,  TriadCensus::k012,
+    TriadCensus::k102,  TriadCensus::k012,  TriadCensus::k021D,
+    TriadCensus::k021C, TriadCensus::k111U, TriadCensus::k012,
+    TriadCensus::k021C, TriadCensus::k021U, TriadCensus::k111D,
+    TriadCensus::k102,  TriadCensus::k111U, TriadCensus::k111D,
+    TriadCensus::k201,  TriadCensus::k012,  TriadCensus::k021C,
+    TriadCensus::k021D, TriadCensus::k111U, TriadCensus::k021U,
+    TriadCensus::k030T, TriadCensus::k030T, TriadCensus::k120U,
+    TriadCensus::k021C, TriadCensus::k030C, TriadCensus::k030T,
+    TriadCensus::k120C, TriadCensus::k111D, TriadCensus::k120C,
+    TriadCensus::k120D, TriadCensus::k210,  TriadCensus::k012,
+    TriadCensus::k021U, TriadCensus::k021C, TriadCensus::k111D,
+    TriadCensus::k021C, TriadCensus::k030T, TriadCensus::k030C,
+    TriadCensus::k120C, TriadCensus::k021D, TriadCensus::k030T,
+    TriadCensus::k030T, TriadCensus::k120D, TriadCensus::k111U,
+    TriadCensus::k120U, TriadCensus::k120C, TriadCensus::k210,
+    TriadCensus::k102,  TriadCensus::k111D, TriadCensus::k111U,
+    TriadCensus::k201,  TriadCensus::k111D, TriadCensus::k120D,
+    TriadCensus::k120C, TriadCensus::k210,  TriadCensus::k111U,
+    TriadCensus::k120C, TriadCensus::k120U, TriadCensus::k210,
+    TriadCensus::k201,  TriadCensus::k210,  TriadCensus::k210,
+    TriadCensus::k300,
+};
+
+/// The neighbors of each node in either direction, with the directions of
+/// the arcs to each as a mask of kOutArc and kInArc
+struct UndirectedNeighbors {
+  std::vector<uint64_t> offsets;
+  std::vector<Node> nodes;
+  std::vector<uint8_t> arcs;
+
+  Neighbors of(Node n) const {
+    return {nodes.data() + offsets[n], offsets[n + 1] - offsets[n]};
+  }
+  const uint8_t* arcs_of(Node n) const { return arcs.data() + offsets[n]; }
+};
+
+/// Call fn(neighbor, arcs) for each neighbor of \p n other than itself, in
+/// order, merging its sorted out-neighbors and in-neighbors
+template <typename F>
+void
+ForEachMergedNeighbor(
+    const katana::GraphTopology& topology, const katana::InEdgeIndex& in_index,
+    Node n, F fn) {
+  auto out_edges = topology.edges(n);
+  const Node* out = topology.edge_dests() + *out_edges.begin();
+  const Node* out_end = topology.edge_dests() + *out_edges.end();
+  auto in_edges = in_index.in_edges(n);
+  const Node* in = in_index.topology.edge_dests() + *in_edges.begin();
+  const Node* in_end = in_index.topology.edge_dests() + *in_edges.end();
+
+  while (out != out_end || in != in_end) {
+    Node next = (in == in_end || (out != out_end && *out <= *in)) ? *out : *in;
+    uint8_t arcs = 0;
+    for (; out != out_end && *out == next; ++out) {
+      arcs |= kOutArc;
+    }
+    for (; in != in_end && *in == next; ++in) {
+      arcs |= kInArc;
+    }
+    if (next != n) {
+      fn(next, arcs);
+    }
+  }
+}
+
+katana::Result<UndirectedNeighbors>
+MakeUndirectedNeighbors(const katana::GraphTopology& topology) {
+  auto in_index_res = katana::MakeInEdgeIndex(topology);
+  if (!in_index_res) {
+    return in_index_res.error();
+  }
+  const katana::InEdgeIndex& in_index = *in_index_res.value();
+  uint64_t num_nodes = topology.num_nodes();
+
+  UndirectedNeighbors neighbors;
+  std::vector<uint64_t> sizes(num_nodes);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        ForEachMergedNeighbor(
+            topology, in_index, n, [&](Node, uint8_t) { ++sizes[n]; });
+      },
+      katana::steal(), katana::no_stats());
+
+  neighbors.offsets.resize(num_nodes + 1);
+  katana::ParallelSTL::partial_sum(
+      sizes.begin(), sizes.end(), neighbors.offsets.begin() + 1);
+  neighbors.nodes.resize(neighbors.offsets[num_nodes]);
+  neighbors.arcs.resize(neighbors.offsets[num_nodes]);
+
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        uint64_t pos = neighbors.offsets[n];
+        ForEachMergedNeighbor(
+            topology, in_index, n, [&](Node neighbor, uint8_t arcs) {
+              neighbors.nodes[pos] = neighbor;
+              neighbors.arcs[pos] = arcs;
+              ++pos;
+            });
+      },
+      katana::steal(), katana::no_stats());
+  return neighbors;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MotifCount(
+    katana::PropertyGraph* pg, const std::string& triangles_property,
+    const std::string& four_cycles_property,
+    const std::string& four_cliques_property, MotifCountPlan plan) {
+  if (triangles_property.empty() && four_cycles_property.empty() &&
+      four_cliques_property.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no motifs to count");
+  }
+  if (plan.algorithm() != MotifCountPlan::kOrderedCount) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  bool relabel;
+  switch (plan.relabeling()) {
+  case MotifCountPlan::kNoRelabel:
+    relabel = false;
+    break;
+  case MotifCountPlan::kRelabel:
+    relabel = true;
+    break;
+  case MotifCountPlan::kAutoRelabel:
+    relabel = IsApproximateDegreeDistributionPowerLaw(*pg);
+    break;
+  default:
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  // Count on a copy so the users graph and its node order are unchanged
+  katana::PropertyGraph* work = pg;
+  std::unique_ptr<katana::PropertyGraph> copy;
+  if (relabel || !plan.edges_sorted()) {
+    auto copy_res = pg->Copy({}, {});
+    if (!copy_res) {
+      return copy_res.error();
+    }
+    copy = std::move(copy_res.value());
+    work = copy.get();
+  }
+
+  std::optional<katana::NodePermutation> perm;
+  if (relabel) {
+    auto perm_res = katana::ComputeNodeOrder(*work, katana::NodeOrder::kDegree);
+    if (!perm_res) {
+      return perm_res.error();
+    }
+    perm = std::move(perm_res.value());
+    if (auto r = work->ApplyNodePermutation(*perm); !r) {
+      return r.error();
+    }
+  }
+  if (relabel || !plan.edges_sorted()) {
+    if (auto r = katana::EnsureAllEdgesSortedByDest(work); !r) {
+      return r.error();
+    }
+  }
+
+  const katana::GraphTopology& topology = work->topology();
+  auto count_motif = [&](const std::string& name,
+                         auto count_fn) -> katana::Result<void> {
+    if (name.empty()) {
+      return katana::ResultSuccess();
+    }
+    std::vector<uint64_t> counts(topology.num_nodes());
+    count_fn(topology, &counts);
+    if (katana::IsCancelled()) {
+      return katana::ErrorCode::Cancelled;
+    }
+    return WriteCounts(pg, name, counts, perm);
+  };
+
+  katana::StatTimer exec_time("MotifCount", "MotifCount");
+  exec_time.start();
+  if (auto r = count_motif(triangles_property, CountTriangles); !r) {
+    return r.error();
+  }
+  if (auto r = count_motif(four_cycles_property, CountFourCycles); !r) {
+    return r.error();
+  }
+  if (auto r = count_motif(four_cliques_property, CountFourCliques); !r) {
+    return r.error();
+  }
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::MotifCountAssertValid(
+    katana::PropertyGraph* pg, const std::string& triangles_property,
+    const std::string& four_cycles_property,
+    const std::string& four_cliques_property) {
+  if (auto r = AssertValidCounts(
+          pg, triangles_property, 3, [](uint64_t d) { return Choose(d, 2); });
+      !r) {
+    return r.error();
+  }
+  // The opposite corners of the 4-cycles of a node are not its neighbors,
+  // so its degree does not bound their number
+  if (auto r = AssertValidCounts(
+          pg, four_cycles_property, 4,
+          [](uint64_t) { return std::numeric_limits<uint64_t>::max(); });
+      !r) {
+    return r.error();
+  }
+  if (auto r = AssertValidCounts(
+          pg, four_cliques_property, 4,
+          [](uint64_t d) { return Choose(d, 3); });
+      !r) {
+    return r.error();
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::MotifCountStatistics::Print(std::ostream& os) const {
+  os << "Total triangles = " << total_triangles << std::endl;
+  os << "Total 4-cycles = " << total_four_cycles << std::endl;
+  os << "Total 4-cliques = " << total_four_cliques << std::endl;
+}
+
+katana::Result<MotifCountStatistics>
+katana::analytics::MotifCountStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& triangles_property,
+    const std::string& four_cycles_property,
+    const std::string& four_cliques_property) {
+  auto triangles_res = TotalMotifs(pg, triangles_property, 3);
+  if (!triangles_res) {
+    return triangles_res.error();
+  }
+  auto cycles_res = TotalMotifs(pg, four_cycles_property, 4);
+  if (!cycles_res) {
+    return cycles_res.error();
+  }
+  auto cliques_res = TotalMotifs(pg, four_cliques_property, 4);
+  if (!cliques_res) {
+    return cliques_res.error();
+  }
+  return MotifCountStatistics{
+      triangles_res.value(), cycles_res.value(), cliques_res.value()};
+}
+
+const char*
+katana::analytics::TriadCensus::TypeName(TriadType type) {
+  constexpr const char* kNames[kNumTriadTypes] = {
+      "003",  "012",  "102",  "021D", "021U", "021C", "111D", "111U",
+      "030T", "030C", "201",  "120D", "120U", "120C", "210",  "300",
+  };
+  if (static_cast<size_t>(type) >= kNumTriadTypes) {
+    return "unknown";
+  }
+  return kNames[type];
+}
+
+void
+katana::analytics::TriadCensus::Print(std::ostream& os) const {
+  for (size_t type = 0; type < kNumTriadTypes; ++type) {
+    os << "Triads of type " << TypeName(static_cast<TriadType>(type)) << " = "
+       << counts[type] << std::endl;
+  }
+}
+
+katana::Result<TriadCensus>
+katana::analytics::DirectedTriadCensus(katana::PropertyGraph* pg) {
+  auto copy_res = pg->Copy({}, {});
+  if (!copy_res) {
+    return copy_res.error();
+  }
+  std::unique_ptr<katana::PropertyGraph> work = std::move(copy_res.value());
+  if (auto r = katana::EnsureAllEdgesSortedByDest(work.get()); !r) {
+    return r.error();
+  }
+  const katana::GraphTopology& topology = work->topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  auto neighbors_res = MakeUndirectedNeighbors(topology);
+  if (!neighbors_res) {
+    return neighbors_res.error();
+  }
+  const UndirectedNeighbors& neighbors = neighbors_res.value();
+
+  // Each connected triad is counted once, from the pair of its nodes v < u
+  // chosen by Batagelj and Mrvar; each dyad v - u also accounts for the
+  // triads it forms with the nodes adjacent to neither.
+  std::array<katana::GAccumulator<uint64_t>, TriadCensus::kNumTriadTypes>
+      totals;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node v) {
+        std::array<uint64_t, TriadCensus::kNumTriadTypes> local{};
+        Neighbors nv = neighbors.of(v);
+        const uint8_t* arcs_v = neighbors.arcs_of(v);
+        for (size_t k = 0; k < nv.size; ++k) {
+          Node u = nv.nodes[k];
+          if (u < v) {
+            continue;
+          }
+          uint8_t vu = arcs_v[k];
+          Neighbors nu = neighbors.of(u);
+          const uint8_t* arcs_u = neighbors.arcs_of(u);
+
+          uint64_t union_size = 0;
+          size_t i = 0;
+          size_t j = 0;
+          while (i < nv.size || j < nu.size) {
+            Node w;
+            uint8_t vw = 0;
+            uint8_t uw = 0;
+            if (j == nu.size || (i < nv.size && nv.nodes[i] < nu.nodes[j])) {
+              w = nv.nodes[i];
+              vw = arcs_v[i++];
+            } else if (i == nv.size || nu.nodes[j] < nv.nodes[i]) {
+              w = nu.nodes[j];
+              uw = arcs_u[j++];
+            } else {
+              w = nv.nodes[i];
+              vw = arcs_v[i++];
+              uw = arcs_u[j++];
+            }
+            if (w == u || w == v) {
+              continue;
+            }
+            ++union_size;
+            if (u < w || (v < w && w < u && vw == 0)) {
+              ++local[kTriadTypes[vu + 4 * vw + 16 * uw]];
+            }
+          }
+
+          auto dyad = vu == (kOutArc | kInArc) ? TriadCensus::k102
+                                               : TriadCensus::k012;
+          local[dyad] += num_nodes - union_size - 2;
+        }
+        for (size_t type = 0; type < TriadCensus::kNumTriadTypes; ++type) {
+          if (local[type] != 0) {
+            totals[type] += local[type];
+          }
+        }
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(), katana::no_stats(),
+      katana::loopname("DirectedTriadCensus"));
+
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+
+  TriadCensus census;
+  unsigned __int128 connected = 0;
+  for (size_t type = 0; type < TriadCensus::kNumTriadTypes; ++type) {
+    census.counts[type] = totals[type].reduce();
+    connected += census.counts[type];
+  }
+  unsigned __int128 n = num_nodes;
+  unsigned __int128 all = n < 3 ? 0 : n * (n - 1) * (n - 2) / 6;
+  unsigned __int128 empty = all - connected;
+  census.counts[TriadCensus::k003] =
+      empty > std::numeric_limits<uint64_t>::max()
+          ? std::numeric_limits<uint64_t>::max()
+          : static_cast<uint64_t>(empty);
+  return census;
+}
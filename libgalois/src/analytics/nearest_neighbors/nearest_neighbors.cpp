@@ -0,0 +1,631 @@
+#include "katana/analytics/nearest_neighbors/nearest_neighbors.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Cancellation.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Properties.h"
+#include "katana/Reduction.h"
+#include "katana/SimpleLock.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Metric = NearestNeighborsPlan::Metric;
+using EmbeddingView = katana::FixedSizeListPropertyView<float>;
+
+/// A distance and the node at that distance
+using Candidate = std::pair<float, Node>;
+
+constexpr Node kNoNeighbor = std::numeric_limits<Node>::max();
+constexpr uint32_t kMaxLevel = 16;
+
+uint64_t
+Mix(uint64_t x) {
+  // splitmix64
+  x += UINT64_C(0x9e3779b97f4a7c15);
+  x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+float
+Dot(const float* a, const float* b, uint32_t dimension) {
+  float sum = 0;
+  for (uint32_t i = 0; i < dimension; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+float
+SquaredDistance(const float* a, const float* b, uint32_t dimension) {
+  float sum = 0;
+  for (uint32_t i = 0; i < dimension; ++i) {
+    float d = a[i] - b[i];
+    sum += d * d;
+  }
+  return sum;
+}
+
+float
+InverseNorm(const float* a, uint32_t dimension) {
+  float norm = std::sqrt(Dot(a, a, dimension));
+  return norm > 0 ? 1 / norm : 0;
+}
+
+/// An embedding to measure distances from
+struct Query {
+  const float* embedding;
+  float inverse_norm;
+};
+
+/// The distances between the embeddings of nodes and queries, smaller is
+/// nearer. Euclidean distances are squared until they are reported.
+class Space {
+public:
+  Space(const EmbeddingView& embeddings, Metric metric)
+      : values_(embeddings.data()),
+        dimension_(embeddings.dimension()),
+        metric_(metric) {
+    if (metric_ != NearestNeighborsPlan::kCosine) {
+      return;
+    }
+    inverse_norms_.allocateBlocked(embeddings.size());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{embeddings.size()}),
+        [&](uint64_t n) {
+          inverse_norms_[n] = InverseNorm(&values_[n * dimension_], dimension_);
+        },
+        katana::no_stats());
+  }
+
+  uint32_t dimension() const { return dimension_; }
+
+  Query Of(Node n) const {
+    return {
+        &values_[uint64_t{n} * dimension_],
+        metric_ == NearestNeighborsPlan::kCosine ? inverse_norms_[n] : 1.0f};
+  }
+
+  Query Of(const float* embedding) const {
+    return {
+        embedding, metric_ == NearestNeighborsPlan::kCosine
+                       ? InverseNorm(embedding, dimension_)
+                       : 1.0f};
+  }
+
+  float Between(const Query& q, Node n) const {
+    const float* embedding = &values_[uint64_t{n} * dimension_];
+    switch (metric_) {
+    case NearestNeighborsPlan::kInnerProduct:
+      return -Dot(q.embedding, embedding, dimension_);
+    case NearestNeighborsPlan::kCosine:
+      return 1 - Dot(q.embedding, embedding, dimension_) * q.inverse_norm *
+                     inverse_norms_[n];
+    default:
+      return SquaredDistance(q.embedding, embedding, dimension_);
+    }
+  }
+
+  /// The distance to report for a distance returned by Between
+  float Reported(float distance) const {
+    return metric_ == NearestNeighborsPlan::kEuclidean ? std::sqrt(distance)
+                                                        : distance;
+  }
+
+private:
+  const float* values_;
+  uint32_t dimension_;
+  Metric metric_;
+  katana::LargeArray<float> inverse_norms_;
+};
+
+/// The neighbors of every node on every layer of the index. The neighbors of
+/// node n are the slots [offsets[n], offsets[n + 1]): 2 * max_degree for
+/// layer 0 and max_degree for each layer above, each filled from the start
+/// and ended by kNoNeighbor if not full.
+struct Layers {
+  const int64_t* offsets;
+  const Node* slots;
+  uint32_t max_degree;
+
+  uint32_t level(Node n) const {
+    return (offsets[n + 1] - offsets[n] - 2 * max_degree) / max_degree;
+  }
+
+  uint32_t degree(uint32_t layer) const {
+    return layer == 0 ? 2 * max_degree : max_degree;
+  }
+
+  /// The index of the first slot of n on layer
+  uint64_t begin(Node n, uint32_t layer) const {
+    return offsets[n] + (layer == 0 ? 0 : (layer + 1) * max_degree);
+  }
+};
+
+/// The nodes visited by one search, an open addressing hash set cleared in
+/// time proportional to the number of nodes in it
+class VisitedSet {
+public:
+  void Clear() {
+    for (size_t i : used_) {
+      slots_[i] = kNoNeighbor;
+    }
+    used_.clear();
+  }
+
+  /// \returns whether n was not in the set
+  bool Insert(Node n) {
+    if (2 * (used_.size() + 1) > slots_.size()) {
+      Grow();
+    }
+    size_t mask = slots_.size() - 1;
+    for (size_t i = Hash(n) & mask;; i = (i + 1) & mask) {
+      if (slots_[i] == n) {
+        return false;
+      }
+      if (slots_[i] == kNoNeighbor) {
+        slots_[i] = n;
+        used_.emplace_back(i);
+        return true;
+      }
+    }
+  }
+
+private:
+  static size_t Hash(Node n) {
+    return (uint64_t{n} * UINT64_C(0x9e3779b97f4a7c15)) >> 32;
+  }
+
+  void Grow() {
+    std::vector<Node> nodes;
+    nodes.reserve(used_.size());
+    for (size_t i : used_) {
+      nodes.emplace_back(slots_[i]);
+    }
+    slots_.assign(std::max<size_t>(64, 2 * slots_.size()), kNoNeighbor);
+    used_.clear();
+    for (Node n : nodes) {
+      Insert(n);
+    }
+  }
+
+  std::vector<Node> slots_;
+  std::vector<size_t> used_;
+};
+
+struct Scratch {
+  VisitedSet visited;
+  /// A min-heap of the nodes to expand
+  std::vector<Candidate> candidates;
+  /// A max-heap of the nearest nodes found
+  std::vector<Candidate> results;
+  std::vector<Node> neighbors;
+  std::vector<Candidate> merged;
+  std::vector<Candidate> selected;
+};
+
+/// Copy the neighbors of n on layer to neighbors, under the lock of n if
+/// locks is not null
+void
+CopyNeighbors(
+    const Layers& layers, std::vector<katana::SimpleLock>* locks, Node n,
+    uint32_t layer, std::vector<Node>* neighbors) {
+  neighbors->clear();
+  const Node* slots = &layers.slots[layers.begin(n, layer)];
+  if (locks) {
+    (*locks)[n].lock();
+  }
+  for (uint32_t i = 0; i < layers.degree(layer) && slots[i] != kNoNeighbor;
+       ++i) {
+    neighbors->emplace_back(slots[i]);
+  }
+  if (locks) {
+    (*locks)[n].unlock();
+  }
+}
+
+/// Search layer for the beam_width nodes nearest to q, starting from the
+/// nodes in scratch->results and leaving the nodes found there as a max-heap
+void
+SearchLayer(
+    const Space& space, const Layers& layers,
+    std::vector<katana::SimpleLock>* locks, const Query& q, uint32_t layer,
+    uint32_t beam_width, Scratch* scratch) {
+  auto& visited = scratch->visited;
+  auto& candidates = scratch->candidates;
+  auto& results = scratch->results;
+  visited.Clear();
+  candidates.clear();
+  for (const Candidate& c : results) {
+    visited.Insert(c.second);
+    candidates.emplace_back(c);
+  }
+  std::make_heap(results.begin(), results.end());
+  std::make_heap(candidates.begin(), candidates.end(), std::greater<>());
+
+  while (!candidates.empty()) {
+    std::pop_heap(candidates.begin(), candidates.end(), std::greater<>());
+    Candidate c = candidates.back();
+    candidates.pop_back();
+    if (results.size() >= beam_width && c.first > results.front().first) {
+      break;
+    }
+    CopyNeighbors(layers, locks, c.second, layer, &scratch->neighbors);
+    for (Node m : scratch->neighbors) {
+      if (!visited.Insert(m)) {
+        continue;
+      }
+      float distance = space.Between(q, m);
+      if (results.size() < beam_width || distance < results.front().first) {
+        candidates.emplace_back(distance, m);
+        std::push_heap(candidates.begin(), candidates.end(), std::greater<>());
+        results.emplace_back(distance, m);
+        std::push_heap(results.begin(), results.end());
+        if (results.size() > beam_width) {
+          std::pop_heap(results.begin(), results.end());
+          results.pop_back();
+        }
+      }
+    }
+  }
+}
+
+/// Select at most max_degree of candidates as neighbors, nearest first,
+/// skipping the candidates nearer to a selected neighbor than to the node,
+/// so that the neighbors of a node lead away from it in different
+/// directions
+void
+SelectNeighbors(
+    const Space& space, std::vector<Candidate>* candidates,
+    uint32_t max_degree, std::vector<Candidate>* selected) {
+  std::sort(candidates->begin(), candidates->end());
+  selected->clear();
+  for (const Candidate& c : *candidates) {
+    if (selected->size() == max_degree) {
+      break;
+    }
+    Query q = space.Of(c.second);
+    bool keep = std::none_of(
+        selected->begin(), selected->end(), [&](const Candidate& s) {
+          return space.Between(q, s.second) < c.first;
+        });
+    if (keep) {
+      selected->emplace_back(c);
+    }
+  }
+}
+
+class IndexBuilder {
+public:
+  IndexBuilder(
+      const Space& space, const Layers& layers, Node* slots,
+      const NearestNeighborsPlan& plan)
+      : space_(space),
+        layers_(layers),
+        slots_(slots),
+        plan_(plan) {}
+
+  katana::Result<void> Build(uint64_t num_nodes) {
+    if (num_nodes == 0) {
+      return katana::ResultSuccess();
+    }
+    locks_ = std::vector<katana::SimpleLock>(num_nodes);
+
+    // The entry is the first node on the top layer, inserted first
+    entry_ = 0;
+    for (Node n = 1; n < num_nodes; ++n) {
+      if (layers_.level(n) > layers_.level(entry_)) {
+        entry_ = n;
+      }
+    }
+    top_level_ = layers_.level(entry_);
+
+    for (uint64_t begin = 1; begin < num_nodes; begin *= 2) {
+      if (katana::IsCancelled()) {
+        return katana::ErrorCode::Cancelled;
+      }
+      uint64_t end = std::min(2 * begin, num_nodes);
+      katana::do_all(
+          katana::iterate(begin, end),
+          [&](uint64_t i) {
+            // Insert the entry first, in place of node 0
+            Insert(i == entry_ ? 0 : static_cast<Node>(i));
+          },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("NearestNeighborsBuildIndex"));
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  void Insert(Node n) {
+    Scratch& scratch = *scratch_.getLocal();
+    Query q = space_.Of(n);
+    uint32_t level = layers_.level(n);
+
+    scratch.results.assign(1, Candidate(space_.Between(q, entry_), entry_));
+    for (uint32_t layer = top_level_; layer > level; --layer) {
+      SearchLayer(space_, layers_, &locks_, q, layer, 1, &scratch);
+    }
+    for (uint32_t layer = std::min(level, top_level_) + 1; layer-- > 0;) {
+      SearchLayer(
+          space_, layers_, &locks_, q, layer, plan_.build_beam_width(),
+          &scratch);
+      scratch.merged = scratch.results;
+      SelectNeighbors(
+          space_, &scratch.merged, plan_.max_degree(), &scratch.selected);
+      std::vector<Candidate> selected = scratch.selected;
+      Link(n, layer, selected, &scratch);
+      for (const Candidate& c : selected) {
+        Link(c.second, layer, {Candidate(c.first, n)}, &scratch);
+      }
+    }
+  }
+
+  /// Add additions to the neighbors of n on layer, keeping the neighbors
+  /// selected among them if there are too many
+  void Link(
+      Node n, uint32_t layer, const std::vector<Candidate>& additions,
+      Scratch* scratch) {
+    Query q = space_.Of(n);
+    Node* slots = &slots_[layers_.begin(n, layer)];
+    uint32_t degree = layers_.degree(layer);
+    auto& merged = scratch->merged;
+
+    locks_[n].lock();
+    merged.clear();
+    for (uint32_t i = 0; i < degree && slots[i] != kNoNeighbor; ++i) {
+      merged.emplace_back(space_.Between(q, slots[i]), slots[i]);
+    }
+    size_t num_old = merged.size();
+    for (const Candidate& c : additions) {
+      auto old_end = merged.begin() + num_old;
+      if (c.second != n &&
+          std::none_of(merged.begin(), old_end, [&](const Candidate& m) {
+            return m.second == c.second;
+          })) {
+        merged.emplace_back(c);
+      }
+    }
+    const std::vector<Candidate>* kept = &merged;
+    if (merged.size() > degree) {
+      SelectNeighbors(space_, &merged, degree, &scratch->selected);
+      kept = &scratch->selected;
+    }
+    for (uint32_t i = 0; i < degree; ++i) {
+      slots[i] = i < kept->size() ? (*kept)[i].second : kNoNeighbor;
+    }
+    locks_[n].unlock();
+  }
+
+  const Space& space_;
+  const Layers& layers_;
+  Node* slots_;
+  const NearestNeighborsPlan& plan_;
+  std::vector<katana::SimpleLock> locks_;
+  katana::PerThreadStorage<Scratch> scratch_;
+  Node entry_{};
+  uint32_t top_level_{};
+};
+
+katana::Result<EmbeddingView>
+GetEmbeddings(
+    katana::PropertyGraph* pg, const std::string& embedding_property_name) {
+  auto property = pg->GetNodeProperty(embedding_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no node property {}",
+        embedding_property_name);
+  }
+  katana::Result<EmbeddingView> view_result = katana::ErrorCode::TypeError;
+  if (property->num_chunks() == 1) {
+    view_result =
+        katana::ConstructPropertyView<katana::FixedSizeListProperty<float>>(
+            property->chunk(0).get());
+  }
+  if (!view_result ||
+      view_result.value().size() != pg->topology().num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "{} is not a fixed size list of floats",
+        embedding_property_name);
+  }
+  return view_result;
+}
+
+/// An index read from its property
+struct Index {
+  Layers layers;
+  /// The first node on the top layer
+  Node entry;
+  uint32_t top_level;
+};
+
+/// Check the index property of a graph built with plan and find its entry
+katana::Result<Index>
+GetIndex(
+    katana::PropertyGraph* pg, const std::string& index_property_name,
+    const NearestNeighborsPlan& plan) {
+  auto property = pg->GetNodeProperty(index_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no node property {}",
+        index_property_name);
+  }
+  const uint64_t num_nodes = pg->topology().num_nodes();
+  auto list = property->num_chunks() == 1
+                  ? std::dynamic_pointer_cast<arrow::LargeListArray>(
+                        property->chunk(0))
+                  : nullptr;
+  auto values =
+      list ? std::dynamic_pointer_cast<arrow::UInt32Array>(list->values())
+           : nullptr;
+  if (!values || static_cast<uint64_t>(list->length()) != num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "{} is not a nearest neighbor index",
+        index_property_name);
+  }
+  Layers layers{
+      list->raw_value_offsets(), values->raw_values(), plan.max_degree()};
+
+  // The top level and, for the first node on it, its complement
+  katana::GReduceMax<uint64_t> entry;
+  katana::GReduceLogicalOr malformed;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        int64_t length = layers.offsets[n + 1] - layers.offsets[n];
+        int64_t upper = length - 2 * int64_t{plan.max_degree()};
+        if (upper < 0 || upper % plan.max_degree() != 0 ||
+            upper / plan.max_degree() > kMaxLevel) {
+          malformed.update(true);
+          return;
+        }
+        entry.update(
+            (uint64_t{layers.level(n)} << 32) | (kNoNeighbor - Node(n)));
+      },
+      katana::no_stats());
+  if (malformed.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} is not an index with max_degree {}", index_property_name,
+        plan.max_degree());
+  }
+  uint64_t top = entry.reduce();
+  return Index{
+      layers, kNoNeighbor - static_cast<Node>(top),
+      static_cast<uint32_t>(top >> 32)};
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::NearestNeighborsBuildIndex(
+    katana::PropertyGraph* pg, const std::string& embedding_property_name,
+    const std::string& index_property_name, NearestNeighborsPlan plan) {
+  if (plan.max_degree() < 2 || plan.build_beam_width() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "max_degree must be at least 2 and build_beam_width positive");
+  }
+  auto embeddings_result = GetEmbeddings(pg, embedding_property_name);
+  if (!embeddings_result) {
+    return embeddings_result.error();
+  }
+  Space space(embeddings_result.value(), plan.metric());
+  const uint64_t num_nodes = pg->topology().num_nodes();
+  const uint32_t max_degree = plan.max_degree();
+
+  // Each node is on the layers above with probability 1 / max_degree
+  auto offsets_res = arrow::AllocateBuffer((num_nodes + 1) * sizeof(int64_t));
+  if (!offsets_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating index offsets: {}",
+        offsets_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> offsets = std::move(offsets_res.ValueOrDie());
+  auto* offsets_data = reinterpret_cast<int64_t*>(offsets->mutable_data());
+  double level_scale = 1 / std::log(double{max_degree});
+  offsets_data[0] = 0;
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    double u = ((Mix(n) >> 11) + 1) * 0x1.0p-53;
+    auto level = std::min(
+        static_cast<uint32_t>(-std::log(u) * level_scale), kMaxLevel);
+    offsets_data[n + 1] = offsets_data[n] + (2 + level) * max_degree;
+  }
+
+  uint64_t num_slots = offsets_data[num_nodes];
+  auto slots_res = arrow::AllocateBuffer(num_slots * sizeof(Node));
+  if (!slots_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating index: {}",
+        slots_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> slots = std::move(slots_res.ValueOrDie());
+  auto* slots_data = reinterpret_cast<Node*>(slots->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_slots),
+      [&](uint64_t i) { slots_data[i] = kNoNeighbor; }, katana::no_stats());
+
+  Layers layers{offsets_data, slots_data, max_degree};
+  IndexBuilder builder(space, layers, slots_data, plan);
+  if (auto r = builder.Build(num_nodes); !r) {
+    return r.error();
+  }
+
+  auto values = std::make_shared<arrow::UInt32Array>(num_slots, slots);
+  auto type = arrow::large_list(arrow::uint32());
+  auto index =
+      std::make_shared<arrow::LargeListArray>(type, num_nodes, offsets, values);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(index_property_name, type)}), {index});
+  return pg->AddNodeProperties(table);
+}
+
+katana::Result<void>
+katana::analytics::NearestNeighborsQuery(
+    katana::PropertyGraph* pg, const std::string& embedding_property_name,
+    const std::string& index_property_name, const float* queries,
+    uint64_t num_queries, uint32_t k, katana::GraphTopology::Node* neighbors,
+    float* distances, NearestNeighborsPlan plan) {
+  if (k == 0 || plan.max_degree() < 2) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "k must be positive and max_degree at least 2");
+  }
+  auto embeddings_result = GetEmbeddings(pg, embedding_property_name);
+  if (!embeddings_result) {
+    return embeddings_result.error();
+  }
+  Space space(embeddings_result.value(), plan.metric());
+  auto index_result = GetIndex(pg, index_property_name, plan);
+  if (!index_result) {
+    return index_result.error();
+  }
+  const Index& index = index_result.value();
+  const uint64_t num_nodes = pg->topology().num_nodes();
+  uint32_t beam_width = std::max(k, plan.query_beam_width());
+
+  katana::PerThreadStorage<Scratch> scratch;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_queries),
+      [&](uint64_t i) {
+        Node* out_neighbors = &neighbors[i * k];
+        float* out_distances = &distances[i * k];
+        std::fill_n(out_neighbors, k, kNoNeighbor);
+        std::fill_n(
+            out_distances, k, std::numeric_limits<float>::infinity());
+        if (num_nodes == 0) {
+          return;
+        }
+
+        Scratch& s = *scratch.getLocal();
+        Query q = space.Of(&queries[i * space.dimension()]);
+        s.results.assign(
+            1, Candidate(space.Between(q, index.entry), index.entry));
+        for (uint32_t layer = index.top_level; layer > 0; --layer) {
+          SearchLayer(space, index.layers, nullptr, q, layer, 1, &s);
+        }
+        SearchLayer(space, index.layers, nullptr, q, 0, beam_width, &s);
+
+        std::sort_heap(s.results.begin(), s.results.end());
+        for (size_t j = 0; j < k && j < s.results.size(); ++j) {
+          out_neighbors[j] = s.results[j].second;
+          out_distances[j] = space.Reported(s.results[j].first);
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("NearestNeighborsQuery"));
+  return katana::ResultSuccess();
+}
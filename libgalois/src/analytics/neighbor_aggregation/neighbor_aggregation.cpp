@@ -0,0 +1,263 @@
+#include "katana/analytics/neighbor_aggregation/neighbor_aggregation.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "katana/Cancellation.h"
+#include "katana/EdgeBalancedRange.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using Aggregation = NeighborAggregationPlan::Aggregation;
+
+/// Copy the weights of the edges of pg to weights as floats, in the order
+/// of the edges of in_edges if it is not null
+template <typename Weight>
+katana::Result<void>
+CopyWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const katana::InEdgeIndex* in_edges, float* weights) {
+  auto weights_result =
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  const Weight* values = weights_result.value()->raw_values();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->topology().num_edges()),
+      [&](uint64_t e) {
+        weights[e] = static_cast<float>(
+            values[in_edges ? in_edges->out_edge_id(e) : e]);
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+ReadWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const katana::InEdgeIndex* in_edges, float* weights) {
+  auto property = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return CopyWeights<uint32_t>(
+        pg, edge_weight_property_name, in_edges, weights);
+  case arrow::Int32Type::type_id:
+    return CopyWeights<int32_t>(
+        pg, edge_weight_property_name, in_edges, weights);
+  case arrow::UInt64Type::type_id:
+    return CopyWeights<uint64_t>(
+        pg, edge_weight_property_name, in_edges, weights);
+  case arrow::Int64Type::type_id:
+    return CopyWeights<int64_t>(
+        pg, edge_weight_property_name, in_edges, weights);
+  case arrow::FloatType::type_id:
+    return CopyWeights<float>(pg, edge_weight_property_name, in_edges, weights);
+  case arrow::DoubleType::type_id:
+    return CopyWeights<double>(
+        pg, edge_weight_property_name, in_edges, weights);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+/// Aggregate the features [begin, begin + width) of the neighbors of every
+/// node, which are the destinations of its edges in topology. Features and
+/// aggregates are size values per node.
+template <Aggregation F, bool Weighted, typename Feature>
+void
+AggregateBlock(
+    const katana::GraphTopology& topology, const float* weights,
+    const Feature* features, uint32_t size, uint32_t begin, uint32_t width,
+    float* aggregates) {
+  const Node* dests = topology.edge_dests();
+  katana::do_all(
+      katana::iterate_edge_balanced(topology),
+      [&](Node n) {
+        float* __restrict__ out = &aggregates[uint64_t{n} * size + begin];
+        float init = F == NeighborAggregationPlan::kMax
+                         ? -std::numeric_limits<float>::max()
+                         : 0.0f;
+        for (uint32_t c = 0; c < width; ++c) {
+          out[c] = init;
+        }
+        auto edges = topology.edges(n);
+        float total_weight = 0;
+        for (Edge e : edges) {
+          const Feature* __restrict__ in =
+              &features[uint64_t{dests[e]} * size + begin];
+          float w = Weighted ? weights[e] : 1.0f;
+          total_weight += w;
+          for (uint32_t c = 0; c < width; ++c) {
+            float value = w * static_cast<float>(in[c]);
+            if constexpr (F == NeighborAggregationPlan::kMax) {
+              out[c] = std::max(out[c], value);
+            } else {
+              out[c] += value;
+            }
+          }
+        }
+
+        if (F == NeighborAggregationPlan::kMax && edges.empty()) {
+          std::fill(out, out + width, 0.0f);
+        }
+        if (F == NeighborAggregationPlan::kMean) {
+          float scale = total_weight != 0 ? 1 / total_weight : 0;
+          for (uint32_t c = 0; c < width; ++c) {
+            out[c] *= scale;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("NeighborAggregation"));
+}
+
+template <Aggregation F, bool Weighted, typename Feature>
+katana::Result<void>
+Aggregate(
+    const katana::GraphTopology& topology, const float* weights,
+    const Feature* features, uint32_t size,
+    const NeighborAggregationPlan& plan, float* aggregates) {
+  uint32_t block = plan.feature_block_size() ? plan.feature_block_size() : size;
+  for (uint32_t begin = 0; begin < size; begin += block) {
+    if (katana::IsCancelled()) {
+      return katana::ErrorCode::Cancelled;
+    }
+    AggregateBlock<F, Weighted>(
+        topology, weights, features, size, begin,
+        std::min(block, size - begin), aggregates);
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename Feature>
+katana::Result<void>
+AggregateWithWrap(
+    const katana::GraphTopology& topology, const float* weights,
+    const Feature* features, uint32_t size,
+    const NeighborAggregationPlan& plan, float* aggregates) {
+  switch (plan.aggregation()) {
+  case NeighborAggregationPlan::kSum:
+    return weights
+               ? Aggregate<NeighborAggregationPlan::kSum, true>(
+                     topology, weights, features, size, plan, aggregates)
+               : Aggregate<NeighborAggregationPlan::kSum, false>(
+                     topology, weights, features, size, plan, aggregates);
+  case NeighborAggregationPlan::kMean:
+    return weights
+               ? Aggregate<NeighborAggregationPlan::kMean, true>(
+                     topology, weights, features, size, plan, aggregates)
+               : Aggregate<NeighborAggregationPlan::kMean, false>(
+                     topology, weights, features, size, plan, aggregates);
+  case NeighborAggregationPlan::kMax:
+    return weights
+               ? Aggregate<NeighborAggregationPlan::kMax, true>(
+                     topology, weights, features, size, plan, aggregates)
+               : Aggregate<NeighborAggregationPlan::kMax, false>(
+                     topology, weights, features, size, plan, aggregates);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown aggregation");
+  }
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::NeighborAggregation(
+    katana::PropertyGraph* pg, const std::string& input_property_name,
+    const std::string& output_property_name,
+    const std::string& edge_weight_property_name,
+    NeighborAggregationPlan plan) {
+  auto property = pg->GetNodeProperty(input_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no node property {}",
+        input_property_name);
+  }
+  const uint64_t num_nodes = pg->topology().num_nodes();
+  auto list = property->num_chunks() == 1
+                  ? std::dynamic_pointer_cast<arrow::FixedSizeListArray>(
+                        property->chunk(0))
+                  : nullptr;
+  if (!list || static_cast<uint64_t>(list->length()) != num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "{} is not a fixed size list",
+        input_property_name);
+  }
+  uint32_t size = list->value_length();
+  uint64_t offset = list->length() > 0 ? list->value_offset(0) : 0;
+
+  std::shared_ptr<const katana::InEdgeIndex> in_edges;
+  if (plan.neighbors() == NeighborAggregationPlan::kInNeighbors) {
+    auto in_edges_result = pg->GetInEdgeIndex();
+    if (!in_edges_result) {
+      return in_edges_result.error();
+    }
+    in_edges = in_edges_result.value();
+  }
+  const katana::GraphTopology& topology =
+      in_edges ? in_edges->topology : pg->topology();
+
+  katana::LargeArray<float> weights;
+  if (!edge_weight_property_name.empty()) {
+    weights.allocateBlocked(topology.num_edges());
+    if (auto r = ReadWeights(
+            pg, edge_weight_property_name, in_edges.get(), weights.data());
+        !r) {
+      return r.error();
+    }
+  }
+
+  uint64_t num_values = num_nodes * size;
+  auto buffer_res = arrow::AllocateBuffer(num_values * sizeof(float));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating aggregates: {}",
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  float* aggregates = reinterpret_cast<float*>(buffer->mutable_data());
+  const float* weights_data =
+      edge_weight_property_name.empty() ? nullptr : weights.data();
+
+  katana::Result<void> res = katana::ErrorCode::TypeError;
+  if (auto values =
+          std::dynamic_pointer_cast<arrow::FloatArray>(list->values())) {
+    res = AggregateWithWrap(
+        topology, weights_data, values->raw_values() + offset, size, plan,
+        aggregates);
+  } else if (
+      auto values =
+          std::dynamic_pointer_cast<arrow::DoubleArray>(list->values())) {
+    res = AggregateWithWrap(
+        topology, weights_data, values->raw_values() + offset, size, plan,
+        aggregates);
+  } else {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "{} is not a list of floats or doubles",
+        input_property_name);
+  }
+  if (!res) {
+    return res.error();
+  }
+
+  auto values = std::make_shared<arrow::FloatArray>(num_values, buffer);
+  auto type = arrow::fixed_size_list(arrow::float32(), size);
+  auto output = std::make_shared<arrow::FixedSizeListArray>(
+      type, num_nodes, values);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, type)}), {output});
+  return pg->AddNodeProperties(table);
+}
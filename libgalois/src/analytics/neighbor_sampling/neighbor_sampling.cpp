@@ -0,0 +1,519 @@
+#include "katana/analytics/neighbor_sampling/neighbor_sampling.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/AtomicHelpers.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/analytics/Utils.h"
+
+using katana::analytics::NeighborSample;
+using katana::analytics::NeighborSampleLoader;
+using katana::analytics::NeighborSampler;
+
+namespace {
+
+constexpr uint32_t kNoBatchId = std::numeric_limits<uint32_t>::max();
+constexpr uint64_t kNoEdge = std::numeric_limits<uint64_t>::max();
+
+/// Without replacement, fanouts up to this draw positions by Floyd's
+/// algorithm, which checks each draw against those before it; larger ones
+/// shuffle the positions of every edge of the node
+constexpr uint64_t kMaxFloydFanout = 32;
+
+/// Call fn with values as the array of its numeric type, returning false if
+/// it is not numeric
+template <typename F>
+bool
+WithNumericArray(const arrow::Array& values, F fn) {
+  switch (values.type_id()) {
+  case arrow::Type::INT8:
+    fn(static_cast<const arrow::Int8Array&>(values));
+    return true;
+  case arrow::Type::UINT8:
+    fn(static_cast<const arrow::UInt8Array&>(values));
+    return true;
+  case arrow::Type::INT16:
+    fn(static_cast<const arrow::Int16Array&>(values));
+    return true;
+  case arrow::Type::UINT16:
+    fn(static_cast<const arrow::UInt16Array&>(values));
+    return true;
+  case arrow::Type::INT32:
+    fn(static_cast<const arrow::Int32Array&>(values));
+    return true;
+  case arrow::Type::UINT32:
+    fn(static_cast<const arrow::UInt32Array&>(values));
+    return true;
+  case arrow::Type::INT64:
+    fn(static_cast<const arrow::Int64Array&>(values));
+    return true;
+  case arrow::Type::UINT64:
+    fn(static_cast<const arrow::UInt64Array&>(values));
+    return true;
+  case arrow::Type::FLOAT:
+    fn(static_cast<const arrow::FloatArray&>(values));
+    return true;
+  case arrow::Type::DOUBLE:
+    fn(static_cast<const arrow::DoubleArray&>(values));
+    return true;
+  default:
+    return false;
+  }
+}
+
+}  // namespace
+
+NeighborSampler::NeighborSampler(
+    const PropertyGraph* pg, std::vector<double>&& weights,
+    bool with_replacement)
+    : pg_(pg),
+      with_replacement_(with_replacement),
+      weights_(std::move(weights)) {
+  const GraphTopology& topology = pg_->topology();
+
+  batch_ids_.createBlocked(topology.num_nodes(), kNoBatchId);
+  first_edges_.createBlocked(topology.num_nodes(), kNoEdge);
+
+  if (!weights_.empty()) {
+    positive_degrees_.resize(topology.num_nodes());
+    if (with_replacement_) {
+      cumulative_weights_.resize(topology.num_edges());
+    }
+    katana::do_all(
+        katana::iterate(topology),
+        [&](uint32_t n) {
+          uint32_t positive = 0;
+          double total = 0;
+          for (auto e : topology.edges(n)) {
+            positive += weights_[e] > 0;
+            total += weights_[e];
+            if (with_replacement_) {
+              cumulative_weights_[e] = total;
+            }
+          }
+          positive_degrees_[n] = positive;
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  katana::on_each([&](unsigned, unsigned) {
+    threads_.getLocal()->generator.seed(katana::GetGenerator()());
+  });
+}
+
+katana::Result<std::unique_ptr<NeighborSampler>>
+NeighborSampler::Make(
+    const PropertyGraph* pg,
+    const std::vector<std::string>& feature_property_names,
+    bool with_replacement) {
+  auto sampler = std::make_unique<NeighborSampler>(
+      pg, std::vector<double>{}, with_replacement);
+  for (const auto& name : feature_property_names) {
+    if (auto res = sampler->AddFeature(name); !res) {
+      return res.error();
+    }
+  }
+  return sampler;
+}
+
+katana::Result<std::unique_ptr<NeighborSampler>>
+NeighborSampler::MakeWeighted(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::vector<std::string>& feature_property_names,
+    bool with_replacement) {
+  auto weights_res = NonNegativeEdgeWeights(pg, edge_weight_property_name);
+  if (!weights_res) {
+    return weights_res.error();
+  }
+  auto sampler = std::make_unique<NeighborSampler>(
+      pg, std::move(weights_res.value()), with_replacement);
+  for (const auto& name : feature_property_names) {
+    if (auto res = sampler->AddFeature(name); !res) {
+      return res.error();
+    }
+  }
+  return sampler;
+}
+
+katana::Result<void>
+NeighborSampler::AddFeature(const std::string& name) {
+  auto property = pg_->GetNodeProperty(name);
+  if (!property) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no node property {}", name);
+  }
+  std::shared_ptr<arrow::Array> array;
+  if (property->num_chunks() == 1) {
+    array = property->chunk(0);
+  } else {
+    auto concat_res = arrow::Concatenate(property->chunks());
+    if (!concat_res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(concat_res.status()),
+          "combining chunks of {}: {}", name, concat_res.status());
+    }
+    array = std::move(concat_res.ValueOrDie());
+  }
+
+  FeatureColumn column{.values = array, .width = 1};
+  if (array->type_id() == arrow::Type::FIXED_SIZE_LIST) {
+    column.lists = std::static_pointer_cast<arrow::FixedSizeListArray>(array);
+    column.values = column.lists->values();
+    column.width = column.lists->list_type()->list_size();
+  }
+  if (!WithNumericArray(*column.values, [](const auto&) {})) {
+    return KATANA_ERROR(
+        ErrorCode::TypeError,
+        "node property {} has type {}, which is not numbers or lists of them",
+        name, array->type()->ToString());
+  }
+
+  features_.emplace_back(std::move(column));
+  feature_width_ += features_.back().width;
+  return ResultSuccess();
+}
+
+void
+NeighborSampler::Seed(uint64_t seed) {
+  katana::on_each([&](unsigned tid, unsigned) {
+    threads_.getLocal()->generator.seed(seed + tid);
+  });
+}
+
+/// The number of edges node keeps at a hop of fanout
+uint64_t
+NeighborSampler::Fanout(uint32_t node, uint32_t fanout) const {
+  uint64_t available = weights_.empty() ? pg_->topology().edges(node).size()
+                                        : positive_degrees_[node];
+  if (available == 0) {
+    return 0;
+  }
+  return with_replacement_ ? fanout : std::min<uint64_t>(fanout, available);
+}
+
+void
+NeighborSampler::SampleEdges(
+    uint32_t node, uint32_t fanout, ThreadState* state, uint64_t* out) {
+  auto [begin, end] = pg_->topology().edge_range(node);
+  uint64_t degree = end - begin;
+  uint64_t count = Fanout(node, fanout);
+  if (count == 0) {
+    return;
+  }
+  RandGenerator& gen = state->generator;
+
+  if (weights_.empty()) {
+    if (with_replacement_) {
+      std::uniform_int_distribution<uint64_t> dist(0, degree - 1);
+      for (uint64_t i = 0; i < count; ++i) {
+        out[i] = begin + dist(gen);
+      }
+    } else if (count == degree) {
+      std::iota(out, out + count, begin);
+    } else if (count <= kMaxFloydFanout) {
+      // Floyd's algorithm: drawing from [0, j] for each j of the last count
+      // positions, and taking j itself when the draw was taken before, picks
+      // every subset of count positions with the same probability
+      for (uint64_t j = degree - count, i = 0; j < degree; ++j, ++i) {
+        uint64_t e = begin + std::uniform_int_distribution<uint64_t>(0, j)(gen);
+        out[i] = std::find(out, out + i, e) == out + i ? e : begin + j;
+      }
+    } else {
+      std::vector<uint32_t>& positions = state->positions;
+      positions.resize(degree);
+      std::iota(positions.begin(), positions.end(), 0);
+      for (uint64_t i = 0; i < count; ++i) {
+        uint64_t j =
+            std::uniform_int_distribution<uint64_t>(i, degree - 1)(gen);
+        std::swap(positions[i], positions[j]);
+        out[i] = begin + positions[i];
+      }
+    }
+    return;
+  }
+
+  if (with_replacement_) {
+    // The first edge whose prefix of weights passes a uniform draw; an edge
+    // of weight 0 never passes it before the edge ahead of it does
+    const double* cumulative = &cumulative_weights_[begin];
+    std::uniform_real_distribution<double> dist(0, cumulative[degree - 1]);
+    for (uint64_t i = 0; i < count;) {
+      uint64_t e =
+          std::upper_bound(cumulative, cumulative + degree, dist(gen)) -
+          cumulative;
+      if (e < degree) {
+        out[i++] = begin + e;
+      }
+    }
+    return;
+  }
+
+  if (count == positive_degrees_[node]) {
+    for (uint64_t e = begin, i = 0; e < end; ++e) {
+      if (weights_[e] > 0) {
+        out[i++] = e;
+      }
+    }
+    return;
+  }
+
+  // Without replacement, Efraimidis and Spirakis: the count edges with the
+  // smallest exponential draws scaled by the inverse of their weights
+  std::vector<std::pair<double, uint64_t>>& keys = state->keys;
+  keys.clear();
+  std::exponential_distribution<double> dist(1);
+  for (uint64_t e = begin; e < end; ++e) {
+    if (weights_[e] > 0) {
+      keys.emplace_back(dist(gen) / weights_[e], e);
+    }
+  }
+  std::nth_element(keys.begin(), keys.begin() + count - 1, keys.end());
+  for (uint64_t i = 0; i < count; ++i) {
+    out[i] = keys[i].second;
+  }
+}
+
+katana::Result<void>
+NeighborSampler::Sample(
+    const std::vector<uint32_t>& seeds, const std::vector<uint32_t>& fanouts,
+    NeighborSample* batch) {
+  const GraphTopology& topology = pg_->topology();
+  batch->nodes.assign(seeds.begin(), seeds.end());
+  batch->hop_offsets.assign({0, seeds.size()});
+  batch->out_indices.clear();
+  batch->out_dests.clear();
+  batch->edges.clear();
+
+  auto reset = [&]() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{batch->nodes.size()}),
+        [&](uint64_t i) {
+          uint32_t n = batch->nodes[i];
+          if (n < topology.num_nodes() && batch_ids_[n] == i) {
+            batch_ids_[n] = kNoBatchId;
+          }
+        },
+        katana::no_stats());
+  };
+
+  katana::GReduceMin<uint64_t> invalid;
+  katana::GReduceMin<uint64_t> repeated;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{seeds.size()}),
+      [&](uint64_t i) {
+        if (seeds[i] >= topology.num_nodes()) {
+          invalid.update(i);
+          return;
+        }
+        uint32_t expected = kNoBatchId;
+        if (!batch_ids_[seeds[i]].compare_exchange_strong(
+                expected, static_cast<uint32_t>(i))) {
+          repeated.update(i);
+        }
+      },
+      katana::no_stats());
+  if (uint64_t i = invalid.reduce(); i != kNoEdge) {
+    reset();
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "seed {} is not a node", seeds[i]);
+  }
+  if (uint64_t i = repeated.reduce(); i != kNoEdge) {
+    reset();
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "seed {} is repeated", seeds[i]);
+  }
+
+  for (uint32_t fanout : fanouts) {
+    uint64_t begin = batch->hop_offsets[batch->hop_offsets.size() - 2];
+    uint64_t end = batch->hop_offsets.back();
+    uint64_t edges_begin = batch->edges.size();
+
+    // Lay out the edges that each node of the hop keeps
+    batch->out_indices.resize(end);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t i) {
+          batch->out_indices[i] = Fanout(batch->nodes[i], fanout);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        batch->out_indices.begin() + begin, batch->out_indices.end(),
+        batch->out_indices.begin() + begin);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t i) { batch->out_indices[i] += edges_begin; },
+        katana::no_stats());
+    uint64_t edges_end = end > begin ? batch->out_indices.back() : edges_begin;
+
+    batch->edges.resize(edges_end);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t i) {
+          uint64_t first = i == 0 ? 0 : batch->out_indices[i - 1];
+          SampleEdges(
+              batch->nodes[i], fanout, threads_.getLocal(),
+              &batch->edges[first]);
+        },
+        katana::steal(), katana::no_stats());
+
+    // A node first reached at this hop joins the batch in the order of the
+    // first edge to it
+    katana::do_all(
+        katana::iterate(edges_begin, edges_end),
+        [&](uint64_t e) {
+          uint32_t dest = topology.edge_dest(batch->edges[e]);
+          if (batch_ids_[dest] == kNoBatchId) {
+            katana::atomicMin(first_edges_[dest], e);
+          }
+        },
+        katana::no_stats());
+    new_ranks_.resize(edges_end - edges_begin);
+    katana::do_all(
+        katana::iterate(edges_begin, edges_end),
+        [&](uint64_t e) {
+          uint32_t dest = topology.edge_dest(batch->edges[e]);
+          new_ranks_[e - edges_begin] =
+              batch_ids_[dest] == kNoBatchId && first_edges_[dest] == e;
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        new_ranks_.begin(), new_ranks_.end(), new_ranks_.begin());
+
+    uint64_t num_new = new_ranks_.empty() ? 0 : new_ranks_.back();
+    batch->nodes.resize(end + num_new);
+    katana::do_all(
+        katana::iterate(edges_begin, edges_end),
+        [&](uint64_t e) {
+          uint64_t k = e - edges_begin;
+          if (new_ranks_[k] != (k == 0 ? 0 : new_ranks_[k - 1])) {
+            uint32_t dest = topology.edge_dest(batch->edges[e]);
+            uint64_t id = end + new_ranks_[k] - 1;
+            batch->nodes[id] = dest;
+            batch_ids_[dest] = id;
+            first_edges_[dest] = kNoEdge;
+          }
+        },
+        katana::no_stats());
+
+    batch->out_dests.resize(edges_end);
+    katana::do_all(
+        katana::iterate(edges_begin, edges_end),
+        [&](uint64_t e) {
+          batch->out_dests[e] =
+              batch_ids_[topology.edge_dest(batch->edges[e])];
+        },
+        katana::no_stats());
+    batch->hop_offsets.emplace_back(end + num_new);
+  }
+
+  GatherFeatures(batch);
+  reset();
+  return ResultSuccess();
+}
+
+void
+NeighborSampler::GatherFeatures(NeighborSample* batch) const {
+  batch->feature_width = feature_width_;
+  batch->features.resize(batch->num_nodes() * feature_width_);
+
+  uint32_t offset = 0;
+  for (const auto& column : features_) {
+    WithNumericArray(*column.values, [&](const auto& values) {
+      katana::do_all(
+          katana::iterate(uint64_t{0}, batch->num_nodes()),
+          [&](uint64_t i) {
+            uint32_t n = batch->nodes[i];
+            int64_t first = column.lists ? column.lists->value_offset(n) : n;
+            float* out = &batch->features[i * feature_width_ + offset];
+            for (uint32_t j = 0; j < column.width; ++j) {
+              out[j] = static_cast<float>(values.Value(first + j));
+            }
+          },
+          katana::no_stats());
+    });
+    offset += column.width;
+  }
+}
+
+NeighborSampleLoader::NeighborSampleLoader(
+    NeighborSampler* sampler,
+    const std::vector<std::vector<uint32_t>>* seed_batches,
+    std::vector<uint32_t> fanouts, size_t depth)
+    : sampler_(sampler),
+      seed_batches_(seed_batches),
+      fanouts_(std::move(fanouts)),
+      slots_(depth + 1) {
+  KATANA_LOG_ASSERT(depth > 0);
+  producer_ = std::thread([this]() { Produce(); });
+}
+
+NeighborSampleLoader::~NeighborSampleLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  changed_.notify_all();
+  producer_.join();
+}
+
+void
+NeighborSampleLoader::Produce() {
+  while (true) {
+    size_t next;
+    {
+      // The batch in use is the last one returned, consumed_ - 1, and the
+      // depth batches after it have the other slots
+      std::unique_lock<std::mutex> lock(mutex_);
+      changed_.wait(lock, [&]() {
+        return stopping_ || produced_ < consumed_ + slots_.size() - 1;
+      });
+      if (stopping_ || produced_ == seed_batches_->size()) {
+        return;
+      }
+      next = produced_;
+    }
+
+    Slot& slot = slots_[next % slots_.size()];
+    auto res = sampler_->Sample((*seed_batches_)[next], fanouts_, &slot.batch);
+    if (res) {
+      slot.error.reset();
+    } else {
+      slot.error.emplace(res.error());
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++produced_;
+    }
+    changed_.notify_all();
+  }
+}
+
+katana::Result<const NeighborSample*>
+NeighborSampleLoader::Next() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (consumed_ == seed_batches_->size()) {
+    return static_cast<const NeighborSample*>(nullptr);
+  }
+  size_t next = consumed_;
+  changed_.wait(lock, [&]() { return produced_ > next; });
+  ++consumed_;
+  lock.unlock();
+  changed_.notify_all();
+
+  const Slot& slot = slots_[next % slots_.size()];
+  if (slot.error) {
+    std::ostringstream message;
+    message << *slot.error;
+    return katana::ErrorInfo(slot.error->error_code(), message.str());
+  }
+  return &slot.batch;
+}
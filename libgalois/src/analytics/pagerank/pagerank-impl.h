@@ -27,6 +27,7 @@
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
+#include "katana/TemporalWindow.h"
 #include "katana/analytics/Utils.h"
 #include "katana/analytics/pagerank/pagerank.h"
 
@@ -37,6 +38,10 @@ katana::Result<void> PagerankPullTopological(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan);
 
+katana::Result<void> PagerankPullBlocked(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan);
+
 katana::Result<void> PagerankPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan);
@@ -49,4 +54,21 @@ katana::Result<void> PagerankPushSynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan);
 
+/// Push-synchronous Page Rank over the edges of window alone
+katana::Result<void> PagerankPushSynchronous(
+    const katana::TemporalWindow& window,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan);
+
+katana::Result<void> PagerankPushIncremental(
+    katana::PropertyGraph* pg, const std::string& rank_property_name,
+    const katana::analytics::PagerankEdgeChanges& changes,
+    katana::analytics::PagerankPlan plan);
+
+katana::Result<void> PagerankPushPersonalized(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets,
+    const std::vector<std::string>& output_property_names,
+    katana::analytics::PagerankPlan plan);
+
 #endif
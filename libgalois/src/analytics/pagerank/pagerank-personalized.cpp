@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/LargeArray.h"
+#include "katana/TypedPropertyGraph.h"
+#include "pagerank-impl.h"
+
+using katana::atomicAdd;
+
+namespace {
+
+using GNode = katana::GraphTopology::Node;
+
+/// Number of seed sets computed together, one lane per seed set. The ranks
+/// and the residuals of a node for a whole batch each fill one cache line.
+constexpr size_t kSeedSetsPerBatch = 16;
+static_assert(kSeedSetsPerBatch <= 32, "lanes are tracked in a uint32_t");
+
+struct alignas(64) Ranks {
+  std::array<PRTy, kSeedSetsPerBatch> lane;
+};
+
+struct alignas(64) Residuals {
+  std::array<std::atomic<PRTy>, kSeedSetsPerBatch> lane;
+};
+
+/// Personalized Page Rank for a batch of seed sets with the push-residual
+/// algorithm.
+///
+/// Each seed set starts with a residual of initial_residual spread over its
+/// seeds and none anywhere else. Pushing a node moves its residuals into its
+/// ranks and sends alpha of them to its neighbors, for all lanes at once, so
+/// a batch traverses each edge once per round instead of once per seed set.
+class PersonalizedPagerank {
+  const katana::GraphTopology& topology_;
+  const katana::analytics::PagerankPlan& plan_;
+  katana::LargeArray<Ranks> ranks_;
+  katana::LargeArray<Residuals> residuals_;
+  katana::LargeArray<std::atomic<bool>> queued_;
+  katana::InsertBag<GNode> active_;
+  katana::InsertBag<GNode> next_;
+
+  static void Activate(
+      std::atomic<bool>& queued, GNode n, katana::InsertBag<GNode>* bag) {
+    if (!queued.load(std::memory_order_relaxed) && !queued.exchange(true)) {
+      bag->push(n);
+    }
+  }
+
+  void Push(GNode src) {
+    queued_[src] = false;
+
+    size_t degree = topology_.edges(src).size();
+    Ranks& rank = ranks_[src];
+    Residuals& residual = residuals_[src];
+    std::array<PRTy, kSeedSetsPerBatch> delta;
+    uint32_t lanes = 0;
+    for (size_t k = 0; k < kSeedSetsPerBatch; ++k) {
+      PRTy r = residual.lane[k].exchange(0);
+      rank.lane[k] += r;
+      delta[k] = degree ? r * plan_.alpha() / degree : 0;
+      if (delta[k] != 0) {
+        lanes |= uint32_t{1} << k;
+      }
+    }
+    if (!lanes) {
+      return;
+    }
+
+    //! For each out-going neighbors, only the lanes that have something
+    //! to push.
+    for (const auto& e : topology_.edges(src)) {
+      GNode dst = topology_.edge_dest(e);
+      Residuals& dst_residual = residuals_[dst];
+      bool crossed = false;
+      for (uint32_t m = lanes; m; m &= m - 1) {
+        unsigned k = __builtin_ctz(m);
+        PRTy old = atomicAdd(dst_residual.lane[k], delta[k]);
+        crossed |= old < plan_.tolerance() &&
+                   old + delta[k] >= plan_.tolerance();
+      }
+      if (crossed) {
+        Activate(queued_[dst], dst, &next_);
+      }
+    }
+  }
+
+public:
+  PersonalizedPagerank(
+      const katana::GraphTopology& topology,
+      const katana::analytics::PagerankPlan& plan)
+      : topology_(topology), plan_(plan) {
+    size_t num_nodes = topology_.num_nodes();
+    ranks_.allocateBlocked(num_nodes);
+    residuals_.allocateBlocked(num_nodes);
+    queued_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          ranks_.constructAt(n);
+          residuals_.constructAt(n);
+          queued_.constructAt(n, false);
+        },
+        katana::no_stats(), katana::loopname("PersonalizedInit"));
+  }
+
+  /// Compute the ranks of up to kSeedSetsPerBatch seed sets
+  void RunBatch(const std::vector<uint32_t>* seed_sets, size_t num_sets) {
+    KATANA_LOG_DEBUG_ASSERT(num_sets <= kSeedSetsPerBatch);
+
+    katana::do_all(
+        katana::iterate(size_t{0}, topology_.num_nodes()),
+        [&](size_t n) {
+          for (size_t k = 0; k < kSeedSetsPerBatch; ++k) {
+            ranks_[n].lane[k] = 0;
+            residuals_[n].lane[k] = 0;
+          }
+        },
+        katana::no_stats(), katana::loopname("PersonalizedReset"));
+
+    for (size_t k = 0; k < num_sets; ++k) {
+      const std::vector<uint32_t>& seeds = seed_sets[k];
+      for (GNode s : seeds) {
+        atomicAdd(
+            residuals_[s].lane[k], plan_.initial_residual() / seeds.size());
+        Activate(queued_[s], s, &active_);
+      }
+    }
+
+    while (!active_.empty()) {
+      katana::do_all(
+          katana::iterate(active_), [&](GNode n) { Push(n); },
+          katana::steal(),
+          katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+          katana::loopname("PersonalizedPush"));
+      active_.clear();
+      active_.swap(next_);
+    }
+  }
+
+  PRTy rank(GNode n, size_t k) const { return ranks_[n].lane[k]; }
+};
+
+}  // namespace
+
+katana::Result<void>
+PagerankPushPersonalized(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets,
+    const std::vector<std::string>& output_property_names,
+    katana::analytics::PagerankPlan plan) {
+  if (seed_sets.size() != output_property_names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} seed sets but {} output properties", seed_sets.size(),
+        output_property_names.size());
+  }
+  for (const auto& seeds : seed_sets) {
+    for (auto s : seeds) {
+      if (s >= pg->num_nodes()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "seed {} is not a node", s);
+      }
+    }
+  }
+
+  katana::EnsurePreallocated(
+      2, pg->num_nodes() * (sizeof(Ranks) + sizeof(Residuals) + 1));
+  katana::reportPageAlloc("MemAllocPre");
+  PersonalizedPagerank personalized(pg->topology(), plan);
+  katana::reportPageAlloc("MemAllocMid");
+
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<NodeValue>, std::tuple<>>;
+
+  for (size_t i = 0; i < seed_sets.size(); i += kSeedSetsPerBatch) {
+    size_t num_sets = std::min(kSeedSetsPerBatch, seed_sets.size() - i);
+    personalized.RunBatch(seed_sets.data() + i, num_sets);
+
+    for (size_t k = 0; k < num_sets; ++k) {
+      const std::string& name = output_property_names[i + k];
+      if (auto result =
+              katana::analytics::ConstructNodeProperties<std::tuple<NodeValue>>(
+                  pg, {name});
+          !result) {
+        return result.error();
+      }
+      auto graph_result = Graph::Make(pg, {name}, {});
+      if (!graph_result) {
+        return graph_result.error();
+      }
+      auto graph = graph_result.value();
+      katana::do_all(
+          katana::iterate(graph),
+          [&](GNode n) {
+            graph.GetData<NodeValue>(n) = personalized.rank(n, k);
+          },
+          katana::no_stats(), katana::loopname("PersonalizedExtract"));
+    }
+  }
+  katana::reportPageAlloc("MemAllocPost");
+
+  return katana::ResultSuccess();
+}
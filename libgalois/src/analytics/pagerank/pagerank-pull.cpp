@@ -17,9 +17,16 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <limits>
+#include <vector>
+
 #include <arrow/type.h>
 
+#include "katana/AdjacencyPrefetcher.h"
+#include "katana/BFloat16.h"
+#include "katana/EdgeBalancedRange.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Checkpoint.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
 
@@ -42,6 +49,10 @@ typedef typename Graph::Node GNode;
 using DeltaArray = katana::LargeArray<PRTy>;
 using ResidualArray = katana::LargeArray<PRTy>;
 
+//! Nodes ahead of the pull loops to prefetch the edges and their
+//! destinations of
+constexpr unsigned kPrefetchDistance = 16;
+
 //! Initialize nodes for the topological algorithm.
 void
 InitNodeDataTopological(Graph* graph) {
@@ -73,6 +84,103 @@ InitNodeDataResidual(
       katana::loopname("initNodeData"));
 }
 
+//! The columns of the checkpoints of the pull algorithms
+constexpr const char* kRankColumn = "rank";
+constexpr const char* kResidualColumn = "residual";
+
+//! The state of the residual algorithm
+std::shared_ptr<arrow::Schema>
+ResidualCheckpointSchema() {
+  auto type = arrow::CTypeTraits<PRTy>::type_singleton();
+  return arrow::schema(
+      {arrow::field(kRankColumn, type), arrow::field(kResidualColumn, type)});
+}
+
+//! The name of the checkpoints of algorithm on graph. The size of the graph
+//! keeps the state of one graph from being restored into another.
+std::string
+CheckpointName(const char* algorithm, const Graph& graph) {
+  return fmt::format(
+      "PagerankPull{}/{}/{}", algorithm, graph.size(), graph.num_edges());
+}
+
+//! Save the state after iteration, made by make_state, if a checkpoint is
+//! due. Failures do not stop the algorithm; they are only logged.
+template <typename F>
+void
+SaveCheckpoint(const std::string& name, uint64_t iteration, F make_state) {
+  katana::analytics::Checkpointer* checkpointer =
+      katana::analytics::CurrentCheckpointer();
+  if (!checkpointer || !checkpointer->IsDue(iteration)) {
+    return;
+  }
+  katana::Result<std::shared_ptr<arrow::Table>> state_res = make_state();
+  if (!state_res) {
+    KATANA_LOG_WARN("not checkpointing {}: {}", name, state_res.error());
+    return;
+  }
+  if (auto r = checkpointer->Save(name, iteration, state_res.value()); !r) {
+    KATANA_LOG_WARN("not checkpointing {}: {}", name, r.error());
+  }
+}
+
+//! Restore the state of the last checkpoint of name with restore_state.
+//! \returns the iterations done in the checkpoint, or 0 if there is none or
+//!     it could not be restored
+template <typename F>
+uint64_t
+RestoreCheckpoint(const std::string& name, F restore_state) {
+  katana::analytics::Checkpointer* checkpointer =
+      katana::analytics::CurrentCheckpointer();
+  if (!checkpointer) {
+    return 0;
+  }
+  auto checkpoint_res = checkpointer->Restore(name);
+  if (!checkpoint_res) {
+    KATANA_LOG_WARN("not restoring {}: {}", name, checkpoint_res.error());
+    return 0;
+  }
+  if (!checkpoint_res.value()) {
+    return 0;
+  }
+  const auto& checkpoint = *checkpoint_res.value();
+  if (auto r = restore_state(*checkpoint.state); !r) {
+    KATANA_LOG_WARN("not restoring {}: {}", name, r.error());
+    return 0;
+  }
+  return checkpoint.iteration;
+}
+
+//! Restore the ranks of the topological algorithms, which are their state
+uint64_t
+RestoreRanks(Graph* graph, const std::string& name) {
+  return RestoreCheckpoint(name, [&](const arrow::Table& state) {
+    return katana::analytics::RestoreCheckpointColumn<PRTy>(
+        state, kRankColumn, graph->size(), [&](uint64_t n, PRTy rank) {
+          graph->GetData<PagerankValueAndOutDegree>(n).value = rank;
+        });
+  });
+}
+
+//! Save the ranks of the topological algorithms
+void
+SaveRanks(Graph* graph, const std::string& name, uint64_t iteration) {
+  SaveCheckpoint(
+      name, iteration, [&]() -> katana::Result<std::shared_ptr<arrow::Table>> {
+        auto rank_res = katana::analytics::MakeCheckpointColumn<PRTy>(
+            graph->size(), [&](uint64_t n) {
+              return graph->GetData<PagerankValueAndOutDegree>(n).value;
+            });
+        if (!rank_res) {
+          return rank_res.error();
+        }
+        return arrow::Table::Make(
+            arrow::schema({arrow::field(
+                kRankColumn, arrow::CTypeTraits<PRTy>::type_singleton())}),
+            {rank_res.value()});
+      });
+}
+
 //! Computing outdegrees in the tranpose graph is equivalent to computing the
 //! indegrees in the original graph.
 void
@@ -83,31 +191,26 @@ ComputeOutDeg(Graph* graph) {
   katana::LargeArray<std::atomic<size_t>> vec;
   vec.allocateInterleaved(graph->size());
 
-  katana::do_all(
-      katana::iterate(*graph),
-      [&](const GNode& src) { vec.constructAt(src, 0ul); },
-      katana::loopname("InitDegVec"));
-
-  katana::do_all(
-      katana::iterate(*graph),
-      [&](const GNode& src) {
-        for (auto nbr : graph->edges(src)) {
-          auto dest = graph->GetEdgeDest(nbr);
-          vec[*dest].fetch_add(1ul);
-        }
-      },
-      katana::steal(),
-      katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+  //! Counting adds to the degrees of other threads' nodes, so it is
+  //! fenced off from the phases before and after it.
+  katana::do_all_fused(
+      katana::iterate_edge_balanced(*graph),
+      katana::phases(
+          [&](const GNode& src) { vec.constructAt(src, 0ul); },
+          katana::phase_barrier(),
+          [&](const GNode& src) {
+            for (auto nbr : graph->edges(src)) {
+              auto dest = graph->GetEdgeDest(nbr);
+              vec[*dest].fetch_add(1ul);
+            }
+          },
+          katana::phase_barrier(),
+          [&](const GNode& src) {
+            auto& sdata = graph->GetData<PagerankValueAndOutDegree>(src);
+            sdata.out = vec[src];
+          }),
       katana::loopname("ComputeOutDeg"));
 
-  katana::do_all(
-      katana::iterate(*graph),
-      [&](const GNode& src) {
-        auto& sdata = graph->GetData<PagerankValueAndOutDegree>(src);
-        sdata.out = vec[src];
-      },
-      katana::loopname("CopyDeg"));
-
   out_degree_timer.stop();
 }
 
@@ -123,7 +226,29 @@ void
 ComputePRResidual(
     Graph* graph, DeltaArray& delta, ResidualArray& residual,
     katana::analytics::PagerankPlan plan) {
-  unsigned int iterations = 0;
+  //! The state of an iteration is the ranks and residuals; the deltas are
+  //! computed from them.
+  std::string checkpoint_name = CheckpointName("Residual", *graph);
+  unsigned int iterations = RestoreCheckpoint(
+      checkpoint_name, [&](const arrow::Table& state) -> katana::Result<void> {
+        //! Check both columns before restoring either
+        if (!state.schema()->Equals(*ResidualCheckpointSchema())) {
+          return KATANA_ERROR(
+              katana::ErrorCode::InvalidArgument,
+              "checkpoint is not of the residual algorithm: {}",
+              state.schema()->ToString());
+        }
+        if (auto r = katana::analytics::RestoreCheckpointColumn<PRTy>(
+                state, kResidualColumn, graph->size(),
+                [&](uint64_t n, PRTy value) { residual[n] = value; });
+            !r) {
+          return r.error();
+        }
+        return katana::analytics::RestoreCheckpointColumn<PRTy>(
+            state, kRankColumn, graph->size(), [&](uint64_t n, PRTy rank) {
+              graph->GetData<PagerankValueAndOutDegree>(n).value = rank;
+            });
+      });
   katana::GAccumulator<unsigned int> accum;
 
   while (true) {
@@ -148,7 +273,7 @@ ComputePRResidual(
         katana::loopname("PageRank_delta"));
 
     katana::do_all(
-        katana::iterate(*graph),
+        katana::iterate_edge_balanced(*graph),
         [&](const GNode& src) {
           float sum = 0;
           for (auto nbr : graph->edges(src)) {
@@ -163,71 +288,387 @@ ComputePRResidual(
         },
         katana::steal(),
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+        katana::prefetch_distance<kPrefetchDistance>(
+            katana::AdjacencyPrefetcher(graph->topology(), delta.data())),
         katana::loopname("PageRank"));
 
 #if DEBUG
     std::cout << "iteration: " << iterations << "\n";
 #endif
     iterations++;
-    if (iterations >= plan.max_iterations() || !accum.reduce()) {
+    if (iterations >= plan.max_iterations() || !accum.reduceHierarchical()) {
       break;
     }
     accum.reset();
+
+    SaveCheckpoint(
+        checkpoint_name, iterations,
+        [&]() -> katana::Result<std::shared_ptr<arrow::Table>> {
+          auto rank_res = katana::analytics::MakeCheckpointColumn<PRTy>(
+              graph->size(), [&](uint64_t n) {
+                return graph->GetData<PagerankValueAndOutDegree>(n).value;
+              });
+          if (!rank_res) {
+            return rank_res.error();
+          }
+          auto residual_res = katana::analytics::MakeCheckpointColumn<PRTy>(
+              graph->size(), [&](uint64_t n) { return residual[n]; });
+          if (!residual_res) {
+            return residual_res.error();
+          }
+          return arrow::Table::Make(
+              ResidualCheckpointSchema(),
+              {rank_res.value(), residual_res.value()});
+        });
   }  ///< End while(true).
   //! [scalarreduction]
 }
 
+/**
+ * Decides when the topological algorithms stop, and when they read the
+ * contributions of nodes in reduced precision.
+ *
+ * Rounding contributions to bfloat16 keeps the ranks from changing by less
+ * than its resolution allows, so once the change of an iteration reaches
+ * the tolerance or stops shrinking, the iterations go on in float until the
+ * change is within the tolerance. The ranks are thus as close to converged
+ * as those of a run in float.
+ */
+class PrecisionSchedule {
+  bool reduced_;
+  float last_change_{std::numeric_limits<float>::infinity()};
+  unsigned int reduced_iterations_{0};
+
+public:
+  explicit PrecisionSchedule(const katana::analytics::PagerankPlan& plan)
+      : reduced_(
+            plan.precision() == katana::analytics::PagerankPlan::kBFloat16) {}
+
+  bool reduced() const { return reduced_; }
+
+  /// 
+eturns true if an iteration that changed the ranks by change
+  ///     converged
+  bool Converged(float change, float tolerance) {
+    if (!reduced_) {
+      return change <= tolerance;
+    }
+    reduced_iterations_ += 1;
+    if (change <= tolerance || change >= last_change_) {
+      reduced_ = false;
+    }
+    last_change_ = change;
+    return false;
+  }
+
+  void Report() const {
+    if (reduced_iterations_ > 0) {
+      katana::ReportStatSingle(
+          "PageRank", "ReducedPrecisionIterations", reduced_iterations_);
+    }
+  }
+};
+
 /**
  * PageRank pull topological.
  * Always calculate the new pagerank for each iteration.
  */
 void
 ComputePRTopological(Graph* graph, katana::analytics::PagerankPlan plan) {
-  unsigned int iteration = 0;
+  std::string checkpoint_name = CheckpointName("Topological", *graph);
+  unsigned int iteration = RestoreRanks(graph, checkpoint_name);
   katana::GAccumulator<float> accum;
 
   float base_score = (1.0f - plan.alpha()) / graph->size();
-  while (true) {
-    katana::do_all(
-        katana::iterate(*graph),
-        [&](const GNode& src) {
-          auto& sdata = graph->GetData<PagerankValueAndOutDegree>(src);
-          float sum = 0.0;
+  auto* ranks = graph->GetNodePropertyData<PagerankValueAndOutDegree>();
+
+  PrecisionSchedule precision(plan);
+  //! In reduced precision, the contributions of nodes are computed once
+  //! per iteration, so each edge reads 2 bytes rather than a rank and a
+  //! degree
+  katana::LargeArray<katana::BFloat16> contribution;
+  if (precision.reduced()) {
+    contribution.allocateInterleaved(graph->size());
+  }
 
-          for (auto jj : graph->edges(src)) {
-            auto dest = graph->GetEdgeDest(jj);
-            auto& ddata = graph->GetData<PagerankValueAndOutDegree>(dest);
-            sum += ddata.value / ddata.out;
-          }
+  auto update = [&](const GNode& src, float sum) {
+    auto& sdata = ranks[src];
+    //! New value of pagerank after computing contributions from
+    //! incoming edges in the original graph.
+    float value = sum * plan.alpha() + base_score;
+    //! Find the delta in new and old pagerank values.
+    float diff = std::fabs(value - sdata.value);
 
-          //! New value of pagerank after computing contributions from
-          //! incoming edges in the original graph.
-          float value = sum * plan.alpha() + base_score;
-          //! Find the delta in new and old pagerank values.
-          float diff = std::fabs(value - sdata.value);
+    //! Do not update pagerank before the diff is computed since
+    //! there is a data dependence on the pagerank value.
+    sdata.value = value;
+    accum += diff;
+  };
 
-          //! Do not update pagerank before the diff is computed since
-          //! there is a data dependence on the pagerank value.
-          sdata.value = value;
-          accum += diff;
-        },
-        katana::steal(),
-        katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
-        katana::loopname("Pagerank Topological"));
+  while (true) {
+    if (precision.reduced()) {
+      katana::do_all(
+          katana::iterate(*graph),
+          [&](const GNode& n) {
+            auto& data = ranks[n];
+            contribution[n] =
+                katana::BFloat16(data.out ? data.value / data.out : 0);
+          },
+          katana::no_stats(), katana::loopname("PagerankContribution"));
+
+      katana::do_all(
+          katana::iterate_edge_balanced(*graph),
+          [&](const GNode& src) {
+            //! Accumulated in float
+            float sum = 0.0;
+            for (auto jj : graph->edges(src)) {
+              sum += contribution[*graph->GetEdgeDest(jj)];
+            }
+            update(src, sum);
+          },
+          katana::steal(),
+          katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+          katana::prefetch_distance<kPrefetchDistance>(
+              katana::AdjacencyPrefetcher(
+                  graph->topology(), contribution.data())),
+          katana::loopname("Pagerank Topological"));
+    } else {
+      katana::do_all(
+          katana::iterate_edge_balanced(*graph),
+          [&](const GNode& src) {
+            float sum = 0.0;
+
+            for (auto jj : graph->edges(src)) {
+              auto dest = graph->GetEdgeDest(jj);
+              auto& ddata = ranks[*dest];
+              sum += ddata.value / ddata.out;
+            }
+            update(src, sum);
+          },
+          katana::steal(),
+          katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+          katana::prefetch_distance<kPrefetchDistance>(
+              katana::AdjacencyPrefetcher(graph->topology(), ranks)),
+          katana::loopname("Pagerank Topological"));
+    }
 
 #if DEBUG
     std::cout << "iteration: " << iteration << " max delta: " << delta << "\n";
 #endif
     iteration += 1;
-    if (accum.reduce() <= plan.tolerance() ||
+    if (precision.Converged(accum.reduceHierarchical(), plan.tolerance()) ||
         iteration >= plan.max_iterations()) {
       break;
     }
     accum.reset();
 
+    SaveRanks(graph, checkpoint_name, iteration);
   }  ///< End while(true).
 
   katana::ReportStatSingle("PageRank", "Iterations", iteration);
+  precision.Report();
+}
+
+/// The edges of the transposed graph split into segments by the node they
+/// point to, which is the node whose rank is read when pulling. Within a
+/// segment, the edges are grouped by the node they belong to, in node order.
+///
+/// Pulling one segment at a time only reads the contributions of the nodes
+/// of that segment, so with segments small enough the random reads of a pull
+/// stay in cache (CSR segmenting); the sums of each node are accumulated with
+/// one sequential write per segment.
+class SegmentedEdges {
+  size_t segment_size_;
+  size_t num_segments_;
+  /// segment_begin_[s] is the first entry of segment s
+  std::vector<size_t> segment_begin_;
+  /// For each entry, the node it belongs to and the end of its edges
+  katana::LargeArray<uint32_t> nodes_;
+  katana::LargeArray<uint64_t> edge_end_;
+  katana::LargeArray<uint32_t> edge_dests_;
+
+public:
+  SegmentedEdges(const Graph& graph, size_t segment_size)
+      : segment_size_(segment_size),
+        num_segments_((graph.size() + segment_size - 1) / segment_size) {
+    unsigned num_threads = katana::getActiveThreads();
+    size_t num_segments = num_segments_;
+
+    // Each thread sorts a block of nodes into segments, so the entries and
+    // edges of a segment are laid out thread after thread.
+    std::vector<uint64_t> entry_offsets(num_threads * num_segments);
+    std::vector<uint64_t> edge_offsets(num_threads * num_segments);
+    katana::on_each([&](unsigned tid, unsigned total) {
+      auto [begin, end] = katana::block_range(
+          uint32_t{0}, uint32_t(graph.size()), tid, total);
+      uint64_t* entries = &entry_offsets[tid * num_segments];
+      uint64_t* edges = &edge_offsets[tid * num_segments];
+      std::vector<uint32_t> last(
+          num_segments, std::numeric_limits<uint32_t>::max());
+      for (uint32_t n = begin; n < end; ++n) {
+        for (auto e : graph.edges(n)) {
+          size_t s = *graph.GetEdgeDest(e) / segment_size_;
+          if (last[s] != n) {
+            last[s] = n;
+            ++entries[s];
+          }
+          ++edges[s];
+        }
+      }
+    });
+
+    // Exclusive prefix sums in (segment, thread) order
+    segment_begin_.resize(num_segments + 1);
+    uint64_t num_entries = 0;
+    uint64_t num_edges = 0;
+    for (size_t s = 0; s < num_segments; ++s) {
+      segment_begin_[s] = num_entries;
+      for (unsigned t = 0; t < num_threads; ++t) {
+        uint64_t entries = entry_offsets[t * num_segments + s];
+        uint64_t edges = edge_offsets[t * num_segments + s];
+        entry_offsets[t * num_segments + s] = num_entries;
+        edge_offsets[t * num_segments + s] = num_edges;
+        num_entries += entries;
+        num_edges += edges;
+      }
+    }
+    segment_begin_[num_segments] = num_entries;
+
+    nodes_.allocateBlocked(num_entries);
+    edge_end_.allocateBlocked(num_entries);
+    edge_dests_.allocateBlocked(num_edges);
+
+    katana::on_each([&](unsigned tid, unsigned total) {
+      auto [begin, end] = katana::block_range(
+          uint32_t{0}, uint32_t(graph.size()), tid, total);
+      uint64_t* entries = &entry_offsets[tid * num_segments];
+      uint64_t* edges = &edge_offsets[tid * num_segments];
+      std::vector<uint32_t> last(
+          num_segments, std::numeric_limits<uint32_t>::max());
+      std::vector<size_t> touched;
+      for (uint32_t n = begin; n < end; ++n) {
+        for (auto e : graph.edges(n)) {
+          uint32_t dest = *graph.GetEdgeDest(e);
+          size_t s = dest / segment_size_;
+          if (last[s] != n) {
+            last[s] = n;
+            nodes_[entries[s]++] = n;
+            touched.emplace_back(s);
+          }
+          edge_dests_[edges[s]++] = dest;
+        }
+        for (size_t s : touched) {
+          edge_end_[entries[s] - 1] = edges[s];
+        }
+        touched.clear();
+      }
+    });
+  }
+
+  size_t num_segments() const { return num_segments_; }
+  size_t segment_begin(size_t s) const { return segment_begin_[s]; }
+  size_t segment_end(size_t s) const { return segment_begin_[s + 1]; }
+
+  uint32_t node(size_t entry) const { return nodes_[entry]; }
+  /// The edges of an entry. An entry's edges directly follow the previous
+  /// entry's, across threads and segments.
+  uint64_t edge_begin(size_t entry) const {
+    return entry ? edge_end_[entry - 1] : 0;
+  }
+  uint64_t edge_end(size_t entry) const { return edge_end_[entry]; }
+  uint32_t edge_dest(uint64_t edge) const { return edge_dests_[edge]; }
+};
+
+/**
+ * PageRank pull topological over segmented edges.
+ * Computes the same ranks as ComputePRTopological, but from the ranks of the
+ * previous iteration only, one segment of source nodes at a time.
+ */
+void
+ComputePRBlocked(Graph* graph, katana::analytics::PagerankPlan plan) {
+  SegmentedEdges segmented(*graph, plan.segment_size());
+
+  PrecisionSchedule precision(plan);
+  katana::LargeArray<PRTy> contribution;
+  contribution.allocateBlocked(graph->size());
+  //! In reduced precision, twice the nodes fit a segment in cache
+  katana::LargeArray<katana::BFloat16> reduced_contribution;
+  if (precision.reduced()) {
+    reduced_contribution.allocateBlocked(graph->size());
+  }
+  katana::LargeArray<PRTy> sum;
+  sum.allocateBlocked(graph->size());
+
+  std::string checkpoint_name = CheckpointName("Blocked", *graph);
+  unsigned int iteration = RestoreRanks(graph, checkpoint_name);
+  katana::GAccumulator<float> accum;
+
+  //! Each node appears at most once in a segment, so the segment's partial
+  //! sums can be added without atomics.
+  auto pull_segments = [&](const auto& contributions) {
+    for (size_t s = 0; s < segmented.num_segments(); ++s) {
+      katana::do_all(
+          katana::iterate(segmented.segment_begin(s), segmented.segment_end(s)),
+          [&](size_t entry) {
+            float partial = 0;
+            for (uint64_t e = segmented.edge_begin(entry),
+                          end = segmented.edge_end(entry);
+                 e < end; ++e) {
+              partial += contributions[segmented.edge_dest(e)];
+            }
+            sum[segmented.node(entry)] += partial;
+          },
+          katana::steal(),
+          katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+          katana::no_stats(), katana::loopname("PagerankSegment"));
+    }
+  };
+
+  float base_score = (1.0f - plan.alpha()) / graph->size();
+  while (true) {
+    bool reduced = precision.reduced();
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& n) {
+          auto& data = graph->GetData<PagerankValueAndOutDegree>(n);
+          PRTy value = data.out ? data.value / data.out : 0;
+          if (reduced) {
+            reduced_contribution[n] = katana::BFloat16(value);
+          } else {
+            contribution[n] = value;
+          }
+          sum[n] = 0;
+        },
+        katana::no_stats(), katana::loopname("PagerankContribution"));
+
+    if (reduced) {
+      pull_segments(reduced_contribution);
+    } else {
+      pull_segments(contribution);
+    }
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& n) {
+          auto& data = graph->GetData<PagerankValueAndOutDegree>(n);
+          float value = sum[n] * plan.alpha() + base_score;
+          accum += std::fabs(value - data.value);
+          data.value = value;
+        },
+        katana::loopname("Pagerank Blocked"));
+
+    iteration += 1;
+    if (precision.Converged(accum.reduceHierarchical(), plan.tolerance()) ||
+        iteration >= plan.max_iterations()) {
+      break;
+    }
+    accum.reset();
+
+    SaveRanks(graph, checkpoint_name, iteration);
+  }
+
+  katana::ReportStatSingle("PageRank", "Iterations", iteration);
+  precision.Report();
 }
 
 katana::Result<void>
@@ -291,6 +732,40 @@ PagerankPullTopological(
   return ExtractValueFromTopoGraph(pg, graph, output_property_name);
 }
 
+katana::Result<void>
+PagerankPullBlocked(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan) {
+  if (plan.segment_size() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "segment size must be positive");
+  }
+
+  katana::EnsurePreallocated(2, 5 * pg->num_nodes() * sizeof(NodeData));
+  katana::analytics::TemporaryPropertyGuard temporary_property{pg};
+  if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
+          pg, {temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  auto compute_graph_result = Graph::Make(pg, {temporary_property.name()}, {});
+  if (!compute_graph_result) {
+    return compute_graph_result.error();
+  }
+  Graph graph = compute_graph_result.value();
+
+  InitNodeDataTopological(&graph);
+  ComputeOutDeg(&graph);
+
+  katana::StatTimer exec_time("PagerankPullBlocked");
+  exec_time.start();
+  ComputePRBlocked(&graph, plan);
+  exec_time.stop();
+
+  return ExtractValueFromTopoGraph(pg, graph, output_property_name);
+}
+
 katana::Result<void>
 PagerankPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
@@ -17,7 +17,12 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "katana/AtomicHelpers.h"
+#include "katana/CombiningScatter.h"
+#include "katana/ParallelSTL.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
@@ -36,6 +41,15 @@ using EdgeData = std::tuple<>;
 typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
 typedef typename Graph::Node GNode;
 
+/// True if adding delta to a residual of old takes it to or beyond the
+/// tolerance. Only the update that crosses the tolerance activates a node.
+bool
+ExceedsTolerance(
+    const katana::analytics::PagerankPlan& plan, PRTy old, PRTy delta) {
+  return std::abs(old) < plan.tolerance() &&
+         std::abs(old + delta) >= plan.tolerance();
+}
+
 void
 InitializeNodeResidual(Graph& graph, katana::analytics::PagerankPlan plan) {
   katana::do_all(
@@ -47,39 +61,22 @@ InitializeNodeResidual(Graph& graph, katana::analytics::PagerankPlan plan) {
       katana::no_stats(), katana::loopname("Initialize"));
 }
 
-}  // namespace
-
-katana::Result<void>
-PagerankPushAsynchronous(
-    katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan) {
-  katana::EnsurePreallocated(5, 5 * pg->num_nodes() * sizeof(NodeData));
-
-  katana::analytics::TemporaryPropertyGuard temporary_property{pg};
-
-  if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
-          pg, {output_property_name, temporary_property.name()});
-      !result) {
-    return result.error();
-  }
-
-  auto graph_result =
-      Graph::Make(pg, {output_property_name, temporary_property.name()}, {});
-  if (!graph_result) {
-    return graph_result.error();
-  }
-  Graph graph = graph_result.value();
-
-  InitializeNodeResidual(graph, plan);
-
+/// Push residuals until every node's residual is within the tolerance,
+/// starting from the nodes in initial. Residuals may be negative, as they are
+/// after edge deletions, so they are compared to the tolerance by magnitude.
+template <typename Range>
+void
+PushResidualsAsynchronous(
+    Graph& graph, const katana::analytics::PagerankPlan& plan,
+    const Range& initial) {
   typedef katana::PerSocketChunkFIFO<
       katana::analytics::PagerankPlan::kChunkSize>
       WL;
   katana::for_each(
-      katana::iterate(graph),
+      initial,
       [&](const GNode& src, auto& ctx) {
         auto& src_residual = graph.GetData<NodeResidual>(src);
-        if (src_residual > plan.tolerance()) {
+        if (std::abs(src_residual.load()) > plan.tolerance()) {
           PRTy old_residual = src_residual.exchange(0.0);
           auto& src_value = graph.GetData<NodeValue>(src);
           src_value += old_residual;
@@ -90,10 +87,9 @@ PagerankPushAsynchronous(
             for (const auto& jj : graph.edges(src)) {
               auto dest = graph.GetEdgeDest(jj);
               auto& dest_residual = graph.GetData<NodeResidual>(dest);
-              if (delta > 0) {
+              if (delta != 0) {
                 auto old = atomicAdd(dest_residual, delta);
-                if ((old < plan.tolerance()) &&
-                    (old + delta >= plan.tolerance())) {
+                if (ExceedsTolerance(plan, old, delta)) {
                   ctx.push(*dest);
                 }
               }
@@ -103,6 +99,34 @@ PagerankPushAsynchronous(
       },
       katana::loopname("PushResidualAsynchronous"),
       katana::disable_conflict_detection(), katana::wl<WL>());
+}
+
+}  // namespace
+
+katana::Result<void>
+PagerankPushAsynchronous(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan) {
+  katana::EnsurePreallocated(5, 5 * pg->num_nodes() * sizeof(NodeData));
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{pg};
+
+  if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
+          pg, {output_property_name, temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  auto graph_result =
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  Graph graph = graph_result.value();
+
+  InitializeNodeResidual(graph, plan);
+
+  PushResidualsAsynchronous(graph, plan, katana::iterate(graph));
 
   return katana::ResultSuccess();
 }
@@ -145,6 +169,19 @@ PagerankPushSynchronous(
       katana::iterate(graph), [&](const auto& src) { active_nodes.push(src); },
       katana::no_stats());
 
+  //! Residuals pushed to hubs are combined per thread; a node is activated
+  //! by the add, combined or not, that takes its residual to the tolerance.
+  katana::CombiningScatter<PRTy> scatter(
+      graph.topology(), graph.GetNodePropertyData<NodeResidual>());
+  auto activate = [&](GNode dest, PRTy old, PRTy delta) {
+    //! If fabs(old) is greater than tolerance, then it would
+    //! already have been processed in the previous do_all
+    //! loop.
+    if ((old <= plan.tolerance()) && (old + delta >= plan.tolerance())) {
+      active_nodes.push(dest);
+    }
+  };
+
   size_t iter = 0;
   for (; !active_nodes.empty() && iter < plan.max_iterations(); ++iter) {
     katana::do_all(
@@ -191,22 +228,207 @@ PagerankPushSynchronous(
           //! For each out-going neighbors.
           for (auto jj = up.beg; jj != up.end; ++jj) {
             auto dest = graph.GetEdgeDest(jj);
-            auto& ddata_residual = graph.GetData<NodeResidual>(dest);
-            auto old = atomicAdd(ddata_residual, up.delta);
-            //! If fabs(old) is greater than tolerance, then it would
-            //! already have been processed in the previous do_all
-            //! loop.
-            if ((old <= plan.tolerance()) &&
-                (old + up.delta >= plan.tolerance())) {
-              active_nodes.push(*dest);
-            }
+            scatter.Add(*dest, up.delta, activate);
           }
         },
         katana::steal(),
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
         katana::loopname("PushResidualSynchronous"));
+    scatter.Flush(activate);
 
     updates.clear();
   }
   return katana::ResultSuccess();
 }
+
+katana::Result<void>
+PagerankPushSynchronous(
+    const katana::TemporalWindow& window,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan) {
+  katana::PropertyGraph* pg = window.graph();
+  katana::analytics::TemporaryPropertyGuard temporary_property{pg};
+
+  if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
+          pg, {output_property_name, temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  auto graph_result =
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  Graph graph = graph_result.value();
+
+  InitializeNodeResidual(graph, plan);
+
+  katana::InsertBag<GNode> active_nodes;
+  katana::InsertBag<GNode> next_active_nodes;
+
+  katana::do_all(
+      katana::iterate(graph), [&](const auto& src) { active_nodes.push(src); },
+      katana::no_stats());
+
+  for (size_t iter = 0; !active_nodes.empty() && iter < plan.max_iterations();
+       ++iter) {
+    if (katana::IsCancelled()) {
+      return katana::ErrorCode::Cancelled;
+    }
+    katana::do_all(
+        katana::iterate(active_nodes),
+        [&](const GNode& src) {
+          auto& src_residual = graph.GetData<NodeResidual>(src);
+          if (src_residual.load() <= plan.tolerance()) {
+            return;
+          }
+          PRTy old_residual = src_residual.exchange(0.0);
+          graph.GetData<NodeValue>(src) += old_residual;
+
+          auto edges = window.edges(src);
+          if (edges.empty()) {
+            return;
+          }
+          PRTy delta = old_residual * plan.alpha() / edges.size();
+          for (auto e : edges) {
+            auto dest = window.edge_dest(e);
+            PRTy old = atomicAdd(graph.GetData<NodeResidual>(dest), delta);
+            if ((old <= plan.tolerance()) &&
+                (old + delta >= plan.tolerance())) {
+              next_active_nodes.push(dest);
+            }
+          }
+        },
+        katana::steal(),
+        katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+        katana::loopname("TemporalPushResidualSynchronous"));
+
+    active_nodes.swap(next_active_nodes);
+    next_active_nodes.clear();
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+PagerankPushIncremental(
+    katana::PropertyGraph* pg, const std::string& rank_property_name,
+    const katana::analytics::PagerankEdgeChanges& changes,
+    katana::analytics::PagerankPlan plan) {
+  using EdgeList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+  for (const EdgeList* list : {&changes.inserted, &changes.deleted}) {
+    for (const auto& [src, dst] : *list) {
+      if (src >= pg->num_nodes() || dst >= pg->num_nodes()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "changed edge ({}, {}) is not between nodes of the graph", src,
+            dst);
+      }
+    }
+  }
+
+  EdgeList inserted = changes.inserted;
+  EdgeList deleted = changes.deleted;
+  auto edge_key = [](const std::pair<uint32_t, uint32_t>& edge) {
+    return uint64_t{edge.first} << 32 | edge.second;
+  };
+  katana::ParallelSTL::radix_sort(inserted.begin(), inserted.end(), edge_key);
+  katana::ParallelSTL::radix_sort(deleted.begin(), deleted.end(), edge_key);
+
+  // The sources whose out-edges changed, with their changes
+  struct Affected {
+    uint32_t node;
+    size_t inserted_begin;
+    size_t inserted_end;
+    size_t deleted_begin;
+    size_t deleted_end;
+  };
+  std::vector<Affected> affected;
+  for (size_t i = 0, d = 0; i < inserted.size() || d < deleted.size();) {
+    uint32_t node = std::min(
+        i < inserted.size() ? inserted[i].first : pg->num_nodes(),
+        d < deleted.size() ? deleted[d].first : pg->num_nodes());
+    Affected a{node, i, i, d, d};
+    while (a.inserted_end < inserted.size() &&
+           inserted[a.inserted_end].first == node) {
+      ++a.inserted_end;
+    }
+    while (a.deleted_end < deleted.size() &&
+           deleted[a.deleted_end].first == node) {
+      ++a.deleted_end;
+    }
+    size_t new_degree = pg->topology().edges(node).size();
+    if (a.inserted_end - a.inserted_begin > new_degree) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node {} has more inserted edges than edges", node);
+    }
+    affected.emplace_back(a);
+    i = a.inserted_end;
+    d = a.deleted_end;
+  }
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{pg};
+
+  if (auto result =
+          katana::analytics::ConstructNodeProperties<std::tuple<NodeResidual>>(
+              pg, {temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  auto graph_result =
+      Graph::Make(pg, {rank_property_name, temporary_property.name()}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  Graph graph = graph_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { graph.GetData<NodeResidual>(n) = 0; },
+      katana::no_stats(), katana::loopname("InitializeIncremental"));
+
+  // The ranks were a fixed point for the old edges. Replace each affected
+  // source's old contribution to its neighbors with its new one; the
+  // difference is the only residual left. Old out-edges are the current ones
+  // minus the inserted ones plus the deleted ones.
+  katana::InsertBag<GNode> active;
+  auto add_residual = [&](GNode dst, PRTy delta) {
+    if (delta == 0) {
+      return;
+    }
+    auto old = atomicAdd(graph.GetData<NodeResidual>(dst), delta);
+    if (ExceedsTolerance(plan, old, delta)) {
+      active.push(dst);
+    }
+  };
+
+  katana::do_all(
+      katana::iterate(affected),
+      [&](const Affected& a) {
+        size_t new_degree = graph.edges(a.node).size();
+        size_t old_degree = new_degree - (a.inserted_end - a.inserted_begin) +
+                            (a.deleted_end - a.deleted_begin);
+        PRTy rank = graph.GetData<NodeValue>(a.node);
+        PRTy new_share = new_degree ? rank * plan.alpha() / new_degree : 0;
+        PRTy old_share = old_degree ? rank * plan.alpha() / old_degree : 0;
+
+        for (const auto& e : graph.edges(a.node)) {
+          add_residual(*graph.GetEdgeDest(e), new_share - old_share);
+        }
+        for (size_t i = a.inserted_begin; i < a.inserted_end; ++i) {
+          add_residual(inserted[i].second, old_share);
+        }
+        for (size_t i = a.deleted_begin; i < a.deleted_end; ++i) {
+          add_residual(deleted[i].second, -old_share);
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("SeedIncrementalResiduals"));
+
+  PushResidualsAsynchronous(graph, plan, katana::iterate(active));
+
+  return katana::ResultSuccess();
+}
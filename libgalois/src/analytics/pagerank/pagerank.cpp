@@ -17,25 +17,323 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <cmath>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Cancellation.h"
+#include "katana/MirrorSync.h"
 #include "katana/TypedPropertyGraph.h"
 #include "pagerank-impl.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+/// Synchronous topological push Pagerank on the partition pg of a graph
+/// partitioned across the hosts of tsuba::Comm(). In each round, nodes push
+/// their ranks over their local edges, mirrors reduce what they got into
+/// their masters by sum and masters compute their ranks and broadcast them
+/// to their mirrors. Out-degrees are those in the whole graph, as the edges
+/// of a node may be on several hosts.
+katana::Result<void>
+PagerankDistributed(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan) {
+  using Node = katana::GraphTopology::Node;
+  auto sync_res = katana::MirrorSync::Make(*pg, tsuba::Comm());
+  if (!sync_res) {
+    return sync_res.error();
+  }
+  katana::MirrorSync& sync = sync_res.value();
+
+  const katana::GraphTopology& topology = pg->topology();
+  const uint64_t num_nodes = topology.num_nodes();
+  // Every master and mirror is sent in every round
+  katana::DynamicBitset all;
+  all.resize(num_nodes);
+  all.bitwise_not();
+
+  katana::LargeArray<std::atomic<uint64_t>> degree;
+  katana::LargeArray<PRTy> rank;
+  katana::LargeArray<std::atomic<PRTy>> received;
+  degree.allocateBlocked(num_nodes);
+  rank.allocateBlocked(num_nodes);
+  received.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        degree.constructAt(n, topology.edges(n).size());
+        rank[n] = plan.initial_residual();
+        received.constructAt(n, 0);
+      },
+      katana::no_stats());
+
+  auto degree_of = [&](Node n) { return degree[n].load(); };
+  if (auto r = sync.Reduce<uint64_t>(
+          &all, degree_of,
+          [&](Node n, uint64_t d) {
+            degree[n] += d;
+            return true;
+          });
+      !r) {
+    return r.error();
+  }
+  if (auto r = sync.Broadcast<uint64_t>(
+          &all, degree_of, [&](Node n, uint64_t d) { degree[n] = d; });
+      !r) {
+    return r.error();
+  }
+
+  for (unsigned iter = 0; iter < plan.max_iterations(); ++iter) {
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node n) {
+          uint64_t d = degree[n].load();
+          if (d == 0) {
+            return;
+          }
+          PRTy share = rank[n] / d;
+          for (auto e : topology.edges(n)) {
+            katana::atomicAdd(received[topology.edge_dest(e)], share);
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    if (auto r = sync.Reduce<PRTy>(
+            &all, [&](Node n) { return received[n].load(); },
+            [&](Node n, PRTy value) {
+              katana::atomicAdd(received[n], value);
+              return true;
+            });
+        !r) {
+      return r.error();
+    }
+
+    katana::GReduceMax<PRTy> max_delta;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, sync.num_masters()),
+        [&](uint64_t n) {
+          PRTy next = plan.initial_residual() + plan.alpha() * received[n];
+          max_delta.update(std::fabs(next - rank[n]));
+          rank[n] = next;
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology), [&](Node n) { received[n] = 0; },
+        katana::no_stats());
+
+    if (auto r = sync.Broadcast<PRTy>(
+            &all, [&](Node n) { return rank[n]; },
+            [&](Node n, PRTy value) { rank[n] = value; });
+        !r) {
+      return r.error();
+    }
+    PRTy delta = sync.AllReduce(
+        max_delta.reduce(), [](PRTy a, PRTy b) { return std::max(a, b); });
+    if (delta < plan.tolerance()) {
+      break;
+    }
+  }
+
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<NodeValue>, std::tuple<>>;
+  if (auto r = katana::analytics::ConstructNodeProperties<
+          std::tuple<NodeValue>>(pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+  auto graph_res = Graph::Make(pg, {output_property_name}, {});
+  if (!graph_res) {
+    return graph_res.error();
+  }
+  Graph graph = graph_res.value();
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) { graph.GetData<NodeValue>(n) = rank[n]; },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+/// \returns the L1 norm of the change of ranks by one pull iteration on pg
+/// over (1 - alpha) times the L1 norm of ranks, which bounds the L1 distance
+/// of ranks from the fixed point, relative to the ranks
+katana::Result<double>
+RelativeErrorBound(
+    katana::PropertyGraph* pg, const arrow::FloatArray& ranks, double alpha) {
+  using Node = katana::GraphTopology::Node;
+  auto in_index_res = pg->GetInEdgeIndex();
+  if (!in_index_res) {
+    return in_index_res.error();
+  }
+  const katana::InEdgeIndex& in_index = *in_index_res.value();
+  const katana::GraphTopology& topology = pg->topology();
+  const float* rank = ranks.raw_values();
+
+  // The iteration keeps the sum of ranks that have out-edges scaled by
+  // alpha and adds the teleport term to every node; fit the term to the
+  // ranks
+  katana::GAccumulator<double> total;
+  katana::GAccumulator<double> linked;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        total += rank[n];
+        if (!topology.edges(n).empty()) {
+          linked += rank[n];
+        }
+      },
+      katana::no_stats());
+  if (total.reduce() <= 0) {
+    return 0.0;
+  }
+  double base =
+      (total.reduce() - alpha * linked.reduce()) / topology.num_nodes();
+
+  katana::GAccumulator<double> change;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        double sum = 0;
+        for (auto e : in_index.in_edges(n)) {
+          Node src = in_index.in_edge_src(e);
+          sum += rank[src] / topology.edges(src).size();
+        }
+        change += std::fabs(base + alpha * sum - rank[n]);
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("PagerankErrorBound"));
+  return change.reduce() / ((1 - alpha) * total.reduce());
+}
+
+}  // namespace
 
 katana::Result<void>
 katana::analytics::Pagerank(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan) {
+  if (auto r = CheckArchitecture(plan, {kCPU, kDistributedCPU}); !r) {
+    return r.error();
+  }
+  if (plan.precision() != PagerankPlan::kFloat &&
+      plan.algorithm() != PagerankPlan::kPullTopological &&
+      plan.algorithm() != PagerankPlan::kPullBlocked) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "only the topological pull algorithms support reduced precision");
+  }
+  if (plan.architecture() == kDistributedCPU) {
+    return PagerankDistributed(pg, output_property_name, plan);
+  }
+  katana::Result<void> r = katana::ResultSuccess();
   switch (plan.algorithm()) {
   case PagerankPlan::kPullResidual:
-    return PagerankPullResidual(pg, output_property_name, plan);
+    r = PagerankPullResidual(pg, output_property_name, plan);
+    break;
   case PagerankPlan::kPullTopological:
-    return PagerankPullTopological(pg, output_property_name, plan);
+    r = PagerankPullTopological(pg, output_property_name, plan);
+    break;
+  case PagerankPlan::kPullBlocked:
+    r = PagerankPullBlocked(pg, output_property_name, plan);
+    break;
   case PagerankPlan::kPushAsynchronous:
-    return PagerankPushAsynchronous(pg, output_property_name, plan);
+    r = PagerankPushAsynchronous(pg, output_property_name, plan);
+    break;
   case PagerankPlan::kPushSynchronous:
-    return PagerankPushSynchronous(pg, output_property_name, plan);
+    r = PagerankPushSynchronous(pg, output_property_name, plan);
+    break;
   default:
     return katana::ErrorCode::InvalidArgument;
   }
+
+  if (r && katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return r;
+}
+
+katana::Result<void>
+katana::analytics::Pagerank(
+    const katana::TemporalWindow& window,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (auto r = PagerankPushSynchronous(window, output_property_name, plan);
+      !r) {
+    return r.error();
+  }
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::PagerankIncremental(
+    katana::PropertyGraph* pg, const std::string& rank_property_name,
+    const PagerankEdgeChanges& changes, katana::analytics::PagerankPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (auto r = PagerankPushIncremental(pg, rank_property_name, changes, plan);
+      !r) {
+    return r.error();
+  }
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::PagerankPersonalized(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets,
+    const std::vector<std::string>& output_property_names,
+    katana::analytics::PagerankPlan plan) {
+  if (auto r =
+          PagerankPushPersonalized(pg, seed_sets, output_property_names, plan);
+      !r) {
+    return r.error();
+  }
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<katana::analytics::ApproximationStatistics>
+katana::analytics::ApproximatePagerank(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    SparsifyPlan sparsify_plan, PagerankPlan plan) {
+  auto sample_res = Sparsify(pg, sparsify_plan);
+  if (!sample_res) {
+    return sample_res.error();
+  }
+  PropertyGraph* sample = sample_res.value().graph.get();
+  if (auto r = Pagerank(sample, output_property_name, plan); !r) {
+    return r.error();
+  }
+  // The nodes are the same, so the ranks carry over as they are
+  auto ranks = sample->GetNodeProperty(output_property_name);
+  if (auto r = pg->AddNodeProperties(arrow::Table::Make(
+          arrow::schema({arrow::field(output_property_name, ranks->type())}),
+          {ranks}));
+      !r) {
+    return r.error();
+  }
+
+  auto ranks_res = pg->GetNodePropertyTyped<float>(output_property_name);
+  if (!ranks_res) {
+    return ranks_res.error();
+  }
+  auto bound_res = RelativeErrorBound(pg, *ranks_res.value(), plan.alpha());
+  if (!bound_res) {
+    return bound_res.error();
+  }
+  return ApproximationStatistics{
+      sample->num_edges(), sample_res.value().edge_fraction,
+      bound_res.value()};
 }
 
 /// \cond DO_NOT_DOCUMENT
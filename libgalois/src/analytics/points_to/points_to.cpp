@@ -0,0 +1,796 @@
+#include "katana/analytics/points_to/points_to.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Bag.h"
+#include "katana/Cancellation.h"
+#include "katana/LargeArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/SimpleLock.h"
+#include "katana/SparseBitmap.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using Kind = PointsToConstraint;
+
+constexpr Edge kNoEdge = std::numeric_limits<Edge>::max();
+constexpr uint8_t kNumKinds = 5;
+
+template <typename T>
+katana::Result<std::vector<Kind>>
+ConstraintKindsWithWrap(
+    katana::PropertyGraph* pg,
+    const std::string& constraint_kind_property_name) {
+  auto kinds_result =
+      pg->GetEdgePropertyTyped<T>(constraint_kind_property_name);
+  if (!kinds_result) {
+    return kinds_result.error();
+  }
+  auto kinds = kinds_result.value();
+
+  std::vector<Kind> result(pg->topology().num_edges());
+  katana::GReduceMin<Edge> invalid;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{result.size()}),
+      [&](Edge e) {
+        T kind = kinds->Value(e);
+        bool negative = false;
+        if constexpr (std::is_signed_v<T>) {
+          negative = kind < 0;
+        }
+        if (negative || kind >= kNumKinds) {
+          invalid.update(e);
+          return;
+        }
+        result[e] = static_cast<Kind>(kind);
+      },
+      katana::no_stats());
+  if (Edge e = invalid.reduce(); e != kNoEdge) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge {} has constraint kind {}, which is not a PointsToConstraint", e,
+        static_cast<int64_t>(kinds->Value(e)));
+  }
+  return result;
+}
+
+katana::Result<std::vector<Kind>>
+ConstraintKinds(
+    katana::PropertyGraph* pg,
+    const std::string& constraint_kind_property_name) {
+  auto kinds = pg->GetEdgeProperty(constraint_kind_property_name);
+  if (!kinds) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        constraint_kind_property_name);
+  }
+
+  switch (kinds->type()->id()) {
+  case arrow::UInt8Type::type_id:
+    return ConstraintKindsWithWrap<uint8_t>(pg, constraint_kind_property_name);
+  case arrow::Int8Type::type_id:
+    return ConstraintKindsWithWrap<int8_t>(pg, constraint_kind_property_name);
+  case arrow::UInt32Type::type_id:
+    return ConstraintKindsWithWrap<uint32_t>(
+        pg, constraint_kind_property_name);
+  case arrow::Int32Type::type_id:
+    return ConstraintKindsWithWrap<int32_t>(pg, constraint_kind_property_name);
+  case arrow::UInt64Type::type_id:
+    return ConstraintKindsWithWrap<uint64_t>(
+        pg, constraint_kind_property_name);
+  case arrow::Int64Type::type_id:
+    return ConstraintKindsWithWrap<int64_t>(pg, constraint_kind_property_name);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+bool
+IsCopy(Kind kind) {
+  return kind == Kind::kCopy || kind == Kind::kGetElementPtr;
+}
+
+/// Strongly connected components by an iterative version of Tarjan's
+/// algorithm, over a graph given by a function that lists the successors
+/// of a node. Visits are stamped with a search number, so nothing is cleared
+/// between searches.
+class SccFinder {
+  struct Frame {
+    uint64_t node;
+    /// The range of neighbors_ holding the successors of node
+    size_t begin;
+    size_t next;
+    size_t end;
+  };
+
+  std::vector<uint32_t> visited_;
+  std::vector<uint64_t> index_;
+  std::vector<uint64_t> low_;
+  std::vector<uint8_t> on_stack_;
+  std::vector<uint64_t> stack_;
+  std::vector<uint64_t> neighbors_;
+  std::vector<Frame> frames_;
+  uint32_t search_{1};
+  uint64_t counter_{0};
+
+  template <typename SuccessorsFn>
+  void Push(uint64_t n, SuccessorsFn& successors) {
+    visited_[n] = search_;
+    index_[n] = low_[n] = counter_++;
+    stack_.emplace_back(n);
+    on_stack_[n] = true;
+    size_t begin = neighbors_.size();
+    successors(n, &neighbors_);
+    frames_.emplace_back(Frame{n, begin, begin, neighbors_.size()});
+  }
+
+public:
+  explicit SccFinder(uint64_t num_nodes)
+      : visited_(num_nodes),
+        index_(num_nodes),
+        low_(num_nodes),
+        on_stack_(num_nodes) {}
+
+  /// Start a new search, which has visited no node yet
+  void NewSearch() { ++search_; }
+
+  /// Visit every node reachable from start that this search has not visited
+  /// yet. successors(n, &out) appends the successors of n to out, and
+  /// scc(first, last) is called with each component found.
+  template <typename SuccessorsFn, typename SccFn>
+  void Visit(uint64_t start, SuccessorsFn successors, SccFn scc) {
+    if (visited_[start] == search_) {
+      return;
+    }
+    Push(start, successors);
+    while (!frames_.empty()) {
+      Frame& frame = frames_.back();
+      if (frame.next < frame.end) {
+        uint64_t w = neighbors_[frame.next++];
+        if (visited_[w] != search_) {
+          Push(w, successors);
+        } else if (on_stack_[w]) {
+          low_[frame.node] = std::min(low_[frame.node], index_[w]);
+        }
+        continue;
+      }
+
+      uint64_t n = frame.node;
+      neighbors_.resize(frame.begin);
+      frames_.pop_back();
+      if (!frames_.empty()) {
+        uint64_t parent = frames_.back().node;
+        low_[parent] = std::min(low_[parent], low_[n]);
+      }
+      if (low_[n] != index_[n]) {
+        continue;
+      }
+      size_t first = stack_.size();
+      do {
+        --first;
+        on_stack_[stack_[first]] = false;
+      } while (stack_[first] != n);
+      scc(stack_.data() + first, stack_.data() + stack_.size());
+      stack_.resize(first);
+    }
+  }
+};
+
+/// Andersen's analysis by rounds of parallel difference propagation, with
+/// hybrid cycle detection. Variables found to be on a cycle are merged into
+/// one representative, which holds the points-to set, pending pointees,
+/// successors and complex constraints of all of them.
+class AndersenSolver {
+  struct Scratch {
+    katana::SparseBitmap delta;
+    katana::SparseBitmap added;
+    katana::SparseBitmap copy;
+    std::vector<Node> succ;
+  };
+
+  const katana::GraphTopology& topology_;
+  const katana::InEdgeIndex& in_edges_;
+  const std::vector<Kind>& kinds_;
+  bool detect_cycles_;
+  uint64_t num_nodes_;
+
+  /// The union-find parent of each node. It only changes between rounds,
+  /// when all paths are compressed.
+  std::vector<Node> rep_;
+  std::vector<Node> compressed_;
+  std::vector<katana::SimpleLock> locks_;
+  /// The pointees of each representative, as node ids
+  std::vector<katana::SparseBitmap> pts_;
+  /// The pointees of each representative not propagated yet
+  std::vector<katana::SparseBitmap> pending_;
+  /// The copy successors of each representative, which may have been merged
+  /// into others since
+  std::vector<katana::SparseBitmap> succ_;
+  /// The targets of the loads dst = *n from each node
+  std::vector<std::vector<Node>> loads_;
+  /// The sources of the stores *n = src to each node
+  std::vector<std::vector<Node>> stores_;
+  /// The nodes that every pointee of each node must be merged with, found
+  /// by offline cycle detection
+  std::vector<std::vector<Node>> hcd_;
+
+  /// The last round each node was scheduled for
+  katana::LargeArray<std::atomic<uint32_t>> stamp_;
+  uint32_t round_{0};
+  katana::InsertBag<Node> next_;
+  /// Pointees to merge with a node, found by offline cycle detection
+  katana::InsertBag<std::pair<Node, Node>> unify_;
+  /// Copy edges that did not change their target
+  katana::InsertBag<std::pair<Node, Node>> lcd_candidates_;
+  /// Copy edges lazy cycle detection has already searched from, so that it
+  /// searches from each at most once
+  std::unordered_set<uint64_t> lcd_checked_;
+  katana::PerThreadStorage<Scratch> scratch_;
+  katana::SparseBitmap merge_scratch_;
+
+  Node Find(Node n) const {
+    while (rep_[n] != n) {
+      n = rep_[n];
+    }
+    return n;
+  }
+
+  void Activate(Node n) {
+    if (stamp_[n].exchange(round_ + 1) != round_ + 1) {
+      next_.push(n);
+    }
+  }
+
+  /// Add pointees to the points-to set of to
+  void AddPointees(Node to, const katana::SparseBitmap& pointees, Scratch* s) {
+    bool changed = false;
+    locks_[to].lock();
+    if (pts_[to].UnionWith(pointees, &s->added)) {
+      pending_[to].UnionWith(s->added);
+      changed = true;
+    }
+    locks_[to].unlock();
+    if (changed) {
+      Activate(to);
+    }
+  }
+
+  /// Add the copy edge from -> to, sending all pointees of from along it if
+  /// it is new. Later pointees of from are sent when from is processed.
+  void AddEdge(Node from, Node to, Scratch* s) {
+    if (from == to) {
+      return;
+    }
+    locks_[from].lock();
+    bool fresh = succ_[from].set(to);
+    if (fresh) {
+      s->copy = pts_[from];
+    }
+    locks_[from].unlock();
+    if (fresh && !s->copy.empty()) {
+      AddPointees(to, s->copy, s);
+    }
+  }
+
+  void Process(Node u, Scratch* s) {
+    locks_[u].lock();
+    s->delta.swap(pending_[u]);
+    pending_[u].clear();
+    locks_[u].unlock();
+    if (s->delta.empty()) {
+      return;
+    }
+
+    for (Node a : hcd_[u]) {
+      s->delta.ForEach([&](Node v) {
+        if (Find(v) != Find(a)) {
+          unify_.push(std::make_pair(v, a));
+        }
+      });
+    }
+    for (Node dst : loads_[u]) {
+      Node to = Find(dst);
+      s->delta.ForEach([&](Node v) { AddEdge(Find(v), to, s); });
+    }
+    for (Node src : stores_[u]) {
+      Node from = Find(src);
+      s->delta.ForEach([&](Node v) { AddEdge(from, Find(v), s); });
+    }
+
+    // Edges added after this snapshot get the whole set of u when they are
+    // added, which includes delta
+    s->succ.clear();
+    locks_[u].lock();
+    succ_[u].ForEach([&](Node w) { s->succ.emplace_back(w); });
+    locks_[u].unlock();
+    for (Node w : s->succ) {
+      w = Find(w);
+      if (w == u) {
+        continue;
+      }
+      bool changed = false;
+      locks_[w].lock();
+      if (pts_[w].UnionWith(s->delta, &s->added)) {
+        pending_[w].UnionWith(s->added);
+        changed = true;
+      }
+      locks_[w].unlock();
+      if (changed) {
+        Activate(w);
+      } else if (detect_cycles_) {
+        lcd_candidates_.push(std::make_pair(u, w));
+      }
+    }
+  }
+
+  /// Merge the representatives of x and y. Only call between rounds.
+  bool Unify(Node x, Node y) {
+    x = Find(x);
+    y = Find(y);
+    if (x == y) {
+      return false;
+    }
+    if (pts_[y].num_blocks() + succ_[y].num_blocks() >
+        pts_[x].num_blocks() + succ_[x].num_blocks()) {
+      std::swap(x, y);
+    }
+    rep_[y] = x;
+
+    // Whatever either side lacked has yet to reach its successors and
+    // complex constraints
+    merge_scratch_.AssignDifference(pts_[y], pts_[x]);
+    pending_[x].UnionWith(merge_scratch_);
+    merge_scratch_.AssignDifference(pts_[x], pts_[y]);
+    pending_[x].UnionWith(merge_scratch_);
+    pending_[x].UnionWith(pending_[y]);
+    pts_[x].UnionWith(pts_[y]);
+    succ_[x].UnionWith(succ_[y]);
+    for (auto* lists : {&loads_, &stores_, &hcd_}) {
+      auto& from = (*lists)[y];
+      auto& to = (*lists)[x];
+      to.insert(to.end(), from.begin(), from.end());
+      std::vector<Node>().swap(from);
+    }
+    katana::SparseBitmap().swap(pts_[y]);
+    katana::SparseBitmap().swap(pending_[y]);
+    katana::SparseBitmap().swap(succ_[y]);
+
+    if (!pending_[x].empty()) {
+      Activate(x);
+    }
+    return true;
+  }
+
+  void CompressPaths() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) { compressed_[n] = Find(n); }, katana::no_stats());
+    rep_.swap(compressed_);
+  }
+
+  /// Hybrid cycle detection, offline part: find cycles in the graph of
+  /// constraints with a node n for each variable and a node *n for what it
+  /// points to. Cycles of variables alone are merged now. A cycle with
+  /// variable a and *p means that every pointee of p will be on a cycle
+  /// with a, so they are merged as the pointees are found.
+  void OfflineCycleDetection() {
+    uint64_t num_nodes = num_nodes_;
+    auto successors = [&](uint64_t x, std::vector<uint64_t>* out) {
+      Node n = x % num_nodes;
+      bool is_ref = x >= num_nodes;
+      for (Edge e : topology_.edges(n)) {
+        Node dst = topology_.edge_dest(e);
+        Kind kind = kinds_[e];
+        if (!is_ref && IsCopy(kind)) {
+          out->emplace_back(dst);
+        } else if (!is_ref && kind == Kind::kStore) {
+          out->emplace_back(num_nodes + dst);
+        } else if (is_ref && kind == Kind::kLoad) {
+          out->emplace_back(dst);
+        }
+      }
+    };
+
+    std::vector<std::vector<Node>> cycles;
+    SccFinder finder(2 * num_nodes);
+    for (uint64_t x = 0; x < 2 * num_nodes; ++x) {
+      finder.Visit(
+          x, successors, [&](const uint64_t* first, const uint64_t* last) {
+            if (last - first < 2) {
+              return;
+            }
+            std::vector<Node> vars;
+            std::vector<Node> refs;
+            for (const uint64_t* it = first; it != last; ++it) {
+              if (*it < num_nodes) {
+                vars.emplace_back(*it);
+              } else {
+                refs.emplace_back(*it - num_nodes);
+              }
+            }
+            if (refs.empty()) {
+              cycles.emplace_back(std::move(vars));
+              return;
+            }
+            // There is no cycle through refs alone
+            for (Node p : refs) {
+              hcd_[p].emplace_back(vars.front());
+            }
+          });
+    }
+
+    for (const auto& cycle : cycles) {
+      for (Node n : cycle) {
+        Unify(cycle.front(), n);
+      }
+    }
+    CompressPaths();
+  }
+
+  /// Merge the cycles found this round: those offline cycle detection
+  /// predicted, and those found by lazy cycle detection, which searches for
+  /// a cycle through each copy edge whose ends have equal points-to sets.
+  void CollapseCycles(SccFinder* finder) {
+    bool merged = false;
+    for (const auto& [v, a] : unify_) {
+      merged |= Unify(v, a);
+    }
+    unify_.clear();
+
+    auto successors = [&](uint64_t x, std::vector<uint64_t>* out) {
+      Node n = x;
+      succ_[n].ForEach([&](Node w) {
+        if (Node r = Find(w); r != n) {
+          out->emplace_back(r);
+        }
+      });
+    };
+    std::vector<std::vector<Node>> cycles;
+    finder->NewSearch();
+    for (auto [u, w] : lcd_candidates_) {
+      u = Find(u);
+      w = Find(w);
+      if (u == w ||
+          !lcd_checked_.insert((uint64_t{u} << 32) | uint64_t{w}).second ||
+          pts_[u] != pts_[w]) {
+        continue;
+      }
+      finder->Visit(
+          w, successors, [&](const uint64_t* first, const uint64_t* last) {
+            if (last - first > 1) {
+              cycles.emplace_back(first, last);
+            }
+          });
+    }
+    lcd_candidates_.clear();
+
+    for (const auto& cycle : cycles) {
+      for (Node n : cycle) {
+        merged |= Unify(cycle.front(), n);
+      }
+    }
+    if (merged) {
+      CompressPaths();
+    }
+  }
+
+  void Initialize() {
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) {
+          rep_[n] = n;
+          stamp_.constructAt(n, 0);
+          for (Edge e : in_edges_.in_edges(n)) {
+            Node src = in_edges_.in_edge_src(e);
+            switch (kinds_[in_edges_.out_edge_id(e)]) {
+            case Kind::kAddressOf:
+              pts_[n].set(src);
+              break;
+            case Kind::kStore:
+              stores_[n].emplace_back(src);
+              break;
+            default:
+              break;
+            }
+          }
+          for (Edge e : topology_.edges(n)) {
+            Node dst = topology_.edge_dest(e);
+            Kind kind = kinds_[e];
+            if (IsCopy(kind) && dst != n) {
+              succ_[n].set(dst);
+            } else if (kind == Kind::kLoad) {
+              loads_[n].emplace_back(dst);
+            }
+          }
+          pending_[n] = pts_[n];
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+public:
+  AndersenSolver(
+      const katana::GraphTopology& topology,
+      const katana::InEdgeIndex& in_edges, const std::vector<Kind>& kinds,
+      bool detect_cycles)
+      : topology_(topology),
+        in_edges_(in_edges),
+        kinds_(kinds),
+        detect_cycles_(detect_cycles),
+        num_nodes_(topology.num_nodes()),
+        rep_(num_nodes_),
+        compressed_(num_nodes_),
+        locks_(num_nodes_),
+        pts_(num_nodes_),
+        pending_(num_nodes_),
+        succ_(num_nodes_),
+        loads_(num_nodes_),
+        stores_(num_nodes_),
+        hcd_(num_nodes_) {
+    stamp_.allocateBlocked(num_nodes_);
+  }
+
+  katana::Result<void> Run() {
+    Initialize();
+    if (detect_cycles_) {
+      OfflineCycleDetection();
+    }
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](Node n) {
+          if (rep_[n] == n && !pending_[n].empty()) {
+            Activate(n);
+          }
+        },
+        katana::no_stats());
+
+    SccFinder finder(detect_cycles_ ? num_nodes_ : 0);
+    std::vector<Node> active;
+    while (true) {
+      // Nodes activated before a merge may no longer be representatives
+      active.clear();
+      for (Node n : next_) {
+        active.emplace_back(Find(n));
+      }
+      next_.clear();
+      std::sort(active.begin(), active.end());
+      active.erase(std::unique(active.begin(), active.end()), active.end());
+      if (active.empty()) {
+        break;
+      }
+      if (katana::IsCancelled()) {
+        return katana::ErrorCode::Cancelled;
+      }
+
+      ++round_;
+      katana::do_all(
+          katana::iterate(active),
+          [&](Node n) { Process(n, scratch_.getLocal()); }, katana::steal(),
+          katana::loopname("PointsTo"));
+      if (detect_cycles_) {
+        CollapseCycles(&finder);
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+  const katana::SparseBitmap& PointsToSet(Node n) const {
+    return pts_[Find(n)];
+  }
+};
+
+katana::Result<void>
+AddPointsToProperty(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    const AndersenSolver& algo) {
+  uint64_t num_nodes = pg->topology().num_nodes();
+  std::vector<int64_t> offsets(num_nodes + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) { offsets[n + 1] = algo.PointsToSet(n).size(); },
+      katana::no_stats());
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  std::vector<uint32_t> values(offsets.back());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        int64_t pos = offsets[n];
+        algo.PointsToSet(n).ForEach([&](uint32_t v) { values[pos++] = v; });
+      },
+      katana::steal(), katana::no_stats());
+
+  auto list_result = arrow::LargeListArray::FromArrays(
+      *katana::BuildArray(offsets), *katana::BuildArray(values));
+  if (!list_result.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "building points-to lists: {}",
+        list_result.status());
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(
+          output_property_name, arrow::large_list(arrow::uint32()))}),
+      {std::make_shared<arrow::ChunkedArray>(
+          arrow::ArrayVector{list_result.ValueOrDie()})});
+  return pg->AddNodeProperties(table);
+}
+
+/// The points-to sets of an output property
+katana::Result<std::shared_ptr<arrow::LargeListArray>>
+ReadPointsTo(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto column = pg->GetNodeProperty(output_property_name);
+  if (!column) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no node property {}",
+        output_property_name);
+  }
+  auto lists =
+      std::dynamic_pointer_cast<arrow::LargeListArray>(column->chunk(0));
+  if (!lists || lists->value_type()->id() != arrow::Type::UINT32) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "node property {} is not a large_list<uint32>", output_property_name);
+  }
+  return lists;
+}
+
+/// The least solution of the constraints, by applying every constraint
+/// until none changes anything
+std::vector<katana::SparseBitmap>
+NaivePointsTo(
+    const katana::GraphTopology& topology, const std::vector<Kind>& kinds) {
+  std::vector<katana::SparseBitmap> pts(topology.num_nodes());
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    for (Edge e : topology.edges(n)) {
+      if (kinds[e] == Kind::kAddressOf) {
+        pts[topology.edge_dest(e)].set(n);
+      }
+    }
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (Node n = 0; n < topology.num_nodes(); ++n) {
+      for (Edge e : topology.edges(n)) {
+        Node dst = topology.edge_dest(e);
+        Kind kind = kinds[e];
+        if (IsCopy(kind) && dst != n) {
+          changed |= pts[dst].UnionWith(pts[n]);
+        } else if (kind == Kind::kLoad) {
+          for (Node v : pts[n].ToVector()) {
+            if (v != dst) {
+              changed |= pts[dst].UnionWith(pts[v]);
+            }
+          }
+        } else if (kind == Kind::kStore) {
+          for (Node v : pts[dst].ToVector()) {
+            if (v != n) {
+              changed |= pts[v].UnionWith(pts[n]);
+            }
+          }
+        }
+      }
+    }
+  }
+  return pts;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::PointsTo(
+    katana::PropertyGraph* pg, const std::string& constraint_kind_property_name,
+    const std::string& output_property_name, PointsToPlan plan) {
+  if (auto column = pg->GetNodeProperty(output_property_name); column) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AlreadyExists, "node property {} already exists",
+        output_property_name);
+  }
+  auto kinds_result = ConstraintKinds(pg, constraint_kind_property_name);
+  if (!kinds_result) {
+    return kinds_result.error();
+  }
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+
+  switch (plan.algorithm()) {
+  case PointsToPlan::kDifferencePropagation: {
+    AndersenSolver algo(
+        pg->topology(), *in_edges_result.value(), kinds_result.value(),
+        plan.detect_cycles());
+    if (auto r = algo.Run(); !r) {
+      return r.error();
+    }
+    return AddPointsToProperty(pg, output_property_name, algo);
+  }
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        plan.algorithm());
+  }
+}
+
+katana::Result<void>
+katana::analytics::PointsToAssertValid(
+    katana::PropertyGraph* pg, const std::string& constraint_kind_property_name,
+    const std::string& output_property_name) {
+  auto kinds_result = ConstraintKinds(pg, constraint_kind_property_name);
+  if (!kinds_result) {
+    return kinds_result.error();
+  }
+  auto lists_result = ReadPointsTo(pg, output_property_name);
+  if (!lists_result) {
+    return lists_result.error();
+  }
+  auto lists = lists_result.value();
+  auto values = std::static_pointer_cast<arrow::UInt32Array>(lists->values());
+
+  std::vector<katana::SparseBitmap> expected =
+      NaivePointsTo(pg->topology(), kinds_result.value());
+  for (Node n = 0; n < expected.size(); ++n) {
+    std::vector<uint32_t> pointees = expected[n].ToVector();
+    int64_t offset = lists->value_offset(n);
+    bool equal = static_cast<size_t>(lists->value_length(n)) == pointees.size();
+    for (size_t i = 0; equal && i < pointees.size(); ++i) {
+      equal = values->Value(offset + i) == pointees[i];
+    }
+    if (!equal) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "node {} points to {} nodes but should point to {}", n,
+          lists->value_length(n), pointees.size());
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<PointsToStatistics>
+katana::analytics::PointsToStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto lists_result = ReadPointsTo(pg, output_property_name);
+  if (!lists_result) {
+    return lists_result.error();
+  }
+  auto lists = lists_result.value();
+
+  katana::GAccumulator<uint64_t> n_points_to_facts;
+  katana::GAccumulator<uint64_t> n_pointers;
+  katana::GReduceMax<uint64_t> max_points_to_size;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->topology().num_nodes()),
+      [&](Node n) {
+        uint64_t size = lists->value_length(n);
+        n_points_to_facts += size;
+        if (size > 0) {
+          n_pointers += 1;
+        }
+        max_points_to_size.update(size);
+      },
+      katana::no_stats());
+  return PointsToStatistics{
+      n_points_to_facts.reduce(), n_pointers.reduce(),
+      max_points_to_size.reduce()};
+}
+
+void
+katana::analytics::PointsToStatistics::Print(std::ostream& os) const {
+  os << "Points-to facts = " << n_points_to_facts << std::endl;
+  os << "Pointers = " << n_pointers << std::endl;
+  os << "Largest points-to set = " << max_points_to_size << std::endl;
+}
@@ -19,6 +19,17 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/Cancellation.h"
+#include "katana/LargeArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -27,147 +38,347 @@ const int RandomWalksPlan::kChunkSize = 1;
 
 namespace {
 
-struct Node2VecAlgo {
-  using NodeData = std::tuple<>;
-  using EdgeData = std::tuple<>;
-
-  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
-  typedef typename Graph::Node GNode;
-
-  const RandomWalksPlan& plan_;
-  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
-
-  GNode FindSampleNeighbor(
-      const Graph& graph, const GNode& n,
-      const katana::LargeArray<uint64_t>& degree, double prob) {
-    if (degree[n] == 0) {
-      return graph.num_nodes();
-    }
-    double total_wt = degree[n];
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// Every walk draws from a stream of its own, keyed by the walk, so that the
+/// walks do not depend on the schedule
+using WalkGenerator = katana::CounterRandom;
+
+/// Split the random word r into a uniform index below n and 32 uniform bits
+/// that are independent of the index: the integer and fractional parts of
+/// r * n / 2^64
+std::pair<uint64_t, uint32_t>
+SplitRandom(uint64_t r, uint64_t n) {
+  unsigned __int128 product = static_cast<unsigned __int128>(r) * n;
+  return {
+      static_cast<uint64_t>(product >> 64U),
+      static_cast<uint32_t>(static_cast<uint64_t>(product) >> 32U)};
+}
 
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto edge = graph.edge_begin(n) + edge_index;
-    return *graph.GetEdgeDest(edge);
+/// The first-order step of a walk: a random out-edge of a node, uniform or,
+/// by Walker's alias method, weighted. The alias table of node n has a
+/// column for each of its edges e; a draw picks a column uniformly and keeps
+/// e if 32 random bits are below threshold_[e], and otherwise takes the edge
+/// alias_[e] positions after the first edge of n.
+class StepSampler {
+public:
+  explicit StepSampler(const katana::GraphTopology& topology)
+      : topology_(topology), can_step_(topology.num_nodes()) {
+    katana::do_all(
+        katana::iterate(topology_),
+        [&](Node n) { can_step_[n] = !topology_.edges(n).empty(); },
+        katana::no_stats());
   }
 
-  void GraphRandomWalk(
-      const Graph& graph, katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::LargeArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
+  /// Weight the steps by weights, which are indexed by edge
+  void SetWeights(const std::vector<double>& weights);
 
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
-
-    double upper_bound = 1.0;
+  bool CanStep(Node n) const { return can_step_[n]; }
 
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
+  /// A random out-edge of n, which must be able to step, and 32 random bits
+  /// independent of it
+  std::pair<Edge, uint32_t> Sample(Node n, WalkGenerator* gen) const {
+    auto [begin, end] = topology_.edge_range(n);
+    auto [column, coin] = SplitRandom((*gen)(), end - begin);
+    Edge e = begin + column;
+    if (!weighted_) {
+      return {e, coin};
+    }
+    if (coin >= threshold_[e]) {
+      e = begin + alias_[e];
+    }
+    return {e, static_cast<uint32_t>((*gen)() >> 32U)};
+  }
 
-    double lower_bound = 1.0;
+private:
+  const katana::GraphTopology& topology_;
+  std::vector<uint8_t> can_step_;
+  bool weighted_{false};
+  katana::LargeArray<uint32_t> threshold_;
+  katana::LargeArray<uint32_t> alias_;
+};
 
-    lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
-    lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
+void
+StepSampler::SetWeights(const std::vector<double>& weights) {
+  threshold_.allocateBlocked(topology_.num_edges());
+  alias_.allocateBlocked(topology_.num_edges());
+  weighted_ = true;
+
+  struct Scratch {
+    std::vector<double> scaled;
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+  };
+  katana::PerThreadStorage<Scratch> scratch;
+  katana::do_all(
+      katana::iterate(topology_),
+      [&](Node n) {
+        Edge begin = topology_.edge_range(n).first;
+        uint64_t degree = topology_.edges(n).size();
+        double total = 0;
+        uint32_t heaviest = 0;
+        for (uint64_t i = 0; i < degree; ++i) {
+          total += weights[begin + i];
+          if (weights[begin + i] > weights[begin + heaviest]) {
+            heaviest = i;
+          }
+        }
+        if (!(total > 0)) {
+          can_step_[n] = false;
+          return;
+        }
+
+        // Vose's construction: scale the weights to average 1, then fill
+        // each column below 1 from one above 1 until every column is 1
+        Scratch& s = *scratch.getLocal();
+        s.scaled.resize(degree);
+        s.small.clear();
+        s.large.clear();
+        for (uint64_t i = 0; i < degree; ++i) {
+          s.scaled[i] = weights[begin + i] * degree / total;
+          (s.scaled[i] < 1 ? s.small : s.large).emplace_back(i);
+          alias_[begin + i] = i;
+        }
+        auto set_threshold = [&](uint32_t i, double p) {
+          constexpr double kMax = std::numeric_limits<uint32_t>::max();
+          threshold_[begin + i] =
+              static_cast<uint32_t>(std::min(p * 0x1p32, kMax));
+        };
+        while (!s.small.empty() && !s.large.empty()) {
+          uint32_t i = s.small.back();
+          s.small.pop_back();
+          uint32_t j = s.large.back();
+          set_threshold(i, s.scaled[i]);
+          alias_[begin + i] = j;
+          s.scaled[j] -= 1 - s.scaled[i];
+          if (s.scaled[j] < 1) {
+            s.large.pop_back();
+            s.small.emplace_back(j);
+          }
+        }
+        // What remains is 1 up to rounding, except that an edge of weight 0
+        // must never be taken
+        for (uint32_t i : s.large) {
+          set_threshold(i, 1);
+        }
+        for (uint32_t i : s.small) {
+          if (weights[begin + i] > 0) {
+            set_threshold(i, 1);
+          } else {
+            set_threshold(i, 0);
+            alias_[begin + i] = heaviest;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
 
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+/// Whether m is a neighbor of n, by binary search over the sorted edges of
+/// n or, if n has enough edges that a bitmap over every node is not much
+/// larger than its edge list, by looking up its bit
+class NeighborSets {
+public:
+  /// A node with a bitmap has at least this many edges, below which binary
+  /// search stays within a few cache lines
+  static constexpr uint64_t kMinBitmapDegree = 64;
+  /// A bitmap is at most this many words per edge of its node
+  static constexpr uint64_t kMaxBitmapWordsPerEdge = 2;
+
+  explicit NeighborSets(const katana::GraphTopology& topology)
+      : topology_(topology),
+        words_((topology.num_nodes() + 63) / 64),
+        bitmap_of_(topology.num_nodes(), kNoBitmap) {
+    uint32_t num_bitmaps = 0;
+    for (Node n = 0; n < topology_.num_nodes(); ++n) {
+      uint64_t degree = topology_.edges(n).size();
+      if (degree >= kMinBitmapDegree &&
+          words_ <= degree * kMaxBitmapWordsPerEdge) {
+        bitmap_of_[n] = num_bitmaps++;
+      }
+    }
+    if (num_bitmaps == 0) {
+      return;
+    }
 
+    bits_.allocateBlocked(num_bitmaps * words_);
     katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
-
-          //check if n has no neighbor
-          if (degree[n] == 0) {
+        katana::iterate(topology_),
+        [&](Node n) {
+          if (bitmap_of_[n] == kNoBitmap) {
             return;
           }
+          uint64_t* bits = &bits_[bitmap_of_[n] * words_];
+          std::fill(bits, bits + words_, 0);
+          for (Edge e : topology_.edges(n)) {
+            Node m = topology_.edge_dests()[e];
+            bits[m / 64] |= uint64_t{1} << (m % 64);
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
-
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
+  bool Contains(Node n, Node m) const {
+    if (uint32_t b = bitmap_of_[n]; b != kNoBitmap) {
+      return (bits_[b * words_ + m / 64] >> (m % 64)) & 1U;
+    }
+    auto [begin, end] = topology_.edge_range(n);
+    const Node* dests = topology_.edge_dests();
+    return std::binary_search(dests + begin, dests + end, m);
+  }
 
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+private:
+  static constexpr uint32_t kNoBitmap = std::numeric_limits<uint32_t>::max();
 
-          //Assumption: All edges have weight 1
-          Graph::Node nbr = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr < graph.num_nodes());
+  const katana::GraphTopology& topology_;
+  uint64_t words_;
+  std::vector<uint32_t> bitmap_of_;
+  katana::LargeArray<uint64_t> bits_;
+};
 
-          walk.push_back(std::move(nbr));
+/// Node2vec walks. A step from curr, having come from prev, to a neighbor
+/// next has weight alpha times the weight of the edge, where alpha is
+/// 1 / backward_probability if next is prev, 1 if next is also a neighbor of
+/// prev and 1 / forward_probability otherwise. Steps are drawn from the
+/// first-order sampler and accepted with probability alpha / max(alpha),
+/// with thresholds on 32 random bits computed once per run.
+class Node2VecWalker {
+public:
+  Node2VecWalker(
+      const katana::GraphTopology& topology, const StepSampler& sampler,
+      const RandomWalksPlan& plan)
+      : topology_(topology),
+        sampler_(sampler),
+        neighbors_(topology),
+        plan_(plan) {
+    double backward = 1.0 / plan_.backward_probability();
+    double forward = 1.0 / plan_.forward_probability();
+    double upper_bound = std::max({1.0, backward, forward});
+    auto threshold = [&](double alpha) {
+      return static_cast<uint64_t>(alpha / upper_bound * 0x1p32);
+    };
+    backward_threshold_ = threshold(backward);
+    common_threshold_ = threshold(1.0);
+    forward_threshold_ = threshold(forward);
+    lower_threshold_ = std::min(
+        {backward_threshold_, common_threshold_, forward_threshold_});
+  }
 
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[current_walk - 1];
-            uint32_t prev = walk[current_walk - 2];
+  /// Write walk number walk into out, returning its length
+  uint32_t Walk(uint64_t walk, uint64_t seed, uint32_t* out) const {
+    Node start = walk % topology_.num_nodes();
+    if (!sampler_.CanStep(start)) {
+      return 0;
+    }
+    WalkGenerator gen(seed, walk);
+
+    out[0] = start;
+    out[1] = topology_.edge_dests()[sampler_.Sample(start, &gen).first];
+    uint32_t length = 2;
+    for (; length <= plan_.walk_length(); ++length) {
+      Node curr = out[length - 1];
+      Node prev = out[length - 2];
+      if (!sampler_.CanStep(curr)) {
+        break;
+      }
+      while (true) {
+        auto [e, y] = sampler_.Sample(curr, &gen);
+        Node next = topology_.edge_dests()[e];
+        if (y < lower_threshold_ || y < Threshold(prev, next)) {
+          out[length] = next;
+          break;
+        }
+      }
+    }
+    return length;
+  }
 
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              break;
-            }
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
+private:
+  uint64_t Threshold(Node prev, Node next) const {
+    if (next == prev) {
+      return backward_threshold_;
+    }
+    if (neighbors_.Contains(prev, next)) {
+      return common_threshold_;
+    }
+    return forward_threshold_;
+  }
 
-              Graph::Node nbr = FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr < graph.num_nodes());
+  const katana::GraphTopology& topology_;
+  const StepSampler& sampler_;
+  NeighborSets neighbors_;
+  const RandomWalksPlan& plan_;
+  uint64_t backward_threshold_;
+  uint64_t common_threshold_;
+  uint64_t forward_threshold_;
+  uint64_t lower_threshold_;
+};
 
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
+katana::Result<RandomWalksBuffer>
+Node2VecWalks(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const RandomWalksPlan& plan) {
+  std::vector<double> weights;
+  if (!edge_weight_property_name.empty()) {
+    auto weights_result = NonNegativeEdgeWeights(pg, edge_weight_property_name);
+    if (!weights_result) {
+      return weights_result.error();
+    }
+    weights = std::move(weights_result.value());
+  }
 
-              if (y <= lower_bound) {
-                //accept this sample
-                walk.push_back(std::move(nbr));
-                break;
-              } else {
-                //compute transition probability
-                double alpha;
-
-                //check if nbr is same as the previous node on this walk
-                if (nbr == prev) {
-                  alpha = prob_backward;
-                }  //check if nbr is also a neighbor of the previous node on this walk
-                else if (
-                    katana::FindEdgeSortedByDest(graph, prev, nbr) !=
-                    graph.edge_end(prev)) {
-                  alpha = 1.0;
-                } else {
-                  alpha = prob_forward;
-                }
-
-                if (y <= alpha) {
-                  //accept y
-                  walk.push_back(std::move(nbr));
-                  break;
-                }
-              }
-            }
-          }
+  // Sorting moves the edges but not their properties, so the weights are
+  // moved along with them
+  if (!pg->edges_sorted_by_dest()) {
+    auto permutation = katana::SortAllEdgesByDest(pg);
+    if (!permutation) {
+      return permutation.error();
+    }
+    if (!weights.empty()) {
+      std::vector<double> sorted_weights(weights.size());
+      katana::do_all(
+          katana::iterate(uint64_t{0}, uint64_t{weights.size()}),
+          [&](Edge e) {
+            sorted_weights[e] = weights[permutation.value()->Value(e)];
+          },
+          katana::no_stats());
+      weights = std::move(sorted_weights);
+    }
+  }
+  const katana::GraphTopology& topology = pg->topology();
 
-          walks->push(std::move(walk));
-        },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Node2vec walks"), katana::no_stats());
+  katana::StatTimer execTime("RandomWalks");
+  execTime.start();
 
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
-    }
+  StepSampler sampler(topology);
+  if (!edge_weight_property_name.empty()) {
+    sampler.SetWeights(weights);
   }
+  Node2VecWalker walker(topology, sampler, plan);
+
+  RandomWalksBuffer buffer;
+  uint64_t total_walks = topology.num_nodes() * plan.number_of_walks();
+  buffer.stride = std::max(plan.walk_length(), uint32_t{1}) + 1;
+  buffer.nodes.allocateBlocked(total_walks * buffer.stride);
+  buffer.lengths.allocateBlocked(total_walks);
+
+  uint64_t seed = katana::GetGenerator()();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, total_walks),
+      [&](uint64_t walk) {
+        buffer.lengths[walk] =
+            walker.Walk(walk, seed, &buffer.nodes[walk * buffer.stride]);
+      },
+      katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
+      katana::loopname("Node2vec walks"), katana::no_stats());
 
-  void operator()(
-      const Graph& graph, katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::LargeArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+  execTime.stop();
+
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
   }
-};
+  return buffer;
+}
 
 struct Edge2VecAlgo {
   using EdgeType = katana::UInt32Property;
@@ -213,14 +424,7 @@ struct Edge2VecAlgo {
       const Graph& graph, katana::InsertBag<std::vector<uint32_t>>* walks,
       katana::InsertBag<std::vector<uint32_t>>* types_walks,
       const katana::LargeArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
+    uint64_t seed = katana::GetGenerator()();
 
     double prob_forward = 1.0 / plan_.forward_probability();
     double prob_backward = 1.0 / plan_.backward_probability();
@@ -242,8 +446,7 @@ struct Edge2VecAlgo {
             return;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+          WalkGenerator gen(seed, idx);
 
           std::vector<uint32_t> walk;
           std::vector<uint32_t> types_vec;
@@ -251,7 +454,7 @@ struct Edge2VecAlgo {
           walk.push_back(n);
 
           //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+          double prob = WalkGenerator::ToUnit(gen());
 
           //Assumption: All edges have weight 1
           auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
@@ -274,7 +477,7 @@ struct Edge2VecAlgo {
             //acceptance-rejection sampling
             while (true) {
               //sample x
-              double prob = (*dist)(*generator.getLocal());
+              double prob = WalkGenerator::ToUnit(gen());
 
               auto nbr_type_pair =
                   FindSampleNeighbor(graph, curr, degree, prob);
@@ -284,7 +487,7 @@ struct Edge2VecAlgo {
               EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
 
               //sample y
-              double y = (*dist)(*generator.getLocal());
+              double y = WalkGenerator::ToUnit(gen());
               y = y * upper_bound;
 
               //compute transition probability
@@ -479,7 +682,12 @@ InitializeDegrees(const Graph& graph, katana::LargeArray<uint64_t>* degree) {
 template <typename Algorithm>
 static katana::Result<std::vector<std::vector<uint32_t>>>
 RandomWalksWithWrap(katana::PropertyGraph* pg, RandomWalksPlan plan) {
-  if (auto res = katana::SortAllEdgesByDest(pg); !res) {
+  if (auto res = katana::EnsureAllEdgesSortedByDest(pg); !res) {
+    return res.error();
+  }
+  // Each step checks for an edge from the previous node with
+  // FindEdgeSortedByDest
+  if (auto res = pg->GetEdgeExistenceIndex(); !res) {
     return res.error();
   }
 
@@ -513,6 +721,10 @@ RandomWalksWithWrap(katana::PropertyGraph* pg, RandomWalksPlan plan) {
   degree.destroy();
   degree.deallocate();
 
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+
   std::vector<std::vector<uint32_t>> walks_in_vector;
   walks_in_vector.reserve(plan.number_of_walks());
   std::move(walks.begin(), walks.end(), std::back_inserter(walks_in_vector));
@@ -522,8 +734,21 @@ RandomWalksWithWrap(katana::PropertyGraph* pg, RandomWalksPlan plan) {
 katana::Result<std::vector<std::vector<uint32_t>>>
 katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
   switch (plan.algorithm()) {
-  case RandomWalksPlan::kNode2Vec:
-    return RandomWalksWithWrap<Node2VecAlgo>(pg, plan);
+  case RandomWalksPlan::kNode2Vec: {
+    auto buffer_result = Node2VecWalks(pg, "", plan);
+    if (!buffer_result) {
+      return buffer_result.error();
+    }
+    const RandomWalksBuffer& buffer = buffer_result.value();
+    std::vector<std::vector<uint32_t>> walks;
+    for (size_t i = 0; i < buffer.num_walks(); ++i) {
+      if (buffer.lengths[i] > 0) {
+        walks.emplace_back(
+            buffer.walk(i), buffer.walk(i) + buffer.lengths[i]);
+      }
+    }
+    return walks;
+  }
   case RandomWalksPlan::kEdge2Vec:
     return RandomWalksWithWrap<Edge2VecAlgo>(pg, plan);
   default:
@@ -531,6 +756,27 @@ katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
   }
 }
 
+katana::Result<RandomWalksBuffer>
+katana::analytics::RandomWalksToBuffer(
+    PropertyGraph* pg, RandomWalksPlan plan) {
+  return RandomWalksToBuffer(pg, "", plan);
+}
+
+katana::Result<RandomWalksBuffer>
+katana::analytics::RandomWalksToBuffer(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    RandomWalksPlan plan) {
+  switch (plan.algorithm()) {
+  case RandomWalksPlan::kNode2Vec:
+    return Node2VecWalks(pg, edge_weight_property_name, plan);
+  case RandomWalksPlan::kEdge2Vec:
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "Edge2Vec walks cannot go to a buffer");
+  default:
+    return ErrorCode::InvalidArgument;
+  }
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::RandomWalksAssertValid([
@@ -0,0 +1,577 @@
+#include "katana/analytics/reachability_index/reachability_index.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Relabel.h"
+#include "katana/analytics/MultiSourceBfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+/// The rank of a hub node in NodeOrder::kDegree
+using Hub = uint32_t;
+
+constexpr uint32_t kInfinity = kReachabilityIndexUnreachable;
+
+/// The first batch of pruned searches has one hub per thread and each next
+/// batch twice as many, up to this many
+constexpr uint64_t kMaxBatchSize = 4096;
+
+struct Entry {
+  Hub hub;
+  uint32_t distance;
+};
+
+using Labels = std::vector<std::vector<Entry>>;
+
+/// The searches along the edges of graph add entries to labels and are
+/// pruned by the labels of their hubs on the other side, hub_labels
+struct Direction {
+  const katana::GraphTopology* graph;
+  Labels* labels;
+  const Labels* hub_labels;
+};
+
+std::string
+FromPropertyName(const std::string& prefix) {
+  return prefix + "-from";
+}
+
+std::string
+ToPropertyName(const std::string& prefix) {
+  return prefix + "-to";
+}
+
+/// Label each node reached along graph from the k highest ranked hubs with
+/// all of them, in one bit-parallel search; entries are in no order yet
+void
+SearchBitParallel(
+    const katana::GraphTopology& graph, const Node* hubs, uint32_t k,
+    Labels* labels) {
+  MultiSourceBfs bfs(graph);
+  bfs.Run(hubs, k);
+  for (size_t d = 0; d < bfs.num_levels(); ++d) {
+    katana::do_all(
+        katana::iterate(bfs.level(d)),
+        [&](const MultiSourceBfs::Visit& v) {
+          for (MultiSourceBfs::Mask m = v.sources; m != 0; m &= m - 1) {
+            (*labels)[v.node].emplace_back(
+                Entry{Hub(__builtin_ctzll(m)), uint32_t(d)});
+          }
+        },
+        katana::no_stats(), katana::loopname("ReachabilityIndexBitParallel"));
+  }
+}
+
+/// The distance from hub i to hub j at [i * k + j], for the k highest
+/// ranked hubs, read from their unpruned in-labels
+std::vector<uint32_t>
+HubDistances(const Labels& from, const Node* hubs, uint32_t k) {
+  std::vector<uint32_t> between(uint64_t{k} * k, kInfinity);
+  for (Hub j = 0; j < k; ++j) {
+    for (const Entry& e : from[hubs[j]]) {
+      between[uint64_t{e.hub} * k + j] = e.distance;
+    }
+  }
+  return between;
+}
+
+/// Drop the entries of the bit-parallel search that a higher ranked hub
+/// among the k covers, leaving the labels pruned landmark labeling would
+/// build, sorted by hub. Hub i is redundant in the in-label of n if the
+/// path from i through some hub j < i to n is as short, and in the
+/// out-label (to_hubs) if the path from n through j to i is.
+void
+PruneBitParallel(
+    const std::vector<uint32_t>& between, uint32_t k, bool to_hubs,
+    Labels* labels) {
+  katana::do_all(
+      katana::iterate(size_t{0}, labels->size()),
+      [&](size_t n) {
+        std::vector<Entry>& label = (*labels)[n];
+        if (label.empty()) {
+          return;
+        }
+        std::array<uint32_t, ReachabilityIndexPlan::kMaxBitParallelHubs> dist;
+        std::fill(dist.begin(), dist.begin() + k, kInfinity);
+        for (const Entry& e : label) {
+          dist[e.hub] = e.distance;
+        }
+        label.clear();
+        for (Hub i = 0; i < k; ++i) {
+          if (dist[i] == kInfinity) {
+            continue;
+          }
+          bool covered = false;
+          for (Hub j = 0; j < i && !covered; ++j) {
+            uint32_t via = to_hubs ? between[uint64_t{j} * k + i]
+                                   : between[uint64_t{i} * k + j];
+            covered = dist[j] != kInfinity && via != kInfinity &&
+                      uint64_t{dist[j]} + via <= dist[i];
+          }
+          if (!covered) {
+            label.emplace_back(Entry{i, dist[i]});
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("ReachabilityIndexPruneBitParallel"));
+}
+
+/// An entry found by a search, added to its label after the batch
+struct Pending {
+  Node node;
+  Entry entry;
+};
+
+/// The state of the pruned searches of one thread, reset after each search
+/// to touch only the nodes it reached
+struct Scratch {
+  /// The distance of each node from the hub of the search
+  std::vector<uint32_t> distance;
+  /// The distance between the hub of the search and each hub of its label
+  /// on the other side
+  std::vector<uint32_t> hub_distance;
+  /// The nodes reached, in breadth-first order
+  std::vector<Node> visited;
+  /// The entries found in each direction
+  std::array<std::vector<Pending>, 2> pending;
+
+  explicit Scratch(uint64_t num_nodes)
+      : distance(num_nodes, kInfinity), hub_distance(num_nodes, kInfinity) {}
+};
+
+/// Search from hub h, node source, and add (h, d) to the pending entries of
+/// each node at distance d that the labels do not already cover. The
+/// search is not continued past covered nodes nor into nodes ranked higher
+/// than h, since the shortest paths through them are covered by higher
+/// ranked hubs.
+void
+SearchPruned(
+    const Direction& dir, const Node* rank, Hub h, Node source, Scratch* s,
+    std::vector<Pending>* pending) {
+  const std::vector<Entry>& hub_label = (*dir.hub_labels)[source];
+  for (const Entry& e : hub_label) {
+    s->hub_distance[e.hub] = e.distance;
+  }
+  s->distance[source] = 0;
+  s->visited.emplace_back(source);
+  for (size_t next = 0; next < s->visited.size(); ++next) {
+    Node n = s->visited[next];
+    uint32_t d = s->distance[n];
+    bool covered = false;
+    for (const Entry& e : (*dir.labels)[n]) {
+      uint32_t via = s->hub_distance[e.hub];
+      if (via != kInfinity && uint64_t{via} + e.distance <= d) {
+        covered = true;
+        break;
+      }
+    }
+    if (covered) {
+      continue;
+    }
+    pending->emplace_back(Pending{n, Entry{h, d}});
+    for (auto e : dir.graph->edges(n)) {
+      Node dst = dir.graph->edge_dest(e);
+      if (s->distance[dst] == kInfinity && rank[dst] > h) {
+        s->distance[dst] = d + 1;
+        s->visited.emplace_back(dst);
+      }
+    }
+  }
+
+  for (Node n : s->visited) {
+    s->distance[n] = kInfinity;
+  }
+  s->visited.clear();
+  for (const Entry& e : hub_label) {
+    s->hub_distance[e.hub] = kInfinity;
+  }
+}
+
+/// Append the entries that the threads found in direction side to their
+/// labels. They are of hubs ranked below every hub already in the labels,
+/// so sorting them by node and hub keeps each label sorted.
+void
+AppendPending(
+    katana::PerThreadStorage<std::unique_ptr<Scratch>>* scratch, size_t side,
+    Labels* labels) {
+  std::vector<Pending> all;
+  for (std::unique_ptr<Scratch>& s : *scratch) {
+    if (s) {
+      all.insert(all.end(), s->pending[side].begin(), s->pending[side].end());
+      s->pending[side].clear();
+    }
+  }
+  katana::ParallelSTL::radix_sort(all.begin(), all.end(), [](const Pending& p) {
+    return (uint64_t{p.node} << 32U) | p.entry.hub;
+  });
+  katana::do_all(
+      katana::iterate(size_t{0}, all.size()),
+      [&](size_t i) {
+        Node n = all[i].node;
+        if (i > 0 && all[i - 1].node == n) {
+          return;
+        }
+        for (size_t j = i; j < all.size() && all[j].node == n; ++j) {
+          (*labels)[n].emplace_back(all[j].entry);
+        }
+      },
+      katana::no_stats(), katana::loopname("ReachabilityIndexAppend"));
+}
+
+/// Search from the hubs ranked first and below in batches; the searches of
+/// a batch run in parallel and are pruned by the labels of earlier batches
+void
+SearchPrunedBatches(
+    const std::vector<Direction>& dirs, const Node* hubs, const Node* rank,
+    uint64_t first, uint64_t num_nodes) {
+  katana::PerThreadStorage<std::unique_ptr<Scratch>> scratch;
+  uint64_t batch_size = katana::getActiveThreads();
+  for (uint64_t begin = first; begin < num_nodes;) {
+    uint64_t end = std::min(begin + batch_size, num_nodes);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t h) {
+          std::unique_ptr<Scratch>& s = *scratch.getLocal();
+          if (!s) {
+            s = std::make_unique<Scratch>(num_nodes);
+          }
+          for (size_t side = 0; side < dirs.size(); ++side) {
+            SearchPruned(
+                dirs[side], rank, Hub(h), hubs[h], s.get(),
+                &s->pending[side]);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("ReachabilityIndexPruned"));
+    for (size_t side = 0; side < dirs.size(); ++side) {
+      AppendPending(&scratch, side, dirs[side].labels);
+    }
+    begin = end;
+    batch_size = std::min(2 * batch_size, kMaxBatchSize);
+  }
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t size) {
+  auto res = arrow::AllocateBuffer(size);
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating labels: {}", res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+std::shared_ptr<arrow::DataType>
+LabelType() {
+  return arrow::large_list(arrow::struct_(
+      {arrow::field("hub", arrow::uint32()),
+       arrow::field("distance", arrow::uint32())}));
+}
+
+/// The labels as a list of (hub, distance) structs per node
+katana::Result<std::shared_ptr<arrow::Array>>
+BuildLabelArray(const Labels& labels) {
+  uint64_t num_nodes = labels.size();
+  auto offsets_res = Allocate((num_nodes + 1) * sizeof(int64_t));
+  if (!offsets_res) {
+    return offsets_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> offsets = std::move(offsets_res.value());
+  auto* offsets_data = reinterpret_cast<int64_t*>(offsets->mutable_data());
+  offsets_data[0] = 0;
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    offsets_data[n + 1] = offsets_data[n] + labels[n].size();
+  }
+
+  uint64_t num_entries = offsets_data[num_nodes];
+  auto hubs_res = Allocate(num_entries * sizeof(Hub));
+  if (!hubs_res) {
+    return hubs_res.error();
+  }
+  auto distances_res = Allocate(num_entries * sizeof(uint32_t));
+  if (!distances_res) {
+    return distances_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> hubs = std::move(hubs_res.value());
+  std::shared_ptr<arrow::Buffer> distances = std::move(distances_res.value());
+  auto* hubs_data = reinterpret_cast<Hub*>(hubs->mutable_data());
+  auto* distances_data = reinterpret_cast<uint32_t*>(distances->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        int64_t i = offsets_data[n];
+        for (const Entry& e : labels[n]) {
+          hubs_data[i] = e.hub;
+          distances_data[i] = e.distance;
+          ++i;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  auto type = LabelType();
+  auto entries = std::make_shared<arrow::StructArray>(
+      std::static_pointer_cast<arrow::LargeListType>(type)->value_type(),
+      num_entries,
+      arrow::ArrayVector{
+          std::make_shared<arrow::UInt32Array>(num_entries, hubs),
+          std::make_shared<arrow::UInt32Array>(num_entries, distances)});
+  return std::make_shared<arrow::LargeListArray>(
+      type, num_nodes, offsets, entries);
+}
+
+/// The labels stored in a property by ReachabilityIndex
+struct LabelView {
+  const int64_t* offsets;
+  const Hub* hubs;
+  const uint32_t* distances;
+
+  uint64_t size(Node n) const { return offsets[n + 1] - offsets[n]; }
+};
+
+katana::Result<LabelView>
+GetLabels(const katana::PropertyGraph& pg, const std::string& name) {
+  auto property = pg.GetNodeProperty(name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no node property {}", name);
+  }
+  auto list = property->num_chunks() == 1
+                  ? std::dynamic_pointer_cast<arrow::LargeListArray>(
+                        property->chunk(0))
+                  : nullptr;
+  auto entries =
+      list ? std::dynamic_pointer_cast<arrow::StructArray>(list->values())
+           : nullptr;
+  auto hubs = entries && entries->num_fields() == 2
+                  ? std::dynamic_pointer_cast<arrow::UInt32Array>(
+                        entries->field(0))
+                  : nullptr;
+  auto distances = hubs ? std::dynamic_pointer_cast<arrow::UInt32Array>(
+                              entries->field(1))
+                        : nullptr;
+  if (!distances ||
+      static_cast<uint64_t>(list->length()) != pg.topology().num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "{} is not a reachability index label",
+        name);
+  }
+  return LabelView{
+      list->raw_value_offsets(), hubs->raw_values(), distances->raw_values()};
+}
+
+/// The least distance from s to t through a hub of both the out-label of s
+/// and the in-label of t, or, if kAnyHub, through the first common hub
+template <bool kAnyHub>
+uint32_t
+Intersect(const LabelView& out, Node s, const LabelView& in, Node t) {
+  int64_t i = out.offsets[s];
+  int64_t i_end = out.offsets[s + 1];
+  int64_t j = in.offsets[t];
+  int64_t j_end = in.offsets[t + 1];
+  uint64_t best = kInfinity;
+  while (i < i_end && j < j_end) {
+    if (out.hubs[i] < in.hubs[j]) {
+      ++i;
+    } else if (in.hubs[j] < out.hubs[i]) {
+      ++j;
+    } else {
+      best = std::min(best, uint64_t{out.distances[i]} + in.distances[j]);
+      if (kAnyHub) {
+        break;
+      }
+      ++i;
+      ++j;
+    }
+  }
+  return std::min<uint64_t>(best, kInfinity);
+}
+
+/// Look up the labels of the index and call answer(q, distance) for each
+/// query
+template <bool kAnyHub, typename Answer>
+katana::Result<void>
+RunQueries(
+    katana::PropertyGraph* pg, const std::string& index_property_prefix,
+    const Node* sources, const Node* targets, uint64_t num_queries,
+    const Answer& answer) {
+  auto from_res = GetLabels(*pg, FromPropertyName(index_property_prefix));
+  if (!from_res) {
+    return from_res.error();
+  }
+  LabelView in = from_res.value();
+  LabelView out = in;
+  if (std::string to_name = ToPropertyName(index_property_prefix);
+      pg->HasNodeProperty(to_name)) {
+    auto to_res = GetLabels(*pg, to_name);
+    if (!to_res) {
+      return to_res.error();
+    }
+    out = to_res.value();
+  }
+
+  uint64_t num_nodes = pg->topology().num_nodes();
+  for (uint64_t q = 0; q < num_queries; ++q) {
+    if (sources[q] >= num_nodes || targets[q] >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "query {} is between nodes {} and {}, but there are {} nodes", q,
+          sources[q], targets[q], num_nodes);
+    }
+  }
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_queries),
+      [&](uint64_t q) {
+        answer(q, Intersect<kAnyHub>(out, sources[q], in, targets[q]));
+      },
+      katana::no_stats(), katana::loopname("ReachabilityIndexQuery"));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::ReachabilityIndex(
+    PropertyGraph* pg, const std::string& index_property_prefix,
+    ReachabilityIndexPlan plan) {
+  if (plan.num_bit_parallel_hubs() >
+      ReachabilityIndexPlan::kMaxBitParallelHubs) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "at most {} hubs can be searched from at once",
+        ReachabilityIndexPlan::kMaxBitParallelHubs);
+  }
+  std::string from_name = FromPropertyName(index_property_prefix);
+  std::string to_name = ToPropertyName(index_property_prefix);
+  for (const std::string& name : {from_name, to_name}) {
+    if (pg->HasNodeProperty(name)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AlreadyExists, "node property {} already exists",
+          name);
+    }
+  }
+
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  auto perm_res = katana::ComputeNodeOrder(*pg, katana::NodeOrder::kDegree);
+  if (!perm_res) {
+    return perm_res.error();
+  }
+  const katana::NodePermutation& perm = perm_res.value();
+  const Node* hubs = perm.old_ids()->raw_values();
+  const Node* rank = perm.new_ids()->raw_values();
+
+  Labels from(num_nodes);
+  Labels to(plan.symmetric() ? 0 : num_nodes);
+  std::vector<Direction> dirs{
+      Direction{&topology, &from, plan.symmetric() ? &from : &to}};
+  std::shared_ptr<const katana::InEdgeIndex> in_edges;
+  if (!plan.symmetric()) {
+    auto in_edges_res = pg->GetInEdgeIndex();
+    if (!in_edges_res) {
+      return in_edges_res.error();
+    }
+    in_edges = std::move(in_edges_res.value());
+    dirs.emplace_back(Direction{&in_edges->topology, &to, &from});
+  }
+
+  uint32_t k = std::min<uint64_t>(plan.num_bit_parallel_hubs(), num_nodes);
+  if (k > 0) {
+    for (const Direction& dir : dirs) {
+      SearchBitParallel(*dir.graph, hubs, k, dir.labels);
+    }
+    std::vector<uint32_t> between = HubDistances(from, hubs, k);
+    PruneBitParallel(between, k, false, &from);
+    if (!plan.symmetric()) {
+      PruneBitParallel(between, k, true, &to);
+    }
+  }
+  SearchPrunedBatches(dirs, hubs, rank, k, num_nodes);
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  arrow::ArrayVector columns;
+  for (const Direction& dir : dirs) {
+    auto array_res = BuildLabelArray(*dir.labels);
+    if (!array_res) {
+      return array_res.error();
+    }
+    fields.emplace_back(arrow::field(
+        dir.labels == &from ? from_name : to_name, LabelType()));
+    columns.emplace_back(std::move(array_res.value()));
+  }
+  return pg->AddNodeProperties(
+      arrow::Table::Make(arrow::schema(fields), columns));
+}
+
+katana::Result<void>
+katana::analytics::ReachabilityIndexQuery(
+    PropertyGraph* pg, const std::string& index_property_prefix,
+    const GraphTopology::Node* sources, const GraphTopology::Node* targets,
+    uint64_t num_queries, uint32_t* distances) {
+  return RunQueries<false>(
+      pg, index_property_prefix, sources, targets, num_queries,
+      [&](uint64_t q, uint32_t distance) { distances[q] = distance; });
+}
+
+katana::Result<void>
+katana::analytics::ReachabilityIndexReachable(
+    PropertyGraph* pg, const std::string& index_property_prefix,
+    const GraphTopology::Node* sources, const GraphTopology::Node* targets,
+    uint64_t num_queries, bool* reachable) {
+  return RunQueries<true>(
+      pg, index_property_prefix, sources, targets, num_queries,
+      [&](uint64_t q, uint32_t distance) {
+        reachable[q] = distance != kInfinity;
+      });
+}
+
+void
+katana::analytics::ReachabilityIndexStatistics::Print(std::ostream& os) const {
+  os << "Total label size = " << total_label_size << std::endl;
+  os << "Largest label size = " << max_label_size << std::endl;
+  os << "Average label size = " << average_label_size << std::endl;
+}
+
+katana::Result<ReachabilityIndexStatistics>
+katana::analytics::ReachabilityIndexStatistics::Compute(
+    PropertyGraph* pg, const std::string& index_property_prefix) {
+  std::vector<std::string> names{FromPropertyName(index_property_prefix)};
+  if (std::string to_name = ToPropertyName(index_property_prefix);
+      pg->HasNodeProperty(to_name)) {
+    names.emplace_back(to_name);
+  }
+
+  uint64_t num_nodes = pg->topology().num_nodes();
+  katana::GAccumulator<uint64_t> total;
+  katana::GReduceMax<uint64_t> max_size;
+  for (const std::string& name : names) {
+    auto labels_res = GetLabels(*pg, name);
+    if (!labels_res) {
+      return labels_res.error();
+    }
+    LabelView labels = labels_res.value();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          total += labels.size(n);
+          max_size.update(labels.size(n));
+        },
+        katana::no_stats(), katana::loopname("ReachabilityIndexStatistics"));
+  }
+  uint64_t num_labels = names.size() * num_nodes;
+  return ReachabilityIndexStatistics{
+      total.reduce(), max_size.reduce(),
+      num_labels == 0 ? 0 : double(total.reduce()) / num_labels};
+}
@@ -0,0 +1,641 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Cancellation.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// The state of a search in one direction. The distance and parent of a
+/// node are valid only if its stamp is the one of the current query.
+template <typename Weight>
+struct SearchSide {
+  using Entry = std::pair<Weight, Node>;
+  using Later = std::greater<Entry>;
+
+  std::vector<Weight> distance;
+  std::vector<Node> parent;
+  std::vector<uint32_t> seen;
+  std::vector<Entry> heap;
+
+  bool Reached(Node n, uint32_t stamp) const { return seen[n] == stamp; }
+
+  /// Record a path of length dist to n through parent if it is shorter
+  /// than the one known
+  void Relax(Node n, Weight dist, Node parent_node, uint32_t stamp) {
+    if (seen[n] == stamp && distance[n] <= dist) {
+      return;
+    }
+    seen[n] = stamp;
+    distance[n] = dist;
+    parent[n] = parent_node;
+    heap.emplace_back(dist, n);
+    std::push_heap(heap.begin(), heap.end(), Later());
+  }
+
+  /// Drop the entries left behind by shorter paths from the top of the
+  /// heap. \returns whether any node is left to settle.
+  bool Prune() {
+    while (!heap.empty() &&
+           heap.front().first != distance[heap.front().second]) {
+      std::pop_heap(heap.begin(), heap.end(), Later());
+      heap.pop_back();
+    }
+    return !heap.empty();
+  }
+
+  Entry Pop() {
+    std::pop_heap(heap.begin(), heap.end(), Later());
+    Entry top = heap.back();
+    heap.pop_back();
+    return top;
+  }
+};
+
+/// A thread's buffers for shortest path queries, allocated by the first
+/// query and reused by the following ones without being cleared
+template <typename Weight>
+struct QueryScratch {
+  SearchSide<Weight> forward;
+  SearchSide<Weight> backward;
+  /// The lower bound on the distance to the target of each node reached by
+  /// a landmark search
+  std::vector<Weight> potential;
+  uint32_t stamp{0};
+
+  void Start(size_t num_nodes) {
+    if (forward.seen.size() < num_nodes) {
+      for (SearchSide<Weight>* side : {&forward, &backward}) {
+        side->distance.resize(num_nodes);
+        side->parent.resize(num_nodes);
+        side->seen.assign(num_nodes, 0);
+      }
+      stamp = 0;
+    }
+    if (++stamp == 0) {
+      std::fill(forward.seen.begin(), forward.seen.end(), 0);
+      std::fill(backward.seen.begin(), backward.seen.end(), 0);
+      stamp = 1;
+    }
+    forward.heap.clear();
+    backward.heap.clear();
+  }
+};
+
+template <typename Weight, typename WeightFn>
+ShortestPathResult
+Dijkstra(
+    const katana::GraphTopology& topology, WeightFn weight_of, Node source,
+    Node target, QueryScratch<Weight>* scratch) {
+  scratch->Start(topology.num_nodes());
+  SearchSide<Weight>& forward = scratch->forward;
+  uint32_t stamp = scratch->stamp;
+  const Node* dests = topology.edge_dests();
+
+  forward.Relax(source, 0, source, stamp);
+  while (forward.Prune()) {
+    auto [dist, n] = forward.Pop();
+    if (n == target) {
+      break;
+    }
+    for (auto e : topology.edges(n)) {
+      forward.Relax(dests[e], dist + weight_of(e), n, stamp);
+    }
+  }
+
+  ShortestPathResult result;
+  if (!forward.Reached(target, stamp)) {
+    return result;
+  }
+  for (Node n = target; n != source; n = forward.parent[n]) {
+    result.path.emplace_back(n);
+  }
+  result.path.emplace_back(source);
+  std::reverse(result.path.begin(), result.path.end());
+  result.distance = static_cast<double>(forward.distance[target]);
+  return result;
+}
+
+/// Bidirectional Dijkstra with the stopping rule of
+///   Andrew V. Goldberg and Chris Harrelson. Computing the Shortest Path:
+///   A* Search Meets Graph Theory. SODA 2005.
+/// Whenever an edge links the two searches, the path through it is a
+/// candidate; once the closest unsettled nodes of both directions are
+/// together no closer than the best candidate, it is a shortest path.
+template <typename Weight, typename WeightFn>
+ShortestPathResult
+BidirectionalDijkstra(
+    const katana::GraphTopology& topology, const katana::InEdgeIndex& in_edges,
+    WeightFn weight_of, Node source, Node target,
+    QueryScratch<Weight>* scratch) {
+  if (source == target) {
+    return ShortestPathResult{{source}, 0};
+  }
+  scratch->Start(topology.num_nodes());
+  SearchSide<Weight>& forward = scratch->forward;
+  SearchSide<Weight>& backward = scratch->backward;
+  uint32_t stamp = scratch->stamp;
+  const Node* dests = topology.edge_dests();
+
+  bool found = false;
+  Weight best{};
+  Node meet{};
+  auto link = [&](Node n, Weight dist) {
+    if (!found || dist < best) {
+      found = true;
+      best = dist;
+      meet = n;
+    }
+  };
+
+  forward.Relax(source, 0, source, stamp);
+  backward.Relax(target, 0, target, stamp);
+  while (forward.Prune() && backward.Prune()) {
+    Weight bound = forward.heap.front().first + backward.heap.front().first;
+    if (found && bound >= best) {
+      break;
+    }
+    if (forward.heap.size() <= backward.heap.size()) {
+      auto [dist, n] = forward.Pop();
+      for (auto e : topology.edges(n)) {
+        Node dst = dests[e];
+        Weight new_dist = dist + weight_of(e);
+        forward.Relax(dst, new_dist, n, stamp);
+        if (backward.Reached(dst, stamp)) {
+          link(dst, new_dist + backward.distance[dst]);
+        }
+      }
+    } else {
+      auto [dist, n] = backward.Pop();
+      for (auto e : in_edges.in_edges(n)) {
+        Node src = in_edges.in_edge_src(e);
+        Weight new_dist = dist + weight_of(in_edges.out_edge_id(e));
+        backward.Relax(src, new_dist, n, stamp);
+        if (forward.Reached(src, stamp)) {
+          link(src, new_dist + forward.distance[src]);
+        }
+      }
+    }
+  }
+
+  ShortestPathResult result;
+  if (!found) {
+    return result;
+  }
+  for (Node n = meet; n != source; n = forward.parent[n]) {
+    result.path.emplace_back(n);
+  }
+  result.path.emplace_back(source);
+  std::reverse(result.path.begin(), result.path.end());
+  for (Node n = meet; n != target;) {
+    n = backward.parent[n];
+    result.path.emplace_back(n);
+  }
+  result.distance = static_cast<double>(best);
+  return result;
+}
+
+std::string
+LandmarkPropertyName(
+    const std::string& prefix, const char* from_or_to, uint32_t i) {
+  return prefix + "-" + from_or_to + "-" + std::to_string(i);
+}
+
+/// The distances between the landmarks and every node. As in Sssp, a
+/// distance of kInfinity or more means there is no path.
+template <typename Weight>
+struct Landmarks {
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max() / 4;
+
+  std::vector<std::shared_ptr<typename arrow::CTypeTraits<Weight>::ArrayType>>
+      arrays;
+  /// from[i][n] is the distance from landmark i to n
+  std::vector<const Weight*> from;
+  /// to[i][n] is the distance from n to landmark i
+  std::vector<const Weight*> to;
+
+  /// \returns a lower bound on the distance from n to target by the
+  /// triangle inequality, or kInfinity if a landmark shows that n does not
+  /// reach target. Skipping the landmarks that give no bound keeps the
+  /// bounds consistent along every edge of nodes that may reach target.
+  Weight LowerBound(Node n, Node target) const {
+    Weight bound{0};
+    for (size_t i = 0; i < from.size(); ++i) {
+      Weight landmark_to_node = from[i][n];
+      Weight landmark_to_target = from[i][target];
+      if (landmark_to_node < kInfinity) {
+        // The landmark reaches all that n reaches
+        if (landmark_to_target >= kInfinity) {
+          return kInfinity;
+        }
+        if (landmark_to_target > landmark_to_node) {
+          bound =
+              std::max<Weight>(bound, landmark_to_target - landmark_to_node);
+        }
+      }
+      Weight node_to_landmark = to[i][n];
+      Weight target_to_landmark = to[i][target];
+      if (target_to_landmark < kInfinity) {
+        // All that reaches target reaches the landmark
+        if (node_to_landmark >= kInfinity) {
+          return kInfinity;
+        }
+        if (node_to_landmark > target_to_landmark) {
+          bound =
+              std::max<Weight>(bound, node_to_landmark - target_to_landmark);
+        }
+      }
+    }
+    return bound;
+  }
+};
+
+template <typename Weight>
+katana::Result<Landmarks<Weight>>
+LoadLandmarks(katana::PropertyGraph* pg, const std::string& prefix) {
+  Landmarks<Weight> landmarks;
+  for (uint32_t i = 0;
+       pg->GetNodeProperty(LandmarkPropertyName(prefix, "from", i)); ++i) {
+    for (const char* from_or_to : {"from", "to"}) {
+      auto array_result = pg->GetNodePropertyTyped<Weight>(
+          LandmarkPropertyName(prefix, from_or_to, i));
+      if (!array_result) {
+        return array_result.error();
+      }
+      landmarks.arrays.emplace_back(array_result.value());
+    }
+    landmarks.from.emplace_back(landmarks.arrays[2 * i]->raw_values());
+    landmarks.to.emplace_back(landmarks.arrays[2 * i + 1]->raw_values());
+  }
+  if (landmarks.from.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no landmarks with prefix {}",
+        prefix);
+  }
+  return landmarks;
+}
+
+/// A* search with the landmark lower bounds as potentials. Since the bounds
+/// are consistent, this is Dijkstra with the reduced edge weights
+///   weight(u, v) - bound(u) + bound(v) >= 0
+/// whose distances exceed the real ones by bound(n) - bound(source).
+template <typename Weight, typename WeightFn>
+ShortestPathResult
+LandmarkSearch(
+    const katana::GraphTopology& topology, const Landmarks<Weight>& landmarks,
+    WeightFn weight_of, Node source, Node target,
+    QueryScratch<Weight>* scratch) {
+  scratch->Start(topology.num_nodes());
+  SearchSide<Weight>& forward = scratch->forward;
+  std::vector<Weight>& potential = scratch->potential;
+  if (potential.size() < topology.num_nodes()) {
+    potential.resize(topology.num_nodes());
+  }
+  uint32_t stamp = scratch->stamp;
+  const Node* dests = topology.edge_dests();
+
+  potential[source] = landmarks.LowerBound(source, target);
+  if (potential[source] >= Landmarks<Weight>::kInfinity) {
+    return ShortestPathResult{};
+  }
+  forward.Relax(source, 0, source, stamp);
+  while (forward.Prune()) {
+    auto [dist, n] = forward.Pop();
+    if (n == target) {
+      break;
+    }
+    for (auto e : topology.edges(n)) {
+      Node dst = dests[e];
+      if (!forward.Reached(dst, stamp)) {
+        potential[dst] = landmarks.LowerBound(dst, target);
+        if (potential[dst] >= Landmarks<Weight>::kInfinity) {
+          continue;
+        }
+      }
+      forward.Relax(
+          dst, dist + weight_of(e) + potential[dst] - potential[n], n, stamp);
+    }
+  }
+
+  ShortestPathResult result;
+  if (!forward.Reached(target, stamp)) {
+    return result;
+  }
+  for (Node n = target; n != source; n = forward.parent[n]) {
+    result.path.emplace_back(n);
+  }
+  result.path.emplace_back(source);
+  std::reverse(result.path.begin(), result.path.end());
+  // The bound of the target is 0
+  result.distance =
+      static_cast<double>(forward.distance[target] + potential[source]);
+  return result;
+}
+
+template <typename Weight>
+katana::Result<std::vector<ShortestPathResult>>
+ShortestPathsWithWrap(
+    katana::PropertyGraph* pg,
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+    const std::string& edge_weight_property_name, ShortestPathPlan plan) {
+  auto weights_result =
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto weights = weights_result.value();
+  auto weight_of = [&](uint64_t e) { return weights->Value(e); };
+
+  std::shared_ptr<const katana::InEdgeIndex> in_edges;
+  if (plan.algorithm() == ShortestPathPlan::kBidirectionalDijkstra) {
+    auto in_edges_result = pg->GetInEdgeIndex();
+    if (!in_edges_result) {
+      return in_edges_result.error();
+    }
+    in_edges = in_edges_result.value();
+  }
+  Landmarks<Weight> landmarks;
+  if (plan.algorithm() == ShortestPathPlan::kLandmarks) {
+    auto landmarks_result =
+        LoadLandmarks<Weight>(pg, plan.landmarks_property_prefix());
+    if (!landmarks_result) {
+      return landmarks_result.error();
+    }
+    landmarks = std::move(landmarks_result.value());
+  }
+
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<ShortestPathResult> results(queries.size());
+  katana::PerThreadStorage<QueryScratch<Weight>> scratch;
+  auto answer = [&](size_t i) {
+    auto [source, target] = queries[i];
+    if (in_edges) {
+      results[i] = BidirectionalDijkstra(
+          topology, *in_edges, weight_of, source, target, scratch.getLocal());
+    } else if (!landmarks.from.empty()) {
+      results[i] = LandmarkSearch(
+          topology, landmarks, weight_of, source, target, scratch.getLocal());
+    } else {
+      results[i] =
+          Dijkstra(topology, weight_of, source, target, scratch.getLocal());
+    }
+  };
+
+  katana::StatTimer exec_time("ShortestPaths");
+  exec_time.start();
+  if (queries.size() == 1) {
+    answer(0);
+  } else {
+    katana::do_all(
+        katana::iterate(size_t{0}, queries.size()), answer, katana::steal(),
+        katana::no_stats(), katana::loopname("ShortestPaths"));
+  }
+  exec_time.stop();
+
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return results;
+}
+
+template <typename Weight>
+katana::Result<void>
+ShortestPathLandmarksWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& landmarks_property_prefix, uint32_t num_landmarks) {
+  auto weights_result =
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto weights = weights_result.value();
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+  auto in_edges = in_edges_result.value();
+  const katana::GraphTopology& topology = pg->topology();
+
+  // Sssp on the transposed graph finds the distances to a landmark
+  katana::PropertyGraph transposed;
+  if (auto r = transposed.SetTopology(in_edges->topology); !r) {
+    return r.error();
+  }
+  std::vector<Weight> in_weights(in_edges->num_edges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, in_edges->num_edges()),
+      [&](uint64_t e) {
+        in_weights[e] = weights->Value(in_edges->out_edge_id(e));
+      },
+      katana::no_stats());
+  auto weights_table = arrow::Table::Make(
+      arrow::schema({arrow::field(
+          edge_weight_property_name,
+          pg->GetEdgeProperty(edge_weight_property_name)->type())}),
+      {katana::BuildArray(in_weights)});
+  if (auto r = transposed.AddEdgeProperties(weights_table); !r) {
+    return r.error();
+  }
+
+  // The distance from the nearest landmark to each node
+  std::vector<Weight> nearest(
+      topology.num_nodes(), Landmarks<Weight>::kInfinity);
+  Node landmark = 0;
+  for (Node n = 1; n < topology.num_nodes(); ++n) {
+    if (topology.edges(n).size() > topology.edges(landmark).size()) {
+      landmark = n;
+    }
+  }
+
+  katana::analytics::SsspPlan sssp_plan(pg);
+  for (uint32_t i = 0; i < num_landmarks && topology.num_nodes() > 0; ++i) {
+    std::string from_name =
+        LandmarkPropertyName(landmarks_property_prefix, "from", i);
+    std::string to_name =
+        LandmarkPropertyName(landmarks_property_prefix, "to", i);
+    if (auto r = katana::analytics::Sssp(
+            pg, landmark, edge_weight_property_name, from_name, sssp_plan);
+        !r) {
+      return r.error();
+    }
+    if (auto r = katana::analytics::Sssp(
+            &transposed, landmark, edge_weight_property_name, to_name,
+            sssp_plan);
+        !r) {
+      return r.error();
+    }
+    auto to_column = transposed.GetNodeProperty(to_name);
+    auto to_table = arrow::Table::Make(
+        arrow::schema({arrow::field(to_name, to_column->type())}),
+        {to_column});
+    if (auto r = pg->AddNodeProperties(to_table); !r) {
+      return r.error();
+    }
+    if (auto r = transposed.RemoveNodeProperty(to_name); !r) {
+      return r.error();
+    }
+
+    // Choose the reachable node farthest from the landmarks so far, the
+    // smallest one on ties
+    auto from_result = pg->GetNodePropertyTyped<Weight>(from_name);
+    if (!from_result) {
+      return from_result.error();
+    }
+    auto from = from_result.value();
+    using Farthest = std::pair<Weight, Node>;
+    auto farther = [](const Farthest& a, const Farthest& b) {
+      if (a.first != b.first) {
+        return a.first > b.first ? a : b;
+      }
+      return a.second < b.second ? a : b;
+    };
+    auto farthest = katana::make_reducible(
+        farther, []() { return Farthest{0, 0}; });
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node n) {
+          nearest[n] = std::min(nearest[n], from->Value(n));
+          if (nearest[n] < Landmarks<Weight>::kInfinity) {
+            farthest.update(Farthest{nearest[n], n});
+          }
+        },
+        katana::no_stats());
+    Farthest next = farthest.reduce();
+    // Every reachable node is a landmark already
+    if (next.first == 0) {
+      break;
+    }
+    landmark = next.second;
+  }
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<std::vector<ShortestPathResult>>
+katana::analytics::ShortestPaths(
+    katana::PropertyGraph* pg,
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+    const std::string& edge_weight_property_name, ShortestPathPlan plan) {
+  for (const auto& [source, target] : queries) {
+    if (source >= pg->topology().num_nodes() ||
+        target >= pg->topology().num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "source {} or target {} is not a node", source, target);
+    }
+  }
+  if (plan.algorithm() != ShortestPathPlan::kBidirectionalDijkstra &&
+      plan.algorithm() != ShortestPathPlan::kDijkstra &&
+      plan.algorithm() != ShortestPathPlan::kLandmarks) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        static_cast<int>(plan.algorithm()));
+  }
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return ShortestPathsWithWrap<uint32_t>(
+        pg, queries, edge_weight_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return ShortestPathsWithWrap<int32_t>(
+        pg, queries, edge_weight_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return ShortestPathsWithWrap<uint64_t>(
+        pg, queries, edge_weight_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return ShortestPathsWithWrap<int64_t>(
+        pg, queries, edge_weight_property_name, plan);
+  case arrow::FloatType::type_id:
+    return ShortestPathsWithWrap<float>(
+        pg, queries, edge_weight_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return ShortestPathsWithWrap<double>(
+        pg, queries, edge_weight_property_name, plan);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+katana::Result<ShortestPathResult>
+katana::analytics::ShortestPath(
+    katana::PropertyGraph* pg, size_t source, size_t target,
+    const std::string& edge_weight_property_name, ShortestPathPlan plan) {
+  if (source >= pg->topology().num_nodes() ||
+      target >= pg->topology().num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} or target {} is not a node", source, target);
+  }
+  auto results_result = ShortestPaths(
+      pg, {{static_cast<uint32_t>(source), static_cast<uint32_t>(target)}},
+      edge_weight_property_name, plan);
+  if (!results_result) {
+    return results_result.error();
+  }
+  return std::move(results_result.value()[0]);
+}
+
+katana::Result<void>
+katana::analytics::ShortestPathLandmarks(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& landmarks_property_prefix, uint32_t num_landmarks) {
+  if (num_landmarks == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no landmarks requested");
+  }
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return ShortestPathLandmarksWithWrap<uint32_t>(
+        pg, edge_weight_property_name, landmarks_property_prefix,
+        num_landmarks);
+  case arrow::Int32Type::type_id:
+    return ShortestPathLandmarksWithWrap<int32_t>(
+        pg, edge_weight_property_name, landmarks_property_prefix,
+        num_landmarks);
+  case arrow::UInt64Type::type_id:
+    return ShortestPathLandmarksWithWrap<uint64_t>(
+        pg, edge_weight_property_name, landmarks_property_prefix,
+        num_landmarks);
+  case arrow::Int64Type::type_id:
+    return ShortestPathLandmarksWithWrap<int64_t>(
+        pg, edge_weight_property_name, landmarks_property_prefix,
+        num_landmarks);
+  case arrow::FloatType::type_id:
+    return ShortestPathLandmarksWithWrap<float>(
+        pg, edge_weight_property_name, landmarks_property_prefix,
+        num_landmarks);
+  case arrow::DoubleType::type_id:
+    return ShortestPathLandmarksWithWrap<double>(
+        pg, edge_weight_property_name, landmarks_property_prefix,
+        num_landmarks);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
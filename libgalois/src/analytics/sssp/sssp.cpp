@@ -19,8 +19,18 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "katana/Cancellation.h"
+#include "katana/LargeArray.h"
+#include "katana/LowLatency.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/DistributedPropagation.h"
+#include "tsuba/tsuba.h"
 
 using namespace katana::analytics;
 
@@ -66,30 +76,194 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   static constexpr Dist kDistanceInfinity = Base::kDistanceInfinity;
 
   using PSchunk = katana::PerSocketChunkFIFO<kChunkSize>;
-  using OBIM = katana::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
-  using OBIMBarrier = typename katana::OrderedByIntegerMetric<
-      UpdateRequestIndexer, PSchunk>::template with_barrier<true>::type;
+  using StealingChunk = katana::StealingChunkFIFO<kChunkSize>;
+
+  /// Requests more than this many buckets past the current one wait outside
+  /// the worklist buckets; see OrderedByIntegerMetric
+  static constexpr unsigned kFarBuckets = 256;
+
+  /// Runtime controller for the delta-stepping bucket width. Threads report
+  /// every item they pop; once per window the width is doubled if threads
+  /// get too few items per bucket visit to amortize moving between buckets,
+  /// or halved if too many popped items were already stale.
+  class DeltaTuner {
+    static constexpr uint64_t kLocalFlush = 256;
+    static constexpr uint64_t kTuneWindow = 1 << 16;
+    static constexpr uint64_t kMinBucketOccupancy = kChunkSize;
+    static constexpr double kMaxStaleFraction = 0.5;
+    static constexpr unsigned kMaxShift = 48;
+
+    struct Local {
+      unsigned last_index{std::numeric_limits<unsigned>::max()};
+      uint64_t items{0};
+      uint64_t stale{0};
+      uint64_t visits{0};
+    };
+
+    std::atomic<unsigned> shift_;
+    std::atomic<uint64_t> items_{0};
+    std::atomic<uint64_t> stale_{0};
+    std::atomic<uint64_t> visits_{0};
+    std::atomic<bool> tuning_{false};
+    std::atomic<uint64_t> adjustments_{0};
+    katana::PerThreadStorage<Local> local_;
+
+    void Retune() {
+      if (tuning_.exchange(true, std::memory_order_acquire)) {
+        return;
+      }
+      uint64_t items = items_.exchange(0);
+      uint64_t stale = stale_.exchange(0);
+      uint64_t visits = std::max<uint64_t>(visits_.exchange(0), 1);
+
+      unsigned shift = shift_.load(std::memory_order_relaxed);
+      if (items / visits < kMinBucketOccupancy && shift < kMaxShift) {
+        shift_.store(shift + 1, std::memory_order_relaxed);
+        adjustments_ += 1;
+      } else if (stale > kMaxStaleFraction * items && shift > 0) {
+        shift_.store(shift - 1, std::memory_order_relaxed);
+        adjustments_ += 1;
+      }
+      tuning_.store(false, std::memory_order_release);
+    }
+
+  public:
+    explicit DeltaTuner(unsigned shift) : shift_(shift) {}
+
+    unsigned shift() const { return shift_.load(std::memory_order_relaxed); }
+    uint64_t adjustments() const { return adjustments_.load(); }
 
-  template <typename T, typename OBIMTy = OBIM, typename P, typename R>
+    void Observe(unsigned index, bool stale) {
+      Local& l = *local_.getLocal();
+      if (index != l.last_index) {
+        l.last_index = index;
+        l.visits += 1;
+      }
+      l.items += 1;
+      l.stale += stale;
+      if (l.items < kLocalFlush) {
+        return;
+      }
+      stale_ += l.stale;
+      visits_ += l.visits;
+      if ((items_ += l.items) >= kTuneWindow) {
+        Retune();
+      }
+      l.items = l.stale = l.visits = 0;
+    }
+  };
+
+  /// Like UpdateRequestIndexer but reads the current width from a tuner
+  struct AdaptiveIndexer {
+    const DeltaTuner* tuner;
+
+    template <typename R>
+    unsigned int operator()(const R& req) const {
+      unsigned int t = req.dist / (1UL << tuner->shift());
+      return t;
+    }
+  };
+
+  template <typename Indexer, typename Chunk = PSchunk>
+  using OBIMFor = katana::OrderedByIntegerMetric<Indexer, Chunk>;
+  template <typename Indexer, typename Chunk = PSchunk>
+  using OBIMBarrierFor =
+      typename OBIMFor<Indexer, Chunk>::template with_barrier<true>::type;
+
+  /// Choose an initial delta (as a shift) from a sample of the graph.
+  ///
+  /// Following Meyer and Sanders, a bucket width of about the maximum edge
+  /// weight divided by the average degree bounds the re-relaxations per
+  /// node while exposing enough work per bucket; twice the sampled mean
+  /// weight stands in for the maximum.
+  static unsigned ChooseDeltaShift(const Graph& graph) {
+    constexpr size_t kSampleNodes = 1024;
+    constexpr size_t kSampleEdgesPerNode = 64;
+
+    size_t num_nodes = graph.size();
+    uint64_t num_edges = graph.num_edges();
+    if (num_nodes == 0 || num_edges == 0) {
+      return SsspPlan::kDefaultDelta;
+    }
+
+    size_t stride = std::max<size_t>(num_nodes / kSampleNodes, 1);
+    double weight_sum = 0;
+    size_t num_sampled = 0;
+    for (size_t n = 0; n < num_nodes; n += stride) {
+      size_t taken = 0;
+      for (auto e : graph.edges(n)) {
+        if (taken++ == kSampleEdgesPerNode) {
+          break;
+        }
+        weight_sum += graph.template GetEdgeData<EdgeWeight>(e);
+        num_sampled += 1;
+      }
+    }
+    if (num_sampled == 0) {
+      return SsspPlan::kDefaultDelta;
+    }
+
+    double avg_degree = static_cast<double>(num_edges) / num_nodes;
+    double delta =
+        2 * (weight_sum / num_sampled) / std::max(avg_degree, 1.0);
+    if (delta < 2) {
+      return 0;
+    }
+    return std::min<unsigned>(std::log2(delta), 31);
+  }
+
+  template <
+      typename T, typename OBIMTy, typename Indexer, typename P, typename R>
   static void DeltaStepAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
-      const R& edgeRange, unsigned stepShift) {
+      const R& edgeRange, const Indexer& indexer, DeltaTuner* tuner) {
     //! [reducible for self-defined stats]
     katana::GAccumulator<size_t> BadWork;
     //! [reducible for self-defined stats]
     katana::GAccumulator<size_t> WLEmptyWork;
 
+    // With a fixed delta, a node needs at most one request waiting in each
+    // bucket: a request relaxes from the distance of its node when it runs,
+    // so improvements within the bucket of a waiting request ride along
+    // with it. pending[n] is one more than the bucket of the request of n
+    // that may run, or 0.
+    constexpr bool kDedupe = std::is_same_v<T, UpdateRequest> &&
+                             std::is_same_v<Indexer, UpdateRequestIndexer>;
+    katana::LargeArray<std::atomic<uint32_t>> pending;
+    if constexpr (kDedupe) {
+      pending.allocateBlocked(graph->size());
+      katana::do_all(
+          katana::iterate(size_t{0}, graph->size()),
+          [&](size_t n) {
+            pending[n].store(0, std::memory_order_relaxed);
+          },
+          katana::no_stats());
+      pending[source] = indexer(UpdateRequest(source, 0)) + 1;
+    }
+
     graph->template GetData<NodeDistance>(source) = 0;
 
     katana::InsertBag<T> init_bag;
     pushWrap(init_bag, source, 0, "parallel");
 
+    auto* dists = graph->template GetNodePropertyData<NodeDistance>();
+    const auto* weights = graph->template GetEdgePropertyData<EdgeWeight>();
+
     katana::for_each(
         katana::iterate(init_bag),
         [&](const T& item, auto& ctx) {
-          const auto& sdata = graph->template GetData<NodeDistance>(item.src);
+          const auto& sdata = dists[item.src];
+
+          if (tuner) {
+            tuner->Observe(indexer(item), sdata < item.dist);
+          }
 
-          if (sdata < item.dist) {
+          bool stale = sdata < item.dist;
+          if constexpr (kDedupe) {
+            uint32_t bucket = indexer(item) + 1;
+            stale = !pending[item.src].compare_exchange_strong(bucket, 0);
+          }
+          if (stale) {
             if (kTrackWork) {
               WLEmptyWork += 1;
             }
@@ -98,8 +272,8 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
 
           for (auto ii : edgeRange(item)) {
             auto dest = graph->GetEdgeDest(ii);
-            auto& ddist = graph->template GetData<NodeDistance>(dest);
-            Dist ew = graph->template GetEdgeData<EdgeWeight>(ii);
+            auto& ddist = dists[*dest];
+            Dist ew = weights[ii];
             const Dist new_dist = sdata + ew;
             Dist old_dist = katana::atomicMin(ddist, new_dist);
             if (new_dist < old_dist) {
@@ -110,11 +284,17 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
                 }
                 //! [per-thread contribution of self-defined stats]
               }
+              if constexpr (kDedupe) {
+                uint32_t bucket = indexer(UpdateRequest(*dest, new_dist)) + 1;
+                if (pending[*dest].exchange(bucket) == bucket) {
+                  continue;
+                }
+              }
               pushWrap(ctx, *dest, new_dist);
             }
           }
         },
-        katana::wl<OBIMTy>(UpdateRequestIndexer{stepShift}),
+        katana::wl<OBIMTy>(indexer, kFarBuckets),
         katana::disable_conflict_detection(), katana::loopname("SSSP"));
 
     if (kTrackWork) {
@@ -125,6 +305,48 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     }
   }
 
+  template <
+      typename T, bool kBarrier, typename Indexer, typename P, typename R>
+  static void DeltaStepWith(
+      Graph* graph, const typename Graph::Node& source, const P& pushWrap,
+      const R& edgeRange, const Indexer& indexer, DeltaTuner* tuner) {
+    if constexpr (kBarrier) {
+      DeltaStepAlgo<T, OBIMBarrierFor<Indexer>>(
+          graph, source, pushWrap, edgeRange, indexer, tuner);
+    } else if (Base::UseStealingWorklist()) {
+      DeltaStepAlgo<T, OBIMFor<Indexer, StealingChunk>>(
+          graph, source, pushWrap, edgeRange, indexer, tuner);
+    } else {
+      DeltaStepAlgo<T, OBIMFor<Indexer>>(
+          graph, source, pushWrap, edgeRange, indexer, tuner);
+    }
+  }
+
+  template <typename T, bool kBarrier = false, typename P, typename R>
+  static void DeltaStep(
+      Graph* graph, const typename Graph::Node& source, const P& pushWrap,
+      const R& edgeRange, const SsspPlan& plan) {
+    if (!plan.adaptive_delta()) {
+      DeltaStepWith<T, kBarrier>(
+          graph, source, pushWrap, edgeRange,
+          UpdateRequestIndexer{plan.delta()}, nullptr);
+      return;
+    }
+
+    DeltaTuner tuner{ChooseDeltaShift(*graph)};
+    katana::ReportStatSingle("SSSP", "InitialDeltaShift", tuner.shift());
+    DeltaStepWith<T, kBarrier>(
+        graph, source, pushWrap, edgeRange, AdaptiveIndexer{&tuner}, &tuner);
+    katana::ReportStatSingle("SSSP", "FinalDeltaShift", tuner.shift());
+    katana::ReportStatSingle("SSSP", "DeltaAdjustments", tuner.adjustments());
+  }
+
+  /// The serial variants have no runtime tuning; an adaptive plan only gets
+  /// the sampled initial delta
+  static unsigned SerialDeltaShift(const Graph& graph, const SsspPlan& plan) {
+    return plan.adaptive_delta() ? ChooseDeltaShift(graph) : plan.delta();
+  }
+
   template <typename T, typename P, typename R>
   static void SerDeltaAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
@@ -329,22 +551,23 @@ public:
 
     switch (plan.algorithm()) {
     case SsspPlan::kDeltaTile:
-      DeltaStepAlgo<SrcEdgeTile>(
+      DeltaStep<SrcEdgeTile>(
           &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
+          plan);
       break;
     case SsspPlan::kDeltaStep:
-      DeltaStepAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+      DeltaStep<UpdateRequest>(
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan);
       break;
     case SsspPlan::kSerialDeltaTile:
       SerDeltaAlgo<SrcEdgeTile>(
           &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
+          SerialDeltaShift(graph, plan));
       break;
     case SsspPlan::kSerialDelta:
       SerDeltaAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph},
+          SerialDeltaShift(graph, plan));
       break;
     case SsspPlan::kDijkstraTile:
       DijkstraAlgo<SrcEdgeTile>(
@@ -361,8 +584,8 @@ public:
       TopoTileAlgo(&graph, source);
       break;
     case SsspPlan::kDeltaStepBarrier:
-      DeltaStepAlgo<UpdateRequest, OBIMBarrier>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+      DeltaStep<UpdateRequest, true>(
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan);
       break;
     default:
       return katana::ErrorCode::InvalidArgument;
@@ -383,7 +606,70 @@ Sssp(
     size_t start_node, SsspPlan plan) {
   static_assert(std::is_integral_v<Weight> || std::is_floating_point_v<Weight>);
   SsspImplementation<Weight> impl{{plan.edge_tile_size()}};
-  return impl.SSSP(pg, start_node, plan);
+  if (auto r = impl.SSSP(pg, start_node, plan); !r) {
+    return r.error();
+  }
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return katana::ResultSuccess();
+}
+
+/// SSSP on the partition pg of a graph partitioned across the hosts of
+/// tsuba::Comm(), from start_node, a node of the RDG
+template <typename Weight>
+katana::Result<void>
+DistributedSssp(
+    typename SsspImplementation<Weight>::Graph* graph,
+    katana::PropertyGraph* pg, size_t start_node) {
+  using Impl = SsspImplementation<Weight>;
+  auto sync_res = katana::MirrorSync::Make(*pg, tsuba::Comm());
+  if (!sync_res) {
+    return sync_res.error();
+  }
+  katana::MirrorSync& sync = sync_res.value();
+  if (start_node >= sync.num_global_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "start node {} is not a node of the graph of {} nodes", start_node,
+        sync.num_global_nodes());
+  }
+
+  const katana::GraphTopology& topology = pg->topology();
+  katana::LargeArray<std::atomic<Weight>> distances;
+  distances.allocateBlocked(topology.num_nodes());
+  katana::DynamicBitset active;
+  active.resize(topology.num_nodes());
+  katana::do_all(
+      katana::iterate(topology),
+      [&](uint32_t n) {
+        bool is_start =
+            n < sync.num_masters() && sync.global_id(n) == start_node;
+        distances.constructAt(
+            n, is_start ? Weight{0} : Impl::kDistanceInfinity);
+        if (is_start) {
+          active.set(n);
+        }
+      },
+      katana::no_stats());
+
+  auto rounds_res = DistributedMinPropagation<Weight>(
+      topology, &sync, &distances, &active,
+      [&](katana::GraphTopology::Edge e) -> Weight {
+        return graph->template GetEdgeData<typename Impl::EdgeWeight>(e);
+      });
+  if (!rounds_res) {
+    return rounds_res.error();
+  }
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](uint32_t n) {
+        graph->template GetData<typename Impl::NodeDistance>(n) =
+            distances[n].load();
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
 }
 
 template <typename Weight>
@@ -413,6 +699,9 @@ SSSPWithWrap(
     return graph.error();
   }
 
+  if (plan.architecture() == kDistributedCPU) {
+    return DistributedSssp<Weight>(&graph.value(), pg, start_node);
+  }
   return Sssp(graph.value(), start_node, plan);
 }
 
@@ -423,6 +712,10 @@ katana::analytics::Sssp(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
     const std::string& output_property_name, SsspPlan plan) {
+  if (auto r = CheckArchitecture(plan, {kCPU, kDistributedCPU}); !r) {
+    return r.error();
+  }
+  katana::LowLatencyRegion region(pg->num_nodes() + pg->num_edges());
   switch (pg->GetEdgeProperty(edge_weight_property_name)->type()->id()) {
   case arrow::UInt32Type::type_id:
     return SSSPWithWrap<uint32_t>(
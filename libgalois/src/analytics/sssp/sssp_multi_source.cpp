@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <limits>
+
+#include <arrow/api.h>
+
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// The number of sources relaxed together; a row of distances of 32-bit
+/// weights is a cache line
+constexpr size_t kBatchWidth = 16;
+
+/// Shortest paths from kBatchWidth sources at once. Every node holds a row
+/// of its distances from the sources. Rounds pull, into each out-neighbor of
+/// a node whose row changed in the previous round, the rows of those of its
+/// in-neighbors that changed plus the weight of the edge, so a node receives
+/// the final row of each in-neighbor in the round after it last changes, and
+/// the search ends when no row changes.
+template <typename Weight>
+class BatchRelaxation {
+public:
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max() / 4;
+
+  BatchRelaxation(
+      const katana::GraphTopology& topology,
+      const katana::InEdgeIndex& in_edges, const Weight* in_weights)
+      : topology_(topology), in_edges_(in_edges), in_weights_(in_weights) {
+    uint64_t num_nodes = topology_.num_nodes();
+    current_.allocateBlocked(num_nodes * kBatchWidth);
+    next_.allocateBlocked(num_nodes * kBatchWidth);
+    katana::CreateBlocked(num_nodes, &changed_, &active_);
+  }
+
+  /// Search from sources[0, kBatchWidth)
+  void Run(const uint32_t* sources) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, topology_.num_nodes()),
+        [&](uint64_t n) { std::fill_n(row(n), kBatchWidth, kInfinity); },
+        katana::no_stats());
+    for (size_t i = 0; i < kBatchWidth; ++i) {
+      Node s = sources[i];
+      row(s)[i] = 0;
+      if (!changed_[s]) {
+        changed_[s] = 1;
+        changed_nodes_.push(s);
+      }
+    }
+
+    while (!changed_nodes_.empty()) {
+      katana::do_all(
+          katana::iterate(changed_nodes_),
+          [&](Node n) {
+            for (auto e : topology_.edges(n)) {
+              Node dst = topology_.edge_dest(e);
+              if (!active_[dst] &&
+                  __sync_bool_compare_and_swap(&active_[dst], 0, 1)) {
+                active_nodes_.push(dst);
+              }
+            }
+          },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("SsspMultiSourceActivate"));
+
+      katana::do_all(
+          katana::iterate(active_nodes_), [&](Node n) { Pull(n); },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("SsspMultiSourcePull"));
+
+      katana::do_all(
+          katana::iterate(changed_nodes_), [&](Node n) { changed_[n] = 0; },
+          katana::no_stats());
+      katana::do_all(
+          katana::iterate(active_nodes_), [&](Node n) { active_[n] = 0; },
+          katana::no_stats());
+      changed_nodes_.clear();
+      active_nodes_.clear();
+      katana::do_all(
+          katana::iterate(lowered_nodes_),
+          [&](Node n) {
+            std::copy_n(&next_[n * kBatchWidth], kBatchWidth, row(n));
+            changed_[n] = 1;
+            changed_nodes_.push(n);
+          },
+          katana::no_stats());
+      lowered_nodes_.clear();
+    }
+  }
+
+  /// The distances of node n from the sources of the last search
+  const Weight* distances(Node n) const { return &current_[n * kBatchWidth]; }
+
+private:
+  Weight* row(Node n) { return &current_[n * kBatchWidth]; }
+
+  void Pull(Node n) {
+    // A local row, which the compiler knows aliases nothing, so that the
+    // relaxations of an edge become a few vector instructions
+    Weight relaxed[kBatchWidth];
+    std::copy_n(row(n), kBatchWidth, relaxed);
+    for (auto e : in_edges_.in_edges(n)) {
+      Node src = in_edges_.in_edge_src(e);
+      if (!changed_[src]) {
+        continue;
+      }
+      const Weight* src_row = row(src);
+      Weight weight = in_weights_[e];
+      for (size_t i = 0; i < kBatchWidth; ++i) {
+        relaxed[i] = std::min<Weight>(relaxed[i], src_row[i] + weight);
+      }
+    }
+    if (!std::equal(relaxed, relaxed + kBatchWidth, row(n))) {
+      std::copy_n(relaxed, kBatchWidth, &next_[n * kBatchWidth]);
+      lowered_nodes_.push(n);
+    }
+  }
+
+  const katana::GraphTopology& topology_;
+  const katana::InEdgeIndex& in_edges_;
+  const Weight* in_weights_;
+  katana::LargeArray<Weight> current_;
+  /// The rows of lowered_nodes_, until the end of the round
+  katana::LargeArray<Weight> next_;
+  katana::LargeArray<uint8_t> changed_;
+  katana::LargeArray<uint8_t> active_;
+  katana::InsertBag<Node> changed_nodes_;
+  katana::InsertBag<Node> active_nodes_;
+  katana::InsertBag<Node> lowered_nodes_;
+};
+
+template <typename Weight>
+katana::Result<void>
+SsspMultiSourceImpl(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  if (sources.empty()) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no sources");
+  }
+  for (uint32_t source : sources) {
+    if (source >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+  }
+
+  auto weights_result =
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto weights = weights_result.value();
+  auto in_edges_result = pg->GetInEdgeIndex();
+  if (!in_edges_result) {
+    return in_edges_result.error();
+  }
+  auto in_edges = in_edges_result.value();
+
+  // The weights in in-edge order, so that pulls read them sequentially
+  katana::LargeArray<Weight> in_weights;
+  in_weights.allocateBlocked(in_edges->num_edges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, in_edges->num_edges()),
+      [&](uint64_t e) {
+        in_weights[e] = weights->Value(in_edges->out_edge_id(e));
+      },
+      katana::no_stats());
+
+  size_t width = sources.size();
+  uint64_t num_values = num_nodes * width;
+  auto buffer_res = arrow::AllocateBuffer(num_values * sizeof(Weight));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating distances: {}",
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  auto* distances = reinterpret_cast<Weight*>(buffer->mutable_data());
+
+  BatchRelaxation<Weight> relaxation(topology, *in_edges, in_weights.data());
+  for (size_t first = 0; first < width; first += kBatchWidth) {
+    size_t count = std::min(width - first, kBatchWidth);
+    // Repeat the last source of a partial batch to fill its row
+    uint32_t batch[kBatchWidth];
+    for (size_t i = 0; i < kBatchWidth; ++i) {
+      batch[i] = sources[first + std::min(i, count - 1)];
+    }
+    relaxation.Run(batch);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          std::copy_n(
+              relaxation.distances(n), count, distances + n * width + first);
+        },
+        katana::no_stats());
+  }
+
+  using ArrowType = typename arrow::CTypeTraits<Weight>::ArrowType;
+  auto values =
+      std::make_shared<arrow::NumericArray<ArrowType>>(num_values, buffer);
+  auto type = arrow::fixed_size_list(
+      arrow::TypeTraits<ArrowType>::type_singleton(), width);
+  auto list =
+      std::make_shared<arrow::FixedSizeListArray>(type, num_nodes, values);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, type)}), {list});
+  return pg->AddNodeProperties(table);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::SsspMultiSource(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  auto weights = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return SsspMultiSourceImpl<uint32_t>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  case arrow::Int32Type::type_id:
+    return SsspMultiSourceImpl<int32_t>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  case arrow::UInt64Type::type_id:
+    return SsspMultiSourceImpl<uint64_t>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  case arrow::Int64Type::type_id:
+    return SsspMultiSourceImpl<int64_t>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  case arrow::FloatType::type_id:
+    return SsspMultiSourceImpl<float>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  case arrow::DoubleType::type_id:
+    return SsspMultiSourceImpl<double>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  default:
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "unsupported weight type {}",
+        weights->type()->ToString());
+  }
+}
@@ -0,0 +1,607 @@
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Cancellation.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Frontier.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using ComponentType = uint64_t;
+struct NodeComponent : public katana::PODProperty<ComponentType> {};
+
+using NodeData = std::tuple<NodeComponent>;
+using EdgeData = std::tuple<>;
+typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+typedef typename Graph::Node GNode;
+
+constexpr GNode kUnassigned = std::numeric_limits<GNode>::max();
+
+/// Working state shared by the phases of the algorithms. Every phase only
+/// looks at the subgraph induced by the nodes that are not assigned to a
+/// component yet.
+struct SccState {
+  const Graph& graph;
+  const katana::InEdgeIndex& in_index;
+  /// The component of each node, or kUnassigned
+  katana::LargeArray<std::atomic<GNode>> component;
+  /// Number of in-edges and out-edges from unassigned nodes, for trimming
+  katana::LargeArray<std::atomic<uint32_t>> in_count;
+  katana::LargeArray<std::atomic<uint32_t>> out_count;
+  /// Forward marks of the pivot, or the colors of the coloring phase
+  katana::LargeArray<std::atomic<GNode>> color;
+
+  SccState(const Graph& g, const katana::InEdgeIndex& index)
+      : graph(g), in_index(index) {
+    component.allocateBlocked(graph.size());
+    in_count.allocateBlocked(graph.size());
+    out_count.allocateBlocked(graph.size());
+    color.allocateBlocked(graph.size());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          new (&component[n]) std::atomic<GNode>(kUnassigned);
+          new (&in_count[n]) std::atomic<uint32_t>(0);
+          new (&out_count[n]) std::atomic<uint32_t>(0);
+          new (&color[n]) std::atomic<GNode>(kUnassigned);
+        },
+        katana::no_stats());
+  }
+
+  bool Assigned(GNode n) const {
+    return component[n].load(std::memory_order_relaxed) != kUnassigned;
+  }
+
+  /// Assign unassigned node n to component c. \returns true if this call
+  /// assigned it.
+  bool Claim(GNode n, GNode c) {
+    GNode expected = kUnassigned;
+    return component[n].compare_exchange_strong(expected, c);
+  }
+
+  template <typename F>
+  void ForEachOut(GNode n, const F& fn) const {
+    for (auto e : graph.edges(n)) {
+      fn(static_cast<GNode>(*graph.GetEdgeDest(e)));
+    }
+  }
+
+  template <typename F>
+  void ForEachIn(GNode n, const F& fn) const {
+    for (auto e : in_index.in_edges(n)) {
+      fn(static_cast<GNode>(in_index.in_edge_src(e)));
+    }
+  }
+};
+
+/// Repeatedly assign unassigned nodes without unassigned in-neighbors or
+/// out-neighbors, other than themselves, to their own component. Such
+/// nodes are on no cycle and make up most of the components of many
+/// graphs.
+void
+Trim(SccState* state) {
+  const Graph& graph = state->graph;
+  katana::Frontier current(graph.size());
+  katana::Frontier next(graph.size());
+
+  // Count before claiming so that every counted neighbor is decremented
+  // exactly once when it is trimmed
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (state->Assigned(n)) {
+          return;
+        }
+        uint32_t in = 0;
+        uint32_t out = 0;
+        state->ForEachIn(n, [&](GNode u) {
+          if (u != n && !state->Assigned(u)) {
+            ++in;
+          }
+        });
+        state->ForEachOut(n, [&](GNode w) {
+          if (w != n && !state->Assigned(w)) {
+            ++out;
+          }
+        });
+        state->in_count[n].store(in, std::memory_order_relaxed);
+        state->out_count[n].store(out, std::memory_order_relaxed);
+      },
+      katana::steal(), katana::loopname("SCC-TrimCount"), katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (!state->Assigned(n) &&
+            (state->in_count[n] == 0 || state->out_count[n] == 0)) {
+          state->Claim(n, n);
+          next.push(n);
+        }
+      },
+      katana::loopname("SCC-TrimInitial"), katana::no_stats());
+  next.Adapt();
+
+  while (!next.empty()) {
+    current.swap(next);
+    next.Reset(current.is_dense());
+
+    current.ForEach(
+        [&](const GNode& v) {
+          state->ForEachOut(v, [&](GNode w) {
+            if (w != v && !state->Assigned(w) &&
+                state->in_count[w].fetch_sub(1) == 1 && state->Claim(w, w)) {
+              next.push(w);
+            }
+          });
+          state->ForEachIn(v, [&](GNode u) {
+            if (u != v && !state->Assigned(u) &&
+                state->out_count[u].fetch_sub(1) == 1 && state->Claim(u, u)) {
+              next.push(u);
+            }
+          });
+        },
+        "SCC-Trim");
+    next.Adapt();
+  }
+}
+
+/// \returns the unassigned node with the largest product of trimmed in and
+/// out degree, or kUnassigned if every node is assigned. Must follow Trim.
+GNode
+ChoosePivot(SccState* state) {
+  using DegreeNodePair = std::pair<uint64_t, GNode>;
+  auto better = [](const DegreeNodePair& a, const DegreeNodePair& b) {
+    if (a.first > b.first || (a.first == b.first && a.second < b.second)) {
+      return a;
+    }
+    return b;
+  };
+  auto identity = []() { return DegreeNodePair{0, kUnassigned}; };
+  auto pivot = katana::make_reducible(better, identity);
+
+  katana::do_all(
+      katana::iterate(state->graph),
+      [&](const GNode& n) {
+        if (!state->Assigned(n)) {
+          uint64_t product =
+              static_cast<uint64_t>(state->in_count[n]) * state->out_count[n];
+          pivot.update(DegreeNodePair{product, n});
+        }
+      },
+      katana::loopname("SCC-ChoosePivot"), katana::no_stats());
+
+  return pivot.reduce().second;
+}
+
+/// Assign the component of pivot: the unassigned nodes that the pivot both
+/// reaches and is reached from
+void
+ForwardBackward(SccState* state, GNode pivot) {
+  const Graph& graph = state->graph;
+  katana::Frontier current(graph.size());
+  katana::Frontier next(graph.size());
+
+  state->color[pivot] = pivot;
+  next.push(pivot);
+  while (!next.empty()) {
+    current.swap(next);
+    next.Reset(current.is_dense());
+    current.ForEach(
+        [&](const GNode& v) {
+          state->ForEachOut(v, [&](GNode w) {
+            if (!state->Assigned(w) &&
+                state->color[w].exchange(pivot) != pivot) {
+              next.push(w);
+            }
+          });
+        },
+        "SCC-Forward");
+    next.Adapt();
+  }
+
+  state->Claim(pivot, pivot);
+  next.Reset(false);
+  next.push(pivot);
+  while (!next.empty()) {
+    current.swap(next);
+    next.Reset(current.is_dense());
+    current.ForEach(
+        [&](const GNode& v) {
+          state->ForEachIn(v, [&](GNode u) {
+            if (state->color[u] == pivot && state->Claim(u, pivot)) {
+              next.push(u);
+            }
+          });
+        },
+        "SCC-Backward");
+    next.Adapt();
+  }
+
+  // Label the component with its smallest node like the other phases do
+  katana::GReduceMin<GNode> smallest;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (state->component[n] == pivot) {
+          smallest.update(n);
+        }
+      },
+      katana::loopname("SCC-ForwardBackwardMin"), katana::no_stats());
+  GNode label = smallest.reduce();
+  if (label != pivot) {
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          if (state->component[n] == pivot) {
+            state->component[n] = label;
+          }
+        },
+        katana::loopname("SCC-ForwardBackwardLabel"), katana::no_stats());
+  }
+}
+
+/// Assign the remaining nodes by rounds of trimming and coloring until
+/// every node is assigned
+void
+Coloring(SccState* state) {
+  const Graph& graph = state->graph;
+  katana::Frontier current(graph.size());
+  katana::Frontier next(graph.size());
+
+  while (!katana::IsCancelled()) {
+    Trim(state);
+
+    next.Reset(false);
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          if (!state->Assigned(n)) {
+            state->color[n] = n;
+            next.push(n);
+          }
+        },
+        katana::loopname("SCC-ColorInitial"), katana::no_stats());
+    next.Adapt();
+    if (next.empty()) {
+      return;
+    }
+
+    // The color of a node becomes the smallest node that reaches it
+    while (!next.empty()) {
+      current.swap(next);
+      next.Reset(current.is_dense());
+      current.ForEach(
+          [&](const GNode& v) {
+            GNode c = state->color[v].load(std::memory_order_relaxed);
+            state->ForEachOut(v, [&](GNode w) {
+              if (!state->Assigned(w) &&
+                  katana::atomicMin(state->color[w], c) > c) {
+                next.push(w);
+              }
+            });
+          },
+          "SCC-ColorPropagate");
+      next.Adapt();
+    }
+
+    // A node that kept its own color is the smallest node of its component,
+    // which holds the nodes of its color that reach it
+    next.Reset(false);
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          if (!state->Assigned(n) && state->color[n] == n) {
+            state->Claim(n, n);
+            next.push(n);
+          }
+        },
+        katana::loopname("SCC-ColorRoots"), katana::no_stats());
+    next.Adapt();
+
+    while (!next.empty()) {
+      current.swap(next);
+      next.Reset(current.is_dense());
+      current.ForEach(
+          [&](const GNode& v) {
+            GNode c = state->color[v].load(std::memory_order_relaxed);
+            state->ForEachIn(v, [&](GNode u) {
+              if (state->color[u] == c && state->Claim(u, c)) {
+                next.push(u);
+              }
+            });
+          },
+          "SCC-ColorBackward");
+      next.Adapt();
+    }
+  }
+}
+
+katana::Result<void>
+StronglyConnectedComponentsImpl(
+    Graph* graph, const katana::InEdgeIndex& in_index,
+    StronglyConnectedComponentsPlan plan) {
+  size_t approxNodeData = 4 * (graph->num_nodes() + graph->num_edges());
+  katana::EnsurePreallocated(8, approxNodeData);
+
+  SccState state(*graph, in_index);
+
+  katana::StatTimer exec_time("StronglyConnectedComponents");
+  exec_time.start();
+
+  switch (plan.algorithm()) {
+  case StronglyConnectedComponentsPlan::kForwardBackward: {
+    Trim(&state);
+    if (GNode pivot = ChoosePivot(&state); pivot != kUnassigned) {
+      ForwardBackward(&state, pivot);
+    }
+    Coloring(&state);
+    break;
+  }
+  case StronglyConnectedComponentsPlan::kColoring:
+    Coloring(&state);
+    break;
+  default:
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  exec_time.stop();
+
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& n) {
+        graph->GetData<NodeComponent>(n) =
+            state.component[n].load(std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponents(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    StronglyConnectedComponentsPlan plan) {
+  auto in_index_res = pg->GetInEdgeIndex();
+  if (!in_index_res) {
+    return in_index_res.error();
+  }
+  std::shared_ptr<const katana::InEdgeIndex> in_index =
+      std::move(in_index_res.value());
+
+  if (auto result = ConstructNodeProperties<NodeData>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  return StronglyConnectedComponentsImpl(&graph, *in_index, plan);
+}
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponentsAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto in_index_res = pg->GetInEdgeIndex();
+  if (!in_index_res) {
+    return in_index_res.error();
+  }
+  const katana::InEdgeIndex& in_index = *in_index_res.value();
+
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+  auto label = [&](GNode n) { return graph.GetData<NodeComponent>(n); };
+
+  // Every component is named after one of its own nodes
+  auto is_bad_label = [&](const GNode& n) {
+    ComponentType c = label(n);
+    if (c >= graph.size() || label(c) != c) {
+      KATANA_LOG_DEBUG("{} has component {}, which is not a member", n, c);
+      return true;
+    }
+    return false;
+  };
+  if (katana::ParallelSTL::find_if(graph.begin(), graph.end(), is_bad_label) !=
+      graph.end()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  // Every component is strongly connected: searching forward and backward
+  // from its representative within the component reaches all its nodes
+  for (bool forward : {true, false}) {
+    katana::DynamicBitset reached;
+    reached.resize(graph.size());
+    katana::Frontier current(graph.size());
+    katana::Frontier next(graph.size());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          if (label(n) == n) {
+            reached.set(n);
+            next.push(n);
+          }
+        },
+        katana::no_stats());
+    next.Adapt();
+    while (!next.empty()) {
+      current.swap(next);
+      next.Reset(current.is_dense());
+      current.ForEach([&](const GNode& v) {
+        auto visit = [&](GNode u) {
+          if (label(u) == label(v) && !reached.set(u)) {
+            next.push(u);
+          }
+        };
+        if (forward) {
+          for (auto e : graph.edges(v)) {
+            visit(*graph.GetEdgeDest(e));
+          }
+        } else {
+          for (auto e : in_index.in_edges(v)) {
+            visit(in_index.in_edge_src(e));
+          }
+        }
+      });
+      next.Adapt();
+    }
+    if (reached.count() != graph.size()) {
+      KATANA_LOG_DEBUG(
+          "{} nodes are not strongly connected to their component",
+          graph.size() - reached.count());
+      return katana::ErrorCode::AssertionFailed;
+    }
+  }
+
+  // Components are maximal: the graph of components is acyclic, so a
+  // topological sort of it visits every component
+  std::vector<GNode> members(graph.size());
+  std::iota(members.begin(), members.end(), GNode{0});
+  katana::ParallelSTL::radix_sort(
+      members.begin(), members.end(), [&](GNode n) { return label(n); });
+  katana::LargeArray<uint64_t> first_member;
+  katana::LargeArray<std::atomic<uint64_t>> cross_in_edges;
+  first_member.allocateBlocked(graph.size());
+  cross_in_edges.allocateBlocked(graph.size());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{graph.size()}),
+      [&](uint64_t i) {
+        new (&cross_in_edges[i]) std::atomic<uint64_t>(0);
+        if (i == 0 || label(members[i]) != label(members[i - 1])) {
+          first_member[label(members[i])] = i;
+        }
+      },
+      katana::no_stats());
+
+  auto for_each_cross_edge = [&](GNode rep, auto fn) {
+    for (uint64_t i = first_member[rep];
+         i < members.size() && label(members[i]) == rep; ++i) {
+      for (auto e : graph.edges(members[i])) {
+        ComponentType c = label(*graph.GetEdgeDest(e));
+        if (c != rep) {
+          fn(c);
+        }
+      }
+    }
+  };
+
+  katana::GAccumulator<uint64_t> num_components;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (label(n) == n) {
+          num_components += 1;
+          for_each_cross_edge(n, [&](ComponentType c) {
+            cross_in_edges[c].fetch_add(1, std::memory_order_relaxed);
+          });
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::Frontier current(graph.size());
+  katana::Frontier next(graph.size());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (label(n) == n && cross_in_edges[n] == 0) {
+          next.push(n);
+        }
+      },
+      katana::no_stats());
+  next.Adapt();
+
+  katana::GAccumulator<uint64_t> num_sorted;
+  while (!next.empty()) {
+    current.swap(next);
+    next.Reset(current.is_dense());
+    current.ForEach([&](const GNode& rep) {
+      num_sorted += 1;
+      for_each_cross_edge(rep, [&](ComponentType c) {
+        if (cross_in_edges[c].fetch_sub(1) == 1) {
+          next.push(c);
+        }
+      });
+    });
+    next.Adapt();
+  }
+
+  if (num_sorted.reduce() != num_components.reduce()) {
+    KATANA_LOG_DEBUG(
+        "{} components are on a cycle with another component",
+        num_components.reduce() - num_sorted.reduce());
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<StronglyConnectedComponentsStatistics>
+katana::analytics::StronglyConnectedComponentsStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+
+  auto graph = pg_result.value();
+
+  auto components = katana::ParallelSTL::group_by(
+      graph.begin(), graph.end(), [&](const GNode& x) {
+        return graph.template GetData<NodeComponent>(x);
+      });
+
+  katana::GAccumulator<uint64_t> non_trivial_components;
+  katana::GReduceMax<uint64_t> largest_component_size;
+  katana::do_all(katana::iterate(components), [&](const auto& x) {
+    largest_component_size.update(x.count);
+    if (x.count > 1) {
+      non_trivial_components += 1;
+    }
+  });
+
+  uint64_t largest = largest_component_size.reduce();
+  double largest_component_ratio = 0;
+  if (!graph.empty()) {
+    largest_component_ratio = double(largest) / graph.size();
+  }
+
+  return StronglyConnectedComponentsStatistics{
+      components.size(), non_trivial_components.reduce(), largest,
+      largest_component_ratio};
+}
+
+void
+katana::analytics::StronglyConnectedComponentsStatistics::Print(
+    std::ostream& os) const {
+  os << "Total number of components = " << total_components << std::endl;
+  os << "Total number of non trivial components = "
+     << total_non_trivial_components << std::endl;
+  os << "Number of nodes in the largest component = " << largest_component_size
+     << std::endl;
+  os << "Ratio of nodes in the largest component = " << largest_component_ratio
+     << std::endl;
+}
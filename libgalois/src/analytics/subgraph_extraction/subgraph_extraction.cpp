@@ -19,8 +19,15 @@
 
 #include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
 
-#include <iostream>
+#include <utility>
 
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
@@ -28,22 +35,71 @@
 namespace {
 
 using namespace katana::analytics;
-using edge_iterator = boost::counting_iterator<uint64_t>;
 
-katana::Result<std::unique_ptr<katana::PropertyGraph>>
-SubGraphNodeSet(
-    katana::PropertyGraph* graph, const std::vector<uint32_t>& node_set) {
-  auto subgraph = std::make_unique<katana::PropertyGraph>();
-  if (node_set.empty()) {
-    return std::unique_ptr<katana::PropertyGraph>(std::move(subgraph));
+/// The topology of a sub-graph, with the id in the original graph of each of
+/// its edges
+struct SubGraphTopology {
+  std::shared_ptr<arrow::UInt64Array> out_indices;
+  std::shared_ptr<arrow::UInt32Array> out_dests;
+  std::shared_ptr<arrow::UInt64Array> edge_ids;
+};
+
+template <typename ArrowArray>
+katana::Result<std::shared_ptr<ArrowArray>>
+AllocateArray(uint64_t length) {
+  using CType = typename ArrowArray::TypeClass::c_type;
+  auto buffer_res = arrow::AllocateBuffer(length * sizeof(CType));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} values: {}", length,
+        buffer_res.status());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  return std::make_shared<ArrowArray>(length, buffer);
+}
+
+template <typename ArrowArray>
+auto*
+MutableValues(const std::shared_ptr<ArrowArray>& array) {
+  using CType = typename ArrowArray::TypeClass::c_type;
+  return reinterpret_cast<CType*>(array->values()->mutable_data());
+}
+
+/// Allocates the topology of a sub-graph with the given out indices, leaving
+/// its destinations and edge ids to be filled
+katana::Result<SubGraphTopology>
+AllocateTopology(std::shared_ptr<arrow::UInt64Array> out_indices) {
+  uint64_t num_nodes = out_indices->length();
+  uint64_t num_edges = num_nodes == 0 ? 0 : out_indices->Value(num_nodes - 1);
+  auto dests_res = AllocateArray<arrow::UInt32Array>(num_edges);
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  auto edge_ids_res = AllocateArray<arrow::UInt64Array>(num_edges);
+  if (!edge_ids_res) {
+    return edge_ids_res.error();
   }
+  return SubGraphTopology{
+      .out_indices = std::move(out_indices),
+      .out_dests = std::move(dests_res.value()),
+      .edge_ids = std::move(edge_ids_res.value()),
+  };
+}
 
+katana::Result<SubGraphTopology>
+SubGraphNodeSet(
+    katana::PropertyGraph* graph, const std::vector<uint32_t>& node_set) {
   uint64_t num_nodes = node_set.size();
-  // Subgraph topology : out indices
-  auto out_indices = std::make_unique<katana::LargeArray<uint64_t>>();
-  out_indices->allocateInterleaved(num_nodes);
+  auto indices_res = AllocateArray<arrow::UInt64Array>(num_nodes);
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto out_indices = std::move(indices_res.value());
+  uint64_t* indices = MutableValues(out_indices);
 
-  katana::gstl::Vector<katana::gstl::Vector<uint32_t>> subgraph_edges;
+  // The destination in the sub-graph and the id of each edge
+  katana::gstl::Vector<katana::gstl::Vector<std::pair<uint32_t, uint64_t>>>
+      subgraph_edges;
   subgraph_edges.resize(num_nodes);
 
   katana::do_all(
@@ -57,93 +113,249 @@ SubGraphNodeSet(
           // Binary search on the edges sorted by destination id
           auto edge_id = katana::FindEdgeSortedByDest(graph, src, dest);
           while (edge_id != *last && *graph->GetEdgeDest(edge_id) == dest) {
-            subgraph_edges[n].push_back(m);
+            subgraph_edges[n].emplace_back(m, edge_id);
             edge_id++;
           }
         }
-        (*out_indices)[n] = subgraph_edges[n].size();
+        indices[n] = subgraph_edges[n].size();
       },
       katana::steal(), katana::no_stats(),
       katana::loopname("SubgraphExtraction"));
 
-  // Prefix sum
-  for (uint64_t i = 1; i < num_nodes; ++i) {
-    (*out_indices)[i] += (*out_indices)[i - 1];
-  }
-  uint64_t num_edges = (*out_indices)[num_nodes - 1];
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
 
-  // Subgraph topology : out dests
-  auto out_dests = std::make_unique<katana::LargeArray<uint32_t>>();
-  out_dests->allocateInterleaved(num_edges);
+  auto topology_res = AllocateTopology(std::move(out_indices));
+  if (!topology_res) {
+    return topology_res.error();
+  }
+  SubGraphTopology topology = std::move(topology_res.value());
+  uint32_t* dests = MutableValues(topology.out_dests);
+  uint64_t* edge_ids = MutableValues(topology.edge_ids);
 
   katana::do_all(
       katana::iterate(uint32_t(0), uint32_t(num_nodes)),
       [&](const uint32_t& n) {
-        uint64_t offset = n == 0 ? 0 : (*out_indices)[n - 1];
-        for (uint32_t dest : subgraph_edges[n]) {
-          (*out_dests)[offset] = dest;
+        uint64_t offset = n == 0 ? 0 : indices[n - 1];
+        for (const auto& [dest, edge_id] : subgraph_edges[n]) {
+          dests[offset] = dest;
+          edge_ids[offset] = edge_id;
           offset++;
         }
       },
       katana::no_stats(), katana::loopname("ConstructTopology"));
 
-  // TODO(amp): The pattern out_indices.release()->data() is leaking both the
-  //  LargeBuffer instance (just a few bytes), AND the buffer itself. The
-  //  instance is leaking because of the call to release without passing
-  //  ownership of the instance to some other object. The buffer is leaking
-  //  because arrow::MutableBuffer does not own it's data, so it will never
-  //  deallocate the buffer passed to arrow::MutableBuffer::Wrap.
-  //  This pattern probably exists elsewhere in the code.
-
-  // Set new topology
-  auto numeric_array_out_indices =
-      std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
-          static_cast<int64_t>(num_nodes),
-          arrow::MutableBuffer::Wrap(out_indices.release()->data(), num_nodes));
-
-  auto numeric_array_out_dests =
-      std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
-          static_cast<int64_t>(num_edges),
-          arrow::MutableBuffer::Wrap(out_dests.release()->data(), num_edges));
+  return topology;
+}
+
+/// The edges of the node set are found by one scan of the edges of each node
+/// of the set: a bitmap of the set filters the destinations, and only those
+/// in the set look up their id in the sub-graph. A first pass counts the
+/// edges of each node, their prefix sum places them, and a second pass
+/// writes them.
+katana::Result<SubGraphTopology>
+SubGraphNodeSetScan(
+    katana::PropertyGraph* graph, const std::vector<uint32_t>& node_set,
+    const katana::DynamicBitset& in_set) {
+  const katana::GraphTopology& topology = graph->topology();
+  uint64_t num_nodes = node_set.size();
+
+  // Entries of nodes out of the set are never read
+  katana::LargeArray<uint32_t> new_ids;
+  new_ids.allocateBlocked(topology.num_nodes());
+  katana::do_all(
+      katana::iterate(uint32_t(0), uint32_t(num_nodes)),
+      [&](const uint32_t& n) { new_ids[node_set[n]] = n; },
+      katana::no_stats());
+
+  auto indices_res = AllocateArray<arrow::UInt64Array>(num_nodes);
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  auto out_indices = std::move(indices_res.value());
+  uint64_t* indices = MutableValues(out_indices);
+
+  katana::do_all(
+      katana::iterate(uint32_t(0), uint32_t(num_nodes)),
+      [&](const uint32_t& n) {
+        uint64_t count = 0;
+        for (auto e : topology.edges(node_set[n])) {
+          count += in_set.test(topology.edge_dest(e));
+        }
+        indices[n] = count;
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("SubgraphExtractionCount"));
+
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+
+  auto sub_topology_res = AllocateTopology(std::move(out_indices));
+  if (!sub_topology_res) {
+    return sub_topology_res.error();
+  }
+  SubGraphTopology sub_topology = std::move(sub_topology_res.value());
+  uint32_t* dests = MutableValues(sub_topology.out_dests);
+  uint64_t* edge_ids = MutableValues(sub_topology.edge_ids);
+
+  katana::do_all(
+      katana::iterate(uint32_t(0), uint32_t(num_nodes)),
+      [&](const uint32_t& n) {
+        uint64_t offset = n == 0 ? 0 : indices[n - 1];
+        for (auto e : topology.edges(node_set[n])) {
+          uint32_t dest = topology.edge_dest(e);
+          if (in_set.test(dest)) {
+            dests[offset] = new_ids[dest];
+            edge_ids[offset] = e;
+            offset++;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("SubgraphExtractionFill"));
+
+  return sub_topology;
+}
+
+/// The named properties of props, at the given rows
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeProperties(
+    const std::shared_ptr<arrow::Table>& props,
+    const std::vector<std::string>& names,
+    const std::shared_ptr<arrow::Array>& rows) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const std::string& name : names) {
+    int i = props->schema()->GetFieldIndex(name);
+    if (i < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no property {}", name);
+    }
+    auto take_res = arrow::compute::Take(
+        arrow::Datum(props->column(i)), arrow::Datum(rows));
+    if (!take_res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(take_res.status()), "taking {}: {}", name,
+          take_res.status());
+    }
+    fields.emplace_back(props->field(i));
+    columns.emplace_back(take_res.ValueOrDie().chunked_array());
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
 
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+MakeSubGraph(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& node_set,
+    const SubGraphTopology& topology,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy) {
+  auto subgraph = std::make_unique<katana::PropertyGraph>();
   if (auto r = subgraph->SetTopology(katana::GraphTopology{
-          .out_indices = std::move(numeric_array_out_indices),
-          .out_dests = std::move(numeric_array_out_dests),
+          .out_indices = topology.out_indices,
+          .out_dests = topology.out_dests,
       });
       !r) {
     return r.error();
   }
 
+  if (!node_properties_to_copy.empty()) {
+    auto rows_res = AllocateArray<arrow::UInt32Array>(node_set.size());
+    if (!rows_res) {
+      return rows_res.error();
+    }
+    std::copy(
+        node_set.begin(), node_set.end(), MutableValues(rows_res.value()));
+    auto props_res = TakeProperties(
+        pg->node_properties(), node_properties_to_copy, rows_res.value());
+    if (!props_res) {
+      return props_res.error().WithContext("copying node properties");
+    }
+    if (auto r = subgraph->AddNodeProperties(props_res.value()); !r) {
+      return r.error();
+    }
+  }
+
+  if (!edge_properties_to_copy.empty()) {
+    auto props_res = TakeProperties(
+        pg->edge_properties(), edge_properties_to_copy, topology.edge_ids);
+    if (!props_res) {
+      return props_res.error().WithContext("copying edge properties");
+    }
+    if (auto r = subgraph->AddEdgeProperties(props_res.value()); !r) {
+      return r.error();
+    }
+  }
+
   return std::unique_ptr<katana::PropertyGraph>(std::move(subgraph));
 }
+
 }  // namespace
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::analytics::SubGraphExtraction(
     katana::PropertyGraph* pg, const std::vector<uint32_t>& node_vec,
     SubGraphExtractionPlan plan) {
-  if (auto r = katana::SortAllEdgesByDest(pg); !r) {
-    return r.error();
-  }
+  return SubGraphExtraction(pg, node_vec, {}, {}, plan);
+}
 
-  // Remove duplicates from the node vector
-  std::unordered_set<uint32_t> set;
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& node_vec,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    SubGraphExtractionPlan plan) {
+  // Remove duplicates from the node vector, keeping the first of each
+  katana::DynamicBitset in_set;
+  in_set.resize(pg->num_nodes());
   std::vector<uint32_t> dedup_node_vec;
   for (auto n : node_vec) {
-    if (set.insert(n).second) {  // If n wasn't already present.
+    if (n >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "node {} is not in the graph", n);
+    }
+    if (!in_set.test(n)) {
+      in_set.set(n);
       dedup_node_vec.push_back(n);
     }
   }
 
   katana::StatTimer execTime("SubGraph-Extraction");
+  katana::Result<SubGraphTopology> topology = ErrorCode::InvalidArgument;
   switch (plan.algorithm()) {
   case SubGraphExtractionPlan::kNodeSet: {
+    // The sort leaves the edge properties in place, so edge ids are mapped
+    // back through its permutation
+    auto permutation_res = katana::SortAllEdgesByDest(pg);
+    if (!permutation_res) {
+      return permutation_res.error();
+    }
+    auto permutation = std::move(permutation_res.value());
     execTime.start();
-    auto subgraph = SubGraphNodeSet(pg, dedup_node_vec);
+    topology = SubGraphNodeSet(pg, dedup_node_vec);
     execTime.stop();
-    return std::move(subgraph.value());
+    if (topology) {
+      const auto& edge_id_array = topology.value().edge_ids;
+      uint64_t* edge_ids = MutableValues(edge_id_array);
+      katana::do_all(
+          katana::iterate(uint64_t{0}, uint64_t(edge_id_array->length())),
+          [&](uint64_t e) { edge_ids[e] = permutation->Value(edge_ids[e]); },
+          katana::no_stats());
+    }
+    break;
+  }
+  case SubGraphExtractionPlan::kNodeSetScan: {
+    execTime.start();
+    topology = SubGraphNodeSetScan(pg, dedup_node_vec, in_set);
+    execTime.stop();
+    break;
   }
   default:
     return katana::ErrorCode::InvalidArgument;
   }
+  if (!topology) {
+    return topology.error();
+  }
+
+  return MakeSubGraph(
+      pg, dedup_node_vec, topology.value(), node_properties_to_copy,
+      edge_properties_to_copy);
 }
@@ -0,0 +1,405 @@
+#include "katana/analytics/subgraph_match/subgraph_match.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Cancellation.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using TypeSet = katana::PropertyGraph::SetOfTypeSetIDs;
+
+constexpr uint32_t kMaxNodes = SubgraphPattern::kMaxNodes;
+constexpr uint32_t kChunkSize = 16;
+
+/// The sorted, distinct neighbors of every node in one direction through
+/// the edges of one type
+struct Adjacency {
+  katana::LargeArray<uint64_t> begins;
+  katana::LargeArray<uint64_t> ends;
+  katana::LargeArray<Node> neighbors;
+
+  const Node* begin(Node n) const { return &neighbors[begins[n]]; }
+  const Node* end(Node n) const { return &neighbors[ends[n]]; }
+};
+
+/// Build the adjacency of the edges of pg whose TypeSetID is in types, or of
+/// all edges if types is null, from sources to destinations or, if in_edges
+/// is not null, from destinations to sources
+std::unique_ptr<Adjacency>
+MakeAdjacency(
+    const katana::PropertyGraph& pg, const katana::InEdgeIndex* in_edges,
+    const TypeSet* types) {
+  const katana::GraphTopology& topology =
+      in_edges ? in_edges->topology : pg.topology();
+  const uint64_t num_nodes = topology.num_nodes();
+  const Node* dests = topology.edge_dests();
+  auto matches = [&](Edge e) {
+    return !types || types->test(pg.GetEdgeTypeSetID(
+                         in_edges ? in_edges->out_edge_id(e) : e));
+  };
+
+  auto adjacency = std::make_unique<Adjacency>();
+  adjacency->begins.allocateBlocked(num_nodes + 1);
+  adjacency->ends.allocateBlocked(num_nodes);
+  uint64_t* begins = adjacency->begins.data();
+  begins[0] = 0;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        auto edges = topology.edges(n);
+        begins[n + 1] = std::count_if(edges.begin(), edges.end(), matches);
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      begins + 1, begins + num_nodes + 1, begins + 1);
+
+  adjacency->neighbors.allocateBlocked(begins[num_nodes]);
+  Node* neighbors = adjacency->neighbors.data();
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        Node* out = &neighbors[begins[n]];
+        Node* end = out;
+        for (Edge e : topology.edges(n)) {
+          if (matches(e)) {
+            *end++ = dests[e];
+          }
+        }
+        std::sort(out, end);
+        adjacency->ends[n] = std::unique(out, end) - neighbors;
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("SubgraphMatchAdjacency"));
+  return adjacency;
+}
+
+/// Where the candidates for a pattern node are found: among the neighbors
+/// of the node matched at an earlier position
+struct Constraint {
+  uint32_t position;
+  const Adjacency* adjacency;
+};
+
+/// A pattern compiled for one graph: the order in which its nodes are
+/// matched and, for each position of that order, the types of the nodes
+/// matched there and the constraints on them
+struct CompiledPattern {
+  uint32_t num_nodes{};
+  std::array<uint32_t, kMaxNodes> order{};
+  std::array<const TypeSet*, kMaxNodes> node_types{};
+  std::array<std::vector<Constraint>, kMaxNodes> constraints;
+  /// Whether some type of the pattern is not in the graph, so that nothing
+  /// matches
+  bool empty{false};
+  std::vector<std::unique_ptr<Adjacency>> adjacencies;
+};
+
+/// Order the nodes of pattern so that each is connected to those before it,
+/// starting from the one with the most edges and then taking the one with
+/// the most edges to the nodes already ordered
+katana::Result<std::array<uint32_t, kMaxNodes>>
+OrderNodes(const SubgraphPattern& pattern) {
+  uint32_t num_nodes = pattern.num_nodes();
+  std::array<uint32_t, kMaxNodes> degree{};
+  for (const auto& edge : pattern.edges()) {
+    ++degree[edge.src];
+    ++degree[edge.dst];
+  }
+  std::array<uint32_t, kMaxNodes> order{};
+  std::array<bool, kMaxNodes> ordered{};
+  for (uint32_t position = 0; position < num_nodes; ++position) {
+    std::array<uint32_t, kMaxNodes> links{};
+    for (const auto& edge : pattern.edges()) {
+      if (ordered[edge.src] != ordered[edge.dst]) {
+        ++links[ordered[edge.src] ? edge.dst : edge.src];
+      }
+    }
+    uint32_t best = num_nodes;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      if (ordered[n] || (position > 0 && links[n] == 0)) {
+        continue;
+      }
+      if (best == num_nodes ||
+          std::make_pair(links[n], degree[n]) >
+              std::make_pair(links[best], degree[best])) {
+        best = n;
+      }
+    }
+    if (best == num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "pattern is not connected");
+    }
+    order[position] = best;
+    ordered[best] = true;
+  }
+  return order;
+}
+
+katana::Result<std::unique_ptr<CompiledPattern>>
+Compile(katana::PropertyGraph* pg, const SubgraphPattern& pattern) {
+  const uint32_t num_nodes = pattern.num_nodes();
+  if (num_nodes == 0 || num_nodes > kMaxNodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "pattern must have between 1 and {} nodes", kMaxNodes);
+  }
+  for (const auto& edge : pattern.edges()) {
+    if (edge.src >= num_nodes || edge.dst >= num_nodes ||
+        edge.src == edge.dst) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "bad pattern edge ({}, {})",
+          edge.src, edge.dst);
+    }
+  }
+  auto order_result = OrderNodes(pattern);
+  if (!order_result) {
+    return order_result.error();
+  }
+
+  auto plan = std::make_unique<CompiledPattern>();
+  plan->num_nodes = num_nodes;
+  plan->order = order_result.value();
+  std::array<uint32_t, kMaxNodes> position_of{};
+  for (uint32_t position = 0; position < num_nodes; ++position) {
+    position_of[plan->order[position]] = position;
+    const std::string& type = pattern.node_types()[plan->order[position]];
+    if (type.empty()) {
+      continue;
+    }
+    if (!pg->HasNodeType(type)) {
+      plan->empty = true;
+      return plan;
+    }
+    plan->node_types[position] = &pg->NodeTypeNameToTypeSetIDs(type);
+  }
+
+  std::shared_ptr<const katana::InEdgeIndex> in_edges;
+  // The adjacency of each direction (in-edges or not) and edge type
+  std::map<std::pair<bool, std::string>, const Adjacency*> adjacencies;
+  for (const auto& edge : pattern.edges()) {
+    // The end of the edge matched later is constrained by the other
+    bool inward = position_of[edge.src] > position_of[edge.dst];
+    uint32_t earlier = inward ? edge.dst : edge.src;
+    uint32_t later = inward ? edge.src : edge.dst;
+    if (!edge.type.empty() && !pg->HasEdgeType(edge.type)) {
+      plan->empty = true;
+      return plan;
+    }
+
+    auto& adjacency = adjacencies[{inward, edge.type}];
+    if (!adjacency) {
+      if (inward && !in_edges) {
+        auto in_edges_result = pg->GetInEdgeIndex();
+        if (!in_edges_result) {
+          return in_edges_result.error();
+        }
+        in_edges = in_edges_result.value();
+      }
+      plan->adjacencies.emplace_back(MakeAdjacency(
+          *pg, inward ? in_edges.get() : nullptr,
+          edge.type.empty() ? nullptr
+                            : &pg->EdgeTypeNameToTypeSetIDs(edge.type)));
+      adjacency = plan->adjacencies.back().get();
+    }
+    plan->constraints[position_of[later]].emplace_back(
+        Constraint{position_of[earlier], adjacency});
+  }
+  return plan;
+}
+
+/// A match of the nodes of the pattern up to a position of its order
+struct PartialMatch {
+  std::array<Node, kMaxNodes> nodes;
+  uint32_t size;
+};
+
+struct Scratch {
+  /// The candidates at each position
+  std::array<std::vector<Node>, kMaxNodes> candidates;
+  std::vector<Node> intersection;
+  std::vector<std::pair<const Node*, const Node*>> lists;
+  std::array<Node, kMaxNodes> match;
+};
+
+template <bool Visit>
+class Matcher {
+public:
+  Matcher(
+      const katana::PropertyGraph& pg, const CompiledPattern& plan,
+      const SubgraphMatchCallback& callback, uint32_t split_depth)
+      : pg_(pg), plan_(plan), callback_(callback), split_depth_(split_depth) {}
+
+  uint64_t Run() {
+    katana::InsertBag<PartialMatch> roots;
+    katana::do_all(
+        katana::iterate(pg_.topology()),
+        [&](Node n) {
+          if (HasType(0, n)) {
+            PartialMatch root{};
+            root.nodes[0] = n;
+            root.size = 1;
+            roots.push(root);
+          }
+        },
+        katana::no_stats());
+
+    katana::for_each(
+        katana::iterate(roots),
+        [&](const PartialMatch& partial, auto& ctx) {
+          if (katana::IsCancelled()) {
+            return;
+          }
+          Scratch& scratch = *scratch_.getLocal();
+          std::copy_n(
+              partial.nodes.begin(), partial.size, scratch.match.begin());
+          if (partial.size >= split_depth_ ||
+              partial.size == plan_.num_nodes) {
+            Extend(partial.size, &scratch);
+            return;
+          }
+          FindCandidates(partial.size, &scratch);
+          PartialMatch child = partial;
+          child.size = partial.size + 1;
+          for (Node n : scratch.candidates[partial.size]) {
+            child.nodes[partial.size] = n;
+            ctx.push(child);
+          }
+        },
+        katana::disable_conflict_detection(),
+        katana::wl<katana::PerSocketChunkLIFO<kChunkSize>>(),
+        katana::loopname("SubgraphMatch"));
+    return num_matches_.reduce();
+  }
+
+private:
+  bool HasType(uint32_t position, Node n) const {
+    const TypeSet* types = plan_.node_types[position];
+    return !types || types->test(pg_.GetNodeTypeSetID(n));
+  }
+
+  /// Set scratch->candidates[position] to the nodes that may be matched at
+  /// position given scratch->match up to it
+  void FindCandidates(uint32_t position, Scratch* scratch) const {
+    auto& lists = scratch->lists;
+    lists.clear();
+    for (const Constraint& c : plan_.constraints[position]) {
+      Node n = scratch->match[c.position];
+      lists.emplace_back(c.adjacency->begin(n), c.adjacency->end(n));
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) {
+      return a.second - a.first < b.second - b.first;
+    });
+
+    auto& candidates = scratch->candidates[position];
+    candidates.assign(lists[0].first, lists[0].second);
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+      scratch->intersection.clear();
+      std::set_intersection(
+          candidates.begin(), candidates.end(), lists[i].first,
+          lists[i].second, std::back_inserter(scratch->intersection));
+      std::swap(candidates, scratch->intersection);
+    }
+
+    const Node* matched = scratch->match.data();
+    auto rejected = [&](Node n) {
+      return !HasType(position, n) ||
+             std::find(matched, matched + position, n) != matched + position;
+    };
+    candidates.erase(
+        std::remove_if(candidates.begin(), candidates.end(), rejected),
+        candidates.end());
+  }
+
+  /// Extend scratch->match from position to every full match, depth first
+  void Extend(uint32_t position, Scratch* scratch) {
+    if (position == plan_.num_nodes) {
+      Emit(scratch->match.data());
+      return;
+    }
+    FindCandidates(position, scratch);
+    if (position + 1 == plan_.num_nodes && !Visit) {
+      num_matches_ += scratch->candidates[position].size();
+      return;
+    }
+    // The candidates of later positions go to their own vectors
+    for (size_t i = 0; i < scratch->candidates[position].size(); ++i) {
+      scratch->match[position] = scratch->candidates[position][i];
+      Extend(position + 1, scratch);
+    }
+  }
+
+  void Emit(const Node* match) {
+    num_matches_ += 1;
+    if constexpr (Visit) {
+      std::array<Node, kMaxNodes> by_pattern_node;
+      for (uint32_t position = 0; position < plan_.num_nodes; ++position) {
+        by_pattern_node[plan_.order[position]] = match[position];
+      }
+      callback_(by_pattern_node.data());
+    }
+  }
+
+  const katana::PropertyGraph& pg_;
+  const CompiledPattern& plan_;
+  const SubgraphMatchCallback& callback_;
+  uint32_t split_depth_;
+  katana::PerThreadStorage<Scratch> scratch_;
+  katana::GAccumulator<uint64_t> num_matches_;
+};
+
+template <bool Visit>
+katana::Result<uint64_t>
+Match(
+    katana::PropertyGraph* pg, const SubgraphPattern& pattern,
+    const SubgraphMatchCallback& callback, const SubgraphMatchPlan& plan) {
+  if (plan.algorithm() != SubgraphMatchPlan::kGenericJoin) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  auto compiled_result = Compile(pg, pattern);
+  if (!compiled_result) {
+    return compiled_result.error();
+  }
+  const CompiledPattern& compiled = *compiled_result.value();
+  if (compiled.empty) {
+    return 0;
+  }
+
+  Matcher<Visit> matcher(
+      *pg, compiled, callback, std::max(plan.split_depth(), 1U));
+  uint64_t num_matches = matcher.Run();
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+  return num_matches;
+}
+
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::SubgraphMatch(
+    katana::PropertyGraph* pg, const SubgraphPattern& pattern,
+    const SubgraphMatchCallback& callback, SubgraphMatchPlan plan) {
+  return Match<true>(pg, pattern, callback, plan);
+}
+
+katana::Result<uint64_t>
+katana::analytics::SubgraphMatchCount(
+    katana::PropertyGraph* pg, const SubgraphPattern& pattern,
+    SubgraphMatchPlan plan) {
+  return Match<false>(pg, pattern, nullptr, plan);
+}
@@ -19,6 +19,14 @@
 
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "katana/Cancellation.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/SetIntersection.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
@@ -28,6 +36,9 @@ using Node = katana::PropertyGraph::Node;
 
 constexpr static const unsigned kChunkSize = 64U;
 
+/// The number of colors of the first sample of SamplingAlgo
+constexpr static const uint32_t kMaxSampleColors = 64U;
+
 /**
  * Like std::lower_bound but doesn't dereference iterators. Returns the first
  * element for which comp is not true.
@@ -57,31 +68,6 @@ LowerBound(Iterator first, Iterator last, Compare comp) {
   return first;
 }
 
-/**
- * std::set_intersection over edge_iterators.
- */
-template <typename G>
-size_t
-CountEqual(
-    const G& g, typename G::edge_iterator aa, typename G::edge_iterator ea,
-    typename G::edge_iterator bb, typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::Node a = *g.GetEdgeDest(aa);
-    typename G::Node b = *g.GetEdgeDest(bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
-}
-
 template <typename G>
 struct LessThan {
   const G& g;
@@ -174,26 +160,21 @@ NodeIteratingAlgo(katana::PropertyGraph* graph) {
 void
 OrderedCountFunc(
     PropertyGraph* graph, Node n, katana::GAccumulator<size_t>& numTriangles) {
-  size_t numTriangles_local = 0;
-  for (auto it_v : graph->edges(n)) {
-    auto v = *graph->GetEdgeDest(it_v);
-    if (v > n) {
-      break;
-    }
-    PropertyGraph::edge_iterator it_n = graph->edges(n).begin();
+  const Node* dests = graph->topology().edge_dests();
+  auto n_edges = graph->edges(n);
+  const Node* n_begin = dests + *n_edges.begin();
+  const Node* n_end = dests + *n_edges.end();
 
-    for (auto it_vv : graph->edges(v)) {
-      auto vv = *graph->GetEdgeDest(it_vv);
-      if (vv > v) {
-        break;
-      }
-      while (*graph->GetEdgeDest(it_n) < vv) {
-        it_n++;
-      }
-      if (vv == *graph->GetEdgeDest(it_n)) {
-        numTriangles_local += 1;
-      }
-    }
+  size_t numTriangles_local = 0;
+  for (const Node* it_v = n_begin; it_v != n_end && *it_v <= n; ++it_v) {
+    Node v = *it_v;
+    auto v_edges = graph->edges(v);
+    const Node* v_begin = dests + *v_edges.begin();
+    const Node* v_end = std::upper_bound(v_begin, dests + *v_edges.end(), v);
+    // Only neighbors of n no larger than v can match
+    const Node* n_match_end = std::upper_bound(n_begin, n_end, v);
+    numTriangles_local += katana::CountSortedIntersection(
+        n_begin, n_match_end - n_begin, v_begin, v_end - v_begin);
   }
   numTriangles += numTriangles_local;
 }
@@ -268,7 +249,9 @@ EdgeIteratingAlgo(PropertyGraph* graph) {
         PropertyGraph::edge_iterator eb =
             LowerBound(bbegin, bend, LessThan<PropertyGraph>(*graph, w.dst));
 
-        numTriangles += CountEqual(*graph, aa, ea, bb, eb);
+        const Node* dests = graph->topology().edge_dests();
+        numTriangles += katana::CountSortedIntersection(
+            dests + *aa, ea - aa, dests + *bb, eb - bb);
       },
       katana::loopname("TriangleCount_EdgeIteratingAlgo"),
       katana::chunk_size<kChunkSize>(), katana::steal());
@@ -276,9 +259,177 @@ EdgeIteratingAlgo(PropertyGraph* graph) {
   return numTriangles.reduce();
 }
 
+/// \returns the color, out of \p colors, of node \p n in sample \p round
+uint32_t
+SampleColor(Node n, uint64_t round, uint32_t colors) {
+  // The splitmix64 finalizer
+  uint64_t x = (round << 32 | n) + 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x % colors;
+}
+
+/**
+ * Count the triangles whose nodes all have the same color, for each color.
+ * Only the edges between nodes of the same color are copied, each once, to
+ * the neighbor of smaller id, and each triangle is counted from its node of
+ * largest id.
+ */
+std::vector<uint64_t>
+CountMonochromaticTriangles(
+    const katana::GraphTopology& topology, uint64_t round, uint32_t colors) {
+  uint64_t num_nodes = topology.num_nodes();
+  const Node* dests = topology.edge_dests();
+  auto for_each_sampled = [&](Node n, auto fn) {
+    uint32_t color = SampleColor(n, round, colors);
+    for (auto e : topology.edges(n)) {
+      Node dst = dests[e];
+      if (dst < n && SampleColor(dst, round, colors) == color) {
+        fn(dst);
+      }
+    }
+  };
+
+  std::vector<uint64_t> sizes(num_nodes);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) { for_each_sampled(n, [&](Node) { ++sizes[n]; }); },
+      katana::steal(), katana::no_stats());
+  std::vector<uint64_t> offsets(num_nodes + 1);
+  katana::ParallelSTL::partial_sum(
+      sizes.begin(), sizes.end(), offsets.begin() + 1);
+
+  std::vector<Node> sample(offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        uint64_t pos = offsets[n];
+        for_each_sampled(n, [&](Node dst) { sample[pos++] = dst; });
+        std::sort(sample.begin() + offsets[n], sample.begin() + pos);
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::PerThreadStorage<std::vector<uint64_t>> per_thread_counts;
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node u) {
+        const Node* u_begin = sample.data() + offsets[u];
+        size_t u_size = offsets[u + 1] - offsets[u];
+        uint64_t count = 0;
+        for (size_t i = 0; i < u_size; ++i) {
+          Node v = u_begin[i];
+          count += katana::CountSortedIntersection(
+              u_begin, u_size, sample.data() + offsets[v],
+              offsets[v + 1] - offsets[v]);
+        }
+        if (count != 0) {
+          std::vector<uint64_t>& counts = *per_thread_counts.getLocal();
+          counts.resize(colors);
+          counts[SampleColor(u, round, colors)] += count;
+        }
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("TriangleCount_SamplingAlgo"));
+
+  std::vector<uint64_t> by_color(colors);
+  for (unsigned i = 0; i < katana::getActiveThreads(); ++i) {
+    const std::vector<uint64_t>& counts = *per_thread_counts.getRemote(i);
+    for (size_t c = 0; c < counts.size(); ++c) {
+      by_color[c] += counts[c];
+    }
+  }
+  return by_color;
+}
+
+/**
+ * Colorful triangle counting with a shrinking number of colors. With c
+ * colors, a triangle has all nodes of color k with probability 1/c^3, so
+ * each color gives an estimate c^3 T_k and their mean is the estimate of
+ * the sample. The sample variance of the color estimates over c is the
+ * variance of the mean, and by Chebyshev's inequality the mean is within
+ * sqrt(variance / (1 - confidence)) of the count with probability
+ * confidence.
+ */
+katana::Result<TriangleCountEstimate>
+SamplingAlgo(
+    const katana::GraphTopology& topology, const TriangleCountPlan& plan) {
+  if (!(plan.relative_error() > 0) ||
+      !(plan.confidence() > 0 && plan.confidence() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "relative error {} must be positive and confidence {} in (0, 1)",
+        plan.relative_error(), plan.confidence());
+  }
+  double failure = 1 - plan.confidence();
+
+  uint64_t round = 0;
+  for (uint32_t colors = kMaxSampleColors;; colors /= 2, ++round) {
+    std::vector<uint64_t> by_color =
+        CountMonochromaticTriangles(topology, round, colors);
+    if (katana::IsCancelled()) {
+      return katana::ErrorCode::Cancelled;
+    }
+
+    double scale = std::pow(static_cast<double>(colors), 3);
+    double mean = 0;
+    for (uint64_t count : by_color) {
+      mean += scale * count;
+    }
+    mean /= colors;
+    if (colors == 1) {
+      return TriangleCountEstimate{mean, 0, 1};
+    }
+
+    double squares = 0;
+    for (uint64_t count : by_color) {
+      squares += (scale * count - mean) * (scale * count - mean);
+    }
+    double variance = squares / (colors - 1) / colors;
+    if (mean > 0 &&
+        std::sqrt(variance / failure) <= plan.relative_error() * mean) {
+      return TriangleCountEstimate{mean, variance, colors};
+    }
+  }
+}
+
+void
+katana::analytics::TriangleCountEstimate::Print(std::ostream& os) const {
+  os << "Estimated triangles = " << estimate << std::endl;
+  os << "Variance = " << variance << std::endl;
+  os << "Sample colors = " << colors << std::endl;
+}
+
+katana::Result<TriangleCountEstimate>
+katana::analytics::EstimateTriangleCount(
+    katana::PropertyGraph* pg, TriangleCountPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (plan.algorithm() == TriangleCountPlan::kSampling) {
+    return SamplingAlgo(pg->topology(), plan);
+  }
+  auto count_res = TriangleCount(pg, plan);
+  if (!count_res) {
+    return count_res.error();
+  }
+  return TriangleCountEstimate{static_cast<double>(count_res.value()), 0, 1};
+}
+
 katana::Result<uint64_t>
 katana::analytics::TriangleCount(
     katana::PropertyGraph* pg, TriangleCountPlan plan) {
+  if (auto r = CheckArchitecture(plan); !r) {
+    return r.error();
+  }
+  if (plan.algorithm() == TriangleCountPlan::kSampling) {
+    auto estimate_res = SamplingAlgo(pg->topology(), plan);
+    if (!estimate_res) {
+      return estimate_res.error();
+    }
+    return std::llround(estimate_res.value().estimate);
+  }
+
   katana::StatTimer timer_graph_read("GraphReadingTime", "TriangleCount");
   katana::StatTimer timer_auto_algo("AutoRelabel", "TriangleCount");
 
@@ -322,7 +473,7 @@ katana::analytics::TriangleCount(
 
   // If we relabel we must also sort. Relabeling will break the sorting.
   if (relabel || !plan.edges_sorted()) {
-    if (auto r = katana::SortAllEdgesByDest(pg); !r) {
+    if (auto r = katana::EnsureAllEdgesSortedByDest(pg); !r) {
       return r.error();
     }
   }
@@ -352,5 +503,9 @@ katana::analytics::TriangleCount(
 
   katana::reportPageAlloc("TriangleCount_MeminfoPost");
 
+  if (katana::IsCancelled()) {
+    return katana::ErrorCode::Cancelled;
+  }
+
   return total_count;
 }
@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGALOIS_TESTTYPEDPROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_TESTTYPEDPROPERTYGRAPH_H_
 
+#include <string>
+#include <vector>
+
 #include <arrow/api.h>
 #include <arrow/type_traits.h>
 
@@ -105,6 +108,31 @@ MakeFileGraph(size_t num_nodes, size_t num_properties, Policy* policy) {
   return g;
 }
 
+/// NodePropertyValues copies the values of the node property name of a
+/// single-chunk numeric column out of a property graph.
+///
+/// \tparam ValueType is the type of column data
+template <typename ValueType>
+std::vector<ValueType>
+NodePropertyValues(katana::PropertyGraph* pg, const std::string& name) {
+  auto res = pg->GetNodePropertyTyped<ValueType>(name);
+  KATANA_LOG_VASSERT(res, "no property {}: {}", name, res.error());
+  auto array = res.value();
+  std::vector<ValueType> values;
+  values.reserve(array->length());
+  for (int64_t i = 0; i < array->length(); ++i) {
+    values.push_back(array->Value(i));
+  }
+  return values;
+}
+
+/// Ranks copies the float node property name, e.g., the output of
+/// katana::analytics::Pagerank, out of a property graph.
+inline std::vector<float>
+Ranks(katana::PropertyGraph* pg, const std::string& name) {
+  return NodePropertyValues<float>(pg, name);
+}
+
 /// BaselineIterate iterates over a property file graph with a standard "for
 /// each node, for each edge" pattern and accesses the corresponding entries in
 /// a node property and edge property array.
@@ -0,0 +1,219 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <set>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PartitionLoader.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/Uri.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using Parts = std::vector<std::unique_ptr<katana::PropertyGraph>>;
+
+constexpr uint32_t kNumNodes = 2000;
+const char* kCommandLine = "all-partitions";
+
+int64_t
+NodeValue(uint64_t node) {
+  return static_cast<int64_t>(node) * 3 - 1000;
+}
+
+uint64_t
+EdgeWeight(uint64_t src, uint64_t dest) {
+  return src * kNumNodes + dest;
+}
+
+std::shared_ptr<arrow::UInt64Array>
+GlobalIDs(const katana::PropertyGraph& pg) {
+  KATANA_LOG_ASSERT(pg.local_to_global_id()->num_chunks() == 1);
+  return std::static_pointer_cast<arrow::UInt64Array>(
+      pg.local_to_global_id()->chunk(0));
+}
+
+/// Give the nodes of part the property "value" and its edges the property
+/// "weight", both computed from the nodes of the RDG they are
+void
+AddProperties(katana::PropertyGraph* part) {
+  std::shared_ptr<arrow::UInt64Array> ids = GlobalIDs(*part);
+  const katana::GraphTopology& topology = part->topology();
+  std::vector<int64_t> values;
+  std::vector<uint64_t> weights;
+  for (auto n : topology) {
+    values.emplace_back(NodeValue(ids->Value(n)));
+    for (auto e : topology.edges(n)) {
+      weights.emplace_back(
+          EdgeWeight(ids->Value(n), ids->Value(topology.edge_dest(e))));
+    }
+  }
+  auto node_res = part->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("value", arrow::int64())}),
+      {katana::BuildArray(values)}));
+  KATANA_LOG_VASSERT(node_res, "adding values: {}", node_res.error());
+  auto edge_res = part->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint64())}),
+      {katana::BuildArray(weights)}));
+  KATANA_LOG_VASSERT(edge_res, "adding weights: {}", edge_res.error());
+  part->MarkAllPropertiesPersistent();
+}
+
+/// The partitions of rdg_dir for num_hosts hosts, with properties
+Parts
+LoadPartitions(const std::string& rdg_dir, uint32_t num_hosts) {
+  katana::PartitionLoadOptions options;
+  options.block_nodes = 64;
+  std::vector<katana::PartitionLoader> loaders;
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    auto res = katana::PartitionLoader::Read(rdg_dir, h, num_hosts, options);
+    KATANA_LOG_VASSERT(res, "reading partition {}: {}", h, res.error());
+    loaders.emplace_back(std::move(res.value()));
+  }
+  Parts parts;
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    std::vector<std::vector<uint64_t>> mirrored;
+    for (uint32_t other = 0; other < num_hosts; ++other) {
+      mirrored.emplace_back(loaders[other].mirrors()[h]);
+    }
+    auto res = loaders[h].Finish(mirrored);
+    KATANA_LOG_VASSERT(res, "finishing partition {}: {}", h, res.error());
+    AddProperties(res.value().get());
+    parts.emplace_back(std::move(res.value()));
+  }
+  return parts;
+}
+
+/// Store parts as the partitions of a new RDG at rdg_dir. Every host but 0
+/// stores its partition from a process of its own, as it would on its own
+/// machine, and host 0 stores last, which publishes the version that names
+/// the partitions of all hosts.
+void
+WritePartitions(const std::string& rdg_dir, const Parts& parts) {
+  katana::CommBackend* comm = tsuba::Comm();
+  KATANA_LOG_ASSERT(comm->ID == 0 && comm->Num == 1);
+  comm->Num = parts.size();
+  auto create_res = tsuba::Create(rdg_dir);
+  KATANA_LOG_VASSERT(create_res, "creating RDG: {}", create_res.error());
+
+  // The threads of the pool are not in the forked processes
+  unsigned threads = katana::getActiveThreads();
+  katana::setActiveThreads(1);
+  for (uint32_t h = 1; h < parts.size(); ++h) {
+    pid_t pid = fork();
+    KATANA_LOG_ASSERT(pid >= 0);
+    if (pid == 0) {
+      comm->ID = h;
+      // Files have random names, which must differ from those of the
+      // other hosts
+      katana::GetGenerator().seed(getpid());
+      KATANA_LOG_ASSERT(parts[h]->InformPath(rdg_dir));
+      auto res = parts[h]->Commit(kCommandLine);
+      KATANA_LOG_VASSERT(res, "storing partition {}: {}", h, res.error());
+      _exit(0);
+    }
+    int status = 0;
+    KATANA_LOG_ASSERT(waitpid(pid, &status, 0) == pid);
+    KATANA_LOG_VASSERT(
+        WIFEXITED(status) && WEXITSTATUS(status) == 0,
+        "storing partition {} exited with status {}", h, status);
+  }
+  katana::setActiveThreads(threads);
+
+  KATANA_LOG_ASSERT(parts[0]->InformPath(rdg_dir));
+  auto res = parts[0]->Commit(kCommandLine);
+  KATANA_LOG_VASSERT(res, "storing partition 0: {}", res.error());
+  comm->Num = 1;
+}
+
+/// combined has each node of pg once, with the edges of the node and the
+/// properties of AddProperties
+void
+CheckCombined(
+    const katana::PropertyGraph& pg, katana::PropertyGraph* combined) {
+  KATANA_LOG_ASSERT(combined->num_nodes() == pg.num_nodes());
+  KATANA_LOG_ASSERT(combined->num_edges() == pg.num_edges());
+  std::shared_ptr<arrow::UInt64Array> ids = GlobalIDs(*combined);
+  auto values = combined->GetNodePropertyTyped<int64_t>("value").value();
+  auto weights = combined->GetEdgePropertyTyped<uint64_t>("weight").value();
+
+  std::vector<char> seen(pg.num_nodes());
+  const katana::GraphTopology& topology = combined->topology();
+  for (auto c : topology) {
+    uint64_t n = ids->Value(c);
+    KATANA_LOG_VASSERT(
+        n < pg.num_nodes() && !seen[n], "node {} is not once in the graph",
+        n);
+    seen[n] = true;
+    KATANA_LOG_ASSERT(values->Value(c) == NodeValue(n));
+
+    std::multiset<uint64_t> dests;
+    for (auto e : topology.edges(c)) {
+      uint64_t dest = ids->Value(topology.edge_dest(e));
+      dests.emplace(dest);
+      KATANA_LOG_ASSERT(weights->Value(e) == EdgeWeight(n, dest));
+    }
+    std::multiset<uint64_t> expected;
+    for (auto e : pg.topology().edges(n)) {
+      expected.emplace(pg.topology().edge_dest(e));
+    }
+    KATANA_LOG_VASSERT(dests == expected, "node {} has other edges", n);
+  }
+}
+
+void
+TestAllPartitions() {
+  RandomPolicy policy{6};
+  auto pg = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/allpartitions");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  std::string parts_dir = rdg_dir + "-parts";
+  if (auto res = pg->Write(rdg_dir, kCommandLine); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing graph: {}", res.error());
+  }
+
+  // An RDG of one partition loads as it is
+  auto one_res = katana::PropertyGraph::MakeFromAllPartitions(rdg_dir);
+  KATANA_LOG_VASSERT(one_res, "loading graph: {}", one_res.error());
+  KATANA_LOG_ASSERT(one_res.value()->Equals(pg.get()));
+
+  WritePartitions(parts_dir, LoadPartitions(rdg_dir, 3));
+  auto stat_res = tsuba::Stat(parts_dir);
+  KATANA_LOG_VASSERT(stat_res, "stat: {}", stat_res.error());
+  KATANA_LOG_ASSERT(stat_res.value().num_partitions == 3);
+
+  for (unsigned threads : {1, 4}) {
+    katana::setActiveThreads(threads);
+    auto res = katana::PropertyGraph::MakeFromAllPartitions(parts_dir);
+    KATANA_LOG_VASSERT(res, "loading partitions: {}", res.error());
+    CheckCombined(*pg, res.value().get());
+  }
+
+  fs::remove_all(rdg_dir);
+  fs::remove_all(parts_dir);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestAllPartitions();
+
+  return 0;
+}
@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/k_core/k_core.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+/// Benchmarks every plan of the analytics algorithms on generated graphs.
+///
+/// Benchmark names have the form Algorithm/Plan/graph:G/scale:S/threads:T,
+/// so --benchmark_filter can select, e.g., one algorithm or one scale. Graph
+/// G is 0 for an RMAT graph and 1 for a road-like grid, each with 2^S nodes.
+/// Graphs come from a fixed seed, so runs are comparable.
+///
+/// The edges_per_second counter is the throughput in input edges. Write
+/// results with --benchmark_out=<file> --benchmark_out_format=json and
+/// compare two such files with scripts/compare_benchmarks.py.
+
+namespace {
+
+using Node = uint32_t;
+
+constexpr uint64_t kSeed = 0xdeadbeef;
+constexpr const char* kWeightProperty = "weight";
+constexpr const char* kOutputProperty = "output";
+
+enum GraphKind { kRmat = 0, kRoad = 1 };
+
+/// Build a symmetric graph without self loops or duplicate edges, with
+/// sorted neighbors and random edge weights
+std::unique_ptr<katana::PropertyGraph>
+MakeSymmetricGraph(
+    size_t num_nodes, const std::vector<std::pair<Node, Node>>& edges,
+    std::mt19937_64* gen) {
+  std::vector<std::vector<Node>> neighbors(num_nodes);
+  for (const auto& [src, dst] : edges) {
+    if (src != dst) {
+      neighbors[src].emplace_back(dst);
+      neighbors[dst].emplace_back(src);
+    }
+  }
+
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  indices.reserve(num_nodes);
+  for (auto& n : neighbors) {
+    std::sort(n.begin(), n.end());
+    n.erase(std::unique(n.begin(), n.end()), n.end());
+    dests.insert(dests.end(), n.begin(), n.end());
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+
+  std::uniform_int_distribution<uint32_t> weight_dist(1, 100);
+  std::vector<uint32_t> weights(dests.size());
+  for (auto& w : weights) {
+    w = weight_dist(*gen);
+  }
+  auto weight_array = katana::BuildArray(weights);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(kWeightProperty, arrow::uint32())}),
+      {weight_array});
+  if (auto r = g->AddEdgeProperties(table); !r) {
+    KATANA_LOG_FATAL("could not add edge weights: {}", r.error());
+  }
+
+  return g;
+}
+
+/// An RMAT graph (Chakrabarti et al.) with the Graph500 parameters:
+/// power-law degrees and a small diameter
+std::unique_ptr<katana::PropertyGraph>
+MakeRmatGraph(int scale) {
+  constexpr int kEdgeFactor = 16;
+  constexpr double kA = 0.57;
+  constexpr double kB = 0.19;
+  constexpr double kC = 0.19;
+
+  std::mt19937_64 gen(kSeed);
+  std::uniform_real_distribution<double> dist(0, 1);
+  size_t num_nodes = size_t{1} << scale;
+  std::vector<std::pair<Node, Node>> edges(num_nodes * kEdgeFactor);
+  for (auto& [src, dst] : edges) {
+    src = 0;
+    dst = 0;
+    for (int bit = 0; bit < scale; ++bit) {
+      double r = dist(gen);
+      if (r >= kA + kB + kC) {
+        src |= Node{1} << bit;
+        dst |= Node{1} << bit;
+      } else if (r >= kA + kB) {
+        src |= Node{1} << bit;
+      } else if (r >= kA) {
+        dst |= Node{1} << bit;
+      }
+    }
+  }
+
+  return MakeSymmetricGraph(num_nodes, edges, &gen);
+}
+
+/// A grid, like a road network: bounded degrees and a large diameter
+std::unique_ptr<katana::PropertyGraph>
+MakeRoadGraph(int scale) {
+  std::mt19937_64 gen(kSeed);
+  size_t width = size_t{1} << (scale / 2);
+  size_t height = (size_t{1} << scale) / width;
+  std::vector<std::pair<Node, Node>> edges;
+  for (size_t y = 0; y < height; ++y) {
+    for (size_t x = 0; x < width; ++x) {
+      Node n = y * width + x;
+      if (x + 1 < width) {
+        edges.emplace_back(n, n + 1);
+      }
+      if (y + 1 < height) {
+        edges.emplace_back(n, n + width);
+      }
+    }
+  }
+
+  return MakeSymmetricGraph(width * height, edges, &gen);
+}
+
+/// \returns a graph shared by all benchmarks of the same kind and scale
+katana::PropertyGraph*
+GetGraph(GraphKind kind, int scale) {
+  static std::map<
+      std::pair<GraphKind, int>, std::unique_ptr<katana::PropertyGraph>>
+      graphs;
+  auto& g = graphs[{kind, scale}];
+  if (!g) {
+    g = kind == kRmat ? MakeRmatGraph(scale) : MakeRoadGraph(scale);
+  }
+  return g.get();
+}
+
+/// Runs an algorithm on a graph and \returns an error if it fails
+using RunFn = std::function<katana::Result<void>(katana::PropertyGraph*)>;
+
+void
+RunAnalytics(benchmark::State& state, const RunFn& run, const RunFn& check) {
+  auto kind = static_cast<GraphKind>(state.range(0));
+  katana::PropertyGraph* g = GetGraph(kind, state.range(1));
+  katana::setActiveThreads(state.range(2));
+
+  auto remove_output = [g]() {
+    if (g->node_schema()->GetFieldIndex(kOutputProperty) >= 0) {
+      if (auto r = g->RemoveNodeProperty(kOutputProperty); !r) {
+        KATANA_LOG_FATAL("removing output: {}", r.error());
+      }
+    }
+  };
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    remove_output();
+    state.ResumeTiming();
+
+    if (auto r = run(g); !r) {
+      state.SkipWithError(fmt::format("{}", r.error()).c_str());
+      return;
+    }
+  }
+
+  if (check) {
+    if (auto r = check(g); !r) {
+      state.SkipWithError(fmt::format("invalid: {}", r.error()).c_str());
+    }
+  }
+  remove_output();
+
+  state.counters["edges_per_second"] = benchmark::Counter(
+      g->topology().num_edges(), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  int max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  std::vector<int> threads{1};
+  if (max_threads > 1) {
+    threads.emplace_back(max_threads);
+  }
+  for (int kind : {kRmat, kRoad}) {
+    for (int scale : {10, 14, 18}) {
+      for (int t : threads) {
+        b->Args({kind, scale, t});
+      }
+    }
+  }
+  b->ArgNames({"graph", "scale", "threads"});
+  b->Unit(benchmark::kMillisecond);
+  b->UseRealTime();
+}
+
+void
+Register(const std::string& name, RunFn run, RunFn check = {}) {
+  benchmark::RegisterBenchmark(
+      name.c_str(),
+      [run, check](benchmark::State& state) {
+        RunAnalytics(state, run, check);
+      })
+      ->Apply(MakeArguments);
+}
+
+void
+RegisterBfs(const std::string& name, katana::analytics::BfsPlan plan) {
+  Register(
+      "Bfs/" + name,
+      [plan](katana::PropertyGraph* g) {
+        return katana::analytics::Bfs(g, 0, kOutputProperty, plan);
+      },
+      [](katana::PropertyGraph* g) {
+        return katana::analytics::BfsAssertValid(g, kOutputProperty);
+      });
+}
+
+void
+RegisterSssp(const std::string& name, katana::analytics::SsspPlan plan) {
+  Register(
+      "Sssp/" + name,
+      [plan](katana::PropertyGraph* g) {
+        return katana::analytics::Sssp(
+            g, 0, kWeightProperty, kOutputProperty, plan);
+      },
+      [](katana::PropertyGraph* g) {
+        return katana::analytics::SsspAssertValid(
+            g, 0, kWeightProperty, kOutputProperty);
+      });
+}
+
+void
+RegisterConnectedComponents(
+    const std::string& name, katana::analytics::ConnectedComponentsPlan plan) {
+  Register(
+      "ConnectedComponents/" + name,
+      [plan](katana::PropertyGraph* g) {
+        return katana::analytics::ConnectedComponents(
+            g, kOutputProperty, plan);
+      },
+      [](katana::PropertyGraph* g) {
+        return katana::analytics::ConnectedComponentsAssertValid(
+            g, kOutputProperty);
+      });
+}
+
+void
+RegisterPagerank(
+    const std::string& name, katana::analytics::PagerankPlan plan) {
+  // The graphs are symmetric, so they are their own transpose, as the pull
+  // plans require
+  Register(
+      "Pagerank/" + name,
+      [plan](katana::PropertyGraph* g) {
+        return katana::analytics::Pagerank(g, kOutputProperty, plan);
+      },
+      [](katana::PropertyGraph* g) {
+        return katana::analytics::PagerankAssertValid(g, kOutputProperty);
+      });
+}
+
+void
+RegisterKCore(const std::string& name, katana::analytics::KCorePlan plan) {
+  constexpr uint32_t kK = 4;
+  Register(
+      "KCore/" + name,
+      [plan](katana::PropertyGraph* g) {
+        return katana::analytics::KCore(g, kK, kOutputProperty, plan);
+      },
+      [](katana::PropertyGraph* g) {
+        return katana::analytics::KCoreAssertValid(g, kK, kOutputProperty);
+      });
+}
+
+void
+RegisterTriangleCount(
+    const std::string& name, katana::analytics::TriangleCountPlan plan) {
+  Register(
+      "TriangleCount/" + name,
+      [plan](katana::PropertyGraph* g) -> katana::Result<void> {
+        if (auto r = katana::analytics::TriangleCount(g, plan); !r) {
+          return r.error();
+        }
+        return katana::ResultSuccess();
+      });
+}
+
+void
+RegisterAll() {
+  using katana::analytics::BfsPlan;
+  using katana::analytics::ConnectedComponentsPlan;
+  using katana::analytics::KCorePlan;
+  using katana::analytics::PagerankPlan;
+  using katana::analytics::SsspPlan;
+  using katana::analytics::TriangleCountPlan;
+
+  RegisterBfs("AsynchronousTile", BfsPlan::AsynchronousTile());
+  RegisterBfs("Asynchronous", BfsPlan::Asynchronous());
+  RegisterBfs("SynchronousTile", BfsPlan::SynchronousTile());
+  RegisterBfs("Synchronous", BfsPlan::Synchronous());
+  RegisterBfs("SynchronousDirectOpt", BfsPlan::SynchronousDirectOpt(15, 18));
+
+  RegisterSssp("DeltaTile", SsspPlan::DeltaTile());
+  RegisterSssp("DeltaStep", SsspPlan::DeltaStep());
+  RegisterSssp("DeltaStepBarrier", SsspPlan::DeltaStepBarrier());
+  RegisterSssp("SerialDeltaTile", SsspPlan::SerialDeltaTile());
+  RegisterSssp("SerialDelta", SsspPlan::SerialDelta());
+  RegisterSssp("DijkstraTile", SsspPlan::DijkstraTile());
+  RegisterSssp("Dijkstra", SsspPlan::Dijkstra());
+  RegisterSssp("Topological", SsspPlan::Topological());
+  RegisterSssp("TopologicalTile", SsspPlan::TopologicalTile());
+
+  RegisterConnectedComponents("Serial", ConnectedComponentsPlan::Serial());
+  RegisterConnectedComponents(
+      "LabelProp", ConnectedComponentsPlan::LabelProp());
+  RegisterConnectedComponents(
+      "Synchronous", ConnectedComponentsPlan::Synchronous());
+  RegisterConnectedComponents(
+      "Asynchronous", ConnectedComponentsPlan::Asynchronous());
+  RegisterConnectedComponents(
+      "EdgeAsynchronous", ConnectedComponentsPlan::EdgeAsynchronous());
+  RegisterConnectedComponents(
+      "EdgeTiledAsynchronous",
+      ConnectedComponentsPlan::EdgeTiledAsynchronous());
+  RegisterConnectedComponents(
+      "BlockedAsynchronous", ConnectedComponentsPlan::BlockedAsynchronous());
+  RegisterConnectedComponents("Afforest", ConnectedComponentsPlan::Afforest());
+  RegisterConnectedComponents(
+      "EdgeAfforest", ConnectedComponentsPlan::EdgeAfforest());
+  RegisterConnectedComponents(
+      "EdgeTiledAfforest", ConnectedComponentsPlan::EdgeTiledAfforest());
+
+  RegisterPagerank("PullTopological", PagerankPlan::PullTopological());
+  RegisterPagerank("PullResidual", PagerankPlan::PullResidual());
+  RegisterPagerank("PullBlocked", PagerankPlan::PullBlocked());
+  RegisterPagerank("PushAsynchronous", PagerankPlan::PushAsynchronous());
+  RegisterPagerank("PushSynchronous", PagerankPlan::PushSynchronous());
+
+  RegisterKCore("Synchronous", KCorePlan::Synchronous());
+  RegisterKCore("Asynchronous", KCorePlan::Asynchronous());
+
+  RegisterTriangleCount("NodeIteration", TriangleCountPlan::NodeIteration());
+  RegisterTriangleCount("EdgeIteration", TriangleCountPlan::EdgeIteration());
+  RegisterTriangleCount("OrderedCount", TriangleCountPlan::OrderedCount());
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+
+  RegisterAll();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+constexpr size_t kLength = 1000;
+
+template <typename ArrowType, typename F>
+void
+TestNullable(F value_of) {
+  using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+  katana::ArrowRandomAccessBuilder<ArrowType> builder(kLength);
+
+  // Build two properties with one builder
+  for (size_t stride : {3, 1}) {
+    builder.Reset(kLength);
+    katana::do_all(katana::iterate(size_t{0}, kLength), [&](size_t i) {
+      if (i % stride == 0) {
+        builder[i] = value_of(i);
+      }
+    });
+
+    auto res = builder.Finalize();
+    KATANA_LOG_ASSERT(res);
+    KATANA_LOG_ASSERT(builder.size() == 0);
+    auto array = std::static_pointer_cast<ArrayType>(res.value());
+    KATANA_LOG_ASSERT(array->length() == int64_t(kLength));
+    KATANA_LOG_ASSERT(array->ValidateFull().ok());
+    int64_t num_valid = (kLength + stride - 1) / stride;
+    KATANA_LOG_ASSERT(array->null_count() == int64_t(kLength) - num_valid);
+    for (size_t i = 0; i < kLength; ++i) {
+      KATANA_LOG_VASSERT(
+          array->IsValid(i) == (i % stride == 0), "index {} of stride {}", i,
+          stride);
+      if (i % stride == 0) {
+        KATANA_LOG_ASSERT(array->GetView(i) == value_of(i));
+      }
+    }
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestNullable<arrow::UInt32Type>([](size_t i) { return uint32_t(i * 7); });
+  TestNullable<arrow::DoubleType>([](size_t i) { return i / 3.0; });
+  TestNullable<arrow::BooleanType>([](size_t i) { return i % 2 == 0; });
+  TestNullable<arrow::StringType>([](size_t i) { return std::to_string(i); });
+
+  katana::ArrowRandomAccessBuilder<arrow::Int64Type> empty(0);
+  auto res = empty.Finalize();
+  KATANA_LOG_ASSERT(res && res.value()->length() == 0);
+
+  return 0;
+}
@@ -0,0 +1,120 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+constexpr uint64_t kSize = 1 << 16;
+constexpr int kRounds = 20;
+
+/// Sum [0, kSize) in parallel kRounds times, using the accumulator both in
+/// and out of parallel loops
+void
+SumRounds() {
+  katana::GAccumulator<uint64_t> sum;
+  for (int round = 0; round < kRounds; ++round) {
+    sum.reset();
+    sum += 1;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, kSize), [&](uint64_t i) { sum += i; },
+        katana::no_stats());
+    uint64_t expected = 1 + kSize * (kSize - 1) / 2;
+    KATANA_LOG_VASSERT(
+        sum.reduce() == expected, "sum is {}, not {}", sum.reduce(), expected);
+
+    katana::on_each(
+        [&](unsigned, unsigned num) {
+          KATANA_LOG_ASSERT(num == katana::getActiveThreads());
+        },
+        katana::no_stats());
+  }
+}
+
+/// Run do_all and for_each loops kRounds times and check their reductions.
+/// The loops run on the pool and not inline, even while another thread's
+/// loops run.
+void
+ForEachRounds() {
+  constexpr uint32_t kChains = 64;
+  constexpr uint32_t kDepth = 32;
+  unsigned num_threads = katana::getActiveThreads();
+
+  for (int round = 0; round < kRounds; ++round) {
+    katana::GAccumulator<uint64_t> sum;
+    std::vector<std::atomic<bool>> ran(num_threads);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, kSize),
+        [&](uint64_t i) {
+          sum += i;
+          ran[katana::ThreadPool::getTID()] = true;
+        },
+        katana::no_stats());
+    KATANA_LOG_ASSERT(sum.reduce() == kSize * (kSize - 1) / 2);
+    for (unsigned tid = 0; tid < num_threads; ++tid) {
+      KATANA_LOG_VASSERT(ran[tid], "thread {} ran no iterations", tid);
+    }
+
+    // Each chain pushes kDepth - 1 items after its first
+    katana::GAccumulator<uint64_t> count;
+    katana::for_each(
+        katana::iterate(uint32_t{0}, kChains),
+        [&](uint32_t item, auto& ctx) {
+          count += 1;
+          if (item / kChains + 1 < kDepth) {
+            ctx.push(item + kChains);
+          }
+        },
+        katana::disable_conflict_detection(), katana::no_stats());
+    KATANA_LOG_VASSERT(
+        count.reduce() == kChains * kDepth, "for_each ran {} items",
+        count.reduce());
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  // Parallel loops of threads the pool did not make take turns with each
+  // other and with the main thread
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 3; ++i) {
+    threads.emplace_back([]() {
+      katana::GetThreadPool().attachThread();
+      SumRounds();
+    });
+  }
+  SumRounds();
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  // Loops of two threads overlap without either running inline
+  std::thread first(ForEachRounds);
+  std::thread second(ForEachRounds);
+  first.join();
+  second.join();
+
+  // A thread that runs a loop before anything else is attached by the run
+  std::thread t([]() {
+    std::vector<uint64_t> values(kSize);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, kSize), [&](uint64_t i) { values[i] = i; },
+        katana::no_stats());
+    for (uint64_t i = 0; i < kSize; ++i) {
+      KATANA_LOG_ASSERT(values[i] == i);
+    }
+  });
+  t.join();
+
+  return 0;
+}
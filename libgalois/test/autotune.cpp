@@ -0,0 +1,95 @@
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/Autotune.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/connected_components/connected_components.h"
+
+using DataType = int64_t;
+using katana::analytics::AutotuneCache;
+using katana::analytics::AutotuneOptions;
+using katana::analytics::PlanCandidate;
+
+struct Output : public katana::PODProperty<uint32_t> {};
+
+void
+TestChoosesFastest() {
+  RandomPolicy policy{3};
+  auto pg = MakeFileGraph<DataType>(1000, 0, &policy);
+  AutotuneCache::Global().Clear();
+
+  // The plan is the milliseconds a trial sleeps; one candidate fails
+  std::vector<PlanCandidate<int>> candidates{
+      {"slow", 20}, {"fast", 1}, {"broken", 0}, {"medium", 10}};
+  AutotuneOptions options;
+  options.sample_nodes = 100;
+  int num_runs = 0;
+  auto run = [&](katana::PropertyGraph* sample,
+                 int ms) -> katana::Result<void> {
+    ++num_runs;
+    KATANA_LOG_ASSERT(sample->num_nodes() == 100);
+    if (ms == 0) {
+      return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "broken");
+    }
+    // A property added by a trial is gone by the next
+    using Properties = std::tuple<Output>;
+    if (auto r = katana::analytics::ConstructNodeProperties<Properties>(
+            sample, {"output"});
+        !r) {
+      return r.error();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    return katana::ResultSuccess();
+  };
+
+  auto res = katana::analytics::Autotune(
+      pg.get(), "sleep", candidates, run, options);
+  KATANA_LOG_VASSERT(res, "autotune failed: {}", res.error());
+  KATANA_LOG_ASSERT(res.value() == 1);
+  KATANA_LOG_ASSERT(num_runs == 7);
+
+  // The choice is cached for the graph, and survives a round trip to JSON
+  std::string json = AutotuneCache::Global().ToJson();
+  AutotuneCache::Global().Clear();
+  KATANA_LOG_ASSERT(AutotuneCache::Global().FromJson(json));
+  num_runs = 0;
+  res = katana::analytics::Autotune(
+      pg.get(), "sleep", candidates, run, options);
+  KATANA_LOG_ASSERT(res && res.value() == 1 && num_runs == 0);
+
+  // Other graphs have other fingerprints
+  auto other = MakeFileGraph<DataType>(1001, 0, &policy);
+  KATANA_LOG_ASSERT(
+      katana::analytics::GraphFingerprint(*other) !=
+      katana::analytics::GraphFingerprint(*pg));
+}
+
+void
+TestConnectedComponents() {
+  LinePolicy policy{1};
+  auto pg = MakeFileGraph<DataType>(10000, 0, &policy);
+  AutotuneOptions options;
+  options.sample_nodes = 1000;
+  options.trials = 1;
+  auto res = katana::analytics::AutotuneConnectedComponents(pg.get(), options);
+  KATANA_LOG_VASSERT(res, "autotune failed: {}", res.error());
+  auto cc_res = katana::analytics::ConnectedComponents(
+      pg.get(), "component", res.value());
+  KATANA_LOG_VASSERT(cc_res, "components failed: {}", cc_res.error());
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestChoosesFastest();
+  TestConnectedComponents();
+
+  return 0;
+}
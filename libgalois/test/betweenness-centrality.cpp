@@ -0,0 +1,125 @@
+#include <cmath>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+
+using katana::analytics::BetweennessCentrality;
+using katana::analytics::BetweennessCentralityPlan;
+using Node = katana::GraphTopology::Node;
+
+namespace {
+
+/// The betweenness centrality of every node of topology by Brandes'
+/// algorithm from every source
+std::vector<double>
+ExactCentrality(const katana::GraphTopology& topology) {
+  std::vector<double> centrality(topology.num_nodes());
+  for (auto source : topology) {
+    std::vector<int64_t> dist(topology.num_nodes(), -1);
+    std::vector<double> sigma(topology.num_nodes());
+    std::vector<double> delta(topology.num_nodes());
+    std::vector<Node> order;
+    std::deque<Node> queue{static_cast<Node>(source)};
+    dist[source] = 0;
+    sigma[source] = 1;
+    while (!queue.empty()) {
+      Node n = queue.front();
+      queue.pop_front();
+      order.emplace_back(n);
+      for (auto e : topology.edges(n)) {
+        auto dst = topology.edge_dest(e);
+        if (dist[dst] < 0) {
+          dist[dst] = dist[n] + 1;
+          queue.emplace_back(dst);
+        }
+        if (dist[dst] == dist[n] + 1) {
+          sigma[dst] += sigma[n];
+        }
+      }
+    }
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      for (auto e : topology.edges(*it)) {
+        auto dst = topology.edge_dest(e);
+        if (dist[dst] == dist[*it] + 1) {
+          delta[*it] += sigma[*it] / sigma[dst] * (1 + delta[dst]);
+        }
+      }
+      if (*it != source) {
+        centrality[*it] += delta[*it];
+      }
+    }
+  }
+  return centrality;
+}
+
+/// A graph of num_components components of component_size nodes, each with
+/// random edges inside it alone
+std::unique_ptr<katana::PropertyGraph>
+MakeComponents(uint32_t num_components, uint32_t component_size) {
+  std::mt19937 gen{7};
+  std::uniform_int_distribution<Node> offset(0, component_size - 1);
+  std::vector<uint64_t> indices;
+  std::vector<Node> dests;
+  for (uint32_t c = 0; c < num_components; ++c) {
+    for (uint32_t i = 0; i < component_size; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        dests.emplace_back(c * component_size + offset(gen));
+      }
+      indices.emplace_back(dests.size());
+    }
+  }
+  auto pg = std::make_unique<katana::PropertyGraph>();
+  auto res = pg->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_VASSERT(res, "SetTopology failed: {}", res.error());
+  return pg;
+}
+
+void
+TestOuter(katana::PropertyGraph* pg) {
+  std::vector<double> exact = ExactCentrality(pg->topology());
+
+  auto res = BetweennessCentrality(
+      pg, "bc", katana::analytics::kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Outer());
+  KATANA_LOG_VASSERT(res, "BetweennessCentrality failed: {}", res.error());
+  auto column = pg->GetNodeProperty("bc");
+  KATANA_LOG_ASSERT(column);
+  auto bc = std::static_pointer_cast<arrow::FloatArray>(column->chunk(0));
+  for (auto n : pg->topology()) {
+    KATANA_LOG_VASSERT(
+        std::fabs(bc->Value(n) - exact[n]) <= 1e-3 * (1 + exact[n]),
+        "node {} has centrality {}, not {}", n, bc->Value(n), exact[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  // Every search reaches the whole graph, so the state of each thread
+  // becomes dense
+  RandomPolicy policy{3};
+  auto connected = MakeFileGraph<uint32_t>(500, 0, &policy);
+  TestOuter(connected.get());
+
+  // Every search reaches one component, so the state stays sparse
+  auto components = MakeComponents(100, 20);
+  TestOuter(components.get());
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/bfs/bfs.h"
+
+using DataType = int64_t;
+using BfsPlan = katana::analytics::BfsPlan;
+
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max() / 4;
+
+std::vector<uint32_t>
+SerialBfs(const katana::GraphTopology& topology, uint32_t source) {
+  std::vector<uint32_t> dist(topology.num_nodes(), kUnreached);
+  std::deque<uint32_t> queue{source};
+  dist[source] = 0;
+  while (!queue.empty()) {
+    uint32_t n = queue.front();
+    queue.pop_front();
+    for (auto e : topology.edges(n)) {
+      uint32_t dst = topology.edge_dest(e);
+      if (dist[dst] == kUnreached) {
+        dist[dst] = dist[n] + 1;
+        queue.push_back(dst);
+      }
+    }
+  }
+  return dist;
+}
+
+/// Direction-optimizing BFS computes levels, like the other plans, whether
+/// or not its frontiers grow large enough for bottom-up steps
+void
+TestDirectionOpt(size_t num_nodes, Policy* policy, BfsPlan plan) {
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, policy);
+  std::vector<uint32_t> expected = SerialBfs(g->topology(), 0);
+
+  auto res = katana::analytics::Bfs(g.get(), 0, "level", plan);
+  KATANA_LOG_VASSERT(res, "running bfs: {}", res.error());
+  KATANA_LOG_ASSERT(katana::analytics::BfsAssertValid(g.get(), "level"));
+
+  auto levels = std::static_pointer_cast<arrow::UInt32Array>(
+      g->GetNodeProperty("level")->chunk(0));
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_VASSERT(
+        levels->Value(n) == expected[n], "level of {}: {} != {}", n,
+        levels->Value(n), expected[n]);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  LinePolicy line{2};
+  RandomPolicy random{8};
+  for (Policy* policy : std::initializer_list<Policy*>{&line, &random}) {
+    TestDirectionOpt(10000, policy, BfsPlan::SynchronousDirectOpt(15, 18));
+    // An alpha that switches to bottom-up early and a beta that never
+    // switches back on frontier size alone
+    TestDirectionOpt(
+        10000, policy, BfsPlan::SynchronousDirectOpt(1000, 1U << 30));
+  }
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include <string>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+using DataType = int64_t;
+using katana::analytics::BipartiteMatchingPlan;
+using katana::analytics::BipartiteMatchingStatistics;
+
+/// Edges from each of the first num_left nodes to width random nodes among
+/// the rest, and to the node facing it if there is one
+class BipartitePolicy : public Policy {
+  size_t num_left_{};
+  size_t width_{};
+  bool facing_{};
+
+public:
+  BipartitePolicy(size_t num_left, size_t width, bool facing)
+      : num_left_(num_left), width_(width), facing_(facing) {}
+
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    if (node_id >= num_left_) {
+      return r;
+    }
+    auto& gen = katana::GetGenerator();
+    std::uniform_int_distribution dist(num_left_, num_nodes - 1);
+    for (size_t i = 0; i < width_; ++i) {
+      r.emplace_back(dist(gen));
+    }
+    if (facing_ && num_left_ + node_id < num_nodes) {
+      r.emplace_back(num_left_ + node_id);
+    }
+    return r;
+  }
+};
+
+/// Add the edge property "weight" with random weights in [min, max]
+template <typename Weight>
+void
+AddWeights(katana::PropertyGraph* pg, Weight min, Weight max) {
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<int64_t> dist(min, max);
+  std::vector<Weight> weights(pg->topology().num_edges());
+  for (auto& w : weights) {
+    w = dist(gen);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(
+          "weight", arrow::CTypeTraits<Weight>::type_singleton())}),
+      {katana::BuildArray(weights)});
+  auto res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add weights: {}", res.error());
+}
+
+/// Compute a maximum cardinality matching with every algorithm and check
+/// them, returning their size
+uint64_t
+TestMatching(Policy* policy, size_t num_nodes) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+
+  std::vector<uint64_t> sizes;
+  for (auto plan :
+       {BipartiteMatchingPlan::PothenFan(), BipartiteMatchingPlan::Auction()}) {
+    std::string output = "matched-" + std::to_string(sizes.size());
+    auto res = katana::analytics::BipartiteMatching(pg.get(), output, plan);
+    KATANA_LOG_VASSERT(res, "matching failed: {}", res.error());
+
+    auto valid_res =
+        katana::analytics::BipartiteMatchingAssertValid(pg.get(), output);
+    KATANA_LOG_VASSERT(valid_res, "invalid matching: {}", valid_res.error());
+
+    auto stats_res = BipartiteMatchingStatistics::Compute(pg.get(), output);
+    KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+    sizes.emplace_back(stats_res.value().n_matched_edges);
+
+    // The output property may not exist before the call
+    res = katana::analytics::BipartiteMatching(pg.get(), output, plan);
+    KATANA_LOG_ASSERT(!res);
+  }
+  KATANA_LOG_VASSERT(
+      sizes[0] == sizes[1], "matchings have {} and {} edges", sizes[0],
+      sizes[1]);
+  return sizes[0];
+}
+
+template <typename Weight>
+void
+TestWeightedMatching(
+    Policy* policy, size_t num_nodes, Weight min, Weight max) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  AddWeights<Weight>(pg.get(), min, max);
+
+  auto res = katana::analytics::WeightedBipartiteMatching(
+      pg.get(), "weight", "matched");
+  KATANA_LOG_VASSERT(res, "weighted matching failed: {}", res.error());
+
+  auto valid_res = katana::analytics::WeightedBipartiteMatchingAssertValid(
+      pg.get(), "weight", "matched");
+  KATANA_LOG_VASSERT(valid_res, "invalid matching: {}", valid_res.error());
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // Edges to the facing nodes make a perfect matching
+  for (size_t width : {0, 1, 3}) {
+    BipartitePolicy facing{500, width, true};
+    uint64_t size = TestMatching(&facing, 1000);
+    KATANA_LOG_VASSERT(size == 500, "matched {} edges, not 500", size);
+  }
+
+  for (size_t width : {1, 2, 4}) {
+    BipartitePolicy random{400, width, false};
+    uint64_t size = TestMatching(&random, 700);
+    KATANA_LOG_ASSERT(size <= 300);
+
+    BipartitePolicy weighted{150, width, false};
+    TestWeightedMatching<uint32_t>(&weighted, 300, 0, 10);
+    TestWeightedMatching<int32_t>(&weighted, 300, -50, 50);
+    TestWeightedMatching<int64_t>(&weighted, 300, 0, 1000000);
+  }
+
+  // Edges must all go from left to right
+  LinePolicy line{2};
+  auto pg = MakeFileGraph<DataType>(10, 0, &line);
+  auto res = katana::analytics::BipartiteMatching(pg.get(), "matched");
+  KATANA_LOG_ASSERT(!res);
+
+  // Only the auction takes weights, which must exist
+  BipartitePolicy random{10, 2, false};
+  pg = MakeFileGraph<DataType>(20, 0, &random);
+  res = katana::analytics::WeightedBipartiteMatching(
+      pg.get(), "weight", "matched");
+  KATANA_LOG_ASSERT(!res);
+  AddWeights<int64_t>(pg.get(), 0, 10);
+  res = katana::analytics::WeightedBipartiteMatching(
+      pg.get(), "weight", "matched", BipartiteMatchingPlan::PothenFan());
+  KATANA_LOG_ASSERT(!res);
+
+  return 0;
+}
@@ -0,0 +1,253 @@
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// The size of the blocks of the cache
+constexpr uint64_t kBlockSize = UINT64_C(4) << 20;
+/// Files of a whole block and a short one
+constexpr uint64_t kFileSize = kBlockSize + 1000;
+
+/// Versioned objects in memory, under mem://, that count their reads
+class MemStorage : public tsuba::FileStorage {
+public:
+  MemStorage() : FileStorage("mem://") {}
+
+  void Set(
+      const std::string& uri, std::vector<uint8_t> data,
+      const std::string& version) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    objects_[uri] = Object{std::move(data), version};
+  }
+
+  uint32_t reads() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reads_;
+  }
+
+  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+
+  katana::Result<void> Stat(
+      const std::string& uri, tsuba::StatBuf* s_buf) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = objects_.find(uri);
+    if (it == objects_.end()) {
+      return KATANA_ERROR(tsuba::ErrorCode::NotFound, "no object {}", uri);
+    }
+    s_buf->size = it->second.data.size();
+    s_buf->version = it->second.version;
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reads_ += 1;
+    auto it = objects_.find(uri);
+    if (it == objects_.end() || start + size > it->second.data.size()) {
+      return KATANA_ERROR(tsuba::ErrorCode::NotFound, "no range of {}", uri);
+    }
+    std::memcpy(result_buf, it->second.data.data() + start, size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string&, const uint8_t*, uint64_t) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string&, const std::string&, uint64_t, uint64_t) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+  std::future<katana::Result<void>> PutAsync(
+      const std::string&, const uint8_t*, uint64_t) override {
+    return std::async(std::launch::deferred, []() -> katana::Result<void> {
+      return tsuba::ErrorCode::NotImplemented;
+    });
+  }
+
+  std::future<katana::Result<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return std::async(std::launch::deferred, [=]() {
+      return GetMultiSync(uri, start, size, result_buf);
+    });
+  }
+
+  std::future<katana::Result<void>> ListAsync(
+      const std::string&, std::vector<std::string>*,
+      std::vector<uint64_t>*) override {
+    return std::async(std::launch::deferred, []() -> katana::Result<void> {
+      return tsuba::ErrorCode::NotImplemented;
+    });
+  }
+
+  katana::Result<void> Delete(
+      const std::string&, const std::unordered_set<std::string>&) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+private:
+  struct Object {
+    std::vector<uint8_t> data;
+    std::string version;
+  };
+
+  std::mutex mutex_;
+  std::map<std::string, Object> objects_;
+  uint32_t reads_{0};
+};
+
+MemStorage storage;
+
+std::vector<uint8_t>
+MakeData(uint8_t seed) {
+  std::vector<uint8_t> data(kFileSize);
+  for (uint64_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 17 + seed);
+  }
+  return data;
+}
+
+std::set<std::string>
+ListBlocks(const std::string& dir) {
+  std::set<std::string> blocks;
+  if (!fs::exists(dir)) {
+    return blocks;
+  }
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    std::string name = entry.path().filename().string();
+    if (name[0] != '.') {
+      blocks.emplace(entry.path().string());
+    }
+  }
+  return blocks;
+}
+
+/// Read all of uri and check that it reads as data, from the storage if
+/// from_storage and else from the cache
+void
+CheckRead(
+    const std::string& uri, const std::vector<uint8_t>& data,
+    bool from_storage) {
+  uint32_t reads = storage.reads();
+  std::vector<uint8_t> out(data.size());
+  auto res = tsuba::FileGet(uri, out.data(), 0, out.size());
+  KATANA_LOG_VASSERT(res, "reading {}: {}", uri, res.error());
+  KATANA_LOG_VASSERT(out == data, "{} does not read as stored", uri);
+  KATANA_LOG_VASSERT(
+      (storage.reads() > reads) == from_storage, "{} was {}read from storage",
+      uri, from_storage ? "not " : "");
+}
+
+/// Reads of cached blocks do not go to the storage, until the file changes
+void
+TestInvalidation(const std::string& cache_dir) {
+  std::string uri = "mem://bucket/changing";
+  std::vector<uint8_t> first = MakeData(1);
+  storage.Set(uri, first, "1");
+  CheckRead(uri, first, true);
+  KATANA_LOG_ASSERT(ListBlocks(cache_dir).size() == 2);
+  CheckRead(uri, first, false);
+
+  // A new version of the same size is read from storage once the cache
+  // learns of it
+  std::vector<uint8_t> second = MakeData(2);
+  storage.Set(uri, second, "2");
+  tsuba::StatBuf stat;
+  KATANA_LOG_ASSERT(tsuba::FileStat(uri, &stat));
+  CheckRead(uri, second, true);
+  CheckRead(uri, second, false);
+  KATANA_LOG_ASSERT(ListBlocks(cache_dir).size() == 4);
+}
+
+/// Blocks are only used for the file whose URI and version they store, even
+/// when the name of a block of another file collides with theirs
+void
+TestCollision(const std::string& cache_dir) {
+  std::string first_uri = "mem://bucket/first";
+  std::string second_uri = "mem://bucket/secnd";
+  std::vector<uint8_t> first = MakeData(3);
+  std::vector<uint8_t> second = MakeData(4);
+  storage.Set(first_uri, first, "1");
+  storage.Set(second_uri, second, "1");
+
+  std::set<std::string> before = ListBlocks(cache_dir);
+  CheckRead(first_uri, first, true);
+  std::set<std::string> with_first = ListBlocks(cache_dir);
+  CheckRead(second_uri, second, true);
+  std::set<std::string> with_second = ListBlocks(cache_dir);
+
+  std::vector<std::string> first_blocks;
+  std::vector<std::string> second_blocks;
+  for (const std::string& block : with_second) {
+    if (before.count(block) > 0) {
+      continue;
+    }
+    (with_first.count(block) > 0 ? first_blocks : second_blocks)
+        .emplace_back(block);
+  }
+  KATANA_LOG_ASSERT(first_blocks.size() == 2 && second_blocks.size() == 2);
+
+  // Make the blocks of the second file copies of those of the first, as a
+  // collision of the hashes of their URIs would
+  for (size_t i = 0; i < first_blocks.size(); ++i) {
+    fs::remove(second_blocks[i]);
+    fs::copy_file(first_blocks[i], second_blocks[i]);
+  }
+  CheckRead(second_uri, second, true);
+  CheckRead(first_uri, first, false);
+  // The read from storage cached the blocks of the second file again
+  CheckRead(second_uri, second, false);
+
+  // Blocks that do not hold their whole key are not used
+  fs::resize_file(first_blocks[0], kBlockSize);
+  CheckRead(first_uri, first, true);
+  CheckRead(first_uri, first, false);
+}
+
+}  // namespace
+
+int
+main() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/blockcache");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string cache_dir(uri_res.value().path());
+
+  // The cache is configured when it is first used, and backends are
+  // registered before tsuba starts
+  setenv("KATANA_BLOCK_CACHE_DIR", cache_dir.c_str(), 1);
+  tsuba::RegisterFileStorage(&storage);
+  {
+    katana::SharedMemSys sys;
+
+    TestInvalidation(cache_dir);
+    TestCollision(cache_dir);
+  }
+
+  fs::remove_all(cache_dir);
+  return 0;
+}
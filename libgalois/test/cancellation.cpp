@@ -0,0 +1,92 @@
+#include <atomic>
+#include <chrono>
+
+#include "katana/Cancellation.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+void
+TestScope() {
+  KATANA_LOG_ASSERT(katana::internal::CurrentCancellationToken() == nullptr);
+
+  katana::CancellationToken outer;
+  katana::CancellationToken inner;
+  {
+    katana::CancellationScope outer_scope(&outer);
+    {
+      katana::CancellationScope inner_scope(&inner);
+      inner.Cancel();
+      KATANA_LOG_ASSERT(katana::IsCancelled());
+    }
+    KATANA_LOG_ASSERT(!katana::IsCancelled());
+
+    outer.SetDeadline(katana::CancellationToken::Clock::now());
+    KATANA_LOG_ASSERT(katana::IsCancelled());
+  }
+  KATANA_LOG_ASSERT(!katana::IsCancelled());
+}
+
+void
+TestCancelledBeforeStart() {
+  katana::CancellationToken token;
+  token.Cancel();
+  katana::CancellationScope scope(&token);
+
+  std::atomic<int> count{0};
+  katana::do_all(katana::iterate(0, 1 << 16), [&](int) { ++count; });
+  katana::do_all(
+      katana::iterate(0, 1 << 16), [&](int) { ++count; }, katana::steal());
+  katana::for_each(
+      katana::iterate(0, 1 << 16), [&](int, auto&) { ++count; },
+      katana::disable_conflict_detection(), katana::no_pushes());
+
+  KATANA_LOG_VASSERT(count == 0, "ran {} iterations", count.load());
+}
+
+template <typename... Args>
+void
+TestCancelDoAll(Args... args) {
+  constexpr int kSize = 1 << 22;
+
+  katana::CancellationToken token;
+  katana::CancellationScope scope(&token);
+
+  std::atomic<int> count{0};
+  katana::do_all(
+      katana::iterate(0, kSize),
+      [&](int) {
+        ++count;
+        token.Cancel();
+      },
+      args...);
+
+  KATANA_LOG_VASSERT(count < kSize / 2, "ran {} iterations", count.load());
+}
+
+void
+TestDeadlineForEach() {
+  katana::CancellationToken token;
+  token.SetTimeout(std::chrono::milliseconds(10));
+  katana::CancellationScope scope(&token);
+
+  // Never terminates on its own
+  katana::for_each(
+      katana::iterate(0, 1024), [&](int i, auto& ctx) { ctx.push(i); },
+      katana::disable_conflict_detection());
+
+  KATANA_LOG_ASSERT(token.IsCancelled());
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestScope();
+  TestCancelledBeforeStart();
+  TestCancelDoAll();
+  TestCancelDoAll(katana::steal());
+  TestDeadlineForEach();
+
+  return 0;
+}
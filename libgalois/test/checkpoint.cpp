@@ -0,0 +1,179 @@
+#include "katana/analytics/Checkpoint.h"
+
+#include <cmath>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace fs = boost::filesystem;
+
+using katana::analytics::Checkpointer;
+using katana::analytics::CheckpointScope;
+using katana::analytics::PagerankPlan;
+
+constexpr float kTolerance = 1.0e-7;
+
+size_t
+NumFiles(const std::string& dir) {
+  if (!fs::exists(dir)) {
+    return 0;
+  }
+  return std::distance(fs::directory_iterator(dir), fs::directory_iterator());
+}
+
+std::shared_ptr<arrow::Table>
+MakeState(uint64_t size, uint64_t iteration) {
+  auto column_res = katana::analytics::MakeCheckpointColumn<uint64_t>(
+      size, [&](uint64_t i) { return i * iteration; });
+  KATANA_LOG_ASSERT(column_res);
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("value", arrow::uint64())}),
+      {column_res.value()});
+}
+
+void
+CheckState(const arrow::Table& state, uint64_t size, uint64_t iteration) {
+  std::vector<uint64_t> values(size);
+  auto res = katana::analytics::RestoreCheckpointColumn<uint64_t>(
+      state, "value", size, [&](uint64_t i, uint64_t v) { values[i] = v; });
+  KATANA_LOG_VASSERT(res, "restoring: {}", res.error());
+  for (uint64_t i = 0; i < size; ++i) {
+    KATANA_LOG_ASSERT(values[i] == i * iteration);
+  }
+
+  KATANA_LOG_ASSERT(!katana::analytics::RestoreCheckpointColumn<uint64_t>(
+      state, "value", size + 1, [](uint64_t, uint64_t) {}));
+  KATANA_LOG_ASSERT(!katana::analytics::RestoreCheckpointColumn<double>(
+      state, "value", size, [](uint64_t, double) {}));
+}
+
+void
+TestSaveRestore(const std::string& dir) {
+  constexpr uint64_t kSize = 1000;
+
+  auto ckpt_res = Checkpointer::Make(dir, 2);
+  KATANA_LOG_ASSERT(ckpt_res);
+  std::unique_ptr<Checkpointer> ckpt = std::move(ckpt_res.value());
+  KATANA_LOG_ASSERT(!ckpt->IsDue(1) && ckpt->IsDue(2) && ckpt->IsDue(4));
+
+  auto restore_res = ckpt->Restore("a");
+  KATANA_LOG_VASSERT(restore_res, "restoring: {}", restore_res.error());
+  KATANA_LOG_ASSERT(!restore_res.value());
+
+  for (uint64_t iteration : {2, 4}) {
+    auto res = ckpt->Save("a", iteration, MakeState(kSize, iteration));
+    KATANA_LOG_VASSERT(res, "saving: {}", res.error());
+    res = ckpt->Finish();
+    KATANA_LOG_VASSERT(res, "finishing: {}", res.error());
+  }
+  // Only the last checkpoint and its manifest are kept
+  KATANA_LOG_VASSERT(NumFiles(dir) == 2, "{} files", NumFiles(dir));
+
+  // A checkpointer after a restart finds the last checkpoint
+  ckpt_res = Checkpointer::Make(dir, 2);
+  KATANA_LOG_ASSERT(ckpt_res);
+  ckpt = std::move(ckpt_res.value());
+  restore_res = ckpt->Restore("a");
+  KATANA_LOG_VASSERT(restore_res, "restoring: {}", restore_res.error());
+  KATANA_LOG_ASSERT(restore_res.value());
+  const auto& checkpoint = *restore_res.value();
+  KATANA_LOG_ASSERT(checkpoint.analytic == "a" && checkpoint.iteration == 4);
+  CheckState(*checkpoint.state, kSize, 4);
+
+  restore_res = ckpt->Restore("b");
+  KATANA_LOG_ASSERT(restore_res && !restore_res.value());
+
+  auto clear_res = ckpt->Clear();
+  KATANA_LOG_VASSERT(clear_res, "clearing: {}", clear_res.error());
+  KATANA_LOG_ASSERT(NumFiles(dir) == 0);
+  restore_res = ckpt->Restore("a");
+  KATANA_LOG_ASSERT(restore_res && !restore_res.value());
+}
+
+void
+CheckRanks(
+    const std::vector<float>& actual, const std::vector<float>& expected) {
+  KATANA_LOG_ASSERT(actual.size() == expected.size());
+  for (size_t n = 0; n < expected.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(actual[n] - expected[n]) <= 1.0e-3 * expected[n],
+        "node {}: expected {} found {}", n, expected[n], actual[n]);
+  }
+}
+
+void
+TestResume(const std::string& dir, PagerankPlan plan, PagerankPlan stopped) {
+  RandomPolicy policy{4};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(1000, 0, &policy);
+
+  auto res = katana::analytics::Pagerank(g.get(), "expected", plan);
+  KATANA_LOG_VASSERT(res, "pagerank failed: {}", res.error());
+  std::vector<float> expected = Ranks(g.get(), "expected");
+
+  {
+    // A run stopped early, as by a preemption, leaves a checkpoint
+    auto ckpt_res = Checkpointer::Make(dir, 5);
+    KATANA_LOG_ASSERT(ckpt_res);
+    CheckpointScope scope(ckpt_res.value().get());
+    res = katana::analytics::Pagerank(g.get(), "stopped", stopped);
+    KATANA_LOG_VASSERT(res, "pagerank failed: {}", res.error());
+  }
+  KATANA_LOG_VASSERT(NumFiles(dir) == 2, "{} files", NumFiles(dir));
+
+  auto ckpt_res = Checkpointer::Make(dir, 5);
+  KATANA_LOG_ASSERT(ckpt_res);
+  std::unique_ptr<Checkpointer> ckpt = std::move(ckpt_res.value());
+  {
+    CheckpointScope scope(ckpt.get());
+    res = katana::analytics::Pagerank(g.get(), "resumed", plan);
+    KATANA_LOG_VASSERT(res, "pagerank failed: {}", res.error());
+    CheckRanks(Ranks(g.get(), "resumed"), expected);
+
+    // The checkpoint of one graph is not restored into another
+    std::unique_ptr<katana::PropertyGraph> other =
+        MakeFileGraph<int64_t>(500, 0, &policy);
+    res = katana::analytics::Pagerank(other.get(), "expected", plan);
+    KATANA_LOG_VASSERT(res, "pagerank failed: {}", res.error());
+    {
+      CheckpointScope no_checkpoints(nullptr);
+      res = katana::analytics::Pagerank(other.get(), "unchecked", plan);
+      KATANA_LOG_VASSERT(res, "pagerank failed: {}", res.error());
+    }
+    CheckRanks(Ranks(other.get(), "expected"), Ranks(other.get(), "unchecked"));
+  }
+
+  auto clear_res = ckpt->Clear();
+  KATANA_LOG_VASSERT(clear_res, "clearing: {}", clear_res.error());
+  KATANA_LOG_ASSERT(NumFiles(dir) == 0);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/checkpoint");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());  // path() because local
+
+  TestSaveRestore(dir);
+
+  TestResume(
+      dir, PagerankPlan::PullTopological(kTolerance),
+      PagerankPlan::PullTopological(kTolerance, 12));
+  TestResume(
+      dir, PagerankPlan::PullResidual(kTolerance),
+      PagerankPlan::PullResidual(kTolerance, 12));
+
+  fs::remove_all(dir);
+  return 0;
+}
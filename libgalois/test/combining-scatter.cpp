@@ -0,0 +1,92 @@
+#include "katana/CombiningScatter.h"
+
+#include <atomic>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Nodes 0 and 1 are hubs that every node has an edge to; other nodes have
+/// an edge to the next node
+class HubPolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    return {0, 1, static_cast<uint32_t>((node_id + 1) % num_nodes)};
+  }
+};
+
+void
+TestScatter(
+    const katana::GraphTopology& topology, size_t buffer_entries,
+    uint64_t min_hot_degree) {
+  std::vector<std::atomic<uint64_t>> values(topology.num_nodes());
+  katana::CombiningScatter<uint64_t> scatter(
+      topology, values.data(), buffer_entries, min_hot_degree);
+  KATANA_LOG_ASSERT(scatter.IsHot(0) && scatter.IsHot(1));
+
+  // Each add to a node is reported with the value before it, so exactly one
+  // crosses half the in-degree
+  std::vector<uint64_t> in_degree(topology.num_nodes());
+  for (auto e = 0ul; e < topology.num_edges(); ++e) {
+    in_degree[topology.edge_dest(e)] += 1;
+  }
+  std::vector<std::atomic<int>> crossings(topology.num_nodes());
+  std::atomic<uint64_t> flushed{0};
+  auto on_flush = [&](Node n, uint64_t old, uint64_t delta) {
+    uint64_t half = in_degree[n] / 2;
+    if (old < half && old + delta >= half) {
+      crossings[n] += 1;
+    }
+    flushed += delta;
+  };
+
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        for (auto e : topology.edges(n)) {
+          scatter.Add(topology.edge_dest(e), 1, on_flush);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  scatter.Flush(on_flush);
+
+  KATANA_LOG_ASSERT(flushed == topology.num_edges());
+  for (Node n : topology) {
+    KATANA_LOG_VASSERT(
+        values[n] == in_degree[n], "node {} is {}, not {}", n,
+        values[n].load(), in_degree[n]);
+    KATANA_LOG_ASSERT(in_degree[n] < 2 || crossings[n] == 1);
+  }
+
+  // Flushed buffers are empty
+  scatter.Flush(on_flush);
+  KATANA_LOG_ASSERT(flushed == topology.num_edges());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  HubPolicy policy;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(10000, 0, &policy);
+
+  TestScatter(
+      g->topology(), katana::CombiningScatter<uint64_t>::kDefaultBufferEntries,
+      0);
+  // Evictions from a buffer of one entry
+  TestScatter(g->topology(), 1, 100);
+
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include <cstdint>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/CompactTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+using DataType = int64_t;
+
+/// Both topologies have the same edges, with the same ids
+template <typename Topology>
+void
+CheckSameEdges(
+    const katana::GraphTopology& expected, const Topology& topology) {
+  KATANA_LOG_ASSERT(topology.num_nodes() == expected.num_nodes());
+  KATANA_LOG_ASSERT(topology.num_edges() == expected.num_edges());
+  for (auto n : expected) {
+    auto [begin, end] = expected.edge_range(n);
+    auto [compact_begin, compact_end] = topology.edge_range(n);
+    KATANA_LOG_VASSERT(
+        compact_begin == begin && compact_end == end, "edges of node {}", n);
+    for (auto e : topology.edges(n)) {
+      KATANA_LOG_ASSERT(topology.edge_dest(e) == expected.edge_dest(e));
+    }
+  }
+}
+
+void
+TestCompactTopology(size_t num_nodes) {
+  RandomPolicy policy{3};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, &policy);
+  const katana::GraphTopology& topology = g->topology();
+
+  KATANA_LOG_ASSERT(katana::CompactTopology<uint32_t>::Fits(topology));
+  katana::CompactTopology<uint32_t> compact(topology);
+  CheckSameEdges(topology, compact);
+
+  uint64_t num_edges = katana::WithCompactTopology(
+      topology, [&](const auto& picked) {
+        CheckSameEdges(topology, picked);
+        return picked.num_edges();
+      });
+  KATANA_LOG_ASSERT(num_edges == topology.num_edges());
+
+  // Graphs with more edges than fit EdgeIndex do not fit
+  KATANA_LOG_ASSERT(
+      katana::CompactTopology<uint8_t>::Fits(topology) ==
+      (topology.num_edges() <= UINT8_MAX));
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestCompactTopology(1);
+  TestCompactTopology(10);
+  TestCompactTopology(1000);
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/CompressedTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const char* kCommandLine = "compressed-topology";
+
+/// Write g to a new RDG, with its topology compressed if compress
+std::string
+WriteGraph(katana::PropertyGraph* g, bool compress) {
+  auto uri_res = katana::Uri::MakeRand("/tmp/compressedtopology");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  g->set_compress_topology(compress);
+  if (auto res = g->Write(rdg_dir, kCommandLine); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing graph: {}", res.error());
+  }
+  return rdg_dir;
+}
+
+/// The compressed topology has the edges of expected, in the same order
+void
+CheckSameDests(
+    const katana::GraphTopology& expected,
+    const katana::CompressedTopology& topology) {
+  KATANA_LOG_ASSERT(topology.num_nodes() == expected.num_nodes());
+  KATANA_LOG_ASSERT(topology.num_edges() == expected.num_edges());
+  for (auto n : topology) {
+    std::vector<uint32_t> dests;
+    for (auto dest : topology.dests(n)) {
+      dests.emplace_back(dest);
+    }
+    std::vector<uint32_t> expected_dests;
+    for (auto e : expected.edges(n)) {
+      expected_dests.emplace_back(expected.edge_dest(e));
+    }
+    KATANA_LOG_VASSERT(dests == expected_dests, "edges of node {}", n);
+    KATANA_LOG_ASSERT(topology.degree(n) == dests.size());
+  }
+}
+
+void
+TestCompressedTopology(size_t num_nodes) {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<int64_t>(num_nodes, 0, &policy);
+  auto sort_res = katana::SortAllEdgesByDest(g.get());
+  KATANA_LOG_VASSERT(sort_res, "sorting edges: {}", sort_res.error());
+
+  std::string rdg_dir = WriteGraph(g.get(), true);
+  auto res = katana::CompressedTopology::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(res, "reading topology: {}", res.error());
+  const katana::CompressedTopology& topology = res.value();
+  CheckSameDests(g->topology(), topology);
+
+  // Sorted destinations take fewer bytes than the 4 of GraphTopology
+  KATANA_LOG_ASSERT(
+      topology.dest_blocks_size() <= topology.num_edges() * sizeof(uint32_t));
+
+  // Degrees come from the out indices, without decoding
+  uint64_t num_edges = 0;
+  for (auto n : topology) {
+    num_edges += topology.degree(n);
+  }
+  KATANA_LOG_ASSERT(num_edges == topology.num_edges());
+}
+
+/// Uncompressed topologies are mapped by PropertyGraph instead
+void
+TestUncompressed() {
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<int64_t>(10, 0, &policy);
+
+  std::string rdg_dir = WriteGraph(g.get(), false);
+  auto res = katana::CompressedTopology::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::NotImplemented);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestCompressedTopology(1);
+  TestCompressedTopology(100);
+  TestCompressedTopology(2000);
+  TestUncompressed();
+
+  return 0;
+}
@@ -0,0 +1,131 @@
+#include "katana/ConcurrentHashMap.h"
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+/// Insert each of num_keys keys many times while looking them up
+void
+TestConcurrentInsert(uint64_t num_keys) {
+  constexpr uint64_t kRepeats = 4;
+  katana::ConcurrentHashMap<uint64_t, std::atomic<uint64_t>> map(num_keys);
+  KATANA_LOG_ASSERT(map.num_slots() >= 2 * num_keys);
+
+  katana::GAccumulator<uint64_t> inserted;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kRepeats * num_keys),
+      [&](uint64_t i) {
+        // Keys are spaced out, which the table must spread over its slots
+        uint64_t key = (i % num_keys) * 1024;
+        auto [count, is_new] = map.Insert(key, 0);
+        inserted += is_new;
+        *count += 1;
+        std::atomic<uint64_t>* found = map.Find(key);
+        KATANA_LOG_ASSERT(found == count);
+      },
+      katana::steal(), katana::no_stats());
+
+  KATANA_LOG_ASSERT(inserted.reduce() == num_keys);
+  KATANA_LOG_ASSERT(map.size() == num_keys);
+  for (uint64_t key = 0; key < num_keys; ++key) {
+    const auto* count = map.Find(key * 1024);
+    KATANA_LOG_VASSERT(
+        count && *count == kRepeats, "key {} counted {}", key,
+        count ? count->load() : 0);
+    KATANA_LOG_ASSERT(!map.Find(key * 1024 + 1));
+  }
+}
+
+/// Build a dictionary of string IDs, some of which repeat, zero-copy
+void
+TestStringIDs(size_t num_rows) {
+  std::vector<std::string> ids;
+  for (size_t i = 0; i < num_rows; ++i) {
+    ids.emplace_back("node-" + std::to_string(i % (num_rows / 2)));
+  }
+
+  katana::ConcurrentHashMap<std::string_view, size_t> map(num_rows);
+  map.InsertAll(size_t{0}, num_rows, [&](size_t i) {
+    return std::make_pair(std::string_view(ids[i]), i);
+  });
+
+  KATANA_LOG_ASSERT(map.size() == num_rows / 2);
+  for (const std::string& id : ids) {
+    const size_t* row = map.Find(id);
+    KATANA_LOG_VASSERT(row && ids[*row] == id, "{} not found", id);
+  }
+  KATANA_LOG_ASSERT(!map.Find("node-"));
+
+  std::atomic<size_t> visited{0};
+  map.ForEach([&](std::string_view id, size_t row) {
+    KATANA_LOG_ASSERT(ids[row] == id);
+    visited += 1;
+  });
+  KATANA_LOG_ASSERT(visited == num_rows / 2);
+}
+
+/// Aggregate weights by key in an insert phase, then look them up
+void
+TestPhaseConcurrent(uint32_t num_keys) {
+  katana::PhaseConcurrentHashMap<uint32_t, std::atomic<double>> map(num_keys);
+  for (int round = 0; round < 2; ++round) {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, 3 * num_keys),
+        [&](uint32_t i) {
+          katana::atomicAdd(*map.Insert(i % num_keys).first, 0.5);
+        },
+        katana::steal(), katana::no_stats());
+
+    KATANA_LOG_ASSERT(map.size() == num_keys);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_keys),
+        [&](uint32_t key) {
+          const std::atomic<double>* weight = map.Find(key);
+          KATANA_LOG_ASSERT(weight && *weight == 1.5);
+        },
+        katana::no_stats());
+    KATANA_LOG_ASSERT(!map.Find(num_keys));
+
+    // Cleared maps start from zero weights
+    map.Clear();
+    KATANA_LOG_ASSERT(map.size() == 0);
+    KATANA_LOG_ASSERT(!map.Find(0));
+  }
+
+  katana::PhaseConcurrentHashMap<uint64_t, uint64_t> squares(num_keys);
+  squares.InsertAll(uint64_t{0}, uint64_t{num_keys}, [](uint64_t i) {
+    return std::make_pair(i, i * i);
+  });
+  KATANA_LOG_ASSERT(!squares.Insert(3, 0).second);
+  KATANA_LOG_ASSERT(*squares.Find(3) == 9);
+  uint64_t sum = 0;
+  for (uint64_t i = 0; i < num_keys; ++i) {
+    sum += *squares.Find(i);
+  }
+  std::atomic<uint64_t> visited_sum{0};
+  squares.ForEach([&](uint64_t, uint64_t square) { visited_sum += square; });
+  KATANA_LOG_ASSERT(visited_sum == sum);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestConcurrentInsert(1);
+  TestConcurrentInsert(10000);
+  TestStringIDs(20000);
+  TestPhaseConcurrent(10000);
+
+  return 0;
+}
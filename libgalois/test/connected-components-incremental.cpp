@@ -0,0 +1,92 @@
+#include <map>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/connected_components/connected_components.h"
+
+using DataType = int64_t;
+using Edge = std::pair<uint32_t, uint32_t>;
+using katana::analytics::ConnectedComponentsPlan;
+
+/// Serial union-find to compute the expected components
+uint32_t
+Find(std::vector<uint32_t>* parent, uint32_t n) {
+  while ((*parent)[n] != n) {
+    n = (*parent)[n] = (*parent)[(*parent)[n]];
+  }
+  return n;
+}
+
+/// Check that two nodes have the same label exactly when they are in the
+/// same expected component
+void
+CheckComponents(katana::PropertyGraph* pg, std::vector<uint32_t>* parent) {
+  auto res = pg->GetNodePropertyTyped<uint64_t>("component");
+  KATANA_LOG_VASSERT(res, "no components: {}", res.error());
+  auto labels = res.value();
+
+  std::map<uint64_t, uint32_t> rep_of_label;
+  std::map<uint32_t, uint64_t> label_of_rep;
+  for (uint32_t n = 0; n < parent->size(); ++n) {
+    uint32_t rep = Find(parent, n);
+    uint64_t label = labels->Value(n);
+    auto [rep_it, new_label] = rep_of_label.emplace(label, rep);
+    auto [label_it, new_rep] = label_of_rep.emplace(rep, label);
+    KATANA_LOG_VASSERT(
+        rep_it->second == rep && label_it->second == label,
+        "node {} has label {} but expected component {}", n, label, rep);
+  }
+}
+
+void
+TestIncremental(size_t num_nodes, ConnectedComponentsPlan plan) {
+  LinePolicy policy{0};
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, &policy);
+  auto cc_res =
+      katana::analytics::ConnectedComponents(pg.get(), "component", plan);
+  KATANA_LOG_VASSERT(cc_res, "components failed: {}", cc_res.error());
+
+  std::vector<uint32_t> parent(num_nodes);
+  std::iota(parent.begin(), parent.end(), 0);
+  CheckComponents(pg.get(), &parent);
+
+  std::mt19937 gen(num_nodes);
+  std::uniform_int_distribution<uint32_t> dist(0, num_nodes - 1);
+  for (size_t batch_size : {0, 1, 10, 100, 1000}) {
+    std::vector<Edge> batch;
+    for (size_t i = 0; i < batch_size; ++i) {
+      batch.emplace_back(dist(gen), dist(gen));
+      parent[Find(&parent, batch.back().first)] =
+          Find(&parent, batch.back().second);
+    }
+    auto res = katana::analytics::ConnectedComponentsIncremental(
+        pg.get(), "component", batch);
+    KATANA_LOG_VASSERT(res, "incremental components failed: {}", res.error());
+    CheckComponents(pg.get(), &parent);
+  }
+
+  // An edge that is not between nodes of the graph is rejected
+  std::vector<Edge> bad{{static_cast<uint32_t>(num_nodes), 0}};
+  auto res = katana::analytics::ConnectedComponentsIncremental(
+      pg.get(), "component", bad);
+  KATANA_LOG_ASSERT(!res);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (auto plan :
+       {ConnectedComponentsPlan::Asynchronous(),
+        ConnectedComponentsPlan::AfforestCompact()}) {
+    TestIncremental(1, plan);
+    TestIncremental(2000, plan);
+  }
+
+  return 0;
+}
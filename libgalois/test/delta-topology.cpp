@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/DeltaTopology.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+using DataType = int64_t;
+using Node = katana::DeltaTopology::Node;
+
+struct Change {
+  Node src;
+  Node dst;
+  bool insert;
+};
+
+std::vector<uint32_t>
+Sorted(std::vector<uint32_t> v) {
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+void
+TestDeltaTopology(size_t num_nodes) {
+  RandomPolicy policy{3};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, &policy);
+  katana::GraphTopology base = g->topology();
+
+  // Remember where each edge came from through an edge property
+  std::vector<int64_t> edge_ids(base.num_edges());
+  std::vector<uint32_t> edge_srcs(base.num_edges());
+  std::vector<std::vector<uint32_t>> expected(num_nodes);
+  for (Node n = 0; n < num_nodes; ++n) {
+    for (auto e : base.edges(n)) {
+      edge_ids[e] = e;
+      edge_srcs[e] = n;
+      expected[n].emplace_back(base.edge_dest(e));
+    }
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("id", arrow::int64())}),
+      {katana::BuildArray(edge_ids)});
+  auto add_res = g->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(add_res, "could not add ids: {}", add_res.error());
+
+  katana::DeltaTopology delta(base);
+
+  for (size_t batch = 0; batch < 3; ++batch) {
+    std::vector<Change> changes;
+    for (size_t i = 0; i < num_nodes; ++i) {
+      Node src = (i * 17 + batch) % num_nodes;
+      Node dst = (i * 5 + batch * 3) % num_nodes;
+      changes.emplace_back(Change{src, dst, i % 3 != 0});
+      // Delete an edge that exists in the base
+      if (i % 4 == 0 && !expected[i].empty()) {
+        changes.emplace_back(Change{Node(i), expected[i].front(), false});
+      }
+    }
+
+    katana::do_all(katana::iterate(changes), [&](const Change& c) {
+      if (c.insert) {
+        delta.InsertEdge(c.src, c.dst);
+      } else {
+        delta.DeleteEdge(c.src, c.dst);
+      }
+    });
+    auto res = delta.Apply();
+    KATANA_LOG_VASSERT(res, "apply failed: {}", res.error());
+
+    // Deletions of a batch come before its insertions
+    for (const auto& c : changes) {
+      auto& edges = expected[c.src];
+      auto it = std::find(edges.begin(), edges.end(), c.dst);
+      if (!c.insert && it != edges.end()) {
+        edges.erase(it);
+      }
+    }
+    for (const auto& c : changes) {
+      if (c.insert) {
+        expected[c.src].emplace_back(c.dst);
+      }
+    }
+
+    uint64_t num_edges = 0;
+    for (Node n = 0; n < num_nodes; ++n) {
+      std::vector<uint32_t> actual;
+      delta.ForEachOutNeighbor(n, [&](Node dst) { actual.emplace_back(dst); });
+      KATANA_LOG_VASSERT(
+          Sorted(actual) == Sorted(expected[n]), "batch {} node {}", batch, n);
+      KATANA_LOG_ASSERT(delta.out_degree(n) == actual.size());
+      num_edges += actual.size();
+    }
+    KATANA_LOG_ASSERT(delta.num_edges() == num_edges);
+  }
+
+  // Edges must be between nodes; the batch is discarded
+  delta.InsertEdge(num_nodes, 0);
+  KATANA_LOG_ASSERT(!delta.Apply());
+  KATANA_LOG_ASSERT(delta.Apply());
+
+  uint64_t num_inserted = delta.num_inserted();
+  auto apply_res = g->ApplyDeltaTopology(&delta);
+  KATANA_LOG_VASSERT(apply_res, "could not apply: {}", apply_res.error());
+  KATANA_LOG_ASSERT(delta.num_inserted() == 0 && delta.num_deleted() == 0);
+
+  const katana::GraphTopology& compacted = g->topology();
+  auto ids_res = g->GetEdgePropertyTyped<int64_t>("id");
+  KATANA_LOG_VASSERT(ids_res, "no ids: {}", ids_res.error());
+  auto ids = ids_res.value();
+  KATANA_LOG_ASSERT(uint64_t(ids->length()) == compacted.num_edges());
+  KATANA_LOG_ASSERT(uint64_t(ids->null_count()) == num_inserted);
+
+  for (Node n = 0; n < num_nodes; ++n) {
+    std::vector<uint32_t> actual;
+    for (auto e : compacted.edges(n)) {
+      Node dst = compacted.edge_dest(e);
+      actual.emplace_back(dst);
+      if (ids->IsValid(e)) {
+        // A kept edge still has the property of the same base edge
+        int64_t id = ids->Value(e);
+        KATANA_LOG_ASSERT(edge_srcs[id] == n);
+        KATANA_LOG_ASSERT(base.edge_dest(id) == dst);
+      }
+    }
+    KATANA_LOG_VASSERT(
+        Sorted(actual) == Sorted(expected[n]), "compacted node {}", n);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestDeltaTopology(1000);
+
+  return 0;
+}
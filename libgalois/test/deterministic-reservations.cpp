@@ -0,0 +1,92 @@
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/DeterministicReservations.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+/// Greedy maximal matching: edge i joins the matching unless an earlier
+/// edge of the matching shares a node with it
+struct MatchingStep {
+  const std::vector<std::pair<uint32_t, uint32_t>>& edges;
+  std::vector<katana::ReservationCell> cells;
+  std::vector<uint8_t> matched_nodes;
+  std::vector<uint8_t> matching;
+
+  MatchingStep(
+      const std::vector<std::pair<uint32_t, uint32_t>>& e, uint32_t num_nodes)
+      : edges(e),
+        cells(num_nodes),
+        matched_nodes(num_nodes, 0),
+        matching(e.size(), 0) {}
+
+  bool Reserve(uint64_t i) {
+    auto [u, v] = edges[i];
+    if (u == v || matched_nodes[u] || matched_nodes[v]) {
+      return false;
+    }
+    cells[u].Reserve(i);
+    cells[v].Reserve(i);
+    return true;
+  }
+
+  bool Commit(uint64_t i) {
+    auto [u, v] = edges[i];
+    bool holds_u = cells[u].Release(i);
+    bool holds_v = cells[v].Release(i);
+    if (!holds_u || !holds_v) {
+      return false;
+    }
+    matched_nodes[u] = 1;
+    matched_nodes[v] = 1;
+    matching[i] = 1;
+    return true;
+  }
+};
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  constexpr uint32_t kNumNodes = 5000;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<uint32_t> dist(0, kNumNodes - 1);
+  std::vector<std::pair<uint32_t, uint32_t>> edges(50000);
+  for (auto& edge : edges) {
+    edge = {dist(gen), dist(gen)};
+  }
+
+  std::vector<uint8_t> expected(edges.size(), 0);
+  std::vector<uint8_t> matched(kNumNodes, 0);
+  for (size_t i = 0; i < edges.size(); ++i) {
+    auto [u, v] = edges[i];
+    if (u != v && !matched[u] && !matched[v]) {
+      matched[u] = matched[v] = 1;
+      expected[i] = 1;
+    }
+  }
+
+  // The result is that of the serial loop for any threads and window
+  for (unsigned threads : {1, 4}) {
+    katana::setActiveThreads(threads);
+    for (uint64_t window : {0, 1, 64, 100000}) {
+      for (bool fixed : {false, true}) {
+        MatchingStep step(edges, kNumNodes);
+        katana::DeterministicReservationsOptions opts;
+        opts.window = window;
+        opts.fixed_window = fixed;
+        auto stats =
+            katana::deterministic_reservations(edges.size(), step, opts);
+        KATANA_LOG_ASSERT(step.matching == expected);
+        KATANA_LOG_ASSERT(stats.rounds > 0);
+        KATANA_LOG_ASSERT(window != 1 || !fixed || stats.retries == 0);
+      }
+    }
+  }
+
+  MatchingStep empty(edges, kNumNodes);
+  KATANA_LOG_ASSERT(katana::deterministic_reservations(0, empty).rounds == 0);
+
+  return 0;
+}
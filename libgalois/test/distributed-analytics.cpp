@@ -0,0 +1,101 @@
+#include <cmath>
+#include <cstdint>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/MirrorSync.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "tsuba/tsuba.h"
+
+// A graph loaded whole is a single partition of masters, which the
+// distributed plans run on with the one host of the job
+
+using DataType = int64_t;
+
+void
+TestMirrorSync() {
+  LinePolicy policy{2};
+  auto pg = MakeFileGraph<DataType>(100, 0, &policy);
+  auto sync_res = katana::MirrorSync::Make(*pg, tsuba::Comm());
+  KATANA_LOG_VASSERT(sync_res, "making sync failed: {}", sync_res.error());
+  katana::MirrorSync& sync = sync_res.value();
+  KATANA_LOG_ASSERT(sync.num_hosts() == 1);
+  KATANA_LOG_ASSERT(sync.num_masters() == 100);
+  KATANA_LOG_ASSERT(sync.num_global_nodes() == 100);
+  KATANA_LOG_ASSERT(sync.global_id(42) == 42);
+  KATANA_LOG_ASSERT(sync.SumAll(7) == 7);
+}
+
+void
+TestBfs() {
+  RandomPolicy policy{3};
+  auto pg = MakeFileGraph<DataType>(2000, 0, &policy);
+  auto res = katana::analytics::Bfs(pg.get(), 5, "level");
+  KATANA_LOG_VASSERT(res, "bfs failed: {}", res.error());
+  res = katana::analytics::Bfs(
+      pg.get(), 5, "distributed-level",
+      katana::analytics::BfsPlan::Distributed());
+  KATANA_LOG_VASSERT(res, "distributed bfs failed: {}", res.error());
+
+  auto expected = pg->GetNodePropertyTyped<uint32_t>("level").value();
+  auto levels = pg->GetNodePropertyTyped<uint32_t>("distributed-level").value();
+  for (uint32_t n = 0; n < pg->num_nodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        levels->Value(n) == expected->Value(n), "node {}: {} != {}", n,
+        levels->Value(n), expected->Value(n));
+  }
+
+  res = katana::analytics::Bfs(
+      pg.get(), pg->num_nodes(), "out-of-range",
+      katana::analytics::BfsPlan::Distributed());
+  KATANA_LOG_ASSERT(!res);
+}
+
+void
+TestConnectedComponents() {
+  // A cycle, whose nodes are all labeled by the least of them
+  LinePolicy policy{1};
+  auto pg = MakeFileGraph<DataType>(1000, 0, &policy);
+  auto res = katana::analytics::ConnectedComponents(
+      pg.get(), "component",
+      katana::analytics::ConnectedComponentsPlan::Distributed());
+  KATANA_LOG_VASSERT(res, "distributed components failed: {}", res.error());
+
+  auto components = pg->GetNodePropertyTyped<uint64_t>("component").value();
+  for (uint32_t n = 0; n < pg->num_nodes(); ++n) {
+    KATANA_LOG_VASSERT(components->Value(n) == 0, "node {}", n);
+  }
+}
+
+void
+TestPagerank() {
+  // On a cycle, every rank converges to 1
+  LinePolicy policy{1};
+  auto pg = MakeFileGraph<DataType>(1000, 0, &policy);
+  auto res = katana::analytics::Pagerank(
+      pg.get(), "rank", katana::analytics::PagerankPlan::Distributed(1e-5));
+  KATANA_LOG_VASSERT(res, "distributed pagerank failed: {}", res.error());
+
+  auto ranks = pg->GetNodePropertyTyped<float>("rank").value();
+  for (uint32_t n = 0; n < pg->num_nodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::fabs(ranks->Value(n) - 1) < 1e-3, "node {}: {}", n,
+        ranks->Value(n));
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestMirrorSync();
+  TestBfs();
+  TestConnectedComponents();
+  TestPagerank();
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <random>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+/// Fill a bitset and its expected bits with random bits
+void
+RandomBits(
+    size_t num_bits, uint32_t seed, katana::DynamicBitset* bitset,
+    std::vector<bool>* bits) {
+  std::mt19937 gen(seed);
+  std::bernoulli_distribution coin(0.3);
+  bitset->resize(num_bits);
+  bitset->reset();
+  bits->assign(num_bits, false);
+  for (size_t i = 0; i < num_bits; ++i) {
+    if (coin(gen)) {
+      bitset->set(i);
+      (*bits)[i] = true;
+    }
+  }
+}
+
+void
+CheckBits(const katana::DynamicBitset& bitset, const std::vector<bool>& bits) {
+  KATANA_LOG_ASSERT(bitset.size() == bits.size());
+  size_t count = 0;
+  std::vector<uint64_t> expected_offsets;
+  for (size_t i = 0; i < bits.size(); ++i) {
+    KATANA_LOG_VASSERT(bitset.test(i) == bits[i], "bit {}", i);
+    if (bits[i]) {
+      count += 1;
+      expected_offsets.push_back(i);
+    }
+  }
+  KATANA_LOG_ASSERT(bitset.count() == count);
+  KATANA_LOG_ASSERT(bitset.GetOffsets<uint64_t>() == expected_offsets);
+
+  // FindNext visits the set bits in order
+  std::vector<uint64_t> found;
+  for (size_t i = bitset.FindNext(0); i < bitset.size();
+       i = bitset.FindNext(i + 1)) {
+    found.push_back(i);
+  }
+  KATANA_LOG_ASSERT(found == expected_offsets);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  // Sizes that do and do not end on a word
+  for (size_t num_bits : {0, 1, 64, 1000, 100003}) {
+    katana::DynamicBitset a;
+    katana::DynamicBitset b;
+    std::vector<bool> a_bits;
+    std::vector<bool> b_bits;
+    RandomBits(num_bits, 1, &a, &a_bits);
+    RandomBits(num_bits, 2, &b, &b_bits);
+    CheckBits(a, a_bits);
+
+    katana::DynamicBitset result;
+    std::vector<bool> expected(num_bits);
+    RandomBits(num_bits, 3, &result, &expected);
+
+    result.bitwise_and(a, b);
+    for (size_t i = 0; i < num_bits; ++i) {
+      expected[i] = a_bits[i] && b_bits[i];
+    }
+    CheckBits(result, expected);
+
+    result.bitwise_or(a);
+    for (size_t i = 0; i < num_bits; ++i) {
+      expected[i] = expected[i] || a_bits[i];
+    }
+    CheckBits(result, expected);
+
+    result.bitwise_andnot(b);
+    for (size_t i = 0; i < num_bits; ++i) {
+      expected[i] = expected[i] && !b_bits[i];
+    }
+    CheckBits(result, expected);
+
+    result.bitwise_xor(a, b);
+    for (size_t i = 0; i < num_bits; ++i) {
+      expected[i] = a_bits[i] != b_bits[i];
+    }
+    CheckBits(result, expected);
+
+    // The complement leaves bits past the end clear
+    result.bitwise_not();
+    for (size_t i = 0; i < num_bits; ++i) {
+      expected[i] = !expected[i];
+    }
+    CheckBits(result, expected);
+
+    result.reset();
+    CheckBits(result, std::vector<bool>(num_bits, false));
+  }
+
+  // Owner writes from threads that each hold whole words
+  katana::DynamicBitset owned;
+  owned.resize(64 * 1024);
+  katana::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [begin, end] =
+        katana::block_range(size_t{0}, size_t{1024}, tid, nthreads);
+    for (size_t w = begin; w < end; ++w) {
+      for (size_t bit = 0; bit < 64; bit += 2) {
+        KATANA_LOG_ASSERT(!owned.set_owned(w * 64 + bit));
+      }
+      KATANA_LOG_ASSERT(owned.reset_owned(w * 64));
+    }
+  });
+  KATANA_LOG_ASSERT(owned.count() == 1024 * 31);
+
+  // Shrinking drops the bits past the new end
+  owned.resize(100);
+  KATANA_LOG_ASSERT(owned.count() == 48);
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include "katana/EdgeBalancedRange.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Node 0 is a hub with an edge to every node, and every other node has an
+/// edge to node 0 or none
+class HubPolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    if (node_id == 0) {
+      for (size_t i = 0; i < num_nodes; ++i) {
+        r.emplace_back(i);
+      }
+    } else if (node_id % 2 == 0) {
+      r.emplace_back(0);
+    }
+    return r;
+  }
+};
+
+/// \returns the weight of each thread's local range of range
+template <typename RangeTy, typename WeightFn>
+std::vector<uint64_t>
+LocalWeights(const RangeTy& range, const WeightFn& weight) {
+  std::vector<uint64_t> weights(katana::getActiveThreads());
+  katana::on_each(
+      [&](unsigned tid, unsigned) {
+        for (auto ii = range.local_begin(); ii != range.local_end(); ++ii) {
+          weights[tid] += weight(*ii);
+        }
+      },
+      katana::no_stats());
+  return weights;
+}
+
+void
+CheckBalanced(
+    const std::vector<uint64_t>& weights, uint64_t total, uint64_t max_item) {
+  uint64_t sum = 0;
+  for (uint64_t w : weights) {
+    sum += w;
+    // Parts are cut at the first item to reach their share
+    uint64_t limit = total / weights.size() + 1 + max_item;
+    KATANA_LOG_VASSERT(w <= limit, "local weight {} above {}", w, limit);
+  }
+  KATANA_LOG_VASSERT(sum == total, "local weights sum to {}", sum);
+}
+
+void
+TestRange(const katana::GraphTopology& topology) {
+  auto degree = [&](Node n) {
+    auto [begin, end] = topology.edge_range(n);
+    return end - begin;
+  };
+
+  std::vector<std::atomic<int>> visits(topology.num_nodes());
+  katana::do_all(
+      katana::iterate_edge_balanced(topology), [&](Node n) { visits[n] += 1; },
+      katana::no_stats());
+  for (Node n : topology) {
+    KATANA_LOG_VASSERT(visits[n] == 1, "node {} visited {}", n, visits[n]);
+  }
+
+  uint64_t max_degree = 0;
+  for (Node n : topology) {
+    max_degree = std::max<uint64_t>(max_degree, degree(n));
+  }
+  auto range = katana::iterate_edge_balanced(topology);
+  CheckBalanced(
+      LocalWeights(range, [&](Node n) { return degree(n) + 1; }),
+      topology.num_edges() + topology.num_nodes(), max_degree + 1);
+}
+
+void
+TestTiles(const katana::GraphTopology& topology, uint64_t max_tile_edges) {
+  katana::EdgeTiles tiles(topology, max_tile_edges);
+
+  // The tiles of each node are its edges, in order
+  std::vector<katana::GraphTopology::Edge> next(topology.num_nodes());
+  for (Node n : topology) {
+    next[n] = topology.edge_range(n).first;
+  }
+  std::vector<int> num_tiles(topology.num_nodes());
+  for (const katana::EdgeTile& tile : tiles) {
+    KATANA_LOG_ASSERT(tile.end - tile.begin <= max_tile_edges);
+    KATANA_LOG_ASSERT(tile.begin == next[tile.node]);
+    next[tile.node] = tile.end;
+    num_tiles[tile.node] += 1;
+  }
+  for (Node n : topology) {
+    KATANA_LOG_ASSERT(next[n] == topology.edge_range(n).second);
+    KATANA_LOG_ASSERT(num_tiles[n] >= 1);
+  }
+
+  std::vector<std::atomic<int>> visits(topology.num_edges());
+  katana::do_all(
+      katana::iterate(tiles),
+      [&](const katana::EdgeTile& tile) {
+        for (auto e : tile.edges()) {
+          visits[e] += 1;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  for (uint64_t e = 0; e < topology.num_edges(); ++e) {
+    KATANA_LOG_VASSERT(visits[e] == 1, "edge {} visited {}", e, visits[e]);
+  }
+
+  CheckBalanced(
+      LocalWeights(
+          tiles,
+          [](const katana::EdgeTile& tile) {
+            return tile.end - tile.begin + 1;
+          }),
+      topology.num_edges() + tiles.size(), max_tile_edges + 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  HubPolicy hub;
+  RandomPolicy random{4};
+  for (Policy* policy : {static_cast<Policy*>(&hub), &random}) {
+    for (size_t num_nodes : {1, 3, 1000}) {
+      std::unique_ptr<katana::PropertyGraph> g =
+          MakeFileGraph<int64_t>(num_nodes, 0, policy);
+      TestRange(g->topology());
+      TestTiles(g->topology(), 1);
+      TestTiles(g->topology(), 16);
+    }
+  }
+
+  return 0;
+}
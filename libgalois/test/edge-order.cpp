@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/EdgeOrder.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+using DataType = int64_t;
+using katana::EdgeOrder;
+
+/// Every kept edge appears once, with its endpoints, and edges are in order
+void
+CheckOrder(
+    const katana::GraphTopology& topology, EdgeOrder order, bool upper_only) {
+  auto edges = katana::OrderEdges(
+      topology, order, [&](uint32_t src, uint32_t dst) {
+        return !upper_only || src < dst;
+      });
+
+  std::vector<uint32_t> srcs(topology.num_edges());
+  uint64_t num_kept = 0;
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      srcs[e] = n;
+      num_kept += !upper_only || n < topology.edge_dest(e);
+    }
+  }
+  KATANA_LOG_ASSERT(edges.size() == num_kept);
+
+  std::vector<uint8_t> seen(topology.num_edges());
+  uint32_t order_bits = 0;
+  while ((uint64_t{1} << order_bits) < topology.num_nodes()) {
+    ++order_bits;
+  }
+  uint64_t prev_key = 0;
+  for (size_t i = 0; i < edges.size(); ++i) {
+    const katana::OrderedEdge& edge = edges[i];
+    KATANA_LOG_ASSERT(edge.src == srcs[edge.id]);
+    KATANA_LOG_ASSERT(edge.dst == topology.edge_dest(edge.id));
+    KATANA_LOG_ASSERT(!upper_only || edge.src < edge.dst);
+    KATANA_LOG_ASSERT(seen[edge.id]++ == 0);
+
+    uint64_t key = 0;
+    switch (order) {
+    case EdgeOrder::kCSR:
+      key = edge.id;
+      break;
+    case EdgeOrder::kBlocked:
+      // With fewer nodes than a block, by source block and then CSR order
+      key = (edge.src / katana::kEdgeOrderBlockSize) << 32U | edge.id;
+      break;
+    case EdgeOrder::kHilbert:
+      key = katana::internal::HilbertIndex(order_bits, edge.src, edge.dst);
+      break;
+    }
+    KATANA_LOG_VASSERT(i == 0 || prev_key <= key, "edge {} out of order", i);
+    prev_key = key;
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // The Hilbert curve visits every point of its square once
+  constexpr uint32_t kOrder = 4;
+  std::vector<uint8_t> visited(1U << (2 * kOrder));
+  for (uint64_t x = 0; x < (1U << kOrder); ++x) {
+    for (uint64_t y = 0; y < (1U << kOrder); ++y) {
+      ++visited[katana::internal::HilbertIndex(kOrder, x, y)];
+    }
+  }
+  for (uint8_t v : visited) {
+    KATANA_LOG_ASSERT(v == 1);
+  }
+
+  for (size_t num_nodes : {1, 100, 1000}) {
+    RandomPolicy policy{5};
+    std::unique_ptr<katana::PropertyGraph> g =
+        MakeFileGraph<DataType>(num_nodes, 0, &policy);
+    for (EdgeOrder order :
+         {EdgeOrder::kCSR, EdgeOrder::kBlocked, EdgeOrder::kHilbert}) {
+      CheckOrder(g->topology(), order, false);
+      CheckOrder(g->topology(), order, true);
+    }
+  }
+
+  return 0;
+}
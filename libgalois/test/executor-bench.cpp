@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Barrier.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WorkList.h"
+#include "katana/gstl.h"
+
+/// Benchmarks the runtime itself: the overhead of scheduling the parallel
+/// loops, the throughput of the worklists, how well do_all steals work and
+/// the latency of the barriers, each for 1, 2, 4, ... threads.
+///
+/// Benchmark names have the form Group/Name/threads:T, e.g.,
+/// Loop/DoAll/threads:4 or Worklist/OBIM/threads:8, so --benchmark_filter
+/// can select one group. The counters are
+///
+/// - ns_per_iteration: the wall time of a loop divided by its iterations, or
+///   the time of one call for on_each
+/// - items_per_second: worklist items pushed and popped by for_each
+/// - stolen_fraction, stolen_ranges and imbalance: the fraction of the
+///   iterations of an imbalanced do_all run by another thread than the one
+///   that was assigned them, the number of ranges that moved, and the
+///   largest work of a thread over the average, 1 if stealing is perfect
+/// - ns_per_wait: the latency of one Barrier::Wait
+///
+/// Write results with --benchmark_out=<file> --benchmark_out_format=json and
+/// compare two such files with scripts/compare_benchmarks.py.
+
+namespace {
+
+constexpr uint64_t kLoopIterations = 1 << 20;
+constexpr uint32_t kWorklistItems = 1 << 16;
+/// Each initial worklist item i pushes i % kWorklistDepth more items
+constexpr uint32_t kWorklistDepth = 16;
+constexpr uint32_t kStealIterations = 1 << 16;
+/// The iterations of the first thread cost this many more than the others
+constexpr uint64_t kStealSkew = 16;
+constexpr int kBarrierWaits = 1024;
+
+using Clock = std::chrono::steady_clock;
+
+/// Times each call of body and reports the average over count items as
+/// counter name
+void
+TimePerItem(
+    benchmark::State& state, const char* name, double count,
+    const std::function<void()>& body) {
+  double ns = 0;
+  for (auto _ : state) {
+    auto start = Clock::now();
+    body();
+    ns += std::chrono::duration<double, std::nano>(Clock::now() - start)
+              .count();
+  }
+  state.counters[name] = ns / (count * state.iterations());
+}
+
+/// Spin for about n units of work
+void
+Spin(uint64_t n) {
+  for (uint64_t i = 0; i < n; ++i) {
+    benchmark::DoNotOptimize(i);
+  }
+}
+
+void
+DoAll(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+  TimePerItem(state, "ns_per_iteration", kLoopIterations, []() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, kLoopIterations),
+        [](uint64_t i) { benchmark::DoNotOptimize(i); }, katana::no_stats());
+  });
+}
+
+void
+DoAllSteal(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+  TimePerItem(state, "ns_per_iteration", kLoopIterations, []() {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, kLoopIterations),
+        [](uint64_t i) { benchmark::DoNotOptimize(i); }, katana::steal(),
+        katana::no_stats());
+  });
+}
+
+void
+ForEach(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+  TimePerItem(state, "ns_per_iteration", kLoopIterations, []() {
+    katana::for_each(
+        katana::iterate(uint64_t{0}, kLoopIterations),
+        [](uint64_t i, auto&) { benchmark::DoNotOptimize(i); },
+        katana::no_pushes(), katana::disable_conflict_detection(),
+        katana::no_stats());
+  });
+}
+
+void
+OnEach(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+  TimePerItem(state, "ns_per_iteration", 1, []() {
+    katana::on_each([](unsigned tid, unsigned) {
+      benchmark::DoNotOptimize(tid);
+    });
+  });
+}
+
+struct Indexer {
+  uint32_t operator()(uint32_t v) const { return v % kWorklistDepth; }
+};
+
+/// Runs for_each on worklist WL, whose items v push v - 1 until 0
+template <typename WL, typename... Args>
+void
+Worklist(benchmark::State& state, const Args&... wl_args) {
+  katana::setActiveThreads(state.range(0));
+  uint64_t num_items = 0;
+  for (uint32_t i = 0; i < kWorklistItems; ++i) {
+    num_items += i % kWorklistDepth + 1;
+  }
+
+  for (auto _ : state) {
+    katana::for_each(
+        katana::iterate(uint32_t{0}, kWorklistItems),
+        [](uint32_t i, auto& ctx) {
+          uint32_t v = i % kWorklistDepth;
+          if (v > 0) {
+            ctx.push(v - 1);
+          }
+        },
+        katana::wl<WL>(wl_args...), katana::disable_conflict_detection(),
+        katana::no_stats());
+  }
+  state.counters["items_per_second"] = benchmark::Counter(
+      num_items, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/// Runs a do_all whose first block of iterations is kStealSkew times more
+/// expensive than the others and measures where the iterations ran
+void
+Steal(benchmark::State& state) {
+  unsigned num_threads = state.range(0);
+  katana::setActiveThreads(num_threads);
+
+  // The thread do_all assigns each iteration to before stealing
+  std::vector<unsigned> home(kStealIterations);
+  for (unsigned t = 0; t < num_threads; ++t) {
+    auto [begin, end] =
+        katana::block_range(uint32_t{0}, kStealIterations, t, num_threads);
+    std::fill(home.begin() + begin, home.begin() + end, t);
+  }
+  auto cost = [&](uint32_t i) { return home[i] == 0 ? kStealSkew : 1; };
+
+  std::vector<unsigned> owner(kStealIterations);
+  uint64_t stolen = 0;
+  uint64_t stolen_ranges = 0;
+  double imbalance = 0;
+  for (auto _ : state) {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, kStealIterations),
+        [&](uint32_t i) {
+          owner[i] = katana::ThreadPool::getTID();
+          Spin(cost(i) * 64);
+        },
+        katana::steal(), katana::no_stats());
+
+    state.PauseTiming();
+    std::vector<uint64_t> work(num_threads);
+    for (uint32_t i = 0; i < kStealIterations; ++i) {
+      work[owner[i]] += cost(i);
+      if (owner[i] != home[i]) {
+        stolen += 1;
+        stolen_ranges += i == 0 || owner[i] != owner[i - 1];
+      }
+    }
+    uint64_t total = 0;
+    for (uint64_t w : work) {
+      total += w;
+    }
+    imbalance += static_cast<double>(
+                     *std::max_element(work.begin(), work.end())) *
+                 num_threads / total;
+    state.ResumeTiming();
+  }
+
+  double loops = state.iterations();
+  state.counters["stolen_fraction"] = stolen / (loops * kStealIterations);
+  state.counters["stolen_ranges"] = stolen_ranges / loops;
+  state.counters["imbalance"] = imbalance / loops;
+}
+
+using BarrierFactory = std::unique_ptr<katana::Barrier> (*)(unsigned);
+
+void
+WaitBarrier(benchmark::State& state, BarrierFactory create) {
+  unsigned num_threads = state.range(0);
+  katana::setActiveThreads(num_threads);
+  std::unique_ptr<katana::Barrier> barrier = create(num_threads);
+  if (!barrier) {
+    state.SkipWithError("barrier not supported");
+    return;
+  }
+  barrier->Reinit(num_threads);
+
+  TimePerItem(state, "ns_per_wait", kBarrierWaits, [&]() {
+    katana::on_each([&](unsigned, unsigned) {
+      for (int i = 0; i < kBarrierWaits; ++i) {
+        barrier->Wait();
+      }
+    });
+  });
+}
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  int max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  for (int t = 1; t < max_threads; t *= 2) {
+    b->Args({t});
+  }
+  b->Args({max_threads});
+  b->ArgNames({"threads"});
+  b->UseRealTime();
+}
+
+template <typename Fn>
+void
+Register(const std::string& name, Fn fn) {
+  benchmark::RegisterBenchmark(name.c_str(), fn)->Apply(MakeArguments);
+}
+
+void
+RegisterAll() {
+  Register("Loop/DoAll", DoAll);
+  Register("Loop/DoAllSteal", DoAllSteal);
+  Register("Loop/ForEach", ForEach);
+  Register("Loop/OnEach", OnEach);
+
+  using Chunked = katana::PerSocketChunkFIFO<64>;
+  Register("Worklist/PerSocketChunkFIFO", [](benchmark::State& state) {
+    Worklist<Chunked>(state);
+  });
+  Register("Worklist/OBIM", [](benchmark::State& state) {
+    Worklist<katana::OrderedByIntegerMetric<Indexer, Chunked>>(
+        state, Indexer{});
+  });
+  Register("Worklist/BulkSynchronous", [](benchmark::State& state) {
+    Worklist<katana::BulkSynchronous<Chunked>>(state);
+  });
+  Register("Worklist/LocalQueue", [](benchmark::State& state) {
+    Worklist<katana::LocalQueue<Chunked>>(state);
+  });
+
+  Register("Steal/Imbalanced", Steal);
+
+  Register("Barrier/Simple", [](benchmark::State& state) {
+    WaitBarrier(state, katana::CreateSimpleBarrier);
+  });
+  Register("Barrier/Counting", [](benchmark::State& state) {
+    WaitBarrier(state, katana::CreateCountingBarrier);
+  });
+  Register("Barrier/MCS", [](benchmark::State& state) {
+    WaitBarrier(state, katana::CreateMCSBarrier);
+  });
+  Register("Barrier/Topo", [](benchmark::State& state) {
+    WaitBarrier(state, katana::CreateTopoBarrier);
+  });
+  Register("Barrier/Dissemination", [](benchmark::State& state) {
+    WaitBarrier(state, katana::CreateDisseminationBarrier);
+  });
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+
+  RegisterAll();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/FileView.h"
+#include "tsuba/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr uint64_t kPage = UINT64_C(1) << 20;
+
+std::vector<uint8_t>
+MakeData(uint64_t size) {
+  std::vector<uint8_t> data(size);
+  for (uint64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + i / kPage);
+  }
+  return data;
+}
+
+/// A scan through AdvanceFrontier keeps the readahead window past the
+/// frontier fetched asynchronously
+void
+TestAdvanceFrontier(const std::string& file, const std::vector<uint8_t>& data) {
+  tsuba::FileView fv;
+  auto res = fv.Bind(file, 0, kPage, false);
+  KATANA_LOG_VASSERT(res, "binding {}: {}", file, res.error());
+  KATANA_LOG_ASSERT(fv.frontier() == 0);
+  fv.set_readahead(2 * kPage);
+  KATANA_LOG_ASSERT(fv.readahead() == 2 * kPage);
+
+  uint64_t steps = 0;
+  for (uint64_t offset = kPage; offset <= data.size(); offset += kPage) {
+    res = fv.AdvanceFrontier(offset);
+    KATANA_LOG_VASSERT(res, "advancing to {}: {}", offset, res.error());
+    steps += 1;
+    KATANA_LOG_ASSERT(fv.frontier() == offset);
+    // Everything up to the end of the window was fetched ahead of use
+    KATANA_LOG_VASSERT(
+        fv.stats().bytes_prefetched >=
+            std::min<uint64_t>(offset + 2 * kPage, data.size()),
+        "{} bytes prefetched at frontier {}", fv.stats().bytes_prefetched,
+        offset);
+    KATANA_LOG_ASSERT(
+        std::memcmp(
+            fv.ptr<uint8_t>() + offset - kPage, data.data() + offset - kPage,
+            kPage) == 0);
+  }
+  KATANA_LOG_ASSERT(fv.stats().hits + fv.stats().stalls == steps);
+
+  // Offsets below the frontier and past the end are no-ops
+  KATANA_LOG_ASSERT(fv.AdvanceFrontier(kPage));
+  KATANA_LOG_ASSERT(fv.frontier() == data.size());
+  KATANA_LOG_ASSERT(fv.AdvanceFrontier(2 * data.size()));
+  KATANA_LOG_ASSERT(fv.frontier() == data.size());
+  KATANA_LOG_ASSERT(
+      std::memcmp(fv.ptr<uint8_t>(), data.data(), data.size()) == 0);
+
+  tsuba::FileView unbound;
+  KATANA_LOG_ASSERT(!unbound.AdvanceFrontier(kPage));
+}
+
+/// Read prefetches the readahead window after each read
+void
+TestReadahead(const std::string& file, const std::vector<uint8_t>& data) {
+  tsuba::FileView fv;
+  auto res = fv.Bind(file, 0, kPage, false);
+  KATANA_LOG_VASSERT(res, "binding {}: {}", file, res.error());
+  fv.set_readahead(3 * kPage);
+
+  std::vector<uint8_t> out(kPage);
+  for (uint64_t offset = 0; offset < data.size(); offset += kPage) {
+    auto read_res = fv.Read(kPage, out.data());
+    KATANA_LOG_ASSERT(read_res.ok());
+    KATANA_LOG_ASSERT(std::memcmp(out.data(), &data[offset], kPage) == 0);
+    KATANA_LOG_ASSERT(
+        fv.stats().bytes_prefetched >=
+        std::min<uint64_t>(offset + 4 * kPage, data.size()));
+  }
+  KATANA_LOG_ASSERT(fv.stats().hits + fv.stats().stalls == data.size() / kPage);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/fileview");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());
+  fs::create_directories(dir);
+  std::string file = dir + "/data";
+
+  std::vector<uint8_t> data = MakeData(8 * kPage);
+  auto res = tsuba::FileStore(file, data.data(), data.size());
+  KATANA_LOG_VASSERT(res, "storing {}: {}", file, res.error());
+
+  TestAdvanceFrontier(file, data);
+  TestReadahead(file, data);
+
+  fs::remove_all(dir);
+  return 0;
+}
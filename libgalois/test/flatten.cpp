@@ -0,0 +1,45 @@
+#include <algorithm>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Flatten.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  // Enough items for many blocks on each thread
+  constexpr uint32_t kNumItems = 1000000;
+  katana::InsertBag<uint32_t> bag;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, kNumItems),
+      [&](uint32_t i) {
+        bag.push(i % 1000);
+        if (i % 3 == 0) {
+          bag.push(i % 1000);
+        }
+      },
+      katana::no_stats());
+
+  // A flattened bag holds the items in the order the bag iterates them
+  std::vector<uint32_t> expected(bag.begin(), bag.end());
+  katana::LargeArray<uint32_t> items = katana::Flatten(bag);
+  KATANA_LOG_ASSERT(items.size() == expected.size());
+  KATANA_LOG_ASSERT(std::equal(items.begin(), items.end(), expected.begin()));
+
+  std::sort(expected.begin(), expected.end());
+  expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+  katana::LargeArray<uint32_t> unique = katana::FlattenSortedUnique(bag);
+  KATANA_LOG_ASSERT(unique.size() == expected.size());
+  KATANA_LOG_ASSERT(std::equal(unique.begin(), unique.end(), expected.begin()));
+
+  katana::InsertBag<uint32_t> empty;
+  KATANA_LOG_ASSERT(katana::Flatten(empty).size() == 0);
+  KATANA_LOG_ASSERT(katana::FlattenSortedUnique(empty).size() == 0);
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <functional>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+
+struct Node : public katana::Lockable {
+  uint32_t dist{kInfinity};
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+};
+
+/// An event reaching node at time dist
+struct Event {
+  uint32_t dist;
+  uint32_t node;
+};
+
+struct EarlierEvent {
+  bool operator()(const Event& a, const Event& b) const {
+    return a.dist < b.dist || (a.dist == b.dist && a.node < b.node);
+  }
+};
+
+/// Single-source shortest paths as a discrete-event simulation
+std::vector<uint32_t>
+Simulate(std::vector<Node>& nodes) {
+  for (auto& n : nodes) {
+    n.dist = kInfinity;
+  }
+  std::vector<Event> initial{{0, 0}};
+  katana::for_each_ordered(
+      initial.begin(), initial.end(), EarlierEvent(),
+      [&](const Event& e) {
+        katana::acquire(&nodes[e.node], katana::MethodFlag::WRITE);
+      },
+      [&](const Event& e, katana::UserContext<Event>& ctx) {
+        Node& n = nodes[e.node];
+        // Events may arrive out of order; discard those already beaten
+        if (e.dist >= n.dist) {
+          return;
+        }
+        n.dist = e.dist;
+        for (auto [dst, weight] : n.edges) {
+          ctx.push(Event{e.dist + weight, dst});
+        }
+      },
+      "simulate");
+
+  std::vector<uint32_t> dists;
+  for (const auto& n : nodes) {
+    dists.push_back(n.dist);
+  }
+  return dists;
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // A worklist that is not concurrent is exact
+  katana::MultiQueue<std::less<int>, int, 2, false> serial;
+  for (int i : {5, 3, 9, 1, 7}) {
+    serial.push(i);
+  }
+  for (int i : {1, 3, 5, 7, 9}) {
+    auto val = serial.pop();
+    KATANA_LOG_ASSERT(val && *val == i);
+  }
+  KATANA_LOG_ASSERT(!serial.pop());
+
+  constexpr uint32_t kNumNodes = 2000;
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<uint32_t> node_dist(0, kNumNodes - 1);
+  std::uniform_int_distribution<uint32_t> weight_dist(1, 100);
+  std::vector<Node> nodes(kNumNodes);
+  for (uint32_t i = 0; i < kNumNodes * 8; ++i) {
+    nodes[node_dist(gen)].edges.emplace_back(node_dist(gen), weight_dist(gen));
+  }
+
+  katana::setActiveThreads(1);
+  std::vector<uint32_t> expected = Simulate(nodes);
+  KATANA_LOG_ASSERT(expected[0] == 0);
+
+  for (unsigned threads : {2, 4, 8}) {
+    katana::setActiveThreads(threads);
+    KATANA_LOG_VASSERT(
+        Simulate(nodes) == expected, "distances differ with {} threads",
+        threads);
+  }
+
+  return 0;
+}
@@ -17,11 +17,14 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
 #include "katana/Bag.h"
+#include "katana/Context.h"
 #include "katana/Galois.h"
+#include "katana/Logging.h"
 
 void
 function_pointer(int x, katana::UserContext<int>&) {
@@ -48,5 +51,53 @@ main() {
   katana::do_all(katana::iterate(v), [&b](int x) { b.push(x); });
   katana::for_each(katana::iterate(b), function_object());
 
+  // Iterations that all conflict each still run once in a loop that
+  // throttles itself, and the next loop of the same name starts throttled
+  katana::setActiveThreads(4);
+  katana::Lockable lock;
+  for (int run = 0; run < 2; ++run) {
+    uint64_t sum = 0;
+    katana::for_each(
+        katana::iterate(uint32_t{0}, uint32_t{10000}),
+        [&](uint32_t x, katana::UserContext<uint32_t>&) {
+          katana::acquire(&lock, katana::MethodFlag::WRITE);
+          sum += x;
+        },
+        katana::adaptive_conflicts(), katana::no_pushes(),
+        katana::loopname("adaptive"));
+    KATANA_LOG_ASSERT(sum == uint64_t{10000} * 9999 / 2);
+  }
+
+  // Payloads from the per-loop allocator outlive the iterations that made
+  // them, whichever thread reads them
+  struct Payload {
+    const uint32_t* values;
+    uint32_t size;
+  };
+  std::vector<Payload> seeds(1000, Payload{nullptr, 0});
+  katana::GAccumulator<uint64_t> checked;
+  katana::for_each(
+      katana::iterate(seeds),
+      [&](const Payload& p, katana::UserContext<Payload>& ctx) {
+        for (uint32_t i = 0; i < p.size; ++i) {
+          KATANA_LOG_ASSERT(p.values[i] == p.size * 100 + i);
+        }
+        checked += p.size;
+        if (p.size == 8) {
+          return;
+        }
+        katana::ArenaVector<uint32_t> scratch(ctx.getPerIterAlloc());
+        for (uint32_t i = 0; i <= p.size; ++i) {
+          scratch.push_back((p.size + 1) * 100 + i);
+        }
+        uint32_t* values = katana::PerIterAllocTy::rebind<uint32_t>::other(
+                               ctx.getPerLoopAlloc())
+                               .allocate(scratch.size());
+        std::copy(scratch.begin(), scratch.end(), values);
+        ctx.push(Payload{values, p.size + 1});
+      },
+      katana::disable_conflict_detection(), katana::loopname("per-loop"));
+  KATANA_LOG_ASSERT(checked.reduce() == uint64_t{1000} * (8 * 9 / 2));
+
   return 0;
 }
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "katana/Frontier.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+std::vector<uint32_t>
+Collect(katana::Frontier* frontier) {
+  std::mutex lock;
+  std::vector<uint32_t> nodes;
+  frontier->ForEach([&](uint32_t n) {
+    std::lock_guard<std::mutex> guard(lock);
+    nodes.push_back(n);
+  });
+  std::sort(nodes.begin(), nodes.end());
+  return nodes;
+}
+
+void
+TestConversions() {
+  // Not a multiple of the bitmap word size
+  constexpr size_t kNumNodes = 1000;
+  katana::Frontier frontier(kNumNodes);
+  KATANA_LOG_ASSERT(frontier.empty());
+  KATANA_LOG_ASSERT(!frontier.is_dense());
+
+  std::vector<uint32_t> expected{0, 63, 64, 500, 999};
+  katana::do_all(katana::iterate(expected), [&](uint32_t n) {
+    frontier.push(n);
+    frontier.push(n);
+  });
+  KATANA_LOG_ASSERT(frontier.size() == 2 * expected.size());
+
+  // Small frontiers stay sparse
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(!frontier.is_dense());
+
+  frontier.ToDense();
+  KATANA_LOG_ASSERT(frontier.is_dense());
+  KATANA_LOG_ASSERT(frontier.size() == expected.size());
+  for (uint32_t n : expected) {
+    KATANA_LOG_ASSERT(frontier.test(n));
+  }
+  KATANA_LOG_ASSERT(!frontier.test(1));
+  KATANA_LOG_ASSERT(Collect(&frontier) == expected);
+
+  frontier.ToSparse();
+  KATANA_LOG_ASSERT(!frontier.is_dense());
+  KATANA_LOG_ASSERT(Collect(&frontier) == expected);
+
+  frontier.clear();
+  KATANA_LOG_ASSERT(frontier.empty());
+  KATANA_LOG_ASSERT(Collect(&frontier).empty());
+}
+
+void
+TestAdapt() {
+  constexpr size_t kNumNodes = 1000;
+  katana::Frontier frontier(kNumNodes);
+
+  frontier.Fill();
+  KATANA_LOG_ASSERT(frontier.is_dense());
+  KATANA_LOG_ASSERT(frontier.size() == kNumNodes);
+  std::vector<uint32_t> all = Collect(&frontier);
+  KATANA_LOG_ASSERT(all.size() == kNumNodes);
+  KATANA_LOG_ASSERT(all.back() == kNumNodes - 1);
+
+  // Large frontiers become dense
+  frontier.Reset(false);
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumNodes / 2),
+      [&](size_t n) { frontier.push(n); });
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(frontier.is_dense());
+  KATANA_LOG_ASSERT(frontier.size() == kNumNodes / 2);
+
+  // A dense frontier just under the threshold stays dense
+  frontier.Reset(true);
+  size_t just_under = katana::Frontier::kDefaultDenseFraction * kNumNodes - 1;
+  for (size_t n = 0; n < just_under; ++n) {
+    frontier.push(n);
+  }
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(frontier.is_dense());
+
+  // and becomes sparse once well below it
+  frontier.Reset(true);
+  frontier.push(7);
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(!frontier.is_dense());
+  KATANA_LOG_ASSERT(Collect(&frontier) == std::vector<uint32_t>{7});
+
+  katana::Frontier other(kNumNodes);
+  other.swap(frontier);
+  KATANA_LOG_ASSERT(frontier.empty());
+  KATANA_LOG_ASSERT(other.size() == 1);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestConversions();
+  TestAdapt();
+
+  return 0;
+}
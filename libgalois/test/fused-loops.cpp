@@ -0,0 +1,78 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+void
+TestPhases(size_t size) {
+  std::vector<size_t> first(size);
+  std::vector<size_t> second(size);
+  std::vector<size_t> third(size);
+  katana::do_all_fused(
+      katana::iterate(size_t{0}, size),
+      katana::phases(
+          [&](size_t i) { first[i] = i; },
+          // Reads what this thread wrote for the same item
+          [&](size_t i) { second[i] = first[i] + 1; },
+          katana::phase_barrier(),
+          // Reads what other threads wrote
+          [&](size_t i) { third[i] = second[(i + 1) % size]; }),
+      katana::loopname("Fused"));
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_VASSERT(
+        third[i] == (i + 1) % size + 1, "item {} is {}", i, third[i]);
+  }
+}
+
+void
+TestNested() {
+  constexpr size_t kSize = 100;
+  std::atomic<size_t> total{0};
+  katana::on_each([&](unsigned, unsigned) {
+    std::vector<size_t> values(kSize);
+    size_t sum = 0;
+    katana::do_all_fused(
+        katana::iterate(size_t{0}, kSize),
+        katana::phases(
+            [&](size_t i) { values[i] = i; }, katana::phase_barrier(),
+            [&](size_t i) { sum += values[kSize - 1 - i]; }));
+    total += sum;
+  });
+  size_t expected = katana::getActiveThreads() * kSize * (kSize - 1) / 2;
+  KATANA_LOG_VASSERT(
+      total == expected, "total is {}, not {}", total.load(), expected);
+}
+
+void
+TestCancel() {
+  constexpr size_t kSize = 10000;
+  katana::CancellationToken token;
+  katana::CancellationScope scope(&token);
+  std::atomic<size_t> after{0};
+  katana::do_all_fused(
+      katana::iterate(size_t{0}, kSize),
+      katana::phases(
+          [&](size_t) { token.Cancel(); }, katana::phase_barrier(),
+          [&](size_t) { ++after; }));
+  KATANA_LOG_VASSERT(after == 0, "{} items after cancel", after.load());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  for (size_t size : {1, 7, 1000}) {
+    TestPhases(size);
+  }
+  TestNested();
+  TestCancel();
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/independent_set/independent_set.h"
+
+using DataType = int64_t;
+using katana::analytics::IndependentSetPlan;
+
+/// Generates a symmetric graph: random edges added in both directions and a
+/// star around node 0, so that degrees vary widely
+class SymmetricPolicy : public Policy {
+  std::vector<std::vector<uint32_t>> neighbors_;
+
+public:
+  SymmetricPolicy(size_t num_nodes, size_t num_edges)
+      : neighbors_(num_nodes) {
+    auto& gen = katana::GetGenerator();
+    std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+    auto add = [&](uint32_t a, uint32_t b) {
+      neighbors_[a].emplace_back(b);
+      neighbors_[b].emplace_back(a);
+    };
+    for (size_t i = 0; i < num_edges; ++i) {
+      add(node(gen), node(gen));
+    }
+    for (uint32_t n = 1; n < num_nodes; n += 3) {
+      add(0, n);
+    }
+  }
+
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t /*num_nodes*/) override {
+    return neighbors_[node_id];
+  }
+};
+
+void
+TestIndependentSet(katana::PropertyGraph* pg) {
+  auto res = katana::analytics::IndependentSet(
+      pg, "in-set", IndependentSetPlan::BitsetPriority());
+  KATANA_LOG_VASSERT(res, "IndependentSet failed: {}", res.error());
+  KATANA_LOG_ASSERT(katana::analytics::IndependentSetAssertValid(pg, "in-set"));
+
+  // Maximal: every node out of the set has a neighbor in it
+  const katana::GraphTopology& topology = pg->topology();
+  auto in_set = pg->GetNodePropertyTyped<uint8_t>("in-set").value();
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    if (in_set->Value(n)) {
+      continue;
+    }
+    bool covered = false;
+    for (auto e : topology.edges(n)) {
+      uint32_t dst = topology.edge_dest(e);
+      covered |= dst != n && in_set->Value(dst);
+    }
+    KATANA_LOG_VASSERT(covered, "node {} could join the set", n);
+  }
+}
+
+void
+TestColoring(katana::PropertyGraph* pg) {
+  auto res = katana::analytics::GraphColoring(pg, "color");
+  KATANA_LOG_VASSERT(res, "GraphColoring failed: {}", res.error());
+  KATANA_LOG_ASSERT(katana::analytics::GraphColoringAssertValid(pg, "color"));
+
+  const katana::GraphTopology& topology = pg->topology();
+  auto colors = pg->GetNodePropertyTyped<uint32_t>("color").value();
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        colors->Value(n) <= topology.edges(n).size(),
+        "node {} of degree {} has color {}", n, topology.edges(n).size(),
+        colors->Value(n));
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+
+    SymmetricPolicy policy(2000, 6000);
+    auto pg = MakeFileGraph<DataType>(2000, 0, &policy);
+    TestIndependentSet(pg.get());
+    TestColoring(pg.get());
+  }
+
+  return 0;
+}
@@ -0,0 +1,238 @@
+#include "katana/GraphGenerator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// A generated graph with its properties as vectors
+struct Generated {
+  std::unique_ptr<katana::PropertyGraph> pg;
+  std::vector<uint64_t> indices;
+  std::vector<Node> dests;
+  std::vector<uint32_t> weights;
+  std::vector<uint32_t> labels;
+};
+
+std::vector<uint32_t>
+Values(const std::shared_ptr<arrow::ChunkedArray>& property) {
+  KATANA_LOG_ASSERT(property);
+  std::vector<uint32_t> values;
+  for (const auto& chunk : property->chunks()) {
+    auto array = std::static_pointer_cast<arrow::UInt32Array>(chunk);
+    for (int64_t i = 0; i < array->length(); ++i) {
+      values.emplace_back(array->Value(i));
+    }
+  }
+  return values;
+}
+
+Generated
+Generate(const katana::GraphGeneratorOptions& opts, unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+  auto res = katana::GenerateGraph(opts);
+  KATANA_LOG_VASSERT(res, "could not generate: {}", res.error());
+
+  Generated g;
+  g.pg = std::move(res.value());
+  const katana::GraphTopology& topology = g.pg->topology();
+  KATANA_LOG_ASSERT(topology.num_nodes() == opts.num_nodes);
+  KATANA_LOG_ASSERT(g.pg->edges_sorted_by_dest());
+  for (Node n : topology) {
+    for (auto e : topology.edges(n)) {
+      g.dests.emplace_back(topology.edge_dest(e));
+    }
+    g.indices.emplace_back(g.dests.size());
+  }
+  g.weights = Values(g.pg->GetEdgeProperty("weight"));
+  g.labels = Values(g.pg->GetNodeProperty("label"));
+  KATANA_LOG_ASSERT(g.weights.size() == topology.num_edges());
+  KATANA_LOG_ASSERT(g.labels.size() == topology.num_nodes());
+  return g;
+}
+
+/// \returns the edge from src to dst, or the number of edges if none
+uint64_t
+FindEdge(const Generated& g, Node src, Node dst) {
+  uint64_t begin = src > 0 ? g.indices[src - 1] : 0;
+  auto it = std::lower_bound(
+      g.dests.begin() + begin, g.dests.begin() + g.indices[src], dst);
+  if (it == g.dests.begin() + g.indices[src] || *it != dst) {
+    return g.dests.size();
+  }
+  return it - g.dests.begin();
+}
+
+/// Generate with one and with several threads, check that the graphs are
+/// the same and valid, and return one
+Generated
+TestGenerate(const katana::GraphGeneratorOptions& opts) {
+  Generated g = Generate(opts, 1);
+  Generated again = Generate(opts, 4);
+  KATANA_LOG_ASSERT(g.indices == again.indices);
+  KATANA_LOG_ASSERT(g.dests == again.dests);
+  KATANA_LOG_ASSERT(g.weights == again.weights);
+  KATANA_LOG_ASSERT(g.labels == again.labels);
+
+  uint64_t num_edges = g.dests.size();
+  uint64_t most = opts.symmetric ? 4 * opts.num_edges : 2 * opts.num_edges;
+  KATANA_LOG_VASSERT(
+      num_edges >= opts.num_edges / 4 && num_edges <= most,
+      "{} edges for {} drawn", num_edges, opts.num_edges);
+
+  for (Node n = 0; n < opts.num_nodes; ++n) {
+    for (uint64_t e = n > 0 ? g.indices[n - 1] : 0; e < g.indices[n]; ++e) {
+      Node dst = g.dests[e];
+      KATANA_LOG_ASSERT(dst < opts.num_nodes && dst != n);
+      KATANA_LOG_VASSERT(
+          e + 1 == g.indices[n] || dst < g.dests[e + 1],
+          "edges of {} not sorted or repeated", n);
+      KATANA_LOG_ASSERT(g.weights[e] >= 1 && g.weights[e] <= opts.max_weight);
+      if (opts.symmetric) {
+        uint64_t reverse = FindEdge(g, dst, n);
+        KATANA_LOG_VASSERT(
+            reverse < num_edges && g.weights[reverse] == g.weights[e],
+            "edge {} -> {} has no reverse of the same weight", n, dst);
+      }
+    }
+  }
+  return g;
+}
+
+katana::GraphGeneratorOptions
+MakeOptions(katana::GeneratedGraph kind, uint64_t num_nodes) {
+  katana::GraphGeneratorOptions opts;
+  opts.kind = kind;
+  opts.num_nodes = num_nodes;
+  opts.num_edges = 8 * num_nodes;
+  opts.seed = 42;
+  opts.weight_property = "weight";
+  opts.label_property = "label";
+  return opts;
+}
+
+void
+TestRmat() {
+  auto opts = MakeOptions(katana::GeneratedGraph::kRmat, 1000);
+  Generated g = TestGenerate(opts);
+
+  // Degrees are skewed
+  uint64_t max_degree = 0;
+  for (Node n = 0; n < opts.num_nodes; ++n) {
+    uint64_t begin = n > 0 ? g.indices[n - 1] : 0;
+    max_degree = std::max(max_degree, g.indices[n] - begin);
+  }
+  KATANA_LOG_VASSERT(
+      max_degree > 4 * g.dests.size() / opts.num_nodes,
+      "largest degree {} is not skewed", max_degree);
+
+  // Another seed gives another graph
+  opts.seed = 43;
+  Generated other = Generate(opts, 4);
+  KATANA_LOG_ASSERT(other.dests != g.dests);
+
+  opts.symmetric = true;
+  TestGenerate(opts);
+
+  opts.rmat_a = 0.9;
+  KATANA_LOG_ASSERT(!katana::GenerateGraph(opts));
+}
+
+void
+TestLfr() {
+  // Communities are larger than degrees, so edges within them are distinct
+  auto opts = MakeOptions(katana::GeneratedGraph::kLfr, 2000);
+  opts.lfr_max_degree = 50;
+  opts.lfr_min_community_size = 60;
+  opts.lfr_max_community_size = 200;
+  opts.lfr_mixing = 0.1;
+  Generated g = TestGenerate(opts);
+
+  // Most edges are within communities, which are the labels
+  uint64_t internal = 0;
+  for (Node n = 0; n < opts.num_nodes; ++n) {
+    for (uint64_t e = n > 0 ? g.indices[n - 1] : 0; e < g.indices[n]; ++e) {
+      internal += g.labels[n] == g.labels[g.dests[e]];
+    }
+  }
+  KATANA_LOG_VASSERT(
+      internal >= 0.8 * g.dests.size(), "only {} of {} edges are internal",
+      internal, g.dests.size());
+  uint32_t num_communities =
+      *std::max_element(g.labels.begin(), g.labels.end()) + 1;
+  KATANA_LOG_ASSERT(num_communities > 1);
+  KATANA_LOG_ASSERT(std::is_sorted(g.labels.begin(), g.labels.end()));
+
+  opts.symmetric = true;
+  TestGenerate(opts);
+
+  opts.lfr_degree_exponent = 2;
+  KATANA_LOG_ASSERT(!katana::GenerateGraph(opts));
+}
+
+void
+TestGeometric() {
+  // 961 nodes on a grid 31 wide whose edges span at most 2 cells
+  auto opts = MakeOptions(katana::GeneratedGraph::kGeometric, 961);
+  opts.num_edges = 4 * opts.num_nodes;
+  opts.symmetric = true;
+  Generated g = TestGenerate(opts);
+  for (Node n = 0; n < opts.num_nodes; ++n) {
+    for (uint64_t e = n > 0 ? g.indices[n - 1] : 0; e < g.indices[n]; ++e) {
+      Node dst = g.dests[e];
+      KATANA_LOG_VASSERT(
+          std::abs(int64_t{n % 31} - int64_t{dst % 31}) <= 2 &&
+              std::abs(int64_t{n / 31} - int64_t{dst / 31}) <= 2,
+          "edge {} -> {} is too long", n, dst);
+    }
+  }
+}
+
+void
+TestBipartite() {
+  auto opts = MakeOptions(katana::GeneratedGraph::kBipartite, 1000);
+  opts.bipartite_num_left_nodes = 300;
+  opts.bipartite_skew = 2;
+  Generated g = TestGenerate(opts);
+  for (Node n = 0; n < opts.num_nodes; ++n) {
+    KATANA_LOG_ASSERT(g.labels[n] == (n >= 300));
+    uint64_t begin = n > 0 ? g.indices[n - 1] : 0;
+    KATANA_LOG_ASSERT(n < 300 || g.indices[n] == begin);
+    for (uint64_t e = begin; e < g.indices[n]; ++e) {
+      KATANA_LOG_ASSERT(g.dests[e] >= 300);
+    }
+  }
+
+  opts.bipartite_num_left_nodes = 1000;
+  KATANA_LOG_ASSERT(!katana::GenerateGraph(opts));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestRmat();
+  TestLfr();
+  TestGeometric();
+  TestBipartite();
+
+  // A single node has no edges to draw
+  auto opts = MakeOptions(katana::GeneratedGraph::kRmat, 1);
+  auto res = katana::GenerateGraph(opts);
+  KATANA_LOG_ASSERT(res && res.value()->topology().num_edges() == 0);
+  opts.num_nodes = 0;
+  KATANA_LOG_ASSERT(!katana::GenerateGraph(opts));
+
+  return 0;
+}
@@ -0,0 +1,196 @@
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/graph_partition/graph_partition.h"
+
+using DataType = int64_t;
+using katana::analytics::GraphPartitionStatistics;
+using katana::analytics::PartitionLayout;
+using katana::analytics::PartitionLayoutPolicy;
+
+/// Clusters of cluster_size nodes, each a cycle with chords of width
+/// neighbors, where the first node of each cluster also links to the first
+/// node of the next cluster
+class ClusterPolicy : public Policy {
+  size_t cluster_size_{};
+  size_t width_{};
+
+public:
+  ClusterPolicy(size_t cluster_size, size_t width)
+      : cluster_size_(cluster_size), width_(width) {}
+
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    size_t first = node_id - node_id % cluster_size_;
+    std::vector<uint32_t> r;
+    for (size_t i = 0; i < width_; ++i) {
+      r.emplace_back(first + (node_id - first + i + 1) % cluster_size_);
+    }
+    if (node_id == first) {
+      r.emplace_back((first + cluster_size_) % num_nodes);
+    }
+    return r;
+  }
+};
+
+void
+TestPartition(
+    Policy* policy, size_t num_nodes, uint32_t num_partitions,
+    uint64_t max_edge_cut) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  auto res =
+      katana::analytics::GraphPartition(pg.get(), num_partitions, "partition");
+  KATANA_LOG_VASSERT(res, "partitioning failed: {}", res.error());
+
+  auto valid_res = katana::analytics::GraphPartitionAssertValid(
+      pg.get(), num_partitions, "partition");
+  KATANA_LOG_VASSERT(valid_res, "invalid partition: {}", valid_res.error());
+
+  auto stats_res =
+      GraphPartitionStatistics::Compute(pg.get(), "partition");
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  GraphPartitionStatistics stats = stats_res.value();
+  KATANA_LOG_VASSERT(
+      stats.n_partitions == num_partitions, "found {} partitions, not {}",
+      stats.n_partitions, num_partitions);
+  KATANA_LOG_VASSERT(
+      stats.edge_cut <= max_edge_cut, "cut {} edges, more than {}",
+      stats.edge_cut, max_edge_cut);
+  KATANA_LOG_VASSERT(
+      stats.imbalance <= 0.1, "partitions are imbalanced by {}",
+      stats.imbalance);
+
+  // The output property may not exist before the call
+  res =
+      katana::analytics::GraphPartition(pg.get(), num_partitions, "partition");
+  KATANA_LOG_ASSERT(!res);
+}
+
+template <typename T>
+std::vector<T>
+Values(const std::shared_ptr<arrow::ChunkedArray>& chunked) {
+  KATANA_LOG_ASSERT(chunked->num_chunks() <= 1);
+  std::vector<T> values;
+  if (chunked->num_chunks() == 0) {
+    return values;
+  }
+  auto array = std::dynamic_pointer_cast<
+      typename arrow::CTypeTraits<T>::ArrayType>(chunked->chunk(0));
+  KATANA_LOG_ASSERT(array);
+  for (int64_t i = 0; i < array->length(); ++i) {
+    values.emplace_back(array->Value(i));
+  }
+  return values;
+}
+
+/// Check that the layouts of all hosts together cover the graph and that
+/// the masters each host lists for another are the mirrors that host lists
+/// for it, in the same order
+void
+TestLayout(
+    Policy* policy, size_t num_nodes, uint32_t num_hosts,
+    PartitionLayoutPolicy layout_policy) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  auto res = katana::analytics::GraphPartition(pg.get(), num_hosts, "host");
+  KATANA_LOG_VASSERT(res, "partitioning failed: {}", res.error());
+  auto part = pg->GetNodePropertyTyped<uint32_t>("host").value();
+
+  std::vector<PartitionLayout> layouts;
+  uint64_t num_owned = 0;
+  uint64_t num_edges = 0;
+  for (uint32_t host = 0; host < num_hosts; ++host) {
+    auto layout_res = katana::analytics::ComputePartitionLayout(
+        pg.get(), "host", num_hosts, host, layout_policy, 2);
+    KATANA_LOG_VASSERT(layout_res, "layout failed: {}", layout_res.error());
+    PartitionLayout layout = layout_res.value();
+    const tsuba::PartitionMetadata& metadata = layout.metadata;
+    KATANA_LOG_ASSERT(
+        metadata.policy_id_ == static_cast<uint32_t>(layout_policy));
+    KATANA_LOG_ASSERT(metadata.num_global_nodes_ == num_nodes);
+    KATANA_LOG_ASSERT(
+        metadata.num_global_edges_ == pg->topology().num_edges());
+    num_owned += metadata.num_owned_;
+    num_edges += metadata.num_edges_;
+
+    auto local_to_user = Values<uint64_t>(layout.local_to_user_id);
+    KATANA_LOG_ASSERT(local_to_user.size() == metadata.num_nodes_);
+    for (uint32_t i = 0; i < metadata.num_nodes_; ++i) {
+      bool owned = part->Value(local_to_user[i]) == host;
+      KATANA_LOG_VASSERT(
+          owned == (i < metadata.num_owned_),
+          "local node {} of host {} is misplaced", i, host);
+    }
+    auto node_ranges = Values<uint64_t>(layout.host_to_owned_global_node_ids);
+    KATANA_LOG_ASSERT(node_ranges.size() == 2 * num_hosts);
+    KATANA_LOG_ASSERT(
+        node_ranges[2 * host + 1] - node_ranges[2 * host] ==
+        metadata.num_owned_);
+    layouts.emplace_back(std::move(layout));
+  }
+  KATANA_LOG_ASSERT(num_owned == num_nodes);
+  KATANA_LOG_ASSERT(num_edges == pg->topology().num_edges());
+
+  for (uint32_t a = 0; a < num_hosts; ++a) {
+    auto a_users = Values<uint64_t>(layouts[a].local_to_user_id);
+    for (uint32_t b = 0; b < num_hosts; ++b) {
+      auto masters = Values<uint32_t>(layouts[a].master_nodes[b]);
+      auto mirrors = Values<uint32_t>(layouts[b].mirror_nodes[a]);
+      KATANA_LOG_VASSERT(
+          masters.size() == mirrors.size(),
+          "host {} has {} masters mirrored on host {}, which has {} mirrors",
+          a, masters.size(), b, mirrors.size());
+      auto b_users = Values<uint64_t>(layouts[b].local_to_user_id);
+      for (size_t i = 0; i < masters.size(); ++i) {
+        KATANA_LOG_ASSERT(a_users[masters[i]] == b_users[mirrors[i]]);
+      }
+    }
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // A cycle can be cut into contiguous runs
+  LinePolicy cycle{1};
+  TestPartition(&cycle, 2000, 4, 20);
+
+  // Clusters linked in a ring should be cut between the clusters
+  ClusterPolicy clusters{100, 3};
+  TestPartition(&clusters, 800, 8, 40);
+
+  // A random assignment would cut three quarters of the edges
+  for (size_t width : {2, 4}) {
+    RandomPolicy random{width};
+    TestPartition(&random, 1000, 4, 1000 * width / 2);
+  }
+
+  for (auto layout_policy :
+       {PartitionLayoutPolicy::kOutgoingEdgeCut,
+        PartitionLayoutPolicy::kIncomingEdgeCut,
+        PartitionLayoutPolicy::kHybridVertexCut}) {
+    RandomPolicy random{3};
+    TestLayout(&random, 300, 3, layout_policy);
+  }
+
+  // There must be some partitions
+  LinePolicy line{2};
+  auto pg = MakeFileGraph<DataType>(10, 0, &line);
+  auto res = katana::analytics::GraphPartition(pg.get(), 0, "partition");
+  KATANA_LOG_ASSERT(!res);
+
+  // Layouts need partitions that name hosts
+  res = katana::analytics::GraphPartition(pg.get(), 4, "partition");
+  KATANA_LOG_VASSERT(res, "partitioning failed: {}", res.error());
+  auto layout_res =
+      katana::analytics::ComputePartitionLayout(pg.get(), "partition", 2, 0);
+  KATANA_LOG_ASSERT(!layout_res);
+  layout_res =
+      katana::analytics::ComputePartitionLayout(pg.get(), "partition", 4, 4);
+  KATANA_LOG_ASSERT(!layout_res);
+
+  return 0;
+}
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "GraphStats.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/FileGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+
+namespace fs = boost::filesystem;
+namespace stats = katana::graphstats;
+
+namespace {
+
+constexpr uint64_t kNumNodes = 1000;
+constexpr int kColumns = 8;
+
+/// A graph, in CSR form, whose nodes have between 0 and 12 edges
+struct Edges {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+
+  Edges() {
+    for (uint64_t n = 0; n < kNumNodes; ++n) {
+      for (uint64_t k = 0; k < (n * 7) % 13; ++k) {
+        dests.emplace_back((n * 31 + k * k * 17) % kNumNodes);
+      }
+      indices.emplace_back(dests.size());
+    }
+  }
+
+  uint64_t begin(uint64_t n) const { return n > 0 ? indices[n - 1] : 0; }
+
+  uint64_t degree(uint64_t n) const { return indices[n] - begin(n); }
+};
+
+std::string
+WriteGr(const Edges& edges, const std::string& file) {
+  katana::FileGraphWriter writer;
+  writer.setNumNodes(kNumNodes);
+  writer.setNumEdges(edges.dests.size());
+  writer.phase1();
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    writer.incrementDegree(n, edges.degree(n));
+  }
+  writer.phase2();
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    for (uint64_t e = edges.begin(n); e < edges.indices[n]; ++e) {
+      writer.addNeighbor(n, edges.dests[e]);
+    }
+  }
+  writer.finish<void>();
+  writer.toFile(file);
+  return file;
+}
+
+/// Every stat of graph matches one computed serially from edges
+template <typename Topology>
+void
+CheckStats(const Topology& graph, const Edges& edges) {
+  KATANA_LOG_ASSERT(graph.num_nodes() == kNumNodes);
+  KATANA_LOG_ASSERT(graph.num_edges() == edges.dests.size());
+
+  std::vector<uint64_t> in_degrees(kNumNodes);
+  std::map<uint64_t, uint64_t> degree_hist;
+  std::vector<uint64_t> degrees;
+  uint64_t max_node = 0;
+  std::vector<std::vector<char>> rows(kColumns, std::vector<char>(kColumns));
+  uint64_t block_size = (kNumNodes + kColumns - 1) / kColumns;
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_ASSERT(stats::Degree(graph, n) == edges.degree(n));
+    degrees.emplace_back(edges.degree(n));
+    degree_hist[edges.degree(n)] += 1;
+    if (edges.degree(n) > edges.degree(max_node)) {
+      max_node = n;
+    }
+    for (uint64_t e = edges.begin(n); e < edges.indices[n]; ++e) {
+      in_degrees[edges.dests[e]] += 1;
+      rows[n / block_size][edges.dests[e] / block_size] = true;
+    }
+  }
+  std::map<uint64_t, uint64_t> in_degree_hist;
+  std::map<uint64_t, uint64_t> dest_hist;
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    in_degree_hist[in_degrees[n]] += 1;
+    if (in_degrees[n] != 0) {
+      dest_hist[n] = in_degrees[n];
+    }
+  }
+
+  auto [node, degree] = stats::MaxDegreeNode(graph);
+  KATANA_LOG_VASSERT(
+      node == max_node && degree == edges.degree(max_node),
+      "max degree node {} of degree {}, not {} of degree {}", node, degree,
+      max_node, edges.degree(max_node));
+  KATANA_LOG_ASSERT(stats::DegreeHistogram(graph) == degree_hist);
+  KATANA_LOG_ASSERT(stats::InDegreeHistogram(graph) == in_degree_hist);
+  KATANA_LOG_ASSERT(stats::DestinationHistogram(graph) == dest_hist);
+  KATANA_LOG_ASSERT(stats::SparsityPattern(graph, kColumns) == rows);
+
+  // A sample of every node has every degree, and one of no node none
+  std::sort(degrees.begin(), degrees.end());
+  KATANA_LOG_ASSERT(stats::SampleDegrees(graph, 1.0, 3) == degrees);
+  KATANA_LOG_ASSERT(stats::SampleDegrees(graph, 0.0, 3).empty());
+  std::vector<uint64_t> half = stats::SampleDegrees(graph, 0.5, 3);
+  KATANA_LOG_VASSERT(
+      half.size() > kNumNodes / 3 && half.size() < 2 * kNumNodes / 3,
+      "sampled {} of {} nodes at rate 0.5", half.size(), kNumNodes);
+  KATANA_LOG_ASSERT(std::is_sorted(half.begin(), half.end()));
+  KATANA_LOG_ASSERT(half == stats::SampleDegrees(graph, 0.5, 3));
+
+  std::set<uint32_t> distinct(edges.dests.begin(), edges.dests.end());
+  double estimate = stats::DistinctDestinations(graph);
+  KATANA_LOG_VASSERT(
+      std::abs(estimate - distinct.size()) < 0.03 * distinct.size(),
+      "estimated {} distinct destinations of {}", estimate, distinct.size());
+}
+
+/// Sketches estimate large sets closely, and merge into the sketch of the
+/// union of their sets
+void
+TestHyperLogLog() {
+  constexpr uint64_t kNumValues = 200000;
+  stats::HyperLogLog empty;
+  KATANA_LOG_ASSERT(empty.Estimate() == 0);
+
+  stats::HyperLogLog whole;
+  stats::HyperLogLog low;
+  stats::HyperLogLog high;
+  for (uint64_t v = 0; v < kNumValues; ++v) {
+    // Values seen again do not count again
+    whole.Add(v * 977);
+    whole.Add(v * 977);
+    (v < kNumValues / 2 ? low : high).Add(v * 977);
+  }
+  double estimate = whole.Estimate();
+  KATANA_LOG_VASSERT(
+      std::abs(estimate - kNumValues) < 0.03 * kNumValues,
+      "estimated {} distinct values of {}", estimate, kNumValues);
+  low.Merge(high);
+  KATANA_LOG_ASSERT(low.Estimate() == estimate);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestHyperLogLog();
+
+  Edges edges;
+  katana::GraphTopology topology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(edges.indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(edges.dests)),
+  };
+  KATANA_LOG_ASSERT(
+      stats::MaxDegreeNode(katana::GraphTopology()) ==
+      std::make_pair(uint64_t{0}, uint64_t{0}));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/graphstats");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());
+  fs::create_directories(dir);
+  stats::FileTopology file(WriteGr(edges, dir + "/graph.gr"));
+
+  for (unsigned threads : {1, 4}) {
+    katana::setActiveThreads(threads);
+    CheckStats(topology, edges);
+    CheckStats(file, edges);
+  }
+
+  fs::remove_all(dir);
+  return 0;
+}
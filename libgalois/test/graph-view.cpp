@@ -0,0 +1,184 @@
+#include <numeric>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/DynamicBitset.h"
+#include "katana/GraphView.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/connected_components/connected_components.h"
+
+using DataType = int64_t;
+using Node = katana::GraphTopology::Node;
+
+/// Adds the uint8 node property "active" and the boolean edge property
+/// "keep"
+void
+AddFilters(katana::PropertyGraph* pg) {
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<uint8_t> active(topology.num_nodes());
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    active[n] = n % 5 != 0;
+  }
+  arrow::BooleanBuilder keep;
+  for (uint64_t e = 0; e < topology.num_edges(); ++e) {
+    KATANA_LOG_ASSERT(keep.Append(e % 3 != 0).ok());
+  }
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("active", arrow::uint8())}),
+      {katana::BuildArray(active)})));
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("keep", arrow::boolean())}),
+      {keep.Finish().ValueOrDie()})));
+}
+
+/// Checks the edges of view against those of its graph that pass in_view,
+/// and returns the number of them
+template <typename InView>
+uint64_t
+CheckEdges(const katana::GraphView& view, const InView& in_view) {
+  const katana::GraphTopology& topology = view.topology();
+  uint64_t num_edges = 0;
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    std::vector<uint64_t> expected;
+    for (auto e : topology.edges(n)) {
+      if (in_view(n, e)) {
+        expected.emplace_back(e);
+      }
+    }
+    std::vector<uint64_t> found;
+    for (auto e : view.edges(n)) {
+      found.emplace_back(e);
+    }
+    KATANA_LOG_VASSERT(
+        found == expected, "node {} has {} edges in the view, expected {}", n,
+        found.size(), expected.size());
+    num_edges += expected.size();
+  }
+  KATANA_LOG_ASSERT(view.num_edges() == num_edges);
+  return num_edges;
+}
+
+void
+TestPropertyFilters(size_t num_nodes, Policy* policy) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  AddFilters(pg.get());
+  const katana::GraphTopology& topology = pg->topology();
+
+  katana::GraphView view(pg.get());
+  KATANA_LOG_ASSERT(view.num_nodes() == topology.num_nodes());
+  KATANA_LOG_ASSERT(view.num_edges() == topology.num_edges());
+
+  KATANA_LOG_ASSERT(view.FilterEdgesByProperty("keep"));
+  CheckEdges(view, [](Node, uint64_t e) { return e % 3 != 0; });
+
+  KATANA_LOG_ASSERT(view.FilterNodesByProperty("active"));
+  auto active = [](Node n) { return n % 5 != 0; };
+  CheckEdges(view, [&](Node n, uint64_t e) {
+    return e % 3 != 0 && active(n) && active(topology.edge_dest(e));
+  });
+
+  // Filters intersect
+  katana::DynamicBitset even;
+  even.resize(topology.num_nodes());
+  for (Node n = 0; n < topology.num_nodes(); n += 2) {
+    even.set(n);
+  }
+  KATANA_LOG_ASSERT(view.FilterNodes(even));
+  auto in_view = [&](Node n) { return active(n) && n % 2 == 0; };
+  CheckEdges(view, [&](Node n, uint64_t e) {
+    return e % 3 != 0 && in_view(n) && in_view(topology.edge_dest(e));
+  });
+
+  // Compact ids number the nodes in the view in order
+  const katana::GraphView::CompactIds& ids = view.compact_ids();
+  Node next = 0;
+  for (Node n = 0; n < topology.num_nodes(); ++n) {
+    KATANA_LOG_ASSERT(view.contains(n) == in_view(n));
+    if (!in_view(n)) {
+      KATANA_LOG_ASSERT(
+          ids.compact_ids[n] == katana::GraphView::CompactIds::kNotInView);
+      continue;
+    }
+    KATANA_LOG_ASSERT(ids.compact_ids[n] == next);
+    KATANA_LOG_ASSERT(ids.graph_ids[next] == n);
+    ++next;
+  }
+  KATANA_LOG_ASSERT(view.num_nodes() == next);
+
+  katana::DynamicBitset short_mask;
+  short_mask.resize(topology.num_edges() + 1);
+  KATANA_LOG_ASSERT(!view.FilterEdges(short_mask));
+  KATANA_LOG_ASSERT(!view.FilterNodesByProperty("missing"));
+}
+
+void
+TestTypeFilter(size_t num_nodes, Policy* policy) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  AddFilters(pg.get());
+  if (auto r = pg->ConstructTypeSetIDs(); !r) {
+    KATANA_LOG_FATAL("could not construct type set ids: {}", r.error());
+  }
+
+  katana::GraphView view(pg.get());
+  KATANA_LOG_ASSERT(view.FilterEdgesByType("keep"));
+  CheckEdges(view, [](Node, uint64_t e) { return e % 3 != 0; });
+  KATANA_LOG_ASSERT(!view.FilterEdgesByType("missing"));
+}
+
+/// Connected components of the view, by serial label propagation over its
+/// edges in both directions
+std::vector<uint64_t>
+ExpectedComponents(const katana::GraphView& view) {
+  std::vector<uint64_t> labels(view.size());
+  std::iota(labels.begin(), labels.end(), 0);
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (Node n = 0; n < view.size(); ++n) {
+      for (auto e : view.edges(n)) {
+        Node dst = view.edge_dest(e);
+        uint64_t label = std::min(labels[n], labels[dst]);
+        changed |= labels[n] != label || labels[dst] != label;
+        labels[n] = labels[dst] = label;
+      }
+    }
+  }
+  return labels;
+}
+
+void
+TestConnectedComponents(size_t num_nodes, Policy* policy) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  AddFilters(pg.get());
+
+  katana::GraphView view(pg.get());
+  KATANA_LOG_ASSERT(view.FilterEdgesByProperty("keep"));
+  KATANA_LOG_ASSERT(view.FilterNodesByProperty("active"));
+  auto res = katana::analytics::ConnectedComponents(view, "component");
+  KATANA_LOG_VASSERT(res, "ConnectedComponents failed: {}", res.error());
+
+  std::vector<uint64_t> expected = ExpectedComponents(view);
+  auto components = pg->GetNodePropertyTyped<uint64_t>("component").value();
+  for (Node n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_VASSERT(
+        components->Value(n) == expected[n], "node {}: component {} != {}", n,
+        components->Value(n), expected[n]);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy line{3};
+  TestPropertyFilters(100, &line);
+  TestConnectedComponents(100, &line);
+
+  RandomPolicy random{4};
+  TestPropertyFilters(1000, &random);
+  TestTypeFilter(1000, &random);
+  TestConnectedComponents(1000, &random);
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+
+void
+TestGroupBy(size_t size, uint64_t num_keys) {
+  katana::LargeArray<uint64_t> keys;
+  keys.create(size);
+
+  std::mt19937 gen(size);
+  std::uniform_int_distribution<uint64_t> dist(0, num_keys - 1);
+  std::map<uint64_t, std::pair<uint64_t, uint64_t>> expected;
+  for (size_t i = 0; i < size; ++i) {
+    // Spread the keys over the whole key space
+    keys[i] = dist(gen) * UINT64_C(0x100000001);
+    auto& [count, sum] = expected[keys[i]];
+    count += 1;
+    sum += i;
+  }
+
+  auto entries = katana::ParallelSTL::group_by(
+      keys.begin(), keys.end(), [](uint64_t k) { return k; },
+      [&](const uint64_t& k) { return uint64_t(&k - keys.data()); });
+
+  KATANA_LOG_VASSERT(
+      entries.size() == expected.size(), "{} groups but expected {}",
+      entries.size(), expected.size());
+  for (const auto& entry : entries) {
+    auto it = expected.find(entry.key);
+    KATANA_LOG_VASSERT(it != expected.end(), "unexpected key {}", entry.key);
+    KATANA_LOG_VASSERT(
+        entry.count == it->second.first && entry.sum == it->second.second,
+        "key {} has count {} and sum {}", entry.key, entry.count, entry.sum);
+  }
+
+  auto counts = katana::ParallelSTL::group_by(
+      keys.begin(), keys.end(), [](uint64_t k) { return k; });
+  KATANA_LOG_ASSERT(counts.size() == expected.size());
+  for (const auto& entry : counts) {
+    KATANA_LOG_ASSERT(entry.count == expected[entry.key].first);
+    KATANA_LOG_ASSERT(entry.sum == entry.count);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestGroupBy(0, 1);
+  TestGroupBy(1000, 1);
+  TestGroupBy(100000, 100);
+  TestGroupBy(100000, 1000000);
+
+  return 0;
+}
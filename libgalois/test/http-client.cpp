@@ -0,0 +1,406 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Http.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+/// How long the server takes to answer /slow
+constexpr std::chrono::milliseconds kSlow(200);
+/// The size of the body of /big
+constexpr size_t kBigSize = 1 << 20;
+
+std::string
+BigBody() {
+  std::string body(kBigSize, '\0');
+  for (size_t i = 0; i < body.size(); ++i) {
+    body[i] = static_cast<char>('a' + (i * 7) % 26);
+  }
+  return body;
+}
+
+/// Any port of the loopback interface
+sockaddr_in
+Loopback() {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  return addr;
+}
+
+std::string
+ToString(const std::vector<char>& data) {
+  return std::string(data.begin(), data.end());
+}
+
+/// A minimal HTTP/1.1 server on the loopback interface that keeps
+/// connections open and serves each on its own thread:
+///
+///   /echo/<x>  answers "<method> <x> <body>"
+///   /slow      answers after kSlow
+///   /big       answers BigBody()
+///   /tagged    answers with the entity tag of its version, or 304 Not
+///              Modified if the request already has it
+///
+/// and 404 Not Found to anything else.
+class TestServer {
+public:
+  TestServer() {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    KATANA_LOG_ASSERT(listen_fd_ >= 0);
+    sockaddr_in addr = Loopback();
+    KATANA_LOG_ASSERT(
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) ==
+        0);
+    KATANA_LOG_ASSERT(listen(listen_fd_, 64) == 0);
+    socklen_t len = sizeof(addr);
+    KATANA_LOG_ASSERT(
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) ==
+        0);
+    port_ = ntohs(addr.sin_port);
+    acceptor_ = std::thread([this]() { Accept(); });
+  }
+
+  ~TestServer() {
+    stopping_ = true;
+    shutdown(listen_fd_, SHUT_RDWR);
+    acceptor_.join();
+    close(listen_fd_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (int fd : fds_) {
+        shutdown(fd, SHUT_RDWR);
+      }
+    }
+    for (std::thread& connection : connections_) {
+      connection.join();
+    }
+    for (int fd : fds_) {
+      close(fd);
+    }
+  }
+
+  TestServer(const TestServer&) = delete;
+  TestServer& operator=(const TestServer&) = delete;
+
+  std::string url(const std::string& path) const {
+    return "http://127.0.0.1:" + std::to_string(port_) + path;
+  }
+
+  uint32_t connections() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fds_.size();
+  }
+
+  void SetVersion(const std::string& version) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    version_ = version;
+  }
+
+private:
+  void Accept() {
+    for (;;) {
+      int fd = accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0) {
+        KATANA_LOG_ASSERT(stopping_);
+        return;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      fds_.emplace_back(fd);
+      connections_.emplace_back([this, fd]() { Serve(fd); });
+    }
+  }
+
+  void Serve(int fd) {
+    std::string buf;
+    for (;;) {
+      size_t end = buf.find("\r\n\r\n");
+      while (end == std::string::npos) {
+        if (!Receive(fd, &buf)) {
+          return;
+        }
+        end = buf.find("\r\n\r\n");
+      }
+      std::string head = buf.substr(0, end + 2);
+      buf.erase(0, end + 4);
+
+      size_t method_end = head.find(' ');
+      size_t path_end = head.find(' ', method_end + 1);
+      std::string method = head.substr(0, method_end);
+      std::string path =
+          head.substr(method_end + 1, path_end - method_end - 1);
+      size_t content_length = 0;
+      std::string if_none_match;
+      for (size_t begin = head.find("\r\n") + 2; begin < head.size();) {
+        size_t line_end = head.find("\r\n", begin);
+        std::string line = head.substr(begin, line_end - begin);
+        begin = line_end + 2;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+          continue;
+        }
+        std::string name = line.substr(0, colon);
+        std::string value = line.substr(line.find_first_not_of(" ", colon + 1));
+        if (strcasecmp(name.c_str(), "Content-Length") == 0) {
+          content_length = std::stoul(value);
+        } else if (strcasecmp(name.c_str(), "If-None-Match") == 0) {
+          if_none_match = value;
+        }
+      }
+      while (buf.size() < content_length) {
+        if (!Receive(fd, &buf)) {
+          return;
+        }
+      }
+      std::string body = buf.substr(0, content_length);
+      buf.erase(0, content_length);
+
+      if (!Send(fd, Answer(method, path, body, if_none_match))) {
+        return;
+      }
+    }
+  }
+
+  std::string Answer(
+      const std::string& method, const std::string& path,
+      const std::string& body, const std::string& if_none_match) {
+    std::string code = "200 OK";
+    std::string headers;
+    std::string answer;
+    if (path.rfind("/echo/", 0) == 0) {
+      answer = method + " " + path.substr(6) + " " + body;
+    } else if (path == "/slow") {
+      std::this_thread::sleep_for(kSlow);
+      answer = "slow";
+    } else if (path == "/big") {
+      answer = BigBody();
+    } else if (path == "/tagged") {
+      std::string version;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        version = version_;
+      }
+      std::string etag = "\"" + version + "\"";
+      if (if_none_match == etag) {
+        return "HTTP/1.1 304 Not Modified\r\nETag: " + etag + "\r\n\r\n";
+      }
+      headers = "ETag: " + etag + "\r\n";
+      answer = "tagged " + version;
+    } else {
+      code = "404 Not Found";
+      answer = "missing";
+    }
+    return "HTTP/1.1 " + code + "\r\n" + headers +
+           "Content-Length: " + std::to_string(answer.size()) + "\r\n\r\n" +
+           answer;
+  }
+
+  static bool Receive(int fd, std::string* buf) {
+    char chunk[4096];
+    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+    if (n <= 0) {
+      return false;
+    }
+    buf->append(chunk, n);
+    return true;
+  }
+
+  /// Clients may close their connection before the answer, so writes do not
+  /// raise SIGPIPE
+  static bool Send(int fd, const std::string& data) {
+    for (size_t sent = 0; sent < data.size();) {
+      ssize_t n =
+          send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+      if (n <= 0) {
+        return false;
+      }
+      sent += n;
+    }
+    return true;
+  }
+
+  int listen_fd_{-1};
+  uint16_t port_{0};
+  std::atomic<bool> stopping_{false};
+  std::thread acceptor_;
+
+  std::mutex mutex_;
+  std::vector<int> fds_;
+  std::vector<std::thread> connections_;
+  std::string version_{"v1"};
+};
+
+/// Each method sends its body and fills its response
+void
+TestMethods(TestServer* server) {
+  katana::HttpClient client;
+
+  std::vector<char> get;
+  std::vector<char> post;
+  std::vector<char> put;
+  std::vector<char> del;
+  auto get_future = client.GetAsync(server->url("/echo/a"), &get);
+  auto post_future =
+      client.PostAsync(server->url("/echo/b"), "posted", &post);
+  auto put_future = client.PutAsync(server->url("/echo/c"), "put", &put);
+  auto del_future = client.DeleteAsync(server->url("/echo/d"), &del);
+
+  KATANA_LOG_ASSERT(get_future.get());
+  KATANA_LOG_ASSERT(post_future.get());
+  KATANA_LOG_ASSERT(put_future.get());
+  KATANA_LOG_ASSERT(del_future.get());
+  KATANA_LOG_VASSERT(ToString(get) == "GET a ", "GET: {}", ToString(get));
+  KATANA_LOG_VASSERT(
+      ToString(post) == "POST b posted", "POST: {}", ToString(post));
+  KATANA_LOG_VASSERT(ToString(put) == "PUT c put", "PUT: {}", ToString(put));
+  KATANA_LOG_VASSERT(
+      ToString(del) == "DELETE d ", "DELETE: {}", ToString(del));
+
+  std::vector<char> missing;
+  auto missing_res = client.GetAsync(server->url("/missing"), &missing).get();
+  KATANA_LOG_ASSERT(!missing_res);
+  KATANA_LOG_ASSERT(missing_res.error() == katana::ErrorCode::NotFound);
+}
+
+/// Many requests are in flight at once, from one thread, and later requests
+/// reuse the connections of earlier ones
+void
+TestConcurrency(TestServer* server) {
+  katana::HttpClient client;
+
+  constexpr uint32_t kNumSlow = 8;
+  std::vector<std::vector<char>> slow(kNumSlow);
+  std::vector<std::future<katana::Result<void>>> futures;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kNumSlow; ++i) {
+    futures.emplace_back(client.GetAsync(server->url("/slow"), &slow[i]));
+  }
+  for (uint32_t i = 0; i < kNumSlow; ++i) {
+    KATANA_LOG_ASSERT(futures[i].get());
+    KATANA_LOG_ASSERT(ToString(slow[i]) == "slow");
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  KATANA_LOG_VASSERT(
+      elapsed < kNumSlow / 2 * kSlow, "{} slow requests took {} ms", kNumSlow,
+      std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+
+  uint32_t connections = server->connections();
+  for (uint32_t i = 0; i < 10; ++i) {
+    std::vector<char> response;
+    std::string name = std::to_string(i);
+    KATANA_LOG_ASSERT(
+        client.GetAsync(server->url("/echo/" + name), &response).get());
+    KATANA_LOG_ASSERT(ToString(response) == "GET " + name + " ");
+  }
+  KATANA_LOG_VASSERT(
+      server->connections() <= connections + 1,
+      "sequential requests made {} connections",
+      server->connections() - connections);
+}
+
+/// Bodies can be streamed to a sink as they arrive
+void
+TestSink(TestServer* server) {
+  katana::HttpClient client;
+
+  std::string body;
+  uint32_t pieces = 0;
+  auto res = client
+                 .GetAsync(
+                     server->url("/big"),
+                     [&](const char* data, size_t size) {
+                       body.append(data, size);
+                       pieces += 1;
+                     })
+                 .get();
+  KATANA_LOG_VASSERT(res, "streaming /big: {}", res.error());
+  KATANA_LOG_ASSERT(body == BigBody());
+  KATANA_LOG_VASSERT(pieces > 1, "/big arrived in {} pieces", pieces);
+}
+
+/// Requests that a client did not finish fail when it stops, as do requests
+/// to servers that are not there
+void
+TestFailures(TestServer* server) {
+  std::vector<char> response;
+  std::future<katana::Result<void>> future;
+  {
+    katana::HttpClient client;
+    future = client.GetAsync(server->url("/slow"), &response);
+  }
+  KATANA_LOG_ASSERT(!future.get());
+
+  // A port that is bound but not listened on refuses connections
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  KATANA_LOG_ASSERT(fd >= 0);
+  sockaddr_in addr = Loopback();
+  socklen_t len = sizeof(addr);
+  KATANA_LOG_ASSERT(
+      bind(fd, reinterpret_cast<sockaddr*>(&addr), len) == 0 &&
+      getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+  std::string url =
+      "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/";
+
+  katana::HttpClient client;
+  auto res = client.GetAsync(url, &response).get();
+  close(fd);
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::HttpError);
+}
+
+/// Conditional gets fetch the resource only when its entity tag changed
+void
+TestGetIfNoneMatch(TestServer* server) {
+  std::string url = server->url("/tagged");
+  std::string etag;
+  std::vector<char> response;
+  auto res = katana::HttpGetIfNoneMatch(url, &etag, &response);
+  KATANA_LOG_VASSERT(res, "getting {}: {}", url, res.error());
+  KATANA_LOG_ASSERT(res.value());
+  KATANA_LOG_VASSERT(etag == "\"v1\"", "entity tag {}", etag);
+  KATANA_LOG_ASSERT(ToString(response) == "tagged v1");
+
+  res = katana::HttpGetIfNoneMatch(url, &etag, &response);
+  KATANA_LOG_ASSERT(res && !res.value());
+  KATANA_LOG_ASSERT(etag == "\"v1\"");
+  KATANA_LOG_ASSERT(ToString(response) == "tagged v1");
+
+  server->SetVersion("v2");
+  res = katana::HttpGetIfNoneMatch(url, &etag, &response);
+  KATANA_LOG_ASSERT(res && res.value());
+  KATANA_LOG_ASSERT(etag == "\"v2\"");
+  KATANA_LOG_ASSERT(ToString(response) == "tagged v2");
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  KATANA_LOG_ASSERT(katana::HttpInit());
+
+  TestServer server;
+  TestMethods(&server);
+  TestConcurrency(&server);
+  TestSink(&server);
+  TestGetIfNoneMatch(&server);
+  TestFailures(&server);
+
+  return 0;
+}
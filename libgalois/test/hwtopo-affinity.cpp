@@ -0,0 +1,92 @@
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+
+#include "katana/HWTopo.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// The number of threads getHWTopo finds in a process that may only run on
+/// the cpus of mask, optionally ignoring the CPU quota of its cgroup. The
+/// topology is computed once per process, so each call forks.
+unsigned
+MaxThreadsIn(const cpu_set_t& mask, bool ignore_quota) {
+  int fds[2];
+  KATANA_LOG_ASSERT(pipe(fds) == 0);
+  pid_t pid = fork();
+  KATANA_LOG_ASSERT(pid >= 0);
+  if (pid == 0) {
+    close(fds[0]);
+    KATANA_LOG_ASSERT(sched_setaffinity(0, sizeof(mask), &mask) == 0);
+    if (ignore_quota) {
+      setenv("KATANA_IGNORE_CPU_QUOTA", "1", 1);
+    } else {
+      unsetenv("KATANA_IGNORE_CPU_QUOTA");
+    }
+
+    const katana::HWTopoInfo& topo = katana::getHWTopo();
+    unsigned max_threads = topo.machineTopoInfo.maxThreads;
+    KATANA_LOG_ASSERT(topo.threadTopoInfo.size() == max_threads);
+    for (const katana::ThreadTopoInfo& thread : topo.threadTopoInfo) {
+      KATANA_LOG_VASSERT(
+          CPU_ISSET(thread.osContext, &mask),
+          "thread {} runs on cpu {}, outside the affinity mask", thread.tid,
+          thread.osContext);
+    }
+    ssize_t written = write(fds[1], &max_threads, sizeof(max_threads));
+    KATANA_LOG_ASSERT(written == sizeof(max_threads));
+    _exit(0);
+  }
+
+  close(fds[1]);
+  int status = 0;
+  KATANA_LOG_ASSERT(waitpid(pid, &status, 0) == pid);
+  KATANA_LOG_VASSERT(
+      WIFEXITED(status) && WEXITSTATUS(status) == 0,
+      "topology process exited with status {}", status);
+  unsigned max_threads = 0;
+  ssize_t got = read(fds[0], &max_threads, sizeof(max_threads));
+  KATANA_LOG_ASSERT(got == sizeof(max_threads));
+  close(fds[0]);
+  return max_threads;
+}
+
+}  // namespace
+
+int
+main() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  KATANA_LOG_ASSERT(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+  unsigned num_allowed = CPU_COUNT(&allowed);
+  KATANA_LOG_ASSERT(num_allowed > 0);
+
+  // Subsets of the cpus this process may run on
+  cpu_set_t subset;
+  CPU_ZERO(&subset);
+  unsigned num_subset = 0;
+  for (int cpu = 0; cpu < CPU_SETSIZE && num_subset < 2; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed)) {
+      CPU_SET(cpu, &subset);
+      num_subset += 1;
+      unsigned found = MaxThreadsIn(subset, true);
+      KATANA_LOG_VASSERT(
+          found == num_subset, "{} threads on {} cpus", found, num_subset);
+    }
+  }
+
+  unsigned all = MaxThreadsIn(allowed, true);
+  KATANA_LOG_VASSERT(
+      all == num_allowed, "{} threads on {} cpus", all, num_allowed);
+
+  // A quota can only take threads away, and always leaves one
+  unsigned limited = MaxThreadsIn(allowed, false);
+  KATANA_LOG_VASSERT(
+      limited >= 1 && limited <= all, "{} threads under quota, of {}",
+      limited, all);
+
+  return 0;
+}
@@ -26,16 +26,19 @@
 void
 printMyTopo() {
   auto t = katana::getHWTopo();
-  std::cout << "T,C,P,N: " << t.machineTopoInfo.maxThreads << " "
+  std::cout << "T,C,P,N,L: " << t.machineTopoInfo.maxThreads << " "
             << t.machineTopoInfo.maxCores << " " << t.machineTopoInfo.maxSockets
-            << " " << t.machineTopoInfo.maxNumaNodes << "\n";
+            << " " << t.machineTopoInfo.maxNumaNodes << " "
+            << t.machineTopoInfo.maxCacheDomains << "\n";
   for (unsigned i = 0; i < t.machineTopoInfo.maxThreads; ++i) {
     auto& c = t.threadTopoInfo[i];
     std::cout << "tid: " << c.tid << " leader: " << c.socketLeader
               << " socket: " << c.socket << " numaNode: " << c.numaNode
               << " cumulativeMaxSocket: " << c.cumulativeMaxSocket
               << " osContext: " << c.osContext
-              << " osNumaNode: " << c.osNumaNode << "\n";
+              << " osNumaNode: " << c.osNumaNode
+              << " cacheDomain: " << c.cacheDomain
+              << " cacheDomainLeader: " << c.cacheDomainLeader << "\n";
   }
 }
 
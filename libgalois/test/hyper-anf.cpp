@@ -0,0 +1,162 @@
+#include <cmath>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/hyper_anf/hyper_anf.h"
+
+using katana::analytics::HyperAnf;
+using katana::analytics::HyperAnfPlan;
+using katana::analytics::HyperAnfStatistics;
+
+namespace {
+
+/// The exact neighborhood function and harmonic centralities of pg, by a
+/// BFS from every node
+struct Exact {
+  std::vector<double> neighborhood_function;
+  std::vector<double> harmonic;
+};
+
+Exact
+ExactDistances(const katana::GraphTopology& topology) {
+  Exact exact;
+  exact.harmonic.resize(topology.num_nodes());
+  std::vector<uint64_t> within;
+  std::vector<uint32_t> dist(topology.num_nodes());
+  for (auto source : topology) {
+    std::fill(dist.begin(), dist.end(), ~uint32_t{0});
+    std::vector<uint32_t> frontier{source};
+    dist[source] = 0;
+    for (uint32_t d = 0; !frontier.empty(); ++d) {
+      if (within.size() <= d) {
+        within.resize(d + 1);
+      }
+      within[d] += frontier.size();
+      if (d > 0) {
+        exact.harmonic[source] += static_cast<double>(frontier.size()) / d;
+      }
+      std::vector<uint32_t> next;
+      for (auto n : frontier) {
+        for (auto e : topology.edges(n)) {
+          auto dst = topology.edge_dest(e);
+          if (dist[dst] == ~uint32_t{0}) {
+            dist[dst] = d + 1;
+            next.emplace_back(dst);
+          }
+        }
+      }
+      frontier.swap(next);
+    }
+  }
+  double total = 0;
+  for (uint64_t count : within) {
+    total += count;
+    exact.neighborhood_function.emplace_back(total);
+  }
+  return exact;
+}
+
+bool
+Near(double estimate, double exact, double relative_error) {
+  return std::fabs(estimate - exact) <= relative_error * exact;
+}
+
+void
+TestHyperAnf(Policy* policy, size_t num_nodes) {
+  auto pg = MakeFileGraph<uint32_t>(num_nodes, 0, policy);
+  Exact exact = ExactDistances(pg->topology());
+
+  auto res = HyperAnf(pg.get(), "harmonic", HyperAnfPlan::Synchronous(10));
+  KATANA_LOG_VASSERT(res, "HyperAnf failed: {}", res.error());
+  HyperAnfStatistics stats = res.value();
+  stats.Print();
+
+  const std::vector<double>& nf = stats.neighborhood_function;
+  const std::vector<double>& exact_nf = exact.neighborhood_function;
+  KATANA_LOG_ASSERT(nf.size() == stats.num_iterations + 1);
+  KATANA_LOG_ASSERT(nf.size() <= exact_nf.size());
+  for (size_t t = 0; t < nf.size(); ++t) {
+    KATANA_LOG_VASSERT(
+        Near(nf[t], exact_nf[t], 0.1), "{} pairs within {}, not {}", nf[t], t,
+        exact_nf[t]);
+    KATANA_LOG_ASSERT(t == 0 || nf[t] >= nf[t - 1]);
+  }
+  KATANA_LOG_ASSERT(Near(nf.back(), exact_nf.back(), 0.1));
+
+  auto column = pg->GetNodeProperty("harmonic");
+  KATANA_LOG_ASSERT(column);
+  auto harmonic = std::static_pointer_cast<arrow::FloatArray>(column->chunk(0));
+  double total = 0;
+  double exact_total = 0;
+  for (auto n : pg->topology()) {
+    KATANA_LOG_ASSERT(harmonic->Value(n) >= 0);
+    total += harmonic->Value(n);
+    exact_total += exact.harmonic[n];
+  }
+  KATANA_LOG_VASSERT(
+      Near(total, exact_total, 0.1), "harmonic centralities sum to {}, not {}",
+      total, exact_total);
+
+  double reachable = exact_nf.back();
+  size_t t = 0;
+  while (exact_nf[t] < 0.9 * reachable) {
+    ++t;
+  }
+  KATANA_LOG_VASSERT(
+      stats.effective_diameter > 0 && stats.effective_diameter <= t + 1,
+      "effective diameter {}, exact 90th percentile {}",
+      stats.effective_diameter, t);
+  KATANA_LOG_ASSERT(
+      stats.average_distance > 0 &&
+      stats.average_distance <= exact_nf.size() - 1);
+
+  // The output must be new
+  KATANA_LOG_ASSERT(!HyperAnf(pg.get(), "harmonic"));
+}
+
+void
+TestCycle() {
+  // Node n reaches n + 1, ..., n + t (mod 200) in t steps
+  LinePolicy policy{1};
+  auto pg = MakeFileGraph<uint32_t>(200, 0, &policy);
+  auto res = HyperAnf(pg.get(), "harmonic", HyperAnfPlan::Synchronous(12));
+  KATANA_LOG_VASSERT(res, "HyperAnf failed: {}", res.error());
+  for (size_t t = 0; t < res.value().neighborhood_function.size(); ++t) {
+    KATANA_LOG_ASSERT(
+        Near(res.value().neighborhood_function[t], 200.0 * (t + 1), 0.1));
+  }
+}
+
+void
+TestInvalidPlan() {
+  LinePolicy policy{1};
+  auto pg = MakeFileGraph<uint32_t>(10, 0, &policy);
+  KATANA_LOG_ASSERT(!HyperAnf(pg.get(), "h", HyperAnfPlan::Synchronous(3)));
+  KATANA_LOG_ASSERT(!HyperAnf(pg.get(), "h", HyperAnfPlan::Synchronous(17)));
+
+  // One iteration only counts the edges
+  auto res = HyperAnf(pg.get(), "h", HyperAnfPlan::Synchronous(4, 1));
+  KATANA_LOG_ASSERT(res);
+  KATANA_LOG_ASSERT(res.value().num_iterations == 1);
+  KATANA_LOG_ASSERT(res.value().neighborhood_function.size() == 2);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  RandomPolicy random{3};
+  TestHyperAnf(&random, 500);
+  LinePolicy line{3};
+  TestHyperAnf(&line, 300);
+  TestCycle();
+  TestInvalidPlan();
+
+  return 0;
+}
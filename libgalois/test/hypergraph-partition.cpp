@@ -0,0 +1,187 @@
+#include <random>
+#include <vector>
+
+#include "katana/HyperGraphView.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/hypergraph_partition/hypergraph_partition.h"
+
+using katana::HyperGraphView;
+using katana::analytics::HyperGraphPartition;
+using katana::analytics::HyperGraphPartitionPlan;
+using katana::analytics::HyperGraphPartitionStatistics;
+using Node = katana::GraphTopology::Node;
+
+namespace {
+
+constexpr uint64_t kClusters = 4;
+constexpr uint64_t kClusterSize = 64;
+constexpr uint64_t kNumNodes = kClusters * kClusterSize;
+
+/// Hyperedges of 3 to 6 nodes inside each of kClusters clusters of
+/// consecutive nodes, and num_crossing hyperedges of 2 nodes between
+/// neighboring clusters
+std::vector<std::vector<Node>>
+ClusteredHyperedges(uint64_t num_crossing) {
+  std::mt19937 gen{5};
+  std::uniform_int_distribution<Node> offset(0, kClusterSize - 1);
+  std::vector<std::vector<Node>> hyperedges;
+  for (uint64_t c = 0; c < kClusters; ++c) {
+    for (int i = 0; i < 100; ++i) {
+      std::vector<Node> pins;
+      for (int j = 0, size = 3 + i % 4; j < size; ++j) {
+        pins.emplace_back(c * kClusterSize + offset(gen));
+      }
+      hyperedges.emplace_back(pins);
+    }
+  }
+  for (uint64_t i = 0; i < num_crossing; ++i) {
+    uint64_t c = i % kClusters;
+    hyperedges.push_back(
+        {Node(c * kClusterSize + offset(gen)),
+         Node((c + 1) % kClusters * kClusterSize + offset(gen))});
+  }
+  return hyperedges;
+}
+
+/// The hyperedges cut by placing node n in partition n % num_partitions
+uint64_t
+RoundRobinCut(
+    const std::vector<std::vector<Node>>& hyperedges,
+    uint32_t num_partitions) {
+  uint64_t cut = 0;
+  for (const auto& pins : hyperedges) {
+    for (Node n : pins) {
+      if (n % num_partitions != pins[0] % num_partitions) {
+        cut += 1;
+        break;
+      }
+    }
+  }
+  return cut;
+}
+
+std::vector<uint32_t>
+ReadPartitions(katana::PropertyGraph* pg, const std::string& name) {
+  auto column = pg->GetNodeProperty(name);
+  KATANA_LOG_VASSERT(column, "no property {}", name);
+  auto array = std::static_pointer_cast<arrow::UInt32Array>(column->chunk(0));
+  std::vector<uint32_t> values;
+  for (int64_t i = 0; i < array->length(); ++i) {
+    values.emplace_back(array->Value(i));
+  }
+  return values;
+}
+
+void
+TestView() {
+  std::vector<std::vector<Node>> hyperedges{{0, 1, 2}, {2, 3}, {}};
+  auto pg_res = HyperGraphView::MakeGraph(5, hyperedges);
+  KATANA_LOG_VASSERT(pg_res, "MakeGraph failed: {}", pg_res.error());
+  auto pg = std::move(pg_res.value());
+  KATANA_LOG_ASSERT(pg->topology().num_nodes() == 8);
+
+  auto view_res = HyperGraphView::Make(pg.get(), hyperedges.size());
+  KATANA_LOG_ASSERT(view_res);
+  const HyperGraphView& view = view_res.value();
+  KATANA_LOG_ASSERT(view.num_hyperedges() == 3);
+  KATANA_LOG_ASSERT(view.num_nodes() == 5);
+  KATANA_LOG_ASSERT(view.num_pins() == 5);
+  for (Node h = 0; h < hyperedges.size(); ++h) {
+    std::vector<Node> pins;
+    for (auto e : view.pins(h)) {
+      pins.emplace_back(view.pin_node(e));
+    }
+    KATANA_LOG_ASSERT(pins == hyperedges[h]);
+  }
+  KATANA_LOG_ASSERT(view.node_id(4) == 7);
+
+  // Hyperedge 1 would be a node with edges, and no graph has 9 nodes
+  KATANA_LOG_ASSERT(!HyperGraphView::Make(pg.get(), 1));
+  KATANA_LOG_ASSERT(!HyperGraphView::Make(pg.get(), 9));
+  KATANA_LOG_ASSERT(!HyperGraphView::MakeGraph(2, hyperedges));
+}
+
+void
+TestPartition(uint32_t num_partitions, HyperGraphPartitionPlan plan) {
+  constexpr uint64_t kCrossing = 8;
+  std::vector<std::vector<Node>> hyperedges = ClusteredHyperedges(kCrossing);
+  auto pg = std::move(HyperGraphView::MakeGraph(kNumNodes, hyperedges).value());
+  uint64_t num_hyperedges = hyperedges.size();
+
+  auto res = HyperGraphPartition(
+      pg.get(), num_hyperedges, num_partitions, "partition", plan);
+  KATANA_LOG_VASSERT(res, "partitioning failed: {}", res.error());
+  auto valid_res = katana::analytics::HyperGraphPartitionAssertValid(
+      pg.get(), num_hyperedges, num_partitions, "partition");
+  KATANA_LOG_VASSERT(valid_res, "invalid partition: {}", valid_res.error());
+
+  auto stats_res = HyperGraphPartitionStatistics::Compute(
+      pg.get(), num_hyperedges, "partition");
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  HyperGraphPartitionStatistics stats = stats_res.value();
+  stats.Print();
+  KATANA_LOG_VASSERT(
+      stats.n_partitions == num_partitions, "found {} partitions, not {}",
+      stats.n_partitions, num_partitions);
+  KATANA_LOG_VASSERT(
+      stats.imbalance <= 0.25, "partitions are imbalanced by {}",
+      stats.imbalance);
+  uint64_t naive_cut = RoundRobinCut(hyperedges, num_partitions);
+  KATANA_LOG_VASSERT(
+      4 * stats.hyperedge_cut <= naive_cut, "cut {} hyperedges, naively {}",
+      stats.hyperedge_cut, naive_cut);
+
+  // The same partition for any number of threads
+  std::vector<uint32_t> expected = ReadPartitions(pg.get(), "partition");
+  for (unsigned threads : {1, 3}) {
+    katana::setActiveThreads(threads);
+    std::string name = "partition" + std::to_string(threads);
+    KATANA_LOG_ASSERT(HyperGraphPartition(
+        pg.get(), num_hyperedges, num_partitions, name, plan));
+    KATANA_LOG_ASSERT(ReadPartitions(pg.get(), name) == expected);
+  }
+  katana::setActiveThreads(4);
+
+  // The output property may not exist before the call
+  KATANA_LOG_ASSERT(!HyperGraphPartition(
+      pg.get(), num_hyperedges, num_partitions, "partition", plan));
+}
+
+void
+TestInvalid() {
+  auto pg = std::move(HyperGraphView::MakeGraph(4, {{0, 1}, {2, 3}}).value());
+  KATANA_LOG_ASSERT(!HyperGraphPartition(pg.get(), 2, 0, "p"));
+  KATANA_LOG_ASSERT(!HyperGraphPartition(
+      pg.get(), 2, 2, "p",
+      HyperGraphPartitionPlan::Multilevel(
+          HyperGraphPartitionPlan::kHigherDegree, -1)));
+  KATANA_LOG_ASSERT(!HyperGraphPartition(pg.get(), 1, 2, "p"));
+
+  // More partitions than nodes leaves some empty, yet valid
+  KATANA_LOG_ASSERT(HyperGraphPartition(pg.get(), 2, 8, "p"));
+  KATANA_LOG_ASSERT(
+      katana::analytics::HyperGraphPartitionAssertValid(pg.get(), 2, 8, "p"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestView();
+  TestPartition(2, HyperGraphPartitionPlan::Multilevel());
+  TestPartition(4, HyperGraphPartitionPlan::Multilevel());
+  TestPartition(
+      2, HyperGraphPartitionPlan::Multilevel(
+             HyperGraphPartitionPlan::kLowerWeight));
+  TestPartition(
+      4, HyperGraphPartitionPlan::Multilevel(
+             HyperGraphPartitionPlan::kRandom));
+  TestInvalid();
+
+  return 0;
+}
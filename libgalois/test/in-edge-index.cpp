@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+using DataType = int64_t;
+
+void
+TestInEdgeIndex(size_t num_nodes, Policy* policy) {
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, policy);
+  const katana::GraphTopology& topology = g->topology();
+
+  KATANA_LOG_ASSERT(!g->HasInEdgeIndex());
+  auto res = g->GetInEdgeIndex();
+  KATANA_LOG_VASSERT(res, "could not make in-edge index: {}", res.error());
+  std::shared_ptr<const katana::InEdgeIndex> index = res.value();
+  KATANA_LOG_ASSERT(g->HasInEdgeIndex());
+
+  KATANA_LOG_ASSERT(index->num_nodes() == topology.num_nodes());
+  KATANA_LOG_ASSERT(index->num_edges() == topology.num_edges());
+
+  // Brute force: collect (src, out edge id) pairs for every destination
+  std::vector<std::vector<std::pair<uint32_t, uint64_t>>> expected(num_nodes);
+  for (auto src : topology) {
+    for (auto e : topology.edges(src)) {
+      expected[topology.edge_dest(e)].emplace_back(src, e);
+    }
+  }
+
+  for (auto n : topology) {
+    std::vector<std::pair<uint32_t, uint64_t>> actual;
+    for (auto in_e : index->in_edges(n)) {
+      uint32_t src = index->in_edge_src(in_e);
+      uint64_t out_e = index->out_edge_id(in_e);
+      KATANA_LOG_ASSERT(topology.edge_dest(out_e) == n);
+      actual.emplace_back(src, out_e);
+    }
+    KATANA_LOG_VASSERT(
+        std::is_sorted(actual.begin(), actual.end()),
+        "in-edges of {} not sorted by source", n);
+    KATANA_LOG_VASSERT(
+        actual == expected[n], "in-edges of {} do not match transpose", n);
+  }
+
+  auto again = g->GetInEdgeIndex();
+  KATANA_LOG_ASSERT(again && again.value() == index);
+
+  auto drop_res = g->DropInEdgeIndex();
+  KATANA_LOG_VASSERT(drop_res, "could not drop index: {}", drop_res.error());
+  KATANA_LOG_ASSERT(!g->HasInEdgeIndex());
+}
+
+/// Add bool edge types "even" and "third" and group the edges by them
+void
+TestEdgeTypeIndex(size_t num_nodes, Policy* policy) {
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, policy);
+  const katana::GraphTopology& topology = g->topology();
+
+  arrow::BooleanBuilder even;
+  arrow::BooleanBuilder third;
+  for (uint64_t e = 0; e < topology.num_edges(); ++e) {
+    KATANA_LOG_ASSERT(even.Append(e % 2 == 0).ok());
+    KATANA_LOG_ASSERT(third.Append(e % 3 == 0).ok());
+  }
+  auto types = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("even", arrow::boolean()),
+           arrow::field("third", arrow::boolean())}),
+      {even.Finish().ValueOrDie(), third.Finish().ValueOrDie()});
+  if (auto r = g->AddEdgeProperties(types); !r) {
+    KATANA_LOG_FATAL("could not add edge types: {}", r.error());
+  }
+  if (auto r = g->ConstructTypeSetIDs(); !r) {
+    KATANA_LOG_FATAL("could not construct type set ids: {}", r.error());
+  }
+
+  auto res = g->GetEdgeTypeIndex();
+  KATANA_LOG_VASSERT(res, "could not make edge type index: {}", res.error());
+  std::shared_ptr<const katana::EdgeTypeIndex> index = res.value();
+  KATANA_LOG_ASSERT(index->num_edges() == topology.num_edges());
+  KATANA_LOG_ASSERT(index->num_type_set_ids == g->GetEdgeTypeSetIDsNum());
+
+  for (auto n : topology) {
+    // The typed ranges partition the edges of n in order of type and keep
+    // the original order of edges within a type
+    uint64_t next = *index->edges(n).begin();
+    for (uint64_t t = 0; t < index->num_type_set_ids; ++t) {
+      std::vector<uint64_t> expected;
+      for (auto e : topology.edges(n)) {
+        if (g->GetEdgeTypeSetID(e) == t) {
+          expected.emplace_back(e);
+        }
+      }
+      std::vector<uint64_t> actual;
+      for (auto e : index->edges(n, t)) {
+        KATANA_LOG_ASSERT(e == next++);
+        uint64_t out_e = index->out_edge_id(e);
+        KATANA_LOG_ASSERT(index->edge_dest(e) == topology.edge_dest(out_e));
+        actual.emplace_back(out_e);
+      }
+      KATANA_LOG_VASSERT(
+          actual == expected, "edges of {} with type {} do not match", n, t);
+    }
+    KATANA_LOG_ASSERT(next == *index->edges(n).end());
+  }
+
+  auto again = g->GetEdgeTypeIndex();
+  KATANA_LOG_ASSERT(again && again.value() == index);
+}
+
+/// Nodes of degrees from 0 to 49, to random destinations that repeat
+class SkewedPolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    auto& gen = katana::GetGenerator();
+    std::uniform_int_distribution dist({}, num_nodes - 1);
+    for (size_t i = 0; i < node_id * 7 % 50; ++i) {
+      r.emplace_back(dist(gen));
+    }
+    return r;
+  }
+};
+
+/// The first edge from src to dst, or the end of the edges of src
+uint64_t
+ExpectedEdge(
+    const katana::GraphTopology& topology, uint32_t src, uint32_t dst) {
+  for (auto e : topology.edges(src)) {
+    if (topology.edge_dest(e) == dst) {
+      return e;
+    }
+  }
+  return *topology.edges(src).end();
+}
+
+void
+TestEdgeExistenceIndex(size_t num_nodes, uint64_t min_degree) {
+  SkewedPolicy policy;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, &policy);
+
+  // Unsorted edges are scanned below min_degree
+  for (int sorted = 0; sorted < 2; ++sorted) {
+    const katana::GraphTopology& topology = g->topology();
+    KATANA_LOG_ASSERT(!g->edge_existence_index());
+    auto res = g->GetEdgeExistenceIndex(min_degree);
+    KATANA_LOG_VASSERT(res, "could not make index: {}", res.error());
+    std::shared_ptr<const katana::EdgeExistenceIndex> index = res.value();
+    KATANA_LOG_ASSERT(g->edge_existence_index() == index.get());
+    KATANA_LOG_ASSERT(index->sorted_by_dest == static_cast<bool>(sorted));
+
+    for (auto src : topology) {
+      auto [begin, end] = topology.edge_range(src);
+      uint64_t degree = end - begin;
+      bool has_table = index->table_begins[src + 1] > index->table_begins[src];
+      KATANA_LOG_ASSERT(has_table == (degree > 0 && degree >= min_degree));
+      for (uint32_t dst = 0; dst < num_nodes; ++dst) {
+        uint64_t expected = ExpectedEdge(topology, src, dst);
+        KATANA_LOG_VASSERT(
+            index->FindEdge(src, dst) == expected, "edge {} -> {} not found",
+            src, dst);
+        KATANA_LOG_ASSERT(index->HasEdge(src, dst) == (expected != end));
+        if (sorted) {
+          KATANA_LOG_ASSERT(
+              katana::FindEdgeSortedByDest(g.get(), src, dst) == expected);
+        }
+      }
+    }
+
+    auto again = g->GetEdgeExistenceIndex(min_degree);
+    KATANA_LOG_ASSERT(again && again.value() == index);
+
+    // Sorting modifies the topology, which drops the index
+    auto sort_res = katana::EnsureAllEdgesSortedByDest(g.get());
+    KATANA_LOG_ASSERT(sort_res);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy line{3};
+  TestInEdgeIndex(10, &line);
+
+  RandomPolicy random{5};
+  TestInEdgeIndex(100, &random);
+  TestEdgeTypeIndex(100, &random);
+
+  TestEdgeExistenceIndex(100, 16);
+  TestEdgeExistenceIndex(100, 0);
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+#include "tsuba/IOScheduler.h"
+
+using tsuba::IOPriority;
+using tsuba::IOScheduler;
+
+namespace {
+
+/// Ops and bytes running on a backend, and the most of each seen at once
+struct Usage {
+  uint32_t ops{0};
+  uint64_t bytes{0};
+  uint32_t max_ops{0};
+  uint64_t max_bytes{0};
+  /// Times an op larger than the byte bound ran beside another op
+  uint32_t shared_large{0};
+};
+
+/// Ops of each backend never run more at once or hold more bytes than the
+/// bounds, except a large op that runs alone
+void
+TestBounds() {
+  constexpr uint32_t kMaxOps = 3;
+  constexpr uint64_t kMaxBytes = 100;
+  IOScheduler scheduler(kMaxOps, kMaxBytes, 8);
+
+  std::mutex mutex;
+  std::unordered_map<std::string, Usage> usage;
+  std::vector<std::future<katana::Result<void>>> futures;
+  for (uint32_t i = 0; i < 60; ++i) {
+    std::string backend = i % 2 == 0 ? "mem" : "file";
+    uint64_t bytes = i % 10 == 3 ? 2 * kMaxBytes : 10 + (i * 7) % 50;
+    auto op = [&, backend, bytes]() -> katana::Result<void> {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        Usage& u = usage[backend];
+        u.ops += 1;
+        u.bytes += bytes;
+        u.max_ops = std::max(u.max_ops, u.ops);
+        if (bytes <= kMaxBytes) {
+          u.max_bytes = std::max(u.max_bytes, u.bytes);
+        } else if (u.ops > 1) {
+          u.shared_large += 1;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      std::lock_guard<std::mutex> lock(mutex);
+      usage[backend].ops -= 1;
+      usage[backend].bytes -= bytes;
+      return katana::ResultSuccess();
+    };
+    futures.emplace_back(scheduler.Schedule<void>(
+        backend + "://bucket/" + std::to_string(i),
+        i % 3 == 0 ? IOPriority::Topology : IOPriority::Properties, bytes,
+        op));
+  }
+  for (auto& future : futures) {
+    KATANA_LOG_ASSERT(future.get());
+  }
+
+  KATANA_LOG_ASSERT(usage.size() == 2);
+  for (const auto& [backend, u] : usage) {
+    KATANA_LOG_VASSERT(
+        u.max_ops <= kMaxOps, "{} ran {} ops at once", backend, u.max_ops);
+    KATANA_LOG_VASSERT(
+        u.max_bytes <= kMaxBytes, "{} held {} bytes at once", backend,
+        u.max_bytes);
+    KATANA_LOG_VASSERT(
+        u.shared_large == 0, "{} ran large ops beside others", backend);
+  }
+}
+
+/// Queued ops of a higher class start before those of a lower one
+void
+TestPriority() {
+  IOScheduler scheduler(1, IOScheduler::kDefaultMaxBytes, 4);
+
+  // Hold the only slot until every op is queued
+  std::promise<void> started;
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  auto blocker = scheduler.Schedule<void>(
+      "file:///blocker", IOPriority::Topology, 0,
+      [&]() -> katana::Result<void> {
+        started.set_value();
+        released.wait();
+        return katana::ResultSuccess();
+      });
+  started.get_future().wait();
+
+  std::mutex mutex;
+  std::vector<std::string> order;
+  std::vector<std::future<katana::Result<std::string>>> futures;
+  for (const auto& [name, priority] :
+       std::vector<std::pair<std::string, IOPriority>>{
+           {"properties-0", IOPriority::Properties},
+           {"topology-0", IOPriority::Topology},
+           {"properties-1", IOPriority::Properties},
+           {"topology-1", IOPriority::Topology}}) {
+    futures.emplace_back(scheduler.Schedule<std::string>(
+        "/local/" + name, priority, 1,
+        [&, name = name]() -> katana::Result<std::string> {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.emplace_back(name);
+          return name;
+        }));
+  }
+  release.set_value();
+
+  KATANA_LOG_ASSERT(blocker.get());
+  for (auto& future : futures) {
+    KATANA_LOG_ASSERT(future.get());
+  }
+  std::vector<std::string> expected{
+      "topology-0", "topology-1", "properties-0", "properties-1"};
+  KATANA_LOG_VASSERT(
+      order == expected, "ops ran in the order {}", fmt::join(order, ", "));
+}
+
+/// Ops that fill every slot can wait for ops they schedule
+void
+TestNestedOps() {
+  constexpr uint32_t kMaxOps = 2;
+  IOScheduler scheduler(kMaxOps, IOScheduler::kDefaultMaxBytes, kMaxOps);
+
+  std::vector<std::future<katana::Result<uint32_t>>> futures;
+  for (uint32_t i = 0; i < 2 * kMaxOps; ++i) {
+    futures.emplace_back(scheduler.Schedule<uint32_t>(
+        "file:///outer", IOPriority::Properties, 1,
+        [&scheduler, i]() -> katana::Result<uint32_t> {
+          auto inner = scheduler.Schedule<uint32_t>(
+              "file:///inner", IOPriority::Topology, 1,
+              [i]() -> katana::Result<uint32_t> { return i + 1; });
+          auto res = inner.get();
+          if (!res) {
+            return res.error();
+          }
+          return res.value() * 10;
+        }));
+  }
+  for (uint32_t i = 0; i < futures.size(); ++i) {
+    auto res = futures[i].get();
+    KATANA_LOG_VASSERT(res, "op {} failed: {}", i, res.error());
+    KATANA_LOG_ASSERT(res.value() == (i + 1) * 10);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestBounds();
+  TestPriority();
+  TestNestedOps();
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/IOStats.h"
+#include "tsuba/file.h"
+
+namespace fs = boost::filesystem;
+
+using tsuba::IOOp;
+
+void
+TestPercentiles() {
+  tsuba::ResetIOStats();
+  for (uint64_t usec = 1; usec <= 1000; ++usec) {
+    tsuba::RecordIO(IOOp::kCopy, usec, 10, usec != 1000);
+  }
+  tsuba::IOOpStats stats = tsuba::GetIOStats(IOOp::kCopy);
+  KATANA_LOG_ASSERT(stats.count == 1000 && stats.errors == 1);
+  KATANA_LOG_ASSERT(stats.bytes == 10000);
+  KATANA_LOG_ASSERT(stats.total_usec == 500500 && stats.max_usec == 1000);
+  // Percentiles are rounded up to within a quarter of their value
+  KATANA_LOG_VASSERT(
+      stats.p50_usec >= 500 && stats.p50_usec <= 625, "p50 {}",
+      stats.p50_usec);
+  KATANA_LOG_VASSERT(
+      stats.p90_usec >= 900 && stats.p90_usec <= 1000, "p90 {}",
+      stats.p90_usec);
+  KATANA_LOG_VASSERT(
+      stats.p99_usec >= 990 && stats.p99_usec <= 1000, "p99 {}",
+      stats.p99_usec);
+
+  tsuba::ResetIOStats();
+  stats = tsuba::GetIOStats(IOOp::kCopy);
+  KATANA_LOG_ASSERT(stats.count == 0 && stats.p99_usec == 0);
+}
+
+void
+TestFileOps(const std::string& dir) {
+  tsuba::ResetIOStats();
+  std::string file = dir + "/data";
+  std::string data(4096, 'x');
+  auto res = tsuba::FileStore(file, data.data(), data.size());
+  KATANA_LOG_VASSERT(res, "storing {}: {}", file, res.error());
+  res = tsuba::FileStoreAsync(file, data.data(), data.size()).get();
+  KATANA_LOG_VASSERT(res, "storing {}: {}", file, res.error());
+
+  tsuba::StatBuf stat;
+  res = tsuba::FileStat(file, &stat);
+  KATANA_LOG_VASSERT(res, "stat of {}: {}", file, res.error());
+  KATANA_LOG_ASSERT(!tsuba::FileStat(dir + "/missing", &stat));
+
+  std::string read(data.size(), '\0');
+  res = tsuba::FileGet(file, read.data(), 0, read.size());
+  KATANA_LOG_VASSERT(res, "reading {}: {}", file, res.error());
+
+  std::vector<std::string> list;
+  std::vector<uint64_t> sizes;
+  res = tsuba::FileListAsync(dir, &list, &sizes).get();
+  KATANA_LOG_VASSERT(res, "listing {}: {}", dir, res.error());
+  res = tsuba::FileDelete(dir, {"data"});
+  KATANA_LOG_VASSERT(res, "deleting {}: {}", file, res.error());
+
+  tsuba::IOOpStats put = tsuba::GetIOStats(IOOp::kPut);
+  KATANA_LOG_ASSERT(put.count == 2 && put.bytes == 2 * data.size());
+  tsuba::IOOpStats stat_stats = tsuba::GetIOStats(IOOp::kStat);
+  KATANA_LOG_ASSERT(stat_stats.count == 2 && stat_stats.errors == 1);
+  tsuba::IOOpStats get = tsuba::GetIOStats(IOOp::kGet);
+  KATANA_LOG_ASSERT(get.count == 1 && get.bytes == data.size());
+  KATANA_LOG_ASSERT(tsuba::GetIOStats(IOOp::kList).count == 1);
+  KATANA_LOG_ASSERT(tsuba::GetIOStats(IOOp::kDelete).count == 1);
+  KATANA_LOG_ASSERT(tsuba::GetIOStats(IOOp::kCopy).count == 0);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/iostats");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());
+  fs::create_directories(dir);
+
+  TestPercentiles();
+  TestFileOps(dir);
+
+  fs::remove_all(dir);
+  return 0;
+}
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/k_core/k_core.h"
+#include "katana/analytics/k_truss/k_truss.h"
+
+using DataType = int64_t;
+using Edge = std::pair<uint32_t, uint32_t>;
+using EdgeSet = std::set<Edge>;
+
+/// The symmetric graph of a set of undirected edges, (u, v) with u < v
+class EdgeSetPolicy : public Policy {
+  std::vector<std::vector<uint32_t>> neighbors_;
+
+public:
+  EdgeSetPolicy(size_t num_nodes, const EdgeSet& edges)
+      : neighbors_(num_nodes) {
+    for (const auto& [u, v] : edges) {
+      neighbors_[u].push_back(v);
+      neighbors_[v].push_back(u);
+    }
+    for (auto& n : neighbors_) {
+      std::sort(n.begin(), n.end());
+    }
+  }
+
+  std::vector<uint32_t> GenerateNeighbors(size_t node_id, size_t) override {
+    return neighbors_[node_id];
+  }
+};
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(size_t num_nodes, const EdgeSet& edges) {
+  EdgeSetPolicy policy{num_nodes, edges};
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, &policy);
+  auto res = katana::EnsureAllEdgesSortedByDest(pg.get());
+  KATANA_LOG_VASSERT(res, "could not sort edges: {}", res.error());
+  return pg;
+}
+
+/// Edges between nearby nodes, which close many triangles
+EdgeSet
+NearbyEdges(size_t num_nodes, std::mt19937* gen) {
+  std::bernoulli_distribution keep(0.4);
+  EdgeSet edges;
+  for (uint32_t u = 0; u < num_nodes; ++u) {
+    for (uint32_t d = 1; d <= 10; ++d) {
+      uint32_t v = (u + d) % num_nodes;
+      if (keep(*gen)) {
+        edges.emplace(std::min(u, v), std::max(u, v));
+      }
+    }
+  }
+  return edges;
+}
+
+std::map<Edge, uint32_t>
+EdgeValues(katana::PropertyGraph* pg, const std::string& name) {
+  auto res = pg->GetEdgePropertyTyped<uint32_t>(name);
+  KATANA_LOG_VASSERT(res, "no property {}: {}", name, res.error());
+  std::map<Edge, uint32_t> values;
+  const auto& topology = pg->topology();
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      values[{n, topology.edge_dest(e)}] = res.value()->Value(e);
+    }
+  }
+  return values;
+}
+
+void
+TestCore(
+    size_t num_nodes, const EdgeSet& before, const EdgeSet& after,
+    const std::vector<Edge>& inserted, const std::vector<Edge>& deleted) {
+  auto old_pg = MakeGraph(num_nodes, before);
+  auto res = katana::analytics::KCoreDecomposition(old_pg.get(), "core");
+  KATANA_LOG_VASSERT(res, "core decomposition failed: {}", res.error());
+
+  auto new_pg = MakeGraph(num_nodes, after);
+  std::vector<uint32_t> old_core =
+      NodePropertyValues<uint32_t>(old_pg.get(), "core");
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("core", arrow::uint32())}),
+      {katana::BuildArray(old_core)});
+  auto add_res = new_pg->AddNodeProperties(table);
+  KATANA_LOG_VASSERT(add_res, "could not add core: {}", add_res.error());
+
+  res = katana::analytics::KCoreDecompositionIncremental(
+      new_pg.get(), "core", inserted, deleted);
+  KATANA_LOG_VASSERT(res, "incremental core failed: {}", res.error());
+  res = katana::analytics::KCoreDecomposition(new_pg.get(), "expected");
+  KATANA_LOG_VASSERT(res, "core decomposition failed: {}", res.error());
+
+  std::vector<uint32_t> actual =
+      NodePropertyValues<uint32_t>(new_pg.get(), "core");
+  std::vector<uint32_t> expected =
+      NodePropertyValues<uint32_t>(new_pg.get(), "expected");
+  for (size_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_VASSERT(
+        actual[n] == expected[n], "node {}: expected coreness {} found {}", n,
+        expected[n], actual[n]);
+  }
+}
+
+void
+TestTruss(
+    size_t num_nodes, const EdgeSet& before, const EdgeSet& after,
+    const std::vector<Edge>& inserted, const std::vector<Edge>& deleted) {
+  auto old_pg = MakeGraph(num_nodes, before);
+  auto res = katana::analytics::KTrussDecomposition(old_pg.get(), "truss");
+  KATANA_LOG_VASSERT(res, "truss decomposition failed: {}", res.error());
+  std::map<Edge, uint32_t> old_truss = EdgeValues(old_pg.get(), "truss");
+
+  // Carry the old trussness over to the edges kept; inserted edges get a
+  // value that must be ignored
+  auto new_pg = MakeGraph(num_nodes, after);
+  const auto& topology = new_pg->topology();
+  std::vector<uint32_t> carried;
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      auto it = old_truss.find({n, topology.edge_dest(e)});
+      carried.push_back(it == old_truss.end() ? 1000 : it->second);
+    }
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("truss", arrow::uint32())}),
+      {katana::BuildArray(carried)});
+  auto add_res = new_pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(add_res, "could not add truss: {}", add_res.error());
+
+  res = katana::analytics::KTrussDecompositionIncremental(
+      new_pg.get(), "truss", inserted, deleted);
+  KATANA_LOG_VASSERT(res, "incremental truss failed: {}", res.error());
+  res = katana::analytics::KTrussDecomposition(new_pg.get(), "expected");
+  KATANA_LOG_VASSERT(res, "truss decomposition failed: {}", res.error());
+
+  auto actual = EdgeValues(new_pg.get(), "truss");
+  auto expected = EdgeValues(new_pg.get(), "expected");
+  for (const auto& [edge, trussness] : expected) {
+    KATANA_LOG_VASSERT(
+        actual[edge] == trussness, "edge {} -> {}: expected {} found {}",
+        edge.first, edge.second, trussness, actual[edge]);
+  }
+}
+
+void
+TestIncremental(size_t num_nodes) {
+  std::mt19937 gen(num_nodes);
+  EdgeSet before = NearbyEdges(num_nodes, &gen);
+
+  // Delete some edges and insert some nearby and some distant ones
+  EdgeSet after;
+  std::vector<Edge> inserted;
+  std::vector<Edge> deleted;
+  std::bernoulli_distribution drop(0.05);
+  for (const auto& edge : before) {
+    if (drop(gen)) {
+      deleted.emplace_back(edge);
+    } else {
+      after.emplace(edge);
+    }
+  }
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  std::uniform_int_distribution<uint32_t> offset(1, 12);
+  for (size_t i = 0; i < num_nodes / 4; ++i) {
+    uint32_t u = node(gen);
+    uint32_t v = i % 2 ? node(gen) : (u + offset(gen)) % num_nodes;
+    Edge edge{std::min(u, v), std::max(u, v)};
+    if (u != v && !before.count(edge) && after.emplace(edge).second) {
+      inserted.emplace_back(edge.second, edge.first);
+    }
+  }
+  KATANA_LOG_ASSERT(!inserted.empty() && !deleted.empty());
+
+  EdgeSet grown = before;
+  for (const auto& [u, v] : inserted) {
+    grown.emplace(v, u);
+  }
+  TestCore(num_nodes, before, grown, inserted, {});
+  TestCore(num_nodes, grown, after, {}, deleted);
+  TestCore(num_nodes, before, after, inserted, deleted);
+  // Undoing the changes gives back the old coreness
+  TestCore(num_nodes, after, before, deleted, inserted);
+
+  TestTruss(num_nodes, before, after, inserted, deleted);
+  TestTruss(num_nodes, after, before, deleted, inserted);
+
+  // Edges that are not in the graph are rejected
+  auto pg = MakeGraph(num_nodes, after);
+  auto res = katana::analytics::KCoreDecomposition(pg.get(), "core");
+  KATANA_LOG_ASSERT(res);
+  std::vector<Edge> bad{{static_cast<uint32_t>(num_nodes), 0}};
+  KATANA_LOG_ASSERT(!katana::analytics::KCoreDecompositionIncremental(
+      pg.get(), "core", bad, {}));
+  KATANA_LOG_ASSERT(!katana::analytics::KCoreDecompositionIncremental(
+      pg.get(), "core", deleted, {}));
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestIncremental(500);
+
+  return 0;
+}
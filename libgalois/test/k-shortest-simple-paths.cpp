@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/k_shortest_simple_paths/k_shortest_simple_paths.h"
+
+using DataType = int64_t;
+using katana::analytics::KShortestSimplePathsResult;
+
+/// Add the edge property "weight" with random weights in [min, max]
+template <typename Weight>
+void
+AddWeights(katana::PropertyGraph* pg, Weight min, Weight max) {
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<int64_t> dist(min, max);
+  std::vector<Weight> weights(pg->topology().num_edges());
+  for (auto& w : weights) {
+    w = dist(gen);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(
+          "weight", arrow::CTypeTraits<Weight>::type_singleton())}),
+      {katana::BuildArray(weights)});
+  auto res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add weights: {}", res.error());
+}
+
+/// \returns the weights of all simple paths from source to target, lightest
+/// first, by enumerating them
+template <typename Weight>
+std::vector<double>
+AllPathWeights(katana::PropertyGraph* pg, uint32_t source, uint32_t target) {
+  const katana::GraphTopology& topology = pg->topology();
+  auto weights = pg->GetEdgePropertyTyped<Weight>("weight").value();
+  std::vector<double> found;
+  std::vector<bool> on_path(topology.num_nodes());
+
+  auto visit = [&](auto& self, uint32_t n, double weight) -> void {
+    if (n == target) {
+      found.emplace_back(weight);
+      return;
+    }
+    on_path[n] = true;
+    for (uint32_t dst = 0; dst < topology.num_nodes(); ++dst) {
+      if (on_path[dst]) {
+        continue;
+      }
+      // Only the lightest of parallel edges counts
+      double lightest = INFINITY;
+      for (auto e : topology.edges(n)) {
+        if (topology.edge_dest(e) == dst) {
+          lightest = std::min(lightest, double(weights->Value(e)));
+        }
+      }
+      if (lightest != INFINITY) {
+        self(self, dst, weight + lightest);
+      }
+    }
+    on_path[n] = false;
+  };
+  visit(visit, source, 0);
+
+  std::sort(found.begin(), found.end());
+  return found;
+}
+
+template <typename Weight>
+void
+TestPaths(Policy* policy, size_t num_nodes, size_t k) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  AddWeights<Weight>(pg.get(), 0, 9);
+
+  for (uint32_t source = 0; source < 3; ++source) {
+    uint32_t target = num_nodes - 1 - source;
+    auto res = katana::analytics::KShortestSimplePaths(
+        pg.get(), source, target, k, "weight");
+    KATANA_LOG_VASSERT(res, "k shortest paths failed: {}", res.error());
+    KShortestSimplePathsResult result = res.value();
+
+    auto valid_res = katana::analytics::KShortestSimplePathsAssertValid(
+        pg.get(), source, target, "weight", result);
+    KATANA_LOG_VASSERT(valid_res, "invalid paths: {}", valid_res.error());
+
+    std::vector<double> expected =
+        AllPathWeights<Weight>(pg.get(), source, target);
+    expected.resize(std::min(expected.size(), k));
+    KATANA_LOG_VASSERT(
+        result.weights == expected, "found {} paths from {} to {}, not {}",
+        result.weights.size(), source, target, expected.size());
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // A cycle has a single simple path between two nodes
+  LinePolicy cycle{1};
+  TestPaths<uint32_t>(&cycle, 20, 5);
+
+  for (size_t width : {2, 3}) {
+    RandomPolicy random{width};
+    TestPaths<uint32_t>(&random, 10, 20);
+    TestPaths<int64_t>(&random, 10, 20);
+    TestPaths<double>(&random, 10, 200);
+  }
+
+  // Negative weights are rejected
+  LinePolicy line{2};
+  auto pg = MakeFileGraph<DataType>(10, 0, &line);
+  AddWeights<int32_t>(pg.get(), -1, -1);
+  auto res =
+      katana::analytics::KShortestSimplePaths(pg.get(), 0, 5, 3, "weight");
+  KATANA_LOG_ASSERT(!res);
+
+  // A path from a node to itself is the node alone
+  auto unsigned_pg = MakeFileGraph<DataType>(10, 0, &line);
+  AddWeights<uint32_t>(unsigned_pg.get(), 1, 1);
+  res = katana::analytics::KShortestSimplePaths(
+      unsigned_pg.get(), 4, 4, 3, "weight");
+  KATANA_LOG_VASSERT(res, "k shortest paths failed: {}", res.error());
+  KATANA_LOG_ASSERT(res.value().paths.size() == 1);
+  KATANA_LOG_ASSERT(res.value().paths[0] == std::vector<uint32_t>{4});
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "katana/LargeArray.h"
+
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PageAlloc.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+/// Records the thread that constructed it
+struct Owner {
+  Owner() : tid(katana::ThreadPool::getTID()) {}
+  explicit Owner(unsigned offset)
+      : tid(katana::ThreadPool::getTID() + offset) {}
+
+  unsigned tid;
+};
+
+/// The thread that a do_all over [0, n) without stealing gives each element
+std::vector<unsigned>
+DoAllOwners(size_t n) {
+  std::vector<unsigned> owners(n);
+  katana::do_all(
+      katana::iterate(size_t{0}, n),
+      [&](size_t i) { owners[i] = katana::ThreadPool::getTID(); },
+      katana::no_stats());
+  return owners;
+}
+
+void
+TestConstructParallel(size_t n) {
+  std::vector<unsigned> owners = DoAllOwners(n);
+
+  katana::LargeArray<Owner> array;
+  array.createBlocked(n, 100u);
+  KATANA_LOG_ASSERT(array.size() == n);
+  for (size_t i = 0; i < n; ++i) {
+    KATANA_LOG_VASSERT(
+        array[i].tid == owners[i] + 100, "element {} made by thread {}", i,
+        array[i].tid);
+  }
+}
+
+void
+TestCreateBlocked(size_t n) {
+  std::vector<unsigned> owners = DoAllOwners(n);
+
+  // Arrays of different element sizes share one placement
+  katana::LargeArray<uint64_t> wide;
+  katana::LargeArray<uint8_t> narrow;
+  katana::LargeArray<Owner> owned;
+  katana::CreateBlocked(n, &wide, &narrow, &owned);
+  KATANA_LOG_ASSERT(wide.size() == n && narrow.size() == n);
+  KATANA_LOG_ASSERT(owned.size() == n);
+  for (size_t i = 0; i < n; ++i) {
+    KATANA_LOG_ASSERT(wide[i] == 0 && narrow[i] == 0);
+    KATANA_LOG_VASSERT(
+        owned[i].tid == owners[i], "element {} made by thread {}", i,
+        owned[i].tid);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (unsigned threads : {1u, 3u, 4u}) {
+    katana::setActiveThreads(threads);
+    TestConstructParallel(0);
+    TestConstructParallel(10);
+    TestConstructParallel(100003);
+    TestCreateBlocked(5);
+    TestCreateBlocked(3 * katana::allocSize() + 7);
+  }
+
+  return 0;
+}
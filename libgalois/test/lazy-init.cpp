@@ -0,0 +1,134 @@
+#include <atomic>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Uri.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// A backend that cannot be initialized and counts the attempts
+class BrokenStorage : public tsuba::FileStorage {
+public:
+  BrokenStorage() : tsuba::FileStorage("broken://") {}
+
+  int inits{0};
+  int finis{0};
+
+  katana::Result<void> Init() override {
+    ++inits;
+    return KATANA_ERROR(tsuba::ErrorCode::NoCredentials, "no credentials");
+  }
+  katana::Result<void> Fini() override {
+    ++finis;
+    return katana::ResultSuccess();
+  }
+  katana::Result<void> Stat(const std::string&, tsuba::StatBuf*) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+  katana::Result<void> GetMultiSync(
+      const std::string&, uint64_t, uint64_t, uint8_t*) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+  katana::Result<void> PutMultiSync(
+      const std::string&, const uint8_t*, uint64_t) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+  katana::Result<void> RemoteCopy(
+      const std::string&, const std::string&, uint64_t, uint64_t) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+  std::future<katana::Result<void>> PutAsync(
+      const std::string&, const uint8_t*, uint64_t) override {
+    return std::async(std::launch::deferred, []() -> katana::Result<void> {
+      return tsuba::ErrorCode::NotImplemented;
+    });
+  }
+  std::future<katana::Result<void>> GetAsync(
+      const std::string&, uint64_t, uint64_t, uint8_t*) override {
+    return std::async(std::launch::deferred, []() -> katana::Result<void> {
+      return tsuba::ErrorCode::NotImplemented;
+    });
+  }
+  std::future<katana::Result<void>> ListAsync(
+      const std::string&, std::vector<std::string>*,
+      std::vector<uint64_t>*) override {
+    return std::async(std::launch::deferred, []() -> katana::Result<void> {
+      return tsuba::ErrorCode::NotImplemented;
+    });
+  }
+  katana::Result<void> Delete(
+      const std::string&, const std::unordered_set<std::string>&) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+};
+
+void
+TestLazyStorage(BrokenStorage* broken) {
+  // Local files work without the broken backend being initialized
+  auto uri_res = katana::Uri::MakeRand("/tmp/lazyinit");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string file(uri_res.value().path());
+  std::string data("hello");
+  auto res = tsuba::FileStore(file, data.data(), data.size());
+  KATANA_LOG_VASSERT(res, "storing {}: {}", file, res.error());
+  std::string read(data.size(), '\0');
+  res = tsuba::FileGet(file, read.data(), 0, read.size());
+  KATANA_LOG_VASSERT(res, "reading {}: {}", file, res.error());
+  KATANA_LOG_ASSERT(read == data);
+  fs::remove(file);
+  KATANA_LOG_ASSERT(broken->inits == 0);
+
+  // The first use of the broken backend fails, and so do the later ones
+  // without initializing it again
+  tsuba::StatBuf stat;
+  res = tsuba::FileStat("broken://bucket/file", &stat);
+  KATANA_LOG_ASSERT(!res && res.error() == tsuba::ErrorCode::NoCredentials);
+  auto future = tsuba::FileStoreAsync("broken://bucket/file", "x", 1);
+  res = future.get();
+  KATANA_LOG_ASSERT(!res && res.error() == tsuba::ErrorCode::NoCredentials);
+  KATANA_LOG_ASSERT(broken->inits == 1);
+}
+
+void
+TestLazyThreads() {
+  KATANA_LOG_ASSERT(katana::internal::PeekThreadPool() == nullptr);
+  // Setting the threads does not start the pool either
+  unsigned num_threads = katana::setActiveThreads(2);
+  KATANA_LOG_ASSERT(num_threads >= 1);
+  KATANA_LOG_ASSERT(katana::internal::PeekThreadPool() == nullptr);
+
+  std::atomic<int> count{0};
+  katana::do_all(katana::iterate(0, 1000), [&](int) { ++count; });
+  KATANA_LOG_ASSERT(count == 1000);
+  KATANA_LOG_ASSERT(katana::internal::PeekThreadPool() != nullptr);
+}
+
+}  // namespace
+
+int
+main() {
+  BrokenStorage broken;
+  tsuba::RegisterFileStorage(&broken);
+
+  {
+    katana::SharedMemSys sys;
+
+    // Before anything that may run in parallel
+    TestLazyThreads();
+    TestLazyStorage(&broken);
+  }
+  // Only initialized backends are finalized
+  KATANA_LOG_ASSERT(broken.finis == 0);
+
+  return 0;
+}
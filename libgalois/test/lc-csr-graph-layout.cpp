@@ -0,0 +1,166 @@
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "katana/EdgeLayout.h"
+#include "katana/LC_CSR_Graph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+using katana::EdgeLayout;
+
+constexpr uint32_t kNumNodes = 100;
+
+/// Node n has n % 7 edges, so that the edges of some nodes straddle the
+/// blocks of EdgeLayout::kBlocked
+uint64_t
+NumEdges(uint32_t n) {
+  return n % 7;
+}
+
+uint32_t
+Dst(uint32_t n, uint64_t e) {
+  return (n * 31 + e * 17) % kNumNodes;
+}
+
+uint32_t
+Weight(uint32_t n, uint64_t e) {
+  return n * 1000 + e;
+}
+
+template <typename Graph>
+Graph
+MakeGraph() {
+  uint64_t num_edges = 0;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    num_edges += NumEdges(n);
+  }
+  return Graph(kNumNodes, num_edges, NumEdges, Dst, Weight);
+}
+
+template <typename Graph>
+void
+CheckEdges(Graph& g) {
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_ASSERT(
+        uint64_t(std::distance(g.edge_begin(n), g.edge_end(n))) ==
+        NumEdges(n));
+    uint64_t i = 0;
+    for (auto e : g.edges(n)) {
+      KATANA_LOG_VASSERT(
+          g.getEdgeDst(e) == Dst(n, i), "node {} edge {}: dst {}", n, i,
+          g.getEdgeDst(e));
+      KATANA_LOG_VASSERT(
+          g.getEdgeData(e) == Weight(n, i), "node {} edge {}: data {}", n, i,
+          g.getEdgeData(e));
+      ++i;
+    }
+  }
+}
+
+/// Sorting moves the data of an edge with its destination
+template <typename Graph>
+void
+CheckSorted(Graph& g, bool by_dst) {
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    if (by_dst) {
+      g.sortEdgesByDst(n);
+    } else {
+      g.sortEdgesByEdgeData(n, std::greater<uint32_t>());
+    }
+    uint32_t prev_dst = 0;
+    uint32_t prev_data = UINT32_MAX;
+    for (auto e : g.edges(n)) {
+      uint32_t dst = g.getEdgeDst(e);
+      uint32_t data = g.getEdgeData(e);
+      KATANA_LOG_ASSERT(by_dst ? prev_dst <= dst : prev_data >= data);
+      // Weight(n, i) identifies i, whose destination is Dst(n, i)
+      KATANA_LOG_ASSERT(data / 1000 == n);
+      KATANA_LOG_ASSERT(dst == Dst(n, data % 1000));
+      prev_dst = dst;
+      prev_data = data;
+    }
+  }
+}
+
+/// The transpose has edge dst -> n with the data of n -> dst
+template <typename Graph>
+void
+CheckTranspose(Graph& g) {
+  g.transpose();
+  std::vector<uint64_t> in_degree(kNumNodes);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    for (uint64_t i = 0; i < NumEdges(n); ++i) {
+      ++in_degree[Dst(n, i)];
+    }
+  }
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_ASSERT(
+        uint64_t(std::distance(g.edge_begin(n), g.edge_end(n))) ==
+        in_degree[n]);
+    for (auto e : g.edges(n)) {
+      uint32_t src = g.getEdgeDst(e);
+      uint32_t data = g.getEdgeData(e);
+      KATANA_LOG_ASSERT(data / 1000 == src);
+      KATANA_LOG_ASSERT(Dst(src, data % 1000) == n);
+    }
+  }
+}
+
+template <typename Graph>
+void
+CheckConstructFrom() {
+  std::vector<uint64_t> prefix_sum(kNumNodes);
+  std::vector<std::vector<uint32_t>> dsts(kNumNodes);
+  std::vector<std::vector<uint32_t>> data(kNumNodes);
+  uint64_t num_edges = 0;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    for (uint64_t i = 0; i < NumEdges(n); ++i) {
+      dsts[n].emplace_back(Dst(n, i));
+      data[n].emplace_back(Weight(n, i));
+    }
+    num_edges += NumEdges(n);
+    prefix_sum[n] = num_edges;
+  }
+
+  // Construct twice to reuse the allocation of the first graph
+  Graph g = MakeGraph<Graph>();
+  for (int i = 0; i < 2; ++i) {
+    g.constructFrom(kNumNodes, num_edges, prefix_sum, dsts, data);
+    CheckEdges(g);
+  }
+}
+
+template <EdgeLayout Layout>
+void
+TestLayout() {
+  using Graph = typename katana::LC_CSR_Graph<uint32_t, uint32_t>::
+      template with_edge_layout<Layout>::type;
+
+  Graph g = MakeGraph<Graph>();
+  CheckEdges(g);
+
+  CheckSorted(g, false);
+  CheckSorted(g, true);
+
+  Graph transposed = MakeGraph<Graph>();
+  CheckTranspose(transposed);
+
+  CheckConstructFrom<Graph>();
+
+  using NumaGraph = typename Graph::template with_numa_alloc<true>::type;
+  NumaGraph numa = MakeGraph<NumaGraph>();
+  CheckEdges(numa);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestLayout<EdgeLayout::kSoA>();
+  TestLayout<EdgeLayout::kAoS>();
+  TestLayout<EdgeLayout::kBlocked>();
+
+  return 0;
+}
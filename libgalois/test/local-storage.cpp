@@ -0,0 +1,198 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// The size of the chunks that local transfers are split into
+constexpr uint64_t kChunk = UINT64_C(8) << 20;
+
+/// Memory aligned to a block, so that aligned ranges of it can use O_DIRECT
+struct AlignedBuffer {
+  explicit AlignedBuffer(uint64_t size)
+      : data(static_cast<uint8_t*>(std::aligned_alloc(
+            tsuba::kBlockSize, tsuba::RoundUpToBlock(size + 1)))) {
+    KATANA_LOG_ASSERT(data != nullptr);
+  }
+  ~AlignedBuffer() { std::free(data); }
+
+  AlignedBuffer(const AlignedBuffer&) = delete;
+  AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+  uint8_t* data;
+};
+
+void
+Fill(uint8_t* data, uint64_t size, uint8_t seed) {
+  for (uint64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 11 + i / tsuba::kBlockSize + seed);
+  }
+}
+
+/// Check that [begin, begin + size) of file reads as expected, into memory
+/// aligned to a block and into memory that is not
+void
+CheckRead(
+    const std::string& file, const uint8_t* expected, uint64_t begin,
+    uint64_t size) {
+  AlignedBuffer out(size);
+  for (uint64_t offset : {0, 1}) {
+    uint8_t* buf = out.data + offset;
+    std::memset(buf, 0, size);
+    auto res = tsuba::FileGet(file, buf, begin, size);
+    KATANA_LOG_VASSERT(
+        res, "reading {} bytes at {} of {}: {}", size, begin, file,
+        res.error());
+    KATANA_LOG_VASSERT(
+        std::memcmp(buf, expected + begin, size) == 0,
+        "{} bytes at {} of {} read at offset {} differ", size, begin, file,
+        offset);
+  }
+}
+
+/// Files of sizes aligned to a block and not, of several chunks, read back
+/// as written, whole and in ranges aligned to blocks and not
+void
+TestSizes(const std::string& dir) {
+  for (uint64_t size :
+       {UINT64_C(0), tsuba::kBlockSize, 2 * kChunk, 2 * kChunk + 12345,
+        kChunk - 1, 3 * tsuba::kBlockSize + 1}) {
+    std::string file = dir + "/size-" + std::to_string(size);
+    AlignedBuffer data(size);
+    Fill(data.data, size, 1);
+    auto res = tsuba::FileStore(file, data.data, size);
+    KATANA_LOG_VASSERT(res, "storing {}: {}", file, res.error());
+
+    tsuba::StatBuf stat;
+    KATANA_LOG_ASSERT(tsuba::FileStat(file, &stat));
+    KATANA_LOG_VASSERT(
+        stat.size == size, "{} holds {} bytes, not {}", file, stat.size, size);
+
+    CheckRead(file, data.data, 0, size);
+    if (size > 2 * tsuba::kBlockSize) {
+      CheckRead(
+          file, data.data, tsuba::kBlockSize, size - 2 * tsuba::kBlockSize);
+      CheckRead(file, data.data, 7, size - 7);
+      CheckRead(file, data.data, size / 2 + 3, 5);
+    }
+
+    // Writes from memory that is not aligned go through the page cache
+    Fill(data.data + 1, size, 2);
+    res = tsuba::FileStore(file, data.data + 1, size);
+    KATANA_LOG_VASSERT(res, "storing {}: {}", file, res.error());
+    CheckRead(file, data.data + 1, 0, size);
+  }
+
+  // Reads past the end of a file fail
+  std::string file = dir + "/size-" + std::to_string(tsuba::kBlockSize);
+  AlignedBuffer out(4 * tsuba::kBlockSize);
+  KATANA_LOG_ASSERT(!tsuba::FileGet(file, out.data, 0, 4 * tsuba::kBlockSize));
+  KATANA_LOG_ASSERT(!tsuba::FileGet(dir + "/missing", out.data, 0, 1));
+}
+
+/// Many reads of one file run at once, from several threads and as futures
+void
+TestConcurrentReads(const std::string& dir) {
+  constexpr uint64_t kSize = 2 * kChunk + 321;
+  constexpr uint64_t kNumReads = 4;
+  std::string file = dir + "/concurrent";
+  AlignedBuffer data(kSize);
+  Fill(data.data, kSize, 3);
+  KATANA_LOG_ASSERT(tsuba::FileStore(file, data.data, kSize));
+
+  std::vector<std::thread> readers;
+  for (uint64_t r = 0; r < kNumReads; ++r) {
+    readers.emplace_back([&, r]() {
+      uint64_t begin = r * (kSize / kNumReads) + r;
+      CheckRead(file, data.data, begin, kSize - begin);
+    });
+  }
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+
+  AlignedBuffer out(kNumReads * kSize);
+  std::vector<std::future<katana::Result<void>>> futures;
+  for (uint64_t r = 0; r < kNumReads; ++r) {
+    futures.emplace_back(
+        tsuba::FileGetAsync(file, out.data + r * kSize, 0, kSize));
+  }
+  for (uint64_t r = 0; r < kNumReads; ++r) {
+    auto res = futures[r].get();
+    KATANA_LOG_VASSERT(res, "reading {}: {}", file, res.error());
+    KATANA_LOG_ASSERT(
+        std::memcmp(out.data + r * kSize, data.data, kSize) == 0);
+  }
+}
+
+void
+RunTests(const std::string& dir) {
+  katana::SharedMemSys sys;
+
+  TestSizes(dir);
+  TestConcurrentReads(dir);
+
+  // File systems without O_DIRECT, such as older tmpfs, fall back to the
+  // page cache
+  if (fs::is_directory("/dev/shm")) {
+    auto uri_res = katana::Uri::MakeRand("/dev/shm/localstorage");
+    KATANA_LOG_ASSERT(uri_res);
+    std::string shm_dir(uri_res.value().path());
+    fs::create_directories(shm_dir);
+    TestSizes(shm_dir);
+    fs::remove_all(shm_dir);
+  }
+}
+
+}  // namespace
+
+/// Local storage is configured when tsuba starts, so each configuration runs
+/// in its own process
+int
+main() {
+  struct Config {
+    const char* io_threads;
+    const char* direct_io;
+  };
+  for (const Config& config :
+       {Config{"16", "0"}, Config{"4", "1"}, Config{"0", "1"}}) {
+    auto uri_res = katana::Uri::MakeRand("/tmp/localstorage");
+    KATANA_LOG_ASSERT(uri_res);
+    std::string dir(uri_res.value().path());
+    fs::create_directories(dir);
+
+    pid_t pid = fork();
+    KATANA_LOG_ASSERT(pid >= 0);
+    if (pid == 0) {
+      setenv("KATANA_LOCAL_IO_THREADS", config.io_threads, 1);
+      setenv("KATANA_LOCAL_DIRECT_IO", config.direct_io, 1);
+      RunTests(dir);
+      std::exit(0);
+    }
+    int status = 0;
+    KATANA_LOG_ASSERT(waitpid(pid, &status, 0) == pid);
+    KATANA_LOG_VASSERT(
+        WIFEXITED(status) && WEXITSTATUS(status) == 0,
+        "{} threads, direct I/O {}: exited with status {}", config.io_threads,
+        config.direct_io, status);
+
+    fs::remove_all(dir);
+  }
+  return 0;
+}
@@ -0,0 +1,179 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Galois.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/LoopSampler.h"
+#include "katana/Reduction.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Statistics.h"
+#include "katana/Uri.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr uint32_t kItems = 1 << 16;
+const char* kLoop = "SampledLoop";
+
+nlohmann::json
+ReadStats(const std::string& file) {
+  std::ifstream in(file);
+  KATANA_LOG_VASSERT(in.good(), "no stats in {}", file);
+  std::stringstream buf;
+  buf << in.rdbuf();
+  std::string text = buf.str();
+  auto res = katana::JsonParse<nlohmann::json>(text);
+  KATANA_LOG_VASSERT(res, "stats are not JSON: {}", text);
+  return res.value();
+}
+
+/// \returns the sum of series over the counter events named name, and the
+/// number of those events
+std::pair<int64_t, size_t>
+SumCounter(
+    const nlohmann::json& doc, const std::string& name,
+    const std::string& series) {
+  int64_t sum = 0;
+  size_t count = 0;
+  for (const auto& event : doc.at("traceEvents")) {
+    if (event.at("name") != name) {
+      continue;
+    }
+    KATANA_LOG_ASSERT(event.at("ph") == "C");
+    sum += event.at("args").at(series).get<int64_t>();
+    count += 1;
+  }
+  return {sum, count};
+}
+
+/// Run a for_each over a binary tree of kItems items, which starts from the
+/// root and pushes the children of each item it pops, and print the stats
+/// to file
+void
+RunLoop(const std::string& file) {
+  katana::SetStatFile(file);
+
+  katana::GAccumulator<uint32_t> popped;
+  katana::for_each(
+      katana::iterate(uint32_t{0}, uint32_t{1}),
+      [&](uint32_t item, katana::UserContext<uint32_t>& ctx) {
+        popped += 1;
+        for (uint32_t child : {2 * item + 1, 2 * item + 2}) {
+          if (child < kItems) {
+            ctx.push(child);
+          }
+        }
+      },
+      katana::loopname(kLoop));
+  KATANA_LOG_ASSERT(popped.reduce() == kItems);
+
+  katana::PrintStats();
+}
+
+/// With sampling enabled, the loop reports its samples as stats and trace
+/// counters, and its pushes and pops balance at the end
+void
+TestSampled(const std::string& file) {
+  KATANA_LOG_ASSERT(katana::internal::LoopSampleInterval() == 1);
+  KATANA_LOG_ASSERT(katana::LoopSampler<true>("Local").local() != nullptr);
+
+  RunLoop(file);
+  nlohmann::json doc = ReadStats(file);
+
+  const auto& stats = doc.at("stats").at(kLoop);
+  for (const char* stat : {"MaxPending", "IdleSpins", "Samples"}) {
+    KATANA_LOG_VASSERT(stats.contains(stat), "no stat {}", stat);
+  }
+  KATANA_LOG_ASSERT(stats.at("Samples").at("total") >= 1);
+
+  // Rates are per interval, so their sums are the totals of the loop
+  std::string rate = std::string(kLoop) + " rate";
+  auto [pushes, num_rates] = SumCounter(doc, rate, "pushes");
+  auto [pops, num_pops] = SumCounter(doc, rate, "pops");
+  KATANA_LOG_ASSERT(num_rates >= 1 && num_rates == num_pops);
+  KATANA_LOG_VASSERT(pushes == pops, "{} pushes but {} pops", pushes, pops);
+  KATANA_LOG_ASSERT(pops == kItems);
+  KATANA_LOG_ASSERT(
+      SumCounter(doc, std::string(kLoop) + " pending", "items").second ==
+      num_rates);
+}
+
+/// With sampling disabled, loops make no counters and report nothing of it
+void
+TestUnsampled(const std::string& file) {
+  KATANA_LOG_ASSERT(katana::internal::LoopSampleInterval() == 0);
+  KATANA_LOG_ASSERT(katana::LoopSampler<true>("Local").local() == nullptr);
+
+  RunLoop(file);
+  nlohmann::json doc = ReadStats(file);
+
+  const auto& stats = doc.at("stats").at(kLoop);
+  KATANA_LOG_ASSERT(stats.contains("Iterations"));
+  for (const char* stat : {"MaxPending", "IdleSpins", "Samples"}) {
+    KATANA_LOG_VASSERT(!stats.contains(stat), "stat {} is reported", stat);
+  }
+  for (const char* suffix : {" pending", " rate", " idle spins"}) {
+    std::string name = std::string(kLoop) + suffix;
+    for (const auto& event : doc.at("traceEvents")) {
+      KATANA_LOG_VASSERT(event.at("name") != name, "{} is traced", name);
+    }
+  }
+}
+
+/// Run test in a process of its own, since the interval is read once per
+/// process, with KATANA_LOOP_SAMPLE_USEC set to usec or unset if it is null
+void
+RunInProcess(
+    void (*test)(const std::string&), const char* usec,
+    const std::string& file) {
+  pid_t pid = fork();
+  KATANA_LOG_ASSERT(pid >= 0);
+  if (pid == 0) {
+    if (usec) {
+      setenv("KATANA_LOOP_SAMPLE_USEC", usec, 1);
+    } else {
+      unsetenv("KATANA_LOOP_SAMPLE_USEC");
+    }
+    // The format is chosen when the statistics manager is made
+    setenv("KATANA_STAT_FORMAT", "json", 1);
+    {
+      katana::SharedMemSys sys;
+      katana::setActiveThreads(4);
+
+      test(file);
+    }
+    _exit(0);
+  }
+
+  int status = 0;
+  KATANA_LOG_ASSERT(waitpid(pid, &status, 0) == pid);
+  KATANA_LOG_VASSERT(
+      WIFEXITED(status) && WEXITSTATUS(status) == 0,
+      "test process exited with status {}", status);
+}
+
+}  // namespace
+
+int
+main() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/loopsampler");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());
+  fs::create_directories(dir);
+
+  RunInProcess(TestSampled, "1", dir + "/sampled.json");
+  RunInProcess(TestUnsampled, nullptr, dir + "/unsampled.json");
+
+  fs::remove_all(dir);
+  return 0;
+}
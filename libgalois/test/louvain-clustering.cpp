@@ -0,0 +1,163 @@
+#include <set>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/analytics/louvain_clustering/louvain_clustering.h"
+
+using katana::analytics::LouvainClusteringPlan;
+using katana::analytics::LouvainClusteringStatistics;
+
+namespace {
+
+constexpr uint32_t kNumCliques = 8;
+constexpr uint32_t kCliqueSize = 16;
+constexpr uint32_t kNumNodes = kNumCliques * kCliqueSize;
+
+/// A ring of cliques, each joined to the next by one symmetric edge, with
+/// unit edge weights
+std::unique_ptr<katana::PropertyGraph>
+MakeRingOfCliques() {
+  std::vector<std::set<uint32_t>> neighbors(kNumNodes);
+  for (uint32_t c = 0; c < kNumCliques; ++c) {
+    uint32_t first = c * kCliqueSize;
+    for (uint32_t i = first; i < first + kCliqueSize; ++i) {
+      for (uint32_t j = first; j < first + kCliqueSize; ++j) {
+        if (i != j) {
+          neighbors[i].emplace(j);
+        }
+      }
+    }
+    uint32_t next = (c + 1) % kNumCliques * kCliqueSize + 1;
+    neighbors[first].emplace(next);
+    neighbors[next].emplace(first);
+  }
+
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (const auto& n : neighbors) {
+    dests.insert(dests.end(), n.begin(), n.end());
+    indices.push_back(dests.size());
+  }
+
+  auto pg = std::make_unique<katana::PropertyGraph>();
+  auto res = pg->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(res);
+
+  std::vector<uint32_t> weights(dests.size(), 1);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)});
+  auto add_res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(add_res, "adding weights: {}", add_res.error());
+  return pg;
+}
+
+/// Check that the clusters in property name are exactly the cliques
+void
+CheckCliques(katana::PropertyGraph* pg, const std::string& name) {
+  auto res =
+      katana::analytics::LouvainClusteringAssertValid(pg, "weight", name);
+  KATANA_LOG_VASSERT(res, "{} is not valid: {}", name, res.error());
+
+  std::vector<uint64_t> clusters = NodePropertyValues<uint64_t>(pg, name);
+  std::set<uint64_t> distinct;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    uint64_t expected = clusters[n / kCliqueSize * kCliqueSize];
+    KATANA_LOG_VASSERT(
+        clusters[n] == expected, "{}: node {} is in cluster {}, not {}", name,
+        n, clusters[n], expected);
+    distinct.emplace(clusters[n]);
+  }
+  KATANA_LOG_VASSERT(
+      distinct.size() == kNumCliques, "{} has {} clusters", name,
+      distinct.size());
+
+  auto stats_res = LouvainClusteringStatistics::Compute(pg, "weight", name);
+  KATANA_LOG_ASSERT(stats_res);
+  KATANA_LOG_ASSERT(stats_res.value().n_clusters == kNumCliques);
+  KATANA_LOG_ASSERT(stats_res.value().largest_cluster_size == kCliqueSize);
+}
+
+/// Louvain coarsens the graph at each level, down to min_graph_size nodes,
+/// and finds the cliques with any plan. The deterministic plan gives the
+/// same clusters on every run.
+void
+TestClustering() {
+  auto pg = MakeRingOfCliques();
+  constexpr uint32_t kMinGraphSize = 2;
+
+  for (bool enable_vf : {false, true}) {
+    std::string suffix = enable_vf ? "-vf" : "";
+    auto deterministic = LouvainClusteringPlan::Deterministic(
+        enable_vf, LouvainClusteringPlan::kDefaultModularityThresholdPerRound,
+        LouvainClusteringPlan::kDefaultModularityThresholdTotal,
+        LouvainClusteringPlan::kDefaultMaxIterations, kMinGraphSize);
+    for (const std::string& name : {"first", "second"}) {
+      auto res = katana::analytics::LouvainClustering(
+          pg.get(), "weight", name + suffix, deterministic);
+      KATANA_LOG_VASSERT(res, "clustering failed: {}", res.error());
+      CheckCliques(pg.get(), name + suffix);
+    }
+    KATANA_LOG_ASSERT(
+        NodePropertyValues<uint64_t>(pg.get(), "first" + suffix) ==
+        NodePropertyValues<uint64_t>(pg.get(), "second" + suffix));
+
+    auto do_all = LouvainClusteringPlan::DoAll(
+        enable_vf, LouvainClusteringPlan::kDefaultModularityThresholdPerRound,
+        LouvainClusteringPlan::kDefaultModularityThresholdTotal,
+        LouvainClusteringPlan::kDefaultMaxIterations, kMinGraphSize);
+    auto res = katana::analytics::LouvainClustering(
+        pg.get(), "weight", "do-all" + suffix, do_all);
+    KATANA_LOG_VASSERT(res, "clustering failed: {}", res.error());
+    CheckCliques(pg.get(), "do-all" + suffix);
+  }
+}
+
+/// Seeded clustering coarsens the input by its seeds before the first level
+void
+TestFromSeed() {
+  auto pg = MakeRingOfCliques();
+
+  // Seed each half of each clique as its own cluster
+  std::vector<uint64_t> seeds(kNumNodes);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    seeds[n] = n / (kCliqueSize / 2) * (kCliqueSize / 2);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("seed", arrow::uint64())}),
+      {katana::BuildArray(seeds)});
+  auto add_res = pg->AddNodeProperties(table);
+  KATANA_LOG_VASSERT(add_res, "adding seeds: {}", add_res.error());
+
+  auto res = katana::analytics::LouvainClusteringFromSeed(
+      pg.get(), "weight", "seed", "seeded",
+      LouvainClusteringPlan::Deterministic());
+  KATANA_LOG_VASSERT(res, "seeded clustering failed: {}", res.error());
+  CheckCliques(pg.get(), "seeded");
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestClustering();
+  TestFromSeed();
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <atomic>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/LowLatency.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/bfs/bfs.h"
+
+namespace {
+
+/// \returns true if every iteration of a do_all over num items ran on
+/// the calling thread
+bool
+DoAllOnCaller(uint32_t num) {
+  std::atomic<uint32_t> iterations{0};
+  std::atomic<bool> elsewhere{false};
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num),
+      [&](uint32_t) {
+        iterations += 1;
+        if (katana::ThreadPool::getTID() != 0) {
+          elsewhere = true;
+        }
+      },
+      katana::loopname("LowLatencyDoAll"));
+  KATANA_LOG_ASSERT(iterations == num);
+  return !elsewhere;
+}
+
+void
+TestLoops() {
+  constexpr uint32_t kSmall = 100;
+  constexpr uint32_t kLarge = 1 << 20;
+  katana::ThreadPool& pool = katana::GetThreadPool();
+  uint64_t spin_usec = pool.getSpinBudget();
+
+  katana::LowLatencyOptions options;
+  options.serial_threshold = 1000;
+  options.spin_usec = spin_usec + 500;
+  katana::EnableLowLatency(options);
+  KATANA_LOG_ASSERT(katana::IsLowLatency());
+  KATANA_LOG_ASSERT(pool.getSpinBudget() == spin_usec + 500);
+
+  KATANA_LOG_ASSERT(DoAllOnCaller(kSmall));
+  DoAllOnCaller(kLarge);
+  {
+    katana::LowLatencyRegion region(kSmall);
+    KATANA_LOG_ASSERT(region.serial());
+    KATANA_LOG_ASSERT(DoAllOnCaller(kLarge));
+
+    // Pushed items are processed too
+    std::atomic<uint32_t> processed{0};
+    katana::for_each(
+        katana::iterate({0u}),
+        [&](uint32_t n, auto& ctx) {
+          processed += 1;
+          KATANA_LOG_ASSERT(katana::ThreadPool::getTID() == 0);
+          if (n < kSmall) {
+            ctx.push(n + 1);
+          }
+        },
+        katana::loopname("LowLatencyForEach"));
+    KATANA_LOG_ASSERT(processed == kSmall + 1);
+  }
+  {
+    katana::LowLatencyRegion region(kLarge);
+    KATANA_LOG_ASSERT(!region.serial());
+  }
+
+  katana::DisableLowLatency();
+  KATANA_LOG_ASSERT(!katana::IsLowLatency());
+  KATANA_LOG_ASSERT(pool.getSpinBudget() == spin_usec);
+  katana::LowLatencyRegion region(kSmall);
+  KATANA_LOG_ASSERT(!region.serial());
+
+  options.burn_power = true;
+  katana::EnableLowLatency(options);
+  KATANA_LOG_ASSERT(DoAllOnCaller(kSmall));
+  DoAllOnCaller(kLarge);
+  katana::DisableLowLatency();
+}
+
+void
+TestBfs() {
+  RandomPolicy policy{4};
+  auto pg = MakeFileGraph<uint32_t>(2000, 0, &policy);
+  auto plan = katana::analytics::BfsPlan::Asynchronous();
+
+  auto res = katana::analytics::Bfs(pg.get(), 0, "expected", plan);
+  KATANA_LOG_VASSERT(res, "Bfs failed: {}", res.error());
+  katana::EnableLowLatency();
+  res = katana::analytics::Bfs(pg.get(), 0, "serial", plan);
+  KATANA_LOG_VASSERT(res, "Bfs failed: {}", res.error());
+  res = katana::analytics::Bfs(
+      pg.get(), 0, "synchronous", katana::analytics::BfsPlan::Synchronous());
+  KATANA_LOG_VASSERT(res, "Bfs failed: {}", res.error());
+  katana::DisableLowLatency();
+
+  KATANA_LOG_ASSERT(katana::analytics::BfsAssertValid(pg.get(), "serial"));
+  std::vector<uint32_t> expected =
+      NodePropertyValues<uint32_t>(pg.get(), "expected");
+  KATANA_LOG_ASSERT(
+      NodePropertyValues<uint32_t>(pg.get(), "serial") == expected);
+  KATANA_LOG_ASSERT(
+      NodePropertyValues<uint32_t>(pg.get(), "synchronous") == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestLoops();
+  TestBfs();
+
+  return 0;
+}
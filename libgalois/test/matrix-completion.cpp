@@ -0,0 +1,123 @@
+#include <cmath>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/matrix_completion/matrix_completion.h"
+
+using DataType = int64_t;
+using katana::analytics::MatrixCompletionPlan;
+using katana::analytics::MatrixCompletionStatistics;
+
+/// Every item rates width random users, which follow the items
+class BipartitePolicy : public Policy {
+  size_t num_items_{};
+  size_t width_{};
+
+public:
+  BipartitePolicy(size_t num_items, size_t width)
+      : num_items_(num_items), width_(width) {}
+
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    if (node_id >= num_items_) {
+      return r;
+    }
+    auto& gen = katana::GetGenerator();
+    std::uniform_int_distribution<size_t> dist(num_items_, num_nodes - 1);
+    for (size_t i = 0; i < width_; ++i) {
+      r.emplace_back(dist(gen));
+    }
+    return r;
+  }
+};
+
+/// Add the edge property "rating" from a planted rank one model, so that the
+/// ratings can be fit exactly
+void
+AddRatings(katana::PropertyGraph* pg) {
+  const katana::GraphTopology& topology = pg->topology();
+  auto& gen = katana::GetGenerator();
+  std::uniform_real_distribution<float> dist(1, 2);
+  std::vector<float> factors(topology.num_nodes());
+  for (auto& f : factors) {
+    f = dist(gen);
+  }
+  std::vector<float> ratings(topology.num_edges());
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    for (auto e : topology.edges(n)) {
+      ratings[e] = factors[n] * factors[topology.edge_dest(e)];
+    }
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("rating", arrow::float32())}),
+      {katana::BuildArray(ratings)});
+  auto res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add ratings: {}", res.error());
+}
+
+void
+TestFactors(MatrixCompletionPlan plan, bool sorted) {
+  size_t num_items = 100;
+  BipartitePolicy policy{num_items, 10};
+  auto pg = MakeFileGraph<DataType>(num_items + 300, 0, &policy);
+  AddRatings(pg.get());
+  if (sorted) {
+    // Sorting reorders the edges, so the ratings are drawn again
+    auto permutation = katana::SortAllEdgesByDest(pg.get());
+    KATANA_LOG_VASSERT(permutation, "sort failed: {}", permutation.error());
+    auto remove_res = pg->RemoveEdgeProperty("rating");
+    KATANA_LOG_VASSERT(remove_res, "remove failed: {}", remove_res.error());
+    AddRatings(pg.get());
+  }
+
+  auto res = katana::analytics::MatrixCompletion(
+      pg.get(), "rating", "latent", plan);
+  KATANA_LOG_VASSERT(res, "matrix completion failed: {}", res.error());
+
+  auto valid_res =
+      katana::analytics::MatrixCompletionAssertValid(pg.get(), "latent");
+  KATANA_LOG_VASSERT(valid_res, "invalid factors: {}", valid_res.error());
+
+  auto stats_res =
+      MatrixCompletionStatistics::Compute(pg.get(), "rating", "latent");
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  MatrixCompletionStatistics stats = stats_res.value();
+  KATANA_LOG_ASSERT(stats.n_items == num_items);
+  KATANA_LOG_ASSERT(stats.n_users == 300);
+  // The ratings are in [1, 4], so predicting 0 has an error above 1
+  KATANA_LOG_VASSERT(stats.rmse < 0.5, "rmse is {}", stats.rmse);
+
+  auto latent = pg->GetNodeProperty("latent");
+  KATANA_LOG_ASSERT(
+      latent->type()->Equals(arrow::fixed_size_list(
+          arrow::float32(), plan.latent_vector_size())));
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (bool sorted : {false, true}) {
+    TestFactors(
+        MatrixCompletionPlan::StochasticGradientDescent(
+            8, MatrixCompletionPlan::kDefaultLearningRate, 0.001, 0.0001, 200,
+            16, 32),
+        sorted);
+    TestFactors(
+        MatrixCompletionPlan::AlternatingLeastSquares(5, 0.01, 0.0001, 20),
+        sorted);
+  }
+
+  // Edges between items are not ratings
+  LinePolicy line{2};
+  auto pg = MakeFileGraph<DataType>(10, 0, &line);
+  AddRatings(pg.get());
+  auto res = katana::analytics::MatrixCompletion(pg.get(), "rating", "latent");
+  KATANA_LOG_ASSERT(!res);
+
+  return 0;
+}
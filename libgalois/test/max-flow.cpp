@@ -0,0 +1,108 @@
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/max_flow/max_flow.h"
+
+using DataType = int64_t;
+using katana::analytics::MaxFlowPlan;
+using katana::analytics::MaxFlowStatistics;
+
+/// Add the edge property "capacity" with random capacities in [min, max]
+template <typename Capacity>
+void
+AddCapacities(katana::PropertyGraph* pg, Capacity min, Capacity max) {
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<int64_t> dist(min, max);
+  std::vector<Capacity> capacities(pg->topology().num_edges());
+  for (auto& c : capacities) {
+    c = dist(gen);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(
+          "capacity", arrow::CTypeTraits<Capacity>::type_singleton())}),
+      {katana::BuildArray(capacities)});
+  auto res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add capacities: {}", res.error());
+}
+
+/// Compute a maximum flow from source to sink and check it, returning its
+/// value
+template <typename Capacity>
+int64_t
+TestFlow(
+    Policy* policy, size_t num_nodes, uint32_t source, uint32_t sink,
+    Capacity min, Capacity max, MaxFlowPlan plan = {}) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  AddCapacities<Capacity>(pg.get(), min, max);
+
+  auto res = katana::analytics::MaxFlow(
+      pg.get(), source, sink, "capacity", "flow", plan);
+  KATANA_LOG_VASSERT(res, "max flow failed: {}", res.error());
+
+  auto valid_res = katana::analytics::MaxFlowAssertValid(
+      pg.get(), source, sink, "capacity", "flow");
+  KATANA_LOG_VASSERT(valid_res, "invalid flow: {}", valid_res.error());
+
+  auto stats_res =
+      MaxFlowStatistics::Compute(pg.get(), source, "capacity", "flow");
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+
+  // The output property may not exist before the call
+  res = katana::analytics::MaxFlow(pg.get(), source, sink, "capacity", "flow");
+  KATANA_LOG_ASSERT(!res);
+
+  return stats_res.value().flow_value;
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // With equal capacities, the cheapest cut of a cycle with chords to the
+  // next width nodes is around the source
+  for (size_t width : {1, 2, 3}) {
+    LinePolicy line{width};
+    for (auto plan :
+         {MaxFlowPlan::PushRelabel(), MaxFlowPlan::PushRelabel(1),
+          MaxFlowPlan::PushRelabel(1000000000)}) {
+      int64_t value = TestFlow<uint32_t>(&line, 200, 0, 100, 5, 5, plan);
+      KATANA_LOG_VASSERT(
+          value == static_cast<int64_t>(5 * width), "flow is {}, not {}",
+          value, 5 * width);
+    }
+  }
+
+  for (size_t width : {1, 2, 4, 8}) {
+    RandomPolicy random{width};
+    TestFlow<uint32_t>(&random, 500, 0, 499, 0, 3);
+    TestFlow<int64_t>(&random, 500, 7, 3, 0, 1000);
+    TestFlow<int32_t>(
+        &random, 500, 1, 2, 0, 100, MaxFlowPlan::PushRelabel(1));
+  }
+
+  // No flow passes edges without capacity
+  LinePolicy line{1};
+  int64_t value = TestFlow<uint64_t>(&line, 50, 10, 5, 0, 0);
+  KATANA_LOG_ASSERT(value == 0);
+
+  auto pg = MakeFileGraph<DataType>(10, 0, &line);
+  // The capacities must exist
+  auto res = katana::analytics::MaxFlow(pg.get(), 0, 5, "capacity", "flow");
+  KATANA_LOG_ASSERT(!res);
+
+  // Capacities may not be negative
+  AddCapacities<int32_t>(pg.get(), -2, -1);
+  res = katana::analytics::MaxFlow(pg.get(), 0, 5, "capacity", "flow");
+  KATANA_LOG_ASSERT(!res);
+
+  // The source and sink must be distinct nodes of the graph
+  res = katana::analytics::MaxFlow(pg.get(), 3, 3, "capacity", "flow");
+  KATANA_LOG_ASSERT(!res);
+  res = katana::analytics::MaxFlow(pg.get(), 0, 10, "capacity", "flow");
+  KATANA_LOG_ASSERT(!res);
+
+  return 0;
+}
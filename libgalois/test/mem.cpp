@@ -19,6 +19,10 @@
 
 #include "katana/Mem.h"
 
+#include <chrono>
+#include <cstring>
+#include <vector>
+
 #include "katana/Galois.h"
 #include "katana/gIO.h"
 
@@ -70,5 +74,27 @@ main() {
     KATANA_LOG_ASSERT(allocated);
   }
 
+  // Pages released to the OS are reused, zeroed, before new ones are mapped
+  std::vector<char*> pages;
+  for (int i = 0; i < 4; ++i) {
+    char* page = static_cast<char*>(pagePoolAlloc());
+    std::memset(page, 1, allocSize());
+    pages.push_back(page);
+  }
+  int total = numPagePoolAllocTotal();
+  for (char* page : pages) {
+    pagePoolFree(page);
+  }
+  size_t released = pagePoolReleaseIdle(std::chrono::milliseconds(0));
+  for (char*& page : pages) {
+    page = static_cast<char*>(pagePoolAlloc());
+    // The OS may not release huge pages
+    KATANA_LOG_ASSERT(released < 4 || page[allocSize() - 1] == 0);
+  }
+  KATANA_LOG_ASSERT(numPagePoolAllocTotal() == total);
+  for (char* page : pages) {
+    pagePoolFree(page);
+  }
+
   return 0;
 }
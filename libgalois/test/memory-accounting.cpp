@@ -0,0 +1,80 @@
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/MemoryAccounting.h"
+#include "katana/PageAlloc.h"
+#include "katana/PagePool.h"
+#include "katana/SharedMemSys.h"
+
+int64_t
+Current(katana::MemoryCategory category) {
+  return katana::GetMemoryUsage(category).current;
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  using katana::MemoryCategory;
+  constexpr size_t kSize = 1 << 20;
+
+  // LargeArrays count towards the category of their scope until freed
+  int64_t analytics = Current(MemoryCategory::kAnalytics);
+  int64_t io = Current(MemoryCategory::kIO);
+  {
+    katana::LargeArray<uint64_t> array;
+    array.allocateBlocked(kSize);
+    KATANA_LOG_ASSERT(
+        Current(MemoryCategory::kAnalytics) >=
+        analytics + int64_t{kSize * sizeof(uint64_t)});
+
+    katana::LargeArray<uint64_t> read;
+    {
+      katana::MemoryCategoryScope scope(MemoryCategory::kIO);
+      read.allocateLocal(kSize);
+    }
+    KATANA_LOG_ASSERT(
+        katana::CurrentMemoryCategory() == MemoryCategory::kAnalytics);
+
+    // Moving an array keeps its category
+    katana::LargeArray<uint64_t> moved(std::move(read));
+    KATANA_LOG_ASSERT(
+        Current(MemoryCategory::kIO) >= io + int64_t{kSize * sizeof(uint64_t)});
+  }
+  KATANA_LOG_ASSERT(Current(MemoryCategory::kAnalytics) == analytics);
+  KATANA_LOG_ASSERT(Current(MemoryCategory::kIO) == io);
+  KATANA_LOG_ASSERT(
+      katana::GetMemoryUsage(MemoryCategory::kAnalytics).peak >=
+      analytics + int64_t{kSize * sizeof(uint64_t)});
+
+  // Resetting drops the peak to what is allocated now
+  katana::ResetMemoryPeaks();
+  KATANA_LOG_ASSERT(
+      katana::GetMemoryUsage(MemoryCategory::kAnalytics).peak == analytics);
+
+  // Pages of the page pool count while handed out
+  int64_t worklist = Current(MemoryCategory::kWorklist);
+  void* page = katana::pagePoolAlloc();
+  KATANA_LOG_ASSERT(
+      Current(MemoryCategory::kWorklist) ==
+      worklist + int64_t(katana::allocSize()));
+  katana::pagePoolFree(page);
+  KATANA_LOG_ASSERT(Current(MemoryCategory::kWorklist) == worklist);
+
+  // Named loops report their peaks
+  std::vector<int> initial(kSize);
+  katana::for_each(
+      katana::iterate(initial.begin(), initial.end()),
+      [&](int item, auto& ctx) {
+        if (item < 2) {
+          ctx.push(item + 1);
+        }
+      },
+      katana::loopname("PushMore"), katana::disable_conflict_detection());
+  katana::ReportMemoryUsage("MemoryAccounting");
+
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include <numeric>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+using DataType = int64_t;
+using katana::analytics::MinimumSpanningForestStatistics;
+
+/// Add the edge property "weight" with random weights in [min, max]
+template <typename Weight>
+void
+AddWeights(katana::PropertyGraph* pg, Weight min, Weight max) {
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<int64_t> dist(min, max);
+  std::vector<Weight> weights(pg->topology().num_edges());
+  for (auto& w : weights) {
+    w = dist(gen);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(
+          "weight", arrow::CTypeTraits<Weight>::type_singleton())}),
+      {katana::BuildArray(weights)});
+  auto res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add weights: {}", res.error());
+}
+
+/// \returns the number of connected components of pg, ignoring edge
+/// directions
+uint64_t
+CountComponents(katana::PropertyGraph* pg) {
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<uint32_t> parent(topology.num_nodes());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&](uint32_t n) {
+    while (parent[n] != n) {
+      n = parent[n] = parent[parent[n]];
+    }
+    return n;
+  };
+  uint64_t components = topology.num_nodes();
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    for (auto e : topology.edges(n)) {
+      uint32_t src = find(n);
+      uint32_t dst = find(topology.edge_dest(e));
+      if (src != dst) {
+        parent[src] = dst;
+        --components;
+      }
+    }
+  }
+  return components;
+}
+
+template <typename Weight>
+void
+TestForest(Policy* policy, size_t num_nodes, Weight max) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  AddWeights<Weight>(pg.get(), 0, max);
+
+  auto res =
+      katana::analytics::MinimumSpanningForest(pg.get(), "weight", "forest");
+  KATANA_LOG_VASSERT(res, "minimum spanning forest failed: {}", res.error());
+
+  auto valid_res = katana::analytics::MinimumSpanningForestAssertValid(
+      pg.get(), "weight", "forest");
+  KATANA_LOG_VASSERT(valid_res, "invalid forest: {}", valid_res.error());
+
+  auto stats_res = MinimumSpanningForestStatistics::Compute(
+      pg.get(), "weight", "forest");
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  uint64_t components = CountComponents(pg.get());
+  KATANA_LOG_VASSERT(
+      stats_res.value().n_trees == components, "found {} trees, not {}",
+      stats_res.value().n_trees, components);
+
+  // The output property may not exist before the call
+  res = katana::analytics::MinimumSpanningForest(pg.get(), "weight", "forest");
+  KATANA_LOG_ASSERT(!res);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy cycle{1};
+  TestForest<uint32_t>(&cycle, 50, 9);
+
+  for (size_t width : {1, 2, 4, 8}) {
+    RandomPolicy random{width};
+    // Few distinct weights make ties common
+    TestForest<uint32_t>(&random, 500, 2);
+    TestForest<int64_t>(&random, 500, 1000);
+    TestForest<double>(&random, 500, 100);
+  }
+
+  // The weights must exist
+  LinePolicy line{2};
+  auto pg = MakeFileGraph<DataType>(10, 0, &line);
+  auto res =
+      katana::analytics::MinimumSpanningForest(pg.get(), "weight", "forest");
+  KATANA_LOG_ASSERT(!res);
+
+  return 0;
+}
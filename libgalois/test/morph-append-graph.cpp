@@ -0,0 +1,157 @@
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Morph_Append_Graph.h"
+#include "katana/Reduction.h"
+#include "katana/SharedMemSys.h"
+
+using Graph = katana::Morph_Append_Graph<uint32_t, uint32_t>;
+using VoidGraph = katana::Morph_Append_Graph<uint32_t, void, true>;
+
+constexpr uint32_t kNumNodes = 64;
+constexpr uint32_t kEdgesPerNode = 50;
+/// Every node also adds kHubEdges edges to node 0, concurrently
+constexpr uint32_t kHubEdges = 200;
+
+/// The data of edge i of src, unique across the graph
+uint32_t
+EdgeId(uint32_t src, uint32_t i) {
+  return src * 1000 + i;
+}
+
+/// Checks that n has exactly the edges whose ids are in ids, once each
+template <typename G>
+void
+CheckEdges(G& g, typename G::GraphNode n, const std::vector<uint32_t>& ids) {
+  std::vector<uint32_t> seen(kNumNodes * 1000);
+  uint64_t num_edges = 0;
+  for (auto e : g.edges(n)) {
+    ++seen[g.getEdgeData(e)];
+    ++num_edges;
+  }
+  KATANA_LOG_VASSERT(
+      num_edges == ids.size(), "node {} has {} edges, expected {}",
+      g.getData(n), num_edges, ids.size());
+  for (uint32_t id : ids) {
+    KATANA_LOG_VASSERT(seen[id] == 1, "edge {} seen {} times", id, seen[id]);
+  }
+}
+
+void
+TestConcurrentAppend() {
+  Graph g;
+  std::vector<Graph::GraphNode> nodes(kNumNodes);
+  katana::do_all(katana::iterate(uint32_t{0}, kNumNodes), [&](uint32_t i) {
+    nodes[i] = g.createNode(i == 0 ? 0 : 1, i);
+  });
+
+  // All threads append to node 0, whose initial block is minimal
+  katana::do_all(
+      katana::iterate(uint32_t{0}, kNumNodes * kHubEdges), [&](uint32_t k) {
+        uint32_t src = k % kNumNodes;
+        uint32_t i = k / kNumNodes;
+        g.addMultiEdge(nodes[0], nodes[src], EdgeId(src, i));
+        if (src != 0 && i < kEdgesPerNode) {
+          g.addMultiEdge(
+              nodes[src], nodes[(src + i) % kNumNodes],
+              EdgeId(src, kHubEdges + i));
+        }
+      });
+
+  std::vector<uint32_t> hub_ids;
+  for (uint32_t src = 0; src < kNumNodes; ++src) {
+    for (uint32_t i = 0; i < kHubEdges; ++i) {
+      hub_ids.emplace_back(EdgeId(src, i));
+    }
+  }
+  CheckEdges(g, nodes[0], hub_ids);
+  for (uint32_t src = 1; src < kNumNodes; ++src) {
+    std::vector<uint32_t> ids;
+    for (uint32_t i = 0; i < kEdgesPerNode; ++i) {
+      ids.emplace_back(EdgeId(src, kHubEdges + i));
+      auto e = g.findEdge(nodes[src], nodes[(src + i) % kNumNodes]);
+      KATANA_LOG_ASSERT(e != g.edge_end(nodes[src]));
+      KATANA_LOG_ASSERT(g.getEdgeDst(e) == nodes[(src + i) % kNumNodes]);
+    }
+    CheckEdges(g, nodes[src], ids);
+  }
+
+  // Remove, in parallel, the hub edges with odd ids; a second removal of an
+  // edge fails
+  katana::GAccumulator<uint64_t> removed;
+  katana::do_all(katana::iterate(uint32_t{0}, uint32_t{2}), [&](uint32_t) {
+    for (auto e : g.edges(nodes[0])) {
+      if (g.getEdgeData(e) % 2 && g.removeEdge(nodes[0], e)) {
+        removed += 1;
+      }
+    }
+  });
+  KATANA_LOG_ASSERT(removed.reduce() == hub_ids.size() / 2);
+
+  std::vector<uint32_t> even_ids;
+  for (uint32_t id : hub_ids) {
+    if (id % 2 == 0) {
+      even_ids.emplace_back(id);
+    }
+  }
+  CheckEdges(g, nodes[0], even_ids);
+
+  g.compactEdges();
+  CheckEdges(g, nodes[0], even_ids);
+
+  // Adding after compaction grows the compacted block
+  for (uint32_t i = 0; i < kHubEdges; ++i) {
+    g.addMultiEdge(nodes[0], nodes[1], EdgeId(kNumNodes - 1, 500 + i));
+    even_ids.emplace_back(EdgeId(kNumNodes - 1, 500 + i));
+  }
+  CheckEdges(g, nodes[0], even_ids);
+  g.compactEdges();
+  CheckEdges(g, nodes[0], even_ids);
+}
+
+void
+TestVoidEdges() {
+  VoidGraph g;
+  std::vector<VoidGraph::GraphNode> nodes(kNumNodes);
+  for (uint32_t i = 0; i < kNumNodes; ++i) {
+    nodes[i] = g.createNode(0, i);
+  }
+  katana::do_all(
+      katana::iterate(uint32_t{0}, kNumNodes * kNumNodes), [&](uint32_t k) {
+        g.addMultiEdge(nodes[k / kNumNodes], nodes[k % kNumNodes]);
+      });
+
+  katana::do_all(katana::iterate(g), [&](VoidGraph::GraphNode n) {
+    for (auto e : g.edges(n)) {
+      if (g.getData(g.getEdgeDst(e)) % 3 == 0) {
+        g.removeEdge(n, e);
+      }
+    }
+  });
+  g.compactEdges();
+
+  for (uint32_t i = 0; i < kNumNodes; ++i) {
+    std::vector<uint32_t> seen(kNumNodes);
+    for (auto e : g.edges(nodes[i])) {
+      ++seen[g.getData(g.getEdgeDst(e))];
+    }
+    for (uint32_t j = 0; j < kNumNodes; ++j) {
+      KATANA_LOG_ASSERT(seen[j] == (j % 3 == 0 ? 0U : 1U));
+    }
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    TestConcurrentAppend();
+    TestVoidEdges();
+  }
+
+  return 0;
+}
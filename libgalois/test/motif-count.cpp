@@ -0,0 +1,269 @@
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/motif_count/motif_count.h"
+
+using DataType = int64_t;
+using katana::analytics::MotifCountPlan;
+using katana::analytics::TriadCensus;
+
+using Matrix = std::vector<std::vector<bool>>;
+
+/// Generates the neighbors of each node from an adjacency matrix
+class MatrixPolicy : public Policy {
+  const Matrix& adjacent_;
+
+public:
+  MatrixPolicy(const Matrix& adjacent) : adjacent_(adjacent) {}
+
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    for (size_t i = 0; i < num_nodes; ++i) {
+      if (adjacent_[node_id][i]) {
+        r.emplace_back(i);
+      }
+    }
+    return r;
+  }
+};
+
+/// \returns a random symmetric adjacency matrix without self loops
+Matrix
+RandomSymmetricMatrix(size_t num_nodes, double density) {
+  auto& gen = katana::GetGenerator();
+  std::bernoulli_distribution edge(density);
+  Matrix adjacent(num_nodes, std::vector<bool>(num_nodes));
+  for (size_t a = 0; a < num_nodes; ++a) {
+    for (size_t b = a + 1; b < num_nodes; ++b) {
+      adjacent[a][b] = adjacent[b][a] = edge(gen);
+    }
+  }
+  return adjacent;
+}
+
+struct ExpectedMotifs {
+  std::vector<uint64_t> triangles;
+  std::vector<uint64_t> four_cycles;
+  std::vector<uint64_t> four_cliques;
+};
+
+/// Count the motifs of each node by checking every triple and quadruple
+ExpectedMotifs
+CountMotifs(const Matrix& adj) {
+  size_t n = adj.size();
+  ExpectedMotifs expected{
+      std::vector<uint64_t>(n), std::vector<uint64_t>(n),
+      std::vector<uint64_t>(n)};
+  for (size_t a = 0; a < n; ++a) {
+    for (size_t b = a + 1; b < n; ++b) {
+      for (size_t c = b + 1; c < n; ++c) {
+        if (adj[a][b] && adj[b][c] && adj[a][c]) {
+          for (size_t x : {a, b, c}) {
+            ++expected.triangles[x];
+          }
+        }
+        for (size_t d = c + 1; d < n; ++d) {
+          // The three ways to close a - b - c - d into a cycle
+          uint64_t cycles =
+              (adj[a][b] && adj[b][c] && adj[c][d] && adj[d][a]) +
+              (adj[a][b] && adj[b][d] && adj[d][c] && adj[c][a]) +
+              (adj[a][c] && adj[c][b] && adj[b][d] && adj[d][a]);
+          bool clique = adj[a][b] && adj[a][c] && adj[a][d] && adj[b][c] &&
+                        adj[b][d] && adj[c][d];
+          for (size_t x : {a, b, c, d}) {
+            expected.four_cycles[x] += cycles;
+            expected.four_cliques[x] += clique;
+          }
+        }
+      }
+    }
+  }
+  return expected;
+}
+
+void
+CheckCounts(
+    katana::PropertyGraph* pg, const std::string& name,
+    const std::vector<uint64_t>& expected) {
+  auto counts_res = pg->GetNodePropertyTyped<uint64_t>(name);
+  KATANA_LOG_VASSERT(counts_res, "no {}: {}", name, counts_res.error());
+  auto counts = counts_res.value();
+  for (size_t n = 0; n < expected.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        counts->Value(n) == expected[n], "node {} has {} {} not {}", n,
+        counts->Value(n), name, expected[n]);
+  }
+}
+
+void
+TestMotifs(size_t num_nodes, double density, MotifCountPlan plan) {
+  Matrix adjacent = RandomSymmetricMatrix(num_nodes, density);
+  MatrixPolicy policy{adjacent};
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, &policy);
+
+  auto res = katana::analytics::MotifCount(
+      pg.get(), "triangles", "four-cycles", "four-cliques", plan);
+  KATANA_LOG_VASSERT(res, "motif count failed: {}", res.error());
+
+  auto valid_res = katana::analytics::MotifCountAssertValid(
+      pg.get(), "triangles", "four-cycles", "four-cliques");
+  KATANA_LOG_VASSERT(valid_res, "invalid motifs: {}", valid_res.error());
+
+  ExpectedMotifs expected = CountMotifs(adjacent);
+  CheckCounts(pg.get(), "triangles", expected.triangles);
+  CheckCounts(pg.get(), "four-cycles", expected.four_cycles);
+  CheckCounts(pg.get(), "four-cliques", expected.four_cliques);
+
+  auto stats_res = katana::analytics::MotifCountStatistics::Compute(
+      pg.get(), "triangles", "four-cycles", "four-cliques");
+  KATANA_LOG_VASSERT(stats_res, "no statistics: {}", stats_res.error());
+  uint64_t total_triangles = 0;
+  for (uint64_t c : expected.triangles) {
+    total_triangles += c;
+  }
+  KATANA_LOG_ASSERT(stats_res.value().total_triangles == total_triangles / 3);
+}
+
+/// \returns the type of the triad of \p a, \p b and \p c, classified by its
+/// numbers of mutual and asymmetric dyads and the degrees of its nodes
+TriadCensus::TriadType
+ClassifyTriad(const Matrix& arc, size_t a, size_t b, size_t c) {
+  size_t nodes[3] = {a, b, c};
+  int mutual = 0;
+  int asymmetric = 0;
+  int out_degree[3] = {};
+  int in_degree[3] = {};
+  int mutual_out[3] = {};
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      if (i == j || !arc[nodes[i]][nodes[j]]) {
+        continue;
+      }
+      if (arc[nodes[j]][nodes[i]]) {
+        mutual_out[i] += 1;
+        mutual += i < j;
+      } else {
+        out_degree[i] += 1;
+        in_degree[j] += 1;
+        asymmetric += 1;
+      }
+    }
+  }
+  auto any = [](const int* degrees, int value) {
+    return degrees[0] == value || degrees[1] == value || degrees[2] == value;
+  };
+
+  switch (mutual * 4 + asymmetric) {
+  case 0:
+    return TriadCensus::k003;
+  case 1:
+    return TriadCensus::k012;
+  case 4:
+    return TriadCensus::k102;
+  case 2:
+    if (any(out_degree, 2)) {
+      return TriadCensus::k021D;
+    }
+    return any(in_degree, 2) ? TriadCensus::k021U : TriadCensus::k021C;
+  case 5:
+    // The asymmetric arc points into the mutual dyad, or out of it
+    for (int i = 0; i < 3; ++i) {
+      if (in_degree[i] == 1) {
+        return mutual_out[i] != 0 ? TriadCensus::k111D : TriadCensus::k111U;
+      }
+    }
+    break;
+  case 3:
+    return any(out_degree, 2) ? TriadCensus::k030T : TriadCensus::k030C;
+  case 8:
+    return TriadCensus::k201;
+  case 6:
+    // The node outside the mutual dyad sends both, receives both, or one
+    for (int i = 0; i < 3; ++i) {
+      if (mutual_out[i] == 0) {
+        if (out_degree[i] == 2) {
+          return TriadCensus::k120D;
+        }
+        return in_degree[i] == 2 ? TriadCensus::k120U : TriadCensus::k120C;
+      }
+    }
+    break;
+  case 9:
+    return TriadCensus::k210;
+  case 12:
+    return TriadCensus::k300;
+  }
+  KATANA_LOG_FATAL("unclassified triad {} {} {}", a, b, c);
+}
+
+void
+TestTriadCensus(Policy* policy, size_t num_nodes) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  auto census_res = katana::analytics::DirectedTriadCensus(pg.get());
+  KATANA_LOG_VASSERT(census_res, "census failed: {}", census_res.error());
+  const TriadCensus& census = census_res.value();
+
+  Matrix arc(num_nodes, std::vector<bool>(num_nodes));
+  const katana::GraphTopology& topology = pg->topology();
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (auto e : topology.edges(n)) {
+      if (topology.edge_dest(e) != n) {
+        arc[n][topology.edge_dest(e)] = true;
+      }
+    }
+  }
+
+  std::array<uint64_t, TriadCensus::kNumTriadTypes> expected{};
+  for (size_t a = 0; a < num_nodes; ++a) {
+    for (size_t b = a + 1; b < num_nodes; ++b) {
+      for (size_t c = b + 1; c < num_nodes; ++c) {
+        ++expected[ClassifyTriad(arc, a, b, c)];
+      }
+    }
+  }
+  for (size_t type = 0; type < TriadCensus::kNumTriadTypes; ++type) {
+    auto name =
+        TriadCensus::TypeName(static_cast<TriadCensus::TriadType>(type));
+    KATANA_LOG_VASSERT(
+        census.counts[type] == expected[type], "{} triads of type {} not {}",
+        census.counts[type], name, expected[type]);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (auto relabeling :
+       {MotifCountPlan::kNoRelabel, MotifCountPlan::kRelabel}) {
+    auto plan = MotifCountPlan::OrderedCount(false, relabeling);
+    TestMotifs(5, 1.0, plan);
+    for (double density : {0.1, 0.3, 0.6}) {
+      TestMotifs(40, density, plan);
+    }
+  }
+
+  // Motifs with an empty name are not counted, but one is required
+  Matrix adjacent = RandomSymmetricMatrix(10, 0.5);
+  MatrixPolicy policy{adjacent};
+  auto pg = MakeFileGraph<DataType>(10, 0, &policy);
+  auto res = katana::analytics::MotifCount(pg.get(), "triangles", "", "");
+  KATANA_LOG_VASSERT(res, "motif count failed: {}", res.error());
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("four-cycles"));
+  KATANA_LOG_ASSERT(!katana::analytics::MotifCount(pg.get(), "", "", ""));
+
+  LinePolicy cycle{1};
+  TestTriadCensus(&cycle, 20);
+  for (size_t width : {1, 2, 3, 5}) {
+    RandomPolicy random{width};
+    TestTriadCensus(&random, 30);
+  }
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/MultiSourceBfs.h"
+
+using DataType = int64_t;
+using Node = katana::analytics::MultiSourceBfs::Node;
+
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+std::vector<uint32_t>
+SerialBfs(const katana::GraphTopology& topology, Node source) {
+  std::vector<uint32_t> dist(topology.num_nodes(), kUnreached);
+  std::deque<Node> queue{source};
+  dist[source] = 0;
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop_front();
+    for (auto e : topology.edges(n)) {
+      Node dst = topology.edge_dest(e);
+      if (dist[dst] == kUnreached) {
+        dist[dst] = dist[n] + 1;
+        queue.push_back(dst);
+      }
+    }
+  }
+  return dist;
+}
+
+void
+TestMultiSourceBfs(size_t num_nodes, Policy* policy) {
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, policy);
+  const katana::GraphTopology& topology = g->topology();
+
+  katana::analytics::MultiSourceBfs bfs(topology);
+
+  // Run twice, with a repeated source, to check that state is reset
+  for (size_t batch : {size_t{64}, size_t{7}}) {
+    std::vector<Node> sources;
+    for (size_t i = 0; i < batch; ++i) {
+      sources.push_back((i * 13) % num_nodes);
+    }
+    sources.back() = sources.front();
+    bfs.Run(sources.data(), sources.size());
+
+    // dist[n][i] is the level of n for source i
+    std::vector<std::vector<uint32_t>> dist(
+        num_nodes, std::vector<uint32_t>(batch, kUnreached));
+    for (size_t d = 0; d < bfs.num_levels(); ++d) {
+      std::vector<bool> in_level(num_nodes);
+      for (const auto& v : bfs.level(d)) {
+        KATANA_LOG_VASSERT(
+            !in_level[v.node], "node {} twice in level {}", v.node, d);
+        in_level[v.node] = true;
+        KATANA_LOG_ASSERT(v.sources != 0);
+        for (size_t i = 0; i < batch; ++i) {
+          if (v.sources & (uint64_t{1} << i)) {
+            KATANA_LOG_VASSERT(
+                dist[v.node][i] == kUnreached,
+                "node {} reached twice from source {}", v.node, i);
+            dist[v.node][i] = d;
+          }
+        }
+      }
+
+      bfs.MarkLevel(d);
+      for (Node n = 0; n < num_nodes; ++n) {
+        KATANA_LOG_ASSERT((bfs.marked(n) != 0) == in_level[n]);
+      }
+    }
+
+    for (size_t i = 0; i < batch; ++i) {
+      std::vector<uint32_t> expected = SerialBfs(topology, sources[i]);
+      for (Node n = 0; n < num_nodes; ++n) {
+        KATANA_LOG_VASSERT(
+            dist[n][i] == expected[n],
+            "node {} source {}: expected {} found {}", n, sources[i],
+            expected[n], dist[n][i]);
+      }
+    }
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy line{3};
+  TestMultiSourceBfs(100, &line);
+
+  RandomPolicy random{3};
+  TestMultiSourceBfs(1000, &random);
+
+  return 0;
+}
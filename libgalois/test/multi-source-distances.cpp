@@ -0,0 +1,179 @@
+#include <deque>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using DataType = int64_t;
+using Node = katana::GraphTopology::Node;
+
+std::vector<uint32_t>
+SerialBfs(const katana::GraphTopology& topology, Node source) {
+  using katana::analytics::kBfsMultiSourceInfinity;
+  std::vector<uint32_t> dist(topology.num_nodes(), kBfsMultiSourceInfinity);
+  std::deque<Node> queue{source};
+  dist[source] = 0;
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop_front();
+    for (auto e : topology.edges(n)) {
+      Node dst = topology.edge_dest(e);
+      if (dist[dst] == kBfsMultiSourceInfinity) {
+        dist[dst] = dist[n] + 1;
+        queue.push_back(dst);
+      }
+    }
+  }
+  return dist;
+}
+
+template <typename Weight>
+std::vector<Weight>
+SerialDijkstra(
+    const katana::GraphTopology& topology, const std::vector<Weight>& weights,
+    Node source) {
+  constexpr Weight kInfinity = std::numeric_limits<Weight>::max() / 4;
+  std::vector<Weight> dist(topology.num_nodes(), kInfinity);
+  using Entry = std::pair<Weight, Node>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+  dist[source] = 0;
+  heap.emplace(0, source);
+  while (!heap.empty()) {
+    auto [d, n] = heap.top();
+    heap.pop();
+    if (d > dist[n]) {
+      continue;
+    }
+    for (auto e : topology.edges(n)) {
+      Node dst = topology.edge_dest(e);
+      if (d + weights[e] < dist[dst]) {
+        dist[dst] = d + weights[e];
+        heap.emplace(dist[dst], dst);
+      }
+    }
+  }
+  return dist;
+}
+
+/// The values of the fixed-size list property name, row by row
+template <typename ArrowArray>
+std::shared_ptr<ArrowArray>
+ListValues(katana::PropertyGraph* pg, const std::string& name, size_t width) {
+  auto property = pg->GetNodeProperty(name);
+  KATANA_LOG_VASSERT(property, "no property {}", name);
+  KATANA_LOG_ASSERT(property->num_chunks() == 1);
+  auto lists =
+      std::dynamic_pointer_cast<arrow::FixedSizeListArray>(property->chunk(0));
+  KATANA_LOG_ASSERT(lists);
+  KATANA_LOG_ASSERT(static_cast<size_t>(lists->value_length()) == width);
+  auto values = std::dynamic_pointer_cast<ArrowArray>(lists->values());
+  KATANA_LOG_ASSERT(values);
+  return values;
+}
+
+std::vector<uint32_t>
+MakeSources(size_t num_nodes, size_t count) {
+  std::vector<uint32_t> sources;
+  for (size_t i = 0; i < count; ++i) {
+    sources.push_back((i * 13) % num_nodes);
+  }
+  // Sources may repeat
+  sources.back() = sources.front();
+  return sources;
+}
+
+void
+TestBfsMultiSource(size_t num_nodes, Policy* policy) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  const katana::GraphTopology& topology = pg->topology();
+
+  // More sources than one bit-parallel search covers
+  std::vector<uint32_t> sources = MakeSources(num_nodes, 70);
+  auto res =
+      katana::analytics::BfsMultiSource(pg.get(), sources, "multi-levels");
+  KATANA_LOG_VASSERT(res, "BfsMultiSource failed: {}", res.error());
+  auto levels =
+      ListValues<arrow::UInt32Array>(pg.get(), "multi-levels", sources.size());
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    std::vector<uint32_t> expected = SerialBfs(topology, sources[i]);
+    for (Node n = 0; n < num_nodes; ++n) {
+      uint32_t found = levels->Value(n * sources.size() + i);
+      KATANA_LOG_VASSERT(
+          found == expected[n], "node {} source {}: expected {} found {}", n,
+          sources[i], expected[n], found);
+    }
+  }
+
+  std::vector<uint32_t> bad_sources{static_cast<uint32_t>(num_nodes)};
+  KATANA_LOG_ASSERT(
+      !katana::analytics::BfsMultiSource(pg.get(), bad_sources, "bad"));
+}
+
+template <typename Weight, typename ArrowArray>
+void
+TestSsspMultiSource(
+    size_t num_nodes, Policy* policy,
+    const std::shared_ptr<arrow::DataType>& arrow_type) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  const katana::GraphTopology& topology = pg->topology();
+
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<int> dist(0, 9);
+  std::vector<Weight> weights(topology.num_edges());
+  for (auto& w : weights) {
+    w = dist(gen);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow_type)}),
+      {katana::BuildArray(weights)});
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(table));
+
+  // Two full batches of relaxations and a partial one
+  std::vector<uint32_t> sources = MakeSources(num_nodes, 37);
+  auto res = katana::analytics::SsspMultiSource(
+      pg.get(), sources, "weight", "multi-distances");
+  KATANA_LOG_VASSERT(res, "SsspMultiSource failed: {}", res.error());
+  auto distances =
+      ListValues<ArrowArray>(pg.get(), "multi-distances", sources.size());
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    std::vector<Weight> expected =
+        SerialDijkstra(topology, weights, sources[i]);
+    for (Node n = 0; n < num_nodes; ++n) {
+      Weight found = distances->Value(n * sources.size() + i);
+      KATANA_LOG_VASSERT(
+          found == expected[n], "node {} source {}: expected {} found {}", n,
+          sources[i], expected[n], found);
+    }
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy line{3};
+  TestBfsMultiSource(100, &line);
+  TestSsspMultiSource<uint32_t, arrow::UInt32Array>(
+      100, &line, arrow::uint32());
+
+  RandomPolicy random{3};
+  TestBfsMultiSource(1000, &random);
+  TestSsspMultiSource<uint32_t, arrow::UInt32Array>(
+      1000, &random, arrow::uint32());
+  TestSsspMultiSource<double, arrow::DoubleArray>(
+      1000, &random, arrow::float64());
+
+  return 0;
+}
@@ -0,0 +1,372 @@
+#include <cstring>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/FileView.h"
+#include "tsuba/file.h"
+
+namespace {
+
+constexpr uint64_t kMiB = UINT64_C(1) << 20;
+/// The part size of multipart transfers
+constexpr uint64_t kPartSize = 16 * kMiB;
+/// Large enough to be split into parts: four whole parts and a short one
+constexpr uint64_t kLargeSize = 4 * kPartSize + 6 * kMiB;
+
+/// Objects in memory, under mem://, whose parts can be made to fail
+class MemStorage : public tsuba::FileStorage {
+public:
+  /// What happened to the object being uploaded
+  struct UploadLog {
+    uint64_t part_size{0};
+    /// Sizes of the parts put successfully
+    std::map<uint32_t, uint64_t> parts;
+    /// Attempts to put each part, successful or not
+    std::map<uint32_t, uint32_t> attempts;
+    bool completed{false};
+    bool aborted{false};
+  };
+
+  MemStorage() : FileStorage("mem://") {}
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    objects_.clear();
+    whole_puts_ = 0;
+    uploads_.clear();
+    ranges_.clear();
+    part_failures_.clear();
+    get_failures_.clear();
+  }
+
+  /// Make the next \param times puts of \param part fail
+  void FailPart(uint32_t part, uint32_t times) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    part_failures_[part] = times;
+  }
+
+  /// Make the next \param times reads starting at \param offset fail
+  void FailGet(uint64_t offset, uint32_t times) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    get_failures_[offset] = times;
+  }
+
+  bool Holds(const std::string& uri, const std::vector<uint8_t>& data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = objects_.find(uri);
+    return it != objects_.end() && it->second == data;
+  }
+  bool Exists(const std::string& uri) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return objects_.count(uri) > 0;
+  }
+  uint32_t whole_puts() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return whole_puts_;
+  }
+  std::vector<UploadLog> uploads() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return uploads_;
+  }
+  /// Offsets and sizes of the reads of the storage, successful or not
+  std::multimap<uint64_t, uint64_t> ranges() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ranges_;
+  }
+
+  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+
+  katana::Result<void> Stat(
+      const std::string& uri, tsuba::StatBuf* s_buf) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = objects_.find(uri);
+    if (it == objects_.end()) {
+      return KATANA_ERROR(tsuba::ErrorCode::NotFound, "no object {}", uri);
+    }
+    s_buf->size = it->second.size();
+    s_buf->version = "1";
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ranges_.emplace(start, size);
+    if (auto it = get_failures_.find(start);
+        it != get_failures_.end() && it->second > 0) {
+      it->second -= 1;
+      return KATANA_ERROR(
+          tsuba::ErrorCode::TODO, "injected failure at {}", start);
+    }
+    auto it = objects_.find(uri);
+    if (it == objects_.end() || start + size > it->second.size()) {
+      return KATANA_ERROR(tsuba::ErrorCode::NotFound, "no range of {}", uri);
+    }
+    std::memcpy(result_buf, it->second.data() + start, size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    whole_puts_ += 1;
+    objects_[uri].assign(data, data + size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string&, const std::string&, uint64_t, uint64_t) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+  std::future<katana::Result<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    return std::async(std::launch::deferred, [=]() {
+      return PutMultiSync(uri, data, size);
+    });
+  }
+
+  std::future<katana::Result<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return std::async(std::launch::deferred, [=]() {
+      return GetMultiSync(uri, start, size, result_buf);
+    });
+  }
+
+  std::future<katana::Result<void>> ListAsync(
+      const std::string&, std::vector<std::string>*,
+      std::vector<uint64_t>*) override {
+    return std::async(std::launch::deferred, []() -> katana::Result<void> {
+      return tsuba::ErrorCode::NotImplemented;
+    });
+  }
+
+  katana::Result<void> Delete(
+      const std::string&, const std::unordered_set<std::string>&) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+  katana::Result<std::unique_ptr<tsuba::MultipartUpload>> StartMultipartUpload(
+      const std::string& uri, uint64_t part_size) override;
+
+private:
+  class Upload;
+
+  std::mutex mutex_;
+  std::map<std::string, std::vector<uint8_t>> objects_;
+  uint32_t whole_puts_{0};
+  std::vector<UploadLog> uploads_;
+  std::multimap<uint64_t, uint64_t> ranges_;
+  std::map<uint32_t, uint32_t> part_failures_;
+  std::map<uint64_t, uint32_t> get_failures_;
+};
+
+class MemStorage::Upload : public tsuba::MultipartUpload {
+public:
+  Upload(MemStorage* storage, std::string uri, size_t log)
+      : storage_(storage), uri_(std::move(uri)), log_(log) {}
+
+  std::future<katana::Result<void>> PutPartAsync(
+      uint32_t part, const uint8_t* data, uint64_t size) override {
+    return std::async(
+        std::launch::deferred, [=]() -> katana::Result<void> {
+          std::lock_guard<std::mutex> lock(storage_->mutex_);
+          UploadLog& log = storage_->uploads_[log_];
+          log.attempts[part] += 1;
+          if (auto it = storage_->part_failures_.find(part);
+              it != storage_->part_failures_.end() && it->second > 0) {
+            it->second -= 1;
+            return KATANA_ERROR(
+                tsuba::ErrorCode::TODO, "injected failure of part {}", part);
+          }
+          log.parts[part] = size;
+          parts_[part].assign(data, data + size);
+          return katana::ResultSuccess();
+        });
+  }
+
+  katana::Result<void> Complete() override {
+    std::lock_guard<std::mutex> lock(storage_->mutex_);
+    std::vector<uint8_t>& object = storage_->objects_[uri_];
+    object.clear();
+    for (const auto& [part, data] : parts_) {
+      object.insert(object.end(), data.begin(), data.end());
+    }
+    storage_->uploads_[log_].completed = true;
+    return katana::ResultSuccess();
+  }
+
+  void Abort() override {
+    std::lock_guard<std::mutex> lock(storage_->mutex_);
+    storage_->uploads_[log_].aborted = true;
+    parts_.clear();
+  }
+
+private:
+  MemStorage* storage_;
+  std::string uri_;
+  /// The index of the log of this upload in uploads_
+  size_t log_;
+  std::map<uint32_t, std::vector<uint8_t>> parts_;
+};
+
+katana::Result<std::unique_ptr<tsuba::MultipartUpload>>
+MemStorage::StartMultipartUpload(const std::string& uri, uint64_t part_size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uploads_.emplace_back();
+  uploads_.back().part_size = part_size;
+  return std::unique_ptr<tsuba::MultipartUpload>(
+      std::make_unique<Upload>(this, uri, uploads_.size() - 1));
+}
+
+MemStorage storage;
+
+std::vector<uint8_t>
+MakeData(uint64_t size, uint8_t seed) {
+  std::vector<uint8_t> data(size);
+  for (uint64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 31 + i / kPartSize + seed);
+  }
+  return data;
+}
+
+/// Store data at uri through a FileFrame, which uploads it in parts if it
+/// is large
+katana::Result<void>
+Persist(const std::string& uri, const std::vector<uint8_t>& data, bool async) {
+  tsuba::FileFrame ff;
+  if (auto res = ff.Init(data.size()); !res) {
+    return res.error();
+  }
+  KATANA_LOG_ASSERT(ff.Write(data.data(), data.size()).ok());
+  ff.Bind(uri);
+  if (async) {
+    return ff.PersistAsync().get();
+  }
+  return ff.Persist();
+}
+
+/// Large stores are uploaded in parts of the part size, and small ones whole
+void
+TestPutParts() {
+  for (bool async : {false, true}) {
+    storage.Reset();
+    std::string uri = "mem://bucket/large";
+    std::vector<uint8_t> data = MakeData(kLargeSize, 1);
+    auto res = Persist(uri, data, async);
+    KATANA_LOG_VASSERT(res, "storing {}: {}", uri, res.error());
+    KATANA_LOG_ASSERT(storage.Holds(uri, data));
+    KATANA_LOG_ASSERT(storage.whole_puts() == 0);
+
+    std::vector<MemStorage::UploadLog> uploads = storage.uploads();
+    KATANA_LOG_ASSERT(uploads.size() == 1);
+    const MemStorage::UploadLog& upload = uploads[0];
+    KATANA_LOG_ASSERT(upload.part_size == kPartSize);
+    KATANA_LOG_ASSERT(upload.completed && !upload.aborted);
+    std::map<uint32_t, uint64_t> expected{
+        {0, kPartSize}, {1, kPartSize}, {2, kPartSize},
+        {3, kPartSize}, {4, 6 * kMiB}};
+    KATANA_LOG_ASSERT(upload.parts == expected);
+
+    std::string small_uri = "mem://bucket/small";
+    std::vector<uint8_t> small = MakeData(kMiB, 2);
+    res = Persist(small_uri, small, async);
+    KATANA_LOG_VASSERT(res, "storing {}: {}", small_uri, res.error());
+    KATANA_LOG_ASSERT(storage.Holds(small_uri, small));
+    KATANA_LOG_ASSERT(storage.whole_puts() == 1);
+    KATANA_LOG_ASSERT(storage.uploads().size() == 1);
+  }
+}
+
+/// A part that fails is put again, and the upload completes
+void
+TestPutRetry() {
+  storage.Reset();
+  storage.FailPart(2, 2);
+  std::string uri = "mem://bucket/retried";
+  std::vector<uint8_t> data = MakeData(kLargeSize, 3);
+  auto res = Persist(uri, data, false);
+  KATANA_LOG_VASSERT(res, "storing {}: {}", uri, res.error());
+  KATANA_LOG_ASSERT(storage.Holds(uri, data));
+
+  MemStorage::UploadLog upload = storage.uploads().at(0);
+  KATANA_LOG_ASSERT(upload.completed);
+  KATANA_LOG_ASSERT(upload.parts.size() == 5);
+  KATANA_LOG_ASSERT(upload.attempts[2] == 3);
+  KATANA_LOG_ASSERT(upload.attempts[1] == 1);
+}
+
+/// A part that keeps failing aborts the upload, leaving no object
+void
+TestPutAbort() {
+  storage.Reset();
+  storage.FailPart(1, 1000);
+  std::string uri = "mem://bucket/aborted";
+  auto res = Persist(uri, MakeData(kLargeSize, 4), false);
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(!storage.Exists(uri));
+
+  MemStorage::UploadLog upload = storage.uploads().at(0);
+  KATANA_LOG_ASSERT(upload.aborted && !upload.completed);
+  KATANA_LOG_VASSERT(
+      upload.attempts[1] > 1, "part 1 was tried {} times",
+      upload.attempts[1]);
+  KATANA_LOG_ASSERT(upload.parts.count(1) == 0);
+}
+
+/// Large reads are split into ranged reads of the part size, and a read
+/// that fails is done again
+void
+TestGetParts() {
+  storage.Reset();
+  std::string uri = "mem://bucket/read";
+  std::vector<uint8_t> data = MakeData(kLargeSize, 5);
+  KATANA_LOG_ASSERT(Persist(uri, data, false));
+  storage.FailGet(2 * kPartSize, 1);
+
+  tsuba::FileView fv;
+  auto res = fv.Bind(uri, true);
+  KATANA_LOG_VASSERT(res, "binding {}: {}", uri, res.error());
+  KATANA_LOG_ASSERT(fv.size() == data.size());
+  KATANA_LOG_ASSERT(
+      std::memcmp(fv.ptr<uint8_t>(), data.data(), data.size()) == 0);
+
+  std::multimap<uint64_t, uint64_t> expected{
+      {0, kPartSize},
+      {kPartSize, kPartSize},
+      {2 * kPartSize, kPartSize},
+      {2 * kPartSize, kPartSize},
+      {3 * kPartSize, kPartSize},
+      {4 * kPartSize, 6 * kMiB}};
+  KATANA_LOG_ASSERT(storage.ranges() == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  // Backends are registered before tsuba starts
+  tsuba::RegisterFileStorage(&storage);
+  katana::SharedMemSys sys;
+
+  TestPutParts();
+  TestPutRetry();
+  TestPutAbort();
+  TestGetParts();
+
+  return 0;
+}
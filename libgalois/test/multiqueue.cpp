@@ -0,0 +1,122 @@
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+using Graph = std::vector<std::vector<std::pair<uint32_t, float>>>;
+
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+std::vector<float>
+Dijkstra(const Graph& graph) {
+  std::vector<float> dist(graph.size(), kInfinity);
+  using Entry = std::pair<float, uint32_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  dist[0] = 0;
+  queue.emplace(0, 0);
+  while (!queue.empty()) {
+    auto [d, n] = queue.top();
+    queue.pop();
+    if (d > dist[n]) {
+      continue;
+    }
+    for (auto [dst, weight] : graph[n]) {
+      if (d + weight < dist[dst]) {
+        dist[dst] = d + weight;
+        queue.emplace(dist[dst], dst);
+      }
+    }
+  }
+  return dist;
+}
+
+/// Shortest paths by real-valued priority, which OrderedByIntegerMetric
+/// could only approximate by bucketing
+std::vector<float>
+ParallelSssp(const Graph& graph) {
+  std::vector<std::atomic<float>> dist(graph.size());
+  for (auto& d : dist) {
+    d = kInfinity;
+  }
+  dist[0] = 0;
+
+  using Item = std::pair<float, uint32_t>;
+  auto earlier = [](const Item& a, const Item& b) { return a < b; };
+  std::vector<Item> initial{{0, 0}};
+  katana::for_each(
+      katana::iterate(initial.begin(), initial.end()),
+      [&](const Item& item, auto& ctx) {
+        auto [d, n] = item;
+        if (d > dist[n].load(std::memory_order_relaxed)) {
+          return;
+        }
+        for (auto [dst, weight] : graph[n]) {
+          float new_dist = d + weight;
+          float old_dist = dist[dst].load(std::memory_order_relaxed);
+          while (new_dist < old_dist) {
+            if (dist[dst].compare_exchange_weak(old_dist, new_dist)) {
+              ctx.push(Item{new_dist, dst});
+              break;
+            }
+          }
+        }
+      },
+      katana::wl<katana::MultiQueue<decltype(earlier)>>(earlier),
+      katana::disable_conflict_detection(), katana::no_stats());
+
+  std::vector<float> result;
+  for (const auto& d : dist) {
+    result.push_back(d.load());
+  }
+  return result;
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // Every item pushed comes out, and then the worklist is empty
+  katana::setActiveThreads(4);
+  katana::MultiQueue<std::less<int>, int> wl;
+  std::vector<int> items(1000);
+  for (int i = 0; i < 1000; ++i) {
+    items[i] = i;
+  }
+  wl.push(items.begin(), items.end());
+  KATANA_LOG_ASSERT(!wl.empty());
+  std::vector<bool> seen(items.size(), false);
+  while (auto val = wl.pop()) {
+    KATANA_LOG_ASSERT(!seen[*val]);
+    seen[*val] = true;
+  }
+  KATANA_LOG_ASSERT(wl.empty());
+  for (bool s : seen) {
+    KATANA_LOG_ASSERT(s);
+  }
+
+  constexpr uint32_t kNumNodes = 5000;
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<uint32_t> node_dist(0, kNumNodes - 1);
+  std::uniform_real_distribution<float> weight_dist(0.01, 10.0);
+  Graph graph(kNumNodes);
+  for (uint32_t i = 0; i < kNumNodes * 8; ++i) {
+    graph[node_dist(gen)].emplace_back(node_dist(gen), weight_dist(gen));
+  }
+
+  std::vector<float> expected = Dijkstra(graph);
+  for (unsigned threads : {1, 4}) {
+    katana::setActiveThreads(threads);
+    KATANA_LOG_VASSERT(
+        ParallelSssp(graph) == expected, "distances differ with {} threads",
+        threads);
+  }
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "CachingNameServerClient.h"
+#include "MemoryNameServerClient.h"
+#include "RDGMeta.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/Errors.h"
+#include "tsuba/RDGLineage.h"
+
+namespace {
+
+constexpr std::chrono::milliseconds kTTL(200);
+
+/// A name server in memory that counts the requests that reach it
+class CountingClient : public tsuba::MemoryNameServerClient {
+public:
+  katana::Result<tsuba::RDGMeta> Get(const katana::Uri& rdg_name) override {
+    gets += 1;
+    return MemoryNameServerClient::Get(rdg_name);
+  }
+
+  katana::Result<bool> GetIfChanged(
+      const katana::Uri& rdg_name, uint64_t known_version,
+      tsuba::RDGMeta* meta) override {
+    revalidations += 1;
+    return MemoryNameServerClient::GetIfChanged(rdg_name, known_version, meta);
+  }
+
+  uint32_t gets{0};
+  uint32_t revalidations{0};
+};
+
+tsuba::RDGMeta
+Next(const tsuba::RDGMeta& meta) {
+  return meta.NextVersion(1, 0, false, tsuba::RDGLineage());
+}
+
+/// Get name through cache and check its version and whether it reached the
+/// server
+void
+CheckGet(
+    tsuba::CachingNameServerClient* cache, CountingClient* server,
+    const katana::Uri& name, uint64_t version, bool from_server) {
+  uint32_t requests = server->gets;
+  auto meta_res = cache->Get(name);
+  KATANA_LOG_VASSERT(meta_res, "getting {}: {}", name, meta_res.error());
+  KATANA_LOG_VASSERT(
+      meta_res.value().version() == version, "{} is at version {}, not {}",
+      name, meta_res.value().version(), version);
+  KATANA_LOG_VASSERT(
+      (server->gets > requests) == from_server, "{} was {}got from the server",
+      name, from_server ? "not " : "");
+}
+
+/// Entries are served from the cache until their ttl passes, and then
+/// revalidated with the server
+void
+TestExpiry(const katana::Uri& name) {
+  auto owned = std::make_unique<CountingClient>();
+  CountingClient* server = owned.get();
+  tsuba::CachingNameServerClient cache(std::move(owned), kTTL);
+
+  tsuba::RDGMeta v1 = Next(tsuba::RDGMeta());
+  KATANA_LOG_ASSERT(cache.CreateIfAbsent(name, v1));
+  CheckGet(&cache, server, name, v1.version(), true);
+  CheckGet(&cache, server, name, v1.version(), false);
+  KATANA_LOG_ASSERT(server->revalidations == 0);
+
+  // Another client moves the name on; the cache does not see it yet
+  tsuba::RDGMeta v2 = Next(v1);
+  KATANA_LOG_ASSERT(server->Update(name, v1.version(), v2));
+  CheckGet(&cache, server, name, v1.version(), false);
+
+  std::this_thread::sleep_for(kTTL);
+  CheckGet(&cache, server, name, v2.version(), true);
+  KATANA_LOG_ASSERT(server->revalidations == 1);
+  CheckGet(&cache, server, name, v2.version(), false);
+
+  // An entry that did not change is kept after revalidating it
+  std::this_thread::sleep_for(kTTL);
+  CheckGet(&cache, server, name, v2.version(), true);
+  KATANA_LOG_ASSERT(server->revalidations == 2);
+  CheckGet(&cache, server, name, v2.version(), false);
+
+  KATANA_LOG_ASSERT(cache.Delete(name));
+}
+
+/// Changes made through the cache update it, and changes that fail drop
+/// the entry
+void
+TestChanges(const katana::Uri& name) {
+  auto owned = std::make_unique<CountingClient>();
+  CountingClient* server = owned.get();
+  tsuba::CachingNameServerClient cache(std::move(owned), kTTL);
+
+  tsuba::RDGMeta v1 = Next(tsuba::RDGMeta());
+  KATANA_LOG_ASSERT(cache.CreateIfAbsent(name, v1));
+  CheckGet(&cache, server, name, v1.version(), true);
+
+  tsuba::RDGMeta v2 = Next(v1);
+  KATANA_LOG_ASSERT(cache.Update(name, v1.version(), v2));
+  CheckGet(&cache, server, name, v2.version(), false);
+
+  // An update from a version the name was already moved on from fails
+  tsuba::RDGMeta stale = Next(v1);
+  auto update_res = cache.Update(name, v1.version(), Next(stale));
+  KATANA_LOG_ASSERT(!update_res);
+  KATANA_LOG_ASSERT(update_res.error() == tsuba::ErrorCode::BadVersion);
+  CheckGet(&cache, server, name, v2.version(), true);
+  CheckGet(&cache, server, name, v2.version(), false);
+
+  // Names deleted through the cache are gone at once
+  KATANA_LOG_ASSERT(cache.Delete(name));
+  uint32_t requests = server->gets;
+  KATANA_LOG_ASSERT(!cache.Get(name));
+  KATANA_LOG_ASSERT(server->gets == requests + 1);
+
+  // and names created again are fetched again
+  KATANA_LOG_ASSERT(cache.CreateIfAbsent(name, v1));
+  CheckGet(&cache, server, name, v1.version(), true);
+  KATANA_LOG_ASSERT(cache.Delete(name));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::Uri::Make("mem://bucket/rdg");
+  KATANA_LOG_ASSERT(uri_res);
+  TestExpiry(uri_res.value());
+  TestChanges(uri_res.value());
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/nearest_neighbors/nearest_neighbors.h"
+
+using DataType = int64_t;
+using katana::analytics::NearestNeighborsPlan;
+
+namespace {
+
+constexpr uint32_t kDimension = 8;
+constexpr uint32_t kNumNeighbors = 10;
+
+/// Add the node property embedding of random embeddings
+std::vector<float>
+AddEmbeddings(katana::PropertyGraph* pg) {
+  auto& gen = katana::GetGenerator();
+  std::uniform_real_distribution<float> dist(-1, 1);
+  std::vector<float> embeddings(pg->topology().num_nodes() * kDimension);
+  for (auto& f : embeddings) {
+    f = dist(gen);
+  }
+  auto values = katana::BuildArray(embeddings);
+  auto type = arrow::fixed_size_list(values->type(), kDimension);
+  auto list = std::make_shared<arrow::FixedSizeListArray>(
+      type, pg->topology().num_nodes(), values);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("embedding", type)}), {list});
+  auto res = pg->AddNodeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add embeddings: {}", res.error());
+  return embeddings;
+}
+
+float
+Distance(const float* a, const float* b, NearestNeighborsPlan::Metric metric) {
+  float dot = 0, aa = 0, bb = 0, squared = 0;
+  for (uint32_t i = 0; i < kDimension; ++i) {
+    dot += a[i] * b[i];
+    aa += a[i] * a[i];
+    bb += b[i] * b[i];
+    squared += (a[i] - b[i]) * (a[i] - b[i]);
+  }
+  switch (metric) {
+  case NearestNeighborsPlan::kInnerProduct:
+    return -dot;
+  case NearestNeighborsPlan::kCosine:
+    return 1 - dot / std::sqrt(aa * bb);
+  default:
+    return std::sqrt(squared);
+  }
+}
+
+void
+TestQueries(
+    katana::PropertyGraph* pg, const std::vector<float>& embeddings,
+    NearestNeighborsPlan::Metric metric, const std::string& index) {
+  auto plan = NearestNeighborsPlan::Hnsw(metric);
+  auto build_res = katana::analytics::NearestNeighborsBuildIndex(
+      pg, "embedding", index, plan);
+  KATANA_LOG_VASSERT(build_res, "could not build index: {}", build_res.error());
+  KATANA_LOG_ASSERT(pg->GetNodeProperty(index));
+
+  // Every node is its own query
+  uint64_t num_nodes = pg->topology().num_nodes();
+  std::vector<uint32_t> neighbors(num_nodes * kNumNeighbors);
+  std::vector<float> distances(num_nodes * kNumNeighbors);
+  auto query_res = katana::analytics::NearestNeighborsQuery(
+      pg, "embedding", index, embeddings.data(), num_nodes, kNumNeighbors,
+      neighbors.data(), distances.data(), plan);
+  KATANA_LOG_VASSERT(query_res, "could not query: {}", query_res.error());
+
+  size_t found = 0;
+  std::vector<std::pair<float, uint32_t>> exact(num_nodes);
+  for (uint64_t q = 0; q < num_nodes; ++q) {
+    const float* query = &embeddings[q * kDimension];
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      exact[n] = {Distance(query, &embeddings[n * kDimension], metric), n};
+    }
+    std::partial_sort(
+        exact.begin(), exact.begin() + kNumNeighbors, exact.end());
+    for (uint32_t i = 0; i < kNumNeighbors; ++i) {
+      uint32_t n = neighbors[q * kNumNeighbors + i];
+      KATANA_LOG_ASSERT(n < num_nodes);
+      float d = distances[q * kNumNeighbors + i];
+      KATANA_LOG_VASSERT(
+          std::abs(d - Distance(query, &embeddings[n * kDimension], metric)) <
+              1e-4,
+          "query {} neighbor {}: bad distance {}", q, n, d);
+      KATANA_LOG_ASSERT(i == 0 || distances[q * kNumNeighbors + i - 1] <= d);
+      found += std::any_of(
+          exact.begin(), exact.begin() + kNumNeighbors,
+          [&](const auto& e) { return e.second == n; });
+    }
+  }
+  double recall = static_cast<double>(found) / (num_nodes * kNumNeighbors);
+  KATANA_LOG_VASSERT(recall >= 0.9, "recall {} is too low", recall);
+
+  // The index must be queried with the max_degree it was built with
+  auto other_plan = NearestNeighborsPlan::Hnsw(metric, 7);
+  KATANA_LOG_ASSERT(!katana::analytics::NearestNeighborsQuery(
+      pg, "embedding", index, embeddings.data(), 1, kNumNeighbors,
+      neighbors.data(), distances.data(), other_plan));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy policy{1};
+  auto pg = MakeFileGraph<DataType>(2000, 0, &policy);
+  std::vector<float> embeddings = AddEmbeddings(pg.get());
+
+  TestQueries(
+      pg.get(), embeddings, NearestNeighborsPlan::kEuclidean, "euclidean");
+  TestQueries(pg.get(), embeddings, NearestNeighborsPlan::kCosine, "cosine");
+
+  // The index may not already exist
+  KATANA_LOG_ASSERT(!katana::analytics::NearestNeighborsBuildIndex(
+      pg.get(), "embedding", "cosine"));
+
+  // With fewer nodes than neighbors, the rest are missing
+  auto small = MakeFileGraph<DataType>(3, 0, &policy);
+  std::vector<float> small_embeddings = AddEmbeddings(small.get());
+  KATANA_LOG_ASSERT(katana::analytics::NearestNeighborsBuildIndex(
+      small.get(), "embedding", "index"));
+  std::vector<uint32_t> neighbors(kNumNeighbors);
+  std::vector<float> distances(kNumNeighbors);
+  KATANA_LOG_ASSERT(katana::analytics::NearestNeighborsQuery(
+      small.get(), "embedding", "index", small_embeddings.data(), 1,
+      kNumNeighbors, neighbors.data(), distances.data()));
+  KATANA_LOG_ASSERT(neighbors[0] == 0 && distances[0] == 0);
+  KATANA_LOG_ASSERT(neighbors[3] == UINT32_MAX && std::isinf(distances[3]));
+
+  return 0;
+}
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/neighbor_aggregation/neighbor_aggregation.h"
+
+using DataType = int64_t;
+using katana::analytics::NeighborAggregationPlan;
+
+namespace {
+
+/// Add the node property name of size random features per node
+template <typename Feature>
+std::vector<float>
+AddFeatures(katana::PropertyGraph* pg, const std::string& name, uint32_t size) {
+  auto& gen = katana::GetGenerator();
+  std::uniform_real_distribution<Feature> dist(-1, 1);
+  std::vector<Feature> features(pg->topology().num_nodes() * size);
+  for (auto& f : features) {
+    f = dist(gen);
+  }
+  auto values = katana::BuildArray(features);
+  auto type = arrow::fixed_size_list(values->type(), size);
+  auto list = std::make_shared<arrow::FixedSizeListArray>(
+      type, pg->topology().num_nodes(), values);
+  auto table =
+      arrow::Table::Make(arrow::schema({arrow::field(name, type)}), {list});
+  auto res = pg->AddNodeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add features: {}", res.error());
+  return std::vector<float>(features.begin(), features.end());
+}
+
+void
+AddWeights(katana::PropertyGraph* pg) {
+  std::vector<uint32_t> weights(pg->topology().num_edges());
+  for (size_t e = 0; e < weights.size(); ++e) {
+    weights[e] = e % 3 + 1;
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)});
+  auto res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add weights: {}", res.error());
+}
+
+/// The aggregates of plan, one edge at a time
+std::vector<float>
+Expected(
+    const katana::GraphTopology& topology, const std::vector<float>& features,
+    uint32_t size, bool weighted, const NeighborAggregationPlan& plan) {
+  uint64_t num_nodes = topology.num_nodes();
+  std::vector<std::vector<std::pair<uint32_t, float>>> neighbors(num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (auto e : topology.edges(n)) {
+      uint32_t dest = topology.edge_dest(e);
+      float w = weighted ? e % 3 + 1 : 1;
+      if (plan.neighbors() == NeighborAggregationPlan::kOutNeighbors) {
+        neighbors[n].emplace_back(dest, w);
+      } else {
+        neighbors[dest].emplace_back(n, w);
+      }
+    }
+  }
+
+  std::vector<float> expected(num_nodes * size, 0);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (uint32_t c = 0; c < size; ++c) {
+      float sum = 0;
+      float max = -INFINITY;
+      float total_weight = 0;
+      for (auto [m, w] : neighbors[n]) {
+        float value = w * features[m * size + c];
+        sum += value;
+        max = std::max(max, value);
+        total_weight += w;
+      }
+      if (neighbors[n].empty()) {
+        continue;
+      }
+      switch (plan.aggregation()) {
+      case NeighborAggregationPlan::kSum:
+        expected[n * size + c] = sum;
+        break;
+      case NeighborAggregationPlan::kMean:
+        expected[n * size + c] = sum / total_weight;
+        break;
+      case NeighborAggregationPlan::kMax:
+        expected[n * size + c] = max;
+        break;
+      }
+    }
+  }
+  return expected;
+}
+
+void
+Check(
+    katana::PropertyGraph* pg, const std::string& name,
+    const std::vector<float>& expected) {
+  auto property = pg->GetNodeProperty(name);
+  KATANA_LOG_ASSERT(property);
+  auto list =
+      std::dynamic_pointer_cast<arrow::FixedSizeListArray>(property->chunk(0));
+  KATANA_LOG_ASSERT(list);
+  auto values = std::dynamic_pointer_cast<arrow::FloatArray>(list->values());
+  KATANA_LOG_ASSERT(values);
+  KATANA_LOG_ASSERT(static_cast<size_t>(values->length()) == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    float actual = values->Value(i);
+    KATANA_LOG_VASSERT(
+        std::abs(actual - expected[i]) <= 1e-4 * (1 + std::abs(expected[i])),
+        "{} value {}: expected {} found {}", name, i, expected[i], actual);
+  }
+}
+
+template <typename Feature>
+void
+TestAggregation(uint32_t size) {
+  RandomPolicy policy{4};
+  auto pg = MakeFileGraph<DataType>(500, 0, &policy);
+  std::vector<float> features = AddFeatures<Feature>(pg.get(), "x", size);
+  AddWeights(pg.get());
+
+  int i = 0;
+  for (auto neighbors : {NeighborAggregationPlan::kOutNeighbors,
+                         NeighborAggregationPlan::kInNeighbors}) {
+    for (uint32_t block : {0U, 1U, 16U}) {
+      for (auto plan :
+           {NeighborAggregationPlan::Sum(neighbors, block),
+            NeighborAggregationPlan::Mean(neighbors, block),
+            NeighborAggregationPlan::Max(neighbors, block)}) {
+        for (bool weighted : {false, true}) {
+          std::string name = "aggregate-" + std::to_string(i++);
+          auto res = katana::analytics::NeighborAggregation(
+              pg.get(), "x", name, weighted ? "weight" : "", plan);
+          KATANA_LOG_VASSERT(res, "aggregation failed: {}", res.error());
+          Check(
+              pg.get(), name,
+              Expected(pg->topology(), features, size, weighted, plan));
+        }
+      }
+    }
+  }
+
+  // The features must be a fixed size list
+  auto res = katana::analytics::NeighborAggregation(pg.get(), "weight", "bad");
+  KATANA_LOG_ASSERT(!res);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestAggregation<float>(40);
+  TestAggregation<double>(3);
+
+  return 0;
+}
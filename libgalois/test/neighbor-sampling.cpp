@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/neighbor_sampling/neighbor_sampling.h"
+
+using DataType = int64_t;
+using katana::analytics::NeighborSample;
+using katana::analytics::NeighborSampleLoader;
+using katana::analytics::NeighborSampler;
+
+/// Add the edge property "weight", which is 0 for edges to multiples of 3,
+/// and the node features "id", the node itself, and "position", the list of
+/// the node and its negation
+void
+AddProperties(katana::PropertyGraph* pg) {
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<uint32_t> weights(topology.num_edges());
+  for (size_t e = 0; e < weights.size(); ++e) {
+    weights[e] = topology.edge_dest(e) % 3;
+  }
+  auto res = pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)}));
+  KATANA_LOG_VASSERT(res, "could not add weights: {}", res.error());
+
+  std::vector<int64_t> ids(topology.num_nodes());
+  std::vector<float> positions;
+  for (size_t n = 0; n < ids.size(); ++n) {
+    ids[n] = n;
+    positions.insert(positions.end(), {float(n), -float(n)});
+  }
+  auto lists_res = arrow::FixedSizeListArray::FromArrays(
+      katana::BuildArray(positions), 2);
+  KATANA_LOG_ASSERT(lists_res.ok());
+  auto lists = lists_res.ValueOrDie();
+  res = pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("id", arrow::int64()),
+           arrow::field("position", lists->type())}),
+      {katana::BuildArray(ids), lists}));
+  KATANA_LOG_VASSERT(res, "could not add features: {}", res.error());
+}
+
+/// Check that batch is the hops of fanouts around seeds, relabeled, with
+/// the features of its nodes
+void
+CheckBatch(
+    katana::PropertyGraph* pg, const NeighborSample& batch,
+    const std::vector<uint32_t>& seeds, const std::vector<uint32_t>& fanouts,
+    bool weighted, bool with_replacement) {
+  const katana::GraphTopology& topology = pg->topology();
+  KATANA_LOG_ASSERT(batch.num_hops() == fanouts.size());
+  KATANA_LOG_ASSERT(batch.hop_offsets[1] == seeds.size());
+  KATANA_LOG_ASSERT(
+      batch.out_indices.size() == batch.hop_offsets[fanouts.size()]);
+  std::set<uint32_t> distinct(batch.nodes.begin(), batch.nodes.end());
+  KATANA_LOG_ASSERT(distinct.size() == batch.num_nodes());
+  for (size_t i = 0; i < seeds.size(); ++i) {
+    KATANA_LOG_ASSERT(batch.nodes[i] == seeds[i]);
+  }
+
+  for (size_t h = 0; h < fanouts.size(); ++h) {
+    for (uint64_t i = batch.hop_offsets[h]; i < batch.hop_offsets[h + 1];
+         ++i) {
+      uint32_t node = batch.nodes[i];
+      uint64_t available = 0;
+      for (auto e : topology.edges(node)) {
+        available += !weighted || topology.edge_dest(e) % 3 != 0;
+      }
+      auto [begin, end] = batch.edge_range(i);
+      uint64_t expected = available == 0 ? 0
+                          : with_replacement
+                              ? fanouts[h]
+                              : std::min<uint64_t>(fanouts[h], available);
+      KATANA_LOG_VASSERT(
+          end - begin == expected, "node {} keeps {} edges, not {}", node,
+          end - begin, expected);
+
+      std::set<uint64_t> edges;
+      for (uint64_t e = begin; e < end; ++e) {
+        uint64_t edge = batch.edges[e];
+        auto [first, last] = topology.edge_range(node);
+        KATANA_LOG_ASSERT(first <= edge && edge < last);
+        uint32_t dest = batch.out_dests[e];
+        KATANA_LOG_ASSERT(batch.nodes[dest] == topology.edge_dest(edge));
+        // Nodes are numbered by the hop that first reaches them
+        KATANA_LOG_ASSERT(dest < batch.hop_offsets[h + 2]);
+        KATANA_LOG_ASSERT(!weighted || batch.nodes[dest] % 3 != 0);
+        edges.insert(edge);
+      }
+      KATANA_LOG_ASSERT(with_replacement || edges.size() == end - begin);
+    }
+  }
+
+  KATANA_LOG_ASSERT(batch.feature_width == 3);
+  for (size_t i = 0; i < batch.num_nodes(); ++i) {
+    const float* features = batch.node_features(i);
+    float node = batch.nodes[i];
+    KATANA_LOG_ASSERT(features[0] == node);
+    KATANA_LOG_ASSERT(features[1] == node && features[2] == -node);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  RandomPolicy random{12};
+  auto pg = MakeFileGraph<DataType>(1000, 0, &random);
+  AddProperties(pg.get());
+  std::vector<std::string> features{"id", "position"};
+  std::vector<uint32_t> fanouts{10, 5, 3};
+
+  for (bool weighted : {false, true}) {
+    for (bool with_replacement : {false, true}) {
+      auto sampler_res = weighted ? NeighborSampler::MakeWeighted(
+                                        pg.get(), "weight", features,
+                                        with_replacement)
+                                  : NeighborSampler::Make(
+                                        pg.get(), features, with_replacement);
+      KATANA_LOG_VASSERT(
+          sampler_res, "could not make sampler: {}", sampler_res.error());
+      NeighborSampler* sampler = sampler_res.value().get();
+
+      // The buffers of a batch are reused from one batch to the next
+      NeighborSample batch;
+      for (uint32_t start = 0; start < 1000; start += 100) {
+        std::vector<uint32_t> seeds;
+        for (uint32_t n = start; n < start + 64; ++n) {
+          seeds.emplace_back(n);
+        }
+        auto res = sampler->Sample(seeds, fanouts, &batch);
+        KATANA_LOG_VASSERT(res, "sampling failed: {}", res.error());
+        CheckBatch(pg.get(), batch, seeds, fanouts, weighted, with_replacement);
+      }
+
+      // Seeds must be distinct nodes, and a failed batch leaves the sampler
+      // as it was
+      KATANA_LOG_ASSERT(!sampler->Sample({1, 2, 1}, fanouts, &batch));
+      KATANA_LOG_ASSERT(!sampler->Sample({1, 1000}, fanouts, &batch));
+      auto res = sampler->Sample({2, 1}, fanouts, &batch);
+      KATANA_LOG_VASSERT(res, "sampling failed: {}", res.error());
+      CheckBatch(pg.get(), batch, {2, 1}, fanouts, weighted, with_replacement);
+    }
+  }
+
+  // The loader returns its batches in order, along with their errors
+  auto sampler_res = NeighborSampler::Make(pg.get(), features);
+  KATANA_LOG_ASSERT(sampler_res);
+  NeighborSampler* sampler = sampler_res.value().get();
+  std::vector<std::vector<uint32_t>> seed_batches;
+  for (uint32_t n = 0; n < 20; ++n) {
+    seed_batches.push_back({n, n + 500});
+  }
+  seed_batches[7] = {3, 3};
+  {
+    NeighborSampleLoader loader(sampler, &seed_batches, fanouts, 3);
+    for (size_t i = 0; i < seed_batches.size(); ++i) {
+      auto batch_res = loader.Next();
+      if (i == 7) {
+        KATANA_LOG_ASSERT(!batch_res);
+        continue;
+      }
+      KATANA_LOG_VASSERT(batch_res, "sampling failed: {}", batch_res.error());
+      CheckBatch(
+          pg.get(), *batch_res.value(), seed_batches[i], fanouts, false,
+          false);
+    }
+    auto end_res = loader.Next();
+    KATANA_LOG_ASSERT(end_res && end_res.value() == nullptr);
+  }
+
+  // A loader may stop before its last batch
+  {
+    NeighborSampleLoader loader(sampler, &seed_batches, fanouts);
+    auto batch_res = loader.Next();
+    KATANA_LOG_ASSERT(batch_res && batch_res.value()->nodes[0] == 0);
+  }
+
+  // The properties must exist
+  KATANA_LOG_ASSERT(!NeighborSampler::Make(pg.get(), {"missing"}));
+  KATANA_LOG_ASSERT(!NeighborSampler::MakeWeighted(pg.get(), "missing"));
+
+  return 0;
+}
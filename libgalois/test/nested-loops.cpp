@@ -0,0 +1,67 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+void
+TestNestedDoAll() {
+  constexpr int kOuter = 100;
+  constexpr int kInner = 1000;
+  std::vector<int> sums(kOuter);
+
+  katana::do_all(
+      katana::iterate(0, kOuter),
+      [&](int i) {
+        int sum = 0;
+        katana::do_all(katana::iterate(0, kInner), [&](int j) { sum += j; });
+        sums[i] = sum;
+      },
+      katana::loopname("OuterDoAll"));
+
+  for (int i = 0; i < kOuter; ++i) {
+    KATANA_LOG_VASSERT(
+        sums[i] == kInner * (kInner - 1) / 2, "sum {} is {}", i, sums[i]);
+  }
+}
+
+void
+TestNestedForEach() {
+  constexpr int kOuter = 100;
+  constexpr int kDepth = 10;
+  std::vector<int> counts(kOuter);
+
+  // Each inner loop pushes a chain of kDepth items
+  katana::for_each(
+      katana::iterate(0, kOuter),
+      [&](int i, auto&) {
+        int count = 0;
+        katana::for_each(
+            katana::iterate(0, 1),
+            [&](int depth, auto& ctx) {
+              ++count;
+              if (depth + 1 < kDepth) {
+                ctx.push(depth + 1);
+              }
+            },
+            katana::disable_conflict_detection());
+        counts[i] = count;
+      },
+      katana::disable_conflict_detection(), katana::no_pushes(),
+      katana::loopname("OuterForEach"));
+
+  for (int i = 0; i < kOuter; ++i) {
+    KATANA_LOG_VASSERT(counts[i] == kDepth, "count {} is {}", i, counts[i]);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestNestedDoAll();
+  TestNestedForEach();
+
+  return 0;
+}
@@ -0,0 +1,51 @@
+#include <arrow/buffer.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NumaMemoryPool.h"
+#include "katana/PageAlloc.h"
+
+void
+TestPolicy(katana::NumaMemoryPool::Policy policy) {
+  katana::NumaMemoryPool pool(policy);
+  int64_t large = 3 * katana::allocSize() + 17;
+
+  auto res = arrow::AllocateResizableBuffer(large, &pool);
+  KATANA_LOG_ASSERT(res.ok());
+  std::unique_ptr<arrow::ResizableBuffer> buf = std::move(res.ValueOrDie());
+  KATANA_LOG_ASSERT(pool.bytes_allocated() >= large);
+
+  uint8_t* data = buf->mutable_data();
+  for (int64_t i = 0; i < large; ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+
+  // Shrink to a small buffer and back to check contents survive moving
+  // between the large and small allocators
+  KATANA_LOG_ASSERT(buf->Resize(100, /*shrink_to_fit=*/true).ok());
+  KATANA_LOG_ASSERT(buf->Resize(large, /*shrink_to_fit=*/true).ok());
+  data = buf->mutable_data();
+  for (int64_t i = 0; i < 100; ++i) {
+    KATANA_LOG_VASSERT(
+        data[i] == static_cast<uint8_t>(i), "byte {} is {}", i, int{data[i]});
+  }
+
+  buf.reset();
+  KATANA_LOG_VASSERT(
+      pool.bytes_allocated() == 0, "{} bytes still allocated",
+      pool.bytes_allocated());
+  KATANA_LOG_ASSERT(pool.max_memory() >= large);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestPolicy(katana::NumaMemoryPool::Policy::kBlocked);
+  TestPolicy(katana::NumaMemoryPool::Policy::kInterleaved);
+  TestPolicy(katana::NumaMemoryPool::Policy::kLocal);
+  TestPolicy(katana::NumaMemoryPool::Policy::kFloating);
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using katana::analytics::SsspPlan;
+using Weight = uint32_t;
+
+namespace {
+
+/// The width of the buckets of items, as a shift
+constexpr uint32_t kShift = 4;
+/// The buckets past the current one that items may be pushed into
+constexpr int kFarDistance = 8;
+
+struct BucketIndexer {
+  int operator()(uint32_t item) const { return item >> kShift; }
+};
+
+using OBIM = katana::OrderedByIntegerMetric<
+    BucketIndexer, katana::PerSocketChunkFIFO<16>>;
+
+/// Items pushed far past the current bucket come out once each, and with
+/// one thread in the order of their buckets
+void
+TestFarItems(unsigned threads) {
+  katana::setActiveThreads(threads);
+
+  // Distinct items spread over many more buckets than the far distance
+  constexpr uint32_t kNumItems = 20000;
+  constexpr uint32_t kRange = 1000003;
+  std::vector<uint32_t> pushed;
+  for (uint32_t i = 1; i <= kNumItems; ++i) {
+    pushed.emplace_back((i * UINT64_C(7919)) % kRange + 1);
+  }
+
+  std::vector<std::atomic<uint32_t>> seen(kRange + 1);
+  std::mutex mutex;
+  std::vector<uint32_t> order;
+  std::vector<uint32_t> initial{0};
+  katana::for_each(
+      katana::iterate(initial.begin(), initial.end()),
+      [&](uint32_t item, auto& ctx) {
+        seen[item].fetch_add(1);
+        if (item == 0) {
+          for (uint32_t p : pushed) {
+            ctx.push(p);
+          }
+          return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        order.emplace_back(item);
+      },
+      katana::wl<OBIM>(BucketIndexer(), kFarDistance),
+      katana::disable_conflict_detection(), katana::no_stats());
+
+  KATANA_LOG_ASSERT(seen[0] == 1);
+  for (uint32_t p : pushed) {
+    KATANA_LOG_VASSERT(
+        seen[p] == 1, "{} came out {} times with {} threads", p,
+        seen[p].load(), threads);
+  }
+  KATANA_LOG_ASSERT(order.size() == pushed.size());
+  if (threads == 1) {
+    for (size_t i = 1; i < order.size(); ++i) {
+      KATANA_LOG_VASSERT(
+          BucketIndexer()(order[i - 1]) <= BucketIndexer()(order[i]),
+          "{} came out before {}", order[i - 1], order[i]);
+    }
+  }
+}
+
+/// Add the edge property "weight" with weights of up to many times the
+/// width of a bucket, so that most requests are far
+void
+AddWeights(katana::PropertyGraph* pg) {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<Weight> dist(0, 100000);
+  std::vector<Weight> weights(pg->topology().num_edges());
+  for (auto& w : weights) {
+    w = dist(gen);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)});
+  auto res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add weights: {}", res.error());
+}
+
+std::vector<Weight>
+Distances(katana::PropertyGraph* pg, SsspPlan plan) {
+  auto res = katana::analytics::Sssp(pg, 0, "weight", "distance", plan);
+  KATANA_LOG_VASSERT(res, "sssp failed: {}", res.error());
+  auto array = pg->GetNodePropertyTyped<Weight>("distance").value();
+  std::vector<Weight> distances(
+      array->raw_values(), array->raw_values() + array->length());
+  auto remove_res = pg->RemoveNodeProperty("distance");
+  KATANA_LOG_VASSERT(remove_res, "remove failed: {}", remove_res.error());
+  return distances;
+}
+
+/// Delta-stepping with a fixed delta, which keeps one request per node per
+/// bucket, finds the same distances as Dijkstra over long paths
+void
+TestDeltaStep() {
+  RandomPolicy random{4};
+  auto pg = MakeFileGraph<int64_t>(2000, 0, &random);
+  AddWeights(pg.get());
+
+  katana::setActiveThreads(1);
+  std::vector<Weight> expected = Distances(pg.get(), SsspPlan::Dijkstra());
+  for (unsigned threads : {1, 4}) {
+    katana::setActiveThreads(threads);
+    for (SsspPlan plan :
+         {SsspPlan::DeltaStep(2), SsspPlan::DeltaStep(),
+          SsspPlan::DeltaStepBarrier(2)}) {
+      KATANA_LOG_VASSERT(
+          Distances(pg.get(), plan) == expected,
+          "distances of delta {} differ with {} threads", plan.delta(),
+          threads);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestFarItems(1);
+  TestFarItems(4);
+  TestDeltaStep();
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SegmentedTopology.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "katana/analytics/OutOfCore.h"
+
+namespace fs = boost::filesystem;
+
+using katana::analytics::kOutOfCoreUnreached;
+
+std::vector<uint32_t>
+ExpectedBfs(const katana::GraphTopology& topology, uint32_t source) {
+  std::vector<uint32_t> levels(topology.num_nodes(), kOutOfCoreUnreached);
+  std::queue<uint32_t> queue;
+  levels[source] = 0;
+  queue.push(source);
+  while (!queue.empty()) {
+    uint32_t n = queue.front();
+    queue.pop();
+    for (auto e : topology.edges(n)) {
+      uint32_t dst = topology.edge_dest(e);
+      if (levels[dst] == kOutOfCoreUnreached) {
+        levels[dst] = levels[n] + 1;
+        queue.push(dst);
+      }
+    }
+  }
+  return levels;
+}
+
+/// The least node of the weakly connected component of each node
+std::vector<uint32_t>
+ExpectedComponents(const katana::GraphTopology& topology) {
+  std::vector<uint32_t> parents(topology.num_nodes());
+  std::iota(parents.begin(), parents.end(), 0);
+  auto find = [&](uint32_t n) {
+    while (parents[n] != n) {
+      n = parents[n] = parents[parents[n]];
+    }
+    return n;
+  };
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    for (auto e : topology.edges(n)) {
+      uint32_t a = find(n);
+      uint32_t b = find(topology.edge_dest(e));
+      parents[std::max(a, b)] = std::min(a, b);
+    }
+  }
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    parents[n] = find(n);
+  }
+  return parents;
+}
+
+std::vector<double>
+ExpectedPagerank(
+    const katana::GraphTopology& topology,
+    const katana::analytics::OutOfCorePagerankPlan& plan) {
+  uint64_t num_nodes = topology.num_nodes();
+  std::vector<double> ranks(num_nodes, 1.0 / num_nodes);
+  for (uint32_t iter = 0; iter < plan.max_iterations; ++iter) {
+    std::vector<double> sums(num_nodes, 0);
+    double dangling = 0;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      auto edges = topology.edges(n);
+      if (edges.empty()) {
+        dangling += ranks[n];
+      }
+      for (auto e : edges) {
+        sums[topology.edge_dest(e)] += ranks[n] / edges.size();
+      }
+    }
+    double change = 0;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      double rank = (1 - plan.alpha) / num_nodes +
+                    plan.alpha * (sums[n] + dangling / num_nodes);
+      change += std::fabs(rank - ranks[n]);
+      ranks[n] = rank;
+    }
+    if (change < plan.tolerance) {
+      break;
+    }
+  }
+  return ranks;
+}
+
+void
+TestOutOfCore(
+    size_t num_nodes, Policy* policy, uint64_t segment_bytes,
+    size_t min_segments) {
+  auto pg = MakeFileGraph<uint32_t>(num_nodes, 0, policy);
+  const katana::GraphTopology& topology = pg->topology();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/outofcore");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = pg->Write(rdg_dir, "out-of-core"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing graph: {}", res.error());
+  }
+
+  auto topology_res = katana::SegmentedTopology::Make(rdg_dir, segment_bytes);
+  if (!topology_res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("opening topology: {}", topology_res.error());
+  }
+  katana::SegmentedTopology segmented = std::move(topology_res.value());
+  KATANA_LOG_ASSERT(segmented.num_nodes() == topology.num_nodes());
+  KATANA_LOG_ASSERT(segmented.num_edges() == topology.num_edges());
+  KATANA_LOG_VASSERT(
+      segmented.segments().size() >= min_segments, "{} segments",
+      segmented.segments().size());
+
+  // The segments cover the nodes in order, and every edge is read
+  uint32_t next = 0;
+  for (const auto& segment : segmented.segments()) {
+    KATANA_LOG_ASSERT(segment.begin == next && segment.end > segment.begin);
+    KATANA_LOG_ASSERT(
+        segmented.segment_of(segment.begin) ==
+        segmented.segment_of(segment.end - 1));
+    next = segment.end;
+  }
+  KATANA_LOG_ASSERT(next == num_nodes);
+  auto check_edges = [&](const katana::SegmentedTopology::Segment& segment) {
+    for (uint32_t n = segment.begin; n < segment.end; ++n) {
+      for (auto e : segmented.edges(n)) {
+        KATANA_LOG_ASSERT(segmented.edge_dest(e) == topology.edge_dest(e));
+      }
+    }
+  };
+  auto scan_res = katana::ForEachSegment(&segmented, check_edges);
+  KATANA_LOG_ASSERT(scan_res);
+
+  auto bfs_res = katana::analytics::OutOfCoreBfs(&segmented, 0);
+  KATANA_LOG_ASSERT(bfs_res);
+  std::vector<uint32_t> expected_levels = ExpectedBfs(topology, 0);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_VASSERT(
+        bfs_res.value()[n] == expected_levels[n], "level of {}: {} != {}", n,
+        bfs_res.value()[n], expected_levels[n]);
+  }
+
+  auto cc_res = katana::analytics::OutOfCoreConnectedComponents(&segmented);
+  KATANA_LOG_ASSERT(cc_res);
+  std::vector<uint32_t> expected_components = ExpectedComponents(topology);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_VASSERT(
+        cc_res.value()[n] == expected_components[n], "component of {}", n);
+  }
+
+  katana::analytics::OutOfCorePagerankPlan plan;
+  plan.max_iterations = 20;
+  auto pr_res = katana::analytics::OutOfCorePagerank(&segmented, plan);
+  KATANA_LOG_ASSERT(pr_res);
+  std::vector<double> expected_ranks = ExpectedPagerank(topology, plan);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_VASSERT(
+        std::fabs(pr_res.value()[n] - expected_ranks[n]) <
+            1e-3 * expected_ranks[n] + 1e-7,
+        "rank of {}: {} != {}", n, pr_res.value()[n], expected_ranks[n]);
+  }
+
+  fs::remove_all(rdg_dir);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  // Many small segments, most of which a traversal of the line skips
+  LinePolicy line{1};
+  TestOutOfCore(1000, &line, 256, 10);
+
+  // Segments of whole pages of storage, which are evicted
+  RandomPolicy random{16};
+  TestOutOfCore(1 << 17, &random, 1 << 20, 4);
+
+  return 0;
+}
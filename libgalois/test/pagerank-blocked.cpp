@@ -0,0 +1,65 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using DataType = int64_t;
+using katana::analytics::PagerankPlan;
+
+constexpr float kTolerance = 1.0e-7;
+
+void
+TestBlocked(size_t num_nodes, Policy* policy) {
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, policy);
+
+  auto res = katana::analytics::Pagerank(
+      g.get(), "expected", PagerankPlan::PullTopological(kTolerance));
+  KATANA_LOG_VASSERT(res, "pagerank failed: {}", res.error());
+  std::vector<float> expected = Ranks(g.get(), "expected");
+
+  // One node per segment, some segments, and a single segment
+  for (uint32_t segment_size :
+       {uint32_t{1}, uint32_t{64}, PagerankPlan::kDefaultSegmentSize}) {
+    std::string name = "rank-" + std::to_string(segment_size);
+    res = katana::analytics::Pagerank(
+        g.get(), name,
+        PagerankPlan::PullBlocked(
+            kTolerance, PagerankPlan::kDefaultMaxIterations,
+            PagerankPlan::kDefaultAlpha, segment_size));
+    KATANA_LOG_VASSERT(res, "blocked pagerank failed: {}", res.error());
+
+    std::vector<float> actual = Ranks(g.get(), name);
+    for (size_t n = 0; n < num_nodes; ++n) {
+      KATANA_LOG_VASSERT(
+          std::abs(actual[n] - expected[n]) <= 1.0e-3 * expected[n],
+          "segment size {} node {}: expected {} found {}", segment_size, n,
+          expected[n], actual[n]);
+    }
+  }
+
+  res = katana::analytics::Pagerank(
+      g.get(), "bad",
+      PagerankPlan::PullBlocked(
+          kTolerance, PagerankPlan::kDefaultMaxIterations,
+          PagerankPlan::kDefaultAlpha, 0));
+  KATANA_LOG_ASSERT(!res);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy line{2};
+  TestBlocked(100, &line);
+
+  RandomPolicy random{4};
+  TestBlocked(1000, &random);
+
+  return 0;
+}
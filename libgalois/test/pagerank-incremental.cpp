@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using DataType = int64_t;
+using katana::analytics::PagerankEdgeChanges;
+using katana::analytics::PagerankPlan;
+
+constexpr float kTolerance = 1.0e-6;
+
+/// Random-ish graph whose edges can be perturbed deterministically
+class ChangingPolicy : public Policy {
+  bool changed_;
+
+public:
+  ChangingPolicy(bool changed) : changed_(changed) {}
+
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    for (size_t k = 1; k <= node_id % 4; ++k) {
+      r.push_back((node_id * 7 + k * 13) % num_nodes);
+    }
+    if (changed_) {
+      if (node_id % 10 == 0 && !r.empty()) {
+        r.pop_back();
+      }
+      if (node_id % 7 == 0) {
+        r.push_back((node_id + 1) % num_nodes);
+      }
+    }
+    std::sort(r.begin(), r.end());
+    return r;
+  }
+};
+
+void
+TestIncremental(size_t num_nodes, PagerankPlan plan) {
+  ChangingPolicy old_policy{false};
+  ChangingPolicy new_policy{true};
+  auto old_graph = MakeFileGraph<DataType>(num_nodes, 0, &old_policy);
+  auto new_graph = MakeFileGraph<DataType>(num_nodes, 0, &new_policy);
+
+  PagerankEdgeChanges changes;
+  for (size_t n = 0; n < num_nodes; ++n) {
+    auto before = old_policy.GenerateNeighbors(n, num_nodes);
+    auto after = new_policy.GenerateNeighbors(n, num_nodes);
+    std::vector<uint32_t> diff;
+    std::set_difference(
+        after.begin(), after.end(), before.begin(), before.end(),
+        std::back_inserter(diff));
+    for (auto d : diff) {
+      changes.inserted.emplace_back(n, d);
+    }
+    diff.clear();
+    std::set_difference(
+        before.begin(), before.end(), after.begin(), after.end(),
+        std::back_inserter(diff));
+    for (auto d : diff) {
+      changes.deleted.emplace_back(n, d);
+    }
+  }
+  KATANA_LOG_ASSERT(!changes.inserted.empty() && !changes.deleted.empty());
+
+  auto res = katana::analytics::Pagerank(old_graph.get(), "rank", plan);
+  KATANA_LOG_VASSERT(res, "pagerank failed: {}", res.error());
+
+  std::vector<float> old_ranks = Ranks(old_graph.get(), "rank");
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("rank", arrow::float32())}),
+      {katana::BuildArray(old_ranks)});
+  auto add_res = new_graph->AddNodeProperties(table);
+  KATANA_LOG_VASSERT(add_res, "could not add ranks: {}", add_res.error());
+
+  res = katana::analytics::PagerankIncremental(
+      new_graph.get(), "rank", changes, plan);
+  KATANA_LOG_VASSERT(res, "incremental pagerank failed: {}", res.error());
+
+  res = katana::analytics::Pagerank(new_graph.get(), "expected", plan);
+  KATANA_LOG_VASSERT(res, "pagerank failed: {}", res.error());
+
+  std::vector<float> actual = Ranks(new_graph.get(), "rank");
+  std::vector<float> expected = Ranks(new_graph.get(), "expected");
+  for (size_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(actual[n] - expected[n]) < 1.0e-3,
+        "node {}: expected {} found {}", n, expected[n], actual[n]);
+  }
+
+  // An edge that is not between nodes of the graph is rejected
+  PagerankEdgeChanges bad;
+  bad.inserted.emplace_back(num_nodes, 0);
+  res = katana::analytics::PagerankIncremental(
+      new_graph.get(), "rank", bad, plan);
+  KATANA_LOG_ASSERT(!res);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestIncremental(1000, PagerankPlan::PushAsynchronous(kTolerance));
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using DataType = int64_t;
+using katana::analytics::PagerankPlan;
+
+constexpr float kTolerance = 1.0e-7;
+
+/// Personalized Page Rank by power iteration, restarting at the seeds. Rank
+/// that reaches a node without out-edges is dropped, as in Pagerank.
+std::vector<double>
+SerialPersonalized(
+    const katana::GraphTopology& topology, const std::vector<uint32_t>& seeds,
+    const PagerankPlan& plan) {
+  size_t num_nodes = topology.num_nodes();
+  std::vector<double> restart(num_nodes);
+  for (auto s : seeds) {
+    restart[s] += plan.initial_residual() / seeds.size();
+  }
+  std::vector<double> rank = restart;
+  for (size_t iter = 0; iter < 200; ++iter) {
+    std::vector<double> next = restart;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      size_t degree = topology.edges(n).size();
+      for (auto e : topology.edges(n)) {
+        next[topology.edge_dest(e)] += plan.alpha() * rank[n] / degree;
+      }
+    }
+    rank.swap(next);
+  }
+  return rank;
+}
+
+void
+TestPersonalized(size_t num_nodes, Policy* policy) {
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, policy);
+  PagerankPlan plan = PagerankPlan::PushAsynchronous(kTolerance);
+
+  // More seed sets than fit in a batch, with an empty one and a repeated seed
+  std::vector<std::vector<uint32_t>> seed_sets;
+  std::vector<std::string> names;
+  for (uint32_t i = 0; i < 20; ++i) {
+    seed_sets.push_back({(i * 37) % uint32_t(num_nodes)});
+    if (i % 3 == 0) {
+      seed_sets.back().push_back((i * 11 + 5) % uint32_t(num_nodes));
+    }
+    names.push_back("ppr-" + std::to_string(i));
+  }
+  seed_sets[5].clear();
+  seed_sets[7].push_back(seed_sets[7].front());
+
+  auto res =
+      katana::analytics::PagerankPersonalized(g.get(), seed_sets, names, plan);
+  KATANA_LOG_VASSERT(res, "personalized pagerank failed: {}", res.error());
+
+  for (size_t i = 0; i < seed_sets.size(); ++i) {
+    auto prop_res = g->GetNodePropertyTyped<float>(names[i]);
+    KATANA_LOG_VASSERT(prop_res, "no property {}", names[i]);
+    auto actual = prop_res.value();
+    std::vector<double> expected =
+        SerialPersonalized(g->topology(), seed_sets[i], plan);
+    for (size_t n = 0; n < num_nodes; ++n) {
+      KATANA_LOG_VASSERT(
+          std::abs(actual->Value(n) - expected[n]) < 1.0e-4,
+          "seed set {} node {}: expected {} found {}", i, n, expected[n],
+          actual->Value(n));
+    }
+  }
+
+  // Mismatched outputs and seeds that are not nodes are rejected
+  res = katana::analytics::PagerankPersonalized(
+      g.get(), seed_sets, {"bad"}, plan);
+  KATANA_LOG_ASSERT(!res);
+  res = katana::analytics::PagerankPersonalized(
+      g.get(), {{uint32_t(num_nodes)}}, {"bad"}, plan);
+  KATANA_LOG_ASSERT(!res);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy line{2};
+  TestPersonalized(100, &line);
+
+  RandomPolicy random{4};
+  TestPersonalized(1000, &random);
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/BFloat16.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using DataType = int64_t;
+using katana::analytics::PagerankPlan;
+
+constexpr float kTolerance = 1.0e-7;
+
+void
+TestBFloat16() {
+  for (float value : {0.0f, 1.0f, -2.5f, 1.0e-30f, 3.0e30f}) {
+    KATANA_LOG_VASSERT(
+        static_cast<float>(katana::BFloat16(value)) == value, "{} changed",
+        value);
+  }
+  // 1 + 2^-8 is halfway between 1 and the next bfloat16, 1 + 2^-7; ties go
+  // to the even one
+  KATANA_LOG_ASSERT(
+      static_cast<float>(katana::BFloat16(1.0f + 0x1p-8f)) == 1.0f);
+  KATANA_LOG_ASSERT(
+      static_cast<float>(katana::BFloat16(1.0f + 0x1p-7f + 0x1p-8f)) ==
+      1.0f + 0x1p-6f);
+  for (float value : {0.1f, 1.0f / 3, 1.0e-9f}) {
+    float rounded = katana::BFloat16(value);
+    KATANA_LOG_VASSERT(
+        std::abs(rounded - value) <= 0x1p-8f * value, "{} rounded to {}",
+        value, rounded);
+  }
+  KATANA_LOG_ASSERT(std::isnan(static_cast<float>(katana::BFloat16(NAN))));
+}
+
+void
+TestPrecision(size_t num_nodes, Policy* policy) {
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, policy);
+
+  auto res = katana::analytics::Pagerank(
+      g.get(), "expected", PagerankPlan::PullTopological(kTolerance));
+  KATANA_LOG_VASSERT(res, "pagerank failed: {}", res.error());
+  std::vector<float> expected = Ranks(g.get(), "expected");
+
+  std::vector<std::pair<std::string, PagerankPlan>> plans{
+      {"topological",
+       PagerankPlan::PullTopological(
+           kTolerance, PagerankPlan::kDefaultMaxIterations,
+           PagerankPlan::kDefaultAlpha, PagerankPlan::kBFloat16)},
+      {"blocked",
+       PagerankPlan::PullBlocked(
+           kTolerance, PagerankPlan::kDefaultMaxIterations,
+           PagerankPlan::kDefaultAlpha, 64, PagerankPlan::kBFloat16)},
+  };
+  for (const auto& [name, plan] : plans) {
+    res = katana::analytics::Pagerank(g.get(), name, plan);
+    KATANA_LOG_VASSERT(res, "{} pagerank failed: {}", name, res.error());
+
+    std::vector<float> actual = Ranks(g.get(), name);
+    for (size_t n = 0; n < num_nodes; ++n) {
+      KATANA_LOG_VASSERT(
+          std::abs(actual[n] - expected[n]) <= 1.0e-3 * expected[n],
+          "{} node {}: expected {} found {}", name, n, expected[n], actual[n]);
+    }
+  }
+
+  PagerankPlan residual{
+      katana::analytics::kCPU,
+      PagerankPlan::kPullResidual,
+      kTolerance,
+      PagerankPlan::kDefaultMaxIterations,
+      PagerankPlan::kDefaultAlpha,
+      PagerankPlan::kDefaultSegmentSize,
+      PagerankPlan::kBFloat16};
+  res = katana::analytics::Pagerank(g.get(), "bad", residual);
+  KATANA_LOG_ASSERT(!res);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestBFloat16();
+
+  LinePolicy line{2};
+  TestPrecision(100, &line);
+
+  RandomPolicy random{4};
+  TestPrecision(1000, &random);
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <arrow/builder.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+
+using Edge = std::pair<uint32_t, uint32_t>;
+
+std::vector<Edge>
+MakeEdges(size_t size, uint32_t num_nodes) {
+  std::mt19937 gen(size);
+  std::uniform_int_distribution<uint32_t> dist(0, num_nodes - 1);
+  std::vector<Edge> edges(size);
+  for (auto& [src, dst] : edges) {
+    src = dist(gen);
+    dst = dist(gen);
+  }
+  return edges;
+}
+
+void
+TestRadixSort(size_t size) {
+  std::vector<Edge> edges = MakeEdges(size, 1000);
+
+  std::vector<int64_t> keys(size);
+  for (size_t i = 0; i < size; ++i) {
+    // Include negative keys and keys that differ in the high bits only
+    keys[i] = (int64_t{edges[i].first} - 500) *
+              (int64_t{1} << (edges[i].second % 40));
+  }
+  std::vector<int64_t> expected_keys = keys;
+  std::sort(expected_keys.begin(), expected_keys.end());
+  katana::ParallelSTL::radix_sort(keys.begin(), keys.end());
+  KATANA_LOG_ASSERT(keys == expected_keys);
+
+  // Sorting by source only must keep the destinations of each source in
+  // their original order
+  std::vector<Edge> expected = edges;
+  std::stable_sort(
+      expected.begin(), expected.end(),
+      [](const Edge& a, const Edge& b) { return a.first < b.first; });
+  std::vector<Edge> by_src = edges;
+  katana::ParallelSTL::radix_sort(
+      by_src.begin(), by_src.end(), [](const Edge& e) { return e.first; });
+  KATANA_LOG_ASSERT(by_src == expected);
+
+  std::vector<uint32_t> srcs(size);
+  std::vector<uint32_t> dsts(size);
+  for (size_t i = 0; i < size; ++i) {
+    std::tie(srcs[i], dsts[i]) = edges[i];
+  }
+  katana::ParallelSTL::radix_sort_by_key(
+      srcs.begin(), srcs.end(), dsts.begin());
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_VASSERT(
+        Edge(srcs[i], dsts[i]) == expected[i], "edge {} is ({}, {})", i,
+        srcs[i], dsts[i]);
+  }
+}
+
+void
+TestStableSort(size_t size) {
+  std::vector<Edge> edges = MakeEdges(size, 100);
+  auto by_dst = [](const Edge& a, const Edge& b) {
+    return a.second < b.second;
+  };
+
+  std::vector<Edge> expected = edges;
+  std::stable_sort(expected.begin(), expected.end(), by_dst);
+  katana::ParallelSTL::stable_sort(edges.begin(), edges.end(), by_dst);
+  KATANA_LOG_ASSERT(edges == expected);
+
+  std::sort(expected.begin(), expected.end());
+  katana::ParallelSTL::stable_sort(edges.begin(), edges.end());
+  KATANA_LOG_ASSERT(edges == expected);
+}
+
+void
+TestArrowSort(size_t size) {
+  std::vector<Edge> edges = MakeEdges(size, 1000);
+
+  arrow::UInt32Builder src_builder;
+  arrow::UInt32Builder dst_builder;
+  for (const auto& [src, dst] : edges) {
+    KATANA_LOG_ASSERT(src_builder.Append(src).ok());
+    KATANA_LOG_ASSERT(dst_builder.Append(dst).ok());
+  }
+  std::shared_ptr<arrow::UInt32Array> srcs;
+  std::shared_ptr<arrow::UInt32Array> dsts;
+  KATANA_LOG_ASSERT(src_builder.Finish(&srcs).ok());
+  KATANA_LOG_ASSERT(dst_builder.Finish(&dsts).ok());
+
+  std::vector<Edge> expected = edges;
+  std::stable_sort(
+      expected.begin(), expected.end(),
+      [](const Edge& a, const Edge& b) { return a.first < b.first; });
+
+  auto sorted_res = katana::ParallelSTL::radix_sort(*srcs);
+  KATANA_LOG_ASSERT(sorted_res);
+  auto stable_res =
+      katana::ParallelSTL::stable_sort(*srcs, std::greater<uint32_t>());
+  KATANA_LOG_ASSERT(stable_res);
+  auto pairs_res = katana::ParallelSTL::radix_sort_by_key(*srcs, *dsts);
+  KATANA_LOG_ASSERT(pairs_res);
+  auto [sorted_srcs, sorted_dsts] = pairs_res.value();
+
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_ASSERT(sorted_res.value()->Value(i) == expected[i].first);
+    KATANA_LOG_ASSERT(
+        stable_res.value()->Value(i) == expected[size - i - 1].first);
+    KATANA_LOG_ASSERT(sorted_srcs->Value(i) == expected[i].first);
+    KATANA_LOG_ASSERT(sorted_dsts->Value(i) == expected[i].second);
+  }
+  // The input is not modified
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_ASSERT(srcs->Value(i) == edges[i].first);
+  }
+
+  KATANA_LOG_ASSERT(src_builder.AppendNull().ok());
+  std::shared_ptr<arrow::UInt32Array> with_null;
+  KATANA_LOG_ASSERT(src_builder.Finish(&with_null).ok());
+  KATANA_LOG_ASSERT(!katana::ParallelSTL::radix_sort(*with_null));
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  for (size_t size : {0, 1, 1000, 100000, 1000003}) {
+    TestRadixSort(size);
+    TestStableSort(size);
+  }
+  TestArrowSort(100000);
+
+  return 0;
+}
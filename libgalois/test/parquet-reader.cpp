@@ -0,0 +1,96 @@
+#include <string>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+std::shared_ptr<arrow::Table>
+MakeTable(int64_t num_rows) {
+  arrow::Int64Builder ints;
+  arrow::LargeStringBuilder strings;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    KATANA_LOG_ASSERT(ints.Append(i * 3).ok());
+    if (i % 5 == 0) {
+      KATANA_LOG_ASSERT(strings.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(strings.Append(std::to_string(i)).ok());
+    }
+  }
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("ints", arrow::int64()),
+           arrow::field("strings", arrow::large_utf8())}),
+      {ints.Finish().ValueOrDie(), strings.Finish().ValueOrDie()});
+}
+
+/// Files of many row groups decode the same with any number of tasks, into
+/// unchunked columns
+void
+TestParallelDecode(const katana::Uri& dir) {
+  constexpr int64_t kNumRows = 1050;
+  std::shared_ptr<arrow::Table> table = MakeTable(kNumRows);
+
+  tsuba::ParquetWriter::WriteOpts write_opts;
+  write_opts.rows_per_row_group = 100;
+  auto writer_res = tsuba::ParquetWriter::Make(table, write_opts);
+  KATANA_LOG_ASSERT(writer_res);
+  katana::Uri file = dir.Join("many-row-groups");
+  auto res = writer_res.value()->WriteToUri(file);
+  KATANA_LOG_VASSERT(res, "writing {}: {}", file, res.error());
+
+  for (uint32_t num_threads : {1, 2, 3, 11, 64}) {
+    tsuba::ParquetReader::ReadOpts read_opts;
+    read_opts.num_threads = num_threads;
+    auto reader_res = tsuba::ParquetReader::Make(read_opts);
+    KATANA_LOG_ASSERT(reader_res);
+    auto read_res = reader_res.value()->ReadTable(file);
+    KATANA_LOG_VASSERT(
+        read_res, "reading with {} threads: {}", num_threads,
+        read_res.error());
+    std::shared_ptr<arrow::Table> read = read_res.value();
+    KATANA_LOG_ASSERT(read->num_rows() == kNumRows);
+    for (int c = 0; c < read->num_columns(); ++c) {
+      KATANA_LOG_ASSERT(read->column(c)->num_chunks() == 1);
+      KATANA_LOG_VASSERT(
+          read->column(c)->Equals(table->column(c)),
+          "column {} differs with {} threads", c, num_threads);
+    }
+  }
+
+  // An empty file has no row groups to split
+  auto empty_res = tsuba::ParquetWriter::Make(MakeTable(0), write_opts);
+  KATANA_LOG_ASSERT(empty_res);
+  katana::Uri empty = dir.Join("empty");
+  KATANA_LOG_ASSERT(empty_res.value()->WriteToUri(empty));
+  tsuba::ParquetReader::ReadOpts read_opts;
+  read_opts.num_threads = 4;
+  auto reader_res = tsuba::ParquetReader::Make(read_opts);
+  KATANA_LOG_ASSERT(reader_res);
+  auto read_res = reader_res.value()->ReadTable(empty);
+  KATANA_LOG_ASSERT(read_res && read_res.value()->num_rows() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/parquetreader");
+  KATANA_LOG_ASSERT(uri_res);
+  fs::create_directories(uri_res.value().path());
+
+  TestParallelDecode(uri_res.value());
+
+  fs::remove_all(uri_res.value().path());
+  return 0;
+}
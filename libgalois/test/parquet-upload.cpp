@@ -0,0 +1,332 @@
+#include <cstring>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// Enough rows of int64 for a table past the size that is streamed into an
+/// upload, which is 64 MiB
+constexpr int64_t kLargeRows = 10 << 20;
+
+/// Objects in memory, under mem://, optionally with multipart uploads whose
+/// parts can be made to fail
+class MemStorage : public tsuba::FileStorage {
+public:
+  struct UploadLog {
+    uint32_t parts{0};
+    bool completed{false};
+    bool aborted{false};
+  };
+
+  MemStorage() : FileStorage("mem://") {}
+
+  void Reset(bool multipart) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    multipart_ = multipart;
+    objects_.clear();
+    whole_puts_ = 0;
+    uploads_.clear();
+    failing_part_ = -1;
+  }
+
+  /// Make every put of part fail
+  void FailPart(int64_t part) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failing_part_ = part;
+  }
+
+  bool Exists(const std::string& uri) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return objects_.count(uri) > 0;
+  }
+  uint32_t whole_puts() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return whole_puts_;
+  }
+  std::vector<UploadLog> uploads() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return uploads_;
+  }
+
+  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+
+  katana::Result<void> Stat(
+      const std::string& uri, tsuba::StatBuf* s_buf) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = objects_.find(uri);
+    if (it == objects_.end()) {
+      return KATANA_ERROR(tsuba::ErrorCode::NotFound, "no object {}", uri);
+    }
+    s_buf->size = it->second.size();
+    s_buf->version = "1";
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = objects_.find(uri);
+    if (it == objects_.end() || start + size > it->second.size()) {
+      return KATANA_ERROR(tsuba::ErrorCode::NotFound, "no range of {}", uri);
+    }
+    std::memcpy(result_buf, it->second.data() + start, size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    whole_puts_ += 1;
+    objects_[uri].assign(data, data + size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string&, const std::string&, uint64_t, uint64_t) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+  std::future<katana::Result<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    return std::async(std::launch::deferred, [=]() {
+      return PutMultiSync(uri, data, size);
+    });
+  }
+
+  std::future<katana::Result<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return std::async(std::launch::deferred, [=]() {
+      return GetMultiSync(uri, start, size, result_buf);
+    });
+  }
+
+  std::future<katana::Result<void>> ListAsync(
+      const std::string&, std::vector<std::string>*,
+      std::vector<uint64_t>*) override {
+    return std::async(std::launch::deferred, []() -> katana::Result<void> {
+      return tsuba::ErrorCode::NotImplemented;
+    });
+  }
+
+  katana::Result<void> Delete(
+      const std::string&, const std::unordered_set<std::string>&) override {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+  katana::Result<std::unique_ptr<tsuba::MultipartUpload>> StartMultipartUpload(
+      const std::string& uri, uint64_t part_size) override;
+
+private:
+  class Upload;
+
+  std::mutex mutex_;
+  bool multipart_{true};
+  std::map<std::string, std::vector<uint8_t>> objects_;
+  uint32_t whole_puts_{0};
+  std::vector<UploadLog> uploads_;
+  int64_t failing_part_{-1};
+};
+
+class MemStorage::Upload : public tsuba::MultipartUpload {
+public:
+  Upload(MemStorage* storage, std::string uri, size_t log)
+      : storage_(storage), uri_(std::move(uri)), log_(log) {}
+
+  std::future<katana::Result<void>> PutPartAsync(
+      uint32_t part, const uint8_t* data, uint64_t size) override {
+    return std::async(
+        std::launch::deferred, [=]() -> katana::Result<void> {
+          std::lock_guard<std::mutex> lock(storage_->mutex_);
+          if (part == storage_->failing_part_) {
+            return KATANA_ERROR(
+                tsuba::ErrorCode::TODO, "injected failure of part {}", part);
+          }
+          if (parts_[part].empty()) {
+            storage_->uploads_[log_].parts += 1;
+          }
+          parts_[part].assign(data, data + size);
+          return katana::ResultSuccess();
+        });
+  }
+
+  katana::Result<void> Complete() override {
+    std::lock_guard<std::mutex> lock(storage_->mutex_);
+    std::vector<uint8_t>& object = storage_->objects_[uri_];
+    object.clear();
+    for (const auto& [part, data] : parts_) {
+      object.insert(object.end(), data.begin(), data.end());
+    }
+    storage_->uploads_[log_].completed = true;
+    return katana::ResultSuccess();
+  }
+
+  void Abort() override {
+    std::lock_guard<std::mutex> lock(storage_->mutex_);
+    storage_->uploads_[log_].aborted = true;
+    parts_.clear();
+  }
+
+private:
+  MemStorage* storage_;
+  std::string uri_;
+  size_t log_;
+  std::map<uint32_t, std::vector<uint8_t>> parts_;
+};
+
+katana::Result<std::unique_ptr<tsuba::MultipartUpload>>
+MemStorage::StartMultipartUpload(const std::string& uri, uint64_t) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!multipart_) {
+    return std::unique_ptr<tsuba::MultipartUpload>();
+  }
+  uploads_.emplace_back();
+  return std::unique_ptr<tsuba::MultipartUpload>(
+      std::make_unique<Upload>(this, uri, uploads_.size() - 1));
+}
+
+MemStorage storage;
+
+/// A table of values that neither compress nor fit a dictionary, so that
+/// its encoding is about as large as the table
+std::shared_ptr<arrow::Table>
+MakeLargeTable() {
+  arrow::Int64Builder builder;
+  KATANA_LOG_ASSERT(builder.Reserve(kLargeRows).ok());
+  uint64_t state = 88172645463325252ULL;
+  for (int64_t i = 0; i < kLargeRows; ++i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    builder.UnsafeAppend(static_cast<int64_t>(state));
+  }
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("values", arrow::int64())}),
+      {builder.Finish().ValueOrDie()});
+}
+
+katana::Result<void>
+Write(const std::shared_ptr<arrow::Table>& table, const std::string& uri) {
+  auto writer_res = tsuba::ParquetWriter::Make(table);
+  if (!writer_res) {
+    return writer_res.error();
+  }
+  auto uri_res = katana::Uri::Make(uri);
+  if (!uri_res) {
+    return uri_res.error();
+  }
+  return writer_res.value()->WriteToUri(uri_res.value());
+}
+
+void
+CheckReadsAs(
+    const std::string& uri, const std::shared_ptr<arrow::Table>& table) {
+  auto reader_res = tsuba::ParquetReader::Make();
+  KATANA_LOG_ASSERT(reader_res);
+  auto uri_res = katana::Uri::Make(uri);
+  KATANA_LOG_ASSERT(uri_res);
+  auto read_res = reader_res.value()->ReadTable(uri_res.value());
+  KATANA_LOG_VASSERT(read_res, "reading {}: {}", uri, read_res.error());
+  KATANA_LOG_VASSERT(
+      read_res.value()->Equals(*table), "{} does not read as written", uri);
+}
+
+/// Large tables are encoded into the parts of an upload as they fill, or
+/// stored whole if their storage has no multipart uploads
+void
+TestUpload(const std::shared_ptr<arrow::Table>& table) {
+  storage.Reset(true);
+  std::string uri = "mem://bucket/streamed.parquet";
+  auto res = Write(table, uri);
+  KATANA_LOG_VASSERT(res, "writing {}: {}", uri, res.error());
+  KATANA_LOG_ASSERT(storage.whole_puts() == 0);
+  std::vector<MemStorage::UploadLog> uploads = storage.uploads();
+  KATANA_LOG_ASSERT(uploads.size() == 1);
+  KATANA_LOG_VASSERT(
+      uploads[0].parts > 1, "{} was put as {} parts", uri, uploads[0].parts);
+  KATANA_LOG_ASSERT(uploads[0].completed && !uploads[0].aborted);
+  CheckReadsAs(uri, table);
+
+  storage.Reset(false);
+  uri = "mem://bucket/whole.parquet";
+  res = Write(table, uri);
+  KATANA_LOG_VASSERT(res, "writing {}: {}", uri, res.error());
+  KATANA_LOG_ASSERT(storage.whole_puts() == 1);
+  KATANA_LOG_ASSERT(storage.uploads().empty());
+  CheckReadsAs(uri, table);
+}
+
+/// A part that keeps failing fails the write and aborts the upload
+void
+TestFailedUpload(const std::shared_ptr<arrow::Table>& table) {
+  storage.Reset(true);
+  storage.FailPart(1);
+  std::string uri = "mem://bucket/failed.parquet";
+  KATANA_LOG_ASSERT(!Write(table, uri));
+  KATANA_LOG_ASSERT(!storage.Exists(uri));
+  std::vector<MemStorage::UploadLog> uploads = storage.uploads();
+  KATANA_LOG_ASSERT(uploads.size() == 1);
+  KATANA_LOG_ASSERT(uploads[0].aborted && !uploads[0].completed);
+}
+
+/// Local files are uploaded into a temporary file that replaces the file
+/// once it is complete
+void
+TestLocal(const std::shared_ptr<arrow::Table>& table) {
+  auto uri_res = katana::Uri::MakeRand("/tmp/parquetupload");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());
+  fs::create_directories(dir);
+
+  std::string file = dir + "/large.parquet";
+  auto res = Write(table, file);
+  KATANA_LOG_VASSERT(res, "writing {}: {}", file, res.error());
+  CheckReadsAs(file, table);
+  std::vector<std::string> names;
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    names.emplace_back(entry.path().filename().string());
+  }
+  KATANA_LOG_VASSERT(
+      names == std::vector<std::string>{"large.parquet"},
+      "{} holds {} files", dir, names.size());
+
+  fs::remove_all(dir);
+}
+
+}  // namespace
+
+int
+main() {
+  // Backends are registered before tsuba starts
+  tsuba::RegisterFileStorage(&storage);
+  katana::SharedMemSys sys;
+
+  std::shared_ptr<arrow::Table> table = MakeLargeTable();
+  TestUpload(table);
+  TestFailedUpload(table);
+  TestLocal(table);
+
+  return 0;
+}
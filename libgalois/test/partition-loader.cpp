@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/CommBackend.h"
+#include "katana/Logging.h"
+#include "katana/MirrorSync.h"
+#include "katana/PartitionLoader.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+using katana::PartitionLoadOptions;
+
+namespace {
+
+using Parts = std::vector<std::unique_ptr<katana::PropertyGraph>>;
+
+/// The partitions of rdg_dir for num_hosts hosts, loaded in one process by
+/// handing each loader the lists of mirrors of the others
+Parts
+LoadPartitions(
+    const std::string& rdg_dir, uint32_t num_hosts,
+    const PartitionLoadOptions& options) {
+  std::vector<katana::PartitionLoader> loaders;
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    auto res = katana::PartitionLoader::Read(rdg_dir, h, num_hosts, options);
+    KATANA_LOG_VASSERT(res, "reading partition {}: {}", h, res.error());
+    loaders.emplace_back(std::move(res.value()));
+  }
+
+  Parts parts;
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    std::vector<std::vector<uint64_t>> mirrored;
+    for (uint32_t other = 0; other < num_hosts; ++other) {
+      mirrored.emplace_back(loaders[other].mirrors()[h]);
+    }
+    auto res = loaders[h].Finish(mirrored);
+    KATANA_LOG_VASSERT(res, "finishing partition {}: {}", h, res.error());
+    parts.emplace_back(std::move(res.value()));
+    KATANA_LOG_ASSERT(!loaders[h].Finish(mirrored));
+  }
+
+  // A host may only mirror masters of the host it names
+  if (num_hosts > 1 && !loaders[1].mirrors()[0].empty()) {
+    std::vector<std::vector<uint64_t>> wrong(num_hosts);
+    wrong[0] = loaders[1].mirrors()[0];
+    auto res = katana::PartitionLoader::Read(rdg_dir, 1, num_hosts, options);
+    KATANA_LOG_ASSERT(res && !res.value().Finish(wrong));
+  }
+  return parts;
+}
+
+/// Check that parts cover the nodes of pg with one master each and its
+/// edges with one copy each, and that MirrorSync accepts them
+void
+CheckPartitions(const katana::PropertyGraph& pg, const Parts& parts) {
+  uint32_t num_hosts = parts.size();
+  std::vector<uint32_t> masters_of(pg.num_nodes(), 0);
+  std::multiset<std::pair<uint64_t, uint64_t>> edges;
+  uint64_t num_mirrors = 0;
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    katana::NullCommBackend comm;
+    comm.Num = num_hosts;
+    comm.ID = h;
+    auto sync_res = katana::MirrorSync::Make(*parts[h], &comm);
+    KATANA_LOG_VASSERT(sync_res, "partition {}: {}", h, sync_res.error());
+    const katana::MirrorSync& sync = sync_res.value();
+    KATANA_LOG_ASSERT(sync.num_global_nodes() == pg.num_nodes());
+
+    const katana::GraphTopology& topology = parts[h]->topology();
+    for (uint32_t n = 0; n < sync.num_masters(); ++n) {
+      masters_of[sync.global_id(n)] += 1;
+    }
+    num_mirrors += sync.num_nodes() - sync.num_masters();
+    for (auto n : topology) {
+      for (auto e : topology.edges(n)) {
+        edges.emplace(
+            sync.global_id(n), sync.global_id(topology.edge_dest(e)));
+      }
+    }
+  }
+  for (uint64_t n = 0; n < pg.num_nodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        masters_of[n] == 1, "node {} has {} masters", n, masters_of[n]);
+  }
+  KATANA_LOG_ASSERT(num_hosts == 1 || num_mirrors > 0);
+
+  std::multiset<std::pair<uint64_t, uint64_t>> expected;
+  const katana::GraphTopology& topology = pg.topology();
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      expected.emplace(n, topology.edge_dest(e));
+    }
+  }
+  KATANA_LOG_ASSERT(edges == expected);
+}
+
+void
+TestPartitionLoader() {
+  constexpr uint32_t kNumNodes = 3000;
+  RandomPolicy policy{6};
+  auto pg = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  // Runs of nodes on each of three hosts
+  arrow::UInt32Builder builder;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_ASSERT(builder.Append(n / 7 % 3).ok());
+  }
+  if (auto r = pg->AddNodeProperties(arrow::Table::Make(
+          arrow::schema({arrow::field("host", arrow::uint32())}),
+          {builder.Finish().ValueOrDie()}));
+      !r) {
+    KATANA_LOG_FATAL("could not add node property: {}", r.error());
+  }
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/partitionloader");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = pg->Write(rdg_dir, "partition-loader"); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing graph: {}", res.error());
+  }
+
+  PartitionLoadOptions hash;
+  hash.block_nodes = 64;
+  for (uint32_t num_hosts : {1, 3, 4}) {
+    CheckPartitions(*pg, LoadPartitions(rdg_dir, num_hosts, hash));
+  }
+
+  PartitionLoadOptions cartesian;
+  cartesian.policy = PartitionLoadOptions::kCartesianVertexCut;
+  for (uint32_t num_hosts : {1, 3, 4, 6}) {
+    Parts parts = LoadPartitions(rdg_dir, num_hosts, cartesian);
+    CheckPartitions(*pg, parts);
+    for (const auto& part : parts) {
+      KATANA_LOG_ASSERT(part->num_edges() > 0);
+    }
+  }
+
+  PartitionLoadOptions by_property;
+  by_property.policy = PartitionLoadOptions::kPartitionProperty;
+  by_property.partition_property = "host";
+  CheckPartitions(*pg, LoadPartitions(rdg_dir, 3, by_property));
+  by_property.block_nodes = 2;
+  Parts parts = LoadPartitions(rdg_dir, 3, by_property);
+  CheckPartitions(*pg, parts);
+  for (uint32_t h = 0; h < 3; ++h) {
+    katana::NullCommBackend comm;
+    comm.Num = 3;
+    comm.ID = h;
+    auto sync_res = katana::MirrorSync::Make(*parts[h], &comm);
+    KATANA_LOG_ASSERT(sync_res);
+    for (uint32_t n = 0; n < sync_res.value().num_masters(); ++n) {
+      KATANA_LOG_ASSERT(sync_res.value().global_id(n) / 7 % 3 == h);
+    }
+  }
+
+  // With one host, the partition is the graph
+  auto one_res = katana::LoadPartition(rdg_dir, tsuba::Comm());
+  KATANA_LOG_VASSERT(one_res, "loading partition: {}", one_res.error());
+  KATANA_LOG_ASSERT(one_res.value()->topology().Equals(pg->topology()));
+  KATANA_LOG_ASSERT(katana::MirrorSync::Make(*one_res.value(), tsuba::Comm()));
+
+  // Errors
+  KATANA_LOG_ASSERT(!katana::PartitionLoader::Read(rdg_dir, 3, 3));
+  by_property.partition_property = "missing";
+  KATANA_LOG_ASSERT(
+      !katana::PartitionLoader::Read(rdg_dir, 0, 3, by_property));
+  // The property names hosts that are not there
+  by_property.partition_property = "host";
+  KATANA_LOG_ASSERT(
+      !katana::PartitionLoader::Read(rdg_dir, 0, 2, by_property));
+
+  fs::remove_all(rdg_dir);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestPartitionLoader();
+
+  return 0;
+}
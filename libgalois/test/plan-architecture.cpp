@@ -0,0 +1,79 @@
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using katana::analytics::Architecture;
+using katana::analytics::PagerankPlan;
+
+namespace {
+
+/// A plan of any architecture
+class TestPlan : public katana::analytics::Plan {
+public:
+  explicit TestPlan(Architecture architecture) : Plan(architecture) {}
+};
+
+void
+CheckRejected(const katana::Result<void>& res, Architecture architecture) {
+  KATANA_LOG_VASSERT(
+      !res, "architecture {} was accepted", static_cast<int>(architecture));
+  KATANA_LOG_VASSERT(
+      res.error() == katana::ErrorCode::FeatureNotEnabled,
+      "architecture {} was rejected with {}", static_cast<int>(architecture),
+      res.error());
+}
+
+/// Only the architectures an analytic implements pass
+void
+TestCheckArchitecture() {
+  using namespace katana::analytics;
+
+  KATANA_LOG_ASSERT(CheckArchitecture(TestPlan(kCPU)));
+  KATANA_LOG_ASSERT(
+      CheckArchitecture(TestPlan(kDistributedCPU), {kCPU, kDistributedCPU}));
+  CheckRejected(
+      CheckArchitecture(TestPlan(kDistributedCPU)), kDistributedCPU);
+  for (Architecture architecture : {kGPU, kDistributedGPU}) {
+    CheckRejected(CheckArchitecture(TestPlan(architecture)), architecture);
+    CheckRejected(
+        CheckArchitecture(TestPlan(architecture), {kCPU, kDistributedCPU}),
+        architecture);
+  }
+
+  // The values of the architectures do not change, since plans store them
+  static_assert(kCPU == 0 && kGPU == 1);
+  static_assert(kDistributedCPU == 2 && kDistributedGPU == 3);
+}
+
+/// An analytic fails for a GPU plan rather than runs on CPUs
+void
+TestGpuPlan() {
+  using namespace katana::analytics;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<int64_t>(100, 0, &policy);
+  for (Architecture architecture : {kGPU, kDistributedGPU}) {
+    PagerankPlan plan(
+        architecture, PagerankPlan::kPullTopological,
+        PagerankPlan::kDefaultTolerance, PagerankPlan::kDefaultMaxIterations,
+        PagerankPlan::kDefaultAlpha);
+    CheckRejected(Pagerank(g.get(), "rank", plan), architecture);
+    KATANA_LOG_ASSERT(!g->HasNodeProperty("rank"));
+  }
+  KATANA_LOG_ASSERT(Pagerank(g.get(), "rank", PagerankPlan()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestCheckArchitecture();
+  TestGpuPlan();
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include <string>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/points_to/points_to.h"
+
+using DataType = int64_t;
+using katana::analytics::PointsToConstraint;
+using katana::analytics::PointsToPlan;
+using katana::analytics::PointsToStatistics;
+
+/// Add the edge property "kind" with the kind of every edge taken from
+/// kind_of(e)
+template <typename Kind, typename F>
+void
+AddKinds(katana::PropertyGraph* pg, F kind_of) {
+  std::vector<Kind> kinds(pg->topology().num_edges());
+  for (size_t e = 0; e < kinds.size(); ++e) {
+    kinds[e] = kind_of(e);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(
+          "kind", arrow::CTypeTraits<Kind>::type_singleton())}),
+      {katana::BuildArray(kinds)});
+  auto res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add kinds: {}", res.error());
+}
+
+/// Random constraints, mostly copies and addresses as in real programs
+template <typename Kind>
+void
+AddRandomKinds(katana::PropertyGraph* pg) {
+  auto& gen = katana::GetGenerator();
+  std::discrete_distribution<int> dist({2, 4, 2, 1, 1});
+  AddKinds<Kind>(pg, [&](size_t) { return dist(gen); });
+}
+
+/// Solve the constraints with and without cycle detection and check both,
+/// returning the number of points-to facts
+uint64_t
+TestPointsTo(katana::PropertyGraph* pg) {
+  std::vector<uint64_t> facts;
+  for (auto plan :
+       {PointsToPlan::DifferencePropagation(true),
+        PointsToPlan::DifferencePropagation(false)}) {
+    std::string output = "points-to-" + std::to_string(facts.size());
+    auto res = katana::analytics::PointsTo(pg, "kind", output, plan);
+    KATANA_LOG_VASSERT(res, "points-to failed: {}", res.error());
+
+    auto valid_res = katana::analytics::PointsToAssertValid(pg, "kind", output);
+    KATANA_LOG_VASSERT(valid_res, "invalid points-to: {}", valid_res.error());
+
+    auto stats_res = PointsToStatistics::Compute(pg, output);
+    KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+    facts.emplace_back(stats_res.value().n_points_to_facts);
+
+    // The output property may not exist before the call
+    res = katana::analytics::PointsTo(pg, "kind", output, plan);
+    KATANA_LOG_ASSERT(!res);
+  }
+  KATANA_LOG_VASSERT(
+      facts[0] == facts[1], "solutions have {} and {} facts", facts[0],
+      facts[1]);
+  return facts[0];
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // Along a line of copies from n1 = &n0, every node points to n0 alone
+  LinePolicy line{1};
+  auto pg = MakeFileGraph<DataType>(100, 0, &line);
+  AddKinds<uint8_t>(pg.get(), [](size_t e) {
+    return static_cast<uint8_t>(
+        e == 0 ? PointsToConstraint::kAddressOf : PointsToConstraint::kCopy);
+  });
+  uint64_t facts = TestPointsTo(pg.get());
+  KATANA_LOG_VASSERT(facts == 100, "{} facts, not 100", facts);
+
+  for (size_t width : {1, 2, 4}) {
+    RandomPolicy random{width};
+    pg = MakeFileGraph<DataType>(500, 0, &random);
+    AddRandomKinds<uint8_t>(pg.get());
+    TestPointsTo(pg.get());
+
+    pg = MakeFileGraph<DataType>(200, 0, &random);
+    AddRandomKinds<int64_t>(pg.get());
+    TestPointsTo(pg.get());
+  }
+
+  // The kinds must exist, and be ints that are PointsToConstraints
+  RandomPolicy random{2};
+  pg = MakeFileGraph<DataType>(20, 0, &random);
+  auto res = katana::analytics::PointsTo(pg.get(), "kind", "points-to");
+  KATANA_LOG_ASSERT(!res);
+  AddKinds<int32_t>(pg.get(), [](size_t e) { return e == 5 ? -1 : 1; });
+  res = katana::analytics::PointsTo(pg.get(), "kind", "points-to");
+  KATANA_LOG_ASSERT(!res);
+
+  pg = MakeFileGraph<DataType>(20, 0, &random);
+  AddKinds<double>(pg.get(), [](size_t) { return 1; });
+  res = katana::analytics::PointsTo(pg.get(), "kind", "points-to");
+  KATANA_LOG_ASSERT(!res);
+
+  return 0;
+}
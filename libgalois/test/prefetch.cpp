@@ -0,0 +1,104 @@
+#include <atomic>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/AdjacencyPrefetcher.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// A prefetcher that counts the items it is asked to prefetch in each stage
+struct CountingPrefetcher {
+  constexpr static unsigned kStages = 2;
+
+  std::vector<std::atomic<int>>* counts;
+
+  void operator()(uint32_t item, unsigned stage) const {
+    KATANA_LOG_ASSERT(stage < kStages);
+    KATANA_LOG_ASSERT(item < counts->size());
+    (*counts)[item] += 1;
+  }
+};
+
+/// Checks that loops with a prefetch distance visit every item once and
+/// prefetch each item in each stage, exactly once unless threads steal
+template <typename... Args>
+void
+TestVisits(uint32_t size, bool steals, Args... args) {
+  std::vector<std::atomic<int>> visits(size);
+  std::vector<std::atomic<int>> prefetches(size);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, size),
+      [&](uint32_t i) { visits[i] += 1; },
+      katana::prefetch_distance<8>(CountingPrefetcher{&prefetches}),
+      katana::no_stats(), args...);
+  for (uint32_t i = 0; i < size; ++i) {
+    KATANA_LOG_VASSERT(visits[i] == 1, "item {} visited {}", i, visits[i]);
+    int stages = CountingPrefetcher::kStages;
+    KATANA_LOG_VASSERT(
+        steals ? prefetches[i] >= stages : prefetches[i] == stages,
+        "item {} prefetched {}", i, prefetches[i]);
+  }
+}
+
+void
+TestAdjacency() {
+  RandomPolicy policy{4};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(1000, 0, &policy);
+  const katana::GraphTopology& topology = g->topology();
+
+  std::vector<uint64_t> weights(topology.num_nodes());
+  for (Node n : topology) {
+    weights[n] = n;
+  }
+  std::vector<uint64_t> expected(topology.num_nodes());
+  for (Node n : topology) {
+    for (auto e : topology.edges(n)) {
+      expected[n] += weights[topology.edge_dest(e)];
+    }
+  }
+
+  std::vector<uint64_t> sums(topology.num_nodes());
+  auto pull = [&](Node n) {
+    for (auto e : topology.edges(n)) {
+      sums[n] += weights[topology.edge_dest(e)];
+    }
+  };
+  katana::do_all(
+      katana::iterate(topology), pull, katana::steal(),
+      katana::chunk_size<16>(),
+      katana::prefetch_distance<16>(
+          katana::AdjacencyPrefetcher(topology, weights.data())),
+      katana::no_stats());
+  KATANA_LOG_ASSERT(sums == expected);
+
+  std::fill(sums.begin(), sums.end(), 0);
+  katana::do_all(
+      katana::iterate(topology), pull,
+      katana::prefetch_distance<4>(katana::AdjacencyPrefetcher(topology)),
+      katana::no_stats());
+  KATANA_LOG_ASSERT(sums == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  for (uint32_t size : {0, 1, 7, 1000}) {
+    TestVisits(size, false);
+    TestVisits(size, true, katana::steal());
+    TestVisits(size, true, katana::steal(), katana::chunk_size<4>());
+  }
+  TestAdjacency();
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+#include <cmath>
+#include <memory>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyExpression.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+using katana::PropertyExpression;
+
+namespace {
+
+/// A property whose value at row i is i, in chunks of chunk_size rows,
+/// every third of which is null if with_nulls
+std::shared_ptr<arrow::ChunkedArray>
+MakeChunkedProperty(int64_t num_rows, int64_t chunk_size, bool with_nulls) {
+  arrow::ArrayVector chunks;
+  for (int64_t begin = 0; begin < num_rows; begin += chunk_size) {
+    arrow::Int32Builder builder;
+    for (int64_t i = begin; i < std::min(num_rows, begin + chunk_size); ++i) {
+      if (with_nulls && i % 3 == 0) {
+        KATANA_LOG_ASSERT(builder.AppendNull().ok());
+      } else {
+        KATANA_LOG_ASSERT(builder.Append(i).ok());
+      }
+    }
+    chunks.emplace_back(builder.Finish().ValueOrDie());
+  }
+  return std::make_shared<arrow::ChunkedArray>(chunks);
+}
+
+PropertyExpression
+MustParse(const std::string& text) {
+  auto res = PropertyExpression::Parse(text);
+  KATANA_LOG_VASSERT(res, "could not parse {}: {}", text, res.error());
+  return res.value();
+}
+
+void
+TestParse() {
+  // Printing an expression gives text that parses back to it
+  for (const char* text :
+       {"a + b * c", "(a + b) * c", "a - (b - c)", "a - b - c", "-a * b",
+        "-(a + b)", "log(`page-rank`) / 2", "pow(a, 0.5) + max(a, b)",
+        "degree() * 3", "a / (b * c)"}) {
+    PropertyExpression e = MustParse(text);
+    KATANA_LOG_VASSERT(
+        e.ToString() == text, "{} printed as {}", text, e.ToString());
+  }
+
+  PropertyExpression e = MustParse(" 2*x+ 1");
+  KATANA_LOG_ASSERT(e.op() == PropertyExpression::Op::kAdd);
+  KATANA_LOG_ASSERT(e.args()[0].op() == PropertyExpression::Op::kMultiply);
+  KATANA_LOG_ASSERT(e.args()[0].args()[1].name() == "x");
+  KATANA_LOG_ASSERT(e.args()[1].value() == 1);
+
+  for (const char* text :
+       {"", "a +", "(a", "a b", "f(a)", "log(a, b)", "pow(a)", "`a", "a $"}) {
+    KATANA_LOG_VASSERT(
+        !PropertyExpression::Parse(text), "{} should not parse", text);
+  }
+  KATANA_LOG_ASSERT(
+      !PropertyExpression::Call(PropertyExpression::Op::kSqrt, {}));
+}
+
+void
+TestEvaluate() {
+  constexpr int64_t kNumNodes = 3000;
+  LinePolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  // Keep the chunks so that the evaluation reads across chunk boundaries
+  auto keep = arrow::key_value_metadata(
+      {katana::PropertyGraph::kKeepChunksKey}, {"true"});
+  auto schema = arrow::schema({
+      arrow::field("x", arrow::int32())->WithMetadata(keep),
+      arrow::field("y", arrow::int32())->WithMetadata(keep),
+  });
+  auto table = arrow::Table::Make(
+      schema, {MakeChunkedProperty(kNumNodes, 700, false),
+               MakeChunkedProperty(kNumNodes, 1100, true)});
+  if (auto r = g->AddNodeProperties(table); !r) {
+    KATANA_LOG_FATAL("could not add node properties: {}", r.error());
+  }
+  KATANA_LOG_ASSERT(g->GetNodeProperty("x")->num_chunks() > 1);
+
+  PropertyExpression e = MustParse("sqrt(x) * 2 + log(degree()) - -1");
+  auto res = katana::AddNodePropertyFromExpression(g.get(), "e", e);
+  KATANA_LOG_VASSERT(res, "could not evaluate: {}", res.error());
+  auto values = std::static_pointer_cast<arrow::DoubleArray>(
+      g->GetNodeProperty("e")->chunk(0));
+  KATANA_LOG_ASSERT(values->length() == kNumNodes);
+  KATANA_LOG_ASSERT(values->null_count() == 0);
+  for (int64_t i = 0; i < kNumNodes; ++i) {
+    double expected = std::sqrt(i) * 2 + std::log(2) + 1;
+    KATANA_LOG_VASSERT(
+        std::abs(values->Value(i) - expected) < 1e-9, "node {} is {}, not {}",
+        i, values->Value(i), expected);
+  }
+
+  // A value is null if an input is
+  auto sum_res = katana::EvaluateNodeExpression(
+      *g,
+      PropertyExpression::Property("x") + PropertyExpression::Property("y"));
+  KATANA_LOG_VASSERT(sum_res, "could not evaluate: {}", sum_res.error());
+  auto sum = sum_res.value();
+  KATANA_LOG_ASSERT(sum->null_count() == (kNumNodes + 2) / 3);
+  for (int64_t i = 0; i < kNumNodes; ++i) {
+    KATANA_LOG_ASSERT(sum->IsNull(i) == (i % 3 == 0));
+    KATANA_LOG_ASSERT(sum->IsNull(i) || sum->Value(i) == 2 * i);
+  }
+
+  KATANA_LOG_ASSERT(
+      katana::AddNodePropertyFromExpression(g.get(), "twice", "2 * x"));
+  KATANA_LOG_ASSERT(g->GetNodeProperty("twice")->Equals(
+      *katana::EvaluateNodeExpression(*g, MustParse("x + x")).value()));
+
+  // Errors
+  KATANA_LOG_ASSERT(!katana::EvaluateNodeExpression(*g, MustParse("z + 1")));
+  KATANA_LOG_ASSERT(!katana::EvaluateEdgeExpression(*g, MustParse("degree()")));
+  KATANA_LOG_ASSERT(!katana::AddNodePropertyFromExpression(g.get(), "e", e));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestParse();
+  TestEvaluate();
+
+  return 0;
+}
@@ -1,11 +1,19 @@
+#include <fstream>
+#include <limits>
+#include <set>
+
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
 #include "katana/Logging.h"
+#include "katana/NumaMemoryPool.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
 #include "katana/Uri.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FaultTest.h"
 
 namespace {
 
@@ -131,6 +139,710 @@ TestRoundTrip() {
   }
 }
 
+void
+TestCompressedTopologyRoundTrip() {
+  constexpr size_t test_length = 100;
+
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  g->set_compress_topology(true);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+}
+
+/// The sorted-by-dest flag survives a round trip, and sorting a graph known
+/// to be sorted leaves its topology alone
+void
+TestSortedByDestRoundTrip() {
+  constexpr size_t test_length = 100;
+
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(!g->edges_sorted_by_dest());
+  auto sort_res = katana::SortAllEdgesByDest(g.get());
+  KATANA_LOG_VASSERT(sort_res, "could not sort: {}", sort_res.error());
+  KATANA_LOG_ASSERT(g->edges_sorted_by_dest());
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g2->edges_sorted_by_dest());
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+
+  auto dests = g2->topology().out_dests;
+  sort_res = katana::SortAllEdgesByDest(g2.get());
+  KATANA_LOG_ASSERT(sort_res);
+  KATANA_LOG_ASSERT(g2->topology().out_dests == dests);
+  const std::shared_ptr<arrow::UInt64Array>& permutation = sort_res.value();
+  for (int64_t e = 0; e < permutation->length(); ++e) {
+    KATANA_LOG_ASSERT(permutation->Value(e) == static_cast<uint64_t>(e));
+  }
+  KATANA_LOG_ASSERT(katana::EnsureAllEdgesSortedByDest(g2.get()));
+  KATANA_LOG_ASSERT(g2->topology().out_dests == dests);
+
+  // A modification that unsorts the edges is persisted too
+  KATANA_LOG_ASSERT(g2->MarkTopologyModified(false));
+  KATANA_LOG_ASSERT(!g2->edges_sorted_by_dest());
+  if (auto res = g2->Commit(command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", res.error());
+  }
+  auto unsorted_res =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!unsorted_res) {
+    KATANA_LOG_FATAL("making result: {}", unsorted_res.error());
+  }
+  KATANA_LOG_ASSERT(!unsorted_res.value()->edges_sorted_by_dest());
+  KATANA_LOG_ASSERT(unsorted_res.value()->topology().Equals(g->topology()));
+}
+
+/// Loading into a pool copies the topology of each node range on the thread
+/// that iterates over it; fewer nodes than threads leave some threads none
+void
+TestLoadIntoNumaPool() {
+  katana::setActiveThreads(4);
+  for (size_t test_length : {3, 1000}) {
+    for (bool compress : {false, true}) {
+      RandomPolicy policy{4};
+      auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+      g->set_compress_topology(compress);
+
+      auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+      KATANA_LOG_ASSERT(uri_res);
+      std::string rdg_dir(uri_res.value().path());  // path() because local
+
+      auto write_result = g->Write(rdg_dir, command_line);
+      if (!write_result) {
+        fs::remove_all(rdg_dir);
+        KATANA_LOG_FATAL("writing result: {}", write_result.error());
+      }
+
+      tsuba::RDGLoadOptions opts;
+      opts.memory_pool = katana::NumaMemoryPool::Get(
+          katana::NumaMemoryPool::Policy::kBlocked);
+      auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+      fs::remove_all(rdg_dir);
+      if (!make_result) {
+        KATANA_LOG_FATAL("making result: {}", make_result.error());
+      }
+      KATANA_LOG_ASSERT(make_result.value()->topology().Equals(g->topology()));
+    }
+  }
+}
+
+void
+TestCommitWithColumnOpts() {
+  constexpr size_t test_length = 1000;
+
+  RandomPolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  // One column gets options of its own and the other inferred ones
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("chosen", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<double>("inferred", test_length)));
+  g->MarkAllPropertiesPersistent();
+
+  tsuba::ParquetWriter::WriteOpts opts;
+  opts.column_opts["chosen"] = {
+      .compression = arrow::Compression::ZSTD,
+      .compression_level = 9,
+      .dictionary = false,
+  };
+  if (auto res = g->Commit(command_line, opts); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", res.error());
+  }
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  for (const std::string& name : {"chosen", "inferred"}) {
+    KATANA_LOG_ASSERT(
+        g2->GetNodeProperty(name)->Equals(*g->GetNodeProperty(name)));
+  }
+}
+
+void
+TestCommitArrowIPC() {
+  constexpr size_t test_length = 1000;
+
+  RandomPolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  // One property is stored as Arrow IPC and the other as Parquet
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("mapped", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<double>("decoded", test_length)));
+  g->MarkAllPropertiesPersistent();
+
+  tsuba::ParquetWriter::WriteOpts opts;
+  opts.arrow_ipc_properties = {"mapped"};
+  if (auto res = g->Commit(command_line, opts); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", res.error());
+  }
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  for (const std::string& name : {"mapped", "decoded"}) {
+    KATANA_LOG_ASSERT(
+        g2->GetNodeProperty(name)->Equals(*g->GetNodeProperty(name)));
+  }
+}
+
+std::set<std::string>
+ListFiles(const std::string& dir) {
+  std::set<std::string> files;
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    files.emplace(entry.path().filename().string());
+  }
+  return files;
+}
+
+void
+TestCommitRollBack() {
+  constexpr size_t test_length = 100;
+
+  RandomPolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+  std::set<std::string> committed = ListFiles(rdg_dir);
+
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("added", test_length)));
+  g->MarkAllPropertiesPersistent();
+
+  // Fail after the files are written, then while storing the RDGMeta
+  for (uint64_t point : {1, 2}) {
+    tsuba::internal::FaultTestInit(
+        tsuba::internal::FaultMode::ErrorRunLength, 0.0f, point);
+    auto res = g->Commit(command_line);
+    tsuba::internal::FaultTestInit();
+    if (res || ListFiles(rdg_dir) != committed) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("commit failing at {} was not rolled back", point);
+    }
+  }
+
+  auto prev_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(prev_res);
+  KATANA_LOG_ASSERT(
+      prev_res.value()->node_schema()->GetFieldIndex("added") < 0);
+
+  if (auto res = g->Commit(command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", res.error());
+  }
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  KATANA_LOG_ASSERT(make_result.value()->GetNodeProperty("added")->Equals(
+      *g->GetNodeProperty("added")));
+}
+
+/// The files in dir that are not in before
+std::set<std::string>
+NewFiles(const std::string& dir, const std::set<std::string>& before) {
+  std::set<std::string> added;
+  for (const std::string& file : ListFiles(dir)) {
+    if (before.count(file) == 0) {
+      added.emplace(file);
+    }
+  }
+  return added;
+}
+
+/// A commit after a store writes only the files of the properties added
+/// since, next to the new metadata
+void
+TestIncrementalCommit() {
+  constexpr size_t test_length = 1000;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  size_t num_edges = g->topology().num_edges();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("first", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddEdgeProperties(MakeProps<int64_t>("weight", num_edges)));
+  g->MarkAllPropertiesPersistent();
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+  std::set<std::string> stored = ListFiles(rdg_dir);
+
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<double>("second", test_length)));
+  g->MarkAllPropertiesPersistent();
+  if (auto res = g->Commit(command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", res.error());
+  }
+
+  size_t num_property_files = 0;
+  for (const std::string& file : NewFiles(rdg_dir, stored)) {
+    if (file.rfind("second", 0) == 0) {
+      num_property_files += 1;
+    } else if (file.rfind("meta_", 0) != 0) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("commit wrote unchanged data again: {}", file);
+    }
+  }
+  KATANA_LOG_ASSERT(num_property_files == 1);
+
+  // Without changes, a commit writes only metadata
+  stored = ListFiles(rdg_dir);
+  if (auto res = g->Commit(command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", res.error());
+  }
+  for (const std::string& file : NewFiles(rdg_dir, stored)) {
+    if (file.rfind("meta_", 0) != 0) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("commit without changes wrote {}", file);
+    }
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  KATANA_LOG_ASSERT(make_result.value()->Equals(g.get()));
+}
+
+/// The first byte of each part header in dir
+std::set<char>
+PartHeaderLeads(const std::string& dir) {
+  std::set<char> leads;
+  for (const std::string& file : ListFiles(dir)) {
+    if (file.rfind("meta_0_", 0) != 0) {
+      continue;
+    }
+    std::ifstream in(dir + "/" + file, std::ios::binary);
+    leads.emplace(in.get());
+  }
+  return leads;
+}
+
+void
+TestPartHeaderFormats() {
+  constexpr size_t test_length = 10;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  for (int i = 0; i < 100; ++i) {
+    KATANA_LOG_ASSERT(g->AddNodeProperties(
+        MakeProps<int32_t>(fmt::format("node-{}", i), test_length)));
+  }
+  g->MarkAllPropertiesPersistent();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  // Older readers need JSON part headers
+  setenv("KATANA_RDG_JSON_PART_HEADER", "1", 1);
+  auto res = g->Write(rdg_dir, command_line);
+  unsetenv("KATANA_RDG_JSON_PART_HEADER");
+  if (!res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+  KATANA_LOG_ASSERT(PartHeaderLeads(rdg_dir) == std::set<char>{'{'});
+
+  auto json_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(json_res);
+  KATANA_LOG_ASSERT(json_res.value()->Equals(g.get()));
+
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("binary", test_length)));
+  g->MarkAllPropertiesPersistent();
+  if (auto res = g->Commit(command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", res.error());
+  }
+  KATANA_LOG_ASSERT(PartHeaderLeads(rdg_dir) == std::set<char>({'{', 'K'}));
+
+  auto binary_res =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!binary_res) {
+    KATANA_LOG_FATAL("making result: {}", binary_res.error());
+  }
+  KATANA_LOG_ASSERT(binary_res.value()->Equals(g.get()));
+}
+
+void
+TestChecksums() {
+  constexpr size_t test_length = 100;
+
+  RandomPolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(test_length, 3, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+  KATANA_LOG_ASSERT(
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions()));
+
+  // Flip a bit of the last byte of the topology, which checks of its
+  // structure need not notice
+  for (const std::string& file : ListFiles(rdg_dir)) {
+    if (file.rfind("topology", 0) != 0) {
+      continue;
+    }
+    std::fstream topology(
+        rdg_dir + "/" + file, std::ios::in | std::ios::out | std::ios::binary);
+    topology.seekg(-1, std::ios::end);
+    char last = topology.get();
+    topology.seekp(-1, std::ios::end);
+    topology.put(last ^ 1);
+  }
+
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(
+      !make_res && make_res.error() == tsuba::ErrorCode::ChecksumMismatch,
+      "corruption went unnoticed");
+}
+
+/// Loads with a node predicate read only the row groups whose statistics
+/// may match it; the other rows are null
+void
+TestPredicatePushdown() {
+  constexpr size_t test_length = 1000;
+
+  RandomPolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("id", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<double>("value", test_length)));
+  g->MarkAllPropertiesPersistent();
+  tsuba::ParquetWriter::WriteOpts opts;
+  opts.rows_per_row_group = 100;
+  if (auto res = g->Commit(command_line, opts); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", res.error());
+  }
+
+  auto load = [&](double min, double max) {
+    tsuba::RDGLoadOptions load_opts;
+    load_opts.node_predicate = tsuba::PropertyPredicate{"id", min, max};
+    auto make_result = katana::PropertyGraph::Make(rdg_dir, load_opts);
+    if (!make_result) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("making result: {}", make_result.error());
+    }
+    return std::move(make_result.value());
+  };
+
+  // Ids 250 to 349 are in the row groups of rows 200 to 399
+  std::unique_ptr<katana::PropertyGraph> some = load(250, 349);
+  KATANA_LOG_ASSERT(some->topology().Equals(g->topology()));
+  for (const std::string& name : {"id", "value"}) {
+    auto loaded = some->GetNodeProperty(name);
+    KATANA_LOG_ASSERT(static_cast<size_t>(loaded->length()) == test_length);
+    KATANA_LOG_VASSERT(
+        static_cast<size_t>(loaded->null_count()) == test_length - 200,
+        "{} has {} nulls", name, loaded->null_count());
+    KATANA_LOG_ASSERT(loaded->Slice(200, 200)->Equals(
+        g->GetNodeProperty(name)->Slice(200, 200)));
+  }
+  // Rows that were not read must not be stored
+  KATANA_LOG_ASSERT(!some->Commit(command_line));
+
+  // A predicate that every row group may satisfy loads everything
+  std::unique_ptr<katana::PropertyGraph> all = load(
+      -std::numeric_limits<double>::infinity(),
+      std::numeric_limits<double>::infinity());
+  KATANA_LOG_ASSERT(all->Equals(g.get()));
+
+  // An empty selection loads no rows, but properties of full length
+  std::unique_ptr<katana::PropertyGraph> none = load(5000, 6000);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(none->topology().Equals(g->topology()));
+  for (const std::string& name : {"id", "value"}) {
+    auto loaded = none->GetNodeProperty(name);
+    KATANA_LOG_ASSERT(static_cast<size_t>(loaded->length()) == test_length);
+    KATANA_LOG_ASSERT(static_cast<size_t>(loaded->null_count()) == test_length);
+  }
+}
+
+void
+TestLazyProperties() {
+  constexpr size_t test_length = 1000;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("first", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<double>("second", test_length)));
+  g->MarkAllPropertiesPersistent();
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  for (bool prefetch : {false, true}) {
+    tsuba::RDGLoadOptions opts;
+    opts.lazy_properties = true;
+    opts.prefetch_lazy_properties = prefetch;
+    auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+    if (!make_result) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("making result: {}", make_result.error());
+    }
+    std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+    // The schema is known before any property is loaded, and properties
+    // load in any order
+    KATANA_LOG_ASSERT(g2->node_schema()->Equals(*g->node_schema()));
+    KATANA_LOG_ASSERT(g2->GetNodePropertyNum() == 2);
+    KATANA_LOG_ASSERT(g2->HasNodeProperty("second"));
+    KATANA_LOG_ASSERT(
+        g2->GetNodeProperty("second")->Equals(*g->GetNodeProperty("second")));
+    KATANA_LOG_ASSERT(
+        g2->GetNodeProperty(0)->Equals(*g->GetNodeProperty("first")));
+    KATANA_LOG_ASSERT(g2->GetNodeProperty("missing") == nullptr);
+    KATANA_LOG_ASSERT(g2->Equals(g.get()));
+  }
+  fs::remove_all(rdg_dir);
+}
+
+void
+TestPropertyMemoryBudget() {
+  constexpr size_t test_length = 1000;
+
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  std::string spill_dir = rdg_dir + "-spill";
+  fs::create_directory(spill_dir);
+
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("stored", test_length)));
+  g->MarkAllPropertiesPersistent();
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    fs::remove_all(spill_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    fs::remove_all(spill_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(
+      g2->AddNodeProperties(MakeProps<double>("computed", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<double>("computed", test_length)));
+
+  // Only the most recently used property stays loaded, and the others load
+  // again, from storage or from a spill file, when they are gotten
+  KATANA_LOG_ASSERT(g2->SetPropertyMemoryBudget(1, spill_dir));
+  uint64_t one_property = test_length * sizeof(double);
+  for (const std::string& name : {"stored", "computed", "stored"}) {
+    KATANA_LOG_ASSERT(
+        g2->GetNodeProperty(name)->Equals(*g->GetNodeProperty(name)));
+    KATANA_LOG_ASSERT(g2->loaded_property_bytes() < 2 * one_property);
+    KATANA_LOG_ASSERT(g2->GetNodePropertyNum() == 2);
+  }
+  KATANA_LOG_ASSERT(!fs::is_empty(spill_dir));
+
+  // Without a budget, properties stay loaded
+  KATANA_LOG_ASSERT(g2->SetPropertyMemoryBudget(0, spill_dir));
+  KATANA_LOG_ASSERT(g2->GetNodeProperty("computed"));
+  KATANA_LOG_ASSERT(g2->loaded_property_bytes() >= 2 * one_property);
+  KATANA_LOG_ASSERT(fs::is_empty(spill_dir));
+  KATANA_LOG_ASSERT(g2->Equals(g.get()));
+
+  fs::remove_all(rdg_dir);
+  fs::remove_all(spill_dir);
+}
+
+struct Second : public katana::PODProperty<int64_t> {};
+
+/// A typed view loads only the properties it views, and they stay loaded
+/// over the memory budget while it is alive
+void
+TestPinnedProperties() {
+  constexpr size_t test_length = 1000;
+  using Graph = katana::TypedPropertyGraph<std::tuple<Second>, std::tuple<>>;
+
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  std::string spill_dir = rdg_dir + "-spill";
+  fs::create_directory(spill_dir);
+
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("first", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int64_t>("second", test_length)));
+  g->MarkAllPropertiesPersistent();
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    fs::remove_all(spill_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.lazy_properties = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    fs::remove_all(spill_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g2->loaded_property_bytes() == 0);
+  KATANA_LOG_ASSERT(g2->SetPropertyMemoryBudget(1, spill_dir));
+
+  auto expected = g->GetNodePropertyTyped<int64_t>("second").value();
+  uint64_t one_property = 0;
+  {
+    auto view_res = Graph::Make(g2.get(), {"second"}, {});
+    KATANA_LOG_VASSERT(view_res, "making view: {}", view_res.error());
+    Graph view = std::move(view_res.value());
+    one_property = g2->loaded_property_bytes();
+    KATANA_LOG_ASSERT(one_property > 0);
+
+    // Getting another property evicts neither, and the view reads and writes
+    // the buffers of the loaded property
+    KATANA_LOG_ASSERT(
+        g2->GetNodeProperty("first")->Equals(*g->GetNodeProperty("first")));
+    KATANA_LOG_ASSERT(g2->loaded_property_bytes() == 2 * one_property);
+    for (auto n : view) {
+      KATANA_LOG_ASSERT(view.GetData<Second>(n) == expected->Value(n));
+    }
+    view.GetData<Second>(0) = -1;
+    auto second = g2->GetNodePropertyTyped<int64_t>("second").value();
+    KATANA_LOG_ASSERT(second->Value(0) == -1);
+    KATANA_LOG_ASSERT(g2->loaded_property_bytes() == one_property);
+  }
+
+  // Without the view, the property may be evicted
+  KATANA_LOG_ASSERT(g2->GetNodeProperty("first"));
+  KATANA_LOG_ASSERT(g2->loaded_property_bytes() == one_property);
+
+  fs::remove_all(rdg_dir);
+  fs::remove_all(spill_dir);
+}
+
 void
 TestGarbageMetadata() {
   auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
@@ -257,6 +969,19 @@ main(int argc, char** argv) {
   command_line = cmdout.str();
 
   TestRoundTrip();
+  TestCompressedTopologyRoundTrip();
+  TestSortedByDestRoundTrip();
+  TestLoadIntoNumaPool();
+  TestCommitWithColumnOpts();
+  TestCommitArrowIPC();
+  TestCommitRollBack();
+  TestIncrementalCommit();
+  TestPartHeaderFormats();
+  TestChecksums();
+  TestPredicatePushdown();
+  TestLazyProperties();
+  TestPropertyMemoryBudget();
+  TestPinnedProperties();
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
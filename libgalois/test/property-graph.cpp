@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <arrow/api.h>
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
@@ -5,6 +7,7 @@
 #include "TestTypedPropertyGraph.h"
 #include "katana/Logging.h"
 #include "katana/Properties.h"
+#include "katana/SharedMemSys.h"
 
 using DataType = int64_t;
 
@@ -126,12 +129,337 @@ TestError1(size_t num_nodes, size_t line_width) {
       "Should return PropertyNotFound when node property doesn't exist.");
 }
 
+/// Test that snapshots of properties are unaffected by later changes
+void
+TestSnapshot(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 2, &policy);
+
+  std::shared_ptr<const tsuba::RDGSnapshot> before = g->PropertySnapshot();
+  KATANA_LOG_ASSERT(before->node_properties->num_columns() == 2);
+  KATANA_LOG_ASSERT(before->node_property_paths.size() == 2);
+
+  katana::TableBuilder builder{num_nodes};
+  builder.AddColumn<DataType>(katana::ColumnOptions());
+  if (auto r = g->UpsertNodeProperties(builder.Finish()); !r) {
+    KATANA_LOG_FATAL("could not upsert node property: {}", r.error());
+  }
+  if (auto r = g->RemoveNodeProperty("1"); !r) {
+    KATANA_LOG_FATAL("could not remove node property: {}", r.error());
+  }
+
+  std::shared_ptr<const tsuba::RDGSnapshot> after = g->PropertySnapshot();
+  KATANA_LOG_VASSERT(
+      after->version > before->version, "{} <= {}", after->version,
+      before->version);
+  KATANA_LOG_ASSERT(after->node_properties->num_columns() == 1);
+  KATANA_LOG_ASSERT(before->node_properties->num_columns() == 2);
+  KATANA_LOG_ASSERT(
+      before->node_properties->column(0) !=
+      after->node_properties->column(0));
+
+  // Unchanged columns are shared rather than copied
+  KATANA_LOG_ASSERT(
+      before->edge_properties->column(0) == after->edge_properties->column(0));
+}
+
+/// Test that a copy shares the topology and properties of its graph until
+/// one of them changes them
+void
+TestCopy(size_t num_nodes, size_t line_width) {
+  RandomPolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 2, &policy);
+
+  auto copy_res = g->Copy({"1"}, {"0"});
+  KATANA_LOG_VASSERT(copy_res, "could not copy: {}", copy_res.error());
+  std::unique_ptr<katana::PropertyGraph> copy = std::move(copy_res.value());
+  KATANA_LOG_ASSERT(copy->node_schema()->num_fields() == 1);
+  KATANA_LOG_ASSERT(copy->edge_schema()->num_fields() == 1);
+  KATANA_LOG_ASSERT(
+      copy->GetNodeProperty("1")->chunk(0)->data() ==
+      g->GetNodeProperty("1")->chunk(0)->data());
+  KATANA_LOG_ASSERT(
+      copy->GetEdgeProperty("0")->chunk(0)->data() ==
+      g->GetEdgeProperty("0")->chunk(0)->data());
+  KATANA_LOG_ASSERT(copy->topology().out_dests == g->topology().out_dests);
+
+  // Changing a property of the copy replaces it in the copy alone
+  auto original = g->GetNodeProperty("1");
+  katana::TableBuilder builder{num_nodes};
+  builder.AddColumn<DataType>(katana::ColumnOptions{.name = "1"});
+  if (auto r = copy->UpsertNodeProperties(builder.Finish()); !r) {
+    KATANA_LOG_FATAL("could not upsert node property: {}", r.error());
+  }
+  KATANA_LOG_ASSERT(g->GetNodeProperty("1") == original);
+  KATANA_LOG_ASSERT(copy->GetNodeProperty("1") != original);
+
+  // Sorting the copy in place copies its topology first
+  std::vector<uint32_t> dests(
+      g->topology().out_dests->raw_values(),
+      g->topology().out_dests->raw_values() + g->topology().num_edges());
+  auto sort_res = katana::SortAllEdgesByDest(copy.get());
+  KATANA_LOG_VASSERT(sort_res, "could not sort: {}", sort_res.error());
+  KATANA_LOG_ASSERT(copy->topology().out_dests != g->topology().out_dests);
+  KATANA_LOG_ASSERT(std::equal(
+      dests.begin(), dests.end(), g->topology().out_dests->raw_values()));
+  KATANA_LOG_ASSERT(!g->edges_sorted_by_dest());
+
+  KATANA_LOG_ASSERT(!g->Copy({"missing"}, {}));
+}
+
+/// Make a property of num_rows int64_t values 0, 1, ... in chunks of
+/// chunk_size rows
+std::shared_ptr<arrow::ChunkedArray>
+MakeChunkedProperty(int64_t num_rows, int64_t chunk_size) {
+  arrow::ArrayVector chunks;
+  for (int64_t begin = 0; begin < num_rows; begin += chunk_size) {
+    arrow::Int64Builder builder;
+    for (int64_t i = begin; i < std::min(num_rows, begin + chunk_size); ++i) {
+      KATANA_LOG_ASSERT(builder.Append(i).ok());
+    }
+    chunks.emplace_back(builder.Finish().ValueOrDie());
+  }
+  return std::make_shared<arrow::ChunkedArray>(chunks);
+}
+
+/// Test that added properties are combined into one chunk unless they ask
+/// to keep theirs
+void
+TestCombineChunks(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, &policy);
+
+  auto keep = arrow::key_value_metadata(
+      {katana::PropertyGraph::kKeepChunksKey}, {"true"});
+  auto schema = arrow::schema({
+      arrow::field("chunked", arrow::int64()),
+      arrow::field("single", arrow::int64()),
+      arrow::field("kept", arrow::int64())->WithMetadata(keep),
+  });
+  auto single = MakeChunkedProperty(num_nodes, num_nodes);
+  auto table = arrow::Table::Make(
+      schema, {MakeChunkedProperty(num_nodes, 3), single,
+               MakeChunkedProperty(num_nodes, 3)});
+  if (auto r = g->AddNodeProperties(table); !r) {
+    KATANA_LOG_FATAL("could not add node properties: {}", r.error());
+  }
+
+  auto chunked = g->GetNodeProperty("chunked");
+  KATANA_LOG_ASSERT(chunked->num_chunks() == 1);
+  KATANA_LOG_ASSERT(chunked->Equals(*MakeChunkedProperty(num_nodes, 3)));
+  // A property with one chunk is not copied
+  auto added_single = g->GetNodeProperty("single");
+  KATANA_LOG_ASSERT(added_single->chunk(0)->data() == single->chunk(0)->data());
+  KATANA_LOG_ASSERT(g->GetNodeProperty("kept")->num_chunks() > 1);
+}
+
+/// Test that a dictionary encoded string property compares by code
+void
+TestDictionaryStrings() {
+  arrow::StringBuilder builder;
+  for (const char* label : {"a", "b", "a", "c", "b", "a"}) {
+    KATANA_LOG_ASSERT(builder.Append(label).ok());
+  }
+  KATANA_LOG_ASSERT(builder.AppendNull().ok());
+  std::shared_ptr<arrow::Array> strings = builder.Finish().ValueOrDie();
+  // Chunks share one dictionary once encoded
+  auto chunked = std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{strings->Slice(0, 3), strings->Slice(3)});
+
+  auto encode_res = katana::DictionaryEncode(chunked);
+  KATANA_LOG_ASSERT(encode_res);
+  std::shared_ptr<arrow::ChunkedArray> encoded = encode_res.value();
+  KATANA_LOG_ASSERT(encoded->num_chunks() == 1);
+
+  auto view_res =
+      katana::ConstructPropertyView<katana::DictionaryStringReadOnlyProperty>(
+          encoded->chunk(0).get());
+  KATANA_LOG_ASSERT(view_res);
+  auto view = std::move(view_res.value());
+  KATANA_LOG_ASSERT(view.size() == 7);
+  KATANA_LOG_ASSERT(view.num_codes() == 3);
+  KATANA_LOG_ASSERT(!view.FindCode("d"));
+
+  auto code = view.FindCode("a");
+  KATANA_LOG_ASSERT(code);
+  size_t matches = 0;
+  for (size_t i = 0; i < view.size(); ++i) {
+    if (view.IsValid(i) && view.codes()[i] == *code) {
+      ++matches;
+    }
+  }
+  KATANA_LOG_ASSERT(matches == 3);
+  KATANA_LOG_ASSERT(view.GetValue(3) == "c");
+  KATANA_LOG_ASSERT(!view.IsValid(6));
+  KATANA_LOG_ASSERT(view[6].empty());
+}
+
+struct Embedding : public katana::FixedSizeListProperty<float, 4> {};
+
+/// Test that fixed size lists are viewed as spans of their rows
+void
+TestFixedSizeLists(size_t num_nodes) {
+  LinePolicy policy{3};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, &policy);
+
+  auto table_res = Embedding::Allocate(num_nodes, "embedding");
+  KATANA_LOG_ASSERT(table_res);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(table_res.value()));
+
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<Embedding>, std::tuple<>>;
+  auto r = Graph::Make(g.get(), {"embedding"}, {});
+  KATANA_LOG_VASSERT(r, "could not make property graph: {}", r.error());
+  auto graph = std::move(r.value());
+  for (auto n : graph) {
+    katana::Span<float, 4> row = graph.GetData<Embedding>(n);
+    for (size_t c = 0; c < row.size(); ++c) {
+      KATANA_LOG_ASSERT(row[c] == 0);
+      row[c] = n * 4 + c;
+    }
+  }
+  const float* values = graph.GetNodePropertyData<Embedding>();
+  for (size_t i = 0; i < num_nodes * 4; ++i) {
+    KATANA_LOG_VASSERT(values[i] == i, "{} != {}", values[i], i);
+  }
+
+  // A slice starts at its own first row, whatever its dimension type
+  auto list = g->GetNodeProperty("embedding")->chunk(0)->Slice(2);
+  auto view_res =
+      katana::ConstructPropertyView<katana::FixedSizeListProperty<float>>(
+          list.get());
+  KATANA_LOG_ASSERT(view_res);
+  auto view = std::move(view_res.value());
+  KATANA_LOG_ASSERT(view.size() == num_nodes - 2);
+  KATANA_LOG_ASSERT(view.dimension() == 4);
+  KATANA_LOG_ASSERT(view.IsValid(0));
+  KATANA_LOG_ASSERT(view[1].data() == values + 12);
+  KATANA_LOG_ASSERT(view[1][3] == 15);
+
+  // Lists of another length or value type are rejected
+  KATANA_LOG_ASSERT(!katana::ConstructPropertyView<
+                    katana::FixedSizeListProperty<float, 3>>(list.get()));
+  KATANA_LOG_ASSERT(!katana::ConstructPropertyView<
+                    katana::FixedSizeListProperty<double, 4>>(list.get()));
+}
+
+/// Test that views and raw arrays of a sliced array start at the first row
+/// of the slice
+void
+TestSlicedViews(size_t num_nodes) {
+  constexpr size_t kOffset = 3;
+  LinePolicy policy{3};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, &policy);
+
+  arrow::Int64Builder builder;
+  for (size_t i = 0; i < num_nodes + kOffset; ++i) {
+    if (i == kOffset + 1) {
+      KATANA_LOG_ASSERT(builder.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(builder.Append(i * 10).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> array = builder.Finish().ValueOrDie();
+  std::shared_ptr<arrow::Array> slice = array->Slice(kOffset, num_nodes);
+
+  auto view_res = katana::ConstructPropertyView<Field0>(slice.get());
+  KATANA_LOG_ASSERT(view_res);
+  auto view = std::move(view_res.value());
+  KATANA_LOG_ASSERT(view.size() == num_nodes);
+  KATANA_LOG_ASSERT(
+      view.data() ==
+      std::static_pointer_cast<arrow::Int64Array>(array)->raw_values() +
+          kOffset);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    KATANA_LOG_ASSERT(view.IsValid(i) == (i != 1));
+    if (i != 1) {
+      KATANA_LOG_VASSERT(
+          view[i] == int64_t((i + kOffset) * 10), "{} != {}", view[i],
+          (i + kOffset) * 10);
+    }
+    KATANA_LOG_ASSERT(&view.data()[i] == &view.GetValue(i));
+  }
+
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("sliced", arrow::int64())}), {slice})));
+  using Graph = katana::TypedPropertyGraph<std::tuple<Field0>, std::tuple<>>;
+  auto r = Graph::Make(g.get(), {"sliced"}, {});
+  KATANA_LOG_VASSERT(r, "could not make property graph: {}", r.error());
+  auto graph = std::move(r.value());
+  int64_t* values = graph.GetNodePropertyData<Field0>();
+  for (auto n : graph) {
+    KATANA_LOG_ASSERT(&values[n] == &graph.GetData<Field0>(n));
+    values[n] = n;
+  }
+  for (size_t i = 0; i < num_nodes; ++i) {
+    KATANA_LOG_ASSERT(view[i] == int64_t(i));
+  }
+}
+
+/// Test that more than 255 combinations of types get TypeSetIDs of their own
+void
+TestManyTypeSetIDs() {
+  constexpr size_t kNumTypes = 10;
+  constexpr size_t kNumNodes = size_t{1} << kNumTypes;
+  LinePolicy policy{1};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(kNumNodes, 1, &policy);
+
+  // Node n has type i if bit i of n is set, so every combination appears
+  arrow::FieldVector fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (size_t i = 0; i < kNumTypes; ++i) {
+    arrow::BooleanBuilder builder;
+    for (size_t n = 0; n < kNumNodes; ++n) {
+      KATANA_LOG_ASSERT(builder.Append((n >> i) & 1).ok());
+    }
+    fields.emplace_back(arrow::field(fmt::format("t{}", i), arrow::boolean()));
+    columns.emplace_back(builder.Finish().ValueOrDie());
+  }
+  if (auto r = g->AddNodeProperties(
+          arrow::Table::Make(arrow::schema(fields), columns));
+      !r) {
+    KATANA_LOG_FATAL("could not add node types: {}", r.error());
+  }
+  if (auto r = g->ConstructTypeSetIDs(); !r) {
+    KATANA_LOG_FATAL("could not construct type set ids: {}", r.error());
+  }
+
+  KATANA_LOG_ASSERT(g->GetNodeTypeSetIDsNum() == kNumNodes);
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    auto id = g->GetNodeTypeSetID(n);
+    KATANA_LOG_ASSERT((n == 0) == (id == katana::PropertyGraph::kUnknownType));
+    for (size_t i = 0; i < kNumTypes; ++i) {
+      bool has = g->NodeTypeNameToTypeSetIDs(fmt::format("t{}", i)).test(id);
+      KATANA_LOG_VASSERT(has == ((n >> i) & 1), "node {} type {}", n, i);
+    }
+  }
+}
+
 int
 main() {
+  katana::SharedMemSys sys;
+
   TestIterate1(10, 3);
   TestIterate3(10, 3);
   TestIterate4(10, 3);
   TestError1(10, 3);
+  TestSnapshot(10, 3);
+  TestCopy(10, 3);
+  TestCombineChunks(10, 3);
+  TestDictionaryStrings();
+  TestFixedSizeLists(10);
+  TestSlicedViews(10);
+  TestManyTypeSetIDs();
 
   return 0;
 }
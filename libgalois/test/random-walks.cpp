@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+using DataType = int64_t;
+using katana::analytics::RandomWalksBuffer;
+using katana::analytics::RandomWalksPlan;
+
+/// Add the edge property "weight" with the weight of every edge taken from
+/// weight_of(e)
+template <typename Weight, typename F>
+void
+AddWeights(katana::PropertyGraph* pg, F weight_of) {
+  std::vector<Weight> weights(pg->topology().num_edges());
+  for (size_t e = 0; e < weights.size(); ++e) {
+    weights[e] = weight_of(e);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(
+          "weight", arrow::CTypeTraits<Weight>::type_singleton())}),
+      {katana::BuildArray(weights)});
+  auto res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add weights: {}", res.error());
+}
+
+/// Check that every walk in buffer starts where it should, has the right
+/// length and only follows edges for which usable(e) is true
+template <typename F>
+void
+CheckWalks(
+    katana::PropertyGraph* pg, const RandomWalksBuffer& buffer,
+    const RandomWalksPlan& plan, F usable) {
+  const katana::GraphTopology& topology = pg->topology();
+  KATANA_LOG_ASSERT(
+      buffer.num_walks() == topology.num_nodes() * plan.number_of_walks());
+  for (size_t i = 0; i < buffer.num_walks(); ++i) {
+    const uint32_t* walk = buffer.walk(i);
+    uint32_t length = buffer.lengths[i];
+    KATANA_LOG_VASSERT(
+        length <= plan.walk_length() + 1, "walk {} has length {}", i, length);
+    if (length == 0) {
+      continue;
+    }
+    KATANA_LOG_ASSERT(walk[0] == i % topology.num_nodes());
+    for (uint32_t j = 1; j < length; ++j) {
+      auto edges = topology.edges(walk[j - 1]);
+      auto e = std::find_if(edges.begin(), edges.end(), [&](auto e) {
+        return topology.edge_dest(e) == walk[j] && usable(e);
+      });
+      KATANA_LOG_VASSERT(
+          e != edges.end(), "walk {} takes no edge from {} to {}", i,
+          walk[j - 1], walk[j]);
+    }
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // Around a cycle every walk is the next walk_length nodes
+  LinePolicy line{1};
+  auto pg = MakeFileGraph<DataType>(100, 0, &line);
+  auto plan = RandomWalksPlan::Node2Vec(10, 2, 0.5, 2);
+  auto walks_res = katana::analytics::RandomWalks(pg.get(), plan);
+  KATANA_LOG_VASSERT(walks_res, "random walks failed: {}", walks_res.error());
+  KATANA_LOG_ASSERT(walks_res.value().size() == 200);
+  for (const auto& walk : walks_res.value()) {
+    KATANA_LOG_ASSERT(walk.size() == 11);
+    for (size_t j = 1; j < walk.size(); ++j) {
+      KATANA_LOG_ASSERT(walk[j] == (walk[j - 1] + 1) % 100);
+    }
+  }
+
+  // Narrow and wide neighborhoods, the latter with neighbor bitmaps
+  for (size_t width : {2, 10, 100}) {
+    RandomPolicy random{width};
+    pg = MakeFileGraph<DataType>(300, 0, &random);
+    // Weights follow the edges when they are sorted by destination
+    AddWeights<uint32_t>(
+        pg.get(), [&](size_t e) { return pg->topology().edge_dest(e) % 3; });
+
+    for (auto plan :
+         {RandomWalksPlan::Node2Vec(20, 3),
+          RandomWalksPlan::Node2Vec(20, 3, 4, 0.25),
+          RandomWalksPlan::Node2Vec(20, 3, 0.25, 4)}) {
+      auto res = katana::analytics::RandomWalksToBuffer(pg.get(), plan);
+      KATANA_LOG_VASSERT(res, "random walks failed: {}", res.error());
+      CheckWalks(pg.get(), res.value(), plan, [](auto) { return true; });
+
+      // Edges of weight 0 are never taken
+      res = katana::analytics::RandomWalksToBuffer(pg.get(), "weight", plan);
+      KATANA_LOG_VASSERT(res, "weighted random walks failed: {}", res.error());
+      CheckWalks(pg.get(), res.value(), plan, [&](auto e) {
+        return pg->topology().edge_dest(e) % 3 != 0;
+      });
+    }
+  }
+
+  // The weights must exist and not be negative
+  RandomPolicy random{2};
+  pg = MakeFileGraph<DataType>(20, 0, &random);
+  auto res = katana::analytics::RandomWalksToBuffer(pg.get(), "weight");
+  KATANA_LOG_ASSERT(!res);
+  AddWeights<double>(pg.get(), [](size_t e) { return e == 5 ? -1 : 1; });
+  res = katana::analytics::RandomWalksToBuffer(pg.get(), "weight");
+  KATANA_LOG_ASSERT(!res);
+
+  return 0;
+}
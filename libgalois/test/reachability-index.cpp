@@ -0,0 +1,146 @@
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/reachability_index/reachability_index.h"
+
+using katana::analytics::kReachabilityIndexUnreachable;
+using katana::analytics::ReachabilityIndex;
+using katana::analytics::ReachabilityIndexPlan;
+using katana::analytics::ReachabilityIndexStatistics;
+using Node = katana::GraphTopology::Node;
+
+namespace {
+
+/// The hop distance from source to every node by breadth-first search
+std::vector<uint32_t>
+ExactDistances(const katana::GraphTopology& topology, Node source) {
+  std::vector<uint32_t> dist(
+      topology.num_nodes(), kReachabilityIndexUnreachable);
+  std::deque<Node> queue{source};
+  dist[source] = 0;
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop_front();
+    for (auto e : topology.edges(n)) {
+      auto dst = topology.edge_dest(e);
+      if (dist[dst] == kReachabilityIndexUnreachable) {
+        dist[dst] = dist[n] + 1;
+        queue.emplace_back(dst);
+      }
+    }
+  }
+  return dist;
+}
+
+/// Index pg with plan and check the answers to the queries between all
+/// pairs of nodes
+void
+TestIndex(katana::PropertyGraph* pg, ReachabilityIndexPlan plan) {
+  auto res = ReachabilityIndex(pg, "index", plan);
+  KATANA_LOG_VASSERT(res, "ReachabilityIndex failed: {}", res.error());
+
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<Node> sources;
+  std::vector<Node> targets;
+  std::vector<uint32_t> expected;
+  for (auto s : topology) {
+    std::vector<uint32_t> dist = ExactDistances(topology, s);
+    for (auto t : topology) {
+      sources.emplace_back(s);
+      targets.emplace_back(t);
+      expected.emplace_back(dist[t]);
+    }
+  }
+
+  std::vector<uint32_t> distances(sources.size());
+  auto query_res = katana::analytics::ReachabilityIndexQuery(
+      pg, "index", sources.data(), targets.data(), sources.size(),
+      distances.data());
+  KATANA_LOG_VASSERT(query_res, "query failed: {}", query_res.error());
+  std::unique_ptr<bool[]> reachable(new bool[sources.size()]);
+  auto reachable_res = katana::analytics::ReachabilityIndexReachable(
+      pg, "index", sources.data(), targets.data(), sources.size(),
+      reachable.get());
+  KATANA_LOG_VASSERT(
+      reachable_res, "reachability query failed: {}", reachable_res.error());
+  for (size_t q = 0; q < sources.size(); ++q) {
+    KATANA_LOG_VASSERT(
+        distances[q] == expected[q], "distance from {} to {} is {}, not {}",
+        sources[q], targets[q], distances[q], expected[q]);
+    KATANA_LOG_ASSERT(
+        reachable[q] == (expected[q] != kReachabilityIndexUnreachable));
+  }
+
+  auto stats_res = ReachabilityIndexStatistics::Compute(pg, "index");
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  ReachabilityIndexStatistics stats = stats_res.value();
+  stats.Print();
+  KATANA_LOG_ASSERT(stats.total_label_size >= topology.num_nodes());
+  KATANA_LOG_ASSERT(stats.max_label_size <= topology.num_nodes());
+
+  // The index properties may not exist before the call
+  KATANA_LOG_ASSERT(!ReachabilityIndex(pg, "index", plan));
+}
+
+void
+TestInvalid() {
+  LinePolicy policy{2};
+  auto pg = MakeFileGraph<uint32_t>(10, 0, &policy);
+  KATANA_LOG_ASSERT(!ReachabilityIndex(
+      pg.get(), "index", ReachabilityIndexPlan::PrunedLandmarkLabeling(65)));
+
+  Node sources[] = {0, 10};
+  Node targets[] = {1, 1};
+  uint32_t distances[2];
+  // No index yet
+  KATANA_LOG_ASSERT(!katana::analytics::ReachabilityIndexQuery(
+      pg.get(), "index", sources, targets, 1, distances));
+  KATANA_LOG_ASSERT(ReachabilityIndex(pg.get(), "index"));
+  KATANA_LOG_ASSERT(katana::analytics::ReachabilityIndexQuery(
+      pg.get(), "index", sources, targets, 1, distances));
+  KATANA_LOG_ASSERT(distances[0] == 1);
+  // Node 10 does not exist
+  KATANA_LOG_ASSERT(!katana::analytics::ReachabilityIndexQuery(
+      pg.get(), "index", sources, targets, 2, distances));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  RandomPolicy dense{3};
+  auto connected = MakeFileGraph<uint32_t>(400, 0, &dense);
+  TestIndex(connected.get(), ReachabilityIndexPlan::PrunedLandmarkLabeling());
+
+  // Most pairs are unreachable along a single out-edge per node
+  RandomPolicy sparse{1};
+  auto forest = MakeFileGraph<uint32_t>(400, 0, &sparse);
+  TestIndex(forest.get(), ReachabilityIndexPlan::PrunedLandmarkLabeling(16));
+
+  RandomPolicy medium{2};
+  auto one_way = MakeFileGraph<uint32_t>(400, 0, &medium);
+  auto symmetric_res = katana::CreateSymmetricGraph(one_way.get());
+  KATANA_LOG_ASSERT(symmetric_res);
+  TestIndex(
+      symmetric_res.value().get(),
+      ReachabilityIndexPlan::PrunedLandmarkLabeling(
+          ReachabilityIndexPlan::kDefaultNumBitParallelHubs, true));
+
+  // A ring has long distances and no hubs; without bit-parallel hubs the
+  // pruned searches build the whole index
+  LinePolicy ring_policy{1};
+  auto ring = MakeFileGraph<uint32_t>(200, 0, &ring_policy);
+  TestIndex(ring.get(), ReachabilityIndexPlan::PrunedLandmarkLabeling(0));
+
+  TestInvalid();
+
+  return 0;
+}
@@ -87,6 +87,47 @@ test_accum() {
   KATANA_LOG_ASSERT(accum.reduce() == num);
 }
 
+void
+test_hierarchical() {
+  katana::GAccumulator<int> accum;
+  katana::GReduceMax<int> max;
+
+  constexpr int num = 123456;
+
+  for (int round = 0; round < 2; ++round) {
+    katana::do_all(katana::iterate(0, num), [&](int i) {
+      accum += 1;
+      max.update(i);
+    });
+
+    KATANA_LOG_ASSERT(accum.reduceHierarchical() == num);
+    KATANA_LOG_ASSERT(max.reduceHierarchical() == num - 1);
+    accum.reset();
+    max.reset();
+  }
+}
+
+void
+test_array_accum() {
+  constexpr size_t size = 1000;
+  constexpr int num = 123456;
+
+  katana::GArrayAccumulator<uint64_t> histogram(size);
+
+  for (int round = 0; round < 2; ++round) {
+    katana::do_all(
+        katana::iterate(0, num), [&](int i) { histogram.update(i % size, 1); });
+
+    std::vector<uint64_t>& result = histogram.reduce();
+    KATANA_LOG_ASSERT(result.size() == size);
+    for (size_t i = 0; i < size; ++i) {
+      uint64_t expected = num / size + (i < num % size ? 1 : 0);
+      KATANA_LOG_VASSERT(
+          result[i] == expected, "bucket {} is {}", i, result[i]);
+    }
+  }
+}
+
 int
 main() {
   katana::SharedMemSys sys;
@@ -100,6 +141,8 @@ main() {
   test_move();
   test_max();
   test_accum();
+  test_hierarchical();
+  test_array_accum();
 
   return 0;
 }
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Relabel.h"
+#include "katana/SharedMemSys.h"
+
+using Node = katana::GraphTopology::Node;
+
+/// Add node and edge properties that record the original ids
+void
+AddIdProperties(katana::PropertyGraph* g) {
+  std::vector<uint32_t> node_ids(g->num_nodes());
+  std::iota(node_ids.begin(), node_ids.end(), 0);
+  std::vector<uint64_t> edge_ids(g->num_edges());
+  std::iota(edge_ids.begin(), edge_ids.end(), 0);
+
+  auto node_res = g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("node", arrow::uint32())}),
+      {katana::BuildArray(node_ids)}));
+  KATANA_LOG_VASSERT(node_res, "adding node ids: {}", node_res.error());
+  auto edge_res = g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("edge", arrow::uint64())}),
+      {katana::BuildArray(edge_ids)}));
+  KATANA_LOG_VASSERT(edge_res, "adding edge ids: {}", edge_res.error());
+}
+
+/// Check that \p relabeled is \p g with node n renamed to perm.NewId(n)
+void
+CheckRelabeled(
+    const katana::PropertyGraph& g, katana::PropertyGraph& relabeled,
+    const katana::NodePermutation& perm) {
+  KATANA_LOG_ASSERT(relabeled.num_nodes() == g.num_nodes());
+  KATANA_LOG_ASSERT(relabeled.num_edges() == g.num_edges());
+
+  auto node_prop = relabeled.GetNodePropertyTyped<uint32_t>("node");
+  KATANA_LOG_ASSERT(node_prop);
+  auto edge_prop = relabeled.GetEdgePropertyTyped<uint64_t>("edge");
+  KATANA_LOG_ASSERT(edge_prop);
+
+  for (Node n = 0; n < g.num_nodes(); ++n) {
+    Node new_n = perm.NewId(n);
+    KATANA_LOG_ASSERT(perm.OldId(new_n) == n);
+    KATANA_LOG_ASSERT(node_prop.value()->Value(new_n) == n);
+
+    auto old_edges = g.edges(n);
+    auto new_edges = relabeled.edges(new_n);
+    KATANA_LOG_ASSERT(old_edges.size() == new_edges.size());
+    auto e = *old_edges.begin();
+    for (auto new_e : new_edges) {
+      KATANA_LOG_ASSERT(
+          relabeled.topology().edge_dest(new_e) ==
+          perm.NewId(g.topology().edge_dest(e)));
+      KATANA_LOG_ASSERT(edge_prop.value()->Value(new_e) == e);
+      ++e;
+    }
+  }
+}
+
+void
+TestOrder(katana::NodeOrder order, size_t num_nodes) {
+  RandomPolicy policy{4};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy);
+  AddIdProperties(g.get());
+
+  auto relabeled_res = katana::RelabelNodes(*g, order);
+  KATANA_LOG_VASSERT(relabeled_res, "relabeling: {}", relabeled_res.error());
+  std::unique_ptr<katana::PropertyGraph> relabeled =
+      std::move(relabeled_res.value());
+
+  auto perm_res = katana::NodePermutation::FromOriginalIds(*relabeled);
+  KATANA_LOG_VASSERT(perm_res, "reading ids: {}", perm_res.error());
+  const katana::NodePermutation& perm = perm_res.value();
+  CheckRelabeled(*g, *relabeled, perm);
+
+  // Results computed on the relabeled graph map back to the original nodes
+  auto result = relabeled->GetNodeProperty("node")->chunk(0);
+  auto mapped_res = perm.ToOriginalOrder(result);
+  KATANA_LOG_ASSERT(mapped_res);
+  auto mapped =
+      std::static_pointer_cast<arrow::UInt32Array>(mapped_res.value());
+  for (Node n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_ASSERT(mapped->Value(n) == n);
+  }
+
+  if (order == katana::NodeOrder::kDegree) {
+    for (Node n = 1; n < num_nodes; ++n) {
+      KATANA_LOG_ASSERT(
+          relabeled->edges(n - 1).size() >= relabeled->edges(n).size());
+    }
+  }
+}
+
+void
+TestSortNodesByDegree() {
+  LinePolicy policy{3};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(100, 0, &policy);
+  AddIdProperties(g.get());
+
+  auto copy_res = g->Copy();
+  KATANA_LOG_ASSERT(copy_res);
+  std::unique_ptr<katana::PropertyGraph> sorted = std::move(copy_res.value());
+  auto sort_res = katana::SortNodesByDegree(sorted.get());
+  KATANA_LOG_VASSERT(sort_res, "sorting: {}", sort_res.error());
+
+  auto perm_res = katana::ComputeNodeOrder(*g, katana::NodeOrder::kDegree);
+  KATANA_LOG_ASSERT(perm_res);
+  CheckRelabeled(*g, *sorted, perm_res.value());
+}
+
+/// Group nodes by a partition property, then relabel with the permutation
+void
+TestOrderByProperty(size_t num_nodes) {
+  RandomPolicy policy{4};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy);
+  AddIdProperties(g.get());
+
+  std::vector<int32_t> parts(num_nodes);
+  for (size_t n = 0; n < num_nodes; ++n) {
+    parts[n] = static_cast<int32_t>((n * 7) % 5) - 2;
+  }
+  auto add_res = g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("part", arrow::int32())}),
+      {katana::BuildArray(parts)}));
+  KATANA_LOG_VASSERT(add_res, "adding parts: {}", add_res.error());
+
+  auto perm_res = katana::ComputeNodeOrderByProperty(*g, "part");
+  KATANA_LOG_VASSERT(perm_res, "ordering: {}", perm_res.error());
+  const katana::NodePermutation& perm = perm_res.value();
+  for (Node n = 1; n < num_nodes; ++n) {
+    Node prev = perm.OldId(n - 1);
+    Node cur = perm.OldId(n);
+    KATANA_LOG_ASSERT(
+        parts[prev] < parts[cur] || (parts[prev] == parts[cur] && prev < cur));
+  }
+
+  auto relabeled_res = katana::RelabelNodes(*g, perm);
+  KATANA_LOG_VASSERT(relabeled_res, "relabeling: {}", relabeled_res.error());
+  CheckRelabeled(*g, *relabeled_res.value(), perm);
+
+  KATANA_LOG_ASSERT(!katana::ComputeNodeOrderByProperty(*g, "missing"));
+}
+
+void
+TestInvalidPermutation() {
+  std::vector<uint32_t> ids{0, 2, 2};
+  auto res = katana::NodePermutation::Make(
+      std::static_pointer_cast<arrow::UInt32Array>(katana::BuildArray(ids)));
+  KATANA_LOG_ASSERT(!res);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (auto order :
+       {katana::NodeOrder::kDegree, katana::NodeOrder::kReverseCuthillMcKee,
+        katana::NodeOrder::kLocality}) {
+    TestOrder(order, 1);
+    TestOrder(order, 1000);
+  }
+  TestSortNodesByDegree();
+  TestOrderByProperty(1000);
+  TestInvalidPermutation();
+
+  return 0;
+}
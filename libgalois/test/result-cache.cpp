@@ -0,0 +1,174 @@
+#include "katana/analytics/ResultCache.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+using katana::analytics::AnalyticSignature;
+using katana::analytics::MemoizeNodeProperty;
+
+constexpr size_t kNumNodes = 100;
+const std::string kOutput = "output";
+const std::string kCommandLine = "result-cache";
+
+/// An analytic that writes the degree of each node plus the sum of the
+/// weights of its edges, and counts its runs
+struct WeightedDegree {
+  katana::PropertyGraph* pg;
+  int64_t offset{0};
+  int runs{0};
+
+  katana::Result<void> operator()() {
+    runs += 1;
+    auto weights = pg->GetEdgeProperty("weight");
+    KATANA_LOG_ASSERT(weights);
+    auto weight_array =
+        std::static_pointer_cast<arrow::Int64Array>(weights->chunk(0));
+    std::vector<int64_t> values;
+    for (auto n : pg->topology()) {
+      int64_t sum = offset;
+      for (auto e : pg->topology().edges(n)) {
+        sum += 1 + weight_array->Value(e);
+      }
+      values.emplace_back(sum);
+    }
+    return pg->AddNodeProperties(arrow::Table::Make(
+        arrow::schema({arrow::field(kOutput, arrow::int64())}),
+        {katana::BuildArray(values)}));
+  }
+};
+
+std::shared_ptr<arrow::Table>
+MakeWeights(size_t num_edges, int64_t weight) {
+  std::vector<int64_t> weights(num_edges, weight);
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::int64())}),
+      {katana::BuildArray(weights)});
+}
+
+std::unique_ptr<katana::PropertyGraph>
+Load(const std::string& rdg_dir, bool lazy) {
+  tsuba::RDGLoadOptions opts;
+  opts.lazy_properties = lazy;
+  auto res = katana::PropertyGraph::Make(rdg_dir, opts);
+  KATANA_LOG_VASSERT(res, "loading: {}", res.error());
+  return std::move(res.value());
+}
+
+bool
+Memoize(
+    katana::PropertyGraph* pg, const AnalyticSignature& signature,
+    WeightedDegree* analytic) {
+  analytic->pg = pg;
+  auto res = MemoizeNodeProperty(
+      pg, signature, kOutput, kCommandLine, std::ref(*analytic));
+  KATANA_LOG_VASSERT(res, "memoizing: {}", res.error());
+  return res.value();
+}
+
+void
+TestMemoize(const std::string& rdg_dir) {
+  RandomPolicy policy{3};
+  auto pg = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  KATANA_LOG_ASSERT(
+      pg->AddEdgeProperties(MakeWeights(pg->topology().num_edges(), 1)));
+  pg->MarkAllPropertiesPersistent();
+
+  AnalyticSignature signature{
+      .analytic = "WeightedDegree/offset:0",
+      .edge_properties = {"weight"},
+  };
+  WeightedDegree analytic;
+
+  // The inputs of a graph that is not stored cannot be identified later
+  KATANA_LOG_ASSERT(!Memoize(pg.get(), signature, &analytic));
+  KATANA_LOG_ASSERT(analytic.runs == 1);
+  KATANA_LOG_ASSERT(pg->GetNodePropertyDerivation(kOutput).empty());
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty(kOutput));
+
+  KATANA_LOG_ASSERT(pg->Write(rdg_dir, kCommandLine));
+  KATANA_LOG_ASSERT(!pg->StoredVersion({}, {"weight"}).empty());
+  KATANA_LOG_ASSERT(pg->StoredVersion({kOutput}, {}).empty());
+
+  // Computed, then stored with the graph and reused
+  KATANA_LOG_ASSERT(!Memoize(pg.get(), signature, &analytic));
+  KATANA_LOG_ASSERT(analytic.runs == 2);
+  KATANA_LOG_ASSERT(Memoize(pg.get(), signature, &analytic));
+  KATANA_LOG_ASSERT(analytic.runs == 2);
+  auto expected = pg->GetNodeProperty(kOutput);
+
+  // Other jobs load the later version of the RDG and reuse the output,
+  // without loading it if properties are lazy
+  for (bool lazy : {false, true}) {
+    auto loaded = Load(rdg_dir, lazy);
+    WeightedDegree again;
+    KATANA_LOG_ASSERT(Memoize(loaded.get(), signature, &again));
+    KATANA_LOG_ASSERT(again.runs == 0);
+    KATANA_LOG_ASSERT(loaded->GetNodeProperty(kOutput)->Equals(*expected));
+  }
+
+  // Other parameters replace the stored output
+  AnalyticSignature other = signature;
+  other.analytic = "WeightedDegree/offset:1";
+  WeightedDegree offset{.offset = 1};
+  KATANA_LOG_ASSERT(!Memoize(pg.get(), other, &offset));
+  KATANA_LOG_ASSERT(offset.runs == 1);
+  KATANA_LOG_ASSERT(Memoize(Load(rdg_dir, false).get(), other, &offset));
+  KATANA_LOG_ASSERT(!Memoize(pg.get(), signature, &analytic));
+  KATANA_LOG_ASSERT(analytic.runs == 3);
+
+  // Changing an input invalidates the output until the input is stored
+  KATANA_LOG_ASSERT(
+      pg->UpsertEdgeProperties(MakeWeights(pg->topology().num_edges(), 2)));
+  KATANA_LOG_ASSERT(pg->StoredVersion({}, {"weight"}).empty());
+  KATANA_LOG_ASSERT(!Memoize(pg.get(), signature, &analytic));
+  KATANA_LOG_ASSERT(analytic.runs == 4);
+  KATANA_LOG_ASSERT(pg->GetNodePropertyDerivation(kOutput).empty());
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty(kOutput));
+
+  pg->MarkAllPropertiesPersistent();
+  KATANA_LOG_ASSERT(pg->Commit(kCommandLine));
+  KATANA_LOG_ASSERT(!Memoize(pg.get(), signature, &analytic));
+  KATANA_LOG_ASSERT(analytic.runs == 5);
+  auto loaded = Load(rdg_dir, false);
+  KATANA_LOG_ASSERT(Memoize(loaded.get(), signature, &analytic));
+  KATANA_LOG_ASSERT(analytic.runs == 5);
+  KATANA_LOG_ASSERT(loaded->GetNodeProperty(kOutput)->Equals(
+      *pg->GetNodeProperty(kOutput)));
+
+  // Replacing the output forgets its derivation
+  KATANA_LOG_ASSERT(pg->UpsertNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(kOutput, arrow::int64())}),
+      {katana::BuildArray(std::vector<int64_t>(kNumNodes, 0))})));
+  KATANA_LOG_ASSERT(pg->GetNodePropertyDerivation(kOutput).empty());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/result-cache");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  TestMemoize(rdg_dir);
+  fs::remove_all(rdg_dir);
+
+  return 0;
+}
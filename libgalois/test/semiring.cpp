@@ -0,0 +1,148 @@
+#include "katana/Semiring.h"
+
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using Value = int64_t;
+
+struct EdgeWeights {
+  Value operator()(Edge e) const { return static_cast<Value>(e % 5) + 1; }
+};
+
+using Matrix = katana::SparseMatrix<EdgeWeights>;
+
+constexpr katana::SpMVDirection kDirections[] = {
+    katana::SpMVDirection::kAuto,
+    katana::SpMVDirection::kPull,
+    katana::SpMVDirection::kPush,
+};
+
+/// Y = A X over S, one entry at a time; transposed is A^T
+template <typename S>
+std::vector<Value>
+Expected(
+    const katana::GraphTopology& topology, bool transposed,
+    const std::vector<Value>& x, uint32_t width) {
+  std::vector<Value> y(x.size(), S::Zero());
+  EdgeWeights weights;
+  for (Node n : topology) {
+    for (auto e : topology.edges(n)) {
+      Node row = transposed ? topology.edge_dest(e) : n;
+      Node column = transposed ? n : topology.edge_dest(e);
+      for (uint32_t c = 0; c < width; ++c) {
+        Value& out = y[row * width + c];
+        out = S::Add(out, S::Multiply(weights(e), x[column * width + c]));
+      }
+    }
+  }
+  return y;
+}
+
+/// Only every stride-th node has values, so that with the largest strides
+/// push is chosen automatically
+std::vector<Value>
+Input(size_t num_nodes, uint32_t width, Node stride) {
+  std::vector<Value> x(num_nodes * width, 0);
+  for (Node n = 0; n < num_nodes; n += stride) {
+    for (uint32_t c = 0; c < width; ++c) {
+      x[n * width + c] = n + c + 1;
+    }
+  }
+  return x;
+}
+
+void
+Check(const std::vector<Value>& actual, const std::vector<Value>& expected) {
+  for (size_t i = 0; i < expected.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        actual[i] == expected[i], "value {}: expected {} found {}", i,
+        expected[i], actual[i]);
+  }
+}
+
+template <typename S>
+void
+TestProducts(const katana::GraphTopology& topology, const Matrix& a) {
+  size_t num_nodes = topology.num_nodes();
+  for (uint32_t width : {1, 3, 4}) {
+    for (Node stride : {1, 3, 1000}) {
+      std::vector<Value> x = Input(num_nodes, width, stride);
+      for (bool transposed : {false, true}) {
+        Matrix m = transposed ? a.Transpose() : a;
+        std::vector<Value> expected =
+            Expected<S>(topology, transposed, x, width);
+        for (auto direction : kDirections) {
+          std::vector<Value> y(x.size());
+          katana::SpMM<S>(m, x.data(), y.data(), width, direction);
+          Check(y, expected);
+        }
+        if (transposed) {
+          // The rows of the transpose are sorted by column
+          std::vector<Value> y(x.size());
+          katana::SpMM<S>(
+              m, x.data(), y.data(), width, katana::SpMVDirection::kTiled,
+              katana::NoMask(), 64);
+          Check(y, expected);
+        }
+      }
+    }
+  }
+}
+
+void
+TestMask(const katana::GraphTopology& topology, const Matrix& a) {
+  using S = katana::PlusTimesSemiring<Value>;
+  size_t num_nodes = topology.num_nodes();
+  std::vector<Value> x = Input(num_nodes, 1, 1);
+  std::vector<Value> expected = Expected<S>(topology, false, x, 1);
+  auto mask = [](Node n) { return n % 2 == 0; };
+  for (auto direction : kDirections) {
+    std::vector<Value> y(num_nodes, -1);
+    katana::SpMV<S>(a, x.data(), y.data(), direction, mask);
+    for (Node n = 0; n < num_nodes; ++n) {
+      Value want = mask(n) ? expected[n] : -1;
+      KATANA_LOG_VASSERT(
+          y[n] == want, "node {}: expected {} found {}", n, want, y[n]);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  RandomPolicy policy{4};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(1000, 0, &policy);
+  const katana::GraphTopology& topology = g->topology();
+  auto in_edges_res = katana::MakeInEdgeIndex(topology);
+  KATANA_LOG_ASSERT(in_edges_res);
+  std::shared_ptr<katana::InEdgeIndex> in_edges = in_edges_res.value();
+
+  Matrix a(topology, in_edges.get());
+  TestProducts<katana::PlusTimesSemiring<Value>>(topology, a);
+  TestProducts<katana::MinPlusSemiring<Value>>(topology, a);
+  TestMask(topology, a);
+
+  // Without columns, the transpose can still be pushed
+  Matrix rows_only(topology, nullptr);
+  std::vector<Value> x = Input(topology.num_nodes(), 1, 1);
+  std::vector<Value> y(x.size());
+  katana::SpMV<katana::PlusTimesSemiring<Value>>(
+      rows_only.Transpose(), x.data(), y.data());
+  Check(y, Expected<katana::PlusTimesSemiring<Value>>(topology, true, x, 1));
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/SetIntersection.h"
+
+std::vector<uint32_t>
+RandomSet(std::mt19937* gen, size_t size, uint32_t universe) {
+  std::uniform_int_distribution<uint32_t> dist(0, universe - 1);
+  std::vector<uint32_t> values(size);
+  for (auto& v : values) {
+    v = dist(*gen);
+  }
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  return values;
+}
+
+void
+TestKernels(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  std::vector<uint32_t> expected;
+  std::set_intersection(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+  for (auto kernel :
+       {katana::IntersectionKernel::kScalar,
+        katana::IntersectionKernel::kGalloping,
+        katana::IntersectionKernel::kAVX2,
+        katana::IntersectionKernel::kAVX512}) {
+    if (!katana::IsIntersectionKernelSupported(kernel)) {
+      continue;
+    }
+    size_t ab = katana::CountSortedIntersection(
+        kernel, a.data(), a.size(), b.data(), b.size());
+    size_t ba = katana::CountSortedIntersection(
+        kernel, b.data(), b.size(), a.data(), a.size());
+    KATANA_LOG_VASSERT(
+        ab == expected.size() && ba == expected.size(),
+        "kernel {}: expected {} got {} and {}", static_cast<int>(kernel),
+        expected.size(), ab, ba);
+  }
+
+  size_t count = katana::CountSortedIntersection(
+      a.data(), a.size(), b.data(), b.size());
+  KATANA_LOG_ASSERT(count == expected.size());
+
+  std::vector<uint32_t> matches;
+  katana::ForEachSortedIntersection(
+      a.data(), a.size(), b.data(), b.size(), [&](size_t i, size_t j) {
+        KATANA_LOG_ASSERT(a[i] == b[j]);
+        matches.push_back(a[i]);
+        return true;
+      });
+  KATANA_LOG_ASSERT(matches == expected);
+
+  // Early exit after the first match
+  size_t calls = 0;
+  katana::ForEachSortedIntersection(
+      a.data(), a.size(), b.data(), b.size(), [&](size_t, size_t) {
+        ++calls;
+        return false;
+      });
+  KATANA_LOG_ASSERT(calls == std::min<size_t>(expected.size(), 1));
+}
+
+int
+main() {
+  std::mt19937 gen(0);
+
+  TestKernels({}, {});
+  TestKernels({1, 2, 3}, {});
+  TestKernels({1, 2, 3}, {1, 2, 3});
+
+  // Similar sizes, including ones that are not multiples of the block width
+  for (size_t size : {7, 8, 16, 17, 100, 1000}) {
+    for (size_t universe : {2 * size, 10 * size}) {
+      TestKernels(
+          RandomSet(&gen, size, universe), RandomSet(&gen, size, universe));
+    }
+  }
+
+  // Skewed sizes take the galloping path
+  TestKernels(RandomSet(&gen, 10, 100000), RandomSet(&gen, 50000, 100000));
+  TestKernels(RandomSet(&gen, 50000, 100000), RandomSet(&gen, 3, 100000));
+
+  // Large values exercise unsigned comparison in the block kernels
+  std::vector<uint32_t> high{0x7fffffff, 0x80000000, 0xfffffffe, 0xffffffff};
+  TestKernels(high, high);
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/BuildGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+using katana::ImportData;
+using katana::ImportDataType;
+using katana::PropertyKey;
+
+constexpr uint32_t kNumShards = 4;
+constexpr uint32_t kNodesPerShard = 50;
+constexpr uint32_t kNumNodes = kNumShards * kNodesPerShard;
+
+template <typename T>
+std::function<ImportData(ImportDataType, bool)>
+Value(ImportDataType type, T value) {
+  return [type, value](ImportDataType, bool) {
+    ImportData data(type, false);
+    data.value = value;
+    return data;
+  };
+}
+
+/// Add node i and its edges to builder. Every node has an int64 property,
+/// the nodes of shard 1 a string and those of shard 2 a label. Edges go to
+/// nodes of any shard and, from the last node, to a node that is never
+/// defined.
+void
+AddNode(katana::PropertyGraphBuilder* builder, uint32_t i) {
+  PropertyKey rank("rank", true, false, "rank", ImportDataType::kInt64, false);
+  PropertyKey name("name", true, false, "name", ImportDataType::kString, false);
+  PropertyKey weight(
+      "weight", false, true, "weight", ImportDataType::kDouble, false);
+
+  KATANA_LOG_ASSERT(builder->StartNode(std::to_string(i)));
+  builder->AddValue(
+      "rank", [&]() { return rank; },
+      Value(ImportDataType::kInt64, static_cast<int64_t>(i)));
+  if (i / kNodesPerShard == 1) {
+    builder->AddValue(
+        "name", [&]() { return name; },
+        Value(ImportDataType::kString, "node" + std::to_string(i)));
+  }
+  if (i / kNodesPerShard == 2) {
+    builder->AddLabel("Even");
+  }
+  KATANA_LOG_ASSERT(builder->FinishNode());
+
+  for (uint32_t j = 0; j < 3; j++) {
+    std::string target = std::to_string((i * 7 + j * 31) % kNumNodes);
+    if (i == kNumNodes - 1 && j == 2) {
+      target = "missing";
+    }
+    KATANA_LOG_ASSERT(builder->StartEdge(std::to_string(i), target));
+    builder->AddValue(
+        "weight", [&]() { return weight; },
+        Value(ImportDataType::kDouble, i + j / 4.0));
+    builder->AddLabel(j == 0 ? "First" : "Other");
+    KATANA_LOG_ASSERT(builder->FinishEdge());
+  }
+}
+
+std::unique_ptr<katana::PropertyGraph>
+ToPropertyGraph(const katana::Result<katana::GraphComponents>& components) {
+  KATANA_LOG_VASSERT(
+      components, "could not build graph: {}", components.error());
+  auto graph = components.value().ToPropertyGraph();
+  KATANA_LOG_VASSERT(graph, "could not build graph: {}", graph.error());
+  return std::move(graph.value());
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  // Nodes are added in order in one builder and shard by shard in parallel,
+  // so the graphs are the same
+  katana::PropertyGraphBuilder builder(7);
+  for (uint32_t i = 0; i < kNumNodes; i++) {
+    AddNode(&builder, i);
+  }
+  auto expected = ToPropertyGraph(builder.Finish(false));
+  KATANA_LOG_ASSERT(expected->num_nodes() == kNumNodes + 1);
+
+  katana::ShardedPropertyGraphBuilder sharded(7, kNumShards);
+  katana::do_all(katana::iterate(uint32_t{0}, kNumShards), [&](uint32_t s) {
+    for (uint32_t i = 0; i < kNodesPerShard; i++) {
+      AddNode(sharded.shard(s), s * kNodesPerShard + i);
+    }
+  });
+  auto graph = ToPropertyGraph(sharded.Finish(false));
+  KATANA_LOG_ASSERT(graph->Equals(expected.get()));
+
+  // A property must have the same type in every shard
+  katana::ShardedPropertyGraphBuilder conflicting(7, 2);
+  AddNode(conflicting.shard(0), 0);
+  PropertyKey rank(
+      "rank", true, false, "rank", ImportDataType::kString, false);
+  KATANA_LOG_ASSERT(conflicting.shard(1)->StartNode("1"));
+  conflicting.shard(1)->AddValue(
+      "rank", [&]() { return rank; },
+      Value(ImportDataType::kString, std::string("one")));
+  KATANA_LOG_ASSERT(conflicting.shard(1)->FinishNode());
+  KATANA_LOG_ASSERT(!conflicting.Finish(false));
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "tsuba/FileView.h"
+#include "tsuba/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr uint64_t kFileSize = (UINT64_C(3) << 20) + 17;
+
+std::vector<uint8_t>
+MakeData(uint8_t seed) {
+  std::vector<uint8_t> data(kFileSize);
+  for (uint64_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 13 + seed);
+  }
+  return data;
+}
+
+std::set<std::string>
+ListEntries(const std::string& dir) {
+  std::set<std::string> entries;
+  if (!fs::exists(dir)) {
+    return entries;
+  }
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    entries.emplace(entry.path().string());
+  }
+  return entries;
+}
+
+/// Bind file through a FileView and check it reads as data
+void
+CheckBind(const std::string& file, const std::vector<uint8_t>& data) {
+  tsuba::FileView fv;
+  auto res = fv.Bind(file, true);
+  KATANA_LOG_VASSERT(res, "binding {}: {}", file, res.error());
+  KATANA_LOG_ASSERT(fv.size() == data.size());
+  KATANA_LOG_VASSERT(
+      std::memcmp(fv.ptr<uint8_t>(), data.data(), data.size()) == 0,
+      "{} does not read as stored", file);
+}
+
+/// Store data at file; bind it so that it is published and \returns the
+/// entry it is published as
+std::string
+StoreAndPublish(
+    const std::string& cache_dir, const std::string& file,
+    const std::vector<uint8_t>& data) {
+  auto res = tsuba::FileStore(file, data.data(), data.size());
+  KATANA_LOG_VASSERT(res, "storing {}: {}", file, res.error());
+
+  std::set<std::string> before = ListEntries(cache_dir);
+  CheckBind(file, data);
+  std::set<std::string> after = ListEntries(cache_dir);
+  KATANA_LOG_ASSERT(after.size() == before.size() + 1);
+  for (const std::string& entry : after) {
+    if (before.count(entry) == 0) {
+      return entry;
+    }
+  }
+  KATANA_LOG_FATAL("{} was not published", file);
+}
+
+/// Entries are only used for the file whose URI they store, even when the
+/// name of the entry of another file collides with theirs
+void
+TestCollision(const std::string& dir, const std::string& cache_dir) {
+  std::vector<uint8_t> first = MakeData(1);
+  std::vector<uint8_t> second = MakeData(2);
+  std::string first_file = dir + "/first";
+  std::string second_file = dir + "/secnd";
+
+  std::string first_entry = StoreAndPublish(cache_dir, first_file, first);
+  std::string second_entry = StoreAndPublish(cache_dir, second_file, second);
+  KATANA_LOG_ASSERT(first_entry != second_entry);
+
+  // Loads of published files map their entries
+  CheckBind(first_file, first);
+  CheckBind(second_file, second);
+
+  // Make the entry of the second file a copy of the first, as a collision of
+  // the hashes of their URIs would
+  fs::remove(second_entry);
+  fs::copy_file(first_entry, second_entry);
+  CheckBind(second_file, second);
+  CheckBind(first_file, first);
+
+  // The load from storage published the second file again
+  CheckBind(second_file, second);
+  KATANA_LOG_ASSERT(ListEntries(cache_dir).size() == 2);
+}
+
+/// An entry that does not hold its whole key is not used
+void
+TestTruncatedEntry(const std::string& dir, const std::string& cache_dir) {
+  std::vector<uint8_t> data = MakeData(3);
+  std::string file = dir + "/truncated";
+  std::string entry = StoreAndPublish(cache_dir, file, data);
+
+  fs::resize_file(entry, kFileSize);
+  CheckBind(file, data);
+}
+
+}  // namespace
+
+int
+main() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/sharedcache");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());
+  std::string cache_dir = dir + "/cache";
+  fs::create_directories(dir);
+
+  // The cache is configured when it is first used
+  setenv("KATANA_SHARED_CACHE_DIR", cache_dir.c_str(), 1);
+  {
+    katana::SharedMemSys sys;
+
+    TestCollision(dir, cache_dir);
+    TestTruncatedEntry(dir, cache_dir);
+  }
+
+  fs::remove_all(dir);
+  return 0;
+}
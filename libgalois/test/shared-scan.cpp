@@ -0,0 +1,143 @@
+#include "katana/analytics/SharedScan.h"
+
+#include <cmath>
+#include <vector>
+
+#include "katana/GraphGenerator.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using katana::analytics::DegreeKernel;
+using katana::analytics::LabelPropagationKernel;
+using katana::analytics::NeighborMeanKernel;
+using katana::analytics::PagerankKernel;
+using katana::analytics::RunSharedScan;
+using Node = katana::GraphTopology::Node;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(uint64_t num_nodes) {
+  katana::GraphGeneratorOptions opts;
+  opts.num_nodes = num_nodes;
+  opts.num_edges = 2 * num_nodes;
+  opts.seed = 7;
+  opts.symmetric = true;
+  auto res = katana::GenerateGraph(opts);
+  KATANA_LOG_VASSERT(res, "could not generate: {}", res.error());
+  return std::move(res.value());
+}
+
+std::vector<double>
+MakeValues(uint64_t num_nodes) {
+  std::vector<double> values(num_nodes);
+  for (uint64_t i = 0; i < num_nodes; ++i) {
+    values[i] = static_cast<double>(i % 7);
+  }
+  return values;
+}
+
+/// The smallest node of the component of each node
+std::vector<uint64_t>
+Components(const katana::GraphTopology& topology) {
+  std::vector<uint64_t> labels(topology.num_nodes(), topology.num_nodes());
+  for (Node root : topology) {
+    if (labels[root] != topology.num_nodes()) {
+      continue;
+    }
+    std::vector<Node> stack{root};
+    labels[root] = root;
+    while (!stack.empty()) {
+      Node n = stack.back();
+      stack.pop_back();
+      for (auto e : topology.edges(n)) {
+        Node dst = topology.edge_dest(e);
+        if (labels[dst] == topology.num_nodes()) {
+          labels[dst] = root;
+          stack.emplace_back(dst);
+        }
+      }
+    }
+  }
+  return labels;
+}
+
+void
+TestSharedScan() {
+  auto pg = MakeGraph(2000);
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<double> values = MakeValues(topology.num_nodes());
+
+  DegreeKernel degrees(topology);
+  PagerankKernel ranks(topology);
+  LabelPropagationKernel components(topology);
+  NeighborMeanKernel means(values);
+  uint32_t num_iterations =
+      RunSharedScan(topology, degrees, ranks, components, means);
+  KATANA_LOG_ASSERT(num_iterations > 1);
+
+  // Each kernel alone
+  DegreeKernel degrees_alone(topology);
+  KATANA_LOG_ASSERT(RunSharedScan(topology, degrees_alone) == 1);
+  PagerankKernel ranks_alone(topology);
+  uint32_t pagerank_iterations = RunSharedScan(topology, ranks_alone);
+  LabelPropagationKernel components_alone(topology);
+  uint32_t label_iterations = RunSharedScan(topology, components_alone);
+  NeighborMeanKernel means_alone(values);
+  KATANA_LOG_ASSERT(RunSharedScan(topology, means_alone) == 1);
+  KATANA_LOG_ASSERT(
+      num_iterations == std::max(pagerank_iterations, label_iterations));
+
+  KATANA_LOG_ASSERT(degrees.degrees() == degrees_alone.degrees());
+  KATANA_LOG_ASSERT(components.labels() == components_alone.labels());
+  KATANA_LOG_ASSERT(means.means() == means_alone.means());
+  for (Node n : topology) {
+    KATANA_LOG_VASSERT(
+        std::fabs(ranks.ranks()[n] - ranks_alone.ranks()[n]) < 1e-4,
+        "rank of {} is {}, alone {}", n, ranks.ranks()[n],
+        ranks_alone.ranks()[n]);
+  }
+
+  // Against direct computations
+  KATANA_LOG_ASSERT(components.labels() == Components(topology));
+  uint64_t max_degree = 0;
+  for (Node n : topology) {
+    uint64_t degree = topology.edges(n).size();
+    max_degree = std::max(max_degree, degree);
+    KATANA_LOG_ASSERT(degrees.degrees()[n] == degree);
+
+    double sum = 0;
+    for (auto e : topology.edges(n)) {
+      sum += values[topology.edge_dest(e)];
+    }
+    double mean = degree > 0 ? sum / degree : 0;
+    KATANA_LOG_ASSERT(std::fabs(means.means()[n] - mean) < 1e-9);
+  }
+  KATANA_LOG_ASSERT(degrees.max_degree() == max_degree);
+
+  // The graph is symmetric, so its own transpose. Nodes with edges keep
+  // their share of the rank, and nodes without only get the base score.
+  double total = 0;
+  double expected = 0;
+  for (Node n : topology) {
+    KATANA_LOG_ASSERT(ranks.ranks()[n] > 0);
+    total += ranks.ranks()[n];
+    expected += degrees.degrees()[n] > 0 ? 1.0 : 1.0 - 0.85;
+  }
+  expected /= topology.num_nodes();
+  KATANA_LOG_VASSERT(
+      std::fabs(total - expected) < 0.01, "ranks sum to {}, not {}", total,
+      expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestSharedScan();
+
+  return 0;
+}
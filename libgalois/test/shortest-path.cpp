@@ -0,0 +1,144 @@
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using DataType = int64_t;
+using Weight = uint32_t;
+using katana::analytics::ShortestPathPlan;
+using katana::analytics::ShortestPathResult;
+
+/// Add the edge property "weight" with random weights in [0, 9]
+void
+AddWeights(katana::PropertyGraph* pg) {
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<Weight> dist(0, 9);
+  std::vector<Weight> weights(pg->topology().num_edges());
+  for (auto& w : weights) {
+    w = dist(gen);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)});
+  auto res = pg->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(res, "could not add weights: {}", res.error());
+}
+
+/// Check that result is a path from source to target of the expected
+/// distance, which is infinite if target is unreachable
+void
+CheckPath(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t target,
+    double expected, const ShortestPathResult& result) {
+  if (expected == std::numeric_limits<double>::infinity()) {
+    KATANA_LOG_VASSERT(
+        !result.reachable(), "found a path from {} to unreachable {}", source,
+        target);
+    return;
+  }
+  KATANA_LOG_VASSERT(
+      result.distance == expected, "distance from {} to {} is {} not {}",
+      source, target, result.distance, expected);
+  KATANA_LOG_ASSERT(result.path.front() == source);
+  KATANA_LOG_ASSERT(result.path.back() == target);
+
+  const katana::GraphTopology& topology = pg->topology();
+  auto weights = pg->GetEdgePropertyTyped<Weight>("weight").value();
+  double weight = 0;
+  for (size_t i = 0; i + 1 < result.path.size(); ++i) {
+    double lightest = std::numeric_limits<double>::infinity();
+    for (auto e : topology.edges(result.path[i])) {
+      if (topology.edge_dest(e) == result.path[i + 1]) {
+        lightest = std::min(lightest, double(weights->Value(e)));
+      }
+    }
+    weight += lightest;
+  }
+  KATANA_LOG_VASSERT(
+      weight == expected, "path from {} to {} weighs {} not {}", source,
+      target, weight, expected);
+}
+
+void
+TestQueries(Policy* policy, size_t num_nodes, ShortestPathPlan plan) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  AddWeights(pg.get());
+  if (plan.algorithm() == ShortestPathPlan::kLandmarks) {
+    auto res = katana::analytics::ShortestPathLandmarks(
+        pg.get(), "weight", plan.landmarks_property_prefix(), 4);
+    KATANA_LOG_VASSERT(res, "landmarks failed: {}", res.error());
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> queries;
+  std::vector<double> expected;
+  for (uint32_t source = 0; source < num_nodes; source += 7) {
+    auto res = katana::analytics::Sssp(
+        pg.get(), source, "weight", "distance",
+        katana::analytics::SsspPlan::Dijkstra());
+    KATANA_LOG_VASSERT(res, "sssp failed: {}", res.error());
+    auto distances = pg->GetNodePropertyTyped<Weight>("distance").value();
+
+    for (uint32_t target = 0; target < num_nodes; ++target) {
+      double distance = distances->Value(target);
+      if (distances->Value(target) >= std::numeric_limits<Weight>::max() / 4) {
+        distance = std::numeric_limits<double>::infinity();
+      }
+      auto path_res = katana::analytics::ShortestPath(
+          pg.get(), source, target, "weight", plan);
+      KATANA_LOG_VASSERT(path_res, "query failed: {}", path_res.error());
+      CheckPath(pg.get(), source, target, distance, path_res.value());
+
+      queries.emplace_back(source, target);
+      expected.emplace_back(distance);
+    }
+    auto remove_res = pg->RemoveNodeProperty("distance");
+    KATANA_LOG_VASSERT(remove_res, "remove failed: {}", remove_res.error());
+  }
+
+  auto batch_res =
+      katana::analytics::ShortestPaths(pg.get(), queries, "weight", plan);
+  KATANA_LOG_VASSERT(batch_res, "batch failed: {}", batch_res.error());
+  KATANA_LOG_ASSERT(batch_res.value().size() == queries.size());
+  for (size_t i = 0; i < queries.size(); ++i) {
+    CheckPath(
+        pg.get(), queries[i].first, queries[i].second, expected[i],
+        batch_res.value()[i]);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (auto plan :
+       {ShortestPathPlan::BidirectionalDijkstra(),
+        ShortestPathPlan::Dijkstra(),
+        ShortestPathPlan::Landmarks("landmark")}) {
+    LinePolicy cycle{1};
+    TestQueries(&cycle, 50, plan);
+
+    for (size_t width : {1, 2, 4}) {
+      RandomPolicy random{width};
+      TestQueries(&random, 200, plan);
+    }
+  }
+
+  // Queries must name nodes of the graph
+  LinePolicy line{2};
+  auto pg = MakeFileGraph<DataType>(10, 0, &line);
+  AddWeights(pg.get());
+  auto res = katana::analytics::ShortestPath(pg.get(), 0, 10, "weight");
+  KATANA_LOG_ASSERT(!res);
+
+  // Landmark queries need the landmarks to be built first
+  res = katana::analytics::ShortestPath(
+      pg.get(), 0, 5, "weight", ShortestPathPlan::Landmarks("landmark"));
+  KATANA_LOG_ASSERT(!res);
+
+  return 0;
+}
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/jaccard/jaccard.h"
+
+using katana::analytics::SimilarityTopKPlan;
+using Node = katana::GraphTopology::Node;
+
+/// The Jaccard similarity of the sets of out-neighbors of u and v, which
+/// MinHash estimates
+double
+SetJaccard(const katana::GraphTopology& topology, Node u, Node v) {
+  auto neighbors = [&](Node n) {
+    std::vector<Node> r;
+    for (auto e : topology.edges(n)) {
+      r.emplace_back(topology.edge_dest(e));
+    }
+    std::sort(r.begin(), r.end());
+    r.erase(std::unique(r.begin(), r.end()), r.end());
+    return r;
+  };
+  std::vector<Node> u_neighbors = neighbors(u);
+  std::vector<Node> v_neighbors = neighbors(v);
+  std::vector<Node> common;
+  std::set_intersection(
+      u_neighbors.begin(), u_neighbors.end(), v_neighbors.begin(),
+      v_neighbors.end(), std::back_inserter(common));
+  return double(common.size()) /
+         (u_neighbors.size() + v_neighbors.size() - common.size());
+}
+
+/// The similarity of every pair sharing an out-neighbor, by brute force
+std::vector<std::vector<std::pair<double, Node>>>
+ExpectedCandidates(
+    const katana::GraphTopology& topology,
+    SimilarityTopKPlan::Measure measure) {
+  uint64_t num_nodes = topology.num_nodes();
+  std::vector<uint64_t> in_degree(num_nodes);
+  for (uint64_t e = 0; e < topology.num_edges(); ++e) {
+    ++in_degree[topology.edge_dest(e)];
+  }
+
+  std::vector<std::vector<std::pair<double, Node>>> candidates(num_nodes);
+  for (Node u = 0; u < num_nodes; ++u) {
+    for (Node v = 0; v < num_nodes; ++v) {
+      if (u == v) {
+        continue;
+      }
+      double paths = 0;
+      for (auto e : topology.edges(u)) {
+        for (auto f : topology.edges(v)) {
+          Node w = topology.edge_dest(e);
+          if (topology.edge_dest(f) == w) {
+            paths += measure == SimilarityTopKPlan::kAdamicAdar
+                         ? 1.0 / std::log(double(in_degree[w]))
+                         : 1.0;
+          }
+        }
+      }
+      if (paths == 0) {
+        continue;
+      }
+      double u_degree = topology.edges(u).size();
+      double v_degree = topology.edges(v).size();
+      double score = paths;
+      if (measure == SimilarityTopKPlan::kJaccard) {
+        score = paths / (u_degree + v_degree - paths);
+      } else if (measure == SimilarityTopKPlan::kCosine) {
+        score = paths / std::sqrt(u_degree * v_degree);
+      }
+      candidates[u].emplace_back(score, v);
+    }
+    std::sort(
+        candidates[u].begin(), candidates[u].end(),
+        [](const auto& a, const auto& b) {
+          return a.first > b.first ||
+                 (a.first == b.first && a.second < b.second);
+        });
+  }
+  return candidates;
+}
+
+void
+TestSimilarityTopK(
+    size_t num_nodes, Policy* policy, SimilarityTopKPlan plan, uint32_t k) {
+  auto pg = MakeFileGraph<uint32_t>(num_nodes, 0, policy);
+  const katana::GraphTopology& topology = pg->topology();
+
+  auto res = katana::analytics::SimilarityTopK(
+      pg.get(), k, "top-nodes", "top-scores", plan);
+  KATANA_LOG_VASSERT(res, "SimilarityTopK failed: {}", res.error());
+  auto nodes_list = std::static_pointer_cast<arrow::FixedSizeListArray>(
+      pg->GetNodeProperty("top-nodes")->chunk(0));
+  auto scores_list = std::static_pointer_cast<arrow::FixedSizeListArray>(
+      pg->GetNodeProperty("top-scores")->chunk(0));
+  KATANA_LOG_ASSERT(static_cast<uint32_t>(nodes_list->value_length()) == k);
+  auto nodes =
+      std::static_pointer_cast<arrow::UInt32Array>(nodes_list->values());
+  auto scores =
+      std::static_pointer_cast<arrow::DoubleArray>(scores_list->values());
+
+  bool min_hash = plan.num_hashes() > 0;
+  auto expected = ExpectedCandidates(topology, plan.measure());
+  for (Node u = 0; u < num_nodes; ++u) {
+    const auto& candidates = expected[u];
+    for (uint32_t i = 0; i < k; ++i) {
+      Node found = nodes->Value(uint64_t{u} * k + i);
+      double found_score = scores->Value(uint64_t{u} * k + i);
+      if (i >= candidates.size()) {
+        KATANA_LOG_VASSERT(
+            found == katana::analytics::kSimilarityTopKNoNode,
+            "node {} has only {} candidates", u, candidates.size());
+        continue;
+      }
+      if (min_hash) {
+        // Any candidate, with an estimate near its similarity
+        auto it = std::find_if(
+            candidates.begin(), candidates.end(),
+            [&](const auto& c) { return c.second == found; });
+        KATANA_LOG_VASSERT(
+            it != candidates.end(), "{} is not a candidate of {}", found, u);
+        double similarity = SetJaccard(topology, u, found);
+        KATANA_LOG_VASSERT(
+            std::fabs(found_score - similarity) < 0.25,
+            "estimate {} of similarity {} of {} and {}", found_score,
+            similarity, u, found);
+        continue;
+      }
+      KATANA_LOG_VASSERT(
+          std::fabs(found_score - candidates[i].first) < 1e-9,
+          "node {} rank {}: score {} != {}", u, i, found_score,
+          candidates[i].first);
+      if (plan.measure() != SimilarityTopKPlan::kAdamicAdar) {
+        // Exact scores, so ties are broken the same way
+        KATANA_LOG_VASSERT(
+            found == candidates[i].second, "node {} rank {}: {} != {}", u, i,
+            found, candidates[i].second);
+      }
+    }
+  }
+}
+
+/// On the line every node has in-degree width, so with a lower bound no
+/// common neighbor is followed
+void
+TestHubsSkipped(size_t num_nodes, size_t width) {
+  LinePolicy line{width};
+  auto pg = MakeFileGraph<uint32_t>(num_nodes, 0, &line);
+  auto res = katana::analytics::SimilarityTopK(
+      pg.get(), 2, "top-nodes", "top-scores",
+      SimilarityTopKPlan::Jaccard(width - 1));
+  KATANA_LOG_VASSERT(res, "SimilarityTopK failed: {}", res.error());
+  auto nodes_list = std::static_pointer_cast<arrow::FixedSizeListArray>(
+      pg->GetNodeProperty("top-nodes")->chunk(0));
+  auto nodes =
+      std::static_pointer_cast<arrow::UInt32Array>(nodes_list->values());
+  for (int64_t i = 0; i < nodes->length(); ++i) {
+    KATANA_LOG_ASSERT(
+        nodes->Value(i) == katana::analytics::kSimilarityTopKNoNode);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy line{4};
+  TestSimilarityTopK(100, &line, SimilarityTopKPlan::Jaccard(), 4);
+  TestSimilarityTopK(100, &line, SimilarityTopKPlan::Cosine(), 10);
+  TestHubsSkipped(100, 4);
+
+  RandomPolicy random{3};
+  TestSimilarityTopK(300, &random, SimilarityTopKPlan::Jaccard(), 5);
+  TestSimilarityTopK(300, &random, SimilarityTopKPlan::Cosine(), 5);
+  TestSimilarityTopK(300, &random, SimilarityTopKPlan::AdamicAdar(), 5);
+  TestSimilarityTopK(300, &random, SimilarityTopKPlan::MinHashJaccard(256), 5);
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/SparseBitmap.h"
+
+constexpr katana::SparseBitmapKernel kKernels[] = {
+    katana::SparseBitmapKernel::kScalar,
+    katana::SparseBitmapKernel::kAVX2,
+    katana::SparseBitmapKernel::kAVX512,
+};
+
+std::vector<uint32_t>
+RandomSet(std::mt19937* gen, size_t size, size_t universe) {
+  std::uniform_int_distribution<uint32_t> dist(0, universe - 1);
+  std::vector<uint32_t> values(size);
+  for (auto& v : values) {
+    v = dist(*gen);
+  }
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  return values;
+}
+
+katana::SparseBitmap
+MakeBitmap(const std::vector<uint32_t>& values) {
+  katana::SparseBitmap bitmap;
+  // Insert out of order to exercise insertion of blocks in the middle
+  for (auto it = values.rbegin(); it != values.rend(); ++it) {
+    KATANA_LOG_ASSERT(bitmap.set(*it));
+    KATANA_LOG_ASSERT(!bitmap.set(*it));
+  }
+  KATANA_LOG_ASSERT(bitmap.ToVector() == values);
+  KATANA_LOG_ASSERT(bitmap.size() == values.size());
+  for (uint32_t v : values) {
+    KATANA_LOG_ASSERT(bitmap.test(v));
+  }
+  return bitmap;
+}
+
+void
+TestKernels(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  std::vector<uint32_t> both;
+  std::set_union(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(both));
+  std::vector<uint32_t> b_minus_a;
+  std::set_difference(
+      b.begin(), b.end(), a.begin(), a.end(), std::back_inserter(b_minus_a));
+  std::vector<uint32_t> a_minus_b;
+  std::set_difference(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(a_minus_b));
+
+  katana::SparseBitmap bitmap_a = MakeBitmap(a);
+  katana::SparseBitmap bitmap_b = MakeBitmap(b);
+  KATANA_LOG_ASSERT(bitmap_a.IsSubsetOf(bitmap_a));
+  KATANA_LOG_ASSERT(bitmap_a.IsSubsetOf(bitmap_b) == a_minus_b.empty());
+
+  for (auto kernel : kKernels) {
+    if (!katana::IsSparseBitmapKernelSupported(kernel)) {
+      continue;
+    }
+    katana::SparseBitmap result = bitmap_a;
+    katana::SparseBitmap added;
+    bool changed = result.UnionWith(kernel, bitmap_b, &added);
+    KATANA_LOG_VASSERT(
+        result.ToVector() == both && added.ToVector() == b_minus_a,
+        "kernel {}: wrong union", static_cast<int>(kernel));
+    KATANA_LOG_ASSERT(changed == !b_minus_a.empty());
+    KATANA_LOG_ASSERT(bitmap_a.IsSubsetOf(result));
+    KATANA_LOG_ASSERT(bitmap_b.IsSubsetOf(result));
+
+    // A second union changes nothing
+    KATANA_LOG_ASSERT(!result.UnionWith(kernel, bitmap_b, &added));
+    KATANA_LOG_ASSERT(added.empty());
+    KATANA_LOG_ASSERT(!result.UnionWith(kernel, bitmap_a));
+
+    katana::SparseBitmap diff;
+    diff.AssignDifference(kernel, bitmap_a, bitmap_b);
+    KATANA_LOG_VASSERT(
+        diff.ToVector() == a_minus_b, "kernel {}: wrong difference",
+        static_cast<int>(kernel));
+    // Empty blocks are dropped, so equal sets compare equal
+    diff.AssignDifference(kernel, result, bitmap_a);
+    KATANA_LOG_ASSERT(diff == MakeBitmap(b_minus_a));
+  }
+
+  katana::SparseBitmap result = bitmap_b;
+  result.UnionWith(bitmap_a);
+  KATANA_LOG_ASSERT(result.ToVector() == both);
+  KATANA_LOG_ASSERT((result == bitmap_b) == a_minus_b.empty());
+}
+
+int
+main() {
+  std::mt19937 gen(0);
+
+  TestKernels({}, {});
+  TestKernels({1, 2, 3}, {});
+  TestKernels({}, {1, 2, 3});
+  TestKernels({1, 2, 3}, {1, 2, 3});
+  TestKernels({0, 511, 512, 4000000000}, {511, 1023, 4294967295});
+
+  // Dense and sparse sets, with few and many blocks in common
+  for (size_t size : {1, 10, 100, 1000, 3000}) {
+    for (size_t universe : {2 * size, 1000 * size, size_t{4000000000}}) {
+      TestKernels(
+          RandomSet(&gen, size, universe), RandomSet(&gen, size, universe));
+      TestKernels(
+          RandomSet(&gen, size, universe),
+          RandomSet(&gen, 10 * size, universe));
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/Sparsify.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using katana::analytics::SparsifiedGraph;
+using katana::analytics::SparsifyPlan;
+
+namespace {
+
+/// A random symmetric graph with the node property "id"
+std::unique_ptr<katana::PropertyGraph>
+MakeSymmetricGraph(size_t num_nodes, size_t width) {
+  RandomPolicy policy{width};
+  auto g = MakeFileGraph<uint32_t>(num_nodes, 0, &policy);
+  auto res = katana::CreateSymmetricGraph(g.get());
+  KATANA_LOG_ASSERT(res);
+  std::unique_ptr<katana::PropertyGraph> symmetric = std::move(res.value());
+
+  arrow::UInt32Builder builder;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_ASSERT(builder.Append(n).ok());
+  }
+  if (auto r = symmetric->AddNodeProperties(arrow::Table::Make(
+          arrow::schema({arrow::field("id", arrow::uint32())}),
+          {builder.Finish().ValueOrDie()}));
+      !r) {
+    KATANA_LOG_FATAL("could not add node property: {}", r.error());
+  }
+  return symmetric;
+}
+
+std::multiset<std::pair<uint32_t, uint32_t>>
+Edges(const katana::GraphTopology& topology) {
+  std::multiset<std::pair<uint32_t, uint32_t>> edges;
+  for (auto n : topology) {
+    for (auto e : topology.edges(n)) {
+      edges.emplace(n, topology.edge_dest(e));
+    }
+  }
+  return edges;
+}
+
+/// Sparsify pg with plan and check that the sample is a symmetric subgraph
+/// on the same nodes with about the fraction of edges asked for
+void
+TestSparsify(
+    katana::PropertyGraph* pg, const SparsifyPlan& plan, double slack) {
+  auto res = katana::analytics::Sparsify(pg, plan, {"id"}, {});
+  KATANA_LOG_VASSERT(res, "Sparsify failed: {}", res.error());
+  const SparsifiedGraph& sample = res.value();
+  const katana::GraphTopology& topology = sample.graph->topology();
+
+  KATANA_LOG_ASSERT(topology.num_nodes() == pg->num_nodes());
+  KATANA_LOG_ASSERT(
+      sample.edge_fraction ==
+      static_cast<double>(topology.num_edges()) / pg->num_edges());
+  KATANA_LOG_VASSERT(
+      std::abs(sample.edge_fraction - plan.edge_fraction()) <= slack,
+      "kept {} of the edges, not about {}", sample.edge_fraction,
+      plan.edge_fraction());
+
+  auto edges = Edges(topology);
+  auto original = Edges(pg->topology());
+  for (const auto& [src, dst] : edges) {
+    KATANA_LOG_ASSERT(original.count({src, dst}) > 0);
+    KATANA_LOG_ASSERT(edges.count({dst, src}) > 0);
+  }
+
+  // Node properties are shared, not copied
+  KATANA_LOG_ASSERT(
+      sample.graph->GetNodeProperty("id")->chunk(0)->data() ==
+      pg->GetNodeProperty("id")->chunk(0)->data());
+  auto weights_res = sample.graph->GetEdgePropertyTyped<double>(
+      SparsifiedGraph::kWeightProperty);
+  KATANA_LOG_ASSERT(weights_res);
+  for (int64_t e = 0; e < weights_res.value()->length(); ++e) {
+    KATANA_LOG_ASSERT(weights_res.value()->Value(e) >= 1);
+  }
+}
+
+void
+TestApproximateAnalytics() {
+  auto pg = MakeSymmetricGraph(2000, 4);
+  SparsifyPlan all = SparsifyPlan::UniformEdge(1);
+
+  // On the whole graph the bound only measures convergence
+  auto pr_res = katana::analytics::ApproximatePagerank(
+      pg.get(), "rank-all", all,
+      katana::analytics::PagerankPlan::PullTopological(1e-7));
+  KATANA_LOG_VASSERT(pr_res, "ApproximatePagerank failed: {}", pr_res.error());
+  KATANA_LOG_VASSERT(
+      pr_res.value().estimated_error < 1e-2, "error bound {}",
+      pr_res.value().estimated_error);
+  pr_res = katana::analytics::ApproximatePagerank(
+      pg.get(), "rank", SparsifyPlan::DegreeBiasedEdge(0.3));
+  KATANA_LOG_ASSERT(pr_res && pr_res.value().estimated_error >= 0);
+  pr_res.value().Print();
+
+  auto cc_res = katana::analytics::ApproximateConnectedComponents(
+      pg.get(), "component-all", all);
+  KATANA_LOG_ASSERT(cc_res && cc_res.value().estimated_error == 0);
+  cc_res = katana::analytics::ApproximateConnectedComponents(
+      pg.get(), "component", SparsifyPlan::Spectral(0.3));
+  KATANA_LOG_ASSERT(cc_res);
+  KATANA_LOG_ASSERT(
+      cc_res.value().estimated_error >= 0 &&
+      cc_res.value().estimated_error <= 1);
+
+  auto lcc_res = katana::analytics::ApproximateLocalClusteringCoefficient(
+      pg.get(), "lcc-all", all);
+  KATANA_LOG_ASSERT(lcc_res);
+  lcc_res = katana::analytics::ApproximateLocalClusteringCoefficient(
+      pg.get(), "lcc", SparsifyPlan::ForestFire(0.3));
+  KATANA_LOG_ASSERT(lcc_res);
+  KATANA_LOG_ASSERT(lcc_res.value().estimated_error > 0);
+
+  // With all the edges, the approximation is exact
+  auto exact_res = katana::analytics::LocalClusteringCoefficient(
+      pg.get(), "lcc-exact",
+      katana::analytics::LocalClusteringCoefficientPlan::OrderedCountPerThread(
+          false,
+          katana::analytics::LocalClusteringCoefficientPlan::kNoRelabel));
+  KATANA_LOG_ASSERT(exact_res);
+  auto approximate = pg->GetNodePropertyTyped<double>("lcc-all").value();
+  auto exact = pg->GetNodePropertyTyped<double>("lcc-exact").value();
+  for (int64_t n = 0; n < exact->length(); ++n) {
+    KATANA_LOG_ASSERT(
+        std::abs(approximate->Value(n) - exact->Value(n)) < 1e-9);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  auto pg = MakeSymmetricGraph(3000, 5);
+  TestSparsify(pg.get(), SparsifyPlan::UniformEdge(0.3), 0.03);
+  TestSparsify(pg.get(), SparsifyPlan::UniformEdge(1), 0);
+  TestSparsify(pg.get(), SparsifyPlan::DegreeBiasedEdge(0.3), 0.05);
+  TestSparsify(pg.get(), SparsifyPlan::Spectral(0.2), 0.05);
+  // Fires stop once their induced subgraph has enough edges
+  TestSparsify(pg.get(), SparsifyPlan::ForestFire(0.3), 0.3);
+  auto ff_res =
+      katana::analytics::Sparsify(pg.get(), SparsifyPlan::ForestFire(0.3));
+  KATANA_LOG_ASSERT(ff_res && ff_res.value().edge_fraction >= 0.3);
+
+  KATANA_LOG_ASSERT(
+      !katana::analytics::Sparsify(pg.get(), SparsifyPlan::UniformEdge(0)));
+  KATANA_LOG_ASSERT(!katana::analytics::Sparsify(
+      pg.get(), SparsifyPlan::ForestFire(0.5, 1)));
+
+  TestApproximateAnalytics();
+
+  return 0;
+}
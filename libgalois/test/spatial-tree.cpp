@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/SpatialTree.h"
+#include "katana/Threads.h"
+
+template <size_t Dim>
+using Point = typename katana::SpatialTree<Dim>::Point;
+template <size_t Dim>
+using Points = std::vector<Point<Dim>>;
+
+template <size_t Dim>
+Points<Dim>
+RandomPoints(size_t num_points) {
+  std::uniform_real_distribution<double> coordinate(-10.0, 10.0);
+  Points<Dim> points(num_points);
+  for (auto& p : points) {
+    for (double& x : p) {
+      x = coordinate(katana::GetGenerator());
+    }
+  }
+  return points;
+}
+
+/// The ids of the k points nearest to q other than exclude, by brute force
+template <size_t Dim>
+std::vector<uint64_t>
+BruteNearest(
+    const Points<Dim>& points, const Point<Dim>& q, size_t k,
+    uint64_t exclude) {
+  std::vector<std::pair<double, uint64_t>> all;
+  for (uint64_t i = 0; i < points.size(); ++i) {
+    if (i != exclude) {
+      all.emplace_back(katana::SpatialTree<Dim>::distance2(q, points[i]), i);
+    }
+  }
+  std::sort(all.begin(), all.end());
+  std::vector<uint64_t> ids;
+  for (size_t i = 0; i < std::min(k, all.size()); ++i) {
+    ids.emplace_back(all[i].second);
+  }
+  return ids;
+}
+
+template <size_t Dim>
+void
+TestSpatialTree(size_t num_points, size_t k) {
+  using Tree = katana::SpatialTree<Dim>;
+  Points<Dim> points = RandomPoints<Dim>(num_points);
+  // Duplicates are distinct points
+  if (num_points > 1) {
+    points[1] = points[0];
+  }
+  Tree tree;
+  tree.bulkLoad(points);
+  KATANA_LOG_ASSERT(tree.size() == num_points);
+
+  Points<Dim> queries = RandomPoints<Dim>(100);
+  std::vector<uint64_t> neighbors = tree.batchNearest(queries, k);
+  for (size_t i = 0; i < queries.size(); ++i) {
+    std::vector<uint64_t> expected =
+        BruteNearest<Dim>(points, queries[i], k, Tree::kNoPoint);
+    KATANA_LOG_ASSERT(tree.nearest(queries[i], k) == expected);
+    expected.resize(k, Tree::kNoPoint);
+    KATANA_LOG_ASSERT(std::equal(
+        expected.begin(), expected.end(), neighbors.begin() + k * i));
+  }
+
+  std::vector<uint64_t> knn = tree.allNearest(k);
+  for (uint64_t i = 0; i < num_points; ++i) {
+    std::vector<uint64_t> expected = BruteNearest<Dim>(points, points[i], k, i);
+    expected.resize(k, Tree::kNoPoint);
+    KATANA_LOG_VASSERT(
+        std::equal(expected.begin(), expected.end(), knn.begin() + k * i),
+        "neighbors of point {}", i);
+  }
+
+  std::vector<typename Tree::Box> boxes;
+  for (const auto& q : queries) {
+    typename Tree::Box box = Tree::Box::emptyBox();
+    box.extend(q);
+    for (auto& x : box.hi) {
+      x += 3.0;
+    }
+    boxes.emplace_back(box);
+  }
+  auto in_range = tree.batchInRange(boxes);
+  auto in_radius = tree.batchInRadius(queries, 3.0);
+  for (size_t i = 0; i < queries.size(); ++i) {
+    std::vector<uint64_t> range_expected;
+    std::vector<uint64_t> radius_expected;
+    for (uint64_t j = 0; j < num_points; ++j) {
+      if (boxes[i].contains(points[j])) {
+        range_expected.emplace_back(j);
+      }
+      if (Tree::distance2(queries[i], points[j]) <= 9.0) {
+        radius_expected.emplace_back(j);
+      }
+    }
+    std::sort(in_range[i].begin(), in_range[i].end());
+    std::sort(in_radius[i].begin(), in_radius[i].end());
+    KATANA_LOG_ASSERT(in_range[i] == range_expected);
+    KATANA_LOG_ASSERT(in_radius[i] == radius_expected);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    TestSpatialTree<2>(0, 4);
+    TestSpatialTree<2>(5, 8);
+    TestSpatialTree<2>(3000, 8);
+    TestSpatialTree<3>(3000, 8);
+    TestSpatialTree<3>(1000, 1);
+  }
+
+  return 0;
+}
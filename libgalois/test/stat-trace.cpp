@@ -0,0 +1,102 @@
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Galois.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/Uri.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+nlohmann::json
+ReadStats(const std::string& file) {
+  std::ifstream in(file);
+  KATANA_LOG_VASSERT(in.good(), "no stats in {}", file);
+  std::stringstream buf;
+  buf << in.rdbuf();
+  std::string text = buf.str();
+  auto res = katana::JsonParse<nlohmann::json>(text);
+  KATANA_LOG_VASSERT(res, "stats are not JSON: {}", text);
+  return res.value();
+}
+
+/// \returns the complete events of the trace named name
+size_t
+CountEvents(const nlohmann::json& doc, const std::string& name) {
+  size_t count = 0;
+  for (const auto& event : doc.at("traceEvents")) {
+    if (event.at("name") != name) {
+      continue;
+    }
+    KATANA_LOG_ASSERT(event.at("ph") == "X");
+    KATANA_LOG_ASSERT(event.at("cat") == "Time");
+    KATANA_LOG_ASSERT(event.at("ts").is_number_unsigned());
+    KATANA_LOG_ASSERT(event.at("dur").is_number_unsigned());
+    count += 1;
+  }
+  return count;
+}
+
+/// Loops and timers print as trace events, next to the statistics
+void
+TestTrace(const std::string& file) {
+  katana::SetStatFile(file);
+
+  constexpr uint32_t kLoops = 3;
+  for (uint32_t i = 0; i < kLoops; ++i) {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, uint32_t{1} << 16), [](uint32_t) {},
+        katana::loopname("TraceLoop"));
+  }
+  {
+    katana::StatTimer timer("Time", "TracePhase");
+    timer.start();
+    timer.stop();
+  }
+  // Loops without a name are not timed
+  katana::do_all(katana::iterate(uint32_t{0}, uint32_t{100}), [](uint32_t) {});
+  katana::ReportStatSingle("TraceTest", "Answer", 42);
+
+  katana::PrintStats();
+  nlohmann::json doc = ReadStats(file);
+
+  KATANA_LOG_ASSERT(CountEvents(doc, "TraceLoop") == kLoops);
+  KATANA_LOG_ASSERT(CountEvents(doc, "TracePhase") == 1);
+  KATANA_LOG_ASSERT(doc.at("traceEvents").size() >= kLoops + 1);
+
+  const auto& answer = doc.at("stats").at("TraceTest").at("Answer");
+  KATANA_LOG_ASSERT(answer.at("total") == 42);
+  KATANA_LOG_ASSERT(answer.at("thread_values").size() >= 1);
+  KATANA_LOG_ASSERT(doc.at("stats").at("TraceLoop").contains("Iterations"));
+}
+
+}  // namespace
+
+int
+main() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/stattrace");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());
+  fs::create_directories(dir);
+
+  // The format is chosen when the statistics manager is made
+  setenv("KATANA_STAT_FORMAT", "json", 1);
+  {
+    katana::SharedMemSys sys;
+    katana::setActiveThreads(2);
+
+    TestTrace(dir + "/stats.json");
+  }
+
+  fs::remove_all(dir);
+  return 0;
+}
@@ -0,0 +1,76 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/StealingDeque.h"
+
+void
+TestDequeOrder() {
+  // Enough elements to force the deque to grow a few times
+  constexpr int kNum = 1000;
+  std::vector<int> values(kNum);
+
+  katana::ChaseLevDeque<int*> deque;
+  KATANA_LOG_ASSERT(deque.empty());
+  KATANA_LOG_ASSERT(!deque.pop());
+  KATANA_LOG_ASSERT(!deque.steal());
+
+  for (int i = 0; i < kNum; ++i) {
+    deque.push(&values[i]);
+  }
+
+  // Thieves take the oldest element, the owner the newest
+  KATANA_LOG_ASSERT(deque.steal() == &values[0]);
+  KATANA_LOG_ASSERT(deque.pop() == &values[kNum - 1]);
+
+  for (int i = kNum - 2; i > 0; --i) {
+    int* v = deque.pop();
+    KATANA_LOG_VASSERT(v == &values[i], "expected element {}", i);
+  }
+  KATANA_LOG_ASSERT(deque.empty());
+  KATANA_LOG_ASSERT(!deque.pop());
+}
+
+template <typename WL>
+void
+TestForEach() {
+  // Each item n spawns 2n and 2n + 1, so every item in [1, kNum) is
+  // generated exactly once from the single initial item
+  constexpr uint32_t kNum = 1 << 18;
+  std::vector<std::atomic<uint32_t>> counts(kNum);
+  for (auto& c : counts) {
+    c = 0;
+  }
+
+  std::vector<uint32_t> init{1};
+  katana::for_each(
+      katana::iterate(init),
+      [&](uint32_t n, auto& ctx) {
+        counts[n] += 1;
+        for (uint32_t child : {2 * n, 2 * n + 1}) {
+          if (child < kNum) {
+            ctx.push(child);
+          }
+        }
+      },
+      katana::wl<WL>(), katana::disable_conflict_detection(),
+      katana::loopname("StealingForEach"));
+
+  for (uint32_t n = 1; n < kNum; ++n) {
+    KATANA_LOG_VASSERT(
+        counts[n] == 1, "item {} processed {} times", n, counts[n].load());
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestDequeOrder();
+  TestForEach<katana::StealingChunkFIFO<16>>();
+  TestForEach<katana::StealingChunkLIFO<16>>();
+
+  return 0;
+}
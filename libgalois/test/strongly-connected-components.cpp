@@ -0,0 +1,96 @@
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+using DataType = int64_t;
+using katana::analytics::StronglyConnectedComponentsPlan;
+
+/// \returns, for each node, whether it reaches each other node
+std::vector<std::vector<bool>>
+Reachability(const katana::GraphTopology& topology) {
+  size_t num_nodes = topology.num_nodes();
+  std::vector<std::vector<bool>> reaches(
+      num_nodes, std::vector<bool>(num_nodes));
+  for (uint32_t src = 0; src < num_nodes; ++src) {
+    std::vector<uint32_t> stack{src};
+    reaches[src][src] = true;
+    while (!stack.empty()) {
+      uint32_t n = stack.back();
+      stack.pop_back();
+      for (auto e : topology.edges(n)) {
+        uint32_t dst = topology.edge_dest(e);
+        if (!reaches[src][dst]) {
+          reaches[src][dst] = true;
+          stack.emplace_back(dst);
+        }
+      }
+    }
+  }
+  return reaches;
+}
+
+void
+TestComponents(
+    Policy* policy, size_t num_nodes, StronglyConnectedComponentsPlan plan) {
+  auto pg = MakeFileGraph<DataType>(num_nodes, 0, policy);
+  auto res = katana::analytics::StronglyConnectedComponents(
+      pg.get(), "component", plan);
+  KATANA_LOG_VASSERT(res, "components failed: {}", res.error());
+
+  auto valid_res = katana::analytics::StronglyConnectedComponentsAssertValid(
+      pg.get(), "component");
+  KATANA_LOG_VASSERT(valid_res, "invalid components: {}", valid_res.error());
+
+  auto labels_res = pg->GetNodePropertyTyped<uint64_t>("component");
+  KATANA_LOG_VASSERT(labels_res, "no components: {}", labels_res.error());
+  auto labels = labels_res.value();
+
+  // Each node is labeled with the smallest node on a cycle with it
+  auto reaches = Reachability(pg->topology());
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    uint32_t expected = 0;
+    while (!reaches[expected][n] || !reaches[n][expected]) {
+      ++expected;
+    }
+    KATANA_LOG_VASSERT(
+        labels->Value(n) == expected, "node {} has component {} not {}", n,
+        labels->Value(n), expected);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (auto plan :
+       {StronglyConnectedComponentsPlan::ForwardBackward(),
+        StronglyConnectedComponentsPlan::Coloring()}) {
+    // No edges: every node is its own component
+    LinePolicy no_edges{0};
+    TestComponents(&no_edges, 100, plan);
+
+    // A single cycle through all nodes
+    LinePolicy cycle{1};
+    TestComponents(&cycle, 100, plan);
+
+    for (size_t width : {1, 2, 3}) {
+      RandomPolicy random{width};
+      TestComponents(&random, 500, plan);
+    }
+  }
+
+  // A property that does not exist yet is required
+  LinePolicy cycle{1};
+  auto pg = MakeFileGraph<DataType>(10, 0, &cycle);
+  auto res =
+      katana::analytics::StronglyConnectedComponents(pg.get(), "component");
+  KATANA_LOG_VASSERT(res, "components failed: {}", res.error());
+  res = katana::analytics::StronglyConnectedComponents(pg.get(), "component");
+  KATANA_LOG_ASSERT(!res);
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+
+using katana::analytics::SubGraphExtractionPlan;
+using Node = katana::GraphTopology::Node;
+
+/// Adds the property "id" holding the id of each node and each edge
+void
+AddIds(katana::PropertyGraph* pg) {
+  std::vector<uint32_t> node_ids(pg->num_nodes());
+  std::iota(node_ids.begin(), node_ids.end(), 0);
+  std::vector<uint64_t> edge_ids(pg->num_edges());
+  std::iota(edge_ids.begin(), edge_ids.end(), 0);
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("id", arrow::uint32())}),
+      {katana::BuildArray(node_ids)})));
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("id", arrow::uint64())}),
+      {katana::BuildArray(edge_ids)})));
+}
+
+void
+TestSubGraph(size_t num_nodes, Policy* policy, SubGraphExtractionPlan plan) {
+  auto pg = MakeFileGraph<uint32_t>(num_nodes, 0, policy);
+  AddIds(pg.get());
+
+  // Every third node, in decreasing order, with a repeat
+  std::vector<uint32_t> node_vec;
+  for (uint32_t n = 0; n < num_nodes; n += 3) {
+    node_vec.emplace_back(num_nodes - 1 - n);
+  }
+  node_vec.emplace_back(node_vec.front());
+
+  // NodeSet sorts the edges of pg but not its edge properties, which keep
+  // the original order
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<Node> dests(topology.num_edges());
+  for (uint64_t e = 0; e < topology.num_edges(); ++e) {
+    dests[e] = topology.edge_dest(e);
+  }
+
+  auto res = katana::analytics::SubGraphExtraction(
+      pg.get(), node_vec, {"id"}, {"id"}, plan);
+  KATANA_LOG_VASSERT(res, "SubGraphExtraction failed: {}", res.error());
+  auto subgraph = std::move(res.value());
+  const katana::GraphTopology& sub_topology = subgraph->topology();
+  node_vec.pop_back();
+  KATANA_LOG_ASSERT(sub_topology.num_nodes() == node_vec.size());
+
+  // The properties name the node and edge of the graph each one copies
+  auto node_ids = subgraph->GetNodePropertyTyped<uint32_t>("id").value();
+  auto edge_ids = subgraph->GetEdgePropertyTyped<uint64_t>("id").value();
+  for (Node n = 0; n < sub_topology.num_nodes(); ++n) {
+    Node src = node_vec[n];
+    KATANA_LOG_ASSERT(node_ids->Value(n) == src);
+
+    std::vector<Node> expected;
+    for (auto e : topology.edges(src)) {
+      Node dst = dests[e];
+      auto it = std::find(node_vec.begin(), node_vec.end(), dst);
+      if (it != node_vec.end()) {
+        expected.emplace_back(it - node_vec.begin());
+      }
+    }
+    std::vector<Node> found;
+    for (auto e : sub_topology.edges(n)) {
+      Node dst = sub_topology.edge_dest(e);
+      found.emplace_back(dst);
+      uint64_t edge_id = edge_ids->Value(e);
+      KATANA_LOG_ASSERT(edge_id < topology.num_edges());
+      KATANA_LOG_VASSERT(
+          dests[edge_id] == node_vec[dst] &&
+              edge_id >= *topology.edges(src).begin() &&
+              edge_id < *topology.edges(src).end(),
+          "edge {} of node {} copies edge {}", e, n, edge_id);
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    KATANA_LOG_VASSERT(
+        expected == found, "node {} has {} edges, expected {}", n,
+        found.size(), expected.size());
+  }
+
+  std::vector<uint32_t> bad_nodes{static_cast<uint32_t>(num_nodes)};
+  KATANA_LOG_ASSERT(!katana::analytics::SubGraphExtraction(
+      pg.get(), bad_nodes, plan));
+  KATANA_LOG_ASSERT(!katana::analytics::SubGraphExtraction(
+      pg.get(), node_vec, {"missing"}, {}, plan));
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (auto plan :
+       {SubGraphExtractionPlan::NodeSetScan(),
+        SubGraphExtractionPlan::NodeSet()}) {
+    LinePolicy line{4};
+    TestSubGraph(100, &line, plan);
+    RandomPolicy random{5};
+    TestSubGraph(2000, &random, plan);
+  }
+
+  return 0;
+}
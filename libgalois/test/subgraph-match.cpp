@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/subgraph_match/subgraph_match.h"
+
+using DataType = int64_t;
+using katana::analytics::SubgraphMatchPlan;
+using katana::analytics::SubgraphPattern;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Node n is red if n % 3 == 0 and blue otherwise; edge e is even if e is
+void
+AddTypes(katana::PropertyGraph* pg) {
+  arrow::BooleanBuilder red;
+  arrow::BooleanBuilder blue;
+  for (Node n = 0; n < pg->topology().num_nodes(); ++n) {
+    KATANA_LOG_ASSERT(red.Append(n % 3 == 0).ok());
+    KATANA_LOG_ASSERT(blue.Append(n % 3 != 0).ok());
+  }
+  auto node_types = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("red", arrow::boolean()),
+           arrow::field("blue", arrow::boolean())}),
+      {red.Finish().ValueOrDie(), blue.Finish().ValueOrDie()});
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(node_types));
+
+  arrow::BooleanBuilder even;
+  for (uint64_t e = 0; e < pg->topology().num_edges(); ++e) {
+    KATANA_LOG_ASSERT(even.Append(e % 2 == 0).ok());
+  }
+  auto edge_types = arrow::Table::Make(
+      arrow::schema({arrow::field("even", arrow::boolean())}),
+      {even.Finish().ValueOrDie()});
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(edge_types));
+  KATANA_LOG_ASSERT(pg->ConstructTypeSetIDs());
+}
+
+/// The edges of a graph by (source, destination, whether it is even)
+using EdgeSet = std::set<std::tuple<Node, Node, bool>>;
+
+EdgeSet
+MakeEdgeSet(const katana::GraphTopology& topology) {
+  EdgeSet edges;
+  for (Node n : topology) {
+    for (auto e : topology.edges(n)) {
+      edges.emplace(n, topology.edge_dest(e), false);
+      if (e % 2 == 0) {
+        edges.emplace(n, topology.edge_dest(e), true);
+      }
+    }
+  }
+  return edges;
+}
+
+bool
+IsMatch(
+    const EdgeSet& edges, const SubgraphPattern& pattern, const Node* match) {
+  for (uint32_t i = 0; i < pattern.num_nodes(); ++i) {
+    const std::string& type = pattern.node_types()[i];
+    if ((type == "red" && match[i] % 3 != 0) ||
+        (type == "blue" && match[i] % 3 == 0)) {
+      return false;
+    }
+    if (std::count(match, match + pattern.num_nodes(), match[i]) != 1) {
+      return false;
+    }
+  }
+  return std::all_of(
+      pattern.edges().begin(), pattern.edges().end(), [&](const auto& edge) {
+        return edges.count(
+            {match[edge.src], match[edge.dst], edge.type == "even"});
+      });
+}
+
+/// The number of matches of pattern, by trying every map of its nodes
+uint64_t
+ExpectedCount(
+    const EdgeSet& edges, uint64_t num_nodes, const SubgraphPattern& pattern) {
+  std::vector<Node> match(pattern.num_nodes(), 0);
+  uint64_t count = 0;
+  while (true) {
+    count += IsMatch(edges, pattern, match.data());
+    uint32_t i = 0;
+    while (i < match.size() && ++match[i] == num_nodes) {
+      match[i++] = 0;
+    }
+    if (i == match.size()) {
+      return count;
+    }
+  }
+}
+
+void
+TestPattern(
+    katana::PropertyGraph* pg, const EdgeSet& edges,
+    const SubgraphPattern& pattern) {
+  uint64_t expected =
+      ExpectedCount(edges, pg->topology().num_nodes(), pattern);
+  KATANA_LOG_ASSERT(expected > 0);
+
+  for (uint32_t split_depth : {1, 2, 3}) {
+    auto plan = SubgraphMatchPlan::GenericJoin(split_depth);
+    auto count_res =
+        katana::analytics::SubgraphMatchCount(pg, pattern, plan);
+    KATANA_LOG_VASSERT(count_res, "could not count: {}", count_res.error());
+    KATANA_LOG_VASSERT(
+        count_res.value() == expected, "expected {} found {}", expected,
+        count_res.value());
+  }
+
+  std::mutex mutex;
+  std::set<std::vector<Node>> matches;
+  auto res = katana::analytics::SubgraphMatch(
+      pg, pattern, [&](const Node* match) {
+        KATANA_LOG_ASSERT(IsMatch(edges, pattern, match));
+        std::lock_guard<std::mutex> lock(mutex);
+        matches.emplace(match, match + pattern.num_nodes());
+      });
+  KATANA_LOG_VASSERT(res, "could not match: {}", res.error());
+  KATANA_LOG_ASSERT(res.value() == expected);
+  KATANA_LOG_ASSERT(matches.size() == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  RandomPolicy policy{3};
+  auto pg = MakeFileGraph<DataType>(60, 0, &policy);
+  AddTypes(pg.get());
+  EdgeSet edges = MakeEdgeSet(pg->topology());
+
+  SubgraphPattern red;
+  red.AddNode("red");
+  TestPattern(pg.get(), edges, red);
+
+  // A typed path a -> b <- c
+  SubgraphPattern path;
+  uint32_t a = path.AddNode("red");
+  uint32_t b = path.AddNode();
+  uint32_t c = path.AddNode("blue");
+  path.AddEdge(a, b, "even");
+  path.AddEdge(c, b);
+  TestPattern(pg.get(), edges, path);
+
+  // A feed forward loop, whose last node is found by an intersection
+  SubgraphPattern loop;
+  a = loop.AddNode();
+  b = loop.AddNode();
+  c = loop.AddNode();
+  loop.AddEdge(a, b);
+  loop.AddEdge(b, c);
+  loop.AddEdge(a, c);
+  TestPattern(pg.get(), edges, loop);
+
+  // Types that no node or edge has match nothing
+  SubgraphPattern missing;
+  missing.AddEdge(missing.AddNode(), missing.AddNode(), "odd");
+  auto res = katana::analytics::SubgraphMatchCount(pg.get(), missing);
+  KATANA_LOG_ASSERT(res && res.value() == 0);
+
+  SubgraphPattern disconnected;
+  disconnected.AddNode();
+  disconnected.AddNode();
+  KATANA_LOG_ASSERT(
+      !katana::analytics::SubgraphMatchCount(pg.get(), disconnected));
+
+  return 0;
+}
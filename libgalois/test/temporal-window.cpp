@@ -0,0 +1,236 @@
+#include "katana/TemporalWindow.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphView.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using katana::TemporalEdgeIndex;
+using katana::TemporalWindow;
+using Node = katana::GraphTopology::Node;
+
+namespace {
+
+/// The timestamp of edge e, or kNullTime for the edges without one
+int64_t
+TimeOf(uint64_t e) {
+  return e % 11 == 0 ? TemporalEdgeIndex::kNullTime
+                     : static_cast<int64_t>((e * 7919) % 100);
+}
+
+/// The int64 edge property "time" of TimeOf, null where it is kNullTime
+std::shared_ptr<arrow::Table>
+MakeTimes(uint64_t num_edges) {
+  arrow::Int64Builder builder;
+  for (uint64_t e = 0; e < num_edges; ++e) {
+    int64_t t = TimeOf(e);
+    if (t == TemporalEdgeIndex::kNullTime) {
+      KATANA_LOG_ASSERT(builder.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(builder.Append(t).ok());
+    }
+  }
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("time", arrow::int64())}),
+      {builder.Finish().ValueOrDie()});
+}
+
+bool
+InWindow(uint64_t e, int64_t begin_time, int64_t end_time) {
+  int64_t t = TimeOf(e);
+  return t != TemporalEdgeIndex::kNullTime && begin_time <= t && t < end_time;
+}
+
+void
+TestIndex(katana::PropertyGraph* pg) {
+  const katana::GraphTopology& topology = pg->topology();
+  auto index_res = pg->GetTemporalEdgeIndex("time");
+  KATANA_LOG_VASSERT(index_res, "no index: {}", index_res.error());
+  std::shared_ptr<const TemporalEdgeIndex> index = index_res.value();
+  KATANA_LOG_ASSERT(index->num_nodes() == topology.num_nodes());
+  KATANA_LOG_ASSERT(index->num_edges() == topology.num_edges());
+
+  for (Node n : topology) {
+    KATANA_LOG_ASSERT(index->edges(n).size() == topology.edges(n).size());
+    auto [begin, end] = topology.edge_range(n);
+    std::vector<bool> seen(end - begin);
+    int64_t last = std::numeric_limits<int64_t>::min();
+    for (auto e : index->edges(n)) {
+      uint64_t id = index->out_edge_id(e);
+      KATANA_LOG_ASSERT(begin <= id && id < end && !seen[id - begin]);
+      seen[id - begin] = true;
+      KATANA_LOG_ASSERT(index->edge_dest(e) == topology.edge_dest(id));
+      KATANA_LOG_ASSERT(index->timestamp(e) == TimeOf(id));
+      KATANA_LOG_ASSERT(index->timestamp(e) >= last);
+      last = index->timestamp(e);
+    }
+  }
+
+  // Cached until the property is replaced
+  KATANA_LOG_ASSERT(pg->GetTemporalEdgeIndex("time").value() == index);
+  KATANA_LOG_ASSERT(pg->UpsertEdgeProperties(MakeTimes(topology.num_edges())));
+  auto rebuilt = pg->GetTemporalEdgeIndex("time");
+  KATANA_LOG_ASSERT(rebuilt && rebuilt.value() != index);
+
+  KATANA_LOG_ASSERT(!pg->GetTemporalEdgeIndex("no such property"));
+}
+
+void
+TestWindowEdges(katana::PropertyGraph* pg) {
+  const katana::GraphTopology& topology = pg->topology();
+  auto window_res = TemporalWindow::Make(pg, "time", 20, 60);
+  KATANA_LOG_ASSERT(window_res);
+  TemporalWindow window = std::move(window_res.value());
+
+  for (auto [begin_time, end_time] :
+       {std::pair<int64_t, int64_t>{20, 60}, {0, 100}, {50, 51}, {70, 30}}) {
+    window.SetBounds(begin_time, end_time);
+    uint64_t num_edges = 0;
+    for (Node n : window) {
+      std::vector<uint64_t> expected;
+      for (auto e : topology.edges(n)) {
+        if (InWindow(e, begin_time, end_time)) {
+          expected.emplace_back(e);
+        }
+      }
+      std::vector<uint64_t> found;
+      for (auto e : window.edges(n)) {
+        KATANA_LOG_ASSERT(window.timestamp(e) >= begin_time);
+        KATANA_LOG_ASSERT(window.timestamp(e) < end_time);
+        found.emplace_back(window.out_edge_id(e));
+      }
+      std::sort(found.begin(), found.end());
+      KATANA_LOG_VASSERT(
+          found == expected, "node {} has {} edges in [{}, {}), expected {}",
+          n, found.size(), begin_time, end_time, expected.size());
+      num_edges += expected.size();
+    }
+    KATANA_LOG_ASSERT(window.num_edges() == num_edges);
+  }
+}
+
+/// BFS levels over the edges in [begin_time, end_time)
+std::vector<uint32_t>
+SerialBfs(
+    const katana::GraphTopology& topology, Node source, int64_t begin_time,
+    int64_t end_time) {
+  std::vector<uint32_t> levels(
+      topology.num_nodes(), katana::analytics::kBfsMultiSourceInfinity);
+  std::vector<Node> frontier{source};
+  levels[source] = 0;
+  for (uint32_t level = 1; !frontier.empty(); ++level) {
+    std::vector<Node> next;
+    for (Node n : frontier) {
+      for (auto e : topology.edges(n)) {
+        Node dst = topology.edge_dest(e);
+        if (InWindow(e, begin_time, end_time) &&
+            levels[dst] == katana::analytics::kBfsMultiSourceInfinity) {
+          levels[dst] = level;
+          next.emplace_back(dst);
+        }
+      }
+    }
+    frontier.swap(next);
+  }
+  return levels;
+}
+
+/// Page Rank over the edges in [begin_time, end_time), by iterating
+/// rank(v) = (1 - alpha) + alpha * sum of rank(u) / degree(u) to a fixpoint
+std::vector<double>
+SerialPagerank(
+    const katana::GraphTopology& topology, int64_t begin_time,
+    int64_t end_time, double alpha) {
+  std::vector<uint64_t> degrees(topology.num_nodes());
+  for (Node n : topology) {
+    for (auto e : topology.edges(n)) {
+      degrees[n] += InWindow(e, begin_time, end_time);
+    }
+  }
+  std::vector<double> ranks(topology.num_nodes(), 1 - alpha);
+  for (int iteration = 0; iteration < 1000; ++iteration) {
+    std::vector<double> next(topology.num_nodes(), 1 - alpha);
+    for (Node n : topology) {
+      for (auto e : topology.edges(n)) {
+        if (InWindow(e, begin_time, end_time)) {
+          next[topology.edge_dest(e)] += alpha * ranks[n] / degrees[n];
+        }
+      }
+    }
+    ranks.swap(next);
+  }
+  return ranks;
+}
+
+template <typename T, typename ArrowArray>
+std::vector<T>
+ReadNodeProperty(katana::PropertyGraph* pg, const std::string& name) {
+  auto column = pg->GetNodeProperty(name);
+  KATANA_LOG_VASSERT(column, "no property {}", name);
+  auto array = std::static_pointer_cast<ArrowArray>(column->chunk(0));
+  std::vector<T> values;
+  for (int64_t i = 0; i < array->length(); ++i) {
+    values.emplace_back(array->Value(i));
+  }
+  return values;
+}
+
+void
+TestAnalytics(katana::PropertyGraph* pg) {
+  const katana::GraphTopology& topology = pg->topology();
+  constexpr int64_t kBegin = 10;
+  constexpr int64_t kEnd = 70;
+  auto window = TemporalWindow::Make(pg, "time", kBegin, kEnd).value();
+
+  KATANA_LOG_ASSERT(katana::analytics::Bfs(window, 1, "level"));
+  auto levels = ReadNodeProperty<uint32_t, arrow::UInt32Array>(pg, "level");
+  KATANA_LOG_ASSERT(levels == SerialBfs(topology, 1, kBegin, kEnd));
+  KATANA_LOG_ASSERT(!katana::analytics::Bfs(window, 1, "level"));
+  KATANA_LOG_ASSERT(
+      !katana::analytics::Bfs(window, topology.num_nodes(), "level2"));
+
+  katana::GraphView view(pg);
+  view.FilterEdgesIf([](uint64_t e) { return InWindow(e, kBegin, kEnd); });
+  KATANA_LOG_ASSERT(katana::analytics::ConnectedComponents(view, "view_cc"));
+  KATANA_LOG_ASSERT(katana::analytics::ConnectedComponents(window, "cc"));
+  KATANA_LOG_ASSERT(
+      (ReadNodeProperty<uint64_t, arrow::UInt64Array>(pg, "cc") ==
+       ReadNodeProperty<uint64_t, arrow::UInt64Array>(pg, "view_cc")));
+
+  auto plan = katana::analytics::PagerankPlan::PushSynchronous(1e-6);
+  KATANA_LOG_ASSERT(katana::analytics::Pagerank(window, "rank", plan));
+  auto ranks = ReadNodeProperty<float, arrow::FloatArray>(pg, "rank");
+  auto expected = SerialPagerank(topology, kBegin, kEnd, plan.alpha());
+  for (Node n : topology) {
+    KATANA_LOG_VASSERT(
+        std::fabs(ranks[n] - expected[n]) < 1e-3, "rank of {} is {}, not {}",
+        n, ranks[n], expected[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  RandomPolicy policy{4};
+  auto pg = MakeFileGraph<uint32_t>(400, 0, &policy);
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(MakeTimes(pg->num_edges())));
+
+  TestIndex(pg.get());
+  TestWindowEdges(pg.get());
+  TestAnalytics(pg.get());
+
+  return 0;
+}
@@ -0,0 +1,52 @@
+#include <atomic>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+/// Each item below kDepth pushes two children, so that termination has to
+/// wait for work pushed by other threads
+constexpr int kDepth = 14;
+
+void
+TestKind(katana::TerminationKind kind) {
+  std::atomic<uint64_t> count{0};
+  int root = 0;
+  katana::for_each(
+      katana::iterate(&root, &root + 1),
+      [&](int depth, auto& ctx) {
+        count.fetch_add(1, std::memory_order_relaxed);
+        if (depth < kDepth) {
+          ctx.push(depth + 1);
+          ctx.push(depth + 1);
+        }
+      },
+      katana::termination(kind), katana::disable_conflict_detection(),
+      katana::no_stats());
+  KATANA_LOG_ASSERT(count == (uint64_t{1} << (kDepth + 1)) - 1);
+
+  // Items are counted exactly once however they are stolen
+  std::atomic<uint64_t> sum{0};
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{100000}),
+      [&](uint64_t i) { sum.fetch_add(i, std::memory_order_relaxed); },
+      katana::steal(), katana::termination(kind), katana::no_stats());
+  KATANA_LOG_ASSERT(sum == uint64_t{100000} * 99999 / 2);
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (unsigned threads : {1, 2, 4, 8}) {
+    katana::setActiveThreads(threads);
+    for (int round = 0; round < 10; ++round) {
+      TestKind(katana::TerminationKind::kDefault);
+      TestKind(katana::TerminationKind::kRing);
+      TestKind(katana::TerminationKind::kTree);
+      TestKind(katana::TerminationKind::kCounter);
+    }
+  }
+
+  return 0;
+}
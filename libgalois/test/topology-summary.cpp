@@ -0,0 +1,94 @@
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Uri.h"
+#include "katana/analytics/TopologySummary.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+namespace fs = boost::filesystem;
+
+using katana::analytics::SsspPlan;
+using katana::analytics::TopologySummary;
+using katana::analytics::TriangleCountPlan;
+
+/// Check summary against the topology of pg
+void
+CheckSummary(const katana::PropertyGraph& pg, const TopologySummary& summary) {
+  const katana::GraphTopology& topology = pg.topology();
+  KATANA_LOG_ASSERT(summary.num_nodes == topology.num_nodes());
+  KATANA_LOG_ASSERT(summary.num_edges == topology.num_edges());
+  KATANA_LOG_ASSERT(
+      summary.topology_bytes() ==
+      topology.num_nodes() * sizeof(uint64_t) +
+          topology.num_edges() * sizeof(uint32_t));
+
+  uint64_t max_degree = 0;
+  std::vector<uint64_t> histogram(1, 0);
+  for (uint64_t n = 0; n < topology.num_nodes(); ++n) {
+    uint64_t degree = topology.edges(n).size();
+    max_degree = std::max(max_degree, degree);
+    size_t bucket = 0;
+    while ((uint64_t{1} << bucket) <= degree) {
+      ++bucket;
+    }
+    histogram.resize(std::max(histogram.size(), bucket + 1), 0);
+    histogram[bucket] += 1;
+  }
+  KATANA_LOG_ASSERT(summary.max_degree == max_degree);
+  KATANA_LOG_ASSERT(summary.degree_histogram == histogram);
+  KATANA_LOG_ASSERT(summary.num_isolated_nodes == histogram[0]);
+
+  SsspPlan sssp(summary);
+  KATANA_LOG_ASSERT(
+      sssp.algorithm() ==
+      (summary.power_law ? SsspPlan::kDeltaStep : SsspPlan::kDeltaStepBarrier));
+  TriangleCountPlan tc(summary);
+  KATANA_LOG_ASSERT(
+      tc.relabeling() == (summary.power_law ? TriangleCountPlan::kRelabel
+                                            : TriangleCountPlan::kNoRelabel));
+}
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy line{1};
+  RandomPolicy random{12};
+  for (Policy* policy : std::initializer_list<Policy*>{&line, &random}) {
+    auto pg = MakeFileGraph<uint32_t>(1000, 0, policy);
+
+    auto uri_res = katana::Uri::MakeRand("/tmp/topologysummary");
+    KATANA_LOG_ASSERT(uri_res);
+    std::string rdg_dir(uri_res.value().path());  // path() because local
+    if (auto res = pg->Write(rdg_dir, "topology-summary"); !res) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("writing graph: {}", res.error());
+    }
+
+    // The summary read from storage is that of the loaded topology
+    auto summary_res = TopologySummary::Make(rdg_dir);
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_VASSERT(
+        summary_res, "summarizing topology: {}", summary_res.error());
+    CheckSummary(*pg, summary_res.value());
+    CheckSummary(
+        *pg, TopologySummary::Make(
+                 pg->topology().out_indices->raw_values(), pg->num_nodes(),
+                 pg->num_edges()));
+  }
+
+  // Even degrees are not a power law
+  auto pg = MakeFileGraph<uint32_t>(1000, 0, &random);
+  KATANA_LOG_ASSERT(!TopologySummary::Make(
+                         pg->topology().out_indices->raw_values(),
+                         pg->num_nodes(), pg->num_edges())
+                         .power_law);
+
+  KATANA_LOG_ASSERT(!TopologySummary::Make("/tmp/topologysummary-missing"));
+
+  return 0;
+}
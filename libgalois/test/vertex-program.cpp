@@ -0,0 +1,228 @@
+#include "katana/VertexProgram.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphGenerator.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using katana::VertexProgramDirection;
+using katana::VertexProgramOptions;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// BFS levels from a source, combining the levels offered by min
+struct BfsProgram {
+  using Value = uint32_t;
+  using Message = uint32_t;
+
+  Node source;
+
+  Message Identity() const { return kUnreached; }
+  Message Combine(Message a, Message b) const { return std::min(a, b); }
+  bool Init(Node n, Value* level) const {
+    *level = n == source ? 0 : kUnreached;
+    return n == source;
+  }
+  Message Scatter(Node, const Value& level, Edge, Node) const {
+    return level + 1;
+  }
+  bool Apply(Node, Value* level, const Message& offered) const {
+    if (offered < *level) {
+      *level = offered;
+      return true;
+    }
+    return false;
+  }
+};
+
+/// Connected components of a symmetric graph: each node takes the least
+/// label among its neighbors until no label changes
+struct ComponentsProgram {
+  using Value = uint32_t;
+  using Message = uint32_t;
+
+  Message Identity() const { return kUnreached; }
+  Message Combine(Message a, Message b) const { return std::min(a, b); }
+  bool Init(Node n, Value* label) const {
+    *label = n;
+    return true;
+  }
+  Message Scatter(Node, const Value& label, Edge, Node) const { return label; }
+  bool Apply(Node, Value* label, const Message& offered) const {
+    if (offered < *label) {
+      *label = offered;
+      return true;
+    }
+    return false;
+  }
+};
+
+/// In one superstep, the sum of the ids of the out-edges to each node
+struct EdgeSumProgram {
+  using Value = uint64_t;
+  using Message = uint64_t;
+
+  Message Identity() const { return 0; }
+  Message Combine(Message a, Message b) const { return a + b; }
+  bool Init(Node, Value* sum) const {
+    *sum = 0;
+    return true;
+  }
+  Message Scatter(Node, const Value&, Edge e, Node) const { return e; }
+  bool Apply(Node, Value* sum, const Message& message) const {
+    *sum = message;
+    return false;
+  }
+};
+
+std::vector<uint32_t>
+SerialBfs(const katana::GraphTopology& topology, Node source) {
+  std::vector<uint32_t> levels(topology.num_nodes(), kUnreached);
+  std::vector<Node> frontier{source};
+  levels[source] = 0;
+  for (uint32_t level = 1; !frontier.empty(); ++level) {
+    std::vector<Node> next;
+    for (Node n : frontier) {
+      for (auto e : topology.edges(n)) {
+        Node dst = topology.edge_dest(e);
+        if (levels[dst] == kUnreached) {
+          levels[dst] = level;
+          next.emplace_back(dst);
+        }
+      }
+    }
+    frontier.swap(next);
+  }
+  return levels;
+}
+
+/// The least node of the component of each node
+std::vector<uint32_t>
+SerialComponents(const katana::GraphTopology& topology) {
+  std::vector<uint32_t> labels(topology.num_nodes(), kUnreached);
+  for (Node root : topology) {
+    if (labels[root] != kUnreached) {
+      continue;
+    }
+    std::vector<Node> stack{root};
+    labels[root] = root;
+    while (!stack.empty()) {
+      Node n = stack.back();
+      stack.pop_back();
+      for (auto e : topology.edges(n)) {
+        Node dst = topology.edge_dest(e);
+        if (labels[dst] == kUnreached) {
+          labels[dst] = root;
+          stack.emplace_back(dst);
+        }
+      }
+    }
+  }
+  return labels;
+}
+
+template <typename Program>
+std::vector<typename Program::Value>
+Run(
+    katana::PropertyGraph* pg, const Program& program,
+    VertexProgramDirection direction, uint32_t* num_supersteps = nullptr) {
+  VertexProgramOptions options;
+  options.direction = direction;
+  std::vector<typename Program::Value> values;
+  auto res = katana::RunVertexProgram(pg, program, &values, options);
+  KATANA_LOG_VASSERT(res, "vertex program failed: {}", res.error());
+  if (num_supersteps) {
+    *num_supersteps = res.value();
+  }
+  return values;
+}
+
+constexpr VertexProgramDirection kDirections[] = {
+    VertexProgramDirection::kAuto, VertexProgramDirection::kPush,
+    VertexProgramDirection::kPull};
+
+void
+TestBfs() {
+  RandomPolicy policy{4};
+  auto pg = MakeFileGraph<uint32_t>(1000, 0, &policy);
+  std::vector<uint32_t> expected = SerialBfs(pg->topology(), 3);
+  uint32_t max_level = 0;
+  for (uint32_t level : expected) {
+    if (level != kUnreached) {
+      max_level = std::max(max_level, level);
+    }
+  }
+
+  for (auto direction : kDirections) {
+    uint32_t num_supersteps = 0;
+    KATANA_LOG_ASSERT(
+        Run(pg.get(), BfsProgram{3}, direction, &num_supersteps) == expected);
+    // The last superstep reaches no new node
+    KATANA_LOG_ASSERT(num_supersteps == max_level + 1);
+  }
+}
+
+void
+TestComponents() {
+  katana::GraphGeneratorOptions opts;
+  opts.num_nodes = 2000;
+  opts.num_edges = 1500;
+  opts.seed = 11;
+  opts.symmetric = true;
+  auto pg = std::move(katana::GenerateGraph(opts).value());
+  std::vector<uint32_t> expected = SerialComponents(pg->topology());
+
+  for (auto direction : kDirections) {
+    KATANA_LOG_ASSERT(
+        Run(pg.get(), ComponentsProgram{}, direction) == expected);
+  }
+}
+
+void
+TestEdgeIds() {
+  RandomPolicy policy{3};
+  auto pg = MakeFileGraph<uint32_t>(500, 0, &policy);
+  const katana::GraphTopology& topology = pg->topology();
+  std::vector<uint64_t> expected(topology.num_nodes());
+  for (uint64_t e = 0; e < topology.num_edges(); ++e) {
+    expected[topology.edge_dest(e)] += e;
+  }
+
+  // Pull reads the edges through the in-edge index but passes their ids
+  for (auto direction : kDirections) {
+    uint32_t num_supersteps = 0;
+    KATANA_LOG_ASSERT(
+        Run(pg.get(), EdgeSumProgram{}, direction, &num_supersteps) ==
+        expected);
+    KATANA_LOG_ASSERT(num_supersteps == 1);
+  }
+
+  VertexProgramOptions options;
+  options.max_supersteps = 0;
+  std::vector<uint64_t> values;
+  auto res =
+      katana::RunVertexProgram(pg.get(), EdgeSumProgram{}, &values, options);
+  KATANA_LOG_ASSERT(res && res.value() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestBfs();
+  TestComponents();
+  TestEdgeIds();
+
+  return 0;
+}
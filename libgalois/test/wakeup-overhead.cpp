@@ -41,6 +41,8 @@ static cll::opt<int> trials(
     "trials", cll::desc("number of trials"), cll::init(1));
 static cll::opt<unsigned> threads(
     "threads", cll::desc("number of threads"), cll::init(2));
+static cll::opt<unsigned> spinUsec(
+    "spinUsec", cll::desc("spin budget of the adaptive mode"), cll::init(50));
 
 void
 runDoAllBurn(int num) {
@@ -55,6 +57,20 @@ runDoAllBurn(int num) {
   katana::GetThreadPool().beKind();
 }
 
+void
+runDoAllAdaptive(int num) {
+  uint64_t old_budget = katana::GetThreadPool().getSpinBudget();
+  katana::GetThreadPool().setSpinBudget(spinUsec);
+
+  for (int r = 0; r < rounds; ++r) {
+    katana::do_all(katana::iterate(0, num), [&](int) {
+      asm volatile("" ::: "memory");
+    });
+  }
+
+  katana::GetThreadPool().setSpinBudget(old_budget);
+}
+
 void
 runDoAll(int num) {
   for (int r = 0; r < rounds; ++r) {
@@ -111,6 +127,7 @@ main(int argc, char* argv[]) {
   for (int t = 0; t < trials; ++t) {
     run(runDoAll, "DoAll");
     run(runDoAllBurn, "DoAllBurn");
+    run(runDoAllAdaptive, "DoAllAdaptive");
     run(runExplicitThread, "ExplicitThread");
   }
   EXIT = 1;
@@ -291,6 +291,10 @@ TableBuilder::AddColumn(const ColumnOptions& options) {
 /// Combine chunks of ChunkedArray into a single Array
 KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> Unchunk(
     const std::shared_ptr<arrow::ChunkedArray>& original);
+/// Dictionary encode a ChunkedArray, e.g., of strings, into one chunk of
+/// int32 codes into a dictionary of its distinct values
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> DictionaryEncode(
+    const std::shared_ptr<arrow::ChunkedArray>& original);
 /// Return a randomly shuffled version of a ChunkedArray
 KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> Shuffle(
     const std::shared_ptr<arrow::ChunkedArray>& original);
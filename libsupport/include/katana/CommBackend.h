@@ -2,7 +2,11 @@
 #define KATANA_LIBSUPPORT_KATANA_COMMBACKEND_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include <arrow/buffer.h>
 
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -10,6 +14,73 @@
 
 namespace katana {
 
+/// The reductions of CommBackend::AllReduce
+enum class CommReduceOp {
+  kSum,
+  kMin,
+  kMax,
+};
+
+/// The element types of CommBackend::AllReduce
+enum class CommDataType {
+  kInt32,
+  kUInt32,
+  kInt64,
+  kUInt64,
+  kFloat,
+  kDouble,
+};
+
+namespace internal {
+
+template <typename T>
+struct CommDataTypeOf;
+
+template <>
+struct CommDataTypeOf<int32_t> {
+  static constexpr CommDataType value = CommDataType::kInt32;
+};
+
+template <>
+struct CommDataTypeOf<uint32_t> {
+  static constexpr CommDataType value = CommDataType::kUInt32;
+};
+
+template <>
+struct CommDataTypeOf<int64_t> {
+  static constexpr CommDataType value = CommDataType::kInt64;
+};
+
+template <>
+struct CommDataTypeOf<uint64_t> {
+  static constexpr CommDataType value = CommDataType::kUInt64;
+};
+
+template <>
+struct CommDataTypeOf<float> {
+  static constexpr CommDataType value = CommDataType::kFloat;
+};
+
+template <>
+struct CommDataTypeOf<double> {
+  static constexpr CommDataType value = CommDataType::kDouble;
+};
+
+}  // namespace internal
+
+/// \returns the size in bytes of an element of type
+KATANA_EXPORT size_t CommDataTypeSize(CommDataType type);
+
+/// A collective started by a non-blocking call of a CommBackend. The
+/// memory it reads and writes must stay untouched until Wait returns.
+class KATANA_EXPORT CommRequest {
+public:
+  virtual ~CommRequest();
+
+  /// Wait for the collective to finish
+  virtual Result<void> Wait() = 0;
+};
+
 class KATANA_EXPORT CommBackend {
 public:
   CommBackend() = default;
@@ -28,6 +99,60 @@ public:
       uint32_t root, const std::string& val, uint64_t max_size) = 0;
   /// Notify other tasks that there was a failure; e.g., with MPI_Abort
   virtual void NotifyFailure() = 0;
+  /// Send send[i] to task i and return what each task sent this one, by
+  /// task. Every task must call it. The default implementation broadcasts
+  /// the messages of each task in turn, so backends that can send to one
+  /// task, e.g., with MPI_Alltoallv, should override it.
+  virtual std::vector<std::string> AllToAll(
+      const std::vector<std::string>& send);
+
+  // The collectives below have default implementations built on AllToAll,
+  // which copy; backends override them to work on the buffers in place.
+  // Every task must call a collective, in the same order as the others.
+
+  /// Combine the count elements of type at data of every task by op, in
+  /// place on every task
+  virtual Result<void> AllReduce(
+      void* data, uint64_t count, CommDataType type, CommReduceOp op);
+
+  /// Send send[i] to task i and return the buffers each task sent this one,
+  /// by task. Buffers are sent as they are, e.g., the value buffer of an
+  /// Arrow array or the memory of a LargeArray wrapped by arrow::Buffer,
+  /// without packing them into one message.
+  virtual Result<std::vector<std::shared_ptr<arrow::Buffer>>> AllToAllV(
+      const std::vector<std::shared_ptr<arrow::Buffer>>& send);
+
+  /// \returns the buffers send of every task, by task, on root and no
+  ///     buffers on other tasks
+  virtual Result<std::vector<std::shared_ptr<arrow::Buffer>>> Gather(
+      uint32_t root, const std::shared_ptr<arrow::Buffer>& send);
+
+  /// Start AllReduce; data holds the result once the request is done.
+  /// The default implementation runs AllReduce before returning.
+  virtual std::unique_ptr<CommRequest> IAllReduce(
+      void* data, uint64_t count, CommDataType type, CommReduceOp op);
+
+  /// Start AllToAllV; recv holds the result once the request is done. The
+  /// request holds references to the send buffers. The default
+  /// implementation runs AllToAllV before returning.
+  virtual std::unique_ptr<CommRequest> IAllToAllV(
+      const std::vector<std::shared_ptr<arrow::Buffer>>& send,
+      std::vector<std::shared_ptr<arrow::Buffer>>* recv);
+
+  /// AllReduce of count elements of T, e.g., of a LargeArray<T>, in place
+  template <typename T>
+  Result<void> AllReduce(T* data, uint64_t count, CommReduceOp op) {
+    return AllReduce(data, count, internal::CommDataTypeOf<T>::value, op);
+  }
+
+  /// \returns value of every task combined by op
+  template <typename T>
+  Result<T> AllReduce(T value, CommReduceOp op) {
+    if (auto r = AllReduce(&value, 1, op); !r) {
+      return r.error();
+    }
+    return value;
+  }
 
   // TODO(thunt): Num and ID were chosen because of NetworkInterface. Changing
   // them is very disruptive so I'll defer for a time in the future where we're
@@ -41,6 +166,8 @@ public:
 
 class KATANA_EXPORT NullCommBackend : public CommBackend {
 public:
+  using CommBackend::AllReduce;
+
   void Barrier() override {}
   void NotifyFailure() override;
   bool Broadcast([[maybe_unused]] uint32_t root, bool val) override {
@@ -51,6 +178,16 @@ public:
       uint64_t max_size) override {
     return val.substr(0, max_size);
   }
+  Result<void> AllReduce(
+      [[maybe_unused]] void* data, [[maybe_unused]] uint64_t count,
+      [[maybe_unused]] CommDataType type,
+      [[maybe_unused]] CommReduceOp op) override {
+    return ResultSuccess();
+  }
+  Result<std::vector<std::shared_ptr<arrow::Buffer>>> AllToAllV(
+      const std::vector<std::shared_ptr<arrow::Buffer>>& send) override {
+    return send;
+  }
 };
 
 }  // namespace katana
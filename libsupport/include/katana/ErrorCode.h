@@ -66,6 +66,8 @@ enum class ErrorCode {
   AssertionFailed = 12,
   GraphUpdateFailed = 13,
   FeatureNotEnabled = 14,
+  Cancelled = 15,
+  CommError = 16,
 };
 
 }  // namespace katana
@@ -108,6 +110,10 @@ public:
       return "graph update failed";
     case ErrorCode::FeatureNotEnabled:
       return "Katana is not built with this feature";
+    case ErrorCode::Cancelled:
+      return "operation cancelled";
+    case ErrorCode::CommError:
+      return "communication between tasks failed";
     default:
       return "unknown error";
     }
@@ -133,7 +139,10 @@ public:
     case ErrorCode::PropertyNotFound:
       return make_error_condition(std::errc::no_such_file_or_directory);
     case ErrorCode::HttpError:
+    case ErrorCode::CommError:
       return make_error_condition(std::errc::io_error);
+    case ErrorCode::Cancelled:
+      return make_error_condition(std::errc::operation_canceled);
     default:
       return std::error_condition(c, *this);
     }
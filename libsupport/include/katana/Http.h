@@ -1,6 +1,12 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_HTTP_H_
 #define KATANA_LIBSUPPORT_KATANA_HTTP_H_
 
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "katana/JSON.h"
 #include "katana/Result.h"
 
@@ -12,6 +18,14 @@ KATANA_EXPORT Result<void> HttpInit();
 KATANA_EXPORT Result<void> HttpGet(
     const std::string& url, std::vector<char>* response);
 
+/// Perform an HTTP get request on url unless the resource still has the
+/// entity tag etag, if not empty. Return false if it does (the server
+/// answered 304 Not Modified); otherwise fill response and set etag to the
+/// entity tag of the response, or empty if it has none, and return true.
+/// Requests reuse the connections of earlier requests of their thread.
+KATANA_EXPORT Result<bool> HttpGetIfNoneMatch(
+    const std::string& url, std::string* etag, std::vector<char>* response);
+
 /// Perform an HTTP post request on url and send the contents of buffer
 KATANA_EXPORT Result<void> HttpPost(
     const std::string& url, const std::string& data,
@@ -26,6 +40,46 @@ KATANA_EXPORT Result<void> HttpPut(
 KATANA_EXPORT Result<void> HttpDelete(
     const std::string& url, std::vector<char>* response);
 
+/// Performs HTTP requests concurrently on one background thread instead of a
+/// thread each. Requests to the same server share a connection, over which
+/// HTTP/2 multiplexes them if the server supports it, and connections stay
+/// open between requests. Calls return at once with a future of the result.
+///
+/// The response vectors and sinks of a request must outlive its future
+/// becoming ready. The body of an upload is moved into the request rather
+/// than copied.
+class KATANA_EXPORT HttpClient {
+public:
+  /// Called on the thread of the client with each piece of a response body
+  /// as it arrives
+  using BodySink = std::function<void(const char* data, size_t size)>;
+
+  /// The client shared by the process
+  static HttpClient& Get();
+
+  HttpClient();
+  /// Fail the requests not yet finished and stop the thread
+  ~HttpClient();
+
+  HttpClient(const HttpClient& no_copy) = delete;
+  HttpClient& operator=(const HttpClient& no_copy) = delete;
+
+  std::future<Result<void>> GetAsync(
+      const std::string& url, std::vector<char>* response);
+  /// Stream the response body to sink instead of gathering it
+  std::future<Result<void>> GetAsync(const std::string& url, BodySink sink);
+  std::future<Result<void>> PostAsync(
+      const std::string& url, std::string data, std::vector<char>* response);
+  std::future<Result<void>> PutAsync(
+      const std::string& url, std::string data, std::vector<char>* response);
+  std::future<Result<void>> DeleteAsync(
+      const std::string& url, std::vector<char>* response);
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
 template <typename T, typename Callable, typename... Args>
 Result<T>
 HttpOpJson(Callable func, Args&&... args) {
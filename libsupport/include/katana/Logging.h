@@ -1,7 +1,10 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_LOGGING_H_
 #define KATANA_LIBSUPPORT_KATANA_LOGGING_H_
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <ostream>
 #include <sstream>
 #include <string>
 #include <system_error>
@@ -38,11 +41,73 @@ enum class LogLevel {
   Error = 4,
 };
 
+/// How log messages are filtered and written. Until SetLogConfig is called,
+/// the configuration is LogConfig::FromEnv() as of the first message.
+struct KATANA_EXPORT LogConfig {
+  /// Log this level and above; messages below it are not even formatted
+  LogLevel level{LogLevel::Debug};
+  /// Write messages from a background thread. Messages are still formatted
+  /// by the thread logging them, which appends them to a lock-free ring of
+  /// its own; a message that finds its ring full is dropped and counted.
+  /// Errors are written synchronously, after the messages logged before
+  /// them.
+  bool async{false};
+  /// Write each message as a JSON object on a line of its own
+  bool json{false};
+  /// Messages per second written from each call site of the logging macros
+  /// below error level, or 0 for no limit. Messages over the limit are
+  /// dropped before they are formatted and counted in the next message
+  /// written from the call site.
+  uint32_t rate_limit{0};
+  /// Messages buffered per thread when async
+  uint32_t ring_capacity{4096};
+  /// Where to write messages; std::cerr if null
+  std::ostream* stream{nullptr};
+
+  /// \returns the configuration set by the environment variables
+  ///     KATANA_LOG_LEVEL, KATANA_LOG_ASYNC, KATANA_LOG_FORMAT (text or json)
+  ///     and KATANA_LOG_RATE_LIMIT
+  static LogConfig FromEnv();
+};
+
+/// Replace the logging configuration, writing pending messages first.
+/// Messages logged concurrently may be written with either configuration.
+KATANA_EXPORT void SetLogConfig(const LogConfig& config);
+
+/// Write all the messages logged so far, e.g., before reading the stream of
+/// an asynchronous configuration
+KATANA_EXPORT void FlushLog();
+
 namespace internal {
 
 KATANA_EXPORT void LogString(LogLevel level, const std::string& s);
 
-}
+/// \returns true if messages at level are written
+KATANA_EXPORT bool LogEnabled(LogLevel level);
+
+/// Write message, logged at file_name:line_no (if not null), after
+/// suppressed messages from the same call site were dropped by the rate
+/// limit
+KATANA_EXPORT void LogRecord(
+    LogLevel level, const char* file_name, int line_no, std::string&& message,
+    uint64_t suppressed);
+
+/// The rate limit state of a call site of the logging macros
+class KATANA_EXPORT LogSite {
+public:
+  /// \returns true if a message from this call site may be written now;
+  ///     if so, *suppressed is the number of messages dropped since the
+  ///     last one written
+  bool Allow(uint64_t* suppressed);
+
+private:
+  /// The second in which count_ messages were logged
+  std::atomic<uint64_t> window_{0};
+  std::atomic<uint32_t> count_{0};
+  std::atomic<uint64_t> suppressed_{0};
+};
+
+}  // namespace internal
 
 /// Log at a specific LogLevel.
 ///
@@ -53,8 +118,12 @@ KATANA_EXPORT void LogString(LogLevel level, const std::string& s);
 template <typename F, typename... Args>
 void
 Log(LogLevel level, F fmt_string, Args&&... args) {
-  std::string s = fmt::format(fmt_string, std::forward<Args>(args)...);
-  internal::LogString(level, s);
+  if (!internal::LogEnabled(level)) {
+    return;
+  }
+  internal::LogRecord(
+      level, nullptr, 0, fmt::format(fmt_string, std::forward<Args>(args)...),
+      0);
 }
 
 /// Log at a specific LogLevel with source code information.
@@ -70,9 +139,27 @@ void
 LogLine(
     LogLevel level, const char* file_name, int line_no, F fmt_string,
     Args&&... args) {
-  std::string s = fmt::format(fmt_string, std::forward<Args>(args)...);
-  std::string with_line = fmt::format("{}:{}: {}", file_name, line_no, s);
-  internal::LogString(level, with_line);
+  if (!internal::LogEnabled(level)) {
+    return;
+  }
+  internal::LogRecord(
+      level, file_name, line_no,
+      fmt::format(fmt_string, std::forward<Args>(args)...), 0);
+}
+
+/// LogLine, rate limited by the state of its call site
+template <typename F, typename... Args>
+void
+LogLineAt(
+    internal::LogSite* site, LogLevel level, const char* file_name,
+    int line_no, F fmt_string, Args&&... args) {
+  uint64_t suppressed = 0;
+  if (!internal::LogEnabled(level) || !site->Allow(&suppressed)) {
+    return;
+  }
+  internal::LogRecord(
+      level, file_name, line_no,
+      fmt::format(fmt_string, std::forward<Args>(args)...), suppressed);
 }
 
 KATANA_EXPORT void AbortApplication [[noreturn]] ();
@@ -94,23 +181,26 @@ KATANA_EXPORT void AbortApplication [[noreturn]] ();
   } while (0)
 #define KATANA_LOG_WARN(fmt_string, ...)                                       \
   do {                                                                         \
-    ::katana::LogLine(                                                         \
-        ::katana::LogLevel::Warning, __FILE__, __LINE__,                       \
+    static ::katana::internal::LogSite __katana_log_site;                      \
+    ::katana::LogLineAt(                                                       \
+        &__katana_log_site, ::katana::LogLevel::Warning, __FILE__, __LINE__,   \
         FMT_STRING(fmt_string), ##__VA_ARGS__);                                \
   } while (0)
 #define KATANA_LOG_VERBOSE(fmt_string, ...)                                    \
   do {                                                                         \
-    ::katana::LogLine(                                                         \
-        ::katana::LogLevel::Verbose, __FILE__, __LINE__,                       \
+    static ::katana::internal::LogSite __katana_log_site;                      \
+    ::katana::LogLineAt(                                                       \
+        &__katana_log_site, ::katana::LogLevel::Verbose, __FILE__, __LINE__,   \
         FMT_STRING(fmt_string), ##__VA_ARGS__);                                \
   } while (0)
 
 #ifndef NDEBUG
 #define KATANA_LOG_DEBUG(fmt_string, ...)                                      \
   do {                                                                         \
-    ::katana::LogLine(                                                         \
-        ::katana::LogLevel::Debug, __FILE__, __LINE__, FMT_STRING(fmt_string), \
-        ##__VA_ARGS__);                                                        \
+    static ::katana::internal::LogSite __katana_log_site;                      \
+    ::katana::LogLineAt(                                                       \
+        &__katana_log_site, ::katana::LogLevel::Debug, __FILE__, __LINE__,     \
+        FMT_STRING(fmt_string), ##__VA_ARGS__);                                \
   } while (0)
 #else
 #define KATANA_LOG_DEBUG(...)
@@ -0,0 +1,58 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_MPICOMMBACKEND_H_
+#define KATANA_LIBSUPPORT_KATANA_MPICOMMBACKEND_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+#include "katana/CommBackend.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A CommBackend of the ranks of an MPI communicator, available when built
+/// with KATANA_ENABLE_MPI. The collectives send buffers as they are, in
+/// pieces of at most 1 GiB to stay within the int counts of MPI.
+///
+/// The caller initializes MPI and destroys the backend before
+/// MPI_Finalize.
+class KATANA_EXPORT MpiCommBackend : public CommBackend {
+public:
+  using CommBackend::AllReduce;
+
+  /// A backend of a duplicate of comm, whose errors are returned rather
+  /// than aborting
+  explicit MpiCommBackend(MPI_Comm comm = MPI_COMM_WORLD);
+  ~MpiCommBackend() override;
+
+  void Barrier() override;
+  bool Broadcast(uint32_t root, bool val) override;
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override;
+  void NotifyFailure() override;
+  std::vector<std::string> AllToAll(
+      const std::vector<std::string>& send) override;
+
+  Result<void> AllReduce(
+      void* data, uint64_t count, CommDataType type,
+      CommReduceOp op) override;
+  Result<std::vector<std::shared_ptr<arrow::Buffer>>> AllToAllV(
+      const std::vector<std::shared_ptr<arrow::Buffer>>& send) override;
+  Result<std::vector<std::shared_ptr<arrow::Buffer>>> Gather(
+      uint32_t root, const std::shared_ptr<arrow::Buffer>& send) override;
+  std::unique_ptr<CommRequest> IAllReduce(
+      void* data, uint64_t count, CommDataType type,
+      CommReduceOp op) override;
+  std::unique_ptr<CommRequest> IAllToAllV(
+      const std::vector<std::shared_ptr<arrow::Buffer>>& send,
+      std::vector<std::shared_ptr<arrow::Buffer>>* recv) override;
+
+private:
+  MPI_Comm comm_;
+};
+
+}  // namespace katana
+
+#endif
@@ -3,6 +3,8 @@
 #include <iostream>
 #include <sstream>
 
+#include <arrow/array/concatenate.h>
+
 #include "katana/Random.h"
 
 namespace {
@@ -122,6 +124,35 @@ katana::Unchunk(const std::shared_ptr<arrow::ChunkedArray>& original) {
   return maybe_chunked.value()->chunk(0);
 }
 
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::DictionaryEncode(const std::shared_ptr<arrow::ChunkedArray>& original) {
+  // Chunks are encoded with dictionaries of their own, so combine them first
+  // to have one dictionary for all values
+  arrow::Datum datum{original};
+  if (original->num_chunks() != 1) {
+    auto concat_res = arrow::Concatenate(original->chunks());
+    if (!concat_res.ok()) {
+      return KATANA_ERROR(
+          ArrowToKatana(concat_res.status()),
+          "combining chunks type: {} reason: {}", original->type()->name(),
+          concat_res.status());
+    }
+    datum = arrow::Datum{concat_res.ValueOrDie()};
+  }
+  auto encode_res = arrow::compute::DictionaryEncode(datum);
+  if (!encode_res.ok()) {
+    return KATANA_ERROR(
+        ArrowToKatana(encode_res.status()),
+        "dictionary encoding type: {} reason: {}", original->type()->name(),
+        encode_res.status());
+  }
+  arrow::Datum encoded = std::move(encode_res.ValueOrDie());
+  if (encoded.is_array()) {
+    return std::make_shared<arrow::ChunkedArray>(encoded.make_array());
+  }
+  return encoded.chunked_array();
+}
+
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::Shuffle(const std::shared_ptr<arrow::ChunkedArray>& original) {
   int64_t length = original->length();
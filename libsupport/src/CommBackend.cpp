@@ -1,8 +1,233 @@
 #include "katana/CommBackend.h"
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+/// A request of a collective that ran before it was returned
+class DoneRequest : public katana::CommRequest {
+public:
+  DoneRequest() = default;
+  explicit DoneRequest(const katana::ErrorInfo& error) : error_(error) {}
+
+  katana::Result<void> Wait() override {
+    if (error_) {
+      return KATANA_ERROR(error_->error_code(), "{}", *error_);
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  /// Kept out of the error stack of the thread until Wait
+  std::optional<katana::CopyableErrorInfo> error_;
+};
+
+template <typename T>
+void
+Combine(T* data, const T* other, uint64_t count, katana::CommReduceOp op) {
+  for (uint64_t i = 0; i < count; ++i) {
+    switch (op) {
+    case katana::CommReduceOp::kSum:
+      data[i] += other[i];
+      break;
+    case katana::CommReduceOp::kMin:
+      data[i] = std::min(data[i], other[i]);
+      break;
+    case katana::CommReduceOp::kMax:
+      data[i] = std::max(data[i], other[i]);
+      break;
+    }
+  }
+}
+
+/// Combine count elements of type at other into data by op
+void
+Combine(
+    void* data, const void* other, uint64_t count, katana::CommDataType type,
+    katana::CommReduceOp op) {
+  switch (type) {
+  case katana::CommDataType::kInt32:
+    Combine(
+        static_cast<int32_t*>(data), static_cast<const int32_t*>(other), count,
+        op);
+    break;
+  case katana::CommDataType::kUInt32:
+    Combine(
+        static_cast<uint32_t*>(data), static_cast<const uint32_t*>(other),
+        count, op);
+    break;
+  case katana::CommDataType::kInt64:
+    Combine(
+        static_cast<int64_t*>(data), static_cast<const int64_t*>(other), count,
+        op);
+    break;
+  case katana::CommDataType::kUInt64:
+    Combine(
+        static_cast<uint64_t*>(data), static_cast<const uint64_t*>(other),
+        count, op);
+    break;
+  case katana::CommDataType::kFloat:
+    Combine(
+        static_cast<float*>(data), static_cast<const float*>(other), count,
+        op);
+    break;
+  case katana::CommDataType::kDouble:
+    Combine(
+        static_cast<double*>(data), static_cast<const double*>(other), count,
+        op);
+    break;
+  }
+}
+
+}  // namespace
+
+size_t
+katana::CommDataTypeSize(CommDataType type) {
+  switch (type) {
+  case CommDataType::kInt32:
+  case CommDataType::kUInt32:
+  case CommDataType::kFloat:
+    return 4;
+  case CommDataType::kInt64:
+  case CommDataType::kUInt64:
+  case CommDataType::kDouble:
+    return 8;
+  }
+  return 0;
+}
+
 // Anchor vtables
 
+katana::CommRequest::~CommRequest() = default;
+
 katana::CommBackend::~CommBackend() = default;
 
+std::vector<std::string>
+katana::CommBackend::AllToAll(const std::vector<std::string>& send) {
+  KATANA_LOG_ASSERT(send.size() == Num);
+  std::vector<std::string> recv(Num);
+  recv[ID] = send[ID];
+  for (uint32_t root = 0; root < Num; ++root) {
+    // The message of root is the sizes of its messages to each task followed
+    // by the messages
+    std::string message;
+    if (root == ID) {
+      for (const std::string& s : send) {
+        uint64_t size = s.size();
+        message.append(reinterpret_cast<const char*>(&size), sizeof(size));
+      }
+      for (const std::string& s : send) {
+        message.append(s);
+      }
+    }
+    std::string size = Broadcast(root, std::to_string(message.size()), 32);
+    message = Broadcast(root, message, std::stoull(size));
+    if (root == ID) {
+      continue;
+    }
+
+    uint64_t offset = Num * sizeof(uint64_t);
+    uint64_t my_size = 0;
+    for (uint32_t task = 0; task <= ID; ++task) {
+      uint64_t task_size = 0;
+      std::memcpy(
+          &task_size, message.data() + task * sizeof(uint64_t),
+          sizeof(task_size));
+      if (task < ID) {
+        offset += task_size;
+      } else {
+        my_size = task_size;
+      }
+    }
+    recv[root] = message.substr(offset, my_size);
+  }
+  return recv;
+}
+
+katana::Result<void>
+katana::CommBackend::AllReduce(
+    void* data, uint64_t count, CommDataType type, CommReduceOp op) {
+  uint64_t size = count * CommDataTypeSize(type);
+  std::string mine(static_cast<const char*>(data), size);
+  std::vector<std::string> all =
+      AllToAll(std::vector<std::string>(Num, mine));
+  // Combine in task order so that every task gets the same result, also of
+  // floating point sums
+  for (uint32_t task = 0; task < Num; ++task) {
+    if (all[task].size() != size) {
+      return KATANA_ERROR(
+          ErrorCode::CommError, "task {} reduced {} bytes, not {}", task,
+          all[task].size(), size);
+    }
+  }
+  std::memcpy(data, all[0].data(), size);
+  for (uint32_t task = 1; task < Num; ++task) {
+    Combine(data, all[task].data(), count, type, op);
+  }
+  return ResultSuccess();
+}
+
+katana::Result<std::vector<std::shared_ptr<arrow::Buffer>>>
+katana::CommBackend::AllToAllV(
+    const std::vector<std::shared_ptr<arrow::Buffer>>& send) {
+  if (send.size() != Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} buffers for {} tasks", send.size(),
+        Num);
+  }
+  std::vector<std::string> messages(Num);
+  for (uint32_t task = 0; task < Num; ++task) {
+    if (send[task]) {
+      messages[task] = send[task]->ToString();
+    }
+  }
+  std::vector<std::string> recv = AllToAll(messages);
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers(Num);
+  for (uint32_t task = 0; task < Num; ++task) {
+    buffers[task] = arrow::Buffer::FromString(std::move(recv[task]));
+  }
+  return buffers;
+}
+
+katana::Result<std::vector<std::shared_ptr<arrow::Buffer>>>
+katana::CommBackend::Gather(
+    uint32_t root, const std::shared_ptr<arrow::Buffer>& send) {
+  std::vector<std::shared_ptr<arrow::Buffer>> to_root(Num);
+  to_root[root] = send;
+  auto recv_res = AllToAllV(to_root);
+  if (!recv_res) {
+    return recv_res.error();
+  }
+  if (ID != root) {
+    return std::vector<std::shared_ptr<arrow::Buffer>>{};
+  }
+  return recv_res;
+}
+
+std::unique_ptr<katana::CommRequest>
+katana::CommBackend::IAllReduce(
+    void* data, uint64_t count, CommDataType type, CommReduceOp op) {
+  if (auto r = AllReduce(data, count, type, op); !r) {
+    return std::make_unique<DoneRequest>(r.error());
+  }
+  return std::make_unique<DoneRequest>();
+}
+
+std::unique_ptr<katana::CommRequest>
+katana::CommBackend::IAllToAllV(
+    const std::vector<std::shared_ptr<arrow::Buffer>>& send,
+    std::vector<std::shared_ptr<arrow::Buffer>>* recv) {
+  auto recv_res = AllToAllV(send);
+  if (!recv_res) {
+    return std::make_unique<DoneRequest>(recv_res.error());
+  }
+  *recv = std::move(recv_res.value());
+  return std::make_unique<DoneRequest>();
+}
+
 void
 katana::NullCommBackend::NotifyFailure() {}
@@ -1,5 +1,13 @@
 #include "katana/Http.h"
 
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <strings.h>
+#include <thread>
+#include <unordered_map>
+
 #include <curl/curl.h>
 
 #include "katana/ErrorCode.h"
@@ -8,12 +16,70 @@
 
 namespace {
 
+/// The easy handles of a thread between requests. A handle keeps its
+/// connections open after a request, so reusing them saves connecting to a
+/// server again.
+class HandlePool {
+  static constexpr size_t kMaxHandles = 4;
+  std::vector<CURL*> handles_;
+
+public:
+  HandlePool() = default;
+  HandlePool(const HandlePool& no_copy) = delete;
+  HandlePool& operator=(const HandlePool& no_copy) = delete;
+
+  ~HandlePool() {
+    for (CURL* handle : handles_) {
+      curl_easy_cleanup(handle);
+    }
+  }
+
+  CURL* Take() {
+    if (handles_.empty()) {
+      return curl_easy_init();
+    }
+    CURL* handle = handles_.back();
+    handles_.pop_back();
+    return handle;
+  }
+
+  /// Reset handle, which keeps its connections but not its options
+  void Return(CURL* handle) {
+    if (handles_.size() >= kMaxHandles) {
+      curl_easy_cleanup(handle);
+      return;
+    }
+    curl_easy_reset(handle);
+    handles_.emplace_back(handle);
+  }
+};
+
+thread_local HandlePool handle_pool;
+
 class CurlHandle {
   CURL* handle_{};
   struct curl_slist* headers_{};
 
   CurlHandle(CURL* handle) : handle_(handle) {}
 
+  static size_t ReadETagCB(
+      char* buffer, size_t size, size_t nitems, void* user_data) {
+    size_t real_size = size * nitems;
+    std::string_view header(buffer, real_size);  // NOLINT (c interface)
+    constexpr std::string_view kName = "etag:";
+    if (header.size() > kName.size() &&
+        strncasecmp(header.data(), kName.data(), kName.size()) == 0) {
+      header.remove_prefix(kName.size());
+      size_t begin = header.find_first_not_of(" \t");
+      size_t end = header.find_last_not_of(" \t\r\n");
+      if (begin != std::string_view::npos) {
+        static_cast<std::string*>(user_data)->assign(
+            header.substr(begin, end - begin + 1));
+      }
+    }
+    return real_size;
+  }
+
   static size_t WriteDataToVectorCB(
       char* ptr, size_t size, size_t nmemb, void* user_data) {
     size_t real_size = size * nmemb;
@@ -38,7 +104,7 @@ public:
 
   static katana::Result<CurlHandle> Make(
       const std::string& url, std::vector<char>* response) {
-    CURL* curl = curl_easy_init();
+    CURL* curl = handle_pool.Take();
     if (!curl) {
       return katana::ErrorCode::HttpError;
     }
@@ -62,8 +128,16 @@ public:
       curl_slist_free_all(headers_);
     }
     if (handle_ != nullptr) {
-      curl_easy_cleanup(handle_);
+      handle_pool.Return(handle_);
+    }
+  }
+
+  /// Fill etag with the entity tag of the response, if it has one
+  katana::Result<void> ReadETag(std::string* etag) {
+    if (auto res = SetOpt(CURLOPT_HEADERFUNCTION, ReadETagCB); !res) {
+      return res.error();
     }
+    return SetOpt(CURLOPT_HEADERDATA, etag);
   }
 
   void SetHeader(const std::string& header) {
@@ -80,22 +154,34 @@ public:
   }
 
   katana::Result<void> Perform() {
+    if (auto res = SetHeaders(); !res) {
+      return res.error();
+    }
+    return Finish(curl_easy_perform(handle_));
+  }
+
+  /// Pass the headers set so far to curl, before the request starts
+  katana::Result<void> SetHeaders() {
     if (headers_ != nullptr) {
-      if (auto res = SetOpt(CURLOPT_HTTPHEADER, headers_); !res) {
-        return res.error();
-      }
+      return SetOpt(CURLOPT_HTTPHEADER, headers_);
     }
-    CURLcode request_res = curl_easy_perform(handle_);
+    return katana::ResultSuccess();
+  }
+
+  /// The result of the request, once curl finished it with request_res
+  katana::Result<void> Finish(CURLcode request_res) {
     if (request_res != CURLE_OK) {
       KATANA_LOG_ERROR("CURL error: {}", curl_easy_strerror(request_res));
       return katana::ErrorCode::HttpError;
     }
 
-    int64_t response_code;
-    curl_easy_getinfo(handle_, CURLINFO_RESPONSE_CODE, &response_code);
-    switch (response_code) {
+    curl_easy_getinfo(handle_, CURLINFO_RESPONSE_CODE, &response_code_);
+    switch (response_code_) {
     case 200:
       return katana::ResultSuccess();
+    // Only sent for conditional requests
+    case 304:
+      return katana::ResultSuccess();
     case 404:
       return katana::ErrorCode::NotFound;
     case 400:
@@ -104,25 +190,73 @@ public:
       return katana::ErrorCode::AlreadyExists;
     default:
       KATANA_LOG_ERROR(
-          "HTTP request returned unhandled code: {}", response_code);
+          "HTTP request returned unhandled code: {}", response_code_);
       return katana::ErrorCode::HttpError;
     }
   }
+
+  int64_t response_code() const { return response_code_; }
+
+private:
+  int64_t response_code_{0};
 };
 
+/// Send data, which curl reads in place, as the body of the request
 katana::Result<void>
-HttpUploadCommon(CurlHandle&& holder, const std::string& data) {
-  if (auto res = holder.SetOpt(CURLOPT_POSTFIELDS, data.c_str()); !res) {
+SetUpload(CurlHandle* holder, const std::string& data) {
+  if (auto res = holder->SetOpt(CURLOPT_POSTFIELDS, data.c_str()); !res) {
     return res.error();
   }
-  if (auto res = holder.SetOpt(CURLOPT_POSTFIELDSIZE, data.size()); !res) {
+  if (auto res = holder->SetOpt(CURLOPT_POSTFIELDSIZE, data.size()); !res) {
+    return res.error();
+  }
+  holder->SetHeader("Content-Type: application/json");
+  holder->SetHeader("Accept: application/json");
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+HttpUploadCommon(CurlHandle&& holder, const std::string& data) {
+  if (auto res = SetUpload(&holder, data); !res) {
     return res.error();
   }
-  holder.SetHeader("Content-Type: application/json");
-  holder.SetHeader("Accept: application/json");
   return holder.Perform();
 }
 
+/// A handle for a request of method, e.g., "PUT", or a GET if null
+katana::Result<CurlHandle>
+MakeRequest(
+    const std::string& url, std::vector<char>* response, const char* method) {
+  auto curl_res = CurlHandle::Make(url, response);
+  if (!curl_res) {
+    return curl_res.error();
+  }
+  CurlHandle curl(std::move(curl_res.value()));
+  auto res = method ? curl.SetOpt(CURLOPT_CUSTOMREQUEST, method)
+                    : curl.SetOpt(CURLOPT_HTTPGET, 1L);
+  if (!res) {
+    return res.error();
+  }
+  return CurlHandle(std::move(curl));
+}
+
+size_t
+WriteDataToSinkCB(char* ptr, size_t size, size_t nmemb, void* user_data) {
+  size_t real_size = size * nmemb;
+  (*static_cast<katana::HttpClient::BodySink*>(user_data))(ptr, real_size);
+  return real_size;
+}
+
+/// A request of an HttpClient from the time it is made until it finishes
+struct AsyncRequest {
+  CurlHandle curl;
+  /// The body sent
+  std::string data;
+  /// The sink of the response body, if not a vector
+  katana::HttpClient::BodySink sink;
+  std::promise<katana::Result<void>> promise;
+};
+
 }  // namespace
 
 katana::Result<void>
@@ -143,6 +277,38 @@ katana::HttpGet(const std::string& url, std::vector<char>* response) {
   return katana::ResultSuccess();
 }
 
+katana::Result<bool>
+katana::HttpGetIfNoneMatch(
+    const std::string& url, std::string* etag, std::vector<char>* response) {
+  std::vector<char> body;
+  auto curl_res = CurlHandle::Make(url, &body);
+  if (!curl_res) {
+    return curl_res.error();
+  }
+  CurlHandle curl(std::move(curl_res.value()));
+
+  if (auto res = curl.SetOpt(CURLOPT_HTTPGET, 1L); !res) {
+    return res.error();
+  }
+  if (!etag->empty()) {
+    curl.SetHeader("If-None-Match: " + *etag);
+  }
+  std::string new_etag;
+  if (auto res = curl.ReadETag(&new_etag); !res) {
+    return res.error();
+  }
+  if (auto res = curl.Perform(); !res) {
+    KATANA_LOG_DEBUG("GET failed for url: {}", url);
+    return res.error();
+  }
+  if (curl.response_code() == 304) {
+    return false;
+  }
+  *etag = std::move(new_etag);
+  *response = std::move(body);
+  return true;
+}
+
 katana::Result<void>
 katana::HttpPost(
     const std::string& url, const std::string& data,
@@ -209,3 +375,193 @@ katana::HttpInit() {
   }
   return katana::ResultSuccess();
 }
+
+struct katana::HttpClient::Impl {
+  /// How long the thread waits for activity before checking for requests
+  static constexpr int kPollMs = 100;
+
+  CURLM* multi{};
+  std::mutex mutex;
+  std::vector<std::unique_ptr<AsyncRequest>> queued;
+  bool stopping{false};
+  std::thread thread;
+
+  /// The requests in progress, by easy handle; used only by the thread
+  std::unordered_map<CURL*, std::unique_ptr<AsyncRequest>> active;
+
+  void Run();
+  std::future<katana::Result<void>> Submit(
+      katana::Result<CurlHandle>&& curl_res, std::string&& data, bool upload,
+      BodySink&& sink);
+};
+
+std::future<katana::Result<void>>
+katana::HttpClient::Impl::Submit(
+    katana::Result<CurlHandle>&& curl_res, std::string&& data, bool upload,
+    BodySink&& sink) {
+  std::promise<katana::Result<void>> failed;
+  if (!curl_res) {
+    failed.set_value(curl_res.error());
+    return failed.get_future();
+  }
+  auto request = std::make_unique<AsyncRequest>(AsyncRequest{
+      .curl = std::move(curl_res.value()),
+      .data = std::move(data),
+      .sink = std::move(sink),
+      .promise = {},
+  });
+  CurlHandle* curl = &request->curl;
+  auto prepare = [&]() -> katana::Result<void> {
+    if (upload) {
+      if (auto res = SetUpload(curl, request->data); !res) {
+        return res.error();
+      }
+    }
+    if (request->sink) {
+      if (auto res = curl->SetOpt(CURLOPT_WRITEFUNCTION, WriteDataToSinkCB);
+          !res) {
+        return res.error();
+      }
+      if (auto res = curl->SetOpt(CURLOPT_WRITEDATA, &request->sink); !res) {
+        return res.error();
+      }
+    }
+    // Prefer HTTP/2 over TLS, and wait to share a connection that is being
+    // made rather than making another
+    if (auto res = curl->SetOpt(
+            CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+        !res) {
+      return res.error();
+    }
+    if (auto res = curl->SetOpt(CURLOPT_PIPEWAIT, 1L); !res) {
+      return res.error();
+    }
+    return curl->SetHeaders();
+  };
+  if (auto res = prepare(); !res) {
+    failed.set_value(res.error());
+    return failed.get_future();
+  }
+
+  std::future<katana::Result<void>> future = request->promise.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.emplace_back(std::move(request));
+  }
+  curl_multi_wakeup(multi);
+  return future;
+}
+
+void
+katana::HttpClient::Impl::Run() {
+  for (;;) {
+    std::vector<std::unique_ptr<AsyncRequest>> started;
+    bool stop = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      started.swap(queued);
+      stop = stopping;
+    }
+    for (std::unique_ptr<AsyncRequest>& request : started) {
+      CURL* easy = request->curl.handle();
+      if (auto err = curl_multi_add_handle(multi, easy); err != CURLM_OK) {
+        KATANA_LOG_ERROR("CURL error: {}", curl_multi_strerror(err));
+        request->promise.set_value(katana::ErrorCode::HttpError);
+        continue;
+      }
+      active.emplace(easy, std::move(request));
+    }
+    if (stop) {
+      break;
+    }
+
+    int running = 0;
+    if (auto err = curl_multi_perform(multi, &running); err != CURLM_OK) {
+      KATANA_LOG_ERROR("CURL error: {}", curl_multi_strerror(err));
+    }
+    int left = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi, &left)) {
+      if (msg->msg != CURLMSG_DONE) {
+        continue;
+      }
+      auto it = active.find(msg->easy_handle);
+      KATANA_LOG_DEBUG_ASSERT(it != active.end());
+      curl_multi_remove_handle(multi, msg->easy_handle);
+      std::unique_ptr<AsyncRequest> request = std::move(it->second);
+      active.erase(it);
+      request->promise.set_value(request->curl.Finish(msg->data.result));
+    }
+    curl_multi_poll(multi, nullptr, 0, kPollMs, nullptr);
+  }
+
+  for (auto& [easy, request] : active) {
+    curl_multi_remove_handle(multi, easy);
+    request->promise.set_value(KATANA_ERROR(
+        katana::ErrorCode::HttpError, "client stopped before the request"));
+  }
+  active.clear();
+}
+
+katana::HttpClient&
+katana::HttpClient::Get() {
+  static HttpClient client;
+  return client;
+}
+
+katana::HttpClient::HttpClient() : impl_(std::make_unique<Impl>()) {
+  impl_->multi = curl_multi_init();
+  KATANA_LOG_ASSERT(impl_->multi != nullptr);
+  curl_multi_setopt(impl_->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  impl_->thread = std::thread([this]() { impl_->Run(); });
+}
+
+katana::HttpClient::~HttpClient() {
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->stopping = true;
+  }
+  curl_multi_wakeup(impl_->multi);
+  impl_->thread.join();
+  // Requests made while stopping
+  for (std::unique_ptr<AsyncRequest>& request : impl_->queued) {
+    request->promise.set_value(KATANA_ERROR(
+        katana::ErrorCode::HttpError, "client stopped before the request"));
+  }
+  impl_->queued.clear();
+  curl_multi_cleanup(impl_->multi);
+}
+
+std::future<katana::Result<void>>
+katana::HttpClient::GetAsync(
+    const std::string& url, std::vector<char>* response) {
+  return impl_->Submit(
+      MakeRequest(url, response, nullptr), std::string(), false, BodySink());
+}
+
+std::future<katana::Result<void>>
+katana::HttpClient::GetAsync(const std::string& url, BodySink sink) {
+  return impl_->Submit(
+      MakeRequest(url, nullptr, nullptr), std::string(), false,
+      std::move(sink));
+}
+
+std::future<katana::Result<void>>
+katana::HttpClient::PostAsync(
+    const std::string& url, std::string data, std::vector<char>* response) {
+  return impl_->Submit(
+      MakeRequest(url, response, "POST"), std::move(data), true, BodySink());
+}
+
+std::future<katana::Result<void>>
+katana::HttpClient::PutAsync(
+    const std::string& url, std::string data, std::vector<char>* response) {
+  return impl_->Submit(
+      MakeRequest(url, response, "PUT"), std::move(data), true, BodySink());
+}
+
+std::future<katana::Result<void>>
+katana::HttpClient::DeleteAsync(
+    const std::string& url, std::vector<char>* response) {
+  return impl_->Submit(
+      MakeRequest(url, response, "DELETE"), std::string(), false, BodySink());
+}
@@ -1,55 +1,416 @@
 #include "katana/Logging.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
 
 #include "katana/Env.h"
 
 namespace {
 
-void
-PrintString(
-    bool error, bool flush, const std::string& prefix, const std::string& s) {
-  static std::mutex lock;
-  std::lock_guard<std::mutex> lg(lock);
+struct Record {
+  katana::LogLevel level{katana::LogLevel::Debug};
+  std::chrono::system_clock::time_point time;
+  uint64_t thread{0};
+  const char* file_name{nullptr};
+  int line_no{0};
+  uint64_t suppressed{0};
+  std::string message;
+};
+
+const char*
+LevelName(katana::LogLevel level) {
+  switch (level) {
+  case katana::LogLevel::Debug:
+    return "DEBUG";
+  case katana::LogLevel::Verbose:
+    return "VERBOSE";
+  case katana::LogLevel::Warning:
+    return "WARNING";
+  case katana::LogLevel::Error:
+    return "ERROR";
+  default:
+    return "UNKNOWN LOG LEVEL";
+  }
+}
 
-  std::ostream& o = error ? std::cerr : std::cout;
-  if (!prefix.empty()) {
-    o << prefix << ": ";
+/// The id of this thread in log records, in the order threads first log
+uint64_t
+ThreadId() {
+  static std::atomic<uint64_t> next_id{0};
+  thread_local uint64_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+  return id;
+}
+
+std::string
+FormatRecord(const Record& r, bool json) {
+  if (json) {
+    nlohmann::json j{
+        {"time_us", std::chrono::duration_cast<std::chrono::microseconds>(
+                        r.time.time_since_epoch())
+                        .count()},
+        {"level", LevelName(r.level)},
+        {"thread", r.thread},
+        {"message", r.message},
+    };
+    if (r.file_name != nullptr) {
+      j["file"] = r.file_name;
+      j["line"] = r.line_no;
+    }
+    if (r.suppressed != 0) {
+      j["suppressed"] = r.suppressed;
+    }
+    // Messages may hold arbitrary bytes; replace invalid UTF-8 rather than
+    // throw
+    return j.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
   }
-  o << s << "\n";
-  if (flush) {
-    o.flush();
+
+  std::string s =
+      r.file_name == nullptr
+          ? fmt::format("{}: {}", LevelName(r.level), r.message)
+          : fmt::format(
+                "{}: {}:{}: {}", LevelName(r.level), r.file_name, r.line_no,
+                r.message);
+  if (r.suppressed != 0) {
+    s += fmt::format(" ({} similar messages suppressed)", r.suppressed);
   }
+  return s;
 }
 
+/// A bounded queue of the records of one thread, with one producer, the
+/// thread, and one consumer, whoever drains the logger
+class Ring {
+public:
+  explicit Ring(uint32_t capacity) : records_(capacity) {}
+
+  uint32_t capacity() const { return static_cast<uint32_t>(records_.size()); }
+
+  /// \returns false, and counts r as dropped, if the ring is full
+  bool TryPush(Record&& r) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == records_.size()) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    records_[tail % records_.size()] = std::move(r);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename F>
+  void Drain(F fn) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      Record& r = records_[head % records_.size()];
+      fn(r);
+      // Release the memory of long messages
+      r.message = std::string();
+    }
+    head_.store(head, std::memory_order_release);
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  uint64_t TakeDropped() {
+    return dropped_.exchange(0, std::memory_order_relaxed);
+  }
+
+private:
+  std::vector<Record> records_;
+  // Keep the producer and consumer indices on cache lines of their own
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+class Logger {
+public:
+  /// The logger lives until the process ends so that static destructors
+  /// may log
+  static Logger& Get() {
+    static Logger* logger = new Logger();
+    return *logger;
+  }
+
+  bool Enabled(katana::LogLevel level) const {
+    return static_cast<int32_t>(level) >=
+           level_.load(std::memory_order_relaxed);
+  }
+
+  uint32_t rate_limit() const {
+    return rate_limit_.load(std::memory_order_relaxed);
+  }
+
+  void Write(Record&& r) {
+    bool async = async_.load(std::memory_order_acquire);
+    if (!async || r.level == katana::LogLevel::Error) {
+      if (async) {
+        // Keep the messages logged before an error before it
+        Drain();
+      }
+      WriteNow(FormatRecord(r, json_.load(std::memory_order_relaxed)), true);
+      return;
+    }
+    bool is_warning = r.level == katana::LogLevel::Warning;
+    if (LocalRing()->TryPush(std::move(r)) && is_warning) {
+      wake_.notify_one();
+    }
+  }
+
+  void SetConfig(const katana::LogConfig& config) {
+    std::lock_guard<std::mutex> config_lock(config_mutex_);
+    StopFlusher();
+    Drain();
+    {
+      std::lock_guard<std::mutex> output_lock(output_mutex_);
+      stream_ = config.stream == nullptr ? &std::cerr : config.stream;
+    }
+    json_.store(config.json, std::memory_order_relaxed);
+    level_.store(
+        static_cast<int32_t>(config.level), std::memory_order_relaxed);
+    rate_limit_.store(config.rate_limit, std::memory_order_relaxed);
+    ring_capacity_.store(
+        std::max<uint32_t>(config.ring_capacity, 1),
+        std::memory_order_relaxed);
+    if (config.async) {
+      StartFlusher();
+    }
+  }
+
+  /// Write the records of every thread, in order per thread
+  void Drain() {
+    std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+      std::lock_guard<std::mutex> rings_lock(rings_mutex_);
+      rings = rings_;
+    }
+    if (rings.empty()) {
+      return;
+    }
+
+    bool json = json_.load(std::memory_order_relaxed);
+    std::string batch;
+    for (const auto& ring : rings) {
+      ring->Drain([&](const Record& r) {
+        batch += FormatRecord(r, json);
+        batch += '\n';
+      });
+      if (uint64_t dropped = ring->TakeDropped(); dropped != 0) {
+        Record r;
+        r.level = katana::LogLevel::Warning;
+        r.time = std::chrono::system_clock::now();
+        r.message = fmt::format(
+            "dropped {} log messages; the ring of their thread was full",
+            dropped);
+        batch += FormatRecord(r, json);
+        batch += '\n';
+      }
+    }
+    rings.clear();
+
+    // Forget the rings of threads that have exited once they are empty
+    {
+      std::lock_guard<std::mutex> rings_lock(rings_mutex_);
+      std::vector<std::shared_ptr<Ring>> live;
+      for (auto& ring : rings_) {
+        if (ring.use_count() > 1 || !ring->empty()) {
+          live.emplace_back(std::move(ring));
+        }
+      }
+      rings_ = std::move(live);
+    }
+
+    if (!batch.empty()) {
+      WriteNow(batch, false);
+    }
+  }
+
+  /// Stop asynchronous logging at exit so that no message is lost
+  void Shutdown() {
+    std::lock_guard<std::mutex> config_lock(config_mutex_);
+    StopFlusher();
+    Drain();
+  }
+
+private:
+  Logger() { SetConfig(katana::LogConfig::FromEnv()); }
+
+  void WriteNow(const std::string& s, bool add_newline) {
+    std::lock_guard<std::mutex> output_lock(output_mutex_);
+    *stream_ << s;
+    if (add_newline) {
+      *stream_ << "\n";
+    }
+    stream_->flush();
+  }
+
+  Ring* LocalRing() {
+    thread_local std::shared_ptr<Ring> ring;
+    uint32_t capacity = ring_capacity_.load(std::memory_order_relaxed);
+    if (!ring || ring->capacity() != capacity) {
+      ring = std::make_shared<Ring>(capacity);
+      std::lock_guard<std::mutex> rings_lock(rings_mutex_);
+      rings_.emplace_back(ring);
+    }
+    return ring.get();
+  }
+
+  void StartFlusher() {
+    static bool registered = [] {
+      std::atexit([] { Logger::Get().Shutdown(); });
+      return true;
+    }();
+    (void)registered;
+
+    stop_ = false;
+    flusher_ = std::thread([this] {
+      std::unique_lock<std::mutex> lock(flusher_mutex_);
+      while (!stop_) {
+        wake_.wait_for(lock, std::chrono::milliseconds(10));
+        lock.unlock();
+        Drain();
+        lock.lock();
+      }
+    });
+    async_.store(true, std::memory_order_release);
+  }
+
+  void StopFlusher() {
+    async_.store(false, std::memory_order_release);
+    if (!flusher_.joinable()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(flusher_mutex_);
+      stop_ = true;
+    }
+    wake_.notify_one();
+    flusher_.join();
+  }
+
+  std::atomic<int32_t> level_{static_cast<int32_t>(katana::LogLevel::Debug)};
+  std::atomic<bool> async_{false};
+  std::atomic<bool> json_{false};
+  std::atomic<uint32_t> rate_limit_{0};
+  std::atomic<uint32_t> ring_capacity_{1};
+
+  /// Serializes SetConfig and Shutdown
+  std::mutex config_mutex_;
+  /// Serializes consumers of the rings
+  std::mutex drain_mutex_;
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<Ring>> rings_;
+
+  std::mutex flusher_mutex_;
+  std::condition_variable wake_;
+  bool stop_{false};
+  std::thread flusher_;
+
+  std::mutex output_mutex_;
+  std::ostream* stream_{&std::cerr};
+};
+
 }  // end unnamed namespace
 
+katana::LogConfig
+katana::LogConfig::FromEnv() {
+  LogConfig config;
+  int level = static_cast<int32_t>(LogLevel::Debug);
+  GetEnv("KATANA_LOG_LEVEL", &level);
+  config.level = static_cast<LogLevel>(level);
+  GetEnv("KATANA_LOG_ASYNC", &config.async);
+  std::string format;
+  if (GetEnv("KATANA_LOG_FORMAT", &format)) {
+    config.json = format == "json";
+  }
+  int rate_limit = 0;
+  if (GetEnv("KATANA_LOG_RATE_LIMIT", &rate_limit) && rate_limit > 0) {
+    config.rate_limit = rate_limit;
+  }
+  return config;
+}
+
+void
+katana::SetLogConfig(const LogConfig& config) {
+  Logger::Get().SetConfig(config);
+}
+
+void
+katana::FlushLog() {
+  Logger::Get().Drain();
+}
+
+bool
+katana::internal::LogEnabled(katana::LogLevel level) {
+  return Logger::Get().Enabled(level);
+}
+
+bool
+katana::internal::LogSite::Allow(uint64_t* suppressed) {
+  uint32_t limit = Logger::Get().rate_limit();
+  if (limit == 0) {
+    *suppressed = 0;
+    return true;
+  }
+
+  uint64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count();
+  uint64_t window = window_.load(std::memory_order_relaxed);
+  // Concurrent messages at the turn of a second may be counted against
+  // either window; the limit is approximate
+  if (window != now && window_.compare_exchange_strong(
+                           window, now, std::memory_order_relaxed)) {
+    count_.store(0, std::memory_order_relaxed);
+  }
+  if (count_.fetch_add(1, std::memory_order_relaxed) >= limit) {
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  *suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+  return true;
+}
+
+void
+katana::internal::LogRecord(
+    katana::LogLevel level, const char* file_name, int line_no,
+    std::string&& message, uint64_t suppressed) {
+  Record r;
+  r.level = level;
+  r.time = std::chrono::system_clock::now();
+  r.thread = ThreadId();
+  r.file_name = file_name;
+  r.line_no = line_no;
+  r.suppressed = suppressed;
+  r.message = std::move(message);
+  Logger::Get().Write(std::move(r));
+}
+
 void
 katana::internal::LogString(katana::LogLevel level, const std::string& s) {
-  int env_log_level = static_cast<int32_t>(LogLevel::Debug);
-  GetEnv("KATANA_LOG_LEVEL", &env_log_level);
   // Only log KATANA_LOG_LEVEL and above (default, log everything)
-  if (static_cast<int32_t>(level) < env_log_level) {
+  if (!LogEnabled(level)) {
     return;
   }
-
-  switch (level) {
-  case LogLevel::Debug:
-    return PrintString(true, false, "DEBUG", s);
-  case LogLevel::Verbose:
-    return PrintString(true, false, "VERBOSE", s);
-  case LogLevel::Warning:
-    return PrintString(true, false, "WARNING", s);
-  case LogLevel::Error:
-    return PrintString(true, false, "ERROR", s);
-  default:
-    return PrintString(true, false, "UNKNOWN LOG LEVEL", s);
-  }
+  LogRecord(level, nullptr, 0, std::string(s), 0);
 }
 
 void
 katana::AbortApplication() {
+  FlushLog();
   // TODO(amp): Replace this with an exception throw that can be caught in
   //  language wrappers to avoid low-level aborting the language runtime.
   std::abort();
@@ -0,0 +1,389 @@
+#include "katana/MpiCommBackend.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// The most bytes moved by one MPI call, which counts in ints
+constexpr uint64_t kMaxPiece = uint64_t{1} << 30U;
+constexpr int kDataTag = 0;
+
+katana::Result<void>
+MpiCheck(int code, const char* call) {
+  if (code == MPI_SUCCESS) {
+    return katana::ResultSuccess();
+  }
+  char message[MPI_MAX_ERROR_STRING];
+  int length = 0;
+  MPI_Error_string(code, message, &length);
+  return KATANA_ERROR(
+      katana::ErrorCode::CommError, "{}: {}", call,
+      std::string(message, length));
+}
+
+/// For the operations of CommBackend that cannot return errors
+void
+MustSucceed(int code, const char* call) {
+  if (auto r = MpiCheck(code, call); !r) {
+    KATANA_LOG_FATAL("{}", r.error());
+  }
+}
+
+MPI_Datatype
+MpiType(katana::CommDataType type) {
+  switch (type) {
+  case katana::CommDataType::kInt32:
+    return MPI_INT32_T;
+  case katana::CommDataType::kUInt32:
+    return MPI_UINT32_T;
+  case katana::CommDataType::kInt64:
+    return MPI_INT64_T;
+  case katana::CommDataType::kUInt64:
+    return MPI_UINT64_T;
+  case katana::CommDataType::kFloat:
+    return MPI_FLOAT;
+  case katana::CommDataType::kDouble:
+    return MPI_DOUBLE;
+  }
+  return MPI_DATATYPE_NULL;
+}
+
+MPI_Op
+MpiOp(katana::CommReduceOp op) {
+  switch (op) {
+  case katana::CommReduceOp::kSum:
+    return MPI_SUM;
+  case katana::CommReduceOp::kMin:
+    return MPI_MIN;
+  case katana::CommReduceOp::kMax:
+    return MPI_MAX;
+  }
+  return MPI_OP_NULL;
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t size) {
+  auto buffer_res = arrow::AllocateBuffer(size);
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(buffer_res.status()),
+        "allocating {} bytes to receive: {}", size, buffer_res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(buffer_res.ValueOrDie()));
+}
+
+/// The pieces in flight of a collective and the buffers they read and
+/// write. After an error the remaining pieces are still posted, so that
+/// the other tasks are not left waiting for them, and Wait returns the
+/// first error.
+class MpiRequest : public katana::CommRequest {
+public:
+  MpiRequest() = default;
+  MpiRequest(const MpiRequest&) = delete;
+  MpiRequest& operator=(const MpiRequest&) = delete;
+
+  ~MpiRequest() override {
+    // MPI may still touch the buffers until the pieces are done
+    if (!requests_.empty()) {
+      MPI_Waitall(
+          static_cast<int>(requests_.size()), requests_.data(),
+          MPI_STATUSES_IGNORE);
+    }
+  }
+
+  katana::Result<void> Wait() override {
+    int code = MPI_Waitall(
+        static_cast<int>(requests_.size()), requests_.data(),
+        MPI_STATUSES_IGNORE);
+    requests_.clear();
+    held_.clear();
+    if (!error_) {
+      if (auto r = MpiCheck(code, "MPI_Waitall"); !r) {
+        Fail(r.error());
+      }
+    }
+    if (error_) {
+      return KATANA_ERROR(error_->error_code(), "{}", *error_);
+    }
+    if (out_) {
+      *out_ = std::move(recv_);
+      out_ = nullptr;
+    }
+    return katana::ResultSuccess();
+  }
+
+  /// Record an error to return from Wait; the first one is kept
+  void Fail(const katana::ErrorInfo& error) {
+    if (!error_) {
+      error_ = error;
+    }
+  }
+
+  /// Keep the posted operation started by code from call
+  void Post(int code, const char* call, MPI_Request request) {
+    if (auto r = MpiCheck(code, call); !r) {
+      Fail(r.error());
+      return;
+    }
+    requests_.emplace_back(request);
+  }
+
+  void Send(const uint8_t* data, uint64_t size, int peer, MPI_Comm comm) {
+    for (uint64_t offset = 0; offset < size; offset += kMaxPiece) {
+      int count = static_cast<int>(std::min(kMaxPiece, size - offset));
+      MPI_Request request{};
+      int code = MPI_Isend(
+          data + offset, count, MPI_BYTE, peer, kDataTag, comm, &request);
+      Post(code, "MPI_Isend", request);
+    }
+  }
+
+  /// Receive the pieces sent by Send of peer; as pieces between two tasks
+  /// with one tag arrive in order, they split the same way
+  void Receive(uint8_t* data, uint64_t size, int peer, MPI_Comm comm) {
+    for (uint64_t offset = 0; offset < size; offset += kMaxPiece) {
+      int count = static_cast<int>(std::min(kMaxPiece, size - offset));
+      MPI_Request request{};
+      int code = MPI_Irecv(
+          data + offset, count, MPI_BYTE, peer, kDataTag, comm, &request);
+      Post(code, "MPI_Irecv", request);
+    }
+  }
+
+  /// Keep buffers alive until the pieces are done
+  void Hold(const std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
+    held_.insert(held_.end(), buffers.begin(), buffers.end());
+  }
+
+  /// Move recv into *out when Wait succeeds
+  void Deliver(
+      std::vector<std::shared_ptr<arrow::Buffer>> recv,
+      std::vector<std::shared_ptr<arrow::Buffer>>* out) {
+    recv_ = std::move(recv);
+    out_ = out;
+  }
+
+private:
+  std::vector<MPI_Request> requests_;
+  std::vector<std::shared_ptr<arrow::Buffer>> held_;
+  std::vector<std::shared_ptr<arrow::Buffer>> recv_;
+  std::vector<std::shared_ptr<arrow::Buffer>>* out_{nullptr};
+  std::optional<katana::CopyableErrorInfo> error_;
+};
+
+}  // namespace
+
+katana::MpiCommBackend::MpiCommBackend(MPI_Comm comm) {
+  MustSucceed(MPI_Comm_dup(comm, &comm_), "MPI_Comm_dup");
+  MustSucceed(
+      MPI_Comm_set_errhandler(comm_, MPI_ERRORS_RETURN),
+      "MPI_Comm_set_errhandler");
+  int size = 0;
+  int rank = 0;
+  MustSucceed(MPI_Comm_size(comm_, &size), "MPI_Comm_size");
+  MustSucceed(MPI_Comm_rank(comm_, &rank), "MPI_Comm_rank");
+  Num = size;
+  ID = rank;
+}
+
+katana::MpiCommBackend::~MpiCommBackend() { MPI_Comm_free(&comm_); }
+
+void
+katana::MpiCommBackend::Barrier() {
+  MustSucceed(MPI_Barrier(comm_), "MPI_Barrier");
+}
+
+bool
+katana::MpiCommBackend::Broadcast(uint32_t root, bool val) {
+  uint8_t value = val ? 1 : 0;
+  MustSucceed(MPI_Bcast(&value, 1, MPI_UINT8_T, root, comm_), "MPI_Bcast");
+  return value != 0;
+}
+
+std::string
+katana::MpiCommBackend::Broadcast(
+    uint32_t root, const std::string& val, uint64_t max_size) {
+  uint64_t size = std::min<uint64_t>(val.size(), max_size);
+  MustSucceed(MPI_Bcast(&size, 1, MPI_UINT64_T, root, comm_), "MPI_Bcast");
+  std::string result = ID == root ? val.substr(0, size) : std::string(size, 0);
+  for (uint64_t offset = 0; offset < size; offset += kMaxPiece) {
+    int count = static_cast<int>(std::min(kMaxPiece, size - offset));
+    MustSucceed(
+        MPI_Bcast(result.data() + offset, count, MPI_BYTE, root, comm_),
+        "MPI_Bcast");
+  }
+  return result;
+}
+
+void
+katana::MpiCommBackend::NotifyFailure() {
+  MPI_Abort(comm_, EXIT_FAILURE);
+}
+
+std::vector<std::string>
+katana::MpiCommBackend::AllToAll(const std::vector<std::string>& send) {
+  // The strings outlive the exchange, so send them without a copy
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+  buffers.reserve(send.size());
+  for (const std::string& s : send) {
+    buffers.emplace_back(std::make_shared<arrow::Buffer>(
+        reinterpret_cast<const uint8_t*>(s.data()), s.size()));
+  }
+  auto recv_res = AllToAllV(buffers);
+  if (!recv_res) {
+    KATANA_LOG_FATAL("exchanging messages: {}", recv_res.error());
+  }
+  std::vector<std::string> recv;
+  recv.reserve(Num);
+  for (const auto& buffer : recv_res.value()) {
+    recv.emplace_back(buffer->ToString());
+  }
+  return recv;
+}
+
+katana::Result<void>
+katana::MpiCommBackend::AllReduce(
+    void* data, uint64_t count, CommDataType type, CommReduceOp op) {
+  uint64_t element_size = CommDataTypeSize(type);
+  uint64_t piece = kMaxPiece / element_size;
+  auto* bytes = static_cast<uint8_t*>(data);
+  for (uint64_t offset = 0; offset < count; offset += piece) {
+    int piece_count = static_cast<int>(std::min(piece, count - offset));
+    int code = MPI_Allreduce(
+        MPI_IN_PLACE, bytes + offset * element_size, piece_count,
+        MpiType(type), MpiOp(op), comm_);
+    if (auto r = MpiCheck(code, "MPI_Allreduce"); !r) {
+      return r.error();
+    }
+  }
+  return ResultSuccess();
+}
+
+katana::Result<std::vector<std::shared_ptr<arrow::Buffer>>>
+katana::MpiCommBackend::AllToAllV(
+    const std::vector<std::shared_ptr<arrow::Buffer>>& send) {
+  std::vector<std::shared_ptr<arrow::Buffer>> recv;
+  if (auto r = IAllToAllV(send, &recv)->Wait(); !r) {
+    return r.error();
+  }
+  return recv;
+}
+
+katana::Result<std::vector<std::shared_ptr<arrow::Buffer>>>
+katana::MpiCommBackend::Gather(
+    uint32_t root, const std::shared_ptr<arrow::Buffer>& send) {
+  uint64_t size = send ? send->size() : 0;
+  std::vector<uint64_t> sizes(ID == root ? Num : 0);
+  int code = MPI_Gather(
+      &size, 1, MPI_UINT64_T, sizes.data(), 1, MPI_UINT64_T, root, comm_);
+  if (auto r = MpiCheck(code, "MPI_Gather"); !r) {
+    return r.error();
+  }
+
+  MpiRequest request;
+  std::vector<std::shared_ptr<arrow::Buffer>> recv;
+  if (ID != root) {
+    if (send) {
+      request.Send(send->data(), size, root, comm_);
+    }
+  } else {
+    recv.resize(Num);
+    for (uint32_t task = 0; task < Num; ++task) {
+      if (task == ID && send) {
+        recv[task] = send;
+        continue;
+      }
+      auto buffer_res = Allocate(sizes[task]);
+      if (!buffer_res) {
+        request.Fail(buffer_res.error());
+        continue;
+      }
+      recv[task] = std::move(buffer_res.value());
+      if (task != ID) {
+        request.Receive(recv[task]->mutable_data(), sizes[task], task, comm_);
+      }
+    }
+  }
+  if (auto r = request.Wait(); !r) {
+    return r.error();
+  }
+  return recv;
+}
+
+std::unique_ptr<katana::CommRequest>
+katana::MpiCommBackend::IAllReduce(
+    void* data, uint64_t count, CommDataType type, CommReduceOp op) {
+  auto request = std::make_unique<MpiRequest>();
+  uint64_t element_size = CommDataTypeSize(type);
+  uint64_t piece = kMaxPiece / element_size;
+  auto* bytes = static_cast<uint8_t*>(data);
+  for (uint64_t offset = 0; offset < count; offset += piece) {
+    int piece_count = static_cast<int>(std::min(piece, count - offset));
+    MPI_Request piece_request{};
+    int code = MPI_Iallreduce(
+        MPI_IN_PLACE, bytes + offset * element_size, piece_count,
+        MpiType(type), MpiOp(op), comm_, &piece_request);
+    request->Post(code, "MPI_Iallreduce", piece_request);
+  }
+  return request;
+}
+
+std::unique_ptr<katana::CommRequest>
+katana::MpiCommBackend::IAllToAllV(
+    const std::vector<std::shared_ptr<arrow::Buffer>>& send,
+    std::vector<std::shared_ptr<arrow::Buffer>>* recv) {
+  auto request = std::make_unique<MpiRequest>();
+  if (send.size() != Num) {
+    request->Fail(KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} buffers for {} tasks", send.size(),
+        Num));
+    return request;
+  }
+
+  // The sizes are exchanged before returning so that the receives can be
+  // posted; only the data is in flight when the request is returned
+  std::vector<uint64_t> send_sizes(Num);
+  for (uint32_t task = 0; task < Num; ++task) {
+    send_sizes[task] = send[task] ? send[task]->size() : 0;
+  }
+  std::vector<uint64_t> recv_sizes(Num);
+  int code = MPI_Alltoall(
+      send_sizes.data(), 1, MPI_UINT64_T, recv_sizes.data(), 1, MPI_UINT64_T,
+      comm_);
+  if (auto r = MpiCheck(code, "MPI_Alltoall"); !r) {
+    request->Fail(r.error());
+    return request;
+  }
+
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers(Num);
+  for (uint32_t task = 0; task < Num; ++task) {
+    if (task == ID && send[task]) {
+      buffers[task] = send[task];
+      continue;
+    }
+    auto buffer_res = Allocate(recv_sizes[task]);
+    if (!buffer_res) {
+      request->Fail(buffer_res.error());
+      continue;
+    }
+    buffers[task] = std::move(buffer_res.value());
+    if (task != ID) {
+      request->Receive(
+          buffers[task]->mutable_data(), recv_sizes[task], task, comm_);
+    }
+  }
+  for (uint32_t task = 0; task < Num; ++task) {
+    if (task != ID && send_sizes[task] > 0) {
+      request->Send(send[task]->data(), send_sizes[task], task, comm_);
+    }
+  }
+  request->Hold(send);
+  request->Deliver(std::move(buffers), recv);
+  return request;
+}
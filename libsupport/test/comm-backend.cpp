@@ -0,0 +1,207 @@
+#include "katana/CommBackend.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kNumTasks = 4;
+
+/// The state shared by the tasks of a ThreadCommBackend
+struct Shared {
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint32_t waiting{0};
+  uint64_t generation{0};
+  std::string slot;
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    uint64_t generation_now = generation;
+    if (++waiting == kNumTasks) {
+      waiting = 0;
+      ++generation;
+      cv.notify_all();
+    } else {
+      cv.wait(lock, [&] { return generation != generation_now; });
+    }
+  }
+};
+
+/// A backend of threads that implements only the required operations, so
+/// the collectives run their default implementations
+class ThreadCommBackend : public katana::CommBackend {
+public:
+  ThreadCommBackend(Shared* shared, uint32_t id) : shared_(shared) {
+    Num = kNumTasks;
+    ID = id;
+  }
+
+  void Barrier() override { shared_->Wait(); }
+  bool Broadcast(uint32_t root, bool val) override {
+    return Broadcast(root, std::string(1, val ? '1' : '0'), 1) == "1";
+  }
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override {
+    shared_->Wait();
+    if (ID == root) {
+      shared_->slot = val.substr(0, max_size);
+    }
+    shared_->Wait();
+    std::string found = shared_->slot;
+    shared_->Wait();
+    return found;
+  }
+  void NotifyFailure() override {}
+
+private:
+  Shared* shared_;
+};
+
+void
+RunTasks(const std::function<void(katana::CommBackend*)>& fn) {
+  Shared shared;
+  std::vector<std::thread> threads;
+  for (uint32_t id = 0; id < kNumTasks; ++id) {
+    threads.emplace_back([&, id] {
+      ThreadCommBackend comm(&shared, id);
+      fn(&comm);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+/// The message from task from to task to
+std::string
+Message(uint32_t from, uint32_t to) {
+  return std::string(from * kNumTasks + to, static_cast<char>('a' + from));
+}
+
+void
+TestAllToAll() {
+  RunTasks([](katana::CommBackend* comm) {
+    std::vector<std::string> send;
+    for (uint32_t to = 0; to < comm->Num; ++to) {
+      send.emplace_back(Message(comm->ID, to));
+    }
+    std::vector<std::string> recv = comm->AllToAll(send);
+    KATANA_LOG_ASSERT(recv.size() == comm->Num);
+    for (uint32_t from = 0; from < comm->Num; ++from) {
+      KATANA_LOG_VASSERT(
+          recv[from] == Message(from, comm->ID),
+          "task {} received {} from task {}", comm->ID, recv[from], from);
+    }
+  });
+}
+
+void
+TestAllReduce() {
+  RunTasks([](katana::CommBackend* comm) {
+    std::vector<uint64_t> values{comm->ID, 10 * comm->ID, 1};
+    auto res = comm->AllReduce(
+        values.data(), values.size(), katana::CommReduceOp::kSum);
+    KATANA_LOG_ASSERT(res);
+    KATANA_LOG_VASSERT(
+        values[0] == 6 && values[1] == 60 && values[2] == kNumTasks,
+        "unexpected sums {} {} {}", values[0], values[1], values[2]);
+
+    auto min_res = comm->AllReduce(
+        static_cast<int32_t>(comm->ID) - 1, katana::CommReduceOp::kMin);
+    KATANA_LOG_ASSERT(min_res && min_res.value() == -1);
+
+    auto max_res =
+        comm->AllReduce(0.5 * comm->ID, katana::CommReduceOp::kMax);
+    KATANA_LOG_ASSERT(max_res && max_res.value() == 1.5);
+  });
+}
+
+void
+TestAllToAllV() {
+  RunTasks([](katana::CommBackend* comm) {
+    std::vector<std::shared_ptr<arrow::Buffer>> send;
+    for (uint32_t to = 0; to < comm->Num; ++to) {
+      send.emplace_back(arrow::Buffer::FromString(Message(comm->ID, to)));
+    }
+    auto recv_res = comm->AllToAllV(send);
+    KATANA_LOG_ASSERT(recv_res);
+    auto recv = std::move(recv_res.value());
+    KATANA_LOG_ASSERT(recv.size() == comm->Num);
+    for (uint32_t from = 0; from < comm->Num; ++from) {
+      KATANA_LOG_ASSERT(recv[from]->ToString() == Message(from, comm->ID));
+    }
+
+    send.pop_back();
+    KATANA_LOG_ASSERT(!comm->AllToAllV(send));
+  });
+}
+
+void
+TestGather() {
+  RunTasks([](katana::CommBackend* comm) {
+    uint32_t root = 2;
+    auto res = comm->Gather(
+        root, arrow::Buffer::FromString(Message(comm->ID, root)));
+    KATANA_LOG_ASSERT(res);
+    if (comm->ID != root) {
+      KATANA_LOG_ASSERT(res.value().empty());
+      return;
+    }
+    KATANA_LOG_ASSERT(res.value().size() == comm->Num);
+    for (uint32_t from = 0; from < comm->Num; ++from) {
+      KATANA_LOG_ASSERT(res.value()[from]->ToString() == Message(from, root));
+    }
+  });
+}
+
+void
+TestNonBlocking() {
+  RunTasks([](katana::CommBackend* comm) {
+    int64_t value = comm->ID;
+    auto reduce_req = comm->IAllReduce(
+        &value, 1, katana::CommDataType::kInt64, katana::CommReduceOp::kMax);
+    KATANA_LOG_ASSERT(reduce_req->Wait());
+    KATANA_LOG_ASSERT(value == kNumTasks - 1);
+
+    std::vector<std::shared_ptr<arrow::Buffer>> send;
+    for (uint32_t to = 0; to < comm->Num; ++to) {
+      send.emplace_back(arrow::Buffer::FromString(Message(comm->ID, to)));
+    }
+    std::vector<std::shared_ptr<arrow::Buffer>> recv;
+    auto exchange_req = comm->IAllToAllV(send, &recv);
+    KATANA_LOG_ASSERT(exchange_req->Wait());
+    KATANA_LOG_ASSERT(recv.size() == comm->Num);
+    for (uint32_t from = 0; from < comm->Num; ++from) {
+      KATANA_LOG_ASSERT(recv[from]->ToString() == Message(from, comm->ID));
+    }
+  });
+}
+
+void
+TestNullCommBackend() {
+  katana::NullCommBackend comm;
+  auto res = comm.AllReduce(uint32_t{7}, katana::CommReduceOp::kSum);
+  KATANA_LOG_ASSERT(res && res.value() == 7);
+
+  auto buffer = arrow::Buffer::FromString("x");
+  auto recv_res = comm.AllToAllV({buffer});
+  KATANA_LOG_ASSERT(recv_res && recv_res.value()[0] == buffer);
+}
+
+}  // namespace
+
+int
+main() {
+  TestAllToAll();
+  TestAllReduce();
+  TestAllToAllV();
+  TestGather();
+  TestNonBlocking();
+  TestNullCommBackend();
+}
@@ -1,6 +1,92 @@
 #include "katana/Logging.h"
 
+#include <sstream>
+#include <string>
 #include <system_error>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+void
+TestAsyncJson() {
+  constexpr int kThreads = 4;
+  constexpr int kMessages = 100;
+
+  std::ostringstream out;
+  katana::LogConfig config;
+  config.async = true;
+  config.json = true;
+  config.stream = &out;
+  config.ring_capacity = kMessages;
+  katana::SetLogConfig(config);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t] {
+      for (int i = 0; i < kMessages; ++i) {
+        katana::LogLine(
+            katana::LogLevel::Warning, __FILE__, __LINE__, "{} {}", t, i);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  katana::FlushLog();
+
+  // Messages of one thread are written in order
+  std::vector<int> next(kThreads);
+  std::istringstream lines(out.str());
+  std::string line;
+  while (std::getline(lines, line)) {
+    auto j = nlohmann::json::parse(line);
+    KATANA_LOG_ASSERT(j["level"] == "WARNING");
+    KATANA_LOG_ASSERT(j["file"] == __FILE__);
+    std::istringstream message(j["message"].get<std::string>());
+    int t = 0;
+    int i = 0;
+    message >> t >> i;
+    KATANA_LOG_VASSERT(next[t] == i, "thread {}: {} after {}", t, i, next[t]);
+    ++next[t];
+  }
+  for (int t = 0; t < kThreads; ++t) {
+    KATANA_LOG_ASSERT(next[t] == kMessages);
+  }
+}
+
+void
+TestRateLimit() {
+  std::ostringstream out;
+  katana::LogConfig config;
+  config.level = katana::LogLevel::Warning;
+  config.rate_limit = 5;
+  config.stream = &out;
+  katana::SetLogConfig(config);
+
+  int formatted = 0;
+  auto count = [&formatted] { return ++formatted; };
+  for (int i = 0; i < 1000; ++i) {
+    KATANA_LOG_WARN("rate limited {}", i);
+    // Disabled levels are not formatted
+    KATANA_LOG_VERBOSE("not written {}", count());
+  }
+  KATANA_LOG_ERROR("errors are not rate limited");
+  katana::FlushLog();
+
+  size_t num_lines = 0;
+  std::istringstream lines(out.str());
+  std::string line;
+  while (std::getline(lines, line)) {
+    ++num_lines;
+  }
+  KATANA_LOG_ASSERT(formatted == 0);
+  // 5 messages per second from the site of the warning and the error
+  KATANA_LOG_VASSERT(
+      num_lines > 1 && num_lines < 1000, "wrote {} lines", num_lines);
+  KATANA_LOG_ASSERT(
+      out.str().find("errors are not rate limited") != std::string::npos);
+}
 
 int
 main() {
@@ -18,5 +104,9 @@ main() {
   KATANA_LOG_DEBUG("this will only be printed in debug builds");
   KATANA_LOG_ASSERT(1 == 1);
 
+  TestAsyncJson();
+  TestRateLimit();
+  katana::SetLogConfig(katana::LogConfig::FromEnv());
+
   return 0;
 }
@@ -5,8 +5,73 @@
 
 #include "katana/Logging.h"
 
+void
+TestCounterRandom() {
+  using katana::CounterRandom;
+
+  // Known answers of Philox4x32-10 from its reference implementation
+  KATANA_LOG_ASSERT(
+      CounterRandom::Philox({0, 0, 0, 0}, 0) ==
+      CounterRandom::Block({0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  KATANA_LOG_ASSERT(
+      CounterRandom::Philox(
+          {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+          0x299f31d0a4093822ULL) ==
+      CounterRandom::Block({0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+
+  // Calls, At and Fill agree wherever they start
+  for (uint64_t start : {0, 1, 6}) {
+    std::vector<uint64_t> filled(13);
+    CounterRandom::Fill(42, 7, start, filled.data(), filled.size());
+    CounterRandom gen(42, 7);
+    gen.discard(start);
+    for (uint64_t i = 0; i < filled.size(); ++i) {
+      uint64_t word = gen();
+      KATANA_LOG_ASSERT(word == filled[i]);
+      KATANA_LOG_ASSERT(word == CounterRandom::At(42, 7, start + i));
+    }
+  }
+
+  // Streams of different keys differ
+  KATANA_LOG_ASSERT(CounterRandom::At(42, 7, 0) != CounterRandom::At(42, 8, 0));
+  KATANA_LOG_ASSERT(CounterRandom::At(42, 7, 0) != CounterRandom::At(43, 7, 0));
+
+  // Streams drawn by many threads match the streams drawn by one
+  std::vector<uint64_t> expected(128);
+  for (uint64_t i = 0; i < expected.size(); ++i) {
+    CounterRandom gen(8675309, i);
+    std::uniform_int_distribution<uint64_t> dist(0, 1000);
+    for (int step = 0; step < 100; ++step) {
+      expected[i] += dist(gen);
+    }
+  }
+  std::vector<uint64_t> results(expected.size());
+  std::vector<std::thread> threads;
+  for (uint64_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&results, t]() {
+      for (uint64_t i = t; i < results.size(); i += 4) {
+        CounterRandom gen(8675309, i);
+        std::uniform_int_distribution<uint64_t> dist(0, 1000);
+        for (int step = 0; step < 100; ++step) {
+          results[i] += dist(gen);
+        }
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  KATANA_LOG_ASSERT(results == expected);
+
+  double unit = CounterRandom::ToUnit(~uint64_t{0});
+  KATANA_LOG_ASSERT(unit < 1.0 && CounterRandom::ToUnit(0) == 0.0);
+  KATANA_LOG_ASSERT(CounterRandom::ToIndex(~uint64_t{0}, 10) == 9);
+}
+
 int
 main() {
+  TestCounterRandom();
+
   // test to make sure we have enough randomness
   std::vector<std::thread> threads;
   for (int i = 0; i < 128; ++i) {
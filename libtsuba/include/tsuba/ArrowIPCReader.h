@@ -0,0 +1,72 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_ARROWIPCREADER_H_
+#define KATANA_LIBTSUBA_TSUBA_ARROWIPCREADER_H_
+
+#include <optional>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+#include "katana/Uri.h"
+#include "tsuba/ParquetReader.h"
+
+namespace tsuba {
+
+/// Reads tables stored as uncompressed Arrow IPC files (Feather v2), the
+/// alternative to Parquet for properties that must load quickly. The file
+/// is mapped by a FileView and the arrays of the table point into the
+/// mapping instead of being decoded, so a table is ready once its file is
+/// resident and keeps the file mapped while any of its arrays is alive.
+class KATANA_EXPORT ArrowIPCReader {
+public:
+  using Slice = ParquetReader::Slice;
+
+  struct ReadOpts {
+    /// if provided, slice the resulting table so that it only contains
+    /// Slice.length rows starting from Slice.offset
+    std::optional<Slice> slice{std::nullopt};
+
+    /// if provided, only the rows in these ranges, which must be sorted and
+    /// disjoint, keep their values; all other rows of the resulting table
+    /// are null. Cannot be combined with slice
+    std::optional<std::vector<Slice>> row_ranges{std::nullopt};
+
+    /// pool for the buffers that reading must copy, i.e., those of tables
+    /// read with row_ranges or stored in several chunks; nullptr means
+    /// arrow::default_memory_pool()
+    arrow::MemoryPool* memory_pool{nullptr};
+
+    static ReadOpts Defaults() { return ReadOpts{}; }
+  };
+
+  static katana::Result<std::unique_ptr<ArrowIPCReader>> Make(
+      ReadOpts opts = ReadOpts::Defaults());
+
+  /// read table from storage
+  ///   \param uri an identifier for an Arrow IPC file
+  katana::Result<std::shared_ptr<arrow::Table>> ReadTable(
+      const katana::Uri& uri);
+
+  /// Get the schema of the table stored in an Arrow IPC file. Only the file
+  /// footer is read.
+  ///   \param uri an identifier for an Arrow IPC file
+  katana::Result<std::shared_ptr<arrow::Schema>> ReadSchema(
+      const katana::Uri& uri);
+
+private:
+  ArrowIPCReader(
+      std::optional<Slice> slice,
+      std::optional<std::vector<Slice>> row_ranges, arrow::MemoryPool* pool)
+      : slice_(slice), row_ranges_(std::move(row_ranges)), pool_(pool) {}
+
+  katana::Result<std::shared_ptr<arrow::Table>> KeepRanges(
+      const std::shared_ptr<arrow::Table>& table);
+
+  std::optional<Slice> slice_;
+  std::optional<std::vector<Slice>> row_ranges_;
+  arrow::MemoryPool* pool_;
+};
+
+}  // namespace tsuba
+
+#endif
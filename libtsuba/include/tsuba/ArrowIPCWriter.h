@@ -0,0 +1,46 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_ARROWIPCWRITER_H_
+#define KATANA_LIBTSUBA_TSUBA_ARROWIPCWRITER_H_
+
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+#include "katana/Uri.h"
+#include "tsuba/WriteGroup.h"
+
+namespace tsuba {
+
+/// Writes tables as uncompressed Arrow IPC files (Feather v2), which
+/// ArrowIPCReader maps instead of decoding. Files are larger than Parquet
+/// files of the same table since they are neither encoded nor compressed.
+class KATANA_EXPORT ArrowIPCWriter {
+public:
+  /// \returns a Writer that will write a table consisting of a single column
+  /// \param array will become the lone column in the table
+  /// \param name will become the name of the column in the table
+  static katana::Result<std::unique_ptr<ArrowIPCWriter>> Make(
+      const std::shared_ptr<arrow::ChunkedArray>& array,
+      const std::string& name);
+
+  /// \returns a Writer that will write a table to a storage location
+  static katana::Result<std::unique_ptr<ArrowIPCWriter>> Make(
+      std::shared_ptr<arrow::Table> table);
+
+  /// write table out to a storage location. If `group` is null, the write is
+  /// synchronous, if not an asynchronous write is started to be managed by
+  /// group
+  katana::Result<void> WriteToUri(
+      const katana::Uri& uri, WriteGroup* group = nullptr);
+
+private:
+  explicit ArrowIPCWriter(std::shared_ptr<arrow::Table> table)
+      : table_(std::move(table)) {}
+
+  std::shared_ptr<arrow::Table> table_;
+};
+
+}  // namespace tsuba
+
+#endif
@@ -2,6 +2,7 @@
 #define KATANA_LIBTSUBA_TSUBA_CSRTOPOLOGY_H_
 
 #include <cstdint>
+#include <limits>
 
 #include "katana/BitMath.h"
 
@@ -35,6 +36,136 @@ CSRTopologyFileSize(const CSRTopologyHeader& header) {
          (header.num_edges * header.edge_type_size);
 }
 
+/// Version of compressed CSR files. (Version 2 is taken by GR files with 64-bit
+/// destinations.)
+///
+/// A compressed CSR file starts with the same header and out index array as
+/// every CSR file, so CSRTopologyPrefix still applies. Instead of a fixed-width
+/// destination array, the edges of each node are stored as a block of
+/// variable-length integers:
+///
+///   uint64_t[num_nodes] dest_offsets: end of each node's block in dest_blocks
+///   uint8_t[dest_offsets[num_nodes - 1]] dest_blocks
+///
+/// The i-th entry of the block of node n encodes dest_i - dest_{i-1}, where
+/// dest_{-1} is n, as a zigzag LEB128 integer. Edge order is preserved, and
+/// when edges are sorted by destination (see SortAllEdgesByDest) or mostly
+/// local most entries take one or two bytes instead of four.
+///
+/// The format saves storage and load bandwidth. katana::PropertyGraph decodes
+/// it into a GraphTopology of 4 bytes per edge when loaded, since edge ids
+/// index edge properties; katana::CompressedTopology keeps it compressed in
+/// memory for analytics that do not need edge ids.
+constexpr uint64_t kCompressedCSRTopologyVersion = 3;
+
+constexpr uint64_t
+CompressedCSRTopologyFileSize(
+    const CSRTopologyHeader& header, uint64_t dest_blocks_size) {
+  return sizeof(header) + 2 * header.num_nodes * sizeof(uint64_t) +
+         dest_blocks_size;
+}
+
+namespace internal {
+
+constexpr uint64_t
+ZigZagEncode(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+constexpr int64_t
+ZigZagDecode(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+}  // namespace internal
+
+/// \returns the number of bytes needed to encode the destinations [begin, end)
+/// of node \param src
+inline uint64_t
+CompressedCSRDestsSize(
+    uint32_t src, const uint32_t* begin, const uint32_t* end) {
+  uint64_t size = 0;
+  uint32_t prev = src;
+  for (const uint32_t* it = begin; it != end; ++it) {
+    uint64_t v = internal::ZigZagEncode(int64_t{*it} - int64_t{prev});
+    do {
+      ++size;
+      v >>= 7;
+    } while (v != 0);
+    prev = *it;
+  }
+  return size;
+}
+
+/// Encode the destinations [begin, end) of node \param src into \param out,
+/// which must have room for CompressedCSRDestsSize bytes.
+///
+/// \returns one past the last byte written
+inline uint8_t*
+EncodeCompressedCSRDests(
+    uint32_t src, const uint32_t* begin, const uint32_t* end, uint8_t* out) {
+  uint32_t prev = src;
+  for (const uint32_t* it = begin; it != end; ++it) {
+    uint64_t v = internal::ZigZagEncode(int64_t{*it} - int64_t{prev});
+    while (v >= 0x80) {
+      *out++ = static_cast<uint8_t>(v | 0x80);
+      v >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(v);
+    prev = *it;
+  }
+  return out;
+}
+
+/// Decode the destination that follows \param dest, the previous destination
+/// of the block (or its node for the first one), from the block bytes
+/// [\param in, \param end). On success, dest is the decoded destination and
+/// in points past its bytes.
+///
+/// \returns false if the block is malformed
+inline bool
+DecodeCompressedCSRDest(
+    const uint8_t** in, const uint8_t* end, uint32_t* dest) {
+  uint64_t v = 0;
+  int shift = 0;
+  for (;;) {
+    if (*in == end || shift > 63) {
+      return false;
+    }
+    uint8_t byte = *(*in)++;
+    v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      break;
+    }
+    shift += 7;
+  }
+  int64_t next = int64_t{*dest} + internal::ZigZagDecode(v);
+  if (next < 0 || next > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  *dest = static_cast<uint32_t>(next);
+  return true;
+}
+
+/// Decode \param num_dests destinations of node \param src from the block
+/// [begin, end) into \param out.
+///
+/// \returns false if the block is malformed
+inline bool
+DecodeCompressedCSRDests(
+    uint32_t src, const uint8_t* begin, const uint8_t* end, uint64_t num_dests,
+    uint32_t* out) {
+  const uint8_t* in = begin;
+  uint32_t dest = src;
+  for (uint64_t i = 0; i < num_dests; ++i) {
+    if (!DecodeCompressedCSRDest(&in, end, &dest)) {
+      return false;
+    }
+    out[i] = dest;
+  }
+  return in == end;
+}
+
 }  // namespace tsuba
 
 #endif
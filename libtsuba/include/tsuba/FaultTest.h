@@ -14,6 +14,7 @@ enum class FaultMode {
   Independent,     // Each point has a fixed probability of failure
   RunLength,       // Specify the number call on which to crash (starts at 1)
   UniformOverRun,  // Choose uniform run length 1..run_length (exclusive)
+  ErrorRunLength,  // Fail the run_length-th TSUBA_PTP_FAILS with an error
 };
 
 KATANA_EXPORT void FaultTestInit(
@@ -32,6 +33,16 @@ KATANA_EXPORT void PtP(
     const char* file, int line,
     FaultSensitivity sensitivity = FaultSensitivity::Normal);
 
+// A point where an operation can fail and recover, e.g., by rolling back, in
+// the same process: in FaultMode::ErrorRunLength true if the caller should
+// fail with an error, else TSUBA_PTP and false
+#define TSUBA_PTP_FAILS(...)                                                   \
+  ::tsuba::internal::PtPFails(__FILE__, __LINE__, ##__VA_ARGS__)
+
+KATANA_EXPORT bool PtPFails(
+    const char* file, int line,
+    FaultSensitivity sensitivity = FaultSensitivity::Normal);
+
 }  // namespace tsuba::internal
 
 #endif
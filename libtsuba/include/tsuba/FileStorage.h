@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
@@ -14,6 +15,25 @@ namespace tsuba {
 
 struct StatBuf;
 
+/// An object being uploaded in parts, e.g., an S3 multipart upload. Parts may
+/// be put concurrently and in any order, and the object appears when the
+/// upload completes.
+class KATANA_EXPORT MultipartUpload {
+public:
+  virtual ~MultipartUpload();
+
+  /// Put part number \param part, counting from 0; every part but the last
+  /// has the part size the upload started with
+  virtual std::future<katana::Result<void>> PutPartAsync(
+      uint32_t part, const uint8_t* data, uint64_t size) = 0;
+
+  /// Assemble the parts into the object, once every part has been put
+  virtual katana::Result<void> Complete() = 0;
+
+  /// Discard the parts put so far
+  virtual void Abort() = 0;
+};
+
 class KATANA_EXPORT FileStorage {
   std::string uri_scheme_;
 
@@ -60,6 +80,15 @@ public:
   virtual katana::Result<void> Delete(
       const std::string& directory,
       const std::unordered_set<std::string>& files) = 0;
+
+  /// Start uploading the object at uri in parts of part_size bytes, for
+  /// backends whose objects can be assembled from parts; returns nullptr if
+  /// this backend cannot
+  virtual katana::Result<std::unique_ptr<MultipartUpload>> StartMultipartUpload(
+      [[maybe_unused]] const std::string& uri,
+      [[maybe_unused]] uint64_t part_size) {
+    return std::unique_ptr<MultipartUpload>();
+  }
 };
 
 /// RegisterFileStorage adds a file storage backend to the tsuba library. File
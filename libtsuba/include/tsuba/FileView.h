@@ -3,8 +3,10 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <parquet/arrow/reader.h>
 
@@ -14,6 +16,18 @@
 
 namespace tsuba {
 
+class SharedCache;
+
+/// Counters describing how well a FileView hid storage latency
+struct FileViewStats {
+  /// Reads (or frontier advances) served entirely from memory
+  uint64_t hits{0};
+  /// Reads (or frontier advances) that waited on storage
+  uint64_t stalls{0};
+  /// Bytes fetched asynchronously ahead of use
+  uint64_t bytes_prefetched{0};
+};
+
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
   struct FillingRange {
     uint64_t first_page;
@@ -28,8 +42,15 @@ class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
   int64_t mem_start_{0};
   std::string filename_;
   bool valid_{false};
+  bool shared_{false};
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
+  uint64_t readahead_{0};
+  uint64_t frontier_{0};
+  FileViewStats stats_;
+  /// The block checksums of the file, which every fill is verified against
+  /// once it arrives, or nullptr if it has none
+  std::shared_ptr<const std::vector<uint32_t>> checksums_;
 
 public:
   FileView() = default;
@@ -44,8 +65,13 @@ public:
         mem_start_(other.mem_start_),
         filename_(std::move(other.filename_)),
         valid_(other.valid_),
+        shared_(other.shared_),
         filling_(std::move(other.filling_)),
-        fetches_(std::move(other.fetches_)) {
+        fetches_(std::move(other.fetches_)),
+        readahead_(other.readahead_),
+        frontier_(other.frontier_),
+        stats_(other.stats_),
+        checksums_(std::move(other.checksums_)) {
     other.valid_ = false;
   }
 
@@ -61,9 +87,14 @@ public:
       mem_start_ = other.mem_start_;
       filename_ = std::move(other.filename_);
       valid_ = other.valid_;
+      shared_ = other.shared_;
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
+      readahead_ = other.readahead_;
+      frontier_ = other.frontier_;
+      stats_ = other.stats_;
+      checksums_ = std::move(other.checksums_);
       other.valid_ = false;
     }
     return *this;
@@ -93,6 +124,35 @@ public:
 
   katana::Result<void> Fill(uint64_t begin, uint64_t end, bool resolve);
 
+  /// Release the memory of the pages that lie wholly in [\param begin,
+  /// \param end), so that they must be filled again before they are read.
+  /// Pages shared with the bytes around the range stay resident. Does
+  /// nothing for a view of the shared cache, whose memory other processes
+  /// may be using.
+  katana::Result<void> Evict(uint64_t begin, uint64_t end);
+
+  /// Enable readahead: keep \param bytes past the scan frontier (the cursor
+  /// for Read, or the offset passed to AdvanceFrontier) fetched
+  /// asynchronously. 0, the default, falls back to prefetching a little more
+  /// than the size of the previous Read.
+  void set_readahead(uint64_t bytes) { readahead_ = bytes; }
+  uint64_t readahead() const { return readahead_; }
+
+  /// For scans that use ptr() instead of Read: make [frontier, \param offset)
+  /// resident, move the frontier to \param offset and start fetching the
+  /// readahead window after it. Offsets below the frontier are assumed to be
+  /// resident already.
+  ///
+  /// Like the rest of FileView, this is not thread-safe; advance the frontier
+  /// from one thread ahead of the threads that consume the data.
+  katana::Result<void> AdvanceFrontier(uint64_t offset);
+
+  /// The end of the range known to be resident for a scan; see
+  /// AdvanceFrontier
+  uint64_t frontier() const { return frontier_; }
+
+  const FileViewStats& stats() const { return stats_; }
+
   bool Valid() const { return valid_; }
 
   katana::Result<void> Unbind();
@@ -164,12 +224,25 @@ private:
   katana::Result<void> MarkFilled(
       uint64_t* bitmap, uint64_t begin, uint64_t end);
 
+  // Clear the bits of pages [begin, end] so that they are fetched again
+  void MarkEvicted(uint64_t* bitmap, uint64_t begin, uint64_t end);
+
   // Resolve all outstanding reads that overlap with the range [cursor_, nbytes]
   katana::Result<void> Resolve(int64_t start, int64_t size);
 
+  // Check the pages [first_page, last_page] just read against checksums_
+  katana::Result<void> Verify(uint64_t first_page, uint64_t last_page);
+
   // Start asynchronously fetching data that we think we might need from storage
   // @start and @size give the location and range of the previous read
   katana::Result<void> PreFetch(int64_t start, int64_t size);
+
+  // Make [start, start + size) resident, counting whether we had to wait
+  katana::Result<void> FillAndResolve(int64_t start, int64_t size);
+
+  // Rebind to the copy of filename_ in cache, if there is one, and report
+  // whether there was
+  katana::Result<bool> BindShared(const SharedCache& cache, uint64_t size);
 };
 }  // namespace tsuba
 
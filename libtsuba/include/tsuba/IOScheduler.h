@@ -0,0 +1,100 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_IOSCHEDULER_H_
+#define KATANA_LIBTSUBA_TSUBA_IOSCHEDULER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace tsuba {
+
+/// Classes of I/O in the order they start: every queued op of a class
+/// starts before any op of a later class on the same backend
+enum class IOPriority { Topology, Properties };
+
+/// Runs the reads and writes of ReadGroups and WriteGroups on a bounded pool
+/// of threads instead of a thread each, so that storing a graph with
+/// thousands of property files does not start thousands of threads.
+///
+/// Each backend (URI scheme) has at most max_ops ops running, holding at most
+/// max_bytes bytes between them, except that an op larger than max_bytes
+/// runs when nothing else on its backend does. Ops of a backend start in
+/// the order of their class and then of their scheduling.
+///
+/// An op scheduled by another op of the scheduler runs at once on the thread
+/// of that op, outside the bounds, so that ops can wait for the ops they
+/// schedule. Ops must not wait for ops that other threads schedule.
+class KATANA_EXPORT IOScheduler {
+public:
+  static constexpr uint32_t kDefaultMaxOps = 16;
+  static constexpr uint64_t kDefaultMaxBytes = UINT64_C(10) << 30;
+  /// Threads of the pool, so that two backends can each run max_ops ops
+  static constexpr uint32_t kMaxThreads = 2 * kDefaultMaxOps;
+
+  static IOScheduler* Get();
+
+  IOScheduler(uint32_t max_ops, uint64_t max_bytes, uint32_t max_threads);
+  /// Finish the queued ops and join the threads
+  ~IOScheduler();
+
+  IOScheduler(const IOScheduler&) = delete;
+  IOScheduler& operator=(const IOScheduler&) = delete;
+
+  /// Queue op, which reads or writes about \param bytes of \param uri
+  template <typename T>
+  std::future<katana::Result<T>> Schedule(
+      const std::string& uri, IOPriority priority, uint64_t bytes,
+      std::function<katana::Result<T>()> op) {
+    using Task = std::packaged_task<katana::Result<T>()>;
+    auto task = std::make_shared<Task>(std::move(op));
+    std::future<katana::Result<T>> future = task->get_future();
+    Enqueue(uri, priority, bytes, [task]() { (*task)(); });
+    return future;
+  }
+
+private:
+  struct Op {
+    std::string backend;
+    uint64_t bytes;
+    std::function<void()> run;
+  };
+
+  struct Backend {
+    uint32_t ops{0};
+    uint64_t bytes{0};
+  };
+
+  void Enqueue(
+      const std::string& uri, IOPriority priority, uint64_t bytes,
+      std::function<void()> run);
+  /// Take the first op that may start from the queues, or return false
+  bool TakeRunnable(Op* op);
+  void Work();
+
+  uint32_t max_ops_;
+  uint64_t max_bytes_;
+  uint32_t max_threads_;
+
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  /// Queued ops by class
+  std::vector<std::deque<Op>> queues_;
+  std::unordered_map<std::string, Backend> backends_;
+  uint32_t idle_threads_{0};
+  bool stopping_{false};
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace tsuba
+
+#endif
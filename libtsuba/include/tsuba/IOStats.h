@@ -0,0 +1,101 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_IOSTATS_H_
+#define KATANA_LIBTSUBA_TSUBA_IOSTATS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace tsuba {
+
+/// The kinds of I/O whose counts, bytes and latencies tsuba records:
+///
+/// - kStat, kGet, kPut, kList, kDelete and kCopy are the requests made to a
+///   FileStorage backend; a multipart transfer is one request per part, and
+///   reads served by the block cache are not requests
+/// - kFill is FileView::Fill, the time readers wait to map file ranges
+/// - kParquetRead and kParquetWrite are tables read by ParquetReader and
+///   encoded and stored by ParquetWriter, including their storage requests
+enum class IOOp : uint8_t {
+  kStat = 0,
+  kGet,
+  kPut,
+  kList,
+  kDelete,
+  kCopy,
+  kFill,
+  kParquetRead,
+  kParquetWrite,
+};
+
+constexpr size_t kNumIOOps = 9;
+
+/// The operations of one kind since the start of the program or the last
+/// ResetIOStats()
+struct IOOpStats {
+  uint64_t count{};
+  uint64_t errors{};
+  uint64_t bytes{};
+  uint64_t total_usec{};
+  uint64_t max_usec{};
+  /// Latency percentiles, to within a quarter of their value
+  uint64_t p50_usec{};
+  uint64_t p90_usec{};
+  uint64_t p99_usec{};
+
+  /// \returns the bytes per second of the operations, as if they ran one
+  ///     after another
+  double bytes_per_sec() const {
+    return total_usec == 0 ? 0.0 : 1.0e6 * bytes / total_usec;
+  }
+};
+
+KATANA_EXPORT const char* IOOpName(IOOp op);
+
+/// Record an operation of \param op that took \param usec microseconds and
+/// moved \param bytes. Thread safe.
+KATANA_EXPORT void RecordIO(IOOp op, uint64_t usec, uint64_t bytes, bool ok);
+
+KATANA_EXPORT IOOpStats GetIOStats(IOOp op);
+
+KATANA_EXPORT void ResetIOStats();
+
+/// Times an operation from its construction to Stop
+class KATANA_EXPORT IOTimer {
+  using Clock = std::chrono::steady_clock;
+
+  IOOp op_;
+  uint64_t bytes_;
+  Clock::time_point start_;
+
+public:
+  explicit IOTimer(IOOp op, uint64_t bytes = 0)
+      : op_(op), bytes_(bytes), start_(Clock::now()) {}
+
+  void AddBytes(uint64_t bytes) { bytes_ += bytes; }
+
+  /// Record the operation, which failed unless \param ok
+  void Stop(bool ok);
+};
+
+/// \returns the result of calling \param f, a function returning a Result,
+///     recorded as an operation of \param op
+template <typename F>
+auto
+TimeIO(IOOp op, uint64_t bytes, F f) -> decltype(f()) {
+  IOTimer timer(op, bytes);
+  auto res = f();
+  timer.Stop(res.has_value());
+  return res;
+}
+
+/// \returns a future of the result of \param future, recorded as an
+///     operation of \param op that lasts until its result is collected
+KATANA_EXPORT std::future<katana::Result<void>> TimeIOAsync(
+    IOOp op, uint64_t bytes, std::future<katana::Result<void>> future);
+
+}  // namespace tsuba
+
+#endif
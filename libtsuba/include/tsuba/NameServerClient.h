@@ -19,6 +19,15 @@ public:
 
   virtual katana::Result<RDGMeta> Get(const katana::Uri& rdg_name) = 0;
 
+  /// GetIfChanged fills meta with the entry of rdg_name and returns true,
+  /// unless its version is still known_version, in which case it returns
+  /// false and leaves meta as it was. Clients that can ask the server
+  /// whether an entry changed without fetching it, e.g., with a conditional
+  /// HTTP request (see katana::HttpGetIfNoneMatch), should override this; by
+  /// default it calls Get.
+  virtual katana::Result<bool> GetIfChanged(
+      const katana::Uri& rdg_name, uint64_t known_version, RDGMeta* meta);
+
   /// CreateIfAbsent creates a name server entry if it is not already
   /// present. If the name is already created and its version matches meta,
   /// this function returns sucess; otherwise, it returns an error.
@@ -2,6 +2,7 @@
 #define KATANA_LIBTSUBA_TSUBA_PARQUETREADER_H_
 
 #include <optional>
+#include <vector>
 
 #include <arrow/api.h>
 
@@ -32,6 +33,19 @@ public:
     /// Slice.length rows starting from Slice.offset
     std::optional<Slice> slice{std::nullopt};
 
+    /// if provided, only read the rows in these ranges, which must be sorted
+    /// and disjoint; all other rows of the resulting table are null. Cannot be
+    /// combined with slice
+    std::optional<std::vector<Slice>> row_ranges{std::nullopt};
+
+    /// maximum number of threads used to decode the row groups of a file in
+    /// parallel when reading a whole table; 0 means one per hardware thread
+    uint32_t num_threads{0};
+
+    /// pool for the buffers of the resulting table; nullptr means
+    /// arrow::default_memory_pool()
+    arrow::MemoryPool* memory_pool{nullptr};
+
     static ReadOpts Defaults() { return ReadOpts{}; }
   };
 
@@ -72,13 +86,48 @@ public:
   ///   \param uri an identifier for a parquet file
   katana::Result<int64_t> NumRows(const katana::Uri& uri);
 
+  /// Get the schema of the table stored in a parquet file, with the types
+  /// that ReadTable gives its columns. Only the file footer is read.
+  ///   \param uri an identifier for a parquet file
+  katana::Result<std::shared_ptr<arrow::Schema>> ReadSchema(
+      const katana::Uri& uri);
+
+  /// Use the row group statistics of a parquet file to find the rows whose
+  /// value in a column may lie in [min, max]. Only the file footer is read.
+  /// The result is conservative: rows outside of it certainly do not match,
+  /// rows inside of it may or may not. Row groups without usable statistics
+  /// (e.g., of non-numeric columns) always match. Boolean columns are
+  /// treated as 0 and 1.
+  ///   \param uri an identifier for a parquet file
+  ///   \param column_idx must be a valid column index for the table in that
+  ///      file
+  ///   \returns sorted, disjoint row ranges suitable for ReadOpts::row_ranges
+  katana::Result<std::vector<Slice>> FindCandidateRows(
+      const katana::Uri& uri, int32_t column_idx, double min, double max);
+
 private:
-  ParquetReader(std::optional<Slice> slice, bool make_cannonical)
-      : slice_(slice), make_cannonical_{make_cannonical} {}
+  ParquetReader(
+      std::optional<Slice> slice,
+      std::optional<std::vector<Slice>> row_ranges, uint32_t num_threads,
+      arrow::MemoryPool* pool, bool make_cannonical)
+      : slice_(slice),
+        row_ranges_(std::move(row_ranges)),
+        num_threads_(num_threads),
+        pool_(pool),
+        make_cannonical_{make_cannonical} {}
+
+  katana::Result<std::shared_ptr<arrow::Table>> ReadWholeTable(
+      const katana::Uri& uri);
 
   katana::Result<std::shared_ptr<arrow::Table>> ReadFromUriSliced(
       const katana::Uri& uri);
 
+  katana::Result<std::shared_ptr<arrow::Table>> ReadFromUriRanges(
+      const katana::Uri& uri);
+
+  katana::Result<std::shared_ptr<arrow::Table>> ReadRowGroupsParallel(
+      const katana::Uri& uri, int num_row_groups, int num_tasks);
+
   katana::Result<std::shared_ptr<arrow::Table>> FixTable(
       std::shared_ptr<arrow::Table>&& _table);
 
@@ -87,6 +136,9 @@ private:
       const std::vector<int32_t>& filter);
 
   std::optional<Slice> slice_;
+  std::optional<std::vector<Slice>> row_ranges_;
+  uint32_t num_threads_;
+  arrow::MemoryPool* pool_;
   bool make_cannonical_;
 };
 
@@ -2,6 +2,9 @@
 #define KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 
 #include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <arrow/api.h>
@@ -16,6 +19,23 @@ namespace tsuba {
 class KATANA_EXPORT ParquetWriter {
 public:
   struct WriteOpts {
+    /// Use the default compression level of the codec
+    static constexpr int kDefaultCompressionLevel =
+        std::numeric_limits<int>::min();
+
+    /// How the values of a column are compressed and encoded. The defaults
+    /// are those of Parquet.
+    struct ColumnOpts {
+      arrow::Compression::type compression{arrow::Compression::UNCOMPRESSED};
+      /// e.g., from 1 (fastest) to 22 (smallest) for ZSTD
+      int compression_level{kDefaultCompressionLevel};
+      /// Whether to store distinct values once and refer to them by index,
+      /// falling back to encoding when the dictionary grows too large
+      bool dictionary{true};
+      /// The encoding of values that are not dictionary encoded
+      parquet::Encoding::type encoding{parquet::Encoding::PLAIN};
+    };
+
     /// int64 timestamps with nanosecond resolution requires Parquet version
     /// 2.0. In Arrow to Parquet version 1.0, nanosecond timestamps will get
     /// truncated to milliseconds.
@@ -31,6 +51,26 @@ public:
 
     /// control the approximate size of blocked files when writing blocked
     uint64_t mbs_per_block{256};
+
+    /// number of rows per Parquet row group. Row groups are the unit of
+    /// parallelism and of statistics based filtering when reading
+    int64_t rows_per_row_group{int64_t{1} << 20};
+
+    /// Options of columns by name
+    std::unordered_map<std::string, ColumnOpts> column_opts;
+
+    /// if true, columns without column_opts get options chosen from their
+    /// type and the number of distinct values among a sample of them:
+    /// ZSTD, and dictionaries for columns with few distinct values;
+    /// otherwise they get the Parquet defaults
+    bool infer_column_opts{true};
+
+    /// Properties by name that an RDG stores as uncompressed Arrow IPC
+    /// files instead, which load by being mapped rather than decoded (see
+    /// ArrowIPCWriter). Their files are larger, and the options above do
+    /// not apply to them.
+    std::unordered_set<std::string> arrow_ipc_properties;
+
     static WriteOpts Defaults() { return WriteOpts{}; }
   };
 
@@ -62,7 +102,9 @@ private:
       std::vector<std::shared_ptr<arrow::Table>> tables, WriteOpts opts)
       : tables_(std::move(tables)), opts_(opts) {}
 
-  std::shared_ptr<parquet::WriterProperties> StandardWriterProperties();
+  /// The writer properties of table, which has been converted for Parquet
+  static std::shared_ptr<parquet::WriterProperties> WriterProperties(
+      const WriteOpts& opts, const arrow::Table& table);
 
   std::shared_ptr<parquet::ArrowWriterProperties> StandardArrowProperties();
 
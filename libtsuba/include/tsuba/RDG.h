@@ -3,7 +3,9 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/chunked_array.h>
@@ -15,6 +17,8 @@
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/FileView.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
 #include "tsuba/PartitionMetadata.h"
 #include "tsuba/RDGLineage.h"
 #include "tsuba/ReadGroup.h"
@@ -27,6 +31,15 @@ class RDGMeta;
 class RDGCore;
 struct PropStorageInfo;
 
+/// A predicate on a numeric or boolean property checked against the Parquet
+/// row group statistics of the property: min <= value <= max. Boolean values
+/// are 0 and 1, so a type (label) property X selects with {X, 1, 1}.
+struct KATANA_EXPORT PropertyPredicate {
+  std::string property;
+  double min;
+  double max;
+};
+
 struct KATANA_EXPORT RDGLoadOptions {
   /// Which partition of the RDG on storage should be loaded
   /// nullopt means the partition associated with the current host's ID will be
@@ -38,6 +51,42 @@ struct KATANA_EXPORT RDGLoadOptions {
   /// List of edge properties that should be loaded
   /// nullptr means all edge properties will be loaded
   const std::vector<std::string>* edge_properties{nullptr};
+  /// If set, node properties are only read for the row groups of
+  /// node_predicate.property that may satisfy the predicate; all other rows of
+  /// every loaded node property are null. Matching is conservative, so
+  /// callers must still check the predicate. An RDG loaded this way cannot be
+  /// stored.
+  std::optional<PropertyPredicate> node_predicate;
+  /// Like node_predicate, but for edge properties
+  std::optional<PropertyPredicate> edge_predicate;
+  /// Pool to allocate loaded properties from; nullptr means
+  /// arrow::default_memory_pool(). See also katana::NumaMemoryPool.
+  arrow::MemoryPool* memory_pool{nullptr};
+  /// If true, only the schemas of the node and edge properties are read at
+  /// load, and each property is read the first time it is used; see
+  /// RDG::EnsureNodePropertyLoaded. Cannot be combined with predicates.
+  bool lazy_properties{false};
+  /// If lazy_properties, also start reading every property in the
+  /// background at load, so that the first use of one waits at most for the
+  /// rest of its read
+  bool prefetch_lazy_properties{false};
+};
+
+/// An immutable version of the properties of an RDG.
+///
+/// Arrow tables are immutable, so changing the properties of an RDG builds
+/// new tables that share the columns that did not change. A snapshot holds
+/// on to the tables of one version, which lets readers keep using them
+/// without copies while a writer adds, replaces or removes properties.
+struct KATANA_EXPORT RDGSnapshot {
+  /// The version of the properties; later versions are larger
+  uint64_t version{0};
+  std::shared_ptr<arrow::Table> node_properties;
+  std::shared_ptr<arrow::Table> edge_properties;
+  /// For each property, the file in the RDG directory that holds it, or
+  /// empty if the property has not been stored since it last changed
+  std::vector<std::string> node_property_paths;
+  std::vector<std::string> edge_property_paths;
 };
 
 class KATANA_EXPORT RDG {
@@ -57,12 +106,17 @@ public:
   bool Equals(const RDG& other) const;
 
   /// Store this RDG at \param handle; if \param ff is not null, it is persisted
-  /// as the topology for this RDG. Add \param command_line to metadata to aid
-  /// in tracking lineage
+  /// as the topology for this RDG. If \param in_ff is not null, it is
+  /// persisted as the in-edge (transposed) topology sidecar for this RDG. Add
+  /// \param command_line to metadata to aid in tracking lineage
   katana::Result<void> Store(
       RDGHandle handle, const std::string& command_line,
-      std::unique_ptr<FileFrame> ff = nullptr);
+      std::unique_ptr<FileFrame> ff = nullptr,
+      std::unique_ptr<FileFrame> in_ff = nullptr);
 
+  /// Properties that are not loaded yet (see EnsureNodePropertyLoaded) may be
+  /// replaced or removed without loading them; Store, Equals and marking
+  /// some properties persistent first load them all
   katana::Result<void> AddNodeProperties(
       const std::shared_ptr<arrow::Table>& props);
 
@@ -75,6 +129,7 @@ public:
   katana::Result<void> UpsertEdgeProperties(
       const std::shared_ptr<arrow::Table>& props);
 
+  /// Remove property \param i of full_node_schema()
   katana::Result<void> RemoveNodeProperty(uint32_t i);
   katana::Result<void> RemoveEdgeProperty(uint32_t i);
 
@@ -85,14 +140,57 @@ public:
   katana::Result<void> MarkEdgePropertiesPersistent(
       const std::vector<std::string>& persist_edge_props);
 
+  /// Record how node property \param name was computed, e.g., by which
+  /// analytic from which inputs (see StoredVersion), and mark it persistent.
+  /// The record is stored with the property and forgotten when the property
+  /// is replaced or removed.
+  katana::Result<void> SetNodePropertyDerivation(
+      const std::string& name, const std::string& derivation);
+
+  /// The derivation of node property \param name recorded by
+  /// SetNodePropertyDerivation, or empty if there is none. The property need
+  /// not be loaded.
+  std::string GetNodePropertyDerivation(const std::string& name) const;
+
+  /// A name of the stored contents of the topology and of the node and edge
+  /// properties given, which differs once any of them changes, or empty if
+  /// any of them changed since it was last stored. Stores only write the
+  /// files of what changed, so the name stays the same across stores of
+  /// other changes.
+  std::string StoredVersion(
+      const std::vector<std::string>& node_props,
+      const std::vector<std::string>& edge_props) const;
+
   /// Explain to graph how it is derived from previous version
   void AddLineage(const std::string& command_line);
 
   /// Load the RDG described by the metadata in handle into memory.
   static katana::Result<RDG> Make(RDGHandle handle, const RDGLoadOptions& opts);
 
+  /// Unbind the topology from storage and forget its file, so the next Store
+  /// must be given the topology. Since the in-edge topology is derived from
+  /// the topology, it is unbound and forgotten as well.
   katana::Result<void> UnbindTopologyFileStorage();
 
+  /// Unbind the topology from storage but keep referencing its file, for when
+  /// the topology was copied into memory of its own
+  katana::Result<void> ReleaseTopologyFileStorage();
+
+  /// Unbind the in-edge topology from storage and forget about it
+  katana::Result<void> UnbindInTopologyFileStorage();
+
+  /// Inform this RDG that its topology was modified in memory, so the bound
+  /// topology must be written out again on the next Store. Any in-edge
+  /// topology is unbound since it no longer matches.
+  katana::Result<void> MarkTopologyModified();
+
+  /// Whether the topology of this RDG is already in storage where a Store to
+  /// \param handle can reference it instead of writing it again
+  bool HasStoredTopology(RDGHandle handle) const;
+
+  /// Like HasStoredTopology, but for the in-edge topology
+  bool HasStoredInTopology(RDGHandle handle) const;
+
   /// Inform this RDG that it's topology is in storage at this location
   /// without loading it into memory. \param new_top must exist and be in
   /// the correct directory for this RDG
@@ -100,10 +198,12 @@ public:
 
   void AddMirrorNodes(std::shared_ptr<arrow::ChunkedArray>&& a) {
     mirror_nodes_.emplace_back(std::move(a));
+    part_arrays_dirty_ = true;
   }
 
   void AddMasterNodes(std::shared_ptr<arrow::ChunkedArray>&& a) {
     master_nodes_.emplace_back(std::move(a));
+    part_arrays_dirty_ = true;
   }
 
   //
@@ -116,24 +216,85 @@ public:
   uint32_t partition_id() const { return partition_id_; }
   void set_partition_id(uint32_t partition_id) { partition_id_ = partition_id; }
 
-  /// The node properties
+  /// The pool of the properties read for this RDG, or null for
+  /// arrow::default_memory_pool()
+  arrow::MemoryPool* memory_pool() const { return memory_pool_; }
+
+  /// How Store writes property files, e.g., with which codecs
+  const ParquetWriter::WriteOpts& write_opts() const { return write_opts_; }
+  void set_write_opts(const ParquetWriter::WriteOpts& write_opts) {
+    write_opts_ = write_opts;
+  }
+
+  /// The node properties, after loading those not loaded yet (see
+  /// EnsurePropertiesLoaded); errors loading them are logged
   const std::shared_ptr<arrow::Table>& node_properties() const;
 
-  /// The edge properties
+  /// The edge properties, after loading those not loaded yet
   const std::shared_ptr<arrow::Table>& edge_properties() const;
 
+  /// The node properties loaded so far, in the order of full_node_schema()
+  const std::shared_ptr<arrow::Table>& loaded_node_properties() const;
+
+  /// The edge properties loaded so far, in the order of full_edge_schema()
+  const std::shared_ptr<arrow::Table>& loaded_edge_properties() const;
+
+  /// The schema of every node property, loaded or not; once they are all
+  /// loaded, the schema of node_properties()
+  std::shared_ptr<arrow::Schema> full_node_schema() const;
+
+  /// The schema of every edge property, loaded or not
+  std::shared_ptr<arrow::Schema> full_edge_schema() const;
+
+  /// Load node property \param name if it is not loaded yet, because this
+  /// RDG was loaded with RDGLoadOptions::lazy_properties or the property was
+  /// evicted, and publish a snapshot with it. Loading a property does not
+  /// change the value of the RDG, but like the methods that change
+  /// properties it must not be called concurrently with other uses of the
+  /// properties.
+  katana::Result<void> EnsureNodePropertyLoaded(const std::string& name) const;
+
+  /// Like EnsureNodePropertyLoaded, but for an edge property
+  katana::Result<void> EnsureEdgePropertyLoaded(const std::string& name) const;
+
+  /// Load every node and edge property not loaded yet
+  katana::Result<void> EnsurePropertiesLoaded() const;
+
+  /// Move the loaded node property \param name out of memory until it is
+  /// loaded again like a lazy property (see EnsureNodePropertyLoaded). A
+  /// property unchanged since it was loaded or stored is read again from its
+  /// file; any other is first written to a new file in \param spill_dir,
+  /// which is deleted once it is loaded again. Like loading, evicting does
+  /// not change the value of the RDG, and it publishes a snapshot without
+  /// the property.
+  katana::Result<void> EvictNodeProperty(
+      const std::string& name, const katana::Uri& spill_dir) const;
+
+  /// Like EvictNodeProperty, but for an edge property
+  katana::Result<void> EvictEdgeProperty(
+      const std::string& name, const katana::Uri& spill_dir) const;
+
   /// Remove all node properties
   void DropNodeProperties();
 
   /// Remove all edge properties
   void DropEdgeProperties();
 
+  /// The latest version of the properties. This may be called concurrently
+  /// with the methods that change properties, and the snapshot stays valid
+  /// after the RDG changes. Properties not loaded yet are not in it.
+  std::shared_ptr<const RDGSnapshot> Snapshot() const;
+
+  /// The version of the latest snapshot
+  uint64_t property_version() const { return Snapshot()->version; }
+
   const std::vector<std::shared_ptr<arrow::ChunkedArray>>& master_nodes()
       const {
     return master_nodes_;
   }
   void set_master_nodes(std::vector<std::shared_ptr<arrow::ChunkedArray>>&& a) {
     master_nodes_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::vector<std::shared_ptr<arrow::ChunkedArray>>& mirror_nodes()
@@ -142,6 +303,7 @@ public:
   }
   void set_mirror_nodes(std::vector<std::shared_ptr<arrow::ChunkedArray>>&& a) {
     mirror_nodes_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& host_to_owned_global_node_ids()
@@ -151,6 +313,7 @@ public:
   void set_host_to_owned_global_node_ids(
       std::shared_ptr<arrow::ChunkedArray>&& a) {
     host_to_owned_global_node_ids_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& host_to_owned_global_edge_ids()
@@ -160,6 +323,7 @@ public:
   void set_host_to_owned_global_edge_ids(
       std::shared_ptr<arrow::ChunkedArray>&& a) {
     host_to_owned_global_edge_ids_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& local_to_user_id() const {
@@ -167,6 +331,7 @@ public:
   }
   void set_local_to_user_id(std::shared_ptr<arrow::ChunkedArray>&& a) {
     local_to_user_id_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& local_to_global_id() const {
@@ -174,6 +339,7 @@ public:
   }
   void set_local_to_global_id(std::shared_ptr<arrow::ChunkedArray>&& a) {
     local_to_global_id_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const PartitionMetadata& part_metadata() const;
@@ -181,12 +347,43 @@ public:
 
   const FileView& topology_file_storage() const;
 
+  /// The in-edge topology sidecar; not Valid() if this RDG does not have one
+  const FileView& in_topology_file_storage() const;
+
+  /// Whether the out-edges of every node in the topology are sorted by
+  /// destination. This is recorded in the part header so that it survives a
+  /// store and load. Replacing the topology clears it.
+  bool topology_sorted_by_dest() const;
+  void set_topology_sorted_by_dest(bool sorted);
+
 private:
   RDG(std::unique_ptr<RDGCore>&& core);
 
   void InitEmptyTables();
 
-  katana::Result<void> DoMake(const katana::Uri& metadata_dir);
+  /// Make the current properties the latest snapshot with a new version
+  void PublishSnapshot() const;
+
+  /// Load the lazy node or edge property \param name, or all of them if it
+  /// is null
+  katana::Result<void> LoadLazyProperties(
+      bool nodes, const std::string* name) const;
+
+  katana::Result<void> EvictProperty(
+      bool nodes, const std::string& name, const katana::Uri& spill_dir) const;
+
+  katana::Result<void> RemoveProperty(bool nodes, uint32_t i);
+
+  /// The record of the node or edge property \param name, loaded or not,
+  /// or nullptr if there is none
+  PropStorageInfo* FindPropStorageInfo(
+      bool nodes, const std::string& name) const;
+
+  katana::Result<void> DoMake(
+      const katana::Uri& metadata_dir,
+      const std::vector<ParquetReader::Slice>* node_row_ranges,
+      const std::vector<ParquetReader::Slice>* edge_row_ranges,
+      arrow::MemoryPool* pool, bool lazy_properties, bool prefetch);
 
   static katana::Result<RDG> Make(
       const RDGMeta& meta, const RDGLoadOptions& opts);
@@ -197,6 +394,9 @@ private:
   katana::Result<std::vector<tsuba::PropStorageInfo>> WritePartArrays(
       const katana::Uri& dir, tsuba::WriteGroup* desc);
 
+  /// Start the writes of the files of this host for a store
+  katana::Result<void> StartStores(RDGHandle handle, WriteGroup* write_group);
+
   katana::Result<void> DoStore(
       RDGHandle handle, const std::string& command_line,
       std::unique_ptr<WriteGroup> desc);
@@ -216,12 +416,23 @@ private:
   std::shared_ptr<arrow::ChunkedArray> local_to_user_id_;
   std::shared_ptr<arrow::ChunkedArray> local_to_global_id_;
 
-  /// name of the graph that was used to load this RDG
+  /// name of the graph that was used to load this RDG or that it was last
+  /// stored to
   katana::Uri rdg_dir_;
   /// which partition of the graph was loaded
   uint32_t partition_id_{std::numeric_limits<uint32_t>::max()};
+  ParquetWriter::WriteOpts write_opts_{ParquetWriter::WriteOpts::Defaults()};
   // How this graph was derived from the previous version
   RDGLineage lineage_;
+  /// true if some property rows were skipped by a load predicate
+  bool loaded_with_predicate_{false};
+  /// The pool properties were loaded from, to load evicted ones again
+  arrow::MemoryPool* memory_pool_{nullptr};
+  /// true if the partition arrays changed since they were loaded or stored
+  bool part_arrays_dirty_{false};
+  /// The latest snapshot; only accessed with the std::atomic_* functions.
+  /// Loading a lazy property publishes a snapshot, hence mutable.
+  mutable std::shared_ptr<const RDGSnapshot> snapshot_;
 };
 
 }  // namespace tsuba
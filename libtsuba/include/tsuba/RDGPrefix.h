@@ -18,6 +18,10 @@ class KATANA_EXPORT RDGPrefix {
 public:
   static katana::Result<RDGPrefix> Make(RDGHandle handle);
 
+  /// False if the RDG has no stored topology, in which case there is no
+  /// header to read
+  bool has_topology() const { return prefix_ != nullptr; }
+
   uint64_t num_nodes() const { return prefix_->header.num_nodes; }
   uint64_t num_edges() const { return prefix_->header.num_edges; }
   uint64_t version() const { return prefix_->header.version; }
@@ -37,6 +41,45 @@ public:
     return std::vector<uint64_t>(out_indexes + first, out_indexes + second);
   }
 
+  /// The destinations of the edges of a version 1 topology. Only those made
+  /// resident by FillDests may be read.
+  const uint32_t* out_dests() const {
+    return prefix_storage_.ptr<uint32_t>(view_offset_);
+  }
+
+  /// Read the destinations of edges [\param first, \param last) of a
+  /// version 1 topology, waiting for them if \param resolve
+  katana::Result<void> FillDests(uint64_t first, uint64_t last, bool resolve) {
+    return prefix_storage_.Fill(
+        view_offset_ + first * sizeof(uint32_t),
+        view_offset_ + last * sizeof(uint32_t), resolve);
+  }
+
+  /// Release the memory of the destinations of edges [\param first, \param
+  /// last); see FileView::Evict
+  katana::Result<void> EvictDests(uint64_t first, uint64_t last) {
+    return prefix_storage_.Evict(
+        view_offset_ + first * sizeof(uint32_t),
+        view_offset_ + last * sizeof(uint32_t));
+  }
+
+  /// The size of the topology file in bytes
+  uint64_t file_size() const { return prefix_storage_.size(); }
+
+  /// The bytes of the topology file after the out indexes, e.g., the
+  /// destination offsets and blocks of a compressed topology. Only those made
+  /// resident by FillData may be read.
+  const uint8_t* data() const {
+    return prefix_storage_.ptr<uint8_t>(view_offset_);
+  }
+
+  /// Read bytes [\param first, \param last) of data(), waiting for them if
+  /// \param resolve
+  katana::Result<void> FillData(uint64_t first, uint64_t last, bool resolve) {
+    return prefix_storage_.Fill(
+        view_offset_ + first, view_offset_ + last, resolve);
+  }
+
 private:
   RDGPrefix(FileView&& prefix_storage, uint64_t view_offset)
       : prefix_storage_(std::move(prefix_storage)),
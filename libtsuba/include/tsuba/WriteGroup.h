@@ -4,6 +4,8 @@
 #include <future>
 #include <list>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "katana/Result.h"
 #include "tsuba/AsyncOpGroup.h"
@@ -14,22 +16,18 @@ namespace tsuba {
 
 /// Track multiple, outstanding async writes and provide a mechanism to ensure
 /// that they have all completed
+///
+/// Stores run on the I/O scheduler of tsuba, which bounds the stores and the
+/// bytes in flight and runs the stores of topologies before those of
+/// properties.
 class WriteGroup {
-  struct AsyncOp {
-    std::future<katana::Result<void>> result;
-    std::string location;
-    uint64_t accounted_size;
-  };
-
   std::string tag_;
-  std::atomic<uint64_t> outstanding_size_{0};
   AsyncOpGroup async_op_group_;
+  std::vector<std::string> files_;
 
   WriteGroup(std::string tag) : tag_(std::move(tag)){};
 
 public:
-  static constexpr uint64_t kMaxOutstandingSize = 10ULL << 30;  // 10 GB
-
   /// Build a descriptor with a tag. If running with multiple hosts, Make should
   /// be Called BSP style and all hosts will have the same tag
   static katana::Result<std::unique_ptr<WriteGroup>> Make();
@@ -40,22 +38,19 @@ public:
   /// Wait until all operations this descriptor knows about have completed
   katana::Result<void> Finish();
 
+  /// The files of the operations started, e.g., to delete them when the
+  /// store they are part of fails
+  const std::vector<std::string>& files() const { return files_; }
+
   /// Start async store op, we hold onto the data until op finishes
   void StartStore(std::shared_ptr<FileFrame> ff);
 
   /// Start async store op, caller responsible for keeping buffer live
-  void StartStore(const std::string& file, const uint8_t* buf, uint64_t size) {
-    AddOp(FileStoreAsync(file, buf, size), file);
-  }
-
-  void AddToOutstanding(uint64_t size) { outstanding_size_ += size; }
+  void StartStore(const std::string& file, const uint8_t* buf, uint64_t size);
 
   /// Add future to the list of futures this descriptor will wait for, note
-  /// the file name for debugging. If the operation is associated with a file
-  /// frame that we are responsible for, note the size
-  void AddOp(
-      std::future<katana::Result<void>> future, std::string file,
-      uint64_t accounted_size = 0);
+  /// the file name for debugging
+  void AddOp(std::future<katana::Result<void>> future, std::string file);
 };
 
 }  // namespace tsuba
@@ -30,6 +30,9 @@ RoundUpToBlock(T val) {
 
 struct StatBuf {
   uint64_t size{UINT64_C(0)};
+  /// Changes whenever the file does, e.g., an ETag or a modification time;
+  /// empty if the storage does not report one
+  std::string version;
 };
 
 // Returns an error file uri does not exist
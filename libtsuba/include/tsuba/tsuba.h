@@ -93,6 +93,10 @@ KATANA_EXPORT katana::Result<void> Init();
 
 KATANA_EXPORT katana::Result<void> Fini();
 
+/// The communication backend tsuba was initialized with, e.g., for
+/// distributed analytics to talk to the other hosts of the job
+KATANA_EXPORT katana::CommBackend* Comm();
+
 }  // namespace tsuba
 
 #endif
@@ -1,30 +1,71 @@
 #include "AddProperties.h"
 
+#include <algorithm>
 #include <memory>
 #include <optional>
+#include <thread>
 
 #include <arrow/chunked_array.h>
 
 #include "katana/Result.h"
+#include "tsuba/ArrowIPCReader.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
+#include "tsuba/IOScheduler.h"
 #include "tsuba/ParquetReader.h"
 
 namespace {
 
 katana::Result<std::shared_ptr<arrow::Table>>
-DoLoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path,
-    std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
+ReadParquet(
+    const katana::Uri& file_path,
+    std::optional<tsuba::ParquetReader::Slice> slice,
+    const std::vector<tsuba::ParquetReader::Slice>* row_ranges,
+    uint32_t num_threads, arrow::MemoryPool* pool) {
   auto read_opts = tsuba::ParquetReader::ReadOpts::Defaults();
   read_opts.slice = slice;
+  read_opts.num_threads = num_threads;
+  read_opts.memory_pool = pool;
+  if (row_ranges != nullptr) {
+    read_opts.row_ranges = *row_ranges;
+  }
   auto reader_res = tsuba::ParquetReader::Make(read_opts);
   if (!reader_res) {
-    return reader_res.error().WithContext("loading property");
+    return reader_res.error();
+  }
+  return reader_res.value()->ReadTable(file_path);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadArrowIPC(
+    const katana::Uri& file_path,
+    std::optional<tsuba::ParquetReader::Slice> slice,
+    const std::vector<tsuba::ParquetReader::Slice>* row_ranges,
+    arrow::MemoryPool* pool) {
+  auto read_opts = tsuba::ArrowIPCReader::ReadOpts::Defaults();
+  read_opts.slice = slice;
+  read_opts.memory_pool = pool;
+  if (row_ranges != nullptr) {
+    read_opts.row_ranges = *row_ranges;
+  }
+  auto reader_res = tsuba::ArrowIPCReader::Make(read_opts);
+  if (!reader_res) {
+    return reader_res.error();
   }
-  std::unique_ptr<tsuba::ParquetReader> reader = std::move(reader_res.value());
+  return reader_res.value()->ReadTable(file_path);
+}
 
-  auto out_res = reader->ReadTable(file_path);
+katana::Result<std::shared_ptr<arrow::Table>>
+DoLoadProperties(
+    const std::string& expected_name, const katana::Uri& file_path,
+    tsuba::PropFormat format,
+    std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt,
+    const std::vector<tsuba::ParquetReader::Slice>* row_ranges = nullptr,
+    uint32_t num_threads = 0, arrow::MemoryPool* pool = nullptr) {
+  auto out_res =
+      format == tsuba::PropFormat::ArrowIPC
+          ? ReadArrowIPC(file_path, slice, row_ranges, pool)
+          : ReadParquet(file_path, slice, row_ranges, num_threads, pool);
   if (!out_res) {
     return out_res.error().WithContext("loading property");
   }
@@ -50,9 +91,13 @@ DoLoadProperties(
 
 katana::Result<std::shared_ptr<arrow::Table>>
 tsuba::LoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path) {
+    const std::string& expected_name, const katana::Uri& file_path,
+    const std::vector<ParquetReader::Slice>* row_ranges, uint32_t num_threads,
+    arrow::MemoryPool* pool, PropFormat format) {
   try {
-    return DoLoadProperties(expected_name, file_path);
+    return DoLoadProperties(
+        expected_name, file_path, format, std::nullopt, row_ranges,
+        num_threads, pool);
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
         tsuba::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
@@ -62,10 +107,10 @@ tsuba::LoadProperties(
 katana::Result<std::shared_ptr<arrow::Table>>
 tsuba::LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length) {
+    int64_t offset, int64_t length, PropFormat format) {
   try {
     return DoLoadProperties(
-        expected_name, file_path,
+        expected_name, file_path, format,
         tsuba::ParquetReader::Slice{.offset = offset, .length = length});
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
@@ -78,15 +123,28 @@ tsuba::AddProperties(
     const katana::Uri& uri,
     const std::vector<tsuba::PropStorageInfo>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn) {
+        add_fn,
+    const std::vector<ParquetReader::Slice>* row_ranges,
+    arrow::MemoryPool* pool) {
+  // Properties are read concurrently, up to the ops the I/O scheduler runs
+  // at once, so split the hardware threads among them for decoding row groups
+  size_t concurrent = std::min<size_t>(
+      properties.size(), IOScheduler::kDefaultMaxOps);
+  uint32_t num_threads = std::max<uint32_t>(
+      1, std::thread::hardware_concurrency() /
+             std::max<size_t>(1, concurrent));
   for (const tsuba::PropStorageInfo& prop : properties) {
     const std::string& name = prop.name;
     const katana::Uri& path = uri.Join(prop.path);
+    PropFormat format = prop.format;
+    // row_ranges must outlive grp
     std::future<katana::Result<std::shared_ptr<arrow::Table>>> future =
-        std::async(
-            std::launch::async,
-            [name, path]() -> katana::Result<std::shared_ptr<arrow::Table>> {
-              auto load_result = LoadProperties(name, path);
+        IOScheduler::Get()->Schedule<std::shared_ptr<arrow::Table>>(
+            path.string(), IOPriority::Properties, 0,
+            [name, path, row_ranges, num_threads, pool,
+             format]() -> katana::Result<std::shared_ptr<arrow::Table>> {
+              auto load_result = LoadProperties(
+                  name, path, row_ranges, num_threads, pool, format);
               if (!load_result) {
                 return load_result.error().WithContext(
                     "error loading {}", path);
@@ -132,12 +190,14 @@ tsuba::AddPropertySlice(
   for (const tsuba::PropStorageInfo& prop : properties) {
     const std::string& name = prop.name;
     const katana::Uri& path = dir.Join(prop.path);
+    PropFormat format = prop.format;
     std::future<katana::Result<std::shared_ptr<arrow::Table>>> future =
-        std::async(
-            std::launch::async,
-            [name, path, begin,
-             size]() -> katana::Result<std::shared_ptr<arrow::Table>> {
-              auto load_result = LoadPropertySlice(name, path, begin, size);
+        IOScheduler::Get()->Schedule<std::shared_ptr<arrow::Table>>(
+            path.string(), IOPriority::Properties, 0,
+            [name, path, begin, size,
+             format]() -> katana::Result<std::shared_ptr<arrow::Table>> {
+              auto load_result =
+                  LoadPropertySlice(name, path, begin, size, format);
               if (!load_result) {
                 return load_result.error().WithContext(
                     "error loading {}", path);
@@ -170,3 +230,75 @@ tsuba::AddPropertySlice(
 
   return katana::ResultSuccess();
 }
+
+katana::Result<std::vector<std::shared_ptr<arrow::Field>>>
+tsuba::LoadPropertyFields(
+    const katana::Uri& uri,
+    const std::vector<tsuba::PropStorageInfo>& properties) {
+  // Footers are small, so the reads count no bytes against the scheduler
+  std::vector<std::future<katana::Result<std::shared_ptr<arrow::Schema>>>>
+      futures;
+  for (const tsuba::PropStorageInfo& prop : properties) {
+    katana::Uri path = uri.Join(prop.path);
+    PropFormat format = prop.format;
+    futures.emplace_back(
+        IOScheduler::Get()->Schedule<std::shared_ptr<arrow::Schema>>(
+            path.string(), IOPriority::Properties, 0,
+            [path, format]() -> katana::Result<std::shared_ptr<arrow::Schema>> {
+              if (format == PropFormat::ArrowIPC) {
+                auto reader_res = ArrowIPCReader::Make();
+                if (!reader_res) {
+                  return reader_res.error();
+                }
+                return reader_res.value()->ReadSchema(path);
+              }
+              auto reader_res = ParquetReader::Make();
+              if (!reader_res) {
+                return reader_res.error();
+              }
+              return reader_res.value()->ReadSchema(path);
+            }));
+  }
+
+  // The reads hold nothing of ours, so those left behind by an error may
+  // finish on their own
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (size_t i = 0; i < futures.size(); ++i) {
+    auto schema_res = futures[i].get();
+    if (!schema_res) {
+      return schema_res.error().WithContext(
+          "reading schema of {}", properties[i].name);
+    }
+    const std::shared_ptr<arrow::Schema>& schema = schema_res.value();
+    if (schema->num_fields() != 1 ||
+        schema->field(0)->name() != properties[i].name) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument, "expected field {} found {}",
+          properties[i].name, schema->ToString());
+    }
+    fields.emplace_back(schema->field(0));
+  }
+  return fields;
+}
+
+std::vector<std::future<katana::Result<std::shared_ptr<arrow::Table>>>>
+tsuba::StartLoadProperties(
+    const katana::Uri& uri,
+    const std::vector<tsuba::PropStorageInfo>& properties,
+    arrow::MemoryPool* pool) {
+  std::vector<std::future<katana::Result<std::shared_ptr<arrow::Table>>>>
+      futures;
+  for (const tsuba::PropStorageInfo& prop : properties) {
+    const std::string& name = prop.name;
+    katana::Uri path = uri.Join(prop.path);
+    PropFormat format = prop.format;
+    futures.emplace_back(
+        IOScheduler::Get()->Schedule<std::shared_ptr<arrow::Table>>(
+            path.string(), IOPriority::Properties, 0,
+            [name, path, pool,
+             format]() -> katana::Result<std::shared_ptr<arrow::Table>> {
+              return LoadProperties(name, path, nullptr, 1, pool, format);
+            }));
+  }
+  return futures;
+}
@@ -1,27 +1,60 @@
 #ifndef KATANA_LIBTSUBA_ADDPROPERTIES_H_
 #define KATANA_LIBTSUBA_ADDPROPERTIES_H_
 
+#include <future>
+#include <vector>
+
 #include <arrow/api.h>
 
 #include "RDGPartHeader.h"
 #include "katana/Result.h"
 #include "katana/Uri.h"
+#include "tsuba/ParquetReader.h"
 #include "tsuba/ReadGroup.h"
 
 namespace tsuba {
 
+/// Load a property. If \param row_ranges is not null, only rows in those
+/// ranges are read and all other rows are null (see
+/// ParquetReader::ReadOpts::row_ranges). \param num_threads bounds the
+/// threads decoding row groups (see ParquetReader::ReadOpts::num_threads).
+/// The property is allocated from \param pool (see
+/// ParquetReader::ReadOpts::memory_pool). A property stored as \param
+/// format ArrowIPC is mapped instead (see ArrowIPCReader), and num_threads
+/// does not apply to it.
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path);
+    const std::string& expected_name, const katana::Uri& file_path,
+    const std::vector<ParquetReader::Slice>* row_ranges = nullptr,
+    uint32_t num_threads = 0, arrow::MemoryPool* pool = nullptr,
+    PropFormat format = PropFormat::Parquet);
 
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length);
+    int64_t offset, int64_t length, PropFormat format = PropFormat::Parquet);
 
 KATANA_EXPORT katana::Result<void> AddProperties(
     const katana::Uri& uri,
     const std::vector<tsuba::PropStorageInfo>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn);
+        add_fn,
+    const std::vector<ParquetReader::Slice>* row_ranges = nullptr,
+    arrow::MemoryPool* pool = nullptr);
+
+/// The field of each of \param properties stored in \param uri, read
+/// without reading their values
+KATANA_EXPORT katana::Result<std::vector<std::shared_ptr<arrow::Field>>>
+LoadPropertyFields(
+    const katana::Uri& uri,
+    const std::vector<tsuba::PropStorageInfo>& properties);
+
+/// Start loading each of \param properties stored in \param uri in the
+/// background, in order
+KATANA_EXPORT
+std::vector<std::future<katana::Result<std::shared_ptr<arrow::Table>>>>
+StartLoadProperties(
+    const katana::Uri& uri,
+    const std::vector<tsuba::PropStorageInfo>& properties,
+    arrow::MemoryPool* pool = nullptr);
 
 KATANA_EXPORT katana::Result<void> AddPropertySlice(
     const katana::Uri& dir,
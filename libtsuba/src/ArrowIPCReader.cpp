@@ -0,0 +1,174 @@
+#include "tsuba/ArrowIPCReader.h"
+
+#include <algorithm>
+
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileView.h"
+
+template <typename T>
+using Result = katana::Result<T>;
+
+namespace {
+
+/// The mapping of a whole file as a buffer. The buffers of the arrays read
+/// from it are slices of it, which keep the file mapped while they live.
+class FileViewBuffer : public arrow::Buffer {
+public:
+  explicit FileViewBuffer(std::shared_ptr<tsuba::FileView> view)
+      : arrow::Buffer(view->ptr<uint8_t>(), view->size()),
+        view_(std::move(view)) {}
+
+private:
+  std::shared_ptr<tsuba::FileView> view_;
+};
+
+}  // namespace
+
+Result<std::unique_ptr<tsuba::ArrowIPCReader>>
+tsuba::ArrowIPCReader::Make(ReadOpts opts) {
+  if (opts.slice && opts.row_ranges) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "slice and row_ranges cannot be used together");
+  }
+  arrow::MemoryPool* pool =
+      opts.memory_pool ? opts.memory_pool : arrow::default_memory_pool();
+  return std::unique_ptr<ArrowIPCReader>(
+      new ArrowIPCReader(opts.slice, std::move(opts.row_ranges), pool));
+}
+
+Result<std::shared_ptr<arrow::Table>>
+tsuba::ArrowIPCReader::ReadTable(const katana::Uri& uri) {
+  auto view = std::make_shared<FileView>();
+  if (auto res = view->Bind(uri.string(), true); !res) {
+    return res.error();
+  }
+  auto input = std::make_shared<arrow::io::BufferReader>(
+      std::make_shared<FileViewBuffer>(std::move(view)));
+
+  auto reader_res = arrow::ipc::RecordBatchFileReader::Open(input);
+  if (!reader_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "opening IPC file: {}", reader_res.status());
+  }
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader =
+      std::move(reader_res.ValueOrDie());
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0, n = reader->num_record_batches(); i < n; ++i) {
+    auto batch_res = reader->ReadRecordBatch(i);
+    if (!batch_res.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "reading record batch: {}",
+          batch_res.status());
+    }
+    batches.emplace_back(std::move(batch_res.ValueOrDie()));
+  }
+  auto table_res = arrow::Table::FromRecordBatches(reader->schema(), batches);
+  if (!table_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "arrow error: {}", table_res.status());
+  }
+  std::shared_ptr<arrow::Table> table = std::move(table_res.ValueOrDie());
+
+  if (row_ranges_) {
+    auto ranges_res = KeepRanges(table);
+    if (!ranges_res) {
+      return ranges_res.error();
+    }
+    table = std::move(ranges_res.value());
+  } else if (slice_) {
+    if (slice_->offset < 0 || slice_->length < 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "slice offset and length must be non-negative");
+    }
+    table = table->Slice(slice_->offset, slice_->length);
+  }
+
+  // Tables are not chunked, as those read by ParquetReader. Files written by
+  // ArrowIPCWriter have one record batch, so this only copies tables that
+  // are not theirs or that were read with row_ranges.
+  auto combine_res = table->CombineChunks(pool_);
+  if (!combine_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "arrow error: {}", combine_res.status());
+  }
+  return combine_res.ValueOrDie();
+}
+
+// Internal use only, invoke iff row_ranges_ has a value
+Result<std::shared_ptr<arrow::Table>>
+tsuba::ArrowIPCReader::KeepRanges(const std::shared_ptr<arrow::Table>& table) {
+  std::shared_ptr<arrow::Schema> schema = table->schema();
+  int64_t num_rows = table->num_rows();
+
+  std::vector<arrow::ArrayVector> chunks(schema->num_fields());
+  auto append_nulls = [&](int64_t length) -> Result<void> {
+    for (int c = 0, n = schema->num_fields(); c < n; ++c) {
+      auto nulls_res =
+          arrow::MakeArrayOfNull(schema->field(c)->type(), length, pool_);
+      if (!nulls_res.ok()) {
+        return KATANA_ERROR(
+            ErrorCode::ArrowError, "making nulls: {}", nulls_res.status());
+      }
+      chunks[c].emplace_back(std::move(nulls_res.ValueOrDie()));
+    }
+    return katana::ResultSuccess();
+  };
+
+  int64_t cursor = 0;
+  for (const Slice& range : row_ranges_.value()) {
+    int64_t begin = std::min(range.offset, num_rows);
+    int64_t end = std::min(range.offset + range.length, num_rows);
+    if (range.offset < cursor || range.length < 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "row ranges must be sorted, disjoint and non-negative");
+    }
+    if (begin == end) {
+      continue;
+    }
+    if (begin > cursor) {
+      if (auto res = append_nulls(begin - cursor); !res) {
+        return res.error();
+      }
+    }
+    std::shared_ptr<arrow::Table> rows = table->Slice(begin, end - begin);
+    for (int c = 0, n = schema->num_fields(); c < n; ++c) {
+      const arrow::ArrayVector& col_chunks = rows->column(c)->chunks();
+      chunks[c].insert(chunks[c].end(), col_chunks.begin(), col_chunks.end());
+    }
+    cursor = end;
+  }
+  if (cursor < num_rows) {
+    if (auto res = append_nulls(num_rows - cursor); !res) {
+      return res.error();
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int c = 0, n = schema->num_fields(); c < n; ++c) {
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        std::move(chunks[c]), schema->field(c)->type()));
+  }
+  return arrow::Table::Make(schema, columns, num_rows);
+}
+
+Result<std::shared_ptr<arrow::Schema>>
+tsuba::ArrowIPCReader::ReadSchema(const katana::Uri& uri) {
+  // Reading through the view only fetches the parts of the file read
+  auto view = std::make_shared<FileView>();
+  if (auto res = view->Bind(uri.string(), false); !res) {
+    return res.error();
+  }
+  auto reader_res = arrow::ipc::RecordBatchFileReader::Open(view);
+  if (!reader_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "opening IPC file: {}", reader_res.status());
+  }
+  return reader_res.ValueOrDie()->schema();
+}
@@ -0,0 +1,96 @@
+#include "tsuba/ArrowIPCWriter.h"
+
+#include <arrow/ipc/writer.h>
+
+#include "UploadStream.h"
+#include "katana/ArrowInterchange.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FaultTest.h"
+#include "tsuba/IOScheduler.h"
+
+namespace {
+
+katana::Result<void>
+StoreTable(const arrow::Table& table, const std::string& uri, uint64_t bytes) {
+  auto sink_res = tsuba::MakeStoreStream(uri, bytes);
+  if (!sink_res) {
+    return sink_res.error();
+  }
+  std::shared_ptr<arrow::io::OutputStream> sink = std::move(sink_res.value());
+
+  // The default options do not compress, so that the buffers of the file
+  // can be used where they are mapped
+  auto writer_res = arrow::ipc::MakeFileWriter(sink, table.schema());
+  if (!writer_res.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "making IPC writer: {}",
+        writer_res.status());
+  }
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer =
+      std::move(writer_res.ValueOrDie());
+  if (auto status = writer->WriteTable(table); !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "writing table: {}", status);
+  }
+  if (auto status = writer->Close(); !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "closing IPC writer: {}", status);
+  }
+
+  TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
+  return tsuba::FinishStoreStream(sink.get());
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<tsuba::ArrowIPCWriter>>
+tsuba::ArrowIPCWriter::Make(
+    const std::shared_ptr<arrow::ChunkedArray>& array,
+    const std::string& name) {
+  return Make(arrow::Table::Make(
+      arrow::schema({arrow::field(name, array->type())}), {array}));
+}
+
+katana::Result<std::unique_ptr<tsuba::ArrowIPCWriter>>
+tsuba::ArrowIPCWriter::Make(std::shared_ptr<arrow::Table> table) {
+  // A table stored as one record batch reads as one chunk per column,
+  // which readers need not combine. Columns of int32 offsets too large to
+  // combine stay chunked.
+  for (const auto& column : table->columns()) {
+    if (column->num_chunks() <= 1) {
+      continue;
+    }
+    auto combine_res = table->CombineChunks();
+    if (combine_res.ok()) {
+      table = std::move(combine_res.ValueOrDie());
+    }
+    break;
+  }
+  return std::unique_ptr<ArrowIPCWriter>(new ArrowIPCWriter(std::move(table)));
+}
+
+katana::Result<void>
+tsuba::ArrowIPCWriter::WriteToUri(const katana::Uri& uri, WriteGroup* group) {
+  // The file is about as large as the table, since it is not encoded
+  uint64_t bytes = katana::ApproxTableMemUse(table_);
+  uint64_t held = bytes >= kStreamingThreshold ? kStreamingBytes : bytes;
+  auto future = IOScheduler::Get()->Schedule<void>(
+      uri.string(), IOPriority::Properties, held,
+      [table = table_, path = uri.string(),
+       bytes]() -> katana::Result<void> {
+        try {
+          return StoreTable(*table, path, bytes);
+        } catch (const std::exception& exp) {
+          return KATANA_ERROR(
+              tsuba::ErrorCode::ArrowError, "arrow exception: {}",
+              exp.what());
+        }
+      });
+
+  if (!group) {
+    return future.get();
+  }
+
+  group->AddOp(std::move(future), uri.string());
+  return katana::ResultSuccess();
+}
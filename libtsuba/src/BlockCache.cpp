@@ -0,0 +1,317 @@
+#include "BlockCache.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "tsuba/Errors.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// Closes a file descriptor when it goes out of scope
+struct FdCloser {
+  int fd;
+  ~FdCloser() {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+};
+
+/// Local files are read from the local file system anyway
+bool
+IsRemote(const std::string& uri) {
+  return uri.find("://") != std::string::npos && uri.find("file://") != 0;
+}
+
+/// \returns true if the file open as \param fd is \param size bytes of
+/// data followed by \param key
+bool
+HoldsKey(int fd, uint64_t size, const std::string& key) {
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) != 0 ||
+      static_cast<uint64_t>(stat_buf.st_size) != size + key.size()) {
+    return false;
+  }
+  std::string stored(key.size(), '\0');
+  for (uint64_t done = 0; done < stored.size();) {
+    ssize_t ret =
+        pread(fd, stored.data() + done, stored.size() - done, size + done);
+    if (ret <= 0) {
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    done += ret;
+  }
+  return stored == key;
+}
+
+}  // namespace
+
+tsuba::BlockCache*
+tsuba::BlockCache::Get() {
+  static std::unique_ptr<BlockCache> cache = []() {
+    std::string dir;
+    if (!katana::GetEnv("KATANA_BLOCK_CACHE_DIR", &dir) || dir.empty()) {
+      return std::unique_ptr<BlockCache>();
+    }
+    int size_gb = kDefaultSizeGB;
+    katana::GetEnv("KATANA_BLOCK_CACHE_GB", &size_gb);
+    return std::make_unique<BlockCache>(
+        dir, static_cast<uint64_t>(std::max(size_gb, 0)) << 30);
+  }();
+  return cache.get();
+}
+
+void
+tsuba::BlockCache::NoteVersion(const std::string& uri, const StatBuf& stat) {
+  if (!IsRemote(uri)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  versions_[uri] = stat;
+}
+
+std::optional<tsuba::StatBuf>
+tsuba::BlockCache::Version(const std::string& uri) {
+  if (!IsRemote(uri)) {
+    return std::nullopt;
+  }
+  StatBuf stat;
+  bool known = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = versions_.find(uri); it != versions_.end()) {
+      stat = it->second;
+      known = true;
+    }
+  }
+  // FileStat notes the version it finds
+  if (!known && !FileStat(uri, &stat)) {
+    return std::nullopt;
+  }
+  if (stat.version.empty()) {
+    return std::nullopt;
+  }
+  return stat;
+}
+
+std::string
+tsuba::BlockCache::BlockPath(
+    const std::string& uri, const StatBuf& stat, uint64_t block) const {
+  return fmt::format(
+      "{}/{:016x}-{}-{:016x}-{}", dir_, std::hash<std::string>{}(uri),
+      stat.size, std::hash<std::string>{}(stat.version), block);
+}
+
+std::string
+tsuba::BlockCache::BlockKey(
+    const std::string& uri, const StatBuf& stat, uint64_t block) {
+  return fmt::format("\n{}\n{}\n{}\n{}", uri, stat.size, stat.version, block);
+}
+
+bool
+tsuba::BlockCache::Read(
+    const std::string& uri, const StatBuf& stat, uint64_t begin,
+    uint64_t size, uint8_t* buf) {
+  if (size == 0 || begin + size > stat.size) {
+    return false;
+  }
+  for (uint64_t block = begin / kBlockSize;
+       block * kBlockSize < begin + size; ++block) {
+    uint64_t block_start = block * kBlockSize;
+    uint64_t block_size = std::min(kBlockSize, stat.size - block_start);
+    uint64_t start = std::max(begin, block_start);
+    uint64_t end = std::min(begin + size, block_start + block_size);
+
+    std::string path = BlockPath(uri, stat, block);
+    FdCloser file{open(path.c_str(), O_RDONLY)};
+    if (file.fd < 0) {
+      return false;
+    }
+    // Blocks of other files or versions may have the same name
+    if (!HoldsKey(file.fd, block_size, BlockKey(uri, stat, block))) {
+      return false;
+    }
+    for (uint64_t done = 0; done < end - start;) {
+      ssize_t ret = pread(
+          file.fd, buf + start - begin + done, end - start - done,
+          start - block_start + done);
+      if (ret <= 0) {
+        if (ret < 0 && errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      done += ret;
+    }
+    // The modification time of a block is its last use
+    futimens(file.fd, nullptr);
+  }
+  return true;
+}
+
+katana::Result<void>
+tsuba::BlockCache::Publish(
+    const std::string& path, const uint8_t* data, uint64_t size,
+    const std::string& key) {
+  std::string tmp_path = fmt::format("{}.tmp-{}", path, getpid());
+  FdCloser file{open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+  if (file.fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "creating {}", tmp_path);
+  }
+  auto write_all = [&](const void* buf,
+                       uint64_t count) -> katana::Result<void> {
+    const auto* bytes = static_cast<const uint8_t*>(buf);
+    for (uint64_t done = 0; done < count;) {
+      ssize_t ret = write(file.fd, bytes + done, count - done);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return KATANA_ERROR(katana::ResultErrno(), "writing {}", tmp_path);
+      }
+      done += ret;
+    }
+    return katana::ResultSuccess();
+  };
+  auto res = [&]() -> katana::Result<void> {
+    if (auto res = write_all(data, size); !res) {
+      return res.error();
+    }
+    if (auto res = write_all(key.data(), key.size()); !res) {
+      return res.error();
+    }
+    if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "publishing {}", path);
+    }
+    return katana::ResultSuccess();
+  }();
+  if (!res) {
+    unlink(tmp_path.c_str());
+  }
+  return res;
+}
+
+katana::Result<void>
+tsuba::BlockCache::Insert(
+    const std::string& uri, const StatBuf& stat, uint64_t begin,
+    uint64_t size, const uint8_t* data) {
+  if (begin + size > stat.size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "range ends past the end of {}", uri);
+  }
+  if (boost::system::error_code err; !fs::create_directories(dir_, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating cache directory {}", dir_);
+    }
+  }
+
+  // Only whole blocks are cached; the last block of a file may be short
+  uint64_t published = 0;
+  for (uint64_t block = (begin + kBlockSize - 1) / kBlockSize;; ++block) {
+    uint64_t block_start = block * kBlockSize;
+    if (block_start >= stat.size) {
+      break;
+    }
+    uint64_t block_size = std::min(kBlockSize, stat.size - block_start);
+    if (block_start + block_size > begin + size) {
+      break;
+    }
+    std::string path = BlockPath(uri, stat, block);
+    std::string key = BlockKey(uri, stat, block);
+    if (FdCloser file{open(path.c_str(), O_RDONLY)};
+        file.fd >= 0 && HoldsKey(file.fd, block_size, key)) {
+      continue;
+    }
+    // A block of another file with the same name is replaced
+    if (auto res = Publish(path, data + block_start - begin, block_size, key);
+        !res) {
+      return res.error();
+    }
+    published += block_size;
+  }
+
+  if (published_.fetch_add(published) + published >= capacity_ / 16) {
+    published_ = 0;
+    if (auto res = Evict(); !res) {
+      return res.error().WithContext("evicting blocks");
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::BlockCache::Evict() {
+  std::string lock_path = dir_ + "/.lock";
+  FdCloser lock{open(lock_path.c_str(), O_RDWR | O_CREAT, 0644)};
+  if (lock.fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", lock_path);
+  }
+  if (flock(lock.fd, LOCK_EX | LOCK_NB) != 0) {
+    if (errno == EWOULDBLOCK) {
+      return katana::ResultSuccess();
+    }
+    return KATANA_ERROR(katana::ResultErrno(), "locking {}", lock_path);
+  }
+
+  // Blocks by last use
+  std::vector<std::tuple<std::time_t, uint64_t, fs::path>> blocks;
+  uint64_t total = 0;
+  boost::system::error_code err;
+  for (fs::directory_iterator it(dir_, err), end; !err && it != end;
+       it.increment(err)) {
+    const fs::path& path = it->path();
+    std::string name = path.filename().string();
+    if (name.empty() || name[0] == '.' ||
+        name.find(".tmp-") != std::string::npos) {
+      continue;
+    }
+    boost::system::error_code stat_err;
+    uint64_t size = fs::file_size(path, stat_err);
+    std::time_t used = fs::last_write_time(path, stat_err);
+    if (stat_err) {
+      // Removed by another process
+      continue;
+    }
+    blocks.emplace_back(used, size, path);
+    total += size;
+  }
+  if (err) {
+    return KATANA_ERROR(
+        std::error_code(err.value(), err.category()), "listing {}", dir_);
+  }
+  if (total <= capacity_) {
+    return katana::ResultSuccess();
+  }
+
+  std::sort(blocks.begin(), blocks.end());
+  uint64_t target = capacity_ / 10 * 9;
+  for (const auto& [used, size, path] : blocks) {
+    if (total <= target) {
+      break;
+    }
+    boost::system::error_code remove_err;
+    fs::remove(path, remove_err);
+    total -= size;
+  }
+  return katana::ResultSuccess();
+}
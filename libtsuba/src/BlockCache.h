@@ -0,0 +1,91 @@
+#ifndef KATANA_LIBTSUBA_BLOCKCACHE_H_
+#define KATANA_LIBTSUBA_BLOCKCACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "katana/Result.h"
+#include "tsuba/file.h"
+
+namespace tsuba {
+
+/// A cache of blocks of remote files on local disk, shared by the processes
+/// of a host, so that jobs that read the same graph again do not fetch it
+/// from the remote store each time.
+///
+/// The cache is a directory named by the KATANA_BLOCK_CACHE_DIR environment
+/// variable, which should be on a local SSD, holding up to
+/// KATANA_BLOCK_CACHE_GB gigabytes. A block is kBlockSize bytes of a file,
+/// aligned in the file, and is named after the URI, size and version (ETag
+/// or modification time) of the file, so a file that changes gets new
+/// blocks and its old ones age out. Names hold hashes of the URI and
+/// version, so each block stores them in full after its data, and a block
+/// is only used when they match. Blocks are published with an atomic
+/// rename, so concurrent processes see either a complete block or none, and
+/// the least recently used blocks are removed when the cache grows past its
+/// size.
+class BlockCache {
+public:
+  static constexpr uint64_t kBlockSize = UINT64_C(4) << 20;
+  static constexpr int kDefaultSizeGB = 64;
+
+  /// \returns the cache configured by the environment, or nullptr if there
+  ///     is none
+  static BlockCache* Get();
+
+  BlockCache(std::string dir, uint64_t capacity)
+      : dir_(std::move(dir)), capacity_(capacity) {}
+
+  /// Record the size and version of the file at \param uri, as returned by
+  /// a Stat of it, which the blocks read from now on must match
+  void NoteVersion(const std::string& uri, const StatBuf& stat);
+
+  /// The size and version of the file at \param uri if its blocks may be
+  /// cached, statting it if no version is known; none for local files and
+  /// files whose storage reports no version
+  std::optional<StatBuf> Version(const std::string& uri);
+
+  /// Copy \param size bytes at \param begin of the file at \param uri into
+  /// \param buf if every block they touch is cached.
+  ///
+  /// \returns false if a block is not cached
+  bool Read(
+      const std::string& uri, const StatBuf& stat, uint64_t begin,
+      uint64_t size, uint8_t* buf);
+
+  /// Cache the blocks of the file at \param uri within the \param size bytes
+  /// at \param begin, which \param data holds
+  katana::Result<void> Insert(
+      const std::string& uri, const StatBuf& stat, uint64_t begin,
+      uint64_t size, const uint8_t* data);
+
+private:
+  std::string BlockPath(
+      const std::string& uri, const StatBuf& stat, uint64_t block) const;
+  /// What a block stores after its data to name the block it holds, since
+  /// the hashes in the names of blocks can collide
+  static std::string BlockKey(
+      const std::string& uri, const StatBuf& stat, uint64_t block);
+  katana::Result<void> Publish(
+      const std::string& path, const uint8_t* data, uint64_t size,
+      const std::string& key);
+  /// Remove the least recently used blocks until the cache is well below its
+  /// size, unless another process is doing so
+  katana::Result<void> Evict();
+
+  std::string dir_;
+  uint64_t capacity_;
+  /// Bytes published since the last eviction
+  std::atomic<uint64_t> published_{0};
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, StatBuf> versions_;
+};
+
+}  // namespace tsuba
+
+#endif
@@ -0,0 +1,84 @@
+#include "CachingNameServerClient.h"
+
+#include <optional>
+
+namespace tsuba {
+
+void
+CachingNameServerClient::Put(const std::string& key, const RDGMeta& meta) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[key] = Entry{.meta = meta, .validated = Clock::now()};
+}
+
+void
+CachingNameServerClient::Drop(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.erase(key);
+}
+
+katana::Result<RDGMeta>
+CachingNameServerClient::Get(const katana::Uri& rdg_name) {
+  std::string key = rdg_name.Encode();
+  std::optional<RDGMeta> stale;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      if (Clock::now() - it->second.validated < ttl_) {
+        return it->second.meta;
+      }
+      stale = it->second.meta;
+    }
+  }
+
+  if (!stale) {
+    auto meta_res = client_->Get(rdg_name);
+    if (!meta_res) {
+      return meta_res.error();
+    }
+    Put(key, meta_res.value());
+    return meta_res;
+  }
+
+  RDGMeta meta = *stale;
+  auto changed_res = client_->GetIfChanged(rdg_name, stale->version(), &meta);
+  if (!changed_res) {
+    Drop(key);
+    return changed_res.error();
+  }
+  Put(key, meta);
+  return meta;
+}
+
+katana::Result<void>
+CachingNameServerClient::CreateIfAbsent(
+    const katana::Uri& rdg_name, const RDGMeta& meta) {
+  // The entry may have existed with another version
+  Drop(rdg_name.Encode());
+  return client_->CreateIfAbsent(rdg_name, meta);
+}
+
+katana::Result<void>
+CachingNameServerClient::Delete(const katana::Uri& rdg_name) {
+  Drop(rdg_name.Encode());
+  return client_->Delete(rdg_name);
+}
+
+katana::Result<void>
+CachingNameServerClient::Update(
+    const katana::Uri& rdg_name, uint64_t old_version, const RDGMeta& meta) {
+  std::string key = rdg_name.Encode();
+  if (auto res = client_->Update(rdg_name, old_version, meta); !res) {
+    Drop(key);
+    return res.error();
+  }
+  Put(key, meta);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+CachingNameServerClient::CheckHealth() {
+  return client_->CheckHealth();
+}
+
+}  // namespace tsuba
@@ -0,0 +1,65 @@
+#ifndef KATANA_LIBTSUBA_CACHINGNAMESERVERCLIENT_H_
+#define KATANA_LIBTSUBA_CACHINGNAMESERVERCLIENT_H_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "RDGMeta.h"
+#include "katana/Result.h"
+#include "tsuba/NameServerClient.h"
+
+namespace tsuba {
+
+/// Wraps a name server client with a local cache of the RDGMeta of each
+/// name, so that opening many versions of an RDG does not wait on the name
+/// server each time.
+///
+/// A cached entry is used as is for ttl after it was fetched; after that it
+/// is revalidated with GetIfChanged, which lets clients that support it ask
+/// the server whether the entry changed without fetching it again. Changes
+/// made through this client pass through to the wrapped client and update
+/// the cache. An Update that fails, e.g., because another client moved the
+/// name on since old_version (BadVersion), drops the entry.
+class KATANA_EXPORT CachingNameServerClient : public NameServerClient {
+public:
+  CachingNameServerClient(
+      std::unique_ptr<NameServerClient> client, std::chrono::milliseconds ttl)
+      : client_(std::move(client)), ttl_(ttl) {}
+
+  katana::Result<RDGMeta> Get(const katana::Uri& rdg_name) override;
+
+  katana::Result<void> CreateIfAbsent(
+      const katana::Uri& rdg_name, const RDGMeta& meta) override;
+
+  katana::Result<void> Delete(const katana::Uri& rdg_name) override;
+
+  katana::Result<void> Update(
+      const katana::Uri& rdg_name, uint64_t old_version,
+      const RDGMeta& meta) override;
+
+  katana::Result<void> CheckHealth() override;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    RDGMeta meta;
+    Clock::time_point validated;
+  };
+
+  void Put(const std::string& key, const RDGMeta& meta);
+  void Drop(const std::string& key);
+
+  std::unique_ptr<NameServerClient> client_;
+  std::chrono::milliseconds ttl_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace tsuba
+
+#endif
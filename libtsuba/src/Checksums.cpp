@@ -0,0 +1,181 @@
+#include "Checksums.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KATANA_HAS_X86_CRC32C 1
+#include <nmmintrin.h>
+#endif
+
+namespace {
+
+/// Buffers of more than this many blocks are summed by several threads
+constexpr uint64_t kBlocksPerTask = 64;
+
+/// The tables of slicing-by-8 for the reflected Castagnoli polynomial:
+/// table[0] is the classic byte table, and table[k][b] is the CRC of byte
+/// b followed by k zero bytes
+using Crc32cTables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr Crc32cTables
+MakeCrc32cTables() {
+  Crc32cTables tables{};
+  for (uint32_t b = 0; b < 256; ++b) {
+    uint32_t crc = b;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+    }
+    tables[0][b] = crc;
+  }
+  for (uint32_t b = 0; b < 256; ++b) {
+    for (size_t k = 1; k < tables.size(); ++k) {
+      uint32_t prev = tables[k - 1][b];
+      tables[k][b] = (prev >> 8) ^ tables[0][prev & 0xff];
+    }
+  }
+  return tables;
+}
+
+constexpr Crc32cTables kCrc32cTables = MakeCrc32cTables();
+
+uint32_t
+Crc32cScalar(const uint8_t* data, uint64_t size, uint32_t crc) {
+  const Crc32cTables& t = kCrc32cTables;
+  uint32_t c = ~crc;
+  while (size >= 8) {
+    uint32_t low;
+    uint32_t high;
+    std::memcpy(&low, data, 4);
+    std::memcpy(&high, data + 4, 4);
+    // Slicing-by-8 assumes little-endian words, as on every target we build
+    low ^= c;
+    c = t[7][low & 0xff] ^ t[6][(low >> 8) & 0xff] ^
+        t[5][(low >> 16) & 0xff] ^ t[4][low >> 24] ^ t[3][high & 0xff] ^
+        t[2][(high >> 8) & 0xff] ^ t[1][(high >> 16) & 0xff] ^
+        t[0][high >> 24];
+    data += 8;
+    size -= 8;
+  }
+  for (; size > 0; --size) {
+    c = (c >> 8) ^ t[0][(c ^ *data++) & 0xff];
+  }
+  return ~c;
+}
+
+#ifdef KATANA_HAS_X86_CRC32C
+
+__attribute__((target("sse4.2"))) uint32_t
+Crc32cSSE42(const uint8_t* data, uint64_t size, uint32_t crc) {
+  uint64_t c = ~crc & UINT64_C(0xffffffff);
+  while (size >= 8) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    c = _mm_crc32_u64(c, word);
+    data += 8;
+    size -= 8;
+  }
+  auto c32 = static_cast<uint32_t>(c);
+  for (; size > 0; --size) {
+    c32 = _mm_crc32_u8(c32, *data++);
+  }
+  return ~c32;
+}
+
+#endif
+
+using Crc32cFn = uint32_t (*)(const uint8_t*, uint64_t, uint32_t);
+
+Crc32cFn
+BestCrc32c() {
+#ifdef KATANA_HAS_X86_CRC32C
+  if (__builtin_cpu_supports("sse4.2")) {
+    return Crc32cSSE42;
+  }
+#endif
+  return Crc32cScalar;
+}
+
+struct ChecksumRegistry {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<const std::vector<uint32_t>>>
+      checksums;
+};
+
+ChecksumRegistry&
+Registry() {
+  static ChecksumRegistry registry;
+  return registry;
+}
+
+}  // namespace
+
+uint32_t
+tsuba::Crc32c(const uint8_t* data, uint64_t size, uint32_t crc) {
+  static const Crc32cFn crc32c = BestCrc32c();
+  return crc32c(data, size, crc);
+}
+
+std::vector<uint32_t>
+tsuba::BlockChecksums(const uint8_t* data, uint64_t size) {
+  uint64_t num_blocks = (size + kChecksumBlockSize - 1) / kChecksumBlockSize;
+  std::vector<uint32_t> checksums(num_blocks);
+  auto sum_blocks = [&](uint64_t begin, uint64_t end) {
+    for (uint64_t b = begin; b < end; ++b) {
+      uint64_t offset = b * kChecksumBlockSize;
+      checksums[b] =
+          Crc32c(data + offset, std::min(kChecksumBlockSize, size - offset));
+    }
+  };
+
+  uint64_t num_tasks = std::min<uint64_t>(
+      std::max(1U, std::thread::hardware_concurrency()),
+      num_blocks / kBlocksPerTask);
+  if (num_tasks <= 1) {
+    sum_blocks(0, num_blocks);
+    return checksums;
+  }
+  uint64_t per_task = (num_blocks + num_tasks - 1) / num_tasks;
+  std::vector<std::future<void>> tasks;
+  for (uint64_t begin = per_task; begin < num_blocks; begin += per_task) {
+    tasks.emplace_back(std::async(
+        std::launch::async, sum_blocks, begin,
+        std::min(begin + per_task, num_blocks)));
+  }
+  sum_blocks(0, per_task);
+  for (auto& task : tasks) {
+    task.get();
+  }
+  return checksums;
+}
+
+void
+tsuba::SetChecksums(const std::string& uri, std::vector<uint32_t> checksums) {
+  auto shared =
+      std::make_shared<const std::vector<uint32_t>>(std::move(checksums));
+  ChecksumRegistry& registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.checksums[uri] = std::move(shared);
+}
+
+void
+tsuba::RecordChecksums(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  SetChecksums(uri, BlockChecksums(data, size));
+}
+
+std::shared_ptr<const std::vector<uint32_t>>
+tsuba::FindChecksums(const std::string& uri) {
+  ChecksumRegistry& registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto it = registry.checksums.find(uri);
+  if (it == registry.checksums.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
@@ -0,0 +1,41 @@
+#ifndef KATANA_LIBTSUBA_CHECKSUMS_H_
+#define KATANA_LIBTSUBA_CHECKSUMS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tsuba {
+
+/// Stored files are checksummed in blocks of this many bytes, the size of
+/// the pages of a FileView, so that a page is verified when it is filled
+constexpr uint64_t kChecksumBlockSize = UINT64_C(1) << 20;
+
+/// The CRC32C of \param size bytes at \param data, continuing the checksum
+/// \param crc of the bytes before them. Uses SSE4.2 where it is available.
+uint32_t Crc32c(const uint8_t* data, uint64_t size, uint32_t crc = 0);
+
+/// The CRC32C of each kChecksumBlockSize block of \param size bytes at
+/// \param data, the last one maybe shorter; large buffers are summed by
+/// several threads
+std::vector<uint32_t> BlockChecksums(const uint8_t* data, uint64_t size);
+
+/// Remember the block checksums of the file at \param uri, either computed
+/// as it was stored or listed by the part header that references it, for
+/// the FileViews bound to it later and for the part headers written later
+void SetChecksums(const std::string& uri, std::vector<uint32_t> checksums);
+
+/// SetChecksums of the \param size bytes at \param data, just stored to
+/// \param uri
+void RecordChecksums(
+    const std::string& uri, const uint8_t* data, uint64_t size);
+
+/// \returns the block checksums remembered for \param uri, or nullptr if
+///     there are none, e.g., for files stored before checksums were
+std::shared_ptr<const std::vector<uint32_t>> FindChecksums(
+    const std::string& uri);
+
+}  // namespace tsuba
+
+#endif
@@ -11,12 +11,14 @@ static float independent_prob_{0.0f};
 static uint64_t run_length_{UINT64_C(0)};
 static uint64_t fault_run_length_{UINT64_C(0)};
 static uint64_t ptp_count_{UINT64_C(0)};
+static uint64_t fails_count_{UINT64_C(0)};
 static const std::unordered_map<tsuba::internal::FaultMode, std::string>
     fault_mode_label{
         {tsuba::internal::FaultMode::None, "No faults"},
         {tsuba::internal::FaultMode::Independent, "Independent"},
         {tsuba::internal::FaultMode::RunLength, "RunLength"},
         {tsuba::internal::FaultMode::UniformOverRun, "UniformOverRun"},
+        {tsuba::internal::FaultMode::ErrorRunLength, "ErrorRunLength"},
     };
 
 void
@@ -57,6 +59,11 @@ tsuba::internal::FaultTestInit(
   case tsuba::internal::FaultMode::Independent: {
     fmt::print("FaultTest Independent {:f}\n", independent_prob_);
   } break;
+  case tsuba::internal::FaultMode::ErrorRunLength: {
+    fault_run_length_ = run_length;
+    fails_count_ = 0;
+    fmt::print("FaultTest ErrorRunLength {:d}\n", run_length_);
+  } break;
   case tsuba::internal::FaultMode::None:
     // Do nothing
     break;
@@ -76,6 +83,7 @@ tsuba::internal::PtP(
   ptp_count_++;
   switch (mode_) {
   case tsuba::internal::FaultMode::None:
+  case tsuba::internal::FaultMode::ErrorRunLength:
     return;
   case tsuba::internal::FaultMode::Independent: {
     float threshold = independent_prob_;
@@ -103,3 +111,19 @@ tsuba::internal::PtP(
   }
   }
 }
+
+bool
+tsuba::internal::PtPFails(
+    const char* file, int line, tsuba::internal::FaultSensitivity sensitivity) {
+  if (mode_ != tsuba::internal::FaultMode::ErrorRunLength) {
+    PtP(file, line, sensitivity);
+    return false;
+  }
+  ptp_count_++;
+  fails_count_++;
+  if (fails_count_ == fault_run_length_) {
+    fmt::print("FaultTest::PtPFails {}:{}\n", file, line);
+    return true;
+  }
+  return false;
+}
@@ -2,6 +2,7 @@
 
 #include <sys/mman.h>
 
+#include "MultipartTransfer.h"
 #include "katana/Logging.h"
 #include "katana/Platform.h"
 #include "katana/Result.h"
@@ -114,7 +115,7 @@ FileFrame::Persist() {
   if (path_.empty()) {
     return KATANA_ERROR(tsuba::ErrorCode::InvalidArgument, "no path provided");
   }
-  if (auto res = tsuba::FileStore(path_, map_start_, cursor_); !res) {
+  if (auto res = tsuba::MultipartPut(path_, map_start_, cursor_); !res) {
     return res.error();
   }
   return katana::ResultSuccess();
@@ -132,7 +133,7 @@ FileFrame::PersistAsync() {
       return KATANA_ERROR(ErrorCode::InvalidArgument, "no path provided");
     });
   }
-  return tsuba::FileStoreAsync(path_, map_start_, cursor_);
+  return tsuba::MultipartPutAsync(path_, map_start_, cursor_);
 }
 
 /////// Begin arrow::io::BufferOutputStream method definitions //////
@@ -4,6 +4,8 @@
 
 tsuba::FileStorage::~FileStorage() = default;
 
+tsuba::MultipartUpload::~MultipartUpload() = default;
+
 std::vector<tsuba::FileStorage*>&
 tsuba::GetRegisteredFileStorages() {
   static std::vector<FileStorage*> fs;
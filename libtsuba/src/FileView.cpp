@@ -4,12 +4,17 @@
 #include <unistd.h>
 
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <string>
 
+#include "Checksums.h"
+#include "MultipartTransfer.h"
+#include "SharedCache.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
+#include "tsuba/IOStats.h"
 #include "tsuba/file.h"
 
 /*
@@ -42,7 +47,8 @@ katana::Result<void>
 FileView::Unbind() {
   if (valid_) {
     // Resolve all outstanding reads so they don't write to the memory we are
-    // about to unmap
+    // about to unmap; nobody reads what they fetched, so skip verifying it
+    checksums_.reset();
     if (auto res = Resolve(0, file_size_); !res) {
       return res.error().WithContext("resolving for unmap");
     }
@@ -77,6 +83,29 @@ FileView::Bind(
   // size, type of backing storage, etc. So make it a class member and set it
   // here.
   page_shift_ = 20; /* 1M */
+
+  SharedCache* cache = SharedCache::Get();
+  if (cache && buf.size > 0) {
+    if (auto res = BindShared(*cache, buf.size); !res) {
+      KATANA_LOG_WARN("not using shared cache: {}", res.error());
+    } else if (res.value()) {
+      return katana::ResultSuccess();
+    }
+  }
+
+  // Files stored without checksums, e.g., by older versions, are not
+  // verified
+  std::shared_ptr<const std::vector<uint32_t>> checksums =
+      FindChecksums(filename_);
+  uint64_t num_blocks =
+      (buf.size + kChecksumBlockSize - 1) / kChecksumBlockSize;
+  if (checksums && checksums->size() != num_blocks) {
+    return KATANA_ERROR(
+        ErrorCode::ChecksumMismatch,
+        "{} has {} bytes, but checksums of {} blocks", filename_, buf.size,
+        checksums->size());
+  }
+
   void* tmp = nullptr;
 
   // Map enough virtual memory to hold entire file, but do not populate it
@@ -90,6 +119,8 @@ FileView::Bind(
   }
 
   map_start_ = static_cast<uint8_t*>(tmp);
+  checksums_ = std::move(checksums);
+  shared_ = false;
   mem_start_ = -1;
   filling_.resize(page_number(buf.size) / 64 + 1, 0);
   file_size_ = buf.size;
@@ -99,64 +130,164 @@ FileView::Bind(
   }
 
   cursor_ = 0;
+  frontier_ = resolve ? in_end : begin;
   valid_ = true;
+
+  if (cache && resolve && begin == 0 && in_end == buf.size && buf.size > 0) {
+    // The whole file is in memory now; share it with later processes
+    if (auto res = cache->Publish(filename_, map_start_, file_size_); !res) {
+      KATANA_LOG_WARN("publishing to shared cache: {}", res.error());
+    } else if (auto res = BindShared(*cache, buf.size); !res) {
+      KATANA_LOG_WARN("mapping from shared cache: {}", res.error());
+    }
+  }
   return katana::ResultSuccess();
 }
 
+katana::Result<bool>
+FileView::BindShared(const SharedCache& cache, uint64_t size) {
+  auto map_res = cache.Map(filename_, size);
+  if (!map_res) {
+    return map_res.error();
+  }
+  if (!map_res.value()) {
+    return false;
+  }
+
+  if (auto res = Unbind(); !res) {
+    munmap(map_res.value(), size);
+    return res.error().WithContext("resetting for shared content");
+  }
+
+  // Everything is resident, so Fill never fetches into (or unprotects) the
+  // read-only mapping
+  map_start_ = static_cast<uint8_t*>(map_res.value());
+  shared_ = true;
+  mem_start_ = 0;
+  filling_.assign(page_number(size) / 64 + 1, 0);
+  if (auto res = MarkFilled(&filling_[0], 0, page_number(size - 1)); !res) {
+    return res.error();
+  }
+  file_size_ = size;
+  fetches_ = std::make_unique<std::vector<FillingRange>>();
+  cursor_ = 0;
+  frontier_ = size;
+  valid_ = true;
+  return true;
+}
+
 katana::Result<void>
 FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
-  uint64_t in_end = std::min<uint64_t>(end, file_size_);
-  uint64_t in_begin = std::min<uint64_t>(begin, in_end);
-  uint64_t first_page = 0;
-  uint64_t last_page = 0;
-  bool found_empty = false;
-
-  // We would check !valid_ but we want to call this in Bind before we have
-  // set valid_. fetches_ should be default constructed to
-  // nullptr.
-  if (!fetches_) {
-    return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
-  }
-  // Gracefully handle the fill zero case here to simplify Bind
-  if (in_end != in_begin) {
-    if (auto opt =
-            MustFill(&filling_[0], page_number(in_begin), page_number(in_end));
-        opt.has_value()) {
-      std::tie(first_page, last_page) = opt.value();
-      found_empty = true;
+  // A fill that resolves is timed until its data is read; a prefetch only
+  // until its reads start
+  IOTimer timer(IOOp::kFill);
+  auto res = [&]() -> katana::Result<void> {
+    uint64_t in_end = std::min<uint64_t>(end, file_size_);
+    uint64_t in_begin = std::min<uint64_t>(begin, in_end);
+    uint64_t first_page = 0;
+    uint64_t last_page = 0;
+    bool found_empty = false;
+
+    // We would check !valid_ but we want to call this in Bind before we have
+    // set valid_. fetches_ should be default constructed to
+    // nullptr.
+    if (!fetches_) {
+      return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
     }
-
-    uint64_t file_off = first_page * (1UL << page_shift_);
-    uint64_t map_size = std::min(
-        (last_page + 1) * (1UL << page_shift_) - file_off,
-        file_size_ - file_off);
-    if (found_empty) {
-      // Get physical pages for the region we are about to write
-      int err =
-          mprotect(map_start_ + file_off, map_size, PROT_READ | PROT_WRITE);
-      if (err == -1) {
-        return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
+    // Gracefully handle the fill zero case here to simplify Bind
+    if (in_end != in_begin) {
+      if (auto opt = MustFill(
+              &filling_[0], page_number(in_begin), page_number(in_end));
+          opt.has_value()) {
+        std::tie(first_page, last_page) = opt.value();
+        found_empty = true;
       }
 
-      auto peek_fut =
-          FileGetAsync(filename_, map_start_ + file_off, file_off, map_size);
-      KATANA_LOG_ASSERT(peek_fut.valid());
-      FillingRange fetch = {first_page, last_page, std::move(peek_fut)};
-      fetches_->push_back(std::move(fetch));
-      if (auto res = MarkFilled(&filling_[0], first_page, last_page); !res) {
-        return res.error().WithContext("updating bookkeeping data");
+      uint64_t file_off = first_page * (1UL << page_shift_);
+      uint64_t map_size = std::min(
+          (last_page + 1) * (1UL << page_shift_) - file_off,
+          file_size_ - file_off);
+      if (found_empty) {
+        // Get physical pages for the region we are about to write
+        int err =
+            mprotect(map_start_ + file_off, map_size, PROT_READ | PROT_WRITE);
+        if (err == -1) {
+          return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
+        }
+
+        auto peek_fut = MultipartGetAsync(
+            filename_, map_start_ + file_off, file_off, map_size);
+        timer.AddBytes(map_size);
+        KATANA_LOG_ASSERT(peek_fut.valid());
+        FillingRange fetch = {first_page, last_page, std::move(peek_fut)};
+        fetches_->push_back(std::move(fetch));
+        if (auto res = MarkFilled(&filling_[0], first_page, last_page); !res) {
+          return res.error().WithContext("updating bookkeeping data");
+        }
+        if (resolve) {
+          if (auto res = Resolve(file_off, map_size); !res) {
+            return res.error().WithContext("resolving fill");
+          }
+        } else {
+          stats_.bytes_prefetched += map_size;
+        }
+        int64_t signed_begin = static_cast<int64_t>(in_begin);
+        if (mem_start_ < 0 || signed_begin < mem_start_) {
+          mem_start_ = signed_begin;
+        }
       }
       if (resolve) {
-        if (auto res = Resolve(file_off, map_size); !res) {
-          return res.error().WithContext("resolving fill");
+        // Parts of the range may still be read by earlier asynchronous fills
+        if (auto res = Resolve(in_begin, in_end - in_begin); !res) {
+          return res.error().WithContext("resolving earlier fills");
         }
       }
-      int64_t signed_begin = static_cast<int64_t>(in_begin);
-      if (mem_start_ < 0 || signed_begin < mem_start_) {
-        mem_start_ = signed_begin;
-      }
     }
+    return katana::ResultSuccess();
+  }();
+  timer.Stop(res.has_value());
+  return res;
+}
+
+katana::Result<void>
+FileView::Evict(uint64_t begin, uint64_t end) {
+  if (!valid_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
+  }
+  if (shared_) {
+    return katana::ResultSuccess();
+  }
+  uint64_t in_end = std::min<uint64_t>(end, file_size_);
+  uint64_t page_size = UINT64_C(1) << page_shift_;
+  uint64_t first_page = page_number(begin + page_size - 1);
+  // The last page of the file is whole if the range reaches the end of it
+  uint64_t end_page = in_end == static_cast<uint64_t>(file_size_)
+                          ? page_number(in_end + page_size - 1)
+                          : page_number(in_end);
+  if (begin >= in_end || first_page >= end_page) {
+    return katana::ResultSuccess();
+  }
+
+  uint64_t file_off = first_page << page_shift_;
+  uint64_t map_size =
+      std::min<uint64_t>(end_page << page_shift_, file_size_) - file_off;
+  // Outstanding reads must not write to the pages after they are released
+  if (auto res = Resolve(file_off, map_size - 1); !res) {
+    return res.error().WithContext("resolving for evict");
+  }
+  if (madvise(map_start_ + file_off, map_size, MADV_DONTNEED) == -1) {
+    return KATANA_ERROR(katana::ResultErrno(), "releasing pages");
+  }
+  if (mprotect(map_start_ + file_off, map_size, PROT_NONE) == -1) {
+    return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
   }
+  MarkEvicted(&filling_[0], first_page, end_page - 1);
+
+  if (mem_start_ >= static_cast<int64_t>(file_off) &&
+      mem_start_ < static_cast<int64_t>(file_off + map_size)) {
+    mem_start_ = -1;
+  }
+  frontier_ = std::min(frontier_, file_off);
   return katana::ResultSuccess();
 }
 
@@ -229,15 +360,11 @@ FileView::Read(int64_t nbytes) {
   if (cursor_ + nbytes > file_size_) {
     nbytes_internal = file_size_ - cursor_;
   }
-  // fetch data from storage if necessary
-  if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
-    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
-  }
-  // resolve outstanding relevant fetches
-  if (auto res = Resolve(cursor_, nbytes_internal); !res) {
+  // fetch data from storage if necessary and resolve outstanding relevant
+  // fetches
+  if (auto res = FillAndResolve(cursor_, nbytes_internal); !res) {
     // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(
-        arrow::StatusCode::IOError, "Resolving asynchronous reads");
+    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
   }
   // prefetch
   if (auto res = PreFetch(cursor_, nbytes_internal); !res) {
@@ -264,15 +391,11 @@ FileView::Read(int64_t nbytes, void* out) {
   if (cursor_ + nbytes > file_size_) {
     nbytes_internal = file_size_ - cursor_;
   }
-  // fetch data from storage if necessary
-  if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
-    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
-  }
-  // resolve outstanding relevant fetches
-  if (auto res = Resolve(cursor_, nbytes_internal); !res) {
+  // fetch data from storage if necessary and resolve outstanding relevant
+  // fetches
+  if (auto res = FillAndResolve(cursor_, nbytes_internal); !res) {
     // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(
-        arrow::StatusCode::IOError, "Resolving asynchronous reads");
+    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
   }
   // prefetch
   if (auto res = PreFetch(cursor_, nbytes_internal); !res) {
@@ -450,6 +573,13 @@ FileView::MarkFilled(uint64_t* bitmap, uint64_t begin, uint64_t end) {
   return katana::ResultSuccess();
 }
 
+void
+FileView::MarkEvicted(uint64_t* bitmap, uint64_t begin, uint64_t end) {
+  for (uint64_t page = begin; page <= end; ++page) {
+    bitmap[page / 64] &= ~(UINT64_C(1) << (63 - page % 64));
+  }
+}
+
 katana::Result<void>
 FileView::Resolve(int64_t start, int64_t size) {
   // This loop could do less work by sorting the vector or storing an
@@ -457,13 +587,22 @@ FileView::Resolve(int64_t start, int64_t size) {
   // bottleneck
   for (auto it = fetches_->begin(); it != fetches_->end();) {
     auto fetch = it;
-    if (fetch->first_page <= page_number(start + size) ||
+    // Only wait for fetches that overlap the range so that prefetches further
+    // ahead keep running in the background
+    if (fetch->first_page <= page_number(start + size) &&
         fetch->last_page >= page_number(start)) {
       // Complete the remaining work if there is some
       if (fetch->work.valid()) {
         if (auto res = fetch->work.get(); !res) {
           return res.error();
         }
+        if (auto res = Verify(fetch->first_page, fetch->last_page); !res) {
+          // Fetch the pages again when they are read next, in case storage
+          // returned a bad copy
+          MarkEvicted(&filling_[0], fetch->first_page, fetch->last_page);
+          fetches_->erase(it);
+          return res.error();
+        }
       } else {
         KATANA_LOG_DEBUG("bad future in FileView::Resolve {} {}", start, size);
       }
@@ -475,8 +614,98 @@ FileView::Resolve(int64_t start, int64_t size) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+FileView::Verify(uint64_t first_page, uint64_t last_page) {
+  if (!checksums_) {
+    return katana::ResultSuccess();
+  }
+  // Pages are whole checksum blocks, but for the last one of the file
+  uint64_t begin = first_page << page_shift_;
+  uint64_t end =
+      std::min<uint64_t>((last_page + 1) << page_shift_, file_size_);
+  for (uint64_t offset = begin; offset < end; offset += kChecksumBlockSize) {
+    uint64_t block = offset / kChecksumBlockSize;
+    uint32_t sum = Crc32c(
+        map_start_ + offset, std::min(kChecksumBlockSize, end - offset));
+    if (sum != (*checksums_)[block]) {
+      return KATANA_ERROR(
+          ErrorCode::ChecksumMismatch,
+          "block {} of {} has checksum {:#x}, not {:#x}", block, filename_,
+          sum, (*checksums_)[block]);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+FileView::FillAndResolve(int64_t start, int64_t size) {
+  if (size <= 0) {
+    return katana::ResultSuccess();
+  }
+  uint64_t begin = static_cast<uint64_t>(start);
+  uint64_t end = static_cast<uint64_t>(start + size);
+
+  bool stalled = false;
+  if (MustFill(&filling_[0], page_number(begin), page_number(end - 1))) {
+    // nobody asked for this range yet, so we will wait for all of it
+    stalled = true;
+  } else {
+    for (const auto& fetch : *fetches_) {
+      if (fetch.first_page <= page_number(end - 1) &&
+          fetch.last_page >= page_number(begin) && fetch.work.valid() &&
+          fetch.work.wait_for(std::chrono::seconds(0)) !=
+              std::future_status::ready) {
+        stalled = true;
+        break;
+      }
+    }
+  }
+
+  if (auto res = Fill(begin, end, true); !res) {
+    return res.error();
+  }
+  if (auto res = Resolve(start, size); !res) {
+    return res.error().WithContext("resolving asynchronous reads");
+  }
+
+  if (stalled) {
+    stats_.stalls += 1;
+  } else {
+    stats_.hits += 1;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+FileView::AdvanceFrontier(uint64_t offset) {
+  if (!valid_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
+  }
+  uint64_t in_offset = std::min<uint64_t>(offset, file_size_);
+  if (in_offset > frontier_) {
+    if (auto res = FillAndResolve(frontier_, in_offset - frontier_); !res) {
+      return res.error();
+    }
+    frontier_ = in_offset;
+  }
+  if (readahead_ != 0) {
+    if (auto res = Fill(frontier_, frontier_ + readahead_, false); !res) {
+      return res.error().WithContext("reading ahead");
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 FileView::PreFetch(int64_t start, int64_t size) {
+  if (readahead_ != 0) {
+    uint64_t begin = static_cast<uint64_t>(start + size);
+    if (auto res = Fill(begin, begin + readahead_, false); !res) {
+      return res.error();
+    }
+    return katana::ResultSuccess();
+  }
+
   // Our highly sophisticated prefetching algorithm is to crudely approximate
   // the size of the last read plus 10%. This is largely motivated by parquet
   // files, which consecutively read row groups that are (in theory)
@@ -18,6 +18,23 @@ GetMemoryClient() {
 
 }  // namespace
 
+katana::Result<void>
+tsuba::LazyInit::Get(const std::function<katana::Result<void>()>& init) {
+  if (!done_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!done_.load(std::memory_order_relaxed)) {
+      if (auto res = init(); !res) {
+        error_ = res.error();
+      }
+      done_.store(true, std::memory_order_release);
+    }
+  }
+  if (error_) {
+    return KATANA_ERROR(error_->error_code(), "{}", *error_);
+  }
+  return katana::ResultSuccess();
+}
+
 std::unique_ptr<tsuba::GlobalState> tsuba::GlobalState::ref_ = nullptr;
 
 std::function<katana::Result<std::unique_ptr<tsuba::NameServerClient>>()>
@@ -34,24 +51,37 @@ tsuba::GlobalState::Comm() const {
   return comm_;
 }
 
-tsuba::FileStorage*
-tsuba::GlobalState::GetDefaultFS() const {
+size_t
+tsuba::GlobalState::FSIndex(std::string_view uri) const {
   KATANA_LOG_DEBUG_ASSERT(file_stores_.size() > 0);
-  return file_stores_[0];
+  for (size_t i = 0; i < file_stores_.size(); ++i) {
+    if (uri.find(file_stores_[i]->uri_scheme()) == 0) {
+      return i;
+    }
+  }
+  return 0;
 }
 
-tsuba::FileStorage*
+katana::Result<tsuba::FileStorage*>
 tsuba::GlobalState::FS(std::string_view uri) const {
-  for (FileStorage* fs : file_stores_) {
-    if (uri.find(fs->uri_scheme()) == 0) {
-      return fs;
-    }
+  size_t index = FSIndex(uri);
+  FileStorage* fs = file_stores_[index];
+  if (auto res = file_store_inits_[index]->Get([fs]() { return fs->Init(); });
+      !res) {
+    return res.error().WithContext(
+        "initializing file storage ({})", fs->uri_scheme());
   }
-  return GetDefaultFS();
+  return fs;
 }
 
-tsuba::NameServerClient*
+katana::Result<tsuba::NameServerClient*>
 tsuba::GlobalState::NS() const {
+  // quick ping to say hello and fail fast if something was misconfigured
+  if (auto res = name_server_init_.Get(
+          [ns = name_server_client_]() { return ns->CheckHealth(); });
+      !res) {
+    return res.error().WithContext("testing name server connection");
+  }
   return name_server_client_;
 }
 
@@ -60,11 +90,6 @@ tsuba::GlobalState::Init(
     katana::CommBackend* comm, tsuba::NameServerClient* ns) {
   KATANA_LOG_DEBUG_ASSERT(ref_ == nullptr);
 
-  // quick ping to say hello and fail fast if something was misconfigured
-  if (auto res = ns->CheckHealth(); !res) {
-    return res.error().WithContext("testing name server connection");
-  }
-
   // new to access non-public constructor
   std::unique_ptr<GlobalState> global_state(new GlobalState(comm, ns));
 
@@ -80,10 +105,8 @@ tsuba::GlobalState::Init(
         return lhs->Priority() > rhs->Priority();
       });
 
-  for (FileStorage* fs : global_state->file_stores_) {
-    if (auto res = fs->Init(); !res) {
-      return res.error().WithContext("initializing backends");
-    }
+  for (size_t i = 0; i < global_state->file_stores_.size(); ++i) {
+    global_state->file_store_inits_.emplace_back(std::make_unique<LazyInit>());
   }
 
   ref_ = std::move(global_state);
@@ -92,7 +115,11 @@ tsuba::GlobalState::Init(
 
 katana::Result<void>
 tsuba::GlobalState::Fini() {
-  for (FileStorage* fs : ref_->file_stores_) {
+  for (size_t i = 0; i < ref_->file_stores_.size(); ++i) {
+    if (!ref_->file_store_inits_[i]->succeeded()) {
+      continue;
+    }
+    FileStorage* fs = ref_->file_stores_[i];
     if (auto res = fs->Fini(); !res) {
       return res.error().WithContext(
           "file storage shutdown ({})", fs->uri_scheme());
@@ -115,12 +142,12 @@ tsuba::Comm() {
   return GlobalState::Get().Comm();
 }
 
-tsuba::FileStorage*
+katana::Result<tsuba::FileStorage*>
 tsuba::FS(std::string_view uri) {
   return GlobalState::Get().FS(uri);
 }
 
-tsuba::NameServerClient*
+katana::Result<tsuba::NameServerClient*>
 tsuba::NS() {
   return GlobalState::Get().NS();
 }
@@ -1,7 +1,11 @@
 #ifndef KATANA_LIBTSUBA_GLOBALSTATE_H_
 #define KATANA_LIBTSUBA_GLOBALSTATE_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 
 #include "LocalStorage.h"
@@ -13,6 +17,22 @@
 
 namespace tsuba {
 
+/// LazyInit runs an initialization on its first Get, from whichever thread
+/// calls first, and returns the result of that run from every Get
+class LazyInit {
+  std::atomic<bool> done_{false};
+  std::mutex mutex_;
+  std::optional<katana::CopyableErrorInfo> error_;
+
+public:
+  katana::Result<void> Get(const std::function<katana::Result<void>()>& init);
+
+  /// \returns true if the initialization ran and succeeded
+  bool succeeded() const {
+    return done_.load(std::memory_order_acquire) && !error_;
+  }
+};
+
 class GlobalState {
   static std::unique_ptr<GlobalState> ref_;
   static std::function<
@@ -20,8 +40,13 @@ class GlobalState {
       make_name_server_client_cb_;
 
   std::vector<FileStorage*> file_stores_;
+  /// The backends and the connection to the name server are initialized on
+  /// first use, so that programs that only read a local file do not wait for
+  /// the others
+  std::vector<std::unique_ptr<LazyInit>> file_store_inits_;
   katana::CommBackend* comm_;
   tsuba::NameServerClient* name_server_client_;
+  mutable LazyInit name_server_init_;
 
   tsuba::LocalStorage local_storage_;
 
@@ -30,7 +55,8 @@ class GlobalState {
     file_stores_.emplace_back(&local_storage_);
   }
 
-  FileStorage* GetDefaultFS() const;
+  /// The index of the file storage of uri
+  size_t FSIndex(std::string_view uri) const;
 
 public:
   GlobalState(const GlobalState& no_copy) = delete;
@@ -41,7 +67,7 @@ public:
   ~GlobalState() = default;
 
   katana::CommBackend* Comm() const;
-  NameServerClient* NS() const;
+  katana::Result<NameServerClient*> NS() const;
 
   /// Get the correct FileStorage based on the URI
   ///
@@ -51,7 +77,9 @@ public:
   /// gs://...    -> GSStore
   /// file://...  -> LocalStore
   /// {no scheme} -> LocalStore
-  FileStorage* FS(std::string_view uri) const;
+  ///
+  /// The store is initialized by the first call that selects it
+  katana::Result<FileStorage*> FS(std::string_view uri) const;
 
   static katana::Result<void> Init(
       katana::CommBackend* comm, tsuba::NameServerClient* ns);
@@ -70,9 +98,9 @@ public:
   }
 };
 
-katana::CommBackend* Comm();
-FileStorage* FS(std::string_view uri);
-NameServerClient* NS();
+KATANA_EXPORT katana::CommBackend* Comm();
+katana::Result<FileStorage*> FS(std::string_view uri);
+katana::Result<NameServerClient*> NS();
 
 /// Execute cb on one host, if it succeeds return success if not print
 /// the error and return MpiError
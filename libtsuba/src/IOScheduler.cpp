@@ -0,0 +1,128 @@
+#include "tsuba/IOScheduler.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+
+/// The scheduler whose op the thread is running, if any
+thread_local tsuba::IOScheduler* running_scheduler = nullptr;
+
+/// The backend of uri, named by its scheme; URIs without one are local
+std::string
+BackendOf(const std::string& uri) {
+  size_t end = uri.find("://");
+  if (end == std::string::npos) {
+    return std::string();
+  }
+  std::string scheme = uri.substr(0, end);
+  return scheme == "file" ? std::string() : scheme;
+}
+
+}  // namespace
+
+tsuba::IOScheduler*
+tsuba::IOScheduler::Get() {
+  static IOScheduler scheduler(kDefaultMaxOps, kDefaultMaxBytes, kMaxThreads);
+  return &scheduler;
+}
+
+tsuba::IOScheduler::IOScheduler(
+    uint32_t max_ops, uint64_t max_bytes, uint32_t max_threads)
+    : max_ops_(std::max<uint32_t>(max_ops, 1)),
+      max_bytes_(max_bytes),
+      max_threads_(std::max<uint32_t>(max_threads, 1)),
+      queues_(static_cast<size_t>(IOPriority::Properties) + 1) {}
+
+tsuba::IOScheduler::~IOScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  changed_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void
+tsuba::IOScheduler::Enqueue(
+    const std::string& uri, IOPriority priority, uint64_t bytes,
+    std::function<void()> run) {
+  // The op would wait for a slot that the op scheduling it may hold
+  if (running_scheduler == this) {
+    run();
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  queues_[static_cast<size_t>(priority)].emplace_back(Op{
+      .backend = BackendOf(uri),
+      .bytes = bytes,
+      .run = std::move(run),
+  });
+  // Threads start as ops arrive to keep them busy, up to max_threads_
+  if (idle_threads_ == 0 && threads_.size() < max_threads_) {
+    threads_.emplace_back([this]() { Work(); });
+    return;
+  }
+  changed_.notify_one();
+}
+
+bool
+tsuba::IOScheduler::TakeRunnable(Op* op) {
+  // A backend whose first queued op cannot start holds back the ops after
+  // it, so that small ops do not starve a large one
+  std::unordered_set<std::string> blocked;
+  for (std::deque<Op>& queue : queues_) {
+    for (auto it = queue.begin(); it != queue.end(); ++it) {
+      if (blocked.count(it->backend) > 0) {
+        continue;
+      }
+      Backend& backend = backends_[it->backend];
+      if (backend.ops < max_ops_ &&
+          (backend.ops == 0 || backend.bytes + it->bytes <= max_bytes_)) {
+        backend.ops += 1;
+        backend.bytes += it->bytes;
+        *op = std::move(*it);
+        queue.erase(it);
+        return true;
+      }
+      blocked.emplace(it->backend);
+      if (blocked.size() == backends_.size()) {
+        return false;
+      }
+    }
+  }
+  return false;
+}
+
+void
+tsuba::IOScheduler::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    Op op;
+    if (TakeRunnable(&op)) {
+      lock.unlock();
+      running_scheduler = this;
+      op.run();
+      running_scheduler = nullptr;
+      lock.lock();
+      Backend& backend = backends_[op.backend];
+      backend.ops -= 1;
+      backend.bytes -= op.bytes;
+      // The ops and bytes freed may let queued ops start
+      changed_.notify_all();
+      continue;
+    }
+    bool empty = std::all_of(
+        queues_.begin(), queues_.end(),
+        [](const std::deque<Op>& queue) { return queue.empty(); });
+    if (stopping_ && empty) {
+      return;
+    }
+    idle_threads_ += 1;
+    changed_.wait(lock);
+    idle_threads_ -= 1;
+  }
+}
@@ -0,0 +1,156 @@
+#include "tsuba/IOStats.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+/// Latencies below 4 usec have a bucket each; above, each power of two is
+/// split into 4 buckets, so a bucket is at most a quarter of its values wide
+constexpr size_t kNumBuckets = 4 * 62 + 4;
+
+size_t
+BucketOf(uint64_t usec) {
+  if (usec < 4) {
+    return usec;
+  }
+  int exp = 63 - __builtin_clzll(usec);
+  return 4 * (exp - 1) + ((usec >> (exp - 2)) & 3);
+}
+
+/// \returns the largest latency in bucket
+uint64_t
+BucketMax(size_t bucket) {
+  if (bucket < 4) {
+    return bucket;
+  }
+  int exp = bucket / 4 + 1;
+  uint64_t sub = bucket % 4;
+  return ((4 + sub + 1) << (exp - 2)) - 1;
+}
+
+struct Counter {
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> errors{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> total_usec{0};
+  std::atomic<uint64_t> max_usec{0};
+  std::array<std::atomic<uint64_t>, kNumBuckets> latency{};
+};
+
+std::array<Counter, tsuba::kNumIOOps> counters;
+
+Counter&
+GetCounter(tsuba::IOOp op) {
+  return counters[static_cast<size_t>(op)];
+}
+
+void
+RaiseTo(std::atomic<uint64_t>* max, uint64_t val) {
+  uint64_t prev = max->load(std::memory_order_relaxed);
+  while (val > prev &&
+         !max->compare_exchange_weak(prev, val, std::memory_order_relaxed))
+    ;
+}
+
+/// \returns the latency below which fraction of the operations recorded in
+/// buckets took
+uint64_t
+Percentile(
+    const std::array<uint64_t, kNumBuckets>& buckets, uint64_t num,
+    double fraction) {
+  auto rank = static_cast<uint64_t>(std::ceil(fraction * num));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank && seen > 0) {
+      return BucketMax(i);
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+const char*
+tsuba::IOOpName(IOOp op) {
+  static constexpr const char* kNames[] = {
+      "Stat", "Get",  "Put",         "List",        "Delete",
+      "Copy", "Fill", "ParquetRead", "ParquetWrite"};
+  static_assert(std::size(kNames) == kNumIOOps);
+  return kNames[static_cast<size_t>(op)];
+}
+
+void
+tsuba::RecordIO(IOOp op, uint64_t usec, uint64_t bytes, bool ok) {
+  Counter& counter = GetCounter(op);
+  counter.count.fetch_add(1, std::memory_order_relaxed);
+  if (!ok) {
+    counter.errors.fetch_add(1, std::memory_order_relaxed);
+  }
+  counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+  counter.total_usec.fetch_add(usec, std::memory_order_relaxed);
+  RaiseTo(&counter.max_usec, usec);
+  counter.latency[BucketOf(usec)].fetch_add(1, std::memory_order_relaxed);
+}
+
+tsuba::IOOpStats
+tsuba::GetIOStats(IOOp op) {
+  const Counter& counter = GetCounter(op);
+  IOOpStats stats;
+  stats.count = counter.count.load(std::memory_order_relaxed);
+  stats.errors = counter.errors.load(std::memory_order_relaxed);
+  stats.bytes = counter.bytes.load(std::memory_order_relaxed);
+  stats.total_usec = counter.total_usec.load(std::memory_order_relaxed);
+  stats.max_usec = counter.max_usec.load(std::memory_order_relaxed);
+
+  // Operations recorded while reading are in some counters and not others
+  std::array<uint64_t, kNumBuckets> buckets;
+  uint64_t num = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    buckets[i] = counter.latency[i].load(std::memory_order_relaxed);
+    num += buckets[i];
+  }
+  stats.p50_usec = std::min(Percentile(buckets, num, 0.50), stats.max_usec);
+  stats.p90_usec = std::min(Percentile(buckets, num, 0.90), stats.max_usec);
+  stats.p99_usec = std::min(Percentile(buckets, num, 0.99), stats.max_usec);
+  return stats;
+}
+
+void
+tsuba::ResetIOStats() {
+  for (Counter& counter : counters) {
+    counter.count.store(0, std::memory_order_relaxed);
+    counter.errors.store(0, std::memory_order_relaxed);
+    counter.bytes.store(0, std::memory_order_relaxed);
+    counter.total_usec.store(0, std::memory_order_relaxed);
+    counter.max_usec.store(0, std::memory_order_relaxed);
+    for (auto& bucket : counter.latency) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void
+tsuba::IOTimer::Stop(bool ok) {
+  auto usec = std::chrono::duration_cast<std::chrono::microseconds>(
+                  Clock::now() - start_)
+                  .count();
+  RecordIO(op_, usec, bytes_, ok);
+}
+
+std::future<katana::Result<void>>
+tsuba::TimeIOAsync(
+    IOOp op, uint64_t bytes, std::future<katana::Result<void>> future) {
+  return std::async(
+      std::launch::deferred,
+      [timer = IOTimer(op, bytes),
+       future = std::move(future)]() mutable -> katana::Result<void> {
+        auto res = future.get();
+        timer.Stop(res.has_value());
+        return res;
+      });
+}
@@ -7,13 +7,21 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <iterator>
+#include <mutex>
 #include <system_error>
+#include <thread>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "katana/Uri.h"
@@ -22,6 +30,300 @@
 
 namespace fs = boost::filesystem;
 
+namespace {
+
+/// Transfers are split into chunks of this many bytes, aligned in the file,
+/// which the pool moves in parallel
+constexpr uint64_t kChunkSize = UINT64_C(8) << 20;
+
+/// Threads of the pool unless KATANA_LOCAL_IO_THREADS is set; enough
+/// requests in flight to keep an NVMe drive busy
+constexpr int kDefaultIOThreads = 16;
+
+bool
+IsBlockAligned(uint64_t value) {
+  return (value & tsuba::kBlockOffsetMask) == 0;
+}
+
+katana::Result<void>
+CreateParentDirectories(const std::string& path) {
+  fs::path dir = fs::path(path).parent_path();
+  if (dir.empty()) {
+    return katana::ResultSuccess();
+  }
+  if (boost::system::error_code err; !fs::create_directories(dir, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating parent directories");
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+/// Threads that run the chunks of transfers in the order they are queued
+class tsuba::LocalStorage::IOPool {
+public:
+  explicit IOPool(int num_threads) {
+    for (int i = 0; i < num_threads; ++i) {
+      threads_.emplace_back([this]() { Work(); });
+    }
+  }
+
+  /// Finish the queued tasks and join the threads
+  ~IOPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    ready_.notify_all();
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void Push(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace_back(std::move(task));
+    }
+    ready_.notify_one();
+  }
+
+private:
+  void Work() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopping_{false};
+  std::vector<std::thread> threads_;
+};
+
+/// One read or write of a range of a file, shared by its chunks
+struct tsuba::LocalStorage::Transfer {
+  std::string path;
+  int fd{-1};
+  /// The file opened with O_DIRECT as well, or -1
+  int direct_fd{-1};
+  bool write{};
+  /// The memory of [start, start + size) of the file; only read if write
+  uint8_t* data{};
+  uint64_t start{};
+  uint64_t size{};
+
+  std::atomic<uint64_t> pending{};
+  std::atomic<uint64_t> transferred{0};
+  std::promise<void> done;
+  std::future<void> finished{done.get_future()};
+
+  /// The first error of a chunk, as a code and a message, since an
+  /// ErrorInfo cannot pass between threads
+  std::mutex error_mutex;
+  std::error_code error;
+  std::string error_message;
+
+  ~Transfer() {
+    if (direct_fd >= 0) {
+      close(direct_fd);
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+
+  uint64_t num_chunks() const {
+    if (size == 0) {
+      return 0;
+    }
+    return (start + size - 1) / kChunkSize - start / kChunkSize + 1;
+  }
+
+  void Fail(std::error_code ec, const char* message) {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (!error) {
+      error = ec;
+      error_message = message;
+    }
+  }
+
+  /// Move [begin, end) of the file through descriptor, stopping at the end
+  /// of the file
+  bool Move(int descriptor, uint64_t begin, uint64_t end) {
+    while (begin < end) {
+      uint8_t* buf = data + (begin - start);
+      ssize_t moved = write ? pwrite(descriptor, buf, end - begin, begin)
+                            : pread(descriptor, buf, end - begin, begin);
+      if (moved < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        Fail(katana::ResultErrno(), write ? "writing" : "reading");
+        return false;
+      }
+      transferred += moved;
+      // Past the end of the file a read returns 0, and O_DIRECT cannot go
+      // on from the unaligned offset a read stops at before then
+      if (moved == 0 || (descriptor == direct_fd &&
+                         static_cast<uint64_t>(moved) < end - begin)) {
+        return false;
+      }
+      begin += moved;
+    }
+    return true;
+  }
+
+  void RunChunk(uint64_t chunk) {
+    uint64_t first_chunk = start / kChunkSize;
+    uint64_t begin = std::max(start, (first_chunk + chunk) * kChunkSize);
+    uint64_t end =
+        std::min(start + size, (first_chunk + chunk + 1) * kChunkSize);
+
+    // The blocks of the chunk that are aligned in memory too can go around
+    // the page cache
+    uint64_t direct_begin = (begin + kBlockOffsetMask) & ~kBlockOffsetMask;
+    uint64_t direct_end = end & ~kBlockOffsetMask;
+    if (direct_fd < 0 || direct_end <= direct_begin ||
+        !IsBlockAligned(
+            reinterpret_cast<uintptr_t>(data + (direct_begin - start)))) {
+      direct_begin = direct_end = end;
+    }
+
+    if (Move(fd, begin, direct_begin) &&
+        Move(direct_fd, direct_begin, direct_end)) {
+      Move(fd, direct_end, end);
+    }
+    if (pending.fetch_sub(1) == 1) {
+      done.set_value();
+    }
+  }
+
+  katana::Result<void> Finish() {
+    finished.wait();
+    if (error) {
+      return KATANA_ERROR(error, "{} {}", error_message, path);
+    }
+    // if the difference in what was read from what we wanted is less than a
+    // block it's because the file size isn't well aligned so don't complain.
+    if (!write && size - transferred > kBlockSize) {
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError,
+          "reading {}: the file ends {} bytes before the range", path,
+          size - transferred);
+    }
+    return katana::ResultSuccess();
+  }
+};
+
+/// A file being written in parts, to a temporary file until it is complete
+class tsuba::LocalStorage::Upload : public MultipartUpload {
+public:
+  Upload(
+      LocalStorage* storage, std::string path, std::string tmp_path, int fd,
+      uint64_t part_size)
+      : storage_(storage),
+        path_(std::move(path)),
+        tmp_path_(std::move(tmp_path)),
+        fd_(fd),
+        part_size_(part_size) {}
+
+  ~Upload() override { Abort(); }
+
+  std::future<katana::Result<void>> PutPartAsync(
+      uint32_t part, const uint8_t* data, uint64_t size) override {
+    auto transfer = std::make_shared<Transfer>();
+    transfer->path = tmp_path_;
+    transfer->write = true;
+    transfer->data = const_cast<uint8_t*>(data);
+    transfer->start = part * part_size_;
+    transfer->size = size;
+    // Each transfer closes its own descriptors
+    transfer->fd = dup(fd_);
+    if (transfer->fd < 0) {
+      katana::CopyableErrorInfo error(
+          KATANA_ERROR(katana::ResultErrno(), "opening {}", tmp_path_));
+      return std::async(
+          std::launch::deferred, [error]() -> katana::Result<void> {
+            return KATANA_ERROR(error.error_code(), "{}", error);
+          });
+    }
+    if (storage_->direct_io_) {
+      transfer->direct_fd = open(tmp_path_.c_str(), O_WRONLY | O_DIRECT);
+    }
+    storage_->Submit(transfer, false);
+    return std::async(std::launch::deferred, [transfer]() {
+      return transfer->Finish();
+    });
+  }
+
+  katana::Result<void> Complete() override {
+    int fd = fd_;
+    fd_ = -1;
+    if (close(fd) != 0) {
+      unlink(tmp_path_.c_str());
+      return KATANA_ERROR(katana::ResultErrno(), "closing {}", tmp_path_);
+    }
+    if (rename(tmp_path_.c_str(), path_.c_str()) != 0) {
+      unlink(tmp_path_.c_str());
+      return KATANA_ERROR(katana::ResultErrno(), "renaming to {}", path_);
+    }
+    return katana::ResultSuccess();
+  }
+
+  void Abort() override {
+    if (fd_ >= 0) {
+      close(fd_);
+      fd_ = -1;
+      unlink(tmp_path_.c_str());
+    }
+  }
+
+private:
+  LocalStorage* storage_;
+  std::string path_;
+  std::string tmp_path_;
+  /// The temporary file until the upload completes or aborts, else -1
+  int fd_;
+  uint64_t part_size_;
+};
+
+tsuba::LocalStorage::LocalStorage() : FileStorage("file://") {}
+
+tsuba::LocalStorage::~LocalStorage() = default;
+
+katana::Result<void>
+tsuba::LocalStorage::Init() {
+  int num_threads = kDefaultIOThreads;
+  katana::GetEnv("KATANA_LOCAL_IO_THREADS", &num_threads);
+  katana::GetEnv("KATANA_LOCAL_DIRECT_IO", &direct_io_);
+  if (num_threads > 0) {
+    pool_ = std::make_unique<IOPool>(num_threads);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::LocalStorage::Fini() {
+  pool_.reset();
+  return katana::ResultSuccess();
+}
+
 void
 tsuba::LocalStorage::CleanUri(std::string* uri) {
   if (uri->find(uri_scheme()) != 0) {
@@ -30,31 +332,136 @@ tsuba::LocalStorage::CleanUri(std::string* uri) {
   *uri = std::string(uri->begin() + uri_scheme().size(), uri->end());
 }
 
-katana::Result<void>
-tsuba::LocalStorage::WriteFile(
+katana::Result<std::shared_ptr<tsuba::LocalStorage::Transfer>>
+tsuba::LocalStorage::StartWrite(
     std::string uri, const uint8_t* data, uint64_t size) {
   CleanUri(&uri);
-  fs::path m_path{uri};
-  fs::path dir = m_path.parent_path();
-  if (!dir.empty()) {
-    if (boost::system::error_code err; !fs::create_directories(dir, err)) {
-      if (err) {
-        return KATANA_ERROR(
-            std::error_code(err.value(), err.category()),
-            "creating parent directories");
-      }
+  if (auto res = CreateParentDirectories(uri); !res) {
+    return res.error();
+  }
+
+  auto transfer = std::make_shared<Transfer>();
+  transfer->path = uri;
+  transfer->write = true;
+  // Writes only read the buffer
+  transfer->data = const_cast<uint8_t*>(data);
+  transfer->size = size;
+  transfer->fd = open(uri.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (transfer->fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", uri);
+  }
+  // Chunks past the end of what is written so far extend the file
+  if (ftruncate(transfer->fd, size) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "sizing {}", uri);
+  }
+  if (direct_io_) {
+    transfer->direct_fd = open(uri.c_str(), O_WRONLY | O_DIRECT);
+  }
+  return transfer;
+}
+
+katana::Result<std::shared_ptr<tsuba::LocalStorage::Transfer>>
+tsuba::LocalStorage::StartRead(
+    std::string uri, uint64_t start, uint64_t size, uint8_t* data) {
+  CleanUri(&uri);
+  auto transfer = std::make_shared<Transfer>();
+  transfer->path = uri;
+  transfer->data = data;
+  transfer->start = start;
+  transfer->size = size;
+  transfer->fd = open(uri.c_str(), O_RDONLY);
+  if (transfer->fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", uri);
+  }
+  // File systems without O_DIRECT, such as tmpfs, fail to open it; the
+  // transfer then uses the page cache for every chunk
+  if (direct_io_) {
+    transfer->direct_fd = open(uri.c_str(), O_RDONLY | O_DIRECT);
+  }
+  return transfer;
+}
+
+void
+tsuba::LocalStorage::Submit(
+    const std::shared_ptr<Transfer>& transfer, bool run_first) {
+  uint64_t num_chunks = transfer->num_chunks();
+  if (num_chunks == 0) {
+    transfer->done.set_value();
+    return;
+  }
+  transfer->pending = num_chunks;
+  uint64_t first_queued = run_first || !pool_ ? 1 : 0;
+  for (uint64_t chunk = first_queued; chunk < num_chunks; ++chunk) {
+    if (!pool_) {
+      transfer->RunChunk(chunk);
+      continue;
     }
+    pool_->Push([transfer, chunk]() { transfer->RunChunk(chunk); });
   }
+  if (first_queued == 1) {
+    transfer->RunChunk(0);
+  }
+}
 
-  std::ofstream ofile(uri);
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "opening file");
+katana::Result<void>
+tsuba::LocalStorage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  auto transfer_res = StartRead(uri, start, size, result_buf);
+  if (!transfer_res) {
+    return transfer_res.error();
   }
-  ofile.write(reinterpret_cast<const char*>(data), size); /* NOLINT */
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "writing file");
+  Submit(transfer_res.value(), true);
+  return transfer_res.value()->Finish();
+}
+
+katana::Result<void>
+tsuba::LocalStorage::PutMultiSync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  auto transfer_res = StartWrite(uri, data, size);
+  if (!transfer_res) {
+    return transfer_res.error();
   }
-  return katana::ResultSuccess();
+  Submit(transfer_res.value(), true);
+  return transfer_res.value()->Finish();
+}
+
+std::future<katana::Result<void>>
+tsuba::LocalStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  auto transfer_res = StartWrite(uri, data, size);
+  if (!transfer_res) {
+    katana::CopyableErrorInfo error(transfer_res.error());
+    return std::async(
+        std::launch::deferred, [error]() -> katana::Result<void> {
+          return KATANA_ERROR(error.error_code(), "{}", error);
+        });
+  }
+  std::shared_ptr<Transfer> transfer = std::move(transfer_res.value());
+  Submit(transfer, false);
+  // Deferred so that the error is made on the thread that waits for it
+  return std::async(std::launch::deferred, [transfer]() {
+    return transfer->Finish();
+  });
+}
+
+std::future<katana::Result<void>>
+tsuba::LocalStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  auto transfer_res = StartRead(uri, start, size, result_buf);
+  if (!transfer_res) {
+    katana::CopyableErrorInfo error(transfer_res.error());
+    return std::async(
+        std::launch::deferred, [error]() -> katana::Result<void> {
+          return KATANA_ERROR(error.error_code(), "{}", error);
+        });
+  }
+  std::shared_ptr<Transfer> transfer = std::move(transfer_res.value());
+  Submit(transfer, false);
+  return std::async(std::launch::deferred, [transfer]() {
+    return transfer->Finish();
+  });
 }
 
 katana::Result<void>
@@ -83,28 +490,24 @@ tsuba::LocalStorage::RemoteCopyFile(
   return katana::ResultSuccess();
 }
 
-katana::Result<void>
-tsuba::LocalStorage::ReadFile(
-    std::string uri, uint64_t start, uint64_t size, uint8_t* data) {
-  CleanUri(&uri);
-  std::ifstream ifile(uri);
-
-  ifile.seekg(start);
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to seek");
-  }
+katana::Result<std::unique_ptr<tsuba::MultipartUpload>>
+tsuba::LocalStorage::StartMultipartUpload(
+    const std::string& uri, uint64_t part_size) {
+  static std::atomic<uint64_t> next_upload{0};
 
-  ifile.read(reinterpret_cast<char*>(data), size); /* NOLINT */
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to read");
+  std::string path = uri;
+  CleanUri(&path);
+  if (auto res = CreateParentDirectories(path); !res) {
+    return res.error();
   }
-
-  // if the difference in what was read from what we wanted is less  than a
-  // block it's because the file size isn't well aligned so don't complain.
-  if (size - ifile.gcount() > kBlockSize) {
-    return ErrorCode::LocalStorageError;
+  std::string tmp_path =
+      fmt::format("{}.upload-{}-{}", path, getpid(), next_upload++);
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "creating {}", tmp_path);
   }
-  return katana::ResultSuccess();
+  return std::unique_ptr<MultipartUpload>(std::make_unique<Upload>(
+      this, std::move(path), std::move(tmp_path), fd, part_size));
 }
 
 katana::Result<void>
@@ -117,6 +520,8 @@ tsuba::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
     return katana::ResultErrno();
   }
   s_buf->size = local_s_buf.st_size;
+  s_buf->version = fmt::format(
+      "{}.{:09}", local_s_buf.st_mtim.tv_sec, local_s_buf.st_mtim.tv_nsec);
   return katana::ResultSuccess();
 }
 
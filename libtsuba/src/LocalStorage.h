@@ -5,45 +5,59 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
-#include <thread>
 
 #include "katana/Result.h"
 #include "tsuba/FileStorage.h"
 
 namespace tsuba {
 
-/// Store byte arrays to the local file system; Provided as a convenience for
-/// testing only (un-optimized)
+/// Store byte arrays to the local file system
+///
+/// Reads and writes are split into aligned chunks of a few megabytes that a
+/// pool of threads transfers in parallel with pread and pwrite, so that one
+/// large file keeps many requests in flight to the drive. The async calls
+/// return as soon as their chunks are queued, and the sync calls transfer a
+/// chunk on the calling thread while the pool does the rest. Chunks aligned
+/// to kBlockSize in the file and in memory bypass the page cache with
+/// O_DIRECT if KATANA_LOCAL_DIRECT_IO is set.
 class LocalStorage : public FileStorage {
+  class IOPool;
+  struct Transfer;
+  class Upload;
+
   void CleanUri(std::string* uri);
-  katana::Result<void> WriteFile(
-      std::string, const uint8_t* data, uint64_t size);
-  katana::Result<void> ReadFile(
+  katana::Result<std::shared_ptr<Transfer>> StartWrite(
+      std::string uri, const uint8_t* data, uint64_t size);
+  katana::Result<std::shared_ptr<Transfer>> StartRead(
       std::string uri, uint64_t start, uint64_t size, uint8_t* data);
+  /// Queue the chunks of transfer to the pool, except the first if
+  /// run_first, which runs on the calling thread
+  void Submit(const std::shared_ptr<Transfer>& transfer, bool run_first);
   katana::Result<void> RemoteCopyFile(
       std::string source_uri, std::string dest_uri, uint64_t begin,
       uint64_t size);
 
+  std::unique_ptr<IOPool> pool_;
+  bool direct_io_{false};
+
 public:
-  LocalStorage() : FileStorage("file://") {}
+  LocalStorage();
+  ~LocalStorage() override;
 
-  katana::Result<void> Init() override { return katana::ResultSuccess(); }
-  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
   katana::Result<void> Stat(const std::string& uri, StatBuf* size) override;
 
   uint32_t Priority() const override { return 1; }
 
   katana::Result<void> GetMultiSync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    return ReadFile(uri, start, size, result_buf);
-  }
+      uint8_t* result_buf) override;
 
   katana::Result<void> PutMultiSync(
-      const std::string& uri, const uint8_t* data, uint64_t size) override {
-    return WriteFile(uri, data, size);
-  }
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
 
   katana::Result<void> RemoteCopy(
       const std::string& source_uri, const std::string& dest_uri,
@@ -53,26 +67,10 @@ public:
 
   // get on future can potentially block (bulk synchronous parallel)
   std::future<katana::Result<void>> PutAsync(
-      const std::string& uri, const uint8_t* data, uint64_t size) override {
-    // No need for AsyncPut to local storage right now
-    if (auto write_res = WriteFile(uri, data, size); !write_res) {
-      return std::async(
-          [=]() -> katana::Result<void> { return write_res.error(); });
-    }
-    return std::async(
-        []() -> katana::Result<void> { return katana::ResultSuccess(); });
-  }
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
   std::future<katana::Result<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    // I suppose there is no need for AsyncGet to local storage either
-    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
-      return std::async(
-          [=]() -> katana::Result<void> { return read_res.error(); });
-    }
-    return std::async(
-        []() -> katana::Result<void> { return katana::ResultSuccess(); });
-  }
+      uint8_t* result_buf) override;
   std::future<katana::Result<void>> ListAsync(
       const std::string& uri, std::vector<std::string>* list,
       std::vector<uint64_t>* size) override;
@@ -80,6 +78,11 @@ public:
   katana::Result<void> Delete(
       const std::string& directory,
       const std::unordered_set<std::string>& files) override;
+
+  /// Parts are written to a temporary file beside the file, which replaces
+  /// it when the upload completes
+  katana::Result<std::unique_ptr<MultipartUpload>> StartMultipartUpload(
+      const std::string& uri, uint64_t part_size) override;
 };
 
 }  // namespace tsuba
@@ -0,0 +1,185 @@
+#include "MultipartTransfer.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+#include "Checksums.h"
+#include "GlobalState.h"
+#include "katana/Logging.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/IOScheduler.h"
+#include "tsuba/IOStats.h"
+#include "tsuba/file.h"
+
+namespace {
+
+using StartPartFunc = std::function<std::future<katana::Result<void>>(
+    uint32_t part, uint64_t offset, uint64_t size)>;
+
+/// Transfer the parts of size bytes of uri, keeping up to
+/// kMultipartPartsInFlight of them started and redoing those that fail
+katana::Result<void>
+TransferParts(
+    const std::string& uri, uint64_t size, const StartPartFunc& start_part) {
+  uint32_t num_parts = (size + tsuba::kMultipartPartSize - 1) /
+                       tsuba::kMultipartPartSize;
+  auto start = [&](uint32_t part) {
+    uint64_t offset = part * tsuba::kMultipartPartSize;
+    return start_part(
+        part, offset, std::min(tsuba::kMultipartPartSize, size - offset));
+  };
+
+  std::deque<std::future<katana::Result<void>>> in_flight;
+  uint32_t next = 0;
+  for (uint32_t part = 0; part < num_parts; ++part) {
+    while (next < num_parts && next - part < tsuba::kMultipartPartsInFlight) {
+      in_flight.emplace_back(start(next++));
+    }
+    auto res = tsuba::WaitForPart(
+        uri, part, std::move(in_flight.front()),
+        [&, part]() { return start(part); });
+    in_flight.pop_front();
+    if (!res) {
+      // The parts still in flight use the buffer of the caller
+      for (auto& future : in_flight) {
+        future.wait();
+      }
+      return res.error().WithContext("part {} of {}", part, num_parts);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Run transfer of size bytes of uri on the I/O scheduler. Its error is
+/// rebuilt by the thread that waits for it, since an ErrorInfo cannot pass
+/// between threads.
+std::future<katana::Result<void>>
+RunInBackground(
+    const std::string& uri, uint64_t size,
+    std::function<katana::Result<void>()> transfer) {
+  auto error = std::make_shared<std::optional<katana::CopyableErrorInfo>>();
+  auto work = tsuba::IOScheduler::Get()->Schedule<void>(
+      uri, tsuba::IOPriority::Properties, size,
+      [transfer = std::move(transfer), error]() -> katana::Result<void> {
+        if (auto res = transfer(); !res) {
+          *error = katana::CopyableErrorInfo(res.error());
+        }
+        return katana::ResultSuccess();
+      });
+  return std::async(
+      std::launch::deferred,
+      [work = std::move(work), error]() mutable -> katana::Result<void> {
+        work.wait();
+        if (*error) {
+          std::ostringstream message;
+          message << **error;
+          return katana::ErrorInfo((*error)->error_code(), message.str());
+        }
+        return katana::ResultSuccess();
+      });
+}
+
+katana::Result<void>
+MultipartGet(
+    const std::string& uri, uint8_t* result_buffer, uint64_t begin,
+    uint64_t size) {
+  // Parts go through the block cache like other reads
+  return TransferParts(
+      uri, size, [&](uint32_t, uint64_t offset, uint64_t part_size) {
+        return tsuba::FileGetAsync(
+            uri, result_buffer + offset, begin + offset, part_size);
+      });
+}
+
+}  // namespace
+
+katana::Result<void>
+tsuba::WaitForPart(
+    const std::string& uri, uint32_t part,
+    std::future<katana::Result<void>> future,
+    const std::function<std::future<katana::Result<void>>()>& restart) {
+  auto res = future.get();
+  for (uint32_t attempt = 1; !res && attempt <= kMultipartRetries;
+       ++attempt) {
+    KATANA_LOG_WARN(
+        "retrying part {} of {} ({}/{}): {}", part, uri, attempt,
+        kMultipartRetries, res.error());
+    std::this_thread::sleep_for(kMultipartRetryDelay * attempt);
+    res = restart().get();
+  }
+  return res;
+}
+
+std::future<katana::Result<void>>
+tsuba::MultipartGetAsync(
+    const std::string& uri, uint8_t* result_buffer, uint64_t begin,
+    uint64_t size) {
+  if (size < kMultipartThreshold) {
+    return FileGetAsync(uri, result_buffer, begin, size);
+  }
+  return RunInBackground(uri, size, [=]() {
+    return MultipartGet(uri, result_buffer, begin, size);
+  });
+}
+
+katana::Result<void>
+tsuba::MultipartPut(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  auto fs_res = FS(uri);
+  if (!fs_res) {
+    return fs_res.error();
+  }
+  FileStorage* fs = fs_res.value();
+  auto put = [&]() -> katana::Result<void> {
+    if (auto res = TimeIO(
+            IOOp::kPut, size,
+            [&]() { return fs->PutMultiSync(uri, data, size); });
+        !res) {
+      return res.error();
+    }
+    RecordChecksums(uri, data, size);
+    return katana::ResultSuccess();
+  };
+  if (size < kMultipartThreshold) {
+    return put();
+  }
+  auto upload_res = fs->StartMultipartUpload(uri, kMultipartPartSize);
+  if (!upload_res) {
+    return upload_res.error().WithContext("starting upload of {}", uri);
+  }
+  std::unique_ptr<MultipartUpload> upload = std::move(upload_res.value());
+  if (!upload) {
+    return put();
+  }
+
+  auto res = TransferParts(
+      uri, size, [&](uint32_t part, uint64_t offset, uint64_t part_size) {
+        return TimeIOAsync(
+            IOOp::kPut, part_size,
+            upload->PutPartAsync(part, data + offset, part_size));
+      });
+  if (!res) {
+    upload->Abort();
+    return res.error().WithContext("uploading {}", uri);
+  }
+  if (auto res = upload->Complete(); !res) {
+    return res.error();
+  }
+  RecordChecksums(uri, data, size);
+  return katana::ResultSuccess();
+}
+
+std::future<katana::Result<void>>
+tsuba::MultipartPutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  if (size < kMultipartThreshold) {
+    return FileStoreAsync(uri, data, size);
+  }
+  return RunInBackground(
+      uri, size, [=]() { return MultipartPut(uri, data, size); });
+}
@@ -0,0 +1,50 @@
+#ifndef KATANA_LIBTSUBA_MULTIPARTTRANSFER_H_
+#define KATANA_LIBTSUBA_MULTIPARTTRANSFER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <string>
+
+#include "katana/Result.h"
+
+namespace tsuba {
+
+/// Transfers of at least this many bytes are split into parts
+constexpr uint64_t kMultipartThreshold = UINT64_C(64) << 20;
+constexpr uint64_t kMultipartPartSize = UINT64_C(16) << 20;
+/// Parts of one transfer started and not yet finished
+constexpr uint32_t kMultipartPartsInFlight = 8;
+/// A failed part is redone this many times, waiting kMultipartRetryDelay
+/// longer before each
+constexpr uint32_t kMultipartRetries = 3;
+constexpr std::chrono::milliseconds kMultipartRetryDelay(200);
+
+/// Wait for part \param part of a transfer of \param uri, starting it again
+/// with \param restart if it fails, up to kMultipartRetries times
+katana::Result<void> WaitForPart(
+    const std::string& uri, uint32_t part,
+    std::future<katana::Result<void>> future,
+    const std::function<std::future<katana::Result<void>>()>& restart);
+
+/// Like FileGetAsync, but a large read is an op of the I/O scheduler, split
+/// into ranged reads of kMultipartPartSize, run concurrently and redone if
+/// they fail
+std::future<katana::Result<void>> MultipartGetAsync(
+    const std::string& uri, uint8_t* result_buffer, uint64_t begin,
+    uint64_t size);
+
+/// Like FileStore, but a large write to a backend that supports multipart
+/// uploads is put as parts of kMultipartPartSize, run concurrently and redone
+/// if they fail
+katana::Result<void> MultipartPut(
+    const std::string& uri, const uint8_t* data, uint64_t size);
+
+/// MultipartPut as an op of the I/O scheduler; data must outlive the future
+std::future<katana::Result<void>> MultipartPutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size);
+
+}  // namespace tsuba
+
+#endif
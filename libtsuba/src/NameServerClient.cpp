@@ -1,9 +1,24 @@
 #include "tsuba/NameServerClient.h"
 
 #include "GlobalState.h"
+#include "RDGMeta.h"
 
 tsuba::NameServerClient::~NameServerClient() = default;
 
+katana::Result<bool>
+tsuba::NameServerClient::GetIfChanged(
+    const katana::Uri& rdg_name, uint64_t known_version, RDGMeta* meta) {
+  auto meta_res = Get(rdg_name);
+  if (!meta_res) {
+    return meta_res.error();
+  }
+  if (meta_res.value().version() == known_version) {
+    return false;
+  }
+  *meta = std::move(meta_res.value());
+  return true;
+}
+
 void
 tsuba::SetMakeNameServerClientCB(
     std::function<katana::Result<std::unique_ptr<tsuba::NameServerClient>>()>
@@ -1,14 +1,21 @@
 #include "tsuba/ParquetReader.h"
 
+#include <future>
 #include <limits>
 #include <memory>
+#include <numeric>
+#include <thread>
 #include <unordered_map>
 
 #include <arrow/chunked_array.h>
 #include <arrow/type.h>
+#include <parquet/metadata.h>
+#include <parquet/statistics.h>
 
+#include "katana/ArrowInterchange.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
+#include "tsuba/IOStats.h"
 
 template <typename T>
 using Result = katana::Result<T>;
@@ -72,8 +79,8 @@ HandleBadParquetTypes(std::shared_ptr<arrow::ChunkedArray> old_array) {
 
 Result<std::unique_ptr<parquet::arrow::FileReader>>
 MakeFileReader(
-    const katana::Uri& uri, uint64_t preload_start, uint64_t preload_end,
-    std::shared_ptr<tsuba::FileView>* fv_ptr = nullptr) {
+    const katana::Uri& uri, arrow::MemoryPool* pool, uint64_t preload_start,
+    uint64_t preload_end, std::shared_ptr<tsuba::FileView>* fv_ptr = nullptr) {
   auto fv = std::make_shared<tsuba::FileView>(tsuba::FileView());
   if (auto res = fv->Bind(uri.string(), preload_start, preload_end, false);
       !res) {
@@ -83,7 +90,7 @@ MakeFileReader(
   std::unique_ptr<parquet::arrow::FileReader> reader;
 
   auto open_file_result =
-      parquet::arrow::OpenFile(fv, arrow::default_memory_pool(), &reader);
+      parquet::arrow::OpenFile(fv, pool, &reader);
   if (!open_file_result.ok()) {
     return KATANA_ERROR(
         ErrorCode::ArrowError, "arrow error: {}", open_file_result);
@@ -95,12 +102,84 @@ MakeFileReader(
   return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
 }
 
+/// Get the [min, max] of a column chunk as doubles if its statistics allow
+std::optional<std::pair<double, double>>
+StatisticsRange(const parquet::ColumnChunkMetaData& column) {
+  std::shared_ptr<parquet::Statistics> stats = column.statistics();
+  if (!stats || !stats->HasMinMax()) {
+    return std::nullopt;
+  }
+  bool is_unsigned =
+      stats->descr()->sort_order() == parquet::SortOrder::UNSIGNED;
+
+  switch (stats->physical_type()) {
+  case parquet::Type::BOOLEAN: {
+    auto typed = std::static_pointer_cast<parquet::BoolStatistics>(stats);
+    return std::pair<double, double>(typed->min(), typed->max());
+  }
+  case parquet::Type::INT32: {
+    auto typed = std::static_pointer_cast<parquet::Int32Statistics>(stats);
+    if (is_unsigned) {
+      return std::pair<double, double>(
+          static_cast<uint32_t>(typed->min()),
+          static_cast<uint32_t>(typed->max()));
+    }
+    return std::pair<double, double>(typed->min(), typed->max());
+  }
+  case parquet::Type::INT64: {
+    auto typed = std::static_pointer_cast<parquet::Int64Statistics>(stats);
+    if (is_unsigned) {
+      return std::pair<double, double>(
+          static_cast<uint64_t>(typed->min()),
+          static_cast<uint64_t>(typed->max()));
+    }
+    return std::pair<double, double>(typed->min(), typed->max());
+  }
+  case parquet::Type::FLOAT: {
+    auto typed = std::static_pointer_cast<parquet::FloatStatistics>(stats);
+    return std::pair<double, double>(typed->min(), typed->max());
+  }
+  case parquet::Type::DOUBLE: {
+    auto typed = std::static_pointer_cast<parquet::DoubleStatistics>(stats);
+    return std::pair<double, double>(typed->min(), typed->max());
+  }
+  default:
+    return std::nullopt;
+  }
+}
+
+/// \returns the table read by \param read, recorded as a ParquetRead of
+///     its bytes
+template <typename F>
+Result<std::shared_ptr<arrow::Table>>
+TimeRead(F read) {
+  tsuba::IOTimer timer(tsuba::IOOp::kParquetRead);
+  Result<std::shared_ptr<arrow::Table>> res = read();
+  if (res) {
+    timer.AddBytes(katana::ApproxTableMemUse(res.value()));
+  }
+  timer.Stop(res.has_value());
+  return res;
+}
+
 }  // namespace
 
 Result<std::unique_ptr<tsuba::ParquetReader>>
 tsuba::ParquetReader::Make(ReadOpts opts) {
-  return std::unique_ptr<ParquetReader>(
-      new ParquetReader(opts.slice, opts.make_cannonical));
+  if (opts.slice && opts.row_ranges) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "slice and row_ranges cannot be used together");
+  }
+  uint32_t num_threads = opts.num_threads;
+  if (num_threads == 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  arrow::MemoryPool* pool =
+      opts.memory_pool ? opts.memory_pool : arrow::default_memory_pool();
+  return std::unique_ptr<ParquetReader>(new ParquetReader(
+      opts.slice, std::move(opts.row_ranges), num_threads, pool,
+      opts.make_cannonical));
 }
 
 // Internal use only, invoke iff slice_ has a value
@@ -114,7 +193,7 @@ tsuba::ParquetReader::ReadFromUriSliced(const katana::Uri& uri) {
   }
 
   std::shared_ptr<FileView> fv;
-  auto reader_res = MakeFileReader(uri, 0, 0, &fv);
+  auto reader_res = MakeFileReader(uri, pool_, 0, 0, &fv);
   if (!reader_res) {
     return reader_res.error();
   }
@@ -158,22 +237,226 @@ tsuba::ParquetReader::ReadFromUriSliced(const katana::Uri& uri) {
   return FixTable(std::move(out));
 }
 
+// Internal use only, invoke iff row_ranges_ has a value
+Result<std::shared_ptr<arrow::Table>>
+tsuba::ParquetReader::ReadFromUriRanges(const katana::Uri& uri) {
+  auto reader_res = MakeFileReader(uri, pool_, 0, 0);
+  if (!reader_res) {
+    return reader_res.error();
+  }
+  std::unique_ptr<parquet::arrow::FileReader> reader(
+      std::move(reader_res.value()));
+
+  std::shared_ptr<arrow::Schema> schema;
+  if (auto status = reader->GetSchema(&schema); !status.ok()) {
+    return KATANA_ERROR(ErrorCode::ArrowError, "reading schema: {}", status);
+  }
+
+  std::shared_ptr<parquet::FileMetaData> md =
+      reader->parquet_reader()->metadata();
+  int rg_count = reader->num_row_groups();
+  std::vector<int64_t> rg_starts;
+  int64_t num_rows = 0;
+  for (int i = 0; i < rg_count; ++i) {
+    rg_starts.emplace_back(num_rows);
+    num_rows += md->RowGroup(i)->num_rows();
+  }
+
+  std::vector<arrow::ArrayVector> chunks(schema->num_fields());
+  auto append_nulls = [&](int64_t length) -> Result<void> {
+    for (int c = 0, n = schema->num_fields(); c < n; ++c) {
+      auto nulls_res = arrow::MakeArrayOfNull(schema->field(c)->type(), length);
+      if (!nulls_res.ok()) {
+        return KATANA_ERROR(
+            ErrorCode::ArrowError, "making nulls: {}", nulls_res.status());
+      }
+      chunks[c].emplace_back(std::move(nulls_res.ValueOrDie()));
+    }
+    return katana::ResultSuccess();
+  };
+
+  int64_t cursor = 0;
+  for (const Slice& range : row_ranges_.value()) {
+    int64_t begin = std::min(range.offset, num_rows);
+    int64_t end = std::min(range.offset + range.length, num_rows);
+    if (range.offset < cursor || range.length < 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "row ranges must be sorted, disjoint and non-negative");
+    }
+    if (begin == end) {
+      continue;
+    }
+    if (begin > cursor) {
+      if (auto res = append_nulls(begin - cursor); !res) {
+        return res.error();
+      }
+    }
+
+    std::vector<int> row_groups;
+    for (int i = 0; i < rg_count; ++i) {
+      int64_t rg_end = rg_starts[i] + md->RowGroup(i)->num_rows();
+      if (rg_starts[i] < end && rg_end > begin) {
+        row_groups.emplace_back(i);
+      }
+    }
+    std::shared_ptr<arrow::Table> rows;
+    if (auto status = reader->ReadRowGroups(row_groups, &rows); !status.ok()) {
+      return KATANA_ERROR(ErrorCode::ArrowError, "arrow error: {}", status);
+    }
+    rows = rows->Slice(begin - rg_starts[row_groups.front()], end - begin);
+    for (int c = 0, n = schema->num_fields(); c < n; ++c) {
+      const arrow::ArrayVector& col_chunks = rows->column(c)->chunks();
+      chunks[c].insert(chunks[c].end(), col_chunks.begin(), col_chunks.end());
+    }
+    cursor = end;
+  }
+  if (cursor < num_rows) {
+    if (auto res = append_nulls(num_rows - cursor); !res) {
+      return res.error();
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int c = 0, n = schema->num_fields(); c < n; ++c) {
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        std::move(chunks[c]), schema->field(c)->type()));
+  }
+  return FixTable(arrow::Table::Make(schema, columns, num_rows));
+}
+
+// Internal use only, decode contiguous runs of row groups in parallel tasks
+Result<std::shared_ptr<arrow::Table>>
+tsuba::ParquetReader::ReadRowGroupsParallel(
+    const katana::Uri& uri, int num_row_groups, int num_tasks) {
+  std::vector<std::future<Result<std::shared_ptr<arrow::Table>>>> futures;
+  for (int task = 0; task < num_tasks; ++task) {
+    int begin = static_cast<int64_t>(num_row_groups) * task / num_tasks;
+    int end = static_cast<int64_t>(num_row_groups) * (task + 1) / num_tasks;
+    futures.emplace_back(std::async(
+        std::launch::async,
+        [uri, begin, end,
+         pool = pool_]() -> Result<std::shared_ptr<arrow::Table>> {
+          // FileView and FileReader are not thread-safe so every task needs
+          // its own
+          auto reader_res = MakeFileReader(uri, pool, 0, 0);
+          if (!reader_res) {
+            return reader_res.error();
+          }
+          std::vector<int> row_groups(end - begin);
+          std::iota(row_groups.begin(), row_groups.end(), begin);
+          std::shared_ptr<arrow::Table> out;
+          if (auto status = reader_res.value()->ReadRowGroups(row_groups, &out);
+              !status.ok()) {
+            return KATANA_ERROR(
+                ErrorCode::ArrowError, "reading row groups [{}, {}): {}", begin,
+                end, status);
+          }
+          return out;
+        }));
+  }
+
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  Result<void> ret = katana::ResultSuccess();
+  for (auto& future : futures) {
+    // wait for every task, even after an error, so none outlive this call
+    auto res = future.get();
+    if (!res) {
+      if (ret) {
+        ret = res.error();
+      }
+      continue;
+    }
+    tables.emplace_back(std::move(res.value()));
+  }
+  if (!ret) {
+    return ret.error();
+  }
+
+  auto concat_res = arrow::ConcatenateTables(tables);
+  if (!concat_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "concatenating row groups: {}",
+        concat_res.status());
+  }
+  return FixTable(std::move(concat_res.ValueOrDie()));
+}
+
+Result<std::vector<tsuba::ParquetReader::Slice>>
+tsuba::ParquetReader::FindCandidateRows(
+    const katana::Uri& uri, int32_t column_idx, double min, double max) {
+  auto reader_res = MakeFileReader(uri, pool_, 0, 0);
+  if (!reader_res) {
+    return reader_res.error();
+  }
+  std::unique_ptr<parquet::arrow::FileReader> reader(
+      std::move(reader_res.value()));
+
+  std::shared_ptr<parquet::FileMetaData> md =
+      reader->parquet_reader()->metadata();
+  if (column_idx < 0 || column_idx >= md->num_columns()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "column index {} should be less than the number of columns {}",
+        column_idx, md->num_columns());
+  }
+
+  std::vector<Slice> candidates;
+  int64_t row_offset = 0;
+  for (int i = 0, rg_count = md->num_row_groups(); i < rg_count; ++i) {
+    std::unique_ptr<parquet::RowGroupMetaData> rg_md = md->RowGroup(i);
+    int64_t num_rows = rg_md->num_rows();
+    auto range = StatisticsRange(*rg_md->ColumnChunk(column_idx));
+    bool may_match = !range || (range->first <= max && range->second >= min);
+    if (may_match && num_rows > 0) {
+      if (!candidates.empty() &&
+          candidates.back().offset + candidates.back().length == row_offset) {
+        candidates.back().length += num_rows;
+      } else {
+        candidates.emplace_back(
+            Slice{.offset = row_offset, .length = num_rows});
+      }
+    }
+    row_offset += num_rows;
+  }
+  return candidates;
+}
+
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadTable(const katana::Uri& uri) {
+  return TimeRead([&]() { return ReadWholeTable(uri); });
+}
+
+Result<std::shared_ptr<arrow::Table>>
+tsuba::ParquetReader::ReadWholeTable(const katana::Uri& uri) {
   if (slice_) {
     // logic for a sliced read is different enough not to bother trying
     // to DRY these out
     return ReadFromUriSliced(uri);
   }
+  if (row_ranges_) {
+    return ReadFromUriRanges(uri);
+  }
 
-  auto reader_res =
-      MakeFileReader(uri, 0, std::numeric_limits<uint64_t>::max());
+  std::shared_ptr<FileView> fv;
+  auto reader_res = MakeFileReader(uri, pool_, 0, 0, &fv);
   if (!reader_res) {
     return reader_res.error();
   }
   std::unique_ptr<parquet::arrow::FileReader> reader(
       std::move(reader_res.value()));
 
+  int rg_count = reader->num_row_groups();
+  int num_tasks = std::min<int64_t>(rg_count, num_threads_);
+  if (num_tasks > 1) {
+    return ReadRowGroupsParallel(uri, rg_count, num_tasks);
+  }
+
+  if (auto res = fv->Fill(0, std::numeric_limits<uint64_t>::max(), false);
+      !res) {
+    return res.error();
+  }
+
   std::shared_ptr<arrow::Table> out;
   auto read_result = reader->ReadTable(&out);
   if (!read_result.ok()) {
@@ -192,6 +475,11 @@ tsuba::ParquetReader::DoFilteredTableRead(
         ErrorCode::NotImplemented,
         "sorry! missing support for sliced read when choosing columns");
   }
+  if (row_ranges_) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "missing support for row ranges when choosing columns");
+  }
 
   std::vector<std::shared_ptr<arrow::Field>> fields;
   std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
@@ -226,45 +514,33 @@ tsuba::ParquetReader::DoFilteredTableRead(
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadColumn(const katana::Uri& uri, int32_t column_idx) {
-  auto reader_res = MakeFileReader(uri, 0, 0);
-  if (!reader_res) {
-    return reader_res.error();
-  }
-  std::unique_ptr<parquet::arrow::FileReader> reader(
-      std::move(reader_res.value()));
-
-  std::shared_ptr<arrow::Schema> schema;
-  auto status = reader->GetSchema(&schema);
-  if (!status.ok()) {
-    return KATANA_ERROR(ErrorCode::ArrowError, "reading schema: {}", status);
-  }
-
-  return DoFilteredTableRead(
-      reader.get(), *schema, std::vector<int32_t>{column_idx});
+  return ReadTable(uri, std::vector<int32_t>{column_idx});
 }
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadTable(
     const katana::Uri& uri, const std::vector<int32_t>& column_indexes) {
-  auto reader_res = MakeFileReader(uri, 0, 0);
-  if (!reader_res) {
-    return reader_res.error();
-  }
-  std::unique_ptr<parquet::arrow::FileReader> reader(
-      std::move(reader_res.value()));
+  return TimeRead([&]() -> Result<std::shared_ptr<arrow::Table>> {
+    auto reader_res = MakeFileReader(uri, pool_, 0, 0);
+    if (!reader_res) {
+      return reader_res.error();
+    }
+    std::unique_ptr<parquet::arrow::FileReader> reader(
+        std::move(reader_res.value()));
 
-  std::shared_ptr<arrow::Schema> schema;
-  auto status = reader->GetSchema(&schema);
-  if (!status.ok()) {
-    return KATANA_ERROR(ErrorCode::ArrowError, "reading schema: {}", status);
-  }
+    std::shared_ptr<arrow::Schema> schema;
+    auto status = reader->GetSchema(&schema);
+    if (!status.ok()) {
+      return KATANA_ERROR(ErrorCode::ArrowError, "reading schema: {}", status);
+    }
 
-  return DoFilteredTableRead(reader.get(), *schema, column_indexes);
+    return DoFilteredTableRead(reader.get(), *schema, column_indexes);
+  });
 }
 
 Result<int32_t>
 tsuba::ParquetReader::NumColumns(const katana::Uri& uri) {
-  auto reader_res = MakeFileReader(uri, 0, 0);
+  auto reader_res = MakeFileReader(uri, pool_, 0, 0);
   if (!reader_res) {
     return reader_res.error();
   }
@@ -275,7 +551,7 @@ tsuba::ParquetReader::NumColumns(const katana::Uri& uri) {
 
 Result<int64_t>
 tsuba::ParquetReader::NumRows(const katana::Uri& uri) {
-  auto reader_res = MakeFileReader(uri, 0, 0);
+  auto reader_res = MakeFileReader(uri, pool_, 0, 0);
   if (!reader_res) {
     return reader_res.error();
   }
@@ -285,6 +561,33 @@ tsuba::ParquetReader::NumRows(const katana::Uri& uri) {
   return reader->parquet_reader()->metadata()->num_rows();
 }
 
+Result<std::shared_ptr<arrow::Schema>>
+tsuba::ParquetReader::ReadSchema(const katana::Uri& uri) {
+  auto reader_res = MakeFileReader(uri, pool_, 0, 0);
+  if (!reader_res) {
+    return reader_res.error();
+  }
+  std::unique_ptr<parquet::arrow::FileReader> reader(
+      std::move(reader_res.value()));
+
+  std::shared_ptr<arrow::Schema> schema;
+  if (auto status = reader->GetSchema(&schema); !status.ok()) {
+    return KATANA_ERROR(ErrorCode::ArrowError, "reading schema: {}", status);
+  }
+  if (!make_cannonical_) {
+    return schema;
+  }
+  // The types of HandleBadParquetTypes
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (const auto& field : schema->fields()) {
+    fields.emplace_back(
+        field->type()->id() == arrow::Type::STRING
+            ? field->WithType(arrow::large_utf8())
+            : field);
+  }
+  return arrow::schema(fields);
+}
+
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::FixTable(std::shared_ptr<arrow::Table>&& _table) {
   std::shared_ptr<arrow::Table> table(std::move(_table));
@@ -323,7 +626,7 @@ tsuba::ParquetReader::FixTable(std::shared_ptr<arrow::Table>&& _table) {
   // combined into a single chunk due to the fact the offset type for these
   // columns is int32_t and thus the maximum size of an arrow::Array for these
   // types is 2^31.
-  auto combine_result = table->CombineChunks(arrow::default_memory_pool());
+  auto combine_result = table->CombineChunks(pool_);
   if (!combine_result.ok()) {
     return KATANA_ERROR(
         ErrorCode::ArrowError, "arrow error: {}", combine_result.status());
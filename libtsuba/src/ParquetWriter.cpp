@@ -1,13 +1,22 @@
 #include "tsuba/ParquetWriter.h"
 
+#include <unordered_set>
+
+#include <arrow/util/compression.h>
+
+#include "UploadStream.h"
 #include "katana/ArrowInterchange.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FaultTest.h"
+#include "tsuba/IOScheduler.h"
+#include "tsuba/IOStats.h"
 
 template <typename T>
 using Result = katana::Result<T>;
 
+using ColumnOpts = tsuba::ParquetWriter::WriteOpts::ColumnOpts;
+
 namespace {
 
 // constant taken directly from the arrow docs
@@ -135,6 +144,80 @@ EstimateRowSize(const std::shared_ptr<arrow::Table>& table) {
 
 constexpr uint64_t kMB = 1UL << 20;
 
+/// Values sampled to choose the options of a column
+constexpr int64_t kCardinalitySample = 1 << 16;
+/// Columns with fewer distinct values than this share of the sample are
+/// dictionary encoded
+constexpr double kDictionaryCardinality = 0.1;
+/// ZSTD levels of inferred options: strings compress well enough to be worth
+/// a slower level, numbers less so
+constexpr int kStringZstdLevel = 3;
+constexpr int kNumericZstdLevel = 1;
+
+/// The share of distinct values among a sample of the valid values of column
+double
+SampledCardinality(const arrow::ChunkedArray& column) {
+  int64_t stride =
+      std::max<int64_t>(1, column.length() / kCardinalitySample);
+  std::unordered_set<std::string> distinct;
+  int64_t sampled = 0;
+  int64_t index = 0;
+  for (const auto& chunk : column.chunks()) {
+    // The first index of this chunk that falls on the stride
+    int64_t i = (stride - index % stride) % stride;
+    for (; i < chunk->length(); i += stride) {
+      if (chunk->IsNull(i)) {
+        continue;
+      }
+      auto scalar_res = chunk->GetScalar(i);
+      if (!scalar_res.ok()) {
+        return 1;
+      }
+      distinct.emplace(scalar_res.ValueOrDie()->ToString());
+      ++sampled;
+    }
+    index += chunk->length();
+  }
+  if (sampled == 0) {
+    return 1;
+  }
+  return static_cast<double>(distinct.size()) / sampled;
+}
+
+/// Options for column: dictionaries if its values repeat, and ZSTD at a level
+/// that suits its type
+ColumnOpts
+InferColumnOpts(const arrow::ChunkedArray& column) {
+  ColumnOpts opts;
+  opts.compression = arrow::Compression::ZSTD;
+  arrow::Type::type id = column.type()->id();
+  if (id == arrow::Type::DICTIONARY) {
+    opts.compression_level = kStringZstdLevel;
+    return opts;
+  }
+  if (id == arrow::Type::BOOL) {
+    // Booleans are bit packed already
+    opts.compression_level = kNumericZstdLevel;
+    opts.dictionary = false;
+    return opts;
+  }
+  bool is_string =
+      arrow::is_binary_like(id) || arrow::is_large_binary_like(id);
+  if (!is_string && !arrow::is_primitive(id)) {
+    opts.compression_level = kNumericZstdLevel;
+    return opts;
+  }
+
+  opts.compression_level = is_string ? kStringZstdLevel : kNumericZstdLevel;
+  opts.dictionary = SampledCardinality(column) < kDictionaryCardinality;
+  // Splitting the bytes of floats makes them compress better
+  if (!opts.dictionary &&
+      (id == arrow::Type::FLOAT || id == arrow::Type::DOUBLE)) {
+    opts.encoding = parquet::Encoding::BYTE_STREAM_SPLIT;
+  }
+  return opts;
+}
+
 std::vector<std::shared_ptr<arrow::Table>>
 BlockTable(std::shared_ptr<arrow::Table> table, uint64_t mbs_per_block) {
   if (table->num_rows() <= 1) {
@@ -174,6 +257,11 @@ tsuba::ParquetWriter::Make(
 Result<std::unique_ptr<tsuba::ParquetWriter>>
 tsuba::ParquetWriter::Make(
     std::shared_ptr<arrow::Table> table, WriteOpts opts) {
+  if (opts.rows_per_row_group <= 0) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::InvalidArgument,
+        "rows_per_row_group must be positive");
+  }
   if (!opts.write_blocked) {
     return std::unique_ptr<ParquetWriter>(
         new ParquetWriter({std::move(table)}, opts));
@@ -193,11 +281,50 @@ tsuba::ParquetWriter::WriteToUri(const katana::Uri& uri, WriteGroup* group) {
 }
 
 std::shared_ptr<parquet::WriterProperties>
-tsuba::ParquetWriter::StandardWriterProperties() {
-  return parquet::WriterProperties::Builder()
-      .version(opts_.parquet_version)
-      ->data_page_version(opts_.data_page_version)
-      ->build();
+tsuba::ParquetWriter::WriterProperties(
+    const WriteOpts& opts, const arrow::Table& table) {
+  parquet::WriterProperties::Builder builder;
+  builder.version(opts.parquet_version)
+      ->data_page_version(opts.data_page_version)
+      ->max_row_group_length(opts.rows_per_row_group);
+
+  for (int i = 0, num_columns = table.num_columns(); i < num_columns; ++i) {
+    const std::string& name = table.field(i)->name();
+    // The leaves of nested columns have paths of their own and get the
+    // defaults
+    if (table.field(i)->type()->num_fields() > 0) {
+      continue;
+    }
+    ColumnOpts column_opts;
+    if (auto it = opts.column_opts.find(name); it != opts.column_opts.end()) {
+      column_opts = it->second;
+    } else if (opts.infer_column_opts) {
+      column_opts = InferColumnOpts(*table.column(i));
+    }
+
+    if (!arrow::util::Codec::IsAvailable(column_opts.compression)) {
+      KATANA_LOG_DEBUG(
+          "codec {} is not available, not compressing {}",
+          arrow::util::Codec::GetCodecAsString(column_opts.compression),
+          name);
+      column_opts.compression = arrow::Compression::UNCOMPRESSED;
+    }
+    builder.compression(name, column_opts.compression);
+    if (column_opts.compression_level != WriteOpts::kDefaultCompressionLevel) {
+      builder.compression_level(name, column_opts.compression_level);
+    }
+    if (column_opts.dictionary) {
+      builder.enable_dictionary(name);
+    } else {
+      builder.disable_dictionary(name);
+    }
+    // The dictionary encodings follow from dictionary
+    if (column_opts.encoding != parquet::Encoding::PLAIN_DICTIONARY &&
+        column_opts.encoding != parquet::Encoding::RLE_DICTIONARY) {
+      builder.encoding(name, column_opts.encoding);
+    }
+  }
+  return builder.build();
 }
 
 std::shared_ptr<parquet::ArrowWriterProperties>
@@ -210,38 +337,55 @@ katana::Result<void>
 tsuba::ParquetWriter::StoreParquet(
     std::shared_ptr<arrow::Table> table, const katana::Uri& uri,
     tsuba::WriteGroup* desc) {
-  auto ff = std::make_shared<tsuba::FileFrame>();
-  if (auto res = ff->Init(); !res) {
-    return res.error().WithContext("creating output buffer");
-  }
-  ff->Bind(uri.string());
-  auto future = std::async(
-      std::launch::async,
-      [table = std::move(table), ff = std::move(ff), desc,
-       writer_props = StandardWriterProperties(),
+  // A FileFrame holds the encoded table until it is stored, while an upload
+  // holds a few parts
+  uint64_t bytes = katana::ApproxTableMemUse(table);
+  uint64_t held =
+      bytes >= tsuba::kStreamingThreshold ? tsuba::kStreamingBytes : bytes;
+  auto future = IOScheduler::Get()->Schedule<void>(
+      uri.string(), IOPriority::Properties, held,
+      [table = std::move(table), path = uri.string(), bytes,
+       opts = opts_,
        arrow_props =
            StandardArrowProperties()]() mutable -> katana::Result<void> {
-        auto res = HandleBadParquetTypes(table);
-        if (!res) {
-          return res.error().WithContext(
-              "conversion from arrow to parquet mismatch");
-        }
-        table = std::move(res.value());
-        auto write_result = parquet::arrow::WriteTable(
-            *table, arrow::default_memory_pool(), ff,
-            std::numeric_limits<int64_t>::max(), writer_props, arrow_props);
-        table.reset();
-
-        if (!write_result.ok()) {
-          return KATANA_ERROR(
-              tsuba::ErrorCode::ArrowError, "arrow error: {}", write_result);
-        }
-        if (desc) {
-          desc->AddToOutstanding(ff->map_size());
-        }
-
-        TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
-        return ff->Persist();
+        // The encoding is timed with the storing, into which it streams
+        return tsuba::TimeIO(
+            tsuba::IOOp::kParquetWrite, bytes, [&]() -> katana::Result<void> {
+              auto res = HandleBadParquetTypes(table);
+              if (!res) {
+                return res.error().WithContext(
+                    "conversion from arrow to parquet mismatch");
+              }
+              table = std::move(res.value());
+              auto writer_props = WriterProperties(opts, *table);
+              auto sink_res = tsuba::MakeStoreStream(path, bytes);
+              if (!sink_res) {
+                return sink_res.error();
+              }
+              std::shared_ptr<arrow::io::OutputStream> sink =
+                  std::move(sink_res.value());
+              // Writers throw for encodings that do not suit a column's type
+              arrow::Status write_result;
+              try {
+                write_result = parquet::arrow::WriteTable(
+                    *table, arrow::default_memory_pool(), sink,
+                    opts.rows_per_row_group, writer_props, arrow_props);
+              } catch (const std::exception& exp) {
+                return KATANA_ERROR(
+                    tsuba::ErrorCode::ArrowError, "arrow exception: {}",
+                    exp.what());
+              }
+              table.reset();
+
+              if (!write_result.ok()) {
+                return KATANA_ERROR(
+                    tsuba::ErrorCode::ArrowError, "arrow error: {}",
+                    write_result);
+              }
+
+              TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
+              return tsuba::FinishStoreStream(sink.get());
+            });
       });
 
   if (!desc) {
@@ -1,10 +1,15 @@
 #include "tsuba/RDG.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <exception>
 #include <fstream>
+#include <limits>
 #include <memory>
 #include <regex>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <arrow/chunked_array.h>
@@ -23,12 +28,14 @@
 #include "GlobalState.h"
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
+#include "SharedCache.h"
 #include "katana/ArrowInterchange.h"
 #include "katana/Backtrace.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "katana/Uri.h"
+#include "tsuba/ArrowIPCWriter.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FaultTest.h"
 #include "tsuba/ParquetWriter.h"
@@ -52,6 +59,33 @@ const char* kDeprecatedLocalToGlobalIDPropName = "local_to_global_vector";
 const char* kDeprecatedHostToOwnedGlobalNodeIDsPropName =
     "host_to_owned_global_ids";
 
+// A topology is scanned in steps of kTopologyScanStep bytes with a window
+// of kTopologyReadahead bytes fetched ahead, so that later pages are read
+// from storage while earlier ones are verified
+constexpr uint64_t kTopologyScanStep = UINT64_C(16) << 20;
+constexpr uint64_t kTopologyReadahead = UINT64_C(64) << 20;
+
+/// Bind fv to all of the file path like FileView::Bind(path, true), but
+/// through the readahead window of fv
+katana::Result<void>
+BindTopology(tsuba::FileView* fv, const std::string& path) {
+  // Only a file bound in one piece is published to the shared cache
+  if (tsuba::SharedCache::Get()) {
+    return fv->Bind(path, true);
+  }
+  if (auto res = fv->Bind(path, 0, kTopologyScanStep, false); !res) {
+    return res.error();
+  }
+  fv->set_readahead(kTopologyReadahead);
+  for (uint64_t offset = kTopologyScanStep; fv->frontier() < fv->size();
+       offset += kTopologyScanStep) {
+    if (auto res = fv->AdvanceFrontier(offset); !res) {
+      return res.error().WithContext("scanning {}", path);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 std::string
 MirrorPropName(unsigned i) {
   return std::string(kMirrorNodesPropName) + "_" + std::to_string(i);
@@ -65,14 +99,24 @@ MasterPropName(unsigned i) {
 katana::Result<std::string>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const katana::Uri& dir,
-    const std::string& name, tsuba::WriteGroup* desc) {
-  auto writer_res = tsuba::ParquetWriter::Make(array, name);
-  if (!writer_res) {
-    return writer_res.error().WithContext("making property writer");
-  }
-
+    const std::string& name, tsuba::WriteGroup* desc,
+    const tsuba::ParquetWriter::WriteOpts& opts,
+    tsuba::PropFormat format = tsuba::PropFormat::Parquet) {
   katana::Uri new_path = dir.RandFile(name);
-  auto res = writer_res.value()->WriteToUri(new_path, desc);
+  katana::Result<void> res = katana::ResultSuccess();
+  if (format == tsuba::PropFormat::ArrowIPC) {
+    auto writer_res = tsuba::ArrowIPCWriter::Make(array, name);
+    if (!writer_res) {
+      return writer_res.error().WithContext("making property writer");
+    }
+    res = writer_res.value()->WriteToUri(new_path, desc);
+  } else {
+    auto writer_res = tsuba::ParquetWriter::Make(array, name, opts);
+    if (!writer_res) {
+      return writer_res.error().WithContext("making property writer");
+    }
+    res = writer_res.value()->WriteToUri(new_path, desc);
+  }
   if (!res) {
     return res.error().WithContext("writing property writer");
   }
@@ -83,21 +127,26 @@ katana::Result<std::vector<tsuba::PropStorageInfo>>
 WriteProperties(
     const arrow::Table& props,
     const std::vector<tsuba::PropStorageInfo>& prop_info,
-    const katana::Uri& dir, tsuba::WriteGroup* desc) {
+    const katana::Uri& dir, tsuba::WriteGroup* desc,
+    const tsuba::ParquetWriter::WriteOpts& opts) {
   const auto& schema = props.schema();
 
-  std::vector<std::string> next_paths;
+  std::vector<std::pair<std::string, tsuba::PropFormat>> next_paths;
   for (size_t i = 0, n = prop_info.size(); i < n; ++i) {
     if (!prop_info[i].persist || !prop_info[i].path.empty()) {
       continue;
     }
     auto name = prop_info[i].name.empty() ? schema->field(i)->name()
                                           : prop_info[i].name;
-    auto name_res = StoreArrowArrayAtName(props.column(i), dir, name, desc);
+    tsuba::PropFormat format = opts.arrow_ipc_properties.count(name) > 0
+                                   ? tsuba::PropFormat::ArrowIPC
+                                   : tsuba::PropFormat::Parquet;
+    auto name_res = StoreArrowArrayAtName(
+        props.column(i), dir, name, desc, opts, format);
     if (!name_res) {
       return name_res.error().WithContext("storing arrow array");
     }
-    next_paths.emplace_back(name_res.value());
+    next_paths.emplace_back(name_res.value(), format);
   }
   TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
 
@@ -109,42 +158,86 @@ WriteProperties(
   auto it = next_paths.begin();
   for (auto& v : next_properties) {
     if (v.persist && v.path.empty()) {
-      v.path = *it++;
+      std::tie(v.path, v.format) = *it++;
     }
   }
 
   return next_properties;
 }
 
+/// \returns true on every host if ok is true on every host
+bool
+AllHostsOk(bool ok) {
+  auto min_res = tsuba::Comm()->AllReduce(
+      static_cast<uint32_t>(ok ? 1 : 0), katana::CommReduceOp::kMin);
+  if (!min_res) {
+    KATANA_LOG_ERROR("agreeing on the outcome of a store: {}", min_res.error());
+    return false;
+  }
+  return min_res.value() == 1;
+}
+
+/// Delete the files that desc wrote for a store that did not commit. They
+/// have new names, so no committed version references them.
+void
+RollBack(const tsuba::WriteGroup& desc) {
+  std::unordered_map<std::string, std::unordered_set<std::string>> by_dir;
+  for (const std::string& file : desc.files()) {
+    auto uri_res = katana::Uri::Make(file);
+    if (!uri_res) {
+      KATANA_LOG_WARN("not rolling back {}: {}", file, uri_res.error());
+      continue;
+    }
+    by_dir[uri_res.value().DirName().string()].emplace(
+        uri_res.value().BaseName());
+  }
+  for (const auto& [dir, files] : by_dir) {
+    if (auto res = tsuba::FileDelete(dir, files); !res) {
+      KATANA_LOG_WARN("rolling back the files of a store: {}", res.error());
+    }
+  }
+}
+
+/// Commit the files of a store of every host as the next version of the
+/// RDG in two phases. First, every host waits for its writes, which all
+/// hosts run concurrently, and the hosts agree whether every one wrote all
+/// of its files (started is false if this host failed to start them).
+/// Then host 0 stores the RDGMeta of the new version, which publishes the
+/// version at once as it names the part headers of all hosts, and the name
+/// server moves to it. If a host fails before the RDGMeta is stored, every
+/// host deletes the files it wrote and the previous version stays the
+/// latest.
 katana::Result<void>
 CommitRDG(
     tsuba::RDGHandle handle, uint32_t policy_id, bool transposed,
-    const tsuba::RDGLineage& lineage, std::unique_ptr<tsuba::WriteGroup> desc) {
+    const tsuba::RDGLineage& lineage, std::unique_ptr<tsuba::WriteGroup> desc,
+    bool started) {
   katana::CommBackend* comm = tsuba::Comm();
   tsuba::RDGMeta new_meta = handle.impl_->rdg_meta().NextVersion(
       comm->Num, policy_id, transposed, lineage);
 
-  // wait for all the work we queued to finish
+  // wait for all the work we queued to finish, even after a failure, so
+  // that none of it is in flight when rolling back
   TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
-  if (auto res = desc->Finish(); !res) {
-    return res.error().WithContext("at least one async write failed");
-  }
-  TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
-  comm->Barrier();
-
-  // NS handles MPI coordination
-  if (auto res = tsuba::NS()->Update(
-          handle.impl_->rdg_meta().dir(), handle.impl_->rdg_meta().version(),
-          new_meta);
-      !res) {
-    KATANA_LOG_ERROR(
-        "unable to update rdg at {}: {}", handle.impl_->rdg_meta().dir(),
-        res.error());
+  auto finish_res = desc->Finish();
+  bool written = started && finish_res &&
+                 !TSUBA_PTP_FAILS(tsuba::internal::FaultSensitivity::High);
+  if (!AllHostsOk(written)) {
+    RollBack(*desc);
+    if (!finish_res) {
+      return finish_res.error().WithContext("at least one async write failed");
+    }
+    return KATANA_ERROR(
+        tsuba::ErrorCode::MpiError, "a host failed to write its partition");
   }
 
   TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
   katana::Result<void> ret = tsuba::OneHostOnly([&]() -> katana::Result<void> {
     TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
+    if (TSUBA_PTP_FAILS(tsuba::internal::FaultSensitivity::High)) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::MpiError, "injected failure storing RDGMeta");
+    }
 
     std::string curr_s = new_meta.ToJsonString();
     auto res = tsuba::FileStore(
@@ -160,10 +253,30 @@ CommitRDG(
     }
     return katana::ResultSuccess();
   });
-  if (ret) {
-    handle.impl_->set_rdg_meta(std::move(new_meta));
+  if (!ret) {
+    RollBack(*desc);
+    return ret.error();
+  }
+
+  // NS handles MPI coordination
+  auto update_ns = [&]() -> katana::Result<void> {
+    auto ns_res = tsuba::NS();
+    if (!ns_res) {
+      return ns_res.error();
+    }
+    return ns_res.value()->Update(
+        handle.impl_->rdg_meta().dir(), handle.impl_->rdg_meta().version(),
+        new_meta);
+  };
+  if (auto res = update_ns(); !res) {
+    KATANA_LOG_ERROR(
+        "unable to update rdg at {}: {}", handle.impl_->rdg_meta().dir(),
+        res.error());
   }
-  return ret;
+  TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
+
+  handle.impl_->set_rdg_meta(std::move(new_meta));
+  return katana::ResultSuccess();
 }
 
 void
@@ -190,6 +303,210 @@ AddEdgePropStorageInfo(
   }
 }
 
+/// The storage path of each column of props, or empty if it has none
+std::vector<std::string>
+PropertyPaths(
+    const arrow::Table& props,
+    const std::vector<tsuba::PropStorageInfo>& prop_info) {
+  std::vector<std::string> paths(props.num_columns());
+  for (const auto& info : prop_info) {
+    int i = props.schema()->GetFieldIndex(info.name);
+    if (i >= 0) {
+      paths[i] = info.path;
+    }
+  }
+  return paths;
+}
+
+/// The lazy properties of \param properties, or nullptr if there are none
+katana::Result<std::unique_ptr<tsuba::LazyProperties>>
+MakeLazyProperties(
+    const katana::Uri& dir, const std::vector<tsuba::PropStorageInfo>& props,
+    bool prefetch, arrow::MemoryPool* pool) {
+  if (props.empty()) {
+    return std::unique_ptr<tsuba::LazyProperties>();
+  }
+  auto fields_res = tsuba::LoadPropertyFields(dir, props);
+  if (!fields_res) {
+    return fields_res.error();
+  }
+  auto lazy = std::make_unique<tsuba::LazyProperties>();
+  lazy->schema = arrow::schema(std::move(fields_res.value()));
+  lazy->pending.assign(props.begin(), props.end());
+  lazy->num_pending = props.size();
+  lazy->spills.resize(props.size());
+  lazy->pool = pool;
+  if (prefetch) {
+    lazy->prefetches = tsuba::StartLoadProperties(dir, props, pool);
+  }
+  return std::unique_ptr<tsuba::LazyProperties>(std::move(lazy));
+}
+
+/// Read field i of lazy, which is pending, from its spill file, its
+/// prefetch or dir
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadLazyProperty(const katana::Uri& dir, tsuba::LazyProperties* lazy, int i) {
+  const tsuba::PropStorageInfo& info = lazy->pending[i].value();
+  if (!lazy->spills[i].empty()) {
+    return tsuba::LoadProperties(
+        info.name, lazy->spills[i], nullptr, 0, lazy->pool,
+        tsuba::PropFormat::ArrowIPC);
+  }
+  if (!lazy->prefetches.empty() && lazy->prefetches[i].valid()) {
+    return lazy->prefetches[i].get();
+  }
+  return tsuba::LoadProperties(
+      info.name, dir.Join(info.path), nullptr, 0, lazy->pool, info.format);
+}
+
+/// Load field i of lazy, which is pending, into table and prop_info after the
+/// loaded fields before it, so that the loaded properties keep the order of
+/// lazy->schema
+katana::Result<void>
+LoadLazyProperty(
+    const katana::Uri& dir, tsuba::LazyProperties* lazy, int i,
+    std::shared_ptr<arrow::Table>* table,
+    std::vector<tsuba::PropStorageInfo>* prop_info) {
+  const tsuba::PropStorageInfo& info = lazy->pending[i].value();
+  auto props_res = ReadLazyProperty(dir, lazy, i);
+  if (!props_res) {
+    return props_res.error();
+  }
+  std::shared_ptr<arrow::Table> props = std::move(props_res.value());
+
+  int position = 0;
+  for (int j = 0; j < i; ++j) {
+    position += !lazy->pending[j];
+  }
+  if ((*table)->num_columns() == 0) {
+    *table = std::move(props);
+  } else {
+    if ((*table)->num_rows() != props->num_rows()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument,
+          "expected {} rows found {} instead", (*table)->num_rows(),
+          props->num_rows());
+    }
+    auto add_res =
+        (*table)->AddColumn(position, props->field(0), props->column(0));
+    if (!add_res.ok()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::ArrowError, "arrow error: {}", add_res.status());
+    }
+    *table = std::move(add_res.ValueOrDie());
+  }
+  prop_info->insert(prop_info->begin() + position, info);
+  lazy->pending[i].reset();
+  lazy->num_pending -= 1;
+  // A mapped spill file stays readable once it is deleted
+  lazy->DeleteSpill(i);
+  return katana::ResultSuccess();
+}
+
+/// Move the loaded property \param name out of table and prop_info into
+/// lazy, first writing it to a new file in spill_dir if it changed since it
+/// was stored
+katana::Result<void>
+EvictLoadedProperty(
+    const std::string& name, const katana::Uri& spill_dir,
+    tsuba::LazyProperties* lazy, std::shared_ptr<arrow::Table>* table,
+    std::vector<tsuba::PropStorageInfo>* prop_info) {
+  int position = (*table)->schema()->GetFieldIndex(name);
+  int i = lazy->schema->GetFieldIndex(name);
+  KATANA_LOG_DEBUG_ASSERT(position >= 0 && i >= 0 && !lazy->pending[i]);
+  tsuba::PropStorageInfo info = (*prop_info)[position];
+
+  katana::Uri spill;
+  if (info.path.empty()) {
+    spill = spill_dir.RandFile(name);
+    auto writer_res =
+        tsuba::ArrowIPCWriter::Make((*table)->column(position), name);
+    if (!writer_res) {
+      return writer_res.error();
+    }
+    if (auto res = writer_res.value()->WriteToUri(spill); !res) {
+      return res.error().WithContext("spilling {}", name);
+    }
+  }
+
+  auto remove_res = (*table)->RemoveColumn(position);
+  if (!remove_res.ok()) {
+    lazy->spills[i] = std::move(spill);
+    lazy->DeleteSpill(i);
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "arrow error: {}", remove_res.status());
+  }
+  *table = std::move(remove_res.ValueOrDie());
+  prop_info->erase(prop_info->begin() + position);
+  lazy->pending[i] = std::move(info);
+  lazy->spills[i] = std::move(spill);
+  lazy->num_pending += 1;
+  return katana::ResultSuccess();
+}
+
+/// Fail if a field of \param schema is a property of lazy that is not
+/// loaded, which adding it would duplicate
+katana::Result<void>
+CheckNotPending(
+    const tsuba::LazyProperties* lazy, const arrow::Schema& schema) {
+  if (lazy == nullptr) {
+    return katana::ResultSuccess();
+  }
+  for (const auto& field : schema.fields()) {
+    int i = lazy->schema->GetFieldIndex(field->name());
+    if (i >= 0 && lazy->pending[i]) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::Exists, "property {} already exists",
+          field->name());
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Forget field i of lazy, which is removed
+void
+DropLazyField(tsuba::LazyProperties* lazy, int i) {
+  if (lazy->pending[i]) {
+    lazy->num_pending -= 1;
+  }
+  auto schema_res = lazy->schema->RemoveField(i);
+  KATANA_LOG_ASSERT(schema_res.ok());
+  lazy->schema = std::move(schema_res.ValueOrDie());
+  lazy->pending.erase(lazy->pending.begin() + i);
+  lazy->DeleteSpill(i);
+  lazy->spills.erase(lazy->spills.begin() + i);
+  if (!lazy->prefetches.empty()) {
+    lazy->prefetches.erase(lazy->prefetches.begin() + i);
+  }
+}
+
+/// Record in lazy the fields of \param schema, which were just upserted into
+/// the loaded properties: those that were loaded are replaced in place, and
+/// the others, including pending ones, were appended after the loaded ones
+void
+MergeUpsertedFields(tsuba::LazyProperties* lazy, const arrow::Schema& schema) {
+  for (const auto& field : schema.fields()) {
+    int i = lazy->schema->GetFieldIndex(field->name());
+    if (i >= 0 && !lazy->pending[i]) {
+      auto schema_res = lazy->schema->SetField(i, field);
+      KATANA_LOG_ASSERT(schema_res.ok());
+      lazy->schema = std::move(schema_res.ValueOrDie());
+      continue;
+    }
+    if (i >= 0) {
+      DropLazyField(lazy, i);
+    }
+    auto schema_res = lazy->schema->AddField(lazy->schema->num_fields(), field);
+    KATANA_LOG_ASSERT(schema_res.ok());
+    lazy->schema = std::move(schema_res.ValueOrDie());
+    lazy->pending.emplace_back();
+    lazy->spills.emplace_back();
+    if (!lazy->prefetches.empty()) {
+      lazy->prefetches.emplace_back();
+    }
+  }
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -240,6 +557,16 @@ tsuba::RDGFile::~RDGFile() {
 
 katana::Result<std::vector<tsuba::PropStorageInfo>>
 tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
+  const std::vector<tsuba::PropStorageInfo>& stored =
+      core_->part_header().part_prop_info_list();
+  if (!part_arrays_dirty_ && !stored.empty() &&
+      std::all_of(stored.begin(), stored.end(), [](const auto& prop) {
+        return !prop.path.empty();
+      })) {
+    // Unchanged since they were loaded from or stored to dir
+    return stored;
+  }
+
   std::vector<tsuba::PropStorageInfo> next_properties;
 
   KATANA_LOG_DEBUG(
@@ -257,7 +584,8 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
 
   for (unsigned i = 0; i < mirror_nodes_.size(); ++i) {
     auto name = MirrorPropName(i);
-    auto mirr_res = StoreArrowArrayAtName(mirror_nodes_[i], dir, name, desc);
+    auto mirr_res = StoreArrowArrayAtName(
+        mirror_nodes_[i], dir, name, desc, write_opts_);
     if (!mirr_res) {
       return mirr_res.error().WithContext("storing mirrors[{}] arrow array", i);
     }
@@ -270,7 +598,8 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
 
   for (unsigned i = 0; i < master_nodes_.size(); ++i) {
     auto name = MasterPropName(i);
-    auto mast_res = StoreArrowArrayAtName(master_nodes_[i], dir, name, desc);
+    auto mast_res = StoreArrowArrayAtName(
+        master_nodes_[i], dir, name, desc, write_opts_);
     if (!mast_res) {
       return mast_res.error().WithContext("storing masters arrow array");
     }
@@ -284,7 +613,7 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
   if (host_to_owned_global_node_ids_ != nullptr) {
     auto h2nod_res = StoreArrowArrayAtName(
         host_to_owned_global_node_ids_, dir, kHostToOwnedGlobalNodeIDsPropName,
-        desc);
+        desc, write_opts_);
     if (!h2nod_res) {
       return h2nod_res.error();
     }
@@ -298,7 +627,7 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
   if (host_to_owned_global_edge_ids_ != nullptr) {
     auto h2edg_res = StoreArrowArrayAtName(
         host_to_owned_global_edge_ids_, dir, kHostToOwnedGlobalEdgeIDsPropName,
-        desc);
+        desc, write_opts_);
     if (!h2edg_res) {
       return h2edg_res.error();
     }
@@ -311,7 +640,7 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
 
   if (local_to_user_id_ != nullptr) {
     auto l2u_res = StoreArrowArrayAtName(
-        local_to_user_id_, dir, kLocalToUserIDPropName, desc);
+        local_to_user_id_, dir, kLocalToUserIDPropName, desc, write_opts_);
     if (!l2u_res) {
       return l2u_res.error();
     }
@@ -324,7 +653,7 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
 
   if (local_to_global_id_ != nullptr) {
     auto l2g_res = StoreArrowArrayAtName(
-        local_to_global_id_, dir, kLocalToGlobalIDPropName, desc);
+        local_to_global_id_, dir, kLocalToGlobalIDPropName, desc, write_opts_);
     if (!l2g_res) {
       return l2g_res.error().WithContext("storing l2g arrow array");
     }
@@ -339,9 +668,7 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
 }
 
 katana::Result<void>
-tsuba::RDG::DoStore(
-    RDGHandle handle, const std::string& command_line,
-    std::unique_ptr<WriteGroup> write_group) {
+tsuba::RDG::StartStores(RDGHandle handle, WriteGroup* write_group) {
   if (core_->part_header().topology_path().empty()) {
     // No topology file; create one
     katana::Uri t_path = MakeTopologyFileName(handle);
@@ -356,9 +683,25 @@ tsuba::RDG::DoStore(
     core_->part_header().set_topology_path(t_path.BaseName());
   }
 
+  if (core_->part_header().in_topology_path().empty() &&
+      core_->in_topology_file_storage().Valid()) {
+    // In-edge topology is bound to another location; copy it here too
+    katana::Uri in_path =
+        handle.impl_->rdg_meta().dir().RandFile("in_topology");
+
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+
+    // depends on `in_topology_file_storage_` outliving writes
+    write_group->StartStore(
+        in_path.string(), core_->in_topology_file_storage().ptr<uint8_t>(),
+        core_->in_topology_file_storage().size());
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    core_->part_header().set_in_topology_path(in_path.BaseName());
+  }
+
   auto node_write_result = WriteProperties(
       *core_->node_properties(), core_->part_header().node_prop_info_list(),
-      handle.impl_->rdg_meta().dir(), write_group.get());
+      handle.impl_->rdg_meta().dir(), write_group, write_opts_);
   if (!node_write_result) {
     return node_write_result.error().WithContext(
         "failed to write node properties");
@@ -370,7 +713,7 @@ tsuba::RDG::DoStore(
 
   auto edge_write_result = WriteProperties(
       *core_->edge_properties(), core_->part_header().edge_prop_info_list(),
-      handle.impl_->rdg_meta().dir(), write_group.get());
+      handle.impl_->rdg_meta().dir(), write_group, write_opts_);
   if (!edge_write_result) {
     return edge_write_result.error().WithContext(
         "failed to write edge properties");
@@ -381,7 +724,7 @@ tsuba::RDG::DoStore(
       std::move(edge_write_result.value()));
 
   auto part_write_result =
-      WritePartArrays(handle.impl_->rdg_meta().dir(), write_group.get());
+      WritePartArrays(handle.impl_->rdg_meta().dir(), write_group);
 
   if (!part_write_result) {
     return part_write_result.error().WithContext("failed to write part arrays");
@@ -389,31 +732,85 @@ tsuba::RDG::DoStore(
   core_->part_header().set_part_properties(
       std::move(part_write_result.value()));
 
-  if (auto write_result = core_->part_header().Write(handle, write_group.get());
+  // The part header lists the checksums of the files, which are computed as
+  // they are stored, so it is written after them
+  if (auto res = write_group->Finish(); !res) {
+    return res.error().WithContext("storing the files of the part header");
+  }
+  core_->part_header().UpdateChecksums(handle.impl_->rdg_meta().dir());
+
+  if (auto write_result = core_->part_header().Write(handle, write_group);
       !write_result) {
     return write_result.error().WithContext("failed to write metadata");
   }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDG::DoStore(
+    RDGHandle handle, const std::string& command_line,
+    std::unique_ptr<WriteGroup> write_group) {
+  // A host that fails to start its writes still joins the commit, so that
+  // every host rolls back
+  std::optional<katana::CopyableErrorInfo> start_error;
+  if (auto res = StartStores(handle, write_group.get()); !res) {
+    start_error = res.error();
+  }
 
   // Update lineage and commit
-  lineage_.AddCommandLine(command_line);
+  RDGLineage lineage = lineage_;
+  lineage.AddCommandLine(command_line);
   if (auto res = CommitRDG(
           handle, core_->part_header().metadata().policy_id_,
-          core_->part_header().metadata().transposed_, lineage_,
-          std::move(write_group));
+          core_->part_header().metadata().transposed_, lineage,
+          std::move(write_group), !start_error);
       !res) {
+    if (start_error) {
+      return KATANA_ERROR(start_error->error_code(), "{}", *start_error);
+    }
     return res.error().WithContext("failed to finalize RDG");
   }
+  lineage_ = std::move(lineage);
+  // Later stores to the same place reference the files written so far
+  rdg_dir_ = handle.impl_->rdg_meta().dir();
+  part_arrays_dirty_ = false;
+  PublishSnapshot();
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
-tsuba::RDG::DoMake(const katana::Uri& metadata_dir) {
+tsuba::RDG::DoMake(
+    const katana::Uri& metadata_dir,
+    const std::vector<ParquetReader::Slice>* node_row_ranges,
+    const std::vector<ParquetReader::Slice>* edge_row_ranges,
+    arrow::MemoryPool* pool, bool lazy_properties, bool prefetch) {
   ReadGroup grp;
+  if (lazy_properties) {
+    RDGPartHeader& header = core_->part_header();
+    auto node_res = MakeLazyProperties(
+        metadata_dir, header.node_prop_info_list(), prefetch, pool);
+    if (!node_res) {
+      return node_res.error().WithContext("reading node property schemas");
+    }
+    core_->set_lazy_node_properties(std::move(node_res.value()));
+    auto edge_res = MakeLazyProperties(
+        metadata_dir, header.edge_prop_info_list(), prefetch, pool);
+    if (!edge_res) {
+      return edge_res.error().WithContext("reading edge property schemas");
+    }
+    core_->set_lazy_edge_properties(std::move(edge_res.value()));
+    // The part header lists the loaded properties, in the order of the
+    // columns of the property tables
+    header.set_node_prop_info_list({});
+    header.set_edge_prop_info_list({});
+  }
+
   auto node_result = AddProperties(
       metadata_dir, core_->part_header().node_prop_info_list(), &grp,
       [rdg = this](const std::shared_ptr<arrow::Table>& props) {
         return rdg->core_->AddNodeProperties(props);
-      });
+      },
+      node_row_ranges, pool);
   if (!node_result) {
     return node_result.error().WithContext("populating node properties");
   }
@@ -422,17 +819,29 @@ tsuba::RDG::DoMake(const katana::Uri& metadata_dir) {
       metadata_dir, core_->part_header().edge_prop_info_list(), &grp,
       [rdg = this](const std::shared_ptr<arrow::Table>& props) {
         return rdg->core_->AddEdgeProperties(props);
-      });
+      },
+      edge_row_ranges, pool);
   if (!edge_result) {
     return edge_result.error().WithContext("populating edge properties");
   }
 
   katana::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
-  if (auto res = core_->topology_file_storage().Bind(t_path.string(), true);
+  if (auto res =
+          BindTopology(&core_->topology_file_storage(), t_path.string());
       !res) {
     return res.error();
   }
 
+  if (const std::string& in_top = core_->part_header().in_topology_path();
+      !in_top.empty()) {
+    katana::Uri in_path = metadata_dir.Join(in_top);
+    if (auto res = BindTopology(
+            &core_->in_topology_file_storage(), in_path.string());
+        !res) {
+      return res.error().WithContext("binding in-edge topology");
+    }
+  }
+
   rdg_dir_ = metadata_dir;
 
   const std::vector<PropStorageInfo>& part_prop_info_list =
@@ -495,6 +904,43 @@ tsuba::RDG::DoMake(const katana::Uri& metadata_dir) {
   return katana::ResultSuccess();
 }
 
+namespace {
+
+/// Find the rows of a property that may satisfy a predicate
+katana::Result<std::vector<tsuba::ParquetReader::Slice>>
+FindPredicateRows(
+    const katana::Uri& dir, const std::vector<tsuba::PropStorageInfo>& props,
+    const tsuba::PropertyPredicate& predicate) {
+  auto it = std::find_if(
+      props.begin(), props.end(), [&](const tsuba::PropStorageInfo& prop) {
+        return prop.name == predicate.property;
+      });
+  if (it == props.end()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::PropertyNotFound, "predicate property {} not found",
+        predicate.property);
+  }
+  // Arrow IPC files have no statistics, so any of their rows may match
+  if (it->format == tsuba::PropFormat::ArrowIPC) {
+    return std::vector<tsuba::ParquetReader::Slice>{
+        {.offset = 0, .length = std::numeric_limits<int64_t>::max()}};
+  }
+
+  auto reader_res = tsuba::ParquetReader::Make();
+  if (!reader_res) {
+    return reader_res.error();
+  }
+  auto rows_res = reader_res.value()->FindCandidateRows(
+      dir.Join(it->path), 0, predicate.min, predicate.max);
+  if (!rows_res) {
+    return rows_res.error().WithContext(
+        "applying predicate on {}", predicate.property);
+  }
+  return rows_res;
+}
+
+}  // namespace
+
 katana::Result<tsuba::RDG>
 tsuba::RDG::Make(const RDGMeta& meta, const RDGLoadOptions& opts) {
   uint32_t partition_id_to_load =
@@ -507,17 +953,55 @@ tsuba::RDG::Make(const RDGMeta& meta, const RDGLoadOptions& opts) {
         "failed to read path {}", partition_path);
   }
 
+  if (opts.lazy_properties && (opts.node_predicate || opts.edge_predicate)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "lazy properties cannot be loaded with a predicate");
+  }
+
   RDG rdg(std::make_unique<RDGCore>(std::move(part_header_res.value())));
 
+  // Predicates may name properties that are not loaded, so look for them
+  // before pruning
+  std::optional<std::vector<ParquetReader::Slice>> node_row_ranges;
+  if (opts.node_predicate) {
+    auto rows_res = FindPredicateRows(
+        meta.dir(), rdg.core_->part_header().node_prop_info_list(),
+        opts.node_predicate.value());
+    if (!rows_res) {
+      return rows_res.error();
+    }
+    node_row_ranges = std::move(rows_res.value());
+  }
+  std::optional<std::vector<ParquetReader::Slice>> edge_row_ranges;
+  if (opts.edge_predicate) {
+    auto rows_res = FindPredicateRows(
+        meta.dir(), rdg.core_->part_header().edge_prop_info_list(),
+        opts.edge_predicate.value());
+    if (!rows_res) {
+      return rows_res.error();
+    }
+    edge_row_ranges = std::move(rows_res.value());
+  }
+
   if (auto res = rdg.core_->part_header().PrunePropsTo(
           opts.node_properties, opts.edge_properties);
       !res) {
     return res.error();
   }
 
-  if (auto res = rdg.DoMake(meta.dir()); !res) {
+  if (auto res = rdg.DoMake(
+          meta.dir(), node_row_ranges ? &node_row_ranges.value() : nullptr,
+          edge_row_ranges ? &edge_row_ranges.value() : nullptr,
+          opts.memory_pool, opts.lazy_properties,
+          opts.prefetch_lazy_properties);
+      !res) {
     return res.error();
   }
+  rdg.loaded_with_predicate_ = node_row_ranges || edge_row_ranges;
+  rdg.part_arrays_dirty_ = false;
+  rdg.memory_pool_ = opts.memory_pool;
+  rdg.PublishSnapshot();
 
   rdg.set_partition_id(partition_id_to_load);
 
@@ -534,6 +1018,12 @@ tsuba::RDG::Validate() const {
 
 bool
 tsuba::RDG::Equals(const RDG& other) const {
+  for (const RDG* rdg : {this, &other}) {
+    if (auto res = rdg->EnsurePropertiesLoaded(); !res) {
+      KATANA_LOG_ERROR("comparing RDGs: {}", res.error());
+      return false;
+    }
+  }
   return core_->Equals(*other.core_);
 }
 
@@ -549,11 +1039,19 @@ tsuba::RDG::Make(RDGHandle handle, const RDGLoadOptions& opts) {
 katana::Result<void>
 tsuba::RDG::Store(
     RDGHandle handle, const std::string& command_line,
-    std::unique_ptr<FileFrame> ff) {
+    std::unique_ptr<FileFrame> ff, std::unique_ptr<FileFrame> in_ff) {
   if (!handle.impl_->AllowsWrite()) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "handle does not allow write");
   }
+  if (loaded_with_predicate_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "cannot store an RDG whose properties were loaded with a predicate");
+  }
+  if (auto res = EnsurePropertiesLoaded(); !res) {
+    return res.error();
+  }
   // We trust the partitioner to give us a valid graph, but we
   // report our assumptions
   KATANA_LOG_DEBUG(
@@ -562,6 +1060,9 @@ tsuba::RDG::Store(
       handle.impl_->rdg_meta().num_hosts(),
       handle.impl_->rdg_meta().policy_id(), tsuba::Comm()->Num,
       core_->part_header().metadata().policy_id_);
+  // The part header references the files of the store once it starts; if
+  // the store fails they are deleted and the header is restored
+  RDGPartHeader prev_header = core_->part_header();
   if (handle.impl_->rdg_meta().dir() != rdg_dir_) {
     core_->part_header().UnbindFromStorage();
   }
@@ -583,14 +1084,36 @@ tsuba::RDG::Store(
     core_->part_header().set_topology_path(t_path.BaseName());
   }
 
-  return DoStore(handle, command_line, std::move(desc));
+  if (in_ff) {
+    katana::Uri in_path =
+        handle.impl_->rdg_meta().dir().RandFile("in_topology");
+
+    in_ff->Bind(in_path.string());
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    desc->StartStore(std::move(in_ff));
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    core_->part_header().set_in_topology_path(in_path.BaseName());
+  }
+
+  if (auto res = DoStore(handle, command_line, std::move(desc)); !res) {
+    core_->set_part_header(std::move(prev_header));
+    return res.error();
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
 tsuba::RDG::AddNodeProperties(const std::shared_ptr<arrow::Table>& props) {
+  LazyProperties* lazy = core_->lazy_node_properties();
+  if (auto res = CheckNotPending(lazy, *props->schema()); !res) {
+    return res.error();
+  }
   if (auto res = core_->AddNodeProperties(props); !res) {
     return res.error();
   }
+  if (lazy != nullptr) {
+    MergeUpsertedFields(lazy, *props->schema());
+  }
 
   AddNodePropStorageInfo(core_.get(), props);
 
@@ -598,14 +1121,22 @@ tsuba::RDG::AddNodeProperties(const std::shared_ptr<arrow::Table>& props) {
       static_cast<size_t>(core_->node_properties()->num_columns()) ==
       core_->part_header().node_prop_info_list().size());
 
+  PublishSnapshot();
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
 tsuba::RDG::AddEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
+  LazyProperties* lazy = core_->lazy_edge_properties();
+  if (auto res = CheckNotPending(lazy, *props->schema()); !res) {
+    return res.error();
+  }
   if (auto res = core_->AddEdgeProperties(props); !res) {
     return res.error();
   }
+  if (lazy != nullptr) {
+    MergeUpsertedFields(lazy, *props->schema());
+  }
 
   AddEdgePropStorageInfo(core_.get(), props);
 
@@ -613,6 +1144,7 @@ tsuba::RDG::AddEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
       static_cast<size_t>(core_->edge_properties()->num_columns()) ==
       core_->part_header().edge_prop_info_list().size());
 
+  PublishSnapshot();
   return katana::ResultSuccess();
 }
 
@@ -621,6 +1153,13 @@ tsuba::RDG::UpsertNodeProperties(const std::shared_ptr<arrow::Table>& props) {
   if (auto res = core_->UpsertNodeProperties(props); !res) {
     return res.error();
   }
+  // Pending properties are replaced without loading them
+  if (LazyProperties* lazy = core_->lazy_node_properties()) {
+    MergeUpsertedFields(lazy, *props->schema());
+    if (lazy->num_pending == 0) {
+      core_->set_lazy_node_properties(nullptr);
+    }
+  }
 
   AddNodePropStorageInfo(core_.get(), props);
 
@@ -628,6 +1167,7 @@ tsuba::RDG::UpsertNodeProperties(const std::shared_ptr<arrow::Table>& props) {
       static_cast<size_t>(core_->node_properties()->num_columns()) ==
       core_->part_header().node_prop_info_list().size());
 
+  PublishSnapshot();
   return katana::ResultSuccess();
 }
 
@@ -636,6 +1176,12 @@ tsuba::RDG::UpsertEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
   if (auto res = core_->UpsertEdgeProperties(props); !res) {
     return res.error();
   }
+  if (LazyProperties* lazy = core_->lazy_edge_properties()) {
+    MergeUpsertedFields(lazy, *props->schema());
+    if (lazy->num_pending == 0) {
+      core_->set_lazy_edge_properties(nullptr);
+    }
+  }
 
   AddEdgePropStorageInfo(core_.get(), props);
 
@@ -643,36 +1189,224 @@ tsuba::RDG::UpsertEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
       static_cast<size_t>(core_->edge_properties()->num_columns()) ==
       core_->part_header().edge_prop_info_list().size());
 
+  PublishSnapshot();
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
 tsuba::RDG::RemoveNodeProperty(uint32_t i) {
-  return core_->RemoveNodeProperty(i);
+  return RemoveProperty(true, i);
 }
 
 katana::Result<void>
 tsuba::RDG::RemoveEdgeProperty(uint32_t i) {
-  return core_->RemoveEdgeProperty(i);
+  return RemoveProperty(false, i);
+}
+
+katana::Result<void>
+tsuba::RDG::RemoveProperty(bool nodes, uint32_t i) {
+  LazyProperties* lazy =
+      nodes ? core_->lazy_node_properties() : core_->lazy_edge_properties();
+  if (lazy == nullptr) {
+    auto res =
+        nodes ? core_->RemoveNodeProperty(i) : core_->RemoveEdgeProperty(i);
+    if (!res) {
+      return res.error();
+    }
+    PublishSnapshot();
+    return katana::ResultSuccess();
+  }
+
+  if (i >= static_cast<uint32_t>(lazy->schema->num_fields())) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no property {} of {}", i,
+        lazy->schema->num_fields());
+  }
+  // A pending property is only forgotten; a loaded one is removed at its
+  // position among the loaded properties
+  if (!lazy->pending[i]) {
+    uint32_t position = 0;
+    for (uint32_t j = 0; j < i; ++j) {
+      position += !lazy->pending[j];
+    }
+    auto res = nodes ? core_->RemoveNodeProperty(position)
+                     : core_->RemoveEdgeProperty(position);
+    if (!res) {
+      return res.error();
+    }
+  }
+  DropLazyField(lazy, i);
+  if (lazy->num_pending == 0) {
+    if (nodes) {
+      core_->set_lazy_node_properties(nullptr);
+    } else {
+      core_->set_lazy_edge_properties(nullptr);
+    }
+  }
+  PublishSnapshot();
+  return katana::ResultSuccess();
 }
 
 void
 tsuba::RDG::MarkAllPropertiesPersistent() {
   core_->part_header().MarkAllPropertiesPersistent();
+  for (LazyProperties* lazy :
+       {core_->lazy_node_properties(), core_->lazy_edge_properties()}) {
+    if (lazy == nullptr) {
+      continue;
+    }
+    for (std::optional<PropStorageInfo>& info : lazy->pending) {
+      if (info) {
+        info->persist = true;
+      }
+    }
+  }
 }
 
 katana::Result<void>
 tsuba::RDG::MarkNodePropertiesPersistent(
     const std::vector<std::string>& persist_node_props) {
+  // Properties are named by position among all of them
+  if (auto res = EnsurePropertiesLoaded(); !res) {
+    return res.error();
+  }
   return core_->part_header().MarkNodePropertiesPersistent(persist_node_props);
 }
 
 katana::Result<void>
 tsuba::RDG::MarkEdgePropertiesPersistent(
     const std::vector<std::string>& persist_edge_props) {
+  // Properties are named by position among all of them
+  if (auto res = EnsurePropertiesLoaded(); !res) {
+    return res.error();
+  }
   return core_->part_header().MarkEdgePropertiesPersistent(persist_edge_props);
 }
 
+tsuba::PropStorageInfo*
+tsuba::RDG::FindPropStorageInfo(bool nodes, const std::string& name) const {
+  RDGPartHeader& header = core_->part_header();
+  PropStorageInfo* info = nodes ? header.FindNodePropStorageInfo(name)
+                                : header.FindEdgePropStorageInfo(name);
+  if (info != nullptr) {
+    return info;
+  }
+  LazyProperties* lazy =
+      nodes ? core_->lazy_node_properties() : core_->lazy_edge_properties();
+  if (lazy == nullptr) {
+    return nullptr;
+  }
+  int i = lazy->schema->GetFieldIndex(name);
+  if (i < 0 || !lazy->pending[i]) {
+    return nullptr;
+  }
+  return &lazy->pending[i].value();
+}
+
+katana::Result<void>
+tsuba::RDG::SetNodePropertyDerivation(
+    const std::string& name, const std::string& derivation) {
+  PropStorageInfo* info = FindPropStorageInfo(true, name);
+  if (info == nullptr) {
+    return KATANA_ERROR(ErrorCode::PropertyNotFound, "no property {}", name);
+  }
+  info->derivation = derivation;
+  info->persist = true;
+  return katana::ResultSuccess();
+}
+
+std::string
+tsuba::RDG::GetNodePropertyDerivation(const std::string& name) const {
+  const PropStorageInfo* info = FindPropStorageInfo(true, name);
+  return info == nullptr ? std::string() : info->derivation;
+}
+
+std::string
+tsuba::RDG::StoredVersion(
+    const std::vector<std::string>& node_props,
+    const std::vector<std::string>& edge_props) const {
+  // Stored files are never rewritten, so their names name their contents
+  std::string version = core_->part_header().topology_path();
+  if (version.empty()) {
+    return version;
+  }
+  for (bool nodes : {true, false}) {
+    for (const std::string& name : nodes ? node_props : edge_props) {
+      const PropStorageInfo* info = FindPropStorageInfo(nodes, name);
+      if (info == nullptr || info->path.empty()) {
+        return std::string();
+      }
+      version += (nodes ? " node:" : " edge:") + info->path;
+    }
+  }
+  return version;
+}
+
+katana::Result<void>
+tsuba::RDG::EvictNodeProperty(
+    const std::string& name, const katana::Uri& spill_dir) const {
+  return EvictProperty(true, name, spill_dir);
+}
+
+katana::Result<void>
+tsuba::RDG::EvictEdgeProperty(
+    const std::string& name, const katana::Uri& spill_dir) const {
+  return EvictProperty(false, name, spill_dir);
+}
+
+katana::Result<void>
+tsuba::RDG::EvictProperty(
+    bool nodes, const std::string& name, const katana::Uri& spill_dir) const {
+  if (loaded_with_predicate_) {
+    // Reading the property again would not skip the rows the load did
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "properties loaded with a predicate cannot be evicted");
+  }
+  std::shared_ptr<arrow::Table> table =
+      nodes ? core_->node_properties() : core_->edge_properties();
+  LazyProperties* lazy =
+      nodes ? core_->lazy_node_properties() : core_->lazy_edge_properties();
+  if (table->schema()->GetFieldIndex(name) < 0) {
+    if (lazy != nullptr && lazy->schema->GetFieldIndex(name) >= 0) {
+      return katana::ResultSuccess();
+    }
+    return KATANA_ERROR(ErrorCode::PropertyNotFound, "no property {}", name);
+  }
+
+  std::unique_ptr<LazyProperties> made;
+  if (lazy == nullptr) {
+    made = std::make_unique<LazyProperties>();
+    made->schema = table->schema();
+    made->pending.resize(table->num_columns());
+    made->spills.resize(table->num_columns());
+    made->pool = memory_pool_;
+    lazy = made.get();
+  }
+  RDGPartHeader& header = core_->part_header();
+  std::vector<PropStorageInfo> prop_info =
+      nodes ? header.node_prop_info_list() : header.edge_prop_info_list();
+  if (auto res = EvictLoadedProperty(name, spill_dir, lazy, &table, &prop_info);
+      !res) {
+    return res.error();
+  }
+  if (nodes) {
+    core_->set_node_properties(std::move(table));
+    header.set_node_prop_info_list(std::move(prop_info));
+    if (made) {
+      core_->set_lazy_node_properties(std::move(made));
+    }
+  } else {
+    core_->set_edge_properties(std::move(table));
+    header.set_edge_prop_info_list(std::move(prop_info));
+    if (made) {
+      core_->set_lazy_edge_properties(std::move(made));
+    }
+  }
+  PublishSnapshot();
+  return katana::ResultSuccess();
+}
+
 const tsuba::PartitionMetadata&
 tsuba::RDG::part_metadata() const {
   return core_->part_header().metadata();
@@ -685,22 +1419,156 @@ tsuba::RDG::set_part_metadata(const tsuba::PartitionMetadata& metadata) {
 
 const std::shared_ptr<arrow::Table>&
 tsuba::RDG::node_properties() const {
+  if (auto res = LoadLazyProperties(true, nullptr); !res) {
+    KATANA_LOG_ERROR("loading node properties: {}", res.error());
+  }
   return core_->node_properties();
 }
 
 const std::shared_ptr<arrow::Table>&
 tsuba::RDG::edge_properties() const {
+  if (auto res = LoadLazyProperties(false, nullptr); !res) {
+    KATANA_LOG_ERROR("loading edge properties: {}", res.error());
+  }
+  return core_->edge_properties();
+}
+
+const std::shared_ptr<arrow::Table>&
+tsuba::RDG::loaded_node_properties() const {
+  return core_->node_properties();
+}
+
+const std::shared_ptr<arrow::Table>&
+tsuba::RDG::loaded_edge_properties() const {
   return core_->edge_properties();
 }
 
+std::shared_ptr<arrow::Schema>
+tsuba::RDG::full_node_schema() const {
+  if (LazyProperties* lazy = core_->lazy_node_properties()) {
+    return lazy->schema;
+  }
+  return core_->node_properties()->schema();
+}
+
+std::shared_ptr<arrow::Schema>
+tsuba::RDG::full_edge_schema() const {
+  if (LazyProperties* lazy = core_->lazy_edge_properties()) {
+    return lazy->schema;
+  }
+  return core_->edge_properties()->schema();
+}
+
+katana::Result<void>
+tsuba::RDG::EnsureNodePropertyLoaded(const std::string& name) const {
+  return LoadLazyProperties(true, &name);
+}
+
+katana::Result<void>
+tsuba::RDG::EnsureEdgePropertyLoaded(const std::string& name) const {
+  return LoadLazyProperties(false, &name);
+}
+
+katana::Result<void>
+tsuba::RDG::EnsurePropertiesLoaded() const {
+  if (auto res = LoadLazyProperties(true, nullptr); !res) {
+    return res.error();
+  }
+  return LoadLazyProperties(false, nullptr);
+}
+
+katana::Result<void>
+tsuba::RDG::LoadLazyProperties(bool nodes, const std::string* name) const {
+  LazyProperties* lazy =
+      nodes ? core_->lazy_node_properties() : core_->lazy_edge_properties();
+  if (lazy == nullptr) {
+    return katana::ResultSuccess();
+  }
+  std::vector<int> fields;
+  if (name != nullptr) {
+    int i = lazy->schema->GetFieldIndex(*name);
+    if (i < 0 || !lazy->pending[i]) {
+      return katana::ResultSuccess();
+    }
+    fields.emplace_back(i);
+  } else {
+    for (int i = 0, n = lazy->schema->num_fields(); i < n; ++i) {
+      if (lazy->pending[i]) {
+        fields.emplace_back(i);
+      }
+    }
+  }
+
+  RDGPartHeader& header = core_->part_header();
+  // The tables and the part header change one property at a time, so a
+  // failed load keeps the properties loaded before it. A failed prefetch is
+  // read again the next time.
+  bool loaded = false;
+  for (int i : fields) {
+    std::shared_ptr<arrow::Table> table =
+        nodes ? core_->node_properties() : core_->edge_properties();
+    std::vector<PropStorageInfo> prop_info =
+        nodes ? header.node_prop_info_list() : header.edge_prop_info_list();
+    if (auto res = LoadLazyProperty(rdg_dir_, lazy, i, &table, &prop_info);
+        !res) {
+      if (loaded) {
+        PublishSnapshot();
+      }
+      return res.error().WithContext(
+          "loading {}", lazy->schema->field(i)->name());
+    }
+    if (nodes) {
+      core_->set_node_properties(std::move(table));
+      header.set_node_prop_info_list(std::move(prop_info));
+    } else {
+      core_->set_edge_properties(std::move(table));
+      header.set_edge_prop_info_list(std::move(prop_info));
+    }
+    loaded = true;
+  }
+  if (lazy->num_pending == 0) {
+    if (nodes) {
+      core_->set_lazy_node_properties(nullptr);
+    } else {
+      core_->set_lazy_edge_properties(nullptr);
+    }
+  }
+  if (loaded) {
+    PublishSnapshot();
+  }
+  return katana::ResultSuccess();
+}
+
+std::shared_ptr<const tsuba::RDGSnapshot>
+tsuba::RDG::Snapshot() const {
+  return std::atomic_load(&snapshot_);
+}
+
+void
+tsuba::RDG::PublishSnapshot() const {
+  auto snapshot = std::make_shared<RDGSnapshot>();
+  // Only the writer publishes, so reading snapshot_ here does not race
+  snapshot->version = snapshot_ ? snapshot_->version + 1 : 0;
+  snapshot->node_properties = core_->node_properties();
+  snapshot->edge_properties = core_->edge_properties();
+  snapshot->node_property_paths = PropertyPaths(
+      *snapshot->node_properties, core_->part_header().node_prop_info_list());
+  snapshot->edge_property_paths = PropertyPaths(
+      *snapshot->edge_properties, core_->part_header().edge_prop_info_list());
+  std::atomic_store(
+      &snapshot_, std::shared_ptr<const RDGSnapshot>(std::move(snapshot)));
+}
+
 void
 tsuba::RDG::DropNodeProperties() {
   core_->drop_node_properties();
+  PublishSnapshot();
 }
 
 void
 tsuba::RDG::DropEdgeProperties() {
   core_->drop_edge_properties();
+  PublishSnapshot();
 }
 
 const tsuba::FileView&
@@ -708,11 +1576,64 @@ tsuba::RDG::topology_file_storage() const {
   return core_->topology_file_storage();
 }
 
+const tsuba::FileView&
+tsuba::RDG::in_topology_file_storage() const {
+  return core_->in_topology_file_storage();
+}
+
+bool
+tsuba::RDG::topology_sorted_by_dest() const {
+  return core_->part_header().topology_sorted_by_dest();
+}
+
+void
+tsuba::RDG::set_topology_sorted_by_dest(bool sorted) {
+  core_->part_header().set_topology_sorted_by_dest(sorted);
+}
+
 katana::Result<void>
 tsuba::RDG::UnbindTopologyFileStorage() {
+  if (auto res = UnbindInTopologyFileStorage(); !res) {
+    return res.error();
+  }
+  core_->part_header().set_topology_sorted_by_dest(false);
+  core_->part_header().set_topology_path("");
   return core_->topology_file_storage().Unbind();
 }
 
+bool
+tsuba::RDG::HasStoredTopology(RDGHandle handle) const {
+  return handle.impl_->rdg_meta().dir() == rdg_dir_ &&
+         !core_->part_header().topology_path().empty();
+}
+
+bool
+tsuba::RDG::HasStoredInTopology(RDGHandle handle) const {
+  return handle.impl_->rdg_meta().dir() == rdg_dir_ &&
+         !core_->part_header().in_topology_path().empty();
+}
+
+katana::Result<void>
+tsuba::RDG::MarkTopologyModified() {
+  if (auto res = UnbindInTopologyFileStorage(); !res) {
+    return res.error();
+  }
+  // An empty path makes DoStore write the bound (modified) topology again
+  core_->part_header().set_topology_path("");
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDG::ReleaseTopologyFileStorage() {
+  return core_->topology_file_storage().Unbind();
+}
+
+katana::Result<void>
+tsuba::RDG::UnbindInTopologyFileStorage() {
+  core_->part_header().set_in_topology_path("");
+  return core_->in_topology_file_storage().Unbind();
+}
+
 katana::Result<void>
 tsuba::RDG::SetTopologyFile(const katana::Uri& new_top) {
   katana::Uri dir = new_top.DirName();
@@ -735,9 +1656,13 @@ tsuba::RDG::InitArrowVectors() {
 
 tsuba::RDG::RDG(std::unique_ptr<RDGCore>&& core) : core_(std::move(core)) {
   InitArrowVectors();
+  PublishSnapshot();
 }
 
-tsuba::RDG::RDG() : core_(std::make_unique<RDGCore>()) { InitArrowVectors(); }
+tsuba::RDG::RDG() : core_(std::make_unique<RDGCore>()) {
+  InitArrowVectors();
+  PublishSnapshot();
+}
 
 tsuba::RDG::~RDG() = default;
 tsuba::RDG::RDG(tsuba::RDG&& other) noexcept = default;
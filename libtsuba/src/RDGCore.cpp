@@ -1,7 +1,9 @@
 #include "RDGCore.h"
 
 #include "RDGPartHeader.h"
+#include "katana/Logging.h"
 #include "tsuba/Errors.h"
+#include "tsuba/file.h"
 
 namespace {
 
@@ -89,6 +91,25 @@ AddProperties(
 
 namespace tsuba {
 
+LazyProperties::~LazyProperties() {
+  for (int i = 0, n = spills.size(); i < n; ++i) {
+    DeleteSpill(i);
+  }
+}
+
+void
+LazyProperties::DeleteSpill(int i) {
+  katana::Uri& spill = spills[i];
+  if (spill.empty()) {
+    return;
+  }
+  if (auto res = FileDelete(spill.DirName().string(), {spill.BaseName()});
+      !res) {
+    KATANA_LOG_WARN("deleting spilled property {}: {}", spill, res.error());
+  }
+  spill = katana::Uri();
+}
+
 katana::Result<void>
 RDGCore::AddNodeProperties(const std::shared_ptr<arrow::Table>& props) {
   return AddProperties(props, &node_properties_);
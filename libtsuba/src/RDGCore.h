@@ -1,16 +1,45 @@
 #ifndef KATANA_LIBTSUBA_RDGCORE_H_
 #define KATANA_LIBTSUBA_RDGCORE_H_
 
+#include <future>
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include <arrow/api.h>
 
 #include "RDGPartHeader.h"
+#include "katana/Uri.h"
 #include "katana/config.h"
 #include "tsuba/FileView.h"
 
 namespace tsuba {
 
+/// The node or edge properties of an RDG that are not loaded yet, because
+/// it was loaded with RDGLoadOptions::lazy_properties or they were evicted
+struct LazyProperties {
+  /// Spill files that are left are deleted
+  ~LazyProperties();
+
+  /// Delete the spill file of field i, if any
+  void DeleteSpill(int i);
+
+  /// Every property, loaded or not, in the order of the loaded properties
+  std::shared_ptr<arrow::Schema> schema;
+  /// Where each field of schema is stored, until it is loaded
+  std::vector<std::optional<PropStorageInfo>> pending;
+  size_t num_pending{0};
+  /// The file each pending field of schema was spilled to when it was
+  /// evicted with changes not stored yet, or empty if it is read from the
+  /// RDG at its PropStorageInfo path
+  std::vector<katana::Uri> spills;
+  /// The reads of the fields of schema started in the background, if they
+  /// are prefetched
+  std::vector<std::future<katana::Result<std::shared_ptr<arrow::Table>>>>
+      prefetches;
+  arrow::MemoryPool* pool{nullptr};
+};
+
 class KATANA_EXPORT RDGCore {
 public:
   RDGCore() { InitEmptyProperties(); }
@@ -58,10 +87,28 @@ public:
   void drop_node_properties() {
     std::vector<std::shared_ptr<arrow::Array>> empty;
     node_properties_ = arrow::Table::Make(arrow::schema({}), empty, 0);
+    lazy_node_properties_.reset();
   }
   void drop_edge_properties() {
     std::vector<std::shared_ptr<arrow::Array>> empty;
     edge_properties_ = arrow::Table::Make(arrow::schema({}), empty, 0);
+    lazy_edge_properties_.reset();
+  }
+
+  /// The node properties not loaded yet, or nullptr if there are none
+  LazyProperties* lazy_node_properties() const {
+    return lazy_node_properties_.get();
+  }
+  void set_lazy_node_properties(std::unique_ptr<LazyProperties>&& lazy) {
+    lazy_node_properties_ = std::move(lazy);
+  }
+
+  /// The edge properties not loaded yet, or nullptr if there are none
+  LazyProperties* lazy_edge_properties() const {
+    return lazy_edge_properties_.get();
+  }
+  void set_lazy_edge_properties(std::unique_ptr<LazyProperties>&& lazy) {
+    lazy_edge_properties_ = std::move(lazy);
   }
 
   const FileView& topology_file_storage() const {
@@ -72,6 +119,11 @@ public:
     topology_file_storage_ = std::move(topology_file_storage);
   }
 
+  const FileView& in_topology_file_storage() const {
+    return in_topology_file_storage_;
+  }
+  FileView& in_topology_file_storage() { return in_topology_file_storage_; }
+
   const RDGPartHeader& part_header() const { return part_header_; }
   RDGPartHeader& part_header() { return part_header_; }
   void set_part_header(RDGPartHeader&& part_header) {
@@ -92,8 +144,11 @@ private:
 
   std::shared_ptr<arrow::Table> node_properties_;
   std::shared_ptr<arrow::Table> edge_properties_;
+  std::unique_ptr<LazyProperties> lazy_node_properties_;
+  std::unique_ptr<LazyProperties> lazy_edge_properties_;
 
   FileView topology_file_storage_;
+  FileView in_topology_file_storage_;
 
   RDGPartHeader part_header_;
 };
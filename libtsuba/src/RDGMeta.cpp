@@ -62,7 +62,11 @@ RDGMeta::Make(RDGHandle handle) {
 Result<RDGMeta>
 RDGMeta::Make(const katana::Uri& uri) {
   if (!IsMetaUri(uri)) {
-    auto ns_res = NS()->Get(uri);
+    auto client_res = NS();
+    if (!client_res) {
+      return client_res.error();
+    }
+    auto ns_res = client_res.value()->Get(uri);
     if (!ns_res) {
       return ns_res.error();
     }
@@ -152,6 +156,9 @@ RDGMeta::FileNames() {
       }
       // Duplicates eliminated by set
       fnames.emplace(header.topology_path());
+      if (!header.in_topology_path().empty()) {
+        fnames.emplace(header.in_topology_path());
+      }
     }
   }
   return fnames;
@@ -1,8 +1,13 @@
 #include "RDGPartHeader.h"
 
+#include <cstring>
+#include <type_traits>
+
+#include "Checksums.h"
 #include "Constants.h"
 #include "GlobalState.h"
 #include "RDGHandleImpl.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
@@ -15,6 +20,8 @@ namespace {
 
 // TODO (witchel) these key are deprecated as part of parquet
 const char* kTopologyPathKey = "kg.v1.topology.path";
+const char* kInTopologyPathKey = "kg.v1.in_topology.path";
+const char* kTopologySortedByDestKey = "kg.v1.topology.sorted_by_dest";
 const char* kNodePropertyPathKey = "kg.v1.node_property.path";
 const char* kNodePropertyNameKey = "kg.v1.node_property.name";
 const char* kEdgePropertyPathKey = "kg.v1.edge_property.path";
@@ -27,6 +34,11 @@ const char* kNodePropertyKey = "kg.v1.node_property";
 const char* kEdgePropertyKey = "kg.v1.edge_property";
 const char* kPartPropertyFilesKey = "kg.v1.part_property_files";
 const char* kPartProperyMetaKey = "kg.v1.part_property_meta";
+const char* kChecksumsKey = "kg.v1.checksums";
+// the format of properties stored as Arrow IPC, which follows their name
+// and path; properties without one are Parquet
+const char* kArrowIPCFormat = "arrow_ipc";
+const char* kParquetFormat = "parquet";
 //
 //constexpr std::string_view  mirror_nodes_prop_name = "mirror_nodes";
 //constexpr std::string_view  master_nodes_prop_name = "master_nodes";
@@ -34,6 +46,110 @@ const char* kPartProperyMetaKey = "kg.v1.part_property_meta";
 
 // special partition property names
 
+/// The binary part header starts with this, so that it is told apart from
+/// JSON, which starts with '{', and from Parquet
+constexpr char kBinaryMagic[8] = {'K', 'A', 'T', 'R', 'D', 'G', 'P', 'H'};
+/// The version of the binary layout below; readers reject other versions
+constexpr uint32_t kBinaryVersion = 1;
+/// BinaryHeader::flags
+constexpr uint32_t kTopologySortedByDestFlag = 1;
+
+/// A string in the string table of a binary part header, which holds the
+/// bytes of every string, without terminators
+struct BinaryString {
+  uint64_t offset;
+  uint64_t size;
+};
+
+/// The record of a property in a binary part header
+struct BinaryProp {
+  BinaryString name;
+  BinaryString path;
+  BinaryString derivation;
+  /// A tsuba::PropFormat
+  uint32_t format;
+  uint32_t reserved;
+};
+
+/// The binary part header, version kBinaryVersion. This fixed-size record
+/// is followed by the BinaryProp records of the partition, node and edge
+/// properties, in that order, and then by the string table, so a reader
+/// maps the file and finds any of them by offset, without parsing. Integers
+/// are in the byte order of the writer; a reader of the other order finds a
+/// wrong version. Sections added since, like BinaryChecksums, follow the
+/// string table at the next multiple of 8 bytes, so that readers which
+/// predate them skip them.
+struct BinaryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  BinaryString topology_path;
+  BinaryString in_topology_path;
+  /// The number of partition, node and edge properties
+  uint64_t num_props[3];
+  uint64_t strings_offset;
+  uint64_t strings_size;
+
+  // The fields of tsuba::PartitionMetadata
+  uint64_t num_global_nodes;
+  uint64_t max_global_node_id;
+  uint64_t num_global_edges;
+  uint64_t num_edges;
+  uint32_t policy_id;
+  uint32_t num_nodes;
+  uint32_t num_owned;
+  uint32_t cartesian_grid[2];
+  uint8_t transposed;
+  uint8_t is_outgoing_edge_cut;
+  uint8_t is_incoming_edge_cut;
+  uint8_t reserved;
+};
+
+/// The section of block checksums, if the file goes on past the string
+/// table: this record, num_files BinaryFileChecksums, and their checksums
+struct BinaryChecksums {
+  /// The tsuba::kChecksumBlockSize of the writer; a reader of another block
+  /// size does not verify
+  uint64_t block_size;
+  uint64_t num_files;
+};
+
+struct BinaryFileChecksums {
+  BinaryString path;
+  /// The offset in the file of the uint32 checksums of the blocks of path
+  uint64_t offset;
+  uint64_t num_blocks;
+};
+
+static_assert(std::is_trivially_copyable_v<BinaryHeader>);
+static_assert(sizeof(BinaryHeader) % alignof(BinaryProp) == 0);
+
+uint64_t
+AlignTo8(uint64_t offset) {
+  return (offset + 7) & ~UINT64_C(7);
+}
+
+bool
+IsBinary(const tsuba::FileView& fv) {
+  return fv.size() >= sizeof(kBinaryMagic) &&
+         std::memcmp(fv.ptr<char>(), kBinaryMagic, sizeof(kBinaryMagic)) == 0;
+}
+
+/// Appends the strings of a binary part header to its string table
+class StringTable {
+public:
+  BinaryString Add(const std::string& s) {
+    BinaryString ref{bytes_.size(), s.size()};
+    bytes_ += s;
+    return ref;
+  }
+
+  const std::string& bytes() const { return bytes_; }
+
+private:
+  std::string bytes_;
+};
+
 // TODO (witchel) Deprecated.  Remove with ReadMetadataParquet, below
 katana::Result<std::vector<tsuba::PropStorageInfo>>
 MakeProperties(std::vector<std::string>&& values) {
@@ -170,15 +286,221 @@ RDGPartHeader::MakeParquet(const katana::Uri& partition_path) {
 }
 
 katana::Result<RDGPartHeader>
-RDGPartHeader::MakeJson(const katana::Uri& partition_path) {
-  tsuba::FileView fv;
-  if (auto res = fv.Bind(partition_path.string(), true); !res) {
-    return res.error();
+RDGPartHeader::MakeBinary(const FileView& fv) {
+  BinaryHeader binary;
+  if (fv.size() < sizeof(binary)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "binary part header of {} bytes",
+        fv.size());
   }
-  if (fv.size() == 0) {
-    return tsuba::RDGPartHeader();
+  std::memcpy(&binary, fv.ptr<char>(), sizeof(binary));
+  if (binary.version != kBinaryVersion) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "unsupported binary part header version {}", binary.version);
+  }
+
+  uint64_t num_props =
+      binary.num_props[0] + binary.num_props[1] + binary.num_props[2];
+  if (num_props > (fv.size() - sizeof(binary)) / sizeof(BinaryProp) ||
+      binary.strings_offset < sizeof(binary) + num_props * sizeof(BinaryProp) ||
+      binary.strings_offset > fv.size() ||
+      binary.strings_size > fv.size() - binary.strings_offset) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "binary part header is truncated");
+  }
+  const char* strings = fv.ptr<char>(binary.strings_offset);
+  bool bad_string = false;
+  auto read_string = [&](const BinaryString& s) {
+    if (s.offset > binary.strings_size ||
+        s.size > binary.strings_size - s.offset) {
+      bad_string = true;
+      return std::string();
+    }
+    return std::string(strings + s.offset, s.size);
+  };
+
+  RDGPartHeader header;
+  header.topology_path_ = read_string(binary.topology_path);
+  header.in_topology_path_ = read_string(binary.in_topology_path);
+  header.topology_sorted_by_dest_ =
+      (binary.flags & kTopologySortedByDestFlag) != 0;
+
+  std::vector<PropStorageInfo>* lists[] = {
+      &header.part_prop_info_list_, &header.node_prop_info_list_,
+      &header.edge_prop_info_list_};
+  uint64_t offset = sizeof(binary);
+  for (int i = 0; i < 3; ++i) {
+    lists[i]->reserve(binary.num_props[i]);
+    for (uint64_t p = 0; p < binary.num_props[i]; ++p) {
+      BinaryProp prop;
+      std::memcpy(&prop, fv.ptr<char>(offset), sizeof(prop));
+      offset += sizeof(prop);
+      lists[i]->emplace_back(PropStorageInfo{
+          .name = read_string(prop.name),
+          .path = read_string(prop.path),
+          .format = prop.format == static_cast<uint32_t>(PropFormat::ArrowIPC)
+                        ? PropFormat::ArrowIPC
+                        : PropFormat::Parquet,
+          .derivation = read_string(prop.derivation),
+      });
+    }
   }
 
+  uint64_t checksums_offset =
+      AlignTo8(binary.strings_offset + binary.strings_size);
+  if (checksums_offset < fv.size()) {
+    BinaryChecksums section;
+    if (fv.size() - checksums_offset < sizeof(section)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "binary part header is truncated");
+    }
+    std::memcpy(&section, fv.ptr<char>(checksums_offset), sizeof(section));
+    uint64_t files_offset = checksums_offset + sizeof(section);
+    if (section.num_files >
+        (fv.size() - files_offset) / sizeof(BinaryFileChecksums)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "binary part header is truncated");
+    }
+    for (uint64_t f = 0; f < section.num_files; ++f) {
+      BinaryFileChecksums file;
+      std::memcpy(
+          &file, fv.ptr<char>(files_offset + f * sizeof(file)), sizeof(file));
+      if (file.offset > fv.size() ||
+          file.num_blocks > (fv.size() - file.offset) / sizeof(uint32_t)) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "binary part header has checksums out of the file");
+      }
+      if (section.block_size != kChecksumBlockSize) {
+        continue;
+      }
+      std::vector<uint32_t> sums(file.num_blocks);
+      std::memcpy(
+          sums.data(), fv.ptr<char>(file.offset),
+          file.num_blocks * sizeof(uint32_t));
+      header.checksums_.emplace(read_string(file.path), std::move(sums));
+    }
+    if (section.block_size != kChecksumBlockSize) {
+      KATANA_LOG_WARN(
+          "not verifying files checksummed in blocks of {} bytes",
+          section.block_size);
+    }
+  }
+
+  if (bad_string) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "binary part header has a string out of its table");
+  }
+
+  PartitionMetadata& metadata = header.metadata_;
+  metadata.policy_id_ = binary.policy_id;
+  metadata.transposed_ = binary.transposed != 0;
+  metadata.is_outgoing_edge_cut_ = binary.is_outgoing_edge_cut != 0;
+  metadata.is_incoming_edge_cut_ = binary.is_incoming_edge_cut != 0;
+  metadata.num_global_nodes_ = binary.num_global_nodes;
+  metadata.max_global_node_id_ = binary.max_global_node_id;
+  metadata.num_global_edges_ = binary.num_global_edges;
+  metadata.num_edges_ = binary.num_edges;
+  metadata.num_nodes_ = binary.num_nodes;
+  metadata.num_owned_ = binary.num_owned;
+  metadata.cartesian_grid_ = {
+      binary.cartesian_grid[0], binary.cartesian_grid[1]};
+  return header;
+}
+
+std::string
+RDGPartHeader::ToBinary() const {
+  BinaryHeader binary{};
+  std::memcpy(binary.magic, kBinaryMagic, sizeof(kBinaryMagic));
+  binary.version = kBinaryVersion;
+  binary.flags = topology_sorted_by_dest_ ? kTopologySortedByDestFlag : 0;
+
+  StringTable strings;
+  binary.topology_path = strings.Add(topology_path_);
+  binary.in_topology_path = strings.Add(in_topology_path_);
+
+  std::vector<BinaryProp> props;
+  const std::vector<PropStorageInfo>* lists[] = {
+      &part_prop_info_list_, &node_prop_info_list_, &edge_prop_info_list_};
+  for (int i = 0; i < 3; ++i) {
+    for (const PropStorageInfo& prop : *lists[i]) {
+      if (!prop.persist) {
+        continue;
+      }
+      props.emplace_back(BinaryProp{
+          .name = strings.Add(prop.name),
+          .path = strings.Add(prop.path),
+          .derivation = strings.Add(prop.derivation),
+          .format = static_cast<uint32_t>(prop.format),
+          .reserved = 0,
+      });
+      binary.num_props[i] += 1;
+    }
+  }
+  std::vector<BinaryFileChecksums> files;
+  for (const auto& [path, sums] : checksums_) {
+    files.emplace_back(BinaryFileChecksums{
+        .path = strings.Add(path),
+        .offset = 0,
+        .num_blocks = sums.size(),
+    });
+  }
+  binary.strings_offset = sizeof(binary) + props.size() * sizeof(BinaryProp);
+  binary.strings_size = strings.bytes().size();
+
+  uint64_t checksums_offset =
+      AlignTo8(binary.strings_offset + binary.strings_size);
+  BinaryChecksums section{
+      .block_size = kChecksumBlockSize,
+      .num_files = files.size(),
+  };
+  uint64_t sums_offset = checksums_offset + sizeof(section) +
+                         files.size() * sizeof(BinaryFileChecksums);
+  for (BinaryFileChecksums& file : files) {
+    file.offset = sums_offset;
+    sums_offset += file.num_blocks * sizeof(uint32_t);
+  }
+
+  binary.num_global_nodes = metadata_.num_global_nodes_;
+  binary.max_global_node_id = metadata_.max_global_node_id_;
+  binary.num_global_edges = metadata_.num_global_edges_;
+  binary.num_edges = metadata_.num_edges_;
+  binary.policy_id = metadata_.policy_id_;
+  binary.num_nodes = metadata_.num_nodes_;
+  binary.num_owned = metadata_.num_owned_;
+  binary.cartesian_grid[0] = metadata_.cartesian_grid_.first;
+  binary.cartesian_grid[1] = metadata_.cartesian_grid_.second;
+  binary.transposed = metadata_.transposed_;
+  binary.is_outgoing_edge_cut = metadata_.is_outgoing_edge_cut_;
+  binary.is_incoming_edge_cut = metadata_.is_incoming_edge_cut_;
+
+  std::string serialized;
+  serialized.reserve(sums_offset);
+  serialized.append(reinterpret_cast<const char*>(&binary), sizeof(binary));
+  serialized.append(
+      reinterpret_cast<const char*>(props.data()),
+      props.size() * sizeof(BinaryProp));
+  serialized += strings.bytes();
+  if (files.empty()) {
+    return serialized;
+  }
+  serialized.resize(checksums_offset, '\0');
+  serialized.append(reinterpret_cast<const char*>(&section), sizeof(section));
+  serialized.append(
+      reinterpret_cast<const char*>(files.data()),
+      files.size() * sizeof(BinaryFileChecksums));
+  for (const auto& [path, sums] : checksums_) {
+    serialized.append(
+        reinterpret_cast<const char*>(sums.data()),
+        sums.size() * sizeof(uint32_t));
+  }
+  return serialized;
+}
+
+katana::Result<RDGPartHeader>
+RDGPartHeader::MakeJson(const FileView& fv) {
   tsuba::RDGPartHeader header;
   auto json_res = katana::JsonParse<tsuba::RDGPartHeader>(fv, &header);
   if (!json_res) {
@@ -189,10 +511,23 @@ RDGPartHeader::MakeJson(const katana::Uri& partition_path) {
 
 katana::Result<RDGPartHeader>
 RDGPartHeader::Make(const katana::Uri& partition_path) {
-  katana::Result<RDGPartHeader> res = MakeJson(partition_path);
+  tsuba::FileView fv;
+  if (auto res = fv.Bind(partition_path.string(), true); !res) {
+    return res.error();
+  }
+  if (fv.size() == 0) {
+    return tsuba::RDGPartHeader();
+  }
+
+  katana::Result<RDGPartHeader> res =
+      IsBinary(fv) ? MakeBinary(fv) : MakeJson(fv);
   if (res) {
+    res.value().RegisterChecksums(partition_path.DirName());
     return res;
   }
+  if (IsBinary(fv)) {
+    return res.error();
+  }
 
   KATANA_LOG_WARN("failed to parse JSON RDGPartHeader: {}", res.error());
   KATANA_LOG_WARN("falling back on Parquet (deprecated)");
@@ -207,16 +542,21 @@ RDGPartHeader::Make(const katana::Uri& partition_path) {
 
 katana::Result<void>
 RDGPartHeader::Write(RDGHandle handle, WriteGroup* writes) const {
-  auto serialized_res = katana::JsonDump(*this);
-  if (!serialized_res) {
-    return serialized_res.error();
+  bool write_json = false;
+  katana::GetEnv("KATANA_RDG_JSON_PART_HEADER", &write_json);
+
+  std::string serialized;
+  if (write_json) {
+    auto serialized_res = katana::JsonDump(*this);
+    if (!serialized_res) {
+      return serialized_res.error();
+    }
+    // POSIX files end with newlines
+    serialized = std::move(serialized_res.value()) + "\n";
+  } else {
+    serialized = ToBinary();
   }
 
-  std::string serialized = std::move(serialized_res.value());
-
-  // POSIX files end with newlines
-  serialized = serialized + "\n";
-
   TSUBA_PTP(internal::FaultSensitivity::Normal);
   auto ff = std::make_unique<FileFrame>();
   if (auto res = ff->Init(serialized.size()); !res) {
@@ -306,6 +646,11 @@ RDGPartHeader::Validate() const {
         ErrorCode::InvalidArgument,
         "topology_path doesn't contain a slash (/): {}", topology_path_);
   }
+  if (in_topology_path_.find('/') != std::string::npos) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "in_topology_path doesn't contain a slash (/): {}", in_topology_path_);
+  }
   return katana::ResultSuccess();
 }
 
@@ -360,6 +705,39 @@ RDGPartHeader::MarkEdgePropertiesPersistent(
   return katana::ResultSuccess();
 }
 
+void
+RDGPartHeader::RegisterChecksums(const katana::Uri& dir) const {
+  for (const auto& [path, sums] : checksums_) {
+    SetChecksums(dir.Join(path).string(), sums);
+  }
+}
+
+void
+RDGPartHeader::UpdateChecksums(const katana::Uri& dir) {
+  std::map<std::string, std::vector<uint32_t>> checksums;
+  auto update = [&](const std::string& path) {
+    if (path.empty()) {
+      return;
+    }
+    if (auto sums = FindChecksums(dir.Join(path).string()); sums) {
+      checksums.emplace(path, *sums);
+    } else if (auto it = checksums_.find(path); it != checksums_.end()) {
+      checksums.emplace(path, std::move(it->second));
+    }
+  };
+  update(topology_path_);
+  update(in_topology_path_);
+  for (const auto* list :
+       {&part_prop_info_list_, &node_prop_info_list_, &edge_prop_info_list_}) {
+    for (const PropStorageInfo& prop : *list) {
+      if (prop.persist) {
+        update(prop.path);
+      }
+    }
+  }
+  checksums_ = std::move(checksums);
+}
+
 void
 RDGPartHeader::UnbindFromStorage() {
   for (PropStorageInfo& prop : node_prop_info_list_) {
@@ -372,6 +750,8 @@ RDGPartHeader::UnbindFromStorage() {
     prop.path = "";
   }
   topology_path_ = "";
+  in_topology_path_ = "";
+  checksums_.clear();
 }
 
 }  // namespace tsuba
@@ -396,6 +776,15 @@ tsuba::to_json(json& j, const tsuba::RDGPartHeader& header) {
       {kPartPropertyFilesKey, header.part_prop_info_list_},
       {kPartProperyMetaKey, header.metadata_},
   };
+  if (!header.in_topology_path_.empty()) {
+    j[kInTopologyPathKey] = header.in_topology_path_;
+  }
+  if (header.topology_sorted_by_dest_) {
+    j[kTopologySortedByDestKey] = true;
+  }
+  if (!header.checksums_.empty()) {
+    j[kChecksumsKey] = header.checksums_;
+  }
 }
 
 void
@@ -405,6 +794,18 @@ tsuba::from_json(const json& j, tsuba::RDGPartHeader& header) {
   j.at(kEdgePropertyKey).get_to(header.edge_prop_info_list_);
   j.at(kPartPropertyFilesKey).get_to(header.part_prop_info_list_);
   j.at(kPartProperyMetaKey).get_to(header.metadata_);
+  // the in-edge topology sidecar is optional
+  if (auto it = j.find(kInTopologyPathKey); it != j.end()) {
+    it->get_to(header.in_topology_path_);
+  }
+  // absent in older headers, which make no claim about edge order
+  if (auto it = j.find(kTopologySortedByDestKey); it != j.end()) {
+    it->get_to(header.topology_sorted_by_dest_);
+  }
+  // files stored before checksums were are not verified
+  if (auto it = j.find(kChecksumsKey); it != j.end()) {
+    it->get_to(header.checksums_);
+  }
 }
 
 void
@@ -455,12 +856,30 @@ void
 tsuba::from_json(const nlohmann::json& j, tsuba::PropStorageInfo& propmd) {
   j.at(0).get_to(propmd.name);
   j.at(1).get_to(propmd.path);
+  // Properties without a format predate Arrow IPC properties
+  propmd.format = tsuba::PropFormat::Parquet;
+  if (j.size() > 2 && j.at(2).get<std::string>() == kArrowIPCFormat) {
+    propmd.format = tsuba::PropFormat::ArrowIPC;
+  }
+  // The derivation, if any, follows the format
+  propmd.derivation.clear();
+  if (j.size() > 3) {
+    j.at(3).get_to(propmd.derivation);
+  }
 }
 
 void
 tsuba::to_json(json& j, const tsuba::PropStorageInfo& propmd) {
   if (propmd.persist) {
     j = json{propmd.name, propmd.path};
+    if (propmd.format == tsuba::PropFormat::ArrowIPC) {
+      j.push_back(kArrowIPCFormat);
+    } else if (!propmd.derivation.empty()) {
+      j.push_back(kParquetFormat);
+    }
+    if (!propmd.derivation.empty()) {
+      j.push_back(propmd.derivation);
+    }
   }
   // creates a null value if property wasn't supposed to be persisted
 }
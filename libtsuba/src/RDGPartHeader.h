@@ -2,6 +2,7 @@
 #define KATANA_LIBTSUBA_RDGPARTHEADER_H_
 
 #include <cassert>
+#include <map>
 #include <vector>
 
 #include <arrow/api.h>
@@ -15,12 +16,26 @@
 
 namespace tsuba {
 
+class FileView;
+
+/// The file formats of stored properties
+enum class PropFormat { Parquet, ArrowIPC };
+
 struct PropStorageInfo {
   std::string name;
   std::string path;
   bool persist{false};
+  PropFormat format{PropFormat::Parquet};
+  /// How the property was computed, e.g., by which analytic from which
+  /// inputs, or empty if unknown; see RDG::SetNodePropertyDerivation
+  std::string derivation;
 };
 
+/// The part header of an RDG: the files of its topology and properties and
+/// its partition metadata. It is stored in a versioned binary format (see
+/// ToBinary), which is read in place from the mapped file, or, for
+/// compatibility, as JSON, which is still read and is written instead if
+/// KATANA_RDG_JSON_PART_HEADER is set.
 class KATANA_EXPORT RDGPartHeader {
 public:
   static katana::Result<RDGPartHeader> Make(const katana::Uri& partition_path);
@@ -35,6 +50,11 @@ public:
 
   void UnbindFromStorage();
 
+  /// Take the block checksums of the files of this header in \param dir
+  /// that were just stored, keep those of the files stored before, and drop
+  /// those of files no longer referenced
+  void UpdateChecksums(const katana::Uri& dir);
+
   //
   // Property manipulation
   //
@@ -48,6 +68,7 @@ public:
     } else {
       // If we already have a record, clear the path so we will rewrite it
       pmd_it->path = "";
+      pmd_it->derivation.clear();
     }
   }
 
@@ -60,9 +81,26 @@ public:
     } else {
       // If we already have a record, clear the path so we will rewrite it
       pmd_it->path = "";
+      pmd_it->derivation.clear();
     }
   }
 
+  /// The record of the loaded node property \param name, or nullptr if
+  /// there is none
+  PropStorageInfo* FindNodePropStorageInfo(const std::string& name) {
+    auto pmd_it = std::find_if(
+        node_prop_info_list_.begin(), node_prop_info_list_.end(),
+        [&](const PropStorageInfo& my_pmd) { return my_pmd.name == name; });
+    return pmd_it == node_prop_info_list_.end() ? nullptr : &*pmd_it;
+  }
+
+  PropStorageInfo* FindEdgePropStorageInfo(const std::string& name) {
+    auto pmd_it = std::find_if(
+        edge_prop_info_list_.begin(), edge_prop_info_list_.end(),
+        [&](const PropStorageInfo& my_pmd) { return my_pmd.name == name; });
+    return pmd_it == edge_prop_info_list_.end() ? nullptr : &*pmd_it;
+  }
+
   void RemoveNodeProperty(uint32_t i) {
     auto& p = node_prop_info_list_;
     KATANA_LOG_DEBUG_ASSERT(i < p.size());
@@ -94,6 +132,20 @@ public:
   const std::string& topology_path() const { return topology_path_; }
   void set_topology_path(std::string path) { topology_path_ = std::move(path); }
 
+  /// The in-edge topology is an optional sidecar of the topology; an empty
+  /// path means there is none in storage
+  const std::string& in_topology_path() const { return in_topology_path_; }
+  void set_in_topology_path(std::string path) {
+    in_topology_path_ = std::move(path);
+  }
+
+  /// True if the out-edges of every node in the topology are sorted by
+  /// destination
+  bool topology_sorted_by_dest() const { return topology_sorted_by_dest_; }
+  void set_topology_sorted_by_dest(bool sorted) {
+    topology_sorted_by_dest_ = sorted;
+  }
+
   const std::vector<PropStorageInfo>& node_prop_info_list() const {
     return node_prop_info_list_;
   }
@@ -120,15 +172,29 @@ public:
   const PartitionMetadata& metadata() const { return metadata_; }
   void set_metadata(const PartitionMetadata& metadata) { metadata_ = metadata; }
 
+  /// The checksums of the kChecksumBlockSize blocks of the files of the
+  /// header, by file name; files stored without checksums have none
+  const std::map<std::string, std::vector<uint32_t>>& checksums() const {
+    return checksums_;
+  }
+
   friend void to_json(nlohmann::json& j, const RDGPartHeader& header);
   friend void from_json(const nlohmann::json& j, RDGPartHeader& header);
 
 private:
-  static katana::Result<RDGPartHeader> MakeJson(
-      const katana::Uri& partition_path);
+  static katana::Result<RDGPartHeader> MakeBinary(const FileView& fv);
+  static katana::Result<RDGPartHeader> MakeJson(const FileView& fv);
   static katana::Result<RDGPartHeader> MakeParquet(
       const katana::Uri& partition_path);
 
+  /// The binary form of this header, which holds the persistent properties
+  /// alone, like the JSON one
+  std::string ToBinary() const;
+
+  /// Remember the checksums of the files of this header in \param dir, so
+  /// that the FileViews bound to them verify what they read
+  void RegisterChecksums(const katana::Uri& dir) const;
+
   std::vector<PropStorageInfo> part_prop_info_list_;
   std::vector<PropStorageInfo> node_prop_info_list_;
   std::vector<PropStorageInfo> edge_prop_info_list_;
@@ -137,6 +203,10 @@ private:
   PartitionMetadata metadata_;
 
   std::string topology_path_;
+  std::string in_topology_path_;
+  bool topology_sorted_by_dest_{false};
+
+  std::map<std::string, std::vector<uint32_t>> checksums_;
 };
 
 void to_json(nlohmann::json& j, const RDGPartHeader& header);
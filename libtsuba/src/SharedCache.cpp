@@ -0,0 +1,155 @@
+#include "SharedCache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "tsuba/Errors.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// Closes a file descriptor when it goes out of scope
+struct FdCloser {
+  int fd;
+  ~FdCloser() {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+};
+
+/// \returns true if the \param key.size() bytes at \param offset of the
+/// file open as \param fd are \param key
+katana::Result<bool>
+HoldsKey(int fd, uint64_t offset, const std::string& key) {
+  std::string stored(key.size(), '\0');
+  for (uint64_t done = 0; done < stored.size();) {
+    ssize_t ret =
+        pread(fd, stored.data() + done, stored.size() - done, offset + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "reading entry key");
+    }
+    if (ret == 0) {
+      return false;
+    }
+    done += ret;
+  }
+  return stored == key;
+}
+
+}  // namespace
+
+tsuba::SharedCache*
+tsuba::SharedCache::Get() {
+  static std::unique_ptr<SharedCache> cache = []() {
+    std::string dir;
+    if (!katana::GetEnv("KATANA_SHARED_CACHE_DIR", &dir) || dir.empty()) {
+      return std::unique_ptr<SharedCache>();
+    }
+    return std::make_unique<SharedCache>(dir);
+  }();
+  return cache.get();
+}
+
+std::string
+tsuba::SharedCache::EntryPath(const std::string& uri, uint64_t size) const {
+  return fmt::format(
+      "{}/{:016x}-{}", dir_, std::hash<std::string>{}(uri), size);
+}
+
+katana::Result<void*>
+tsuba::SharedCache::Map(const std::string& uri, uint64_t size) const {
+  std::string path = EntryPath(uri, size);
+  FdCloser file{open(path.c_str(), O_RDONLY)};
+  if (file.fd < 0) {
+    if (errno == ENOENT) {
+      return static_cast<void*>(nullptr);
+    }
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+  }
+
+  // The entry is the copy followed by the URI it copies. Check the URI
+  // through the descriptor that is mapped below, so that an entry published
+  // in between cannot be mapped in place of the one checked.
+  struct stat stat_buf;
+  if (fstat(file.fd, &stat_buf) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "getting size of {}", path);
+  }
+  if (static_cast<uint64_t>(stat_buf.st_size) != size + uri.size()) {
+    return static_cast<void*>(nullptr);
+  }
+  auto key_res = HoldsKey(file.fd, size, uri);
+  if (!key_res) {
+    return key_res.error().WithContext("{}", path);
+  }
+  if (!key_res.value()) {
+    return static_cast<void*>(nullptr);
+  }
+
+  void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, file.fd, 0);
+  if (map == MAP_FAILED) {
+    return KATANA_ERROR(katana::ResultErrno(), "mapping {}", path);
+  }
+  return map;
+}
+
+katana::Result<void>
+tsuba::SharedCache::Publish(
+    const std::string& uri, const void* data, uint64_t size) const {
+  if (boost::system::error_code err; !fs::create_directories(dir_, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating cache directory {}", dir_);
+    }
+  }
+
+  std::string path = EntryPath(uri, size);
+  std::string tmp_path = fmt::format("{}.tmp-{}", path, getpid());
+  FdCloser file{open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)};
+  if (file.fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "creating {}", tmp_path);
+  }
+
+  // Write through a mapping rather than with write, which memory file
+  // systems like hugetlbfs do not support
+  auto res = [&]() -> katana::Result<void> {
+    uint64_t entry_size = size + uri.size();
+    if (ftruncate(file.fd, entry_size) != 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "sizing {}", tmp_path);
+    }
+    void* map = mmap(
+        nullptr, entry_size, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd, 0);
+    if (map == MAP_FAILED) {
+      return KATANA_ERROR(katana::ResultErrno(), "mapping {}", tmp_path);
+    }
+    std::memcpy(map, data, size);
+    std::memcpy(static_cast<uint8_t*>(map) + size, uri.data(), uri.size());
+    if (munmap(map, entry_size) != 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "unmapping {}", tmp_path);
+    }
+    if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "publishing {}", path);
+    }
+    return katana::ResultSuccess();
+  }();
+  if (!res) {
+    unlink(tmp_path.c_str());
+  }
+  return res;
+}
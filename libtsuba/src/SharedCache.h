@@ -0,0 +1,51 @@
+#ifndef KATANA_LIBTSUBA_SHAREDCACHE_H_
+#define KATANA_LIBTSUBA_SHAREDCACHE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/Result.h"
+
+namespace tsuba {
+
+/// A cache of read-only file copies in shared memory, so that processes
+/// that load the same graph map one copy instead of each reading the files
+/// from storage.
+///
+/// The cache is a directory named by the KATANA_SHARED_CACHE_DIR environment
+/// variable, which should be on a memory file system such as /dev/shm (a
+/// tmpfs mounted with huge=always also backs entries with huge pages). The
+/// files of an RDG version are never modified, so an entry is named after
+/// the URI and size of the file it copies and never needs invalidating. The
+/// name holds only a hash of the URI, so an entry stores the full URI after
+/// the copy, and Map checks it to never return the entry of another file
+/// whose name collides. Entries are published with an atomic rename, so
+/// concurrent processes see either a complete entry or none. Remove the
+/// directory to free the memory.
+class SharedCache {
+public:
+  /// \returns the cache configured by the environment, or nullptr if there
+  ///     is none
+  static SharedCache* Get();
+
+  explicit SharedCache(std::string dir) : dir_(std::move(dir)) {}
+
+  /// Map the entry for the file at \param uri read-only.
+  ///
+  /// \returns the start of the mapping of \param size bytes, which the
+  ///     caller must munmap, or nullptr if the file is not cached
+  katana::Result<void*> Map(const std::string& uri, uint64_t size) const;
+
+  /// Copy \param size bytes at \param data into the entry for \param uri
+  katana::Result<void> Publish(
+      const std::string& uri, const void* data, uint64_t size) const;
+
+private:
+  std::string EntryPath(const std::string& uri, uint64_t size) const;
+
+  std::string dir_;
+};
+
+}  // namespace tsuba
+
+#endif
@@ -0,0 +1,172 @@
+#include "UploadStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "Checksums.h"
+#include "GlobalState.h"
+#include "katana/Logging.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/IOStats.h"
+
+tsuba::UploadStream::UploadStream(
+    std::string uri, std::unique_ptr<MultipartUpload> upload,
+    uint64_t part_size)
+    : uri_(std::move(uri)), upload_(std::move(upload)), part_size_(part_size) {
+  buffer_.reserve(part_size_);
+}
+
+tsuba::UploadStream::~UploadStream() {
+  if (finished_) {
+    return;
+  }
+  // The parts in flight use the buffers of this stream
+  for (Part& part : in_flight_) {
+    part.done.wait();
+  }
+  upload_->Abort();
+}
+
+void
+tsuba::UploadStream::PutPart() {
+  Part part{.data = std::move(buffer_)};
+  // Every part but the last is a whole number of checksum blocks
+  std::vector<uint32_t> sums =
+      BlockChecksums(part.data.data(), part.data.size());
+  checksums_.insert(checksums_.end(), sums.begin(), sums.end());
+  part.done = TimeIOAsync(
+      IOOp::kPut, part.data.size(),
+      upload_->PutPartAsync(next_part_++, part.data.data(), part.data.size()));
+  in_flight_.emplace_back(std::move(part));
+  buffer_ = std::move(spare_);
+  buffer_.clear();
+  buffer_.reserve(part_size_);
+  spare_ = std::vector<uint8_t>();
+}
+
+katana::Result<void>
+tsuba::UploadStream::WaitForOldest() {
+  Part& part = in_flight_.front();
+  uint32_t number = next_part_ - in_flight_.size();
+  auto res = WaitForPart(uri_, number, std::move(part.done), [&]() {
+    return TimeIOAsync(
+        IOOp::kPut, part.data.size(),
+        upload_->PutPartAsync(number, part.data.data(), part.data.size()));
+  });
+  spare_ = std::move(part.data);
+  in_flight_.pop_front();
+  if (!res) {
+    return res.error().WithContext("part {} of {}", number, uri_);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::UploadStream::Finish() {
+  auto res = [&]() -> katana::Result<void> {
+    if (error_) {
+      std::ostringstream message;
+      message << *error_;
+      return katana::ErrorInfo(error_->error_code(), message.str());
+    }
+    // An empty file is one empty part
+    if (!buffer_.empty() || next_part_ == 0) {
+      PutPart();
+    }
+    while (!in_flight_.empty()) {
+      if (auto res = WaitForOldest(); !res) {
+        return res.error();
+      }
+    }
+    return upload_->Complete();
+  }();
+  if (res) {
+    finished_ = true;
+    SetChecksums(uri_, std::move(checksums_));
+  }
+  return res;
+}
+
+arrow::Status
+tsuba::UploadStream::Close() {
+  closed_ = true;
+  return arrow::Status::OK();
+}
+
+arrow::Result<int64_t>
+tsuba::UploadStream::Tell() const {
+  return position_;
+}
+
+bool
+tsuba::UploadStream::closed() const {
+  return closed_;
+}
+
+arrow::Status
+tsuba::UploadStream::Write(const void* data, int64_t nbytes) {
+  if (closed_) {
+    return arrow::Status(arrow::StatusCode::Invalid, "UploadStream is closed");
+  }
+  if (nbytes < 0) {
+    return arrow::Status(
+        arrow::StatusCode::Invalid, "Cannot Write negative bytes");
+  }
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  uint64_t remaining = nbytes;
+  while (remaining > 0) {
+    if (error_) {
+      return arrow::Status::IOError("UploadStream: ", *error_);
+    }
+    uint64_t count = std::min(remaining, part_size_ - buffer_.size());
+    buffer_.insert(buffer_.end(), bytes, bytes + count);
+    bytes += count;
+    remaining -= count;
+    position_ += count;
+    if (buffer_.size() < part_size_) {
+      continue;
+    }
+    if (in_flight_.size() >= kMultipartPartsInFlight) {
+      if (auto res = WaitForOldest(); !res) {
+        error_.emplace(res.error());
+        continue;
+      }
+    }
+    PutPart();
+  }
+  return arrow::Status::OK();
+}
+
+katana::Result<std::shared_ptr<arrow::io::OutputStream>>
+tsuba::MakeStoreStream(const std::string& uri, uint64_t bytes) {
+  if (bytes >= kStreamingThreshold) {
+    auto fs_res = FS(uri);
+    if (!fs_res) {
+      return fs_res.error();
+    }
+    auto upload_res =
+        fs_res.value()->StartMultipartUpload(uri, kMultipartPartSize);
+    if (!upload_res) {
+      return upload_res.error().WithContext("starting upload of {}", uri);
+    }
+    if (upload_res.value()) {
+      return std::make_shared<UploadStream>(
+          uri, std::move(upload_res.value()), kMultipartPartSize);
+    }
+  }
+  auto ff = std::make_shared<FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error().WithContext("creating output buffer");
+  }
+  ff->Bind(uri);
+  return ff;
+}
+
+katana::Result<void>
+tsuba::FinishStoreStream(arrow::io::OutputStream* stream) {
+  if (auto* upload = dynamic_cast<UploadStream*>(stream)) {
+    return upload->Finish();
+  }
+  return static_cast<FileFrame*>(stream)->Persist();
+}
@@ -0,0 +1,96 @@
+#ifndef KATANA_LIBTSUBA_UPLOADSTREAM_H_
+#define KATANA_LIBTSUBA_UPLOADSTREAM_H_
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/io/interfaces.h>
+
+#include "MultipartTransfer.h"
+#include "katana/Result.h"
+#include "tsuba/FileStorage.h"
+
+namespace tsuba {
+
+/// Files at least this large are written straight into a multipart upload
+/// if their storage has them, instead of into a FileFrame that is stored
+/// once the whole file is written
+constexpr uint64_t kStreamingThreshold = kMultipartThreshold;
+/// The memory that writing into an upload holds: the parts in flight, the
+/// part filling and the one being retried
+constexpr uint64_t kStreamingBytes =
+    (kMultipartPartsInFlight + 2) * kMultipartPartSize;
+
+/// An output stream that puts what is written to it as the parts of a
+/// multipart upload as they fill, instead of holding the whole file like a
+/// FileFrame, so that writing a file overlaps uploading it and holds at most
+/// kMultipartPartsInFlight parts besides the one filling.
+class UploadStream : public arrow::io::OutputStream {
+public:
+  UploadStream(
+      std::string uri, std::unique_ptr<MultipartUpload> upload,
+      uint64_t part_size);
+  /// Aborts the upload unless it finished
+  ~UploadStream() override;
+
+  UploadStream(const UploadStream&) = delete;
+  UploadStream& operator=(const UploadStream&) = delete;
+
+  /// Put the last part and complete the upload
+  katana::Result<void> Finish();
+
+  ///// Begin arrow::io::OutputStream methods ///////
+
+  arrow::Status Close() override;
+  arrow::Result<int64_t> Tell() const override;
+  bool closed() const override;
+  arrow::Status Write(const void* data, int64_t nbytes) override;
+
+  ///// End arrow::io::OutputStream methods ///////
+
+private:
+  struct Part {
+    std::vector<uint8_t> data;
+    std::future<katana::Result<void>> done;
+  };
+
+  /// Put the bytes buffered as the next part
+  void PutPart();
+  /// Wait for the oldest part in flight, keeping its memory for reuse
+  katana::Result<void> WaitForOldest();
+
+  std::string uri_;
+  std::unique_ptr<MultipartUpload> upload_;
+  uint64_t part_size_;
+
+  std::vector<uint8_t> buffer_;
+  /// The block checksums of the parts put so far
+  std::vector<uint32_t> checksums_;
+  /// The memory of the last part finished, for the next buffer
+  std::vector<uint8_t> spare_;
+  std::deque<Part> in_flight_;
+  uint32_t next_part_{0};
+  uint64_t position_{0};
+  /// The first error of a part, which fails the writes after it
+  std::optional<katana::CopyableErrorInfo> error_;
+  bool closed_{false};
+  bool finished_{false};
+};
+
+/// The stream that a file of about \param bytes bytes is written into for
+/// uri: an UploadStream if it is large and its storage has multipart
+/// uploads, else a FileFrame bound to uri
+katana::Result<std::shared_ptr<arrow::io::OutputStream>> MakeStoreStream(
+    const std::string& uri, uint64_t bytes);
+
+/// Store what was written into \param stream, made by MakeStoreStream
+katana::Result<void> FinishStoreStream(arrow::io::OutputStream* stream);
+
+}  // namespace tsuba
+
+#endif
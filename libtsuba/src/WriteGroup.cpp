@@ -1,8 +1,10 @@
 #include "tsuba/WriteGroup.h"
 
 #include "GlobalState.h"
+#include "MultipartTransfer.h"
 #include "katana/Random.h"
 #include "katana/Result.h"
+#include "tsuba/IOScheduler.h"
 
 template <typename T>
 using Result = katana::Result<T>;
@@ -32,27 +34,11 @@ WriteGroup::Finish() {
 }
 
 void
-WriteGroup::AddOp(
-    std::future<katana::Result<void>> future, std::string file,
-    uint64_t accounted_size) {
-  if (accounted_size > kMaxOutstandingSize) {
-    accounted_size = kMaxOutstandingSize;
-  }
-  if (accounted_size > 0) {
-    while (outstanding_size_ + accounted_size > kMaxOutstandingSize) {
-      if (!async_op_group_.FinishOne()) {
-        KATANA_LOG_ERROR(
-            "outstanding_size should be zero if we couldn't drain");
-        break;
-      }
-    }
-  }
+WriteGroup::AddOp(std::future<katana::Result<void>> future, std::string file) {
+  files_.emplace_back(file);
   async_op_group_.AddOp(
       std::move(future), std::move(file),
-      [wg = this, accounted_size]() -> katana::Result<void> {
-        wg->outstanding_size_ -= accounted_size;
-        return katana::ResultSuccess();
-      });
+      []() -> katana::Result<void> { return katana::ResultSuccess(); });
 }
 
 // shared pointer because FileFrames are often held that way due do the way
@@ -63,10 +49,24 @@ WriteGroup::StartStore(std::shared_ptr<FileFrame> ff) {
   uint64_t size = ff->map_size();
 
   // wrap future to hold onto FileFrame, but free it as soon as possible
-  auto future = std::async(std::launch::async, [ff = std::move(ff)]() mutable {
-    return ff->PersistAsync().get();
-  });
-  AddOp(std::move(future), file, size);
+  auto future = IOScheduler::Get()->Schedule<void>(
+      file, IOPriority::Topology, size,
+      [ff = std::move(ff)]() mutable -> katana::Result<void> {
+        auto res = ff->Persist();
+        ff.reset();
+        return res;
+      });
+  AddOp(std::move(future), file);
+}
+
+void
+WriteGroup::StartStore(
+    const std::string& file, const uint8_t* buf, uint64_t size) {
+  auto future = IOScheduler::Get()->Schedule<void>(
+      file, IOPriority::Topology, size, [file, buf, size]() {
+        return MultipartPut(file, buf, size);
+      });
+  AddOp(std::move(future), file);
 }
 
 }  // namespace tsuba
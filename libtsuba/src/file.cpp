@@ -12,70 +12,182 @@
 #include <fstream>
 #include <iostream>
 #include <mutex>
+#include <optional>
 #include <unordered_map>
 
+#include "BlockCache.h"
+#include "Checksums.h"
 #include "GlobalState.h"
 #include "katana/Logging.h"
 #include "katana/Platform.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
+#include "tsuba/IOStats.h"
+
+namespace {
+
+/// A future of error, made on the thread that waits for it
+std::future<katana::Result<void>>
+FailedFuture(const katana::ErrorInfo& error) {
+  katana::CopyableErrorInfo copy(error);
+  return std::async(std::launch::deferred, [copy]() -> katana::Result<void> {
+    return KATANA_ERROR(copy.error_code(), "{}", copy);
+  });
+}
+
+}  // namespace
 
 katana::Result<void>
 tsuba::FileStore(const std::string& uri, const void* data, uint64_t size) {
-  return FS(uri)->PutMultiSync(uri, static_cast<const uint8_t*>(data), size);
+  auto fs_res = FS(uri);
+  if (!fs_res) {
+    return fs_res.error();
+  }
+  if (auto res = TimeIO(
+          IOOp::kPut, size,
+          [&]() {
+            return fs_res.value()->PutMultiSync(
+                uri, static_cast<const uint8_t*>(data), size);
+          });
+      !res) {
+    return res.error();
+  }
+  RecordChecksums(uri, static_cast<const uint8_t*>(data), size);
+  return katana::ResultSuccess();
 }
 
 std::future<katana::Result<void>>
 tsuba::FileStoreAsync(const std::string& uri, const void* data, uint64_t size) {
-  return FS(uri)->PutAsync(uri, static_cast<const uint8_t*>(data), size);
+  auto fs_res = FS(uri);
+  if (!fs_res) {
+    return FailedFuture(fs_res.error());
+  }
+  // No reader binds the file before the store finishes
+  RecordChecksums(uri, static_cast<const uint8_t*>(data), size);
+  return TimeIOAsync(
+      IOOp::kPut, size,
+      fs_res.value()->PutAsync(uri, static_cast<const uint8_t*>(data), size));
 }
 
 katana::Result<void>
 tsuba::FileGet(
     const std::string& uri, void* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetMultiSync(
-      uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  if (BlockCache::Get() == nullptr) {
+    auto fs_res = FS(uri);
+    if (!fs_res) {
+      return fs_res.error();
+    }
+    return TimeIO(IOOp::kGet, size, [&]() {
+      return fs_res.value()->GetMultiSync(
+          uri, begin, size, static_cast<uint8_t*>(result_buffer));
+    });
+  }
+  return FileGetAsync(uri, result_buffer, begin, size).get();
 }
 
 std::future<katana::Result<void>>
 tsuba::FileGetAsync(
     const std::string& uri, void* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetAsync(
-      uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  auto* buf = static_cast<uint8_t*>(result_buffer);
+  auto fs_res = FS(uri);
+  if (!fs_res) {
+    return FailedFuture(fs_res.error());
+  }
+  FileStorage* fs = fs_res.value();
+  BlockCache* cache = BlockCache::Get();
+  std::optional<StatBuf> stat;
+  if (cache != nullptr) {
+    stat = cache->Version(uri);
+  }
+  if (!stat) {
+    return TimeIOAsync(IOOp::kGet, size, fs->GetAsync(uri, begin, size, buf));
+  }
+  if (cache->Read(uri, *stat, begin, size, buf)) {
+    return std::async(std::launch::deferred, []() -> katana::Result<void> {
+      return katana::ResultSuccess();
+    });
+  }
+
+  // Cache the blocks of what the storage returns
+  auto fetch =
+      TimeIOAsync(IOOp::kGet, size, fs->GetAsync(uri, begin, size, buf));
+  return std::async(
+      std::launch::deferred,
+      [cache, uri, stat = *stat, begin, size, buf,
+       fetch = std::move(fetch)]() mutable -> katana::Result<void> {
+        if (auto res = fetch.get(); !res) {
+          return res.error();
+        }
+        if (auto res = cache->Insert(uri, stat, begin, size, buf); !res) {
+          KATANA_LOG_WARN("not caching blocks of {}: {}", uri, res.error());
+        }
+        return katana::ResultSuccess();
+      });
 }
 
 katana::Result<void>
 tsuba::FileRemoteCopy(
     const std::string& source_uri, const std::string& dest_uri, uint64_t begin,
     uint64_t size) {
-  auto source_fs = FS(source_uri);
-  auto dest_fs = FS(dest_uri);
+  auto source_res = FS(source_uri);
+  if (!source_res) {
+    return source_res.error();
+  }
+  auto dest_res = FS(dest_uri);
+  if (!dest_res) {
+    return dest_res.error();
+  }
 
-  if (source_fs != dest_fs) {
+  if (source_res.value() != dest_res.value()) {
     KATANA_LOG_ERROR("cannot copy between different back-ends");
     return ErrorCode::NotImplemented;
   }
 
-  return dest_fs->RemoteCopy(source_uri, dest_uri, begin, size);
+  return TimeIO(IOOp::kCopy, size, [&]() {
+    return dest_res.value()->RemoteCopy(source_uri, dest_uri, begin, size);
+  });
 }
 
 katana::Result<void>
 tsuba::FileStat(const std::string& uri, StatBuf* s_buf) {
-  return FS(uri)->Stat(uri, s_buf);
+  auto fs_res = FS(uri);
+  if (!fs_res) {
+    return fs_res.error();
+  }
+  FileStorage* fs = fs_res.value();
+  if (auto res = TimeIO(IOOp::kStat, 0, [&]() { return fs->Stat(uri, s_buf); });
+      !res) {
+    return res.error();
+  }
+  if (BlockCache* cache = BlockCache::Get(); cache != nullptr) {
+    cache->NoteVersion(uri, *s_buf);
+  }
+  return katana::ResultSuccess();
 }
 
 std::future<katana::Result<void>>
 tsuba::FileListAsync(
     const std::string& directory, std::vector<std::string>* list,
     std::vector<uint64_t>* size) {
-  return FS(directory)->ListAsync(directory, list, size);
+  auto fs_res = FS(directory);
+  if (!fs_res) {
+    return FailedFuture(fs_res.error());
+  }
+  return TimeIOAsync(
+      IOOp::kList, 0, fs_res.value()->ListAsync(directory, list, size));
 }
 
 katana::Result<void>
 tsuba::FileDelete(
     const std::string& directory,
     const std::unordered_set<std::string>& files) {
-  return FS(directory)->Delete(directory, files);
+  auto fs_res = FS(directory);
+  if (!fs_res) {
+    return fs_res.error();
+  }
+  return TimeIO(IOOp::kDelete, 0, [&]() {
+    return fs_res.value()->Delete(directory, files);
+  });
 }
@@ -1,5 +1,6 @@
 #include "tsuba/tsuba.h"
 
+#include "CachingNameServerClient.h"
 #include "GlobalState.h"
 #include "RDGHandleImpl.h"
 #include "katana/Backtrace.h"
@@ -145,7 +146,11 @@ tsuba::Create(const std::string& name) {
   }
 
   // NS handles MPI coordination
-  if (auto res = tsuba::NS()->CreateIfAbsent(uri, meta); !res) {
+  auto ns_res = tsuba::NS();
+  if (!ns_res) {
+    return ns_res.error();
+  }
+  if (auto res = ns_res.value()->CreateIfAbsent(uri, meta); !res) {
     return res.error().WithContext(
         "failed to create RDG name: {}", uri.string());
   }
@@ -175,7 +180,11 @@ tsuba::RegisterIfAbsent(const std::string& name) {
   }
   RDGMeta meta = std::move(meta_res.value());
 
-  return tsuba::NS()->CreateIfAbsent(meta.dir(), meta);
+  auto ns_res = tsuba::NS();
+  if (!ns_res) {
+    return ns_res.error();
+  }
+  return ns_res.value()->CreateIfAbsent(meta.dir(), meta);
 }
 
 katana::Result<void>
@@ -193,8 +202,11 @@ tsuba::Forget(const std::string& name) {
   }
 
   // NS ensures only host 0 creates
-  auto res = tsuba::NS()->Delete(uri);
-  return res;
+  auto ns_res = tsuba::NS();
+  if (!ns_res) {
+    return ns_res.error();
+  }
+  return ns_res.value()->Delete(uri);
 }
 
 katana::Result<tsuba::RDGStat>
@@ -249,6 +261,14 @@ tsuba::Init(katana::CommBackend* comm) {
     return client_res.error();
   }
   default_ns_client = std::move(client_res.value());
+  // Cache name server entries for this many milliseconds, see
+  // CachingNameServerClient
+  int cache_ttl_ms = 0;
+  katana::GetEnv("KATANA_NAME_SERVER_CACHE_TTL_MS", &cache_ttl_ms);
+  if (cache_ttl_ms > 0) {
+    default_ns_client = std::make_unique<CachingNameServerClient>(
+        std::move(default_ns_client), std::chrono::milliseconds(cache_ttl_ms));
+  }
   katana::InitBacktrace();
   return GlobalState::Init(comm, default_ns_client.get());
 }
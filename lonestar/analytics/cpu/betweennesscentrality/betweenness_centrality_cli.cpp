@@ -60,13 +60,22 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         clEnumValN(
             BetweennessCentralityPlan::kLevel, "Level",
             "Level parallel algorithm"),
-        // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
+        clEnumValN(
+            BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
-            "Outer parallel algorithm")
+            "Outer parallel algorithm"),
+        clEnumValN(
+            BetweennessCentralityPlan::kMultiSource, "MultiSource",
+            "Batched multi-source BFS algorithm")
         // clEnumValN(BetweennessCentralityPlan::kAutoAlgo, "Auto", "Auto: choose among the algorithms automatically")
         ),
     cll::init(BetweennessCentralityPlan::kLevel));
+static cll::opt<uint32_t> sourcesPerBatch(
+    "sourcesPerBatch",
+    cll::desc("Number of sources searched together by the MultiSource "
+              "algorithm (at most 64)"),
+    cll::init(BetweennessCentralityPlan::kDefaultSourcesPerBatch));
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -91,6 +100,9 @@ main(int argc, char** argv) {
 
   BetweennessCentralityPlan plan =
       BetweennessCentralityPlan::FromAlgorithm(algo);
+  if (algo == BetweennessCentralityPlan::kMultiSource) {
+    plan = BetweennessCentralityPlan::MultiSource(sourcesPerBatch);
+  }
 
   BetweennessCentralitySources sources = kBetweennessCentralityAllNodes;
   uint32_t num_sources = pg->num_nodes();
@@ -68,7 +68,10 @@ static cll::opt<ConnectedComponentsPlan::Algorithm> algo(
             "Afforest (edge-wise) sampling algorithm"),
         clEnumValN(
             ConnectedComponentsPlan::kEdgeTiledAfforest, "EdgeTiledAfforest",
-            "Afforest (tiled edge-wise) sampling algorithm")),
+            "Afforest (tiled edge-wise) sampling algorithm"),
+        clEnumValN(
+            ConnectedComponentsPlan::kAfforestCompact, "AfforestCompact",
+            "Afforest sampling algorithm on a 32-bit parent array")),
     cll::init(ConnectedComponentsPlan::kAfforest));
 
 static cll::opt<uint32_t> edgeTileSize(
@@ -115,6 +118,8 @@ AlgorithmName(ConnectedComponentsPlan::Algorithm algorithm) {
     return "EdgeAfforest";
   case ConnectedComponentsPlan::kEdgeTiledAfforest:
     return "EdgeTiledAfforest";
+  case ConnectedComponentsPlan::kAfforestCompact:
+    return "AfforestCompact";
   default:
     return "Unknown";
   }
@@ -202,6 +207,14 @@ main(int argc, char** argv) {
     plan = ConnectedComponentsPlan::EdgeTiledAfforest(
         neighborSampleSize, componentSampleFrequency);
     break;
+  case ConnectedComponentsPlan::kAfforestCompact:
+    katana::gInfo(
+        "INFO: Using neighbor sample size: ", neighborSampleSize,
+        " component sample frequency: ", componentSampleFrequency);
+    katana::gInfo("WARNING: Performance may vary due to the parameters");
+    plan = ConnectedComponentsPlan::AfforestCompact(
+        neighborSampleSize, componentSampleFrequency);
+    break;
   default:
     std::cerr << "Invalid algorithm\n";
     abort();
@@ -60,7 +60,11 @@ cll::opt<IndependentSetPlan::Algorithm> algo(
             "prio algo based on Martin's GPU ECL-MIS algorithm (default)"),
         clEnumValN(
             IndependentSetPlan::kEdgeTiledPriority, "EdgeTiledPriority",
-            "edge-tiled prio algo based on Martin's GPU ECL-MIS algorithm")),
+            "edge-tiled prio algo based on Martin's GPU ECL-MIS algorithm"),
+        clEnumValN(
+            IndependentSetPlan::kBitsetPriority, "BitsetPriority",
+            "prio algo over bitset-packed states, revisiting only undecided "
+            "nodes")),
     cll::init(IndependentSetPlan::kPriority));
 
 }  // namespace
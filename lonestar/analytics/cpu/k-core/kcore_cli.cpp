@@ -47,8 +47,10 @@ static cll::opt<KCorePlan::Algorithm> algo(
         clEnumValN(
             KCorePlan::kSynchronous, "Synchronous", "Synchronous algorithm"),
         clEnumValN(
-            KCorePlan::kAsynchronous, "Asynchronous",
-            "Asynchronous algorithm")),
+            KCorePlan::kAsynchronous, "Asynchronous", "Asynchronous algorithm"),
+        clEnumValN(
+            KCorePlan::kDecomposition, "Decomposition",
+            "Coreness of every node by bucketed peeling")),
     cll::init(KCorePlan::kSynchronous));
 
 //! Required k specification for k-core.
@@ -65,6 +67,8 @@ AlgorithmName(KCorePlan::Algorithm algorithm) {
     return "Synchronous";
   case KCorePlan::kAsynchronous:
     return "Asynchronous";
+  case KCorePlan::kDecomposition:
+    return "Decomposition";
   default:
     return "Unknown";
   }
@@ -104,16 +108,32 @@ main(int argc, char** argv) {
   case KCorePlan::kAsynchronous:
     plan = KCorePlan::Asynchronous();
     break;
+  case KCorePlan::kDecomposition:
+    plan = KCorePlan::Decomposition();
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
-  if (auto r = KCore(pg.get(), kCoreNumber, "node-in-core", plan); !r) {
+  //! The decomposition outputs the coreness of each node instead of a flag.
+  bool decomposition = algo == KCorePlan::kDecomposition;
+  std::string output_property_name =
+      decomposition ? "node-coreness" : "node-in-core";
+
+  if (decomposition) {
+    if (auto r = KCoreDecomposition(pg.get(), output_property_name); !r) {
+      KATANA_LOG_FATAL("Failed to compute core decomposition: {}", r.error());
+    }
+  } else if (auto r = KCore(pg.get(), kCoreNumber, output_property_name, plan);
+             !r) {
     KATANA_LOG_FATAL("Failed to compute k-core: {}", r.error());
   }
 
   auto stats_result =
-      KCoreStatistics::Compute(pg.get(), kCoreNumber, "node-in-core");
+      decomposition ? KCoreStatistics::ComputeDecomposition(
+                          pg.get(), kCoreNumber, output_property_name)
+                    : KCoreStatistics::Compute(
+                          pg.get(), kCoreNumber, output_property_name);
   if (!stats_result) {
     KATANA_LOG_FATAL(
         "Failed to compute KCore statistics: {}", stats_result.error());
@@ -122,7 +142,11 @@ main(int argc, char** argv) {
   stats.Print();
 
   if (!skipVerify) {
-    if (KCoreAssertValid(pg.get(), kCoreNumber, "node-in-core")) {
+    katana::Result<void> valid =
+        decomposition
+            ? KCoreDecompositionAssertValid(pg.get(), output_property_name)
+            : KCoreAssertValid(pg.get(), kCoreNumber, output_property_name);
+    if (valid) {
       std::cout << "Verification successful.\n";
     } else {
       KATANA_LOG_FATAL("verification failed");
@@ -130,7 +154,7 @@ main(int argc, char** argv) {
   }
 
   if (output) {
-    auto r = pg->GetNodePropertyTyped<uint32_t>("node-in-core");
+    auto r = pg->GetNodePropertyTyped<uint32_t>(output_property_name);
     if (!r) {
       KATANA_LOG_FATAL("Failed to get node property {}", r.error());
     }
@@ -0,0 +1,103 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/k_shortest_simple_paths/k_shortest_simple_paths.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Yen k Simple Shortest Paths";
+static const char* desc =
+    "Computes the k shortest simple paths from a source to a sink node in a "
+    "directed "
+    "graph";
+static const char* url = "yen_k_simple_shortest_paths";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+static cll::opt<unsigned int> startNode(
+    "startNode", cll::desc("Node to start search from (default value 0)"),
+    cll::init(1));
+static cll::opt<unsigned int> reportNode(
+    "reportNode", cll::desc("Node to report distance to(default value 1)"),
+    cll::init(1));
+static cll::opt<unsigned int> numPaths(
+    "numPaths",
+    cll::desc("Number of paths to compute from source to report node (default "
+              "value 10)"),
+    cll::init(10));
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  if (startNode >= pg->topology().num_nodes() ||
+      reportNode >= pg->topology().num_nodes()) {
+    KATANA_LOG_FATAL(
+        "failed to set report: {} or failed to set source: {}", reportNode,
+        startNode);
+  }
+
+  katana::reportPageAlloc("MeminfoPre");
+
+  auto paths_result = KShortestSimplePaths(
+      pg.get(), startNode, reportNode, numPaths, edge_property_name,
+      KShortestSimplePathsPlan::Yen());
+  if (!paths_result) {
+    KATANA_LOG_FATAL(
+        "Failed to run k shortest simple paths: {}", paths_result.error());
+  }
+  auto paths = paths_result.value();
+
+  katana::reportPageAlloc("MeminfoPost");
+
+  if (paths.paths.empty()) {
+    std::cout << "no shortest path exists from source to sink\n";
+  }
+  paths.Print();
+
+  if (!skipVerify) {
+    if (auto r = KShortestSimplePathsAssertValid(
+            pg.get(), startNode, reportNode, edge_property_name, paths);
+        r) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed: {}", r.error());
+    }
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -50,7 +50,10 @@ static cll::opt<KTrussPlan::Algorithm> algo(
             KTrussPlan::kBsp, "Bsp", "Bulk-synchronous parallel (default)"),
         clEnumValN(
             KTrussPlan::kBspCoreThenTruss, "BspCoreThenTruss",
-            "Compute k-1 core and then k-truss")),
+            "Compute k-1 core and then k-truss"),
+        clEnumValN(
+            KTrussPlan::kDecomposition, "Decomposition",
+            "Truss decomposition by peeling edges in order of support")),
     cll::init(KTrussPlan::kBsp));
 
 std::string
@@ -62,6 +65,8 @@ AlgorithmName(KTrussPlan::Algorithm algorithm) {
     return "BspJacobi";
   case KTrussPlan::kBspCoreThenTruss:
     return "BspCoreThenTruss";
+  case KTrussPlan::kDecomposition:
+    return "Decomposition";
   default:
     return "Unknown";
   }
@@ -108,6 +113,9 @@ main(int argc, char** argv) {
   case KTrussPlan::kBspCoreThenTruss:
     plan = KTrussPlan::BspCoreThenTruss();
     break;
+  case KTrussPlan::kDecomposition:
+    plan = KTrussPlan::Decomposition();
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm");
   }
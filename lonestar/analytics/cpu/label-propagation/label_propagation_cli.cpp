@@ -0,0 +1,121 @@
+#include <iostream>
+
+#include <katana/analytics/label_propagation/label_propagation.h>
+
+#include "Lonestar/BoilerPlate.h"
+
+using namespace katana::analytics;
+
+static const char* name = "Label Propagation";
+
+static const char* desc =
+    "Detects communities in the graph by propagating the most frequent "
+    "label among neighbors";
+
+static const char* url = "label_propagation";
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<LabelPropagationPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value Asynchronous):"),
+    cll::values(
+        clEnumValN(
+            LabelPropagationPlan::kSynchronous, "Synchronous",
+            "Deterministic rounds over the labels of the previous round"),
+        clEnumValN(
+            LabelPropagationPlan::kAsynchronous, "Asynchronous",
+            "Labels are updated in place")),
+    cll::init(LabelPropagationPlan::kAsynchronous));
+
+static cll::opt<uint32_t> maxIterations(
+    "maxIterations", cll::desc("Maximum number of rounds (default value 10)"),
+    cll::init(LabelPropagationPlan::kDefaultMaxIterations));
+
+std::string
+AlgorithmName(LabelPropagationPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case LabelPropagationPlan::kSynchronous:
+    return "Synchronous";
+  case LabelPropagationPlan::kAsynchronous:
+    return "Asynchronous";
+  default:
+    return "Unknown";
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    KATANA_LOG_FATAL(
+        "This application requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph.");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  std::cout << "Running " << AlgorithmName(algo) << " algorithm\n";
+
+  LabelPropagationPlan plan = LabelPropagationPlan();
+  switch (algo) {
+  case LabelPropagationPlan::kSynchronous:
+    plan = LabelPropagationPlan::Synchronous(maxIterations);
+    break;
+  case LabelPropagationPlan::kAsynchronous:
+    plan = LabelPropagationPlan::Asynchronous(maxIterations);
+    break;
+  default:
+    KATANA_LOG_FATAL("invalid algorithm");
+  }
+
+  if (auto r = LabelPropagation(pg.get(), "label", plan); !r) {
+    KATANA_LOG_FATAL("Failed to run LabelPropagation: {}", r.error());
+  }
+
+  auto stats_result = LabelPropagationStatistics::Compute(pg.get(), "label");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute LabelPropagation statistics: {}",
+        stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (LabelPropagationAssertValid(pg.get(), "label")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint64_t>("label");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(
+        uint64_t(results->length()) == pg->topology().num_nodes());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
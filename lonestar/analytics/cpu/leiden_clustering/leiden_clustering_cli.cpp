@@ -0,0 +1,134 @@
+#include <iostream>
+
+#include <katana/analytics/leiden_clustering/leiden_clustering.h>
+
+#include "Lonestar/BoilerPlate.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Leiden Clustering";
+
+static const char* desc =
+    "Computes the clusters in the graph using Leiden Clustering algorithm";
+
+static const char* url = "leiden_clustering";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<bool> enable_vf(
+    "enable_vf", cll::desc("Flag to enable vertex following optimization."),
+    cll::init(false));
+
+static cll::opt<double> modularity_threshold_per_round(
+    "modularity_threshold_per_round",
+    cll::desc("Threshold for modularity gain"), cll::init(0.01));
+
+static cll::opt<double> modularity_threshold_total(
+    "modularity_threshold_total",
+    cll::desc("Total modularity_threshold_total for modularity gain"),
+    cll::init(0.01));
+
+static cll::opt<uint32_t> max_iterations(
+    "max_iterations", cll::desc("Maximum number of iterations to execute"),
+    cll::init(10));
+
+static cll::opt<uint32_t> min_graph_size(
+    "min_graph_size", cll::desc("Minimum coarsened graph size"),
+    cll::init(100));
+
+static cll::opt<LeidenClusteringPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value DoAll):"),
+    cll::values(clEnumValN(
+        LeidenClusteringPlan::kDoAll, "DoAll",
+        "Use Katana do_all loop for conflict mitigation")),
+    cll::init(LeidenClusteringPlan::kDoAll));
+
+std::string
+AlgorithmName(LeidenClusteringPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case LeidenClusteringPlan::kDoAll:
+    return "DoAll";
+  default:
+    return "Unknown";
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    KATANA_LOG_FATAL(
+        "This application requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph.");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  std::cout << "Running " << AlgorithmName(algo) << " algorithm\n";
+
+  LeidenClusteringPlan plan = LeidenClusteringPlan();
+  switch (algo) {
+  case LeidenClusteringPlan::kDoAll:
+    plan = LeidenClusteringPlan::DoAll(
+        enable_vf, modularity_threshold_per_round, modularity_threshold_total,
+        max_iterations, min_graph_size);
+    break;
+  default:
+    KATANA_LOG_FATAL("invalid algorithm");
+  }
+
+  auto pg_result =
+      LeidenClustering(pg.get(), edge_property_name, "clusterId", plan);
+  if (!pg_result) {
+    KATANA_LOG_FATAL("Failed to run LeidenClustering: {}", pg_result.error());
+  }
+
+  auto stats_result = LeidenClusteringStatistics::Compute(
+      pg.get(), edge_property_name, "clusterId");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute LeidenClustering statistics: {}",
+        stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (LeidenClusteringAssertValid(
+            pg.get(), edge_property_name, "clusterId")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint64_t>("clusterId");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(
+        uint64_t(results->length()) == pg->topology().num_nodes());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -40,6 +40,10 @@ static cll::opt<LocalClusteringCoefficientPlan::Algorithm> algo(
         LocalClusteringCoefficientPlan::kOrderedCountPerThread,
         "orderedCountPerThread",
         "Ordered Simple Count using PerThreadStorage (default)")),
+    cll::values(clEnumValN(
+        LocalClusteringCoefficientPlan::kOrderedCountOwnerComputes,
+        "orderedCountOwnerComputes",
+        "Ordered Simple Count with per-edge counts collected by each node")),
     cll::init(LocalClusteringCoefficientPlan::kOrderedCountPerThread));
 
 static cll::opt<bool> relabel(
@@ -80,6 +84,10 @@ main(int argc, char** argv) {
     plan =
         LocalClusteringCoefficientPlan::OrderedCountPerThread(relabeling_flag);
     break;
+  case LocalClusteringCoefficientPlan::kOrderedCountOwnerComputes:
+    plan = LocalClusteringCoefficientPlan::OrderedCountOwnerComputes(
+        LocalClusteringCoefficientPlan::kDefaultEdgesSorted, relabeling_flag);
+    break;
   default:
     std::cerr << "Unknown algo: " << algo << "\n";
   }
@@ -19,6 +19,7 @@
 
 #include <iostream>
 
+#include <katana/analytics/label_propagation/label_propagation.h>
 #include <katana/analytics/louvain_clustering/louvain_clustering.h>
 
 #include "Lonestar/BoilerPlate.h"
@@ -42,6 +43,11 @@ static cll::opt<bool> enable_vf(
     "enable_vf", cll::desc("Flag to enable vertex following optimization."),
     cll::init(false));
 
+static cll::opt<bool> seed_label_propagation(
+    "seed_label_propagation",
+    cll::desc("Flag to start from the communities found by label propagation."),
+    cll::init(false));
+
 static cll::opt<double> modularity_threshold_per_round(
     "modularity_threshold_per_round",
     cll::desc("Threshold for modularity gain"), cll::init(0.01));
@@ -122,8 +128,17 @@ main(int argc, char** argv) {
     KATANA_LOG_FATAL("invalid algorithm");
   }
 
-  auto pg_result =
-      LouvainClustering(pg.get(), edge_property_name, "clusterId", plan);
+  katana::Result<void> pg_result = katana::ResultSuccess();
+  if (seed_label_propagation) {
+    if (auto r = LabelPropagation(pg.get(), "seedLabel"); !r) {
+      KATANA_LOG_FATAL("Failed to run LabelPropagation: {}", r.error());
+    }
+    pg_result = LouvainClusteringFromSeed(
+        pg.get(), edge_property_name, "seedLabel", "clusterId", plan);
+  } else {
+    pg_result =
+        LouvainClustering(pg.get(), edge_property_name, "clusterId", plan);
+  }
   if (!pg_result) {
     KATANA_LOG_FATAL("Failed to run LouvainClustering: {}", pg_result.error());
   }
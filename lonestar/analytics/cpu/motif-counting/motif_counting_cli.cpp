@@ -0,0 +1,111 @@
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/motif_count/motif_count.h"
+
+using namespace katana::analytics;
+
+constexpr static const char* const name = "Motif Counting";
+constexpr static const char* const desc =
+    "Counts the triangles, 4-cycles and 4-cliques of each node of a "
+    "symmetric graph, or computes the triad census of a directed graph";
+static const char* url = "motif_counting";
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<bool> relabel(
+    "relabel",
+    cll::desc("Relabel nodes of the graph (default value of false => "
+              "choose automatically)"),
+    cll::init(false));
+
+static cll::opt<bool> triadCensus(
+    "triadCensus",
+    cll::desc("Compute the directed triad census instead of the motifs of "
+              "each node (default value false)"),
+    cll::init(false));
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer total_timer("TimerTotal");
+  total_timer.start();
+
+  if (!triadCensus && !symmetricGraph) {
+    KATANA_DIE(
+        "This application requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph.");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  if (triadCensus) {
+    auto census_result = DirectedTriadCensus(pg.get());
+    if (!census_result) {
+      KATANA_LOG_FATAL(
+          "Failed to compute triad census: {}", census_result.error());
+    }
+    census_result.value().Print();
+    total_timer.stop();
+    return 0;
+  }
+
+  MotifCountPlan plan = MotifCountPlan::OrderedCount(
+      MotifCountPlan::kDefaultEdgeSorted,
+      relabel ? MotifCountPlan::kRelabel : MotifCountPlan::kAutoRelabel);
+
+  katana::reportPageAlloc("MeminfoPre");
+
+  if (auto r = MotifCount(
+          pg.get(), "triangles", "four-cycles", "four-cliques", plan);
+      !r) {
+    KATANA_LOG_FATAL("Failed to count motifs: {}", r.error());
+  }
+
+  katana::reportPageAlloc("MeminfoPost");
+
+  auto stats_result = MotifCountStatistics::Compute(
+      pg.get(), "triangles", "four-cycles", "four-cliques");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute motif count statistics: {}", stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (MotifCountAssertValid(
+            pg.get(), "triangles", "four-cycles", "four-cliques")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint64_t>("triangles");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(
+        uint64_t(results->length()) == pg->topology().num_nodes());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  total_timer.stop();
+
+  return 0;
+}
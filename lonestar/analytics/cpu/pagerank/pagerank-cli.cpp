@@ -46,10 +46,25 @@ static cll::opt<PagerankPlan::Algorithm> algo(
             PagerankPlan::kPullTopological, "PullTopological",
             "PullTopological"),
         clEnumValN(PagerankPlan::kPullResidual, "PullResidual", "PullResidual"),
+        clEnumValN(PagerankPlan::kPullBlocked, "PullBlocked", "PullBlocked"),
         clEnumValN(PagerankPlan::kPushSynchronous, "PushSync", "PushSync"),
         clEnumValN(PagerankPlan::kPushAsynchronous, "PushAsync", "PushAsync")),
     cll::init(PagerankPlan::kPushAsynchronous));
 
+static cll::opt<uint32_t> segmentSize(
+    "segmentSize",
+    cll::desc("Number of source nodes read together by PullBlocked"),
+    cll::init(PagerankPlan::kDefaultSegmentSize));
+
+static cll::opt<PagerankPlan::Precision> precision(
+    "precision",
+    cll::desc("Format of the values PullTopological and PullBlocked read "
+              "per edge:"),
+    cll::values(
+        clEnumValN(PagerankPlan::kFloat, "Float", "Float"),
+        clEnumValN(PagerankPlan::kBFloat16, "BFloat16", "BFloat16")),
+    cll::init(PagerankPlan::kFloat));
+
 //! Flag that forces user to be aware that they should be passing in a
 //! transposed graph.
 static cll::opt<bool> transposedGraph(
@@ -62,7 +77,8 @@ main(int argc, char** argv) {
       LonestarStart(argc, argv, name, desc, url, &inputFile);
 
   if ((algo == PagerankPlan::kPullResidual ||
-       algo == PagerankPlan::kPullTopological) &&
+       algo == PagerankPlan::kPullTopological ||
+       algo == PagerankPlan::kPullBlocked) &&
       !transposedGraph) {
     KATANA_DIE(
         "This application requires a transposed graph input;"
@@ -85,7 +101,8 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
-  PagerankPlan plan{kCPU, algo, tolerance, maxIterations, kAlpha};
+  PagerankPlan plan{kCPU,   algo,        tolerance, maxIterations,
+                    kAlpha, segmentSize, precision};
 
   if (auto r = Pagerank(pg.get(), "rank", plan); !r) {
     KATANA_LOG_FATAL("Failed to run Pagerank {}", r.error());
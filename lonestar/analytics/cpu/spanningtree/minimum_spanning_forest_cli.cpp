@@ -0,0 +1,103 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Boruvka's Minimum Spanning Tree Algorithm";
+static const char* desc = "Computes the minimum spanning forest of a graph";
+static const char* url = "mst";
+
+static cll::opt<std::string> inputFilename(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+static cll::opt<MinimumSpanningForestPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value Boruvka):"),
+    cll::values(clEnumValN(
+        MinimumSpanningForestPlan::kBoruvka, "Boruvka", "Boruvka")),
+    cll::init(MinimumSpanningForestPlan::kBoruvka));
+static cll::opt<std::string> outputPropertyName(
+    "outputPropertyName",
+    cll::desc("Name of the boolean edge property marking the forest edges "
+              "(default value in_forest)"),
+    cll::init("in_forest"));
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFilename);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFilename << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFilename, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  MinimumSpanningForestPlan plan;
+  switch (algo) {
+  case MinimumSpanningForestPlan::kBoruvka:
+    plan = MinimumSpanningForestPlan::Boruvka();
+    break;
+  default:
+    std::cerr << "Invalid algorithm\n";
+    abort();
+  }
+
+  katana::reportPageAlloc("MeminfoPre");
+
+  if (auto r = MinimumSpanningForest(
+          pg.get(), edge_property_name, outputPropertyName, plan);
+      !r) {
+    KATANA_LOG_FATAL("Failed to run minimum spanning forest: {}", r.error());
+  }
+
+  katana::reportPageAlloc("MeminfoPost");
+
+  auto stats_result = MinimumSpanningForestStatistics::Compute(
+      pg.get(), edge_property_name, outputPropertyName);
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute MinimumSpanningForest statistics: {}",
+        stats_result.error());
+  }
+  stats_result.value().Print();
+
+  if (!skipVerify) {
+    if (auto r = MinimumSpanningForestAssertValid(
+            pg.get(), edge_property_name, outputPropertyName);
+        r) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed: {}", r.error());
+    }
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -57,6 +57,16 @@ static cll::opt<bool> persistAllDistances(
 cll::opt<unsigned int> reportNode(
     "reportNode", cll::desc("Node to report distance to(default value 1)"),
     cll::init(1));
+static cll::opt<bool> pointToPoint(
+    "pointToPoint",
+    cll::desc("Only find a shortest path from each source node to the report "
+              "node, searching from both ends (default value false)"),
+    cll::init(false));
+static cll::opt<unsigned int> numLandmarks(
+    "landmarks",
+    cll::desc("With -pointToPoint, first build an index of this many "
+              "landmarks and guide the searches with it (default value 0)"),
+    cll::init(0));
 cll::opt<unsigned int> stepShift(
     "delta", cll::desc("Shift value for the deltastep (default value 13)"),
     cll::init(13));
@@ -174,6 +184,49 @@ main(int argc, char** argv) {
         std::istream_iterator<uint64_t>{});
   }
   uint32_t num_sources = startNodes.size();
+
+  if (pointToPoint) {
+    std::vector<std::pair<uint32_t, uint32_t>> queries;
+    for (auto startNode : startNodes) {
+      if (startNode >= pg->topology().num_nodes()) {
+        KATANA_LOG_FATAL("failed to set source: {}", startNode);
+      }
+      queries.emplace_back(startNode, reportNode);
+    }
+    ShortestPathPlan query_plan;
+    if (numLandmarks > 0) {
+      katana::StatTimer landmarks_time("TimerLandmarks");
+      landmarks_time.start();
+      if (auto r = ShortestPathLandmarks(
+              pg.get(), edge_property_name, "landmark", numLandmarks);
+          !r) {
+        KATANA_LOG_FATAL("Failed to build landmarks: {}", r.error());
+      }
+      landmarks_time.stop();
+      query_plan = ShortestPathPlan::Landmarks("landmark");
+    }
+    std::cout << "Running " << num_sources << " point-to-point queries\n";
+    auto paths_result =
+        ShortestPaths(pg.get(), queries, edge_property_name, query_plan);
+    if (!paths_result) {
+      KATANA_LOG_FATAL("Failed to run queries: {}", paths_result.error());
+    }
+    for (size_t i = 0; i < queries.size(); ++i) {
+      const ShortestPathResult& result = paths_result.value()[i];
+      std::cout << "Distance from " << queries[i].first << " to "
+                << reportNode << " = " << result.distance << "\n";
+      if (result.reachable()) {
+        std::cout << "Path:";
+        for (uint32_t n : result.path) {
+          std::cout << " " << n;
+        }
+        std::cout << "\n";
+      }
+    }
+    totalTime.stop();
+    return 0;
+  }
+
   std::cout << "Running BFS for " << num_sources << " sources\n";
 
   if (algo == SsspPlan::kDeltaStep || algo == SsspPlan::kDeltaTile ||
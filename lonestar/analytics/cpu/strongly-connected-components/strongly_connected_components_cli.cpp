@@ -0,0 +1,111 @@
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+using namespace katana::analytics;
+
+constexpr static const char* const name = "Strongly Connected Components";
+constexpr static const char* const desc =
+    "Computes the strongly connected components of a directed graph";
+static const char* url = "strongly_connected_components";
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<StronglyConnectedComponentsPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value ForwardBackward):"),
+    cll::values(
+        clEnumValN(
+            StronglyConnectedComponentsPlan::kForwardBackward,
+            "ForwardBackward",
+            "Trimming, then forward-backward search from a pivot"),
+        clEnumValN(
+            StronglyConnectedComponentsPlan::kColoring, "Coloring",
+            "Trimming, then rounds of coloring")),
+    cll::init(StronglyConnectedComponentsPlan::kForwardBackward));
+
+std::string
+AlgorithmName(StronglyConnectedComponentsPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case StronglyConnectedComponentsPlan::kForwardBackward:
+    return "ForwardBackward";
+  case StronglyConnectedComponentsPlan::kColoring:
+    return "Coloring";
+  default:
+    return "Unknown";
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer total_timer("TimerTotal");
+  total_timer.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  std::cout << "Running " << AlgorithmName(algo) << "\n";
+
+  katana::reportPageAlloc("MeminfoPre");
+
+  StronglyConnectedComponentsPlan plan;
+  switch (algo) {
+  case StronglyConnectedComponentsPlan::kForwardBackward:
+    plan = StronglyConnectedComponentsPlan::ForwardBackward();
+    break;
+  case StronglyConnectedComponentsPlan::kColoring:
+    plan = StronglyConnectedComponentsPlan::Coloring();
+    break;
+  default:
+    KATANA_LOG_FATAL("Invalid algorithm");
+  }
+
+  if (auto r = StronglyConnectedComponents(pg.get(), "component", plan); !r) {
+    KATANA_LOG_FATAL(
+        "Failed to compute strongly connected components: {}", r.error());
+  }
+
+  auto stats_result =
+      StronglyConnectedComponentsStatistics::Compute(pg.get(), "component");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute strongly connected components statistics: {}",
+        stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (StronglyConnectedComponentsAssertValid(pg.get(), "component")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint64_t>("component");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(
+        uint64_t(results->length()) == pg->topology().num_nodes());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  total_timer.stop();
+
+  return 0;
+}
@@ -45,10 +45,15 @@ static cll::opt<std::string> nodesString(
     cll::init(""));
 static cll::opt<SubGraphExtractionPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm:"),
-    cll::values(clEnumValN(
-        SubGraphExtractionPlan::kNodeSet, "nodeSet",
-        "Extract subgraph topology from node set")),
-    cll::init(SubGraphExtractionPlan::kNodeSet));
+    cll::values(
+        clEnumValN(
+            SubGraphExtractionPlan::kNodeSet, "nodeSet",
+            "Extract subgraph topology from node set by binary search"),
+        clEnumValN(
+            SubGraphExtractionPlan::kNodeSetScan, "nodeSetScan",
+            "Extract subgraph topology from node set by scanning its edges "
+            "(default)")),
+    cll::init(SubGraphExtractionPlan::kNodeSetScan));
 
 int
 main(int argc, char** argv) {
@@ -62,7 +67,7 @@ main(int argc, char** argv) {
   std::unique_ptr<katana::PropertyGraph> pg =
       MakeFileGraph(inputFile, edge_property_name);
 
-  SubGraphExtractionPlan plan;
+  SubGraphExtractionPlan plan = SubGraphExtractionPlan::FromAlgorithm(algo);
 
   std::vector<uint32_t> node_vec;
   if (!nodesFile.getValue().empty()) {
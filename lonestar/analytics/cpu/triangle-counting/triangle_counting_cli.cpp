@@ -40,7 +40,10 @@ static cll::opt<TriangleCountPlan::Algorithm> algo(
             TriangleCountPlan::kEdgeIteration, "edgeiterator", "Edge Iterator"),
         clEnumValN(
             TriangleCountPlan::kOrderedCount, "orderedCount",
-            "Ordered Simple Count (default)")),
+            "Ordered Simple Count (default)"),
+        clEnumValN(
+            TriangleCountPlan::kSampling, "sampling",
+            "Colorful Sampling Estimate")),
     cll::init(TriangleCountPlan::kOrderedCount));
 
 static cll::opt<bool> relabel(
@@ -48,6 +51,18 @@ static cll::opt<bool> relabel(
     cll::desc("Relabel nodes of the graph (default value of false => "
               "choose automatically)"),
     cll::init(false));
+
+static cll::opt<double> relativeError(
+    "relativeError",
+    cll::desc("Relative error bound of the sampling estimate (default value "
+              "0.05)"),
+    cll::init(TriangleCountPlan::kDefaultRelativeError));
+
+static cll::opt<double> confidence(
+    "confidence",
+    cll::desc("Confidence of the sampling error bound (default value 0.9)"),
+    cll::init(TriangleCountPlan::kDefaultConfidence));
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -85,10 +100,24 @@ main(int argc, char** argv) {
     plan = TriangleCountPlan::OrderedCount(relabeling_flag);
     break;
 
+  case TriangleCountPlan::kSampling:
+    plan = TriangleCountPlan::Sampling(relativeError, confidence);
+    break;
+
   default:
     std::cerr << "Unknown algo: " << algo << "\n";
   }
 
+  if (algo == TriangleCountPlan::kSampling) {
+    auto estimate_result = EstimateTriangleCount(pg.get(), plan);
+    if (!estimate_result) {
+      KATANA_LOG_FATAL("failed to run algorithm: {}", estimate_result.error());
+    }
+    estimate_result.value().Print();
+    totalTime.stop();
+    return 0;
+  }
+
   auto num_triangles_result = TriangleCount(pg.get(), plan);
   if (!num_triangles_result) {
     KATANA_LOG_FATAL(
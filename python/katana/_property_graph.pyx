@@ -1,4 +1,13 @@
-from pyarrow.lib cimport pyarrow_unwrap_table, pyarrow_wrap_chunked_array, pyarrow_wrap_schema, to_shared
+from pyarrow.lib cimport (
+    CArray,
+    CUInt32Array,
+    CUInt64Array,
+    pyarrow_unwrap_table,
+    pyarrow_wrap_array,
+    pyarrow_wrap_chunked_array,
+    pyarrow_wrap_schema,
+    to_shared,
+)
 
 from .cpp.libgalois.graphs cimport Graph as CGraph
 from .cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
@@ -6,7 +15,7 @@ from .cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
 from .numba_support._pyarrow_wrappers import unchunked
 
 from libc.stdint cimport uint32_t
-from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.memory cimport shared_ptr, static_pointer_cast, unique_ptr
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 
@@ -158,6 +167,24 @@ cdef class PropertyGraphBase:
             raise IndexError(e)
         return self.topology().out_dests.get().Value(e)
 
+    def out_indices(self):
+        """
+        Return a `pyarrow` array with the end of the out-edges of each node: the edges of node `n` are the edge IDs
+        from `out_indices[n-1]` (0 for the first node) up to `out_indices[n]`.
+
+        The array shares memory with the topology of this graph and stays valid after the graph changes. Its
+        ``to_numpy()`` is a zero-copy view that can be bound to numba compiled operators, which then walk the
+        topology without calling back into the graph (see :py:func:`katana.numba_support.galois.edge_range`).
+        """
+        return pyarrow_wrap_array(static_pointer_cast[CArray, CUInt64Array](self.topology().out_indices))
+
+    def out_dests(self):
+        """
+        Return a `pyarrow` array with the destination node ID of each edge, sharing memory with the topology of this
+        graph like `out_indices`.
+        """
+        return pyarrow_wrap_array(static_pointer_cast[CArray, CUInt32Array](self.topology().out_dests))
+
     def get_node_property(self, prop):
         """
         Return a `pyarrow` array or chunked array storing the data for node property `prop`.
@@ -226,6 +253,36 @@ cdef class PropertyGraphBase:
         """
         handle_result_void(self.underlying_property_graph().UpsertEdgeProperties(pyarrow_unwrap_table(table)))
 
+    def add_node_property_from_expression(self, str name, str expression):
+        """
+        Insert a new node property of doubles holding the value of an arithmetic expression over node properties.
+        The expression is evaluated in parallel, without materializing intermediate values.
+
+        :param name: The name of the new property.
+        :param expression: An expression of numbers, property names (quoted in backticks if they are not
+            identifiers), ``+ - * /``, parentheses and the functions ``log``, ``exp``, ``sqrt``, ``abs``, ``pow``,
+            ``min``, ``max`` and ``degree()``, e.g., ``"0.3 * rank + log(degree())"``. A value is null if a property it
+            uses is null.
+        """
+        cdef string name_str = bytes(name, "utf-8")
+        cdef string expression_str = bytes(expression, "utf-8")
+        with nogil:
+            handle_result_void(CGraph.AddNodePropertyFromExpression(
+                self.underlying_property_graph(), name_str, expression_str))
+
+    def add_edge_property_from_expression(self, str name, str expression):
+        """
+        Insert a new edge property of doubles holding the value of an arithmetic expression over edge properties.
+
+        :param name: The name of the new property.
+        :param expression: An expression as for :py:meth:`add_node_property_from_expression`, without ``degree()``.
+        """
+        cdef string name_str = bytes(name, "utf-8")
+        cdef string expression_str = bytes(expression, "utf-8")
+        with nogil:
+            handle_result_void(CGraph.AddEdgePropertyFromExpression(
+                self.underlying_property_graph(), name_str, expression_str))
+
     def remove_node_property(self, prop):
         """
         Remove a node property from the graph by name or index.
@@ -238,6 +295,22 @@ cdef class PropertyGraphBase:
         """
         handle_result_void(self.underlying_property_graph().RemoveEdgeProperty(PropertyGraph._property_name_to_id(prop, self.edge_schema())))
 
+    def set_property_memory_budget(self, uint64_t max_bytes, spill_dir):
+        """
+        Keep the loaded properties within `max_bytes` by evicting the least recently used ones, which load again
+        when they are next used. Properties changed since the graph was written are first spilled to files in
+        `spill_dir`. A budget of 0 evicts nothing.
+        """
+        handle_result_void(
+            self.underlying_property_graph().SetPropertyMemoryBudget(max_bytes, bytes(str(spill_dir), encoding="UTF-8"))
+        )
+
+    def loaded_property_bytes(self):
+        """
+        The bytes of the buffers of the node and edge properties in memory.
+        """
+        return self.underlying_property_graph().loaded_property_bytes()
+
     def mark_all_properties_persistent(self):
         """
         Mark all properties (node and edge) to be stored when this graph is written.
@@ -354,3 +427,29 @@ cdef class PropertyGraph(PropertyGraphBase):
                 handle_result_GraphComponents(CGraph.ConvertGraphML(path_str, chunk_size, False))
                     .ToPropertyGraph())
         return PropertyGraph.make(pg)
+
+    @staticmethod
+    def from_all_partitions(path, node_properties=None, edge_properties=None):
+        """
+        Load every partition of a partitioned graph, in parallel, as one graph on this host. Its nodes are the masters
+        of the partitions, in partition order, with all of their edges and their properties.
+
+        :param path: the path or URL from which to load the graph.
+        :type path: str
+        :param node_properties: A list of node property names to load, or None (default) for all of them.
+        :param edge_properties: A list of edge property names to load, or None (default) for all of them.
+        :returns: the new :py:class:`~katana.property_graph.PropertyGraph`
+        """
+        cdef RDGLoadOptions opts
+        cdef vector[string] node_props
+        cdef vector[string] edge_props
+        if node_properties is not None:
+            node_props = _convert_string_list(node_properties)
+            opts.node_properties = &node_props
+        if edge_properties is not None:
+            edge_props = _convert_string_list(edge_properties)
+            opts.edge_properties = &edge_props
+        path_str = <string>bytes(str(path), "utf-8")
+        with nogil:
+            pg = handle_result_PropertyGraph(_PropertyGraph.MakeFromAllPartitions(path_str, opts))
+        return PropertyGraph.make(pg)
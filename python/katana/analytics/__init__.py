@@ -26,26 +26,58 @@ Algorithms
 
 .. automodule:: katana.analytics._bfs
 
+.. automodule:: katana.analytics._bipartite_matching
+
 .. automodule:: katana.analytics._connected_components
 
+.. automodule:: katana.analytics._graph_partition
+
+.. automodule:: katana.analytics._hyper_anf
+
+.. automodule:: katana.analytics._hypergraph_partition
+
 .. automodule:: katana.analytics._independent_set
 
 .. automodule:: katana.analytics._louvain_clustering
 
+.. automodule:: katana.analytics._leiden_clustering
+
 .. automodule:: katana.analytics._local_clustering_coefficient
 
 .. automodule:: katana.analytics._subgraph_extraction
 
+.. automodule:: katana.analytics._subgraph_match
+
 .. automodule:: katana.analytics._jaccard
 
 .. automodule:: katana.analytics._k_core
 
 .. automodule:: katana.analytics._k_truss
 
+.. automodule:: katana.analytics._label_propagation
+
+.. automodule:: katana.analytics._matrix_completion
+
+.. automodule:: katana.analytics._max_flow
+
+.. automodule:: katana.analytics._minimum_spanning_forest
+
+.. automodule:: katana.analytics._motif_count
+
+.. automodule:: katana.analytics._nearest_neighbors
+
+.. automodule:: katana.analytics._neighbor_aggregation
+
 .. automodule:: katana.analytics._pagerank
 
+.. automodule:: katana.analytics._points_to
+
+.. automodule:: katana.analytics._reachability_index
+
 .. automodule:: katana.analytics._sssp
 
+.. automodule:: katana.analytics._strongly_connected_components
+
 .. automodule:: katana.analytics._triangle_count
 
 .. automodule:: katana.analytics._wrappers
@@ -60,31 +92,132 @@ from katana.analytics._betweenness_centrality import (
     betweenness_centrality,
 )
 from katana.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid
+from katana.analytics._bipartite_matching import (
+    BipartiteMatchingPlan,
+    BipartiteMatchingStatistics,
+    bipartite_matching,
+    bipartite_matching_assert_valid,
+    weighted_bipartite_matching,
+    weighted_bipartite_matching_assert_valid,
+)
 from katana.analytics._connected_components import (
     ConnectedComponentsPlan,
     ConnectedComponentsStatistics,
     connected_components,
     connected_components_assert_valid,
 )
+from katana.analytics._graph_partition import (
+    GraphPartitionPlan,
+    GraphPartitionStatistics,
+    graph_partition,
+    graph_partition_assert_valid,
+)
+from katana.analytics._hyper_anf import HyperAnfPlan, HyperAnfStatistics, hyper_anf
+from katana.analytics._hypergraph_partition import (
+    HYPERGRAPH_PARTITION_CUT,
+    HyperGraphPartitionPlan,
+    HyperGraphPartitionStatistics,
+    hypergraph_partition,
+    hypergraph_partition_assert_valid,
+    make_hypergraph,
+)
 from katana.analytics._independent_set import (
     IndependentSetPlan,
     IndependentSetStatistics,
+    graph_coloring,
+    graph_coloring_assert_valid,
     independent_set,
     independent_set_assert_valid,
 )
 from katana.analytics._jaccard import JaccardPlan, JaccardStatistics, jaccard, jaccard_assert_valid
-from katana.analytics._k_core import KCorePlan, KCoreStatistics, k_core, k_core_assert_valid
-from katana.analytics._k_truss import KTrussPlan, KTrussStatistics, k_truss, k_truss_assert_valid
+from katana.analytics._k_core import (
+    KCorePlan,
+    KCoreStatistics,
+    k_core,
+    k_core_assert_valid,
+    k_core_decomposition,
+    k_core_decomposition_assert_valid,
+)
+from katana.analytics._k_truss import (
+    KTrussPlan,
+    KTrussStatistics,
+    k_truss,
+    k_truss_assert_valid,
+    k_truss_decomposition,
+    k_truss_decomposition_assert_valid,
+)
+from katana.analytics._label_propagation import (
+    LabelPropagationPlan,
+    LabelPropagationStatistics,
+    label_propagation,
+    label_propagation_assert_valid,
+)
+from katana.analytics._leiden_clustering import (
+    LeidenClusteringPlan,
+    LeidenClusteringStatistics,
+    leiden_clustering,
+    leiden_clustering_assert_valid,
+)
 from katana.analytics._local_clustering_coefficient import LocalClusteringCoefficientPlan, local_clustering_coefficient
 from katana.analytics._louvain_clustering import (
     LouvainClusteringPlan,
     LouvainClusteringStatistics,
     louvain_clustering,
     louvain_clustering_assert_valid,
+    louvain_clustering_from_seed,
+)
+from katana.analytics._matrix_completion import (
+    MatrixCompletionPlan,
+    MatrixCompletionStatistics,
+    matrix_completion,
+    matrix_completion_assert_valid,
+)
+from katana.analytics._max_flow import MaxFlowPlan, MaxFlowStatistics, max_flow, max_flow_assert_valid
+from katana.analytics._minimum_spanning_forest import (
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
+)
+from katana.analytics._motif_count import (
+    MotifCountPlan,
+    MotifCountStatistics,
+    directed_triad_census,
+    motif_count,
+    motif_count_assert_valid,
+)
+from katana.analytics._nearest_neighbors import (
+    NearestNeighborsPlan,
+    nearest_neighbors_build_index,
+    nearest_neighbors_query,
+)
+from katana.analytics._neighbor_aggregation import NeighborAggregationPlan, neighbor_aggregation
+from katana.analytics._pagerank import (
+    PagerankPlan,
+    PagerankStatistics,
+    pagerank,
+    pagerank_assert_valid,
+    pagerank_incremental,
+    pagerank_personalized,
+)
+from katana.analytics._points_to import PointsToPlan, PointsToStatistics, points_to, points_to_assert_valid
+from katana.analytics._reachability_index import (
+    REACHABILITY_INDEX_UNREACHABLE,
+    ReachabilityIndexPlan,
+    ReachabilityIndexStatistics,
+    reachability_index,
+    reachability_index_query,
+    reachability_index_reachable,
 )
-from katana.analytics._pagerank import PagerankPlan, PagerankStatistics, pagerank, pagerank_assert_valid
 from katana.analytics._sssp import SsspPlan, SsspStatistics, sssp, sssp_assert_valid
+from katana.analytics._strongly_connected_components import (
+    StronglyConnectedComponentsPlan,
+    StronglyConnectedComponentsStatistics,
+    strongly_connected_components,
+    strongly_connected_components_assert_valid,
+)
 from katana.analytics._subgraph_extraction import SubGraphExtractionPlan, subgraph_extraction
-from katana.analytics._triangle_count import TriangleCountPlan, triangle_count
+from katana.analytics._subgraph_match import SubgraphMatchPlan, subgraph_match_count
+from katana.analytics._triangle_count import TriangleCountEstimate, TriangleCountPlan, triangle_count
 from katana.analytics._wrappers import find_edge_sorted_by_dest, sort_all_edges_by_dest, sort_nodes_by_degree
 from katana.analytics.plan import Architecture, Plan, Statistics
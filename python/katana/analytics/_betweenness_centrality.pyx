@@ -39,8 +39,11 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kMultiSource "katana::analytics::BetweennessCentralityPlan::kMultiSource"
+            kAsynchronous "katana::analytics::BetweennessCentralityPlan::kAsynchronous"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
+        uint32_t sources_per_batch() const
 
         BetweennessCentralityPlan()
 
@@ -49,8 +52,14 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan MultiSource(uint32_t sources_per_batch)
+        @staticmethod
+        _BetweennessCentralityPlan Asynchronous()
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
+    uint32_t kDefaultSourcesPerBatch "katana::analytics::BetweennessCentralityPlan::kDefaultSourcesPerBatch"
+
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
 
     Result[void] BetweennessCentrality(_PropertyGraph* pg, string output_property_name, const BetweennessCentralitySources& sources, _BetweennessCentralityPlan plan)
@@ -87,6 +96,8 @@ class _BetweennessCentralityAlgorithm(Enum):
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    MultiSource = _BetweennessCentralityPlan.Algorithm.kMultiSource
+    Asynchronous = _BetweennessCentralityPlan.Algorithm.kAsynchronous
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -127,6 +138,28 @@ cdef class BetweennessCentralityPlan(Plan):
         """
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @property
+    def sources_per_batch(self) -> int:
+        return self.underlying_.sources_per_batch()
+
+    @staticmethod
+    def multi_source(sources_per_batch=kDefaultSourcesPerBatch):
+        """
+        Search from batches of sources at once with a bit-parallel BFS, reading the graph once per batch instead of
+        once per source.
+
+        :param sources_per_batch: Number of sources per batch, at most 64. Path counts and dependencies take 8 bytes
+            per node per source in a batch.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.MultiSource(sources_per_batch))
+
+    @staticmethod
+    def asynchronous():
+        """
+        Build shortest path DAGs asynchronously, without per-level barriers. Best on high-diameter graphs.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Asynchronous())
+
 
 def betweenness_centrality(PropertyGraph pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan()):
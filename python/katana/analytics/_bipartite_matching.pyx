@@ -0,0 +1,232 @@
+"""
+Bipartite Matching
+------------------
+
+.. autoclass:: katana.analytics.BipartiteMatchingPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._bipartite_matching._BipartiteMatchingPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.bipartite_matching
+
+.. autofunction:: katana.analytics.weighted_bipartite_matching
+
+.. autoclass:: katana.analytics.BipartiteMatchingStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.bipartite_matching_assert_valid
+
+.. autofunction:: katana.analytics.weighted_bipartite_matching_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/bipartite_matching/bipartite_matching.h" namespace "katana::analytics" nogil:
+    cppclass _BipartiteMatchingPlan "katana::analytics::BipartiteMatchingPlan" (_Plan):
+        enum Algorithm:
+            kPothenFan "katana::analytics::BipartiteMatchingPlan::kPothenFan"
+            kAuction "katana::analytics::BipartiteMatchingPlan::kAuction"
+
+        _BipartiteMatchingPlan.Algorithm algorithm() const
+
+        BipartiteMatchingPlan()
+
+        @staticmethod
+        _BipartiteMatchingPlan PothenFan()
+
+        @staticmethod
+        _BipartiteMatchingPlan Auction()
+
+    Result[void] BipartiteMatching(_PropertyGraph* pg, string output_property_name, _BipartiteMatchingPlan plan)
+
+    Result[void] WeightedBipartiteMatching(
+        _PropertyGraph* pg, string edge_weight_property_name, string output_property_name,
+        _BipartiteMatchingPlan plan)
+
+    Result[void] BipartiteMatchingAssertValid(_PropertyGraph* pg, string output_property_name)
+
+    Result[void] WeightedBipartiteMatchingAssertValid(
+        _PropertyGraph* pg, string edge_weight_property_name, string output_property_name)
+
+    cppclass _BipartiteMatchingStatistics "katana::analytics::BipartiteMatchingStatistics":
+        uint64_t n_matched_edges
+        uint64_t n_left_nodes
+        uint64_t n_right_nodes
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_BipartiteMatchingStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
+
+class _BipartiteMatchingPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.BipartiteMatchingPlan` constructors for algorithm documentation.
+    """
+    PothenFan = _BipartiteMatchingPlan.Algorithm.kPothenFan
+    Auction = _BipartiteMatchingPlan.Algorithm.kAuction
+
+
+cdef class BipartiteMatchingPlan(Plan):
+    """
+    A computational :ref:`Plan` for Bipartite Matching.
+
+    Static methods construct BipartiteMatchingPlans.
+    """
+    cdef:
+        _BipartiteMatchingPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _BipartiteMatchingPlanAlgorithm
+
+    @staticmethod
+    cdef BipartiteMatchingPlan make(_BipartiteMatchingPlan u):
+        f = <BipartiteMatchingPlan>BipartiteMatchingPlan.__new__(BipartiteMatchingPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> BipartiteMatchingPlan.Algorithm:
+        return _BipartiteMatchingPlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def pothen_fan() -> BipartiteMatchingPlan:
+        """
+        Parallel depth-first searches for disjoint augmenting paths from all unmatched left nodes, with lookahead
+        and fairness. Maximum cardinality only.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.PothenFan())
+
+    @staticmethod
+    def auction() -> BipartiteMatchingPlan:
+        """
+        The auction algorithm with epsilon scaling, where unassigned nodes bid for their best neighbor in parallel.
+        Exact for integer weights.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.Auction())
+
+
+def bipartite_matching(
+    PropertyGraph pg, str output_property_name, BipartiteMatchingPlan plan = BipartiteMatchingPlan()
+):
+    """
+    Compute a maximum cardinality matching of a bipartite graph whose edges all go from left nodes to right nodes.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze. No node may have both in- and out-edges.
+    :type output_property_name: str
+    :param output_property_name: The output boolean edge property, true for the edges in the matching. This
+        property must not already exist.
+    :type plan: BipartiteMatchingPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(BipartiteMatching(pg.underlying_property_graph(), output_property_name_str, plan.underlying_))
+
+
+def weighted_bipartite_matching(
+    PropertyGraph pg,
+    str edge_weight_property_name,
+    str output_property_name,
+    BipartiteMatchingPlan plan = BipartiteMatchingPlan.auction()
+):
+    """
+    Compute a maximum weight matching of a bipartite graph whose edges all go from left nodes to right nodes.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze. No node may have both in- and out-edges.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The integer edge property holding the weight of each edge.
+    :type output_property_name: str
+    :param output_property_name: The output boolean edge property, true for the edges in the matching. This
+        property must not already exist.
+    :type plan: BipartiteMatchingPlan
+    :param plan: The execution plan to use, which must be an auction.
+    """
+    cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(WeightedBipartiteMatching(
+            pg.underlying_property_graph(), edge_weight_property_name_str, output_property_name_str,
+            plan.underlying_))
+
+
+def bipartite_matching_assert_valid(PropertyGraph pg, str output_property_name):
+    """
+    Raise an exception if the edges of `pg` in the matching share nodes or leave an augmenting path.
+
+    :raises: AssertionError
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(BipartiteMatchingAssertValid(pg.underlying_property_graph(), output_property_name_str))
+
+
+def weighted_bipartite_matching_assert_valid(
+    PropertyGraph pg, str edge_weight_property_name, str output_property_name
+):
+    """
+    Raise an exception if the edges of `pg` in the matching share nodes or do not have the maximum weight.
+
+    :raises: AssertionError
+    """
+    cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(WeightedBipartiteMatchingAssertValid(
+            pg.underlying_property_graph(), edge_weight_property_name_str, output_property_name_str))
+
+
+cdef _BipartiteMatchingStatistics handle_result_BipartiteMatchingStatistics(
+    Result[_BipartiteMatchingStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class BipartiteMatchingStatistics:
+    """
+    Compute the :ref:`statistics` of a Bipartite Matching result.
+    """
+    cdef _BipartiteMatchingStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str output_property_name):
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_BipartiteMatchingStatistics(_BipartiteMatchingStatistics.Compute(
+                pg.underlying_property_graph(), output_property_name_str))
+
+    @property
+    def n_matched_edges(self) -> uint64_t:
+        return self.underlying.n_matched_edges
+
+    @property
+    def n_left_nodes(self) -> uint64_t:
+        return self.underlying.n_left_nodes
+
+    @property
+    def n_right_nodes(self) -> uint64_t:
+        return self.underlying.n_right_nodes
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,210 @@
+"""
+Graph Partition
+---------------
+
+.. autoclass:: katana.analytics.GraphPartitionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._graph_partition._GraphPartitionPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.graph_partition
+
+.. autoclass:: katana.analytics.GraphPartitionStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.graph_partition_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/graph_partition/graph_partition.h" namespace "katana::analytics" nogil:
+    cppclass _GraphPartitionPlan "katana::analytics::GraphPartitionPlan" (_Plan):
+        enum Algorithm:
+            kMultilevel "katana::analytics::GraphPartitionPlan::kMultilevel"
+
+        _GraphPartitionPlan.Algorithm algorithm() const
+        double imbalance() const
+        uint32_t refinement_passes() const
+        uint32_t coarsest_nodes_per_partition() const
+
+        GraphPartitionPlan()
+
+        @staticmethod
+        _GraphPartitionPlan Multilevel(
+            double imbalance, uint32_t refinement_passes, uint32_t coarsest_nodes_per_partition)
+
+    double kDefaultImbalance "katana::analytics::GraphPartitionPlan::kDefaultImbalance"
+    uint32_t kDefaultRefinementPasses "katana::analytics::GraphPartitionPlan::kDefaultRefinementPasses"
+    uint32_t kDefaultCoarsestNodesPerPartition "katana::analytics::GraphPartitionPlan::kDefaultCoarsestNodesPerPartition"
+
+    Result[void] GraphPartition(_PropertyGraph* pg, uint32_t num_partitions, string output_property_name, _GraphPartitionPlan plan)
+
+    Result[void] GraphPartitionAssertValid(_PropertyGraph* pg, uint32_t num_partitions, string output_property_name)
+
+    cppclass _GraphPartitionStatistics "katana::analytics::GraphPartitionStatistics":
+        uint64_t n_partitions
+        uint64_t edge_cut
+        uint64_t max_partition_size
+        uint64_t min_partition_size
+        double imbalance
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_GraphPartitionStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
+
+class _GraphPartitionPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.GraphPartitionPlan` constructors for algorithm documentation.
+    """
+    Multilevel = _GraphPartitionPlan.Algorithm.kMultilevel
+
+
+cdef class GraphPartitionPlan(Plan):
+    """
+    A computational :ref:`Plan` for Graph Partitioning.
+
+    Static methods construct GraphPartitionPlans.
+    """
+    cdef:
+        _GraphPartitionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _GraphPartitionPlanAlgorithm
+
+    @staticmethod
+    cdef GraphPartitionPlan make(_GraphPartitionPlan u):
+        f = <GraphPartitionPlan>GraphPartitionPlan.__new__(GraphPartitionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> GraphPartitionPlan.Algorithm:
+        return _GraphPartitionPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def imbalance(self) -> double:
+        return self.underlying_.imbalance()
+
+    @property
+    def refinement_passes(self) -> uint32_t:
+        return self.underlying_.refinement_passes()
+
+    @property
+    def coarsest_nodes_per_partition(self) -> uint32_t:
+        return self.underlying_.coarsest_nodes_per_partition()
+
+    @staticmethod
+    def multilevel(
+        double imbalance = kDefaultImbalance,
+        uint32_t refinement_passes = kDefaultRefinementPasses,
+        uint32_t coarsest_nodes_per_partition = kDefaultCoarsestNodesPerPartition
+    ) -> GraphPartitionPlan:
+        """
+        Coarsen the graph by heavy edge matching, partition the coarsest graph by greedy graph growing, and refine
+        the partition at every level on the way back by moving boundary nodes to the partition they are most
+        connected to.
+        """
+        return GraphPartitionPlan.make(_GraphPartitionPlan.Multilevel(
+            imbalance, refinement_passes, coarsest_nodes_per_partition))
+
+
+def graph_partition(
+    PropertyGraph pg,
+    uint32_t num_partitions,
+    str output_property_name,
+    GraphPartitionPlan plan = GraphPartitionPlan()
+):
+    """
+    Partition the nodes of pg into num_partitions parts of about the same size with few edges between them, treating
+    every edge as undirected.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type num_partitions: int
+    :param num_partitions: The number of partitions to make.
+    :type output_property_name: str
+    :param output_property_name: The output uint32 node property holding the partition of each node. This property
+        must not already exist.
+    :type plan: GraphPartitionPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(GraphPartition(
+            pg.underlying_property_graph(), num_partitions, output_property_name_str, plan.underlying_))
+
+
+def graph_partition_assert_valid(PropertyGraph pg, uint32_t num_partitions, str output_property_name):
+    """
+    Raise an exception if some node of `pg` is not in one of the num_partitions partitions.
+
+    :raises: AssertionError
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(GraphPartitionAssertValid(
+            pg.underlying_property_graph(), num_partitions, output_property_name_str))
+
+
+cdef _GraphPartitionStatistics handle_result_GraphPartitionStatistics(
+    Result[_GraphPartitionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class GraphPartitionStatistics:
+    """
+    Compute the :ref:`statistics` of a Graph Partition result.
+    """
+    cdef _GraphPartitionStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str output_property_name):
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_GraphPartitionStatistics(_GraphPartitionStatistics.Compute(
+                pg.underlying_property_graph(), output_property_name_str))
+
+    @property
+    def n_partitions(self) -> uint64_t:
+        return self.underlying.n_partitions
+
+    @property
+    def edge_cut(self) -> uint64_t:
+        return self.underlying.edge_cut
+
+    @property
+    def max_partition_size(self) -> uint64_t:
+        return self.underlying.max_partition_size
+
+    @property
+    def min_partition_size(self) -> uint64_t:
+        return self.underlying.min_partition_size
+
+    @property
+    def imbalance(self) -> double:
+        return self.underlying.imbalance
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
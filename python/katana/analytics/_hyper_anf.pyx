@@ -0,0 +1,177 @@
+"""
+HyperANF
+--------
+
+.. autoclass:: katana.analytics.HyperAnfPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._hyper_anf._HyperAnfPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.hyper_anf
+
+.. autoclass:: katana.analytics.HyperAnfStatistics
+    :members:
+    :undoc-members:
+"""
+from libc.stdint cimport uint32_t
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/hyper_anf/hyper_anf.h" namespace "katana::analytics" nogil:
+    cppclass _HyperAnfPlan "katana::analytics::HyperAnfPlan" (_Plan):
+        enum Algorithm:
+            kSynchronous "katana::analytics::HyperAnfPlan::kSynchronous"
+
+        _HyperAnfPlan.Algorithm algorithm() const
+        uint32_t log2_registers() const
+        uint32_t max_iterations() const
+
+        HyperAnfPlan()
+
+        @staticmethod
+        _HyperAnfPlan Synchronous(uint32_t log2_registers, uint32_t max_iterations)
+
+    uint32_t kDefaultLog2Registers "katana::analytics::HyperAnfPlan::kDefaultLog2Registers"
+    uint32_t kDefaultMaxIterations "katana::analytics::HyperAnfPlan::kDefaultMaxIterations"
+
+    cppclass _HyperAnfStatistics "katana::analytics::HyperAnfStatistics":
+        vector[double] neighborhood_function
+        double effective_diameter
+        double average_distance
+        uint32_t num_iterations
+
+        void Print(ostream os)
+
+    Result[_HyperAnfStatistics] HyperAnf(_PropertyGraph* pg, string output_property_name, _HyperAnfPlan plan)
+
+
+class _HyperAnfPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.HyperAnfPlan` constructors for algorithm documentation.
+    """
+    Synchronous = _HyperAnfPlan.Algorithm.kSynchronous
+
+
+cdef class HyperAnfPlan(Plan):
+    """
+    A computational :ref:`Plan` for HyperANF.
+
+    Static methods construct HyperAnfPlans.
+    """
+    cdef:
+        _HyperAnfPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _HyperAnfPlanAlgorithm
+
+    @staticmethod
+    cdef HyperAnfPlan make(_HyperAnfPlan u):
+        f = <HyperAnfPlan>HyperAnfPlan.__new__(HyperAnfPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> HyperAnfPlan.Algorithm:
+        return _HyperAnfPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def log2_registers(self) -> uint32_t:
+        return self.underlying_.log2_registers()
+
+    @property
+    def max_iterations(self) -> uint32_t:
+        return self.underlying_.max_iterations()
+
+    @staticmethod
+    def synchronous(
+        uint32_t log2_registers = kDefaultLog2Registers, uint32_t max_iterations = kDefaultMaxIterations
+    ) -> HyperAnfPlan:
+        """
+        Every node keeps a HyperLogLog counter of 2^log2_registers one-byte registers for the set of nodes it reaches.
+        In each iteration, each node unions the counters of the destinations of its edges into its own, so after t
+        iterations its counter holds the nodes within distance t. The relative standard error of each count is about
+        1.04 / sqrt(2^log2_registers).
+        """
+        return HyperAnfPlan.make(_HyperAnfPlan.Synchronous(log2_registers, max_iterations))
+
+
+cdef _HyperAnfStatistics handle_result_HyperAnfStatistics(Result[_HyperAnfStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class HyperAnfStatistics:
+    """
+    The :ref:`statistics` of the distances of a graph, as estimated by :py:func:`~katana.analytics.hyper_anf`.
+    """
+    cdef _HyperAnfStatistics underlying
+
+    @staticmethod
+    cdef HyperAnfStatistics make(_HyperAnfStatistics u):
+        s = <HyperAnfStatistics>HyperAnfStatistics.__new__(HyperAnfStatistics)
+        s.underlying = u
+        return s
+
+    @property
+    def neighborhood_function(self) -> list:
+        """
+        The estimated number of pairs of nodes (x, y) such that y is reachable from x in at most t steps, counting
+        (x, x), for each t from 0 to the last iteration.
+        """
+        return self.underlying.neighborhood_function
+
+    @property
+    def effective_diameter(self) -> double:
+        return self.underlying.effective_diameter
+
+    @property
+    def average_distance(self) -> double:
+        return self.underlying.average_distance
+
+    @property
+    def num_iterations(self) -> uint32_t:
+        return self.underlying.num_iterations
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
+
+
+def hyper_anf(PropertyGraph pg, str output_property_name, HyperAnfPlan plan = HyperAnfPlan()) -> HyperAnfStatistics:
+    """
+    Estimate the neighborhood function of pg along its out-edges with HyperANF, and the harmonic centrality of each
+    node, the sum of 1 / d(x, y) over the nodes y reachable from x.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output float node property of harmonic centralities. This property must not
+        already exist. These are the usual harmonic centralities, over the distances to each node, if pg is symmetric.
+    :type plan: HyperAnfPlan
+    :param plan: The execution plan to use.
+    :returns: The statistics of the distances, including the neighborhood function and effective diameter.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    cdef _HyperAnfStatistics stats
+    with nogil:
+        stats = handle_result_HyperAnfStatistics(HyperAnf(
+            pg.underlying_property_graph(), output_property_name_str, plan.underlying_))
+    return HyperAnfStatistics.make(stats)
@@ -0,0 +1,295 @@
+"""
+Hypergraph Partition
+--------------------
+
+.. autofunction:: katana.analytics.make_hypergraph
+
+.. autoclass:: katana.analytics.HyperGraphPartitionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._hypergraph_partition._HyperGraphPartitionPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autoclass:: katana.analytics._hypergraph_partition._HyperGraphPartitionPlanMatchingPolicy
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.hypergraph_partition
+
+.. autoclass:: katana.analytics.HyperGraphPartitionStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.hypergraph_partition_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+from pyarrow.lib cimport to_shared
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/HyperGraphView.h" namespace "katana" nogil:
+    cppclass _HyperGraphView "katana::HyperGraphView":
+        @staticmethod
+        Result[unique_ptr[_PropertyGraph]] MakeGraph(uint64_t num_nodes, const vector[vector[uint32_t]]& hyperedges)
+
+
+cdef extern from "katana/analytics/hypergraph_partition/hypergraph_partition.h" namespace "katana::analytics" nogil:
+    uint32_t kHyperGraphPartitionCut
+
+    cppclass _HyperGraphPartitionPlan "katana::analytics::HyperGraphPartitionPlan" (_Plan):
+        enum Algorithm:
+            kMultilevel "katana::analytics::HyperGraphPartitionPlan::kMultilevel"
+
+        enum MatchingPolicy:
+            kHigherDegree "katana::analytics::HyperGraphPartitionPlan::kHigherDegree"
+            kLowerDegree "katana::analytics::HyperGraphPartitionPlan::kLowerDegree"
+            kHigherWeight "katana::analytics::HyperGraphPartitionPlan::kHigherWeight"
+            kLowerWeight "katana::analytics::HyperGraphPartitionPlan::kLowerWeight"
+            kRandom "katana::analytics::HyperGraphPartitionPlan::kRandom"
+
+        _HyperGraphPartitionPlan.Algorithm algorithm() const
+        _HyperGraphPartitionPlan.MatchingPolicy matching_policy() const
+        double imbalance() const
+        uint32_t refinement_passes() const
+        uint32_t max_coarse_graph_size() const
+
+        HyperGraphPartitionPlan()
+
+        @staticmethod
+        _HyperGraphPartitionPlan Multilevel(
+            _HyperGraphPartitionPlan.MatchingPolicy matching_policy, double imbalance, uint32_t refinement_passes,
+            uint32_t max_coarse_graph_size)
+
+    _HyperGraphPartitionPlan.MatchingPolicy kDefaultMatchingPolicy "katana::analytics::HyperGraphPartitionPlan::kDefaultMatchingPolicy"
+    double kDefaultImbalance "katana::analytics::HyperGraphPartitionPlan::kDefaultImbalance"
+    uint32_t kDefaultRefinementPasses "katana::analytics::HyperGraphPartitionPlan::kDefaultRefinementPasses"
+    uint32_t kDefaultMaxCoarseGraphSize "katana::analytics::HyperGraphPartitionPlan::kDefaultMaxCoarseGraphSize"
+
+    Result[void] HyperGraphPartition(
+        _PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions, string output_property_name,
+        _HyperGraphPartitionPlan plan)
+
+    Result[void] HyperGraphPartitionAssertValid(
+        _PropertyGraph* pg, uint64_t num_hyperedges, uint32_t num_partitions, string output_property_name)
+
+    cppclass _HyperGraphPartitionStatistics "katana::analytics::HyperGraphPartitionStatistics":
+        uint64_t n_partitions
+        uint64_t hyperedge_cut
+        uint64_t max_partition_size
+        uint64_t min_partition_size
+        double imbalance
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_HyperGraphPartitionStatistics] Compute(
+            _PropertyGraph* pg, uint64_t num_hyperedges, string output_property_name)
+
+
+HYPERGRAPH_PARTITION_CUT = kHyperGraphPartitionCut
+
+
+cdef shared_ptr[_PropertyGraph] handle_result_property_graph(Result[unique_ptr[_PropertyGraph]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return to_shared(res.value())
+
+
+def make_hypergraph(uint64_t num_nodes, hyperedges) -> PropertyGraph:
+    """
+    Make a graph holding a hypergraph, as its incidence graph: the first len(hyperedges) nodes of the graph are the
+    hyperedges, each with an edge to each of its nodes, and the nodes of the hypergraph follow.
+
+    :type num_nodes: int
+    :param num_nodes: The number of nodes of the hypergraph.
+    :param hyperedges: A list of lists of node ids in [0, num_nodes), one per hyperedge.
+    :returns: the new :py:class:`~katana.property_graph.PropertyGraph`, without properties
+    """
+    cdef vector[vector[uint32_t]] hyperedges_vector = [[<uint32_t>n for n in pins] for pins in hyperedges]
+    with nogil:
+        pg = handle_result_property_graph(_HyperGraphView.MakeGraph(num_nodes, hyperedges_vector))
+    return PropertyGraph.make(pg)
+
+
+class _HyperGraphPartitionPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.HyperGraphPartitionPlan` constructors for algorithm documentation.
+    """
+    Multilevel = _HyperGraphPartitionPlan.Algorithm.kMultilevel
+
+
+class _HyperGraphPartitionPlanMatchingPolicy(Enum):
+    """
+    The hyperedges whose nodes are merged first when coarsening.
+    """
+    HigherDegree = _HyperGraphPartitionPlan.MatchingPolicy.kHigherDegree
+    LowerDegree = _HyperGraphPartitionPlan.MatchingPolicy.kLowerDegree
+    HigherWeight = _HyperGraphPartitionPlan.MatchingPolicy.kHigherWeight
+    LowerWeight = _HyperGraphPartitionPlan.MatchingPolicy.kLowerWeight
+    Random = _HyperGraphPartitionPlan.MatchingPolicy.kRandom
+
+
+cdef class HyperGraphPartitionPlan(Plan):
+    """
+    A computational :ref:`Plan` for Hypergraph Partitioning.
+
+    Static methods construct HyperGraphPartitionPlans.
+    """
+    cdef:
+        _HyperGraphPartitionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _HyperGraphPartitionPlanAlgorithm
+    MatchingPolicy = _HyperGraphPartitionPlanMatchingPolicy
+
+    @staticmethod
+    cdef HyperGraphPartitionPlan make(_HyperGraphPartitionPlan u):
+        f = <HyperGraphPartitionPlan>HyperGraphPartitionPlan.__new__(HyperGraphPartitionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> HyperGraphPartitionPlan.Algorithm:
+        return _HyperGraphPartitionPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def matching_policy(self) -> HyperGraphPartitionPlan.MatchingPolicy:
+        return _HyperGraphPartitionPlanMatchingPolicy(self.underlying_.matching_policy())
+
+    @property
+    def imbalance(self) -> double:
+        return self.underlying_.imbalance()
+
+    @property
+    def refinement_passes(self) -> uint32_t:
+        return self.underlying_.refinement_passes()
+
+    @property
+    def max_coarse_graph_size(self) -> uint32_t:
+        return self.underlying_.max_coarse_graph_size()
+
+    @staticmethod
+    def multilevel(
+        matching_policy = _HyperGraphPartitionPlanMatchingPolicy(kDefaultMatchingPolicy),
+        double imbalance = kDefaultImbalance,
+        uint32_t refinement_passes = kDefaultRefinementPasses,
+        uint32_t max_coarse_graph_size = kDefaultMaxCoarseGraphSize
+    ) -> HyperGraphPartitionPlan:
+        """
+        Recursive bisection in the style of BiPart, with the same result for any number of threads. Coarsen the
+        hypergraph by merging the nodes that pick the same hyperedge under matching_policy, bisect the coarsest
+        hypergraph greedily by gain, and refine the bisection at every level on the way back by swapping the nodes of
+        highest gain between the sides.
+        """
+        return HyperGraphPartitionPlan.make(_HyperGraphPartitionPlan.Multilevel(
+            _HyperGraphPartitionPlanMatchingPolicy(matching_policy).value, imbalance, refinement_passes,
+            max_coarse_graph_size))
+
+
+def hypergraph_partition(
+    PropertyGraph pg,
+    uint64_t num_hyperedges,
+    uint32_t num_partitions,
+    str output_property_name,
+    HyperGraphPartitionPlan plan = HyperGraphPartitionPlan()
+):
+    """
+    Partition the nodes of the hypergraph in pg, whose first num_hyperedges nodes are hyperedges (see
+    :py:func:`~katana.analytics.make_hypergraph`), into num_partitions parts of about the same size, cutting few
+    hyperedges.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type num_hyperedges: int
+    :param num_hyperedges: The number of hyperedges, which come first among the nodes of pg.
+    :type num_partitions: int
+    :param num_partitions: The number of partitions to make.
+    :type output_property_name: str
+    :param output_property_name: The output uint32 node property holding the partition of each node, and of each
+        hyperedge whose nodes are all in one partition. The other hyperedges hold HYPERGRAPH_PARTITION_CUT. This
+        property must not already exist.
+    :type plan: HyperGraphPartitionPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(HyperGraphPartition(
+            pg.underlying_property_graph(), num_hyperedges, num_partitions, output_property_name_str,
+            plan.underlying_))
+
+
+def hypergraph_partition_assert_valid(
+    PropertyGraph pg, uint64_t num_hyperedges, uint32_t num_partitions, str output_property_name
+):
+    """
+    Raise an exception if some node of the hypergraph in `pg` is not in one of the num_partitions partitions, or some
+    hyperedge is not in the partition of its nodes nor cut.
+
+    :raises: AssertionError
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(HyperGraphPartitionAssertValid(
+            pg.underlying_property_graph(), num_hyperedges, num_partitions, output_property_name_str))
+
+
+cdef _HyperGraphPartitionStatistics handle_result_HyperGraphPartitionStatistics(
+    Result[_HyperGraphPartitionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class HyperGraphPartitionStatistics:
+    """
+    Compute the :ref:`statistics` of a Hypergraph Partition result.
+    """
+    cdef _HyperGraphPartitionStatistics underlying
+
+    def __init__(self, PropertyGraph pg, uint64_t num_hyperedges, str output_property_name):
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_HyperGraphPartitionStatistics(_HyperGraphPartitionStatistics.Compute(
+                pg.underlying_property_graph(), num_hyperedges, output_property_name_str))
+
+    @property
+    def n_partitions(self) -> uint64_t:
+        return self.underlying.n_partitions
+
+    @property
+    def hyperedge_cut(self) -> uint64_t:
+        return self.underlying.hyperedge_cut
+
+    @property
+    def max_partition_size(self) -> uint64_t:
+        return self.underlying.max_partition_size
+
+    @property
+    def min_partition_size(self) -> uint64_t:
+        return self.underlying.min_partition_size
+
+    @property
+    def imbalance(self) -> double:
+        return self.underlying.imbalance
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
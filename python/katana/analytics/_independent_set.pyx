@@ -18,6 +18,10 @@ Independent Set
     :undoc-members:
 
 .. autofunction:: katana.analytics.independent_set_assert_valid
+
+.. autofunction:: katana.analytics.graph_coloring
+
+.. autofunction:: katana.analytics.graph_coloring_assert_valid
 """
 from libc.stdint cimport uint32_t
 from libcpp.string cimport string
@@ -38,6 +42,7 @@ cdef extern from "katana/analytics/independent_set/independent_set.h" namespace
             kPull "katana::analytics::IndependentSetPlan::kPull"
             kPriority "katana::analytics::IndependentSetPlan::kPriority"
             kEdgeTiledPriority "katana::analytics::IndependentSetPlan::kEdgeTiledPriority"
+            kBitsetPriority "katana::analytics::IndependentSetPlan::kBitsetPriority"
 
         # unsigned int kChunkSize
 
@@ -56,11 +61,17 @@ cdef extern from "katana/analytics/independent_set/independent_set.h" namespace
         _IndependentSetPlan Priority()
         @staticmethod
         _IndependentSetPlan EdgeTiledPriority()
+        @staticmethod
+        _IndependentSetPlan BitsetPriority()
 
     Result[void] IndependentSet(_PropertyGraph* pg, string output_property_name, _IndependentSetPlan plan)
 
     Result[void] IndependentSetAssertValid(_PropertyGraph* pg, string output_property_name)
 
+    Result[void] GraphColoring(_PropertyGraph* pg, string output_property_name)
+
+    Result[void] GraphColoringAssertValid(_PropertyGraph* pg, string output_property_name)
+
     cppclass _IndependentSetStatistics "katana::analytics::IndependentSetStatistics":
         uint32_t cardinality
 
@@ -78,6 +89,7 @@ class _IndependentSetPlanAlgorithm(Enum):
     Pull = _IndependentSetPlan.Algorithm.kPull
     Priority = _IndependentSetPlan.Algorithm.kPriority
     EdgeTiledPriority = _IndependentSetPlan.Algorithm.kEdgeTiledPriority
+    BitsetPriority = _IndependentSetPlan.Algorithm.kBitsetPriority
 
 
 cdef class IndependentSetPlan(Plan):
@@ -120,6 +132,10 @@ cdef class IndependentSetPlan(Plan):
     def edge_tiled_priority():
         return IndependentSetPlan.make(_IndependentSetPlan.EdgeTiledPriority())
 
+    @staticmethod
+    def bitset_priority():
+        return IndependentSetPlan.make(_IndependentSetPlan.BitsetPriority())
+
 
 def independent_set(PropertyGraph pg, str output_property_name,
              IndependentSetPlan plan = IndependentSetPlan()):
@@ -155,6 +171,35 @@ def independent_set_assert_valid(PropertyGraph pg, str output_property_name):
         handle_result_assert(IndependentSetAssertValid(pg.underlying_property_graph(), output_property_name_cstr))
 
 
+def graph_coloring(PropertyGraph pg, str output_property_name):
+    """
+    Color the nodes of the graph so that no edge joins two nodes of the same color, and create a uint32_t property of
+    the colors. The nodes of one color are an independent set. The graph must be symmetric. The property named
+    output_property_name is created by this function and may not exist before the call.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property to write colors into. This property must not already exist.
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(GraphColoring(pg.underlying_property_graph(), output_property_name_cstr))
+
+
+def graph_coloring_assert_valid(PropertyGraph pg, str output_property_name):
+    """
+    Raise an exception if an edge of `pg` joins two nodes of the same color.
+
+    :raises: AssertionError
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_assert(GraphColoringAssertValid(pg.underlying_property_graph(), output_property_name_cstr))
+
+
 cdef _IndependentSetStatistics handle_result_IndependentSetStatistics(Result[_IndependentSetStatistics] res) nogil except *:
     if not res.has_value():
         with gil:
@@ -18,9 +18,14 @@ k-Core
     :undoc-members:
 
 .. autofunction:: katana.analytics.k_core_assert_valid
+
+.. autofunction:: katana.analytics.k_core_decomposition
+
+.. autofunction:: katana.analytics.k_core_decomposition_assert_valid
 """
 from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 from katana._property_graph cimport PropertyGraph
 from katana.analytics.plan cimport Plan, _Plan
@@ -36,6 +41,7 @@ cdef extern from "katana/analytics/k_core/k_core.h" namespace "katana::analytics
         enum Algorithm:
             kSynchronous "katana::analytics::KCorePlan::kSynchronous"
             kAsynchronous "katana::analytics::KCorePlan::kAsynchronous"
+            kDecomposition "katana::analytics::KCorePlan::kDecomposition"
 
         _KCorePlan.Algorithm algorithm() const
 
@@ -45,20 +51,30 @@ cdef extern from "katana/analytics/k_core/k_core.h" namespace "katana::analytics
         _KCorePlan Synchronous()
         @staticmethod
         _KCorePlan Asynchronous()
+        @staticmethod
+        _KCorePlan Decomposition()
 
     Result[void] KCore(_PropertyGraph* pg, uint32_t k_core_number, string output_property_name, _KCorePlan plan)
 
 
     Result[void] KCoreAssertValid(_PropertyGraph* pg, uint32_t k_core_number, string output_property_name)
 
+    Result[void] KCoreDecomposition(_PropertyGraph* pg, string output_property_name)
+
+    Result[void] KCoreDecompositionAssertValid(_PropertyGraph* pg, string output_property_name)
+
     cppclass _KCoreStatistics "katana::analytics::KCoreStatistics":
         uint64_t number_of_nodes_in_kcore
+        vector[uint64_t] coreness_histogram
 
         void Print(ostream os)
 
         @staticmethod
         Result[_KCoreStatistics] Compute(_PropertyGraph* pg, uint32_t k_core_number, string output_property_name)
 
+        @staticmethod
+        Result[_KCoreStatistics] ComputeDecomposition(_PropertyGraph* pg, uint32_t k_core_number, string output_property_name)
+
 
 class _KCorePlanAlgorithm(Enum):
     """
@@ -66,6 +82,7 @@ class _KCorePlanAlgorithm(Enum):
     """
     Synchronous = _KCorePlan.Algorithm.kSynchronous
     Asynchronous = _KCorePlan.Algorithm.kAsynchronous
+    Decomposition = _KCorePlan.Algorithm.kDecomposition
 
 
 cdef class KCorePlan(Plan):
@@ -104,6 +121,13 @@ cdef class KCorePlan(Plan):
         Asynchronous
         """
         return KCorePlan.make(_KCorePlan.Asynchronous())
+    @staticmethod
+    def decomposition() -> KCorePlan:
+        """
+        Bucket-based core decomposition, which peels nodes in order of degree and finds the coreness of every node in one
+        run.
+        """
+        return KCorePlan.make(_KCorePlan.Decomposition())
 
 
 def k_core(PropertyGraph pg, uint32_t k_core_number, str output_property_name, KCorePlan plan = KCorePlan()) -> int:
@@ -136,6 +160,35 @@ def k_core_assert_valid(PropertyGraph pg, uint32_t k_core_number, str output_pro
         handle_result_assert(KCoreAssertValid(pg.underlying_property_graph(), k_core_number, output_property_name_str))
 
 
+def k_core_decomposition(PropertyGraph pg, str output_property_name) -> int:
+    """
+    Compute the coreness of every node of pg, the largest k such that the node is in the k-core. The pg must be
+    symmetric.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the coreness of each node. This property must not already
+        exist.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(KCoreDecomposition(pg.underlying_property_graph(), output_property_name_str))
+    return v
+
+
+def k_core_decomposition_assert_valid(PropertyGraph pg, str output_property_name):
+    """
+    Raise an exception if the coreness results in `pg` are invalid. This is not an exhaustive check, just a sanity
+    check.
+
+    :raises: AssertionError
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(KCoreDecompositionAssertValid(pg.underlying_property_graph(), output_property_name_str))
+
+
 cdef _KCoreStatistics handle_result_KCoreStatistics(Result[_KCoreStatistics] res) nogil except *:
     if not res.has_value():
         with gil:
@@ -145,20 +198,33 @@ cdef _KCoreStatistics handle_result_KCoreStatistics(Result[_KCoreStatistics] res
 
 cdef class KCoreStatistics:
     """
-    Compute the :ref:`statistics` of a k-Core result.
+    Compute the :ref:`statistics` of a k-Core result. With `decomposition`, the output property holds the coreness
+    computed by :py:func:`~katana.analytics.k_core_decomposition` and the statistics include a histogram of coreness.
     """
     cdef _KCoreStatistics underlying
 
-    def __init__(self, PropertyGraph pg, uint32_t k_core_number, str output_property_name):
+    def __init__(self, PropertyGraph pg, uint32_t k_core_number, str output_property_name, bint decomposition = False):
         cdef string output_property_name_str = output_property_name.encode("utf-8")
         with nogil:
-            self.underlying = handle_result_KCoreStatistics(_KCoreStatistics.Compute(
-                pg.underlying_property_graph(), k_core_number, output_property_name_str))
+            if decomposition:
+                self.underlying = handle_result_KCoreStatistics(_KCoreStatistics.ComputeDecomposition(
+                    pg.underlying_property_graph(), k_core_number, output_property_name_str))
+            else:
+                self.underlying = handle_result_KCoreStatistics(_KCoreStatistics.Compute(
+                    pg.underlying_property_graph(), k_core_number, output_property_name_str))
 
     @property
     def number_of_nodes_in_kcore(self) -> uint64_t:
         return self.underlying.number_of_nodes_in_kcore
 
+    @property
+    def coreness_histogram(self) -> list:
+        """
+        The number of nodes of each coreness, from 0 to the largest coreness. Empty unless computed with
+        `decomposition`.
+        """
+        return self.underlying.coreness_histogram
+
     def __str__(self) -> str:
         cdef ostringstream ss
         self.underlying.Print(ss)
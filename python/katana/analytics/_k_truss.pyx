@@ -20,9 +20,14 @@ The k-Truss is a maximal connected subgraph in which all edges are part of at le
     :undoc-members:
 
 .. autofunction:: katana.analytics.k_truss_assert_valid
+
+.. autofunction:: katana.analytics.k_truss_decomposition
+
+.. autofunction:: katana.analytics.k_truss_decomposition_assert_valid
 """
 from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 from katana._property_graph cimport PropertyGraph
 from katana.analytics.plan cimport Plan, _Plan
@@ -39,6 +44,7 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
             kBsp "katana::analytics::KTrussPlan::kBsp"
             kBspJacobi "katana::analytics::KTrussPlan::kBspJacobi"
             kBspCoreThenTruss "katana::analytics::KTrussPlan::kBspCoreThenTruss"
+            kDecomposition "katana::analytics::KTrussPlan::kDecomposition"
 
         _KTrussPlan.Algorithm algorithm() const
 
@@ -50,14 +56,21 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
         _KTrussPlan BspJacobi()
         @staticmethod
         _KTrussPlan BspCoreThenTruss()
+        @staticmethod
+        _KTrussPlan Decomposition()
 
     Result[void] KTruss(_PropertyGraph* pg, uint32_t k_truss_number,string output_property_name, _KTrussPlan plan)
 
     Result[void] KTrussAssertValid(_PropertyGraph* pg, uint32_t k_truss_number,
                                    string output_property_name)
 
+    Result[void] KTrussDecomposition(_PropertyGraph* pg, string output_property_name)
+
+    Result[void] KTrussDecompositionAssertValid(_PropertyGraph* pg, string output_property_name)
+
     cppclass _KTrussStatistics "katana::analytics::KTrussStatistics":
         uint64_t number_of_edges_left
+        vector[uint64_t] trussness_histogram
 
         void Print(ostream os)
 
@@ -65,6 +78,10 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
         Result[_KTrussStatistics] Compute(_PropertyGraph* pg, uint32_t k_truss_number,
                                           string output_property_name)
 
+        @staticmethod
+        Result[_KTrussStatistics] ComputeDecomposition(_PropertyGraph* pg, uint32_t k_truss_number,
+                                                       string output_property_name)
+
 
 class _KTrussPlanAlgorithm(Enum):
     """
@@ -73,6 +90,7 @@ class _KTrussPlanAlgorithm(Enum):
     Bsp = _KTrussPlan.Algorithm.kBsp
     BspJacobi = _KTrussPlan.Algorithm.kBspJacobi
     BspCoreThenTruss = _KTrussPlan.Algorithm.kBspCoreThenTruss
+    Decomposition = _KTrussPlan.Algorithm.kDecomposition
 
 
 cdef class KTrussPlan(Plan):
@@ -120,6 +138,13 @@ cdef class KTrussPlan(Plan):
         """
         return KTrussPlan.make(_KTrussPlan.BspCoreThenTruss())
 
+    @staticmethod
+    def decomposition() -> KTrussPlan:
+        """
+        Truss decomposition, which peels edges in order of support and finds the trussness of every edge in one run.
+        """
+        return KTrussPlan.make(_KTrussPlan.Decomposition())
+
 
 def k_truss(PropertyGraph pg, uint32_t k_truss_number, str output_property_name, KTrussPlan plan = KTrussPlan()) -> int:
     """
@@ -151,6 +176,35 @@ def k_truss_assert_valid(PropertyGraph pg, uint32_t k_truss_number, str output_p
         handle_result_assert(KTrussAssertValid(pg.underlying_property_graph(), k_truss_number, output_property_name_str))
 
 
+def k_truss_decomposition(PropertyGraph pg, str output_property_name) -> int:
+    """
+    Compute the trussness of every edge of pg, the largest k such that the edge is in the k-truss. `pg` must be
+    symmetric.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output edge property holding the trussness of each edge. This property must not
+        already exist.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(KTrussDecomposition(pg.underlying_property_graph(), output_property_name_str))
+    return v
+
+
+def k_truss_decomposition_assert_valid(PropertyGraph pg, str output_property_name):
+    """
+    Raise an exception if the trussness results in `pg` are invalid. This is not an exhaustive check, just a sanity
+    check.
+
+    :raises: AssertionError
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(KTrussDecompositionAssertValid(pg.underlying_property_graph(), output_property_name_str))
+
+
 cdef _KTrussStatistics handle_result_KTrussStatistics(Result[_KTrussStatistics] res) nogil except *:
     if not res.has_value():
         with gil:
@@ -160,20 +214,33 @@ cdef _KTrussStatistics handle_result_KTrussStatistics(Result[_KTrussStatistics]
 
 cdef class KTrussStatistics:
     """
-    Compute the :ref:`statistics` of a k-truss.
+    Compute the :ref:`statistics` of a k-truss. With `decomposition`, the output property holds the trussness computed
+    by :py:func:`~katana.analytics.k_truss_decomposition` and the statistics include a histogram of trussness.
     """
     cdef _KTrussStatistics underlying
 
-    def __init__(self, PropertyGraph pg, uint32_t k_truss_number, str output_property_name):
+    def __init__(self, PropertyGraph pg, uint32_t k_truss_number, str output_property_name, bint decomposition = False):
         cdef string output_property_name_str = output_property_name.encode("utf-8")
         with nogil:
-            self.underlying = handle_result_KTrussStatistics(_KTrussStatistics.Compute(
-                pg.underlying_property_graph(), k_truss_number, output_property_name_str))
+            if decomposition:
+                self.underlying = handle_result_KTrussStatistics(_KTrussStatistics.ComputeDecomposition(
+                    pg.underlying_property_graph(), k_truss_number, output_property_name_str))
+            else:
+                self.underlying = handle_result_KTrussStatistics(_KTrussStatistics.Compute(
+                    pg.underlying_property_graph(), k_truss_number, output_property_name_str))
 
     @property
     def number_of_edges_left(self) -> uint64_t:
         return self.underlying.number_of_edges_left
 
+    @property
+    def trussness_histogram(self) -> list:
+        """
+        The number of undirected edges of each trussness, from 0 to the largest trussness. Empty unless computed with
+        `decomposition`.
+        """
+        return self.underlying.trussness_histogram
+
     def __str__(self) -> str:
         cdef ostringstream ss
         self.underlying.Print(ss)
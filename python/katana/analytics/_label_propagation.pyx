@@ -0,0 +1,188 @@
+"""
+Label Propagation
+-----------------
+
+.. autoclass:: katana.analytics.LabelPropagationPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._label_propagation._LabelPropagationPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.label_propagation
+
+.. autoclass:: katana.analytics.LabelPropagationStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.label_propagation_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/label_propagation/label_propagation.h" namespace "katana::analytics" nogil:
+    cppclass _LabelPropagationPlan "katana::analytics::LabelPropagationPlan" (_Plan):
+        enum Algorithm:
+            kSynchronous "katana::analytics::LabelPropagationPlan::kSynchronous"
+            kAsynchronous "katana::analytics::LabelPropagationPlan::kAsynchronous"
+
+        _LabelPropagationPlan.Algorithm algorithm() const
+        uint32_t max_iterations() const
+
+        LabelPropagationPlan()
+
+        @staticmethod
+        _LabelPropagationPlan Synchronous(uint32_t max_iterations)
+        @staticmethod
+        _LabelPropagationPlan Asynchronous(uint32_t max_iterations)
+
+    uint32_t kDefaultMaxIterations "katana::analytics::LabelPropagationPlan::kDefaultMaxIterations"
+
+    Result[void] LabelPropagation(_PropertyGraph* pg, string output_property_name, _LabelPropagationPlan plan)
+
+    Result[void] LabelPropagationAssertValid(_PropertyGraph* pg, string output_property_name)
+
+    cppclass _LabelPropagationStatistics "katana::analytics::LabelPropagationStatistics":
+        uint64_t n_communities
+        uint64_t n_non_trivial_communities
+        uint64_t largest_community_size
+        double largest_community_ratio
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_LabelPropagationStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
+
+class _LabelPropagationPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.LabelPropagationPlan` constructors for algorithm documentation.
+    """
+    Synchronous = _LabelPropagationPlan.Algorithm.kSynchronous
+    Asynchronous = _LabelPropagationPlan.Algorithm.kAsynchronous
+
+
+cdef class LabelPropagationPlan(Plan):
+    """
+    A computational :ref:`Plan` for Label Propagation.
+
+    Static methods construct LabelPropagationPlans.
+    """
+    cdef:
+        _LabelPropagationPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _LabelPropagationPlanAlgorithm
+
+    @staticmethod
+    cdef LabelPropagationPlan make(_LabelPropagationPlan u):
+        f = <LabelPropagationPlan>LabelPropagationPlan.__new__(LabelPropagationPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> LabelPropagationPlan.Algorithm:
+        return _LabelPropagationPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def max_iterations(self) -> uint32_t:
+        return self.underlying_.max_iterations()
+
+    @staticmethod
+    def synchronous(uint32_t max_iterations = kDefaultMaxIterations) -> LabelPropagationPlan:
+        """
+        Deterministic rounds in which every node takes the label most frequent among its neighbors in the previous
+        round. Only nodes with a neighbor that changed label are evaluated again.
+        """
+        return LabelPropagationPlan.make(_LabelPropagationPlan.Synchronous(max_iterations))
+
+    @staticmethod
+    def asynchronous(uint32_t max_iterations = kDefaultMaxIterations) -> LabelPropagationPlan:
+        """
+        Like synchronous, but labels are updated in place. Converges in fewer rounds, but the result depends on the
+        schedule.
+        """
+        return LabelPropagationPlan.make(_LabelPropagationPlan.Asynchronous(max_iterations))
+
+
+def label_propagation(PropertyGraph pg, str output_property_name, LabelPropagationPlan plan = LabelPropagationPlan()):
+    """
+    Detect communities in pg by label propagation. The pg must be symmetric.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the label, a node id, of each node. This property must
+        not already exist. It can seed :py:func:`~katana.analytics.louvain_clustering_from_seed`.
+    :type plan: LabelPropagationPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(LabelPropagation(pg.underlying_property_graph(), output_property_name_str, plan.underlying_))
+
+
+def label_propagation_assert_valid(PropertyGraph pg, str output_property_name):
+    """
+    Raise an exception if the label propagation results in `pg` are invalid. This is not an exhaustive check, just a
+    sanity check.
+
+    :raises: AssertionError
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(LabelPropagationAssertValid(pg.underlying_property_graph(), output_property_name_str))
+
+
+cdef _LabelPropagationStatistics handle_result_LabelPropagationStatistics(Result[_LabelPropagationStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class LabelPropagationStatistics:
+    """
+    Compute the :ref:`statistics` of a Label Propagation result.
+    """
+    cdef _LabelPropagationStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str output_property_name):
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_LabelPropagationStatistics(_LabelPropagationStatistics.Compute(
+                pg.underlying_property_graph(), output_property_name_str))
+
+    @property
+    def n_communities(self) -> uint64_t:
+        return self.underlying.n_communities
+
+    @property
+    def n_non_trivial_communities(self) -> uint64_t:
+        return self.underlying.n_non_trivial_communities
+
+    @property
+    def largest_community_size(self) -> uint64_t:
+        return self.underlying.largest_community_size
+
+    @property
+    def largest_community_ratio(self) -> double:
+        return self.underlying.largest_community_ratio
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
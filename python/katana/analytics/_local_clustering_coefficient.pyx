@@ -31,6 +31,7 @@ cdef extern from "katana/analytics/local_clustering_coefficient/local_clustering
         enum Algorithm:
             kOrderedCountAtomics "katana::analytics::LocalClusteringCoefficientPlan::kOrderedCountAtomics"
             kOrderedCountPerThread "katana::analytics::LocalClusteringCoefficientPlan::kOrderedCountPerThread"
+            kOrderedCountOwnerComputes "katana::analytics::LocalClusteringCoefficientPlan::kOrderedCountOwnerComputes"
 
         enum Relabeling:
             kRelabel "katana::analytics::LocalClusteringCoefficientPlan::kRelabel"
@@ -53,6 +54,11 @@ cdef extern from "katana/analytics/local_clustering_coefficient/local_clustering
                 bool edges_sorted,
                 _LocalClusteringCoefficientPlan.Relabeling relabeling
             )
+        @staticmethod
+        _LocalClusteringCoefficientPlan OrderedCountOwnerComputes(
+                bool edges_sorted,
+                _LocalClusteringCoefficientPlan.Relabeling relabeling
+            )
 
     _LocalClusteringCoefficientPlan.Relabeling kDefaultRelabeling "katana::analytics::LocalClusteringCoefficientPlan::kDefaultRelabeling"
     bool kDefaultEdgesSorted "katana::analytics::LocalClusteringCoefficientPlan::kDefaultEdgesSorted"
@@ -66,6 +72,7 @@ class _LocalClusteringCoefficientPlanAlgorithm(Enum):
     """
     OrderedCountAtomics = _LocalClusteringCoefficientPlan.Algorithm.kOrderedCountAtomics
     OrderedCountPerThread = _LocalClusteringCoefficientPlan.Algorithm.kOrderedCountPerThread
+    OrderedCountOwnerComputes = _LocalClusteringCoefficientPlan.Algorithm.kOrderedCountOwnerComputes
 
 
 cdef _relabeling_to_python(v):
@@ -151,6 +158,23 @@ cdef class LocalClusteringCoefficientPlan(Plan):
         return LocalClusteringCoefficientPlan.make(_LocalClusteringCoefficientPlan.OrderedCountPerThread(
              edges_sorted, _relabeling_from_python(relabeling)))
 
+    @staticmethod
+    def ordered_count_owner_computes(
+                relabeling = _relabeling_to_python(kDefaultRelabeling),
+                bool edges_sorted = kDefaultEdgesSorted
+            ):
+        """
+        The ordered count algorithm without atomics or thread-local arrays of counts. Each triangle is
+        found once, at its largest node, and counted for the two edges of that node in it; each node
+        then collects the counts of the edges to it from its larger neighbors. This takes one count per
+        edge instead of one per node for each thread.
+
+        :param relabeling: Should the algorithm relabel the nodes.
+        :param edges_sorted: Are the edges of the graph already sorted.
+        """
+        return LocalClusteringCoefficientPlan.make(_LocalClusteringCoefficientPlan.OrderedCountOwnerComputes(
+             edges_sorted, _relabeling_from_python(relabeling)))
+
 
 def local_clustering_coefficient(PropertyGraph pg, str output_property_name, LocalClusteringCoefficientPlan plan = LocalClusteringCoefficientPlan()):
     cdef string output_property_name_str = bytes(output_property_name, "utf-8")
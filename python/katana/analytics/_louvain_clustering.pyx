@@ -13,6 +13,8 @@ Louvain Clustering
 
 .. autofunction:: katana.analytics.louvain_clustering
 
+.. autofunction:: katana.analytics.louvain_clustering_from_seed
+
 .. autoclass:: katana.analytics.LouvainClusteringStatistics
     :members:
     :undoc-members:
@@ -74,6 +76,9 @@ cdef extern from "katana/analytics/louvain_clustering/louvain_clustering.h" name
 
     Result[void] LouvainClustering(_PropertyGraph* pfg, const string& edge_weight_property_name,const string& output_property_name, _LouvainClusteringPlan plan)
 
+    Result[void] LouvainClusteringFromSeed(_PropertyGraph* pfg, const string& edge_weight_property_name,
+            const string& seed_property_name, const string& output_property_name, _LouvainClusteringPlan plan)
+
     Result[void] LouvainClusteringAssertValid(_PropertyGraph* pfg,
             const string& edge_weight_property_name,
             const string& output_property_name
@@ -187,6 +192,21 @@ def louvain_clustering(PropertyGraph pg, str edge_weight_property_name, str outp
         handle_result_void(LouvainClustering(pg.underlying_property_graph(), edge_weight_property_name_str, output_property_name_str, plan.underlying_))
 
 
+def louvain_clustering_from_seed(PropertyGraph pg, str edge_weight_property_name, str seed_property_name, str output_property_name, LouvainClusteringPlan plan = LouvainClusteringPlan()):
+    """
+    Compute the Louvain Clustering for pg starting from the clusters in the
+    uint64 node property named seed_property_name, e.g., the labels computed
+    by label_propagation. Each seed cluster must be a node id. Louvain merges
+    the seed clusters but never splits them.
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string seed_property_name_str = bytes(seed_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(LouvainClusteringFromSeed(pg.underlying_property_graph(), edge_weight_property_name_str,
+                seed_property_name_str, output_property_name_str, plan.underlying_))
+
+
 def louvain_clustering_assert_valid(PropertyGraph pg, str edge_weight_property_name, str output_property_name ):
     cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
     cdef string output_property_name_str = bytes(output_property_name, "utf-8")
@@ -0,0 +1,249 @@
+"""
+Matrix Completion
+-----------------
+
+.. autoclass:: katana.analytics.MatrixCompletionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._matrix_completion._MatrixCompletionPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.matrix_completion
+
+.. autoclass:: katana.analytics.MatrixCompletionStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.matrix_completion_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/matrix_completion/matrix_completion.h" namespace "katana::analytics" nogil:
+    cppclass _MatrixCompletionPlan "katana::analytics::MatrixCompletionPlan" (_Plan):
+        enum Algorithm:
+            kStochasticGradientDescent "katana::analytics::MatrixCompletionPlan::kStochasticGradientDescent"
+            kAlternatingLeastSquares "katana::analytics::MatrixCompletionPlan::kAlternatingLeastSquares"
+
+        _MatrixCompletionPlan.Algorithm algorithm() const
+        uint32_t latent_vector_size() const
+        double learning_rate() const
+        double lambda_ "lambda"() const
+        double tolerance() const
+        uint32_t max_iterations() const
+        uint32_t items_per_block() const
+        uint32_t users_per_block() const
+
+        MatrixCompletionPlan()
+
+        @staticmethod
+        _MatrixCompletionPlan StochasticGradientDescent(
+            uint32_t latent_vector_size, double learning_rate, double lambda_, double tolerance,
+            uint32_t max_iterations, uint32_t items_per_block, uint32_t users_per_block)
+        @staticmethod
+        _MatrixCompletionPlan AlternatingLeastSquares(
+            uint32_t latent_vector_size, double lambda_, double tolerance, uint32_t max_iterations)
+
+    uint32_t kDefaultLatentVectorSize "katana::analytics::MatrixCompletionPlan::kDefaultLatentVectorSize"
+    double kDefaultLearningRate "katana::analytics::MatrixCompletionPlan::kDefaultLearningRate"
+    double kDefaultLambda "katana::analytics::MatrixCompletionPlan::kDefaultLambda"
+    double kDefaultTolerance "katana::analytics::MatrixCompletionPlan::kDefaultTolerance"
+    uint32_t kDefaultMaxIterations "katana::analytics::MatrixCompletionPlan::kDefaultMaxIterations"
+    uint32_t kDefaultItemsPerBlock "katana::analytics::MatrixCompletionPlan::kDefaultItemsPerBlock"
+    uint32_t kDefaultUsersPerBlock "katana::analytics::MatrixCompletionPlan::kDefaultUsersPerBlock"
+
+    Result[void] MatrixCompletion(_PropertyGraph* pg, string edge_rating_property_name, string output_property_name, _MatrixCompletionPlan plan)
+
+    Result[void] MatrixCompletionAssertValid(_PropertyGraph* pg, string output_property_name)
+
+    cppclass _MatrixCompletionStatistics "katana::analytics::MatrixCompletionStatistics":
+        uint64_t n_items
+        uint64_t n_users
+        double rmse
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MatrixCompletionStatistics] Compute(_PropertyGraph* pg, string edge_rating_property_name, string output_property_name)
+
+
+class _MatrixCompletionPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.MatrixCompletionPlan` constructors for algorithm documentation.
+    """
+    StochasticGradientDescent = _MatrixCompletionPlan.Algorithm.kStochasticGradientDescent
+    AlternatingLeastSquares = _MatrixCompletionPlan.Algorithm.kAlternatingLeastSquares
+
+
+cdef class MatrixCompletionPlan(Plan):
+    """
+    A computational :ref:`Plan` for Matrix Completion.
+
+    Static methods construct MatrixCompletionPlans.
+    """
+    cdef:
+        _MatrixCompletionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MatrixCompletionPlanAlgorithm
+
+    @staticmethod
+    cdef MatrixCompletionPlan make(_MatrixCompletionPlan u):
+        f = <MatrixCompletionPlan>MatrixCompletionPlan.__new__(MatrixCompletionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> MatrixCompletionPlan.Algorithm:
+        return _MatrixCompletionPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def latent_vector_size(self) -> uint32_t:
+        return self.underlying_.latent_vector_size()
+
+    @property
+    def learning_rate(self) -> double:
+        return self.underlying_.learning_rate()
+
+    @property
+    def lambda_(self) -> double:
+        return self.underlying_.lambda_()
+
+    @property
+    def tolerance(self) -> double:
+        return self.underlying_.tolerance()
+
+    @property
+    def max_iterations(self) -> uint32_t:
+        return self.underlying_.max_iterations()
+
+    @property
+    def items_per_block(self) -> uint32_t:
+        return self.underlying_.items_per_block()
+
+    @property
+    def users_per_block(self) -> uint32_t:
+        return self.underlying_.users_per_block()
+
+    @staticmethod
+    def stochastic_gradient_descent(
+        uint32_t latent_vector_size = kDefaultLatentVectorSize,
+        double learning_rate = kDefaultLearningRate,
+        double lambda_ = kDefaultLambda,
+        double tolerance = kDefaultTolerance,
+        uint32_t max_iterations = kDefaultMaxIterations,
+        uint32_t items_per_block = kDefaultItemsPerBlock,
+        uint32_t users_per_block = kDefaultUsersPerBlock
+    ) -> MatrixCompletionPlan:
+        """
+        Gradient steps on every rating, scheduled in tiles of items by users that share no row or column, so that
+        updates never conflict. The step size follows the bold driver.
+        """
+        return MatrixCompletionPlan.make(_MatrixCompletionPlan.StochasticGradientDescent(
+            latent_vector_size, learning_rate, lambda_, tolerance, max_iterations, items_per_block, users_per_block))
+
+    @staticmethod
+    def alternating_least_squares(
+        uint32_t latent_vector_size = kDefaultLatentVectorSize,
+        double lambda_ = kDefaultLambda,
+        double tolerance = kDefaultTolerance,
+        uint32_t max_iterations = kDefaultMaxIterations
+    ) -> MatrixCompletionPlan:
+        """
+        Alternately solve the regularized least squares problems of all items and of all users exactly.
+        """
+        return MatrixCompletionPlan.make(_MatrixCompletionPlan.AlternatingLeastSquares(
+            latent_vector_size, lambda_, tolerance, max_iterations))
+
+
+def matrix_completion(
+    PropertyGraph pg,
+    str edge_rating_property_name,
+    str output_property_name,
+    MatrixCompletionPlan plan = MatrixCompletionPlan()
+):
+    """
+    Factor the rating matrix of the bipartite graph pg into latent vectors, so that the rating of an edge is
+    approximated by the dot product of the vectors of its endpoints. The items are the nodes with out-edges and must
+    precede all users; every edge goes from an item to a user.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type edge_rating_property_name: str
+    :param edge_rating_property_name: The input property containing the rating of each edge.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the latent vector of each node as a fixed size list of
+        floats. This property must not already exist.
+    :type plan: MatrixCompletionPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string edge_rating_property_name_str = edge_rating_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(MatrixCompletion(
+            pg.underlying_property_graph(), edge_rating_property_name_str, output_property_name_str,
+            plan.underlying_))
+
+
+def matrix_completion_assert_valid(PropertyGraph pg, str output_property_name):
+    """
+    Raise an exception if the latent vectors in `pg` are invalid. This is not an exhaustive check, just a sanity check.
+
+    :raises: AssertionError
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(MatrixCompletionAssertValid(pg.underlying_property_graph(), output_property_name_str))
+
+
+cdef _MatrixCompletionStatistics handle_result_MatrixCompletionStatistics(
+    Result[_MatrixCompletionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MatrixCompletionStatistics:
+    """
+    Compute the :ref:`statistics` of a Matrix Completion result.
+    """
+    cdef _MatrixCompletionStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str edge_rating_property_name, str output_property_name):
+        cdef string edge_rating_property_name_str = edge_rating_property_name.encode("utf-8")
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_MatrixCompletionStatistics(_MatrixCompletionStatistics.Compute(
+                pg.underlying_property_graph(), edge_rating_property_name_str, output_property_name_str))
+
+    @property
+    def n_items(self) -> uint64_t:
+        return self.underlying.n_items
+
+    @property
+    def n_users(self) -> uint64_t:
+        return self.underlying.n_users
+
+    @property
+    def rmse(self) -> double:
+        return self.underlying.rmse
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,192 @@
+"""
+Max Flow
+--------
+
+.. autoclass:: katana.analytics.MaxFlowPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._max_flow._MaxFlowPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.max_flow
+
+.. autoclass:: katana.analytics.MaxFlowStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.max_flow_assert_valid
+"""
+from libc.stdint cimport int64_t, uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/max_flow/max_flow.h" namespace "katana::analytics" nogil:
+    cppclass _MaxFlowPlan "katana::analytics::MaxFlowPlan" (_Plan):
+        enum Algorithm:
+            kPushRelabel "katana::analytics::MaxFlowPlan::kPushRelabel"
+
+        _MaxFlowPlan.Algorithm algorithm() const
+        uint64_t global_relabel_interval() const
+
+        MaxFlowPlan()
+
+        @staticmethod
+        _MaxFlowPlan PushRelabel(uint64_t global_relabel_interval)
+
+    uint64_t kDefaultGlobalRelabelInterval "katana::analytics::MaxFlowPlan::kDefaultGlobalRelabelInterval"
+
+    Result[void] MaxFlow(
+        _PropertyGraph* pg, uint32_t source_id, uint32_t sink_id, string edge_capacity_property_name,
+        string output_property_name, _MaxFlowPlan plan)
+
+    Result[void] MaxFlowAssertValid(
+        _PropertyGraph* pg, uint32_t source_id, uint32_t sink_id, string edge_capacity_property_name,
+        string output_property_name)
+
+    cppclass _MaxFlowStatistics "katana::analytics::MaxFlowStatistics":
+        int64_t flow_value
+        uint64_t n_saturated_edges
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MaxFlowStatistics] Compute(
+            _PropertyGraph* pg, uint32_t source_id, string edge_capacity_property_name, string output_property_name)
+
+
+class _MaxFlowPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.MaxFlowPlan` constructors for algorithm documentation.
+    """
+    PushRelabel = _MaxFlowPlan.Algorithm.kPushRelabel
+
+
+cdef class MaxFlowPlan(Plan):
+    """
+    A computational :ref:`Plan` for Max Flow.
+
+    Static methods construct MaxFlowPlans.
+    """
+    cdef:
+        _MaxFlowPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MaxFlowPlanAlgorithm
+
+    @staticmethod
+    cdef MaxFlowPlan make(_MaxFlowPlan u):
+        f = <MaxFlowPlan>MaxFlowPlan.__new__(MaxFlowPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> MaxFlowPlan.Algorithm:
+        return _MaxFlowPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def global_relabel_interval(self) -> uint64_t:
+        return self.underlying_.global_relabel_interval()
+
+    @staticmethod
+    def push_relabel(uint64_t global_relabel_interval = kDefaultGlobalRelabelInterval) -> MaxFlowPlan:
+        """
+        Parallel push-relabel, with global relabeling by breadth-first search from the sink every
+        global_relabel_interval arcs scanned (or by default, every 6 * num_nodes + num_edges) and the gap heuristic.
+        """
+        return MaxFlowPlan.make(_MaxFlowPlan.PushRelabel(global_relabel_interval))
+
+
+def max_flow(
+    PropertyGraph pg,
+    uint32_t source_id,
+    uint32_t sink_id,
+    str edge_capacity_property_name,
+    str output_property_name,
+    MaxFlowPlan plan = MaxFlowPlan()
+):
+    """
+    Compute a maximum flow from source_id to sink_id.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type source_id: int
+    :param source_id: The node the flow leaves.
+    :type sink_id: int
+    :param sink_id: The node the flow enters.
+    :type edge_capacity_property_name: str
+    :param edge_capacity_property_name: The integer edge property holding the capacity of each edge.
+    :type output_property_name: str
+    :param output_property_name: The output edge property holding the flow on each edge, of the same type as the
+        capacities. This property must not already exist.
+    :type plan: MaxFlowPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string edge_capacity_property_name_str = edge_capacity_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(MaxFlow(
+            pg.underlying_property_graph(), source_id, sink_id, edge_capacity_property_name_str,
+            output_property_name_str, plan.underlying_))
+
+
+def max_flow_assert_valid(
+    PropertyGraph pg, uint32_t source_id, uint32_t sink_id, str edge_capacity_property_name, str output_property_name
+):
+    """
+    Raise an exception if the flow is not within the capacities, is not conserved, or is not maximum.
+
+    :raises: AssertionError
+    """
+    cdef string edge_capacity_property_name_str = edge_capacity_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(MaxFlowAssertValid(
+            pg.underlying_property_graph(), source_id, sink_id, edge_capacity_property_name_str,
+            output_property_name_str))
+
+
+cdef _MaxFlowStatistics handle_result_MaxFlowStatistics(Result[_MaxFlowStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MaxFlowStatistics:
+    """
+    Compute the :ref:`statistics` of a Max Flow result.
+    """
+    cdef _MaxFlowStatistics underlying
+
+    def __init__(self, PropertyGraph pg, uint32_t source_id, str edge_capacity_property_name, str output_property_name):
+        cdef string edge_capacity_property_name_str = edge_capacity_property_name.encode("utf-8")
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_MaxFlowStatistics(_MaxFlowStatistics.Compute(
+                pg.underlying_property_graph(), source_id, edge_capacity_property_name_str, output_property_name_str))
+
+    @property
+    def flow_value(self) -> int64_t:
+        return self.underlying.flow_value
+
+    @property
+    def n_saturated_edges(self) -> uint64_t:
+        return self.underlying.n_saturated_edges
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,179 @@
+"""
+Minimum Spanning Forest
+-----------------------
+
+.. autoclass:: katana.analytics.MinimumSpanningForestPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._minimum_spanning_forest._MinimumSpanningForestPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.minimum_spanning_forest
+
+.. autoclass:: katana.analytics.MinimumSpanningForestStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.minimum_spanning_forest_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h" namespace "katana::analytics" nogil:
+    cppclass _MinimumSpanningForestPlan "katana::analytics::MinimumSpanningForestPlan" (_Plan):
+        enum Algorithm:
+            kBoruvka "katana::analytics::MinimumSpanningForestPlan::kBoruvka"
+
+        _MinimumSpanningForestPlan.Algorithm algorithm() const
+
+        MinimumSpanningForestPlan()
+
+        @staticmethod
+        _MinimumSpanningForestPlan Boruvka()
+
+    Result[void] MinimumSpanningForest(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name, _MinimumSpanningForestPlan plan)
+
+    Result[void] MinimumSpanningForestAssertValid(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name)
+
+    cppclass _MinimumSpanningForestStatistics "katana::analytics::MinimumSpanningForestStatistics":
+        uint64_t n_forest_edges
+        uint64_t n_trees
+        double total_weight
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MinimumSpanningForestStatistics] Compute(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name)
+
+
+class _MinimumSpanningForestPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.MinimumSpanningForestPlan` constructors for algorithm documentation.
+    """
+    Boruvka = _MinimumSpanningForestPlan.Algorithm.kBoruvka
+
+
+cdef class MinimumSpanningForestPlan(Plan):
+    """
+    A computational :ref:`Plan` for the Minimum Spanning Forest.
+
+    Static methods construct MinimumSpanningForestPlans.
+    """
+    cdef:
+        _MinimumSpanningForestPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MinimumSpanningForestPlanAlgorithm
+
+    @staticmethod
+    cdef MinimumSpanningForestPlan make(_MinimumSpanningForestPlan u):
+        f = <MinimumSpanningForestPlan>MinimumSpanningForestPlan.__new__(MinimumSpanningForestPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> MinimumSpanningForestPlan.Algorithm:
+        return _MinimumSpanningForestPlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def boruvka() -> MinimumSpanningForestPlan:
+        """
+        Rounds in which every component picks its lightest edge to another component. After the first round, only the
+        edges between distinct components are kept, in a list that is compacted every round.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.Boruvka())
+
+
+def minimum_spanning_forest(
+    PropertyGraph pg,
+    str edge_weight_property_name,
+    str output_property_name,
+    MinimumSpanningForestPlan plan = MinimumSpanningForestPlan()
+):
+    """
+    Compute a minimum spanning forest of pg, treating every edge as undirected. Ties between edges of equal weight are
+    broken by edge id, so the forest does not depend on the schedule.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input property containing the weight of each edge.
+    :type output_property_name: str
+    :param output_property_name: The output boolean edge property marking the edges in the forest. This property must
+        not already exist. Of the two directions of an edge of a symmetric graph, at most one is marked.
+    :type plan: MinimumSpanningForestPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(MinimumSpanningForest(
+            pg.underlying_property_graph(), edge_weight_property_name_str, output_property_name_str,
+            plan.underlying_))
+
+
+def minimum_spanning_forest_assert_valid(PropertyGraph pg, str edge_weight_property_name, str output_property_name):
+    """
+    Raise an exception if the minimum spanning forest results in `pg` are invalid. The forest is compared with the one
+    found by a serial Kruskal's algorithm.
+
+    :raises: AssertionError
+    """
+    cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(MinimumSpanningForestAssertValid(
+            pg.underlying_property_graph(), edge_weight_property_name_str, output_property_name_str))
+
+
+cdef _MinimumSpanningForestStatistics handle_result_MinimumSpanningForestStatistics(
+    Result[_MinimumSpanningForestStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MinimumSpanningForestStatistics:
+    """
+    Compute the :ref:`statistics` of a Minimum Spanning Forest result.
+    """
+    cdef _MinimumSpanningForestStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str edge_weight_property_name, str output_property_name):
+        cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_MinimumSpanningForestStatistics(_MinimumSpanningForestStatistics.Compute(
+                pg.underlying_property_graph(), edge_weight_property_name_str, output_property_name_str))
+
+    @property
+    def n_forest_edges(self) -> uint64_t:
+        return self.underlying.n_forest_edges
+
+    @property
+    def n_trees(self) -> uint64_t:
+        return self.underlying.n_trees
+
+    @property
+    def total_weight(self) -> double:
+        return self.underlying.total_weight
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,277 @@
+"""
+Motif Counting
+--------------
+
+.. autoclass:: katana.analytics.MotifCountPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._motif_count._MotifCountPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.motif_count
+
+.. autoclass:: katana.analytics.MotifCountStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.motif_count_assert_valid
+
+.. autofunction:: katana.analytics.directed_triad_census
+"""
+from libc.stddef cimport size_t
+from libc.stdint cimport uint64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/motif_count/motif_count.h" namespace "katana::analytics" nogil:
+    cppclass _MotifCountPlan "katana::analytics::MotifCountPlan" (_Plan):
+        enum Algorithm:
+            kOrderedCount "katana::analytics::MotifCountPlan::kOrderedCount"
+
+        enum Relabeling:
+            kRelabel "katana::analytics::MotifCountPlan::kRelabel"
+            kNoRelabel "katana::analytics::MotifCountPlan::kNoRelabel"
+            kAutoRelabel "katana::analytics::MotifCountPlan::kAutoRelabel"
+
+        _MotifCountPlan.Algorithm algorithm() const
+        _MotifCountPlan.Relabeling relabeling() const
+        bool edges_sorted() const
+
+        MotifCountPlan()
+
+        @staticmethod
+        _MotifCountPlan OrderedCount(bool edges_sorted, _MotifCountPlan.Relabeling relabeling)
+
+    _MotifCountPlan.Relabeling kDefaultRelabeling "katana::analytics::MotifCountPlan::kDefaultRelabeling"
+    bool kDefaultEdgeSorted "katana::analytics::MotifCountPlan::kDefaultEdgeSorted"
+
+    Result[void] MotifCount(_PropertyGraph* pg, string triangles_property, string four_cycles_property,
+                            string four_cliques_property, _MotifCountPlan plan)
+
+    Result[void] MotifCountAssertValid(_PropertyGraph* pg, string triangles_property, string four_cycles_property,
+                                       string four_cliques_property)
+
+    cppclass _MotifCountStatistics "katana::analytics::MotifCountStatistics":
+        uint64_t total_triangles
+        uint64_t total_four_cycles
+        uint64_t total_four_cliques
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MotifCountStatistics] Compute(_PropertyGraph* pg, string triangles_property,
+                                              string four_cycles_property, string four_cliques_property)
+
+    cppclass _TriadCounts "std::array<uint64_t, katana::analytics::TriadCensus::kNumTriadTypes>":
+        uint64_t& operator[](size_t)
+
+    cppclass _TriadCensus "katana::analytics::TriadCensus":
+        _TriadCounts counts
+
+    Result[_TriadCensus] DirectedTriadCensus(_PropertyGraph* pg)
+
+
+class _MotifCountPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.MotifCountPlan` constructors for algorithm documentation.
+    """
+    OrderedCount = _MotifCountPlan.Algorithm.kOrderedCount
+
+
+cdef _relabeling_to_python(v):
+    if v == _MotifCountPlan.Relabeling.kRelabel:
+        return True
+    elif v == _MotifCountPlan.Relabeling.kNoRelabel:
+        return False
+    else:
+        return None
+
+
+cdef _relabeling_from_python(v):
+    if v is None:
+        return _MotifCountPlan.Relabeling.kAutoRelabel
+    elif v:
+        return _MotifCountPlan.Relabeling.kRelabel
+    else:
+        return _MotifCountPlan.Relabeling.kNoRelabel
+
+
+cdef class MotifCountPlan(Plan):
+    """
+    A computational :ref:`Plan` for Motif Counting.
+
+    Static methods construct MotifCountPlans.
+    """
+    cdef:
+        _MotifCountPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MotifCountPlanAlgorithm
+
+    @staticmethod
+    cdef MotifCountPlan make(_MotifCountPlan u):
+        f = <MotifCountPlan>MotifCountPlan.__new__(MotifCountPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _MotifCountPlanAlgorithm:
+        return _MotifCountPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def edges_sorted(self) -> bool:
+        """
+        Are the edges of the graph already sorted?
+
+        :rtype: bool
+        """
+        return self.underlying_.edges_sorted()
+
+    @property
+    def relabeling(self):
+        """
+        Should the algorithm relabel the nodes? Or `None` to decide heuristically.
+
+        :rtype: Optional[bool]
+        """
+        return _relabeling_to_python(self.underlying_.relabeling())
+
+    @staticmethod
+    def ordered_count(bool edges_sorted = kDefaultEdgeSorted,
+                      relabeling = _relabeling_to_python(kDefaultRelabeling)):
+        """
+        The ordered count of triangle counting, extended to 4-cliques, and wedge counting for 4-cycles. Nodes are
+        relabeled by degree and each motif is found once.
+
+        :type edges_sorted: bool
+        :param edges_sorted: Are the edges of the graph already sorted?
+        :type relabeling: Optional[bool]
+        :param relabeling: Should the algorithm relabel the nodes? Or `None` to decide heuristically.
+        """
+        return MotifCountPlan.make(_MotifCountPlan.OrderedCount(edges_sorted, _relabeling_from_python(relabeling)))
+
+    def __str__(self):
+        return "MotifCountPlan({}, {}, {})".format(self.algorithm.name, self.edges_sorted, self.relabeling)
+
+
+def motif_count(PropertyGraph pg, str triangles_property, str four_cycles_property = "",
+                str four_cliques_property = "", MotifCountPlan plan = MotifCountPlan()):
+    """
+    Count the triangles, 4-cycles and 4-cliques of each node of `pg`, which must be symmetric. A motif whose property
+    name is empty is not counted.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type triangles_property: str
+    :param triangles_property: The output property for the triangles of each node.
+    :type four_cycles_property: str
+    :param four_cycles_property: The output property for the 4-cycles of each node.
+    :type four_cliques_property: str
+    :param four_cliques_property: The output property for the 4-cliques of each node.
+    :type plan: MotifCountPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string triangles_property_str = triangles_property.encode("utf-8")
+    cdef string four_cycles_property_str = four_cycles_property.encode("utf-8")
+    cdef string four_cliques_property_str = four_cliques_property.encode("utf-8")
+    with nogil:
+        handle_result_void(MotifCount(pg.underlying_property_graph(), triangles_property_str,
+                                      four_cycles_property_str, four_cliques_property_str, plan.underlying_))
+
+
+def motif_count_assert_valid(PropertyGraph pg, str triangles_property, str four_cycles_property = "",
+                             str four_cliques_property = ""):
+    """
+    Raise an exception if the Motif Counting results in `pg` are clearly incorrect.
+
+    :raises: AssertionError
+    """
+    cdef string triangles_property_str = triangles_property.encode("utf-8")
+    cdef string four_cycles_property_str = four_cycles_property.encode("utf-8")
+    cdef string four_cliques_property_str = four_cliques_property.encode("utf-8")
+    with nogil:
+        handle_result_assert(MotifCountAssertValid(pg.underlying_property_graph(), triangles_property_str,
+                                                   four_cycles_property_str, four_cliques_property_str))
+
+
+cdef _MotifCountStatistics handle_result_MotifCountStatistics(Result[_MotifCountStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MotifCountStatistics:
+    """
+    Compute the :ref:`statistics` of a Motif Counting computation on a graph.
+    """
+    cdef _MotifCountStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str triangles_property, str four_cycles_property = "",
+                 str four_cliques_property = ""):
+        cdef string triangles_property_str = triangles_property.encode("utf-8")
+        cdef string four_cycles_property_str = four_cycles_property.encode("utf-8")
+        cdef string four_cliques_property_str = four_cliques_property.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_MotifCountStatistics(_MotifCountStatistics.Compute(
+                pg.underlying_property_graph(), triangles_property_str, four_cycles_property_str,
+                four_cliques_property_str))
+
+    @property
+    def total_triangles(self) -> uint64_t:
+        return self.underlying.total_triangles
+
+    @property
+    def total_four_cycles(self) -> uint64_t:
+        return self.underlying.total_four_cycles
+
+    @property
+    def total_four_cliques(self) -> uint64_t:
+        return self.underlying.total_four_cliques
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
+
+
+TRIAD_TYPES = (
+    "003", "012", "102", "021D", "021U", "021C", "111D", "111U",
+    "030T", "030C", "201", "120D", "120U", "120C", "210", "300",
+)
+
+
+cdef _TriadCensus handle_result_TriadCensus(Result[_TriadCensus] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def directed_triad_census(PropertyGraph pg) -> dict:
+    """
+    Compute the triad census of `pg`, treated as directed: the number of triples of nodes of each of the 16 types of
+    directed triads. Self loops are ignored and parallel edges count once.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :return: A dict from the name of each triad type, e.g., "021D", to its number of triads.
+    """
+    cdef _TriadCensus census
+    with nogil:
+        census = handle_result_TriadCensus(DirectedTriadCensus(pg.underlying_property_graph()))
+    return {name: census.counts[i] for i, name in enumerate(TRIAD_TYPES)}
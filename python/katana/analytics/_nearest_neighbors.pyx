@@ -0,0 +1,196 @@
+"""
+Nearest Neighbors
+-----------------
+
+.. autoclass:: katana.analytics.NearestNeighborsPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._nearest_neighbors._NearestNeighborsPlanMetric
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.nearest_neighbors_build_index
+
+.. autofunction:: katana.analytics.nearest_neighbors_query
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, handle_result_void
+
+from enum import Enum
+
+import numpy as np
+
+
+cdef extern from "katana/analytics/nearest_neighbors/nearest_neighbors.h" namespace "katana::analytics" nogil:
+    cppclass _NearestNeighborsPlan "katana::analytics::NearestNeighborsPlan" (_Plan):
+        enum Metric:
+            kEuclidean "katana::analytics::NearestNeighborsPlan::kEuclidean"
+            kInnerProduct "katana::analytics::NearestNeighborsPlan::kInnerProduct"
+            kCosine "katana::analytics::NearestNeighborsPlan::kCosine"
+
+        _NearestNeighborsPlan.Metric metric() const
+        uint32_t max_degree() const
+        uint32_t build_beam_width() const
+        uint32_t query_beam_width() const
+
+        NearestNeighborsPlan()
+
+        @staticmethod
+        _NearestNeighborsPlan Hnsw(
+            _NearestNeighborsPlan.Metric metric, uint32_t max_degree, uint32_t build_beam_width,
+            uint32_t query_beam_width)
+
+    uint32_t kDefaultMaxDegree "katana::analytics::NearestNeighborsPlan::kDefaultMaxDegree"
+    uint32_t kDefaultBuildBeamWidth "katana::analytics::NearestNeighborsPlan::kDefaultBuildBeamWidth"
+    uint32_t kDefaultQueryBeamWidth "katana::analytics::NearestNeighborsPlan::kDefaultQueryBeamWidth"
+
+    Result[void] NearestNeighborsBuildIndex(
+        _PropertyGraph* pg, string embedding_property_name, string index_property_name, _NearestNeighborsPlan plan)
+
+    Result[void] NearestNeighborsQuery(
+        _PropertyGraph* pg, string embedding_property_name, string index_property_name, const float* queries,
+        uint64_t num_queries, uint32_t k, uint32_t* neighbors, float* distances, _NearestNeighborsPlan plan)
+
+
+class _NearestNeighborsPlanMetric(Enum):
+    """
+    The distance between embeddings: Euclidean, the negated inner product, or one minus the cosine similarity.
+    """
+    Euclidean = _NearestNeighborsPlan.Metric.kEuclidean
+    InnerProduct = _NearestNeighborsPlan.Metric.kInnerProduct
+    Cosine = _NearestNeighborsPlan.Metric.kCosine
+
+
+cdef class NearestNeighborsPlan(Plan):
+    """
+    A computational :ref:`Plan` for approximate nearest neighbors over node embeddings, indexed by a hierarchical
+    navigable small world (HNSW) graph.
+
+    Every node links to up to max_degree nearby nodes on each layer of the index it is on (2 * max_degree on the
+    bottom layer). Inserting a node searches for its build_beam_width nearest nodes and a query for its
+    query_beam_width nearest nodes; wider beams are more accurate and slower.
+
+    Static methods construct NearestNeighborsPlans.
+    """
+    cdef:
+        _NearestNeighborsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Metric = _NearestNeighborsPlanMetric
+
+    @staticmethod
+    cdef NearestNeighborsPlan make(_NearestNeighborsPlan u):
+        f = <NearestNeighborsPlan>NearestNeighborsPlan.__new__(NearestNeighborsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def metric(self) -> NearestNeighborsPlan.Metric:
+        return _NearestNeighborsPlanMetric(self.underlying_.metric())
+
+    @property
+    def max_degree(self) -> uint32_t:
+        return self.underlying_.max_degree()
+
+    @property
+    def build_beam_width(self) -> uint32_t:
+        return self.underlying_.build_beam_width()
+
+    @property
+    def query_beam_width(self) -> uint32_t:
+        return self.underlying_.query_beam_width()
+
+    @staticmethod
+    def hnsw(
+        metric = _NearestNeighborsPlanMetric.Euclidean,
+        uint32_t max_degree = kDefaultMaxDegree,
+        uint32_t build_beam_width = kDefaultBuildBeamWidth,
+        uint32_t query_beam_width = kDefaultQueryBeamWidth
+    ) -> NearestNeighborsPlan:
+        """
+        Index the embeddings with an HNSW graph. An index must be queried with the metric and max_degree it was
+        built with.
+        """
+        return NearestNeighborsPlan.make(_NearestNeighborsPlan.Hnsw(
+            _NearestNeighborsPlanMetric(metric).value, max_degree, build_beam_width, query_beam_width))
+
+
+def nearest_neighbors_build_index(
+    PropertyGraph pg,
+    str embedding_property_name,
+    str index_property_name,
+    NearestNeighborsPlan plan = NearestNeighborsPlan()
+):
+    """
+    Build an approximate nearest neighbor index over the embeddings of the nodes of pg. The index is a node property,
+    so it is saved and loaded with the graph.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to index.
+    :type embedding_property_name: str
+    :param embedding_property_name: The input property holding the embedding of each node as a fixed size list of
+        floats.
+    :type index_property_name: str
+    :param index_property_name: The output property holding the index. This property must not already exist.
+    :type plan: NearestNeighborsPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string embedding_property_name_str = embedding_property_name.encode("utf-8")
+    cdef string index_property_name_str = index_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(NearestNeighborsBuildIndex(
+            pg.underlying_property_graph(), embedding_property_name_str, index_property_name_str,
+            plan.underlying_))
+
+
+def nearest_neighbors_query(
+    PropertyGraph pg,
+    str embedding_property_name,
+    str index_property_name,
+    queries,
+    uint32_t k,
+    NearestNeighborsPlan plan = NearestNeighborsPlan()
+):
+    """
+    Find approximately the k nodes whose embeddings are nearest to each query, using an index built by
+    :py:func:`nearest_neighbors_build_index`.
+
+    :type pg: PropertyGraph
+    :param pg: The indexed graph.
+    :type embedding_property_name: str
+    :param embedding_property_name: The property holding the embeddings the index was built over.
+    :type index_property_name: str
+    :param index_property_name: The property holding the index.
+    :param queries: A two dimensional array of query embeddings, one per row, with as many columns as the embeddings
+        have values.
+    :type k: int
+    :param k: The number of neighbors of each query.
+    :type plan: NearestNeighborsPlan
+    :param plan: The plan the index was built with.
+    :return: Arrays of the node ids of the neighbors of each query, nearest first, and their distances, one row per
+        query. Missing neighbors get the largest node id and an infinite distance.
+    """
+    cdef const float[:, ::1] queries_view = np.ascontiguousarray(queries, dtype=np.float32)
+    cdef uint64_t num_queries = queries_view.shape[0]
+    neighbors = np.empty((num_queries, k), dtype=np.uint32)
+    distances = np.empty((num_queries, k), dtype=np.float32)
+    if num_queries == 0 or k == 0:
+        return neighbors, distances
+    cdef uint32_t[:, ::1] neighbors_view = neighbors
+    cdef float[:, ::1] distances_view = distances
+    cdef string embedding_property_name_str = embedding_property_name.encode("utf-8")
+    cdef string index_property_name_str = index_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(NearestNeighborsQuery(
+            pg.underlying_property_graph(), embedding_property_name_str, index_property_name_str,
+            &queries_view[0, 0], num_queries, k, &neighbors_view[0, 0], &distances_view[0, 0], plan.underlying_))
+    return neighbors, distances
@@ -0,0 +1,180 @@
+"""
+Neighbor Aggregation
+--------------------
+
+.. autoclass:: katana.analytics.NeighborAggregationPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._neighbor_aggregation._NeighborAggregationPlanAggregation
+    :members:
+    :undoc-members:
+
+.. autoclass:: katana.analytics._neighbor_aggregation._NeighborAggregationPlanNeighbors
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.neighbor_aggregation
+"""
+from libc.stdint cimport uint32_t
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, handle_result_void
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/neighbor_aggregation/neighbor_aggregation.h" namespace "katana::analytics" nogil:
+    cppclass _NeighborAggregationPlan "katana::analytics::NeighborAggregationPlan" (_Plan):
+        enum Aggregation:
+            kSum "katana::analytics::NeighborAggregationPlan::kSum"
+            kMean "katana::analytics::NeighborAggregationPlan::kMean"
+            kMax "katana::analytics::NeighborAggregationPlan::kMax"
+
+        enum Neighbors:
+            kOutNeighbors "katana::analytics::NeighborAggregationPlan::kOutNeighbors"
+            kInNeighbors "katana::analytics::NeighborAggregationPlan::kInNeighbors"
+
+        _NeighborAggregationPlan.Aggregation aggregation() const
+        _NeighborAggregationPlan.Neighbors neighbors() const
+        uint32_t feature_block_size() const
+
+        NeighborAggregationPlan()
+
+        @staticmethod
+        _NeighborAggregationPlan Sum(_NeighborAggregationPlan.Neighbors neighbors, uint32_t feature_block_size)
+        @staticmethod
+        _NeighborAggregationPlan Mean(_NeighborAggregationPlan.Neighbors neighbors, uint32_t feature_block_size)
+        @staticmethod
+        _NeighborAggregationPlan Max(_NeighborAggregationPlan.Neighbors neighbors, uint32_t feature_block_size)
+
+    uint32_t kDefaultFeatureBlockSize "katana::analytics::NeighborAggregationPlan::kDefaultFeatureBlockSize"
+
+    Result[void] NeighborAggregation(
+        _PropertyGraph* pg, string input_property_name, string output_property_name,
+        string edge_weight_property_name, _NeighborAggregationPlan plan)
+
+
+class _NeighborAggregationPlanAggregation(Enum):
+    """
+    :see: :py:class:`~katana.analytics.NeighborAggregationPlan` constructors for documentation.
+    """
+    Sum = _NeighborAggregationPlan.Aggregation.kSum
+    Mean = _NeighborAggregationPlan.Aggregation.kMean
+    Max = _NeighborAggregationPlan.Aggregation.kMax
+
+
+class _NeighborAggregationPlanNeighbors(Enum):
+    """
+    Whether the neighbors of a node are the destinations of its out-edges or the sources of its in-edges.
+    """
+    OutNeighbors = _NeighborAggregationPlan.Neighbors.kOutNeighbors
+    InNeighbors = _NeighborAggregationPlan.Neighbors.kInNeighbors
+
+
+cdef class NeighborAggregationPlan(Plan):
+    """
+    A computational :ref:`Plan` for Neighbor Aggregation.
+
+    Every node reads the features of its neighbors, feature_block_size features at a time, or all at once for 0, so
+    that the features read by one pass stay in cache.
+
+    Static methods construct NeighborAggregationPlans.
+    """
+    cdef:
+        _NeighborAggregationPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Aggregation = _NeighborAggregationPlanAggregation
+    Neighbors = _NeighborAggregationPlanNeighbors
+
+    @staticmethod
+    cdef NeighborAggregationPlan make(_NeighborAggregationPlan u):
+        f = <NeighborAggregationPlan>NeighborAggregationPlan.__new__(NeighborAggregationPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def aggregation(self) -> NeighborAggregationPlan.Aggregation:
+        return _NeighborAggregationPlanAggregation(self.underlying_.aggregation())
+
+    @property
+    def neighbors(self) -> NeighborAggregationPlan.Neighbors:
+        return _NeighborAggregationPlanNeighbors(self.underlying_.neighbors())
+
+    @property
+    def feature_block_size(self) -> uint32_t:
+        return self.underlying_.feature_block_size()
+
+    @staticmethod
+    def sum(
+        neighbors = _NeighborAggregationPlanNeighbors.InNeighbors,
+        uint32_t feature_block_size = kDefaultFeatureBlockSize
+    ) -> NeighborAggregationPlan:
+        """
+        The sum of the (weighted) features of the neighbors.
+        """
+        return NeighborAggregationPlan.make(_NeighborAggregationPlan.Sum(
+            _NeighborAggregationPlanNeighbors(neighbors).value, feature_block_size))
+
+    @staticmethod
+    def mean(
+        neighbors = _NeighborAggregationPlanNeighbors.InNeighbors,
+        uint32_t feature_block_size = kDefaultFeatureBlockSize
+    ) -> NeighborAggregationPlan:
+        """
+        The sum divided by the number of neighbors or, with weights, by the sum of the weights.
+        """
+        return NeighborAggregationPlan.make(_NeighborAggregationPlan.Mean(
+            _NeighborAggregationPlanNeighbors(neighbors).value, feature_block_size))
+
+    @staticmethod
+    def max(
+        neighbors = _NeighborAggregationPlanNeighbors.InNeighbors,
+        uint32_t feature_block_size = kDefaultFeatureBlockSize
+    ) -> NeighborAggregationPlan:
+        """
+        The largest (weighted) value of each feature among the neighbors.
+        """
+        return NeighborAggregationPlan.make(_NeighborAggregationPlan.Max(
+            _NeighborAggregationPlanNeighbors(neighbors).value, feature_block_size))
+
+
+def neighbor_aggregation(
+    PropertyGraph pg,
+    str input_property_name,
+    str output_property_name,
+    str edge_weight_property_name = None,
+    NeighborAggregationPlan plan = NeighborAggregationPlan()
+):
+    """
+    Aggregate the features of the neighbors of every node, e.g., for the layers of a graph neural network. A node
+    without neighbors aggregates to zeros.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type input_property_name: str
+    :param input_property_name: The input property holding the features of each node as a fixed size list of floats
+        or doubles.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the aggregate of each node as a fixed size list of
+        floats of the same size. This property must not already exist.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: If given, the edge property by whose values the features of neighbors are
+        multiplied.
+    :type plan: NeighborAggregationPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string input_property_name_str = input_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    cdef string edge_weight_property_name_str = (edge_weight_property_name or "").encode("utf-8")
+    with nogil:
+        handle_result_void(NeighborAggregation(
+            pg.underlying_property_graph(), input_property_name_str, output_property_name_str,
+            edge_weight_property_name_str, plan.underlying_))
@@ -15,15 +15,26 @@ Page Rank
     :members:
     :undoc-members:
 
+.. autoclass:: katana.analytics._pagerank._PagerankPlanPrecision
+    :members:
+    :undoc-members:
+
 .. autofunction:: katana.analytics.pagerank
 
+.. autofunction:: katana.analytics.pagerank_incremental
+
+.. autofunction:: katana.analytics.pagerank_personalized
+
 .. autoclass:: katana.analytics.PagerankStatistics
     :members:
     :undoc-members:
 
 .. autofunction:: katana.analytics.pagerank_assert_valid
 """
+from libc.stdint cimport uint32_t
+from libcpp.pair cimport pair
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 from katana._property_graph cimport PropertyGraph
 from katana.analytics.plan cimport Plan, _Plan
@@ -41,6 +52,11 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
             kPullResidual "katana::analytics::PagerankPlan::kPullResidual"
             kPushSynchronous "katana::analytics::PagerankPlan::kPushSynchronous"
             kPushAsynchronous "katana::analytics::PagerankPlan::kPushAsynchronous"
+            kPullBlocked "katana::analytics::PagerankPlan::kPullBlocked"
+
+        enum Precision:
+            kFloat "katana::analytics::PagerankPlan::kFloat"
+            kBFloat16 "katana::analytics::PagerankPlan::kBFloat16"
 
         # unsigned int kChunkSize
 
@@ -49,24 +65,37 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         unsigned int max_iterations() const
         float alpha() const
         float initial_residual() const
+        uint32_t segment_size() const
+        _PagerankPlan.Precision precision() const
 
         PagerankPlan()
 
         @staticmethod
-        _PagerankPlan PullTopological(float tolerance, unsigned int max_iterations, float alpha)
+        _PagerankPlan PullTopological(float tolerance, unsigned int max_iterations, float alpha, _PagerankPlan.Precision precision)
         @staticmethod
         _PagerankPlan PullResidual(float tolerance, unsigned int max_iterations, float alpha)
         @staticmethod
         _PagerankPlan PushAsynchronous(float tolerance, float alpha)
         @staticmethod
+        _PagerankPlan PullBlocked(float tolerance, unsigned int max_iterations, float alpha, uint32_t segment_size, _PagerankPlan.Precision precision)
+        @staticmethod
         _PagerankPlan PushSynchronous(float tolerance, unsigned int max_iterations, float alpha)
 
     double kDefaultTolerance "katana::analytics::PagerankPlan::kDefaultTolerance"
     int kDefaultMaxIterations "katana::analytics::PagerankPlan::kDefaultMaxIterations"
     double kDefaultAlpha "katana::analytics::PagerankPlan::kDefaultAlpha"
+    uint32_t kDefaultSegmentSize "katana::analytics::PagerankPlan::kDefaultSegmentSize"
 
     Result[void] Pagerank(_PropertyGraph* pg, string output_property_name, _PagerankPlan plan)
 
+    cppclass _PagerankEdgeChanges "katana::analytics::PagerankEdgeChanges":
+        vector[pair[uint32_t, uint32_t]] inserted
+        vector[pair[uint32_t, uint32_t]] deleted
+
+    Result[void] PagerankIncremental(_PropertyGraph* pg, string rank_property_name, const _PagerankEdgeChanges& changes, _PagerankPlan plan)
+
+    Result[void] PagerankPersonalized(_PropertyGraph* pg, const vector[vector[uint32_t]]& seed_sets, const vector[string]& output_property_names, _PagerankPlan plan)
+
     Result[void] PagerankAssertValid(_PropertyGraph* pg, string output_property_name)
 
     cppclass _PagerankStatistics "katana::analytics::PagerankStatistics":
@@ -85,6 +114,12 @@ class _PagerankPlanAlgorithm(Enum):
     PullResidual = _PagerankPlan.Algorithm.kPullResidual
     PushSynchronous = _PagerankPlan.Algorithm.kPushSynchronous
     PushAsynchronous = _PagerankPlan.Algorithm.kPushAsynchronous
+    PullBlocked = _PagerankPlan.Algorithm.kPullBlocked
+
+
+class _PagerankPlanPrecision(Enum):
+    Float = _PagerankPlan.Precision.kFloat
+    BFloat16 = _PagerankPlan.Precision.kBFloat16
 
 
 cdef class PagerankPlan(Plan):
@@ -100,6 +135,7 @@ cdef class PagerankPlan(Plan):
         return &self.underlying_
 
     Algorithm = _PagerankPlanAlgorithm
+    Precision = _PagerankPlanPrecision
 
     @staticmethod
     cdef PagerankPlan make(_PagerankPlan u):
@@ -127,14 +163,25 @@ cdef class PagerankPlan(Plan):
     def initial_residual(self) -> float:
         return self.underlying_.initial_residual()
 
+    @property
+    def segment_size(self) -> int:
+        return self.underlying_.segment_size()
+
+    @property
+    def precision(self) -> _PagerankPlanPrecision:
+        return _PagerankPlanPrecision(self.underlying_.precision())
+
     @staticmethod
-    def pull_topological(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
+    def pull_topological(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha, precision = _PagerankPlanPrecision.Float):
         """
         Topological pull algorithm
 
+        With precision ``PagerankPlan.Precision.BFloat16``, the values read per edge are stored in 16 bits until the
+        ranks converge as far as 16 bits allow; the result still meets the tolerance.
+
         The graph must be transposed to use this algorithm.
         """
-        return PagerankPlan.make(_PagerankPlan.PullTopological(tolerance, max_iterations, alpha))
+        return PagerankPlan.make(_PagerankPlan.PullTopological(tolerance, max_iterations, alpha, _PagerankPlanPrecision(precision).value))
 
     @staticmethod
     def pull_residual(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
@@ -145,6 +192,19 @@ cdef class PagerankPlan(Plan):
         """
         return PagerankPlan.make(_PagerankPlan.PullResidual(tolerance, max_iterations, alpha))
 
+    @staticmethod
+    def pull_blocked(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha, uint32_t segment_size = kDefaultSegmentSize, precision = _PagerankPlanPrecision.Float):
+        """
+        Segmented topological pull algorithm
+
+        Like pull_topological, but the in-edges are split into segments by their source and each iteration pulls one
+        segment at a time, so the ranks it reads stay in cache on graphs much larger than the last level cache. precision
+        is as for pull_topological.
+
+        The graph must be transposed to use this algorithm.
+        """
+        return PagerankPlan.make(_PagerankPlan.PullBlocked(tolerance, max_iterations, alpha, segment_size, _PagerankPlanPrecision(precision).value))
+
     @staticmethod
     def push_asynchronous(float tolerance = kDefaultTolerance, float alpha = kDefaultAlpha):
         """
@@ -184,6 +244,54 @@ def pagerank(PropertyGraph pg, str output_property_name, PagerankPlan plan = Pag
         handle_result_void(Pagerank(pg.underlying_property_graph(), output_property_name_cstr, plan.underlying_))
 
 
+def pagerank_incremental(PropertyGraph pg, str rank_property_name, inserted = (), deleted = (),
+                         PagerankPlan plan = PagerankPlan()):
+    """
+    Update a Page Rank computed by :py:func:`pagerank` after edges of the graph changed, instead of recomputing it.
+    Residuals are seeded only around the changed edges and pushed asynchronously until they are within tolerance.
+
+    :type pg: PropertyGraph
+    :param pg: The graph after the changes. Its nodes must not have changed.
+    :type rank_property_name: str
+    :param rank_property_name: The property holding the ranks from before the changes. It is updated in place.
+    :type inserted: List[Tuple[int, int]]
+    :param inserted: The (source, destination) of each inserted edge.
+    :type deleted: List[Tuple[int, int]]
+    :param deleted: The (source, destination) of each deleted edge.
+    :type plan: PagerankPlan
+    :param plan: The tolerance and alpha to use. Alpha must match the one the ranks were computed with.
+    """
+    rank_property_name_bytes = bytes(rank_property_name, "utf-8")
+    rank_property_name_cstr = <string>rank_property_name_bytes
+    cdef _PagerankEdgeChanges changes
+    changes.inserted = [(src, dst) for src, dst in inserted]
+    changes.deleted = [(src, dst) for src, dst in deleted]
+    with nogil:
+        handle_result_void(PagerankIncremental(pg.underlying_property_graph(), rank_property_name_cstr, changes, plan.underlying_))
+
+
+def pagerank_personalized(PropertyGraph pg, seed_sets, output_property_names, PagerankPlan plan = PagerankPlan()):
+    """
+    Compute the personalized Page Rank of each node for many seed sets. The ranks for `seed_sets[i]` are stored in a
+    new property named `output_property_names[i]`. The ranks of a seed set add up to at most the initial residual
+    (1 - alpha), so the plan's tolerance should be chosen well below that. Only the tolerance and alpha of the plan are
+    used.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type seed_sets: List[List[int]]
+    :param seed_sets: The nodes at which the walk of each seed set restarts.
+    :type output_property_names: List[str]
+    :param output_property_names: The names of the properties to create, one per seed set.
+    :type plan: PagerankPlan
+    :param plan: The tolerance and alpha to use.
+    """
+    cdef vector[vector[uint32_t]] seed_sets_vector = [list(seeds) for seeds in seed_sets]
+    cdef vector[string] output_property_names_vector = [bytes(name, "utf-8") for name in output_property_names]
+    with nogil:
+        handle_result_void(PagerankPersonalized(pg.underlying_property_graph(), seed_sets_vector, output_property_names_vector, plan.underlying_))
+
+
 def pagerank_assert_valid(PropertyGraph pg, str output_property_name):
     """
     Raise an exception if the pagerank results in `pg` are invalid. This is not an exhaustive check, just a sanity check.
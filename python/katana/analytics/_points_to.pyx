@@ -0,0 +1,188 @@
+"""
+Points-to Analysis
+------------------
+
+.. autoclass:: katana.analytics.PointsToPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._points_to._PointsToPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.points_to
+
+.. autoclass:: katana.analytics.PointsToStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.points_to_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/points_to/points_to.h" namespace "katana::analytics" nogil:
+    cppclass _PointsToPlan "katana::analytics::PointsToPlan" (_Plan):
+        enum Algorithm:
+            kDifferencePropagation "katana::analytics::PointsToPlan::kDifferencePropagation"
+
+        _PointsToPlan.Algorithm algorithm() const
+        bool detect_cycles() const
+
+        PointsToPlan()
+
+        @staticmethod
+        _PointsToPlan DifferencePropagation(bool detect_cycles)
+
+    bool kDefaultDetectCycles "katana::analytics::PointsToPlan::kDefaultDetectCycles"
+
+    Result[void] PointsTo(
+        _PropertyGraph* pg, string constraint_kind_property_name, string output_property_name, _PointsToPlan plan)
+
+    Result[void] PointsToAssertValid(
+        _PropertyGraph* pg, string constraint_kind_property_name, string output_property_name)
+
+    cppclass _PointsToStatistics "katana::analytics::PointsToStatistics":
+        uint64_t n_points_to_facts
+        uint64_t n_pointers
+        uint64_t max_points_to_size
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_PointsToStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
+
+class _PointsToPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.PointsToPlan` constructors for algorithm documentation.
+    """
+    DifferencePropagation = _PointsToPlan.Algorithm.kDifferencePropagation
+
+
+cdef class PointsToPlan(Plan):
+    """
+    A computational :ref:`Plan` for Points-to Analysis.
+
+    Static methods construct PointsToPlans.
+    """
+    cdef:
+        _PointsToPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _PointsToPlanAlgorithm
+
+    @staticmethod
+    cdef PointsToPlan make(_PointsToPlan u):
+        f = <PointsToPlan>PointsToPlan.__new__(PointsToPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> PointsToPlan.Algorithm:
+        return _PointsToPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def detect_cycles(self) -> bool:
+        return self.underlying_.detect_cycles()
+
+    @staticmethod
+    def difference_propagation(bint detect_cycles = kDefaultDetectCycles) -> PointsToPlan:
+        """
+        Rounds of parallel difference propagation, where each variable sends only its new pointees along its copy
+        edges. If detect_cycles is true, variables on cycles of copies are collapsed into one by hybrid (offline
+        and lazy) cycle detection.
+        """
+        return PointsToPlan.make(_PointsToPlan.DifferencePropagation(detect_cycles))
+
+
+def points_to(
+    PropertyGraph pg,
+    str constraint_kind_property_name,
+    str output_property_name,
+    PointsToPlan plan = PointsToPlan()
+):
+    """
+    Compute the points-to sets of Andersen's inclusion-based pointer analysis. Nodes are the variables and abstract
+    objects of a program, and an edge from src to dst is a constraint of one of these kinds: 0, dst = &src; 1,
+    dst = src; 2, dst = *src; 3, *dst = src; 4, dst = src + offset, which is treated as a copy.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type constraint_kind_property_name: str
+    :param constraint_kind_property_name: The integer edge property holding the kind of each constraint.
+    :type output_property_name: str
+    :param output_property_name: The output node property, the sorted list of the nodes each node points to. This
+        property must not already exist.
+    :type plan: PointsToPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string constraint_kind_property_name_str = constraint_kind_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(PointsTo(
+            pg.underlying_property_graph(), constraint_kind_property_name_str, output_property_name_str,
+            plan.underlying_))
+
+
+def points_to_assert_valid(PropertyGraph pg, str constraint_kind_property_name, str output_property_name):
+    """
+    Raise an exception if the points-to sets of `pg` are not the least solution of its constraints.
+
+    :raises: AssertionError
+    """
+    cdef string constraint_kind_property_name_str = constraint_kind_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(PointsToAssertValid(
+            pg.underlying_property_graph(), constraint_kind_property_name_str, output_property_name_str))
+
+
+cdef _PointsToStatistics handle_result_PointsToStatistics(Result[_PointsToStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class PointsToStatistics:
+    """
+    Compute the :ref:`statistics` of a Points-to Analysis result.
+    """
+    cdef _PointsToStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str output_property_name):
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_PointsToStatistics(_PointsToStatistics.Compute(
+                pg.underlying_property_graph(), output_property_name_str))
+
+    @property
+    def n_points_to_facts(self) -> uint64_t:
+        return self.underlying.n_points_to_facts
+
+    @property
+    def n_pointers(self) -> uint64_t:
+        return self.underlying.n_pointers
+
+    @property
+    def max_points_to_size(self) -> uint64_t:
+        return self.underlying.max_points_to_size
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,252 @@
+"""
+Reachability Index
+------------------
+
+.. autoclass:: katana.analytics.ReachabilityIndexPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._reachability_index._ReachabilityIndexPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.reachability_index
+
+.. autofunction:: katana.analytics.reachability_index_query
+
+.. autofunction:: katana.analytics.reachability_index_reachable
+
+.. autoclass:: katana.analytics.ReachabilityIndexStatistics
+    :members:
+    :undoc-members:
+"""
+from libc.stdint cimport uint8_t, uint32_t, uint64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+
+from enum import Enum
+
+import numpy as np
+
+
+cdef extern from "katana/analytics/reachability_index/reachability_index.h" namespace "katana::analytics" nogil:
+    uint32_t kReachabilityIndexUnreachable
+
+    cppclass _ReachabilityIndexPlan "katana::analytics::ReachabilityIndexPlan" (_Plan):
+        enum Algorithm:
+            kPrunedLandmarkLabeling "katana::analytics::ReachabilityIndexPlan::kPrunedLandmarkLabeling"
+
+        _ReachabilityIndexPlan.Algorithm algorithm() const
+        uint32_t num_bit_parallel_hubs() const
+        bool symmetric() const
+
+        ReachabilityIndexPlan()
+
+        @staticmethod
+        _ReachabilityIndexPlan PrunedLandmarkLabeling(uint32_t num_bit_parallel_hubs, bool symmetric)
+
+    uint32_t kDefaultNumBitParallelHubs "katana::analytics::ReachabilityIndexPlan::kDefaultNumBitParallelHubs"
+
+    Result[void] ReachabilityIndex(_PropertyGraph* pg, string index_property_prefix, _ReachabilityIndexPlan plan)
+
+    Result[void] ReachabilityIndexQuery(
+        _PropertyGraph* pg, string index_property_prefix, const uint32_t* sources, const uint32_t* targets,
+        uint64_t num_queries, uint32_t* distances)
+
+    Result[void] ReachabilityIndexReachable(
+        _PropertyGraph* pg, string index_property_prefix, const uint32_t* sources, const uint32_t* targets,
+        uint64_t num_queries, bool* reachable)
+
+    cppclass _ReachabilityIndexStatistics "katana::analytics::ReachabilityIndexStatistics":
+        uint64_t total_label_size
+        uint64_t max_label_size
+        double average_label_size
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_ReachabilityIndexStatistics] Compute(_PropertyGraph* pg, string index_property_prefix)
+
+
+REACHABILITY_INDEX_UNREACHABLE = kReachabilityIndexUnreachable
+
+
+class _ReachabilityIndexPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.ReachabilityIndexPlan` constructors for algorithm documentation.
+    """
+    PrunedLandmarkLabeling = _ReachabilityIndexPlan.Algorithm.kPrunedLandmarkLabeling
+
+
+cdef class ReachabilityIndexPlan(Plan):
+    """
+    A computational :ref:`Plan` for the reachability index, a 2-hop labeling that answers hop distance and
+    reachability queries between pairs of nodes by intersecting two labels.
+
+    Static methods construct ReachabilityIndexPlans.
+    """
+    cdef:
+        _ReachabilityIndexPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _ReachabilityIndexPlanAlgorithm
+
+    @staticmethod
+    cdef ReachabilityIndexPlan make(_ReachabilityIndexPlan u):
+        f = <ReachabilityIndexPlan>ReachabilityIndexPlan.__new__(ReachabilityIndexPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> ReachabilityIndexPlan.Algorithm:
+        return _ReachabilityIndexPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def num_bit_parallel_hubs(self) -> uint32_t:
+        return self.underlying_.num_bit_parallel_hubs()
+
+    @property
+    def symmetric(self) -> bool:
+        return self.underlying_.symmetric()
+
+    @staticmethod
+    def pruned_landmark_labeling(
+        uint32_t num_bit_parallel_hubs = kDefaultNumBitParallelHubs, bool symmetric = False
+    ) -> ReachabilityIndexPlan:
+        """
+        Pruned landmark labeling over the nodes ranked by descending degree. The searches from the
+        num_bit_parallel_hubs (at most 64) highest ranked nodes run as one bit-parallel breadth-first search; the
+        others run in parallel batches, each pruned by the labels of the batches before it. If symmetric, the graph
+        must be symmetric and only one label per node is built.
+        """
+        return ReachabilityIndexPlan.make(
+            _ReachabilityIndexPlan.PrunedLandmarkLabeling(num_bit_parallel_hubs, symmetric))
+
+
+def reachability_index(
+    PropertyGraph pg, str index_property_prefix, ReachabilityIndexPlan plan = ReachabilityIndexPlan()
+):
+    """
+    Build the reachability index of pg along its out-edges. The labels are node properties, so the index is saved and
+    loaded with the graph.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to index.
+    :type index_property_prefix: str
+    :param index_property_prefix: The prefix of the output node properties holding the labels,
+        index_property_prefix + "-from" and, unless the plan is symmetric, index_property_prefix + "-to". Each label is
+        a list of (hub, distance) structs. These properties must not already exist.
+    :type plan: ReachabilityIndexPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string index_property_prefix_str = index_property_prefix.encode("utf-8")
+    with nogil:
+        handle_result_void(ReachabilityIndex(
+            pg.underlying_property_graph(), index_property_prefix_str, plan.underlying_))
+
+
+def reachability_index_query(PropertyGraph pg, str index_property_prefix, sources, targets):
+    """
+    Find the hop distance from each source to the corresponding target with the index built by
+    :py:func:`reachability_index`.
+
+    :type pg: PropertyGraph
+    :param pg: The indexed graph.
+    :type index_property_prefix: str
+    :param index_property_prefix: The prefix of the properties holding the index.
+    :param sources: An array of the source node of each query.
+    :param targets: An array of the target node of each query, as long as sources.
+    :return: An array of the distance of each query, REACHABILITY_INDEX_UNREACHABLE if the target is not reachable.
+    """
+    cdef const uint32_t[::1] sources_view = np.ascontiguousarray(sources, dtype=np.uint32)
+    cdef const uint32_t[::1] targets_view = np.ascontiguousarray(targets, dtype=np.uint32)
+    if sources_view.shape[0] != targets_view.shape[0]:
+        raise ValueError("there must be as many sources as targets")
+    cdef uint64_t num_queries = sources_view.shape[0]
+    distances = np.empty(num_queries, dtype=np.uint32)
+    if num_queries == 0:
+        return distances
+    cdef uint32_t[::1] distances_view = distances
+    cdef string index_property_prefix_str = index_property_prefix.encode("utf-8")
+    with nogil:
+        handle_result_void(ReachabilityIndexQuery(
+            pg.underlying_property_graph(), index_property_prefix_str, &sources_view[0], &targets_view[0],
+            num_queries, &distances_view[0]))
+    return distances
+
+
+def reachability_index_reachable(PropertyGraph pg, str index_property_prefix, sources, targets):
+    """
+    Find whether each target is reachable from the corresponding source with the index built by
+    :py:func:`reachability_index`. This is faster than :py:func:`reachability_index_query`.
+
+    :type pg: PropertyGraph
+    :param pg: The indexed graph.
+    :type index_property_prefix: str
+    :param index_property_prefix: The prefix of the properties holding the index.
+    :param sources: An array of the source node of each query.
+    :param targets: An array of the target node of each query, as long as sources.
+    :return: A boolean array, true for each query whose target is reachable from its source.
+    """
+    cdef const uint32_t[::1] sources_view = np.ascontiguousarray(sources, dtype=np.uint32)
+    cdef const uint32_t[::1] targets_view = np.ascontiguousarray(targets, dtype=np.uint32)
+    if sources_view.shape[0] != targets_view.shape[0]:
+        raise ValueError("there must be as many sources as targets")
+    cdef uint64_t num_queries = sources_view.shape[0]
+    reachable = np.empty(num_queries, dtype=np.bool_)
+    if num_queries == 0:
+        return reachable
+    cdef uint8_t[::1] reachable_view = reachable.view(np.uint8)
+    cdef string index_property_prefix_str = index_property_prefix.encode("utf-8")
+    with nogil:
+        handle_result_void(ReachabilityIndexReachable(
+            pg.underlying_property_graph(), index_property_prefix_str, &sources_view[0], &targets_view[0],
+            num_queries, <bool*>&reachable_view[0]))
+    return reachable
+
+
+cdef _ReachabilityIndexStatistics handle_result_ReachabilityIndexStatistics(
+    Result[_ReachabilityIndexStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class ReachabilityIndexStatistics:
+    """
+    Compute the :ref:`statistics` of a reachability index.
+    """
+    cdef _ReachabilityIndexStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str index_property_prefix):
+        cdef string index_property_prefix_str = index_property_prefix.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_ReachabilityIndexStatistics(_ReachabilityIndexStatistics.Compute(
+                pg.underlying_property_graph(), index_property_prefix_str))
+
+    @property
+    def total_label_size(self) -> uint64_t:
+        return self.underlying.total_label_size
+
+    @property
+    def max_label_size(self) -> uint64_t:
+        return self.underlying.max_label_size
+
+    @property
+    def average_label_size(self) -> double:
+        return self.underlying.average_label_size
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -20,9 +20,11 @@ Single-Source Shortest Path
 .. autofunction:: katana.analytics.sssp_assert_valid
 """
 from enum import Enum
+from typing import Optional
 
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint64_t
+from libcpp cimport bool
 from libcpp.string cimport string
 
 from katana._property_graph cimport PropertyGraph
@@ -51,6 +53,7 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
 
         _SsspPlan.Algorithm algorithm() const
         unsigned delta() const
+        bool adaptive_delta() const
         ptrdiff_t edge_tile_size() const
 
         @staticmethod
@@ -150,12 +153,21 @@ cdef class SsspPlan(Plan):
         """
         return _SsspAlgorithm(self.underlying_.algorithm())
     @property
-    def delta(self) -> int:
+    def delta(self) -> Optional[int]:
         """
         The exponent of the delta step size (2 based). A delta of 4 will produce a real delta step size of 16.
+        None if the algorithm chooses and tunes the delta itself; see :py:attr:`adaptive_delta`.
         """
+        if self.underlying_.adaptive_delta():
+            return None
         return self.underlying_.delta()
     @property
+    def adaptive_delta(self) -> bool:
+        """
+        True if the algorithm chooses the delta from a sample of the graph and tunes it while it runs.
+        """
+        return self.underlying_.adaptive_delta()
+    @property
     def edge_tile_size(self) -> int:
         """
         The edge tile size.
@@ -0,0 +1,188 @@
+"""
+Strongly Connected Components
+-----------------------------
+
+.. autoclass:: katana.analytics.StronglyConnectedComponentsPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._strongly_connected_components._StronglyConnectedComponentsPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.strongly_connected_components
+
+.. autoclass:: katana.analytics.StronglyConnectedComponentsStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.strongly_connected_components_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/strongly_connected_components/strongly_connected_components.h" namespace "katana::analytics" nogil:
+    cppclass _StronglyConnectedComponentsPlan "katana::analytics::StronglyConnectedComponentsPlan" (_Plan):
+        enum Algorithm:
+            kForwardBackward "katana::analytics::StronglyConnectedComponentsPlan::kForwardBackward"
+            kColoring "katana::analytics::StronglyConnectedComponentsPlan::kColoring"
+
+        _StronglyConnectedComponentsPlan.Algorithm algorithm() const
+
+        StronglyConnectedComponentsPlan()
+
+        @staticmethod
+        _StronglyConnectedComponentsPlan ForwardBackward()
+        @staticmethod
+        _StronglyConnectedComponentsPlan Coloring()
+
+    Result[void] StronglyConnectedComponents(_PropertyGraph* pg, string output_property_name, _StronglyConnectedComponentsPlan plan)
+
+    Result[void] StronglyConnectedComponentsAssertValid(_PropertyGraph* pg, string output_property_name)
+
+    cppclass _StronglyConnectedComponentsStatistics "katana::analytics::StronglyConnectedComponentsStatistics":
+        uint64_t total_components
+        uint64_t total_non_trivial_components
+        uint64_t largest_component_size
+        double largest_component_ratio
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_StronglyConnectedComponentsStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
+
+class _StronglyConnectedComponentsPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.StronglyConnectedComponentsPlan` constructors for algorithm documentation.
+    """
+    ForwardBackward = _StronglyConnectedComponentsPlan.Algorithm.kForwardBackward
+    Coloring = _StronglyConnectedComponentsPlan.Algorithm.kColoring
+
+
+cdef class StronglyConnectedComponentsPlan(Plan):
+    """
+    A computational :ref:`Plan` for Strongly Connected Components.
+
+    Static methods construct StronglyConnectedComponentsPlans.
+    """
+    cdef:
+        _StronglyConnectedComponentsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _StronglyConnectedComponentsPlanAlgorithm
+
+    @staticmethod
+    cdef StronglyConnectedComponentsPlan make(_StronglyConnectedComponentsPlan u):
+        f = <StronglyConnectedComponentsPlan>StronglyConnectedComponentsPlan.__new__(StronglyConnectedComponentsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> StronglyConnectedComponentsPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @staticmethod
+    def forward_backward() -> StronglyConnectedComponentsPlan:
+        """
+        Trim nodes without in- or out-edges, find the component of a high degree pivot by a forward and a backward
+        search, then split up the remaining nodes by coloring.
+        """
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.ForwardBackward())
+
+    @staticmethod
+    def coloring() -> StronglyConnectedComponentsPlan:
+        """
+        Trim nodes without in- or out-edges, then repeatedly propagate the minimum node id forward as a color and
+        collect the component of each node that keeps its own color by a backward search.
+        """
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.Coloring())
+
+
+def strongly_connected_components(PropertyGraph pg, str output_property_name,
+                                  StronglyConnectedComponentsPlan plan = StronglyConnectedComponentsPlan()) -> int:
+    """
+    Compute the strongly connected components of `pg`, treating it as directed. Each node is labeled with the smallest
+    node id in its component.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property to write component ids into. This property must not already exist.
+    :type plan: StronglyConnectedComponentsPlan
+    :param plan: The execution plan to use.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(StronglyConnectedComponents(pg.underlying_property_graph(), output_property_name_str, plan.underlying_))
+    return v
+
+
+def strongly_connected_components_assert_valid(PropertyGraph pg, str output_property_name):
+    """
+    Raise an exception if the Strongly Connected Components results in `pg` are incorrect: a component is not strongly
+    connected or two components lie on a common cycle.
+
+    :raises: AssertionError
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(StronglyConnectedComponentsAssertValid(pg.underlying_property_graph(),
+                                                                    output_property_name_str))
+
+
+cdef _StronglyConnectedComponentsStatistics handle_result_StronglyConnectedComponentsStatistics(
+        Result[_StronglyConnectedComponentsStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class StronglyConnectedComponentsStatistics:
+    """
+    Compute the :ref:`statistics` of a Strongly Connected Components computation on a graph.
+    """
+    cdef _StronglyConnectedComponentsStatistics underlying
+
+    def __init__(self, PropertyGraph pg, str output_property_name):
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_StronglyConnectedComponentsStatistics(
+                _StronglyConnectedComponentsStatistics.Compute(pg.underlying_property_graph(), output_property_name_str))
+
+    @property
+    def total_components(self) -> uint64_t:
+        return self.underlying.total_components
+
+    @property
+    def total_non_trivial_components(self) -> uint64_t:
+        return self.underlying.total_non_trivial_components
+
+    @property
+    def largest_component_size(self) -> uint64_t:
+        return self.underlying.largest_component_size
+
+    @property
+    def largest_component_ratio(self) -> double:
+        """
+        The faction of the entire graph that is part of the largest component.
+        """
+        return self.underlying.largest_component_ratio
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
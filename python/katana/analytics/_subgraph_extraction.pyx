@@ -11,6 +11,7 @@ Subgraph Extraction
 """
 from libc.stdint cimport uint32_t
 from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 from pyarrow.lib cimport to_shared
 
@@ -26,6 +27,7 @@ cdef extern from "katana/analytics/subgraph_extraction/subgraph_extraction.h" na
     cppclass _SubGraphExtractionPlan "katana::analytics::SubGraphExtractionPlan" (_Plan):
         enum Algorithm:
             kNodeSet "katana::analytics::SubGraphExtractionPlan::kNodeSet"
+            kNodeSetScan "katana::analytics::SubGraphExtractionPlan::kNodeSetScan"
 
         _SubGraphExtractionPlan.Algorithm algorithm() const
 
@@ -35,11 +37,16 @@ cdef extern from "katana/analytics/subgraph_extraction/subgraph_extraction.h" na
         _SubGraphExtractionPlan NodeSet(
             )
 
-    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec, _SubGraphExtractionPlan plan)
+        @staticmethod
+        _SubGraphExtractionPlan NodeSetScan(
+            )
+
+    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec, const vector[string]& node_properties_to_copy, const vector[string]& edge_properties_to_copy, _SubGraphExtractionPlan plan)
 
 
 class _SubGraphExtractionPlanAlgorithm(Enum):
     NodeSet = _SubGraphExtractionPlan.Algorithm.kNodeSet
+    NodeSetScan = _SubGraphExtractionPlan.Algorithm.kNodeSetScan
 
 
 cdef class SubGraphExtractionPlan(Plan):
@@ -69,10 +76,17 @@ cdef class SubGraphExtractionPlan(Plan):
     @staticmethod
     def node_set() -> SubGraphExtractionPlan:
         """
-        The node-set algorithm.
+        The node-set algorithm, which searches the sorted edges of each node for the other nodes of the set.
         """
         return SubGraphExtractionPlan.make(_SubGraphExtractionPlan.NodeSet())
 
+    @staticmethod
+    def node_set_scan() -> SubGraphExtractionPlan:
+        """
+        The node-set scan algorithm, which scans the edges of each node of the set once against a bitmap of the set.
+        """
+        return SubGraphExtractionPlan.make(_SubGraphExtractionPlan.NodeSetScan())
+
 
 cdef shared_ptr[_PropertyGraph] handle_result_property_graph(Result[unique_ptr[_PropertyGraph]] res) nogil except *:
     if not res.has_value():
@@ -81,12 +95,22 @@ cdef shared_ptr[_PropertyGraph] handle_result_property_graph(Result[unique_ptr[_
     return to_shared(res.value())
 
 
-def subgraph_extraction(PropertyGraph pg, node_vec, SubGraphExtractionPlan plan = SubGraphExtractionPlan()) -> PropertyGraph:
+def subgraph_extraction(PropertyGraph pg, node_vec, SubGraphExtractionPlan plan = SubGraphExtractionPlan(), node_properties=(), edge_properties=()) -> PropertyGraph:
     """
     Given a set of node ids, this algorithm constructs a new sub-graph which contains all nodes in the set and edges
-    between them.
+    between them, with copies of the named node and edge properties.
     """
     cdef vector[uint32_t] vec = [<uint32_t>n for n in node_vec]
+    cdef vector[string] node_properties_vector = [bytes(name, "utf-8") for name in node_properties]
+    cdef vector[string] edge_properties_vector = [bytes(name, "utf-8") for name in edge_properties]
     with nogil:
-        v = handle_result_property_graph(SubGraphExtraction(pg.underlying_property_graph(), vec, plan.underlying_))
+        v = handle_result_property_graph(
+            SubGraphExtraction(
+                pg.underlying_property_graph(),
+                vec,
+                node_properties_vector,
+                edge_properties_vector,
+                plan.underlying_,
+            )
+        )
     return PropertyGraph.make(v)
@@ -0,0 +1,127 @@
+"""
+Subgraph Matching
+-----------------
+
+.. autoclass:: katana.analytics.SubgraphMatchPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.analytics._subgraph_match._SubgraphMatchPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.subgraph_match_count
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana._property_graph cimport PropertyGraph
+from katana.analytics.plan cimport Plan, _Plan
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/subgraph_match/subgraph_match.h" namespace "katana::analytics" nogil:
+    cppclass _SubgraphPattern "katana::analytics::SubgraphPattern":
+        _SubgraphPattern()
+        uint32_t AddNode(const string& type)
+        void AddEdge(uint32_t src, uint32_t dst, const string& type)
+
+    cppclass _SubgraphMatchPlan "katana::analytics::SubgraphMatchPlan" (_Plan):
+        enum Algorithm:
+            kGenericJoin "katana::analytics::SubgraphMatchPlan::kGenericJoin"
+
+        _SubgraphMatchPlan.Algorithm algorithm() const
+        uint32_t split_depth() const
+
+        SubgraphMatchPlan()
+
+        @staticmethod
+        _SubgraphMatchPlan GenericJoin(uint32_t split_depth)
+
+    uint32_t kDefaultSplitDepth "katana::analytics::SubgraphMatchPlan::kDefaultSplitDepth"
+
+    Result[uint64_t] SubgraphMatchCount(_PropertyGraph* pg, const _SubgraphPattern& pattern, _SubgraphMatchPlan plan)
+
+
+class _SubgraphMatchPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.analytics.SubgraphMatchPlan` constructors for algorithm documentation.
+    """
+    GenericJoin = _SubgraphMatchPlan.Algorithm.kGenericJoin
+
+
+cdef class SubgraphMatchPlan(Plan):
+    """
+    A computational :ref:`Plan` for subgraph matching.
+
+    Static methods construct SubgraphMatchPlans.
+    """
+    cdef:
+        _SubgraphMatchPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _SubgraphMatchPlanAlgorithm
+
+    @staticmethod
+    cdef SubgraphMatchPlan make(_SubgraphMatchPlan u):
+        f = <SubgraphMatchPlan>SubgraphMatchPlan.__new__(SubgraphMatchPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _SubgraphMatchPlanAlgorithm:
+        return _SubgraphMatchPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def split_depth(self) -> uint32_t:
+        return self.underlying_.split_depth()
+
+    @staticmethod
+    def generic_join(uint32_t split_depth = kDefaultSplitDepth) -> SubgraphMatchPlan:
+        """
+        A worst-case optimal generic join: each pattern node is matched to the intersection of the sorted neighbor
+        lists of the nodes matched to its pattern neighbors. Partial matches of fewer than split_depth nodes are
+        spread over the threads by work stealing.
+        """
+        return SubgraphMatchPlan.make(_SubgraphMatchPlan.GenericJoin(split_depth))
+
+
+cdef uint64_t handle_result_int(Result[uint64_t] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def subgraph_match_count(
+    PropertyGraph pg, node_types, edges, SubgraphMatchPlan plan = SubgraphMatchPlan()
+) -> int:
+    """
+    Count the matches of a small connected pattern graph in pg: the maps of the pattern nodes to distinct nodes of pg
+    such that every pattern edge maps to an edge of pg in the same direction. Symmetric patterns are counted once for
+    each of their automorphisms.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to search.
+    :param node_types: The type of each pattern node, or None for any type. Pattern nodes are numbered by their
+        position.
+    :param edges: The pattern edges as (source, destination) or (source, destination, type) tuples of pattern nodes.
+    :type plan: SubgraphMatchPlan
+    :param plan: The execution plan to use.
+    """
+    cdef _SubgraphPattern pattern
+    for node_type in node_types:
+        pattern.AddNode((node_type or "").encode("utf-8"))
+    for edge in edges:
+        edge_type = edge[2] if len(edge) > 2 else None
+        pattern.AddEdge(edge[0], edge[1], (edge_type or "").encode("utf-8"))
+    cdef uint64_t count
+    with nogil:
+        count = handle_result_int(SubgraphMatchCount(pg.underlying_property_graph(), pattern, plan.underlying_))
+    return count
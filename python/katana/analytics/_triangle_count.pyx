@@ -15,13 +15,18 @@ Triangle Counting
     :undoc-members:
 
 .. autofunction:: katana.analytics.triangle_count
+
+.. autoclass:: katana.analytics.TriangleCountEstimate
+    :members:
+    :undoc-members:
 """
-from libc.stdint cimport uint64_t
+from libc.stdint cimport uint32_t, uint64_t
 from libcpp cimport bool
 
 from katana._property_graph cimport PropertyGraph
 from katana.analytics.plan cimport Plan, _Plan
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 
 from enum import Enum
@@ -33,6 +38,7 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
             kNodeIteration "katana::analytics::TriangleCountPlan::kNodeIteration"
             kEdgeIteration "katana::analytics::TriangleCountPlan::kEdgeIteration"
             kOrderedCount "katana::analytics::TriangleCountPlan::kOrderedCount"
+            kSampling "katana::analytics::TriangleCountPlan::kSampling"
 
         enum Relabeling:
             kRelabel "katana::analytics::TriangleCountPlan::kRelabel"
@@ -42,6 +48,8 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
         _TriangleCountPlan.Algorithm algorithm() const
         _TriangleCountPlan.Relabeling relabeling() const
         bool edges_sorted() const
+        double relative_error() const
+        double confidence() const
 
         TriangleCountPlan()
 
@@ -51,18 +59,32 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
         _TriangleCountPlan EdgeIteration(bool edges_sorted, _TriangleCountPlan.Relabeling relabeling)
         @staticmethod
         _TriangleCountPlan OrderedCount(bool edges_sorted, _TriangleCountPlan.Relabeling relabeling)
+        @staticmethod
+        _TriangleCountPlan Sampling(double relative_error, double confidence)
 
 
     _TriangleCountPlan.Relabeling kDefaultRelabeling "katana::analytics::TriangleCountPlan::kDefaultRelabeling"
     bool kDefaultEdgeSorted "katana::analytics::TriangleCountPlan::kDefaultEdgeSorted"
+    double kDefaultRelativeError "katana::analytics::TriangleCountPlan::kDefaultRelativeError"
+    double kDefaultConfidence "katana::analytics::TriangleCountPlan::kDefaultConfidence"
 
     Result[uint64_t] TriangleCount(_PropertyGraph* pg, _TriangleCountPlan plan)
 
+    cppclass _TriangleCountEstimate "katana::analytics::TriangleCountEstimate":
+        double estimate
+        double variance
+        uint32_t colors
+
+        void Print(ostream os)
+
+    Result[_TriangleCountEstimate] EstimateTriangleCount(_PropertyGraph* pg, _TriangleCountPlan plan)
+
 
 class _TriangleCountPlanAlgorithm(Enum):
     NodeIteration = _TriangleCountPlan.Algorithm.kNodeIteration
     EdgeIteration = _TriangleCountPlan.Algorithm.kEdgeIteration
     OrderedCount = _TriangleCountPlan.Algorithm.kOrderedCount
+    Sampling = _TriangleCountPlan.Algorithm.kSampling
 
 
 cdef _relabeling_to_python(v):
@@ -125,6 +147,24 @@ cdef class TriangleCountPlan(Plan):
         """
         return _relabeling_to_python(self.underlying_.relabeling())
 
+    @property
+    def relative_error(self) -> float:
+        """
+        The error bound of a sampling estimate, relative to the estimate.
+
+        :rtype: float
+        """
+        return self.underlying_.relative_error()
+
+    @property
+    def confidence(self) -> float:
+        """
+        The probability with which the error bound of a sampling estimate should hold.
+
+        :rtype: float
+        """
+        return self.underlying_.confidence()
+
     @staticmethod
     def node_iteration(bool edges_sorted = kDefaultEdgeSorted,
                        relabeling = _relabeling_to_python(kDefaultRelabeling)):
@@ -169,6 +209,20 @@ cdef class TriangleCountPlan(Plan):
         return TriangleCountPlan.make(_TriangleCountPlan.OrderedCount(
             edges_sorted, _relabeling_from_python(relabeling)))
 
+    @staticmethod
+    def sampling(double relative_error = kDefaultRelativeError, double confidence = kDefaultConfidence):
+        """
+        Estimate the count by colorful sparsification due to Pagh and Tsourakakis: count the triangles among the
+        edges whose endpoints have the same randomly chosen color, with fewer colors until the estimate meets the
+        error bound with the given confidence. The graph is not copied.
+
+        :type relative_error: float
+        :param relative_error: The bound on the error relative to the estimate.
+        :type confidence: float
+        :param confidence: The probability with which the bound should hold.
+        """
+        return TriangleCountPlan.make(_TriangleCountPlan.Sampling(relative_error, confidence))
+
     def __str__(self):
         return "TriangleCountPlan({}, {}, {})".format(self.algorithm.name, self.edges_sorted, self.relabeling)
 
@@ -193,3 +247,46 @@ def triangle_count(PropertyGraph pg,  TriangleCountPlan plan = TriangleCountPlan
     with nogil:
         v = handle_result_int(TriangleCount(pg.underlying_property_graph(), plan.underlying_))
     return v
+
+
+cdef _TriangleCountEstimate handle_result_TriangleCountEstimate(Result[_TriangleCountEstimate] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class TriangleCountEstimate:
+    """
+    Estimate the number of triangles in `pg` with a sampling plan, and the variance of the estimate. Other plans count
+    exactly.
+    """
+    cdef _TriangleCountEstimate underlying
+
+    def __init__(self, PropertyGraph pg, TriangleCountPlan plan = TriangleCountPlan.sampling()):
+        with nogil:
+            self.underlying = handle_result_TriangleCountEstimate(
+                EstimateTriangleCount(pg.underlying_property_graph(), plan.underlying_))
+
+    @property
+    def estimate(self) -> float:
+        return self.underlying.estimate
+
+    @property
+    def variance(self) -> float:
+        """
+        The estimated variance of the estimate; 0 if it is exact.
+        """
+        return self.underlying.variance
+
+    @property
+    def colors(self) -> int:
+        """
+        The number of colors of the sample the estimate came from; 1 if it is exact.
+        """
+        return self.underlying.colors
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -8,12 +8,13 @@ class Architecture(Enum):
     CPU
         Parallel NUMA-aware CPU. Not distributed.
     GPU
+        GPU. No algorithm implements it yet; plans for it fail.
 
     DistributedCPU
         Distributed CPU.
 
     DistributedGPU
-        Distributed GPU.
+        Distributed GPU. No algorithm implements it yet; plans for it fail.
     """
     CPU = _Architecture.kCPU
     GPU = _Architecture.kGPU
@@ -9,6 +9,7 @@ cdef extern from "katana/Galois.h" namespace "katana" nogil:
     cppclass UserContext[T]:
         void push(...)
         void push_back(...)
+        void pushRange[It](It, It)
         bint isFirstPass()
         void cautiousPoint()
         void breakLoop()
@@ -60,3 +61,9 @@ cdef extern from "katana/NoDerefIterator.h" namespace "katana" nogil:
 
 cdef extern from "katana/Version.h" namespace "katana" nogil:
     string getVersion()
+
+cdef extern from "katana/ThreadPool.h" namespace "katana" nogil:
+    cppclass ThreadPool:
+        void attachThread()
+
+    ThreadPool& GetThreadPool()
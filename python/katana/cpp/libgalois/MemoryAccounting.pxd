@@ -0,0 +1,21 @@
+from libc.stdint cimport int64_t
+from libcpp.string cimport string
+
+
+cdef extern from "katana/MemoryAccounting.h" namespace "katana" nogil:
+    ctypedef enum MemoryCategory "katana::MemoryCategory":
+        kAnalytics "katana::MemoryCategory::kAnalytics"
+        kWorklist "katana::MemoryCategory::kWorklist"
+        kProperty "katana::MemoryCategory::kProperty"
+        kIO "katana::MemoryCategory::kIO"
+
+    size_t kNumMemoryCategories
+
+    cppclass MemoryUsage:
+        int64_t current
+        int64_t peak
+
+    const char* MemoryCategoryName(MemoryCategory category)
+    MemoryUsage GetMemoryUsage(MemoryCategory category)
+    void ResetMemoryPeaks()
+    void ReportMemoryUsage(const string& region)
@@ -0,0 +1,5 @@
+from libcpp.string cimport string
+
+
+cdef extern from "katana/Statistics.h" namespace "katana" nogil:
+    void ReportIOStats(const string& region)
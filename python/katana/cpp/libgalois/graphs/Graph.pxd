@@ -123,6 +123,8 @@ cdef extern from "katana/Graph.h" namespace "katana" nogil:
         PropertyGraph()
         @staticmethod
         Result[unique_ptr[_PropertyGraph]] Make(string filename, RDGLoadOptions opts)
+        @staticmethod
+        Result[unique_ptr[_PropertyGraph]] MakeFromAllPartitions(string filename, RDGLoadOptions opts)
 
         bint Equals(const _PropertyGraph*)
 
@@ -157,6 +159,9 @@ cdef extern from "katana/Graph.h" namespace "katana" nogil:
         Result[void] RemoveEdgeProperty(int)
         Result[void] RemoveEdgeProperty(const string&)
 
+        Result[void] SetPropertyMemoryBudget(uint64_t max_bytes, const string& spill_dir)
+        uint64_t loaded_property_bytes()
+
         void MarkAllPropertiesPersistent()
         Result[void] MarkNodePropertiesPersistent(const vector[string]& persist_node_props)
         Result[void] MarkEdgePropertiesPersistent(const vector[string]& persist_edge_props)
@@ -181,3 +186,7 @@ cdef extern from "katana/BuildGraph.h" namespace "katana" nogil:
 cdef extern from "katana/GraphML.h" namespace "katana" nogil:
     Result[GraphComponents] ConvertGraphML(
         string input_filename, size_t chunk_size, bint verbose)
+
+cdef extern from "katana/PropertyExpression.h" namespace "katana" nogil:
+    Result[void] AddNodePropertyFromExpression(_PropertyGraph* pg, const string& name, const string& text)
+    Result[void] AddEdgePropertyFromExpression(_PropertyGraph* pg, const string& name, const string& text)
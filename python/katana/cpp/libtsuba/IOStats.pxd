@@ -0,0 +1,31 @@
+from libc.stdint cimport uint64_t
+
+
+cdef extern from "tsuba/IOStats.h" namespace "tsuba" nogil:
+    ctypedef enum IOOp "tsuba::IOOp":
+        kStat "tsuba::IOOp::kStat"
+        kGet "tsuba::IOOp::kGet"
+        kPut "tsuba::IOOp::kPut"
+        kList "tsuba::IOOp::kList"
+        kDelete "tsuba::IOOp::kDelete"
+        kCopy "tsuba::IOOp::kCopy"
+        kFill "tsuba::IOOp::kFill"
+        kParquetRead "tsuba::IOOp::kParquetRead"
+        kParquetWrite "tsuba::IOOp::kParquetWrite"
+
+    size_t kNumIOOps
+
+    cppclass IOOpStats:
+        uint64_t count
+        uint64_t errors
+        uint64_t bytes
+        uint64_t total_usec
+        uint64_t max_usec
+        uint64_t p50_usec
+        uint64_t p90_usec
+        uint64_t p99_usec
+        double bytes_per_sec()
+
+    const char* IOOpName(IOOp op)
+    IOOpStats GetIOStats(IOOp op)
+    void ResetIOStats()
@@ -0,0 +1,97 @@
+"""
+Run loads, writes and analytics in background threads so that they overlap.
+
+Loading and writing graphs and running analytics release the GIL, so a graph can be loaded from storage while an
+analytic runs on another one. Analytics started from different threads take turns on the katana threads, each using
+all of them, while loads and writes run alongside::
+
+    from katana import futures
+    from katana.analytics import bfs
+
+    loading = [futures.load(path) for path in paths]
+    writing = []
+    for path, f in zip(paths, loading):
+        graph = f.result()
+        bfs(graph, 0, "distance")
+        writing.append(futures.write(graph, path + "-bfs"))
+    for f in writing:
+        f.result()
+
+The results are :py:class:`concurrent.futures.Future` objects. Use :py:func:`asyncio.wrap_future` to await them from
+a coroutine.
+"""
+import concurrent.futures
+import threading
+from typing import Optional
+
+from katana.galois import attach_thread
+from katana.property_graph import PropertyGraph
+
+__all__ = ["Executor", "submit", "load", "write"]
+
+
+class Executor(concurrent.futures.ThreadPoolExecutor):
+    """
+    A :py:class:`concurrent.futures.ThreadPoolExecutor` whose threads can start katana parallel loops.
+    """
+
+    def __init__(self, max_workers=None, thread_name_prefix="katana", initializer=None, initargs=()):
+        def initialize():
+            attach_thread()
+            if initializer is not None:
+                initializer(*initargs)
+
+        super().__init__(max_workers=max_workers, thread_name_prefix=thread_name_prefix, initializer=initialize)
+
+    def load(self, path, **kwargs) -> "concurrent.futures.Future[PropertyGraph]":
+        """
+        Load the graph at path in the background. The keyword arguments are those of
+        :py:class:`~katana.property_graph.PropertyGraph`.
+        """
+        return self.submit(PropertyGraph, path, **kwargs)
+
+    def write(
+        self, graph: PropertyGraph, path=None, command_line="katana.futures.write"
+    ) -> "concurrent.futures.Future[None]":
+        """
+        Write graph in the background, as :py:meth:`~katana.property_graph.PropertyGraph.write` does.
+        """
+        return self.submit(graph.write, path, command_line)
+
+
+_default_executor: Optional[Executor] = None
+_default_executor_lock = threading.Lock()
+
+
+def _get_default_executor() -> Executor:
+    # pylint: disable=global-statement
+    global _default_executor
+    with _default_executor_lock:
+        if _default_executor is None:
+            _default_executor = Executor()
+        return _default_executor
+
+
+def submit(fn, *args, **kwargs) -> concurrent.futures.Future:
+    """
+    Call fn(*args, **kwargs), such as an analytic from :py:mod:`katana.analytics`, in a background thread.
+    """
+    return _get_default_executor().submit(fn, *args, **kwargs)
+
+
+def load(path, **kwargs) -> "concurrent.futures.Future[PropertyGraph]":
+    """
+    Load the graph at path in a background thread.
+
+    :see: :py:meth:`Executor.load`
+    """
+    return _get_default_executor().load(path, **kwargs)
+
+
+def write(graph: PropertyGraph, path=None, command_line="katana.futures.write") -> "concurrent.futures.Future[None]":
+    """
+    Write graph in a background thread.
+
+    :see: :py:meth:`Executor.write`
+    """
+    return _get_default_executor().write(graph, path, command_line)
@@ -1,10 +1,20 @@
+from .cpp.libgalois.Galois cimport GetThreadPool
 from .cpp.libgalois.Galois cimport getVersion as c_getVersion
 from .cpp.libgalois.Galois cimport setActiveThreads as c_setActiveThreads
 
-__all__ = ["set_active_threads", "get_version"]
+__all__ = ["set_active_threads", "get_version", "attach_thread"]
 
 def set_active_threads(int n):
     return c_setActiveThreads(n)
 
 def get_version():
     return str(c_getVersion(), encoding="ASCII")
+
+def attach_thread():
+    """
+    Let the calling thread start parallel loops. Threads other than the main thread are attached the first time they
+    run one, so this is only needed to attach a thread early. Parallel loops started by different threads take turns
+    on the katana threads.
+    """
+    with nogil:
+        GetThreadPool().attachThread()
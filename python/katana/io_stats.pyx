@@ -0,0 +1,52 @@
+from .cpp.libgalois.Statistics cimport ReportIOStats
+from .cpp.libtsuba.IOStats cimport GetIOStats, IOOp, IOOpName, IOOpStats, ResetIOStats, kNumIOOps
+
+__all__ = ["io_stats", "reset_io_stats", "report_io_stats"]
+
+
+def io_stats():
+    """
+    io_stats()
+
+    Return the I/O done by katana as a dict from kind ("Stat", "Get", "Put", "List", "Delete", "Copy", "Fill",
+    "ParquetRead" or "ParquetWrite") to a dict with the number of operations ("count") and failures ("errors"), the
+    bytes moved ("bytes"), their total, maximum and percentile latencies in microseconds ("usec", "max_usec",
+    "p50_usec", "p90_usec" and "p99_usec") and their throughput ("bytes_per_sec"). Kinds not done are left out.
+    """
+    cdef IOOpStats stats
+    result = {}
+    for i in range(kNumIOOps):
+        stats = GetIOStats(<IOOp>i)
+        if stats.count == 0:
+            continue
+        name = str(IOOpName(<IOOp>i), encoding="ASCII")
+        result[name] = {
+            "count": stats.count,
+            "errors": stats.errors,
+            "bytes": stats.bytes,
+            "usec": stats.total_usec,
+            "max_usec": stats.max_usec,
+            "p50_usec": stats.p50_usec,
+            "p90_usec": stats.p90_usec,
+            "p99_usec": stats.p99_usec,
+            "bytes_per_sec": stats.bytes_per_sec(),
+        }
+    return result
+
+
+def reset_io_stats():
+    """
+    reset_io_stats()
+
+    Forget the I/O done so far, e.g., to measure the I/O of one phase of a program.
+    """
+    ResetIOStats()
+
+
+def report_io_stats(region):
+    """
+    report_io_stats(region)
+
+    Add the I/O done so far to the statistics of `region`.
+    """
+    ReportIOStats(bytes(region, "utf-8"))
@@ -54,8 +54,8 @@ def sssp_operator(g: PropertyGraph, dists: np.ndarray, edge_weights, item, ctx:
 
 
 @obim_metric()
-def obim_indexer(shift, item):
-    return item.dist >> shift
+def obim_indexer(item):
+    return item.dist
 
 
 def sssp(graph: PropertyGraph, source, length_property, shift, property_name):
@@ -72,7 +72,7 @@ def sssp(graph: PropertyGraph, source, length_property, shift, property_name):
     for_each(
         init_bag,
         sssp_operator(graph, dists, graph.get_edge_property(length_property)),
-        worklist=OrderedByIntegerMetric(obim_indexer(shift)),
+        worklist=OrderedByIntegerMetric(obim_indexer, delta=shift),
         disable_conflict_detection=True,
         loop_name="SSSP",
     )
@@ -4,7 +4,16 @@ import numba
 import numba.core.ccallback
 import numba.types
 
-from ._loops import OrderedByIntegerMetric, PerSocketChunkFIFO, UserContext, do_all, for_each
+from ._loops import (
+    CHUNK_SIZES,
+    BulkSynchronous,
+    OrderedByIntegerMetric,
+    PerSocketChunkFIFO,
+    PerSocketChunkLIFO,
+    UserContext,
+    do_all,
+    for_each,
+)
 from .numba_support.closure import Closure, ClosureBuilder
 from .numba_support.galois_compiler import OperatorCompiler
 
@@ -14,9 +23,12 @@ __all__ = [
     "for_each",
     "for_each_operator",
     "obim_metric",
+    "BulkSynchronous",
+    "CHUNK_SIZES",
     "OrderedByIntegerMetric",
     "UserContext",
     "PerSocketChunkFIFO",
+    "PerSocketChunkLIFO",
 ]
 
 
@@ -0,0 +1,45 @@
+from .cpp.libgalois.MemoryAccounting cimport (
+    GetMemoryUsage,
+    MemoryCategory,
+    MemoryCategoryName,
+    MemoryUsage,
+    ReportMemoryUsage,
+    ResetMemoryPeaks,
+    kNumMemoryCategories,
+)
+
+__all__ = ["memory_usage", "reset_memory_peaks", "report_memory_usage"]
+
+
+def memory_usage():
+    """
+    memory_usage()
+
+    Return the memory allocated by katana as a dict from category ("Analytics", "Worklist", "Property" or "IO") to a
+    dict with the bytes allocated now ("current") and the most allocated at once ("peak").
+    """
+    cdef MemoryUsage usage
+    result = {}
+    for i in range(kNumMemoryCategories):
+        usage = GetMemoryUsage(<MemoryCategory>i)
+        name = str(MemoryCategoryName(<MemoryCategory>i), encoding="ASCII")
+        result[name] = {"current": usage.current, "peak": usage.peak}
+    return result
+
+
+def reset_memory_peaks():
+    """
+    reset_memory_peaks()
+
+    Lower the peak of every category to the bytes allocated now, e.g., to measure the peak of one phase of a program.
+    """
+    ResetMemoryPeaks()
+
+
+def report_memory_usage(region):
+    """
+    report_memory_usage(region)
+
+    Add the current and peak bytes of every category to the statistics of `region`.
+    """
+    ReportMemoryUsage(bytes(region, "utf-8"))
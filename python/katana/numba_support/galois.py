@@ -2,7 +2,7 @@ import ctypes
 from typing import Dict
 
 from numba import types
-from numba.extending import overload, overload_method
+from numba.extending import overload, overload_method, register_jitable
 
 import katana.datastructures
 import katana.property_graph
@@ -45,3 +45,32 @@ def overload_PropertyGraph_edges(self, n):
 
         return impl
     return None
+
+
+# Topology arrays
+
+
+@register_jitable
+def edge_range(out_indices, n):
+    """
+    Return the range of the edge IDs of node `n` given the `out_indices` of a graph as a numpy array.
+
+    Operators that bind ``graph.out_indices().to_numpy()`` and ``graph.out_dests().to_numpy()`` instead of the graph
+    read the topology directly from its memory, so their loops over edges compile to plain array accesses:
+
+    >>> @do_all_operator()
+    ... def count_self_loops(out_indices, out_dests, out, n):
+    ...     t = 0
+    ...     for e in edge_range(out_indices, n):
+    ...         if out_dests[e] == n:
+    ...             t += 1
+    ...     out[n] = t
+    >>> do_all(graph, count_self_loops(graph.out_indices().to_numpy(), graph.out_dests().to_numpy(), out))
+
+    Can be called from numba compiled code and from Python.
+    """
+    if n == 0:
+        prev = 0
+    else:
+        prev = out_indices[n - 1]
+    return range(prev, out_indices[n])
@@ -5,45 +5,110 @@ from pytest import approx, raises
 
 from katana import GaloisError
 from katana.analytics import (
+    HYPERGRAPH_PARTITION_CUT,
+    REACHABILITY_INDEX_UNREACHABLE,
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
     BfsStatistics,
+    BipartiteMatchingPlan,
     ConnectedComponentsStatistics,
+    GraphPartitionPlan,
+    GraphPartitionStatistics,
+    HyperAnfPlan,
+    HyperGraphPartitionPlan,
+    HyperGraphPartitionStatistics,
     IndependentSetPlan,
     IndependentSetStatistics,
     JaccardPlan,
     JaccardStatistics,
+    KCorePlan,
     KCoreStatistics,
+    KTrussPlan,
     KTrussStatistics,
+    LabelPropagationPlan,
+    LabelPropagationStatistics,
+    LeidenClusteringPlan,
+    LeidenClusteringStatistics,
+    LocalClusteringCoefficientPlan,
     LouvainClusteringStatistics,
+    MaxFlowPlan,
+    MaxFlowStatistics,
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    MotifCountPlan,
+    MotifCountStatistics,
+    PagerankPlan,
     PagerankStatistics,
+    PointsToPlan,
+    PointsToStatistics,
+    ReachabilityIndexPlan,
+    ReachabilityIndexStatistics,
+    SsspPlan,
     SsspStatistics,
+    StronglyConnectedComponentsPlan,
+    StronglyConnectedComponentsStatistics,
+    SubGraphExtractionPlan,
+    TriangleCountEstimate,
     TriangleCountPlan,
     betweenness_centrality,
     bfs,
     bfs_assert_valid,
+    bipartite_matching,
     connected_components,
     connected_components_assert_valid,
+    directed_triad_census,
     find_edge_sorted_by_dest,
+    graph_coloring,
+    graph_coloring_assert_valid,
+    graph_partition,
+    graph_partition_assert_valid,
+    hyper_anf,
+    hypergraph_partition,
+    hypergraph_partition_assert_valid,
     independent_set,
     independent_set_assert_valid,
     jaccard,
     jaccard_assert_valid,
     k_core,
     k_core_assert_valid,
+    k_core_decomposition,
+    k_core_decomposition_assert_valid,
     k_truss,
     k_truss_assert_valid,
+    k_truss_decomposition,
+    k_truss_decomposition_assert_valid,
+    label_propagation,
+    label_propagation_assert_valid,
+    leiden_clustering,
+    leiden_clustering_assert_valid,
     local_clustering_coefficient,
     louvain_clustering,
     louvain_clustering_assert_valid,
+    louvain_clustering_from_seed,
+    make_hypergraph,
+    max_flow,
+    max_flow_assert_valid,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
+    motif_count,
+    motif_count_assert_valid,
     pagerank,
     pagerank_assert_valid,
+    pagerank_personalized,
+    points_to,
+    points_to_assert_valid,
+    reachability_index,
+    reachability_index_query,
+    reachability_index_reachable,
     sort_all_edges_by_dest,
     sort_nodes_by_degree,
     sssp,
     sssp_assert_valid,
+    strongly_connected_components,
+    strongly_connected_components_assert_valid,
     subgraph_extraction,
     triangle_count,
+    weighted_bipartite_matching,
 )
 from katana.example_utils import get_input
 from katana.lonestar.analytics.bfs import verify_bfs
@@ -149,6 +214,16 @@ def test_sssp(property_graph: PropertyGraph):
     verify_sssp(property_graph, start_node, new_property_id)
 
 
+def test_sssp_plan_delta(property_graph: PropertyGraph):
+    plan = SsspPlan(property_graph)
+    assert plan.adaptive_delta
+    assert plan.delta is None
+
+    plan = SsspPlan.delta_step(4)
+    assert not plan.adaptive_delta
+    assert plan.delta == 4
+
+
 def test_jaccard(property_graph: PropertyGraph):
     property_name = "NewProp"
     compare_node = 0
@@ -209,6 +284,39 @@ def test_pagerank(property_graph: PropertyGraph):
     assert stats.average_rank == approx(0.5205338001251221, abs=0.001)
 
 
+def test_pagerank_personalized(property_graph: PropertyGraph):
+    seed_sets = [[0], [1917, 2812], []]
+    property_names = ["PPR0", "PPR1", "PPR2"]
+    plan = PagerankPlan.push_asynchronous(tolerance=1.0e-6)
+
+    pagerank_personalized(property_graph, seed_sets, property_names, plan)
+
+    for seeds, property_name in zip(seed_sets, property_names):
+        ranks: np.ndarray = property_graph.get_node_property(property_name).to_numpy()
+        assert ranks.sum() <= plan.initial_residual + 1.0e-4
+        for seed in seeds:
+            assert ranks[seed] >= plan.initial_residual / len(seeds) - 1.0e-6
+    assert not property_graph.get_node_property(property_names[2]).to_numpy().any()
+
+
+def test_points_to():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+    kinds = np.arange(property_graph.num_edges(), dtype=np.uint8) % 5
+    property_graph.add_edge_property(table({"kind": kinds}))
+
+    points_to(property_graph, "kind", "points_to", PointsToPlan.difference_propagation())
+
+    points_to_assert_valid(property_graph, "kind", "points_to")
+
+    stats = PointsToStatistics(property_graph, "points_to")
+    assert stats.n_pointers <= property_graph.num_nodes()
+    assert stats.max_points_to_size <= property_graph.num_nodes()
+    assert stats.n_pointers <= stats.n_points_to_facts
+
+    with raises(GaloisError):
+        points_to(property_graph, "no_such_kind", "points_to2")
+
+
 def test_betweenness_centrality_outer(property_graph: PropertyGraph):
     property_name = "NewProp"
 
@@ -243,6 +351,40 @@ def test_betweenness_centrality_level(property_graph: PropertyGraph):
     assert stats.average_centrality == approx(1.3645)
 
 
+def test_betweenness_centrality_multi_source(property_graph: PropertyGraph):
+    property_name = "NewProp"
+
+    betweenness_centrality(property_graph, property_name, 16, BetweennessCentralityPlan.multi_source())
+
+    node_schema: Schema = property_graph.node_schema()
+    num_node_properties = len(node_schema)
+    new_property_id = num_node_properties - 1
+    assert node_schema.names[new_property_id] == property_name
+
+    stats = BetweennessCentralityStatistics(property_graph, property_name)
+
+    assert stats.min_centrality == 0
+    assert stats.max_centrality == approx(8210.38)
+    assert stats.average_centrality == approx(1.3645)
+
+
+def test_betweenness_centrality_asynchronous(property_graph: PropertyGraph):
+    property_name = "NewProp"
+
+    betweenness_centrality(property_graph, property_name, 16, BetweennessCentralityPlan.asynchronous())
+
+    node_schema: Schema = property_graph.node_schema()
+    num_node_properties = len(node_schema)
+    new_property_id = num_node_properties - 1
+    assert node_schema.names[new_property_id] == property_name
+
+    stats = BetweennessCentralityStatistics(property_graph, property_name)
+
+    assert stats.min_centrality == 0
+    assert stats.max_centrality == approx(8210.38)
+    assert stats.average_centrality == approx(1.3645)
+
+
 def test_triangle_count():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
     original_first_edge_list = [property_graph.get_edge_dest(e) for e in property_graph.edges(0)]
@@ -262,6 +404,20 @@ def test_triangle_count():
     assert n == 282617
 
 
+def test_triangle_count_sampling():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    estimate = TriangleCountEstimate(property_graph, TriangleCountPlan.sampling(relative_error=0.05))
+    assert estimate.estimate == approx(282617, rel=0.15)
+    assert estimate.colors >= 1
+
+    n = triangle_count(property_graph, TriangleCountPlan.sampling())
+    assert n == approx(282617, rel=0.15)
+
+    exact = TriangleCountEstimate(property_graph, TriangleCountPlan.ordered_count())
+    assert exact.estimate == 282617
+    assert exact.variance == 0
+
+
 def test_triangle_count_presorted():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
     sort_nodes_by_degree(property_graph)
@@ -270,6 +426,35 @@ def test_triangle_count_presorted():
     assert n == 282617
 
 
+def test_motif_count():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    motif_count(property_graph, "triangles", "four_cycles", "four_cliques")
+    motif_count_assert_valid(property_graph, "triangles", "four_cycles", "four_cliques")
+
+    stats = MotifCountStatistics(property_graph, "triangles", "four_cycles", "four_cliques")
+    assert stats.total_triangles == 282617
+
+    motif_count(property_graph, "triangles_relabeled", plan=MotifCountPlan.ordered_count(relabeling=True))
+    relabeled = MotifCountStatistics(property_graph, "triangles_relabeled")
+    assert relabeled.total_triangles == 282617
+    assert relabeled.total_four_cycles == 0
+    assert np.array_equal(
+        property_graph.get_node_property("triangles").to_numpy(),
+        property_graph.get_node_property("triangles_relabeled").to_numpy(),
+    )
+
+
+def test_directed_triad_census():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    census = directed_triad_census(property_graph)
+
+    # Every dyad of a symmetric graph is mutual, so each triangle is a 300 triad
+    assert census["300"] == 282617
+    assert all(census[t] == 0 for t in census if t not in ("003", "102", "201", "300"))
+    n = property_graph.num_nodes()
+    assert sum(census.values()) == n * (n - 1) * (n - 2) // 6
+
+
 def test_independent_set():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -285,6 +470,29 @@ def test_independent_set():
 
     independent_set_assert_valid(property_graph, "output2")
 
+    independent_set(property_graph, "output3", IndependentSetPlan.bitset_priority())
+
+    independent_set_assert_valid(property_graph, "output3")
+
+
+def test_graph_coloring():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    graph_coloring(property_graph, "color")
+
+    graph_coloring_assert_valid(property_graph, "color")
+
+
+def test_bipartite_matching_fail():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    # Every node of a symmetric graph has both in- and out-edges
+    with raises(GaloisError):
+        bipartite_matching(property_graph, "matched", BipartiteMatchingPlan.pothen_fan())
+
+    with raises(GaloisError):
+        weighted_bipartite_matching(property_graph, "value", "matched")
+
 
 def test_connected_components():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
@@ -301,6 +509,43 @@ def test_connected_components():
     connected_components_assert_valid(property_graph, "output")
 
 
+def test_graph_partition():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    graph_partition(property_graph, 4, "partition", GraphPartitionPlan.multilevel())
+
+    graph_partition_assert_valid(property_graph, 4, "partition")
+
+    stats = GraphPartitionStatistics(property_graph, "partition")
+    assert stats.n_partitions == 4
+    assert stats.edge_cut < property_graph.num_edges()
+    assert stats.imbalance <= 0.1
+
+
+def test_strongly_connected_components():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    # On a symmetric graph the strongly connected components are the
+    # connected components
+    strongly_connected_components(property_graph, "output")
+
+    stats = StronglyConnectedComponentsStatistics(property_graph, "output")
+
+    assert stats.total_components == 69
+    assert stats.total_non_trivial_components == 1
+    assert stats.largest_component_size == 956
+
+    strongly_connected_components_assert_valid(property_graph, "output")
+
+    strongly_connected_components(property_graph, "output2", StronglyConnectedComponentsPlan.coloring())
+
+    stats = StronglyConnectedComponentsStatistics(property_graph, "output2")
+
+    assert stats.total_components == 69
+
+    strongly_connected_components_assert_valid(property_graph, "output2")
+
+
 def test_k_core():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -313,6 +558,26 @@ def test_k_core():
     k_core_assert_valid(property_graph, 10, "output")
 
 
+def test_k_core_decomposition():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    k_core(property_graph, 10, "output", KCorePlan.decomposition())
+
+    stats = KCoreStatistics(property_graph, 10, "output")
+
+    assert stats.number_of_nodes_in_kcore == 438
+
+    k_core_decomposition(property_graph, "coreness")
+
+    k_core_decomposition_assert_valid(property_graph, "coreness")
+
+    stats = KCoreStatistics(property_graph, 10, "coreness", decomposition=True)
+
+    assert stats.number_of_nodes_in_kcore == 438
+    assert sum(stats.coreness_histogram) == property_graph.num_nodes()
+    assert sum(stats.coreness_histogram[10:]) == 438
+
+
 def test_k_truss():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -325,6 +590,25 @@ def test_k_truss():
     k_truss_assert_valid(property_graph, 10, "output")
 
 
+def test_k_truss_decomposition():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    k_truss(property_graph, 10, "output", KTrussPlan.decomposition())
+
+    stats = KTrussStatistics(property_graph, 10, "output")
+
+    assert stats.number_of_edges_left == 13338
+
+    k_truss_decomposition(property_graph, "trussness")
+
+    k_truss_decomposition_assert_valid(property_graph, "trussness")
+
+    stats = KTrussStatistics(property_graph, 10, "trussness", decomposition=True)
+
+    assert stats.number_of_edges_left == 13338
+    assert sum(stats.trussness_histogram[10:]) == 13338
+
+
 def test_k_truss_fail():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -350,6 +634,150 @@ def test_louvain_clustering():
     # assert stats.largest_cluster_size == 297
 
 
+def test_louvain_clustering_from_seed():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    label_propagation(property_graph, "seed")
+
+    louvain_clustering_from_seed(property_graph, "value", "seed", "output")
+
+    louvain_clustering_assert_valid(property_graph, "value", "output")
+
+    # Louvain merges the seed communities but never splits them
+    seed_stats = LabelPropagationStatistics(property_graph, "seed")
+    stats = LouvainClusteringStatistics(property_graph, "value", "output")
+    assert stats.n_clusters <= seed_stats.n_communities
+
+
+def test_label_propagation():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+
+    label_propagation(property_graph, "sync", LabelPropagationPlan.synchronous())
+    label_propagation(property_graph, "sync2", LabelPropagationPlan.synchronous())
+    label_propagation(property_graph, "async", LabelPropagationPlan.asynchronous())
+
+    label_propagation_assert_valid(property_graph, "sync")
+    label_propagation_assert_valid(property_graph, "async")
+
+    # Synchronous label propagation is deterministic
+    assert np.array_equal(
+        property_graph.get_node_property("sync").to_numpy(), property_graph.get_node_property("sync2").to_numpy()
+    )
+
+    stats = LabelPropagationStatistics(property_graph, "async")
+    assert 0 < stats.n_communities < property_graph.num_nodes()
+
+
+def test_max_flow():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    max_flow(property_graph, 0, 1, "value", "flow", MaxFlowPlan.push_relabel())
+
+    max_flow_assert_valid(property_graph, 0, 1, "value", "flow")
+
+    stats = MaxFlowStatistics(property_graph, 0, "value", "flow")
+    assert stats.flow_value >= 0
+    assert stats.n_saturated_edges <= property_graph.num_edges()
+
+
+def test_hyper_anf():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    stats = hyper_anf(property_graph, "harmonic", HyperAnfPlan.synchronous(8))
+
+    nf = stats.neighborhood_function
+    assert len(nf) == stats.num_iterations + 1
+    assert nf == sorted(nf)
+    assert abs(nf[0] - property_graph.num_nodes()) <= 0.1 * property_graph.num_nodes()
+    assert 0 < stats.effective_diameter <= stats.num_iterations
+    assert 0 < stats.average_distance <= stats.num_iterations
+    assert (property_graph.get_node_property("harmonic").to_numpy() >= 0).all()
+
+    with raises(GaloisError):
+        hyper_anf(property_graph, "harmonic")
+
+
+def test_hypergraph_partition():
+    # Two groups of 20 nodes with 6-node hyperedges inside them, and one
+    # hyperedge across
+    hyperedges = [[g * 20 + (i + j) % 20 for j in range(6)] for g in range(2) for i in range(20)]
+    hyperedges.append([0, 20])
+    property_graph = make_hypergraph(40, hyperedges)
+    num_hyperedges = len(hyperedges)
+
+    plan = HyperGraphPartitionPlan.multilevel(HyperGraphPartitionPlan.MatchingPolicy.LowerDegree)
+    hypergraph_partition(property_graph, num_hyperedges, 2, "partition", plan)
+
+    hypergraph_partition_assert_valid(property_graph, num_hyperedges, 2, "partition")
+
+    stats = HyperGraphPartitionStatistics(property_graph, num_hyperedges, "partition")
+    assert stats.n_partitions == 2
+    assert stats.hyperedge_cut < num_hyperedges // 2
+    assert stats.imbalance <= 0.1
+
+    # The last hyperedge holds nodes 0 and 20
+    partition = property_graph.get_node_property("partition").to_numpy()
+    crossing = partition[num_hyperedges - 1]
+    assert crossing == HYPERGRAPH_PARTITION_CUT or crossing == partition[num_hyperedges]
+
+    with raises(GaloisError):
+        hypergraph_partition(property_graph, num_hyperedges, 2, "partition")
+
+
+def test_reachability_index(property_graph: PropertyGraph):
+    num_nodes = property_graph.num_nodes()
+    bfs(property_graph, 0, "bfs")
+    expected = property_graph.get_node_property("bfs").to_numpy()
+    expected = np.where(expected <= num_nodes, expected, REACHABILITY_INDEX_UNREACHABLE)
+
+    reachability_index(property_graph, "index", ReachabilityIndexPlan.pruned_landmark_labeling(16))
+
+    sources = np.zeros(num_nodes, dtype=np.uint32)
+    targets = np.arange(num_nodes, dtype=np.uint32)
+    assert (reachability_index_query(property_graph, "index", sources, targets) == expected).all()
+    reachable = reachability_index_reachable(property_graph, "index", sources, targets)
+    assert (reachable == (expected != REACHABILITY_INDEX_UNREACHABLE)).all()
+
+    stats = ReachabilityIndexStatistics(property_graph, "index")
+    assert num_nodes <= stats.total_label_size
+    assert 0 < stats.average_label_size <= stats.max_label_size
+
+    with raises(GaloisError):
+        reachability_index(property_graph, "index")
+    with raises(GaloisError):
+        reachability_index_query(property_graph, "index", [num_nodes], [0])
+
+
+def test_minimum_spanning_forest():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    minimum_spanning_forest(property_graph, "value", "forest", MinimumSpanningForestPlan.boruvka())
+
+    minimum_spanning_forest_assert_valid(property_graph, "value", "forest")
+
+    stats = MinimumSpanningForestStatistics(property_graph, "value", "forest")
+    assert stats.n_forest_edges + stats.n_trees == property_graph.num_nodes()
+    assert stats.n_forest_edges == np.count_nonzero(property_graph.get_edge_property("forest").to_numpy())
+
+
+def test_leiden_clustering():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    leiden_clustering(property_graph, "value", "output")
+
+    leiden_clustering_assert_valid(property_graph, "value", "output")
+
+    stats = LeidenClusteringStatistics(property_graph, "value", "output")
+
+    # The clustering is non-deterministic, but never worse than singletons
+    assert 0 < stats.n_clusters <= property_graph.num_nodes()
+    assert stats.modularity > 0
+
+    leiden_clustering(property_graph, "value", "output_vf", LeidenClusteringPlan.do_all(True))
+
+    leiden_clustering_assert_valid(property_graph, "value", "output_vf")
+
+
 def test_local_clustering_coefficient():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
 
@@ -360,6 +788,15 @@ def test_local_clustering_coefficient():
     assert out[-1].as_py() == 0
     assert not np.any(np.isnan(out))
 
+    # The graph is already relabeled and sorted by the first run
+    local_clustering_coefficient(
+        property_graph,
+        "output_owner_computes",
+        LocalClusteringCoefficientPlan.ordered_count_owner_computes(relabeling=False),
+    )
+    owner_computes = property_graph.get_node_property("output_owner_computes")
+    assert np.allclose(np.array(owner_computes), np.array(property_graph.get_node_property("output")))
+
 
 def test_subgraph_extraction():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
@@ -375,12 +812,13 @@ def test_subgraph_extraction():
         for i in nodes
     ]
 
-    pg = subgraph_extraction(property_graph, nodes)
+    for plan in [SubGraphExtractionPlan.node_set(), SubGraphExtractionPlan.node_set_scan()]:
+        pg = subgraph_extraction(property_graph, nodes, plan)
 
-    assert isinstance(pg, PropertyGraph)
-    assert len(pg) == len(nodes)
-    assert pg.num_edges() == 6
+        assert isinstance(pg, PropertyGraph)
+        assert len(pg) == len(nodes)
+        assert pg.num_edges() == 6
 
-    for i, _ in enumerate(expected_edges):
-        assert len(pg.edges(i)) == len(expected_edges[i])
-        assert [pg.get_edge_dest(e) for e in pg.edges(i)] == expected_edges[i]
+        for i, _ in enumerate(expected_edges):
+            assert len(pg.edges(i)) == len(expected_edges[i])
+            assert [pg.get_edge_dest(e) for e in pg.edges(i)] == expected_edges[i]
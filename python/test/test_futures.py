@@ -0,0 +1,35 @@
+from tempfile import TemporaryDirectory
+
+from katana import futures
+from katana.analytics import BfsStatistics, bfs, bfs_assert_valid
+from katana.example_utils import get_input
+from katana.property_graph import PropertyGraph
+
+
+def test_load_and_analyze_concurrently():
+    path = get_input("propertygraphs/ldbc_003")
+    expected = PropertyGraph(path)
+    bfs(expected, 0, "distance")
+    expected_max_distance = BfsStatistics(expected, "distance").max_distance
+
+    with futures.Executor(max_workers=4) as executor:
+        loading = [executor.load(path) for _ in range(4)]
+        running = [executor.submit(bfs, f.result(), 0, "distance") for f in loading]
+        for f in running:
+            f.result()
+
+    for f in loading:
+        graph = f.result()
+        bfs_assert_valid(graph, "distance")
+        assert BfsStatistics(graph, "distance").max_distance == expected_max_distance
+
+
+def test_default_executor(property_graph: PropertyGraph):
+    futures.submit(bfs, property_graph, 0, "distance").result()
+    # TODO(amp): mark_all_properties_persistent shouldn't be required. Why is it?
+    property_graph.mark_all_properties_persistent()
+    with TemporaryDirectory() as tmpdir:
+        futures.write(property_graph, tmpdir).result()
+        graph = futures.load(tmpdir).result()
+    bfs_assert_valid(graph, "distance")
+    assert graph.num_nodes() == property_graph.num_nodes()
@@ -14,6 +14,10 @@ def test_import_property_graph():
     import katana.property_graph
 
 
+def test_import_futures():
+    import katana.futures
+
+
 def test_import_graph():
     import katana.graphs
 
@@ -0,0 +1,18 @@
+from katana.example_utils import get_input
+from katana.io_stats import io_stats, reset_io_stats
+from katana.property_graph import PropertyGraph
+
+__all__ = []
+
+
+def test_io_stats_load():
+    reset_io_stats()
+    PropertyGraph(get_input("propertygraphs/ldbc_003"))
+    stats = io_stats()
+    assert stats["Get"]["count"] > 0
+    assert stats["Get"]["bytes"] > 0
+    assert stats["ParquetRead"]["count"] > 0
+    for op in stats.values():
+        assert op["p50_usec"] <= op["p90_usec"] <= op["p99_usec"] <= op["max_usec"]
+    reset_io_stats()
+    assert io_stats() == {}
@@ -6,8 +6,11 @@ import pytest
 from numba import from_dtype
 
 from katana.loops import (
+    CHUNK_SIZES,
+    BulkSynchronous,
     OrderedByIntegerMetric,
     PerSocketChunkFIFO,
+    PerSocketChunkLIFO,
     do_all,
     do_all_operator,
     for_each,
@@ -250,6 +253,98 @@ def test_per_socket_chunk_fifo(threads_1):
     assert order == [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0]
 
 
+def test_obim_delta(threads_1):
+    _ = threads_1
+
+    order = []
+
+    @obim_metric()
+    def metric(i):
+        return 9 - i
+
+    def f(i, ctx):
+        _ = ctx
+        order.append(i)
+
+    # Metrics that differ only in their low 2 bits share a bucket, which keeps its order
+    for_each(range(10), f, worklist=OrderedByIntegerMetric(metric, delta=2))
+    assert order == [6, 7, 8, 9, 2, 3, 4, 5, 0, 1]
+
+
+@pytest.mark.parametrize("chunk_size", CHUNK_SIZES)
+@pytest.mark.parametrize("worklist_type", [PerSocketChunkFIFO, PerSocketChunkLIFO, BulkSynchronous])
+def test_worklists(worklist_type, chunk_size):
+    @for_each_operator()
+    def f(out, i, ctx):
+        out[i] += 1
+        if i < 500:
+            ctx.push(i + 500)
+
+    out = np.zeros(1000, dtype=int)
+    for_each(range(500), f(out), worklist=worklist_type(chunk_size=chunk_size))
+    assert np.all(out == 1)
+
+
+def test_bulk_synchronous(threads_1):
+    _ = threads_1
+
+    order = []
+
+    def f(i, ctx):
+        order.append(i)
+        if i < 10:
+            ctx.push(i + 10)
+
+    for_each(range(10), f, worklist=BulkSynchronous())
+    assert sorted(order[:10]) == list(range(10))
+    assert sorted(order[10:]) == list(range(10, 20))
+
+
+def test_worklist_invalid_arguments():
+    with pytest.raises(ValueError):
+        PerSocketChunkFIFO(chunk_size=17)
+    with pytest.raises(ValueError):
+        OrderedByIntegerMetric(lambda i: i, delta=-1)
+
+
+@pytest.mark.parametrize("modes", simple_modes)
+def test_for_each_push_many(modes):
+    @for_each_operator()
+    def f(out, children, i, ctx):
+        out[i] += 1
+        if i == 0:
+            ctx.push_many(children.ctypes, len(children))
+
+    children = np.arange(1, 100, dtype=np.uint64)
+    out = np.zeros(100, dtype=int)
+    for_each(range(1), f(out, children), **modes)
+    assert np.all(out == 1)
+
+
+def test_for_each_push_many_python():
+    out = np.zeros(100, dtype=int)
+
+    def f(i, ctx):
+        out[i] += 1
+        if i == 0:
+            ctx.push_many(np.arange(1, 100))
+
+    for_each(range(1), f)
+    assert np.all(out == 1)
+
+
+@pytest.mark.parametrize("modes", simple_modes)
+def test_for_each_array(modes):
+    @for_each_operator()
+    def f(out, i, ctx):
+        _ = ctx
+        out[i] += 1
+
+    out = np.zeros(10, dtype=int)
+    for_each(np.array([1, 3, 5], dtype=np.int32), f(out), **modes)
+    assert np.allclose(out, np.array([0, 1, 0, 1, 0, 1, 0, 0, 0, 0]))
+
+
 def test_closure_memory_management():
     @do_all_operator()
     def f(x, y):
@@ -0,0 +1,20 @@
+import numpy as np
+
+from katana.datastructures import LargeArray
+from katana.memory import memory_usage, reset_memory_peaks
+
+__all__ = []
+
+
+def test_memory_usage_large_array():
+    reset_memory_peaks()
+    before = memory_usage()["Analytics"]
+    arr = LargeArray[np.uint64]()
+    arr.allocateBlocked(1 << 20)
+    during = memory_usage()["Analytics"]
+    assert during["current"] >= before["current"] + 8 * (1 << 20)
+    assert during["peak"] >= during["current"]
+    del arr
+    after = memory_usage()["Analytics"]
+    assert after["current"] == before["current"]
+    assert after["peak"] == during["peak"]
@@ -8,6 +8,7 @@ import pytest
 
 from katana import TsubaError
 from katana.loops import do_all, do_all_operator
+from katana.numba_support.galois import edge_range
 from katana.property_graph import PropertyGraph
 
 
@@ -119,6 +120,17 @@ def test_add_node_property(property_graph):
     assert property_graph.get_node_property("new_prop") == pyarrow.array(range(property_graph.num_nodes()))
 
 
+def test_add_node_property_from_expression(property_graph):
+    t = pyarrow.table(dict(x=range(property_graph.num_nodes())))
+    property_graph.add_node_property(t)
+    property_graph.add_node_property_from_expression("y", "2 * x + degree()")
+    y = property_graph.get_node_property("y").to_numpy()
+    degrees = np.diff(np.concatenate([[0], property_graph.out_indices().to_numpy()]))
+    np.testing.assert_allclose(y, 2 * np.arange(property_graph.num_nodes()) + degrees)
+    with pytest.raises(RuntimeError):
+        property_graph.add_node_property_from_expression("z", "2 *")
+
+
 def test_upsert_node_property(property_graph):
     prop = property_graph.node_schema().names[0]
     t = pyarrow.table({prop: range(property_graph.num_nodes())})
@@ -128,6 +140,18 @@ def test_upsert_node_property(property_graph):
     assert property_graph.get_node_property(prop) == pyarrow.array(range(property_graph.num_nodes()))
 
 
+def test_property_memory_budget(property_graph):
+    with TemporaryDirectory() as tmpdir:
+        t = pyarrow.table({"new_prop": range(property_graph.num_nodes())})
+        property_graph.add_node_property(t)
+        property_graph.set_property_memory_budget(1, tmpdir)
+        assert property_graph.loaded_property_bytes() < 8 * property_graph.num_nodes() + 64
+        assert len(property_graph.node_schema()) == 32
+        prop = property_graph.node_schema().names[0]
+        assert property_graph.get_node_property(prop) is not None
+        assert property_graph.get_node_property("new_prop") == pyarrow.array(range(property_graph.num_nodes()))
+
+
 def test_get_edge_property(property_graph):
     prop1 = property_graph.get_edge_property(15)
     assert not prop1[10].as_py()
@@ -236,3 +260,39 @@ def test_simple_algorithm(property_graph):
     assert oprop[0].as_py() == 91
     assert oprop[4].as_py() == 239
     assert oprop[-1].as_py() == 0
+
+
+def test_topology_arrays(property_graph):
+    g = property_graph
+    out_indices = g.out_indices()
+    out_dests = g.out_dests()
+    assert len(out_indices) == g.num_nodes()
+    assert len(out_dests) == g.num_edges()
+    assert out_indices[-1].as_py() == g.num_edges()
+    assert out_dests[0].as_py() == g.get_edge_dest(0)
+
+    out_indices_np = out_indices.to_numpy(zero_copy_only=True)
+    out_dests_np = out_dests.to_numpy(zero_copy_only=True)
+    reachable = [out_dests_np[e] for e in edge_range(out_indices_np, 10)]
+    assert reachable == [2011, 1422, 1409, 4798, 9483]
+
+
+def test_simple_algorithm_topology_arrays(property_graph):
+    @do_all_operator()
+    def func_operator(out_indices, out_dests, prop, out, nid):
+        t = 0
+        for eid in edge_range(out_indices, nid):
+            nid2 = out_dests[eid]
+            if prop.is_valid(nid2):
+                t += prop[nid2]
+        out[nid] = t
+
+    g = property_graph
+    prop = g.get_node_property("length")
+    out = np.empty((g.num_nodes(),), dtype=int)
+
+    do_all(g, func_operator(g.out_indices().to_numpy(), g.out_dests().to_numpy(), prop, out), "operator")
+
+    assert out[0] == 91
+    assert out[4] == 239
+    assert out[-1] == 0
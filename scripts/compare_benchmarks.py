@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+#
+# Compare two Google Benchmark JSON outputs, e.g., of unit-analytics-bench
+# written with --benchmark_out=<file> --benchmark_out_format=json, and report
+# the benchmarks whose throughput regressed.
+#
+# Exits with a non-zero status when any benchmark regressed by more than the
+# threshold, so that it can gate a nightly job against a stored baseline.
+
+import argparse
+import json
+import sys
+
+
+def load(path, counter):
+    with open(path) as f:
+        doc = json.load(f)
+    results = {}
+    for b in doc["benchmarks"]:
+        if b.get("error_occurred"):
+            continue
+        # Repetitions report aggregates; compare only the means
+        if b.get("run_type") == "aggregate" and b.get("aggregate_name") != "mean":
+            continue
+        name = b.get("run_name", b["name"])
+        if counter in b:
+            results[name] = float(b[counter])
+        else:
+            # Without the counter, use the inverse of the time, so that larger
+            # is still better
+            results[name] = 1.0 / float(b["real_time"])
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare benchmark throughput against a baseline.")
+    parser.add_argument("baseline", help="benchmark JSON of the baseline")
+    parser.add_argument("contender", help="benchmark JSON to compare")
+    parser.add_argument("--counter", default="edges_per_second", help="throughput counter to compare")
+    parser.add_argument(
+        "--threshold", type=float, default=0.1, help="largest allowed relative slowdown (default: 0.1)"
+    )
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.counter)
+    contender = load(args.contender, args.counter)
+
+    regressions = 0
+    width = max((len(name) for name in {**baseline, **contender}), default=0)
+    for name in sorted(baseline):
+        if name not in contender:
+            print(f"{name:<{width}}  missing")
+            continue
+        change = contender[name] / baseline[name] - 1
+        marker = ""
+        if change < -args.threshold:
+            marker = "  REGRESSION"
+            regressions += 1
+        print(f"{name:<{width}}  {change:+8.1%}{marker}")
+
+    for name in sorted(set(contender) - set(baseline)):
+        print(f"{name:<{width}}  new")
+
+    if regressions:
+        print(f"{regressions} benchmarks regressed by more than {args.threshold:.0%}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,117 @@
+#ifndef KATANA_TOOLS_GRAPH_CONVERT_PARALLELFETCH_H_
+#define KATANA_TOOLS_GRAPH_CONVERT_PARALLELFETCH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "katana/Galois.h"
+
+namespace katana {
+
+/// A bounded queue of batches between the threads that fetch rows from a
+/// database and the threads that add them to a graph builder
+template <typename Batch>
+class FetchQueue {
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::deque<Batch> batches_;
+  size_t capacity_;
+  bool closed_{false};
+
+public:
+  FetchQueue(size_t capacity) : capacity_(capacity) {}
+
+  /// Move batch to the back of the queue unless it is full
+  bool TryPush(Batch* batch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (batches_.size() >= capacity_) {
+      return false;
+    }
+    batches_.emplace_back(std::move(*batch));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /// Remove the oldest batch, if there is one
+  std::optional<Batch> TryPop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return PopLocked();
+  }
+
+  /// Remove the oldest batch, waiting for one while the queue is open.
+  /// Returns nullopt once the queue is closed and empty.
+  std::optional<Batch> Pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this]() { return !batches_.empty() || closed_; });
+    return PopLocked();
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+private:
+  std::optional<Batch> PopLocked() {
+    if (batches_.empty()) {
+      return std::nullopt;
+    }
+    Batch batch = std::move(batches_.front());
+    batches_.pop_front();
+    return batch;
+  }
+};
+
+/// Read every source, such as a range of the rows of a table, on at most
+/// num_fetchers threads at once, while every thread adds the batches read to
+/// its graph builder.
+///
+/// fetch(source, fetcher, emit) reads source with the connection of fetcher,
+/// a number less than num_fetchers that no other thread uses at the same
+/// time, and calls emit(Batch&&) for each batch it reads. convert(Batch&&,
+/// tid) adds a batch to the builder of thread tid. At most queue_capacity
+/// batches wait between the two; a fetcher that finds the queue full
+/// converts the oldest batch itself instead of waiting, which keeps memory
+/// bounded and lets a single thread both fetch and convert.
+template <typename Batch, typename Source, typename FetchFn, typename ConvertFn>
+void
+FetchInParallel(
+    const std::vector<Source>& sources, unsigned num_fetchers,
+    size_t queue_capacity, FetchFn fetch, ConvertFn convert) {
+  num_fetchers = std::clamp(num_fetchers, 1U, katana::getActiveThreads());
+
+  FetchQueue<Batch> queue(queue_capacity);
+  std::atomic<size_t> next_source{0};
+  std::atomic<unsigned> active_fetchers{num_fetchers};
+
+  katana::on_each([&](unsigned tid, unsigned) {
+    if (tid < num_fetchers) {
+      auto emit = [&](Batch&& batch) {
+        while (!queue.TryPush(&batch)) {
+          if (auto oldest = queue.TryPop(); oldest) {
+            convert(std::move(oldest.value()), tid);
+          }
+        }
+      };
+      for (size_t s = next_source++; s < sources.size(); s = next_source++) {
+        fetch(sources[s], tid, emit);
+      }
+      if (--active_fetchers == 0) {
+        queue.Close();
+      }
+    }
+    while (auto batch = queue.Pop()) {
+      convert(std::move(batch.value()), tid);
+    }
+  });
+}
+
+}  // end namespace katana
+
+#endif
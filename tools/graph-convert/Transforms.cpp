@@ -1,8 +1,16 @@
 #include "Transforms.h"
 
+#include <algorithm>
+#include <numeric>
+#include <optional>
+
+#include <arrow/compute/api.h>
 #include <arrow/type.h>
 
 #include "TimeParser.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
 
 namespace {
 
@@ -51,6 +59,229 @@ ApplyTransform(
   }
 }
 
+/// The values of an arrow array being filled in
+template <typename ArrowType>
+struct ArrayValues {
+  using T = typename ArrowType::c_type;
+
+  std::shared_ptr<arrow::Buffer> buffer;
+  uint64_t length{};
+  T* data{};
+
+  std::shared_ptr<arrow::NumericArray<ArrowType>> Finish() const {
+    return std::make_shared<arrow::NumericArray<ArrowType>>(length, buffer);
+  }
+};
+
+template <typename ArrowType>
+katana::Result<ArrayValues<ArrowType>>
+AllocateValues(uint64_t length) {
+  using T = typename ArrowType::c_type;
+
+  auto res = arrow::AllocateBuffer(length * sizeof(T));
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(res.status()), "allocating {} values: {}",
+        length, res.status());
+  }
+  ArrayValues<ArrowType> values;
+  values.buffer = std::move(res.ValueOrDie());
+  values.length = length;
+  values.data = reinterpret_cast<T*>(values.buffer->mutable_data());
+  return values;
+}
+
+/// The topology made by a GraphTransformer, the old edge of each of its
+/// edges and, if it removed nodes, the old node of each of its nodes
+struct TransformedTopology {
+  ArrayValues<arrow::UInt64Type> out_indices;
+  ArrayValues<arrow::UInt32Type> out_dests;
+  ArrayValues<arrow::UInt64Type> old_edges;
+  std::optional<ArrayValues<arrow::UInt64Type>> old_nodes;
+
+  static katana::Result<TransformedTopology> Allocate(
+      uint64_t num_nodes, uint64_t num_edges) {
+    TransformedTopology transformed;
+    auto indices_res = AllocateValues<arrow::UInt64Type>(num_nodes);
+    if (!indices_res) {
+      return indices_res.error();
+    }
+    transformed.out_indices = std::move(indices_res.value());
+    if (auto res = transformed.AllocateEdges(num_edges); !res) {
+      return res.error();
+    }
+    return transformed;
+  }
+
+  /// Allocate the edges once out_indices holds the end of each node's edges
+  katana::Result<void> AllocateEdges(uint64_t num_edges) {
+    auto dests_res = AllocateValues<arrow::UInt32Type>(num_edges);
+    if (!dests_res) {
+      return dests_res.error();
+    }
+    out_dests = std::move(dests_res.value());
+    auto edges_res = AllocateValues<arrow::UInt64Type>(num_edges);
+    if (!edges_res) {
+      return edges_res.error();
+    }
+    old_edges = std::move(edges_res.value());
+    return katana::ResultSuccess();
+  }
+
+  uint64_t num_nodes() const { return out_indices.length; }
+
+  uint64_t edges_begin(uint64_t n) const {
+    return n == 0 ? 0 : out_indices.data[n - 1];
+  }
+
+  /// Turn the number of edges of each node in out_indices into the end of
+  /// its edges and allocate them
+  katana::Result<void> AllocateFromDegrees() {
+    katana::ParallelSTL::partial_sum(
+        out_indices.data, out_indices.data + num_nodes(), out_indices.data);
+    return AllocateEdges(
+        num_nodes() == 0 ? 0 : out_indices.data[num_nodes() - 1]);
+  }
+};
+
+/// Copy the rows of table in the order of rows, one column per task
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::shared_ptr<arrow::UInt64Array>& rows) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns(
+      table->num_columns());
+  std::vector<arrow::Status> statuses(columns.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, columns.size()),
+      [&](size_t i) {
+        auto take_res = arrow::compute::Take(
+            arrow::Datum(table->column(i)), arrow::Datum(rows));
+        if (!take_res.ok()) {
+          statuses[i] = take_res.status();
+          return;
+        }
+        columns[i] = take_res.ValueOrDie().chunked_array();
+      },
+      katana::steal(), katana::no_stats());
+  for (size_t i = 0; i < statuses.size(); ++i) {
+    if (!statuses[i].ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(statuses[i]), "copying property {}: {}",
+          table->field(i)->name(), statuses[i]);
+    }
+  }
+  return arrow::Table::Make(table->schema(), columns, rows->length());
+}
+
+/// Make the graph with the transformed topology and the properties of the
+/// nodes and edges of graph it came from
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+MakeTransformedGraph(
+    const katana::PropertyGraph& graph,
+    const TransformedTopology& transformed) {
+  auto out = std::make_unique<katana::PropertyGraph>();
+  if (auto res = out->SetTopology(katana::GraphTopology{
+          .out_indices = transformed.out_indices.Finish(),
+          .out_dests = transformed.out_dests.Finish(),
+      });
+      !res) {
+    return res.error();
+  }
+
+  std::shared_ptr<arrow::Table> node_properties = graph.node_properties();
+  if (transformed.old_nodes && node_properties->num_columns() > 0) {
+    auto take_res = TakeRows(node_properties, transformed.old_nodes->Finish());
+    if (!take_res) {
+      return take_res.error().WithContext("node properties");
+    }
+    node_properties = std::move(take_res.value());
+  }
+  if (auto res = out->AddNodeProperties(node_properties); !res) {
+    return res.error();
+  }
+
+  if (graph.edge_properties()->num_columns() > 0) {
+    auto take_res =
+        TakeRows(graph.edge_properties(), transformed.old_edges.Finish());
+    if (!take_res) {
+      return take_res.error().WithContext("edge properties");
+    }
+    if (auto res = out->AddEdgeProperties(take_res.value()); !res) {
+      return res.error();
+    }
+  }
+
+  if (auto res = out->ConstructTypeSetIDs(); !res) {
+    return res.error();
+  }
+  return std::unique_ptr<katana::PropertyGraph>(std::move(out));
+}
+
+/// Sort the out-edges of every node by destination and, if remove_redundant,
+/// drop self-loops and repeated edges
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SortAndDeduplicate(const katana::PropertyGraph& graph, bool remove_redundant) {
+  const katana::GraphTopology& topology = graph.topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  // Sort each node's edge ids, the old order breaking ties
+  auto order_res = AllocateValues<arrow::UInt64Type>(topology.num_edges());
+  if (!order_res) {
+    return order_res.error();
+  }
+  uint64_t* order = order_res.value().data;
+
+  auto transformed_res = TransformedTopology::Allocate(num_nodes, 0);
+  if (!transformed_res) {
+    return transformed_res.error();
+  }
+  TransformedTopology transformed = std::move(transformed_res.value());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto edges = topology.edges(n);
+        uint64_t* begin = order + *edges.begin();
+        uint64_t* end = order + *edges.end();
+        std::iota(begin, end, *edges.begin());
+        std::sort(begin, end, [&](uint64_t a, uint64_t b) {
+          auto a_dest = topology.edge_dest(a);
+          auto b_dest = topology.edge_dest(b);
+          return a_dest < b_dest || (a_dest == b_dest && a < b);
+        });
+        if (remove_redundant) {
+          end = std::unique(begin, end, [&](uint64_t a, uint64_t b) {
+            return topology.edge_dest(a) == topology.edge_dest(b);
+          });
+          end = std::remove_if(begin, end, [&](uint64_t e) {
+            return topology.edge_dest(e) == n;
+          });
+        }
+        transformed.out_indices.data[n] = end - begin;
+      },
+      katana::steal(), katana::no_stats());
+
+  if (auto res = transformed.AllocateFromDegrees(); !res) {
+    return res.error();
+  }
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        const uint64_t* kept = order + *topology.edges(n).begin();
+        for (uint64_t e = transformed.edges_begin(n),
+                      end = transformed.out_indices.data[n];
+             e < end; ++e, ++kept) {
+          transformed.out_dests.data[e] = topology.edge_dest(*kept);
+          transformed.old_edges.data[e] = *kept;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return MakeTransformedGraph(graph, transformed);
+}
+
 }  // namespace
 
 std::pair<std::shared_ptr<arrow::Field>, std::shared_ptr<arrow::ChunkedArray>>
@@ -161,3 +392,189 @@ katana::ApplyTransforms(
     ApplyTransform(graph->edge_property_view(), t.get());
   }
 }
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::Transpose::operator()(katana::PropertyGraph* graph) {
+  auto index_res = katana::MakeInEdgeIndex(graph->topology());
+  if (!index_res) {
+    return index_res.error();
+  }
+  const katana::InEdgeIndex& index = *index_res.value();
+
+  auto transformed_res =
+      TransformedTopology::Allocate(index.num_nodes(), index.num_edges());
+  if (!transformed_res) {
+    return transformed_res.error();
+  }
+  TransformedTopology transformed = std::move(transformed_res.value());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, index.num_nodes()),
+      [&](uint64_t n) {
+        transformed.out_indices.data[n] = index.topology.out_indices->Value(n);
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, index.num_edges()),
+      [&](uint64_t e) {
+        transformed.out_dests.data[e] = index.in_edge_src(e);
+        transformed.old_edges.data[e] = index.out_edge_id(e);
+      },
+      katana::no_stats());
+
+  return MakeTransformedGraph(*graph, transformed);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::MakeSymmetric::operator()(katana::PropertyGraph* graph) {
+  const katana::GraphTopology& topology = graph->topology();
+  auto index_res = katana::MakeInEdgeIndex(topology);
+  if (!index_res) {
+    return index_res.error();
+  }
+  const katana::InEdgeIndex& index = *index_res.value();
+  uint64_t num_nodes = topology.num_nodes();
+
+  auto transformed_res = TransformedTopology::Allocate(num_nodes, 0);
+  if (!transformed_res) {
+    return transformed_res.error();
+  }
+  TransformedTopology transformed = std::move(transformed_res.value());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t degree = topology.edges(n).size();
+        for (auto in_edge : index.in_edges(n)) {
+          if (index.in_edge_src(in_edge) != n) {
+            ++degree;
+          }
+        }
+        transformed.out_indices.data[n] = degree;
+      },
+      katana::steal(), katana::no_stats());
+
+  if (auto res = transformed.AllocateFromDegrees(); !res) {
+    return res.error();
+  }
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t pos = transformed.edges_begin(n);
+        for (auto e : topology.edges(n)) {
+          transformed.out_dests.data[pos] = topology.edge_dest(e);
+          transformed.old_edges.data[pos] = e;
+          ++pos;
+        }
+        for (auto in_edge : index.in_edges(n)) {
+          auto src = index.in_edge_src(in_edge);
+          if (src == n) {
+            continue;
+          }
+          transformed.out_dests.data[pos] = src;
+          transformed.old_edges.data[pos] = index.out_edge_id(in_edge);
+          ++pos;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return MakeTransformedGraph(*graph, transformed);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::SortEdges::operator()(katana::PropertyGraph* graph) {
+  return SortAndDeduplicate(*graph, false);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::Cleanup::operator()(katana::PropertyGraph* graph) {
+  return SortAndDeduplicate(*graph, true);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::RemoveHighDegree::operator()(katana::PropertyGraph* graph) {
+  const katana::GraphTopology& topology = graph->topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  // new_ids[n] - 1 is the new id of n if n is kept
+  auto new_ids_res = AllocateValues<arrow::UInt64Type>(num_nodes);
+  if (!new_ids_res) {
+    return new_ids_res.error();
+  }
+  uint64_t* new_ids = new_ids_res.value().data;
+  auto kept = [&](uint64_t n) {
+    return topology.edges(n).size() <= max_degree_;
+  };
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { new_ids[n] = kept(n) ? 1 : 0; }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(new_ids, new_ids + num_nodes, new_ids);
+  uint64_t num_kept = num_nodes == 0 ? 0 : new_ids[num_nodes - 1];
+
+  auto transformed_res = TransformedTopology::Allocate(num_kept, 0);
+  if (!transformed_res) {
+    return transformed_res.error();
+  }
+  TransformedTopology transformed = std::move(transformed_res.value());
+  auto old_nodes_res = AllocateValues<arrow::UInt64Type>(num_kept);
+  if (!old_nodes_res) {
+    return old_nodes_res.error();
+  }
+  transformed.old_nodes = std::move(old_nodes_res.value());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (!kept(n)) {
+          return;
+        }
+        uint64_t degree = 0;
+        for (auto e : topology.edges(n)) {
+          if (kept(topology.edge_dest(e))) {
+            ++degree;
+          }
+        }
+        transformed.out_indices.data[new_ids[n] - 1] = degree;
+        transformed.old_nodes->data[new_ids[n] - 1] = n;
+      },
+      katana::steal(), katana::no_stats());
+
+  if (auto res = transformed.AllocateFromDegrees(); !res) {
+    return res.error();
+  }
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_kept),
+      [&](uint64_t n) {
+        uint64_t pos = transformed.edges_begin(n);
+        for (auto e : topology.edges(transformed.old_nodes->data[n])) {
+          auto dest = topology.edge_dest(e);
+          if (!kept(dest)) {
+            continue;
+          }
+          transformed.out_dests.data[pos] = new_ids[dest] - 1;
+          transformed.old_edges.data[pos] = e;
+          ++pos;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return MakeTransformedGraph(*graph, transformed);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::ApplyGraphTransforms(
+    std::unique_ptr<katana::PropertyGraph> graph,
+    const std::vector<std::unique_ptr<katana::GraphTransformer>>&
+        transformers) {
+  for (const auto& t : transformers) {
+    KATANA_LOG_WARN("applying {} to graph", t->name());
+    auto res = (*t)(graph.get());
+    if (!res) {
+      return res.error().WithContext("applying {}", t->name());
+    }
+    graph = std::move(res.value());
+  }
+  return std::unique_ptr<katana::PropertyGraph>(std::move(graph));
+}
@@ -84,6 +84,74 @@ void ApplyTransforms(
     katana::PropertyGraph* graph,
     const std::vector<std::unique_ptr<ColumnTransformer>>& transformers);
 
+/// A GraphTransformer makes a new graph from the topology of a graph. Each
+/// edge of the new graph takes the properties of the edge of the old
+/// graph it came from, and each node takes the properties of its old node.
+class GraphTransformer {
+public:
+  virtual ~GraphTransformer() = default;
+
+  virtual Result<std::unique_ptr<PropertyGraph>> operator()(
+      PropertyGraph* graph) = 0;
+
+  virtual std::string name() = 0;
+};
+
+/// Transpose reverses every edge.
+struct Transpose : public GraphTransformer {
+  std::string name() override { return "Transpose"; }
+
+  Result<std::unique_ptr<PropertyGraph>> operator()(
+      PropertyGraph* graph) override;
+};
+
+/// MakeSymmetric adds the reverse of every edge that is not a self-loop. The
+/// out-edges of a node are its old out-edges followed by the reverses of its
+/// old in-edges, ordered by source.
+struct MakeSymmetric : public GraphTransformer {
+  std::string name() override { return "MakeSymmetric"; }
+
+  Result<std::unique_ptr<PropertyGraph>> operator()(
+      PropertyGraph* graph) override;
+};
+
+/// SortEdges sorts the out-edges of every node by destination. Edges with
+/// the same destination keep their order.
+struct SortEdges : public GraphTransformer {
+  std::string name() override { return "SortEdges"; }
+
+  Result<std::unique_ptr<PropertyGraph>> operator()(
+      PropertyGraph* graph) override;
+};
+
+/// Cleanup sorts the out-edges of every node by destination and removes
+/// self-loops and all but the first of any edges with the same source and
+/// destination.
+struct Cleanup : public GraphTransformer {
+  std::string name() override { return "Cleanup"; }
+
+  Result<std::unique_ptr<PropertyGraph>> operator()(
+      PropertyGraph* graph) override;
+};
+
+/// RemoveHighDegree removes the nodes with more than max_degree out-edges,
+/// and the edges to and from them. The remaining nodes keep their order.
+struct RemoveHighDegree : public GraphTransformer {
+  uint64_t max_degree_;
+
+  RemoveHighDegree(uint64_t max_degree) : max_degree_(max_degree) {}
+
+  std::string name() override { return "RemoveHighDegree"; }
+
+  Result<std::unique_ptr<PropertyGraph>> operator()(
+      PropertyGraph* graph) override;
+};
+
+/// Apply each transformer in turn to the graph made by the previous one.
+Result<std::unique_ptr<PropertyGraph>> ApplyGraphTransforms(
+    std::unique_ptr<PropertyGraph> graph,
+    const std::vector<std::unique_ptr<GraphTransformer>>& transformers);
+
 }  // namespace katana
 
 #endif
@@ -18,11 +18,13 @@
  */
 
 #include <fcntl.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <ios>
@@ -30,6 +32,7 @@
 #include <limits>
 #include <random>
 #include <regex>
+#include <string>
 #include <vector>
 
 #include <boost/iostreams/filter/gzip.hpp>
@@ -54,6 +57,23 @@ static cll::opt<bool> edgesSorted(
     cll::init(false));
 static cll::opt<unsigned long long> numNodes(
     "numNodes", cll::desc("Total number of nodes given."), cll::init(0));
+static cll::opt<bool> externalMemory(
+    "externalMemory",
+    cll::desc("Build the graph out of core: spill the edges to buckets of "
+              "sources in scratchDir and sort one bucket at a time"),
+    cll::init(false));
+static cll::opt<unsigned long long> memoryBudget(
+    "memoryBudget", cll::desc("Memory budget in MB for externalMemory"),
+    cll::init(4096));
+static cll::opt<std::string> scratchDir(
+    "scratchDir",
+    cll::desc("Directory for the buckets of externalMemory, ideally on a "
+              "local SSD"),
+    cll::init("/tmp"));
+static cll::opt<unsigned long long> maxBucketEdges(
+    "maxBucketEdges",
+    cll::desc("Limit the number of edges in a bucket of externalMemory"),
+    cll::init(0), cll::Hidden);
 
 union dataTy {
   int64_t ival;
@@ -65,7 +85,8 @@ union dataTy {
 void
 perEdge(
     std::istream& is, std::function<void(uint64_t, uint64_t, dataTy)> fn,
-    std::function<void(uint64_t, uint64_t)> fnPreSize) {
+    std::function<void(uint64_t, uint64_t)> fnPreSize,
+    bool* sawData = nullptr) {
   std::string line;
 
   uint64_t bytes = 0;
@@ -120,12 +141,16 @@ perEdge(
       else
         data.dval = std::stod(matches[3].str());
       match = true;
+      if (sawData)
+        *sawData = true;
     } else if (std::regex_match(line, matches, intData)) {
       if (useSmallData)
         data.i32val = std::stoul(matches[3].str());
       else
         data.ival = std::stoll(matches[3].str());
       match = true;
+      if (sawData)
+        *sawData = true;
     } else if (std::regex_match(
                    line, matches,
                    noData)) {  // || std::regex_match(line, matches,
@@ -236,6 +261,292 @@ go_edgesSorted(std::istream& input, uint64_t numNodes) {
   }
 }
 
+/// An edge spilled to a bucket by go_external
+struct SpilledEdge {
+  uint64_t src;
+  uint64_t dst;
+  dataTy data;
+};
+
+void
+writeAt(int fd, const void* buf, size_t size, uint64_t offset) {
+  const char* ptr = static_cast<const char*>(buf);
+  while (size > 0) {
+    ssize_t written = pwrite(fd, ptr, size, offset);
+    if (written < 0)
+      throw "Failed to write";
+    ptr += written;
+    size -= written;
+    offset += written;
+  }
+}
+
+void
+writeAll(int fd, const void* buf, size_t size) {
+  const char* ptr = static_cast<const char*>(buf);
+  while (size > 0) {
+    ssize_t written = write(fd, ptr, size);
+    if (written < 0)
+      throw "Failed to write";
+    ptr += written;
+    size -= written;
+  }
+}
+
+/// Reads up to size bytes, fewer only at the end of the file
+size_t
+readAll(int fd, void* buf, size_t size) {
+  char* ptr = static_cast<char*>(buf);
+  size_t total = 0;
+  while (total < size) {
+    ssize_t count = read(fd, ptr + total, size - total);
+    if (count < 0)
+      throw "Failed to read";
+    if (count == 0)
+      break;
+    total += count;
+  }
+  return total;
+}
+
+/// The sources [firstNode, endNode), whose edges [firstEdge, firstEdge +
+/// numEdges) are sorted in memory together
+struct Bucket {
+  uint64_t firstNode;
+  uint64_t endNode;
+  uint64_t firstEdge;
+  uint64_t numEdges;
+  int fd;
+  std::vector<SpilledEdge> buffer;
+};
+
+/// The destinations and data of the edges of a bucket, in CSR order
+class BucketEdges {
+  size_t dataSize;
+  std::vector<uint32_t> dsts32;
+  std::vector<uint64_t> dsts64;
+  std::vector<char> data;
+  bool use32;
+
+public:
+  BucketEdges(uint64_t numEdges, bool use32_, size_t dataSize_)
+      : dataSize(dataSize_), use32(use32_) {
+    if (use32)
+      dsts32.resize(numEdges);
+    else
+      dsts64.resize(numEdges);
+    data.resize(numEdges * dataSize);
+  }
+
+  void set(uint64_t pos, const SpilledEdge& edge) {
+    if (use32)
+      dsts32[pos] = edge.dst;
+    else
+      dsts64[pos] = edge.dst;
+    if (dataSize == sizeof(uint32_t))
+      std::memcpy(&data[pos * dataSize], &edge.data.i32val, dataSize);
+    else if (dataSize == sizeof(uint64_t))
+      std::memcpy(&data[pos * dataSize], &edge.data.ival, dataSize);
+  }
+
+  void write(int fd, uint64_t dstOffset, uint64_t dataOffset) {
+    if (use32)
+      writeAt(fd, dsts32.data(), dsts32.size() * sizeof(uint32_t), dstOffset);
+    else
+      writeAt(fd, dsts64.data(), dsts64.size() * sizeof(uint64_t), dstOffset);
+    writeAt(fd, data.data(), data.size(), dataOffset);
+  }
+};
+
+/**
+ * Out of core construction, for graphs whose edges do not fit in memory:
+ *
+ * 1. A scan of the input counts the degree of every source. The sources are
+ *    split into buckets whose edges fit in memoryBudget, less the 8 bytes of
+ *    every node's offset, and the offsets are written to the output.
+ * 2. A second scan appends each edge to the file of its bucket in scratchDir.
+ * 3. One bucket at a time, its edges are read back and put in place by the
+ *    offsets of their sources, which is a counting sort that keeps the order
+ *    of the input, and are written to the output in one piece.
+ *
+ * So the input is scanned twice, and the edges are written to scratch and
+ * read back once, all sequentially. If every edge fits in one bucket, the
+ * second scan puts the edges in place without spilling them.
+ */
+void
+go_external(std::istream& input) {
+  try {
+    // 1. Degrees
+    std::vector<uint64_t> offsets(numNodes, 0);
+    uint64_t maxDst = 0;
+    uint64_t numEdges = 0;
+    bool sawData = false;
+    perEdge(
+        input,
+        [&](uint64_t src, uint64_t dst, dataTy) {
+          if (offsets.size() <= src)
+            offsets.resize(src + 1);
+          ++offsets[src];
+          maxDst = std::max(maxDst, dst);
+          ++numEdges;
+        },
+        [&offsets](uint64_t nodes, uint64_t) {
+          if (offsets.size() < nodes)
+            offsets.resize(nodes);
+        },
+        &sawData);
+    if (numEdges > 0 && offsets.size() <= maxDst)
+      offsets.resize(maxDst + 1);
+
+    const uint64_t nodes = offsets.size();
+    // Nodes are greater than 2^32 so need ver = 2.
+    const uint64_t ver = nodes >= 4294967296 ? 2 : 1;
+    const size_t dstSize = ver == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
+    const size_t dataSize =
+        !sawData ? 0 : (useSmallData ? sizeof(uint32_t) : sizeof(uint64_t));
+    const uint64_t dstStart = sizeof(uint64_t) * (4 + nodes);
+    // FileGraph skips a padding destination when the number of edges is odd
+    const uint64_t dataStart = dstStart + dstSize * (numEdges + numEdges % 2);
+    std::cout << "Nodes: " << nodes << " Edges: " << numEdges
+              << " Version: " << ver << "\n";
+
+    const uint64_t budget = memoryBudget * 1024 * 1024;
+    const uint64_t nodeBytes = nodes * sizeof(uint64_t);
+    if (budget <= nodeBytes)
+      throw "memoryBudget cannot hold the offsets of every node";
+    // leave a quarter of the rest for reading buckets back in
+    const uint64_t readBytes =
+        std::min<uint64_t>((budget - nodeBytes) / 4, 64 * 1024 * 1024);
+    const size_t readEdges =
+        std::max<size_t>(readBytes / sizeof(SpilledEdge), 1);
+    uint64_t capacity = std::max<uint64_t>(
+        (budget - nodeBytes - readBytes) / (dstSize + dataSize), 1);
+    if (maxBucketEdges > 0)
+      capacity = std::min<uint64_t>(capacity, maxBucketEdges);
+
+    int outFd = open(
+        outputFilename.c_str(), O_RDWR | O_CREAT | O_TRUNC,
+        S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (outFd < 0)
+      throw "Bad filename";
+    uint64_t header[4] = {ver, dataSize, nodes, numEdges};
+    writeAt(outFd, header, sizeof(header), 0);
+
+    // turn degrees into the offset of the first edge of each node, writing
+    // the offsets past the last edge as the out indices
+    std::vector<Bucket> buckets;
+    std::vector<uint64_t> outIdx;
+    outIdx.reserve(1024 * 1024);
+    uint64_t outIdxStart = sizeof(header);
+    uint64_t offset = 0;
+    for (uint64_t n = 0; n < nodes; ++n) {
+      uint64_t degree = offsets[n];
+      if (buckets.empty() || (buckets.back().numEdges > 0 &&
+                              buckets.back().numEdges + degree > capacity))
+        buckets.emplace_back(Bucket{n, n, offset, 0, -1, {}});
+      buckets.back().endNode = n + 1;
+      buckets.back().numEdges += degree;
+
+      offsets[n] = offset;
+      offset += degree;
+      outIdx.push_back(offset);
+      if (outIdx.size() == outIdx.capacity() || n + 1 == nodes) {
+        writeAt(
+            outFd, outIdx.data(), outIdx.size() * sizeof(uint64_t),
+            outIdxStart);
+        outIdxStart += outIdx.size() * sizeof(uint64_t);
+        outIdx.clear();
+      }
+    }
+    std::cout << "Buckets: " << buckets.size() << "\n";
+
+    // 2. Spill
+    input.clear();
+    input.seekg(0, std::ios_base::beg);
+    if (buckets.size() == 1) {
+      Bucket& bucket = buckets.front();
+      BucketEdges edges(bucket.numEdges, ver == 1, dataSize);
+      perEdge(
+          input,
+          [&](uint64_t src, uint64_t dst, dataTy data) {
+            edges.set(offsets[src]++, SpilledEdge{src, dst, data});
+          },
+          [](uint64_t, uint64_t) {});
+      edges.write(outFd, dstStart, dataStart);
+    } else if (buckets.size() > 1) {
+      const size_t bufferEdges = std::clamp<size_t>(
+          (budget - nodeBytes) / buckets.size() / sizeof(SpilledEdge), 1024,
+          1024 * 1024);
+      std::vector<uint64_t> bucketStarts;
+      for (size_t b = 0; b < buckets.size(); ++b) {
+        std::string path = scratchDir + "/graph-convert-huge-" +
+                           std::to_string(getpid()) + "-" + std::to_string(b);
+        buckets[b].fd =
+            open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        if (buckets[b].fd < 0)
+          throw "Could not create a bucket in scratchDir";
+        // the file goes away once closed, however this ends
+        unlink(path.c_str());
+        buckets[b].buffer.reserve(bufferEdges);
+        bucketStarts.push_back(buckets[b].firstNode);
+      }
+
+      perEdge(
+          input,
+          [&](uint64_t src, uint64_t dst, dataTy data) {
+            size_t b = std::upper_bound(
+                           bucketStarts.begin(), bucketStarts.end(), src) -
+                       bucketStarts.begin() - 1;
+            Bucket& bucket = buckets[b];
+            bucket.buffer.push_back(SpilledEdge{src, dst, data});
+            if (bucket.buffer.size() == bufferEdges) {
+              writeAll(
+                  bucket.fd, bucket.buffer.data(),
+                  bucket.buffer.size() * sizeof(SpilledEdge));
+              bucket.buffer.clear();
+            }
+          },
+          [](uint64_t, uint64_t) {});
+      for (Bucket& bucket : buckets) {
+        writeAll(
+            bucket.fd, bucket.buffer.data(),
+            bucket.buffer.size() * sizeof(SpilledEdge));
+        std::vector<SpilledEdge>().swap(bucket.buffer);
+      }
+
+      // 3. Sort
+      std::vector<SpilledEdge> readBuffer(readEdges);
+      for (Bucket& bucket : buckets) {
+        BucketEdges edges(bucket.numEdges, ver == 1, dataSize);
+        if (lseek(bucket.fd, 0, SEEK_SET) < 0)
+          throw "Failed to read";
+        size_t count;
+        while ((count = readAll(
+                    bucket.fd, readBuffer.data(),
+                    readBuffer.size() * sizeof(SpilledEdge)) /
+                        sizeof(SpilledEdge)) > 0) {
+          for (size_t i = 0; i < count; ++i) {
+            const SpilledEdge& edge = readBuffer[i];
+            edges.set(offsets[edge.src]++ - bucket.firstEdge, edge);
+          }
+        }
+        close(bucket.fd);
+        edges.write(
+            outFd, dstStart + dstSize * bucket.firstEdge,
+            dataStart + dataSize * bucket.firstEdge);
+      }
+    }
+
+    // make room for the padding and the data even if they are not written
+    if (ftruncate(outFd, dataStart + dataSize * numEdges) < 0)
+      throw "Failed to write";
+    close(outFd);
+  } catch (const char* c) {
+    std::cerr << "Failed with: " << c << "\n";
+    abort();
+  }
+}
+
 int
 main(int argc, char** argv) {
   llvm::cl::ParseCommandLineOptions(argc, argv);
@@ -247,7 +558,9 @@ main(int argc, char** argv) {
     return 1;
   }
 
-  if (numNodes > 0 && edgesSorted) {
+  if (externalMemory) {
+    go_external(infile);
+  } else if (numNodes > 0 && edgesSorted) {
     go_edgesSorted(infile, numNodes);
   } else {
     go(infile);
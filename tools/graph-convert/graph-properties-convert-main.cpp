@@ -3,6 +3,7 @@
 #include <llvm/Support/CommandLine.h>
 
 #include "Transforms.h"
+#include "graph-properties-convert-tables.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphML.h"
@@ -23,6 +24,14 @@ namespace cll = llvm::cl;
 
 namespace {
 
+enum class GraphTransform {
+  kTranspose,
+  kMakeSymmetric,
+  kSortEdges,
+  kCleanup,
+  kRemoveHighDegree,
+};
+
 cll::opt<std::string> input_filename(
     cll::Positional, cll::desc("<input file/directory>"), cll::Required);
 cll::opt<std::string> output_directory(
@@ -36,7 +45,13 @@ cll::opt<katana::SourceType> type(
             "source file is of type GraphML"),
         clEnumValN(
             katana::SourceType::kKatana, "katana",
-            "source file is of type Katana")),
+            "source file is of type Katana"),
+        clEnumValN(
+            katana::SourceType::kCsv, "csv",
+            "source file is a CSV table of edges"),
+        clEnumValN(
+            katana::SourceType::kParquet, "parquet",
+            "source file is a Parquet table of edges")),
     cll::init(katana::SourceType::kGraphml));
 cll::opt<katana::SourceDatabase> database(
     cll::desc("Database the data is from:"),
@@ -83,6 +98,65 @@ cll::opt<std::string> user(
     "user",
     cll::desc("Username for the target database if needed, default is root"),
     cll::init("root"));
+cll::opt<unsigned> cursors(
+    "cursors",
+    cll::desc("Number of concurrent cursors reading MongoDB or MySQL "
+              "databases, default is one per thread"),
+    cll::init(0));
+
+cll::opt<bool> streaming(
+    "streaming",
+    cll::desc("Convert GraphML files in batches staged to Parquet files, "
+              "without holding the whole input in memory"),
+    cll::init(false));
+cll::opt<std::string> staging_directory(
+    "staging-directory",
+    cll::desc("Local or remote directory for the files staged by streaming "
+              "conversions, default is the output directory"),
+    cll::init(""));
+
+cll::opt<std::string> nodes_filename(
+    "nodes",
+    cll::desc("Table of nodes for csv and parquet inputs, default is none, "
+              "in which case node IDs must be integers"),
+    cll::init(""));
+cll::opt<std::string> source_column(
+    "source-column",
+    cll::desc("Column of the edge table with the source IDs, default is src"),
+    cll::init("src"));
+cll::opt<std::string> destination_column(
+    "destination-column",
+    cll::desc("Column of the edge table with the destination IDs, default is "
+              "dst"),
+    cll::init("dst"));
+cll::opt<std::string> node_id_column(
+    "node-id-column",
+    cll::desc("Column of the node table with the node IDs, default is id"),
+    cll::init("id"));
+
+cll::list<GraphTransform> graph_transforms(
+    cll::desc("Transforms of the topology of katana inputs, applied in the "
+              "order given; edges and nodes keep their properties:"),
+    cll::values(
+        clEnumValN(
+            GraphTransform::kTranspose, "transpose", "reverse every edge"),
+        clEnumValN(
+            GraphTransform::kMakeSymmetric, "symmetric",
+            "add the reverse of every edge"),
+        clEnumValN(
+            GraphTransform::kSortEdges, "sort-edges",
+            "sort the out-edges of every node by destination"),
+        clEnumValN(
+            GraphTransform::kCleanup, "cleanup",
+            "sort edges and remove self-loops and duplicate edges"),
+        clEnumValN(
+            GraphTransform::kRemoveHighDegree, "remove-high-degree",
+            "remove the nodes with more than max-degree out-edges")));
+cll::opt<uint64_t> max_degree(
+    "max-degree",
+    cll::desc("Maximum out-degree of the nodes kept by remove-high-degree, "
+              "default is 2048"),
+    cll::init(2 * 1024));
 
 cll::opt<bool> export_graphml(
     "export",
@@ -131,15 +205,56 @@ ConvertKatana(const std::string& rdg_file) {
 
   ApplyTransforms(graph.get(), transformers);
 
+  std::vector<std::unique_ptr<katana::GraphTransformer>> graph_transformers;
+  for (GraphTransform t : graph_transforms) {
+    switch (t) {
+    case GraphTransform::kTranspose:
+      graph_transformers.emplace_back(std::make_unique<katana::Transpose>());
+      break;
+    case GraphTransform::kMakeSymmetric:
+      graph_transformers.emplace_back(
+          std::make_unique<katana::MakeSymmetric>());
+      break;
+    case GraphTransform::kSortEdges:
+      graph_transformers.emplace_back(std::make_unique<katana::SortEdges>());
+      break;
+    case GraphTransform::kCleanup:
+      graph_transformers.emplace_back(std::make_unique<katana::Cleanup>());
+      break;
+    case GraphTransform::kRemoveHighDegree:
+      graph_transformers.emplace_back(
+          std::make_unique<katana::RemoveHighDegree>(max_degree));
+      break;
+    }
+  }
+
+  auto transformed_res =
+      ApplyGraphTransforms(std::move(graph), graph_transformers);
+  if (!transformed_res) {
+    KATANA_LOG_FATAL(
+        "failed to transform {}: {}", rdg_file, transformed_res.error());
+  }
+  graph = std::move(transformed_res.value());
+
   return katana::PropertyGraph(std::move(*graph));
 }
 
+katana::Result<katana::GraphComponents>
+ConvertGraphMLInput() {
+  if (streaming) {
+    return katana::ConvertGraphMLStreaming(
+        input_filename,
+        staging_directory.empty() ? output_directory : staging_directory,
+        chunk_size, true);
+  }
+  return katana::ConvertGraphML(input_filename, chunk_size, true);
+}
+
 void
 ParseWild() {
   switch (type) {
   case katana::SourceType::kGraphml: {
-    auto components_result =
-        katana::ConvertGraphML(input_filename, chunk_size, true);
+    auto components_result = ConvertGraphMLInput();
     if (!components_result) {
       KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
     }
@@ -157,6 +272,24 @@ ParseWild() {
       KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
     }
     return;
+  case katana::SourceType::kCsv:
+  case katana::SourceType::kParquet: {
+    katana::TableColumns columns;
+    columns.source = source_column;
+    columns.destination = destination_column;
+    columns.node_id = node_id_column;
+    auto components_result = katana::ConvertTables(
+        type, input_filename, nodes_filename, columns);
+    if (!components_result) {
+      KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
+    }
+    if (auto r = katana::WritePropertyGraph(
+            components_result.value(), output_directory);
+        !r) {
+      KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
+    }
+    return;
+  }
   default:
     KATANA_LOG_ERROR("Unsupported input type {}", type);
   }
@@ -166,8 +299,7 @@ void
 ParseNeo4j() {
   switch (type) {
   case katana::SourceType::kGraphml: {
-    auto components_result =
-        katana::ConvertGraphML(input_filename, chunk_size, true);
+    auto components_result = ConvertGraphMLInput();
     if (!components_result) {
       KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
     }
@@ -190,7 +322,8 @@ ParseMongoDB() {
     katana::GenerateMappingMongoDB(input_filename, output_directory);
   } else {
     if (auto r = katana::WritePropertyGraph(
-            katana::ConvertMongoDB(input_filename, mapping, chunk_size),
+            katana::ConvertMongoDB(
+                input_filename, mapping, chunk_size, cursors),
             output_directory);
         !r) {
       KATANA_LOG_FATAL("Failed to write property graph: {}", r.error());
@@ -209,7 +342,7 @@ ParseMysql() {
   } else {
     if (auto r = katana::WritePropertyGraph(
             katana::ConvertMysql(
-                input_filename, mapping, chunk_size, host, user),
+                input_filename, mapping, chunk_size, host, user, cursors),
             output_directory);
         !r) {
       KATANA_LOG_FATAL("Failed to write property graph: {}", r.error());
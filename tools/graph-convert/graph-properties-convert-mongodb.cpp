@@ -18,6 +18,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "ParallelFetch.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphMLSchema.h"
@@ -34,6 +35,9 @@ using katana::PropertyKey;
 
 namespace {
 
+/// The number of documents fetched before they are handed to a builder
+constexpr size_t kDocumentsPerBatch = 4096;
+
 struct CollectionFields {
   std::map<std::string, PropertyKey> property_fields;
   std::set<std::string> embedded_nodes;
@@ -47,10 +51,36 @@ struct MongoClient {
   ~MongoClient() { mongoc_client_destroy(client); }
 };
 
+struct MongoClientPool {
+  mongoc_client_pool_t* pool;
+
+  MongoClientPool(mongoc_client_pool_t* pool_) : pool(pool_) {}
+  ~MongoClientPool() { mongoc_client_pool_destroy(pool); }
+};
+
 struct bson_value_t_wrapper {
   bson_value_t val;
 };
 
+struct BsonDeleter {
+  void operator()(bson_t* doc) const { bson_destroy(doc); }
+};
+
+using BsonPtr = std::unique_ptr<bson_t, BsonDeleter>;
+
+/// A query for all or part of the documents of a collection
+struct CollectionRange {
+  std::string collection;
+  bool for_edge;
+  std::shared_ptr<bson_t> filter;
+};
+
+/// A batch of the documents of one collection
+struct DocumentBatch {
+  const CollectionRange* range;
+  std::vector<BsonPtr> documents;
+};
+
 /******************************/
 /* Functions for parsing data */
 /******************************/
@@ -529,6 +559,27 @@ GetMongoClient(const char* uri_string) {
   return client;
 }
 
+// mongoc_init() should be called before this function
+mongoc_client_pool_t*
+GetMongoClientPool(const char* uri_string) {
+  bson_error_t error;
+  mongoc_uri_t* uri = mongoc_uri_new_with_error(uri_string, &error);
+  if (!uri) {
+    KATANA_LOG_FATAL(
+        "Failed to parse URI: {}\n"
+        "Error message: {}\n",
+        uri_string, error.message);
+  }
+  mongoc_client_pool_t* pool = mongoc_client_pool_new(uri);
+  if (!pool) {
+    KATANA_LOG_FATAL("Could not create a client pool for URI: {}", uri_string);
+  }
+  mongoc_client_pool_set_appname(pool, "graph-properties-convert");
+  mongoc_uri_destroy(uri);
+
+  return pool;
+}
+
 std::vector<std::string>
 GetCollectionNames(mongoc_database_t* database) {
   std::vector<std::string> coll_names;
@@ -545,29 +596,117 @@ GetCollectionNames(mongoc_database_t* database) {
   return coll_names;
 }
 
-template <typename T>
+std::shared_ptr<bson_t>
+MakeFilter(
+    const bson_value_t& first, const bson_value_t& last, bool last_inclusive) {
+  std::shared_ptr<bson_t> filter{bson_new(), BsonDeleter{}};
+  bson_t id_range;
+  BSON_APPEND_DOCUMENT_BEGIN(filter.get(), "_id", &id_range);
+  BSON_APPEND_VALUE(&id_range, "$gte", &first);
+  BSON_APPEND_VALUE(&id_range, last_inclusive ? "$lte" : "$lt", &last);
+  bson_append_document_end(filter.get(), &id_range);
+  return filter;
+}
+
+/// Split a collection into up to num_ranges ranges of _id of about the same
+/// number of documents, found by a $bucketAuto aggregation, so that several
+/// cursors can read it at once. A collection that cannot be split is read
+/// whole.
 void
-QueryEntireCollection(
-    mongoc_database_t* database, const bson_t** document,
-    const std::string& coll_name, T document_op) {
-  bson_error_t error;
+PartitionCollection(
+    mongoc_database_t* database, const std::string& coll_name, bool for_edge,
+    size_t num_ranges, std::vector<CollectionRange>* ranges) {
   auto collection = mongoc_database_get_collection(database, coll_name.c_str());
-  bson_t filter;
-  bson_init(&filter);
-  auto cursor =
-      mongoc_collection_find_with_opts(collection, &filter, nullptr, nullptr);
+  bson_t* pipeline = BCON_NEW(
+      "pipeline", "[", "{", "$bucketAuto", "{", "groupBy", BCON_UTF8("$_id"),
+      "buckets", BCON_INT32(static_cast<int32_t>(num_ranges)), "}", "}", "]");
+  // the aggregation sorts every _id, which may not fit in server memory
+  bson_t* opts = BCON_NEW("allowDiskUse", BCON_BOOL(true));
+  auto cursor = mongoc_collection_aggregate(
+      collection, MONGOC_QUERY_NONE, pipeline, opts, nullptr);
+  bson_destroy(opts);
+  bson_destroy(pipeline);
+
+  // each bucket holds the _ids from its min up to, but excluding, its max,
+  // except the last, which also holds its max
+  std::vector<std::pair<bson_value_t, bson_value_t>> buckets;
+  const bson_t* doc;
+  while (mongoc_cursor_next(cursor, &doc)) {
+    bson_iter_t iter;
+    bson_iter_t min_iter;
+    bson_iter_t max_iter;
+    if (bson_iter_init(&iter, doc) &&
+        bson_iter_find_descendant(&iter, "_id.min", &min_iter) &&
+        bson_iter_init(&iter, doc) &&
+        bson_iter_find_descendant(&iter, "_id.max", &max_iter)) {
+      auto& bucket = buckets.emplace_back();
+      bson_value_copy(bson_iter_value(&min_iter), &bucket.first);
+      bson_value_copy(bson_iter_value(&max_iter), &bucket.second);
+    }
+  }
+  bson_error_t error;
+  if (mongoc_cursor_error(cursor, &error)) {
+    KATANA_LOG_WARN(
+        "Could not split collection {}, reading it whole: {}", coll_name,
+        error.message);
+    for (auto& bucket : buckets) {
+      bson_value_destroy(&bucket.first);
+      bson_value_destroy(&bucket.second);
+    }
+    buckets.clear();
+  }
+  mongoc_cursor_destroy(cursor);
+  mongoc_collection_destroy(collection);
+
+  if (buckets.empty()) {
+    std::shared_ptr<bson_t> everything{bson_new(), BsonDeleter{}};
+    ranges->emplace_back(CollectionRange{coll_name, for_edge, everything});
+    return;
+  }
+  for (size_t i = 0; i < buckets.size(); i++) {
+    ranges->emplace_back(CollectionRange{
+        coll_name, for_edge,
+        MakeFilter(
+            buckets[i].first, buckets[i].second, i + 1 == buckets.size())});
+    bson_value_destroy(&buckets[i].first);
+    bson_value_destroy(&buckets[i].second);
+  }
+}
 
-  while (mongoc_cursor_next(cursor, document)) {
-    document_op();
+/// Read the documents of range with a client of pool, calling emit for each
+/// batch of documents
+template <typename EmitFn>
+void
+FetchDocuments(
+    mongoc_client_pool_t* pool, const std::string& db_name,
+    const CollectionRange& range, EmitFn emit) {
+  mongoc_client_t* client = mongoc_client_pool_pop(pool);
+  auto collection = mongoc_client_get_collection(
+      client, db_name.c_str(), range.collection.c_str());
+  auto cursor = mongoc_collection_find_with_opts(
+      collection, range.filter.get(), nullptr, nullptr);
+
+  DocumentBatch batch{&range, {}};
+  const bson_t* doc;
+  while (mongoc_cursor_next(cursor, &doc)) {
+    batch.documents.emplace_back(bson_copy(doc));
+    if (batch.documents.size() == kDocumentsPerBatch) {
+      emit(std::move(batch));
+      batch = DocumentBatch{&range, {}};
+    }
   }
+  bson_error_t error;
   if (mongoc_cursor_error(cursor, &error)) {
     KATANA_LOG_ERROR(
         "An error occurred with a mongodb cursor: {}", error.message);
   }
+  if (!batch.documents.empty()) {
+    emit(std::move(batch));
+  }
 
-  bson_destroy(&filter);
   mongoc_cursor_destroy(cursor);
   mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(pool, client);
 }
 
 /***************************************/
@@ -1003,6 +1142,44 @@ GetUserInput(
       std::move(nodes), std::move(edges));
 }
 
+/// Add the labels and properties of a schema mapping to every shard of
+/// builder, returning the node and edge collections it names
+std::pair<std::vector<std::string>, std::vector<std::string>>
+ApplySchemaMapping(
+    katana::ShardedPropertyGraphBuilder* builder, const std::string& mapping,
+    const std::vector<std::string>& coll_names) {
+  auto [rules, keys] = katana::graphml::ProcessSchemaMapping(mapping);
+
+  std::vector<std::string> nodes;
+  std::vector<std::string> edges;
+  for (const LabelRule& rule : rules) {
+    if (std::find(coll_names.begin(), coll_names.end(), rule.id) ==
+        coll_names.end()) {
+      continue;
+    }
+    if (rule.for_node) {
+      nodes.emplace_back(rule.id);
+    } else if (rule.for_edge) {
+      edges.emplace_back(rule.id);
+    }
+  }
+
+  for (size_t i = 0; i < builder->num_shards(); i++) {
+    for (const LabelRule& rule : rules) {
+      if (rule.for_node || rule.for_edge) {
+        builder->shard(i)->AddLabelBuilder(rule);
+      }
+    }
+    for (const PropertyKey& key : keys) {
+      if (key.for_node || key.for_edge) {
+        builder->shard(i)->AddBuilder(key);
+      }
+    }
+  }
+  return std::pair<std::vector<std::string>, std::vector<std::string>>(
+      std::move(nodes), std::move(edges));
+}
+
 }  // end of unnamed namespace
 
 // for now only handle arrays and data all of same type
@@ -1112,46 +1289,67 @@ katana::GenerateMappingMongoDB(
 
 katana::GraphComponents
 katana::ConvertMongoDB(
-    const std::string& db_name, const std::string& mapping, size_t chunk_size) {
+    const std::string& db_name, const std::string& mapping, size_t chunk_size,
+    unsigned num_cursors) {
   const char* uri_string = "mongodb://localhost:27017";
-  const bson_t* document = nullptr;
 
-  katana::PropertyGraphBuilder builder{chunk_size};
   katana::setActiveThreads(1000);
+  katana::ShardedPropertyGraphBuilder builder{
+      chunk_size, katana::getActiveThreads()};
+  if (num_cursors == 0 || num_cursors > katana::getActiveThreads()) {
+    num_cursors = katana::getActiveThreads();
+  }
 
   mongoc_init();
-  MongoClient client_wrapper{GetMongoClient(uri_string)};
-  mongoc_database_t* database =
-      mongoc_client_get_database(client_wrapper.client, db_name.c_str());
-  std::vector<std::string> coll_names = GetCollectionNames(database);
+  MongoClientPool pool_wrapper{GetMongoClientPool(uri_string)};
+  std::vector<CollectionRange> ranges;
+  {
+    mongoc_client_t* client = mongoc_client_pool_pop(pool_wrapper.pool);
+    mongoc_database_t* database =
+        mongoc_client_get_database(client, db_name.c_str());
+    std::vector<std::string> coll_names = GetCollectionNames(database);
+
+    // get input on node/edge mappings, label names, property names and
+    // values
+    std::vector<std::string> nodes;
+    std::vector<std::string> edges;
+    if (!mapping.empty()) {
+      auto res = ApplySchemaMapping(&builder, mapping, coll_names);
+      nodes = res.first;
+      edges = res.second;
+    } else {
+      auto res = GetUserInput(database, coll_names);
+      nodes = res.first;
+      edges = res.second;
+    }
 
-  // get input on node/edge mappings, label names, property names and
-  // values
-  std::vector<std::string> nodes;
-  std::vector<std::string> edges;
-  if (!mapping.empty()) {
-    auto res =
-        katana::graphml::ProcessSchemaMapping(&builder, mapping, coll_names);
-    nodes = res.first;
-    edges = res.second;
-  } else {
-    auto res = GetUserInput(database, coll_names);
-    nodes = res.first;
-    edges = res.second;
+    for (const auto& coll_name : edges) {
+      PartitionCollection(database, coll_name, true, 4 * num_cursors, &ranges);
+    }
+    for (const auto& coll_name : nodes) {
+      PartitionCollection(database, coll_name, false, 4 * num_cursors, &ranges);
+    }
+    mongoc_database_destroy(database);
+    mongoc_client_pool_push(pool_wrapper.pool, client);
   }
 
-  // add all edges first
-  for (auto coll_name : edges) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
-    });
-  }
-  // then add all nodes
-  for (auto coll_name : nodes) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleNodeDocumentMongoDB(&builder, document, coll_name);
-    });
-  }
+  katana::FetchInParallel<DocumentBatch>(
+      ranges, num_cursors, 2 * katana::getActiveThreads(),
+      [&](const CollectionRange& range, unsigned, auto emit) {
+        FetchDocuments(pool_wrapper.pool, db_name, range, emit);
+      },
+      [&](DocumentBatch&& batch, unsigned tid) {
+        const CollectionRange& range = *batch.range;
+        for (const BsonPtr& document : batch.documents) {
+          if (range.for_edge) {
+            katana::HandleEdgeDocumentMongoDB(
+                builder.shard(tid), document.get(), range.collection);
+          } else {
+            katana::HandleNodeDocumentMongoDB(
+                builder.shard(tid), document.get(), range.collection);
+          }
+        }
+      });
 
   mongoc_cleanup();
   if (auto r = builder.Finish(); !r) {
@@ -15,9 +15,14 @@ void HandleEdgeDocumentMongoDB(
     PropertyGraphBuilder*, const bson_t* doc,
     const std::string& collection_name);
 
+/// Convert the collections of a MongoDB database to a graph. Collections are
+/// split into ranges of _id; up to num_cursors ranges are read at once while
+/// every thread adds the documents read so far to its shard of a
+/// ShardedPropertyGraphBuilder. If num_cursors is 0 there is a cursor per
+/// thread.
 GraphComponents ConvertMongoDB(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size);
+    const size_t chunk_size, unsigned num_cursors = 0);
 void GenerateMappingMongoDB(
     const std::string& db_name, const std::string& outfile);
 
@@ -21,6 +21,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "ParallelFetch.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphMLSchema.h"
@@ -37,6 +38,9 @@ using katana::PropertyKey;
 
 namespace {
 
+/// The number of rows fetched before they are handed to a builder
+constexpr size_t kRowsPerBatch = 4096;
+
 struct MysqlRes {
   MYSQL_RES* res;
 
@@ -63,10 +67,26 @@ struct Relationship {
         target_field(std::move(target_field_)) {}
 };
 
+bool
+IsIntegerType(enum_field_types type) {
+  switch (type) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    return true;
+  default:
+    return false;
+  }
+}
+
 struct TableData {
   std::string name;
   bool is_node;
   int64_t primary_key_index;
+  // the integer primary key by which the table can be read in ranges, if any
+  std::string range_key;
   std::vector<Relationship> out_references;
   std::vector<Relationship> in_references;
   std::vector<std::string> field_names;
@@ -77,12 +97,23 @@ struct TableData {
       : name(std::move(name_)),
         is_node(true),
         primary_key_index(-1),
+        range_key(),
         out_references(std::vector<Relationship>{}),
         in_references(std::vector<Relationship>{}),
         field_names(std::vector<std::string>{}),
         field_indexes(std::vector<size_t>{}),
         ignore_list(std::unordered_set<std::string>{}) {}
 
+  void SetPrimaryKey(MYSQL_FIELD* field, size_t field_index) {
+    // a key of several columns is not split into ranges
+    if (primary_key_index < 0 && IsIntegerType(field->type)) {
+      range_key = std::string{field->name, field->name_length};
+    } else {
+      range_key.clear();
+    }
+    primary_key_index = static_cast<int64_t>(field_index);
+  }
+
   void ResolveOutgoingKeys(const std::string& field, size_t field_index) {
     for (auto& relation : this->out_references) {
       if (relation.source_field == field) {
@@ -220,6 +251,21 @@ GenerateFetchTableQuery(const std::string& table) {
   return std::string{"SELECT * FROM " + table + ";"};
 }
 
+std::string
+GenerateFetchKeyBoundsQuery(const std::string& table, const std::string& key) {
+  return std::string{
+      "SELECT MIN(" + key + "), MAX(" + key + ") FROM " + table + ";"};
+}
+
+std::string
+GenerateFetchTableRangeQuery(
+    const std::string& table, const std::string& key, int64_t first,
+    int64_t last) {
+  return std::string{
+      "SELECT * FROM " + table + " WHERE " + key + " BETWEEN " +
+      std::to_string(first) + " AND " + std::to_string(last) + ";"};
+}
+
 std::vector<std::string>
 FetchTableNames(MYSQL* con) {
   std::vector<std::string> table_names;
@@ -248,6 +294,23 @@ std::vector<std::string> FetchFieldNames(MysqlRes* table) {
   return field_names;
 }*/
 
+MYSQL*
+Connect(
+    const std::string& db_name, const std::string& host,
+    const std::string& user, const std::string& password) {
+  MYSQL* con = mysql_init(NULL);
+  if (con == nullptr) {
+    KATANA_LOG_FATAL("mysql_init() failed");
+  }
+  if (mysql_real_connect(
+          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
+          NULL, 0) == NULL) {
+    KATANA_LOG_FATAL(
+        "Could not establish mysql connection: {}", mysql_error(con));
+  }
+  return con;
+}
+
 MysqlRes
 RunQuery(MYSQL* con, const std::string& query) {
   if (mysql_real_query(con, query.c_str(), query.size())) {
@@ -257,105 +320,210 @@ RunQuery(MYSQL* con, const std::string& query) {
 }
 
 void
-AddNodeTable(
-    katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
-  MYSQL_ROW row;
+ExhaustResultSet(MysqlRes* res) {
+  while (mysql_fetch_row(res->res))
+    ;
+}
 
-  while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
+/// The values of a row, or nullopt for the null ones
+using Row = std::vector<std::optional<std::string>>;
 
-    builder->StartNode();
-    builder->AddLabel(table_data.name);
-
-    // if table has a primary key, add it as node's ID
-    auto primary_index = table_data.primary_key_index;
-    if (primary_index >= 0) {
-      std::string primary_key{row[primary_index], lengths[primary_index]};
-      builder->AddNodeId(table_data.name + primary_key);
-    }
-
-    // add data fields
-    for (size_t i = 0; i < table_data.field_names.size(); i++) {
-      auto index = table_data.field_indexes[i];
-      // if the data is null then do not add it
-      if (row[index] != NULL) {
-        std::string value{row[index], lengths[index]};
-
-        builder->AddValue(
-            table_data.field_names[i],
-            []() {
-              return PropertyKey{
-                  "invalid", ImportDataType::kUnsupported, false};
-            },
-            [&value](ImportDataType type, bool is_list) {
-              return ResolveValue(value, type, is_list);
-            });
-      }
+/// A batch of the rows of one table
+struct RowBatch {
+  const TableData* table;
+  std::vector<Row> rows;
+};
+
+/// A query for all or part of the rows of a table
+struct TableRange {
+  const TableData* table;
+  std::string query;
+};
+
+void
+AddNodeRow(
+    katana::PropertyGraphBuilder* builder, const TableData& table_data,
+    const Row& row) {
+  builder->StartNode();
+  builder->AddLabel(table_data.name);
+
+  // if table has a primary key, add it as node's ID
+  auto primary_index = table_data.primary_key_index;
+  if (primary_index >= 0) {
+    std::string primary_key = row[primary_index].value_or(std::string{});
+    builder->AddNodeId(table_data.name + primary_key);
+  }
+
+  // add data fields
+  for (size_t i = 0; i < table_data.field_names.size(); i++) {
+    auto index = table_data.field_indexes[i];
+    // if the data is null then do not add it
+    if (row[index]) {
+      const std::string& value = *row[index];
+
+      builder->AddValue(
+          table_data.field_names[i],
+          []() {
+            return PropertyKey{"invalid", ImportDataType::kUnsupported, false};
+          },
+          [&value](ImportDataType type, bool is_list) {
+            return ResolveValue(value, type, is_list);
+          });
     }
+  }
 
-    // if table has outgoing edges, add them
-    for (auto relation : table_data.out_references) {
-      auto foreign_index = relation.source_index;
-      // if the target is null then do not add an edge
-      if (row[foreign_index] != NULL) {
-        std::string foreign_key{row[foreign_index], lengths[foreign_index]};
-        std::string edge_id = relation.target_table + foreign_key;
-        builder->AddOutgoingEdge(edge_id, relation.label);
-      }
+  // if table has outgoing edges, add them
+  for (auto relation : table_data.out_references) {
+    auto foreign_index = relation.source_index;
+    // if the target is null then do not add an edge
+    if (row[foreign_index]) {
+      std::string edge_id = relation.target_table + *row[foreign_index];
+      builder->AddOutgoingEdge(edge_id, relation.label);
+    }
+  }
+  builder->FinishNode();
+}
+
+void
+AddEdgeRow(
+    katana::PropertyGraphBuilder* builder, const TableData& table_data,
+    const Row& row) {
+  builder->StartEdge();
+  builder->AddLabel(table_data.name);
+
+  bool adding_source = true;
+  // if the source or target is null then add a placeholder node
+  for (auto relation : table_data.out_references) {
+    auto foreign_index = relation.source_index;
+    std::string foreign_key = row[foreign_index].value_or(std::string{});
+    std::string edge_id = relation.target_table + foreign_key;
+    if (adding_source) {
+      builder->AddEdgeSource(edge_id);
+      adding_source = false;
+    } else {
+      builder->AddEdgeTarget(edge_id);
+    }
+  }
+
+  // add data fields
+  for (size_t i = 0; i < table_data.field_names.size(); i++) {
+    auto index = table_data.field_indexes[i];
+    // if the data is null then do not add it
+    if (row[index]) {
+      const std::string& value = *row[index];
+
+      builder->AddValue(
+          table_data.field_names[i],
+          []() {
+            return PropertyKey{"invalid", ImportDataType::kUnsupported, false};
+          },
+          [&value](ImportDataType type, bool is_list) {
+            return ResolveValue(value, type, is_list);
+          });
     }
-    builder->FinishNode();
   }
+  builder->FinishEdge();
 }
 
 void
-AddEdgeTable(
-    katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
+AddRows(katana::PropertyGraphBuilder* builder, const RowBatch& batch) {
+  for (const Row& row : batch.rows) {
+    if (batch.table->is_node) {
+      AddNodeRow(builder, *batch.table, row);
+    } else {
+      AddEdgeRow(builder, *batch.table, row);
+    }
+  }
+}
+
+/// Read the rows of range through con, calling emit for each batch of rows
+template <typename EmitFn>
+void
+FetchRows(MYSQL* con, const TableRange& range, EmitFn emit) {
+  MysqlRes table = RunQuery(con, range.query);
+  auto num_fields = mysql_num_fields(table.res);
+  RowBatch batch{range.table, {}};
   MYSQL_ROW row;
 
   while ((row = mysql_fetch_row(table.res))) {
     auto lengths = mysql_fetch_lengths(table.res);
-
-    builder->StartEdge();
-    builder->AddLabel(table_data.name);
-
-    bool adding_source = true;
-    // if the source or target is null then add a placeholder node
-    for (auto relation : table_data.out_references) {
-      auto foreign_index = relation.source_index;
-      std::string foreign_key{row[foreign_index], lengths[foreign_index]};
-      std::string edge_id = relation.target_table + foreign_key;
-      if (adding_source) {
-        builder->AddEdgeSource(edge_id);
-        adding_source = false;
-      } else {
-        builder->AddEdgeTarget(edge_id);
+    Row& values = batch.rows.emplace_back(num_fields);
+    for (size_t i = 0; i < num_fields; i++) {
+      if (row[i] != NULL) {
+        values[i].emplace(row[i], lengths[i]);
       }
     }
+    if (batch.rows.size() == kRowsPerBatch) {
+      emit(std::move(batch));
+      batch = RowBatch{range.table, {}};
+    }
+  }
+  if (mysql_errno(con)) {
+    KATANA_LOG_FATAL(
+        "Could not fetch rows of {}: {}", range.table->name, mysql_error(con));
+  }
+  if (!batch.rows.empty()) {
+    emit(std::move(batch));
+  }
+}
+
+/// The smallest and largest value of the range key of a table, or nullopt if
+/// the table is empty or its keys do not fit in an int64_t
+std::optional<std::pair<int64_t, int64_t>>
+FetchKeyBounds(MYSQL* con, const TableData& table_data) {
+  MysqlRes bounds = RunQuery(
+      con, GenerateFetchKeyBoundsQuery(table_data.name, table_data.range_key));
+  MYSQL_ROW row = mysql_fetch_row(bounds.res);
+  std::optional<std::pair<int64_t, int64_t>> result;
+  if (row != NULL && row[0] != NULL && row[1] != NULL) {
+    try {
+      result.emplace(
+          boost::lexical_cast<int64_t>(row[0]),
+          boost::lexical_cast<int64_t>(row[1]));
+    } catch (const boost::bad_lexical_cast&) {
+      result.reset();
+    }
+  }
+  ExhaustResultSet(&bounds);
+  return result;
+}
 
-    // add data fields
-    for (size_t i = 0; i < table_data.field_names.size(); i++) {
-      auto index = table_data.field_indexes[i];
-      // if the data is null then do not add it
-      if (row[index] != NULL) {
-        std::string value{row[index], lengths[index]};
-
-        builder->AddValue(
-            table_data.field_names[i],
-            []() {
-              return PropertyKey{
-                  "invalid", ImportDataType::kUnsupported, false};
-            },
-            [&value](ImportDataType type, bool is_list) {
-              return ResolveValue(value, type, is_list);
-            });
+/// Split each table into up to num_ranges ranges of its integer primary key,
+/// so that several cursors can read it at once. Tables without one are read
+/// whole.
+std::vector<TableRange>
+PartitionTables(
+    MYSQL* con, const std::unordered_map<std::string, TableData>& table_data,
+    size_t num_ranges) {
+  std::vector<TableRange> ranges;
+  for (const auto& [name, data] : table_data) {
+    std::optional<std::pair<int64_t, int64_t>> bounds;
+    if (!data.range_key.empty()) {
+      bounds = FetchKeyBounds(con, data);
+    }
+    if (!bounds) {
+      ranges.emplace_back(TableRange{&data, GenerateFetchTableQuery(name)});
+      continue;
+    }
+    auto [first, last] = bounds.value();
+    // the span of keys may not fit in an int64_t, but it fits in a uint64_t
+    uint64_t span = static_cast<uint64_t>(last) - static_cast<uint64_t>(first);
+    uint64_t step = span / num_ranges + 1;
+    for (uint64_t offset = 0;; offset += step) {
+      uint64_t range_span = std::min(step - 1, span - offset);
+      int64_t range_first =
+          static_cast<int64_t>(static_cast<uint64_t>(first) + offset);
+      int64_t range_last = static_cast<int64_t>(
+          static_cast<uint64_t>(range_first) + range_span);
+      ranges.emplace_back(TableRange{
+          &data, GenerateFetchTableRangeQuery(
+                     name, data.range_key, range_first, range_last)});
+      if (span - offset < step) {
+        break;
       }
     }
-    builder->FinishEdge();
   }
+  return ranges;
 }
 
 /************************************/
@@ -500,12 +668,6 @@ GetUserInputForFields(
 /* Functions for preprocessing MySQL databases */
 /***********************************************/
 
-void
-ExhaustResultSet(MysqlRes* res) {
-  while (mysql_fetch_row(res->res))
-    ;
-}
-
 bool
 ContainsRelation(
     const std::vector<LabelRule>& rules, const std::string& label) {
@@ -641,7 +803,7 @@ PreprocessFields(
 
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
-      table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.SetPrimaryKey(field, index);
     } else if (
         table_iter->second.ignore_list.find(key.id) ==
         table_iter->second.ignore_list.end()) {
@@ -674,7 +836,7 @@ PreprocessFields(
 
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
-      table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.SetPrimaryKey(field, index);
     } else if (
         table_iter->second.ignore_list.find(key.id) !=
         table_iter->second.ignore_list.end()) {
@@ -690,9 +852,24 @@ PreprocessFields(
   }
 }
 
+/// Add the label and property builders to every shard of builder
+void
+AddBuilders(
+    katana::ShardedPropertyGraphBuilder* builder,
+    const std::vector<LabelRule>& rules, const std::vector<PropertyKey>& keys) {
+  for (size_t i = 0; i < builder->num_shards(); i++) {
+    for (auto rule : rules) {
+      builder->shard(i)->AddLabelBuilder(rule);
+    }
+    for (auto key : keys) {
+      builder->shard(i)->AddBuilder(key);
+    }
+  }
+}
+
 std::unordered_map<std::string, TableData>
 PreprocessTables(
-    MYSQL* con, katana::PropertyGraphBuilder* builder,
+    MYSQL* con, katana::ShardedPropertyGraphBuilder* builder,
     const std::vector<std::string>& table_names) {
   std::unordered_map<std::string, TableData> table_data;
   std::map<std::string, PropertyKey> node_fields;
@@ -717,22 +894,24 @@ PreprocessTables(
     }
     ExhaustResultSet(&table_row);
   }
+  std::vector<LabelRule> rules;
   for (auto [name, data] : table_data) {
-    LabelRule rule{name, data.is_node, !data.is_node, name};
-    builder->AddLabelBuilder(rule);
+    rules.emplace_back(name, data.is_node, !data.is_node, name);
   }
+  std::vector<PropertyKey> keys;
   for (auto iter : node_fields) {
-    builder->AddBuilder(iter.second);
+    keys.emplace_back(iter.second);
   }
   for (auto iter : edge_fields) {
-    builder->AddBuilder(iter.second);
+    keys.emplace_back(iter.second);
   }
+  AddBuilders(builder, rules, keys);
   return table_data;
 }
 
 std::unordered_map<std::string, TableData>
 PreprocessTables(
-    MYSQL* con, katana::PropertyGraphBuilder* builder,
+    MYSQL* con, katana::ShardedPropertyGraphBuilder* builder,
     const std::vector<std::string>& table_names,
     const std::vector<LabelRule>& rules, const std::vector<PropertyKey>& keys) {
   std::unordered_map<std::string, TableData> table_data;
@@ -755,12 +934,7 @@ PreprocessTables(
     }
     ExhaustResultSet(&table_row);
   }
-  for (auto rule : rules) {
-    builder->AddLabelBuilder(rule);
-  }
-  for (auto key : keys) {
-    builder->AddBuilder(key);
-  }
+  AddBuilders(builder, rules, keys);
   return table_data;
 }
 
@@ -859,20 +1033,16 @@ GetMappingInput(
 GraphComponents
 katana::ConvertMysql(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user) {
-  katana::PropertyGraphBuilder builder{chunk_size};
+    const size_t chunk_size, const std::string& host, const std::string& user,
+    unsigned num_cursors) {
+  katana::ShardedPropertyGraphBuilder builder{
+      chunk_size, katana::getActiveThreads()};
   std::string password{getpass("MySQL Password: ")};
-
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    KATANA_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    KATANA_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
+  if (num_cursors == 0 || num_cursors > katana::getActiveThreads()) {
+    num_cursors = katana::getActiveThreads();
   }
+
+  MYSQL* con = Connect(db_name, host, user, password);
   std::vector<std::string> table_names = FetchTableNames(con);
   std::unordered_map<std::string, TableData> table_data;
   if (!mapping.empty()) {
@@ -884,14 +1054,27 @@ katana::ConvertMysql(
     table_data = PreprocessTables(con, &builder, table_names);
   }
 
-  for (auto table : table_data) {
-    if (table.second.is_node) {
-      AddNodeTable(&builder, con, table.second);
-    } else {
-      AddEdgeTable(&builder, con, table.second);
-    }
+  // a connection cannot be shared between threads, so each cursor has its own
+  std::vector<TableRange> ranges =
+      PartitionTables(con, table_data, 4 * num_cursors);
+  std::vector<MYSQL*> cursor_cons{con};
+  for (size_t i = 1; i < std::min<size_t>(num_cursors, ranges.size()); i++) {
+    cursor_cons.emplace_back(Connect(db_name, host, user, password));
+  }
+
+  katana::FetchInParallel<RowBatch>(
+      ranges, cursor_cons.size(), 2 * katana::getActiveThreads(),
+      [&](const TableRange& range, unsigned cursor, auto emit) {
+        // the client library keeps state for each thread that uses it
+        mysql_thread_init();
+        FetchRows(cursor_cons[cursor], range, emit);
+      },
+      [&](RowBatch&& batch, unsigned tid) {
+        AddRows(builder.shard(tid), batch);
+      });
+  for (MYSQL* cursor_con : cursor_cons) {
+    mysql_close(cursor_con);
   }
-  mysql_close(con);
   auto out_result = builder.Finish();
   if (!out_result) {
     KATANA_LOG_FATAL("Failed to construct graph: {}", out_result.error());
@@ -907,16 +1090,7 @@ katana::GenerateMappingMysql(
     const std::string& host, const std::string& user) {
   std::string password{getpass("MySQL Password: ")};
 
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    KATANA_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    KATANA_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
-  }
+  MYSQL* con = Connect(db_name, host, user, password);
   std::vector<std::string> table_names = FetchTableNames(con);
 
   // get user input on node/edge mappings, label names, property names and
@@ -5,9 +5,15 @@
 
 namespace katana {
 
+/// Convert the tables of a MySQL database to a graph. Tables with an integer
+/// primary key are read in ranges of the key; up to num_cursors ranges, each
+/// through its own connection, are read at once while every thread adds the
+/// rows read so far to its shard of a ShardedPropertyGraphBuilder. If
+/// num_cursors is 0 there is a cursor per thread.
 GraphComponents ConvertMysql(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user);
+    const size_t chunk_size, const std::string& host, const std::string& user,
+    unsigned num_cursors = 0);
 void GenerateMappingMysql(
     const std::string& db_name, const std::string& outfile,
     const std::string& host, const std::string& user);
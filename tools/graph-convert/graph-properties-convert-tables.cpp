@@ -0,0 +1,597 @@
+#include "graph-properties-convert-tables.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <arrow/csv/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "katana/Uri.h"
+#include "tsuba/FileView.h"
+#include "tsuba/ParquetReader.h"
+
+using katana::GraphComponent;
+using katana::GraphComponents;
+
+namespace {
+
+/*******************************/
+/* Functions for reading files */
+/*******************************/
+
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadCsvTable(const std::string& filename) {
+  auto file = std::make_shared<tsuba::FileView>();
+  if (auto res = file->Bind(filename, false); !res) {
+    return res.error().WithContext("opening {}", filename);
+  }
+
+  auto read_options = arrow::csv::ReadOptions::Defaults();
+  read_options.use_threads = true;
+  auto reader_res = arrow::csv::TableReader::Make(
+      arrow::default_memory_pool(), file, read_options,
+      arrow::csv::ParseOptions::Defaults(),
+      arrow::csv::ConvertOptions::Defaults());
+  if (!reader_res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(reader_res.status()), "reading {}: {}",
+        filename, reader_res.status());
+  }
+  auto table_res = reader_res.ValueOrDie()->Read();
+  if (!table_res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(table_res.status()), "reading {}: {}",
+        filename, table_res.status());
+  }
+  return table_res.ValueOrDie();
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadParquetTable(const std::string& filename) {
+  auto uri_res = katana::Uri::Make(filename);
+  if (!uri_res) {
+    return uri_res.error();
+  }
+  auto reader_res = tsuba::ParquetReader::Make();
+  if (!reader_res) {
+    return reader_res.error();
+  }
+  return reader_res.value()->ReadTable(uri_res.value());
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadTable(katana::SourceType type, const std::string& filename) {
+  switch (type) {
+  case katana::SourceType::kCsv:
+    return ReadCsvTable(filename);
+  case katana::SourceType::kParquet:
+    return ReadParquetTable(filename);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "tables must be in csv or parquet files");
+  }
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+GetColumn(
+    const std::shared_ptr<arrow::Table>& table, const std::string& name,
+    const std::string& filename) {
+  auto column = table->GetColumnByName(name);
+  if (!column) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "{} has no column {}", filename,
+        name);
+  }
+  return column;
+}
+
+/*************************************/
+/* Functions for resolving node IDs */
+/*************************************/
+
+/// Whether the IDs of a column are integers or strings
+enum class IdKind { kInteger, kString };
+
+katana::Result<IdKind>
+KindOf(const arrow::ChunkedArray& ids, const std::string& name) {
+  auto type_id = ids.type()->id();
+  if (arrow::is_integer(type_id)) {
+    return IdKind::kInteger;
+  }
+  if (type_id == arrow::Type::STRING || type_id == arrow::Type::LARGE_STRING) {
+    return IdKind::kString;
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::TypeError,
+      "IDs in column {} must be integers or strings, not {}", name,
+      ids.type()->ToString());
+}
+
+/// Integer IDs as int64, so that they can be read without a switch over
+/// every integer type
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+NormalizeIds(const std::shared_ptr<arrow::ChunkedArray>& ids, IdKind kind) {
+  if (kind == IdKind::kString || ids->type()->id() == arrow::Type::INT64) {
+    return ids;
+  }
+  auto cast_res = arrow::compute::Cast(arrow::Datum(ids), arrow::int64());
+  if (!cast_res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(cast_res.status()), "casting IDs: {}",
+        cast_res.status());
+  }
+  return cast_res.ValueOrDie().chunked_array();
+}
+
+/// Call fn(i, id) for each element i of chunk, a chunk of a column returned
+/// by NormalizeIds, with id an int64_t or a std::string_view. Returns the
+/// first null element, or -1 if there is none.
+template <typename Fn>
+int64_t
+VisitIds(const arrow::Array& chunk, Fn fn) {
+  auto visit = [&](const auto& array) -> int64_t {
+    for (int64_t i = 0; i < array.length(); ++i) {
+      if (array.IsNull(i)) {
+        return i;
+      }
+      auto id = array.GetView(i);
+      if constexpr (std::is_same_v<decltype(id), int64_t>) {
+        fn(i, id);
+      } else {
+        fn(i, std::string_view(id.data(), id.size()));
+      }
+    }
+    return -1;
+  };
+  switch (chunk.type_id()) {
+  case arrow::Type::INT64:
+    return visit(static_cast<const arrow::Int64Array&>(chunk));
+  case arrow::Type::STRING:
+    return visit(static_cast<const arrow::StringArray&>(chunk));
+  case arrow::Type::LARGE_STRING:
+    return visit(static_cast<const arrow::LargeStringArray&>(chunk));
+  default:
+    KATANA_LOG_FATAL("IDs were not normalized");
+  }
+}
+
+/// Call fn(i, id) for each element i of ids, a column returned by
+/// NormalizeIds, in parallel over its chunks
+template <typename Fn>
+katana::Result<void>
+ForEachId(const arrow::ChunkedArray& ids, const std::string& name, Fn fn) {
+  std::vector<int64_t> offsets(ids.num_chunks() + 1, 0);
+  for (int c = 0; c < ids.num_chunks(); ++c) {
+    offsets[c + 1] = offsets[c] + ids.chunk(c)->length();
+  }
+
+  katana::GReduceMin<int64_t> first_null;
+  katana::do_all(
+      katana::iterate(0, ids.num_chunks()),
+      [&](int c) {
+        int64_t offset = offsets[c];
+        int64_t null = VisitIds(
+            *ids.chunk(c), [&](int64_t i, auto id) { fn(offset + i, id); });
+        if (null >= 0) {
+          first_null.update(offset + null);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (first_null.reduce() != std::numeric_limits<int64_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "row {} of column {} is null",
+        first_null.reduce(), name);
+  }
+  return katana::ResultSuccess();
+}
+
+/// The index of each node ID of a node table. The string IDs are views of
+/// the table, which must outlive the dictionary.
+struct NodeDictionary {
+  std::unordered_map<int64_t, uint32_t> integer_ids;
+  std::unordered_map<std::string_view, uint32_t> string_ids;
+};
+
+katana::Result<void>
+FillDictionary(
+    const arrow::ChunkedArray& ids, const std::string& name,
+    NodeDictionary* dictionary) {
+  int64_t offset = 0;
+  int64_t duplicate = -1;
+  for (const auto& chunk : ids.chunks()) {
+    int64_t null = VisitIds(*chunk, [&](int64_t i, auto id) {
+      bool inserted = false;
+      if constexpr (std::is_same_v<decltype(id), int64_t>) {
+        inserted = dictionary->integer_ids.emplace(id, offset + i).second;
+      } else {
+        inserted = dictionary->string_ids.emplace(id, offset + i).second;
+      }
+      if (!inserted && duplicate < 0) {
+        duplicate = offset + i;
+      }
+    });
+    if (null >= 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "row {} of column {} is null",
+          offset + null, name);
+    }
+    if (duplicate >= 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "row {} of column {} repeats an ID", duplicate, name);
+    }
+    offset += chunk->length();
+  }
+  return katana::ResultSuccess();
+}
+
+/// The largest of the integer IDs of columns, which must not be negative
+katana::Result<int64_t>
+MaxId(
+    const std::vector<const arrow::ChunkedArray*>& columns,
+    const std::string& name) {
+  katana::GReduceMax<int64_t> max_id;
+  katana::GReduceMin<int64_t> min_id;
+  for (const arrow::ChunkedArray* ids : columns) {
+    auto res = ForEachId(*ids, name, [&](int64_t, auto id) {
+      if constexpr (std::is_same_v<decltype(id), int64_t>) {
+        max_id.update(id);
+        min_id.update(id);
+      }
+    });
+    if (!res) {
+      return res.error();
+    }
+  }
+  if (min_id.reduce() < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "node IDs must not be negative without a node table");
+  }
+  return max_id.reduce();
+}
+
+/// Resolve the IDs of the edge column ids to node indexes, written to nodes
+katana::Result<void>
+ResolveIds(
+    const arrow::ChunkedArray& ids, const std::string& name,
+    const NodeDictionary* dictionary, katana::LargeArray<uint32_t>* nodes) {
+  constexpr uint32_t kUnresolved = std::numeric_limits<uint32_t>::max();
+  katana::GReduceMin<uint64_t> first_unresolved;
+  auto res = ForEachId(ids, name, [&](int64_t e, auto id) {
+    uint32_t node = kUnresolved;
+    if constexpr (std::is_same_v<decltype(id), int64_t>) {
+      if (!dictionary) {
+        node = static_cast<uint32_t>(id);
+      } else if (auto it = dictionary->integer_ids.find(id);
+                 it != dictionary->integer_ids.end()) {
+        node = it->second;
+      }
+    } else if (auto it = dictionary->string_ids.find(id);
+               it != dictionary->string_ids.end()) {
+      node = it->second;
+    }
+    if (node == kUnresolved) {
+      first_unresolved.update(e);
+    }
+    (*nodes)[e] = node;
+  });
+  if (!res) {
+    return res.error();
+  }
+  if (first_unresolved.reduce() != std::numeric_limits<uint64_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "row {} of column {} names no node of the node table",
+        first_unresolved.reduce(), name);
+  }
+  return katana::ResultSuccess();
+}
+
+/************************************/
+/* Functions for building the graph */
+/************************************/
+
+/// Allocate an Arrow buffer for length values of type T
+template <typename T>
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateValues(uint64_t length) {
+  auto buffer_res = arrow::AllocateBuffer(length * sizeof(T));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(buffer_res.status()), "allocating buffer: {}",
+        buffer_res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(buffer_res.ValueOrDie()));
+}
+
+/// The CSR of the edges from sources to dests, and the edge of the table
+/// that each edge of the CSR is
+struct Csr {
+  std::shared_ptr<katana::GraphTopology> topology;
+  std::shared_ptr<arrow::UInt64Array> order;
+};
+
+/// Build the CSR by a parallel counting sort of the edges by source, keeping
+/// the edges of each node in order
+katana::Result<Csr>
+BuildCsr(
+    const katana::LargeArray<uint32_t>& sources,
+    const katana::LargeArray<uint32_t>& dests, uint64_t num_nodes) {
+  uint64_t num_edges = sources.size();
+
+  auto indices_res = AllocateValues<uint64_t>(num_nodes);
+  if (!indices_res) {
+    return indices_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buffer = indices_res.value();
+  auto* out_indices = reinterpret_cast<uint64_t*>(
+      indices_buffer->mutable_data());
+
+  katana::LargeArray<uint64_t> degrees;
+  degrees.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { degrees[n] = 0; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { __sync_fetch_and_add(&degrees[sources[e]], 1); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      degrees.begin(), degrees.end(), out_indices);
+
+  // degrees become the next free position of the edges of each node
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { degrees[n] = out_indices[n] - degrees[n]; },
+      katana::no_stats());
+
+  auto order_res = AllocateValues<uint64_t>(num_edges);
+  if (!order_res) {
+    return order_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> order_buffer = order_res.value();
+  auto* order = reinterpret_cast<uint64_t*>(order_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        order[__sync_fetch_and_add(&degrees[sources[e]], 1)] = e;
+      },
+      katana::no_stats());
+
+  auto dests_res = AllocateValues<uint32_t>(num_edges);
+  if (!dests_res) {
+    return dests_res.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_res.value();
+  auto* out_dests = reinterpret_cast<uint32_t*>(dests_buffer->mutable_data());
+
+  // the atomic scatter leaves the edges of a node in any order
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n == 0 ? 0 : out_indices[n - 1];
+        uint64_t end = out_indices[n];
+        std::sort(order + begin, order + end);
+        for (uint64_t e = begin; e < end; ++e) {
+          out_dests[e] = dests[order[e]];
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  auto topology = std::make_shared<katana::GraphTopology>();
+  topology->out_indices = std::make_shared<arrow::UInt64Array>(
+      static_cast<int64_t>(num_nodes), indices_buffer);
+  topology->out_dests = std::make_shared<arrow::UInt32Array>(
+      static_cast<int64_t>(num_edges), dests_buffer);
+  return Csr{
+      topology, std::make_shared<arrow::UInt64Array>(
+                    static_cast<int64_t>(num_edges), order_buffer)};
+}
+
+/// The columns of the edge table other than the source and destination, in
+/// the order of the CSR
+katana::Result<std::shared_ptr<arrow::Table>>
+OrderEdgeProperties(
+    const std::shared_ptr<arrow::Table>& edges,
+    const katana::TableColumns& columns,
+    const std::shared_ptr<arrow::UInt64Array>& order) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> properties;
+  for (int i = 0; i < edges->num_columns(); ++i) {
+    const std::string& name = edges->field(i)->name();
+    if (name != columns.source && name != columns.destination) {
+      fields.emplace_back(edges->field(i));
+      properties.emplace_back(edges->column(i));
+    }
+  }
+
+  std::vector<arrow::Status> statuses(properties.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, properties.size()),
+      [&](size_t i) {
+        auto take_res = arrow::compute::Take(
+            arrow::Datum(properties[i]), arrow::Datum(order));
+        if (!take_res.ok()) {
+          statuses[i] = take_res.status();
+          return;
+        }
+        properties[i] = take_res.ValueOrDie().chunked_array();
+      },
+      katana::steal(), katana::no_stats());
+  for (size_t i = 0; i < statuses.size(); ++i) {
+    if (!statuses[i].ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(statuses[i]), "ordering edge property {}: {}",
+          fields[i]->name(), statuses[i]);
+    }
+  }
+  return arrow::Table::Make(arrow::schema(fields), properties, order->length());
+}
+
+std::shared_ptr<arrow::Table>
+EmptyTable(int64_t num_rows) {
+  return arrow::Table::Make(
+      arrow::schema({}), std::vector<std::shared_ptr<arrow::ChunkedArray>>{},
+      num_rows);
+}
+
+}  // end of unnamed namespace
+
+katana::Result<katana::GraphComponents>
+katana::ConvertTables(
+    katana::SourceType type, const std::string& edges_file,
+    const std::string& nodes_file, const katana::TableColumns& columns) {
+  auto edges_res = ReadTable(type, edges_file);
+  if (!edges_res) {
+    return edges_res.error();
+  }
+  std::shared_ptr<arrow::Table> edges = edges_res.value();
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> endpoints;
+  for (const std::string& name : {columns.source, columns.destination}) {
+    auto column_res = GetColumn(edges, name, edges_file);
+    if (!column_res) {
+      return column_res.error();
+    }
+    endpoints.emplace_back(column_res.value());
+  }
+  std::vector<IdKind> kinds;
+  for (size_t i = 0; i < endpoints.size(); ++i) {
+    auto kind_res = KindOf(*endpoints[i], i == 0 ? columns.source
+                                                 : columns.destination);
+    if (!kind_res) {
+      return kind_res.error();
+    }
+    kinds.emplace_back(kind_res.value());
+    auto ids_res = NormalizeIds(endpoints[i], kinds[i]);
+    if (!ids_res) {
+      return ids_res.error();
+    }
+    endpoints[i] = ids_res.value();
+  }
+  if (kinds[0] != kinds[1]) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "columns {} and {} hold different kinds of IDs", columns.source,
+        columns.destination);
+  }
+
+  // find the nodes
+  std::shared_ptr<arrow::Table> nodes;
+  NodeDictionary dictionary;
+  uint64_t num_nodes = 0;
+  if (!nodes_file.empty()) {
+    auto nodes_res = ReadTable(type, nodes_file);
+    if (!nodes_res) {
+      return nodes_res.error();
+    }
+    nodes = nodes_res.value();
+    auto ids_res = GetColumn(nodes, columns.node_id, nodes_file);
+    if (!ids_res) {
+      return ids_res.error();
+    }
+    auto kind_res = KindOf(*ids_res.value(), columns.node_id);
+    if (!kind_res) {
+      return kind_res.error();
+    }
+    if (kind_res.value() != kinds[0]) {
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError,
+          "the node and edge tables hold different kinds of IDs");
+    }
+    auto normalized_res = NormalizeIds(ids_res.value(), kinds[0]);
+    if (!normalized_res) {
+      return normalized_res.error();
+    }
+    // the dictionary may view normalized IDs, so keep them in the table
+    if (normalized_res.value() != ids_res.value()) {
+      int index = nodes->schema()->GetFieldIndex(columns.node_id);
+      auto set_res = nodes->SetColumn(
+          index, arrow::field(columns.node_id, arrow::int64()),
+          normalized_res.value());
+      if (!set_res.ok()) {
+        return KATANA_ERROR(
+            katana::ArrowToKatana(set_res.status()), "normalizing IDs: {}",
+            set_res.status());
+      }
+      nodes = set_res.ValueOrDie();
+    }
+    if (auto res = FillDictionary(
+            *normalized_res.value(), columns.node_id, &dictionary);
+        !res) {
+      return res.error();
+    }
+    num_nodes = nodes->num_rows();
+  } else {
+    if (kinds[0] != IdKind::kInteger) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "string node IDs need a node table");
+    }
+    auto max_res =
+        MaxId({endpoints[0].get(), endpoints[1].get()}, columns.source);
+    if (!max_res) {
+      return max_res.error();
+    }
+    num_nodes = edges->num_rows() == 0 ? 0 : max_res.value() + 1;
+  }
+  if (num_nodes >= std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} nodes do not fit in 32-bit node ids", num_nodes);
+  }
+
+  // resolve the endpoints of the edges and build the CSR
+  uint64_t num_edges = edges->num_rows();
+  katana::LargeArray<uint32_t> sources;
+  katana::LargeArray<uint32_t> dests;
+  sources.allocateBlocked(num_edges);
+  dests.allocateBlocked(num_edges);
+  const NodeDictionary* node_dictionary = nodes ? &dictionary : nullptr;
+  if (auto res = ResolveIds(
+          *endpoints[0], columns.source, node_dictionary, &sources);
+      !res) {
+    return res.error();
+  }
+  if (auto res = ResolveIds(
+          *endpoints[1], columns.destination, node_dictionary, &dests);
+      !res) {
+    return res.error();
+  }
+
+  auto csr_res = BuildCsr(sources, dests, num_nodes);
+  if (!csr_res) {
+    return csr_res.error();
+  }
+
+  auto edge_properties_res =
+      OrderEdgeProperties(edges, columns, csr_res.value().order);
+  if (!edge_properties_res) {
+    return edge_properties_res.error();
+  }
+
+  std::shared_ptr<arrow::Table> node_properties =
+      nodes ? nodes : EmptyTable(num_nodes);
+  return GraphComponents{
+      GraphComponent{node_properties, EmptyTable(num_nodes)},
+      GraphComponent{edge_properties_res.value(), EmptyTable(num_edges)},
+      csr_res.value().topology};
+}
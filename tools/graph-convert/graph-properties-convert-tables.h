@@ -0,0 +1,48 @@
+#ifndef KATANA_TOOLS_GRAPH_CONVERT_GRAPH_PROPERTIES_CONVERT_TABLES_H_
+#define KATANA_TOOLS_GRAPH_CONVERT_GRAPH_PROPERTIES_CONVERT_TABLES_H_
+
+#include <string>
+
+#include "katana/BuildGraph.h"
+
+namespace katana {
+
+/// The columns of the node and edge tables that hold the topology
+struct TableColumns {
+  /// column of the edge table with the ID of the source of each edge
+  std::string source{"src"};
+  /// column of the edge table with the ID of the destination of each edge
+  std::string destination{"dst"};
+  /// column of the node table with the ID of each node
+  std::string node_id{"id"};
+};
+
+/// ConvertTables builds a graph straight from a table of edges and,
+/// optionally, a table of nodes, both either CSV files with a header row or
+/// Parquet files. Files are read with the multithreaded Arrow readers and the
+/// CSR is built in parallel by counting sort; the edges of each node keep the
+/// order of the edge table.
+///
+/// With a node table, node i is row i of the table and the columns of the
+/// table, including the IDs, are the node properties. IDs may be integers or
+/// strings, must be unique and, in the edge table, must be of the same kind
+/// and name a node of the table. Without a node table, IDs must be
+/// non-negative integers, which are the node indexes, and there are as many
+/// nodes as the largest ID plus one.
+///
+/// The columns of the edge table other than columns.source and
+/// columns.destination are the edge properties.
+///
+/// \param type kCsv or kParquet
+/// \param edges_file Path or URI of the edge table
+/// \param nodes_file Path or URI of the node table, or empty
+/// \param columns Names of the columns holding the topology
+/// \returns A collection of Arrow tables of node properties, edge properties
+///     and CSR topology, with empty label tables
+Result<GraphComponents> ConvertTables(
+    SourceType type, const std::string& edges_file,
+    const std::string& nodes_file, const TableColumns& columns = {});
+
+}  // end namespace katana
+
+#endif
@@ -6,6 +6,7 @@
 #include "katana/Galois.h"
 #include "katana/GraphML.h"
 #include "katana/Logging.h"
+#include "katana/Uri.h"
 #include "katana/config.h"
 
 #if defined(KATANA_MONGOC_FOUND)
@@ -43,6 +44,9 @@ static cll::opt<ConvertTest> test_type(
 static cll::opt<int> chunk_size(
     "chunkSize", cll::desc("Chunk size for in memory arrow representation"),
     cll::init(25000));
+static cll::opt<bool> streaming(
+    "streaming", cll::desc("Convert GraphML with ConvertGraphMLStreaming"),
+    cll::init(false));
 
 namespace {
 
@@ -1271,13 +1275,22 @@ main(int argc, char** argv) {
   katana::GraphComponents graph;
 
   switch (fileType) {
-  case katana::SourceDatabase::kNeo4j:
-    if (auto r = katana::ConvertGraphML(input_filename, chunk_size, true); !r) {
-      KATANA_LOG_FATAL(": {}", r.error());
+  case katana::SourceDatabase::kNeo4j: {
+    katana::Result<katana::GraphComponents> r = katana::GraphComponents{};
+    if (streaming) {
+      auto staging_res = katana::Uri::MakeRand("/tmp/graphml-staging");
+      KATANA_LOG_ASSERT(staging_res);
+      r = katana::ConvertGraphMLStreaming(
+          input_filename, staging_res.value().string(), chunk_size, true);
     } else {
-      graph = std::move(r.value());
+      r = katana::ConvertGraphML(input_filename, chunk_size, true);
+    }
+    if (!r) {
+      KATANA_LOG_FATAL(": {}", r.error());
     }
+    graph = std::move(r.value());
     break;
+  }
 #if defined(KATANA_MONGOC_FOUND)
   case katana::SourceDatabase::kMongodb:
     graph = GenerateAndConvertBson(chunk_size);
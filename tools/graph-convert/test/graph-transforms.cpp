@@ -0,0 +1,157 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "Transforms.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+
+namespace {
+
+template <typename ArrayType, typename T>
+void
+AssertValues(
+    const std::shared_ptr<arrow::Array>& array, const std::vector<T>& expected,
+    const std::string& name) {
+  auto values = std::static_pointer_cast<ArrayType>(array);
+  KATANA_LOG_VASSERT(
+      values->length() == static_cast<int64_t>(expected.size()),
+      "{} has {} values, not {}", name, values->length(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        values->Value(i) == expected[i], "{}[{}] is {}, not {}", name, i,
+        values->Value(i), expected[i]);
+  }
+}
+
+std::shared_ptr<arrow::Array>
+Property(const std::shared_ptr<arrow::ChunkedArray>& property) {
+  KATANA_LOG_ASSERT(property);
+  auto combine_res = arrow::Concatenate(property->chunks());
+  KATANA_LOG_ASSERT(combine_res.ok());
+  return combine_res.ValueOrDie();
+}
+
+/// Nodes have the property "id" with their number and edges the property
+/// "id" with theirs, so that the ids of a transformed graph say where its
+/// nodes and edges came from.
+///
+///   0 -> 1, 0 -> 1, 0 -> 0, 0 -> 2, 1 -> 2, 2 -> 0; node 3 has no edges
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::vector<uint64_t> out_indices{4, 5, 6, 6};
+  std::vector<uint32_t> out_dests{1, 1, 0, 2, 2, 0};
+  std::vector<int64_t> node_ids{0, 1, 2, 3};
+  std::vector<int64_t> edge_ids{0, 1, 2, 3, 4, 5};
+
+  auto graph = std::make_unique<katana::PropertyGraph>();
+  auto res = graph->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(out_indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(out_dests)),
+  });
+  KATANA_LOG_ASSERT(res);
+
+  auto schema = arrow::schema({arrow::field("id", arrow::int64())});
+  res = graph->AddNodeProperties(
+      arrow::Table::Make(schema, {katana::BuildArray(node_ids)}));
+  KATANA_LOG_ASSERT(res);
+  res = graph->AddEdgeProperties(
+      arrow::Table::Make(schema, {katana::BuildArray(edge_ids)}));
+  KATANA_LOG_ASSERT(res);
+  return graph;
+}
+
+void
+AssertGraph(
+    const katana::PropertyGraph& graph,
+    const std::vector<uint64_t>& out_indices,
+    const std::vector<uint32_t>& out_dests, const std::vector<int64_t>& nodes,
+    const std::vector<int64_t>& edges) {
+  AssertValues<arrow::UInt64Array>(
+      graph.topology().out_indices, out_indices, "out_indices");
+  AssertValues<arrow::UInt32Array>(
+      graph.topology().out_dests, out_dests, "out_dests");
+  AssertValues<arrow::Int64Array>(
+      Property(graph.GetNodeProperty("id")), nodes, "node ids");
+  AssertValues<arrow::Int64Array>(
+      Property(graph.GetEdgeProperty("id")), edges, "edge ids");
+}
+
+std::unique_ptr<katana::PropertyGraph>
+Apply(std::unique_ptr<katana::GraphTransformer> transformer) {
+  std::vector<std::unique_ptr<katana::GraphTransformer>> transformers;
+  transformers.emplace_back(std::move(transformer));
+  auto res = katana::ApplyGraphTransforms(MakeGraph(), transformers);
+  KATANA_LOG_VASSERT(res, "transforming graph: {}", res.error());
+  return std::move(res.value());
+}
+
+void
+TestTranspose() {
+  auto graph = Apply(std::make_unique<katana::Transpose>());
+  AssertGraph(
+      *graph, {2, 4, 6, 6}, {0, 2, 0, 0, 0, 1}, {0, 1, 2, 3},
+      {2, 5, 0, 1, 3, 4});
+}
+
+void
+TestMakeSymmetric() {
+  auto graph = Apply(std::make_unique<katana::MakeSymmetric>());
+  AssertGraph(
+      *graph, {5, 8, 11, 11}, {1, 1, 0, 2, 2, 2, 0, 0, 0, 0, 1}, {0, 1, 2, 3},
+      {0, 1, 2, 3, 5, 4, 0, 1, 5, 3, 4});
+}
+
+void
+TestSortEdges() {
+  auto graph = Apply(std::make_unique<katana::SortEdges>());
+  AssertGraph(
+      *graph, {4, 5, 6, 6}, {0, 1, 1, 2, 2, 0}, {0, 1, 2, 3},
+      {2, 0, 1, 3, 4, 5});
+}
+
+void
+TestCleanup() {
+  auto graph = Apply(std::make_unique<katana::Cleanup>());
+  AssertGraph(*graph, {2, 3, 4, 4}, {1, 2, 2, 0}, {0, 1, 2, 3}, {0, 3, 4, 5});
+}
+
+void
+TestRemoveHighDegree() {
+  auto graph = Apply(std::make_unique<katana::RemoveHighDegree>(1));
+  AssertGraph(*graph, {1, 1, 1}, {1}, {1, 2, 3}, {4});
+}
+
+void
+TestPipeline() {
+  std::vector<std::unique_ptr<katana::GraphTransformer>> transformers;
+  transformers.emplace_back(std::make_unique<katana::MakeSymmetric>());
+  transformers.emplace_back(std::make_unique<katana::Cleanup>());
+  auto res = katana::ApplyGraphTransforms(MakeGraph(), transformers);
+  KATANA_LOG_VASSERT(res, "transforming graph: {}", res.error());
+  AssertGraph(
+      *res.value(), {2, 4, 6, 6}, {1, 2, 0, 2, 0, 1}, {0, 1, 2, 3},
+      {0, 3, 0, 4, 5, 4});
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestTranspose();
+  TestMakeSymmetric();
+  TestSortEdges();
+  TestCleanup();
+  TestRemoveHighDegree();
+  TestPipeline();
+
+  return 0;
+}
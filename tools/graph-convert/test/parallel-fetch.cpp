@@ -0,0 +1,72 @@
+#include <atomic>
+#include <vector>
+
+#include "ParallelFetch.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Threads.h"
+
+namespace {
+
+struct Batch {
+  size_t source;
+  std::vector<size_t> values;
+};
+
+/// Fetch kBatches batches from each of num_sources sources and check that
+/// every batch is converted once, by one thread at a time per builder
+void
+TestFetch(size_t num_sources, unsigned num_fetchers, size_t capacity) {
+  constexpr size_t kBatches = 10;
+  std::vector<size_t> sources(num_sources);
+  for (size_t i = 0; i < num_sources; ++i) {
+    sources[i] = i;
+  }
+
+  std::vector<std::atomic<size_t>> converted(num_sources * kBatches);
+  std::vector<std::atomic<bool>> fetchers_busy(num_fetchers);
+  std::vector<std::atomic<bool>> builders_busy(katana::getActiveThreads());
+
+  katana::FetchInParallel<Batch>(
+      sources, num_fetchers, capacity,
+      [&](size_t source, unsigned fetcher, auto emit) {
+        KATANA_LOG_ASSERT(fetcher < num_fetchers);
+        KATANA_LOG_ASSERT(!fetchers_busy[fetcher].exchange(true));
+        for (size_t b = 0; b < kBatches; ++b) {
+          emit(Batch{source, {source * kBatches + b}});
+        }
+        fetchers_busy[fetcher] = false;
+      },
+      [&](Batch&& batch, unsigned tid) {
+        KATANA_LOG_ASSERT(!builders_busy[tid].exchange(true));
+        for (size_t value : batch.values) {
+          converted[value]++;
+        }
+        builders_busy[tid] = false;
+      });
+
+  for (size_t i = 0; i < converted.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        converted[i] == 1, "batch {} converted {} times", i,
+        converted[i].load());
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  unsigned num_threads = katana::getActiveThreads();
+  TestFetch(100, num_threads, 2 * num_threads);
+  TestFetch(100, 1, 1);
+  TestFetch(3, num_threads, 1);
+  TestFetch(0, num_threads, 1);
+
+  // a single thread both fetches and converts
+  katana::setActiveThreads(1);
+  TestFetch(20, 4, 1);
+
+  return 0;
+}
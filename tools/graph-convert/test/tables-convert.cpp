@@ -0,0 +1,175 @@
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "graph-properties-convert-tables.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Uri.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/file.h"
+
+namespace {
+
+std::string inputs_dir;
+
+template <typename ArrayType, typename T>
+void
+AssertValues(
+    const std::shared_ptr<arrow::Array>& array, const std::vector<T>& expected,
+    const std::string& name) {
+  auto values = std::static_pointer_cast<ArrayType>(array);
+  KATANA_LOG_VASSERT(
+      values->length() == static_cast<int64_t>(expected.size()),
+      "{} has {} values, not {}", name, values->length(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        values->Value(i) == expected[i], "{}[{}] is {}, not {}", name, i,
+        values->Value(i), expected[i]);
+  }
+}
+
+void
+AssertTopology(
+    const katana::GraphComponents& graph,
+    const std::vector<uint64_t>& out_indices,
+    const std::vector<uint32_t>& out_dests) {
+  AssertValues<arrow::UInt64Array>(
+      graph.topology->out_indices, out_indices, "out_indices");
+  AssertValues<arrow::UInt32Array>(
+      graph.topology->out_dests, out_dests, "out_dests");
+  KATANA_LOG_ASSERT(
+      graph.nodes.labels->num_rows() ==
+      static_cast<int64_t>(out_indices.size()));
+  KATANA_LOG_ASSERT(
+      graph.edges.labels->num_rows() == static_cast<int64_t>(out_dests.size()));
+}
+
+std::shared_ptr<arrow::Array>
+Column(const std::shared_ptr<arrow::Table>& table, const std::string& name) {
+  auto column = table->GetColumnByName(name);
+  KATANA_LOG_VASSERT(column, "no column {}", name);
+  KATANA_LOG_ASSERT(column->num_chunks() == 1);
+  return column->chunk(0);
+}
+
+void
+TestStringIds() {
+  auto res = katana::ConvertTables(
+      katana::SourceType::kCsv, inputs_dir + "/tables-edges.csv",
+      inputs_dir + "/tables-nodes.csv");
+  KATANA_LOG_VASSERT(res, "converting tables: {}", res.error());
+  const katana::GraphComponents& graph = res.value();
+
+  AssertTopology(graph, {2, 3, 4, 5}, {1, 2, 0, 0, 2});
+
+  KATANA_LOG_ASSERT(graph.nodes.properties->num_columns() == 3);
+  KATANA_LOG_ASSERT(graph.edges.properties->num_columns() == 2);
+  AssertValues<arrow::DoubleArray, double>(
+      Column(graph.edges.properties, "weight"), {1.5, 3.5, 4.5, 0.5, 2.5},
+      "weight");
+  AssertValues<arrow::Int64Array, int64_t>(
+      Column(graph.edges.properties, "since"),
+      {2010, 2012, 2008, 2001, 2015}, "since");
+  AssertValues<arrow::Int64Array, int64_t>(
+      Column(graph.nodes.properties, "age"), {31, 27, 45, 38}, "age");
+}
+
+void
+TestIntegerIds() {
+  auto res = katana::ConvertTables(
+      katana::SourceType::kCsv, inputs_dir + "/tables-int-edges.csv", "");
+  KATANA_LOG_VASSERT(res, "converting tables: {}", res.error());
+  const katana::GraphComponents& graph = res.value();
+
+  AssertTopology(graph, {1, 1, 1, 2, 3}, {1, 0, 2});
+  KATANA_LOG_ASSERT(graph.nodes.properties->num_columns() == 0);
+  KATANA_LOG_ASSERT(graph.edges.properties->num_columns() == 0);
+}
+
+void
+TestParquet() {
+  std::vector<int32_t> sources{3, 0, 4};
+  std::vector<int32_t> dests{0, 1, 2};
+  std::vector<double> weights{0.5, 1.5, 2.5};
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("from", arrow::int32()),
+           arrow::field("to", arrow::int32()),
+           arrow::field("weight", arrow::float64())}),
+      {katana::BuildArray(sources), katana::BuildArray(dests),
+       katana::BuildArray(weights)});
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/tables-convert");
+  KATANA_LOG_ASSERT(uri_res);
+  katana::Uri uri = uri_res.value();
+  auto writer_res = tsuba::ParquetWriter::Make(table);
+  KATANA_LOG_ASSERT(writer_res);
+  auto write_res = writer_res.value()->WriteToUri(uri);
+  KATANA_LOG_VASSERT(write_res, "writing edges: {}", write_res.error());
+
+  katana::TableColumns columns;
+  columns.source = "from";
+  columns.destination = "to";
+  auto res = katana::ConvertTables(
+      katana::SourceType::kParquet, uri.string(), "", columns);
+  KATANA_LOG_VASSERT(res, "converting tables: {}", res.error());
+  const katana::GraphComponents& graph = res.value();
+
+  AssertTopology(graph, {1, 1, 1, 2, 3}, {1, 0, 2});
+  AssertValues<arrow::DoubleArray, double>(
+      Column(graph.edges.properties, "weight"), {1.5, 0.5, 2.5}, "weight");
+
+  KATANA_LOG_ASSERT(
+      tsuba::FileDelete(uri.DirName().string(), {uri.BaseName()}));
+}
+
+void
+TestErrors() {
+  // string IDs need a node table
+  KATANA_LOG_ASSERT(!katana::ConvertTables(
+      katana::SourceType::kCsv, inputs_dir + "/tables-edges.csv", ""));
+
+  // integer IDs do not name the string IDs of a node table
+  KATANA_LOG_ASSERT(!katana::ConvertTables(
+      katana::SourceType::kCsv, inputs_dir + "/tables-int-edges.csv",
+      inputs_dir + "/tables-nodes.csv"));
+
+  // the endpoint columns must exist and hold IDs
+  katana::TableColumns columns;
+  columns.source = "weight";
+  KATANA_LOG_ASSERT(!katana::ConvertTables(
+      katana::SourceType::kCsv, inputs_dir + "/tables-edges.csv",
+      inputs_dir + "/tables-nodes.csv", columns));
+
+  columns = katana::TableColumns{};
+  columns.source = "missing";
+  KATANA_LOG_ASSERT(!katana::ConvertTables(
+      katana::SourceType::kCsv, inputs_dir + "/tables-edges.csv",
+      inputs_dir + "/tables-nodes.csv", columns));
+
+  // every edge names a node of the node table
+  columns = katana::TableColumns{};
+  columns.node_id = "name";
+  KATANA_LOG_ASSERT(!katana::ConvertTables(
+      katana::SourceType::kCsv, inputs_dir + "/tables-edges.csv",
+      inputs_dir + "/tables-nodes.csv", columns));
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  KATANA_LOG_ASSERT(argc == 2);
+  inputs_dir = argv[1];
+
+  TestStringIds();
+  TestIntegerIds();
+  TestParquet();
+  TestErrors();
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include <memory>
+#include <string>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "katana/Galois.h"
+#include "katana/GraphGenerator.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Timer.h"
+#include "katana/gIO.h"
+
+namespace cll = llvm::cl;
+
+namespace {
+
+cll::opt<std::string> output_rdg(
+    cll::Positional, cll::desc("<output rdg>"), cll::Required);
+cll::opt<katana::GeneratedGraph> kind(
+    "kind", cll::desc("Family of graphs:"),
+    cll::values(
+        clEnumValN(
+            katana::GeneratedGraph::kRmat, "rmat",
+            "R-MAT (stochastic Kronecker) graphs, like social networks"),
+        clEnumValN(
+            katana::GeneratedGraph::kLfr, "lfr",
+            "LFR-like graphs of communities"),
+        clEnumValN(
+            katana::GeneratedGraph::kGeometric, "geometric",
+            "Road-like random geometric graphs"),
+        clEnumValN(
+            katana::GeneratedGraph::kBipartite, "bipartite",
+            "Bipartite graphs")),
+    cll::Required);
+cll::opt<uint64_t> num_nodes(
+    "nodes", cll::desc("Number of nodes"), cll::Required);
+cll::opt<uint64_t> num_edges(
+    "edges", cll::desc("Number of edges to draw"), cll::Required);
+cll::opt<uint64_t> seed(
+    "seed", cll::desc("Random seed (default 0)"), cll::init(0));
+cll::opt<bool> symmetric(
+    "symmetric", cll::desc("Add the reverse of each edge"), cll::init(false));
+cll::opt<bool> keep_duplicates(
+    "keep-duplicates", cll::desc("Keep edges drawn more than once"),
+    cll::init(false));
+
+cll::opt<double> rmat_a(
+    "rmat-a", cll::desc("R-MAT probability a"), cll::init(0.57));
+cll::opt<double> rmat_b(
+    "rmat-b", cll::desc("R-MAT probability b"), cll::init(0.19));
+cll::opt<double> rmat_c(
+    "rmat-c", cll::desc("R-MAT probability c"), cll::init(0.19));
+
+cll::opt<double> lfr_degree_exponent(
+    "lfr-degree-exponent", cll::desc("Exponent of the LFR degrees"),
+    cll::init(2.5));
+cll::opt<uint64_t> lfr_max_degree(
+    "lfr-max-degree",
+    cll::desc("Largest LFR degree (default 10 times the average)"),
+    cll::init(0));
+cll::opt<double> lfr_community_exponent(
+    "lfr-community-exponent",
+    cll::desc("Exponent of the LFR community sizes"), cll::init(1.5));
+cll::opt<uint64_t> lfr_min_community_size(
+    "lfr-min-community", cll::desc("Smallest LFR community"), cll::init(16));
+cll::opt<uint64_t> lfr_max_community_size(
+    "lfr-max-community",
+    cll::desc("Largest LFR community (default the largest degree)"),
+    cll::init(0));
+cll::opt<double> lfr_mixing(
+    "lfr-mixing",
+    cll::desc("Fraction of the edges of a node leaving its community"),
+    cll::init(0.1));
+
+cll::opt<uint64_t> bipartite_num_left_nodes(
+    "bipartite-left",
+    cll::desc("Number of bipartite source nodes (default half)"),
+    cll::init(0));
+cll::opt<double> bipartite_skew(
+    "bipartite-skew",
+    cll::desc("Skew of the bipartite destinations (default 1, uniform)"),
+    cll::init(1.0));
+
+cll::opt<std::string> weight_property(
+    "weight", cll::desc("Edge property of weights (default none)"),
+    cll::init(""));
+cll::opt<uint32_t> max_weight(
+    "max-weight", cll::desc("Largest edge weight"), cll::init(100));
+cll::opt<std::string> label_property(
+    "label", cll::desc("Node property of labels (default none)"),
+    cll::init(""));
+cll::opt<uint32_t> num_labels(
+    "num-labels", cll::desc("Number of random labels"), cll::init(16));
+
+cll::opt<int> num_threads(
+    "t", cll::desc("Number of threads (default all)"), cll::init(0));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv,
+      "Generate a synthetic graph in parallel and write it as an RDG. The "
+      "graph depends on the options alone, not on the number of threads.\n");
+  if (num_threads > 0) {
+    katana::setActiveThreads(num_threads);
+  } else {
+    katana::setActiveThreads(katana::getThreadPool().getMaxUsableThreads());
+  }
+  std::string command_line = argv[0];
+  for (int i = 1; i < argc; ++i) {
+    command_line = command_line + " " + argv[i];
+  }
+
+  katana::GraphGeneratorOptions opts;
+  opts.kind = kind;
+  opts.num_nodes = num_nodes;
+  opts.num_edges = num_edges;
+  opts.seed = seed;
+  opts.symmetric = symmetric;
+  opts.remove_duplicates = !keep_duplicates;
+  opts.rmat_a = rmat_a;
+  opts.rmat_b = rmat_b;
+  opts.rmat_c = rmat_c;
+  opts.lfr_degree_exponent = lfr_degree_exponent;
+  opts.lfr_max_degree = lfr_max_degree;
+  opts.lfr_community_exponent = lfr_community_exponent;
+  opts.lfr_min_community_size = lfr_min_community_size;
+  opts.lfr_max_community_size = lfr_max_community_size;
+  opts.lfr_mixing = lfr_mixing;
+  opts.bipartite_num_left_nodes = bipartite_num_left_nodes;
+  opts.bipartite_skew = bipartite_skew;
+  opts.weight_property = weight_property;
+  opts.max_weight = max_weight;
+  opts.label_property = label_property;
+  opts.num_labels = num_labels;
+
+  katana::StatTimer generate_timer("Generate", "GraphGenerate");
+  generate_timer.start();
+  auto graph_res = katana::GenerateGraph(opts);
+  generate_timer.stop();
+  if (!graph_res) {
+    KATANA_LOG_FATAL("failed to generate: {}", graph_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> graph = std::move(graph_res.value());
+  katana::gPrint(
+      "generated ", graph->topology().num_nodes(), " nodes and ",
+      graph->topology().num_edges(), " edges in ",
+      generate_timer.get_usec() / 1000, " ms\n");
+
+  if (auto res = graph->Write(output_rdg, command_line); !res) {
+    KATANA_LOG_FATAL("failed to write {}: {}", output_rdg, res.error());
+  }
+  return 0;
+}
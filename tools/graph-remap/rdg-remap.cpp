@@ -0,0 +1,135 @@
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Relabel.h"
+
+namespace cll = llvm::cl;
+
+namespace {
+
+enum class RemapOrder { kDegree, kRCM, kLocality, kProperty, kMapping };
+
+cll::opt<std::string> input_rdg(
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
+cll::opt<std::string> output_rdg(
+    cll::Positional,
+    cll::desc("<output rdg> (default: commit a new version of the input)"),
+    cll::init(""));
+cll::opt<RemapOrder> order(
+    "order", cll::desc("Order in which to place the nodes:"),
+    cll::values(
+        clEnumValN(RemapOrder::kDegree, "degree", "Descending out-degree"),
+        clEnumValN(RemapOrder::kRCM, "rcm", "Reverse Cuthill-McKee"),
+        clEnumValN(
+            RemapOrder::kLocality, "locality", "Greedy Gorder locality"),
+        clEnumValN(
+            RemapOrder::kProperty, "property",
+            "Ascending values of the node property given by -property, "
+            "e.g., the partition of each node"),
+        clEnumValN(
+            RemapOrder::kMapping, "mapping",
+            "The file given by -mapping, whose line n is the original id "
+            "of node n")),
+    cll::Required);
+cll::opt<std::string> property(
+    "property", cll::desc("Node property of -order=property"), cll::init(""));
+cll::opt<std::string> mapping_file(
+    "mapping", cll::desc("Mapping file of -order=mapping"), cll::init(""));
+cll::opt<int> num_threads(
+    "t", cll::desc("Number of threads (default all)"), cll::init(0));
+
+katana::Result<katana::NodePermutation>
+ReadMapping(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    return KATANA_ERROR(katana::ErrorCode::NotFound, "cannot open {}", path);
+  }
+  std::vector<uint32_t> old_ids;
+  uint64_t old_id;
+  while (in >> old_id) {
+    old_ids.emplace_back(old_id);
+  }
+  if (!in.eof()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "malformed line {} of {}",
+        old_ids.size() + 1, path);
+  }
+  return katana::NodePermutation::Make(
+      std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(old_ids)));
+}
+
+katana::Result<katana::NodePermutation>
+ComputePermutation(const katana::PropertyGraph& pg) {
+  switch (order) {
+  case RemapOrder::kDegree:
+    return katana::ComputeNodeOrder(pg, katana::NodeOrder::kDegree);
+  case RemapOrder::kRCM:
+    return katana::ComputeNodeOrder(
+        pg, katana::NodeOrder::kReverseCuthillMcKee);
+  case RemapOrder::kLocality:
+    return katana::ComputeNodeOrder(pg, katana::NodeOrder::kLocality);
+  case RemapOrder::kProperty:
+    return katana::ComputeNodeOrderByProperty(pg, property);
+  case RemapOrder::kMapping:
+    return ReadMapping(mapping_file);
+  }
+  return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "unknown order");
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv,
+      "Relabel the nodes of an RDG, moving its node and edge properties "
+      "with them\n");
+  if (num_threads > 0) {
+    katana::setActiveThreads(num_threads);
+  } else {
+    katana::setActiveThreads(katana::getThreadPool().getMaxUsableThreads());
+  }
+  std::string command_line = argv[0];
+  for (int i = 1; i < argc; ++i) {
+    command_line = command_line + " " + argv[i];
+  }
+
+  auto graph_res = katana::PropertyGraph::Make(input_rdg);
+  if (!graph_res) {
+    KATANA_LOG_FATAL("failed to load {}: {}", input_rdg, graph_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> graph = std::move(graph_res.value());
+
+  auto perm_res = ComputePermutation(*graph);
+  if (!perm_res) {
+    KATANA_LOG_FATAL("failed to compute the permutation: {}", perm_res.error());
+  }
+
+  // Relabeling a copy stores the original ids with the graph; see
+  // katana::NodePermutation::FromOriginalIds
+  auto relabeled_res = katana::RelabelNodes(*graph, perm_res.value());
+  if (!relabeled_res) {
+    KATANA_LOG_FATAL("failed to relabel: {}", relabeled_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> relabeled =
+      std::move(relabeled_res.value());
+
+  if (output_rdg.empty()) {
+    if (auto res = relabeled->Commit(command_line); !res) {
+      KATANA_LOG_FATAL("failed to commit {}: {}", input_rdg, res.error());
+    }
+  } else if (auto res = relabeled->Write(output_rdg, command_line); !res) {
+    KATANA_LOG_FATAL("failed to write {}: {}", output_rdg, res.error());
+  }
+  return 0;
+}
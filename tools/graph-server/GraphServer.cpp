@@ -0,0 +1,447 @@
+#include "GraphServer.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace {
+
+using TableResult = katana::Result<std::shared_ptr<arrow::Table>>;
+using Args = std::vector<std::string>;
+
+/// An arrow::io::OutputStream that sends what is written to a socket. The
+/// socket stays open when the stream is closed.
+class SocketOutputStream : public arrow::io::OutputStream {
+  int fd_;
+  int64_t position_{0};
+  bool closed_{false};
+
+public:
+  explicit SocketOutputStream(int fd) : fd_(fd) {}
+
+  arrow::Status Close() override {
+    closed_ = true;
+    return arrow::Status::OK();
+  }
+
+  arrow::Result<int64_t> Tell() const override { return position_; }
+
+  bool closed() const override { return closed_; }
+
+  arrow::Status Write(const void* data, int64_t nbytes) override {
+    const char* bytes = static_cast<const char*>(data);
+    while (nbytes > 0) {
+      ssize_t sent = send(fd_, bytes, nbytes, MSG_NOSIGNAL);
+      if (sent < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return arrow::Status::IOError("sending: ", std::strerror(errno));
+      }
+      bytes += sent;
+      nbytes -= sent;
+      position_ += sent;
+    }
+    return arrow::Status::OK();
+  }
+
+  using arrow::io::OutputStream::Write;
+};
+
+katana::Result<void>
+CheckArgs(const Args& args, size_t num_args, const char* usage) {
+  if (args.size() != num_args) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "usage: {}", usage);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<uint64_t>
+ParseNode(const katana::PropertyGraph* graph, const std::string& word) {
+  char* end = nullptr;
+  errno = 0;
+  uint64_t node = std::strtoull(word.c_str(), &end, 10);
+  if (word.empty() || *end != '\0' || errno == ERANGE || word[0] == '-') {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} is not a node", word);
+  }
+  if (node >= graph->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "node {} is not less than {}",
+        node, graph->num_nodes());
+  }
+  return node;
+}
+
+/// The named columns of properties, or all of them if names is empty
+TableResult
+SelectProperties(
+    const std::shared_ptr<arrow::Table>& properties, const Args& names) {
+  if (names.empty()) {
+    return properties;
+  }
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : names) {
+    int i = properties->schema()->GetFieldIndex(name);
+    if (i < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no property {}", name);
+    }
+    fields.emplace_back(properties->schema()->field(i));
+    columns.emplace_back(properties->column(i));
+  }
+  return arrow::Table::Make(
+      arrow::schema(fields), columns, properties->num_rows());
+}
+
+TableResult
+Info(katana::PropertyGraph* graph, const Args& args) {
+  if (auto res = CheckArgs(args, 0, "info"); !res) {
+    return res.error();
+  }
+  std::vector<uint64_t> num_nodes{graph->num_nodes()};
+  std::vector<uint64_t> num_edges{graph->num_edges()};
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("num_nodes", arrow::uint64()),
+           arrow::field("num_edges", arrow::uint64())}),
+      {katana::BuildArray(num_nodes), katana::BuildArray(num_edges)});
+}
+
+TableResult
+NodeProperties(katana::PropertyGraph* graph, const Args& args) {
+  return SelectProperties(graph->node_properties(), args);
+}
+
+TableResult
+EdgeProperties(katana::PropertyGraph* graph, const Args& args) {
+  return SelectProperties(graph->edge_properties(), args);
+}
+
+TableResult
+OutEdges(katana::PropertyGraph* graph, const Args& args) {
+  std::vector<uint32_t> srcs;
+  std::vector<uint64_t> edges;
+  std::vector<uint32_t> dests;
+  for (const auto& word : args) {
+    auto node_res = ParseNode(graph, word);
+    if (!node_res) {
+      return node_res.error();
+    }
+    uint32_t node = node_res.value();
+    for (auto e : graph->topology().edges(node)) {
+      srcs.emplace_back(node);
+      edges.emplace_back(e);
+      dests.emplace_back(graph->topology().edge_dest(e));
+    }
+  }
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("src", arrow::uint32()),
+           arrow::field("edge", arrow::uint64()),
+           arrow::field("dest", arrow::uint32())}),
+      {katana::BuildArray(srcs), katana::BuildArray(edges),
+       katana::BuildArray(dests)});
+}
+
+/// The node property output that an analytic added to graph
+TableResult
+AnalyticOutput(
+    katana::Result<void> res, katana::PropertyGraph* graph,
+    const std::string& output) {
+  if (!res) {
+    return res.error();
+  }
+  return SelectProperties(graph->node_properties(), {output});
+}
+
+TableResult
+Bfs(katana::PropertyGraph* graph, const Args& args) {
+  if (auto res = CheckArgs(args, 2, "bfs start output"); !res) {
+    return res.error();
+  }
+  auto start_res = ParseNode(graph, args[0]);
+  if (!start_res) {
+    return start_res.error();
+  }
+  return AnalyticOutput(
+      katana::analytics::Bfs(graph, start_res.value(), args[1]), graph,
+      args[1]);
+}
+
+TableResult
+Sssp(katana::PropertyGraph* graph, const Args& args) {
+  if (auto res = CheckArgs(args, 3, "sssp start weight output"); !res) {
+    return res.error();
+  }
+  auto start_res = ParseNode(graph, args[0]);
+  if (!start_res) {
+    return start_res.error();
+  }
+  return AnalyticOutput(
+      katana::analytics::Sssp(graph, start_res.value(), args[1], args[2]),
+      graph, args[2]);
+}
+
+TableResult
+ConnectedComponents(katana::PropertyGraph* graph, const Args& args) {
+  if (auto res = CheckArgs(args, 1, "connected-components output"); !res) {
+    return res.error();
+  }
+  return AnalyticOutput(
+      katana::analytics::ConnectedComponents(graph, args[0]), graph, args[0]);
+}
+
+TableResult
+Pagerank(katana::PropertyGraph* graph, const Args& args) {
+  if (auto res = CheckArgs(args, 1, "pagerank output"); !res) {
+    return res.error();
+  }
+  return AnalyticOutput(
+      katana::analytics::Pagerank(graph, args[0]), graph, args[0]);
+}
+
+struct Command {
+  const char* name;
+  /// Whether the command adds properties to the graph
+  bool modifies_graph;
+  TableResult (*run)(katana::PropertyGraph*, const Args&);
+};
+
+const Command kCommands[] = {
+    {"info", false, Info},
+    {"node-properties", false, NodeProperties},
+    {"edge-properties", false, EdgeProperties},
+    {"out-edges", false, OutEdges},
+    {"bfs", true, Bfs},
+    {"sssp", true, Sssp},
+    {"connected-components", true, ConnectedComponents},
+    {"pagerank", true, Pagerank},
+};
+
+katana::Result<void>
+WriteResponse(int fd, const TableResult& res) {
+  SocketOutputStream stream(fd);
+  if (!res) {
+    std::string message = fmt::format("ERROR {}", res.error());
+    std::replace(message.begin(), message.end(), '\n', ' ');
+    message += '\n';
+    if (auto st = stream.Write(message.data(), message.size()); !st.ok()) {
+      return KATANA_ERROR(katana::ArrowToKatana(st), "sending error: {}", st);
+    }
+    return katana::ResultSuccess();
+  }
+
+  const std::shared_ptr<arrow::Table>& table = res.value();
+  if (auto st = stream.Write("OK\n", 3); !st.ok()) {
+    return KATANA_ERROR(katana::ArrowToKatana(st), "sending reply: {}", st);
+  }
+  auto writer_res = arrow::ipc::MakeStreamWriter(&stream, table->schema());
+  if (!writer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(writer_res.status()), "starting stream: {}",
+        writer_res.status());
+  }
+  auto writer = writer_res.ValueOrDie();
+  if (auto st = writer->WriteTable(*table); !st.ok()) {
+    return KATANA_ERROR(katana::ArrowToKatana(st), "sending table: {}", st);
+  }
+  if (auto st = writer->Close(); !st.ok()) {
+    return KATANA_ERROR(katana::ArrowToKatana(st), "ending stream: {}", st);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::GraphServer::GraphServer(std::unique_ptr<PropertyGraph> graph)
+    : graph_(std::move(graph)) {}
+
+katana::GraphServer::~GraphServer() {
+  if (listen_fd_ >= 0) {
+    close(listen_fd_);
+  }
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::GraphServer::Handle(const std::string& request) {
+  std::istringstream words_stream(request);
+  Args args{
+      std::istream_iterator<std::string>(words_stream),
+      std::istream_iterator<std::string>()};
+  if (args.empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "empty request");
+  }
+  std::string name = args.front();
+  args.erase(args.begin());
+
+  for (const auto& command : kCommands) {
+    if (name != command.name) {
+      continue;
+    }
+    if (command.modifies_graph) {
+      std::unique_lock<std::shared_mutex> lock(graph_mutex_);
+      return command.run(graph_.get(), args);
+    }
+    std::shared_lock<std::shared_mutex> lock(graph_mutex_);
+    return command.run(graph_.get(), args);
+  }
+  return KATANA_ERROR(ErrorCode::InvalidArgument, "unknown request {}", name);
+}
+
+katana::Result<uint16_t>
+katana::GraphServer::Listen(uint16_t port, const std::string& host) {
+  KATANA_LOG_ASSERT(listen_fd_ < 0);
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* found = nullptr;
+  if (int err = getaddrinfo(host.c_str(), nullptr, &hints, &found); err != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "resolving host {}: {}", host,
+        gai_strerror(err));
+  }
+  sockaddr_in address = *reinterpret_cast<sockaddr_in*>(found->ai_addr);
+  freeaddrinfo(found);
+  address.sin_port = htons(port);
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return KATANA_ERROR(ResultErrno(), "creating socket");
+  }
+  listen_fd_ = fd;
+
+  int reuse = 1;
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0) {
+    return KATANA_ERROR(ResultErrno(), "setting socket options");
+  }
+
+  if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    return KATANA_ERROR(ResultErrno(), "binding to {}:{}", host, port);
+  }
+  if (listen(fd, SOMAXCONN) != 0) {
+    return KATANA_ERROR(ResultErrno(), "listening on port {}", port);
+  }
+
+  socklen_t length = sizeof(address);
+  if (getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+    return KATANA_ERROR(ResultErrno(), "getting socket address");
+  }
+  return ntohs(address.sin_port);
+}
+
+katana::Result<void>
+katana::GraphServer::Serve() {
+  KATANA_LOG_ASSERT(listen_fd_ >= 0);
+  while (true) {
+    int fd = accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      if (stopping_) {
+        break;
+      }
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      return KATANA_ERROR(ResultErrno(), "accepting client");
+    }
+
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    if (stopping_) {
+      close(fd);
+      break;
+    }
+    client_fds_.emplace_back(fd);
+    std::thread([this, fd]() { ServeClient(fd); }).detach();
+  }
+
+  std::unique_lock<std::mutex> lock(clients_mutex_);
+  clients_done_.wait(lock, [this]() { return client_fds_.empty(); });
+  return ResultSuccess();
+}
+
+void
+katana::GraphServer::Stop() {
+  stopping_ = true;
+  shutdown(listen_fd_, SHUT_RDWR);
+  std::lock_guard<std::mutex> lock(clients_mutex_);
+  for (int fd : client_fds_) {
+    shutdown(fd, SHUT_RDWR);
+  }
+}
+
+void
+katana::GraphServer::ServeClient(int fd) {
+  std::string buffer;
+  char chunk[4096];
+  bool connected = true;
+  while (connected) {
+    ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+    if (received < 0 && errno == EINTR) {
+      continue;
+    }
+    if (received <= 0) {
+      break;
+    }
+    buffer.append(chunk, received);
+
+    size_t begin = 0;
+    for (size_t end = buffer.find('\n'); end != std::string::npos;
+         end = buffer.find('\n', begin)) {
+      if (end - begin > kMaxRequestLength) {
+        break;
+      }
+      std::string request = buffer.substr(begin, end - begin);
+      begin = end + 1;
+      if (!request.empty() && request.back() == '\r') {
+        request.pop_back();
+      }
+      if (request.find_first_not_of(' ') == std::string::npos) {
+        continue;
+      }
+      if (auto res = WriteResponse(fd, Handle(request)); !res) {
+        KATANA_LOG_WARN("client disconnected: {}", res.error());
+        connected = false;
+        break;
+      }
+    }
+    buffer.erase(0, begin);
+
+    // Do not buffer requests without bound
+    if (connected && buffer.size() > kMaxRequestLength) {
+      auto res = WriteResponse(
+          fd, KATANA_ERROR(
+                  ErrorCode::InvalidArgument,
+                  "request longer than {} bytes", kMaxRequestLength));
+      if (!res) {
+        KATANA_LOG_WARN("client disconnected: {}", res.error());
+      }
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(clients_mutex_);
+  client_fds_.erase(std::find(client_fds_.begin(), client_fds_.end(), fd));
+  close(fd);
+  clients_done_.notify_all();
+}
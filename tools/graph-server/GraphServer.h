@@ -0,0 +1,89 @@
+#ifndef KATANA_TOOLS_GRAPH_SERVER_GRAPHSERVER_H_
+#define KATANA_TOOLS_GRAPH_SERVER_GRAPHSERVER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+
+namespace katana {
+
+/// Serves a property graph held in memory to clients over TCP, so that many
+/// processes can query one copy of a graph instead of each loading its own.
+///
+/// A client sends requests, one per line, of words separated by spaces. The
+/// server answers each request with a line that is either "OK" or
+/// "ERROR <message>", and after "OK" with the result table as an Arrow IPC
+/// stream (e.g., pyarrow.ipc.open_stream on the socket). The requests are:
+///
+///   info                           num_nodes and num_edges
+///   node-properties [name...]      the named node properties (default all)
+///   edge-properties [name...]      the named edge properties (default all)
+///   out-edges node...              src, edge and dest of each out-edge
+///   bfs start output               the new node property output
+///   sssp start weight output
+///   connected-components output
+///   pagerank output
+///
+/// Properties are written to clients straight from the buffers of the graph.
+/// Analytics add their output property to the graph, so later requests can
+/// read it; they run one at a time, while no other request runs.
+///
+/// The server does not authenticate clients, so by default it only listens
+/// on the loopback interface. A client that sends a request line longer than
+/// kMaxRequestLength is answered with an error and disconnected.
+class GraphServer {
+public:
+  static constexpr const char* kDefaultHost = "127.0.0.1";
+  static constexpr size_t kMaxRequestLength = 64 << 10;
+
+  explicit GraphServer(std::unique_ptr<PropertyGraph> graph);
+  ~GraphServer();
+
+  GraphServer(const GraphServer&) = delete;
+  GraphServer& operator=(const GraphServer&) = delete;
+
+  /// Answer one request
+  Result<std::shared_ptr<arrow::Table>> Handle(const std::string& request);
+
+  /// Listen for clients on port of the IPv4 address or host name host, or
+  /// on any free port if port is 0. "0.0.0.0" listens on every interface.
+  ///
+  /// \return the port listened on
+  Result<uint16_t> Listen(
+      uint16_t port, const std::string& host = kDefaultHost);
+
+  /// Accept clients until Stop is called, serving each on its own thread
+  Result<void> Serve();
+
+  /// Make Serve disconnect every client and return
+  void Stop();
+
+  PropertyGraph* graph() { return graph_.get(); }
+
+private:
+  void ServeClient(int fd);
+
+  std::unique_ptr<PropertyGraph> graph_;
+  /// Held shared by readers of graph_ and exclusively by analytics
+  std::shared_mutex graph_mutex_;
+
+  int listen_fd_{-1};
+  std::atomic<bool> stopping_{false};
+  std::mutex clients_mutex_;
+  std::vector<int> client_fds_;
+  std::condition_variable clients_done_;
+};
+
+}  // namespace katana
+
+#endif
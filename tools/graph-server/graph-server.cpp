@@ -0,0 +1,58 @@
+#include <iostream>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "GraphServer.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+
+namespace cll = llvm::cl;
+
+namespace {
+
+cll::opt<std::string> input_rdg(
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
+cll::opt<unsigned> port(
+    "port", cll::desc("Port to listen on (default 8815)"), cll::init(8815));
+cll::opt<std::string> host(
+    "host",
+    cll::desc(
+        "Address to listen on (default 127.0.0.1); "
+        "0.0.0.0 listens on every interface"),
+    cll::init(katana::GraphServer::kDefaultHost));
+cll::opt<int> num_threads(
+    "t", cll::desc("Number of threads (default all)"), cll::init(0));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv, "Serve a property graph held in memory over TCP\n");
+  if (num_threads > 0) {
+    katana::setActiveThreads(num_threads);
+  }
+  if (port > UINT16_MAX) {
+    KATANA_LOG_FATAL("port {} is greater than {}", port, UINT16_MAX);
+  }
+
+  auto graph_res = katana::PropertyGraph::Make(input_rdg);
+  if (!graph_res) {
+    KATANA_LOG_FATAL("failed to load {}: {}", input_rdg, graph_res.error());
+  }
+  katana::GraphServer server(std::move(graph_res.value()));
+
+  auto port_res = server.Listen(port, host);
+  if (!port_res) {
+    KATANA_LOG_FATAL("failed to listen: {}", port_res.error());
+  }
+  std::cout << "Serving " << input_rdg << " on " << host << ":"
+            << port_res.value() << "\n";
+
+  if (auto res = server.Serve(); !res) {
+    KATANA_LOG_FATAL("failed to serve: {}", res.error());
+  }
+  return 0;
+}
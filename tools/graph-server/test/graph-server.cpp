@@ -0,0 +1,249 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/api.h>
+
+#include "GraphServer.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+
+namespace {
+
+template <typename ArrayType, typename T>
+void
+AssertColumn(
+    const std::shared_ptr<arrow::Table>& table, const std::string& name,
+    const std::vector<T>& expected) {
+  auto column = table->GetColumnByName(name);
+  KATANA_LOG_VASSERT(column, "no column {}", name);
+  KATANA_LOG_VASSERT(
+      column->length() == static_cast<int64_t>(expected.size()),
+      "{} has {} values, not {}", name, column->length(), expected.size());
+  auto combine_res = arrow::Concatenate(column->chunks());
+  KATANA_LOG_ASSERT(combine_res.ok());
+  auto values = std::static_pointer_cast<ArrayType>(combine_res.ValueOrDie());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        values->Value(i) == expected[i], "{}[{}] is {}, not {}", name, i,
+        values->Value(i), expected[i]);
+  }
+}
+
+///   0 -> 1, 0 -> 2, 1 -> 2, 2 -> 0; node 3 has no edges
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::vector<uint64_t> out_indices{2, 3, 4, 4};
+  std::vector<uint32_t> out_dests{1, 2, 2, 0};
+  std::vector<int64_t> node_ids{10, 11, 12, 13};
+  std::vector<int64_t> weights{5, 1, 1, 1};
+
+  auto graph = std::make_unique<katana::PropertyGraph>();
+  auto res = graph->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(out_indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(out_dests)),
+  });
+  KATANA_LOG_ASSERT(res);
+
+  res = graph->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("id", arrow::int64())}),
+      {katana::BuildArray(node_ids)}));
+  KATANA_LOG_ASSERT(res);
+  res = graph->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::int64())}),
+      {katana::BuildArray(weights)}));
+  KATANA_LOG_ASSERT(res);
+  return graph;
+}
+
+std::shared_ptr<arrow::Table>
+Handle(katana::GraphServer* server, const std::string& request) {
+  auto res = server->Handle(request);
+  KATANA_LOG_VASSERT(res, "{}: {}", request, res.error());
+  return res.value();
+}
+
+void
+TestRequests() {
+  katana::GraphServer server(MakeGraph());
+
+  auto info = Handle(&server, "info");
+  AssertColumn<arrow::UInt64Array, uint64_t>(info, "num_nodes", {4});
+  AssertColumn<arrow::UInt64Array, uint64_t>(info, "num_edges", {4});
+
+  // Properties are the columns of the graph itself
+  auto ids = Handle(&server, "node-properties id");
+  KATANA_LOG_ASSERT(ids->column(0) == server.graph()->GetNodeProperty("id"));
+  KATANA_LOG_ASSERT(Handle(&server, "edge-properties")->num_columns() == 1);
+
+  auto edges = Handle(&server, "out-edges 0 3 2");
+  AssertColumn<arrow::UInt32Array, uint32_t>(edges, "src", {0, 0, 2});
+  AssertColumn<arrow::UInt64Array, uint64_t>(edges, "edge", {0, 1, 3});
+  AssertColumn<arrow::UInt32Array, uint32_t>(edges, "dest", {1, 2, 0});
+
+  auto distances = Handle(&server, "sssp 0 weight distance");
+  int64_t infinity = std::numeric_limits<int64_t>::max() / 4;
+  AssertColumn<arrow::Int64Array, int64_t>(
+      distances, "distance", {0, 5, 1, infinity});
+  KATANA_LOG_ASSERT(server.graph()->HasNodeProperty("distance"));
+  KATANA_LOG_ASSERT(Handle(&server, "node-properties")->num_columns() == 2);
+
+  for (const char* request :
+       {"", "unknown", "info 1", "node-properties missing", "out-edges 4",
+        "out-edges -1", "out-edges x", "bfs 0", "sssp 0 weight distance"}) {
+    KATANA_LOG_VASSERT(!server.Handle(request), "{} succeeded", request);
+  }
+}
+
+/// The reply that starts at *offset of the replies received, as a table, or
+/// null if it is an error; advances *offset past it
+std::shared_ptr<arrow::Table>
+ReadReply(const std::string& replies, size_t* offset) {
+  size_t line_end = replies.find('\n', *offset);
+  KATANA_LOG_ASSERT(line_end != std::string::npos);
+  std::string status = replies.substr(*offset, line_end - *offset);
+  *offset = line_end + 1;
+  if (status != "OK") {
+    KATANA_LOG_VASSERT(status.rfind("ERROR ", 0) == 0, "reply {}", status);
+    return nullptr;
+  }
+
+  auto buffer = std::make_shared<arrow::Buffer>(
+      reinterpret_cast<const uint8_t*>(replies.data()) + *offset,
+      replies.size() - *offset);
+  arrow::io::BufferReader input(buffer);
+  auto reader_res = arrow::ipc::RecordBatchStreamReader::Open(&input);
+  KATANA_LOG_ASSERT(reader_res.ok());
+  std::shared_ptr<arrow::Table> table;
+  KATANA_LOG_ASSERT(reader_res.ValueOrDie()->ReadAll(&table).ok());
+  *offset += input.Tell().ValueOrDie();
+  return table;
+}
+
+/// Send requests to port on a new connection, returning the bytes received
+/// until the server closes the connection
+std::string
+Exchange(uint16_t port, const std::string& requests) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  KATANA_LOG_ASSERT(fd >= 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  KATANA_LOG_ASSERT(
+      connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) ==
+      0);
+
+  KATANA_LOG_ASSERT(
+      send(fd, requests.data(), requests.size(), 0) ==
+      static_cast<ssize_t>(requests.size()));
+  shutdown(fd, SHUT_WR);
+
+  std::string replies;
+  char chunk[4096];
+  ssize_t received;
+  while ((received = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+    replies.append(chunk, received);
+  }
+  close(fd);
+  return replies;
+}
+
+void
+TestSockets() {
+  katana::GraphServer server(MakeGraph());
+  auto port_res = server.Listen(0);
+  KATANA_LOG_VASSERT(port_res, "listening: {}", port_res.error());
+  uint16_t port = port_res.value();
+  std::thread serving([&]() {
+    auto res = server.Serve();
+    KATANA_LOG_VASSERT(res, "serving: {}", res.error());
+  });
+
+  // Clients connect at the same time, and an analytic runs while others read
+  std::vector<std::string> replies(4);
+  std::vector<std::thread> clients;
+  for (size_t i = 0; i < replies.size(); ++i) {
+    std::string analytic = "bfs 0 level" + std::to_string(i);
+    clients.emplace_back([&, i, analytic]() {
+      replies[i] = Exchange(
+          port, "info\r\n\nnode-properties id\nbogus\n" + analytic +
+                    "\nout-edges 0\n");
+    });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+
+  for (size_t i = 0; i < replies.size(); ++i) {
+    size_t offset = 0;
+    auto info = ReadReply(replies[i], &offset);
+    AssertColumn<arrow::UInt64Array, uint64_t>(info, "num_nodes", {4});
+    auto ids = ReadReply(replies[i], &offset);
+    AssertColumn<arrow::Int64Array, int64_t>(ids, "id", {10, 11, 12, 13});
+    KATANA_LOG_ASSERT(!ReadReply(replies[i], &offset));
+    auto levels = ReadReply(replies[i], &offset);
+    KATANA_LOG_ASSERT(levels->num_rows() == 4);
+    KATANA_LOG_ASSERT(levels->num_columns() == 1);
+    auto edges = ReadReply(replies[i], &offset);
+    AssertColumn<arrow::UInt32Array, uint32_t>(edges, "dest", {1, 2});
+    KATANA_LOG_ASSERT(offset == replies[i].size());
+  }
+
+  server.Stop();
+  serving.join();
+}
+
+/// Clients that send longer requests than the server buffers are dropped
+void
+TestLimits() {
+  katana::GraphServer server(MakeGraph());
+  KATANA_LOG_ASSERT(!server.Listen(0, "no-such-host.invalid"));
+  auto port_res = server.Listen(0, "localhost");
+  KATANA_LOG_VASSERT(port_res, "listening: {}", port_res.error());
+  uint16_t port = port_res.value();
+  std::thread serving([&]() {
+    auto res = server.Serve();
+    KATANA_LOG_VASSERT(res, "serving: {}", res.error());
+  });
+
+  std::string too_long(katana::GraphServer::kMaxRequestLength + 1, 'x');
+  std::string replies = Exchange(port, too_long);
+  size_t offset = 0;
+  KATANA_LOG_ASSERT(!ReadReply(replies, &offset));
+  KATANA_LOG_ASSERT(offset == replies.size());
+
+  // Other clients are still served
+  replies = Exchange(port, "info\n");
+  offset = 0;
+  KATANA_LOG_ASSERT(ReadReply(replies, &offset));
+
+  server.Stop();
+  serving.join();
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestRequests();
+  TestSockets();
+  TestLimits();
+
+  return 0;
+}
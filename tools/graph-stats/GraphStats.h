@@ -0,0 +1,265 @@
+#ifndef KATANA_TOOLS_GRAPH_STATS_GRAPHSTATS_H_
+#define KATANA_TOOLS_GRAPH_STATS_GRAPHSTATS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/FileGraph.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+
+namespace katana::graphstats {
+
+/// A .gr file with the accessors of katana::GraphTopology, so that stats
+/// read either input the same way. The file is mapped into memory, so it may
+/// be read by many threads.
+class FileTopology {
+public:
+  explicit FileTopology(const std::string& filename) {
+    graph_.fromFile(filename);
+  }
+
+  uint64_t num_nodes() const { return graph_.size(); }
+
+  uint64_t num_edges() const { return graph_.sizeEdges(); }
+
+  size_t edge_size() const { return graph_.edgeSize(); }
+
+  std::pair<uint64_t, uint64_t> edge_range(uint64_t node) const {
+    return std::make_pair(*graph_.edge_begin(node), *graph_.edge_end(node));
+  }
+
+  uint64_t edge_dest(uint64_t edge) const {
+    return graph_.getEdgeDst(katana::FileGraph::edge_iterator(edge));
+  }
+
+private:
+  mutable katana::FileGraph graph_;
+};
+
+/// The stats below take a Topology with the accessors of
+/// katana::GraphTopology, e.g., FileTopology, and compute in parallel.
+
+template <typename Topology>
+uint64_t
+Degree(const Topology& graph, uint64_t node) {
+  auto [begin, end] = graph.edge_range(node);
+  return end - begin;
+}
+
+/// The first node of the largest degree and its degree, or (0, 0) if graph
+/// has no nodes
+template <typename Topology>
+std::pair<uint64_t, uint64_t>
+MaxDegreeNode(const Topology& graph) {
+  if (graph.num_nodes() == 0) {
+    return std::make_pair(0, 0);
+  }
+  // Pack the degree above the complement of the node so that the max is
+  // the first node with the max degree
+  katana::GReduceMax<uint64_t> max;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_nodes()),
+      [&](uint64_t n) {
+        uint64_t degree = std::min<uint64_t>(Degree(graph, n), UINT32_MAX);
+        max.update((degree << 32) | (UINT32_MAX - n));
+      },
+      katana::no_stats());
+  uint64_t packed = max.reduce();
+  return std::make_pair(UINT32_MAX - (packed & UINT32_MAX), packed >> 32);
+}
+
+/// Histogram of key_fn(n) over the nodes n of graph
+template <typename Topology, typename KeyFn>
+std::map<uint64_t, uint64_t>
+NodeHistogram(const Topology& graph, KeyFn key_fn) {
+  auto entries = katana::ParallelSTL::group_by(
+      boost::counting_iterator<uint64_t>(0),
+      boost::counting_iterator<uint64_t>(graph.num_nodes()), key_fn);
+  std::map<uint64_t, uint64_t> hist;
+  for (const auto& entry : entries) {
+    hist[entry.key] = entry.count;
+  }
+  return hist;
+}
+
+/// The number of in-edges of each node
+template <typename Topology>
+katana::LargeArray<uint64_t>
+InDegrees(const Topology& graph) {
+  katana::LargeArray<uint64_t> in_degrees;
+  in_degrees.allocateBlocked(graph.num_nodes());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_nodes()),
+      [&](uint64_t n) { in_degrees[n] = 0; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) {
+        __sync_fetch_and_add(&in_degrees[graph.edge_dest(e)], 1);
+      },
+      katana::no_stats());
+  return in_degrees;
+}
+
+/// The number of nodes of each degree
+template <typename Topology>
+std::map<uint64_t, uint64_t>
+DegreeHistogram(const Topology& graph) {
+  return NodeHistogram(graph, [&](uint64_t n) { return Degree(graph, n); });
+}
+
+/// The number of nodes of each in-degree
+template <typename Topology>
+std::map<uint64_t, uint64_t>
+InDegreeHistogram(const Topology& graph) {
+  katana::LargeArray<uint64_t> in_degrees = InDegrees(graph);
+  return NodeHistogram(graph, [&](uint64_t n) { return in_degrees[n]; });
+}
+
+/// The in-degree of each node that is the destination of an edge
+template <typename Topology>
+std::map<uint64_t, uint64_t>
+DestinationHistogram(const Topology& graph) {
+  katana::LargeArray<uint64_t> in_degrees = InDegrees(graph);
+  std::map<uint64_t, uint64_t> hist;
+  for (uint64_t n = 0; n < graph.num_nodes(); ++n) {
+    if (in_degrees[n] != 0) {
+      hist[n] = in_degrees[n];
+    }
+  }
+  return hist;
+}
+
+/// The non-zeros of graph as a columns by columns matrix of blocks of
+/// nodes: rows[i][x] is true if a node of block i has an edge to a node of
+/// block x
+template <typename Topology>
+std::vector<std::vector<char>>
+SparsityPattern(const Topology& graph, int columns) {
+  uint64_t block_size = (graph.num_nodes() + columns - 1) / columns;
+
+  std::vector<std::vector<char>> rows(columns, std::vector<char>(columns));
+  katana::do_all(
+      katana::iterate(0, columns),
+      [&](int i) {
+        std::vector<char>& row = rows[i];
+        auto p = katana::block_range(
+            uint64_t{0}, graph.num_nodes(), i, columns);
+        for (uint64_t n = p.first; n != p.second; ++n) {
+          auto [begin, end] = graph.edge_range(n);
+          for (uint64_t e = begin; e < end; ++e) {
+            row[graph.edge_dest(e) / block_size] = true;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return rows;
+}
+
+/// The sorted degrees of a Bernoulli sample of the nodes that includes
+/// each node with probability sample_rate, which needs only a pass over
+/// the node index rather than a sort of all degrees
+template <typename Topology>
+std::vector<uint64_t>
+SampleDegrees(const Topology& graph, double sample_rate, unsigned seed) {
+  katana::PerThreadStorage<std::vector<uint64_t>> samples;
+  katana::on_each([&](unsigned tid, unsigned total) {
+    std::mt19937_64 gen(seed * total + tid);
+    std::bernoulli_distribution coin(sample_rate);
+    auto [begin, end] =
+        katana::block_range(uint64_t{0}, graph.num_nodes(), tid, total);
+    for (uint64_t n = begin; n < end; ++n) {
+      if (coin(gen)) {
+        samples.getLocal()->emplace_back(Degree(graph, n));
+      }
+    }
+  });
+  std::vector<uint64_t> sample;
+  for (unsigned t = 0; t < samples.size(); ++t) {
+    const std::vector<uint64_t>& local = *samples.getRemote(t);
+    sample.insert(sample.end(), local.begin(), local.end());
+  }
+  katana::ParallelSTL::sort(sample.begin(), sample.end());
+  return sample;
+}
+
+/// A HyperLogLog sketch of a set of 64-bit values
+class HyperLogLog {
+public:
+  static constexpr unsigned kIndexBits = 14;
+  static constexpr size_t kNumRegisters = size_t{1} << kIndexBits;
+
+  HyperLogLog() : registers_(kNumRegisters, 0) {}
+
+  void Add(uint64_t value) {
+    uint64_t hash = Mix(value);
+    size_t index = hash >> (64 - kIndexBits);
+    // The rank of the first set bit of the rest of the hash; the guard bit
+    // bounds it when the rest is zero
+    uint64_t rest = (hash << kIndexBits) | (uint64_t{1} << (kIndexBits - 1));
+    auto rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    registers_[index] = std::max(registers_[index], rank);
+  }
+
+  void Merge(const HyperLogLog& other) {
+    for (size_t i = 0; i < kNumRegisters; ++i) {
+      registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+  }
+
+  double Estimate() const {
+    double m = kNumRegisters;
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : registers_) {
+      sum += std::ldexp(1.0, -r);
+      zeros += r == 0;
+    }
+    double alpha = 0.7213 / (1 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    // Linear counting is more accurate for small sets
+    if (estimate <= 2.5 * m && zeros > 0) {
+      estimate = m * std::log(m / zeros);
+    }
+    return estimate;
+  }
+
+private:
+  static uint64_t Mix(uint64_t x) {
+    x += UINT64_C(0x9E3779B97F4A7C15);
+    x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return x ^ (x >> 31);
+  }
+
+  std::vector<uint8_t> registers_;
+};
+
+/// Estimate the number of distinct edge destinations with per-thread
+/// sketches, in one pass over the edges and in constant memory per thread
+template <typename Topology>
+double
+DistinctDestinations(const Topology& graph) {
+  katana::PerThreadStorage<HyperLogLog> sketches;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) { sketches.getLocal()->Add(graph.edge_dest(e)); },
+      katana::no_stats());
+  HyperLogLog sketch;
+  for (unsigned t = 0; t < sketches.size(); ++t) {
+    sketch.Merge(*sketches.getRemote(t));
+  }
+  return sketch.Estimate();
+}
+
+}  // namespace katana::graphstats
+
+#endif
@@ -17,20 +17,31 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
 #include <vector>
 
+#include "GraphStats.h"
 #include "katana/Galois.h"
 #include "katana/LCGraph.h"
-#include "katana/OfflineGraph.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
+namespace stats = katana::graphstats;
 
 enum StatMode {
   degreehist,
   degrees,
+  degreequantiles,
+  distinctdsts,
   maxDegreeNode,
   dsthist,
   indegreehist,
@@ -46,6 +57,11 @@ static cll::list<StatMode> statModeList(
     cll::values(
         clEnumVal(degreehist, "Histogram of degrees"),
         clEnumVal(degrees, "Node degrees"),
+        clEnumVal(
+            degreequantiles, "Quantiles of degrees of a sample of nodes"),
+        clEnumVal(
+            distinctdsts,
+            "Approximate number of distinct destinations (HyperLogLog)"),
         clEnumVal(maxDegreeNode, "Max Degree Node"),
         clEnumVal(dsthist, "Histogram of destinations"),
         clEnumVal(indegreehist, "Histogram of indegrees"),
@@ -57,47 +73,58 @@ static cll::list<StatMode> statModeList(
             "Pattern of non-zeros when graph is "
             "interpreted as a sparse matrix"),
         clEnumVal(summary, "Graph summary")));
+static cll::opt<bool> rdgInput(
+    "rdg", cll::desc("Input is an RDG rather than a .gr file"),
+    cll::init(false));
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads (default: all)"),
+    cll::init(std::numeric_limits<unsigned>::max()));
 static cll::opt<int> numBins(
     "numBins", cll::desc("Number of bins"), cll::init(-1));
 static cll::opt<int> columns(
     "columns", cll::desc("Columns for sparsity"), cll::init(80));
+static cll::opt<double> sampleRate(
+    "sampleRate",
+    cll::desc("Fraction of nodes sampled by degreequantiles (default: 0.01)"),
+    cll::init(0.01));
+static cll::opt<unsigned> seed(
+    "seed", cll::desc("Seed of the sample of degreequantiles"), cll::init(0));
 
-typedef katana::OfflineGraph Graph;
+typedef katana::FileGraph Graph;
 typedef Graph::GraphNode GNode;
 
+template <typename Topology>
 void
-doSummary(Graph& graph) {
-  std::cout << "NumNodes: " << graph.size() << "\n";
-  std::cout << "NumEdges: " << graph.sizeEdges() << "\n";
-  std::cout << "SizeofEdge: " << graph.edgeSize() << "\n";
+doSummary(const Topology& graph, std::optional<size_t> edge_size) {
+  std::cout << "NumNodes: " << graph.num_nodes() << "\n";
+  std::cout << "NumEdges: " << graph.num_edges() << "\n";
+  if (edge_size) {
+    std::cout << "SizeofEdge: " << *edge_size << "\n";
+  }
 }
 
+template <typename Topology>
 void
-doDegrees(Graph& graph) {
-  for (auto n : graph) {
-    std::cout << graph.edges(n).size() << "\n";
+doDegrees(const Topology& graph) {
+  for (uint64_t n = 0; n < graph.num_nodes(); ++n) {
+    std::cout << stats::Degree(graph, n) << "\n";
   }
 }
 
+template <typename Topology>
 void
-findMaxDegreeNode(Graph& graph) {
-  uint64_t nodeId = 0;
-  size_t MaxDegree = 0;
-  uint64_t MaxDegreeNode = 0;
-  for (auto n : graph) {
-    size_t degree = graph.edges(n).size();
-    if (MaxDegree < degree) {
-      MaxDegree = degree;
-      MaxDegreeNode = nodeId;
-    }
-    ++nodeId;
-  }
-  std::cout << "MaxDegreeNode : " << MaxDegreeNode
-            << " , MaxDegree : " << MaxDegree << "\n";
+findMaxDegreeNode(const Topology& graph) {
+  auto [node, degree] = stats::MaxDegreeNode(graph);
+  std::cout << "MaxDegreeNode : " << node << " , MaxDegree : " << degree
+            << "\n";
 }
 
 void
 printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
+  if (hists.empty()) {
+    std::cout << name << "Bin,Start,End,Count\n";
+    return;
+  }
   auto max = hists.rbegin()->first;
   if (numBins <= 0) {
     std::cout << name << "Bin,Start,End,Count\n";
@@ -127,47 +154,56 @@ printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
   }
 }
 
+template <typename Topology>
 void
 doSparsityPattern(
-    Graph& graph, std::function<void(unsigned, unsigned, bool)> printFn) {
-  unsigned blockSize = (graph.size() + columns - 1) / columns;
-
+    const Topology& graph,
+    std::function<void(unsigned, unsigned, bool)> printFn) {
+  std::vector<std::vector<char>> rows = stats::SparsityPattern(graph, columns);
   for (int i = 0; i < columns; ++i) {
-    std::vector<bool> row(columns);
-    auto p = katana::block_range(graph.begin(), graph.end(), i, columns);
-    for (auto ii = p.first, ei = p.second; ii != ei; ++ii) {
-      for (auto jj : graph.edges(*ii)) {
-        row[graph.getEdgeDst(jj) / blockSize] = true;
-      }
-    }
     for (int x = 0; x < columns; ++x) {
-      printFn(x, i, row[x]);
+      printFn(x, i, rows[i][x]);
     }
   }
 }
 
+template <typename Topology>
 void
-doDegreeHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    ++hist[graph.edges(ii).size()];
-  }
+doDegreeHistogram(const Topology& graph) {
+  auto hist = stats::DegreeHistogram(graph);
   printHistogram("Degree", hist);
 }
 
+template <typename Topology>
 void
-doInDegreeHistogram(Graph& graph) {
-  std::vector<uint64_t> inv(graph.size());
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++inv[graph.getEdgeDst(jj)];
-    }
+doInDegreeHistogram(const Topology& graph) {
+  auto hist = stats::InDegreeHistogram(graph);
+  printHistogram("InDegree", hist);
+}
+
+/// Print the quantiles of the degrees of a sample of the nodes
+template <typename Topology>
+void
+doDegreeQuantiles(const Topology& graph) {
+  std::vector<uint64_t> sample = stats::SampleDegrees(graph, sampleRate, seed);
+  std::cout << "SampledNodes: " << sample.size() << "\n";
+  if (sample.empty()) {
+    return;
   }
-  for (uint64_t n : inv) {
-    ++hist[n];
+  std::cout << "Quantile,Degree\n";
+  for (double q : {0.0, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0}) {
+    size_t index = std::min<size_t>(q * sample.size(), sample.size() - 1);
+    std::cout << q << ',' << sample[index] << '\n';
   }
-  printHistogram("InDegree", hist);
+}
+
+template <typename Topology>
+void
+doDistinctDestinations(const Topology& graph) {
+  std::cout << "DistinctDestinations (approximate): "
+            << static_cast<uint64_t>(
+                   std::llround(stats::DistinctDestinations(graph)))
+            << "\n";
 }
 
 struct EdgeComp {
@@ -191,8 +227,9 @@ getLogIndex(ptrdiff_t x) {
   return sign * logvalue;
 }
 
+template <typename Topology>
 void
-doSortedLogOffsetHistogram([[maybe_unused]] Graph& graph) {
+doSortedLogOffsetHistogram([[maybe_unused]] const Topology& graph) {
   // Graph copy;
   // {
   //   // Original FileGraph is immutable because it is backed by a file
@@ -240,61 +277,83 @@ doSortedLogOffsetHistogram([[maybe_unused]] Graph& graph) {
   // printHistogram("LogOffset", hists);
 }
 
+template <typename Topology>
 void
-doDestinationHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++hist[graph.getEdgeDst(jj)];
+doDestinationHistogram(const Topology& graph) {
+  auto hist = stats::DestinationHistogram(graph);
+  printHistogram("DestinationBin", hist);
+}
+
+template <typename Topology>
+void
+doStats(const Topology& graph, std::optional<size_t> edge_size) {
+  for (unsigned i = 0; i != statModeList.size(); ++i) {
+    switch (statModeList[i]) {
+    case degreehist:
+      doDegreeHistogram(graph);
+      break;
+    case degrees:
+      doDegrees(graph);
+      break;
+    case degreequantiles:
+      doDegreeQuantiles(graph);
+      break;
+    case distinctdsts:
+      doDistinctDestinations(graph);
+      break;
+    case maxDegreeNode:
+      findMaxDegreeNode(graph);
+      break;
+    case dsthist:
+      doDestinationHistogram(graph);
+      break;
+    case indegreehist:
+      doInDegreeHistogram(graph);
+      break;
+    case sortedlogoffsethist:
+      doSortedLogOffsetHistogram(graph);
+      break;
+    case sparsityPattern: {
+      unsigned lastrow = ~0;
+      doSparsityPattern(graph, [&lastrow](unsigned, unsigned y, bool val) {
+        if (y != lastrow) {
+          lastrow = y;
+          std::cout << '\n';
+        }
+        std::cout << (val ? 'x' : '.');
+      });
+      std::cout << '\n';
+      break;
+    }
+    case summary:
+      doSummary(graph, edge_size);
+      break;
+    default:
+      std::cerr << "Unknown stat requested\n";
+      break;
     }
   }
-  printHistogram("DestinationBin", hist);
 }
 
 int
 main(int argc, char** argv) {
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(numThreads);
   try {
-    Graph graph(inputfilename);
-    for (unsigned i = 0; i != statModeList.size(); ++i) {
-      switch (statModeList[i]) {
-      case degreehist:
-        doDegreeHistogram(graph);
-        break;
-      case degrees:
-        doDegrees(graph);
-        break;
-      case maxDegreeNode:
-        findMaxDegreeNode(graph);
-        break;
-      case dsthist:
-        doDestinationHistogram(graph);
-        break;
-      case indegreehist:
-        doInDegreeHistogram(graph);
-        break;
-      case sortedlogoffsethist:
-        doSortedLogOffsetHistogram(graph);
-        break;
-      case sparsityPattern: {
-        unsigned lastrow = ~0;
-        doSparsityPattern(graph, [&lastrow](unsigned, unsigned y, bool val) {
-          if (y != lastrow) {
-            lastrow = y;
-            std::cout << '\n';
-          }
-          std::cout << (val ? 'x' : '.');
-        });
-        std::cout << '\n';
-        break;
-      }
-      case summary:
-        doSummary(graph);
-        break;
-      default:
-        std::cerr << "Unknown stat requested\n";
-        break;
+    if (rdgInput) {
+      // Only the topology is needed, so leave the properties unread
+      tsuba::RDGLoadOptions opts;
+      opts.lazy_properties = true;
+      auto res = katana::PropertyGraph::Make(inputfilename, opts);
+      if (!res) {
+        KATANA_LOG_FATAL(
+            "failed to load {}: {}", inputfilename.getValue(), res.error());
       }
+      doStats(res.value()->topology(), std::nullopt);
+    } else {
+      stats::FileTopology graph(inputfilename);
+      doStats(graph, graph.edge_size());
     }
     return 0;
   } catch (...) {